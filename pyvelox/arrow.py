@@ -0,0 +1,67 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Zero-copy conversions between Velox vectors and pyarrow.
+
+Uses the Arrow C data interface, so flat fixed width values and nulls are
+shared between Velox and Arrow instead of being converted element by element.
+Requires pyarrow.
+"""
+
+import pyarrow as pa
+from pyarrow.cffi import ffi
+
+import pyvelox.pyvelox as pv
+
+
+def _address(c_struct):
+    return int(ffi.cast("uintptr_t", c_struct))
+
+
+def to_pyarrow(vector):
+    """Returns a pyarrow.Array that shares the buffers of 'vector'."""
+    c_array = ffi.new("struct ArrowArray*")
+    c_schema = ffi.new("struct ArrowSchema*")
+    pv.export_to_arrow(vector, _address(c_array), _address(c_schema))
+    return pa.Array._import_from_c(_address(c_array), _address(c_schema))
+
+
+def from_pyarrow(array):
+    """Returns a Velox vector that shares the buffers of the pyarrow.Array
+    'array'."""
+    c_array = ffi.new("struct ArrowArray*")
+    c_schema = ffi.new("struct ArrowSchema*")
+    array._export_to_c(_address(c_array), _address(c_schema))
+    return pv.import_from_arrow(_address(c_array), _address(c_schema))
+
+
+def run(batches, filter="", projections=None):
+    """Runs a Velox filter and projections over 'batches' and returns a
+    pyarrow.RecordBatchReader over the results.
+
+    'batches' is a pyarrow.RecordBatchReader, or an iterable of
+    pyarrow.RecordBatch together with their schema as a (schema, iterable)
+    pair. 'filter' and 'projections' are SQL expressions over the columns of
+    the batches. The batches are read and processed as the results are read.
+    """
+    if not isinstance(batches, pa.RecordBatchReader):
+        schema, iterable = batches
+        batches = pa.RecordBatchReader.from_batches(schema, iterable)
+    c_input = ffi.new("struct ArrowArrayStream*")
+    c_output = ffi.new("struct ArrowArrayStream*")
+    batches._export_to_c(_address(c_input))
+    pv.run_arrow_stream(
+        _address(c_input), _address(c_output), filter, projections or []
+    )
+    return pa.RecordBatchReader._import_from_c(_address(c_output))
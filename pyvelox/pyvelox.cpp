@@ -17,6 +17,12 @@
 #include "pyvelox.h"
 #include "signatures.h"
 
+#include <velox/core/PlanNode.h>
+#include <velox/exec/ArrowStream.h>
+#include <velox/exec/Task.h>
+#include <velox/vector/arrow/Abi.h>
+#include <velox/vector/arrow/Bridge.h>
+
 namespace facebook::velox::py {
 using namespace velox;
 namespace py = pybind11;
@@ -120,6 +126,131 @@ static void addExpressionBindings(
       });
 }
 
+// Runs a plan over the Arrow batches of the ArrowArrayStream at
+// 'inputStreamAddress' and exports its results into the ArrowArrayStream at
+// 'outputStreamAddress'. The plan filters the batches by 'filter' and
+// computes 'projections' over the passing rows, if these are not empty. The
+// input stream is moved into the plan. The plan runs single-threaded as the
+// consumer pulls batches from the output stream.
+static void runArrowStream(
+    uintptr_t inputStreamAddress,
+    uintptr_t outputStreamAddress,
+    const std::string& filter,
+    const std::vector<std::string>& projections) {
+  auto* input = reinterpret_cast<ArrowArrayStream*>(inputStreamAddress);
+  if (input->release == nullptr) {
+    throw py::value_error("The input Arrow stream has been released");
+  }
+  std::shared_ptr<ArrowArrayStream> inputStream(
+      new ArrowArrayStream(*input), [](ArrowArrayStream* stream) {
+        if (stream->release) {
+          stream->release(stream);
+        }
+        delete stream;
+      });
+  input->release = nullptr;
+
+  ArrowSchema arrowSchema;
+  if (inputStream->get_schema(inputStream.get(), &arrowSchema)) {
+    const char* error = inputStream->get_last_error(inputStream.get());
+    throw py::value_error(fmt::format(
+        "Failed to get the schema of the Arrow stream: {}",
+        error ? error : ""));
+  }
+  TypePtr type;
+  try {
+    type = importFromArrow(arrowSchema);
+  } catch (...) {
+    arrowSchema.release(&arrowSchema);
+    throw;
+  }
+  arrowSchema.release(&arrowSchema);
+  if (type->kind() != TypeKind::ROW) {
+    throw py::type_error("The Arrow stream must have a struct schema");
+  }
+
+  memory::MemoryPool* pool = PyVeloxContext::getInstance().pool();
+  parse::ParseOptions options;
+  core::PlanNodePtr plan = std::make_shared<core::ArrowStreamNode>(
+      "0", asRowType(type), inputStream);
+  if (!filter.empty()) {
+    auto filterExpr = core::Expressions::inferTypes(
+        parse::parseExpr(filter, options), plan->outputType(), pool);
+    plan = std::make_shared<core::FilterNode>("1", filterExpr, plan);
+  }
+  if (!projections.empty()) {
+    std::vector<std::string> names;
+    std::vector<core::TypedExprPtr> exprs;
+    for (auto i = 0; i < projections.size(); ++i) {
+      auto expr = parse::parseExpr(projections[i], options);
+      if (expr->alias().has_value()) {
+        names.push_back(expr->alias().value());
+      } else if (
+          auto field = dynamic_cast<const core::FieldAccessExpr*>(expr.get())) {
+        names.push_back(field->getFieldName());
+      } else {
+        names.push_back(fmt::format("p{}", i));
+      }
+      exprs.push_back(
+          core::Expressions::inferTypes(expr, plan->outputType(), pool));
+    }
+    plan = std::make_shared<core::ProjectNode>(
+        "2", std::move(names), std::move(exprs), plan);
+  }
+
+  static std::atomic<int64_t> taskCounter{0};
+  auto task = std::make_shared<exec::Task>(
+      fmt::format("pyvelox.arrow.{}", taskCounter++),
+      core::PlanFragment{plan},
+      0,
+      std::make_shared<core::QueryCtx>());
+  exec::exportToArrowStream(
+      std::move(task),
+      *reinterpret_cast<ArrowArrayStream*>(outputStreamAddress));
+}
+
+static void addArrowBindings(py::module& m) {
+  using namespace facebook::velox;
+  m.def(
+      "export_to_arrow",
+      [](VectorPtr& vector, uintptr_t arrayAddress, uintptr_t schemaAddress) {
+        auto* arrowSchema = reinterpret_cast<ArrowSchema*>(schemaAddress);
+        exportToArrow(vector, *arrowSchema);
+        try {
+          exportToArrow(
+              vector,
+              *reinterpret_cast<ArrowArray*>(arrayAddress),
+              PyVeloxContext::getInstance().pool());
+        } catch (...) {
+          arrowSchema->release(arrowSchema);
+          throw;
+        }
+      },
+      "Exports the vector into the ArrowArray and ArrowSchema at the given addresses, e.g. allocated with pyarrow.cffi. Flat fixed width values and nulls are shared, not copied",
+      py::arg("vector"),
+      py::arg("array_address"),
+      py::arg("schema_address"));
+  m.def(
+      "import_from_arrow",
+      [](uintptr_t arrayAddress, uintptr_t schemaAddress) {
+        return importFromArrowAsOwner(
+            *reinterpret_cast<ArrowSchema*>(schemaAddress),
+            *reinterpret_cast<ArrowArray*>(arrayAddress),
+            PyVeloxContext::getInstance().pool());
+      },
+      "Imports the ArrowArray and ArrowSchema at the given addresses into a vector that takes ownership of them. Fixed width values and nulls are shared, not copied",
+      py::arg("array_address"),
+      py::arg("schema_address"));
+  m.def(
+      "run_arrow_stream",
+      &runArrowStream,
+      "Runs a filter and projections over the batches of the input ArrowArrayStream and exports the results as the output ArrowArrayStream. Batches are processed as the output stream is read",
+      py::arg("input_stream_address"),
+      py::arg("output_stream_address"),
+      py::arg("filter") = "",
+      py::arg("projections") = std::vector<std::string>{});
+}
+
 #ifdef CREATE_PYVELOX_MODULE
 PYBIND11_MODULE(pyvelox, m) {
   m.doc() = R"pbdoc(
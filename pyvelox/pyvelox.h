@@ -222,6 +222,46 @@ inline void setItemInVector(VectorPtr& v, vector_size_t idx, py::handle& obj) {
       setItemInVector, v->typeKind(), v, idx, var);
 }
 
+template <TypeKind T>
+inline py::buffer_info getVectorBuffer(BaseVector& v) {
+  using NativeType = typename TypeTraits<T>::NativeType;
+  auto* flat = v.asFlatVector<NativeType>();
+  return py::buffer_info(
+      const_cast<NativeType*>(flat->rawValues()),
+      sizeof(NativeType),
+      py::format_descriptor<NativeType>::format(),
+      1,
+      {static_cast<py::ssize_t>(v.size())},
+      {static_cast<py::ssize_t>(sizeof(NativeType))},
+      true);
+}
+
+/// Describes the values of a flat vector of a fixed width numeric type as a
+/// read-only buffer, so that e.g. numpy.asarray() wraps them without copying.
+/// The values of null rows are undefined.
+inline py::buffer_info getVectorBuffer(BaseVector& v) {
+  if (v.encoding() != VectorEncoding::Simple::FLAT) {
+    throw py::type_error("Only flat vectors expose their values as a buffer");
+  }
+  switch (v.typeKind()) {
+    case TypeKind::TINYINT:
+      return getVectorBuffer<TypeKind::TINYINT>(v);
+    case TypeKind::SMALLINT:
+      return getVectorBuffer<TypeKind::SMALLINT>(v);
+    case TypeKind::INTEGER:
+      return getVectorBuffer<TypeKind::INTEGER>(v);
+    case TypeKind::BIGINT:
+      return getVectorBuffer<TypeKind::BIGINT>(v);
+    case TypeKind::REAL:
+      return getVectorBuffer<TypeKind::REAL>(v);
+    case TypeKind::DOUBLE:
+      return getVectorBuffer<TypeKind::DOUBLE>(v);
+    default:
+      throw py::type_error(
+          "Only vectors of fixed width numeric types expose their values as a buffer");
+  }
+}
+
 inline void appendVectors(VectorPtr& u, VectorPtr& v) {
   if (u->typeKind() != v->typeKind()) {
     throw py::type_error("Tried to append vectors of two different types");
@@ -381,7 +421,11 @@ inline void addVectorBindings(
       .value("FUNCTION", velox::VectorEncoding::Simple::FUNCTION);
 
   py::class_<BaseVector, VectorPtr>(
-      m, "BaseVector", py::module_local(asModuleLocalDefinitions))
+      m,
+      "BaseVector",
+      py::buffer_protocol(),
+      py::module_local(asModuleLocalDefinitions))
+      .def_buffer([](BaseVector& v) { return getVectorBuffer(v); })
       .def("__str__", [](VectorPtr& v) { return v->toString(); })
       .def("__len__", &BaseVector::size)
       .def("size", &BaseVector::size)
@@ -422,12 +466,18 @@ static void addExpressionBindings(
     py::module& m,
     bool asModuleLocalDefinitions = true);
 
+static void addArrowBindings(py::module& m);
+
 ///  Adds Velox Python Bindings to the module m.
 ///
 /// This function adds the following bindings:
 ///   * velox::TypeKind enum
 ///   * velox::Type and its derived types
 ///   * Basic functions on Type and its derived types.
+///   * velox::BaseVector, which supports the buffer protocol for flat
+///     numeric vectors.
+///   * Expression parsing and evaluation.
+///   * Conversions to and from the Arrow C data interface.
 ///
 ///  @param m Module to add bindings too.
 ///  @param asModuleLocalDefinitions If true then these bindings are only
@@ -442,6 +492,7 @@ inline void addVeloxBindings(
   addDataTypeBindings(m, asModuleLocalDefinitions);
   addVectorBindings(m, asModuleLocalDefinitions);
   addExpressionBindings(m, asModuleLocalDefinitions);
+  addArrowBindings(m);
   auto atexit = py::module_::import("atexit");
   atexit.attr("register")(
       py::cpp_function([]() { PyVeloxContext::cleanup(); }));
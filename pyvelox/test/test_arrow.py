@@ -0,0 +1,68 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import pyvelox.pyvelox as pv
+
+try:
+    import pyarrow as pa
+
+    import pyvelox.arrow as pva
+except ImportError:
+    pa = None
+
+
+@unittest.skipIf(pa is None, "requires pyarrow")
+class TestArrow(unittest.TestCase):
+    def test_to_pyarrow(self):
+        array = pva.to_pyarrow(pv.from_list([1, None, 3]))
+        self.assertEqual(array.type, pa.int64())
+        self.assertEqual(array.to_pylist(), [1, None, 3])
+
+        array = pva.to_pyarrow(pv.from_list(["a", "longer than twelve", None]))
+        self.assertEqual(array.to_pylist(), ["a", "longer than twelve", None])
+
+    def test_from_pyarrow(self):
+        vector = pva.from_pyarrow(pa.array([1.5, None, 2.5]))
+        self.assertEqual(vector.dtype(), pv.DoubleType())
+        self.assertEqual([vector[i] for i in range(len(vector))], [1.5, None, 2.5])
+
+        # The values are shared with the Arrow array.
+        vector = pva.from_pyarrow(pa.array([4, 5, 6], type=pa.int64()))
+        self.assertEqual(memoryview(vector).tolist(), [4, 5, 6])
+
+    def test_run(self):
+        schema = pa.schema([("a", pa.int64()), ("b", pa.string())])
+        batches = [
+            pa.record_batch(
+                [
+                    pa.array(list(range(i * 100, (i + 1) * 100))),
+                    pa.array([str(j % 7) for j in range(100)]),
+                ],
+                schema=schema,
+            )
+            for i in range(5)
+        ]
+        reader = pva.run(
+            (schema, batches),
+            filter="a % 3 = 0",
+            projections=["a * 2 AS x", "b"],
+        )
+        table = reader.read_all()
+        self.assertEqual(table.column_names, ["x", "b"])
+        expected = [a * 2 for a in range(500) if a % 3 == 0]
+        self.assertEqual(table.column("x").to_pylist(), expected)
+        expected = [str(a % 100 % 7) for a in range(500) if a % 3 == 0]
+        self.assertEqual(table.column("b").to_pylist(), expected)
@@ -156,3 +156,13 @@ class TestVeloxVector(unittest.TestCase):
 
         with self.assertRaises(TypeError):
             ints2.append(strs2)
+
+    def test_buffer_protocol(self):
+        ints = pv.from_list([1, 2, 3, 4])
+        view = memoryview(ints)
+        self.assertTrue(view.readonly)
+        self.assertEqual(view.itemsize, 8)
+        self.assertEqual(view.tolist(), [1, 2, 3, 4])
+
+        doubles = pv.from_list([0.5, 1.5])
+        self.assertEqual(memoryview(doubles).tolist(), [0.5, 1.5])
@@ -50,6 +50,8 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
  public:
   explicit LikeFunctionsBenchmark() {
     exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
+    exec::registerStatefulVectorFunction(
+        "re2_search", re2SearchSignatures(), makeRe2Search);
 
     VectorFuzzer::Options opts;
     opts.vectorSize = FLAGS_vector_size;
@@ -91,6 +93,12 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
         auto fixedPatternString = inputString.substr(fixedPatternStartIdx, 10);
         return generateRandomString(kAnyWildcardCharacter) + fixedPatternString;
       }
+      case PatternKind::kSubstring: {
+        auto fixedPatternStartIdx = inputString.size() / 3;
+        auto fixedPatternString = inputString.substr(fixedPatternStartIdx, 10);
+        return generateRandomString(kAnyWildcardCharacter) +
+            fixedPatternString + generateRandomString(kAnyWildcardCharacter);
+      }
       default:
         return inputString;
     }
@@ -124,13 +132,25 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
   }
 
   size_t run(const TpchBenchmarkCase tpchCase, const StringView patternString) {
+    return runExpression(
+        tpchCase, fmt::format("like(c0, '{}')", patternString));
+  }
+
+  // Evaluates 're2_search' over the TPC-H column of 'tpchCase'.
+  size_t runRegex(const TpchBenchmarkCase tpchCase, const StringView pattern) {
+    return runExpression(
+        tpchCase, fmt::format("re2_search(c0, '{}')", pattern));
+  }
+
+  size_t runExpression(
+      const TpchBenchmarkCase tpchCase,
+      const std::string& expression) {
     folly::BenchmarkSuspender kSuspender;
     const auto input = getTpchData(tpchCase);
     const auto data = makeRowVector({input});
-    auto likeExpression = fmt::format("like(c0, '{}')", patternString);
     auto rowType = std::dynamic_pointer_cast<const RowType>(data->type());
     exec::ExprSet exprSet =
-        FunctionBenchmarkBase::compileExpression(likeExpression, rowType);
+        FunctionBenchmarkBase::compileExpression(expression, rowType);
     kSuspender.dismiss();
 
     size_t cnt = 0;
@@ -199,6 +219,10 @@ BENCHMARK(suffixPattern) {
   benchmark->run(PatternKind::kSuffix);
 }
 
+BENCHMARK(substringPattern) {
+  benchmark->run(PatternKind::kSubstring);
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(tpchQuery2) {
@@ -230,6 +254,25 @@ BENCHMARK(tpchQuery20) {
   benchmark->run(TpchBenchmarkCase::TpchQuery20, "forest%");
 }
 
+BENCHMARK_DRAW_LINE();
+
+// Generic patterns evaluated with RE2 after the required literal prefilter.
+BENCHMARK(genericUnderscore) {
+  benchmark->run(TpchBenchmarkCase::TpchQuery13, "%special_requests%");
+}
+
+BENCHMARK(genericNoMatch) {
+  benchmark->run(TpchBenchmarkCase::TpchQuery13, "%pending%xyzzy_%");
+}
+
+BENCHMARK(regexSearch) {
+  benchmark->runRegex(TpchBenchmarkCase::TpchQuery13, "special.*requests");
+}
+
+BENCHMARK(regexSearchNoMatch) {
+  benchmark->runRegex(TpchBenchmarkCase::TpchQuery13, "[0-9]+xyzzy");
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+
+#include <fstream>
+#include <regex>
+
+#include "velox/common/file/File.h"
+#include "velox/common/time/Timer.h"
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/tests/utils/FilterGenerator.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+#endif
+
+DEFINE_int32(num_rows, 1'000'000, "Number of rows of each file");
+DEFINE_int32(write_batch_size, 10'000, "Number of rows of each written batch");
+DEFINE_int32(read_batch_size, 10'000, "Number of rows of each read batch");
+DEFINE_int32(num_repeats, 3, "Number of reads of each file. Reports the best");
+DEFINE_int32(seed, 1, "Seed of the data and filter generation");
+DEFINE_string(formats, "dwrf,parquet", "Comma separated file formats");
+DEFINE_string(
+    types,
+    "",
+    "Comma separated types to scan from: bigint, integer, smallint, double, "
+    "real, boolean, varchar, array, map, struct, array_array, struct_struct. "
+    "Empty means all");
+DEFINE_string(
+    null_ratios,
+    "0,0.1,0.5",
+    "Comma separated ratios of null values, including nested values");
+DEFINE_string(
+    selectivities,
+    "100,50,10,1",
+    "Comma separated percentages of rows passing the filter. 100 means no "
+    "filter. Scalar columns are filtered on themselves, complex columns on a "
+    "bigint column next to them");
+DEFINE_string(
+    encodings,
+    "plain,dictionary",
+    "Comma separated encodings. 'dictionary' writes 1000 distinct values with "
+    "dictionary encoding enabled, 'plain' random values with dictionary "
+    "encoding disabled");
+DEFINE_string(
+    filter,
+    "",
+    "If set, only runs the configurations whose name matches this regex");
+DEFINE_string(
+    json_output,
+    "",
+    "If set, writes the results of all configurations as JSON to this file");
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+
+/// Scans a column of one type, written with one format, encoding and null
+/// ratio, with a filter of a given selectivity.
+struct ScanConfig {
+  std::string format;
+  std::string typeName;
+  TypePtr type;
+  std::string encoding;
+  double nullRatio;
+  int32_t selectivityPct;
+
+  std::string name() const {
+    return fmt::format(
+        "{}_{}_{}_nulls{}_select{}",
+        format,
+        typeName,
+        encoding,
+        static_cast<int32_t>(nullRatio * 100),
+        selectivityPct);
+  }
+
+  bool dictionary() const {
+    return encoding == "dictionary";
+  }
+};
+
+struct ScanResult {
+  uint64_t numRows{0};
+  uint64_t numPassed{0};
+  uint64_t fileBytes{0};
+  uint64_t dataBytes{0};
+  uint64_t bestMicros{0};
+
+  double rowsPerSecond() const {
+    return numRows * 1'000'000.0 / std::max<uint64_t>(bestMicros, 1);
+  }
+
+  double fileBytesPerSecond() const {
+    return fileBytes * 1'000'000.0 / std::max<uint64_t>(bestMicros, 1);
+  }
+
+  double dataBytesPerSecond() const {
+    return dataBytes * 1'000'000.0 / std::max<uint64_t>(bestMicros, 1);
+  }
+};
+
+const std::vector<std::pair<std::string, TypePtr>>& allTypes() {
+  static const std::vector<std::pair<std::string, TypePtr>> kTypes = {
+      {"bigint", BIGINT()},
+      {"integer", INTEGER()},
+      {"smallint", SMALLINT()},
+      {"double", DOUBLE()},
+      {"real", REAL()},
+      {"boolean", BOOLEAN()},
+      {"varchar", VARCHAR()},
+      {"array", ARRAY(BIGINT())},
+      {"map", MAP(BIGINT(), DOUBLE())},
+      {"struct", ROW({"a", "b"}, {BIGINT(), VARCHAR()})},
+      {"array_array", ARRAY(ARRAY(BIGINT()))},
+      {"struct_struct", ROW({"a"}, {ROW({"b"}, {BIGINT()})})},
+  };
+  return kTypes;
+}
+
+// Returns true if the column of 'type' is filtered on itself.
+bool isFilterable(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BIGINT:
+    case TypeKind::INTEGER:
+    case TypeKind::SMALLINT:
+    case TypeKind::DOUBLE:
+    case TypeKind::REAL:
+    case TypeKind::VARCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::vector<std::string> splitFlag(const std::string& flag) {
+  std::vector<std::string> values;
+  folly::split(',', flag, values, true);
+  return values;
+}
+
+class ScanBenchmark {
+ public:
+  ScanBenchmark()
+      : rootPool_(memory::defaultMemoryManager().addRootPool("ScanBenchmark")),
+        leafPool_(rootPool_->addLeafChild("ScanBenchmark")) {}
+
+  ScanResult run(const ScanConfig& config) {
+    auto batches = makeData(config);
+    const auto file = write(config, batches);
+    std::string_view data(file);
+
+    ScanResult result;
+    result.fileBytes = data.size();
+    for (const auto& batch : batches) {
+      result.numRows += batch->size();
+      result.dataBytes += batch->estimateFlatSize();
+    }
+
+    auto scanSpec = makeScanSpec(config, batches);
+    for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+      uint64_t micros = 0;
+      uint64_t numPassed = 0;
+      {
+        MicrosecondTimer timer(&micros);
+        numPassed = read(config, data, scanSpec);
+      }
+      if (repeat == 0 || micros < result.bestMicros) {
+        result.bestMicros = micros;
+      }
+      result.numPassed = numPassed;
+    }
+    return result;
+  }
+
+ private:
+  // Returns the row type of the file of 'config'. Complex columns get a
+  // bigint column to filter on.
+  static RowTypePtr rowType(const ScanConfig& config) {
+    if (isFilterable(config.type) || config.selectivityPct >= 100) {
+      return ROW({"c"}, {config.type});
+    }
+    return ROW({"k", "c"}, {BIGINT(), config.type});
+  }
+
+  std::vector<RowVectorPtr> makeData(const ScanConfig& config) {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_write_batch_size;
+    options.nullRatio = config.nullRatio;
+    options.stringVariableLength = true;
+    options.stringLength = 20;
+    options.containerLength = 5;
+    options.complexElementsMaxSize = 10 * FLAGS_write_batch_size;
+    VectorFuzzer fuzzer(options, leafPool_.get(), FLAGS_seed);
+
+    const auto type = rowType(config);
+    distinctValues_.clear();
+    distinctValues_.resize(type->size());
+    std::vector<RowVectorPtr> batches;
+    for (auto row = 0; row < FLAGS_num_rows; row += FLAGS_write_batch_size) {
+      const auto size = std::min(FLAGS_write_batch_size, FLAGS_num_rows - row);
+      std::vector<VectorPtr> children;
+      for (auto i = 0; i < type->size(); ++i) {
+        children.push_back(
+            makeColumn(fuzzer, type->childAt(i), size, config, i));
+      }
+      batches.push_back(std::make_shared<RowVector>(
+          leafPool_.get(), type, nullptr, size, std::move(children)));
+    }
+    return batches;
+  }
+
+  // Returns a flat column of 'size' rows. With dictionary encoding, the
+  // values are drawn from 1000 distinct values of the column at 'column'.
+  VectorPtr makeColumn(
+      VectorFuzzer& fuzzer,
+      const TypePtr& type,
+      vector_size_t size,
+      const ScanConfig& config,
+      column_index_t column) {
+    if (!config.dictionary()) {
+      return fuzzer.fuzzFlat(type, size);
+    }
+    auto& distinctValues = distinctValues_[column];
+    if (!distinctValues) {
+      distinctValues = fuzzer.fuzzFlat(type, 1'000);
+    }
+    auto indices = allocateIndices(size, leafPool_.get());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = folly::Random::rand32(1'000, rng_);
+    }
+    auto result = BaseVector::create(type, size, leafPool_.get());
+    result->copy(
+        BaseVector::wrapInDictionary(nullptr, indices, size, distinctValues)
+            .get(),
+        0,
+        0,
+        size);
+    return result;
+  }
+
+  // Writes 'batches' in the format of 'config' and returns the file. The
+  // writers own their sink, so the data is copied out before the writer is
+  // destroyed.
+  std::string write(
+      const ScanConfig& config,
+      const std::vector<RowVectorPtr>& batches) {
+    size_t capacity = 64 << 20;
+    for (const auto& batch : batches) {
+      capacity += 2 * batch->estimateFlatSize();
+    }
+    auto sink = std::make_unique<MemorySink>(*leafPool_, capacity);
+    auto* sinkPtr = sink.get();
+
+    if (config.format == "dwrf") {
+      auto dwrfConfig = std::make_shared<dwrf::Config>();
+      const float threshold = config.dictionary() ? 1.0 : 0.0;
+      dwrfConfig->set(
+          dwrf::Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD, threshold);
+      dwrfConfig->set(
+          dwrf::Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, threshold);
+      dwrf::WriterOptions options;
+      options.config = dwrfConfig;
+      options.schema = batches[0]->type();
+      dwrf::Writer writer(options, std::move(sink), *rootPool_);
+      for (const auto& batch : batches) {
+        writer.write(batch);
+      }
+      writer.close();
+      return std::string(sinkPtr->getData(), sinkPtr->size());
+    }
+#ifdef VELOX_ENABLE_PARQUET
+    if (config.format == "parquet") {
+      auto builder = ::parquet::WriterProperties::Builder();
+      if (!config.dictionary()) {
+        builder.disable_dictionary();
+      }
+      parquet::Writer writer(
+          std::move(sink), *leafPool_, 10'000, builder.build());
+      for (const auto& batch : batches) {
+        writer.write(batch);
+      }
+      writer.close();
+      return std::string(sinkPtr->getData(), sinkPtr->size());
+    }
+#endif
+    VELOX_USER_FAIL("Unsupported file format: {}", config.format);
+  }
+
+  std::shared_ptr<ScanSpec> makeScanSpec(
+      const ScanConfig& config,
+      const std::vector<RowVectorPtr>& batches) {
+    auto type = rowType(config);
+    FilterGenerator filterGenerator(type, FLAGS_seed);
+    std::vector<FilterSpec> filterSpecs;
+    if (config.selectivityPct < 100) {
+      filterSpecs.emplace_back(
+          isFilterable(config.type) ? "c" : "k",
+          0,
+          config.selectivityPct,
+          FilterKind::kBigintRange,
+          false,
+          false);
+    }
+    std::vector<uint64_t> hitRows;
+    auto filters =
+        filterGenerator.makeSubfieldFilters(filterSpecs, batches, hitRows);
+    return filterGenerator.makeScanSpec(std::move(filters));
+  }
+
+  std::unique_ptr<Reader> makeReader(
+      const ScanConfig& config,
+      std::string_view data) {
+    ReaderOptions readerOptions{leafPool_.get()};
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), *leafPool_);
+    if (config.format == "dwrf") {
+      return std::make_unique<dwrf::DwrfReader>(
+          readerOptions, std::move(input));
+    }
+#ifdef VELOX_ENABLE_PARQUET
+    if (config.format == "parquet") {
+      return std::make_unique<parquet::ParquetReader>(
+          std::move(input), readerOptions);
+    }
+#endif
+    VELOX_USER_FAIL("Unsupported file format: {}", config.format);
+  }
+
+  // Reads all of 'data' with 'scanSpec' and returns the number of rows that
+  // pass the filter.
+  uint64_t read(
+      const ScanConfig& config,
+      std::string_view data,
+      const std::shared_ptr<ScanSpec>& scanSpec) {
+    auto reader = makeReader(config, data);
+    const auto type = rowType(config);
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.select(
+        std::make_shared<ColumnSelector>(type, type->names()));
+    rowReaderOptions.setScanSpec(scanSpec);
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+    auto result = BaseVector::create(type, 0, leafPool_.get());
+    uint64_t numPassed = 0;
+    while (rowReader->next(FLAGS_read_batch_size, result)) {
+      auto* rowVector = result->asUnchecked<RowVector>();
+      for (auto& child : rowVector->children()) {
+        child->loadedVector();
+      }
+      numPassed += rowVector->size();
+    }
+    return numPassed;
+  }
+
+  std::shared_ptr<memory::MemoryPool> rootPool_;
+  std::shared_ptr<memory::MemoryPool> leafPool_;
+  folly::Random::DefaultGenerator rng_{static_cast<uint32_t>(FLAGS_seed)};
+  // The values of each column with dictionary encoding.
+  std::vector<VectorPtr> distinctValues_;
+};
+
+
+std::vector<ScanConfig> makeConfigs() {
+  std::vector<std::string> typeNames = splitFlag(FLAGS_types);
+  std::vector<std::pair<std::string, TypePtr>> types;
+  for (const auto& [name, type] : allTypes()) {
+    if (typeNames.empty() ||
+        std::find(typeNames.begin(), typeNames.end(), name) !=
+            typeNames.end()) {
+      types.emplace_back(name, type);
+    }
+  }
+
+  std::optional<std::regex> filter;
+  if (!FLAGS_filter.empty()) {
+    filter = std::regex(FLAGS_filter);
+  }
+  std::vector<ScanConfig> configs;
+  for (const auto& format : splitFlag(FLAGS_formats)) {
+#ifndef VELOX_ENABLE_PARQUET
+    if (format == "parquet") {
+      LOG(WARNING) << "Skipping Parquet, which is not enabled in this build";
+      continue;
+    }
+#endif
+    for (const auto& [typeName, type] : types) {
+      for (const auto& encoding : splitFlag(FLAGS_encodings)) {
+        VELOX_USER_CHECK(
+            encoding == "plain" || encoding == "dictionary",
+            "Unknown encoding: {}",
+            encoding);
+        for (const auto& nullRatio : splitFlag(FLAGS_null_ratios)) {
+          for (const auto& selectivity : splitFlag(FLAGS_selectivities)) {
+            ScanConfig config{
+                format,
+                typeName,
+                type,
+                encoding,
+                folly::to<double>(nullRatio),
+                folly::to<int32_t>(selectivity)};
+            if (!filter || std::regex_search(config.name(), *filter)) {
+              configs.push_back(std::move(config));
+            }
+          }
+        }
+      }
+    }
+  }
+  return configs;
+}
+
+void printResult(const ScanConfig& config, const ScanResult& result) {
+  std::cout << fmt::format(
+                   "{:<50} {:>10} {:>10} {:>12.0f} {:>10.1f} {:>10.1f}",
+                   config.name(),
+                   result.numRows,
+                   result.numPassed,
+                   result.rowsPerSecond(),
+                   result.fileBytesPerSecond() / (1 << 20),
+                   result.dataBytesPerSecond() / (1 << 20))
+            << std::endl;
+}
+
+folly::dynamic toJson(const ScanConfig& config, const ScanResult& result) {
+  folly::dynamic json = folly::dynamic::object;
+  json["name"] = config.name();
+  json["format"] = config.format;
+  json["type"] = config.type->toString();
+  json["encoding"] = config.encoding;
+  json["nullRatio"] = config.nullRatio;
+  json["selectivityPct"] = config.selectivityPct;
+  json["numRows"] = result.numRows;
+  json["numPassed"] = result.numPassed;
+  json["fileBytes"] = result.fileBytes;
+  json["dataBytes"] = result.dataBytes;
+  json["micros"] = result.bestMicros;
+  json["rowsPerSecond"] = result.rowsPerSecond();
+  json["fileBytesPerSecond"] = result.fileBytesPerSecond();
+  json["dataBytesPerSecond"] = result.dataBytesPerSecond();
+  return json;
+}
+
+} // namespace
+
+// Writes a file per configuration of format, type, encoding and null ratio
+// and reads it with filters of different selectivity, e.g.:
+//
+//   velox_scan_benchmark --types=bigint,map --formats=dwrf
+//       --selectivities=100,10 --json_output=/tmp/scan.json
+//
+// Prints the rows read per second and the throughput in MB/s of the file and
+// of the flat data it holds.
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  auto configs = makeConfigs();
+  std::cout << fmt::format(
+                   "{:<50} {:>10} {:>10} {:>12} {:>10} {:>10}",
+                   "Configuration",
+                   "Rows",
+                   "Passed",
+                   "Rows/s",
+                   "File MB/s",
+                   "Data MB/s")
+            << std::endl;
+
+  ScanBenchmark benchmark;
+  folly::dynamic results = folly::dynamic::array;
+  for (const auto& config : configs) {
+    auto result = benchmark.run(config);
+    printResult(config, result);
+    results.push_back(toJson(config, result));
+  }
+
+  if (!FLAGS_json_output.empty()) {
+    std::ofstream out(FLAGS_json_output);
+    VELOX_CHECK(out.good(), "Cannot open {}", FLAGS_json_output);
+    out << folly::toPrettyJson(results) << std::endl;
+  }
+  return 0;
+}
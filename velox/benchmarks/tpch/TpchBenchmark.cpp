@@ -15,12 +15,20 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
 
+#include <fstream>
+#include <thread>
+#include <unordered_set>
+
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
@@ -28,6 +36,8 @@
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TpcdsQueryBuilder.h"
 #include "velox/exec/tests/utils/TpchQueryBuilder.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
@@ -110,6 +120,62 @@ DEFINE_int32(
     "GB of process memory for cache and query.. if "
     "non-0, uses mmap to allocator and in-process data cache.");
 DEFINE_int32(num_repeats, 1, "Number of times to run each query");
+DEFINE_string(
+    tpcds_data_path,
+    "",
+    "Root path of TPC-DS data with the same layout as the TPC-H data. If set, "
+    "the supported TPC-DS queries are benchmarked too.");
+DEFINE_string(
+    json_output,
+    "",
+    "If set, runs each query --num_repeats times and writes the wall time, "
+    "CPU time, peak memory, spilled bytes and per operator statistics of each "
+    "run as JSON to this file instead of running the folly benchmarks.");
+
+DEFINE_int32(
+    num_concurrent_queries,
+    0,
+    "If > 0, runs the workload of --throughput_queries with this many queries "
+    "in flight and reports the throughput instead of running the benchmarks.");
+DEFINE_int32(
+    throughput_num_queries,
+    100,
+    "Total number of queries to run in the throughput mode.");
+DEFINE_string(
+    throughput_queries,
+    "",
+    "Comma separated queries of the throughput mode workload, e.g. "
+    "'tpch:1,tpch:6,tpch:6,tpcds:3'. A query id without suite is a TPC-H "
+    "query. The queries are started round robin, so that a query listed twice "
+    "runs twice as often. Defaults to all TPC-H queries and, if "
+    "--tpcds_data_path is set, all TPC-DS queries.");
+DEFINE_int32(
+    num_executor_threads,
+    0,
+    "Number of threads of the executor shared by the queries in the "
+    "throughput mode. 0 means the number of hardware threads.");
+DEFINE_bool(
+    shared_arbitrator,
+    false,
+    "If true and --cache_gb is set, the queries share the memory through the "
+    "shared memory arbitrator.");
+DEFINE_string(
+    spill_dir,
+    "",
+    "If set, the queries of the throughput mode spill to this directory.");
+
+DEFINE_bool(
+    compare_formats,
+    false,
+    "If true, runs each TPC-H query on the Parquet data of --data_path with "
+    "the native and the DuckDB Parquet readers and on the DWRF data of "
+    "--dwrf_data_path, checks that all results match and reports the scan CPU "
+    "time and bytes read of each instead of running the benchmarks.");
+DEFINE_string(
+    dwrf_data_path,
+    "",
+    "Root path of a DWRF copy of the data of --data_path for "
+    "--compare_formats. If empty, only the Parquet readers are compared.");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -128,6 +194,16 @@ class TpchBenchmark {
       allocator_ = std::make_shared<cache::AsyncDataCache>(
           allocator, memoryBytes, nullptr);
       memory::MemoryAllocator::setDefaultInstance(allocator_.get());
+      if (FLAGS_shared_arbitrator) {
+        memory::IMemoryManager::Options managerOptions;
+        managerOptions.capacity = memoryBytes;
+        managerOptions.allocator = allocator_.get();
+        managerOptions.arbitratorConfig = memory::MemoryArbitrator::Config{
+            .kind = memory::MemoryArbitrator::Kind::kShared,
+            .capacity = memoryBytes,
+            .allocator = allocator_.get()};
+        memory::MemoryManager::getInstance(managerOptions, true);
+      }
     }
     functions::prestosql::registerAllScalarFunctions();
     aggregate::prestosql::registerAllAggregateFunctions();
@@ -153,30 +229,7 @@ class TpchBenchmark {
     int32_t repeat = 0;
     try {
       for (;;) {
-        CursorParameters params;
-        params.maxDrivers = FLAGS_num_drivers;
-        params.planNode = tpchPlan.plan;
-        const int numSplitsPerFile = FLAGS_num_splits_per_file;
-
-        bool noMoreSplits = false;
-        auto addSplits = [&](exec::Task* task) {
-          if (!noMoreSplits) {
-            for (const auto& entry : tpchPlan.dataFiles) {
-              for (const auto& path : entry.second) {
-                auto const splits =
-                    HiveConnectorTestBase::makeHiveConnectorSplits(
-                        path, numSplitsPerFile, tpchPlan.dataFileFormat);
-                for (const auto& split : splits) {
-                  task->addSplit(entry.first, exec::Split(split));
-                }
-              }
-              task->noMoreSplits(entry.first);
-            }
-          }
-          noMoreSplits = true;
-        };
-        auto result = readCursor(params, addSplits);
-        ensureTaskCompletion(result.first->task().get());
+        auto result = runOnce(tpchPlan);
         if (++repeat >= FLAGS_num_repeats) {
           return result;
         }
@@ -187,23 +240,476 @@ class TpchBenchmark {
     }
   }
 
+  /// Runs 'tpchPlan' --num_repeats times and appends a JSON object with the
+  /// statistics of each run to 'runs'.
+  void runWithStats(
+      const std::string& suite,
+      int queryId,
+      const TpchPlan& tpchPlan,
+      folly::dynamic& runs) {
+    for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+      folly::dynamic entry = folly::dynamic::object;
+      entry["suite"] = suite;
+      entry["query"] = queryId;
+      entry["repeat"] = repeat;
+      try {
+        const auto [cursor, results] = runOnce(tpchPlan);
+        auto task = cursor->task();
+        const auto stats = task->taskStats();
+        uint64_t cpuNanos = 0;
+        uint64_t spilledBytes = 0;
+        for (const auto& [_, planStats] : toPlanStats(stats)) {
+          cpuNanos += planStats.cpuWallTiming.cpuNanos;
+          spilledBytes += planStats.spilledBytes;
+        }
+        vector_size_t outputRows = 0;
+        for (const auto& result : results) {
+          outputRows += result->size();
+        }
+        entry["wallMs"] = stats.executionEndTimeMs - stats.executionStartTimeMs;
+        entry["cpuNanos"] = cpuNanos;
+        entry["peakMemoryBytes"] = task->pool()->getMaxBytes();
+        entry["spilledBytes"] = spilledBytes;
+        entry["outputRows"] = outputRows;
+        entry["planNodes"] = toPlanStatsJson(stats);
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Query terminated with: " << e.what();
+        entry["error"] = e.what();
+      }
+      runs.push_back(std::move(entry));
+    }
+  }
+
+  /// Statistics of one query of the throughput mode.
+  struct QueryRun {
+    uint64_t latencyUs{0};
+    uint64_t spilledBytes{0};
+    bool failed{false};
+  };
+
+  /// Runs 'tpchPlan' once on 'executor', which is shared with the other
+  /// queries of the throughput mode.
+  QueryRun runConcurrent(const TpchPlan& tpchPlan, folly::Executor* executor) {
+    std::unordered_map<std::string, std::string> config;
+    if (!FLAGS_spill_dir.empty()) {
+      config[core::QueryConfig::kSpillEnabled] = "true";
+    }
+    auto queryCtx = std::make_shared<core::QueryCtx>(
+        executor, std::make_shared<core::MemConfig>(std::move(config)));
+
+    QueryRun run;
+    const auto startUs = getCurrentTimeMicro();
+    try {
+      const auto [cursor, results] = runOnce(tpchPlan, std::move(queryCtx));
+      for (const auto& [_, planStats] :
+           toPlanStats(cursor->task()->taskStats())) {
+        run.spilledBytes += planStats.spilledBytes;
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Query terminated with: " << e.what();
+      run.failed = true;
+    }
+    run.latencyUs = getCurrentTimeMicro() - startUs;
+    return run;
+  }
+
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
   std::shared_ptr<memory::MemoryAllocator> allocator_;
+
+ private:
+  std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> runOnce(
+      const TpchPlan& tpchPlan,
+      std::shared_ptr<core::QueryCtx> queryCtx = nullptr) {
+    CursorParameters params;
+    params.maxDrivers = FLAGS_num_drivers;
+    params.planNode = tpchPlan.plan;
+    if (queryCtx) {
+      params.queryCtx = std::move(queryCtx);
+      params.spillDirectory = FLAGS_spill_dir;
+    }
+    const int numSplitsPerFile = FLAGS_num_splits_per_file;
+
+    bool noMoreSplits = false;
+    auto addSplits = [&](exec::Task* task) {
+      if (!noMoreSplits) {
+        for (const auto& entry : tpchPlan.dataFiles) {
+          for (const auto& path : entry.second) {
+            auto const splits = HiveConnectorTestBase::makeHiveConnectorSplits(
+                path, numSplitsPerFile, tpchPlan.dataFileFormat);
+            for (const auto& split : splits) {
+              task->addSplit(entry.first, exec::Split(split));
+            }
+          }
+          task->noMoreSplits(entry.first);
+        }
+      }
+      noMoreSplits = true;
+    };
+    auto result = readCursor(params, addSplits);
+    ensureTaskCompletion(result.first->task().get());
+    return result;
+  }
 };
 
 TpchBenchmark benchmark;
 std::shared_ptr<TpchQueryBuilder> queryBuilder;
+std::shared_ptr<TpcdsQueryBuilder> tpcdsQueryBuilder;
+
+// The TPC-H queries that have a plan in TpchQueryBuilder.
+const std::vector<int> kTpchQueryIds = {1,  2,  3,  4,  5,  6,  7,  8,
+                                        9,  10, 11, 12, 13, 14, 15, 16,
+                                        17, 18, 19, 20, 21, 22};
+
+void writeJsonOutput(const std::string& path) {
+  folly::dynamic runs = folly::dynamic::array;
+  for (auto queryId : kTpchQueryIds) {
+    benchmark.runWithStats(
+        "tpch", queryId, queryBuilder->getQueryPlan(queryId), runs);
+  }
+  if (tpcdsQueryBuilder) {
+    for (auto queryId : TpcdsQueryBuilder::getQueryIds()) {
+      benchmark.runWithStats(
+          "tpcds", queryId, tpcdsQueryBuilder->getQueryPlan(queryId), runs);
+    }
+  }
+
+  folly::dynamic config = folly::dynamic::object;
+  config["numDrivers"] = FLAGS_num_drivers;
+  config["dataFormat"] = FLAGS_data_format;
+  config["numSplitsPerFile"] = FLAGS_num_splits_per_file;
+  config["numRepeats"] = FLAGS_num_repeats;
+  folly::dynamic output = folly::dynamic::object;
+  output["config"] = std::move(config);
+  output["runs"] = std::move(runs);
+
+  std::ofstream out(path);
+  VELOX_CHECK(out.good(), "Cannot open {} for writing", path);
+  out << folly::toPrettyJson(output) << std::endl;
+}
+
+struct WorkloadQuery {
+  std::string suite;
+  int queryId;
+  TpchPlan plan;
+};
+
+std::vector<WorkloadQuery> makeThroughputWorkload() {
+  std::vector<std::pair<std::string, int>> queries;
+  if (FLAGS_throughput_queries.empty()) {
+    for (auto queryId : kTpchQueryIds) {
+      queries.emplace_back("tpch", queryId);
+    }
+    if (tpcdsQueryBuilder) {
+      for (auto queryId : TpcdsQueryBuilder::getQueryIds()) {
+        queries.emplace_back("tpcds", queryId);
+      }
+    }
+  } else {
+    std::vector<std::string> names;
+    folly::split(',', FLAGS_throughput_queries, names, true);
+    for (const auto& name : names) {
+      std::string suite = "tpch";
+      std::string queryId = folly::trimWhitespace(name).str();
+      if (auto colon = queryId.find(':'); colon != std::string::npos) {
+        suite = queryId.substr(0, colon);
+        queryId = queryId.substr(colon + 1);
+      }
+      queries.emplace_back(suite, folly::to<int>(queryId));
+    }
+  }
+
+  std::vector<WorkloadQuery> workload;
+  for (const auto& [suite, queryId] : queries) {
+    if (suite == "tpch") {
+      workload.push_back({suite, queryId, queryBuilder->getQueryPlan(queryId)});
+    } else if (suite == "tpcds") {
+      VELOX_USER_CHECK_NOT_NULL(
+          tpcdsQueryBuilder, "TPC-DS queries require --tpcds_data_path");
+      workload.push_back(
+          {suite, queryId, tpcdsQueryBuilder->getQueryPlan(queryId)});
+    } else {
+      VELOX_USER_FAIL("Unknown benchmark suite: {}", suite);
+    }
+  }
+  VELOX_USER_CHECK(!workload.empty(), "The throughput workload is empty");
+  return workload;
+}
+
+// Returns the 'percentile' of 'sortedValues'.
+uint64_t percentile(const std::vector<uint64_t>& sortedValues, int percentile) {
+  if (sortedValues.empty()) {
+    return 0;
+  }
+  return sortedValues[std::min<size_t>(
+      sortedValues.size() - 1, sortedValues.size() * percentile / 100)];
+}
+
+folly::dynamic latencyJson(std::vector<uint64_t>& latenciesUs) {
+  std::sort(latenciesUs.begin(), latenciesUs.end());
+  folly::dynamic latency = folly::dynamic::object;
+  latency["count"] = latenciesUs.size();
+  latency["p50Us"] = percentile(latenciesUs, 50);
+  latency["p90Us"] = percentile(latenciesUs, 90);
+  latency["p99Us"] = percentile(latenciesUs, 99);
+  latency["maxUs"] = latenciesUs.empty() ? 0 : latenciesUs.back();
+  return latency;
+}
+
+// Runs --throughput_num_queries queries of the workload with
+// --num_concurrent_queries of them in flight. The queries share one executor,
+// the process memory manager and, with --cache_gb, the AsyncDataCache, like
+// the queries of a worker do. Prints the throughput, the latency percentiles,
+// the cache hits, the spilled bytes and the memory arbitration events and
+// writes them to --json_output if set.
+void runThroughput() {
+  const auto workload = makeThroughputWorkload();
+  const auto numThreads = FLAGS_num_executor_threads > 0
+      ? FLAGS_num_executor_threads
+      : std::thread::hardware_concurrency();
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(numThreads);
+
+  auto* dataCache =
+      dynamic_cast<cache::AsyncDataCache*>(benchmark.allocator_.get());
+  const auto cacheStatsBefore =
+      dataCache ? dataCache->refreshStats() : cache::CacheStats{};
+  auto* arbitrator = memory::MemoryManager::getInstance().arbitrator();
+  const auto arbitratorStatsBefore =
+      arbitrator ? arbitrator->stats() : memory::MemoryArbitrator::Stats{};
+
+  std::vector<TpchBenchmark::QueryRun> runs(FLAGS_throughput_num_queries);
+  std::atomic<int32_t> nextQuery{0};
+  const auto startUs = getCurrentTimeMicro();
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < FLAGS_num_concurrent_queries; ++i) {
+    threads.emplace_back([&]() {
+      for (;;) {
+        const auto index = nextQuery++;
+        if (index >= runs.size()) {
+          return;
+        }
+        runs[index] = benchmark.runConcurrent(
+            workload[index % workload.size()].plan, executor.get());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto elapsedUs = getCurrentTimeMicro() - startUs;
+
+  std::vector<uint64_t> latenciesUs;
+  std::vector<std::vector<uint64_t>> queryLatenciesUs(workload.size());
+  uint64_t numFailed = 0;
+  uint64_t spilledBytes = 0;
+  uint64_t numSpilledQueries = 0;
+  for (auto i = 0; i < runs.size(); ++i) {
+    if (runs[i].failed) {
+      ++numFailed;
+      continue;
+    }
+    latenciesUs.push_back(runs[i].latencyUs);
+    queryLatenciesUs[i % workload.size()].push_back(runs[i].latencyUs);
+    spilledBytes += runs[i].spilledBytes;
+    numSpilledQueries += runs[i].spilledBytes > 0;
+  }
+
+  folly::dynamic output = folly::dynamic::object;
+  output["numConcurrentQueries"] = FLAGS_num_concurrent_queries;
+  output["numExecutorThreads"] = numThreads;
+  output["numQueries"] = runs.size();
+  output["numFailedQueries"] = numFailed;
+  output["elapsedUs"] = elapsedUs;
+  output["qps"] = (runs.size() - numFailed) * 1'000'000.0 / elapsedUs;
+  output["latency"] = latencyJson(latenciesUs);
+  folly::dynamic queries = folly::dynamic::array;
+  for (auto i = 0; i < workload.size(); ++i) {
+    auto query = latencyJson(queryLatenciesUs[i]);
+    query["suite"] = workload[i].suite;
+    query["query"] = workload[i].queryId;
+    queries.push_back(std::move(query));
+  }
+  output["queries"] = std::move(queries);
+  output["spilledBytes"] = spilledBytes;
+  output["numSpilledQueries"] = numSpilledQueries;
+  if (dataCache) {
+    const auto cacheStats = dataCache->refreshStats();
+    const auto numHit = cacheStats.numHit - cacheStatsBefore.numHit;
+    const auto numNew = cacheStats.numNew - cacheStatsBefore.numNew;
+    folly::dynamic cacheJson = folly::dynamic::object;
+    cacheJson["numHit"] = numHit;
+    cacheJson["hitBytes"] = cacheStats.hitBytes - cacheStatsBefore.hitBytes;
+    cacheJson["numNew"] = numNew;
+    cacheJson["numEvict"] = cacheStats.numEvict - cacheStatsBefore.numEvict;
+    cacheJson["hitRate"] =
+        numHit + numNew == 0 ? 0.0 : numHit / double(numHit + numNew);
+    output["cache"] = std::move(cacheJson);
+  }
+  if (arbitrator) {
+    const auto stats = arbitrator->stats();
+    folly::dynamic arbitration = folly::dynamic::object;
+    arbitration["numRequests"] =
+        stats.numRequests - arbitratorStatsBefore.numRequests;
+    arbitration["numFailures"] =
+        stats.numFailures - arbitratorStatsBefore.numFailures;
+    arbitration["queueTimeUs"] =
+        stats.queueTimeUs - arbitratorStatsBefore.queueTimeUs;
+    arbitration["arbitrationTimeUs"] =
+        stats.arbitrationTimeUs - arbitratorStatsBefore.arbitrationTimeUs;
+    arbitration["reclaimedBytes"] =
+        stats.numReclaimedBytes - arbitratorStatsBefore.numReclaimedBytes;
+    arbitration["cacheShrunkBytes"] =
+        stats.numCacheShrunkBytes - arbitratorStatsBefore.numCacheShrunkBytes;
+    output["arbitration"] = std::move(arbitration);
+  }
+
+  std::cout << folly::toPrettyJson(output) << std::endl;
+  if (!FLAGS_json_output.empty()) {
+    std::ofstream out(FLAGS_json_output);
+    VELOX_CHECK(out.good(), "Cannot open {} for writing", FLAGS_json_output);
+    out << folly::toPrettyJson(output) << std::endl;
+  }
+}
+
+// The format and the reader of a --compare_formats run.
+struct ReadPath {
+  std::string name;
+  std::shared_ptr<TpchQueryBuilder> builder;
+  std::optional<parquet::ParquetReaderType> parquetReader;
+};
+
+// Adds the ids of the TableScan nodes in 'node' and its sources to 'ids'.
+void findTableScans(
+    const core::PlanNodePtr& node,
+    std::unordered_set<core::PlanNodeId>& ids) {
+  if (std::dynamic_pointer_cast<const core::TableScanNode>(node)) {
+    ids.insert(node->id());
+  }
+  for (const auto& source : node->sources()) {
+    findTableScans(source, ids);
+  }
+}
+
+// Runs each TPC-H query with each read path, checks that the results match
+// the results of the first read path and prints the wall time, the CPU time
+// of the scans and the bytes read by the scans. Writes them to --json_output
+// if set. Returns false if any results differ or any query fails.
+bool runFormatComparison() {
+  VELOX_USER_CHECK_EQ(
+      FLAGS_data_format,
+      "parquet",
+      "--compare_formats reads the Parquet data of --data_path");
+  std::vector<ReadPath> readPaths = {
+      {"parquet_native", queryBuilder, parquet::ParquetReaderType::NATIVE},
+      {"parquet_duckdb", queryBuilder, parquet::ParquetReaderType::DUCKDB}};
+  if (!FLAGS_dwrf_data_path.empty()) {
+    auto dwrfBuilder = std::make_shared<TpchQueryBuilder>(FileFormat::DWRF);
+    dwrfBuilder->initialize(FLAGS_dwrf_data_path);
+    readPaths.push_back({"dwrf", std::move(dwrfBuilder), std::nullopt});
+  }
+
+  bool allMatch = true;
+  folly::dynamic runs = folly::dynamic::array;
+  std::cout << fmt::format(
+                   "{:>6} {:>15} {:>10} {:>12} {:>12} {:>8}",
+                   "query",
+                   "read path",
+                   "wall ms",
+                   "scan cpu ms",
+                   "scan bytes",
+                   "matches")
+            << std::endl;
+  for (auto queryId : kTpchQueryIds) {
+    std::vector<RowVectorPtr> expected;
+    for (auto i = 0; i < readPaths.size(); ++i) {
+      const auto& readPath = readPaths[i];
+      if (readPath.parquetReader.has_value()) {
+        parquet::unregisterParquetReaderFactory();
+        parquet::registerParquetReaderFactory(readPath.parquetReader.value());
+      }
+      const auto plan = readPath.builder->getQueryPlan(queryId);
+      folly::dynamic entry = folly::dynamic::object;
+      entry["query"] = queryId;
+      entry["readPath"] = readPath.name;
+      const auto [cursor, results] = benchmark.run(plan);
+      if (!cursor) {
+        allMatch = false;
+        entry["error"] = true;
+        std::cout << fmt::format("{:>6} {:>15} failed", queryId, readPath.name)
+                  << std::endl;
+        runs.push_back(std::move(entry));
+        continue;
+      }
+
+      std::unordered_set<core::PlanNodeId> scanIds;
+      findTableScans(plan.plan, scanIds);
+      const auto stats = cursor->task()->taskStats();
+      uint64_t scanCpuNanos = 0;
+      uint64_t scanBytes = 0;
+      for (const auto& [id, planStats] : toPlanStats(stats)) {
+        if (scanIds.count(id)) {
+          scanCpuNanos += planStats.cpuWallTiming.cpuNanos;
+          scanBytes += planStats.rawInputBytes;
+        }
+      }
+      bool matches = true;
+      if (i == 0) {
+        expected = results;
+      } else {
+        matches = assertEqualResults(expected, results);
+        allMatch &= matches;
+      }
+      const auto wallMs = stats.executionEndTimeMs - stats.executionStartTimeMs;
+      entry["wallMs"] = wallMs;
+      entry["scanCpuNanos"] = scanCpuNanos;
+      entry["scanBytes"] = scanBytes;
+      entry["matches"] = matches;
+      std::cout << fmt::format(
+                       "{:>6} {:>15} {:>10} {:>12.1f} {:>12} {:>8}",
+                       queryId,
+                       readPath.name,
+                       wallMs,
+                       scanCpuNanos / 1e6,
+                       succinctBytes(scanBytes),
+                       matches ? "yes" : "NO")
+                << std::endl;
+      runs.push_back(std::move(entry));
+    }
+  }
+
+  if (!FLAGS_json_output.empty()) {
+    folly::dynamic output = folly::dynamic::object;
+    output["numDrivers"] = FLAGS_num_drivers;
+    output["numSplitsPerFile"] = FLAGS_num_splits_per_file;
+    output["numRepeats"] = FLAGS_num_repeats;
+    output["allMatch"] = allMatch;
+    output["runs"] = std::move(runs);
+    std::ofstream out(FLAGS_json_output);
+    VELOX_CHECK(out.good(), "Cannot open {} for writing", FLAGS_json_output);
+    out << folly::toPrettyJson(output) << std::endl;
+  }
+  return allMatch;
+}
 
 BENCHMARK(q1) {
   const auto planContext = queryBuilder->getQueryPlan(1);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -234,6 +740,11 @@ BENCHMARK(q10) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q12) {
   const auto planContext = queryBuilder->getQueryPlan(12);
   benchmark.run(planContext);
@@ -298,7 +809,28 @@ int main(int argc, char** argv) {
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
   queryBuilder->initialize(FLAGS_data_path);
-  if (FLAGS_run_query_verbose == -1) {
+  if (!FLAGS_tpcds_data_path.empty()) {
+    tpcdsQueryBuilder =
+        std::make_shared<TpcdsQueryBuilder>(toFileFormat(FLAGS_data_format));
+    tpcdsQueryBuilder->initialize(FLAGS_tpcds_data_path);
+  }
+  int exitCode = 0;
+  if (FLAGS_compare_formats) {
+    exitCode = runFormatComparison() ? 0 : 1;
+  } else if (FLAGS_num_concurrent_queries > 0) {
+    runThroughput();
+  } else if (!FLAGS_json_output.empty()) {
+    writeJsonOutput(FLAGS_json_output);
+  } else if (FLAGS_run_query_verbose == -1) {
+    if (tpcdsQueryBuilder) {
+      for (auto queryId : TpcdsQueryBuilder::getQueryIds()) {
+        folly::addBenchmark(
+            __FILE__, fmt::format("tpcds_q{}", queryId), [queryId]() {
+              benchmark.run(tpcdsQueryBuilder->getQueryPlan(queryId));
+              return 1u;
+            });
+      }
+    }
     folly::runBenchmarks();
   } else {
     const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
@@ -328,6 +860,7 @@ int main(int argc, char** argv) {
                      *queryPlan.plan, stats, FLAGS_include_custom_stats)
               << std::endl;
   }
+  tpcdsQueryBuilder.reset();
   queryBuilder.reset();
-  return 0;
+  return exitCode;
 }
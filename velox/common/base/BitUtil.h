@@ -436,6 +436,54 @@ forEachSetBit(const uint64_t* bits, int32_t begin, int32_t end, Callable func) {
   forEachBit(bits, begin, end, true, func);
 }
 
+/// Invokes 'func(rangeBegin, rangeEnd)' for each maximal range of consecutive
+/// set bits in [begin, end), in order. Full words of set bits are merged into
+/// one range without looking at individual bits, so that a caller can process
+/// dense ranges with loops that vectorize.
+template <typename Callable>
+inline void forEachSetRange(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    Callable func) {
+  // The range found so far. It is passed to 'func' once the next range does
+  // not continue it.
+  int32_t rangeBegin = -1;
+  int32_t rangeEnd = -1;
+  auto addRange = [&](int32_t first, int32_t last) {
+    if (first == rangeEnd) {
+      rangeEnd = last;
+      return;
+    }
+    if (rangeBegin >= 0) {
+      func(rangeBegin, rangeEnd);
+    }
+    rangeBegin = first;
+    rangeEnd = last;
+  };
+  auto partialWord = [&](int32_t idx, uint64_t mask) {
+    auto word = bits[idx] & mask;
+    while (word) {
+      const int32_t first = __builtin_ctzll(word);
+      const auto inverted = ~(word >> first);
+      const int32_t last =
+          inverted == 0 ? 64 : first + __builtin_ctzll(inverted);
+      addRange(idx * 64 + first, idx * 64 + last);
+      word = last == 64 ? 0 : word & ~lowMask(last);
+    }
+  };
+  forEachWord(begin, end, partialWord, [&](int32_t idx) {
+    if (bits[idx] == ~0ULL) {
+      addRange(idx * 64, idx * 64 + 64);
+    } else {
+      partialWord(idx, ~0ULL);
+    }
+  });
+  if (rangeBegin >= 0) {
+    func(rangeBegin, rangeEnd);
+  }
+}
+
 /// Invokes a function for each unset bit.
 template <typename Callable>
 inline void forEachUnsetBit(
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <vector>
 namespace facebook::velox {
 // Utility for combining IOs to nearby location into fewer coalesced
@@ -46,7 +47,9 @@ static constexpr int32_t kNoCoalesce = -1;
 // that correspond to an Element, skipRange adds a gap between
 // neighboring items, ioFunc takes the items, the first item to
 // process, the first item not to process, the offset of the first
-// item and a vector of Ranges.
+// item and a vector of Ranges. An IO that would span more than
+// maxIoBytes from its start to the end of the next item is not
+// extended by that item.
 template <
     typename Item,
     typename Range,
@@ -65,7 +68,8 @@ CoalesceIoStats coalesceIo(
     ItemNumRanges numRanges,
     AddRanges addRanges,
     SkipRange skipRange,
-    IoFunc ioFunc) {
+    IoFunc ioFunc,
+    int64_t maxIoBytes = std::numeric_limits<int64_t>::max()) {
   std::vector<Range> buffers;
   auto start = offsetFunc(0);
   auto lastOffset = start;
@@ -81,9 +85,11 @@ CoalesceIoStats coalesceIo(
     bool enoughRanges = (rangesForItem == kNoCoalesce ||
                          ranges.size() + rangesForItem >= rangesPerIo) &&
         !ranges.empty();
-    if (lastOffset != startOffset || enoughRanges) {
+    bool enoughBytes =
+        !ranges.empty() && startOffset + size - start > maxIoBytes;
+    if (lastOffset != startOffset || enoughRanges || enoughBytes) {
       int64_t gap = startOffset - lastOffset;
-      if (gap > 0 && gap < maxGap && !enoughRanges) {
+      if (gap > 0 && gap < maxGap && !enoughRanges && !enoughBytes) {
         // The next one is after the previous and no farther than maxGap bytes,
         // we read the gap but drop the bytes.
         result.extraBytes += gap;
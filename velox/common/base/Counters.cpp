@@ -24,6 +24,66 @@ void registerVeloxCounters() {
   // P50, P90, P99, and P100.
   REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
       kCounterHiveFileHandleGenerateLatencyMs, 10, 0, 100000, 50, 90, 99, 100);
+
+  // Track the time Drivers wait in the queue of a MultiLevelTaskExecutor in
+  // range of [0, 100s] and reports P50, P90, P99, and P100.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      kCounterDriverQueuedTimeMs, 10, 0, 100000, 50, 90, 99, 100);
+
+  // Events that are reported as they happen or as the difference since the
+  // last report of PeriodicStatsReporter are summed.
+  for (const auto& key :
+       {kCounterDriverRunningTimeUs,
+        kCounterDriverBlockedTimeUs,
+        kCounterDriverQueuedWallTimeUs,
+        kCounterNumDriverRuns,
+        kCounterNumDriverYields,
+        kCounterArbitratorNumRequests,
+        kCounterArbitratorNumFailures,
+        kCounterArbitratorQueueTimeUs,
+        kCounterArbitratorArbitrationTimeUs,
+        kCounterArbitratorShrunkBytes,
+        kCounterArbitratorReclaimedBytes,
+        kCounterCacheNumHits,
+        kCounterCacheHitBytes,
+        kCounterCacheNumNew,
+        kCounterCacheNumEvicts,
+        kCounterCacheNumEvictChecks,
+        kCounterCacheNumWaitExclusive,
+        kCounterSsdCacheEntriesRead,
+        kCounterSsdCacheBytesRead,
+        kCounterSsdCacheEntriesWritten,
+        kCounterSsdCacheBytesWritten,
+        kCounterSpillWriteBytes,
+        kCounterSpillWriteTimeUs,
+        kCounterSpillFiles,
+        kCounterExchangeReceivedBytes}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::SUM);
+  }
+
+  REPORT_ADD_STAT_EXPORT_TYPE(
+      kCounterMemoryAllocationFailures, StatType::COUNT);
+
+  // Gauges are averaged over the export interval.
+  for (const auto& key :
+       {kCounterNumBlockedDrivers,
+        kCounterNumQueuedDrivers,
+        kCounterAllocatedBytes,
+        kCounterMappedBytes,
+        kCounterAllocatorCachedBytes,
+        kCounterCacheNumEntries,
+        kCounterCacheNumEmptyEntries,
+        kCounterCacheNumSharedEntries,
+        kCounterCacheNumExclusiveEntries,
+        kCounterCacheNumPrefetchedEntries,
+        kCounterCacheTotalBytes,
+        kCounterCachePrefetchBytes,
+        kCounterCacheHitRatePct,
+        kCounterSsdCacheEntriesCached,
+        kCounterSsdCacheBytesCached,
+        kCounterExchangeQueuedBytes}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::AVG);
+  }
 }
 
 } // namespace facebook::velox
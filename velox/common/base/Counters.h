@@ -25,4 +25,116 @@ void registerVeloxCounters();
 
 constexpr folly::StringPiece kCounterHiveFileHandleGenerateLatencyMs{
     "velox.hive_file_handle_generate_latency_ms"};
+
+constexpr folly::StringPiece kCounterDriverQueuedTimeMs{
+    "velox.driver_queued_time_ms"};
+
+/// Prefix of the keys of the CPU time of the levels of a
+/// MultiLevelTaskExecutor. The level number follows the prefix.
+constexpr folly::StringPiece kCounterDriverLevelCpuTimeMs{
+    "velox.driver_level_cpu_time_ms"};
+
+/// Wall time Drivers spend in each state, reported as Drivers leave the
+/// state.
+constexpr folly::StringPiece kCounterDriverRunningTimeUs{
+    "velox.driver_running_time_us"};
+constexpr folly::StringPiece kCounterDriverBlockedTimeUs{
+    "velox.driver_blocked_time_us"};
+constexpr folly::StringPiece kCounterDriverQueuedWallTimeUs{
+    "velox.driver_queued_wall_time_us"};
+
+/// Gauges of the Drivers that are blocked and that are queued on a
+/// MultiLevelTaskExecutor. Reported by PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterNumBlockedDrivers{
+    "velox.num_blocked_drivers"};
+constexpr folly::StringPiece kCounterNumQueuedDrivers{
+    "velox.num_queued_drivers"};
+
+/// Runs and yields of Drivers on a MultiLevelTaskExecutor since the last
+/// report. Reported by PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterNumDriverRuns{"velox.num_driver_runs"};
+constexpr folly::StringPiece kCounterNumDriverYields{
+    "velox.num_driver_yields"};
+
+/// Memory of the MemoryAllocator. Reported by PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterAllocatedBytes{
+    "velox.memory_allocated_bytes"};
+constexpr folly::StringPiece kCounterMappedBytes{"velox.memory_mapped_bytes"};
+constexpr folly::StringPiece kCounterAllocatorCachedBytes{
+    "velox.memory_allocator_cached_bytes"};
+
+/// Allocations that fail in a MemoryPool, reported as they fail.
+constexpr folly::StringPiece kCounterMemoryAllocationFailures{
+    "velox.memory_allocation_failures"};
+
+/// Events of the MemoryArbitrator since the last report. Reported by
+/// PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterArbitratorNumRequests{
+    "velox.arbitrator_num_requests"};
+constexpr folly::StringPiece kCounterArbitratorNumFailures{
+    "velox.arbitrator_num_failures"};
+constexpr folly::StringPiece kCounterArbitratorQueueTimeUs{
+    "velox.arbitrator_queue_time_us"};
+constexpr folly::StringPiece kCounterArbitratorArbitrationTimeUs{
+    "velox.arbitrator_arbitration_time_us"};
+constexpr folly::StringPiece kCounterArbitratorShrunkBytes{
+    "velox.arbitrator_shrunk_bytes"};
+constexpr folly::StringPiece kCounterArbitratorReclaimedBytes{
+    "velox.arbitrator_reclaimed_bytes"};
+
+/// State of the AsyncDataCache. Reported by PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterCacheNumEntries{
+    "velox.cache_num_entries"};
+constexpr folly::StringPiece kCounterCacheNumEmptyEntries{
+    "velox.cache_num_empty_entries"};
+constexpr folly::StringPiece kCounterCacheNumSharedEntries{
+    "velox.cache_num_shared_entries"};
+constexpr folly::StringPiece kCounterCacheNumExclusiveEntries{
+    "velox.cache_num_exclusive_entries"};
+constexpr folly::StringPiece kCounterCacheNumPrefetchedEntries{
+    "velox.cache_num_prefetched_entries"};
+constexpr folly::StringPiece kCounterCacheTotalBytes{"velox.cache_total_bytes"};
+constexpr folly::StringPiece kCounterCachePrefetchBytes{
+    "velox.cache_prefetch_bytes"};
+
+/// Events of the AsyncDataCache since the last report and the percentage of
+/// lookups that hit over the same interval. Reported by
+/// PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterCacheNumHits{"velox.cache_num_hits"};
+constexpr folly::StringPiece kCounterCacheHitBytes{"velox.cache_hit_bytes"};
+constexpr folly::StringPiece kCounterCacheNumNew{"velox.cache_num_new"};
+constexpr folly::StringPiece kCounterCacheNumEvicts{"velox.cache_num_evicts"};
+constexpr folly::StringPiece kCounterCacheNumEvictChecks{
+    "velox.cache_num_evict_checks"};
+constexpr folly::StringPiece kCounterCacheNumWaitExclusive{
+    "velox.cache_num_wait_exclusive"};
+constexpr folly::StringPiece kCounterCacheHitRatePct{
+    "velox.cache_hit_rate_pct"};
+
+/// Events and state of the SsdCache. Reported by PeriodicStatsReporter.
+constexpr folly::StringPiece kCounterSsdCacheEntriesRead{
+    "velox.ssd_cache_entries_read"};
+constexpr folly::StringPiece kCounterSsdCacheBytesRead{
+    "velox.ssd_cache_bytes_read"};
+constexpr folly::StringPiece kCounterSsdCacheEntriesWritten{
+    "velox.ssd_cache_entries_written"};
+constexpr folly::StringPiece kCounterSsdCacheBytesWritten{
+    "velox.ssd_cache_bytes_written"};
+constexpr folly::StringPiece kCounterSsdCacheEntriesCached{
+    "velox.ssd_cache_entries_cached"};
+constexpr folly::StringPiece kCounterSsdCacheBytesCached{
+    "velox.ssd_cache_bytes_cached"};
+
+/// Spilled data, reported as spill files are written.
+constexpr folly::StringPiece kCounterSpillWriteBytes{
+    "velox.spill_write_bytes"};
+constexpr folly::StringPiece kCounterSpillWriteTimeUs{
+    "velox.spill_write_time_us"};
+constexpr folly::StringPiece kCounterSpillFiles{"velox.spill_files"};
+
+/// Data received by Exchanges and the data queued in all ExchangeQueues.
+constexpr folly::StringPiece kCounterExchangeReceivedBytes{
+    "velox.exchange_received_bytes"};
+constexpr folly::StringPiece kCounterExchangeQueuedBytes{
+    "velox.exchange_queued_bytes"};
 } // namespace facebook::velox
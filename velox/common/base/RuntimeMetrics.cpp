@@ -18,6 +18,7 @@
 
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/SamplingProfiler.h"
 #include "velox/common/base/SuccinctPrinter.h"
 
 namespace facebook::velox {
@@ -66,6 +67,7 @@ static thread_local BaseRuntimeStatWriter* localRuntimeStatWriter;
 
 void setThreadLocalRunTimeStatWriter(BaseRuntimeStatWriter* writer) {
   localRuntimeStatWriter = writer;
+  SamplingProfiler::writerChanged(writer);
 }
 
 BaseRuntimeStatWriter* getThreadLocalRunTimeStatWriter() {
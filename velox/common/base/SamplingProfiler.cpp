@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/SamplingProfiler.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/RuntimeMetrics.h"
+
+namespace facebook::velox {
+
+std::atomic_bool SamplingProfiler::running_{false};
+
+namespace {
+
+// What a thread was last seen doing. Written by the owning thread and read by
+// the sampling thread, both under 'mutex'. The entry is only valid for the
+// profiler run whose generation it carries. A thread that stops publishing
+// because the profiler stopped leaves a stale entry behind whose writer may
+// be gone by the time the profiler is restarted.
+struct ThreadSample {
+  std::mutex mutex;
+  BaseRuntimeStatWriter* writer{nullptr};
+  const std::string* label{nullptr};
+  uint64_t generation{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::unordered_set<ThreadSample*> threads;
+};
+
+Registry& registry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Registers the thread with the sampler on first use and unregisters it at
+// thread exit.
+struct ThreadSampleHolder {
+  ThreadSampleHolder() {
+    std::lock_guard<std::mutex> l(registry().mutex);
+    registry().threads.insert(&sample);
+  }
+
+  ~ThreadSampleHolder() {
+    std::lock_guard<std::mutex> l(registry().mutex);
+    registry().threads.erase(&sample);
+  }
+
+  ThreadSample sample;
+};
+
+std::atomic<uint64_t> generation{0};
+
+struct SamplerThread {
+  // Serializes start() and stop().
+  std::mutex controlMutex;
+  // Guards 'stopRequested'.
+  std::mutex mutex;
+  std::condition_variable stopCv;
+  bool stopRequested{false};
+  std::thread thread;
+};
+
+SamplerThread& samplerThread() {
+  static SamplerThread* sampler = new SamplerThread();
+  return *sampler;
+}
+} // namespace
+
+// static
+const std::string*& SamplingProfiler::currentLabel() {
+  static thread_local const std::string* label{nullptr};
+  return label;
+}
+
+// static
+void SamplingProfiler::publish(
+    BaseRuntimeStatWriter* writer,
+    const std::string* label) {
+  static thread_local ThreadSampleHolder holder;
+  std::lock_guard<std::mutex> l(holder.sample.mutex);
+  holder.sample.writer = writer;
+  holder.sample.label = label;
+  holder.sample.generation = generation.load(std::memory_order_acquire);
+}
+
+SamplingProfiler::LabelScope::LabelScope(const std::string& label)
+    : prevLabel_(currentLabel()) {
+  currentLabel() = &label;
+  if (running()) {
+    publish(getThreadLocalRunTimeStatWriter(), &label);
+  }
+}
+
+SamplingProfiler::LabelScope::~LabelScope() {
+  currentLabel() = prevLabel_;
+  if (running()) {
+    publish(getThreadLocalRunTimeStatWriter(), prevLabel_);
+  }
+}
+
+// static
+void SamplingProfiler::sampleAll(uint64_t nanos) {
+  const auto currentGeneration = generation.load(std::memory_order_acquire);
+  const RuntimeCounter counter(nanos, RuntimeCounter::Unit::kNanos);
+  std::lock_guard<std::mutex> registryLock(registry().mutex);
+  for (auto* sample : registry().threads) {
+    std::lock_guard<std::mutex> l(sample->mutex);
+    if (sample->generation != currentGeneration || sample->writer == nullptr) {
+      continue;
+    }
+    sample->writer->addRuntimeStat(kSampledRunningNanos, counter);
+    if (sample->label != nullptr) {
+      sample->writer->addRuntimeStat(
+          fmt::format("{}.{}", kSampledRunningNanos, *sample->label), counter);
+    }
+  }
+}
+
+// static
+void SamplingProfiler::start(std::chrono::microseconds interval) {
+  VELOX_CHECK_GT(interval.count(), 0);
+  auto& sampler = samplerThread();
+  std::lock_guard<std::mutex> l(sampler.controlMutex);
+  VELOX_CHECK(!running(), "SamplingProfiler is already running");
+  generation.fetch_add(1, std::memory_order_acq_rel);
+  sampler.stopRequested = false;
+  running_ = true;
+  sampler.thread = std::thread([interval, &sampler]() {
+    const uint64_t nanos =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+    std::unique_lock<std::mutex> stopLock(sampler.mutex);
+    while (!sampler.stopCv.wait_for(
+        stopLock, interval, [&]() { return sampler.stopRequested; })) {
+      stopLock.unlock();
+      sampleAll(nanos);
+      stopLock.lock();
+    }
+  });
+}
+
+// static
+void SamplingProfiler::stop() {
+  auto& sampler = samplerThread();
+  std::lock_guard<std::mutex> l(sampler.controlMutex);
+  if (!running()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> stopLock(sampler.mutex);
+    sampler.stopRequested = true;
+  }
+  sampler.stopCv.notify_all();
+  sampler.thread.join();
+  // Threads keep publishing until the sampling thread is gone so that it never
+  // sees a writer that went away without being unpublished.
+  running_ = false;
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace facebook::velox {
+
+class BaseRuntimeStatWriter;
+
+/// Process wide sampling profiler. While running, a background thread wakes
+/// up every 'interval' and attributes the interval to whatever each thread
+/// is doing at that moment: the runtime stat writer installed on the thread
+/// (the Operator the Driver is running, see RuntimeStatWriterScopeGuard) and
+/// the innermost label (e.g. the expression being evaluated). The samples
+/// are added to the writer as runtime stats, so they come back with the
+/// Operator stats of the Task:
+///
+///   sampledRunningNanos          - Total sampled time of the Operator.
+///   sampledRunningNanos.<label>  - Sampled time spent under <label>.
+///
+/// The profiler costs one relaxed atomic load per writer or label change
+/// when it is not running.
+class SamplingProfiler {
+ public:
+  static constexpr const char* kSampledRunningNanos = "sampledRunningNanos";
+
+  /// Starts the sampling thread. Throws if the profiler is already running.
+  static void start(std::chrono::microseconds interval);
+
+  /// Stops and joins the sampling thread. No-op if not running.
+  static void stop();
+
+  static bool running() {
+    return running_.load(std::memory_order_relaxed);
+  }
+
+  /// Takes one sample of all threads, attributing 'nanos' to each of them.
+  /// Called by the sampling thread, exposed for testing.
+  static void sampleAll(uint64_t nanos);
+
+  /// Publishes the current runtime stat writer of this thread to the
+  /// sampler. Called by setThreadLocalRunTimeStatWriter().
+  static void writerChanged(BaseRuntimeStatWriter* writer) {
+    if (running()) {
+      publish(writer, currentLabel());
+    }
+  }
+
+  /// Sets the innermost label sampled on this thread for the lifetime of the
+  /// scope. 'label' must outlive the scope.
+  class LabelScope {
+   public:
+    explicit LabelScope(const std::string& label);
+
+    ~LabelScope();
+
+   private:
+    const std::string* const prevLabel_;
+  };
+
+ private:
+  static const std::string*& currentLabel();
+
+  static void publish(
+      BaseRuntimeStatWriter* writer,
+      const std::string* label);
+
+  static std::atomic_bool running_;
+};
+
+} // namespace facebook::velox
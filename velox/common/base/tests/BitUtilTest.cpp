@@ -459,6 +459,44 @@ TEST_F(BitUtilTest, forEachBit) {
   ASSERT_EQ(totalBits - 1, count);
 }
 
+TEST_F(BitUtilTest, forEachSetRange) {
+  using Ranges = std::vector<std::pair<int32_t, int32_t>>;
+  constexpr int32_t kNumBits = 64 * 5;
+  std::vector<uint64_t> data(nwords(kNumBits));
+  // Ranges within a word, across words and over full words.
+  const Ranges ranges = {
+      {0, 1},
+      {3, 10},
+      {60, 70},
+      {127, 128},
+      {128, 256},
+      {258, 259},
+      {319, 320}};
+  for (auto [begin, end] : ranges) {
+    fillBits(data.data(), begin, end, true);
+  }
+
+  auto collectRanges = [&](int32_t begin, int32_t end) {
+    Ranges result;
+    forEachSetRange(data.data(), begin, end, [&](auto first, auto last) {
+      result.emplace_back(first, last);
+    });
+    return result;
+  };
+
+  // 127 and 128 to 256 are one range.
+  const Ranges expected = {
+      {0, 1}, {3, 10}, {60, 70}, {127, 256}, {258, 259}, {319, 320}};
+  EXPECT_EQ(collectRanges(0, kNumBits), expected);
+  EXPECT_EQ(collectRanges(5, 200), (Ranges{{5, 10}, {60, 70}, {127, 200}}));
+  EXPECT_EQ(collectRanges(61, 62), (Ranges{{61, 62}}));
+  EXPECT_TRUE(collectRanges(10, 60).empty());
+  EXPECT_TRUE(collectRanges(0, 0).empty());
+
+  std::fill(data.begin(), data.end(), ~0ULL);
+  EXPECT_EQ(collectRanges(1, kNumBits - 1), (Ranges{{1, kNumBits - 1}}));
+}
+
 TEST_F(BitUtilTest, hash) {
   std::unordered_set<size_t> hashes;
   const char* text = "Forget the night, come live with us in forests of azure";
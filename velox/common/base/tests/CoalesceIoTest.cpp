@@ -113,3 +113,36 @@ TEST(CoalesceIoTest, basic) {
   EXPECT_EQ(1, ioGroups[2].size());
   EXPECT_EQ(1, ioGroups[3].size());
 }
+
+TEST(CoalesceIoTest, maxIoBytes) {
+  std::vector<IoUnit> data;
+  // Adjacent units of 100 bytes. With a limit of 250 bytes per IO, each IO
+  // gets 2 of them.
+  for (auto i = 0; i < 5; ++i) {
+    data.emplace_back(i * 100, 100, 1);
+  }
+  std::vector<int64_t> offsets;
+  auto stats = coalesceIo<IoUnit, Range>(
+      data,
+      1000,
+      100,
+      [&](int32_t index) { return data[index].offset; },
+      [&](int32_t index) { return data[index].size; },
+      [&](int32_t index) { return data[index].numBuffers; },
+      [&](const IoUnit& item, std::vector<Range>& ranges) {
+        ranges.emplace_back(item.size, item.numBuffers);
+      },
+      [&](int32_t skip, std::vector<Range>& ranges) {
+        ranges.emplace_back(skip, 0);
+      },
+      [&](const std::vector<IoUnit>& /*items*/,
+          int32_t /*begin*/,
+          int32_t /*end*/,
+          uint64_t offset,
+          const std::vector<Range>& /*ranges*/) { offsets.push_back(offset); },
+      250);
+  EXPECT_EQ(3, stats.numIos);
+  EXPECT_EQ(0, stats.extraBytes);
+  std::vector<int64_t> expectedOffsets{0, 200, 400};
+  EXPECT_EQ(expectedOffsets, offsets);
+}
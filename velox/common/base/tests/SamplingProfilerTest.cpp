@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/SamplingProfiler.h"
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
+
+namespace facebook::velox {
+namespace {
+
+class TestWriter : public BaseRuntimeStatWriter {
+ public:
+  void addRuntimeStat(const std::string& name, const RuntimeCounter& value)
+      override {
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_[name] += value.value;
+  }
+
+  int64_t get(const std::string& name) {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = stats_.find(name);
+    return it == stats_.end() ? 0 : it->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, int64_t> stats_;
+};
+
+class SamplingProfilerTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    SamplingProfiler::stop();
+  }
+
+  static constexpr auto kNeverSample = std::chrono::hours(1);
+
+  const std::string sampledNanos_{SamplingProfiler::kSampledRunningNanos};
+};
+
+TEST_F(SamplingProfilerTest, notRunning) {
+  ASSERT_FALSE(SamplingProfiler::running());
+  TestWriter writer;
+  RuntimeStatWriterScopeGuard guard(&writer);
+  SamplingProfiler::sampleAll(100);
+  ASSERT_EQ(0, writer.get(sampledNanos_));
+}
+
+TEST_F(SamplingProfilerTest, writerAndLabels) {
+  SamplingProfiler::start(kNeverSample);
+  ASSERT_TRUE(SamplingProfiler::running());
+  VELOX_ASSERT_THROW(
+      SamplingProfiler::start(kNeverSample),
+      "SamplingProfiler is already running");
+
+  TestWriter writer;
+  const std::string outer = "outer";
+  const std::string inner = "inner";
+  {
+    RuntimeStatWriterScopeGuard guard(&writer);
+    SamplingProfiler::sampleAll(10);
+    {
+      SamplingProfiler::LabelScope outerScope(outer);
+      SamplingProfiler::sampleAll(20);
+      {
+        SamplingProfiler::LabelScope innerScope(inner);
+        SamplingProfiler::sampleAll(40);
+      }
+      SamplingProfiler::sampleAll(80);
+    }
+  }
+  // No writer on the thread, nothing is sampled.
+  SamplingProfiler::sampleAll(1000);
+
+  ASSERT_EQ(150, writer.get(sampledNanos_));
+  ASSERT_EQ(100, writer.get(sampledNanos_ + ".outer"));
+  ASSERT_EQ(40, writer.get(sampledNanos_ + ".inner"));
+}
+
+TEST_F(SamplingProfilerTest, otherThreads) {
+  SamplingProfiler::start(kNeverSample);
+  TestWriter writer;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool published = false;
+  bool done = false;
+  std::thread thread([&]() {
+    RuntimeStatWriterScopeGuard guard(&writer);
+    std::unique_lock<std::mutex> l(mutex);
+    published = true;
+    cv.notify_all();
+    cv.wait(l, [&]() { return done; });
+  });
+  {
+    std::unique_lock<std::mutex> l(mutex);
+    cv.wait(l, [&]() { return published; });
+  }
+  SamplingProfiler::sampleAll(10);
+  {
+    std::lock_guard<std::mutex> l(mutex);
+    done = true;
+  }
+  cv.notify_all();
+  thread.join();
+  // The thread is gone and unregistered itself.
+  SamplingProfiler::sampleAll(10);
+  ASSERT_EQ(10, writer.get(sampledNanos_));
+}
+
+TEST_F(SamplingProfilerTest, staleAfterRestart) {
+  TestWriter writer;
+  SamplingProfiler::start(kNeverSample);
+  {
+    RuntimeStatWriterScopeGuard guard(&writer);
+    SamplingProfiler::stop();
+    // The writer change at the end of the scope is not published.
+  }
+  SamplingProfiler::start(kNeverSample);
+  SamplingProfiler::sampleAll(10);
+  ASSERT_EQ(0, writer.get(sampledNanos_));
+}
+
+TEST_F(SamplingProfilerTest, samplingThread) {
+  TestWriter writer;
+  const std::string label = "busy";
+  SamplingProfiler::start(std::chrono::microseconds(100));
+  {
+    RuntimeStatWriterScopeGuard guard(&writer);
+    SamplingProfiler::LabelScope labelScope(label);
+    while (writer.get(sampledNanos_ + ".busy") == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  SamplingProfiler::stop();
+  ASSERT_FALSE(SamplingProfiler::running());
+  ASSERT_GT(writer.get(sampledNanos_), 0);
+  ASSERT_EQ(0, writer.get(sampledNanos_) % 100'000);
+}
+
+} // namespace
+} // namespace facebook::velox
@@ -16,10 +16,13 @@
 
 #include "velox/common/caching/AsyncDataCache.h"
 #include <velox/common/base/BitUtil.h>
+#include "velox/common/caching/CacheAdmissionPolicy.h"
+#include "velox/common/caching/CacheCodec.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 
 #include <folly/executors/QueuedImmediateExecutor.h>
+#include <shared_mutex>
 #include "velox/common/caching/FileIds.h"
 
 namespace facebook::velox::cache {
@@ -27,6 +30,23 @@ namespace facebook::velox::cache {
 using memory::MachinePageCount;
 using memory::MemoryAllocator;
 
+namespace {
+// Returns the ranges of the first 'size' bytes of 'data'.
+template <typename T>
+std::vector<folly::Range<T*>> dataRanges(
+    const memory::Allocation& data,
+    uint64_t size) {
+  std::vector<folly::Range<T*>> ranges;
+  for (auto i = 0; i < data.numRuns() && size > 0; ++i) {
+    auto run = data.runAt(i);
+    const auto bytes = std::min<uint64_t>(run.numBytes(), size);
+    ranges.emplace_back(run.data<char>(), bytes);
+    size -= bytes;
+  }
+  return ranges;
+}
+} // namespace
+
 AsyncDataCacheEntry::AsyncDataCacheEntry(CacheShard* shard) : shard_(shard) {
   accessStats_.reset();
 }
@@ -40,7 +60,7 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
   numPins_ = 1;
   std::unique_ptr<folly::SharedPromise<bool>> promise;
   {
-    std::lock_guard<std::mutex> l(shard_->mutex());
+    std::lock_guard<folly::SharedMutex> l(shard_->mutex());
     // Enter the shard's mutex to make sure a promise is not being added during
     // the move.
     promise = std::move(promise_);
@@ -56,14 +76,35 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
     hook(*this);
   }
 
-  if (!ssdFile_ && shard_->cache()->ssdCache()) {
-    auto ssdCache = shard_->cache()->ssdCache();
+  auto cache = shard_->cache();
+  auto policy = cache->admissionPolicy();
+  const RawFileCacheKey rawKey{key_.fileNum.id(), key_.offset};
+  bool memoryReject = false;
+  if (policy && !policy->admitToMemory(rawKey, size_)) {
+    memoryReject = true;
+    if (isPrefetch_) {
+      evictOnFirstUse_ = true;
+    } else {
+      makeEvictable();
+    }
+  }
+
+  bool ssdReject = false;
+  if (!ssdFile_ && cache->ssdCache()) {
+    auto ssdCache = cache->ssdCache();
     assert(ssdCache); // for lint only.
     if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
-      ssdSaveable_ = true;
-      shard_->cache()->possibleSsdSave(size_);
+      if (policy && !policy->admitToSsd(rawKey, size_)) {
+        ssdReject = true;
+      } else {
+        ssdSaveable_ = true;
+        cache->possibleSsdSave(size_);
+      }
     }
   }
+  if (memoryReject || ssdReject) {
+    cache->incrementAdmissionRejects(memoryReject, ssdReject);
+  }
 }
 
 void AsyncDataCacheEntry::release() {
@@ -99,6 +140,10 @@ memory::MachinePageCount AsyncDataCacheEntry::setPrefetch(bool flag) {
 void AsyncDataCacheEntry::initialize(FileCacheKey key) {
   VELOX_CHECK(isExclusive());
   setSsdFile(nullptr, 0);
+  evictOnFirstUse_ = false;
+  // A recycled entry must not inherit the access history of its previous
+  // contents, e.g. having been made evictable.
+  accessStats_.reset();
   key_ = std::move(key);
   auto cache = shard_->cache();
   ClockTimer t(shard_->allocClocks());
@@ -150,13 +195,42 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
   return newEntry;
 }
 
+CachePin CacheShard::findShared(RawFileCacheKey key, uint64_t size) {
+  std::shared_lock<folly::SharedMutex> l(mutex_);
+  auto it = entryMap_.find(key);
+  if (it == entryMap_.end()) {
+    return CachePin();
+  }
+  auto found = it->second;
+  // An entry cannot become exclusive while 'mutex_' is held, so it is enough
+  // to check for exclusive before adding the pin.
+  auto numPins = found->numPins_.load();
+  do {
+    if (numPins < 0 || found->isPrefetch_ || found->isCompressed() ||
+        found->size() < size) {
+      return CachePin();
+    }
+  } while (!found->numPins_.compare_exchange_weak(numPins, numPins + 1));
+  ++eventCounter_;
+  found->touch();
+  ++numHit_;
+  hitBytes_ += found->size();
+  CachePin pin;
+  pin.setEntry(found);
+  return pin;
+}
+
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
+  auto pin = findShared(key, size);
+  if (!pin.empty()) {
+    return pin;
+  }
   AsyncDataCacheEntry* entryToInit = nullptr;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::unique_lock<folly::SharedMutex> l(mutex_);
     ++eventCounter_;
     auto it = entryMap_.find(key);
     if (it != entryMap_.end()) {
@@ -171,10 +245,24 @@ CachePin CacheShard::findOrCreate(
       }
       if (found->size() >= size) {
         found->touch();
+        if (found->isCompressed()) {
+          // Compressed entries are never pinned. Other lookups wait for the
+          // decompression like they wait for a load.
+          found->numPins_ = AsyncDataCacheEntry::kExclusive;
+          ++numHit_;
+          hitBytes_ += found->size();
+          ++numCompressedHit_;
+          l.unlock();
+          return decompressEntry(found);
+        }
         // The entry is in a readable state. Add a pin.
         if (found->isPrefetch_) {
           found->isFirstUse_ = true;
           found->setPrefetch(false);
+          if (found->evictOnFirstUse_) {
+            found->evictOnFirstUse_ = false;
+            found->makeEvictable();
+          }
         } else {
           ++numHit_;
           hitBytes_ += found->size();
@@ -216,7 +304,7 @@ CachePin CacheShard::findOrCreate(
 }
 
 bool CacheShard::exists(RawFileCacheKey key) const {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::shared_lock<folly::SharedMutex> l(mutex_);
   auto it = entryMap_.find(key);
   if (it != entryMap_.end()) {
     it->second->touch();
@@ -298,7 +386,7 @@ void CoalescedLoad::setEndState(LoadState endState) {
 
 std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
     AsyncDataCacheEntry* entry) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<folly::SharedMutex> l(mutex_);
   removeEntryLocked(entry);
   // After the entry is removed from the hash table, a promise can no longer
   // be made. It is safe to move the promise and realize it.
@@ -327,21 +415,28 @@ void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
       cache_->freeNonContiguous(entry->data());
     }
   }
+  // A superseded entry has no key but may still be compressed.
+  if (entry->isCompressed()) {
+    cache_->freeCompressedBytes(entry->compressed_.size());
+    std::string().swap(entry->compressed_);
+  }
 }
 
-void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
+uint64_t CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   int64_t tinyFreed = 0;
   int64_t largeFreed = 0;
   int32_t evictSaveableSkipped = 0;
   auto ssdCache = cache_->ssdCache();
   bool skipSsdSaveable = ssdCache && ssdCache->writeInProgress();
   auto now = accessTime();
+  auto codec = cache_->codec();
   std::vector<memory::Allocation> toFree;
+  std::vector<std::pair<AsyncDataCacheEntry*, int32_t>> toCompress;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<folly::SharedMutex> l(mutex_);
     int size = entries_.size();
     if (!size) {
-      return;
+      return 0;
     }
     int32_t counter = 0;
     int32_t numChecked = 0;
@@ -369,6 +464,12 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         numChecked = 0;
         eventCounter_ = 0;
       }
+      // Compressed entries hold no cache memory. They are dropped only to make
+      // space in the compressed tier.
+      if (candidate->isCompressed() && candidate->key_.fileNum.hasValue() &&
+          !evictAllUnpinned && !cache_->compressedTierFull()) {
+        continue;
+      }
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
@@ -377,6 +478,19 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
+        if (codec && !evictAllUnpinned && candidate->key_.fileNum.hasValue() &&
+            candidate->data_.numPages() > 0 && !candidate->ssdSaveable_ &&
+            score != std::numeric_limits<int32_t>::max()) {
+          // Compressed and freed outside of 'mutex_'. Lookups wait until
+          // this is done.
+          candidate->numPins_ = AsyncDataCacheEntry::kExclusive;
+          largeFreed += candidate->data_.byteSize();
+          toCompress.emplace_back(candidate, entryIndex);
+          if (largeFreed + tinyFreed > bytesToFree) {
+            break;
+          }
+          continue;
+        }
         largeFreed += candidate->data_.byteSize();
         toFree.push_back(std::move(candidate->data()));
         removeEntryLocked(candidate);
@@ -395,8 +509,13 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       }
     }
   }
-  ClockTimer t(allocClocks_);
-  freeAllocations(toFree);
+  {
+    ClockTimer t(allocClocks_);
+    freeAllocations(toFree);
+  }
+  if (!toCompress.empty()) {
+    compressEntries(toCompress);
+  }
   cache_->incrementCachedPages(
       -largeFreed / static_cast<int32_t>(memory::AllocationTraits::kPageSize));
   if (evictSaveableSkipped && ssdCache && ssdCache->startWrite()) {
@@ -408,6 +527,7 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   } else if (evictSaveableSkipped) {
     ++cache_->numSkippedSaves();
   }
+  return largeFreed;
 }
 
 void CacheShard::freeAllocations(std::vector<memory::Allocation>& allocations) {
@@ -417,6 +537,80 @@ void CacheShard::freeAllocations(std::vector<memory::Allocation>& allocations) {
   allocations.clear();
 }
 
+void CacheShard::compressEntries(
+    std::vector<std::pair<AsyncDataCacheEntry*, int32_t>>& entries) {
+  auto codec = cache_->codec();
+  for (auto [entry, entryIndex] : entries) {
+    std::string compressed;
+    {
+      ClockTimer t(compressClocks_);
+      compressed =
+          codec->compress(dataRanges<const char>(entry->data_, entry->size_));
+    }
+    const bool keep =
+        !compressed.empty() && cache_->tryAddCompressedBytes(compressed.size());
+    {
+      ClockTimer t(allocClocks_);
+      cache_->freeNonContiguous(entry->data_);
+    }
+    std::unique_ptr<folly::SharedPromise<bool>> promise;
+    {
+      std::lock_guard<folly::SharedMutex> l(mutex_);
+      if (keep) {
+        entry->compressed_ = std::move(compressed);
+        ++numCompress_;
+      } else {
+        removeEntryLocked(entry);
+        freeEntries_.push_back(std::move(entries_[entryIndex]));
+        emptySlots_.push_back(entryIndex);
+        entry->size_ = 0;
+        ++numEvict_;
+        ++numCompressFailures_;
+      }
+      entry->numPins_ = 0;
+      promise = entry->movePromise();
+    }
+    if (promise) {
+      promise->setValue(true);
+    }
+  }
+}
+
+CachePin CacheShard::decompressEntry(AsyncDataCacheEntry* entry) {
+  // The pin removes the entry if this throws.
+  CachePin pin;
+  pin.setEntry(entry);
+  ClockTimer t(decompressClocks_);
+  const auto sizePages =
+      bits::roundUp(entry->size_, memory::AllocationTraits::kPageSize) /
+      memory::AllocationTraits::kPageSize;
+  if (!cache_->allocateNonContiguous(sizePages, entry->data_)) {
+    _VELOX_THROW(
+        VeloxRuntimeError,
+        error_source::kErrorSourceRuntime.c_str(),
+        error_code::kNoCacheSpace.c_str(),
+        /* isRetriable */ true,
+        "Failed to allocate {} bytes for decompressing cache entry",
+        entry->size_);
+  }
+  cache_->incrementCachedPages(entry->data_.numPages());
+  cache_->codec()->decompress(
+      entry->compressed_, dataRanges<char>(entry->data_, entry->size_));
+  std::unique_ptr<folly::SharedPromise<bool>> promise;
+  {
+    std::lock_guard<folly::SharedMutex> l(mutex_);
+    cache_->freeCompressedBytes(entry->compressed_.size());
+    std::string().swap(entry->compressed_);
+    // The exclusive pin becomes the first shared pin.
+    entry->numPins_ = 1;
+    promise = entry->movePromise();
+  }
+  if (promise) {
+    promise->setValue(true);
+  }
+  return pin;
+}
+
 void CacheShard::calibrateThreshold() {
   auto numSamples = std::min<int32_t>(10, entries_.size());
   auto now = accessTime();
@@ -441,7 +635,7 @@ void CacheShard::calibrateThreshold() {
 }
 
 void CacheShard::updateStats(CacheStats& stats) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<folly::SharedMutex> l(mutex_);
   for (auto& entry : entries_) {
     if (!entry || !entry->key_.fileNum.hasValue()) {
       ++stats.numEmptyEntries;
@@ -458,6 +652,12 @@ void CacheShard::updateStats(CacheStats& stats) {
     ++stats.numEntries;
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
+    if (entry->isCompressed()) {
+      ++stats.numCompressed;
+      stats.compressedSize += entry->compressed_.size();
+      stats.compressedOriginalSize += entry->size_;
+      continue;
+    }
     stats.largeSize += entry->size_;
     stats.largePadding += entry->data_.byteSize() - entry->size_;
   }
@@ -469,10 +669,24 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
   stats.allocClocks += allocClocks_;
+  stats.numCompress += numCompress_;
+  stats.numCompressFailures += numCompressFailures_;
+  stats.numCompressedHit += numCompressedHit_;
+  stats.compressClocks += compressClocks_;
+  stats.decompressClocks += decompressClocks_;
+}
+
+void CacheShard::addFileBytes(FileBytesMap& fileBytes) const {
+  std::shared_lock<folly::SharedMutex> l(mutex_);
+  for (auto& entry : entries_) {
+    if (entry && entry->key_.fileNum.hasValue() && !entry->isExclusive()) {
+      fileBytes[entry->key_.fileNum.id()] += entry->size_;
+    }
+  }
 }
 
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<folly::SharedMutex> l(mutex_);
   // Do not add more than 70% of entries to a write batch.If SSD save
   // is slower than storage read, we must not have a situation where
   // SSD save pins everything and stops reading.
@@ -480,7 +694,7 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   VELOX_CHECK(cache_->ssdCache()->writeInProgress());
   for (auto& entry : entries_) {
     if (entry && !entry->ssdFile_ && !entry->isExclusive() &&
-        entry->ssdSaveable_) {
+        !entry->isCompressed() && entry->ssdSaveable_) {
       CachePin pin;
       ++entry->numPins_;
       pin.setEntry(entry.get());
@@ -507,12 +721,143 @@ AsyncDataCache::AsyncDataCache(
   }
 }
 
+AsyncDataCache::~AsyncDataCache() {
+  if (!headroomEvictor_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(headroomMutex_);
+    stopHeadroomEvictor_ = true;
+  }
+  headroomCv_.notify_one();
+  headroomEvictor_.join();
+}
+
+void AsyncDataCache::startHeadroomEvictor(
+    uint64_t headroomBytes,
+    std::chrono::milliseconds interval) {
+  VELOX_CHECK(!headroomEvictor_.joinable(), "Headroom evictor already started");
+  VELOX_CHECK_GT(headroomBytes, 0);
+  VELOX_CHECK_LT(headroomBytes, maxBytes_);
+  constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
+  headroomPages_ = bits::roundUp(headroomBytes, kPageSize) / kPageSize;
+  headroomInterval_ = interval;
+  headroomEvictor_ = std::thread([this]() { headroomEvictorLoop(); });
+}
+
+void AsyncDataCache::headroomEvictorLoop() {
+  std::unique_lock<std::mutex> l(headroomMutex_);
+  while (!stopHeadroomEvictor_) {
+    headroomCv_.wait_for(l, headroomInterval_, [&]() {
+      return stopHeadroomEvictor_ || headroomCheckRequested_;
+    });
+    if (stopHeadroomEvictor_) {
+      break;
+    }
+    headroomCheckRequested_ = false;
+    // Evictions free memory and must not hold up the allocating threads that
+    // request a check.
+    l.unlock();
+    ensureHeadroom();
+    l.lock();
+  }
+}
+
+void AsyncDataCache::ensureHeadroom() {
+  const MachinePageCount maxPages =
+      maxBytes_ / memory::AllocationTraits::kPageSize;
+  for (;;) {
+    const auto numAllocated = allocator_->numAllocated();
+    if (numAllocated + headroomPages_ <= maxPages) {
+      return;
+    }
+    const uint64_t bytesToFree = (numAllocated + headroomPages_ - maxPages) *
+        memory::AllocationTraits::kPageSize;
+    uint64_t freed = 0;
+    for (auto i = 0; i < numEvictionTargets() && freed < bytesToFree; ++i) {
+      freed += evictNext(bytesToFree - freed, false);
+    }
+    headroomEvictedBytes_ += freed;
+    if (freed == 0) {
+      return;
+    }
+  }
+}
+
+void AsyncDataCache::notifyHeadroomEvictor() {
+  if (headroomPages_ == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(headroomMutex_);
+    headroomCheckRequested_ = true;
+  }
+  headroomCv_.notify_one();
+}
+
+uint64_t AsyncDataCache::shrinkCache(uint64_t bytes) {
+  uint64_t freed = 0;
+  // The first round over the shards evicts by score, the second evicts
+  // anything that is not pinned.
+  const auto numTargets = numEvictionTargets();
+  for (auto i = 0; i < 2 * numTargets && freed < bytes; ++i) {
+    freed += evictNext(bytes - freed, i >= numTargets);
+  }
+  shrunkBytes_ += freed;
+  return freed;
+}
+
+void AsyncDataCache::addDerivedCache(std::weak_ptr<DerivedDataCache> cache) {
+  std::lock_guard<std::mutex> l(derivedCachesMutex_);
+  derivedCaches_.push_back(std::move(cache));
+  hasDerivedCaches_ = true;
+}
+
+uint64_t AsyncDataCache::evictNext(uint64_t bytes, bool evictAllUnpinned) {
+  if (hasDerivedCaches_ &&
+      ++evictionCounter_ % numEvictionTargets() == kNumShards) {
+    return evictDerived(bytes);
+  }
+  return shards_[++shardCounter_ & kShardMask]->evict(bytes, evictAllUnpinned);
+}
+
+uint64_t AsyncDataCache::evictDerived(uint64_t bytes) {
+  std::vector<std::shared_ptr<DerivedDataCache>> caches;
+  {
+    std::lock_guard<std::mutex> l(derivedCachesMutex_);
+    auto it = derivedCaches_.begin();
+    while (it != derivedCaches_.end()) {
+      if (auto cache = it->lock()) {
+        caches.push_back(std::move(cache));
+        ++it;
+      } else {
+        it = derivedCaches_.erase(it);
+      }
+    }
+  }
+  // The caches evict outside of the mutex, since they free memory of the
+  // allocator.
+  uint64_t freed = 0;
+  for (auto& cache : caches) {
+    if (freed >= bytes) {
+      break;
+    }
+    freed += cache->evict(bytes - freed);
+  }
+  derivedEvictedBytes_ += freed;
+  return freed;
+}
+
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
   int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  auto pin = shards_[shard]->findOrCreate(key, size, wait);
+  if (admissionPolicy_ && !pin.empty() && pin.checkedEntry()->isExclusive()) {
+    admissionPolicy_->recordLoad(key);
+  }
+  return pin;
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
@@ -570,6 +915,9 @@ bool AsyncDataCache::makeSpace(
         throw;
       }
     }
+    if (nthAttempt == 0) {
+      notifyHeadroomEvictor();
+    }
     if (nthAttempt > 2 && ssdCache_ && ssdCache_->writeInProgress()) {
       LOG(INFO) << "SSDCA: Pause 0.5s after failed eviction waiting for SSD "
                 << "cach write to unpin memory";
@@ -584,13 +932,12 @@ bool AsyncDataCache::makeSpace(
     if (rank) {
       backoff(nthAttempt + rank);
     }
-    ++shardCounter_;
-    // Evict from next shard. If we have gone through all shards once
-    // and still have not made the allocation, we go to desperate mode
-    // with 'evictAllUnpinned' set to true.
-    shards_[shardCounter_ & (kShardMask)]->evict(
+    // Evict from next shard or derived cache. If we have gone through all
+    // shards once and still have not made the allocation, we go to desperate
+    // mode with 'evictAllUnpinned' set to true.
+    evictNext(
         numPages * sizeMultiplier * memory::AllocationTraits::kPageSize,
-        nthAttempt >= kNumShards);
+        nthAttempt >= numEvictionTargets());
     if (numPages < kSmallSizePages && sizeMultiplier < 4) {
       sizeMultiplier *= 2;
     }
@@ -688,12 +1035,69 @@ CacheStats AsyncDataCache::refreshStats() const {
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  stats.numMemoryRejects = numMemoryRejects_;
+  stats.numSsdRejects = numSsdRejects_;
+  stats.headroomEvictedBytes = headroomEvictedBytes_;
+  stats.shrunkBytes = shrunkBytes_;
+  stats.derivedEvictedBytes = derivedEvictedBytes_;
+  if (codec_) {
+    stats.compressedBudget = maxCompressedBytes_;
+  }
   if (ssdCache_) {
     stats.ssdStats = std::make_shared<SsdCacheStats>(ssdCache_->stats());
   }
   return stats;
 }
 
+std::vector<FileResidency> AsyncDataCache::fileResidency(
+    int32_t maxFiles) const {
+  FileBytesMap memoryBytes;
+  for (auto& shard : shards_) {
+    shard->addFileBytes(memoryBytes);
+  }
+  FileBytesMap ssdBytes;
+  if (ssdCache_) {
+    ssdCache_->addFileBytes(ssdBytes);
+  }
+  // File id, total bytes.
+  std::vector<std::pair<uint64_t, int64_t>> files;
+  files.reserve(memoryBytes.size() + ssdBytes.size());
+  for (auto& [fileNum, bytes] : memoryBytes) {
+    auto it = ssdBytes.find(fileNum);
+    files.emplace_back(
+        fileNum, bytes + (it == ssdBytes.end() ? 0 : it->second));
+  }
+  for (auto& [fileNum, bytes] : ssdBytes) {
+    if (memoryBytes.find(fileNum) == memoryBytes.end()) {
+      files.emplace_back(fileNum, bytes);
+    }
+  }
+  std::sort(
+      files.begin(), files.end(), [](const auto& left, const auto& right) {
+        return left.second > right.second;
+      });
+
+  std::vector<FileResidency> result;
+  for (auto& [fileNum, bytes] : files) {
+    if (result.size() >= static_cast<size_t>(maxFiles)) {
+      break;
+    }
+    // The file has no name if all its entries were dropped after the counts
+    // were taken. Ids are not reused.
+    auto name = fileIds().string(fileNum);
+    if (name.empty()) {
+      continue;
+    }
+    auto memoryIt = memoryBytes.find(fileNum);
+    auto ssdIt = ssdBytes.find(fileNum);
+    result.push_back(FileResidency{
+        std::move(name),
+        memoryIt == memoryBytes.end() ? 0 : memoryIt->second,
+        ssdIt == ssdBytes.end() ? 0 : ssdIt->second});
+  }
+  return result;
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     shard->evict(std::numeric_limits<int32_t>::max(), true);
@@ -708,8 +1112,25 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
-      << " read pins " << stats.numShared << " write pins "
+      << stats.numEvict << " not admitted " << stats.numMemoryRejects
+      << " not admitted to SSD " << stats.numSsdRejects << "\n";
+  if (headroomPages_ || stats.shrunkBytes) {
+    out << "Headroom evicted: " << stats.headroomEvictedBytes
+        << " bytes shrunk for queries: " << stats.shrunkBytes << " bytes\n";
+  }
+  if (hasDerivedCaches_) {
+    out << "Evicted from derived caches: " << stats.derivedEvictedBytes
+        << " bytes\n";
+  }
+  if (codec_) {
+    out << "Compressed: " << stats.numCompressed << " entries "
+        << stats.compressedSize << " / " << stats.compressedBudget
+        << " bytes of " << stats.compressedOriginalSize << " hits "
+        << stats.numCompressedHit << " not kept " << stats.numCompressFailures
+        << " compress Megaclocks " << (stats.compressClocks >> 20)
+        << " decompress Megaclocks " << (stats.decompressClocks >> 20) << "\n";
+  }
+  out << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
       << " allocated pages " << numAllocated() << " cached pages "
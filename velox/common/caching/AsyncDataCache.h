@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <deque>
+#include <thread>
 
 #include <fmt/format.h>
+#include <folly/SharedMutex.h>
 #include <folly/chrono/Hardware.h>
 #include <folly/futures/SharedPromise.h>
 #include "velox/common/base/BitUtil.h"
@@ -34,6 +37,8 @@
 namespace facebook::velox::cache {
 
 class AsyncDataCache;
+class CacheAdmissionPolicy;
+class CacheCodec;
 class CacheShard;
 class SsdCache;
 class SsdCacheStats;
@@ -53,9 +58,11 @@ inline AccessTime accessTime() {
   return folly::hardware_timestamp() >> 21;
 }
 
+// Updated by concurrent hits without synchronization. A lost update only
+// affects the eviction order.
 struct AccessStats {
-  AccessTime lastUse{0};
-  int32_t numUses{0};
+  tsan_atomic<AccessTime> lastUse{0};
+  tsan_atomic<int32_t> numUses{0};
 
   // Retention score. A higher number means less worth retaining. This
   // works well with a typical formula of time over use count going to
@@ -197,6 +204,13 @@ class AsyncDataCacheEntry {
     return numPins_;
   }
 
+  // True if the data of 'this' is held in compressed form in 'compressed_'
+  // and 'data_' is empty. A compressed entry is unpinned and is decompressed
+  // by the lookup that hits it.
+  bool isCompressed() const {
+    return !compressed_.empty();
+  }
+
   // Sets the 'isPrefetch_' and updates the cache's total prefetch count.
   // Returns the new prefetch pages count.
   memory::MachinePageCount setPrefetch(bool flag = true);
@@ -275,10 +289,15 @@ class AsyncDataCacheEntry {
   // page (kTinyDataSize).
   std::string tinyData_;
 
+  // Contains the cached data compressed by the cache's codec if this was
+  // compressed instead of evicted. See AsyncDataCache::setCompressedTier().
+  std::string compressed_;
+
   std::unique_ptr<folly::SharedPromise<bool>> promise_;
   int32_t size_{0};
 
-  // Setting this from 0 to 1 or to kExclusive requires owning shard_->mutex_.
+  // Setting this from 0 to 1 or to kExclusive requires owning shard_->mutex_,
+  // in shared mode for 0 to 1 and in exclusive mode for kExclusive.
   std::atomic<int32_t> numPins_{0};
 
   AccessStats accessStats_;
@@ -299,6 +318,11 @@ class AsyncDataCacheEntry {
   // Tracking id. Used for deciding if this should be written to SSD.
   TrackingId trackingId_;
 
+  // True if 'this' was prefetched and not admitted to memory by the cache's
+  // admission policy. Made evictable on first use, not before, so that a
+  // prefetch is not lost before it is read.
+  bool evictOnFirstUse_{false};
+
   // SSD file from which this was loaded or nullptr if not backed by
   // SsdFile. Used to avoid re-adding items that already come from
   // SSD. The exact file and offset are needed to include uses in RAM
@@ -500,9 +524,48 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of new entries that the admission policy did not admit to memory.
+  int64_t numMemoryRejects{};
+  // Number of new entries that the admission policy did not admit to SSD.
+  int64_t numSsdRejects{};
+  // Number of entries held compressed in memory.
+  int32_t numCompressed{};
+  // Total size of the compressed data of the entries in 'numCompressed'.
+  int64_t compressedSize{};
+  // Total uncompressed size of the entries in 'numCompressed'.
+  int64_t compressedOriginalSize{};
+  // Maximum for 'compressedSize'. 0 if there is no compressed tier.
+  int64_t compressedBudget{};
+  // Number of times an entry was compressed instead of evicted.
+  int64_t numCompress{};
+  // Number of times an entry was evicted because it did not compress or the
+  // compressed data did not fit in 'compressedBudget'.
+  int64_t numCompressFailures{};
+  // Number of hits on compressed entries. These are included in 'numHit'.
+  int64_t numCompressedHit{};
+  // Cumulative clocks spent in compressing and decompressing entries.
+  uint64_t compressClocks{};
+  uint64_t decompressClocks{};
+  // Bytes evicted by the headroom evictor and by shrinkCache().
+  int64_t headroomEvictedBytes{};
+  int64_t shrunkBytes{};
+  // Bytes evicted from derived caches, e.g. of decoded vectors.
+  int64_t derivedEvictedBytes{};
 
   std::shared_ptr<SsdCacheStats> ssdStats = nullptr;
 };
+
+// Bytes of a file held in memory and on SSD. Reported by
+// AsyncDataCache::fileResidency() so that a scheduler can prefer workers that
+// already have the data of a split.
+struct FileResidency {
+  std::string fileName;
+  int64_t memoryBytes{0};
+  int64_t ssdBytes{0};
+};
+
+// Map from file id in fileIds() to a byte count.
+using FileBytesMap = folly::F14FastMap<uint64_t, int64_t>;
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
 // to decrease contention on the mutex for the key to entry mapping
@@ -517,13 +580,19 @@ class CacheShard {
       uint64_t size,
       folly::SemiFuture<bool>* readyFuture);
 
+  // Returns a pin on the entry for 'key' if this is shared, not a first use
+  // of a prefetched entry and has at least 'size' bytes. Holds 'mutex_' in
+  // shared mode, so that concurrent hits do not serialize. Returns an empty
+  // pin otherwise, in which case findOrCreate() takes the exclusive path.
+  CachePin findShared(RawFileCacheKey key, uint64_t size);
+
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
 
   AsyncDataCache* cache() {
     return cache_;
   }
-  std::mutex& mutex() {
+  folly::SharedMutex& mutex() {
     return mutex_;
   }
 
@@ -531,8 +600,8 @@ class CacheShard {
   // not pinned. This favors first removing older and less frequently
   // used entries. If 'evictAllUnpinned' is true, anything that is
   // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
-  void evict(uint64_t bytesToFree, bool evictAllUnpinned);
+  // emergencies. Returns the bytes of cache memory freed.
+  uint64_t evict(uint64_t bytesToFree, bool evictAllUnpinned);
 
   // Removes 'entry' from 'this'. Removes a possible promise from the entry
   // inside the shard mutex and returns it so that it can be realized outside of
@@ -543,6 +612,10 @@ class CacheShard {
   // Adds the stats of 'this' to 'stats'.
   void updateStats(CacheStats& stats);
 
+  // Adds the sizes of the loaded entries of 'this' to the counts of their
+  // files in 'fileBytes'.
+  void addFileBytes(FileBytesMap& fileBytes) const;
+
   // Appends a batch of non-saved SSD saveable entries in 'this' to
   // 'pins'. This may have to be called several times since this keeps
   // limits on the batch to write at one time. The saveable entries
@@ -569,7 +642,22 @@ class CacheShard {
 
   void freeAllocations(std::vector<memory::Allocation>& allocations);
 
-  mutable std::mutex mutex_;
+  // Compresses the data of 'entries' and frees their memory. The entries are
+  // set to exclusive mode by evict() and are unpinned after compression. The
+  // ones that do not compress or do not fit in the compressed budget are
+  // evicted. The second of each pair is the index of the entry in 'entries_'.
+  void compressEntries(
+      std::vector<std::pair<AsyncDataCacheEntry*, int32_t>>& entries);
+
+  // Decompresses 'entry', which has been set to exclusive mode by
+  // findOrCreate(), and returns a shared pin on it. The entry is removed if
+  // there is no memory for the decompressed data.
+  CachePin decompressEntry(AsyncDataCacheEntry* entry);
+
+  // Held in shared mode for hits on shared entries and in exclusive mode for
+  // anything that changes 'entryMap_', 'entries_' or the exclusive state of
+  // an entry.
+  mutable folly::SharedMutex mutex_;
   folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry*> entryMap_;
   // Entries associated to a key.
   std::deque<std::unique_ptr<AsyncDataCacheEntry>> entries_;
@@ -582,13 +670,13 @@ class CacheShard {
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets  since last stats sampling.
-  uint32_t eventCounter_{};
+  std::atomic<uint32_t> eventCounter_{};
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
-  // Cumulative count of cache hits.
-  uint64_t numHit_{};
+  // Cumulative count of cache hits. Incremented in shared mode.
+  std::atomic<uint64_t> numHit_{};
   // Sum of bytes in cache hits.
-  uint64_t hitBytes_{};
+  std::atomic<uint64_t> hitBytes_{};
   // Cumulative count of hits on entries held in exclusive mode.
   uint64_t numWaitExclusive_{};
   // Cumulative count of new entry creation.
@@ -601,11 +689,34 @@ class CacheShard {
   // Sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{};
+  // Count of entries compressed instead of evicted.
+  uint64_t numCompress_{};
+  // Count of entries evicted because they could not be kept compressed.
+  uint64_t numCompressFailures_{};
+  // Count of hits on compressed entries.
+  uint64_t numCompressedHit_{};
+  // Time spent in compressing and decompressing entries.
+  std::atomic<uint64_t> compressClocks_{};
+  std::atomic<uint64_t> decompressClocks_{};
   // Tracker of time spent in allocating/freeing MemoryAllocator space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
 };
 
+// A cache of data derived from file contents, e.g. decoded column vectors,
+// whose memory comes from the same allocator as AsyncDataCache. The
+// AsyncDataCache evicts from it in turn with its own shards when it makes
+// space, so that the two share the memory. Entries are evicted by
+// AccessStats::score(), the same as AsyncDataCache entries.
+class DerivedDataCache {
+ public:
+  virtual ~DerivedDataCache() = default;
+
+  // Evicts entries, the coldest first, until 'bytes' are freed or nothing is
+  // left. Returns the number of bytes freed.
+  virtual uint64_t evict(uint64_t bytes) = 0;
+};
+
 class AsyncDataCache : public memory::MemoryAllocator {
  public:
   AsyncDataCache(
@@ -613,6 +724,8 @@ class AsyncDataCache : public memory::MemoryAllocator {
       uint64_t maxBytes,
       std::unique_ptr<SsdCache> ssdCache = nullptr);
 
+  ~AsyncDataCache() override;
+
   // Finds or creates a cache entry corresponding to 'key'. The entry
   // is returned in 'pin'. If the entry is new, it is pinned in
   // exclusive mode and its 'data_' has uninitialized space for at
@@ -678,8 +791,34 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return allocator_->numMapped();
   }
 
+  uint64_t cachedBytes() const override {
+    return cachedPages_ * memory::AllocationTraits::kPageSize;
+  }
+
+  // Evicts unpinned entries, cold ones first, until 'bytes' of cache memory
+  // is freed or there is nothing left to evict. Called by the memory
+  // arbitrator to back the capacity it grants to queries with cache memory.
+  uint64_t shrinkCache(uint64_t bytes) override;
+
+  // Starts a background thread that keeps 'headroomBytes' of 'maxBytes_'
+  // unallocated by evicting cold entries ahead of need. This way the
+  // allocations in makeSpace() usually succeed at the first attempt instead
+  // of evicting and retrying under the failing allocation. The thread checks
+  // every 'interval' and right after an allocation fails. Only entries that
+  // would be evicted anyway are evicted, so the headroom may not be reached
+  // if the rest of the cache is hot or pinned. The thread is stopped by the
+  // destructor. Must be called at most once, before the cache is used.
+  void startHeadroomEvictor(
+      uint64_t headroomBytes,
+      std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
   CacheStats refreshStats() const;
 
+  // Returns the files with the most bytes in memory and on SSD, at most
+  // 'maxFiles' of them, largest first. This is a snapshot: entries may be
+  // loaded or evicted while it is being made.
+  std::vector<FileResidency> fileResidency(int32_t maxFiles) const;
+
   std::string toString() const override;
 
   memory::MachinePageCount incrementCachedPages(int64_t pages) {
@@ -721,6 +860,62 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return verifyHook_;
   }
 
+  // Sets the policy deciding which newly loaded entries are retained in memory
+  // and may be written to SSD. nullptr admits everything. Must be set before
+  // the cache is used.
+  void setAdmissionPolicy(std::shared_ptr<CacheAdmissionPolicy> policy) {
+    admissionPolicy_ = std::move(policy);
+  }
+
+  CacheAdmissionPolicy* FOLLY_NULLABLE admissionPolicy() const {
+    return admissionPolicy_.get();
+  }
+
+  // Makes evict() keep cold entries in memory compressed by 'codec' instead
+  // of dropping them, as long as their compressed data fits in
+  // 'maxCompressedBytes'. The compressed data is outside of the memory
+  // managed by 'this'. A hit on a compressed entry decompresses it into newly
+  // allocated cache memory, which costs CPU but saves the IO. When the budget
+  // is full, the coldest compressed entries are dropped. Entries that have
+  // been made evictable, e.g. by the admission policy, and entries waiting to
+  // be written to SSD are not compressed. Must be set before the cache is
+  // used.
+  void setCompressedTier(
+      std::shared_ptr<CacheCodec> codec,
+      int64_t maxCompressedBytes) {
+    codec_ = std::move(codec);
+    maxCompressedBytes_ = maxCompressedBytes;
+  }
+
+  CacheCodec* FOLLY_NULLABLE codec() const {
+    return codec_.get();
+  }
+
+  // Adds 'bytes' to the size of compressed data if this fits in the budget
+  // given to setCompressedTier(). Returns true if added.
+  bool tryAddCompressedBytes(int64_t bytes) {
+    if (compressedBytes_.fetch_add(bytes) + bytes > maxCompressedBytes_) {
+      compressedBytes_ -= bytes;
+      return false;
+    }
+    return true;
+  }
+
+  void freeCompressedBytes(int64_t bytes) {
+    compressedBytes_ -= bytes;
+  }
+
+  // True if the compressed data fills the budget given to setCompressedTier().
+  bool compressedTierFull() const {
+    return compressedBytes_ >= maxCompressedBytes_;
+  }
+
+  // Updates the admission reject counters.
+  void incrementAdmissionRejects(bool memory, bool ssd) {
+    numMemoryRejects_ += memory;
+    numSsdRejects_ += ssd;
+  }
+
   // Looks up a pin for each in 'keys' and skips all loading or
   // loaded pins. Calls processPin for each exclusive
   // pin. processPin must move its argument if it wants to use it
@@ -740,6 +935,11 @@ class AsyncDataCache : public memory::MemoryAllocator {
     }
   }
 
+  // Makes the evictions of 'this' also free memory from 'cache' as long as
+  // 'cache' is alive. 'cache' is an extra shard in the round robin over the
+  // shards. May be called while 'this' is in use.
+  void addDerivedCache(std::weak_ptr<DerivedDataCache> cache);
+
   // Drops all unpinned entries. Pins stay valid.
   void clear();
 
@@ -758,9 +958,32 @@ class AsyncDataCache : public memory::MemoryAllocator {
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
   static constexpr int32_t kShardMask = kNumShards - 1;
 
+  // Body of the thread started by startHeadroomEvictor().
+  void headroomEvictorLoop();
+
+  // Evicts cold entries until 'headroomPages_' of 'maxBytes_' are
+  // unallocated or a pass over all shards frees nothing.
+  void ensureHeadroom();
+
+  // Wakes up the headroom evictor, if any, after an allocation failed.
+  void notifyHeadroomEvictor();
+
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
 
+  // The number of shards plus 1 if there are derived caches.
+  int32_t numEvictionTargets() const {
+    return kNumShards + hasDerivedCaches_;
+  }
+
+  // Evicts up to 'bytes' from the next shard or, every
+  // numEvictionTargets() calls, from the derived caches. Returns the bytes
+  // freed.
+  uint64_t evictNext(uint64_t bytes, bool evictAllUnpinned);
+
+  // Evicts up to 'bytes' from the live caches in 'derivedCaches_'.
+  uint64_t evictDerived(uint64_t bytes);
+
   // Calls 'allocate' until this returns true. Returns true if
   // allocate returns true. and Tries to evict at least 'numPages' of
   // cache after each failed call to 'allocate'.  May pause to wait
@@ -776,6 +999,13 @@ class AsyncDataCache : public memory::MemoryAllocator {
   std::unique_ptr<SsdCache> ssdCache_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
   std::atomic<int32_t> shardCounter_{0};
+  // Round robin position of evictNext() over the shards and the derived
+  // caches.
+  std::atomic<uint32_t> evictionCounter_{0};
+  std::mutex derivedCachesMutex_;
+  std::vector<std::weak_ptr<DerivedDataCache>> derivedCaches_;
+  std::atomic<bool> hasDerivedCaches_{false};
+  tsan_atomic<uint64_t> derivedEvictedBytes_{0};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
   // Number of pages that are allocated and not yet loaded or loaded
   // but not yet hit for the first time.
@@ -795,6 +1025,16 @@ class AsyncDataCache : public memory::MemoryAllocator {
   CacheStats stats_;
 
   std::function<void(const AsyncDataCacheEntry&)> verifyHook_;
+
+  std::shared_ptr<CacheAdmissionPolicy> admissionPolicy_;
+  tsan_atomic<uint64_t> numMemoryRejects_{0};
+  tsan_atomic<uint64_t> numSsdRejects_{0};
+
+  std::shared_ptr<CacheCodec> codec_;
+  int64_t maxCompressedBytes_{0};
+  // Total size of the compressed data of compressed entries.
+  std::atomic<int64_t> compressedBytes_{0};
+
   // Count of skipped saves to 'ssdCache_' due to 'ssdCache_' being
   // busy with write.
   tsan_atomic<int32_t> numSkippedSaves_{0};
@@ -807,6 +1047,19 @@ class AsyncDataCache : public memory::MemoryAllocator {
   // Counter of threads competing for allocation in makeSpace(). Used
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
+
+  // Headroom kept free by 'headroomEvictor_'. 0 if there is no evictor.
+  memory::MachinePageCount headroomPages_{0};
+  std::chrono::milliseconds headroomInterval_{0};
+  std::thread headroomEvictor_;
+  std::mutex headroomMutex_;
+  std::condition_variable headroomCv_;
+  // Set under 'headroomMutex_' to ask for a check or to stop the evictor.
+  bool headroomCheckRequested_{false};
+  bool stopHeadroomEvictor_{false};
+
+  tsan_atomic<uint64_t> headroomEvictedBytes_{0};
+  tsan_atomic<uint64_t> shrunkBytes_{0};
 };
 
 // Samples a set of values T from 'numSamples' calls of
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheAdmissionPolicy.h"
+
+namespace facebook::velox::cache {
+
+TinyLfuAdmissionPolicy::TinyLfuAdmissionPolicy(
+    int32_t numCounters,
+    int32_t minMemoryLoads,
+    int32_t minSsdLoads)
+    : numCounters_(bits::nextPowerOfTwo(std::max(numCounters, 64))),
+      counterMask_(numCounters_ - 1),
+      minMemoryLoads_(minMemoryLoads),
+      minSsdLoads_(minSsdLoads),
+      sampleSize_(numCounters_),
+      counters_(kNumRows * numCounters_) {
+  VELOX_CHECK_LE(minMemoryLoads_, kMaxCount);
+  VELOX_CHECK_LE(minSsdLoads_, kMaxCount);
+}
+
+void TinyLfuAdmissionPolicy::recordLoad(RawFileCacheKey key) {
+  const auto hash = std::hash<RawFileCacheKey>()(key);
+  int32_t indices[kNumRows];
+  std::lock_guard<std::mutex> l(mutex_);
+  uint8_t minCount = kMaxCount;
+  for (auto row = 0; row < kNumRows; ++row) {
+    indices[row] = counterIndex(hash, row);
+    minCount = std::min(minCount, counters_[indices[row]]);
+  }
+  if (minCount < kMaxCount) {
+    // Conservative update: only the counters that determine the estimate are
+    // incremented. This keeps collisions from inflating the other counts.
+    for (auto row = 0; row < kNumRows; ++row) {
+      if (counters_[indices[row]] == minCount) {
+        ++counters_[indices[row]];
+      }
+    }
+  }
+  if (++numSampled_ >= sampleSize_) {
+    halveCountersLocked();
+  }
+}
+
+int32_t TinyLfuAdmissionPolicy::numLoads(RawFileCacheKey key) const {
+  const auto hash = std::hash<RawFileCacheKey>()(key);
+  std::lock_guard<std::mutex> l(mutex_);
+  uint8_t minCount = kMaxCount;
+  for (auto row = 0; row < kNumRows; ++row) {
+    minCount = std::min(minCount, counters_[counterIndex(hash, row)]);
+  }
+  return minCount;
+}
+
+void TinyLfuAdmissionPolicy::halveCountersLocked() {
+  for (auto& counter : counters_) {
+    counter >>= 1;
+  }
+  numSampled_ = 0;
+}
+
+} // namespace facebook::velox::cache
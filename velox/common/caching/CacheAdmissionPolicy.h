@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+namespace facebook::velox::cache {
+
+// Decides which newly loaded entries AsyncDataCache retains in memory and
+// which may be written to SsdCache. Without a policy all entries are retained
+// and FileGroupStats alone decides what is written to SSD. Implementations
+// must be thread safe.
+class CacheAdmissionPolicy {
+ public:
+  virtual ~CacheAdmissionPolicy() = default;
+
+  // Records that the data for 'key' is being loaded, i.e. that a lookup of
+  // 'key' missed the memory cache.
+  virtual void recordLoad(RawFileCacheKey key) = 0;
+
+  // Returns true if the newly loaded entry for 'key' of 'size' bytes is
+  // retained in memory after its first use. An entry that is not admitted is
+  // still returned to its readers but it is the first to go when space is
+  // needed, unless it is hit again before that.
+  virtual bool admitToMemory(RawFileCacheKey key, int32_t size) = 0;
+
+  // Returns true if the newly loaded entry for 'key' of 'size' bytes may be
+  // written to SSD.
+  virtual bool admitToSsd(RawFileCacheKey key, int32_t size) = 0;
+};
+
+// TinyLFU style admission. Keeps an approximate count of recent loads of each
+// key in a count-min sketch of saturating 4 bit counters. All counts are
+// halved after every 'numCounters' loads, so that old history fades out and
+// the sketch does not fill up with one-off loads. An entry is admitted to
+// memory if its key has been loaded at least 'minMemoryLoads' times and to SSD
+// if at least 'minSsdLoads' times. A one-off scan loads each key once, so with
+// the defaults it neither displaces the working set in memory nor gets written
+// to SSD, while data that keeps coming back is admitted on its second load.
+class TinyLfuAdmissionPolicy : public CacheAdmissionPolicy {
+ public:
+  // 'numCounters' is rounded up to a power of 2. It should be in the order of
+  // the number of entries that fit in the cache, so that the history covers
+  // about one turnover of the cache.
+  explicit TinyLfuAdmissionPolicy(
+      int32_t numCounters = 1 << 20,
+      int32_t minMemoryLoads = 2,
+      int32_t minSsdLoads = 2);
+
+  void recordLoad(RawFileCacheKey key) override;
+
+  bool admitToMemory(RawFileCacheKey key, int32_t /*size*/) override {
+    return numLoads(key) >= minMemoryLoads_;
+  }
+
+  bool admitToSsd(RawFileCacheKey key, int32_t /*size*/) override {
+    return numLoads(key) >= minSsdLoads_;
+  }
+
+  // Returns the estimated number of recent loads of 'key'. This may
+  // overestimate but never underestimates, up to the counter maximum of 15.
+  int32_t numLoads(RawFileCacheKey key) const;
+
+ private:
+  static constexpr int32_t kNumRows = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  // Returns the index in 'counters_' of the counter for 'hash' in 'row'.
+  int32_t counterIndex(uint64_t hash, int32_t row) const {
+    return row * numCounters_ + (bits::hashMix(hash, row) & counterMask_);
+  }
+
+  // Halves all counters. Caller must hold 'mutex_'.
+  void halveCountersLocked();
+
+  const int32_t numCounters_;
+  const uint64_t counterMask_;
+  const int32_t minMemoryLoads_;
+  const int32_t minSsdLoads_;
+
+  // Number of loads after which the counters are halved.
+  const int64_t sampleSize_;
+
+  mutable std::mutex mutex_;
+
+  // 'kNumRows' rows of 'numCounters_' counters.
+  std::vector<uint8_t> counters_;
+
+  // Number of loads recorded since the counters were last halved.
+  int64_t numSampled_{0};
+};
+
+} // namespace facebook::velox::cache
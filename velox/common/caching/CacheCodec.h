@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/Range.h>
+
+namespace facebook::velox::cache {
+
+// Compresses the entries that AsyncDataCache keeps in memory in compressed
+// form instead of evicting them. See AsyncDataCache::setCompressedTier(). The
+// codec is supplied by the embedding application, e.g. LZ4 or ZSTD at a low
+// level, since this library does not link any compression library.
+// Implementations must be thread safe.
+class CacheCodec {
+ public:
+  virtual ~CacheCodec() = default;
+
+  // Returns the compressed form of the bytes in 'ranges'. Returns an empty
+  // string if the data does not compress well enough to be worth keeping,
+  // in which case the entry is evicted. Data that is already compressed by
+  // the file format typically does not.
+  virtual std::string compress(
+      const std::vector<folly::Range<const char*>>& ranges) = 0;
+
+  // Decompresses 'compressed' into 'ranges'. The sizes of 'ranges' add up to
+  // the size of the data that was passed to compress().
+  virtual void decompress(
+      std::string_view compressed,
+      const std::vector<folly::Range<char*>>& ranges) = 0;
+};
+
+} // namespace facebook::velox::cache
@@ -42,7 +42,8 @@ SsdCache::SsdCache(
         fmt::format("{}{}", filePrefix_, i),
         i,
         fileMaxRegions,
-        checkpointIntervalBytes / numShards));
+        checkpointIntervalBytes / numShards,
+        executor_));
   }
 }
 
@@ -119,6 +120,12 @@ SsdCacheStats SsdCache::stats() const {
   return stats;
 }
 
+void SsdCache::addFileBytes(FileBytesMap& fileBytes) const {
+  for (auto& file : files_) {
+    file->addFileBytes(fileBytes);
+  }
+}
+
 void SsdCache::clear() {
   for (auto& file : files_) {
     file->clear();
@@ -67,6 +67,10 @@ class SsdCache {
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
+  // Adds the sizes of the entries of all shards to the counts of their files
+  // in 'fileBytes'.
+  void addFileBytes(FileBytesMap& fileBytes) const;
+
   FileGroupStats& groupStats() const {
     return *groupStats_;
   }
@@ -19,6 +19,7 @@
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/file/IoUringReader.h"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -198,6 +199,10 @@ CoalesceIoStats SsdFile::load(
     ++stats_.entriesRead;
     stats_.bytesRead += entry->size();
   }
+  // With io_uring, the coalesced reads are submitted together after
+  // planning and are all in flight at the same time.
+  auto reader = IoUringReader::instance();
+  std::vector<IoUringReader::Read> reads;
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
   // gaps is ~25K per gap. For longer payloads this is ~50-100K.
@@ -214,8 +219,20 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        if (reader) {
+          reads.push_back(IoUringReader::Read{offset, buffers});
+        } else {
+          read(offset, buffers);
+        }
       });
+  if (!reads.empty()) {
+    // Waits for all reads before checking for errors, so that no read is
+    // left writing into 'pins'.
+    auto results = folly::collectAll(reader->preadvBatch(fd_, reads)).get();
+    for (auto& result : results) {
+      result.throwUnlessValue();
+    }
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -440,6 +457,13 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   }
 }
 
+void SsdFile::addFileBytes(FileBytesMap& fileBytes) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [key, run] : entries_) {
+    fileBytes[key.fileNum.id()] += run.size();
+  }
+}
+
 void SsdFile::clear() {
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
@@ -532,10 +556,14 @@ void SsdFile::checkpoint(bool force) {
     if (executor_) {
       executor_->add([sync]() { sync->prepare(); });
     }
+    // The state is written into a temporary file that replaces the previous
+    // checkpoint only after it is complete and synced. A crash while writing
+    // the checkpoint leaves the previous checkpoint and eviction log intact.
     std::ofstream state;
     auto checkpointPath = fileName_ + kCheckpointExtension;
+    auto tempPath = checkpointPath + kCheckpointTempExtension;
     state.exceptions(std::ofstream::failbit);
-    state.open(checkpointPath, std::ios_base::out | std::ios_base::trunc);
+    state.open(tempPath, std::ios_base::out | std::ios_base::trunc);
     // The checkpoint state file contains:
     // int32_t The 4 bytes of kCheckpointMagic,
     // int32_t maxRegions,
@@ -584,20 +612,24 @@ void SsdFile::checkpoint(bool force) {
       checkRc(-1, "Writing checkpoint file");
     }
     state.close();
-    ftruncate(evictLogFd_, 0);
-    checkRc(fsync(evictLogFd_), "Sync of evict log");
     auto syncRc = sync->move();
     checkRc(*syncRc, fmt::format("Error in cache file fsync {}", *syncRc));
 
     // Sync checkpoint data file. ofstream does not have a sync method, so open
     // as fd and sync that.
     auto fd = checkRc(
-        open(checkpointPath.c_str(), O_WRONLY),
-        "Open of checkpoint file for sync");
+        open(tempPath.c_str(), O_WRONLY), "Open of checkpoint file for sync");
     if (fd > 0) {
       checkRc(fsync(fd), "Sync checkpoint file");
       close(fd);
     }
+    checkRc(
+        rename(tempPath.c_str(), checkpointPath.c_str()),
+        "Rename of checkpoint file");
+
+    // The evictions logged so far are covered by the new checkpoint.
+    ftruncate(evictLogFd_, 0);
+    checkRc(fsync(evictLogFd_), "Sync of evict log");
 
   } catch (const std::exception& e) {
     try {
@@ -661,7 +693,11 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       maxRegions,
       maxRegions_,
       "Trying to start from checkpoint with a different capacity");
-  numRegions_ = readNumber<int32_t>(state);
+  const auto numRegions = readNumber<int32_t>(state);
+  VELOX_CHECK_LE(
+      numRegions,
+      fileSize_ / kRegionSize,
+      "Checkpoint has more regions than the cache file");
   std::vector<int64_t> scores(maxRegions);
   state.read(asChar(scores.data()), maxRegions_ * sizeof(uint64_t));
   std::unordered_map<uint64_t, StringIdLease> idMap;
@@ -684,6 +720,8 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
   for (auto region : evicted) {
     evictedMap.insert(region);
   }
+  // The used bytes of each region are the end of its last recovered entry.
+  std::vector<uint32_t> regionSizes(maxRegions_);
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -696,13 +734,20 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       // The file may have a different id on restore.
       auto it = idMap.find(fileNum);
       VELOX_CHECK(it != idMap.end());
+      const auto region = regionIndex(run.offset());
+      VELOX_CHECK_LT(region, numRegions, "Checkpoint entry past end of file");
       FileCacheKey key{it->second, offset};
       entries_[std::move(key)] = run;
+      regionSizes[region] = std::max<uint32_t>(
+          regionSizes[region],
+          run.offset() - region * kRegionSize + run.size());
     }
   }
   // The state is successfully read. Install the access frequency scores and
   // evicted regions.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
+  numRegions_ = numRegions;
+  regionSize_ = std::move(regionSizes);
   // Set the writable regions by deduplicated evicted regions.
   writableRegions_.clear();
   for (auto region : evictedMap) {
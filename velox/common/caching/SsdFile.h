@@ -157,8 +157,12 @@ class SsdFile {
  public:
   static constexpr uint64_t kRegionSize = 1 << 26; // 64MB
 
-  // Constructs a cache backed by filename. Discards any previous
-  // contents of filename.
+  // Constructs a cache backed by filename. If 'checkpointIntervalBytes' is
+  // non-0 and there is a complete checkpoint of a previous instance with the
+  // same 'maxRegions', the entries of the checkpoint that are not in regions
+  // evicted after the checkpoint are recovered. The files of the entries are
+  // identified by their names, which are mapped to new ids in fileIds().
+  // Otherwise discards any previous contents of filename.
   SsdFile(
       const std::string& filename,
       int32_t shardId,
@@ -218,6 +222,10 @@ class SsdFile {
   // Adds 'stats_' to 'stats'.
   void updateStats(SsdCacheStats& stats) const;
 
+  // Adds the sizes of the entries to the counts of their files in
+  // 'fileBytes'.
+  void addFileBytes(FileBytesMap& fileBytes) const;
+
   // Resets this' to a post-construction empty state. See SsdCache::clear().
   void clear();
 
@@ -263,7 +271,8 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
-  // Reads the backing file with ReadFile::preadv().
+  // Reads the backing file with ReadFile::preadv(). load() uses
+  // IoUringReader instead if this is available.
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
   // Verifies that 'entry' has the data at 'run'.
@@ -299,6 +308,9 @@ class SsdFile {
   std::string fileName_;
   static constexpr const char* FOLLY_NONNULL kLogExtension = ".log";
   static constexpr const char* FOLLY_NONNULL kCheckpointExtension = ".cpt";
+  // Suffix of the checkpoint file while it is being written.
+  static constexpr const char* FOLLY_NONNULL kCheckpointTempExtension =
+      ".tmp";
 
   // Shard index within 'cache_'.
   int32_t shardId_;
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/caching/CacheAdmissionPolicy.h"
+#include "velox/common/caching/CacheCodec.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/memory/MmapAllocator.h"
@@ -591,6 +594,242 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   clearAllocations(allocations);
 }
 
+TEST_F(AsyncDataCacheTest, headroomEvictor) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int64_t kHeadroom = 4 << 20;
+  constexpr int32_t kSize = 16 << 10;
+  constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
+  constexpr int64_t kMaxPages = kMaxBytes / kPageSize;
+  initializeCache(kMaxBytes);
+  for (auto i = 0; i < kMaxBytes / kSize; ++i) {
+    auto pin = newEntry(i * kSize, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+  ASSERT_GT(cache_->numAllocated() + kHeadroom / kPageSize, kMaxPages);
+
+  cache_->startHeadroomEvictor(kHeadroom, std::chrono::milliseconds(10));
+  VELOX_ASSERT_THROW(
+      cache_->startHeadroomEvictor(kHeadroom),
+      "Headroom evictor already started");
+  for (auto i = 0; i < 1'000; ++i) {
+    if (cache_->numAllocated() + kHeadroom / kPageSize <= kMaxPages) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+  }
+  ASSERT_LE(cache_->numAllocated() + kHeadroom / kPageSize, kMaxPages);
+  auto stats = cache_->refreshStats();
+  ASSERT_GE(stats.headroomEvictedBytes, kHeadroom - kSize);
+  ASSERT_EQ(0, stats.shrunkBytes);
+
+  // Shrinking evicts what is asked for and then everything unpinned.
+  const auto cachedBytes = cache_->cachedBytes();
+  ASSERT_GT(cachedBytes, kHeadroom);
+  ASSERT_GE(cache_->shrinkCache(kHeadroom), kHeadroom);
+  ASSERT_LE(cache_->cachedBytes(), cachedBytes - kHeadroom);
+  cache_->shrinkCache(kMaxBytes);
+  ASSERT_EQ(0, cache_->cachedBytes());
+  ASSERT_GE(cache_->refreshStats().shrunkBytes, kHeadroom);
+}
+
+TEST_F(AsyncDataCacheTest, fileResidency) {
+  constexpr int32_t kSize = 16 << 10;
+  initializeCache(16 << 20);
+  // File i has i + 1 entries.
+  for (auto file = 0; file < 3; ++file) {
+    for (auto i = 0; i <= file; ++i) {
+      RawFileCacheKey key{filenames_[file].id(), static_cast<uint64_t>(i)};
+      auto pin = cache_->findOrCreate(key, kSize);
+      ASSERT_TRUE(pin.checkedEntry()->isExclusive());
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+  }
+  // An entry being loaded is not counted.
+  auto loading = cache_->findOrCreate(
+      RawFileCacheKey{filenames_[3].id(), 0}, 100 * kSize);
+  ASSERT_TRUE(loading.checkedEntry()->isExclusive());
+
+  auto files = cache_->fileResidency(2);
+  ASSERT_EQ(2, files.size());
+  ASSERT_EQ(fileIds().string(filenames_[2].id()), files[0].fileName);
+  ASSERT_EQ(3 * kSize, files[0].memoryBytes);
+  ASSERT_EQ(0, files[0].ssdBytes);
+  ASSERT_EQ(fileIds().string(filenames_[1].id()), files[1].fileName);
+  ASSERT_EQ(2 * kSize, files[1].memoryBytes);
+  ASSERT_EQ(3, cache_->fileResidency(10).size());
+}
+
+TEST_F(AsyncDataCacheTest, concurrentHits) {
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumEntries = 10;
+  constexpr int32_t kNumThreads = 16;
+  constexpr int32_t kNumLookups = 2'000;
+  initializeCache(16 << 20);
+  for (auto i = 0; i < kNumEntries; ++i) {
+    auto pin = newEntry(i * kSize, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setPrefetch(false);
+    initializeContents(
+        filenames_[0].id() + i * kSize, pin.checkedEntry()->data());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+
+  // The hits on shared entries take the shard mutex in shared mode.
+  runThreads(kNumThreads, [&](int32_t thread) {
+    for (auto i = 0; i < kNumLookups; ++i) {
+      const uint64_t offset = ((thread + i) % kNumEntries) * kSize;
+      auto pin = cache_->findOrCreate(
+          RawFileCacheKey{filenames_[0].id(), offset}, kSize);
+      ASSERT_TRUE(pin.checkedEntry()->isShared());
+      checkContents(*pin.checkedEntry());
+    }
+  });
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(kNumThreads * kNumLookups, stats.numHit);
+  ASSERT_EQ(0, stats.numShared);
+  ASSERT_EQ(kNumEntries, stats.numEntries);
+}
+
+TEST_F(AsyncDataCacheTest, admissionPolicy) {
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumEntries = 10;
+  initializeCache(16 << 20);
+  cache_->setAdmissionPolicy(std::make_shared<TinyLfuAdmissionPolicy>());
+  auto load = [&](uint64_t offset, bool prefetch) {
+    auto pin = newEntry(offset, kSize);
+    ASSERT_FALSE(pin.empty());
+    if (!prefetch) {
+      pin.checkedEntry()->setPrefetch(false);
+    }
+    initializeContents(
+        filenames_[0].id() + offset, pin.checkedEntry()->data());
+    pin.checkedEntry()->setExclusiveToShared();
+  };
+
+  // The first load of each entry is not admitted.
+  for (auto i = 0; i < kNumEntries; ++i) {
+    load(i * kSize, false);
+  }
+  ASSERT_EQ(kNumEntries, cache_->refreshStats().numMemoryRejects);
+
+  // The entries stay available until their space is needed.
+  for (auto i = 0; i < kNumEntries; ++i) {
+    ASSERT_TRUE(cache_->exists(RawFileCacheKey{filenames_[0].id(), i * kSize}));
+  }
+
+  // The second load is admitted.
+  cache_->clear();
+  for (auto i = 0; i < kNumEntries; ++i) {
+    load(i * kSize, false);
+  }
+  ASSERT_EQ(kNumEntries, cache_->refreshStats().numMemoryRejects);
+
+  // A prefetched entry that is not admitted is returned by its first lookup.
+  const uint64_t prefetchOffset = kNumEntries * kSize;
+  load(prefetchOffset, true);
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(kNumEntries + 1, stats.numMemoryRejects);
+  ASSERT_EQ(0, stats.numSsdRejects);
+  auto pin = cache_->findOrCreate(
+      RawFileCacheKey{filenames_[0].id(), prefetchOffset}, kSize);
+  ASSERT_TRUE(pin.checkedEntry()->isShared());
+  ASSERT_TRUE(pin.checkedEntry()->getAndClearFirstUseFlag());
+  checkContents(*pin.checkedEntry());
+}
+
+namespace {
+// Keeps the data as is. Declines to compress if 'compressible' is false.
+class CopyCodec : public CacheCodec {
+ public:
+  std::string compress(
+      const std::vector<folly::Range<const char*>>& ranges) override {
+    std::string result;
+    if (compressible) {
+      for (const auto& range : ranges) {
+        result.append(range.data(), range.size());
+      }
+    }
+    return result;
+  }
+
+  void decompress(
+      std::string_view compressed,
+      const std::vector<folly::Range<char*>>& ranges) override {
+    size_t offset = 0;
+    for (const auto& range : ranges) {
+      VELOX_CHECK_LE(offset + range.size(), compressed.size());
+      memcpy(range.data(), compressed.data() + offset, range.size());
+      offset += range.size();
+    }
+    VELOX_CHECK_EQ(offset, compressed.size());
+  }
+
+  std::atomic<bool> compressible{true};
+};
+} // namespace
+
+TEST_F(AsyncDataCacheTest, compressedTier) {
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int64_t kMaxBytes = 4 << 20;
+  constexpr int32_t kNumEntries = 2 * kMaxBytes / kSize;
+  initializeCache(kMaxBytes);
+  auto codec = std::make_shared<CopyCodec>();
+  cache_->setCompressedTier(codec, kMaxBytes);
+  auto loadAll = [&]() {
+    for (auto i = 0; i < kNumEntries; ++i) {
+      const uint64_t offset = i * kSize;
+      auto pin = newEntry(offset, kSize);
+      ASSERT_FALSE(pin.empty());
+      pin.checkedEntry()->setPrefetch(false);
+      initializeContents(
+          filenames_[0].id() + offset, pin.checkedEntry()->data());
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+  };
+
+  // Twice the capacity is loaded. The entries that do not fit are compressed
+  // instead of evicted.
+  loadAll();
+  auto stats = cache_->refreshStats();
+  ASSERT_LT(0, stats.numCompress);
+  ASSERT_LT(0, stats.numCompressed);
+  ASSERT_LE(stats.compressedSize, kMaxBytes);
+  ASSERT_EQ(stats.compressedSize, stats.compressedOriginalSize);
+  ASSERT_EQ(kMaxBytes, stats.compressedBudget);
+  ASSERT_GE(
+      kMaxBytes / memory::AllocationTraits::kPageSize,
+      cache_->incrementCachedPages(0));
+
+  // Hits on compressed entries get the original data.
+  for (auto i = 0; i < kNumEntries; ++i) {
+    auto pin = cache_->findOrCreate(
+        RawFileCacheKey{filenames_[0].id(), static_cast<uint64_t>(i * kSize)},
+        kSize);
+    ASSERT_FALSE(pin.empty());
+    if (pin.checkedEntry()->isShared()) {
+      checkContents(*pin.checkedEntry());
+    }
+  }
+  stats = cache_->refreshStats();
+  ASSERT_LT(0, stats.numCompressedHit);
+  ASSERT_LE(stats.numCompressedHit, stats.numHit);
+  ASSERT_LE(stats.compressedSize, kMaxBytes);
+
+  // Compressed entries are dropped by clear().
+  cache_->clear();
+  stats = cache_->refreshStats();
+  ASSERT_EQ(0, stats.numCompressed);
+  ASSERT_EQ(0, stats.compressedSize);
+
+  // Entries that do not compress are evicted.
+  codec->compressible = false;
+  loadAll();
+  stats = cache_->refreshStats();
+  ASSERT_LT(0, stats.numCompressFailures);
+  ASSERT_EQ(0, stats.numCompressed);
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheAdmissionPolicy.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+TEST(CacheAdmissionPolicyTest, tinyLfu) {
+  constexpr int32_t kNumCounters = 1 << 10;
+  TinyLfuAdmissionPolicy policy(kNumCounters, 2, 3);
+  RawFileCacheKey hot{1, 0};
+  RawFileCacheKey cold{1, 1000};
+
+  ASSERT_EQ(0, policy.numLoads(hot));
+  policy.recordLoad(hot);
+  policy.recordLoad(cold);
+  ASSERT_FALSE(policy.admitToMemory(hot, 1000));
+  policy.recordLoad(hot);
+  ASSERT_TRUE(policy.admitToMemory(hot, 1000));
+  ASSERT_FALSE(policy.admitToSsd(hot, 1000));
+  policy.recordLoad(hot);
+  ASSERT_TRUE(policy.admitToSsd(hot, 1000));
+  ASSERT_FALSE(policy.admitToMemory(cold, 1000));
+
+  // The counts saturate.
+  for (auto i = 0; i < 100; ++i) {
+    policy.recordLoad(hot);
+  }
+  ASSERT_EQ(15, policy.numLoads(hot));
+
+  // A scan of many distinct keys that each get loaded once. Collisions in the
+  // sketch may make a few of these look like they were loaded before.
+  constexpr int32_t kNumScanKeys = 20 * kNumCounters;
+  int32_t numAdmitted = 0;
+  for (auto i = 0; i < kNumScanKeys; ++i) {
+    RawFileCacheKey key{2, static_cast<uint64_t>(i)};
+    policy.recordLoad(key);
+    numAdmitted += policy.admitToMemory(key, 1000);
+  }
+  ASSERT_LT(numAdmitted, kNumScanKeys / 10);
+
+  // The counts of 'hot' have been halved many times during the scan.
+  ASSERT_GT(2, policy.numLoads(hot));
+}
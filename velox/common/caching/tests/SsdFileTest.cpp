@@ -47,7 +47,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -55,11 +58,16 @@ class SsdFileTest : public testing::Test {
 
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
-    tempDirectory_ = exec::test::TempDirectoryPath::create();
+    // A second initialization reuses the directory so that the file can be
+    // recovered from the checkpoint of the previous one.
+    if (!tempDirectory_) {
+      tempDirectory_ = exec::test::TempDirectoryPath::create();
+    }
     ssdFile_ = std::make_unique<SsdFile>(
         fmt::format("{}/ssdtest", tempDirectory_->path),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes);
   }
 
   static void initializeContents(int64_t sequence, memory::Allocation& alloc) {
@@ -291,3 +299,50 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, recoverFromCheckpoint) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  initializeCache(128 * kMB, kSsdSize, kSsdSize);
+  int64_t numEntries = 0;
+  int64_t numBytes = 0;
+  for (auto startOffset = 0; startOffset < 2 * SsdFile::kRegionSize;
+       startOffset += SsdFile::kRegionSize) {
+    auto pins =
+        makePins(fileName_.id(), startOffset, 4096, 2048 * 1025, 62 * kMB);
+    ssdFile_->write(pins);
+    for (auto& pin : pins) {
+      ASSERT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+      ++numEntries;
+      numBytes += pin.entry()->size();
+    }
+  }
+  ssdFile_->checkpoint(true);
+
+  // Starts a new memory cache and SSD file on the same path, as after a
+  // restart.
+  ssdFile_.reset();
+  initializeCache(128 * kMB, kSsdSize, kSsdSize);
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  ASSERT_EQ(stats.entriesCached, numEntries);
+  ASSERT_EQ(stats.bytesCached, numBytes);
+  FileBytesMap fileBytes;
+  ssdFile_->addFileBytes(fileBytes);
+  ASSERT_EQ(1, fileBytes.size());
+  ASSERT_EQ(numBytes, fileBytes[fileName_.id()]);
+
+  for (auto startOffset = 0; startOffset < 2 * SsdFile::kRegionSize;
+       startOffset += SsdFile::kRegionSize) {
+    auto pins =
+        makePins(fileName_.id(), startOffset, 4096, 2048 * 1025, 62 * kMB);
+    readAndCheckPins(pins);
+  }
+
+  // A checkpoint for a different capacity is not used.
+  ssdFile_->checkpoint(true);
+  ssdFile_.reset();
+  initializeCache(128 * kMB, 2 * kSsdSize, kSsdSize);
+  stats = SsdCacheStats();
+  ssdFile_->updateStats(stats);
+  ASSERT_EQ(stats.entriesCached, 0);
+}
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUringReader.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -22,7 +23,9 @@
 #include <stdexcept>
 
 #include <fcntl.h>
+#include <folly/portability/SysMman.h>
 #include <folly/portability/SysUio.h>
+#include <folly/portability/Unistd.h>
 
 namespace facebook::velox {
 
@@ -73,7 +76,7 @@ uint64_t InMemoryWriteFile::size() const {
   return file_->size();
 }
 
-LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
+LocalReadFile::LocalReadFile(std::string_view path, bool mmap) : path_(path) {
   fd_ = open(path_.c_str(), O_RDONLY);
   VELOX_CHECK_GE(
       fd_,
@@ -91,11 +94,24 @@ LocalReadFile::LocalReadFile(std::string_view path) : path_(path) {
       path,
       folly::errnoStr(errno));
   size_ = rc;
+  if (mmap && size_ > 0) {
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+      LOG(WARNING) << "mmap failure in LocalReadFile constructor, reading "
+                   << path << " with pread: " << folly::errnoStr(errno);
+    } else {
+      mapped_ = static_cast<char*>(mapped);
+    }
+  }
 }
 
 LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
 
 LocalReadFile::~LocalReadFile() {
+  if (mapped_ && ::munmap(mapped_, size_) < 0) {
+    LOG(WARNING) << "munmap failure in LocalReadFile destructor: "
+                 << folly::errnoStr(errno);
+  }
   const int ret = close(fd_);
   if (ret < 0) {
     LOG(WARNING) << "close failure in LocalReadFile destructor: " << ret << ", "
@@ -105,6 +121,10 @@ LocalReadFile::~LocalReadFile() {
 
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
+  if (mapped_) {
+    memcpy(pos, mappedData(offset, length), length);
+    return;
+  }
   bytesRead_ += length;
   auto bytesRead = ::pread(fd_, pos, length, offset);
   VELOX_CHECK_EQ(
@@ -124,6 +144,10 @@ LocalReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
 uint64_t LocalReadFile::preadv(
     uint64_t offset,
     const std::vector<folly::Range<char*>>& buffers) const {
+  if (mapped_) {
+    // Copies from the mapping, skipping the ranges without data.
+    return ReadFile::preadv(offset, buffers);
+  }
   // Dropped bytes sized so that a typical dropped range of 50K is not
   // too many iovecs.
   static thread_local std::vector<char> droppedBytes(16 * 1024);
@@ -144,6 +168,49 @@ uint64_t LocalReadFile::preadv(
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto reader = IoUringReader::instance();
+  if (!reader || mapped_) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  return reader->preadv(fd_, offset, buffers);
+}
+
+bool LocalReadFile::hasPreadvAsync() const {
+  return !mapped_ && IoUringReader::instance() != nullptr;
+}
+
+const char* LocalReadFile::mappedData(uint64_t offset, uint64_t length) const {
+  if (!mapped_) {
+    return nullptr;
+  }
+  VELOX_CHECK_LE(
+      offset + length,
+      static_cast<uint64_t>(size_),
+      "Read past the end of mapped file {}: {} bytes at {}",
+      path_,
+      length,
+      offset);
+  bytesRead_ += length;
+  return mapped_ + offset;
+}
+
+void LocalReadFile::willNeed(uint64_t offset, uint64_t length) const {
+  if (!mapped_ || length == 0 || offset >= static_cast<uint64_t>(size_)) {
+    return;
+  }
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  // madvise takes a page aligned start.
+  const auto begin = offset / kPageSize * kPageSize;
+  const auto end = std::min<uint64_t>(offset + length, size_);
+  if (::madvise(mapped_ + begin, end - begin, MADV_WILLNEED) < 0) {
+    VLOG(1) << "madvise failure for " << path_ << ": "
+            << folly::errnoStr(errno);
+  }
+}
+
 uint64_t LocalReadFile::size() const {
   return size_;
 }
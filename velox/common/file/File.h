@@ -62,7 +62,9 @@ class ReadFile {
 
   // Like preadv but may execute asynchronously and returns the read
   // size or exception via SemiFuture. Use hasPreadvAsync() to check
-  // if the implementation is in fact asynchronous.
+  // if the implementation is in fact asynchronous. The memory referenced by
+  // 'buffers' must stay valid until the future is realized. 'buffers' itself
+  // need not.
   virtual folly::SemiFuture<uint64_t> preadvAsync(
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const {
@@ -79,6 +81,20 @@ class ReadFile {
     return false;
   }
 
+  // Returns a pointer to the bytes at [offset, offset + length) if the file is
+  // mapped in memory, so that they can be used without a copy, or nullptr if
+  // they have to be read. The bytes stay valid as long as 'this'. Counts the
+  // bytes as read.
+  virtual const char* FOLLY_NULLABLE
+  mappedData(uint64_t /*offset*/, uint64_t /*length*/) const {
+    return nullptr;
+  }
+
+  // Hints that [offset, offset + length) will be read soon, so that a mapped
+  // file can fault the range in ahead of use. A no-op for files that are not
+  // mapped.
+  virtual void willNeed(uint64_t /*offset*/, uint64_t /*length*/) const {}
+
   // Whether preads should be coalesced where possible. E.g. remote disk would
   // set to true, in-memory to false.
   virtual bool shouldCoalesce() const = 0;
@@ -203,7 +219,10 @@ class InMemoryWriteFile final : public WriteFile {
 
 class LocalReadFile final : public ReadFile {
  public:
-  explicit LocalReadFile(std::string_view path);
+  // If 'mmap' is true, maps the file in memory and serves reads from the
+  // mapping, see mappedData(). Falls back to pread if the file can't be
+  // mapped.
+  explicit LocalReadFile(std::string_view path, bool mmap = false);
 
   explicit LocalReadFile(int32_t fd);
 
@@ -218,6 +237,23 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  // Reads with io_uring if Velox is built with VELOX_ENABLE_IO_URING and the
+  // kernel supports it. Otherwise reads synchronously.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final;
+
+  const char* FOLLY_NULLABLE
+  mappedData(uint64_t offset, uint64_t length) const final;
+
+  void willNeed(uint64_t offset, uint64_t length) const final;
+
+  bool isMapped() const {
+    return mapped_ != nullptr;
+  }
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
@@ -242,6 +278,8 @@ class LocalReadFile final : public ReadFile {
   std::string path_;
   int32_t fd_;
   long size_;
+  // The whole file if it is mapped, see mappedData().
+  char* FOLLY_NULLABLE mapped_{nullptr};
 };
 
 class LocalWriteFile final : public WriteFile {
@@ -20,9 +20,17 @@
 #include "velox/common/file/File.h"
 #include "velox/core/Context.h"
 
+#include <gflags/gflags.h>
+
 #include <cstdio>
 #include <filesystem>
 
+DEFINE_bool(
+    velox_local_file_mmap,
+    false,
+    "Map local files in memory for reads instead of reading them with pread. "
+    "BufferedInput then uses the mapped bytes without copying them.");
+
 namespace facebook::velox::filesystems {
 
 namespace {
@@ -88,7 +96,8 @@ class LocalFileSystem : public FileSystem {
   std::unique_ptr<ReadFile> openFileForRead(
       std::string_view path,
       const FileOptions& /*unused*/) override {
-    return std::make_unique<LocalReadFile>(extractPath(path));
+    return std::make_unique<LocalReadFile>(
+        extractPath(path), FLAGS_velox_local_file_mmap);
   }
 
   std::unique_ptr<WriteFile> openFileForWrite(
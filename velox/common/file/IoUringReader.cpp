@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUringReader.h"
+
+#include "velox/common/base/Exceptions.h"
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <liburing.h>
+#include <sys/uio.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace facebook::velox {
+
+#ifdef VELOX_ENABLE_IO_URING
+
+class IoUringReader::Impl {
+ public:
+  // Maximum number of reads in flight. Further reads wait for a completion.
+  static constexpr int32_t kQueueDepth = 256;
+
+  // Maximum number of iovecs in one submission. Longer reads are submitted
+  // in parts.
+  static constexpr size_t kMaxIovecs = 1024;
+
+  Impl() {
+    const auto rc = io_uring_queue_init(kQueueDepth, &ring_, 0);
+    VELOX_CHECK_GE(
+        rc, 0, "io_uring_queue_init failed: {}", folly::errnoStr(-rc));
+    completionThread_ = std::thread([this]() { completionLoop(); });
+  }
+
+  ~Impl() {
+    {
+      // A nop with no request stops the completion thread.
+      std::unique_lock<std::mutex> l(mutex_);
+      cv_.wait(l, [&]() { return inFlight_ < kQueueDepth; });
+      auto sqe = io_uring_get_sqe(&ring_);
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      io_uring_submit(&ring_);
+    }
+    completionThread_.join();
+    io_uring_queue_exit(&ring_);
+  }
+
+  std::vector<folly::SemiFuture<uint64_t>> preadvBatch(
+      int32_t fd,
+      const std::vector<Read>& reads) {
+    std::vector<std::unique_ptr<Request>> requests;
+    std::vector<folly::SemiFuture<uint64_t>> futures;
+    requests.reserve(reads.size());
+    futures.reserve(reads.size());
+    for (const auto& read : reads) {
+      requests.push_back(makeRequest(fd, read.offset, read.buffers));
+      futures.push_back(requests.back()->promise.getSemiFuture());
+    }
+    std::unique_lock<std::mutex> l(mutex_);
+    for (auto& request : requests) {
+      if (inFlight_ >= kQueueDepth) {
+        // Submit what is prepared before waiting for completions.
+        io_uring_submit(&ring_);
+        cv_.wait(l, [&]() { return inFlight_ < kQueueDepth; });
+      }
+      ++inFlight_;
+      prepareLocked(request.release());
+    }
+    const auto rc = io_uring_submit(&ring_);
+    VELOX_CHECK_GE(rc, 0, "io_uring_submit failed: {}", folly::errnoStr(-rc));
+    return futures;
+  }
+
+ private:
+  struct Request {
+    int32_t fd;
+    // File offset of 'iovecs[first]'.
+    uint64_t offset;
+    std::vector<iovec> iovecs;
+    // Index of the first iovec that is not fully read.
+    size_t first{0};
+    uint64_t bytesRead{0};
+    folly::Promise<uint64_t> promise;
+
+    // Advances the read position by 'bytes'.
+    void advance(uint64_t bytes) {
+      bytesRead += bytes;
+      offset += bytes;
+      while (bytes > 0) {
+        auto& iov = iovecs[first];
+        if (bytes < iov.iov_len) {
+          iov.iov_base = static_cast<char*>(iov.iov_base) + bytes;
+          iov.iov_len -= bytes;
+          return;
+        }
+        bytes -= iov.iov_len;
+        ++first;
+      }
+    }
+  };
+
+  static std::unique_ptr<Request> makeRequest(
+      int32_t fd,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) {
+    // Skipped ranges are read into a buffer that nobody reads. Concurrent
+    // reads may overwrite each other there.
+    static std::vector<char> droppedBytes(64 * 1024);
+    auto request = std::make_unique<Request>();
+    request->fd = fd;
+    request->offset = offset;
+    request->iovecs.reserve(buffers.size());
+    for (const auto& range : buffers) {
+      if (!range.data()) {
+        auto skipSize = range.size();
+        while (skipSize) {
+          auto bytes = std::min<size_t>(droppedBytes.size(), skipSize);
+          request->iovecs.push_back({droppedBytes.data(), bytes});
+          skipSize -= bytes;
+        }
+      } else {
+        request->iovecs.push_back({range.data(), range.size()});
+      }
+    }
+    return request;
+  }
+
+  // Adds a readv of the unread part of 'request' to the submission queue.
+  // The caller submits the queue.
+  void prepareLocked(Request* request) {
+    auto sqe = io_uring_get_sqe(&ring_);
+    VELOX_CHECK_NOT_NULL(sqe, "io_uring submission queue is full");
+    const auto numIovecs =
+        std::min(kMaxIovecs, request->iovecs.size() - request->first);
+    io_uring_prep_readv(
+        sqe,
+        request->fd,
+        request->iovecs.data() + request->first,
+        numIovecs,
+        request->offset);
+    io_uring_sqe_set_data(sqe, request);
+  }
+
+  void completionLoop() {
+    for (;;) {
+      io_uring_cqe* cqe;
+      const auto rc = io_uring_wait_cqe(&ring_, &cqe);
+      if (rc < 0) {
+        if (rc != -EINTR) {
+          LOG(ERROR) << "io_uring_wait_cqe failed: " << folly::errnoStr(-rc);
+        }
+        continue;
+      }
+      auto request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+      const auto result = cqe->res;
+      io_uring_cqe_seen(&ring_, cqe);
+      if (!request) {
+        return;
+      }
+      complete(request, result);
+    }
+  }
+
+  // Completes 'request' after a readv that returned 'result'. Submits the
+  // rest if the read was short or did not cover all iovecs. A read that
+  // returns 0 bytes has reached the end of the file.
+  void complete(Request* request, int32_t result) {
+    if (result > 0) {
+      request->advance(result);
+      if (request->first < request->iovecs.size()) {
+        std::lock_guard<std::mutex> l(mutex_);
+        prepareLocked(request);
+        io_uring_submit(&ring_);
+        return;
+      }
+    }
+    std::unique_ptr<Request> finished(request);
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      --inFlight_;
+    }
+    cv_.notify_all();
+    if (result < 0) {
+      try {
+        VELOX_FAIL(
+            "io_uring read at {} failed: {}",
+            finished->offset,
+            folly::errnoStr(-result));
+      } catch (const std::exception&) {
+        finished->promise.setException(
+            folly::exception_wrapper(std::current_exception()));
+      }
+      return;
+    }
+    finished->promise.setValue(finished->bytesRead);
+  }
+
+  io_uring ring_;
+
+  // Serializes submissions.
+  std::mutex mutex_;
+
+  // Signaled when a read completes.
+  std::condition_variable cv_;
+
+  // Number of submitted reads that are not completed.
+  int32_t inFlight_{0};
+
+  std::thread completionThread_;
+};
+
+IoUringReader* IoUringReader::instance() {
+  static std::unique_ptr<IoUringReader> reader =
+      []() -> std::unique_ptr<IoUringReader> {
+    try {
+      return std::unique_ptr<IoUringReader>(
+          new IoUringReader(std::make_unique<Impl>()));
+    } catch (const std::exception& e) {
+      // E.g. io_uring is disabled or not supported by the kernel.
+      LOG(WARNING) << "Using synchronous reads: " << e.what();
+      return nullptr;
+    }
+  }();
+  return reader.get();
+}
+
+std::vector<folly::SemiFuture<uint64_t>> IoUringReader::preadvBatch(
+    int32_t fd,
+    const std::vector<Read>& reads) {
+  return impl_->preadvBatch(fd, reads);
+}
+
+#else
+
+class IoUringReader::Impl {};
+
+IoUringReader* IoUringReader::instance() {
+  return nullptr;
+}
+
+std::vector<folly::SemiFuture<uint64_t>> IoUringReader::preadvBatch(
+    int32_t /*fd*/,
+    const std::vector<Read>& /*reads*/) {
+  VELOX_UNSUPPORTED("Velox is built without io_uring");
+}
+
+#endif
+
+IoUringReader::IoUringReader(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+IoUringReader::~IoUringReader() = default;
+
+folly::SemiFuture<uint64_t> IoUringReader::preadv(
+    int32_t fd,
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  std::vector<Read> reads;
+  reads.push_back(Read{offset, buffers});
+  return std::move(preadvBatch(fd, reads)[0]);
+}
+
+} // namespace facebook::velox
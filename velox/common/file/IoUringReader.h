@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <folly/Range.h>
+#include <folly/futures/Future.h>
+
+namespace facebook::velox {
+
+// Reads local files asynchronously with io_uring. One ring is shared by the
+// process. Reads are submitted by the calling thread and completed by a
+// dedicated thread that realizes the returned futures, so that no thread
+// blocks in IO wait. Available only if Velox is built with
+// VELOX_ENABLE_IO_URING and the kernel supports io_uring.
+class IoUringReader {
+ public:
+  // A read of consecutive bytes into 'buffers', like ReadFile::preadv().
+  struct Read {
+    uint64_t offset;
+    std::vector<folly::Range<char*>> buffers;
+  };
+
+  // Returns the process wide reader or nullptr if io_uring is not available.
+  static IoUringReader* FOLLY_NULLABLE instance();
+
+  ~IoUringReader();
+
+  // Starts reading 'fd' at 'offset' into 'buffers'. A buffer with nullptr
+  // data skips its size worth of bytes. The returned future is realized with
+  // the number of bytes read, including the skipped ones, or the error. The
+  // memory referenced by 'buffers' must stay valid until then.
+  folly::SemiFuture<uint64_t> preadv(
+      int32_t fd,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers);
+
+  // Starts all of 'reads' of 'fd' with a single submission to the kernel.
+  // Returns a future for each read, in the order of 'reads'.
+  std::vector<folly::SemiFuture<uint64_t>> preadvBatch(
+      int32_t fd,
+      const std::vector<Read>& reads);
+
+ private:
+  class Impl;
+
+  explicit IoUringReader(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace facebook::velox
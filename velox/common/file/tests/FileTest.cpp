@@ -18,6 +18,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUringReader.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
@@ -98,6 +99,76 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, preadvAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadFile readFile(filename);
+  ASSERT_EQ(IoUringReader::instance() != nullptr, readFile.hasPreadvAsync());
+  char head[12];
+  char middle[4];
+  char tail[7];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)500000),
+      folly::Range<char*>(middle, sizeof(middle)),
+      folly::Range<char*>(
+          nullptr,
+          (char*)(uint64_t)(15 + kOneMB - 500000 - sizeof(head) -
+                            sizeof(middle) - sizeof(tail))),
+      folly::Range<char*>(tail, sizeof(tail))};
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  for (auto i = 0; i < 10; ++i) {
+    futures.push_back(readFile.preadvAsync(0, buffers));
+  }
+  for (auto& future : futures) {
+    ASSERT_EQ(15 + kOneMB, std::move(future).get());
+  }
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+  // Reading past the end returns the bytes up to the end.
+  char last[10];
+  ASSERT_EQ(
+      5,
+      readFile
+          .preadvAsync(10 + kOneMB, {folly::Range<char*>(last, sizeof(last))})
+          .get());
+  ASSERT_EQ(std::string_view(last, 5), "ddddd");
+}
+
+TEST(LocalFile, mmap) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadFile readFile(filename, true);
+  ASSERT_TRUE(readFile.isMapped());
+  ASSERT_FALSE(readFile.hasPreadvAsync());
+  readData(&readFile);
+
+  readFile.resetBytesRead();
+  const auto* data = readFile.mappedData(kOneMB + 8, 7);
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(std::string_view(data, 7), "ccddddd");
+  ASSERT_EQ(readFile.bytesRead(), 7);
+  readFile.willNeed(10, kOneMB);
+  ASSERT_ANY_THROW(readFile.mappedData(kOneMB, 16));
+
+  // The same file read with pread is not mapped.
+  LocalReadFile unmapped(filename);
+  ASSERT_FALSE(unmapped.isMapped());
+  ASSERT_EQ(unmapped.mappedData(0, 5), nullptr);
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -18,6 +18,7 @@
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -117,6 +118,39 @@ double correctBias(double rawEstimate, int8_t indexBitLength) {
 
   return rawEstimate - bias;
 }
+
+/// Sets each 4-bit delta in 'deltas' to the max of itself and the delta at the
+/// same position in 'otherDeltas'. Returns the number of zero deltas in the
+/// result.
+int32_t mergeDeltas(int8_t* deltas, const int8_t* otherDeltas, int32_t size) {
+  using Batch = xsimd::batch<uint8_t>;
+  const Batch lowMask(static_cast<uint8_t>(kBucketMask));
+  const Batch highMask(static_cast<uint8_t>(kBucketMask << kBitsPerBucket));
+  const Batch zero(0);
+  auto* rawDeltas = reinterpret_cast<uint8_t*>(deltas);
+  auto* rawOtherDeltas = reinterpret_cast<const uint8_t*>(otherDeltas);
+
+  int32_t numZeros = 0;
+  int32_t i = 0;
+  for (; i + Batch::size <= size; i += Batch::size) {
+    auto slots = Batch::load_unaligned(rawDeltas + i);
+    auto otherSlots = Batch::load_unaligned(rawOtherDeltas + i);
+    auto low = xsimd::max(slots & lowMask, otherSlots & lowMask);
+    auto high = xsimd::max(slots & highMask, otherSlots & highMask);
+    (low | high).store_unaligned(rawDeltas + i);
+    numZeros += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+  }
+  for (; i < size; ++i) {
+    uint8_t low =
+        std::max(rawDeltas[i] & kBucketMask, rawOtherDeltas[i] & kBucketMask);
+    uint8_t high = std::max(
+        rawDeltas[i] >> kBitsPerBucket, rawOtherDeltas[i] >> kBitsPerBucket);
+    rawDeltas[i] = (high << kBitsPerBucket) | low;
+    numZeros += (low == 0) + (high == 0);
+  }
+  return numZeros;
+}
 } // namespace
 
 DenseHll::DenseHll(int8_t indexBitLength, HashStringAllocator* allocator)
@@ -143,6 +177,12 @@ void DenseHll::insertHash(uint64_t hash) {
   insert(index, value);
 }
 
+void DenseHll::insertHashes(folly::Range<const uint64_t*> hashes) {
+  for (auto hash : hashes) {
+    insertHash(hash);
+  }
+}
+
 void DenseHll::insert(int32_t index, int8_t value) {
   auto delta = value - baseline_;
   auto oldDelta = getDelta(index);
@@ -568,6 +608,12 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
+  if (baseline_ == otherBaseline) {
+    mergeWithSameBaseline(
+        otherDeltas, otherOverflows, otherOverflowBuckets, otherOverflowValues);
+    return;
+  }
+
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
@@ -623,6 +669,29 @@ void DenseHll::mergeWith(
   adjustBaselineIfNeeded();
 }
 
+void DenseHll::mergeWithSameBaseline(
+    const int8_t* otherDeltas,
+    int16_t otherOverflows,
+    const uint16_t* otherOverflowBuckets,
+    const int8_t* otherOverflowValues) {
+  baselineCount_ = mergeDeltas(deltas_.data(), otherDeltas, deltas_.size());
+
+  // A bucket that overflows in either HLL has the max delta after the merge
+  // and keeps the larger of the overflows.
+  for (auto i = 0; i < otherOverflows; ++i) {
+    auto bucket = otherOverflowBuckets[i];
+    auto overflowEntry = findOverflowEntry(bucket);
+    if (overflowEntry == -1) {
+      addOverflow(bucket, otherOverflowValues[i]);
+    } else {
+      overflowValues_[overflowEntry] =
+          std::max(overflowValues_[overflowEntry], otherOverflowValues[i]);
+    }
+  }
+
+  adjustBaselineIfNeeded();
+}
+
 int8_t
 DenseHll::updateOverflow(int32_t index, int overflowEntry, int8_t delta) {
   if (delta > kMaxDelta) {
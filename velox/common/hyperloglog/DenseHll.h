@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/Range.h>
+
 #include "velox/common/memory/HashStringAllocator.h"
 
 namespace facebook::velox::common::hll {
@@ -48,6 +50,9 @@ class DenseHll {
 
   void insertHash(uint64_t hash);
 
+  /// Inserts a batch of hashes. Equivalent to calling insertHash for each.
+  void insertHashes(folly::Range<const uint64_t*> hashes);
+
   /// Inserts pre-computed {bucket, value} pair. These value must be compatible
   /// with computeIndex and computeValue methods called with the indexBitLength
   /// value of this HLL. Used by SparseHll.toDense().
@@ -116,6 +121,14 @@ class DenseHll {
       const uint16_t* otherOverflowBuckets,
       const int8_t* otherOverflowValues);
 
+  /// Merges an HLL with the same baseline. The deltas are merged a SIMD batch
+  /// at a time and only the overflows are merged bucket by bucket.
+  void mergeWithSameBaseline(
+      const int8_t* otherDeltas,
+      int16_t otherOverflows,
+      const uint16_t* otherOverflowBuckets,
+      const int8_t* otherOverflowValues);
+
   /// Number of first bits of the hash to calculate buckets from.
   int8_t indexBitLength_;
 
@@ -220,6 +220,34 @@ TEST_P(DenseHllTest, mergeWith) {
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
 }
 
+TEST_P(DenseHllTest, mergeMany) {
+  int8_t indexBitLength = GetParam();
+
+  // Merges many partial HLLs into one, as in a final aggregation. The
+  // baselines of the partial HLLs and the merged one differ until the merged
+  // one has seen enough values.
+  DenseHll merged{indexBitLength, &allocator_};
+  DenseHll expected{indexBitLength, &allocator_};
+  int32_t value = 0;
+  for (auto i = 0; i < 200; ++i) {
+    std::vector<uint64_t> hashes;
+    for (auto j = 0; j < 1'000 + i * 10; ++j) {
+      hashes.push_back(hashOne(value++));
+    }
+    DenseHll partial{indexBitLength, &allocator_};
+    partial.insertHashes(hashes);
+    expected.insertHashes(hashes);
+    if (i % 2 == 0) {
+      merged.mergeWith(partial);
+    } else {
+      merged.mergeWith(serialize(partial).data());
+    }
+  }
+
+  ASSERT_EQ(serialize(merged), serialize(expected));
+  ASSERT_EQ(merged.cardinality(), expected.cardinality());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DenseHllTest,
     DenseHllTest,
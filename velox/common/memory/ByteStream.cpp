@@ -59,7 +59,10 @@ void ByteStream::flush(OutputStream* out) {
     if (isBits_ && isReverseBitOrder_ && !isReversed_) {
       bits::reverseBits(ranges_[i].buffer, bytes);
     }
-    out->write(reinterpret_cast<char*>(ranges_[i].buffer), bytes);
+    auto* data = reinterpret_cast<char*>(ranges_[i].buffer);
+    if (!out->writeShared(arena_, data, bytes)) {
+      out->write(data, bytes);
+    }
   }
   if (isBits_ && isReverseBitOrder_) {
     isReversed_ = true;
@@ -96,6 +99,16 @@ struct FreeData {
   std::function<void()> releaseFn;
 };
 
+void appendIOBuf(
+    std::unique_ptr<folly::IOBuf> newBuf,
+    std::unique_ptr<folly::IOBuf>& iobuf) {
+  if (iobuf) {
+    iobuf->prev()->appendChain(std::move(newBuf));
+  } else {
+    iobuf = std::move(newBuf);
+  }
+}
+
 FreeData* newFreeData(
     const std::shared_ptr<StreamArena>& arena,
     const std::function<void()>& releaseFn) {
@@ -113,35 +126,117 @@ void freeFunc(void* /*data*/, void* userData) {
   }
   delete freeData;
 }
+
+// Appends an IOBuf for each range of 'stream' to 'iobuf'. The IOBufs keep
+// shared ownership of 'arena'.
+void appendRanges(
+    ByteStream& stream,
+    const std::shared_ptr<StreamArena>& arena,
+    const std::function<void()>& releaseFn,
+    std::unique_ptr<folly::IOBuf>& iobuf) {
+  auto& ranges = stream.ranges();
+  for (auto& range : ranges) {
+    auto numValues =
+        &range == &ranges.back() ? stream.lastRangeEnd() : range.size;
+    appendIOBuf(
+        folly::IOBuf::takeOwnership(
+            reinterpret_cast<char*>(range.buffer),
+            numValues,
+            freeFunc,
+            newFreeData(arena, releaseFn)),
+        iobuf);
+  }
+}
 } // namespace
 
+void IOBufOutputStream::write(const char* s, std::streamsize count) {
+  auto* stream = target();
+  if (seekPiece_ >= 0) {
+    const auto& piece = pieces_[seekPiece_];
+    VELOX_CHECK_LE(
+        static_cast<int64_t>(stream->tellp()) + count,
+        piece.size,
+        "Write after a seek crosses a shared range");
+  }
+  stream->appendStringPiece(folly::StringPiece(s, count));
+  if (listener_) {
+    listener_->onWrite(s, count);
+  }
+}
+
+bool IOBufOutputStream::writeShared(
+    const StreamArena* arena,
+    const char* s,
+    std::streamsize count) {
+  if (!sharedArena_ || arena != sharedArena_.get() || count < kMinSharedBytes ||
+      seekPiece_ >= 0) {
+    return false;
+  }
+  // Shared ranges are taken at the end of the output.
+  const int64_t size = out_->size();
+  VELOX_CHECK_EQ(static_cast<int64_t>(out_->tellp()), size);
+  if (size > 0) {
+    pieces_.push_back({std::move(out_), nullptr, piecesSize_, size});
+    piecesSize_ += size;
+    out_ = std::make_unique<ByteStream>(arena_.get());
+    out_->startWrite(memory::AllocationTraits::kPageSize);
+  }
+  pieces_.push_back({nullptr, s, piecesSize_, static_cast<int64_t>(count)});
+  piecesSize_ += count;
+  if (listener_) {
+    listener_->onWrite(s, count);
+  }
+  return true;
+}
+
 std::unique_ptr<folly::IOBuf> IOBufOutputStream::getIOBuf(
     const std::function<void()>& releaseFn) {
   // Make an IOBuf for each range. The IOBufs keep shared ownership of
-  // 'arena_'.
+  // 'arena_' or, for shared ranges, of 'sharedArena_'.
   std::unique_ptr<folly::IOBuf> iobuf;
-  auto& ranges = out_->ranges();
-  for (auto& range : ranges) {
-    auto numValues =
-        &range == &ranges.back() ? out_->lastRangeEnd() : range.size;
-    auto userData = newFreeData(arena_, releaseFn);
-    auto newBuf = folly::IOBuf::takeOwnership(
-        reinterpret_cast<char*>(range.buffer), numValues, freeFunc, userData);
-    if (iobuf) {
-      iobuf->prev()->appendChain(std::move(newBuf));
+  for (auto& piece : pieces_) {
+    if (piece.stream) {
+      appendRanges(*piece.stream, arena_, releaseFn, iobuf);
     } else {
-      iobuf = std::move(newBuf);
+      appendIOBuf(
+          folly::IOBuf::takeOwnership(
+              const_cast<char*>(piece.shared),
+              piece.size,
+              freeFunc,
+              newFreeData(sharedArena_, releaseFn)),
+          iobuf);
     }
   }
+  appendRanges(*out_, arena_, releaseFn, iobuf);
   return iobuf;
 }
 
 std::streampos IOBufOutputStream::tellp() const {
-  return out_->tellp();
+  if (seekPiece_ >= 0) {
+    const auto& piece = pieces_[seekPiece_];
+    return piece.offset + piece.stream->tellp();
+  }
+  return piecesSize_ + out_->tellp();
 }
 
 void IOBufOutputStream::seekp(std::streampos pos) {
-  out_->seekp(pos);
+  const int64_t position = pos;
+  if (position >= piecesSize_) {
+    seekPiece_ = -1;
+    out_->seekp(position - piecesSize_);
+    return;
+  }
+  // Seeks back into the bytes before a shared range, e.g. to write a header.
+  for (auto i = 0; i < pieces_.size(); ++i) {
+    auto& piece = pieces_[i];
+    if (position < piece.offset + piece.size) {
+      VELOX_CHECK_NOT_NULL(
+          piece.stream, "Seeking into a shared range: {}", position);
+      seekPiece_ = i;
+      piece.stream->seekp(position - piece.offset);
+      return;
+    }
+  }
 }
 
 } // namespace facebook::velox
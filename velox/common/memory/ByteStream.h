@@ -48,6 +48,17 @@ class OutputStream {
 
   virtual void write(const char* s, std::streamsize count) = 0;
 
+  // Like write() but may reference the 'count' bytes at 's' instead of
+  // copying them if they are in memory of 'arena'. Returns false if the bytes
+  // are not taken, in which case the caller writes them with write(). The
+  // bytes must not change after this.
+  virtual bool writeShared(
+      const StreamArena* /*arena*/,
+      const char* /*s*/,
+      std::streamsize /*count*/) {
+    return false;
+  }
+
   virtual std::streampos tellp() const = 0;
 
   virtual void seekp(std::streampos pos) = 0;
@@ -412,23 +423,59 @@ class IOBufOutputStream : public OutputStream {
     out_->startWrite(initialSize);
   }
 
-  void write(const char* s, std::streamsize count) override {
-    out_->appendStringPiece(folly::StringPiece(s, count));
-    if (listener_) {
-      listener_->onWrite(s, count);
-    }
-  }
+  void write(const char* s, std::streamsize count) override;
+
+  /// Takes 'count' bytes without copying them if 'arena' is the arena given
+  /// to shareRanges() and 'count' is at least kMinSharedBytes.
+  bool writeShared(
+      const StreamArena* arena,
+      const char* s,
+      std::streamsize count) override;
 
   std::streampos tellp() const override;
 
   void seekp(std::streampos pos) override;
 
+  /// Makes the IOBufs from getIOBuf() reference the ranges of 'arena' that
+  /// are flushed to 'this' with ByteStream::flush() instead of copies of them.
+  /// The IOBufs keep shared ownership of 'arena', which must not change after
+  /// the flush. Used for shuffle, where the serialized streams are
+  /// discarded after the flush.
+  void shareRanges(std::shared_ptr<StreamArena> arena) {
+    sharedArena_ = std::move(arena);
+  }
+
   /// 'releaseFn' is executed on iobuf destruction if not null.
   std::unique_ptr<folly::IOBuf> getIOBuf(
       const std::function<void()>& releaseFn = nullptr);
 
+  /// Shorter ranges are copied since an IOBuf per range would cost more.
+  static constexpr int32_t kMinSharedBytes = 1024;
+
  private:
+  // A part of the output before 'out_'. Either the bytes written
+  // before a shared range, in 'stream', or a shared range.
+  struct Piece {
+    std::unique_ptr<ByteStream> stream;
+    const char* shared{nullptr};
+    // Position of the piece in the output.
+    int64_t offset;
+    int64_t size;
+  };
+
+  // The stream written by write(). A piece before 'out_' after a seek into
+  // it, otherwise 'out_'.
+  ByteStream* target() const {
+    return seekPiece_ < 0 ? out_.get() : pieces_[seekPiece_].stream.get();
+  }
+
   std::shared_ptr<StreamArena> arena_;
+  std::shared_ptr<StreamArena> sharedArena_;
+  std::vector<Piece> pieces_;
+  // Number of bytes in 'pieces_'.
+  int64_t piecesSize_{0};
+  // Index in 'pieces_' of the piece written after a seekp() into it or -1.
+  int32_t seekPiece_{-1};
   std::unique_ptr<ByteStream> out_;
 };
 
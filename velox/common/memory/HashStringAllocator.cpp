@@ -239,27 +239,48 @@ HashStringAllocator::allocateFromFreeList(
   if (!numFree_) {
     return nullptr;
   }
-  VELOX_CHECK(!free_.empty());
+  VELOX_CHECK_NE(freeNonEmpty_, 0);
   preferredSize = std::max(kMinAlloc, preferredSize);
-  int32_t counter = 0;
+  const auto index = freeListIndex(preferredSize);
+  // The blocks in the free lists above 'index' all fit.
+  const auto largerIndex = index + 1 < kNumFreeLists
+      ? bits::findFirstBit(&freeNonEmpty_, index + 1, kNumFreeLists)
+      : -1;
   Header* largest = nullptr;
   Header* found = nullptr;
-  for (auto* item = free_.next(); item != &free_; item = item->next()) {
-    auto header = headerOf(item);
-    VELOX_CHECK(header->isFree());
-    auto size = header->size();
-    if (size >= preferredSize) {
-      found = header;
-      break;
-    }
-    if (!largest || size > largest->size()) {
-      largest = header;
-    }
-    if (!mustHaveSize && ++counter > kMaxCheckedForFit) {
-      break;
+  if (freeNonEmpty_ & (1UL << index)) {
+    // All the blocks of the size class are checked only if there is no larger
+    // block to fall back to.
+    const bool checkAll = mustHaveSize && largerIndex == -1;
+    int32_t counter = 0;
+    auto& freeList = free_[index];
+    for (auto* item = freeList.next(); item != &freeList;
+         item = item->next()) {
+      auto header = headerOf(item);
+      VELOX_CHECK(header->isFree());
+      auto size = header->size();
+      if (size >= preferredSize) {
+        found = header;
+        break;
+      }
+      if (!largest || size > largest->size()) {
+        largest = header;
+      }
+      if (!checkAll && ++counter > kMaxCheckedForFit) {
+        break;
+      }
     }
   }
+  if (!found && largerIndex != -1) {
+    found = headerOf(free_[largerIndex].next());
+  }
   if (!mustHaveSize && !found) {
+    if (!largest && index > 0) {
+      const auto smallerIndex = bits::findLastBit(&freeNonEmpty_, 0, index);
+      if (smallerIndex != -1) {
+        largest = headerOf(free_[smallerIndex].next());
+      }
+    }
     found = largest;
   }
   if (!found) {
@@ -304,14 +325,16 @@ void HashStringAllocator::free(Header* _header) {
       }
     }
     if (header->isPreviousFree()) {
+      // The coalesced block may belong to a larger size class.
       auto previousFree = getPreviousFree(header);
+      removeFromFreeList(previousFree);
       previousFree->setSize(
           previousFree->size() + header->size() + sizeof(Header));
       header = previousFree;
     } else {
       ++numFree_;
-      free_.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
     }
+    addToFreeList(header);
     markAsFree(header);
     header = continued;
   } while (header);
@@ -441,9 +464,13 @@ void HashStringAllocator::checkConsistency() const {
   VELOX_CHECK_EQ(freeBytes, freeBytes_);
   uint64_t numInFreeList = 0;
   uint64_t bytesInFreeList = 0;
-  for (auto free = free_.next(); free != &free_; free = free->next()) {
-    ++numInFreeList;
-    bytesInFreeList += headerOf(free)->size() + sizeof(Header);
+  for (auto i = 0; i < kNumFreeLists; ++i) {
+    VELOX_CHECK_EQ(free_[i].empty(), (freeNonEmpty_ & (1UL << i)) == 0);
+    for (auto free = free_[i].next(); free != &free_[i]; free = free->next()) {
+      VELOX_CHECK_EQ(freeListIndex(headerOf(free)->size()), i);
+      ++numInFreeList;
+      bytesInFreeList += headerOf(free)->size() + sizeof(Header);
+    }
   }
   VELOX_CHECK_EQ(numInFreeList, numFree_);
   VELOX_CHECK_EQ(bytesInFreeList, freeBytes_);
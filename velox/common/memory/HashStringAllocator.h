@@ -27,8 +27,10 @@ namespace facebook::velox {
 
 // Implements an arena backed by MappedMemory::Allocation. This is for backing
 // ByteStream or for allocating single blocks. Blocks can be individually freed.
-// Adjacent frees are coalesced and free blocks are kept in a free list.
-// Allocated blocks are prefixed with a Header. This has a size and flags.
+// Adjacent frees are coalesced and free blocks are kept in free lists by size
+// class, so that finding a block of a given size does not walk through all the
+// free blocks. Allocated blocks are prefixed with a Header. This has a size and
+// flags.
 // kContinue means that last 8 bytes are a pointer to another Header after which
 // the contents of this allocation continue. kFree means the block is free. A
 // free block has pointers to the next and previous free block via a
@@ -266,7 +268,10 @@ class HashStringAllocator : public StreamArena {
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
-    new (&free_) CompactDoubleList();
+    for (auto& freeList : free_) {
+      new (&freeList) CompactDoubleList();
+    }
+    freeNonEmpty_ = 0;
     pool_.clear();
   }
 
@@ -286,6 +291,18 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kUnitSize = 16 * memory::AllocationTraits::kPageSize;
   static constexpr int32_t kMinContiguous = 48;
 
+  // Number of size classes of free blocks. Free list 0 has the blocks below 32
+  // bytes, free list i has the blocks of [2^(i + 4), 2^(i + 5)) bytes and the
+  // last one has all the blocks of 8KB and above, header excluded.
+  static constexpr int32_t kNumFreeLists = 10;
+
+  // Returns the index in 'free_' of the free list for a block of 'size' bytes.
+  static int32_t freeListIndex(int32_t size) {
+    return std::min<int32_t>(
+        kNumFreeLists - 1,
+        std::max<int32_t>(0, 59 - bits::countLeadingZeros(size)));
+  }
+
   // Adds 'bytes' worth of contiguous space to the free list. This
   // grows the footprint in MemoryAllocator but does not allocate
   // anything yet. Throws if fails to grow. The caller typically knows
@@ -294,10 +311,23 @@ class HashStringAllocator : public StreamArena {
   // starting to process a batch of input.
   void newSlab(int32_t size);
 
+  // Adds free block 'header' to the free list of its size class.
+  void addToFreeList(Header* FOLLY_NONNULL header) {
+    const auto index = freeListIndex(header->size());
+    free_[index].insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
+    freeNonEmpty_ |= 1UL << index;
+  }
+
+  // Removes free block 'header' from its free list. The size of 'header' must
+  // not have changed since it was added.
   void removeFromFreeList(Header* FOLLY_NONNULL header) {
     VELOX_CHECK(header->isFree());
     header->clearFree();
+    const auto index = freeListIndex(header->size());
     reinterpret_cast<CompactDoubleList*>(header->begin())->remove();
+    if (free_[index].empty()) {
+      freeNonEmpty_ &= ~(1UL << index);
+    }
   }
 
   /// Allocates a block of specified size. If exactSize is false, the block may
@@ -310,7 +340,9 @@ class HashStringAllocator : public StreamArena {
   // than 'preferredSize'. If 'isFinalSize' is true, this will not
   // return a block that is much larger than preferredSize. Otherwise,
   // the block can be larger and the user is expected to call
-  // freeRestOfBlock to finalize the allocation.
+  // freeRestOfBlock to finalize the allocation. A few blocks of the size
+  // class of 'preferredSize' are checked for fit before taking a block of a
+  // larger size class, which always fits.
   Header* FOLLY_NULLABLE allocateFromFreeList(
       int32_t preferredSize,
       bool mustHaveSize,
@@ -321,13 +353,16 @@ class HashStringAllocator : public StreamArena {
   // blocks would be below minimum size.
   void freeRestOfBlock(Header* FOLLY_NONNULL header, int32_t keepBytes);
 
-  // Circular list of free blocks.
-  CompactDoubleList free_;
+  // Circular lists of free blocks by size class.
+  CompactDoubleList free_[kNumFreeLists];
+
+  // Bit i is set if 'free_[i]' is not empty.
+  uint64_t freeNonEmpty_{0};
 
-  // Count of elements in 'free_'. This is 0 when free_.next() == &free_.
+  // Count of elements in 'free_'. This is 0 when all 'free_' are empty.
   uint64_t numFree_ = 0;
 
-  // Sum of the size of blocks in 'free_', excluding headers.
+  // Sum of the size of blocks in 'free_', including headers.
   uint64_t freeBytes_ = 0;
 
   // Counter of allocated bytes. The difference of two point in time values
@@ -16,6 +16,8 @@
 
 #include "velox/common/memory/Memory.h"
 
+#include <folly/ScopeGuard.h>
+
 DECLARE_bool(velox_enable_memory_usage_track_in_default_memory_pool);
 
 namespace facebook::velox::memory {
@@ -29,6 +31,18 @@ namespace {
       "Exceeded memory manager cap of {} MB",                       \
       (cap) / 1024 / 1024);
 
+std::unique_ptr<MemoryArbitrator> createArbitrator(
+    const IMemoryManager::Options& options) {
+  if (!options.arbitratorConfig.has_value()) {
+    return nullptr;
+  }
+  auto config = options.arbitratorConfig.value();
+  if (config.allocator == nullptr) {
+    config.allocator = options.allocator;
+  }
+  return MemoryArbitrator::create(config);
+}
+
 constexpr folly::StringPiece kDefaultRootName{"__default_root__"};
 constexpr folly::StringPiece kDefaultLeafName("__default_leaf__");
 } // namespace
@@ -36,8 +50,11 @@ constexpr folly::StringPiece kDefaultLeafName("__default_leaf__");
 MemoryManager::MemoryManager(const Options& options)
     : allocator_{options.allocator->shared_from_this()},
       memoryQuota_{options.capacity},
+      arbitrator_{createArbitrator(options)},
       alignment_(std::max(MemoryAllocator::kMinAlignment, options.alignment)),
       checkUsageLeak_(options.checkUsageLeak),
+      trackPoolAllocations_(options.trackPoolAllocations),
+      poolAllocationStackSampleRate_(options.poolAllocationStackSampleRate),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
       defaultRoot_{std::make_shared<MemoryPoolImpl>(
           this,
@@ -51,11 +68,19 @@ MemoryManager::MemoryManager(const Options& options)
               .alignment = alignment_,
               .capacity = kMaxMemory,
               .trackUsage =
-                  FLAGS_velox_enable_memory_usage_track_in_default_memory_pool})},
+                  FLAGS_velox_enable_memory_usage_track_in_default_memory_pool,
+              .trackAllocations = trackPoolAllocations_,
+              .allocationStackSampleRate = poolAllocationStackSampleRate_})},
       deprecatedDefaultLeafPool_(
           defaultRoot_->addLeafChild(kDefaultLeafName.str())) {
   VELOX_CHECK_NOT_NULL(allocator_);
   VELOX_USER_CHECK_GE(memoryQuota_, 0);
+  if (arbitrator_ != nullptr) {
+    VELOX_USER_CHECK_EQ(
+        options.arbitratorConfig->capacity,
+        memoryQuota_,
+        "Memory arbitrator capacity must be the same as memory manager's");
+  }
   MemoryAllocator::alignmentCheck(0, alignment_);
 }
 
@@ -101,6 +126,13 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
   options.capacity = maxBytes;
   options.trackUsage = trackUsage;
   options.reclaimer = std::move(reclaimer);
+  options.trackAllocations = trackPoolAllocations_;
+  options.allocationStackSampleRate = poolAllocationStackSampleRate_;
+  const bool arbitrated = arbitrator_ != nullptr && trackUsage;
+  if (arbitrated) {
+    options.maxCapacity = maxBytes;
+    options.capacity = arbitrator_->reserveMemory(maxBytes);
+  }
   auto pool = std::make_shared<MemoryPoolImpl>(
       this,
       poolName,
@@ -108,6 +140,14 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
       nullptr,
       poolDestructionCb_,
       options);
+  if (arbitrated) {
+    // NOTE: the root memory usage tracker is owned by 'pool'.
+    pool->getMemoryUsageTracker()->setGrowCallback(
+        [this, pool = pool.get()](
+            int64_t size, MemoryUsageTracker& /*unused*/) {
+          return growPool(pool, size);
+        });
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   pools_.push_back(pool.get());
   return pool;
@@ -127,6 +167,9 @@ std::shared_ptr<MemoryPool> MemoryManager::addLeafPool(
 
 void MemoryManager::dropPool(MemoryPool* pool) {
   VELOX_CHECK_NOT_NULL(pool);
+  if (arbitrator_ != nullptr && pool->getMemoryUsageTracker() != nullptr) {
+    arbitrator_->releaseMemory(pool);
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   auto it = pools_.begin();
   while (it != pools_.end()) {
@@ -139,6 +182,54 @@ void MemoryManager::dropPool(MemoryPool* pool) {
   VELOX_UNREACHABLE("Memory pool is not found");
 }
 
+bool MemoryManager::growPool(MemoryPool* pool, uint64_t incrementBytes) {
+  VELOX_CHECK_NOT_NULL(arbitrator_);
+  // NOTE: the memory usage tracker's grow callback must not throw.
+  try {
+    auto* requestor = reservingMemoryPool();
+    if (requestor != nullptr) {
+      requestor->enterArbitration();
+    }
+    SCOPE_EXIT {
+      if (requestor != nullptr) {
+        requestor->leaveArbitration();
+      }
+    };
+    const auto candidates = getAlivePools();
+    std::vector<MemoryPool*> candidatePools;
+    candidatePools.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+      candidatePools.push_back(candidate.get());
+    }
+    // Only grows by the part of the reservation increment which is not covered
+    // by the pool's free capacity.
+    const uint64_t targetBytes =
+        incrementBytes - std::min(incrementBytes, pool->freeBytes());
+    if (targetBytes == 0) {
+      return true;
+    }
+    return arbitrator_->growMemory(pool, candidatePools, targetBytes);
+  } catch (const std::exception& e) {
+    VELOX_MEM_LOG(ERROR) << "Failed to grow " << pool->name() << " capacity by "
+                         << succinctBytes(incrementBytes) << ": " << e.what();
+    return false;
+  }
+}
+
+std::vector<std::shared_ptr<MemoryPool>> MemoryManager::getAlivePools() const {
+  std::vector<std::shared_ptr<MemoryPool>> alivePools;
+  folly::SharedMutex::ReadHolder guard{mutex_};
+  alivePools.reserve(pools_.size());
+  for (auto* pool : pools_) {
+    // NOTE: a pool under destruction can't be upgraded and is skipped.
+    auto alivePool = pool->weak_from_this().lock();
+    if (alivePool != nullptr) {
+      alivePools.push_back(std::move(alivePool));
+    }
+  }
+  return alivePools;
+}
+
 MemoryPool& MemoryManager::deprecatedLeafPool() {
   return *deprecatedDefaultLeafPool_;
 }
@@ -184,6 +275,9 @@ std::string MemoryManager::toString() const {
   for (const auto* pool : pools_) {
     out << "\t" << pool->name() << "\n";
   }
+  if (arbitrator_ != nullptr) {
+    out << arbitrator_->toString() << "\n";
+  }
   out << "]";
   return out.str();
 }
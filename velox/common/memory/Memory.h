@@ -21,6 +21,7 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <fmt/format.h>
@@ -78,8 +79,23 @@ class IMemoryManager {
     /// have been fixed.
     bool checkUsageLeak{FLAGS_velox_memory_leak_check_enabled};
 
+    /// If true, the memory pools record their live allocations so that their
+    /// usage snapshots report the largest allocations of each leaf pool. See
+    /// MemoryPool::Options::trackAllocations.
+    bool trackPoolAllocations{false};
+
+    /// If not zero and 'trackPoolAllocations' is true, captures the stack trace
+    /// of one in every 'poolAllocationStackSampleRate' recorded allocations of
+    /// each leaf pool.
+    int32_t poolAllocationStackSampleRate{0};
+
     /// Specifies the backing memory allocator.
     MemoryAllocator* allocator{MemoryAllocator::getInstance()};
+
+    /// Specifies the memory arbitrator to share 'capacity' among the root
+    /// memory pools. If not set, each root memory pool has the fixed capacity
+    /// it is created with.
+    std::optional<MemoryArbitrator::Config> arbitratorConfig;
   };
 
   virtual ~IMemoryManager() = default;
@@ -95,7 +111,10 @@ class IMemoryManager {
   /// Creates a root memory pool with specified 'name' and 'maxBytes'. If 'name'
   /// is missing, the memory manager generates a default name internally to
   /// ensure uniqueness. If 'trackUsage' is true, then set the memory usage
-  /// tracker in the created root memory pool.
+  /// tracker in the created root memory pool. If the memory manager has a
+  /// memory arbitrator and 'trackUsage' is true, then the root memory pool
+  /// starts with the capacity reserved by the arbitrator and grows up to
+  /// 'maxBytes' through memory arbitration.
   virtual std::shared_ptr<MemoryPool> addRootPool(
       const std::string& name = "",
       int64_t maxBytes = kMaxMemory,
@@ -200,6 +219,11 @@ class MemoryManager final : public IMemoryManager {
 
   MemoryAllocator& getAllocator();
 
+  /// Returns the memory arbitrator if set, otherwise null.
+  MemoryArbitrator* arbitrator() const {
+    return arbitrator_.get();
+  }
+
   /// Returns the memory manger's internal default root memory pool for testing
   /// purpose.
   MemoryPool& testingDefaultRoot() const {
@@ -209,10 +233,24 @@ class MemoryManager final : public IMemoryManager {
  private:
   void dropPool(MemoryPool* pool);
 
+  // Invoked by the memory usage tracker of root memory 'pool' to grow its
+  // capacity by 'incrementBytes' through memory arbitration. The other alive
+  // root memory pools take part in the arbitration as candidates.
+  bool growPool(MemoryPool* pool, uint64_t incrementBytes);
+
+  // Returns the alive root memory pools in 'pools_' by shared reference so
+  // that they can't be destroyed during memory arbitration.
+  std::vector<std::shared_ptr<MemoryPool>> getAlivePools() const;
+
   const std::shared_ptr<MemoryAllocator> allocator_;
   const int64_t memoryQuota_;
+  // The memory arbitrator which shares 'memoryQuota_' among the root memory
+  // pools in 'pools_'. Null if not configured.
+  const std::unique_ptr<MemoryArbitrator> arbitrator_;
   const uint16_t alignment_;
   const bool checkUsageLeak_;
+  const bool trackPoolAllocations_;
+  const int32_t poolAllocationStackSampleRate_;
   // The destruction callback set for the allocated  root memory pools which are
   // tracked by 'pools_'. It is invoked on the root pool destruction and removes
   // the pool from 'pools_'.
@@ -278,6 +278,19 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
 
   virtual MachinePageCount numMapped() const = 0;
 
+  /// Returns the bytes held by a cache built on this allocator, e.g.
+  /// AsyncDataCache. This memory is allocated outside of any memory pool and
+  /// can be freed on demand by shrinkCache().
+  virtual uint64_t cachedBytes() const {
+    return 0;
+  }
+
+  /// Frees up to 'bytes' of the memory counted in cachedBytes() and returns
+  /// the bytes actually freed.
+  virtual uint64_t shrinkCache(uint64_t /*bytes*/) {
+    return 0;
+  }
+
   virtual Stats stats() const {
     return Stats();
   }
@@ -16,7 +16,10 @@
 
 #include "velox/common/memory/MemoryArbitrator.h"
 
+#include <algorithm>
+
 #include "velox/common/memory/Memory.h"
+#include "velox/common/memory/SharedArbitrator.h"
 
 namespace facebook::velox::memory {
 std::string MemoryArbitrator::kindString(Kind kind) {
@@ -41,10 +44,10 @@ std::unique_ptr<MemoryArbitrator> MemoryArbitrator::create(
     const Config& config) {
   switch (config.kind) {
     case Kind::kFixed:
-      FOLLY_FALLTHROUGH;
-    case Kind::kShared:
       VELOX_UNSUPPORTED(
           "{} arbitrator type not supported yet", kindString(config.kind));
+    case Kind::kShared:
+      return std::make_unique<SharedArbitrator>(config);
     default:
       VELOX_UNREACHABLE(kindString(config.kind));
   }
@@ -85,32 +88,53 @@ uint64_t MemoryReclaimer::reclaim(MemoryPool* pool, uint64_t targetBytes) {
   if (pool->kind() == MemoryPool::Kind::kLeaf) {
     return 0;
   }
-  // TODO: add to sort the child memory pools based on the reclaimable bytes
-  // before memory reclamation.
+  // Reclaims from the child memory pools with the most reclaimable memory
+  // first. The children are collected under the read lock and held by shared
+  // reference so that they can be reclaimed without holding the lock.
+  struct Candidate {
+    std::shared_ptr<MemoryPool> pool;
+    uint64_t reclaimableBytes;
+  };
+  std::vector<Candidate> candidates;
+  pool->visitChildren([&](MemoryPool* child) {
+    auto candidate = child->weak_from_this().lock();
+    if (candidate != nullptr) {
+      const auto reclaimableBytes = candidate->reclaimableBytes();
+      candidates.push_back({std::move(candidate), reclaimableBytes});
+    }
+    return true;
+  });
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.reclaimableBytes > rhs.reclaimableBytes;
+      });
+
   uint64_t reclaimedBytes{0};
-  pool->visitChildren([&](MemoryPool* pool) {
-    const auto bytes = pool->reclaim(targetBytes);
+  for (const auto& candidate : candidates) {
+    const auto bytes = candidate.pool->reclaim(targetBytes);
     reclaimedBytes += bytes;
     if (targetBytes != 0) {
       if (bytes >= targetBytes) {
-        return false;
+        break;
       }
       targetBytes -= bytes;
     }
-    return true;
-  });
+  }
   return reclaimedBytes;
 }
 
 std::string MemoryArbitrator::Stats::toString() const {
   return fmt::format(
-      "STATS[numRequests {} numFailures {} numQueuedRequests {} queueTime {} arbitrationTime {} shrunkMemory {} reclaimedMemory {}]",
+      "STATS[numRequests {} numFailures {} numQueuedRequests {} queueTime {} arbitrationTime {} shrunkMemory {} reclaimedMemory {} shrunkCache {}]",
       numRequests,
       numFailures,
       numQueuedRequests,
       succinctMicros(queueTimeUs),
       succinctMicros(arbitrationTimeUs),
       succinctBytes(numShrunkBytes),
-      succinctBytes(numReclaimedBytes));
+      succinctBytes(numReclaimedBytes),
+      succinctBytes(numCacheShrunkBytes));
 }
 } // namespace facebook::velox::memory
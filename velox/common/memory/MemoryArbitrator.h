@@ -23,6 +23,7 @@
 
 namespace facebook::velox::memory {
 
+class MemoryAllocator;
 class MemoryPool;
 
 /// The memory arbitrator interface. There is one memory arbitrator object per
@@ -67,6 +68,20 @@ class MemoryArbitrator {
     /// NOTE: this should be same capacity as we set in the associated memory
     /// manager.
     int64_t capacity;
+    /// The initial memory capacity to reserve for a newly created query memory
+    /// pool. The memory pool grows its capacity through memory arbitration
+    /// on demand after that.
+    uint64_t initMemoryPoolCapacity{256 << 20};
+    /// The minimum memory capacity to grow a query memory pool by in one
+    /// memory arbitration. This avoids arbitrating for every small memory
+    /// reservation of a growing query.
+    uint64_t minMemoryPoolCapacityTransferSize{32 << 20};
+    /// The memory allocator backing the query memory pools. If this holds a
+    /// cache, e.g. AsyncDataCache, the cached memory occupies the capacity
+    /// that is not assigned to any query memory pool and the arbitrator evicts
+    /// from the cache to back the capacity it grants. If not set, the memory
+    /// manager sets this to its allocator.
+    MemoryAllocator* allocator{nullptr};
   };
   static std::unique_ptr<MemoryArbitrator> create(const Config& config);
 
@@ -129,6 +144,8 @@ class MemoryArbitrator {
     uint64_t numShrunkBytes{0};
     /// The amount of memory bytes freed by memory reclamation.
     uint64_t numReclaimedBytes{0};
+    /// The amount of cache memory evicted to back granted capacity.
+    uint64_t numCacheShrunkBytes{0};
 
     /// Returns the debug string of this stats.
     std::string toString() const;
@@ -140,10 +157,18 @@ class MemoryArbitrator {
 
  protected:
   explicit MemoryArbitrator(const Config& config)
-      : kind_(config.kind), capacity_(config.capacity) {}
+      : kind_(config.kind),
+        capacity_(config.capacity),
+        initMemoryPoolCapacity_(config.initMemoryPoolCapacity),
+        minMemoryPoolCapacityTransferSize_(
+            config.minMemoryPoolCapacityTransferSize),
+        allocator_(config.allocator) {}
 
   const Kind kind_;
   const uint64_t capacity_;
+  const uint64_t initMemoryPoolCapacity_;
+  const uint64_t minMemoryPoolCapacityTransferSize_;
+  MemoryAllocator* const allocator_;
 
   Stats stats_;
 };
@@ -16,7 +16,14 @@
 
 #include "velox/common/memory/MemoryPool.h"
 
+#include <algorithm>
+
+#include <folly/ScopeGuard.h>
+#include <folly/json.h>
+
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
@@ -30,6 +37,10 @@ namespace {
       "Exceeded memory manager cap of {} MB",                       \
       (cap) / 1024 / 1024);
 
+// The leaf memory pool with a memory reclaimer whose memory reservation is
+// running on this thread.
+thread_local MemoryPool* reservingPool{nullptr};
+
 std::shared_ptr<MemoryUsageTracker> createMemoryUsageTracker(
     MemoryPool* parent,
     MemoryPool::Kind kind,
@@ -56,10 +67,14 @@ MemoryPool::MemoryPool(
     : name_(name),
       kind_(kind),
       alignment_{options.alignment},
+      maxCapacity_{options.maxCapacity},
       parent_(std::move(parent)),
       reclaimer_(options.reclaimer),
-      checkUsageLeak_(options.checkUsageLeak) {
+      checkUsageLeak_(options.checkUsageLeak),
+      trackAllocations_(options.trackAllocations),
+      allocationStackSampleRate_(options.allocationStackSampleRate) {
   MemoryAllocator::alignmentCheck(0, alignment_);
+  VELOX_CHECK_GE(allocationStackSampleRate_, 0);
   VELOX_CHECK(parent_ != nullptr || kind_ == Kind::kAggregate);
 }
 
@@ -97,6 +112,70 @@ MemoryPool* MemoryPool::parent() const {
   return parent_.get();
 }
 
+MemoryPoolSnapshot MemoryPool::usageSnapshot(int32_t maxAllocations) const {
+  MemoryPoolSnapshot snapshot;
+  snapshot.name = name_;
+  snapshot.kind = kind_;
+  const auto& tracker = getMemoryUsageTracker();
+  if (tracker != nullptr) {
+    snapshot.currentBytes = tracker->currentBytes();
+    snapshot.peakBytes = tracker->peakBytes();
+    snapshot.numAllocs = tracker->numAllocs();
+  } else {
+    snapshot.currentBytes = getCurrentBytes();
+    snapshot.peakBytes = getMaxBytes();
+  }
+  for (const auto& record : largestAllocations(maxAllocations)) {
+    snapshot.largestAllocations.push_back(
+        {record.bytes,
+         record.stackTrace != nullptr ? record.stackTrace->toString() : ""});
+  }
+  visitChildren([&](MemoryPool* child) {
+    snapshot.children.push_back(child->usageSnapshot(maxAllocations));
+    return true;
+  });
+  std::sort(
+      snapshot.children.begin(),
+      snapshot.children.end(),
+      [](const MemoryPoolSnapshot& lhs, const MemoryPoolSnapshot& rhs) {
+        return lhs.currentBytes > rhs.currentBytes;
+      });
+  return snapshot;
+}
+
+folly::dynamic MemoryPoolSnapshot::toJson() const {
+  folly::dynamic obj = folly::dynamic::object;
+  obj["name"] = name;
+  obj["kind"] = MemoryPool::kindString(kind);
+  obj["currentBytes"] = currentBytes;
+  obj["peakBytes"] = peakBytes;
+  obj["numAllocs"] = numAllocs;
+  if (!largestAllocations.empty()) {
+    folly::dynamic allocations = folly::dynamic::array;
+    for (const auto& allocation : largestAllocations) {
+      folly::dynamic entry = folly::dynamic::object;
+      entry["bytes"] = allocation.bytes;
+      if (!allocation.stackTrace.empty()) {
+        entry["stackTrace"] = allocation.stackTrace;
+      }
+      allocations.push_back(std::move(entry));
+    }
+    obj["largestAllocations"] = std::move(allocations);
+  }
+  if (!children.empty()) {
+    folly::dynamic childrenObj = folly::dynamic::array;
+    for (const auto& child : children) {
+      childrenObj.push_back(child.toJson());
+    }
+    obj["children"] = std::move(childrenObj);
+  }
+  return obj;
+}
+
+std::string MemoryPoolSnapshot::toString() const {
+  return folly::toPrettyJson(toJson());
+}
+
 uint64_t MemoryPool::getChildCount() const {
   folly::SharedMutex::ReadHolder guard{childrenMutex_};
   return children_.size();
@@ -273,9 +352,11 @@ void* MemoryPoolImpl::allocate(int64_t size) {
   void* buffer = allocator_->allocateBytes(alignedSize, alignment_);
   if (FOLLY_UNLIKELY(buffer == nullptr)) {
     release(alignedSize);
+    REPORT_ADD_STAT_VALUE(kCounterMemoryAllocationFailures);
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} bytes from {}", __FUNCTION__, size, toString()));
   }
+  recordAllocation(buffer, alignedSize);
   return buffer;
 }
 
@@ -287,6 +368,7 @@ void* MemoryPoolImpl::allocateZeroFilled(int64_t numEntries, int64_t sizeEach) {
   void* buffer = allocator_->allocateZeroFilled(alignedSize);
   if (FOLLY_UNLIKELY(buffer == nullptr)) {
     release(alignedSize);
+    REPORT_ADD_STAT_VALUE(kCounterMemoryAllocationFailures);
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} entries and {} bytes each from {}",
         __FUNCTION__,
@@ -294,6 +376,7 @@ void* MemoryPoolImpl::allocateZeroFilled(int64_t numEntries, int64_t sizeEach) {
         sizeEach,
         toString()));
   }
+  recordAllocation(buffer, alignedSize);
   return buffer;
 }
 
@@ -310,6 +393,7 @@ void* MemoryPoolImpl::reallocate(
   if (FOLLY_UNLIKELY(newP == nullptr)) {
     free(p, alignedSize);
     release(alignedNewSize);
+    REPORT_ADD_STAT_VALUE(kCounterMemoryAllocationFailures);
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} new bytes and {} old bytes from {}",
         __FUNCTION__,
@@ -318,6 +402,7 @@ void* MemoryPoolImpl::reallocate(
         toString()));
   }
   VELOX_CHECK_NOT_NULL(newP);
+  recordAllocation(newP, alignedNewSize);
   if (p == nullptr) {
     return newP;
   }
@@ -330,6 +415,7 @@ void MemoryPoolImpl::free(void* p, int64_t size) {
   checkMemoryAllocation();
 
   const auto alignedSize = sizeAlign(size);
+  recordFree(p);
   allocator_->freeBytes(p, alignedSize);
   release(alignedSize);
 }
@@ -341,6 +427,9 @@ void MemoryPoolImpl::allocateNonContiguous(
   checkMemoryAllocation();
   VELOX_CHECK_GT(numPages, 0);
 
+  if (!out.empty()) {
+    recordFree(out.runAt(0).data());
+  }
   if (!allocator_->allocateNonContiguous(
           numPages,
           out,
@@ -353,17 +442,22 @@ void MemoryPoolImpl::allocateNonContiguous(
           },
           minSizeClass)) {
     VELOX_CHECK(out.empty());
+    REPORT_ADD_STAT_VALUE(kCounterMemoryAllocationFailures);
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} pages from {}", __FUNCTION__, numPages, toString()));
   }
   VELOX_CHECK(!out.empty());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
+  recordAllocation(out.runAt(0).data(), out.byteSize());
 }
 
 void MemoryPoolImpl::freeNonContiguous(Allocation& allocation) {
   checkMemoryAllocation();
 
+  if (!allocation.empty()) {
+    recordFree(allocation.runAt(0).data());
+  }
   const int64_t freedBytes = allocator_->freeNonContiguous(allocation);
   VELOX_CHECK(allocation.empty());
   release(freedBytes);
@@ -383,6 +477,9 @@ void MemoryPoolImpl::allocateContiguous(
   checkMemoryAllocation();
   VELOX_CHECK_GT(numPages, 0);
 
+  if (!out.empty()) {
+    recordFree(out.data());
+  }
   if (!allocator_->allocateContiguous(
           numPages, nullptr, out, [this](int64_t allocBytes, bool preAlloc) {
             if (preAlloc) {
@@ -392,17 +489,22 @@ void MemoryPoolImpl::allocateContiguous(
             }
           })) {
     VELOX_CHECK(out.empty());
+    REPORT_ADD_STAT_VALUE(kCounterMemoryAllocationFailures);
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} pages from {}", __FUNCTION__, numPages, toString()));
   }
   VELOX_CHECK(!out.empty());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
+  recordAllocation(out.data(), out.size());
 }
 
 void MemoryPoolImpl::freeContiguous(ContiguousAllocation& allocation) {
   checkMemoryAllocation();
 
+  if (!allocation.empty()) {
+    recordFree(allocation.data());
+  }
   const int64_t bytesToFree = allocation.size();
   allocator_->freeContiguous(allocation);
   VELOX_CHECK(allocation.empty());
@@ -417,6 +519,53 @@ int64_t MemoryPoolImpl::getMaxBytes() const {
   return std::max(getSubtreeMaxBytes(), localMemoryUsage_.getMaxBytes());
 }
 
+void MemoryPoolImpl::recordAllocation(const void* address, uint64_t bytes) {
+  if (FOLLY_LIKELY(!trackAllocations_)) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(allocationsMutex_);
+  AllocationRecord record{bytes, nullptr};
+  if (allocationStackSampleRate_ != 0 &&
+      numRecordedAllocations_ % allocationStackSampleRate_ == 0) {
+    record.stackTrace = std::make_shared<process::StackTrace>();
+  }
+  ++numRecordedAllocations_;
+  allocations_[reinterpret_cast<uint64_t>(address)] = std::move(record);
+}
+
+void MemoryPoolImpl::recordFree(const void* address) {
+  if (FOLLY_LIKELY(!trackAllocations_)) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(allocationsMutex_);
+  allocations_.erase(reinterpret_cast<uint64_t>(address));
+}
+
+std::vector<MemoryPool::AllocationRecord> MemoryPoolImpl::largestAllocations(
+    int32_t maxAllocations) const {
+  std::vector<AllocationRecord> records;
+  if (!trackAllocations_ || maxAllocations <= 0) {
+    return records;
+  }
+  {
+    std::lock_guard<std::mutex> l(allocationsMutex_);
+    records.reserve(allocations_.size());
+    for (const auto& entry : allocations_) {
+      records.push_back(entry.second);
+    }
+  }
+  const auto numRecords = std::min<size_t>(maxAllocations, records.size());
+  std::partial_sort(
+      records.begin(),
+      records.begin() + numRecords,
+      records.end(),
+      [](const AllocationRecord& lhs, const AllocationRecord& rhs) {
+        return lhs.bytes > rhs.bytes;
+      });
+  records.resize(numRecords);
+  return records;
+}
+
 std::string MemoryPoolImpl::toString() const {
   return fmt::format(
       "Memory Pool[{} {} {}]",
@@ -458,7 +607,9 @@ std::shared_ptr<MemoryPool> MemoryPoolImpl::genChild(
       Options{
           .alignment = alignment_,
           .reclaimer = std::move(reclaimer),
-          .threadSafe = threadSafe});
+          .threadSafe = threadSafe,
+          .trackAllocations = trackAllocations_,
+          .allocationStackSampleRate = allocationStackSampleRate_});
 }
 
 const MemoryUsage& MemoryPoolImpl::getLocalMemoryUsage() const {
@@ -497,7 +648,16 @@ void MemoryPoolImpl::reserve(int64_t size) {
   checkMemoryAllocation();
 
   if (memoryUsageTracker_ != nullptr) {
-    memoryUsageTracker_->update(size);
+    if (reclaimer_ == nullptr) {
+      memoryUsageTracker_->update(size);
+    } else {
+      auto* const prevPool = reservingPool;
+      reservingPool = this;
+      SCOPE_EXIT {
+        reservingPool = prevPool;
+      };
+      memoryUsageTracker_->update(size);
+    }
   }
   localMemoryUsage_.incrementCurrentBytes(size);
 
@@ -521,4 +681,40 @@ void MemoryPoolImpl::release(int64_t size) {
     memoryUsageTracker_->update(-size);
   }
 }
+
+int64_t MemoryPoolImpl::capacity() const {
+  if (memoryUsageTracker_ == nullptr) {
+    return kMaxMemory;
+  }
+  return memoryUsageTracker_->maxMemory();
+}
+
+uint64_t MemoryPoolImpl::freeBytes() const {
+  if (memoryUsageTracker_ == nullptr) {
+    return 0;
+  }
+  VELOX_CHECK_NULL(parent_, "Only root memory pool has free capacity");
+  return memoryUsageTracker_->unreservedBytes();
+}
+
+uint64_t MemoryPoolImpl::shrink(uint64_t targetBytes) {
+  if (memoryUsageTracker_ == nullptr) {
+    return 0;
+  }
+  VELOX_CHECK_NULL(parent_, "Only root memory pool allows to shrink capacity");
+  return memoryUsageTracker_->shrinkMaxMemory(targetBytes);
+}
+
+uint64_t MemoryPoolImpl::grow(uint64_t bytes) {
+  VELOX_CHECK_NOT_NULL(
+      memoryUsageTracker_,
+      "Memory pool {} without memory usage tracking can't grow capacity",
+      name_);
+  VELOX_CHECK_NULL(parent_, "Only root memory pool allows to grow capacity");
+  return memoryUsageTracker_->growMaxMemory(bytes);
+}
+
+MemoryPool* reservingMemoryPool() {
+  return reservingPool;
+}
 } // namespace facebook::velox::memory
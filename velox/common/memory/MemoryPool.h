@@ -21,10 +21,13 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include <fmt/format.h>
 #include <folly/Synchronized.h>
+#include <folly/dynamic.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -34,12 +37,14 @@
 #include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/common/memory/MemoryUsage.h"
 #include "velox/common/memory/MemoryUsageTracker.h"
+#include "velox/common/process/StackTrace.h"
 
 DECLARE_bool(velox_memory_leak_check_enabled);
 
 namespace facebook::velox::memory {
 
 class MemoryManager;
+struct MemoryPoolSnapshot;
 
 /// This class provides the memory allocation interfaces for a query execution.
 /// Each query execution entity creates a dedicated memory pool object. The
@@ -108,6 +113,9 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     uint16_t alignment{MemoryAllocator::kMaxAlignment};
     /// Specifies the memory capacity of this memory pool.
     int64_t capacity{kMaxMemory};
+    /// Specifies the max memory capacity that the memory arbitration can grow
+    /// this memory pool to. This only applies to a root memory pool.
+    int64_t maxCapacity{kMaxMemory};
     /// Used by memory arbitration to reclaim memory from the associated query
     /// object if not null. For example, a memory pool can reclaim the used
     /// memory from a spillable operator through disk spilling. If null, we
@@ -130,6 +138,14 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     /// TODO: deprecate this flag after all the existing memory leak use cases
     /// have been fixed.
     bool checkUsageLeak{FLAGS_velox_memory_leak_check_enabled};
+    /// If true, a leaf memory pool records its live allocations so that its
+    /// usage snapshot reports its largest allocations. This is inherited by
+    /// the child pools.
+    bool trackAllocations{false};
+    /// If not zero and 'trackAllocations' is true, captures the stack trace of
+    /// one in every 'allocationStackSampleRate' recorded allocations. This is
+    /// inherited by the child pools.
+    int32_t allocationStackSampleRate{0};
   };
 
   /// Constructs a named memory pool with specified 'name', 'parent' and 'kind'.
@@ -277,6 +293,15 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
 
   /// Memory arbitration related interfaces.
 
+  /// Returns the memory capacity of the root memory pool of this memory pool.
+  virtual int64_t capacity() const = 0;
+
+  /// Returns the max memory capacity that the memory arbitration can grow this
+  /// root memory pool to.
+  int64_t maxCapacity() const {
+    return maxCapacity_;
+  }
+
   /// Returns the free memory capacity in bytes that haven't been reserved for
   /// use, and can be freed by reducing this memory pool's capacity without
   /// actually freeing the used memory.
@@ -324,7 +349,27 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
 
   virtual std::string toString() const = 0;
 
+  /// Returns a snapshot of the memory usage of the memory pool subtree rooted
+  /// at this, with up to 'maxAllocations' largest allocations of each leaf
+  /// pool that tracks its allocations.
+  MemoryPoolSnapshot usageSnapshot(int32_t maxAllocations = 10) const;
+
  protected:
+  /// A live allocation recorded by a leaf memory pool which tracks its
+  /// allocations.
+  struct AllocationRecord {
+    uint64_t bytes;
+    /// Set if the allocation is sampled for stack trace.
+    std::shared_ptr<process::StackTrace> stackTrace;
+  };
+
+  /// Returns up to 'maxAllocations' largest live allocations, largest first.
+  /// This is empty if this memory pool doesn't track its allocations.
+  virtual std::vector<AllocationRecord> largestAllocations(
+      int32_t /*maxAllocations*/) const {
+    return {};
+  }
+
   /// Invoked by addChild() to create a child memory pool object. 'parent' is
   /// a shared pointer created from this.
   virtual std::shared_ptr<MemoryPool> genChild(
@@ -357,9 +402,12 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   const std::string name_;
   const Kind kind_;
   const uint16_t alignment_;
+  const int64_t maxCapacity_;
   const std::shared_ptr<MemoryPool> parent_;
   const std::shared_ptr<MemoryReclaimer> reclaimer_;
   const bool checkUsageLeak_;
+  const bool trackAllocations_;
+  const int32_t allocationStackSampleRate_;
 
   /// Protects 'children_'.
   mutable folly::SharedMutex childrenMutex_;
@@ -371,6 +419,43 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
 
 std::ostream& operator<<(std::ostream& out, MemoryPool::Kind kind);
 
+/// A point in time snapshot of the memory usage of a memory pool and its
+/// subtree, taken by MemoryPool::usageSnapshot(). This is used to find out
+/// which query, task, plan node or operator holds the memory.
+struct MemoryPoolSnapshot {
+  /// A live allocation of a leaf memory pool.
+  struct Allocation {
+    uint64_t bytes;
+    /// The symbolized stack trace if the allocation is sampled, otherwise
+    /// empty.
+    std::string stackTrace;
+  };
+
+  std::string name;
+  MemoryPool::Kind kind;
+  int64_t currentBytes{0};
+  int64_t peakBytes{0};
+  /// The number of allocations made from a leaf pool. This is 0 for an
+  /// aggregate pool or if the memory pool doesn't track its memory usage.
+  int64_t numAllocs{0};
+  /// The largest live allocations, largest first.
+  std::vector<Allocation> largestAllocations;
+  /// The snapshots of the child pools with the largest current usage first.
+  std::vector<MemoryPoolSnapshot> children;
+
+  folly::dynamic toJson() const;
+
+  /// Returns the snapshot as pretty printed JSON.
+  std::string toString() const;
+};
+
+/// Returns the leaf memory pool with a memory reclaimer whose memory
+/// reservation is running on the calling thread, or null if there is none. The
+/// memory manager puts this pool into memory arbitration while it grows the
+/// capacity of its root pool, so that the driver thread of the allocating
+/// operator does not block its task from being paused for memory reclamation.
+MemoryPool* reservingMemoryPool();
+
 class MemoryManager;
 
 /// The implementation of MemoryPool interface with a specified memory manager.
@@ -454,17 +539,15 @@ class MemoryPoolImpl : public MemoryPool {
 
   void release(int64_t size) override;
 
-  uint64_t freeBytes() const override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  int64_t capacity() const override;
 
-  uint64_t shrink(uint64_t targetBytes = 0) override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  /// NOTE: freeBytes(), shrink() and grow() are only supported on a root
+  /// memory pool with memory usage tracking.
+  uint64_t freeBytes() const override;
 
-  uint64_t grow(uint64_t bytes) override {
-    VELOX_NYI("{} unsupported", __FUNCTION__);
-  }
+  uint64_t shrink(uint64_t targetBytes = 0) override;
+
+  uint64_t grow(uint64_t bytes) override;
 
   std::string toString() const override;
 
@@ -472,6 +555,10 @@ class MemoryPoolImpl : public MemoryPool {
     return allocator_;
   }
 
+ protected:
+  std::vector<AllocationRecord> largestAllocations(
+      int32_t maxAllocations) const override;
+
  private:
   int64_t sizeAlign(int64_t size);
 
@@ -479,6 +566,13 @@ class MemoryPoolImpl : public MemoryPool {
       std::function<void(const MemoryUsage&)> visitor) const;
   void updateSubtreeMemoryUsage(std::function<void(MemoryUsage&)> visitor);
 
+  // Records the allocation of 'bytes' at 'address' if 'trackAllocations_' is
+  // set.
+  void recordAllocation(const void* address, uint64_t bytes);
+
+  // Removes the allocation at 'address' if 'trackAllocations_' is set.
+  void recordFree(const void* address);
+
   const std::shared_ptr<MemoryUsageTracker> memoryUsageTracker_;
   MemoryManager* const memoryManager_;
   MemoryAllocator* const allocator_;
@@ -488,6 +582,12 @@ class MemoryPoolImpl : public MemoryPool {
   MemoryUsage localMemoryUsage_;
   mutable folly::SharedMutex subtreeUsageMutex_;
   MemoryUsage subtreeMemoryUsage_;
+
+  // The live allocations keyed by address if 'trackAllocations_' is set.
+  mutable std::mutex allocationsMutex_;
+  std::unordered_map<uint64_t, AllocationRecord> allocations_;
+  // The number of allocations recorded in 'allocations_' so far.
+  uint64_t numRecordedAllocations_{0};
 };
 
 /// An Allocator backed by a memory pool for STL containers.
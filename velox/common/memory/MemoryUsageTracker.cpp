@@ -243,6 +243,35 @@ bool MemoryUsageTracker::maybeIncrementReservationLocked(uint64_t size) {
   return false;
 }
 
+int64_t MemoryUsageTracker::unreservedBytes() const {
+  VELOX_CHECK_NULL(parent_, "Only root tracker has unreserved memory");
+  std::lock_guard<std::mutex> l(mutex_);
+  return std::max<int64_t>(0, maxMemory_ - reservationBytes_);
+}
+
+int64_t MemoryUsageTracker::growMaxMemory(int64_t bytes) {
+  VELOX_CHECK_NULL(parent_, "Only root tracker allows to grow memory limit");
+  VELOX_CHECK_GE(bytes, 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  const int64_t maxMemory = maxMemory_;
+  VELOX_CHECK_LE(bytes, kMaxMemory - maxMemory);
+  maxMemory_ = maxMemory + bytes;
+  return maxMemory + bytes;
+}
+
+int64_t MemoryUsageTracker::shrinkMaxMemory(int64_t targetBytes) {
+  VELOX_CHECK_NULL(parent_, "Only root tracker allows to shrink memory limit");
+  VELOX_CHECK_GE(targetBytes, 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  const int64_t unreservedBytes =
+      std::max<int64_t>(0, maxMemory_ - reservationBytes_);
+  const int64_t shrunkBytes = targetBytes == 0
+      ? unreservedBytes
+      : std::min(targetBytes, unreservedBytes);
+  maxMemory_ -= shrunkBytes;
+  return shrunkBytes;
+}
+
 void MemoryUsageTracker::decrementReservation(uint64_t size) noexcept {
   VELOX_CHECK_GT(size, 0);
 
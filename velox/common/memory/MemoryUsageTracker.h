@@ -207,9 +207,24 @@ class MemoryUsageTracker
   }
 
   int64_t maxMemory() const {
-    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_;
+    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_.load();
   }
 
+  /// Returns the part of the memory limit of a root tracker that is not
+  /// covered by memory reservations. This can be given back to the memory
+  /// arbitrator without freeing any used memory.
+  int64_t unreservedBytes() const;
+
+  /// Raises the memory limit of a root tracker by 'bytes' and returns the new
+  /// limit. This is used by the memory arbitrator to grow the capacity of a
+  /// query memory pool.
+  int64_t growMaxMemory(int64_t bytes);
+
+  /// Lowers the memory limit of a root tracker by up to 'targetBytes' of its
+  /// unreserved memory, or by all of it if 'targetBytes' is zero. Returns the
+  /// number of bytes the limit has been lowered by.
+  int64_t shrinkMaxMemory(int64_t targetBytes = 0);
+
   /// Create a child memory usage tracker. 'leafTracker' indicates if the child
   /// is a leaf tracker for memory reservation use. If it is false, then the
   /// child is used for memory reservation aggregation and it is associated with
@@ -484,8 +499,9 @@ class MemoryUsageTracker
   // counters such as 'peakBytes_' and 'cumulativeBytes_'.
   mutable std::mutex mutex_;
 
-  // The memory limit in bytes to enforce.
-  int64_t maxMemory_;
+  // The memory limit in bytes to enforce. It is only changed with 'mutex_'
+  // held but can be read without it.
+  std::atomic<int64_t> maxMemory_;
 
   int64_t peakBytes_{0};
   int64_t cumulativeBytes_{0};
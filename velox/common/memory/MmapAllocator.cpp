@@ -25,6 +25,8 @@ namespace facebook::velox::memory {
 MmapAllocator::MmapAllocator(const Options& options)
     : kind_(MemoryAllocator::Kind::kMmap),
       useMmapArena_(options.useMmapArena),
+      useHugePages_(options.useHugePages),
+      numNumaNodes_(options.numNumaNodes),
       maxMallocBytes_(options.maxMallocBytes),
       mallocReservedBytes_(
           maxMallocBytes_ == 0
@@ -32,7 +34,10 @@ MmapAllocator::MmapAllocator(const Options& options)
               : options.capacity * options.smallAllocationReservePct / 100),
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
-          64 * sizeClassSizes_.back())) {
+          64 * sizeClassSizes_.back())),
+      numContiguousPagesOnNode_(numNumaNodes_) {
+  VELOX_CHECK_GE(numNumaNodes_, 1);
+  VELOX_CHECK_LE(numNumaNodes_, 64);
   for (const auto& size : sizeClassSizes_) {
     sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
   }
@@ -41,8 +46,12 @@ MmapAllocator::MmapAllocator(const Options& options)
     const auto arenaSizeBytes = bits::roundUp(
         AllocationTraits::pageBytes(capacity_) / options.mmapArenaCapacityRatio,
         AllocationTraits::kPageSize);
-    managedArenas_ = std::make_unique<ManagedMmapArenas>(
-        std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes));
+    for (auto node = 0; node < numNumaNodes_; ++node) {
+      managedArenas_.push_back(std::make_unique<ManagedMmapArenas>(
+          std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes),
+          numNumaNodes_ > 1 ? node : MmapArena::kNoNumaNode,
+          useHugePages_));
+    }
   }
 }
 
@@ -237,15 +246,7 @@ bool MmapAllocator::allocateContiguousImpl(
   }
   const auto numLargeCollateralPages = allocation.numPages();
   if (numLargeCollateralPages > 0) {
-    if (useMmapArena_) {
-      std::lock_guard<std::mutex> l(arenaMutex_);
-      managedArenas_->free(allocation.data(), allocation.size());
-    } else {
-      if (::munmap(allocation.data(), allocation.size()) < 0) {
-        VELOX_MEM_LOG(ERROR) << "munmap got " << folly::errnoStr(errno)
-                             << " for " << allocation.toString();
-      }
-    }
+    unmapContiguous(allocation);
     allocation.clear();
   }
 
@@ -320,23 +321,32 @@ bool MmapAllocator::allocateContiguousImpl(
   }
 
   void* data;
+  const auto numaNode = numaNodeForAllocation();
+  const auto numBytes = AllocationTraits::pageBytes(numPages);
   if (testingHasInjectedFailure(InjectedFailure::kMmap)) {
     data = nullptr;
   } else {
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
-      data = managedArenas_->allocate(AllocationTraits::pageBytes(numPages));
+      data = managedArenas_[numaNode]->allocate(numBytes);
     } else {
       data = ::mmap(
           nullptr,
-          AllocationTraits::pageBytes(numPages),
+          numBytes,
           PROT_READ | PROT_WRITE,
           MAP_PRIVATE | MAP_ANONYMOUS,
           -1,
           0);
+      if (data == MAP_FAILED) {
+        data = nullptr;
+      } else if (
+          numNumaNodes_ > 1 && !bindToNumaNode(data, numBytes, numaNode)) {
+        VELOX_MEM_LOG_EVERY_MS(WARNING, 1000)
+            << "mbind to NUMA node " << numaNode << " failed with "
+            << folly::errnoStr(errno);
+      }
     }
   }
-  // TODO: add handling of MAP_FAILED.
   if (data == nullptr) {
     VELOX_MEM_LOG(ERROR) << "Mmap failed with " << numPages
                          << " pages, use MmapArena "
@@ -346,23 +356,42 @@ bool MmapAllocator::allocateContiguousImpl(
     rollbackAllocation(numToMap);
     return false;
   }
-  allocation.set(data, AllocationTraits::pageBytes(numPages));
+  // The arenas are advised for huge pages as a whole when created.
+  if (useHugePages_ && numBytes >= kHugePageSize &&
+      (useMmapArena_ || adviseHugePages(data, numBytes))) {
+    numHugePageAdvisedPages_ += numPages;
+  }
+  numContiguousPagesOnNode_[numaNode] += numPages;
+  allocation.set(data, numBytes);
   return true;
 }
 
-void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
-  if (allocation.empty()) {
-    return;
+ManagedMmapArenas& MmapAllocator::arenasOf(const void* address) {
+  for (auto& arenas : managedArenas_) {
+    if (arenas->contains(address)) {
+      return *arenas;
+    }
   }
+  VELOX_FAIL("Address {} is not in any MmapArena", address);
+}
+
+void MmapAllocator::unmapContiguous(const ContiguousAllocation& allocation) {
   if (useMmapArena_) {
     std::lock_guard<std::mutex> l(arenaMutex_);
-    managedArenas_->free(allocation.data(), allocation.size());
+    arenasOf(allocation.data()).free(allocation.data(), allocation.size());
   } else {
     if (::munmap(allocation.data(), allocation.size()) < 0) {
       VELOX_MEM_LOG(ERROR) << "munmap returned " << folly::errnoStr(errno)
                            << " for " << allocation.toString();
     }
   }
+}
+
+void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
+  if (allocation.empty()) {
+    return;
+  }
+  unmapContiguous(allocation);
   numMapped_ -= allocation.numPages();
   numExternalMapped_ -= allocation.numPages();
   numAllocated_ -= allocation.numPages();
@@ -899,7 +928,12 @@ std::string MmapAllocator::toString() const {
   for (auto& sizeClass : sizeClasses_) {
     out << sizeClass->toString() << std::endl;
   }
-  out << "]" << std::endl;
+  out << "huge page advised " << numHugePageAdvisedPages_
+      << " contiguous pages by NUMA node";
+  for (const auto& numPages : numContiguousPagesOnNode_) {
+    out << " " << numPages;
+  }
+  out << std::endl << "]" << std::endl;
   return out.str();
 }
 
@@ -61,6 +61,17 @@ class MmapAllocator : public MemoryAllocator {
     /// capacity to single MmapArena capacity ratio.
     int32_t mmapArenaCapacityRatio = 10;
 
+    /// If set true, contiguous allocations of at least kHugePageSize, e.g. hash
+    /// tables, are advised to be backed by transparent huge pages. This cuts
+    /// the TLB misses of random accesses to them.
+    bool useHugePages = false;
+
+    /// Number of NUMA nodes of the machine. If more than 1, contiguous
+    /// allocations are preferably placed on the NUMA node of the CPU of the
+    /// allocating thread, with one set of ManagedMmapArenas per node if
+    /// 'useMmapArena' is set.
+    int32_t numNumaNodes = 1;
+
     /// If not zero, reserve 'smallAllocationReservePct'% of space from
     /// 'capacity' for ad hoc small allocations. And those allocations are
     /// delegated to std::malloc.
@@ -77,6 +88,10 @@ class MmapAllocator : public MemoryAllocator {
     int32_t maxMallocBytes = 3072;
   };
 
+  /// The size of a transparent huge page on x86_64 and of the smallest one on
+  /// aarch64.
+  static constexpr uint64_t kHugePageSize = 2 << 20;
+
   explicit MmapAllocator(const Options& options);
 
   ~MmapAllocator();
@@ -165,6 +180,20 @@ class MmapAllocator : public MemoryAllocator {
     return numMallocBytes_;
   }
 
+  /// Returns the cumulative number of pages of contiguous allocations placed
+  /// on NUMA node 'node'. Without NUMA aware placement, all are counted on
+  /// node 0.
+  uint64_t numContiguousPagesOnNode(int32_t node) const {
+    VELOX_CHECK_LT(node, numNumaNodes_);
+    return numContiguousPagesOnNode_[node];
+  }
+
+  /// Returns the cumulative number of pages of contiguous allocations advised
+  /// to be backed by transparent huge pages.
+  uint64_t numHugePageAdvisedPages() const {
+    return numHugePageAdvisedPages_;
+  }
+
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
@@ -359,6 +388,17 @@ class MmapAllocator : public MemoryAllocator {
 
   bool useMalloc(uint64_t bytes);
 
+  // Returns the NUMA node to place a new contiguous allocation on.
+  int32_t numaNodeForAllocation() const {
+    return numNumaNodes_ > 1 ? currentNumaNode() % numNumaNodes_ : 0;
+  }
+
+  // Returns the ManagedMmapArenas containing 'address'.
+  ManagedMmapArenas& arenasOf(const void* address);
+
+  // Unmaps or returns to its arena the memory of the contiguous 'allocation'.
+  void unmapContiguous(const ContiguousAllocation& allocation);
+
   const Kind kind_;
 
   // If set true, allocations larger than the largest size class size will be
@@ -366,6 +406,10 @@ class MmapAllocator : public MemoryAllocator {
   // issued for each such allocation.
   const bool useMmapArena_;
 
+  const bool useHugePages_;
+
+  const int32_t numNumaNodes_;
+
   // Serializes moving capacity between size classes
   std::mutex sizeClassBalanceMutex_;
 
@@ -402,11 +446,14 @@ class MmapAllocator : public MemoryAllocator {
   std::atomic<uint64_t> numAllocatedPages_ = 0;
   std::atomic<uint64_t> numAdvisedPages_ = 0;
   std::atomic<uint64_t> numMallocBytes_ = 0;
+  std::atomic<uint64_t> numHugePageAdvisedPages_ = 0;
+  std::vector<std::atomic<uint64_t>> numContiguousPagesOnNode_;
 
   // Allocations that are larger than largest size classes will be delegated to
-  // ManagedMmapArenas, to avoid calling mmap on every allocation.
+  // ManagedMmapArenas, to avoid calling mmap on every allocation. There is one
+  // ManagedMmapArenas per NUMA node, indexed by node.
   std::mutex arenaMutex_;
-  std::unique_ptr<ManagedMmapArenas> managedArenas_;
+  std::vector<std::unique_ptr<ManagedMmapArenas>> managedArenas_;
 
   Stats stats_;
 };
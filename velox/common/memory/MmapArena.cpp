@@ -17,15 +17,63 @@
 #include "velox/common/memory/MmapArena.h"
 
 #include <sys/mman.h>
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
+
+int32_t currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu;
+  unsigned node;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+bool adviseHugePages(void* address, uint64_t bytes) {
+#ifdef MADV_HUGEPAGE
+  return ::madvise(address, bytes, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+
+bool bindToNumaNode(void* address, uint64_t bytes, int32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  VELOX_CHECK_GE(node, 0);
+  VELOX_CHECK_LT(node, 64);
+  const uint64_t nodeMask = 1UL << node;
+  // The kernel reads one bit less than 'maxnode' bits of the mask.
+  return ::syscall(
+             SYS_mbind,
+             address,
+             bytes,
+             MPOL_PREFERRED,
+             &nodeMask,
+             sizeof(nodeMask) * 8 + 1,
+             0) == 0;
+#else
+  return false;
+#endif
+}
 uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(
+    size_t capacityBytes,
+    int32_t numaNode,
+    bool useHugePages)
+    : byteSize_(capacityBytes) {
   VELOX_CHECK_EQ(
       byteSize_ % kMinGrainSizeBytes,
       0,
@@ -45,6 +93,14 @@ MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
         folly::errnoStr(errno),
         capacityBytes);
   }
+  if (numaNode != kNoNumaNode && !bindToNumaNode(ptr, byteSize_, numaNode)) {
+    VELOX_MEM_LOG(WARNING) << "mbind to NUMA node " << numaNode
+                           << " failed with " << folly::errnoStr(errno);
+  }
+  if (useHugePages && !adviseHugePages(ptr, byteSize_)) {
+    VELOX_MEM_LOG(WARNING) << "madvise for huge pages failed with "
+                           << folly::errnoStr(errno);
+  }
   address_ = reinterpret_cast<uint8_t*>(ptr);
   addFreeBlock(reinterpret_cast<uint64_t>(address_), byteSize_);
   freeBytes_ = byteSize_;
@@ -267,9 +323,15 @@ bool MmapArena::checkConsistency() const {
   return numErrors == 0;
 }
 
-ManagedMmapArenas::ManagedMmapArenas(uint64_t singleArenaCapacity)
-    : singleArenaCapacity_(singleArenaCapacity) {
-  auto arena = std::make_shared<MmapArena>(singleArenaCapacity);
+ManagedMmapArenas::ManagedMmapArenas(
+    uint64_t singleArenaCapacity,
+    int32_t numaNode,
+    bool useHugePages)
+    : singleArenaCapacity_(singleArenaCapacity),
+      numaNode_(numaNode),
+      useHugePages_(useHugePages) {
+  auto arena = std::make_shared<MmapArena>(
+      singleArenaCapacity_, numaNode_, useHugePages_);
   arenas_.emplace(reinterpret_cast<uint64_t>(arena->address()), arena);
   currentArena_ = arena;
 }
@@ -283,7 +345,8 @@ void* FOLLY_NULLABLE ManagedMmapArenas::allocate(uint64_t bytes) {
   // If first allocation fails we create a new MmapArena for another attempt. If
   // it ever fails again then it means requested bytes is larger than a single
   // MmapArena's capacity. No further attempts will happen.
-  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_);
+  auto newArena = std::make_shared<MmapArena>(
+      singleArenaCapacity_, numaNode_, useHugePages_);
   arenas_.emplace(reinterpret_cast<uint64_t>(newArena->address()), newArena);
   currentArena_ = newArena;
   return currentArena_->allocate(bytes);
@@ -309,4 +372,13 @@ void ManagedMmapArenas::free(void* FOLLY_NONNULL address, uint64_t bytes) {
   }
 }
 
+bool ManagedMmapArenas::contains(const void* address) const {
+  auto iter = arenas_.upper_bound(reinterpret_cast<uint64_t>(address));
+  if (iter == arenas_.begin()) {
+    return false;
+  }
+  --iter;
+  return iter->second->contains(address);
+}
+
 } // namespace facebook::velox::memory
@@ -26,6 +26,19 @@
 
 namespace facebook::velox::memory {
 
+/// Returns the NUMA node of the CPU the calling thread runs on, or 0 if this
+/// is not known.
+int32_t currentNumaNode();
+
+/// Advises the kernel to back the 'bytes' bytes at 'address' with transparent
+/// huge pages. Returns false if the advice is not supported.
+bool adviseHugePages(void* FOLLY_NONNULL address, uint64_t bytes);
+
+/// Sets the preferred NUMA node of the not yet touched 'bytes' bytes at
+/// 'address' to 'node'. The kernel falls back to the other nodes if 'node' is
+/// out of memory. Returns false if the NUMA policy is not supported.
+bool bindToNumaNode(void* FOLLY_NONNULL address, uint64_t bytes, int32_t node);
+
 class MmapArena {
  public:
   /// Single MmapArena capacity is determined by mmap_arena_capacity_ratio ratio
@@ -36,7 +49,15 @@ class MmapArena {
   /// MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  MmapArena(size_t capacityBytes);
+  static constexpr int32_t kNoNumaNode = -1;
+
+  /// If 'numaNode' is not kNoNumaNode, the memory of 'this' is preferably
+  /// placed on that NUMA node. If 'useHugePages' is true, the memory is advised
+  /// to be backed by transparent huge pages.
+  MmapArena(
+      size_t capacityBytes,
+      int32_t numaNode = kNoNumaNode,
+      bool useHugePages = false);
   ~MmapArena();
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
@@ -49,6 +70,12 @@ class MmapArena {
     return byteSize_;
   }
 
+  /// True if 'address' is in the address range of 'this'.
+  bool contains(const void* FOLLY_NONNULL address) const {
+    const auto* ptr = reinterpret_cast<const uint8_t*>(address);
+    return ptr >= address_ && ptr < address_ + byteSize_;
+  }
+
   const std::map<uint64_t, uint64_t>& freeList() const {
     return freeList_;
   }
@@ -121,12 +148,24 @@ class MmapArena {
 /// fragmentation happens.
 class ManagedMmapArenas {
  public:
-  ManagedMmapArenas(uint64_t singleArenaCapacity);
+  /// 'numaNode' and 'useHugePages' are passed to the managed MmapArenas.
+  ManagedMmapArenas(
+      uint64_t singleArenaCapacity,
+      int32_t numaNode = MmapArena::kNoNumaNode,
+      bool useHugePages = false);
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
 
   void free(void* FOLLY_NONNULL address, uint64_t bytes);
 
+  /// True if 'address' is in the address range of one of the managed
+  /// MmapArenas.
+  bool contains(const void* FOLLY_NONNULL address) const;
+
+  int32_t numaNode() const {
+    return numaNode_;
+  }
+
   const std::map<uint64_t, std::shared_ptr<MmapArena>>& arenas() const {
     return arenas_;
   }
@@ -141,6 +180,10 @@ class ManagedMmapArenas {
 
   /// Capacity in bytes for a single MmapArena managed by this.
   const uint64_t singleArenaCapacity_;
+
+  const int32_t numaNode_;
+
+  const bool useHugePages_;
 };
 
 } // namespace facebook::velox::memory
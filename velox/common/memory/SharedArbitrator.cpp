@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/SharedArbitrator.h"
+
+#include <algorithm>
+
+#include <folly/ScopeGuard.h>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MemoryAllocator.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::memory {
+
+SharedArbitrator::SharedArbitrator(const Config& config)
+    : MemoryArbitrator(config), freeCapacity_(capacity_) {
+  VELOX_CHECK_EQ(kind_, Kind::kShared);
+}
+
+int64_t SharedArbitrator::reserveMemory(int64_t bytes) {
+  VELOX_CHECK_GE(bytes, 0);
+  return decrementFreeCapacity(
+      std::min<uint64_t>(bytes, initMemoryPoolCapacity_));
+}
+
+void SharedArbitrator::releaseMemory(MemoryPool* releasor) {
+  VELOX_CHECK_NOT_NULL(releasor);
+  VELOX_CHECK_NULL(releasor->parent());
+  incrementFreeCapacity(releasor->capacity());
+}
+
+bool SharedArbitrator::growMemory(
+    MemoryPool* requestor,
+    const std::vector<MemoryPool*>& candidates,
+    uint64_t targetBytes) {
+  VELOX_CHECK_NOT_NULL(requestor);
+  VELOX_CHECK_NULL(
+      requestor->parent(),
+      "Only root memory pool can grow capacity through memory arbitration");
+
+  uint64_t queueTimeUs{0};
+  bool queued{false};
+  std::unique_lock<std::mutex> arbitrationLock(
+      arbitrationMutex_, std::try_to_lock);
+  if (!arbitrationLock.owns_lock()) {
+    queued = true;
+    MicrosecondTimer timer(&queueTimeUs);
+    arbitrationLock.lock();
+  }
+
+  bool success{false};
+  uint64_t arbitrationTimeUs{0};
+  SCOPE_EXIT {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numRequests;
+    if (queued) {
+      ++stats_.numQueuedRequests;
+    }
+    if (!success) {
+      ++stats_.numFailures;
+    }
+    stats_.queueTimeUs += queueTimeUs;
+    stats_.arbitrationTimeUs += arbitrationTimeUs;
+  };
+  MicrosecondTimer timer(&arbitrationTimeUs);
+
+  // A pool can't grow beyond its max capacity. Up to the max capacity, it
+  // grows by at least the min transfer size to avoid an arbitration for every
+  // small reservation.
+  const uint64_t capacity = requestor->capacity();
+  const uint64_t maxCapacity = requestor->maxCapacity();
+  const uint64_t maxGrowBytes =
+      maxCapacity > capacity ? maxCapacity - capacity : 0;
+  if (targetBytes > maxGrowBytes) {
+    VELOX_MEM_LOG(WARNING) << "Can't grow " << requestor->name()
+                           << " capacity by " << succinctBytes(targetBytes)
+                           << " which exceeds its max capacity "
+                           << succinctBytes(maxCapacity);
+    return false;
+  }
+  const uint64_t growBytes = std::min(
+      maxGrowBytes, std::max(minMemoryPoolCapacityTransferSize_, targetBytes));
+
+  uint64_t freedBytes = decrementFreeCapacity(growBytes);
+  if (freedBytes < targetBytes) {
+    auto candidateStats = getCandidateStats(candidates);
+    freedBytes += reclaimFreeMemoryFromCandidates(
+        candidateStats, requestor, growBytes - freedBytes);
+    if (freedBytes < targetBytes) {
+      // Only reclaims what is needed as reclaiming used memory is expensive.
+      freedBytes += reclaimUsedMemoryFromCandidates(
+          candidateStats, targetBytes - freedBytes);
+    }
+  }
+  if (freedBytes < targetBytes) {
+    incrementFreeCapacity(freedBytes);
+    VELOX_MEM_LOG(WARNING) << "Failed to grow " << requestor->name()
+                           << " capacity by " << succinctBytes(targetBytes)
+                           << ", freed " << succinctBytes(freedBytes) << " "
+                           << toString();
+    return false;
+  }
+  shrinkCache(freedBytes);
+  requestor->grow(freedBytes);
+  success = true;
+  return true;
+}
+
+std::vector<SharedArbitrator::Candidate> SharedArbitrator::getCandidateStats(
+    const std::vector<MemoryPool*>& pools) {
+  std::vector<Candidate> candidates;
+  candidates.reserve(pools.size());
+  for (auto* pool : pools) {
+    const bool reclaimable = pool->canReclaim();
+    candidates.push_back(
+        {pool,
+         reclaimable,
+         reclaimable ? pool->reclaimableBytes() : 0,
+         pool->freeBytes()});
+  }
+  return candidates;
+}
+
+uint64_t SharedArbitrator::reclaimFreeMemoryFromCandidates(
+    std::vector<Candidate>& candidates,
+    const MemoryPool* requestor,
+    uint64_t targetBytes) {
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.freeBytes > rhs.freeBytes;
+      });
+  uint64_t freedBytes{0};
+  for (auto& candidate : candidates) {
+    if (freedBytes >= targetBytes || candidate.freeBytes == 0) {
+      break;
+    }
+    if (candidate.pool == requestor) {
+      continue;
+    }
+    const auto bytes = candidate.pool->shrink(targetBytes - freedBytes);
+    candidate.freeBytes -= std::min(bytes, candidate.freeBytes);
+    freedBytes += bytes;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  stats_.numShrunkBytes += freedBytes;
+  return freedBytes;
+}
+
+uint64_t SharedArbitrator::reclaimUsedMemoryFromCandidates(
+    std::vector<Candidate>& candidates,
+    uint64_t targetBytes) {
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        if (lhs.reclaimable != rhs.reclaimable) {
+          return lhs.reclaimable;
+        }
+        return lhs.reclaimableBytes > rhs.reclaimableBytes;
+      });
+  uint64_t freedBytes{0};
+  for (const auto& candidate : candidates) {
+    if (freedBytes >= targetBytes || !candidate.reclaimable) {
+      break;
+    }
+    const auto remainingBytes = targetBytes - freedBytes;
+    candidate.pool->reclaim(remainingBytes);
+    // The reclaimed memory is returned to the pool's free capacity, from where
+    // we take it out.
+    freedBytes += candidate.pool->shrink(remainingBytes);
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  stats_.numReclaimedBytes += freedBytes;
+  return freedBytes;
+}
+
+void SharedArbitrator::shrinkCache(uint64_t grantedBytes) {
+  if (allocator_ == nullptr) {
+    return;
+  }
+  const uint64_t cachedBytes = allocator_->cachedBytes();
+  uint64_t freeCapacity;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    freeCapacity = freeCapacity_;
+  }
+  if (cachedBytes <= freeCapacity) {
+    return;
+  }
+  const uint64_t freedBytes = allocator_->shrinkCache(
+      std::min(grantedBytes, cachedBytes - freeCapacity));
+  std::lock_guard<std::mutex> l(mutex_);
+  stats_.numCacheShrunkBytes += freedBytes;
+}
+
+uint64_t SharedArbitrator::decrementFreeCapacity(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const uint64_t decrementedBytes = std::min(bytes, freeCapacity_);
+  freeCapacity_ -= decrementedBytes;
+  return decrementedBytes;
+}
+
+void SharedArbitrator::incrementFreeCapacity(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  freeCapacity_ += bytes;
+  VELOX_CHECK_LE(
+      freeCapacity_,
+      capacity_,
+      "The free capacity exceeds the arbitrator capacity after returning {}",
+      succinctBytes(bytes));
+}
+
+MemoryArbitrator::Stats SharedArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+std::string SharedArbitrator::toString() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return fmt::format(
+      "ARBITRATOR[{} CAPACITY {} FREE {} {}]",
+      kindString(kind_),
+      succinctBytes(capacity_),
+      succinctBytes(freeCapacity_),
+      stats_.toString());
+}
+} // namespace facebook::velox::memory
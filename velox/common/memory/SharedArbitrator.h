@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+namespace facebook::velox::memory {
+
+/// The memory arbitrator of kind kShared. The query memory pools share the
+/// total memory 'capacity_'. Each pool starts off with a small initial
+/// capacity and grows through memory arbitration on demand. To grow a pool,
+/// the arbitrator takes the requested capacity out of the unassigned capacity
+/// first. If this is not enough, it shrinks the unused capacity of the other
+/// query memory pools, starting with the ones with the most unused capacity.
+/// If this is still not enough, it reclaims used memory from the reclaimable
+/// query memory pools with the most reclaimable memory first, e.g. by disk
+/// spilling, and then shrinks their freed capacity. The memory arbitration
+/// requests are executed one at a time.
+///
+/// If the memory allocator holds a cache, e.g. AsyncDataCache, the cache is
+/// assumed to live in the unassigned capacity. Before granting capacity, the
+/// arbitrator evicts as much of the cache as no longer fits in the remaining
+/// unassigned capacity. So a query gets its memory from the cache before any
+/// query is made to spill, and its allocations find free memory instead of
+/// having to evict from the cache themselves.
+class SharedArbitrator : public MemoryArbitrator {
+ public:
+  explicit SharedArbitrator(const Config& config);
+
+  bool canGrow() final {
+    return true;
+  }
+
+  int64_t reserveMemory(int64_t bytes) final;
+
+  bool growMemory(
+      MemoryPool* requestor,
+      const std::vector<MemoryPool*>& candidates,
+      uint64_t targetBytes) final;
+
+  void releaseMemory(MemoryPool* releasor) final;
+
+  Stats stats() const final;
+
+  std::string toString() const final;
+
+ private:
+  // The memory arbitration stats of a candidate memory pool collected at the
+  // start of a memory arbitration.
+  struct Candidate {
+    MemoryPool* pool;
+    bool reclaimable;
+    uint64_t reclaimableBytes;
+    uint64_t freeBytes;
+  };
+
+  static std::vector<Candidate> getCandidateStats(
+      const std::vector<MemoryPool*>& pools);
+
+  // Takes up to 'bytes' out of 'freeCapacity_' and returns the amount taken.
+  uint64_t decrementFreeCapacity(uint64_t bytes);
+
+  // Returns 'bytes' of capacity to 'freeCapacity_'.
+  void incrementFreeCapacity(uint64_t bytes);
+
+  // Shrinks the unused capacity of 'candidates' other than 'requestor', with
+  // the most unused capacity first, until 'targetBytes' is freed. Returns the
+  // freed capacity in bytes.
+  uint64_t reclaimFreeMemoryFromCandidates(
+      std::vector<Candidate>& candidates,
+      const MemoryPool* requestor,
+      uint64_t targetBytes);
+
+  // Reclaims used memory from the reclaimable 'candidates', with the most
+  // reclaimable memory first, and shrinks their freed capacity until
+  // 'targetBytes' is freed. Returns the freed capacity in bytes.
+  uint64_t reclaimUsedMemoryFromCandidates(
+      std::vector<Candidate>& candidates,
+      uint64_t targetBytes);
+
+  // Evicts from the cache of 'allocator_', if any, what does not fit in the
+  // unassigned capacity after granting 'grantedBytes' of it. Evicts at most
+  // 'grantedBytes'.
+  void shrinkCache(uint64_t grantedBytes);
+
+  // Serializes the memory arbitration requests.
+  std::mutex arbitrationMutex_;
+
+  // Protects 'freeCapacity_' and 'stats_'.
+  mutable std::mutex mutex_;
+
+  // The memory capacity that is not assigned to any query memory pool.
+  uint64_t freeCapacity_;
+};
+} // namespace facebook::velox::memory
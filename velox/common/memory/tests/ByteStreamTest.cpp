@@ -110,3 +110,55 @@ TEST_F(ByteStreamTest, resetInput) {
   ASSERT_EQ(byteStream.size(), totalBytes);
   ASSERT_EQ(byteStream.lastRangeEnd(), lastRangeEnd);
 }
+
+TEST_F(ByteStreamTest, shareRanges) {
+  auto arena = std::make_shared<StreamArena>(pool_.get());
+  ByteStream values(arena.get());
+  values.startWrite(10'000);
+  std::string data(20'000, 0);
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = i % 251;
+  }
+  values.appendStringPiece(folly::StringPiece(data));
+
+  auto out = std::make_unique<IOBufOutputStream>(*pool_);
+  out->shareRanges(arena);
+  std::stringstream referenceSStream;
+  auto reference = std::make_unique<OStreamOutputStream>(&referenceSStream);
+  for (auto* stream : std::vector<OutputStream*>{out.get(), reference.get()}) {
+    const std::string header(16, 'h');
+    stream->write(header.data(), header.size());
+    values.flush(stream);
+    stream->write("tail", 4);
+    // Patches the header before the shared ranges.
+    stream->seekp(4);
+    stream->write("size", 4);
+    stream->seekp(16 + data.size() + 4);
+  }
+  EXPECT_EQ(reference->tellp(), out->tellp());
+  // A write after a seek may not run into a shared range.
+  out->seekp(10);
+  EXPECT_THROW(out->write("too long", 8), VeloxException);
+  out->seekp(16 + data.size() + 4);
+
+  auto iobuf = out->getIOBuf();
+  out = nullptr;
+  auto coalesced = iobuf->clone()->coalesce();
+  EXPECT_EQ(
+      referenceSStream.str(),
+      std::string(
+          reinterpret_cast<const char*>(coalesced.data()), coalesced.size()));
+  // The ranges of 'values' are in the IOBuf chain, not copies of them.
+  bool shared = false;
+  for (auto range : *iobuf) {
+    shared |= range.data() == values.ranges()[0].buffer;
+  }
+  EXPECT_TRUE(shared);
+
+  // The IOBufs keep 'arena' alive.
+  std::weak_ptr<StreamArena> weakArena = arena;
+  arena = nullptr;
+  EXPECT_FALSE(weakArena.expired());
+  iobuf = nullptr;
+  EXPECT_TRUE(weakArena.expired());
+}
@@ -109,6 +109,35 @@ TEST_F(HashStringAllocatorTest, allocate) {
   EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 200);
 }
 
+TEST_F(HashStringAllocatorTest, allocateMixedSizes) {
+  std::vector<HashStringAllocator::Header*> headers;
+  for (auto i = 0; i < 10'000; ++i) {
+    headers.push_back(allocate(
+        i % 7 == 0 ? 2'000 + folly::Random::rand32(rng_) % 10'000
+                   : 16 + folly::Random::rand32(rng_) % 200));
+  }
+  instance_->checkConsistency();
+  // Frees every other block so that the free blocks of all size classes are
+  // interleaved with allocated ones and then reallocates from the free lists.
+  for (auto i = 0; i < headers.size(); i += 2) {
+    instance_->free(headers[i]);
+    headers[i] = nullptr;
+  }
+  instance_->checkConsistency();
+  const auto retainedSize = instance_->retainedSize();
+  for (auto i = 0; i < headers.size(); i += 2) {
+    headers[i] = allocate(16 + folly::Random::rand32(rng_) % 1'000);
+  }
+  instance_->checkConsistency();
+  // The reallocations fit in the freed blocks.
+  EXPECT_EQ(retainedSize, instance_->retainedSize());
+  for (auto* header : headers) {
+    instance_->free(header);
+  }
+  instance_->checkConsistency();
+  EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 200);
+}
+
 TEST_F(HashStringAllocatorTest, multipart) {
   constexpr int32_t kNumSamples = 10'000;
   std::vector<Multipart> data(kNumSamples);
@@ -1391,4 +1391,43 @@ TEST_F(MmapArenaTest, managedMmapArenas) {
     EXPECT_EQ(managedArenas->arenas().size(), 2);
   }
 }
+
+TEST_F(MmapArenaTest, numaNodeAndHugePages) {
+  ASSERT_GE(currentNumaNode(), 0);
+  ManagedMmapArenas managedArenas(kArenaCapacityBytes, 0, true);
+  ASSERT_EQ(managedArenas.numaNode(), 0);
+  void* buffer = managedArenas.allocate(kArenaCapacityBytes / 2);
+  ASSERT_TRUE(managedArenas.contains(buffer));
+  int dummy;
+  ASSERT_FALSE(managedArenas.contains(&dummy));
+  memset(buffer, 1, kArenaCapacityBytes / 2);
+  managedArenas.free(buffer, kArenaCapacityBytes / 2);
+}
+
+TEST(MmapAllocatorNumaTest, contiguousPlacement) {
+  for (const bool useMmapArena : {false, true}) {
+    SCOPED_TRACE(fmt::format("useMmapArena {}", useMmapArena));
+    MmapAllocator::Options options;
+    options.capacity = kMaxMemoryAllocator;
+    options.useMmapArena = useMmapArena;
+    options.useHugePages = true;
+    options.numNumaNodes = 2;
+    MmapAllocator allocator(options);
+    const MachinePageCount numPages =
+        2 * MmapAllocator::kHugePageSize / AllocationTraits::kPageSize;
+    ContiguousAllocation allocation;
+    ASSERT_TRUE(allocator.allocateContiguous(numPages, nullptr, allocation));
+    memset(allocation.data(), 1, allocation.size());
+    // The kernel may not support transparent huge pages.
+    ASSERT_LE(allocator.numHugePageAdvisedPages(), numPages);
+    ASSERT_EQ(
+        allocator.numContiguousPagesOnNode(0) +
+            allocator.numContiguousPagesOnNode(1),
+        numPages);
+    VELOX_ASSERT_THROW(allocator.numContiguousPagesOnNode(2), "");
+    allocator.freeContiguous(allocation);
+    ASSERT_EQ(allocator.numAllocated(), 0);
+    ASSERT_TRUE(allocator.checkConsistency());
+  }
+}
 } // namespace facebook::velox::memory
@@ -42,9 +42,10 @@ TEST_F(MemoryArbitrationTest, stats) {
   stats.arbitrationTimeUs = 1020;
   stats.numShrunkBytes = 100'000'000;
   stats.numReclaimedBytes = 10'000;
+  stats.numCacheShrunkBytes = 3 * MB;
   ASSERT_EQ(
       stats.toString(),
-      "STATS[numRequests 2 numFailures 100 numQueuedRequests 1000 queueTime 230.00ms arbitrationTime 1.02ms shrunkMemory 95.37MB reclaimedMemory 9.77KB]");
+      "STATS[numRequests 2 numFailures 100 numQueuedRequests 1000 queueTime 230.00ms arbitrationTime 1.02ms shrunkMemory 95.37MB reclaimedMemory 9.77KB shrunkCache 3.00MB]");
 }
 
 TEST_F(MemoryArbitrationTest, kind) {
@@ -68,16 +69,22 @@ TEST_F(MemoryArbitrationTest, kind) {
 }
 
 TEST_F(MemoryArbitrationTest, create) {
-  std::vector<MemoryArbitrator::Kind> kinds;
-  kinds.push_back(MemoryArbitrator::Kind::kFixed);
-  kinds.push_back(MemoryArbitrator::Kind::kShared);
-  kinds.push_back(static_cast<MemoryArbitrator::Kind>(100));
-  for (const auto& kind : kinds) {
+  std::vector<MemoryArbitrator::Kind> unsupportedKinds;
+  unsupportedKinds.push_back(MemoryArbitrator::Kind::kFixed);
+  unsupportedKinds.push_back(static_cast<MemoryArbitrator::Kind>(100));
+  for (const auto& kind : unsupportedKinds) {
     MemoryArbitrator::Config config;
     config.capacity = 1 * GB;
     config.kind = kind;
     VELOX_ASSERT_THROW(MemoryArbitrator::create(config), "");
   }
+
+  MemoryArbitrator::Config config;
+  config.capacity = 1 * GB;
+  config.kind = MemoryArbitrator::Kind::kShared;
+  auto arbitrator = MemoryArbitrator::create(config);
+  ASSERT_EQ(arbitrator->kind(), MemoryArbitrator::Kind::kShared);
+  ASSERT_TRUE(arbitrator->canGrow());
 }
 
 class MemoryReclaimerTest : public testing::Test {
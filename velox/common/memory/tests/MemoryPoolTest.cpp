@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/json.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -1929,18 +1930,118 @@ TEST(MemoryPoolTest, visitChildren) {
   }
 }
 
-TEST_P(MemoryPoolTest, shrinkAPIs) {
-  MemoryManager manager;
-  std::vector<bool> isLeafs = {true, false};
-  for (const auto isLeaf : isLeafs) {
-    SCOPED_TRACE(fmt::format("is leaf {}", isLeaf));
-    auto pool = isLeaf ? manager.addLeafPool("shrinkAPIs")
-                       : manager.addRootPool("shrinkAPIs");
-    auto* poolPtr = dynamic_cast<MemoryPoolImpl*>(pool.get());
-    VELOX_ASSERT_THROW(poolPtr->freeBytes(), "");
-    VELOX_ASSERT_THROW(poolPtr->shrink(0), "");
-    VELOX_ASSERT_THROW(poolPtr->shrink(100), "");
+TEST(MemoryPoolTest, usageSnapshot) {
+  MemoryManager manager{{.trackPoolAllocations = true,
+                         .poolAllocationStackSampleRate = 2}};
+  auto root = manager.addRootPool("root");
+  auto task = root->addAggregateChild("task");
+  auto leaf1 = task->addLeafChild("leaf1");
+  auto leaf2 = task->addLeafChild("leaf2");
+
+  std::vector<std::pair<void*, int64_t>> buffers;
+  for (int i = 1; i <= 4; ++i) {
+    buffers.emplace_back(leaf1->allocate(i * KB), i * KB);
+  }
+  buffers.emplace_back(leaf2->allocate(MB), MB);
+  leaf1->free(buffers[0].first, buffers[0].second);
+  ContiguousAllocation contiguous;
+  leaf2->allocateContiguous(64, contiguous);
+
+  auto snapshot = root->usageSnapshot(2);
+  ASSERT_EQ(snapshot.name, "root");
+  ASSERT_EQ(snapshot.kind, MemoryPool::Kind::kAggregate);
+  ASSERT_EQ(
+      snapshot.currentBytes, root->getMemoryUsageTracker()->currentBytes());
+  ASSERT_EQ(snapshot.children.size(), 1);
+  const auto& taskSnapshot = snapshot.children[0];
+  ASSERT_EQ(taskSnapshot.name, "task");
+  ASSERT_EQ(taskSnapshot.children.size(), 2);
+  // The children are ordered by current usage.
+  const auto& leaf2Snapshot = taskSnapshot.children[0];
+  const auto& leaf1Snapshot = taskSnapshot.children[1];
+  ASSERT_EQ(leaf2Snapshot.name, "leaf2");
+  ASSERT_EQ(leaf1Snapshot.name, "leaf1");
+  ASSERT_EQ(
+      leaf1Snapshot.currentBytes,
+      leaf1->getMemoryUsageTracker()->currentBytes());
+  ASSERT_EQ(leaf1Snapshot.numAllocs, 4);
+  ASSERT_EQ(leaf1Snapshot.largestAllocations.size(), 2);
+  ASSERT_EQ(leaf1Snapshot.largestAllocations[0].bytes, 4 * KB);
+  ASSERT_EQ(leaf1Snapshot.largestAllocations[1].bytes, 3 * KB);
+  // One in every two allocations is sampled for stack trace, starting with the
+  // first one.
+  ASSERT_TRUE(leaf1Snapshot.largestAllocations[0].stackTrace.empty());
+  ASSERT_FALSE(leaf1Snapshot.largestAllocations[1].stackTrace.empty());
+  ASSERT_EQ(leaf2Snapshot.largestAllocations.size(), 2);
+  ASSERT_EQ(leaf2Snapshot.largestAllocations[0].bytes, MB);
+  ASSERT_EQ(
+      leaf2Snapshot.largestAllocations[1].bytes,
+      64 * AllocationTraits::kPageSize);
+
+  const auto json = folly::parseJson(snapshot.toString());
+  ASSERT_EQ(json["name"], "root");
+  ASSERT_EQ(json["children"][0]["children"][1]["name"], "leaf1");
+  ASSERT_EQ(
+      json["children"][0]["children"][1]["largestAllocations"][0]["bytes"],
+      4 * KB);
+
+  // A memory pool which doesn't track its allocations doesn't report them.
+  MemoryManager untrackedManager{};
+  auto untrackedRoot = untrackedManager.addRootPool("untracked");
+  auto untrackedLeaf = untrackedRoot->addLeafChild("leaf");
+  void* buffer = untrackedLeaf->allocate(KB);
+  ASSERT_TRUE(untrackedRoot->usageSnapshot()
+                  .children[0]
+                  .largestAllocations.empty());
+  untrackedLeaf->free(buffer, KB);
+
+  leaf2->freeContiguous(contiguous);
+  for (int i = 1; i < buffers.size(); ++i) {
+    auto* pool = i < 4 ? leaf1.get() : leaf2.get();
+    pool->free(buffers[i].first, buffers[i].second);
   }
+  for (const auto& leafSnapshot : root->usageSnapshot().children[0].children) {
+    ASSERT_TRUE(leafSnapshot.largestAllocations.empty());
+  }
+}
+
+TEST_P(MemoryPoolTest, shrinkAndGrowAPIs) {
+  MemoryManager manager;
+  auto root = manager.addRootPool("shrinkAndGrowAPIs", 64 * MB);
+  auto leaf = root->addLeafChild("shrinkAndGrowAPIs", isLeafThreadSafe_);
+  ASSERT_EQ(root->capacity(), 64 * MB);
+  ASSERT_EQ(leaf->capacity(), 64 * MB);
+  ASSERT_EQ(root->freeBytes(), 64 * MB);
+  VELOX_ASSERT_THROW(leaf->freeBytes(), "");
+  VELOX_ASSERT_THROW(leaf->shrink(0), "");
+  VELOX_ASSERT_THROW(leaf->grow(MB), "");
+
+  void* buffer = leaf->allocate(MB);
+  ASSERT_EQ(root->freeBytes(), 63 * MB);
+  ASSERT_EQ(root->shrink(MB), MB);
+  ASSERT_EQ(root->capacity(), 63 * MB);
+  ASSERT_EQ(root->freeBytes(), 62 * MB);
+  ASSERT_EQ(root->shrink(0), 62 * MB);
+  ASSERT_EQ(root->capacity(), MB);
+  ASSERT_EQ(root->freeBytes(), 0);
+  ASSERT_EQ(root->shrink(0), 0);
+  VELOX_ASSERT_THROW(leaf->allocate(MB), "");
+
+  ASSERT_EQ(root->grow(8 * MB), 9 * MB);
+  ASSERT_EQ(leaf->capacity(), 9 * MB);
+  ASSERT_EQ(root->freeBytes(), 8 * MB);
+  void* buffer2 = leaf->allocate(MB);
+  leaf->free(buffer2, MB);
+  leaf->free(buffer, MB);
+  ASSERT_EQ(root->freeBytes(), 9 * MB);
+
+  // A memory pool without memory usage tracking has no capacity to shrink.
+  auto untrackedRoot =
+      manager.addRootPool("shrinkAndGrowAPIsUntracked", kMaxMemory, false);
+  ASSERT_EQ(untrackedRoot->capacity(), kMaxMemory);
+  ASSERT_EQ(untrackedRoot->freeBytes(), 0);
+  ASSERT_EQ(untrackedRoot->shrink(0), 0);
+  VELOX_ASSERT_THROW(untrackedRoot->grow(MB), "");
 }
 
 TEST_P(MemoryPoolTest, reclaimAPIsWithDefaultReclaimer) {
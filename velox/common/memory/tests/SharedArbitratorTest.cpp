@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/memory/SharedArbitrator.h"
+
+using namespace ::testing;
+
+constexpr int64_t KB = 1024L;
+constexpr int64_t MB = 1024L * KB;
+
+namespace facebook::velox::memory {
+namespace {
+// Reclaims by freeing the allocation set on it. It also counts the number of
+// memory arbitrations entered by its memory pool.
+class FakeLeafReclaimer : public MemoryReclaimer {
+ public:
+  void setAllocation(MemoryPool* pool, void* buffer, uint64_t size) {
+    pool_ = pool;
+    buffer_ = buffer;
+    size_ = size;
+  }
+
+  void enterArbitration() override {
+    ++numEnterArbitrations;
+    ++numActiveArbitrations;
+  }
+
+  void leaveArbitration() noexcept override {
+    --numActiveArbitrations;
+  }
+
+  bool canReclaim(const MemoryPool& /*unused*/) const override {
+    return buffer_ != nullptr;
+  }
+
+  uint64_t reclaimableBytes(const MemoryPool& /*unused*/) const override {
+    return buffer_ != nullptr ? size_ : 0;
+  }
+
+  uint64_t reclaim(MemoryPool* /*unused*/, uint64_t /*unused*/) override {
+    if (buffer_ == nullptr) {
+      return 0;
+    }
+    pool_->free(buffer_, size_);
+    buffer_ = nullptr;
+    return size_;
+  }
+
+  int numEnterArbitrations{0};
+  int numActiveArbitrations{0};
+
+ private:
+  MemoryPool* pool_{nullptr};
+  void* buffer_{nullptr};
+  uint64_t size_{0};
+};
+
+// Allocator that pretends to hold 'cachedBytes' of cache memory.
+class FakeCacheAllocator : public MmapAllocator {
+ public:
+  explicit FakeCacheAllocator(uint64_t cachedBytes)
+      : MmapAllocator(MmapAllocator::Options{.capacity = 64 * MB}),
+        cachedBytes_(cachedBytes) {}
+
+  uint64_t cachedBytes() const override {
+    return cachedBytes_;
+  }
+
+  uint64_t shrinkCache(uint64_t bytes) override {
+    const auto freed = std::min(bytes, cachedBytes_);
+    cachedBytes_ -= freed;
+    return freed;
+  }
+
+ private:
+  uint64_t cachedBytes_;
+};
+} // namespace
+
+class SharedArbitratorTest : public testing::Test {
+ protected:
+  static constexpr int64_t kCapacity = 64 * MB;
+  static constexpr int64_t kInitCapacity = 32 * MB;
+  static constexpr int64_t kTransferSize = 4 * MB;
+
+  void SetUp() override {
+    IMemoryManager::Options options;
+    options.capacity = kCapacity;
+    options.arbitratorConfig = MemoryArbitrator::Config{
+        .kind = MemoryArbitrator::Kind::kShared,
+        .capacity = kCapacity,
+        .initMemoryPoolCapacity = kInitCapacity,
+        .minMemoryPoolCapacityTransferSize = kTransferSize};
+    manager_ = std::make_unique<MemoryManager>(options);
+  }
+
+  void TearDown() override {
+    manager_.reset();
+  }
+
+  // Creates a root pool which reclaims from its children, and a leaf child with
+  // a FakeLeafReclaimer.
+  std::pair<std::shared_ptr<MemoryPool>, std::shared_ptr<MemoryPool>> addQuery(
+      const std::string& name,
+      int64_t maxBytes = kMaxMemory) {
+    auto root = manager_->addRootPool(
+        name, maxBytes, true, MemoryReclaimer::create());
+    auto leaf = root->addLeafChild(
+        name + ".leaf", true, std::make_shared<FakeLeafReclaimer>());
+    return {std::move(root), std::move(leaf)};
+  }
+
+  static FakeLeafReclaimer* reclaimer(const std::shared_ptr<MemoryPool>& leaf) {
+    return static_cast<FakeLeafReclaimer*>(leaf->reclaimer());
+  }
+
+  std::unique_ptr<MemoryManager> manager_;
+};
+
+TEST_F(SharedArbitratorTest, reserveAndRelease) {
+  VELOX_ASSERT_THROW(
+      MemoryManager({.capacity = kCapacity,
+                     .arbitratorConfig = MemoryArbitrator::Config{
+                         .kind = MemoryArbitrator::Kind::kShared,
+                         .capacity = kCapacity / 2}}),
+      "Memory arbitrator capacity must be the same as memory manager's");
+
+  auto pool1 = manager_->addRootPool("pool1");
+  ASSERT_EQ(pool1->capacity(), kInitCapacity);
+  ASSERT_EQ(pool1->maxCapacity(), kMaxMemory);
+  auto pool2 = manager_->addRootPool("pool2", 16 * MB);
+  ASSERT_EQ(pool2->capacity(), 16 * MB);
+  ASSERT_EQ(pool2->maxCapacity(), 16 * MB);
+  auto pool3 = manager_->addRootPool("pool3");
+  ASSERT_EQ(pool3->capacity(), kCapacity - kInitCapacity - 16 * MB);
+  auto pool4 = manager_->addRootPool("pool4");
+  ASSERT_EQ(pool4->capacity(), 0);
+
+  // A pool without memory usage tracking doesn't take part in arbitration.
+  auto untrackedPool = manager_->addRootPool("untracked", kMaxMemory, false);
+  ASSERT_EQ(untrackedPool->capacity(), kMaxMemory);
+  untrackedPool.reset();
+
+  pool1.reset();
+  auto pool5 = manager_->addRootPool("pool5");
+  ASSERT_EQ(pool5->capacity(), kInitCapacity);
+  ASSERT_EQ(manager_->arbitrator()->stats().numRequests, 0);
+}
+
+TEST_F(SharedArbitratorTest, growFromFreeCapacity) {
+  auto [root, leaf] = addQuery("query");
+  ASSERT_EQ(root->capacity(), kInitCapacity);
+
+  void* buffer = leaf->allocate(kInitCapacity + MB);
+  ASSERT_GE(root->capacity(), kInitCapacity + MB);
+  ASSERT_LE(root->capacity(), kCapacity);
+  auto stats = manager_->arbitrator()->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_EQ(stats.numShrunkBytes, 0);
+  ASSERT_EQ(stats.numReclaimedBytes, 0);
+  ASSERT_EQ(reclaimer(leaf)->numEnterArbitrations, 1);
+  ASSERT_EQ(reclaimer(leaf)->numActiveArbitrations, 0);
+  leaf->free(buffer, kInitCapacity + MB);
+}
+
+TEST_F(SharedArbitratorTest, shrinkFreeCapacityFromOtherPools) {
+  auto [root1, leaf1] = addQuery("query1");
+  auto [root2, leaf2] = addQuery("query2");
+  ASSERT_EQ(root1->capacity() + root2->capacity(), kCapacity);
+
+  void* buffer = leaf1->allocate(40 * MB);
+  ASSERT_GE(root1->capacity(), 40 * MB);
+  ASSERT_LE(root2->capacity(), kCapacity - 40 * MB);
+  ASSERT_EQ(root1->capacity() + root2->capacity(), kCapacity);
+  auto stats = manager_->arbitrator()->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_GE(stats.numShrunkBytes, 8 * MB);
+  ASSERT_EQ(stats.numReclaimedBytes, 0);
+  leaf1->free(buffer, 40 * MB);
+}
+
+TEST_F(SharedArbitratorTest, reclaimUsedMemoryFromOtherPools) {
+  auto [root1, leaf1] = addQuery("query1");
+  auto [root2, leaf2] = addQuery("query2");
+
+  void* buffer2 = leaf2->allocate(kInitCapacity);
+  reclaimer(leaf2)->setAllocation(leaf2.get(), buffer2, kInitCapacity);
+  ASSERT_TRUE(root2->canReclaim());
+  ASSERT_EQ(root2->reclaimableBytes(), kInitCapacity);
+
+  void* buffer1 = leaf1->allocate(40 * MB);
+  ASSERT_GE(root1->capacity(), 40 * MB);
+  ASSERT_FALSE(root2->canReclaim());
+  ASSERT_EQ(leaf2->getCurrentBytes(), 0);
+  auto stats = manager_->arbitrator()->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 0);
+  ASSERT_GE(stats.numReclaimedBytes, 8 * MB);
+  leaf1->free(buffer1, 40 * MB);
+}
+
+TEST_F(SharedArbitratorTest, shrinkCache) {
+  constexpr int64_t kCachedBytes = 30 * MB;
+  auto cache = std::make_shared<FakeCacheAllocator>(kCachedBytes);
+  manager_ = std::make_unique<MemoryManager>(IMemoryManager::Options{
+      .capacity = kCapacity,
+      .arbitratorConfig = MemoryArbitrator::Config{
+          .kind = MemoryArbitrator::Kind::kShared,
+          .capacity = kCapacity,
+          .initMemoryPoolCapacity = kInitCapacity,
+          .minMemoryPoolCapacityTransferSize = kTransferSize,
+          .allocator = cache.get()}});
+  auto [root, leaf] = addQuery("query");
+  // The cache fits in the unassigned capacity.
+  ASSERT_EQ(cache->cachedBytes(), kCachedBytes);
+
+  // The capacity granted to the query is taken from the cache as far as the
+  // cache no longer fits in the unassigned capacity.
+  void* buffer = leaf->allocate(kInitCapacity + 8 * MB);
+  ASSERT_GT(root->capacity(), kCapacity - kCachedBytes);
+  ASSERT_EQ(cache->cachedBytes(), kCapacity - root->capacity());
+  auto stats = manager_->arbitrator()->stats();
+  ASSERT_EQ(stats.numCacheShrunkBytes, kCachedBytes - cache->cachedBytes());
+  ASSERT_EQ(stats.numReclaimedBytes, 0);
+  leaf->free(buffer, kInitCapacity + 8 * MB);
+  leaf.reset();
+  root.reset();
+  manager_.reset();
+}
+
+TEST_F(SharedArbitratorTest, growFailure) {
+  auto [root1, leaf1] = addQuery("query1");
+  auto [root2, leaf2] = addQuery("query2");
+
+  // 'query2' uses all its capacity and can't reclaim.
+  void* buffer2 = leaf2->allocate(kInitCapacity);
+  VELOX_ASSERT_THROW(leaf1->allocate(40 * MB), "");
+  ASSERT_EQ(root1->capacity(), kInitCapacity);
+  ASSERT_EQ(root2->capacity(), kInitCapacity);
+  auto stats = manager_->arbitrator()->stats();
+  ASSERT_EQ(stats.numRequests, 1);
+  ASSERT_EQ(stats.numFailures, 1);
+  ASSERT_EQ(reclaimer(leaf1)->numActiveArbitrations, 0);
+  leaf2->free(buffer2, kInitCapacity);
+
+  // The capacity can't grow beyond the pool's max capacity even if there is
+  // free capacity.
+  root1.reset();
+  leaf1.reset();
+  auto [root3, leaf3] = addQuery("query3", 16 * MB);
+  ASSERT_EQ(root3->capacity(), 16 * MB);
+  VELOX_ASSERT_THROW(leaf3->allocate(20 * MB), "");
+  ASSERT_EQ(root3->capacity(), 16 * MB);
+  ASSERT_EQ(manager_->arbitrator()->stats().numFailures, 2);
+}
+} // namespace facebook::velox::memory
@@ -34,6 +34,7 @@ class ITypedExpr;
 
 namespace facebook::velox::exec {
 class ExprSet;
+struct SpillConfig;
 }
 
 namespace facebook::velox::connector {
@@ -55,6 +56,28 @@ struct ConnectorSplit {
   virtual std::string toString() const {
     return fmt::format("[split: {}]", connectorId);
   }
+
+  /// Returns the number of bytes of data covered by the split or 0 if not
+  /// known.
+  virtual uint64_t size() const {
+    return 0;
+  }
+
+  /// Divides the split into at most 'maxParts' splits of at least 'minSize'
+  /// bytes that together cover the same data. Returns an empty vector if the
+  /// split can't be divided.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> divide(
+      int32_t /*maxParts*/,
+      uint64_t /*minSize*/) const {
+    return {};
+  }
+
+  /// Returns a string that identifies the data of the split, or std::nullopt
+  /// if the data may change between reads. Results computed from the split
+  /// may be cached under this key, see exec::FragmentResultCache.
+  virtual std::optional<std::string> cacheKey() const {
+    return std::nullopt;
+  }
 };
 
 class ColumnHandle {
@@ -116,6 +139,12 @@ class DataSink {
   virtual std::vector<std::string> finish() const = 0;
 
   virtual void close() = 0;
+
+  /// Returns the runtime stats of the sink. Called after close().
+  virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats()
+      const {
+    return {};
+  }
 };
 
 class DataSource {
@@ -170,6 +199,11 @@ class DataSource {
     VELOX_UNSUPPORTED("setFromDataSource");
   }
 
+  // Starts the reads of the first data of the split added last, so that the
+  // first next() does not wait for it. Called on the connector's executor
+  // after addSplit() when the split is preloaded. The default does nothing.
+  virtual void prefetch() {}
+
   // Returns a connector dependent row size if available. This can be
   // called after addSplit().  This estimates uncompressed data
   // sizes. This is better than getCompletedBytes()/getCompletedRows()
@@ -220,7 +254,8 @@ class ConnectorQueryCtx {
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
       const std::string& taskId,
       const std::string& planNodeId,
-      int driverId)
+      int driverId,
+      const exec::SpillConfig* FOLLY_NULLABLE spillConfig = nullptr)
       : operatorPool_(operatorPool),
         connectorPool_(connectorPool),
         config_(connectorConfig),
@@ -228,7 +263,8 @@ class ConnectorQueryCtx {
         allocator_(allocator),
         scanId_(fmt::format("{}.{}", taskId, planNodeId)),
         taskId_(taskId),
-        driverId_(driverId) {}
+        driverId_(driverId),
+        spillConfig_(spillConfig) {}
 
   /// Returns the associated operator's memory pool which is a leaf kind of
   /// memory pool, used for direct memory allocation use.
@@ -273,6 +309,12 @@ class ConnectorQueryCtx {
     return driverId_;
   }
 
+  /// Returns the spill config for a data sink to spill buffered data, or
+  /// nullptr if spilling is disabled.
+  const exec::SpillConfig* FOLLY_NULLABLE spillConfig() const {
+    return spillConfig_;
+  }
+
  private:
   memory::MemoryPool* operatorPool_;
   memory::MemoryPool* connectorPool_;
@@ -282,6 +324,7 @@ class ConnectorQueryCtx {
   const std::string scanId_;
   const std::string taskId_;
   const int driverId_;
+  const exec::SpillConfig* FOLLY_NULLABLE const spillConfig_;
 };
 
 class Connector {
@@ -315,6 +358,20 @@ class Connector {
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx) = 0;
 
+  // Returns a copy of 'tableHandle' whose DataSource also drops the rows that
+  // do not pass 'filter', or nullptr if the connector cannot evaluate
+  // 'filter' while reading. 'filter' refers to the columns of the scan by
+  // their names in 'columnHandles'. Lets the planner evaluate a filter over a
+  // scan on the rows produced by the reader instead of in a FilterProject.
+  virtual std::shared_ptr<ConnectorTableHandle> pushdownFilter(
+      const std::shared_ptr<ConnectorTableHandle>& /*tableHandle*/,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& /*columnHandles*/,
+      const std::shared_ptr<const core::ITypedExpr>& /*filter*/) const {
+    return nullptr;
+  }
+
   // Returns true if addSplit of DataSource can use 'dataSource' from
   // ConnectorSplit in addSplit(). If so, TableScan can preload splits
   // so that file opening and metadata operations are off the Driver'
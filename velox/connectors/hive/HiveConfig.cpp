@@ -15,6 +15,7 @@
  */
 
 #include "velox/connectors/hive/HiveConfig.h"
+#include "velox/dwio/common/ScanSpec.h"
 
 #include <boost/algorithm/string.hpp>
 
@@ -35,6 +36,18 @@ stringToInsertExistingPartitionsBehavior(const std::string& strValue) {
       "Unsupported insert existing partitions behavior: {}.", strValue);
 }
 
+common::CollectionOverflowPolicy stringToCollectionOverflowPolicy(
+    const std::string& strValue) {
+  auto upperValue = boost::algorithm::to_upper_copy(strValue);
+  if (upperValue == "TRUNCATE") {
+    return common::CollectionOverflowPolicy::kTruncate;
+  }
+  if (upperValue == "ERROR") {
+    return common::CollectionOverflowPolicy::kError;
+  }
+  VELOX_UNSUPPORTED("Unsupported collection overflow policy: {}.", strValue);
+}
+
 } // namespace
 
 // static
@@ -61,4 +74,58 @@ bool HiveConfig::isCaseSensitive(const Config* config) {
   return config->get<bool>(kCaseSensitive, true);
 }
 
+// static
+int32_t HiveConfig::splitDecodingParallelism(const Config* config) {
+  return config->get<int32_t>(kSplitDecodingParallelism, 1);
+}
+
+// static
+uint64_t HiveConfig::maxWriterMemory(const Config* config) {
+  return config->get<uint64_t>(kMaxWriterMemory, 0);
+}
+
+// static
+uint64_t HiveConfig::maxTargetFileSize(const Config* config) {
+  return config->get<uint64_t>(kMaxTargetFileSize, 0);
+}
+
+// static
+int32_t HiveConfig::writerEncodingParallelism(const Config* config) {
+  return config->get<int32_t>(kWriterEncodingParallelism, 1);
+}
+
+// static
+bool HiveConfig::biasedIntegerVectors(const Config* config) {
+  return config->get<bool>(kBiasedIntegerVectors, false);
+}
+
+// static
+int32_t HiveConfig::minSequenceRunLength(const Config* config) {
+  return config->get<int32_t>(kMinSequenceRunLength, 0);
+}
+
+// static
+bool HiveConfig::preloadFirstStripe(const Config* config) {
+  return config->get<bool>(kPreloadFirstStripe, true);
+}
+
+// static
+bool HiveConfig::decompressAhead(const Config* config) {
+  return config->get<bool>(kDecompressAhead, false);
+}
+
+// static
+int32_t HiveConfig::maxCollectionElements(const Config* config) {
+  return config->get<int32_t>(kMaxCollectionElements, 0);
+}
+
+// static
+common::CollectionOverflowPolicy HiveConfig::collectionOverflowPolicy(
+    const Config* config) {
+  auto strPolicy = config->get<std::string>(kCollectionOverflowPolicy);
+  return strPolicy.has_value()
+      ? stringToCollectionOverflowPolicy(strPolicy.value())
+      : common::CollectionOverflowPolicy::kTruncate;
+}
+
 } // namespace facebook::velox::connector::hive
@@ -17,6 +17,10 @@
 
 #include "velox/core/Context.h"
 
+namespace facebook::velox::common {
+enum class CollectionOverflowPolicy;
+} // namespace facebook::velox::common
+
 namespace facebook::velox::connector::hive {
 
 /// Hive connector configs.
@@ -49,6 +53,80 @@ class HiveConfig {
   static constexpr const char* kCaseSensitive = "case_sensitive";
 
   static bool isCaseSensitive(const Config* config);
+
+  /// Maximum number of columns of a split decoded at a time on the connector's
+  /// executor. 1 decodes all columns on the driver thread.
+  static constexpr const char* kSplitDecodingParallelism =
+      "split_decoding_parallelism";
+
+  static int32_t splitDecodingParallelism(const Config* config);
+
+  /// Memory budget in bytes of all file writers of a table writer instance.
+  /// When these use more, the largest writers flush their stripes and the
+  /// writers of partitions without recent rows are closed. 0 means no limit.
+  static constexpr const char* kMaxWriterMemory = "max_writer_memory";
+
+  static uint64_t maxWriterMemory(const Config* config);
+
+  /// Size in bytes at which a file writer closes its file. The next rows of
+  /// the writer go to a new file in the same directory. The size is checked
+  /// after each input and includes the estimated size of the stripe being
+  /// written. Does not apply to bucketed tables. 0 means no limit.
+  static constexpr const char* kMaxTargetFileSize = "max_target_file_size";
+
+  static uint64_t maxTargetFileSize(const Config* config);
+
+  /// Maximum number of columns of a batch encoded at a time by a file writer
+  /// on the connector's executor. 1 encodes all columns on the driver thread.
+  static constexpr const char* kWriterEncodingParallelism =
+      "writer_encoding_parallelism";
+
+  static int32_t writerEncodingParallelism(const Config* config);
+
+  /// Whether the readers return BIGINT and INTEGER columns as BiasVectors
+  /// when the values of a batch fit a narrower type after subtracting their
+  /// minimum.
+  static constexpr const char* kBiasedIntegerVectors =
+      "biased_integer_vectors";
+
+  static bool biasedIntegerVectors(const Config* config);
+
+  /// If non-zero, the readers return BIGINT, INTEGER and SMALLINT columns as
+  /// SequenceVectors when the runs of equal values of a batch are at least
+  /// this long on the average. 0 disables run-length encoded results.
+  static constexpr const char* kMinSequenceRunLength =
+      "min_sequence_run_length";
+
+  static int32_t minSequenceRunLength(const Config* config);
+
+  /// Whether a preloaded split also issues the reads of its first stripe or
+  /// row group in the background, on top of opening the file and reading its
+  /// footer.
+  static constexpr const char* kPreloadFirstStripe = "preload_first_stripe";
+
+  static bool preloadFirstStripe(const Config* config);
+
+  /// Whether the readers decrypt and decompress the next block of each
+  /// stream on the connector's executor while the driver thread decodes the
+  /// current one.
+  static constexpr const char* kDecompressAhead = "decompress_ahead";
+
+  static bool decompressAhead(const Config* config);
+
+  /// If non-zero, the readers take at most this many elements of each array
+  /// or map value. The action for the values with more is given by
+  /// kCollectionOverflowPolicy.
+  static constexpr const char* kMaxCollectionElements =
+      "max_collection_elements";
+
+  static int32_t maxCollectionElements(const Config* config);
+
+  /// 'truncate' or 'error'. See common::CollectionOverflowPolicy.
+  static constexpr const char* kCollectionOverflowPolicy =
+      "collection_overflow_policy";
+
+  static common::CollectionOverflowPolicy collectionOverflowPolicy(
+      const Config* config);
 };
 
 } // namespace facebook::velox::connector::hive
@@ -16,9 +16,13 @@
 
 #include "velox/connectors/hive/HiveConnector.h"
 
+#include <folly/hash/Hash.h>
+
 #include "velox/common/base/Fs.h"
+#include "velox/dwio/common/DecodedVectorCache.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ReaderFactory.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/FieldReference.h"
 #include "velox/type/Conversions.h"
 #include "velox/type/DecimalUtilOp.h"
@@ -28,6 +32,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <memory>
+#include <unordered_set>
 
 using namespace facebook::velox::exec;
 using namespace facebook::velox::dwrf;
@@ -48,12 +53,29 @@ HiveTableHandle::HiveTableHandle(
     const std::string& tableName,
     bool filterPushdownEnabled,
     SubfieldFilters subfieldFilters,
-    const core::TypedExprPtr& remainingFilter)
+    const core::TypedExprPtr& remainingFilter,
+    std::optional<HiveTableSample> sample)
     : ConnectorTableHandle(std::move(connectorId)),
       tableName_(tableName),
       filterPushdownEnabled_(filterPushdownEnabled),
       subfieldFilters_(std::move(subfieldFilters)),
-      remainingFilter_(remainingFilter) {}
+      remainingFilter_(remainingFilter),
+      sample_(std::move(sample)) {
+  if (sample_.has_value()) {
+    VELOX_USER_CHECK(
+        sample_->percentage >= 0 && sample_->percentage <= 100,
+        "Sample percentage must be between 0 and 100: {}",
+        sample_->percentage);
+  }
+}
+
+std::string HiveTableSample::toString() const {
+  return fmt::format(
+      "{} {}% seed {}",
+      method == Method::kSystem ? "SYSTEM" : "BERNOULLI",
+      percentage,
+      seed);
+}
 
 HiveTableHandle::~HiveTableHandle() {}
 
@@ -80,6 +102,9 @@ std::string HiveTableHandle::toString() const {
   if (remainingFilter_) {
     out << ", remaining filter: (" << remainingFilter_->toString() << ")";
   }
+  if (sample_.has_value()) {
+    out << ", sample: " << sample_->toString();
+  }
   return out.str();
 }
 
@@ -246,6 +271,65 @@ std::shared_ptr<common::ScanSpec> HiveDataSource::makeScanSpec(
   return spec;
 }
 
+// static
+core::TypedExprPtr HiveDataSource::extractFiltersFromRemainingFilter(
+    const core::TypedExprPtr& expr,
+    SubfieldFilters& filters) {
+  auto* call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (!call) {
+    return expr;
+  }
+  if (call->name() == "and") {
+    std::vector<core::TypedExprPtr> remaining;
+    for (const auto& input : call->inputs()) {
+      if (auto rest = extractFiltersFromRemainingFilter(input, filters)) {
+        remaining.push_back(std::move(rest));
+      }
+    }
+    if (remaining.empty()) {
+      return nullptr;
+    }
+    if (remaining.size() == 1) {
+      return remaining[0];
+    }
+    if (remaining.size() == call->inputs().size()) {
+      return expr;
+    }
+    return std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(), std::move(remaining), "and");
+  }
+
+  const auto* leaf = call;
+  const bool negated = call->name() == "not";
+  if (negated) {
+    leaf = dynamic_cast<const core::CallTypedExpr*>(call->inputs()[0].get());
+    if (!leaf) {
+      return expr;
+    }
+  }
+  common::Subfield subfield;
+  std::unique_ptr<common::Filter> filter;
+  try {
+    filter = exec::leafCallToSubfieldFilter(*leaf, subfield, negated);
+  } catch (const VeloxException&) {
+    // The constant is of a type without a filter.
+    return expr;
+  }
+  // Filters on nested fields and on the columns made by the connector are
+  // left to the remaining filter.
+  if (!filter || subfield.path().size() != 1 ||
+      subfield.toString() == kPath || subfield.toString() == kBucket) {
+    return expr;
+  }
+  auto it = filters.find(subfield);
+  if (it != filters.end()) {
+    it->second = it->second->mergeWith(filter.get());
+  } else {
+    filters.emplace(std::move(subfield), std::move(filter));
+  }
+  return nullptr;
+}
+
 HiveDataSource::HiveDataSource(
     const RowTypePtr& outputType,
     const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -258,7 +342,14 @@ HiveDataSource::HiveDataSource(
     memory::MemoryAllocator* allocator,
     const std::string& scanId,
     bool caseSensitive,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    int32_t decodingParallelism,
+    bool biasedIntegerVectors,
+    int32_t minSequenceRunLength,
+    bool preloadFirstStripe,
+    bool decompressAhead,
+    int32_t maxCollectionElements,
+    common::CollectionOverflowPolicy collectionOverflowPolicy)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
       pool_(pool),
@@ -266,7 +357,8 @@ HiveDataSource::HiveDataSource(
       expressionEvaluator_(expressionEvaluator),
       allocator_(allocator),
       scanId_(scanId),
-      executor_(executor) {
+      executor_(executor),
+      preloadFirstStripe_(preloadFirstStripe) {
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -312,8 +404,24 @@ HiveDataSource::HiveDataSource(
       readerOutputType_,
       hiveColumnHandles,
       pool_);
+  // Single column conjuncts of the remaining filter become filters of the
+  // reader. They prune splits and row groups by statistics and skip the rows
+  // they reject before the remaining filter and the columns it does not
+  // reference are read.
+  auto remainingFilter = hiveTableHandle->remainingFilter();
+  if (remainingFilter) {
+    SubfieldFilters extractedFilters;
+    remainingFilter =
+        extractFiltersFromRemainingFilter(remainingFilter, extractedFilters);
+    for (const auto& [subfield, filter] : extractedFilters) {
+      scanSpec_->getOrCreateChild(subfield)->addFilter(*filter);
+    }
+  }
+  for (const auto& child : scanSpec_->children()) {
+    child->setMakeBiased(biasedIntegerVectors);
+    child->setMinRunLength(minSequenceRunLength);
+  }
 
-  const auto& remainingFilter = hiveTableHandle->remainingFilter();
   if (remainingFilter) {
     metadataFilter_ =
         std::make_shared<common::MetadataFilter>(*scanSpec_, *remainingFilter);
@@ -342,10 +450,33 @@ HiveDataSource::HiveDataSource(
     readerOutputType_ = ROW(std::move(names), std::move(types));
   }
 
+  if (maxCollectionElements > 0) {
+    scanSpec_->setMaxCollectionElementsRecursively(
+        maxCollectionElements, collectionOverflowPolicy);
+  }
+
+  sample_ = hiveTableHandle->sample();
+  if (sample_.has_value() &&
+      sample_->method == HiveTableSample::Method::kBernoulli) {
+    rowSampler_ =
+        std::make_unique<dwio::common::RowSampler>(sample_->percentage / 100);
+    scanSpec_->setRowSampler(rowSampler_.get());
+  }
+
   readerOpts_.setCaseSensitive(caseSensitive);
 
   rowReaderOpts_.setScanSpec(scanSpec_);
   rowReaderOpts_.setMetadataFilter(metadataFilter_);
+  if (executor_ && decodingParallelism > 1) {
+    // Does not own the executor, which belongs to the connector.
+    rowReaderOpts_.setDecodingExecutor(
+        std::shared_ptr<folly::Executor>(std::shared_ptr<void>(), executor_));
+    rowReaderOpts_.setDecodingParallelism(decodingParallelism);
+  }
+  if (executor_ && decompressAhead) {
+    rowReaderOpts_.setDecompressionExecutor(
+        std::shared_ptr<folly::Executor>(std::shared_ptr<void>(), executor_));
+  }
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
 }
@@ -394,12 +525,10 @@ bool testFilters(
       const auto& name = child->fieldName();
       if (!rowType->containsChild(name)) {
         // If missing column is partition key.
-        auto iter = partitionKey.find(name);
-        if (iter != partitionKey.end() && iter->second.has_value()) {
-          return applyPartitionFilter(
-              partitionKeysHandle[name]->dataType()->kind(),
-              iter->second.value(),
-              child->filter());
+        // Partition keys are tested by testSplitFilters() before the file
+        // is opened.
+        if (partitionKey.count(name)) {
+          continue;
         }
         // Column is missing. Most likely due to schema evolution.
         if (child->filter()->isDeterministic() &&
@@ -427,6 +556,79 @@ bool testFilters(
   return true;
 }
 
+// Returns the type to test a filter against 'stats' with, or nullptr if
+// 'stats' has no range of values.
+TypePtr statisticsType(const dwio::common::ColumnStatistics& stats) {
+  if (dynamic_cast<const dwio::common::IntegerColumnStatistics*>(&stats)) {
+    return BIGINT();
+  }
+  if (dynamic_cast<const dwio::common::DoubleColumnStatistics*>(&stats)) {
+    return DOUBLE();
+  }
+  if (dynamic_cast<const dwio::common::StringColumnStatistics*>(&stats)) {
+    return VARCHAR();
+  }
+  if (dynamic_cast<const dwio::common::BooleanColumnStatistics*>(&stats)) {
+    return BOOLEAN();
+  }
+  return nullptr;
+}
+
+// Tests the filters of 'scanSpec' against the partition keys of 'split' and
+// against the file statistics passed in 'split'. Returns false if no row of
+// the split can pass, without any I/O.
+bool testSplitFilters(
+    common::ScanSpec* scanSpec,
+    const HiveConnectorSplit& split,
+    const std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>&
+        partitionKeysHandle) {
+  for (const auto& child : scanSpec->children()) {
+    auto* filter = child->filter();
+    if (!filter || !filter->isDeterministic()) {
+      continue;
+    }
+    const auto& name = child->fieldName();
+    auto keyIt = split.partitionKeys.find(name);
+    if (keyIt != split.partitionKeys.end()) {
+      if (!keyIt->second.has_value()) {
+        if (!filter->testNull()) {
+          return false;
+        }
+        continue;
+      }
+      auto handleIt = partitionKeysHandle.find(name);
+      if (handleIt != partitionKeysHandle.end() &&
+          !applyPartitionFilter(
+              handleIt->second->dataType()->kind(),
+              keyIt->second.value(),
+              filter)) {
+        VLOG(1) << "Skipping " << split.filePath
+                << " based on the value of partition key " << name;
+        return false;
+      }
+      continue;
+    }
+
+    auto statsIt = split.columnStatistics.find(name);
+    if (statsIt == split.columnStatistics.end() || !statsIt->second) {
+      continue;
+    }
+    auto* stats = statsIt->second.get();
+    auto type = statisticsType(*stats);
+    // Without the number of rows, testFilter() can not tell that a column has
+    // no nulls or only nulls from the number of values.
+    const auto numRows = split.numRows.has_value()
+        ? split.numRows.value()
+        : std::numeric_limits<uint64_t>::max();
+    if (type && !testFilter(filter, stats, numRows, type)) {
+      VLOG(1) << "Skipping " << split.filePath
+              << " based on split statistics and filter for column " << name;
+      return false;
+    }
+  }
+  return true;
+}
+
 template <TypeKind ToKind>
 velox::variant convertFromString(const std::optional<std::string>& value) {
   if (value.has_value()) {
@@ -493,6 +695,28 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   VLOG(1) << "Adding split " << split_->toString();
 
+  // A SYSTEM sample reads or skips the whole split before any I/O.
+  if (sample_.has_value() &&
+      sample_->method == HiveTableSample::Method::kSystem &&
+      !dwio::common::RowSampler(sample_->percentage / 100, splitSampleSeed())
+           .keep()) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    ++runtimeStats_.sampledOutSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
+  // Checks the filters on partition keys and split statistics before opening
+  // the file.
+  if (!testSplitFilters(scanSpec_.get(), *split_, partitionKeys_)) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    ++runtimeStats_.prunedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
   std::unique_ptr<dwio::common::BufferedInput> input;
   if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_)) {
@@ -615,10 +839,23 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
         fileType, columnNames, nullptr, readerOpts_.isCaseSensitive());
   }
 
+  if (rowSampler_) {
+    rowSampler_->reset(splitSampleSeed());
+  }
+  rowReaderOpts_.setDecodedVectorCache(
+      dwio::common::DecodedVectorCache::getInstance(),
+      fileHandle_->uuid.id());
   rowReader_ = reader_->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
 }
 
+uint64_t HiveDataSource::splitSampleSeed() const {
+  return dwio::common::RowSampler::mixSeed(
+      sample_->seed,
+      folly::hash::hash_128_to_64(
+          folly::hash::fnv64(split_->filePath), split_->start));
+}
+
 void HiveDataSource::setFromDataSource(
     std::shared_ptr<DataSource> sourceShared) {
   auto source = dynamic_cast<HiveDataSource*>(sourceShared.get());
@@ -630,6 +867,8 @@ void HiveDataSource::setFromDataSource(
   }
   source->scanSpec_->moveAdaptationFrom(*scanSpec_);
   scanSpec_ = std::move(source->scanSpec_);
+  // The root of 'scanSpec_' points to the sampler of 'source'.
+  rowSampler_ = std::move(source->rowSampler_);
   reader_ = std::move(source->reader_);
   rowReader_ = std::move(source->rowReader_);
   // New io will be accounted on the stats of 'source'. Add the existing
@@ -638,6 +877,12 @@ void HiveDataSource::setFromDataSource(
   ioStats_ = std::move(source->ioStats_);
 }
 
+void HiveDataSource::prefetch() {
+  if (preloadFirstStripe_ && !emptySplit_ && rowReader_) {
+    rowReader_->startFirstStripe();
+  }
+}
+
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
     velox::ContinueFuture& /*future*/) {
@@ -807,6 +1052,98 @@ HiveConnector::HiveConnector(
           std::make_unique<FileHandleGenerator>(std::move(properties))),
       executor_(executor) {}
 
+namespace {
+// Adds the names of the columns read by 'expr' to 'columns'. Returns false if
+// 'expr' has lambdas or accesses fields of structs by name, as these names
+// would be renamed together with the columns.
+bool collectColumns(
+    const core::TypedExprPtr& expr,
+    std::unordered_set<std::string>& columns) {
+  if (dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    return false;
+  }
+  if (auto field =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    const auto& inputs = field->inputs();
+    if (inputs.empty() ||
+        (inputs.size() == 1 &&
+         dynamic_cast<const core::InputTypedExpr*>(inputs[0].get()))) {
+      columns.insert(field->name());
+      return true;
+    }
+    return false;
+  }
+  for (const auto& input : expr->inputs()) {
+    if (!collectColumns(input, columns)) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+std::shared_ptr<ConnectorTableHandle> HiveConnector::pushdownFilter(
+    const std::shared_ptr<ConnectorTableHandle>& tableHandle,
+    const std::unordered_map<
+        std::string,
+        std::shared_ptr<connector::ColumnHandle>>& columnHandles,
+    const core::TypedExprPtr& filter) const {
+  auto hiveTableHandle =
+      std::dynamic_pointer_cast<const HiveTableHandle>(tableHandle);
+  if (hiveTableHandle == nullptr ||
+      !hiveTableHandle->isFilterPushdownEnabled()) {
+    return nullptr;
+  }
+  std::unordered_set<std::string> columns;
+  if (!collectColumns(filter, columns)) {
+    return nullptr;
+  }
+
+  // The remaining filter refers to the columns by their names in the table.
+  std::unordered_map<std::string, std::string> mapping;
+  for (const auto& column : columns) {
+    auto it = columnHandles.find(column);
+    if (it == columnHandles.end()) {
+      return nullptr;
+    }
+    auto handle = std::dynamic_pointer_cast<const HiveColumnHandle>(it->second);
+    if (handle == nullptr ||
+        handle->columnType() == HiveColumnHandle::ColumnType::kSynthesized) {
+      return nullptr;
+    }
+    if (handle->name() != column) {
+      mapping[column] = handle->name();
+    }
+  }
+  auto remainingFilter =
+      mapping.empty() ? filter : filter->rewriteInputNames(mapping);
+  if (hiveTableHandle->remainingFilter()) {
+    remainingFilter = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            hiveTableHandle->remainingFilter(), remainingFilter},
+        "and");
+  }
+
+  SubfieldFilters subfieldFilters;
+  for (const auto& [subfield, subfieldFilter] :
+       hiveTableHandle->subfieldFilters()) {
+    std::vector<std::unique_ptr<common::Subfield::PathElement>> path;
+    for (const auto& element : subfield.path()) {
+      path.push_back(element->clone());
+    }
+    subfieldFilters.emplace(
+        common::Subfield(std::move(path)), subfieldFilter->clone());
+  }
+  return std::make_shared<HiveTableHandle>(
+      hiveTableHandle->connectorId(),
+      hiveTableHandle->tableName(),
+      true,
+      std::move(subfieldFilters),
+      remainingFilter,
+      hiveTableHandle->sample());
+}
+
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
 VELOX_REGISTER_CONNECTOR_FACTORY(
     std::make_shared<HiveHadoop2ConnectorFactory>())
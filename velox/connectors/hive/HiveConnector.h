@@ -22,6 +22,7 @@
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Reader.h"
+#include "velox/dwio/common/RowSampler.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
 #include "velox/exec/OperatorUtils.h"
@@ -89,6 +90,27 @@ class HiveColumnHandle : public ColumnHandle {
 using SubfieldFilters =
     std::unordered_map<common::Subfield, std::unique_ptr<common::Filter>>;
 
+/// TABLESAMPLE of a table scan. The same 'seed' over the same splits reads
+/// the same sample.
+struct HiveTableSample {
+  enum class Method {
+    /// Reads or skips whole splits before opening their files. The splits of
+    /// a file cover whole stripes or row groups, see planSplits(), so that
+    /// smaller splits sample at a finer grain.
+    kSystem,
+    /// Keeps each row with probability 'percentage' / 100. The rows are
+    /// sampled in the reader before any column is decoded.
+    kBernoulli,
+  };
+
+  Method method;
+  /// The percentage of the table to read, in [0, 100].
+  double percentage;
+  uint64_t seed{0};
+
+  std::string toString() const;
+};
+
 class HiveTableHandle : public ConnectorTableHandle {
  public:
   HiveTableHandle(
@@ -96,10 +118,15 @@ class HiveTableHandle : public ConnectorTableHandle {
       const std::string& tableName,
       bool filterPushdownEnabled,
       SubfieldFilters subfieldFilters,
-      const core::TypedExprPtr& remainingFilter);
+      const core::TypedExprPtr& remainingFilter,
+      std::optional<HiveTableSample> sample = std::nullopt);
 
   ~HiveTableHandle() override;
 
+  const std::string& tableName() const {
+    return tableName_;
+  }
+
   bool isFilterPushdownEnabled() const {
     return filterPushdownEnabled_;
   }
@@ -112,6 +139,10 @@ class HiveTableHandle : public ConnectorTableHandle {
     return remainingFilter_;
   }
 
+  const std::optional<HiveTableSample>& sample() const {
+    return sample_;
+  }
+
   std::string toString() const override;
 
  private:
@@ -119,6 +150,7 @@ class HiveTableHandle : public ConnectorTableHandle {
   const bool filterPushdownEnabled_;
   const SubfieldFilters subfieldFilters_;
   const core::TypedExprPtr remainingFilter_;
+  const std::optional<HiveTableSample> sample_;
 };
 
 class HiveConnector;
@@ -137,7 +169,15 @@ class HiveDataSource : public DataSource {
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
       const std::string& scanId,
       bool caseSensitive,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      int32_t decodingParallelism = 1,
+      bool biasedIntegerVectors = false,
+      int32_t minSequenceRunLength = 0,
+      bool preloadFirstStripe = true,
+      bool decompressAhead = false,
+      int32_t maxCollectionElements = 0,
+      common::CollectionOverflowPolicy collectionOverflowPolicy =
+          common::CollectionOverflowPolicy::kTruncate);
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -164,6 +204,8 @@ class HiveDataSource : public DataSource {
 
   void setFromDataSource(std::shared_ptr<DataSource> source) override;
 
+  void prefetch() override;
+
   int64_t estimatedRowSize() override;
 
   // Internal API, made public to be accessible in unit tests.  Do not use in
@@ -174,6 +216,15 @@ class HiveDataSource : public DataSource {
       const std::vector<const HiveColumnHandle*>& columnHandles,
       memory::MemoryPool* pool);
 
+  /// Moves the conjuncts of 'expr' that compare a top level column with
+  /// constants, e.g. 'a > 10' in 'a > 10 AND a + b < 5', into 'filters',
+  /// merging them with the filters already there. Returns the rest of 'expr'
+  /// or nullptr if nothing remains. Internal API, made public to be
+  /// accessible in unit tests.
+  static core::TypedExprPtr extractFiltersFromRemainingFilter(
+      const core::TypedExprPtr& expr,
+      SubfieldFilters& filters);
+
  private:
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
@@ -198,6 +249,10 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Returns the seed of the sample of 'split_', from the seed of 'sample_' and
+  // the file and range of the split.
+  uint64_t splitSampleSeed() const;
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -214,6 +269,9 @@ class HiveDataSource : public DataSource {
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<dwio::common::RowReader> rowReader_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
+  std::optional<HiveTableSample> sample_;
+  // Set on the root of 'scanSpec_' for a BERNOULLI sample.
+  std::unique_ptr<dwio::common::RowSampler> rowSampler_;
   RowTypePtr readerOutputType_;
   bool emptySplit_;
 
@@ -232,6 +290,8 @@ class HiveDataSource : public DataSource {
   memory::MemoryAllocator* const FOLLY_NONNULL allocator_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  // Whether prefetch() starts the reads of the first stripe.
+  const bool preloadFirstStripe_;
 };
 
 class HiveConnector final : public Connector {
@@ -262,9 +322,25 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->allocator(),
         connectorQueryCtx->scanId(),
         HiveConfig::isCaseSensitive(connectorQueryCtx->config()),
-        executor_);
+        executor_,
+        HiveConfig::splitDecodingParallelism(connectorQueryCtx->config()),
+        HiveConfig::biasedIntegerVectors(connectorQueryCtx->config()),
+        HiveConfig::minSequenceRunLength(connectorQueryCtx->config()),
+        HiveConfig::preloadFirstStripe(connectorQueryCtx->config()),
+        HiveConfig::decompressAhead(connectorQueryCtx->config()),
+        HiveConfig::maxCollectionElements(connectorQueryCtx->config()),
+        HiveConfig::collectionOverflowPolicy(connectorQueryCtx->config()));
   }
 
+  /// Adds 'filter' to the remaining filter of 'tableHandle'. Returns nullptr
+  /// if filter pushdown is disabled or 'filter' reads synthesized columns.
+  std::shared_ptr<ConnectorTableHandle> pushdownFilter(
+      const std::shared_ptr<ConnectorTableHandle>& tableHandle,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& columnHandles,
+      const core::TypedExprPtr& filter) const override;
+
   bool supportsSplitPreload() override {
     return true;
   }
@@ -279,7 +355,11 @@ class HiveConnector final : public Connector {
     VELOX_CHECK_NOT_NULL(
         hiveInsertHandle, "Hive connector expecting hive write handle!");
     return std::make_shared<HiveDataSink>(
-        inputType, hiveInsertHandle, connectorQueryCtx, commitStrategy);
+        inputType,
+        hiveInsertHandle,
+        connectorQueryCtx,
+        commitStrategy,
+        executor_);
   }
 
   folly::Executor* FOLLY_NULLABLE executor() const override {
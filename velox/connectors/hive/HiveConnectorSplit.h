@@ -15,10 +15,12 @@
  */
 #pragma once
 
+#include <map>
 #include <optional>
 #include <unordered_map>
 #include "velox/connectors/Connector.h"
 #include "velox/dwio/common/Options.h"
+#include "velox/dwio/common/Statistics.h"
 
 namespace facebook::velox::connector::hive {
 
@@ -30,6 +32,16 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
   const std::unordered_map<std::string, std::optional<std::string>>
       partitionKeys;
   std::optional<int32_t> tableBucketNumber;
+  /// Optional statistics of the columns of the whole file keyed on column
+  /// name, e.g. from the metastore or the manifest of a table format. The
+  /// data source tests its filters against these before opening the file.
+  std::unordered_map<
+      std::string,
+      std::shared_ptr<dwio::common::ColumnStatistics>>
+      columnStatistics;
+  /// The number of rows of the file, if known. Lets 'columnStatistics' tell
+  /// that a column has no nulls.
+  std::optional<uint64_t> numRows;
 
   HiveConnectorSplit(
       const std::string& connectorId,
@@ -39,14 +51,21 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
       uint64_t _length = std::numeric_limits<uint64_t>::max(),
       const std::unordered_map<std::string, std::optional<std::string>>&
           _partitionKeys = {},
-      std::optional<int32_t> _tableBucketNumber = std::nullopt)
+      std::optional<int32_t> _tableBucketNumber = std::nullopt,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<dwio::common::ColumnStatistics>>&
+          _columnStatistics = {},
+      std::optional<uint64_t> _numRows = std::nullopt)
       : ConnectorSplit(connectorId),
         filePath(_filePath),
         fileFormat(_fileFormat),
         start(_start),
         length(_length),
         partitionKeys(_partitionKeys),
-        tableBucketNumber(_tableBucketNumber) {}
+        tableBucketNumber(_tableBucketNumber),
+        columnStatistics(_columnStatistics),
+        numRows(_numRows) {}
 
   std::string toString() const override {
     if (tableBucketNumber.has_value()) {
@@ -59,6 +78,57 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
     }
     return fmt::format("[file {} {} - {}]", filePath, start, length);
   }
+
+  uint64_t size() const override {
+    return length == std::numeric_limits<uint64_t>::max() ? 0 : length;
+  }
+
+  /// Divides the byte range of the split into consecutive ranges. The file
+  /// readers read the stripes or row groups that start in the range of a
+  /// split, so each stripe is read by exactly one of the parts.
+  std::vector<std::shared_ptr<ConnectorSplit>> divide(
+      int32_t maxParts,
+      uint64_t minSize) const override {
+    const auto splitSize = size();
+    if (minSize == 0 || splitSize < 2 * minSize || maxParts < 2) {
+      return {};
+    }
+    const auto numParts = std::min<uint64_t>(maxParts, splitSize / minSize);
+    const auto partSize = (splitSize + numParts - 1) / numParts;
+    std::vector<std::shared_ptr<ConnectorSplit>> parts;
+    for (uint64_t offset = 0; offset < splitSize; offset += partSize) {
+      parts.push_back(std::make_shared<HiveConnectorSplit>(
+          connectorId,
+          filePath,
+          fileFormat,
+          start + offset,
+          std::min(partSize, splitSize - offset),
+          partitionKeys,
+          tableBucketNumber,
+          columnStatistics,
+          numRows));
+    }
+    return parts;
+  }
+
+  /// The files are treated as immutable, so the data is identified by the
+  /// byte range of the file, the partition keys and the bucket.
+  std::optional<std::string> cacheKey() const override {
+    std::map<std::string, std::optional<std::string>> sortedKeys(
+        partitionKeys.begin(), partitionKeys.end());
+    auto key = fmt::format(
+        "{}:{}:{}:{}:{}",
+        connectorId,
+        filePath,
+        start,
+        length,
+        tableBucketNumber.has_value() ? tableBucketNumber.value() : -1);
+    for (const auto& [name, value] : sortedKeys) {
+      key += fmt::format(
+          ":{}={}", name, value.has_value() ? value.value() : "<null>");
+    }
+    return key;
+  }
 };
 
 } // namespace facebook::velox::connector::hive
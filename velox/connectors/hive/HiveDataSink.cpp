@@ -21,11 +21,14 @@
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/exec/SortBuffer.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include <numeric>
+
 using namespace facebook::velox::dwrf;
 using WriterConfig = facebook::velox::dwrf::Config;
 
@@ -48,6 +51,72 @@ std::vector<column_index_t> getPartitionChannels(
   return channels;
 }
 
+// Returns the channels of 'columns' in 'inputType'. These must not be
+// partition keys.
+std::vector<column_index_t> getChannels(
+    const RowTypePtr& inputType,
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle,
+    const std::vector<std::string>& columns) {
+  std::vector<column_index_t> channels;
+  channels.reserve(columns.size());
+  for (const auto& column : columns) {
+    const auto channel = inputType->getChildIdx(column);
+    VELOX_USER_CHECK(
+        !insertTableHandle->inputColumns()[channel]->isPartitionKey(),
+        "Partition key {} can't be a bucketing or sorting column",
+        column);
+    channels.push_back(channel);
+  }
+  return channels;
+}
+
+std::unique_ptr<HivePartitionFunction> makeBucketFunction(
+    const RowTypePtr& inputType,
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  const auto& bucketProperty = insertTableHandle->bucketProperty();
+  if (bucketProperty == nullptr) {
+    return nullptr;
+  }
+  const auto bucketCount = bucketProperty->bucketCount();
+  // Maps each bucket to itself.
+  std::vector<int> bucketToPartition(bucketCount);
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  return std::make_unique<HivePartitionFunction>(
+      bucketCount,
+      std::move(bucketToPartition),
+      getChannels(
+          inputType, insertTableHandle, bucketProperty->bucketedBy()));
+}
+
+std::vector<column_index_t> getSortChannels(
+    const RowTypePtr& inputType,
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  const auto& bucketProperty = insertTableHandle->bucketProperty();
+  if (bucketProperty == nullptr) {
+    return {};
+  }
+  std::vector<std::string> columns;
+  for (const auto& sortingColumn : bucketProperty->sortedBy()) {
+    columns.push_back(sortingColumn.sortColumn());
+  }
+  return getChannels(inputType, insertTableHandle, columns);
+}
+
+std::vector<CompareFlags> getSortCompareFlags(
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  const auto& bucketProperty = insertTableHandle->bucketProperty();
+  if (bucketProperty == nullptr) {
+    return {};
+  }
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& sortingColumn : bucketProperty->sortedBy()) {
+    const auto& sortOrder = sortingColumn.sortOrder();
+    compareFlags.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+  }
+  return compareFlags;
+}
+
 std::string makePartitionDirectory(
     const std::string& tableDirectory,
     const std::optional<std::string>& partitionSubdirectory) {
@@ -61,13 +130,18 @@ std::string makeUuid() {
   return boost::lexical_cast<std::string>(boost::uuids::random_generator()());
 }
 
+// The number of rows in a batch of sorted rows written to a file. Matches the
+// default preferred output batch size.
+constexpr uint32_t kSortedWriteBatchRows = 1024;
+
 } // namespace
 
 HiveDataSink::HiveDataSink(
     RowTypePtr inputType,
     std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
     const ConnectorQueryCtx* connectorQueryCtx,
-    CommitStrategy commitStrategy)
+    CommitStrategy commitStrategy,
+    folly::Executor* executor)
     : inputType_(std::move(inputType)),
       insertTableHandle_(std::move(insertTableHandle)),
       connectorQueryCtx_(connectorQueryCtx),
@@ -80,49 +154,63 @@ HiveDataSink::HiveDataSink(
                                             HiveConfig::maxPartitionsPerWriters(
                                                 connectorQueryCtx_->config()),
                                             connectorQueryCtx_->memoryPool())
-                                      : nullptr) {}
+                                      : nullptr),
+      numBuckets_(
+          insertTableHandle_->isBucketed()
+              ? insertTableHandle_->bucketProperty()->bucketCount()
+              : 1),
+      bucketFunction_(makeBucketFunction(inputType_, insertTableHandle_)),
+      sortChannels_(getSortChannels(inputType_, insertTableHandle_)),
+      sortCompareFlags_(getSortCompareFlags(insertTableHandle_)),
+      maxWriterMemory_(
+          HiveConfig::maxWriterMemory(connectorQueryCtx_->config())),
+      maxTargetFileSize_(
+          HiveConfig::maxTargetFileSize(connectorQueryCtx_->config())),
+      encodingParallelism_(HiveConfig::writerEncodingParallelism(
+          connectorQueryCtx_->config())),
+      encodingExecutor_(encodingParallelism_ > 1 ? executor : nullptr) {}
 
 void HiveDataSink::appendData(RowVectorPtr input) {
-  // Write to unpartitioned table.
-  if (partitionChannels_.empty()) {
-    ensureSingleWriter();
+  ++numInputs_;
+  writeInput(input);
+  ensureWriterMemoryBudget();
+}
 
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+void HiveDataSink::writeInput(const RowVectorPtr& input) {
+  // Write to unpartitioned and unbucketed table.
+  if (!isPartitioned() && !isBucketed()) {
+    ensureWriter(0);
+    write(0, input);
     return;
   }
 
-  // Write to partitioned table.
-  partitionIdGenerator_->run(input, partitionIds_);
-
-  ensurePartitionWriters();
-
   for (column_index_t i = 0; i < input->childrenSize(); i++) {
     input->childAt(i)->loadedVector();
   }
 
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  // Write to partitioned or bucketed table.
+  computeWriterIds(input);
 
-  // All inputs belong to a single partition.
-  if (numPartitions == 1) {
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+  // All inputs belong to a single partition of an unbucketed table.
+  if (!isBucketed() && partitionIdGenerator_->numPartitions() == 1) {
+    ensureWriter(0);
+    write(0, input);
     return;
   }
 
-  computePartitionRowCountsAndIndices();
+  computeWriterRowCountsAndIndices();
 
-  for (auto id = 0; id < numPartitions; id++) {
-    vector_size_t partitionSize = partitionSizes_[id];
-    if (partitionSize == 0) {
+  for (auto id = 0; id < writerSizes_.size(); id++) {
+    const vector_size_t writerSize = writerSizes_[id];
+    if (writerSize == 0) {
       continue;
     }
 
-    RowVectorPtr writerInput = partitionSize == input->size()
+    RowVectorPtr writerInput = writerSize == input->size()
         ? input
-        : exec::wrap(partitionSize, partitionRows_[id], input);
-    writers_[id]->write(writerInput);
-    writerInfo_[id]->numWrittenRows += partitionSize;
+        : exec::wrap(writerSize, writerRows_[id], input);
+    ensureWriter(id);
+    write(id, writerInput);
   }
 }
 
@@ -132,6 +220,16 @@ std::vector<std::string> HiveDataSink::finish() const {
 
   for (const auto& info : writerInfo_) {
     if (info) {
+      auto fileWriteInfos = folly::dynamic::array();
+      for (const auto& fileNames : info->fileNames) {
+        // clang-format off
+        fileWriteInfos.push_back(
+          folly::dynamic::object
+            ("writeFileName", fileNames.writeFileName)
+            ("targetFileName", fileNames.targetFileName)
+            ("fileSize", 0));
+        // clang-format on
+      }
       // clang-format off
       auto partitionUpdateJson = folly::toJson(
        folly::dynamic::object
@@ -141,11 +239,7 @@ std::vector<std::string> HiveDataSink::finish() const {
               info->writerParameters.updateMode()))
           ("writePath", info->writerParameters.writeDirectory())
           ("targetPath", info->writerParameters.targetDirectory())
-          ("fileWriteInfos", folly::dynamic::array(
-            folly::dynamic::object
-              ("writeFileName", info->writerParameters.writeFileName())
-              ("targetFileName", info->writerParameters.targetFileName())
-              ("fileSize", 0)))
+          ("fileWriteInfos", std::move(fileWriteInfos))
           ("rowCount", info->numWrittenRows)
          // TODO(gaoge): track and send the fields when inMemoryDataSizeInBytes, onDiskDataSizeInBytes
          // and containsNumberedFileNames are needed at coordinator when file_renaming_enabled are turned on.
@@ -160,91 +254,301 @@ std::vector<std::string> HiveDataSink::finish() const {
 }
 
 void HiveDataSink::close() {
-  for (const auto& writer : writers_) {
-    writer->close();
+  for (auto id = 0; id < writers_.size(); id++) {
+    if (writers_[id] == nullptr) {
+      continue;
+    }
+    if (isSorted()) {
+      writeSorted(id);
+    }
+    writers_[id]->close();
   }
 }
 
-void HiveDataSink::ensureSingleWriter() {
-  if (writers_.empty()) {
-    appendWriter(std::nullopt);
-  }
+std::unordered_map<std::string, RuntimeCounter> HiveDataSink::runtimeStats()
+    const {
+  return {
+      {"numWriterFlushes", RuntimeCounter(numFlushes_)},
+      {"numWriterRollovers", RuntimeCounter(numRollovers_)}};
 }
 
-void HiveDataSink::ensurePartitionWriters() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
-  const auto numWriters = writers_.size();
-
-  VELOX_CHECK_LE(numWriters, numPartitions);
+uint32_t HiveDataSink::numWriterIds() const {
+  const auto numPartitions =
+      isPartitioned() ? partitionIdGenerator_->numPartitions() : 1;
+  return numPartitions * numBuckets_;
+}
 
-  if (numWriters < numPartitions) {
-    writers_.reserve(numPartitions);
-    writerInfo_.reserve(numPartitions);
-    for (auto id = numWriters; id < numPartitions; id++) {
-      appendWriter(partitionIdGenerator_->partitionName(id));
+void HiveDataSink::ensureWriter(uint32_t writerId) {
+  if (writers_.size() <= writerId) {
+    const auto numWriterIds = std::max(writerId + 1, this->numWriterIds());
+    writers_.resize(numWriterIds);
+    writerInfo_.resize(numWriterIds);
+    lastInputs_.resize(numWriterIds);
+    if (isSorted()) {
+      sortPools_.resize(numWriterIds);
+      sortBuffers_.resize(numWriterIds);
     }
   }
+  if (writers_[writerId] == nullptr) {
+    createWriter(writerId);
+  }
 }
 
-void HiveDataSink::appendWriter(
-    const std::optional<std::string>& partitionName) {
+void HiveDataSink::createWriter(uint32_t writerId) {
+  const auto bucketId = isBucketed()
+      ? std::make_optional<uint32_t>(writerId % numBuckets_)
+      : std::nullopt;
+  if (writerInfo_[writerId] == nullptr) {
+    const auto partitionName = isPartitioned()
+        ? std::make_optional(
+              partitionIdGenerator_->partitionName(writerId / numBuckets_))
+        : std::nullopt;
+    writerInfo_[writerId] = std::make_shared<HiveWriterInfo>(
+        *getWriterParameters(partitionName, bucketId));
+  } else {
+    // The writer was closed by rollWriter().
+    auto& fileNames = writerInfo_[writerId]->fileNames;
+    fileNames.push_back(makeFileNames(bucketId, fileNames.size()));
+  }
+  const auto& writerInfo = *writerInfo_[writerId];
+
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
   facebook::velox::dwrf::WriterOptions options;
   options.config = config;
   options.schema = inputType_;
+  if (encodingExecutor_) {
+    // Does not own the executor, which belongs to the connector.
+    options.encodingExecutor = std::shared_ptr<folly::Executor>(
+        std::shared_ptr<void>(), encodingExecutor_);
+    options.encodingParallelism = encodingParallelism_;
+  }
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
-  auto writerParameters = getWriterParameters(partitionName);
-  auto writePath = fs::path(writerParameters->writeDirectory()) /
-      writerParameters->writeFileName();
+  auto writePath = fs::path(writerInfo.writerParameters.writeDirectory()) /
+      writerInfo.fileNames.back().writeFileName;
 
   auto sink = dwio::common::DataSink::create(writePath);
-  writers_.push_back(std::make_unique<Writer>(
-      options, std::move(sink), *connectorQueryCtx_->connectorMemoryPool()));
-  writerInfo_.push_back(std::make_shared<HiveWriterInfo>(*writerParameters));
+  writers_[writerId] = std::make_unique<Writer>(
+      options, std::move(sink), *connectorQueryCtx_->connectorMemoryPool());
+
+  if (!isSorted()) {
+    return;
+  }
+  // Each sort buffer spills to its own files.
+  std::optional<exec::SpillConfig> spillConfig;
+  if (connectorQueryCtx_->spillConfig() != nullptr) {
+    spillConfig = *connectorQueryCtx_->spillConfig();
+    spillConfig->filePath =
+        fmt::format("{}-writer-{}", spillConfig->filePath, writerId);
+  }
+  sortPools_[writerId] =
+      connectorQueryCtx_->connectorMemoryPool()->addLeafChild(
+          fmt::format("sort.{}", writerId));
+  sortBuffers_[writerId] = std::make_unique<exec::SortBuffer>(
+      inputType_,
+      sortChannels_,
+      sortCompareFlags_,
+      kSortedWriteBatchRows,
+      sortPools_[writerId].get(),
+      std::move(spillConfig));
+}
+
+void HiveDataSink::write(uint32_t writerId, const RowVectorPtr& input) {
+  if (isSorted()) {
+    sortBuffers_[writerId]->addInput(input);
+  } else {
+    writers_[writerId]->write(input);
+  }
+  writerInfo_[writerId]->numWrittenRows += input->size();
+  lastInputs_[writerId] = numInputs_;
+  maybeRollWriterAtTargetSize(writerId);
+}
+
+void HiveDataSink::writeSorted(uint32_t writerId) {
+  auto& sortBuffer = sortBuffers_[writerId];
+  sortBuffer->noMoreInput();
+  while (auto output = sortBuffer->getOutput()) {
+    writers_[writerId]->write(output);
+  }
+  // Frees the buffered rows before the next writer is flushed.
+  sortBuffer.reset();
+}
+
+int64_t HiveDataSink::writerMemoryUsage(uint32_t writerId) const {
+  if (isSorted()) {
+    // The rows are only written at close.
+    return sortPools_[writerId]->getCurrentBytes();
+  }
+  return writers_[writerId]->getContext().getTotalMemoryUsage();
+}
+
+void HiveDataSink::ensureWriterMemoryBudget() {
+  if (maxWriterMemory_ == 0) {
+    return;
+  }
+  auto* pool = connectorQueryCtx_->connectorMemoryPool();
+  int64_t usage = pool->getCurrentBytes();
+  if (usage <= maxWriterMemory_) {
+    return;
+  }
+
+  // Frees the memory of the largest writers first.
+  std::vector<std::pair<int64_t, uint32_t>> writerUsages;
+  for (auto id = 0; id < writers_.size(); id++) {
+    if (writers_[id] != nullptr) {
+      writerUsages.emplace_back(writerMemoryUsage(id), id);
+    }
+  }
+  std::sort(writerUsages.begin(), writerUsages.end(), std::greater<>());
+
+  for (const auto& [writerUsage, id] : writerUsages) {
+    if (usage <= maxWriterMemory_) {
+      return;
+    }
+    if (writerUsage == 0) {
+      break;
+    }
+    if (isSorted()) {
+      auto& sortBuffer = sortBuffers_[id];
+      if (!sortBuffer->canSpill()) {
+        continue;
+      }
+      sortBuffer->spill(0, 0);
+    } else {
+      if (writers_[id]->getContext().stripeRowCount == 0) {
+        continue;
+      }
+      writers_[id]->flush();
+    }
+    ++numFlushes_;
+    usage = pool->getCurrentBytes();
+  }
+
+  // A bucketed table has a single file per bucket, so its writers can't roll.
+  if (isBucketed()) {
+    return;
+  }
+  for (const auto& [writerUsage, id] : writerUsages) {
+    if (usage <= maxWriterMemory_) {
+      return;
+    }
+    if (lastInputs_[id] == numInputs_) {
+      continue;
+    }
+    rollWriter(id);
+    usage = pool->getCurrentBytes();
+  }
+}
+
+void HiveDataSink::rollWriter(uint32_t writerId) {
+  writers_[writerId]->close();
+  writers_[writerId].reset();
+  ++numRollovers_;
 }
 
-void HiveDataSink::computePartitionRowCountsAndIndices() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
-  const auto numRows = partitionIds_.size();
-
-  partitionSizes_.resize(numPartitions);
-  std::fill(partitionSizes_.begin(), partitionSizes_.end(), 0);
-
-  partitionRows_.resize(numPartitions, nullptr);
-  rawPartitionRows_.resize(numPartitions);
-  for (auto id = 0; id < numPartitions; id++) {
-    if (partitionRows_[id] == nullptr ||
-        partitionRows_[id]->capacity() < numRows * sizeof(vector_size_t)) {
-      partitionRows_[id] =
-          allocateIndices(numRows, connectorQueryCtx_->memoryPool());
-      rawPartitionRows_[id] = partitionRows_[id]->asMutable<vector_size_t>();
+void HiveDataSink::maybeRollWriterAtTargetSize(uint32_t writerId) {
+  // A bucketed table has a single file per bucket, and a sorted table is
+  // bucketed.
+  if (maxTargetFileSize_ == 0 || isBucketed()) {
+    return;
+  }
+  const auto& writer = *writers_[writerId];
+  const auto& context = writer.getContext();
+  // The flushed stripes and the estimated size of the current stripe.
+  const uint64_t fileSize = writer.getSink().size() +
+      context.getEstimatedStripeSize(context.stripeRawSize);
+  if (fileSize >= maxTargetFileSize_) {
+    rollWriter(writerId);
+  }
+}
+
+void HiveDataSink::computeWriterIds(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  if (isPartitioned()) {
+    partitionIdGenerator_->run(input, writerIds_);
+  } else {
+    writerIds_.resize(numRows);
+    std::fill(writerIds_.begin(), writerIds_.end(), 0);
+  }
+  if (isBucketed()) {
+    bucketFunction_->partition(*input, bucketIds_);
+    for (auto row = 0; row < numRows; row++) {
+      writerIds_[row] = writerIds_[row] * numBuckets_ + bucketIds_[row];
     }
   }
+}
 
+void HiveDataSink::computeWriterRowCountsAndIndices() {
+  const auto numWriterIds = this->numWriterIds();
+  const auto numRows = writerIds_.size();
+
+  writerSizes_.resize(numWriterIds);
+  std::fill(writerSizes_.begin(), writerSizes_.end(), 0);
   for (auto row = 0; row < numRows; row++) {
-    uint64_t id = partitionIds_[row];
-    rawPartitionRows_[id][partitionSizes_[id]] = row;
-    partitionSizes_[id]++;
+    writerSizes_[writerIds_[row]]++;
+  }
+
+  // Allocates the row indices only for the writers with rows since there may
+  // be many buckets.
+  writerRows_.resize(numWriterIds, nullptr);
+  rawWriterRows_.resize(numWriterIds);
+  for (auto id = 0; id < numWriterIds; id++) {
+    const auto writerSize = writerSizes_[id];
+    if (writerSize == 0) {
+      continue;
+    }
+    if (writerRows_[id] == nullptr ||
+        writerRows_[id]->capacity() < writerSize * sizeof(vector_size_t)) {
+      writerRows_[id] =
+          allocateIndices(writerSize, connectorQueryCtx_->memoryPool());
+      rawWriterRows_[id] = writerRows_[id]->asMutable<vector_size_t>();
+    }
+    writerRows_[id]->setSize(writerSize * sizeof(vector_size_t));
+    // Recounted below while filling in the row indices.
+    writerSizes_[id] = 0;
   }
 
-  for (auto id = 0; id < numPartitions; id++) {
-    partitionRows_[id]->setSize(partitionSizes_[id] * sizeof(vector_size_t));
+  for (auto row = 0; row < numRows; row++) {
+    const uint64_t id = writerIds_[row];
+    rawWriterRows_[id][writerSizes_[id]] = row;
+    writerSizes_[id]++;
   }
 }
 
 std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
-    const std::optional<std::string>& partition) const {
+    const std::optional<std::string>& partition,
+    std::optional<uint32_t> bucketId) const {
   auto updateMode = getUpdateMode();
 
+  auto fileNames = makeFileNames(bucketId, 0);
+
+  return std::make_shared<HiveWriterParameters>(
+      updateMode,
+      partition,
+      std::move(fileNames.targetFileName),
+      makePartitionDirectory(
+          insertTableHandle_->locationHandle()->targetPath(), partition),
+      std::move(fileNames.writeFileName),
+      makePartitionDirectory(
+          insertTableHandle_->locationHandle()->writePath(), partition));
+}
+
+HiveWriterInfo::FileNames HiveDataSink::makeFileNames(
+    std::optional<uint32_t> bucketId,
+    uint32_t fileSequence) const {
+  // Hive finds the bucket of a file by the number its name starts with.
+  const auto bucketPrefix = bucketId.has_value()
+      ? fmt::format("{:06}_", bucketId.value())
+      : std::string();
   std::string targetFileName;
   std::string writeFileName;
   switch (commitStrategy_) {
     case CommitStrategy::kNoCommit: {
       targetFileName = fmt::format(
-          "{}_{}_{}",
+          "{}{}_{}_{}",
+          bucketPrefix,
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
           makeUuid());
@@ -253,10 +557,11 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
     }
     case CommitStrategy::kTaskCommit: {
       targetFileName = fmt::format(
-          "{}_{}_{}",
+          "{}{}_{}_{}",
+          bucketPrefix,
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
-          0);
+          fileSequence);
       writeFileName =
           fmt::format(".tmp.velox.{}_{}", targetFileName, makeUuid());
       break;
@@ -264,16 +569,7 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
     default:
       VELOX_UNREACHABLE();
   }
-
-  return std::make_shared<HiveWriterParameters>(
-      updateMode,
-      partition,
-      targetFileName,
-      makePartitionDirectory(
-          insertTableHandle_->locationHandle()->targetPath(), partition),
-      writeFileName,
-      makePartitionDirectory(
-          insertTableHandle_->locationHandle()->writePath(), partition));
+  return {std::move(writeFileName), std::move(targetFileName)};
 }
 
 HiveWriterParameters::UpdateMode HiveDataSink::getUpdateMode() const {
@@ -16,12 +16,17 @@
 #pragma once
 
 #include "velox/connectors/Connector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/PartitionIdGenerator.h"
 
 namespace facebook::velox::dwrf {
 class Writer;
 }
 
+namespace facebook::velox::exec {
+class SortBuffer;
+}
+
 namespace facebook::velox::connector::hive {
 class HiveColumnHandle;
 
@@ -62,6 +67,61 @@ class LocationHandle {
   const TableType tableType_;
 };
 
+/// A column the files of a bucketed Hive table are sorted on.
+class HiveSortingColumn {
+ public:
+  HiveSortingColumn(std::string sortColumn, core::SortOrder sortOrder)
+      : sortColumn_(std::move(sortColumn)), sortOrder_(std::move(sortOrder)) {}
+
+  const std::string& sortColumn() const {
+    return sortColumn_;
+  }
+
+  const core::SortOrder& sortOrder() const {
+    return sortOrder_;
+  }
+
+ private:
+  const std::string sortColumn_;
+  const core::SortOrder sortOrder_;
+};
+
+/// Bucketing properties of the Hive table to be written. The rows of each
+/// partition are distributed over 'bucketCount' buckets by the Hive hash of
+/// the 'bucketedBy' columns. Each bucket is written to its own files. If
+/// 'sortedBy' is not empty, the rows of each file are sorted on these columns.
+class HiveBucketProperty {
+ public:
+  HiveBucketProperty(
+      int32_t bucketCount,
+      std::vector<std::string> bucketedBy,
+      std::vector<HiveSortingColumn> sortedBy = {})
+      : bucketCount_(bucketCount),
+        bucketedBy_(std::move(bucketedBy)),
+        sortedBy_(std::move(sortedBy)) {
+    VELOX_USER_CHECK_GT(bucketCount_, 0, "Bucket count must be positive");
+    VELOX_USER_CHECK(
+        !bucketedBy_.empty(), "A bucketed table needs bucketing columns");
+  }
+
+  int32_t bucketCount() const {
+    return bucketCount_;
+  }
+
+  const std::vector<std::string>& bucketedBy() const {
+    return bucketedBy_;
+  }
+
+  const std::vector<HiveSortingColumn>& sortedBy() const {
+    return sortedBy_;
+  }
+
+ private:
+  const int32_t bucketCount_;
+  const std::vector<std::string> bucketedBy_;
+  const std::vector<HiveSortingColumn> sortedBy_;
+};
+
 /**
  * Represents a request for Hive write.
  */
@@ -69,9 +129,11 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
   HiveInsertTableHandle(
       std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns,
-      std::shared_ptr<const LocationHandle> locationHandle)
+      std::shared_ptr<const LocationHandle> locationHandle,
+      std::shared_ptr<const HiveBucketProperty> bucketProperty = nullptr)
       : inputColumns_(std::move(inputColumns)),
-        locationHandle_(std::move(locationHandle)) {}
+        locationHandle_(std::move(locationHandle)),
+        bucketProperty_(std::move(bucketProperty)) {}
 
   virtual ~HiveInsertTableHandle() = default;
 
@@ -84,13 +146,30 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
     return locationHandle_;
   }
 
+  /// Returns the bucketing properties or nullptr if the table is not
+  /// bucketed.
+  const std::shared_ptr<const HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
   bool isPartitioned() const;
 
+  bool isBucketed() const {
+    return bucketProperty_ != nullptr;
+  }
+
   bool isInsertTable() const;
 
+  /// Each writer driver writes its own files. A bucketed table has one file
+  /// per bucket, so it is written by a single driver.
+  bool supportsMultiThreading() const override {
+    return !isBucketed();
+  }
+
  private:
   const std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns_;
   const std::shared_ptr<const LocationHandle> locationHandle_;
+  const std::shared_ptr<const HiveBucketProperty> bucketProperty_;
 };
 
 /// Parameters for Hive writers.
@@ -177,10 +256,23 @@ class HiveWriterParameters {
 };
 
 struct HiveWriterInfo {
+  struct FileNames {
+    std::string writeFileName;
+    std::string targetFileName;
+  };
+
   explicit HiveWriterInfo(HiveWriterParameters parameters)
-      : writerParameters(std::move(parameters)) {}
+      : writerParameters(std::move(parameters)),
+        fileNames{
+            {writerParameters.writeFileName(),
+             writerParameters.targetFileName()}} {}
 
   const HiveWriterParameters writerParameters;
+  /// The names of the files written so far, in write order. Starts with the
+  /// file of 'writerParameters'. A writer that is closed under memory pressure
+  /// or at the target file size and then gets more rows rolls over to a new
+  /// file in the same directory.
+  std::vector<FileNames> fileNames;
   vector_size_t numWrittenRows = 0;
 };
 
@@ -190,7 +282,8 @@ class HiveDataSink : public DataSink {
       RowTypePtr inputType,
       std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
       const ConnectorQueryCtx* connectorQueryCtx,
-      CommitStrategy commitStrategy);
+      CommitStrategy commitStrategy,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
   void appendData(RowVectorPtr input) override;
 
@@ -198,23 +291,77 @@ class HiveDataSink : public DataSink {
 
   void close() override;
 
+  /// Returns the number of stripe flushes done to stay within the writer
+  /// memory budget and the number of writer rollovers done for the budget
+  /// or the target file size.
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() const override;
+
  private:
-  // Pass 0 as partitionId when creating the single writer for an
-  // unpartitioned table.
-  void appendWriter(const std::optional<std::string>& partitionName);
+  bool isPartitioned() const {
+    return partitionIdGenerator_ != nullptr;
+  }
+
+  bool isBucketed() const {
+    return bucketFunction_ != nullptr;
+  }
+
+  bool isSorted() const {
+    return !sortChannels_.empty();
+  }
 
-  // Make sure to create the one writer for unpartitioned table.
-  void ensureSingleWriter();
+  // Returns the number of writer ids. A writer id is the partition id times
+  // the number of buckets plus the bucket. An unpartitioned table has one
+  // partition and an unbucketed table has one bucket.
+  uint32_t numWriterIds() const;
 
-  // Make sure every partition has one writer created for it.
-  void ensurePartitionWriters();
+  // Creates the writer of 'writerId' if it has not been created yet.
+  void ensureWriter(uint32_t writerId);
+
+  // Creates the writer and, for a sorted table, the sort buffer of 'writerId'.
+  void createWriter(uint32_t writerId);
+
+  // Writes 'input' to the writers of its partitions and buckets.
+  void writeInput(const RowVectorPtr& input);
+
+  // Writes 'input' to the writer of 'writerId' or adds it to the sort buffer
+  // of the writer for a sorted table.
+  void write(uint32_t writerId, const RowVectorPtr& input);
+
+  // Writes the rows buffered for 'writerId' to its writer in sort order.
+  void writeSorted(uint32_t writerId);
+
+  // Returns the memory used by the writer of 'writerId'.
+  int64_t writerMemoryUsage(uint32_t writerId) const;
+
+  // Flushes the stripes of the largest writers and then closes the writers
+  // without rows in the last input until the memory usage of the sink is
+  // within 'maxWriterMemory_'. The closed writers roll over to new files if
+  // they get more rows. No-op if there is no budget.
+  void ensureWriterMemoryBudget();
+
+  // Closes the writer of 'writerId'. Its next rows go to a new file.
+  void rollWriter(uint32_t writerId);
+
+  // Closes the writer of 'writerId' if its file has reached
+  // 'maxTargetFileSize_'. No-op for a bucketed table.
+  void maybeRollWriterAtTargetSize(uint32_t writerId);
+
+  // Computes the writer id of every row of 'input' into 'writerIds_'.
+  void computeWriterIds(const RowVectorPtr& input);
 
   // Compute the number of rows as well as the actual row indices corresponding
-  // to every partition ID, based on the ID labeling of partitionIds_.
-  void computePartitionRowCountsAndIndices();
+  // to every writer ID, based on the ID labeling of writerIds_.
+  void computeWriterRowCountsAndIndices();
 
   std::shared_ptr<const HiveWriterParameters> getWriterParameters(
-      const std::optional<std::string>& partition) const;
+      const std::optional<std::string>& partition,
+      std::optional<uint32_t> bucketId) const;
+
+  // Returns the write and target names of the 'fileSequence'th file of a
+  // writer.
+  HiveWriterInfo::FileNames makeFileNames(
+      std::optional<uint32_t> bucketId,
+      uint32_t fileSequence) const;
 
   HiveWriterParameters::UpdateMode getUpdateMode() const;
 
@@ -224,19 +371,51 @@ class HiveDataSink : public DataSink {
   const CommitStrategy commitStrategy_;
   const std::vector<column_index_t> partitionChannels_;
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
-
-  // Below are structures for partitions from all inputs. writerInfo_ and
-  // writers_ are both indexed by partitionId.
+  // The number of buckets, 1 if the table is not bucketed.
+  const uint32_t numBuckets_;
+  // Computes the bucket of each row. Null if the table is not bucketed.
+  const std::unique_ptr<HivePartitionFunction> bucketFunction_;
+  // The channels and orders of the columns to sort the rows of each file on.
+  // Empty if the table is not sorted.
+  const std::vector<column_index_t> sortChannels_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  // The memory budget of all writers of the sink in bytes. 0 if unlimited.
+  const int64_t maxWriterMemory_;
+  // The size in bytes at which a file is closed and the next rows of its
+  // writer go to a new file. 0 if unlimited.
+  const uint64_t maxTargetFileSize_;
+  // The max number of columns of a batch encoded at a time and the
+  // connector's executor for encoding these in parallel. The executor is null
+  // if the columns are encoded on the driver thread.
+  const int32_t encodingParallelism_;
+  folly::Executor* FOLLY_NULLABLE const encodingExecutor_;
+
+  // Below are structures for writers from all inputs. writerInfo_, writers_,
+  // sortPools_ and sortBuffers_ are indexed by writer id and have nullptr for
+  // the writer ids without rows so far. sortPools_ and sortBuffers_ are only
+  // filled for a sorted table.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
   std::vector<std::unique_ptr<dwrf::Writer>> writers_;
-
-  // Below are structures updated when processing current input. partitionIds_
-  // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
-  // partitionSizes_ are indexed by partitionId.
-  raw_vector<uint64_t> partitionIds_;
-  std::vector<BufferPtr> partitionRows_;
-  std::vector<vector_size_t*> rawPartitionRows_;
-  std::vector<vector_size_t> partitionSizes_;
+  std::vector<std::shared_ptr<memory::MemoryPool>> sortPools_;
+  std::vector<std::unique_ptr<exec::SortBuffer>> sortBuffers_;
+  // The number of the last appendData() call with rows for each writer id.
+  std::vector<uint64_t> lastInputs_;
+
+  // The number of appendData() calls so far.
+  uint64_t numInputs_{0};
+  // The number of stripes flushed to stay within 'maxWriterMemory_' and of
+  // writers closed for 'maxWriterMemory_' or 'maxTargetFileSize_'.
+  uint64_t numFlushes_{0};
+  uint64_t numRollovers_{0};
+
+  // Below are structures updated when processing current input. writerIds_
+  // and bucketIds_ are indexed by the row of input_. writerRows_,
+  // rawWriterRows_ and writerSizes_ are indexed by writer id.
+  raw_vector<uint64_t> writerIds_;
+  std::vector<uint32_t> bucketIds_;
+  std::vector<BufferPtr> writerRows_;
+  std::vector<vector_size_t*> rawWriterRows_;
+  std::vector<vector_size_t> writerSizes_;
 };
 
 } // namespace facebook::velox::connector::hive
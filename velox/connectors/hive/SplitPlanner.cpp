@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/SplitPlanner.h"
+
+namespace facebook::velox::connector::hive {
+namespace {
+
+std::shared_ptr<HiveConnectorSplit> makeSplit(
+    const std::string& connectorId,
+    const HiveSplitFile& file,
+    uint64_t start,
+    uint64_t length) {
+  return std::make_shared<HiveConnectorSplit>(
+      connectorId,
+      file.filePath,
+      file.fileFormat,
+      start,
+      length,
+      file.partitionKeys,
+      file.tableBucketNumber);
+}
+
+// Cuts 'file' into about equal splits of at most about 'targetSplitSize'
+// bytes and adds each as a group of its own to 'groups'.
+void splitFile(
+    const std::string& connectorId,
+    const HiveSplitFile& file,
+    uint64_t targetSplitSize,
+    std::vector<std::vector<std::shared_ptr<HiveConnectorSplit>>>& groups) {
+  const auto& sections = file.sections;
+  uint64_t totalSize = 0;
+  for (const auto& section : sections) {
+    totalSize += section.length;
+  }
+  const auto numSplits = std::max<uint64_t>(
+      1, (totalSize + targetSplitSize - 1) / targetSplitSize);
+  // The first split starts at 0 and the last one extends to the end of the
+  // file so that the splits cover the sections regardless of where their
+  // offsets are.
+  uint64_t start = 0;
+  uint64_t cumulativeSize = 0;
+  uint64_t splitIndex = 0;
+  for (auto i = 0; i < sections.size(); ++i) {
+    cumulativeSize += sections[i].length;
+    if (i + 1 == sections.size()) {
+      groups.push_back({makeSplit(
+          connectorId,
+          file,
+          start,
+          std::max(file.fileSize, sections[i].offset + 1) - start)});
+      break;
+    }
+    // Cuts after the section that brings the cumulative size to the next
+    // multiple of the size of an equal split.
+    if (cumulativeSize * numSplits >= (splitIndex + 1) * totalSize) {
+      const auto end = sections[i + 1].offset;
+      groups.push_back({makeSplit(connectorId, file, start, end - start)});
+      start = end;
+      while (cumulativeSize * numSplits >= (splitIndex + 1) * totalSize) {
+        ++splitIndex;
+      }
+    }
+  }
+}
+
+} // namespace
+
+std::vector<std::vector<std::shared_ptr<HiveConnectorSplit>>> planSplits(
+    const std::string& connectorId,
+    const std::vector<HiveSplitFile>& files,
+    uint64_t targetSplitSize) {
+  VELOX_CHECK_GT(targetSplitSize, 0);
+  std::vector<std::vector<std::shared_ptr<HiveConnectorSplit>>> groups;
+  std::vector<std::shared_ptr<HiveConnectorSplit>> smallFiles;
+  uint64_t smallFilesSize = 0;
+  for (const auto& file : files) {
+    uint64_t numRows = 0;
+    for (const auto& section : file.sections) {
+      numRows += section.numRows;
+    }
+    if (numRows == 0) {
+      continue;
+    }
+    if (file.fileSize >= targetSplitSize / 2) {
+      splitFile(connectorId, file, targetSplitSize, groups);
+      continue;
+    }
+    smallFiles.push_back(makeSplit(connectorId, file, 0, file.fileSize));
+    smallFilesSize += file.fileSize;
+    if (smallFilesSize >= targetSplitSize) {
+      groups.push_back(std::move(smallFiles));
+      smallFiles.clear();
+      smallFilesSize = 0;
+    }
+  }
+  if (!smallFiles.empty()) {
+    groups.push_back(std::move(smallFiles));
+  }
+  return groups;
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/dwio/common/Reader.h"
+
+namespace facebook::velox::connector::hive {
+
+/// A file to plan splits over. 'sections' are the stripes or row groups of
+/// the file as returned by dwio::common::Reader::sections().
+struct HiveSplitFile {
+  std::string filePath;
+  dwio::common::FileFormat fileFormat;
+  uint64_t fileSize;
+  std::vector<dwio::common::FileSection> sections;
+  std::unordered_map<std::string, std::optional<std::string>> partitionKeys;
+  std::optional<int32_t> tableBucketNumber;
+};
+
+/// Plans splits of about 'targetSplitSize' bytes over 'files'. Split
+/// boundaries fall on section boundaries, so that each split reads whole
+/// stripes or row groups, and a file is cut into splits of about equal size
+/// instead of a series of full size splits and a small remainder. A section
+/// larger than 'targetSplitSize' gets a split of its own. Files with no rows
+/// get no splits.
+///
+/// Returns groups of splits, each of about 'targetSplitSize' bytes, to be
+/// scheduled as one unit of work, e.g. added to the same driver one after
+/// the other. A split of a large file is a group of its own. Files smaller
+/// than half of 'targetSplitSize' are read as whole files and coalesced into
+/// groups so that many tiny files do not each pay the overhead of a unit of
+/// work.
+std::vector<std::vector<std::shared_ptr<HiveConnectorSplit>>> planSplits(
+    const std::string& connectorId,
+    const std::vector<HiveSplitFile>& files,
+    uint64_t targetSplitSize);
+
+} // namespace facebook::velox::connector::hive
@@ -23,8 +23,7 @@ void HdfsFileSink::write(
     std::vector<facebook::velox::dwio::common::DataBuffer<char>>& buffers) {
   writeImpl(buffers, [&](auto& buffer) {
     size_t size = buffer.size();
-    std::string str(buffer.data(), size);
-    file_->append(str);
+    file_->append(std::string_view(buffer.data(), size));
     return size;
   });
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <hdfs/hdfs.h>
 #include <mutex>
 #include "folly/concurrency/ConcurrentHashMap.h"
@@ -33,26 +34,35 @@ class HdfsFileSystem::Impl {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpointInfo.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpointInfo.port);
+    setReadOptions(builder, config);
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
         "Unable to connect to HDFS, got error: {}.",
         hdfsGetLastError())
+    hedgedReader_ = makeHedgedReader(config);
+    setWriteOptions(config);
   }
 
   explicit Impl(const Config* config, const HdfsServiceEndpoint& endpoint) {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpoint.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpoint.port);
+    setReadOptions(builder, config);
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
         "Unable to connect to HDFS: {}, got error: {}.",
         endpoint.identity,
         hdfsGetLastError())
+    hedgedReader_ = makeHedgedReader(config);
+    setWriteOptions(config);
   }
 
   ~Impl() {
+    // Waits for the reads that lost a hedge before disconnecting.
+    hedgedReader_.reset();
+    writeExecutor_.reset();
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -65,8 +75,89 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  HdfsHedgedReader* hedgedReader() {
+    return hedgedReader_.get();
+  }
+
+  folly::Executor* writeExecutor() {
+    return writeExecutor_.get();
+  }
+
+  uint64_t maxInflightWriteBytes() const {
+    return maxInflightWriteBytes_;
+  }
+
  private:
+  // Sets up short-circuit reads, which read the blocks stored on the local
+  // DataNode directly from its disks. libhdfs3 has them on by default and
+  // falls back to reading through the DataNode when the domain socket is
+  // not there.
+  static void setReadOptions(hdfsBuilder* builder, const Config* config) {
+    if (config == nullptr) {
+      return;
+    }
+    auto enabled = config->get<bool>(kShortCircuitReadEnabled);
+    if (enabled.hasValue()) {
+      hdfsBuilderConfSetStr(
+          builder,
+          "dfs.client.read.shortcircuit",
+          enabled.value() ? "true" : "false");
+    }
+    auto socketPath = config->get(kDomainSocketPath);
+    if (socketPath.hasValue()) {
+      hdfsBuilderConfSetStr(
+          builder, "dfs.domain.socket.path", socketPath->c_str());
+    }
+  }
+
+  static std::unique_ptr<HdfsHedgedReader> makeHedgedReader(
+      const Config* config) {
+    if (config == nullptr) {
+      return nullptr;
+    }
+    const auto numThreads = config->get<int32_t>(kHedgedReadThreads, 0);
+    if (numThreads <= 0) {
+      return nullptr;
+    }
+    return std::make_unique<HdfsHedgedReader>(
+        numThreads,
+        config->get<double>(kHedgedReadPercentile, 95),
+        config->get<int64_t>(kHedgedReadMinDelayMs, 10));
+  }
+
+  // Makes the executor of the background writes of the write files if write
+  // threads are configured. Without one, the files write in append().
+  void setWriteOptions(const Config* config) {
+    if (config == nullptr) {
+      return;
+    }
+    const auto numThreads = config->get<int32_t>(kWriteThreads, 0);
+    if (numThreads > 0) {
+      writeExecutor_ =
+          std::make_unique<folly::IOThreadPoolExecutor>(numThreads);
+    }
+    maxInflightWriteBytes_ =
+        config->get<uint64_t>(kMaxInflightWriteBytes, maxInflightWriteBytes_);
+  }
+
+  static constexpr const char* kShortCircuitReadEnabled =
+      "hive.hdfs.short-circuit-read.enabled";
+  static constexpr const char* kDomainSocketPath =
+      "hive.hdfs.domain-socket-path";
+  static constexpr const char* kHedgedReadThreads =
+      "hive.hdfs.hedged-read.threads";
+  static constexpr const char* kHedgedReadPercentile =
+      "hive.hdfs.hedged-read.percentile";
+  static constexpr const char* kHedgedReadMinDelayMs =
+      "hive.hdfs.hedged-read.min-delay-ms";
+  static constexpr const char* kWriteThreads = "hive.hdfs.write-threads";
+  static constexpr const char* kMaxInflightWriteBytes =
+      "hive.hdfs.max-inflight-write-bytes";
+
   hdfsFS hdfsClient_;
+  std::unique_ptr<HdfsHedgedReader> hedgedReader_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> writeExecutor_;
+  uint64_t maxInflightWriteBytes_{64 << 20};
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -95,13 +186,21 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(), path, impl_->hedgedReader());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
     std::string_view path,
     const FileOptions& /*unused*/) {
-  return std::make_unique<HdfsWriteFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsWriteFile>(
+      impl_->hdfsClient(),
+      path,
+      0,
+      0,
+      0,
+      impl_->writeExecutor(),
+      impl_->maxInflightWriteBytes());
 }
 
 bool HdfsFileSystem::isHdfsFile(const std::string_view filePath) {
@@ -15,13 +15,88 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/ScopeGuard.h>
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
+#include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/time/Timer.h"
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
+HdfsHedgedReader::HdfsHedgedReader(
+    int32_t numThreads,
+    double percentile,
+    int64_t minDelayMs)
+    : percentile_(percentile),
+      minDelayUs_(minDelayMs * 1'000),
+      latencies_(kNumLatencies),
+      delayUs_(minDelayUs_),
+      executor_(std::make_unique<folly::CPUThreadPoolExecutor>(numThreads)) {
+  VELOX_CHECK_GT(numThreads, 0);
+  VELOX_CHECK_GE(minDelayMs, 0);
+  VELOX_CHECK(
+      percentile_ > 0 && percentile_ <= 100,
+      "Hedged read percentile must be in (0, 100]: {}",
+      percentile_);
+}
+
+void HdfsHedgedReader::read(
+    const std::function<void(char*)>& read,
+    uint64_t length,
+    char* pos) {
+  auto primary = start(read, length);
+  primary.wait(std::chrono::microseconds(delayUs_.load()));
+  if (primary.isReady()) {
+    auto buffer = std::move(primary).get();
+    memcpy(pos, buffer->data(), length);
+    return;
+  }
+  addThreadLocalRuntimeStat("hdfsHedgedReads", RuntimeCounter(1));
+  std::vector<folly::Future<std::shared_ptr<std::string>>> reads;
+  reads.push_back(std::move(primary));
+  reads.push_back(start(read, length));
+  // The loser keeps running and frees its buffer when it completes.
+  auto [index, buffer] =
+      folly::collectAnyWithoutException(std::move(reads)).get();
+  if (index == 1) {
+    addThreadLocalRuntimeStat("hdfsHedgedReadWins", RuntimeCounter(1));
+  }
+  memcpy(pos, buffer->data(), length);
+}
+
+folly::Future<std::shared_ptr<std::string>> HdfsHedgedReader::start(
+    const std::function<void(char*)>& read,
+    uint64_t length) {
+  return folly::via(executor_.get(), [this, read, length]() {
+    auto buffer = std::make_shared<std::string>(length, 0);
+    const auto startUs = getCurrentTimeMicro();
+    read(buffer->data());
+    recordLatency(getCurrentTimeMicro() - startUs);
+    return buffer;
+  });
+}
+
+void HdfsHedgedReader::recordLatency(uint64_t micros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  latencies_[numLatencies_++ % kNumLatencies] = micros;
+  if (numLatencies_ % kUpdateInterval != 0) {
+    return;
+  }
+  std::vector<uint64_t> sorted(
+      latencies_.begin(),
+      latencies_.begin() + std::min<int64_t>(numLatencies_, kNumLatencies));
+  const auto nth = std::min<size_t>(
+      sorted.size() - 1, sorted.size() * percentile_ / 100);
+  std::nth_element(sorted.begin(), sorted.begin() + nth, sorted.end());
+  delayUs_ = std::max(minDelayUs_, sorted[nth]);
+}
+
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    HdfsHedgedReader* hedgedReader)
+    : hdfsClient_(hdfs), hedgedReader_(hedgedReader), filePath_(path) {
   fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
   VELOX_CHECK_NOT_NULL(
       fileInfo_,
@@ -33,34 +108,47 @@ HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
 void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
-  VELOX_CHECK_NOT_NULL(
-      file,
-      "Unable to open file {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
-  seekToPosition(file, offset);
-  uint64_t totalBytesRead = 0;
-  while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
-    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
-    totalBytesRead += bytesRead;
-    pos += bytesRead;
-  }
-
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
-    LOG(ERROR) << "Unable to close file, errno: " << errno;
+  if (hedgedReader_ == nullptr || length == 0) {
+    readRange(hdfsClient_, filePath_, offset, length, pos);
+    return;
   }
+  hedgedReader_->read(
+      [hdfs = hdfsClient_, path = filePath_, offset, length](char* buffer) {
+        readRange(hdfs, path, offset, length, buffer);
+      },
+      length,
+      pos);
 }
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
+// static
+void HdfsReadFile::readRange(
+    hdfsFS hdfs,
+    const std::string& path,
+    uint64_t offset,
+    uint64_t length,
+    char* pos) {
+  auto file = hdfsOpenFile(hdfs, path.data(), O_RDONLY, 0, 0, 0);
+  VELOX_CHECK_NOT_NULL(
+      file, "Unable to open file {}. got error: {}", path, hdfsGetLastError());
+  SCOPE_EXIT {
+    if (hdfsCloseFile(hdfs, file) == -1) {
+      LOG(ERROR) << "Unable to close file, errno: " << errno;
+    }
+  };
+  auto seekStatus = hdfsSeek(hdfs, file, offset);
   VELOX_CHECK_EQ(
       seekStatus,
       0,
       "Cannot seek through HDFS file: {}, error: {}",
-      filePath_,
+      path,
       std::string(hdfsGetLastError()));
+  uint64_t totalBytesRead = 0;
+  while (totalBytesRead < length) {
+    auto bytesRead = hdfsRead(hdfs, file, pos, length - totalBytesRead);
+    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
+    totalBytesRead += bytesRead;
+    pos += bytesRead;
+  }
 }
 
 std::string_view
@@ -14,14 +14,69 @@
  * limitations under the License.
  */
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <hdfs/hdfs.h>
+#include <atomic>
+#include <mutex>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
+// Hedges the reads of the HdfsReadFiles of one HdfsFileSystem. A read that
+// has not completed within 'percentile' of the recent read latencies, but
+// not sooner than 'minDelayMs', is issued a second time and the first of the
+// two to succeed is returned. The second read opens the file again, so that
+// it usually goes to a different DataNode than the slow one. The number of
+// hedged reads and the number of those won by the second read are reported
+// as the runtime stats 'hdfsHedgedReads' and 'hdfsHedgedReadWins'.
+class HdfsHedgedReader {
+ public:
+  HdfsHedgedReader(int32_t numThreads, double percentile, int64_t minDelayMs);
+
+  // Reads 'length' bytes into 'pos' by calling 'read', which reads the range
+  // into the buffer it is given. 'read' may run on a thread of 'this' after
+  // this returns and must therefore not refer to the caller's state.
+  void read(
+      const std::function<void(char*)>& read,
+      uint64_t length,
+      char* pos);
+
+ private:
+  static constexpr int32_t kNumLatencies = 1'024;
+  static constexpr int32_t kUpdateInterval = 64;
+
+  // Runs 'read' into a new buffer of 'length' bytes on 'executor_'.
+  folly::Future<std::shared_ptr<std::string>> start(
+      const std::function<void(char*)>& read,
+      uint64_t length);
+
+  void recordLatency(uint64_t micros);
+
+  const double percentile_;
+  const uint64_t minDelayUs_;
+
+  std::mutex mutex_;
+  // Ring of the latencies of the last 'kNumLatencies' reads.
+  std::vector<uint64_t> latencies_;
+  int64_t numLatencies_{0};
+
+  // The delay after which a read is hedged. Recomputed every
+  // 'kUpdateInterval' reads.
+  std::atomic<uint64_t> delayUs_;
+
+  // Declared last so that the threads are joined before the rest of 'this'
+  // is destroyed.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+};
+
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  // Reads are hedged with 'hedgedReader' if it is not null. 'hedgedReader'
+  // must outlive 'this'.
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      HdfsHedgedReader* hedgedReader = nullptr);
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
@@ -44,9 +99,19 @@ class HdfsReadFile final : public ReadFile {
 
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
+
+  // Opens 'path', reads 'length' bytes at 'offset' into 'pos' and closes the
+  // file.
+  static void readRange(
+      hdfsFS hdfs,
+      const std::string& path,
+      uint64_t offset,
+      uint64_t length,
+      char* pos);
+
   hdfsFS hdfsClient_;
+  HdfsHedgedReader* const hedgedReader_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
 };
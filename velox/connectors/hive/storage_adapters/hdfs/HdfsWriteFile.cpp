@@ -15,6 +15,7 @@
  */
 
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsWriteFile.h"
+#include <folly/executors/SerialExecutor.h>
 #include <hdfs/hdfs.h>
 
 namespace facebook::velox {
@@ -23,8 +24,16 @@ HdfsWriteFile::HdfsWriteFile(
     std::string_view path,
     int bufferSize,
     short replication,
-    int blockSize)
-    : hdfsClient_(hdfsClient), filePath_(path) {
+    int blockSize,
+    folly::Executor* executor,
+    uint64_t maxInflightBytes)
+    : hdfsClient_(hdfsClient),
+      filePath_(path),
+      maxInflightBytes_(maxInflightBytes) {
+  if (executor != nullptr) {
+    executor_ =
+        folly::SerialExecutor::create(folly::getKeepAliveToken(executor));
+  }
   auto pos = filePath_.rfind("/");
   auto parentDir = filePath_.substr(0, pos + 1);
   // Check whether the parentDir exist, create it if not exist.
@@ -46,7 +55,14 @@ HdfsWriteFile::HdfsWriteFile(
       std::string(hdfsGetLastError()));
 }
 
+HdfsWriteFile::~HdfsWriteFile() {
+  // The background writes reference 'this'.
+  std::unique_lock<std::mutex> l(mutex_);
+  inflightCv_.wait(l, [&]() { return inflightBytes_ == 0; });
+}
+
 void HdfsWriteFile::close() {
+  waitForWrites(0);
   int success = hdfsCloseFile(hdfsClient_, hdfsFile_);
   VELOX_CHECK_EQ(
       success,
@@ -61,6 +77,7 @@ void HdfsWriteFile::flush() {
       hdfsFile_,
       "Cannot flush HDFS file because file handle is null, file path: {}",
       filePath_);
+  waitForWrites(0);
   int success = hdfsFlush(hdfsClient_, hdfsFile_);
   VELOX_CHECK_EQ(
       success, 0, "Hdfs flush error: {}", std::string(hdfsGetLastError()));
@@ -74,15 +91,50 @@ void HdfsWriteFile::append(std::string_view data) {
       hdfsFile_,
       "Cannot append to HDFS file because file handle is null, file path: {}",
       filePath_);
-  int64_t totalWrittenBytes =
-      hdfsWrite(hdfsClient_, hdfsFile_, std::string(data).c_str(), data.size());
+  if (!executor_) {
+    write(data.data(), data.size());
+    return;
+  }
+  const uint64_t size = data.size();
+  // A write larger than the limit waits for all pending writes.
+  waitForWrites(size >= maxInflightBytes_ ? 0 : maxInflightBytes_ - size);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    inflightBytes_ += size;
+  }
+  executor_->add([this, buffer = std::string(data)]() {
+    std::exception_ptr error;
+    try {
+      write(buffer.data(), buffer.size());
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> l(mutex_);
+    if (error && !error_) {
+      error_ = error;
+    }
+    inflightBytes_ -= buffer.size();
+    inflightCv_.notify_all();
+  });
+}
+
+void HdfsWriteFile::write(const char* data, uint64_t size) {
+  int64_t totalWrittenBytes = hdfsWrite(hdfsClient_, hdfsFile_, data, size);
   VELOX_CHECK_EQ(
       totalWrittenBytes,
-      data.size(),
+      size,
       "Write failure in HDFSWriteFile::append {}",
       std::string(hdfsGetLastError()));
 }
 
+void HdfsWriteFile::waitForWrites(uint64_t maxBytes) {
+  std::unique_lock<std::mutex> l(mutex_);
+  inflightCv_.wait(l, [&]() { return inflightBytes_ <= maxBytes; });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
 uint64_t HdfsWriteFile::size() const {
   auto fileInfo = hdfsGetPathInfo(hdfsClient_, filePath_.c_str());
   return fileInfo->mSize;
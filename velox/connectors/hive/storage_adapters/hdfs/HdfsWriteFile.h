@@ -15,13 +15,20 @@
  */
 #pragma once
 
+#include <folly/Executor.h>
 #include <hdfs/hdfs.h>
+#include <condition_variable>
+#include <mutex>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
 /// Implementation of hdfs write file. Nothing written to the file should be
-/// read back until it is closed.
+/// read back until it is closed. If an executor is given, append() copies the
+/// data and writes it to HDFS in the background, so that the caller can
+/// produce the next data while the previous data is sent. The writes of a
+/// file run in append order and at most 'maxInflightBytes' are pending.
+/// flush() and close() wait for the pending writes.
 class HdfsWriteFile : public WriteFile {
  public:
   /// The constructor.
@@ -33,12 +40,19 @@ class HdfsWriteFile : public WriteFile {
   /// the default configured values.
   /// @param blockSize Size of block - pass 0 if you want to use the
   /// default configured values.
+  /// @param executor Executor for the background writes or nullptr to write
+  /// in append().
+  /// @param maxInflightBytes Maximum bytes of pending background writes.
   HdfsWriteFile(
       hdfsFS hdfsClient,
       std::string_view path,
       int bufferSize = 0,
       short replication = 0,
-      int blockSize = 0);
+      int blockSize = 0,
+      folly::Executor* executor = nullptr,
+      uint64_t maxInflightBytes = 64 << 20);
+
+  ~HdfsWriteFile() override;
 
   /// Get the file size.
   uint64_t size() const override;
@@ -53,11 +67,28 @@ class HdfsWriteFile : public WriteFile {
   void close() override;
 
  private:
+  /// Writes 'data' to 'hdfsFile_'. Throws on error.
+  void write(const char* data, uint64_t size);
+
+  /// Waits until at most 'maxBytes' of background writes are pending.
+  /// Rethrows the error of a failed background write.
+  void waitForWrites(uint64_t maxBytes);
+
   /// The configured hdfs filesystem handle.
   hdfsFS hdfsClient_;
   /// The hdfs file handle for write.
   hdfsFile hdfsFile_;
   /// The hdfs file path.
   const std::string filePath_;
+  /// Runs the background writes in order. Null if writes are synchronous.
+  folly::Executor::KeepAlive<> executor_;
+  const uint64_t maxInflightBytes_;
+
+  std::mutex mutex_;
+  std::condition_variable inflightCv_;
+  /// Bytes of pending background writes.
+  uint64_t inflightBytes_{0};
+  /// The error of the first failed background write.
+  std::exception_ptr error_;
 };
 } // namespace facebook::velox
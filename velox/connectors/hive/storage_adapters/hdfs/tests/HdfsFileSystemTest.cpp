@@ -15,6 +15,7 @@
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
 #include <boost/format.hpp>
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
 #include <connectors/hive/storage_adapters/hdfs/HdfsWriteFile.h>
 #include <gmock/gmock-matchers.h>
@@ -184,6 +185,19 @@ TEST_F(HdfsFileSystemTest, viaFileSystem) {
   readData(readFile.get());
 }
 
+TEST_F(HdfsFileSystemTest, hedgedRead) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  // With no delay every read is hedged.
+  HdfsHedgedReader hedgedReader(2, 50, 0);
+  HdfsReadFile readFile(hdfs, destinationPath, &hedgedReader);
+  for (auto i = 0; i < 10; ++i) {
+    readData(&readFile);
+  }
+}
+
 TEST_F(HdfsFileSystemTest, initializeFsWithEndpointInfoInFilePath) {
   facebook::velox::filesystems::registerHdfsFileSystem();
   auto hdfsFileSystem =
@@ -392,6 +406,32 @@ TEST_F(HdfsFileSystemTest, write) {
   ASSERT_EQ(writeFile->size(), data.size() * 3);
 }
 
+TEST_F(HdfsFileSystemTest, pipelinedWrite) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  folly::IOThreadPoolExecutor executor(2);
+  const std::string path = "/pipelined.txt";
+  std::string expected;
+  {
+    // Allows two appends in flight.
+    HdfsWriteFile writeFile(hdfs, path, 0, 0, 0, &executor, 2 * kOneMB);
+    for (auto i = 0; i < 10; ++i) {
+      std::string data(kOneMB, 'a' + i);
+      writeFile.append(data);
+      expected += data;
+    }
+    writeFile.flush();
+    writeFile.append("tail");
+    expected += "tail";
+    writeFile.close();
+    ASSERT_EQ(writeFile.size(), expected.size());
+  }
+  HdfsReadFile readFile(hdfs, path);
+  ASSERT_EQ(readFile.pread(0, expected.size()), expected);
+}
+
 TEST_F(HdfsFileSystemTest, missingFileForWrite) {
   const std::string filePath = "hdfs://localhost:7777/path/that/does/not/exist";
   const std::string errorMsg =
@@ -20,7 +20,11 @@
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
+#include <folly/ScopeGuard.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <glog/logging.h>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <stdexcept>
 
@@ -31,8 +35,13 @@
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -59,10 +68,84 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
+// Runs the ranged GETs of S3ReadFile::preadvAsync() for the files of one
+// S3FileSystem and limits the bytes they have in flight.
+class S3ReadExecutor {
+ public:
+  S3ReadExecutor(
+      int32_t numThreads,
+      uint64_t maxInflightBytes,
+      uint64_t chunkSize,
+      uint64_t maxCoalesceDistance)
+      : executor_(std::make_unique<folly::IOThreadPoolExecutor>(numThreads)),
+        maxInflightBytes_(maxInflightBytes),
+        chunkSize_(chunkSize),
+        maxCoalesceDistance_(maxCoalesceDistance) {
+    VELOX_CHECK_GT(chunkSize_, 0);
+  }
+
+  // Ranges longer than this are read with parallel GETs of this size.
+  uint64_t chunkSize() const {
+    return chunkSize_;
+  }
+
+  // Ranges separated by at most this many bytes are read with a single GET.
+  uint64_t maxCoalesceDistance() const {
+    return maxCoalesceDistance_;
+  }
+
+  // Runs 'get', which reads 'bytes' bytes, on a thread of 'executor_' once
+  // the bytes in flight leave room for it. A GET larger than the limit runs
+  // alone.
+  folly::SemiFuture<folly::Unit> run(
+      uint64_t bytes,
+      std::function<void()> get) {
+    return folly::via(
+               executor_.get(),
+               [this, bytes, get = std::move(get)]() {
+                 acquire(bytes);
+                 SCOPE_EXIT {
+                   release(bytes);
+                 };
+                 get();
+               })
+        .semi();
+  }
+
+ private:
+  void acquire(uint64_t bytes) {
+    std::unique_lock<std::mutex> l(mutex_);
+    cv_.wait(l, [&]() {
+      return inflightBytes_ == 0 || inflightBytes_ + bytes <= maxInflightBytes_;
+    });
+    inflightBytes_ += bytes;
+  }
+
+  void release(uint64_t bytes) {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      inflightBytes_ -= bytes;
+    }
+    cv_.notify_all();
+  }
+
+  const std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
+  const uint64_t maxInflightBytes_;
+  const uint64_t chunkSize_;
+  const uint64_t maxCoalesceDistance_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t inflightBytes_{0};
+};
+
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      S3ReadExecutor* readExecutor)
+      : client_(client), readExecutor_(readExecutor) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -124,6 +207,36 @@ class S3ReadFile final : public ReadFile {
     return length;
   }
 
+  // Reads with parallel ranged GETs. Ranges separated by small gaps are
+  // read with one GET and long ones are split into several. 'this' and the
+  // memory referenced by 'buffers' must stay valid until the returned future
+  // is realized.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    uint64_t length = 0;
+    for (const auto& range : buffers) {
+      length += range.size();
+    }
+    std::vector<folly::SemiFuture<folly::Unit>> futures;
+    for (auto& get : planGets(offset, buffers)) {
+      const auto getLength = get.length;
+      futures.push_back(readExecutor_->run(
+          getLength, [this, get = std::move(get)]() { readGet(get); }));
+    }
+    return folly::collectAll(std::move(futures))
+        .deferValue([length](std::vector<folly::Try<folly::Unit>>&& results) {
+          for (auto& result : results) {
+            result.throwUnlessValue();
+          }
+          return length;
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return true;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -165,11 +278,274 @@ class S3ReadFile final : public ReadFile {
     VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
   }
 
+  // A ranged GET of [offset, offset + length) and the destinations it fills,
+  // each with its offset in the object.
+  struct RangedGet {
+    uint64_t offset;
+    uint64_t length;
+    std::vector<std::pair<uint64_t, folly::Range<char*>>> targets;
+  };
+
+  // Returns the GETs that fill the non-gap ranges in 'buffers', which start
+  // at 'offset'.
+  std::vector<RangedGet> planGets(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const {
+    std::vector<RangedGet> gets;
+    // Destinations that are read with a run of GETs and the range they span.
+    std::vector<std::pair<uint64_t, folly::Range<char*>>> group;
+    uint64_t groupStart = 0;
+    uint64_t groupEnd = 0;
+    auto flush = [&]() {
+      const auto chunkSize = readExecutor_->chunkSize();
+      for (auto start = groupStart; start < groupEnd; start += chunkSize) {
+        const auto end = std::min(groupEnd, start + chunkSize);
+        RangedGet get{start, end - start, {}};
+        for (const auto& [targetOffset, target] : group) {
+          const auto begin = std::max(start, targetOffset);
+          const auto targetEnd = std::min(end, targetOffset + target.size());
+          if (begin < targetEnd) {
+            get.targets.emplace_back(
+                begin,
+                folly::Range<char*>(
+                    target.data() + (begin - targetOffset),
+                    targetEnd - begin));
+          }
+        }
+        gets.push_back(std::move(get));
+      }
+      group.clear();
+    };
+    for (const auto& range : buffers) {
+      if (range.data() && !range.empty()) {
+        if (!group.empty() &&
+            offset - groupEnd > readExecutor_->maxCoalesceDistance()) {
+          flush();
+        }
+        if (group.empty()) {
+          groupStart = offset;
+        }
+        group.emplace_back(offset, range);
+        groupEnd = offset + range.size();
+      }
+      offset += range.size();
+    }
+    if (!group.empty()) {
+      flush();
+    }
+    return gets;
+  }
+
+  void readGet(const RangedGet& get) const {
+    if (get.targets.size() == 1 && get.targets[0].second.size() == get.length) {
+      preadInternal(get.offset, get.length, get.targets[0].second.data());
+      return;
+    }
+    // The GET covers gaps or several destinations.
+    std::string buffer(get.length, 0);
+    preadInternal(get.offset, get.length, buffer.data());
+    for (const auto& [targetOffset, target] : get.targets) {
+      memcpy(
+          target.data(),
+          buffer.data() + (targetOffset - get.offset),
+          target.size());
+    }
+  }
+
   Aws::S3::S3Client* client_;
+  S3ReadExecutor* const readExecutor_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
+
+// Writes an S3 object with a multipart upload. The appended data is buffered
+// until it fills a part, which is then uploaded on 'uploadExecutor' while the
+// next part is appended. At most 'maxInflightParts' parts of the file are
+// uploaded at a time; append() waits for the oldest part beyond that. An
+// object smaller than a part is written with a single PUT at close.
+class S3WriteFile final : public WriteFile {
+ public:
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* uploadExecutor,
+      uint64_t partSize,
+      int32_t maxInflightParts)
+      : client_(client),
+        uploadExecutor_(uploadExecutor),
+        partSize_(partSize),
+        maxInflightParts_(maxInflightParts) {
+    // S3 requires all parts but the last to be at least 5MB.
+    VELOX_CHECK_GE(partSize_, 5UL << 20, "S3 upload parts must be at least 5MB");
+    VELOX_CHECK_GT(maxInflightParts_, 0);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+  }
+
+  ~S3WriteFile() override {
+    if (closed_) {
+      return;
+    }
+    // The uploads in flight reference 'this'.
+    for (auto& part : inflightParts_) {
+      part.wait();
+    }
+    if (!uploadId_.empty()) {
+      abortUpload();
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "Cannot append to closed S3 file {}", getName());
+    size_ += data.size();
+    while (!data.empty()) {
+      const auto size = std::min<uint64_t>(
+          data.size(), partSize_ - currentPart_.size());
+      currentPart_.append(data.data(), size);
+      data.remove_prefix(size);
+      if (currentPart_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // Waits for the parts in flight. The data after the last full part stays
+  // buffered until it fills a part or the file is closed since only the last
+  // part of an upload may be smaller than the part size.
+  void flush() override {
+    VELOX_CHECK(!closed_, "Cannot flush closed S3 file {}", getName());
+    waitForParts(0);
+  }
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+    } else {
+      if (!currentPart_.empty()) {
+        uploadPart();
+      }
+      waitForParts(0);
+      completeUpload();
+    }
+    closed_ = true;
+    currentPart_ = std::string();
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  std::string getName() const {
+    return fmt::format("s3://{}/{}", bucket_, key_);
+  }
+
+  // Starts uploading 'currentPart_' on 'uploadExecutor_'.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      createUpload();
+    }
+    waitForParts(maxInflightParts_ - 1);
+    const int32_t partNumber = ++numParts_;
+    auto part = std::make_shared<std::string>(std::move(currentPart_));
+    currentPart_ = std::string();
+    currentPart_.reserve(partSize_);
+    auto upload = [this, partNumber, part]() {
+      Aws::S3::Model::UploadPartRequest request;
+      request.SetBucket(awsString(bucket_));
+      request.SetKey(awsString(key_));
+      request.SetUploadId(uploadId_);
+      request.SetPartNumber(partNumber);
+      request.SetContentLength(part->size());
+      request.SetBody(
+          Aws::MakeShared<StringViewStream>("", part->data(), part->size()));
+      auto outcome = client_->UploadPart(request);
+      VELOX_CHECK_AWS_OUTCOME(
+          outcome, "Failed to upload S3 object part", bucket_, key_);
+      Aws::S3::Model::CompletedPart completedPart;
+      completedPart.SetPartNumber(partNumber);
+      completedPart.SetETag(outcome.GetResult().GetETag());
+      return completedPart;
+    };
+    inflightParts_.push_back(folly::via(uploadExecutor_, std::move(upload)));
+  }
+
+  // Waits for the oldest parts in flight until at most 'maxInflight' are
+  // left. Throws if an upload failed.
+  void waitForParts(int32_t maxInflight) {
+    while (inflightParts_.size() > static_cast<size_t>(maxInflight)) {
+      auto part = std::move(inflightParts_.front());
+      inflightParts_.pop_front();
+      completedParts_.push_back(std::move(part).get());
+    }
+  }
+
+  void createUpload() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    auto outcome = client_->CreateMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to create S3 multipart upload", bucket_, key_);
+    uploadId_ = outcome.GetResult().GetUploadId();
+  }
+
+  void completeUpload() {
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(completedParts_);
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete S3 multipart upload", bucket_, key_);
+  }
+
+  void abortUpload() {
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      LOG(WARNING) << "Failed to abort S3 multipart upload of " << getName()
+                   << ": " << outcome.GetError().GetMessage();
+    }
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(currentPart_.size());
+    request.SetBody(Aws::MakeShared<StringViewStream>(
+        "", currentPart_.data(), currentPart_.size()));
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+  }
+
+  Aws::S3::S3Client* const client_;
+  folly::Executor* const uploadExecutor_;
+  const uint64_t partSize_;
+  const int32_t maxInflightParts_;
+  std::string bucket_;
+  std::string key_;
+
+  uint64_t size_{0};
+  // The data appended after the last uploaded part.
+  std::string currentPart_;
+  Aws::String uploadId_;
+  int32_t numParts_{0};
+  // The uploads in flight in part order and the parts uploaded before them.
+  std::deque<folly::Future<Aws::S3::Model::CompletedPart>> inflightParts_;
+  Aws::Vector<Aws::S3::Model::CompletedPart> completedParts_;
+  bool closed_{false};
+};
 } // namespace
 
 namespace filesystems {
@@ -217,6 +593,41 @@ class S3Config {
     return {};
   }
 
+  // Maximum number of connections of the S3 client. This is also the number
+  // of threads for the GETs of ReadFile::preadvAsync() and for the part
+  // uploads of written files.
+  int32_t maxConnections() const {
+    return config_->get<int32_t>("hive.s3.max-connections", 25);
+  }
+
+  // Maximum total size of the GETs of ReadFile::preadvAsync() in flight.
+  uint64_t maxInflightBytes() const {
+    return config_->get<uint64_t>("hive.s3.max-inflight-bytes", 256 << 20);
+  }
+
+  // Size of the parallel GETs that ReadFile::preadvAsync() splits long
+  // ranges into.
+  uint64_t readChunkSize() const {
+    return config_->get<uint64_t>("hive.s3.read-chunk-size", 8 << 20);
+  }
+
+  // Maximum gap between ranges that ReadFile::preadvAsync() reads with one
+  // GET. The same default as for reader coalescing.
+  uint64_t maxCoalesceDistance() const {
+    return config_->get<uint64_t>("hive.s3.max-coalesce-distance", 512 << 10);
+  }
+
+  // Size of the parts of the multipart uploads of written files. At least
+  // 5MB.
+  uint64_t uploadPartSize() const {
+    return config_->get<uint64_t>("hive.s3.upload-part-size", 16 << 20);
+  }
+
+  // Maximum number of parts of a written file uploaded at a time.
+  int32_t maxInflightUploadParts() const {
+    return config_->get<int32_t>("hive.s3.max-inflight-upload-parts", 4);
+  }
+
   std::string iamRoleSessionName() const {
     return config_->get(
         "hive.s3.iam-role-session-name", std::string("velox-session"));
@@ -268,9 +679,19 @@ class S3FileSystem::Impl {
       awsOptions.httpOptions.installSigPipeHandler = true;
       Aws::InitAPI(awsOptions);
     }
+    readExecutor_ = std::make_unique<S3ReadExecutor>(
+        s3Config_.maxConnections(),
+        s3Config_.maxInflightBytes(),
+        s3Config_.readChunkSize(),
+        s3Config_.maxCoalesceDistance());
+    uploadExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+        s3Config_.maxConnections());
   }
 
   ~Impl() {
+    // Joins the threads that may still use the client.
+    readExecutor_.reset();
+    uploadExecutor_.reset();
     const size_t newCount = --initCounter_;
     if (newCount == 0) {
       Aws::SDKOptions awsOptions;
@@ -347,6 +768,7 @@ class S3FileSystem::Impl {
     Aws::Client::ClientConfiguration clientConfig;
 
     clientConfig.endpointOverride = s3Config_.endpoint();
+    clientConfig.maxConnections = s3Config_.maxConnections();
 
     if (s3Config_.useSSL()) {
       clientConfig.scheme = Aws::Http::Scheme::HTTPS;
@@ -370,6 +792,18 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  S3ReadExecutor* readExecutor() const {
+    return readExecutor_.get();
+  }
+
+  folly::Executor* uploadExecutor() const {
+    return uploadExecutor_.get();
+  }
+
+  const S3Config& s3Config() const {
+    return s3Config_;
+  }
+
   std::string getLogLevelName() const {
     return GetLogLevelName(s3Config_.getLogLevel());
   }
@@ -377,6 +811,8 @@ class S3FileSystem::Impl {
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  std::unique_ptr<S3ReadExecutor> readExecutor_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> uploadExecutor_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -400,7 +836,8 @@ std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
     std::string_view path,
     const FileOptions& /*unused*/) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file, impl_->s3Client(), impl_->readExecutor());
   s3file->initialize();
   return s3file;
 }
@@ -408,7 +845,12 @@ std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path,
     const FileOptions& /*unused*/) {
-  VELOX_NYI();
+  return std::make_unique<S3WriteFile>(
+      s3Path(path),
+      impl_->s3Client(),
+      impl_->uploadExecutor(),
+      impl_->s3Config().uploadPartSize(),
+      impl_->s3Config().maxInflightUploadParts());
 }
 
 std::string S3FileSystem::name() const {
@@ -118,6 +118,96 @@ TEST_F(S3FileSystemTest, writeAndRead) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, writeViaS3) {
+  const char* bucketName = "data-write";
+  addBucket(bucketName);
+  // Two parts in flight of the minimum part size.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.upload-part-size", std::to_string(5 * kOneMB)},
+       {"hive.s3.max-inflight-upload-parts", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // Smaller than a part, written with a single PUT.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  {
+    auto writeFile = s3fs.openFileForWrite(smallFile);
+    writeData(writeFile.get());
+    writeFile->close();
+  }
+  readData(s3fs.openFileForRead(smallFile).get());
+
+  // Written as a multipart upload of three full parts and a tail.
+  const std::string largeFile = s3URI(bucketName, "large.txt");
+  std::string expected;
+  {
+    auto writeFile = s3fs.openFileForWrite(largeFile);
+    for (auto i = 0; i < 16; ++i) {
+      std::string data(kOneMB, 'a' + i);
+      writeFile->append(data);
+      expected += data;
+      if (i == 7) {
+        writeFile->flush();
+      }
+    }
+    writeFile->append("tail");
+    expected += "tail";
+    ASSERT_EQ(writeFile->size(), expected.size());
+    writeFile->close();
+  }
+  auto readFile = s3fs.openFileForRead(largeFile);
+  ASSERT_EQ(readFile->size(), expected.size());
+  ASSERT_EQ(readFile->pread(0, expected.size()), expected);
+}
+
+TEST_F(S3FileSystemTest, preadvAsync) {
+  const char* bucketName = "data-async";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Small chunks and coalesce distance, so that the reads below are split
+  // into several GETs and gaps are sometimes read and sometimes skipped.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-chunk-size", "100000"},
+       {"hive.s3.max-coalesce-distance", "1000"},
+       {"hive.s3.max-inflight-bytes", "300000"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+
+  char head[12];
+  char middle[4];
+  char tail[7];
+  std::vector<char> body(kOneMB);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)500),
+      folly::Range<char*>(middle, sizeof(middle)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)500000),
+      folly::Range<char*>(tail, sizeof(tail))};
+  const uint64_t length =
+      sizeof(head) + 500 + sizeof(middle) + 500000 + sizeof(tail);
+  ASSERT_EQ(length, readFile->preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccccccc");
+
+  ASSERT_EQ(
+      kOneMB,
+      readFile->preadvAsync(15, {folly::Range<char*>(body.data(), kOneMB)})
+          .get());
+  ASSERT_EQ(
+      std::string(body.begin(), body.end() - 10),
+      std::string(kOneMB - 10, 'c'));
+  ASSERT_EQ(std::string(body.end() - 10, body.end()), "cccccddddd");
+}
+
 TEST_F(S3FileSystemTest, viaRegistry) {
   const char* bucketName = "data2";
   const char* file = "test.txt";
@@ -16,6 +16,7 @@
 
 #include "velox/connectors/hive/HiveConnector.h"
 #include <gtest/gtest.h>
+#include "velox/expression/ExprToSubfieldFilter.h"
 
 namespace facebook::velox::connector::hive {
 namespace {
@@ -175,5 +176,89 @@ TEST_F(HiveConnectorTest, makeScanSpec_requiredSubfields_allSubscripts) {
   validateNullConstant(*elements->childByName("c0c1"), *BIGINT());
 }
 
+TEST_F(HiveConnectorTest, extractFiltersFromRemainingFilter) {
+  auto field = [](const std::string& name) {
+    return std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), name);
+  };
+  auto constant = [](int64_t value) {
+    return std::make_shared<core::ConstantTypedExpr>(BIGINT(), variant(value));
+  };
+  auto call = [](const std::string& name,
+                 std::vector<core::TypedExprPtr> inputs) {
+    return std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(), std::move(inputs), name);
+  };
+  auto multiColumn = call(
+      "lt",
+      {std::make_shared<core::CallTypedExpr>(
+           BIGINT(),
+           std::vector<core::TypedExprPtr>{field("c0"), field("c1")},
+           "plus"),
+       constant(5)});
+
+  // c0 > 10 AND c0 + c1 < 5 AND NOT c1 = 3 with a filter c0 < 100.
+  SubfieldFilters filters;
+  filters.emplace(Subfield("c0"), exec::lessThan(100));
+  auto remaining = HiveDataSource::extractFiltersFromRemainingFilter(
+      call(
+          "and",
+          {call("gt", {field("c0"), constant(10)}),
+           multiColumn,
+           call("not", {call("eq", {field("c1"), constant(3)})})}),
+      filters);
+  ASSERT_EQ(remaining, multiColumn);
+  ASSERT_EQ(filters.size(), 2);
+  auto* c0 = filters.at(Subfield("c0")).get();
+  EXPECT_FALSE(c0->testInt64(10));
+  EXPECT_TRUE(c0->testInt64(50));
+  EXPECT_FALSE(c0->testInt64(100));
+  EXPECT_FALSE(c0->testNull());
+  auto* c1 = filters.at(Subfield("c1")).get();
+  EXPECT_FALSE(c1->testInt64(3));
+  EXPECT_TRUE(c1->testInt64(4));
+  EXPECT_FALSE(c1->testNull());
+
+  // Nothing to extract.
+  filters.clear();
+  EXPECT_EQ(
+      HiveDataSource::extractFiltersFromRemainingFilter(multiColumn, filters),
+      multiColumn);
+  EXPECT_TRUE(filters.empty());
+
+  // Everything is extracted.
+  EXPECT_EQ(
+      HiveDataSource::extractFiltersFromRemainingFilter(
+          call(
+              "and",
+              {call("gte", {field("c0"), constant(1)}),
+               call("lte", {field("c0"), constant(2)})}),
+          filters),
+      nullptr);
+  ASSERT_EQ(filters.size(), 1);
+  EXPECT_TRUE(filters.at(Subfield("c0"))->testInt64(2));
+  EXPECT_FALSE(filters.at(Subfield("c0"))->testInt64(3));
+
+  // Connector columns and nested fields stay in the remaining filter.
+  filters.clear();
+  auto path = call(
+      "eq",
+      {std::make_shared<core::FieldAccessTypedExpr>(VARCHAR(), "$path"),
+       std::make_shared<core::ConstantTypedExpr>(VARCHAR(), variant("a"))});
+  EXPECT_EQ(
+      HiveDataSource::extractFiltersFromRemainingFilter(path, filters), path);
+  auto nested = call(
+      "eq",
+      {std::make_shared<core::FieldAccessTypedExpr>(
+           BIGINT(),
+           std::make_shared<core::FieldAccessTypedExpr>(
+               ROW({{"f", BIGINT()}}), "c2"),
+           "f"),
+       constant(1)});
+  EXPECT_EQ(
+      HiveDataSource::extractFiltersFromRemainingFilter(nested, filters),
+      nested);
+  EXPECT_TRUE(filters.empty());
+}
+
 } // namespace
 } // namespace facebook::velox::connector::hive
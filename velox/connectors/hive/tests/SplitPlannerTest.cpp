@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/SplitPlanner.h"
+
+#include "gtest/gtest.h"
+
+namespace facebook::velox::connector::hive {
+namespace {
+
+constexpr uint64_t kMB = 1 << 20;
+
+// Makes a file of 'numSections' sections of 'sectionSize' bytes and 100 rows
+// each after a 3 byte header.
+HiveSplitFile makeFile(
+    const std::string& path,
+    int32_t numSections,
+    uint64_t sectionSize) {
+  HiveSplitFile file{path, dwio::common::FileFormat::DWRF, 0, {}, {}, {}};
+  uint64_t offset = 3;
+  for (auto i = 0; i < numSections; ++i) {
+    file.sections.push_back({offset, sectionSize, 100});
+    offset += sectionSize;
+  }
+  // Footer.
+  file.fileSize = offset + 1000;
+  return file;
+}
+
+// Returns the indices of the sections of 'file' that a row reader over
+// 'split' reads.
+std::vector<int32_t> sectionsInSplit(
+    const HiveSplitFile& file,
+    const HiveConnectorSplit& split) {
+  std::vector<int32_t> indices;
+  for (auto i = 0; i < file.sections.size(); ++i) {
+    const auto offset = file.sections[i].offset;
+    if (offset >= split.start && offset < split.start + split.length) {
+      indices.push_back(i);
+    }
+  }
+  return indices;
+}
+
+TEST(SplitPlannerTest, balancedSplits) {
+  // 10 sections of 30MB with a target of 128MB give 3 splits of 100MB rather
+  // than 2 of 120MB and one of 60MB.
+  auto file = makeFile("large", 10, 30 * kMB);
+  auto groups = planSplits("hive", {file}, 128 * kMB);
+  ASSERT_EQ(groups.size(), 3);
+  std::vector<std::vector<int32_t>> expected = {
+      {0, 1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  for (auto i = 0; i < groups.size(); ++i) {
+    ASSERT_EQ(groups[i].size(), 1);
+    EXPECT_EQ(sectionsInSplit(file, *groups[i][0]), expected[i]);
+  }
+  EXPECT_EQ(groups[0][0]->start, 0);
+  EXPECT_EQ(
+      groups.back()[0]->start + groups.back()[0]->length, file.fileSize);
+
+  // A section larger than the target is a split of its own.
+  file = makeFile("huge", 3, 400 * kMB);
+  groups = planSplits("hive", {file}, 128 * kMB);
+  ASSERT_EQ(groups.size(), 3);
+  for (auto i = 0; i < groups.size(); ++i) {
+    EXPECT_EQ(sectionsInSplit(file, *groups[i][0]), std::vector<int32_t>{i});
+  }
+}
+
+TEST(SplitPlannerTest, coalesceSmallFiles) {
+  std::vector<HiveSplitFile> files;
+  for (auto i = 0; i < 10; ++i) {
+    files.push_back(makeFile(fmt::format("small{}", i), 1, 5 * kMB));
+  }
+  files.push_back(makeFile("large", 4, 64 * kMB));
+  // Empty files get no splits.
+  files.push_back(makeFile("empty", 0, 0));
+
+  auto groups = planSplits("hive", files, 32 * kMB);
+  // A split per section of the large file and 2 groups of the small files.
+  ASSERT_EQ(groups.size(), 6);
+  for (auto i = 0; i < 4; ++i) {
+    ASSERT_EQ(groups[i].size(), 1);
+    EXPECT_EQ(groups[i][0]->filePath, "large");
+  }
+  ASSERT_EQ(groups[4].size(), 7);
+  ASSERT_EQ(groups[5].size(), 3);
+  for (auto i = 0; i < 10; ++i) {
+    const auto& split = groups[4 + i / 7][i % 7];
+    EXPECT_EQ(split->filePath, fmt::format("small{}", i));
+    EXPECT_EQ(split->start, 0);
+    EXPECT_EQ(split->length, files[i].fileSize);
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::connector::hive
@@ -21,37 +21,6 @@ namespace facebook::velox::connector::tpch {
 
 using facebook::velox::tpch::Table;
 
-namespace {
-
-RowVectorPtr getTpchData(
-    Table table,
-    size_t maxRows,
-    size_t offset,
-    double scaleFactor,
-    memory::MemoryPool* pool) {
-  switch (table) {
-    case Table::TBL_PART:
-      return velox::tpch::genTpchPart(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_SUPPLIER:
-      return velox::tpch::genTpchSupplier(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_PARTSUPP:
-      return velox::tpch::genTpchPartSupp(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_CUSTOMER:
-      return velox::tpch::genTpchCustomer(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_ORDERS:
-      return velox::tpch::genTpchOrders(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_LINEITEM:
-      return velox::tpch::genTpchLineItem(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_NATION:
-      return velox::tpch::genTpchNation(pool, maxRows, offset, scaleFactor);
-    case Table::TBL_REGION:
-      return velox::tpch::genTpchRegion(pool, maxRows, offset, scaleFactor);
-  }
-  return nullptr;
-}
-
-} // namespace
-
 std::string TpchTableHandle::toString() const {
   return fmt::format(
       "table: {}, scale factor: {}", toTableName(table_), scaleFactor_);
@@ -105,22 +74,6 @@ TpchDataSource::TpchDataSource(
   outputType_ = outputType;
 }
 
-RowVectorPtr TpchDataSource::projectOutputColumns(RowVectorPtr inputVector) {
-  std::vector<VectorPtr> children;
-  children.reserve(outputColumnMappings_.size());
-
-  for (const auto channel : outputColumnMappings_) {
-    children.emplace_back(inputVector->childAt(channel));
-  }
-
-  return std::make_shared<RowVector>(
-      pool_,
-      outputType_,
-      BufferPtr(),
-      inputVector->size(),
-      std::move(children));
-}
-
 void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   VELOX_CHECK_EQ(
       currentSplit_,
@@ -143,8 +96,14 @@ std::optional<RowVectorPtr> TpchDataSource::next(
       currentSplit_, "No split to process. Call addSplit() first.");
 
   size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
-  auto outputVector =
-      getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+  // Only the projected columns are generated.
+  auto outputVector = velox::tpch::genTpchData(
+      tpchTable_,
+      outputColumnMappings_,
+      pool_,
+      maxRows,
+      splitOffset_,
+      scaleFactor_);
 
   // If the split is exhausted.
   if (!outputVector || outputVector->size() == 0) {
@@ -159,7 +118,12 @@ std::optional<RowVectorPtr> TpchDataSource::next(
   completedRows_ += outputVector->size();
   completedBytes_ += outputVector->retainedSize();
 
-  return projectOutputColumns(outputVector);
+  return std::make_shared<RowVector>(
+      pool_,
+      outputType_,
+      BufferPtr(),
+      outputVector->size(),
+      outputVector->children());
 }
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<TpchConnectorFactory>())
@@ -102,8 +102,6 @@ class TpchDataSource : public DataSource {
   }
 
  private:
-  RowVectorPtr projectOutputColumns(RowVectorPtr vector);
-
   velox::tpch::Table tpchTable_;
   double scaleFactor_{1.0};
   size_t tpchTableRowCount_{0};
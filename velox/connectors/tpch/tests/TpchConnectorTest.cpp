@@ -269,6 +269,26 @@ TEST_F(TpchConnectorTest, join) {
   test::assertEqualVectors(expected, output);
 }
 
+// Scans of keys only are generated without DBGEN. Checks them against a scan
+// that also reads a column generated by DBGEN.
+TEST_F(TpchConnectorTest, nativeColumns) {
+  auto scan = [&](std::vector<std::string>&& columns) {
+    auto plan = PlanBuilder()
+                    .tableScan(Table::TBL_PARTSUPP, std::move(columns), 0.01)
+                    .project({"ps_partkey", "ps_suppkey"})
+                    .planNode();
+    std::vector<exec::Split> splits;
+    for (auto i = 0; i < 3; ++i) {
+      splits.push_back(makeTpchSplit(3, i));
+    }
+    return getResults(plan, std::move(splits));
+  };
+
+  auto expected = scan({"ps_partkey", "ps_suppkey", "ps_availqty"});
+  EXPECT_EQ(tpch::getRowCount(Table::TBL_PARTSUPP, 0.01), expected->size());
+  test::assertEqualVectors(expected, scan({"ps_suppkey", "ps_partkey"}));
+}
+
 TEST_F(TpchConnectorTest, orderDateCount) {
   auto plan = PlanBuilder()
                   .tableScan(Table::TBL_ORDERS, {"o_orderdate"}, 0.01)
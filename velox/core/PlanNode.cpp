@@ -61,6 +61,36 @@ SortOrder SortOrder::deserialize(const folly::dynamic& obj) {
 }
 
 namespace {
+folly::dynamic serializeSortingOrders(
+    const std::vector<SortOrder>& sortingOrders) {
+  auto array = folly::dynamic::array();
+  for (const auto& order : sortingOrders) {
+    array.push_back(order.serialize());
+  }
+
+  return array;
+}
+
+std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
+  std::vector<SortOrder> sortingOrders;
+  for (const auto& order : array) {
+    sortingOrders.push_back(SortOrder::deserialize(order));
+  }
+  return sortingOrders;
+}
+
+void addSortingKeys(
+    std::stringstream& stream,
+    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<SortOrder>& sortingOrders) {
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
+  }
+}
+
 const std::vector<PlanNodePtr> kEmptySources;
 
 RowTypePtr getAggregationOutputType(
@@ -102,6 +132,56 @@ AggregationNode::AggregationNode(
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
     bool ignoreNullKeys,
     PlanNodePtr source)
+    : AggregationNode(
+          id,
+          step,
+          groupingKeys,
+          preGroupedKeys,
+          aggregateNames,
+          aggregates,
+          aggregateMasks,
+          {},
+          ignoreNullKeys,
+          std::move(source)) {}
+
+AggregationNode::AggregationNode(
+    const PlanNodeId& id,
+    Step step,
+    const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+    const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+    const std::vector<std::string>& aggregateNames,
+    const std::vector<CallTypedExprPtr>& aggregates,
+    const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& distinctFlags,
+    bool ignoreNullKeys,
+    PlanNodePtr source)
+    : AggregationNode(
+          id,
+          step,
+          groupingKeys,
+          preGroupedKeys,
+          aggregateNames,
+          aggregates,
+          aggregateMasks,
+          distinctFlags,
+          {},
+          {},
+          ignoreNullKeys,
+          std::move(source)) {}
+
+AggregationNode::AggregationNode(
+    const PlanNodeId& id,
+    Step step,
+    const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+    const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+    const std::vector<std::string>& aggregateNames,
+    const std::vector<CallTypedExprPtr>& aggregates,
+    const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& distinctFlags,
+    const std::vector<std::vector<FieldAccessTypedExprPtr>>& sortingKeys,
+    const std::vector<std::vector<SortOrder>>& sortingOrders,
+    bool ignoreNullKeys,
+    PlanNodePtr source)
     : PlanNode(id),
       step_(step),
       groupingKeys_(groupingKeys),
@@ -109,6 +189,9 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      distinctFlags_(distinctFlags),
+      sortingKeys_(sortingKeys),
+      sortingOrders_(sortingOrders),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -136,6 +219,45 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  if (!distinctFlags_.empty()) {
+    VELOX_CHECK_EQ(
+        distinctFlags_.size(),
+        aggregates_.size(),
+        "Distinct flags must be specified for all aggregates");
+  }
+  // Distinct values of the raw input can only be found if all the input of a
+  // group is seen by the same aggregation.
+  VELOX_CHECK(
+      !hasDistinctAggregates() || step_ == Step::kSingle,
+      "Distinct aggregates are only supported in single aggregation");
+
+  if (!sortingKeys_.empty()) {
+    VELOX_CHECK_EQ(
+        sortingKeys_.size(),
+        aggregates_.size(),
+        "Sorting keys must be specified for all aggregates");
+  }
+  VELOX_CHECK_EQ(
+      sortingOrders_.size(),
+      sortingKeys_.size(),
+      "Sorting orders must be specified for all aggregates");
+  for (auto i = 0; i < sortingKeys_.size(); ++i) {
+    VELOX_CHECK_EQ(
+        sortingKeys_[i].size(),
+        sortingOrders_[i].size(),
+        "Number of sorting keys and sorting orders of an aggregate must match");
+    VELOX_CHECK(
+        sortingKeys_[i].empty() || distinctFlags_.empty() ||
+            !distinctFlags_[i],
+        "Aggregates over distinct inputs can't be sorted: {}",
+        aggregates_[i]->toString());
+  }
+  // Like with distinct aggregates, the input of a group can only be sorted
+  // if the whole of it is seen by the same aggregation.
+  VELOX_CHECK(
+      !hasSortedAggregates() || step_ == Step::kSingle,
+      "Sorted aggregates are only supported in single aggregation");
 }
 
 namespace {
@@ -187,6 +309,13 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
     if (aggregateMasks_.size() > i && aggregateMasks_[i]) {
       stream << " mask: " << aggregateMasks_[i]->name();
     }
+    if (distinctFlags_.size() > i && distinctFlags_[i]) {
+      stream << " distinct";
+    }
+    if (sortingKeys_.size() > i && !sortingKeys_[i].empty()) {
+      stream << " ORDER BY ";
+      addSortingKeys(stream, sortingKeys_[i], sortingOrders_[i]);
+    }
   }
 }
 
@@ -239,6 +368,23 @@ folly::dynamic AggregationNode::serialize() const {
     }
   }
 
+  if (hasDistinctAggregates()) {
+    obj["distinctFlags"] = folly::dynamic::array;
+    for (auto flag : distinctFlags_) {
+      obj["distinctFlags"].push_back(static_cast<bool>(flag));
+    }
+  }
+
+  if (hasSortedAggregates()) {
+    obj["sortingKeys"] = folly::dynamic::array;
+    obj["sortingOrders"] = folly::dynamic::array;
+    for (auto i = 0; i < sortingKeys_.size(); ++i) {
+      obj["sortingKeys"].push_back(ISerializable::serialize(sortingKeys_[i]));
+      obj["sortingOrders"].push_back(
+          serializeSortingOrders(sortingOrders_[i]));
+    }
+  }
+
   obj["ignoreNullKeys"] = ignoreNullKeys_;
   return obj;
 }
@@ -280,6 +426,24 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
     }
   }
 
+  std::vector<bool> distinctFlags;
+  if (obj.count("distinctFlags")) {
+    for (const auto& flag : obj["distinctFlags"]) {
+      distinctFlags.push_back(flag.asBool());
+    }
+  }
+
+  std::vector<std::vector<FieldAccessTypedExprPtr>> sortingKeys;
+  std::vector<std::vector<SortOrder>> sortingOrders;
+  if (obj.count("sortingKeys")) {
+    for (const auto& keys : obj["sortingKeys"]) {
+      sortingKeys.push_back(deserializeFields(keys, context));
+    }
+    for (const auto& orders : obj["sortingOrders"]) {
+      sortingOrders.push_back(deserializeSortingOrders(orders));
+    }
+  }
+
   return std::make_shared<AggregationNode>(
       deserializePlanNodeId(obj),
       stepFromName(obj["step"].asString()),
@@ -288,6 +452,9 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
       aggregateNames,
       aggregates,
       masks,
+      distinctFlags,
+      sortingKeys,
+      sortingOrders,
       obj["ignoreNullKeys"].asBool(),
       deserializeSingleSource(obj, context));
 }
@@ -850,11 +1017,15 @@ void HashJoinNode::addDetails(std::stringstream& stream) const {
   if (nullAware_) {
     stream << ", null aware";
   }
+  if (useHashTableCache_) {
+    stream << ", hash table cache";
+  }
 }
 
 folly::dynamic HashJoinNode::serialize() const {
   auto obj = serializeBase();
   obj["nullAware"] = nullAware_;
+  obj["useHashTableCache"] = useHashTableCache_;
   return obj;
 }
 
@@ -873,6 +1044,9 @@ PlanNodePtr HashJoinNode::create(const folly::dynamic& obj, void* context) {
   }
 
   auto outputType = deserializeRowType(obj["outputType"]);
+  const bool useHashTableCache = obj.count("useHashTableCache")
+      ? obj["useHashTableCache"].asBool()
+      : false;
 
   return std::make_shared<HashJoinNode>(
       deserializePlanNodeId(obj),
@@ -883,7 +1057,8 @@ PlanNodePtr HashJoinNode::create(const folly::dynamic& obj, void* context) {
       filter,
       sources[0],
       sources[1],
-      outputType);
+      outputType,
+      useHashTableCache);
 }
 
 folly::dynamic MergeJoinNode::serialize() const {
@@ -934,7 +1109,10 @@ NestedLoopJoinNode::NestedLoopJoinNode(
       "{} unsupported, NestedLoopJoin only supports inner and outer join",
       joinTypeName(joinType_));
   if (joinCondition_ != nullptr) {
-    VELOX_NYI("NestedLoopJoin does not support join condition.");
+    VELOX_USER_CHECK(
+        joinCondition_->type()->kind() == TypeKind::BOOLEAN,
+        "NestedLoopJoin condition must be boolean: {}",
+        joinCondition_->type()->toString());
   }
 
   auto leftType = sources_[0]->outputType();
@@ -1045,6 +1223,41 @@ PlanNodePtr AssignUniqueIdNode::create(
       std::move(source));
 }
 
+GlobalRowNumberNode::GlobalRowNumberNode(
+    const PlanNodeId& id,
+    const std::string& rowNumberName,
+    PlanNodePtr source)
+    : PlanNode(id), sources_{std::move(source)} {
+  std::vector<std::string> names(sources_[0]->outputType()->names());
+  std::vector<TypePtr> types(sources_[0]->outputType()->children());
+
+  names.emplace_back(rowNumberName);
+  types.emplace_back(BIGINT());
+  outputType_ = ROW(std::move(names), std::move(types));
+}
+
+void GlobalRowNumberNode::addDetails(std::stringstream& /* stream */) const {
+  // Nothing to add.
+}
+
+folly::dynamic GlobalRowNumberNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["rowNumberName"] = outputType_->names().back();
+  return obj;
+}
+
+// static
+PlanNodePtr GlobalRowNumberNode::create(
+    const folly::dynamic& obj,
+    void* context) {
+  auto source = deserializeSingleSource(obj, context);
+
+  return std::make_shared<GlobalRowNumberNode>(
+      deserializePlanNodeId(obj),
+      obj["rowNumberName"].asString(),
+      std::move(source));
+}
+
 namespace {
 RowTypePtr getWindowOutputType(
     const RowTypePtr& inputType,
@@ -1099,12 +1312,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -1216,26 +1431,6 @@ WindowNode::Function WindowNode::Function::deserialize(
       obj["ignoreNulls"].asBool()};
 }
 
-namespace {
-folly::dynamic serializeSortingOrders(
-    const std::vector<SortOrder>& sortingOrders) {
-  auto array = folly::dynamic::array();
-  for (const auto& order : sortingOrders) {
-    array.push_back(order.serialize());
-  }
-
-  return array;
-}
-
-std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
-  std::vector<SortOrder> sortingOrders;
-  for (const auto& order : array) {
-    sortingOrders.push_back(SortOrder::deserialize(order));
-  }
-  return sortingOrders;
-}
-} // namespace
-
 folly::dynamic WindowNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
@@ -1254,6 +1449,7 @@ folly::dynamic WindowNode::serialize() const {
     windowNames.push_back(outputType_->nameOf(i));
   }
   obj["names"] = ISerializable::serialize(windowNames);
+  obj["inputsSorted"] = inputsSorted_;
 
   return obj;
 }
@@ -1280,23 +1476,10 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
       sortingOrders,
       windowNames,
       functions,
+      obj["inputsSorted"].asBool(),
       source);
 }
 
-namespace {
-void addSortingKeys(
-    std::stringstream& stream,
-    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
-    const std::vector<SortOrder>& sortingOrders) {
-  for (auto i = 0; i < sortingKeys.size(); ++i) {
-    if (i > 0) {
-      stream << ", ";
-    }
-    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
-  }
-}
-} // namespace
-
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
@@ -1361,7 +1544,9 @@ PlanNodePtr MergeExchangeNode::create(
 
 void LocalPartitionNode::addDetails(std::stringstream& stream) const {
   stream << typeName(type_);
-  if (type_ != Type::kGather) {
+  if (scaleWriter_) {
+    stream << " scaleWriter";
+  } else if (type_ != Type::kGather) {
     stream << " " << partitionFunctionSpec_->toString();
   }
 }
@@ -1370,6 +1555,7 @@ folly::dynamic LocalPartitionNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["type"] = typeName(type_);
   obj["partitionFunctionSpec"] = partitionFunctionSpec_->serialize();
+  obj["scaleWriter"] = scaleWriter_;
   return obj;
 }
 
@@ -1382,7 +1568,8 @@ PlanNodePtr LocalPartitionNode::create(
       typeFromName(obj["type"].asString()),
       ISerializable::deserialize<PartitionFunctionSpec>(
           obj["partitionFunctionSpec"]),
-      deserializeSources(obj, context));
+      deserializeSources(obj, context),
+      obj.getDefault("scaleWriter", false).asBool());
 }
 
 // static
@@ -1566,6 +1753,10 @@ PlanNodePtr OrderByNode::create(const folly::dynamic& obj, void* context) {
 }
 
 void WindowNode::addDetails(std::stringstream& stream) const {
+  if (inputsSorted_) {
+    stream << "STREAMING ";
+  }
+
   stream << "partition by [";
   if (!partitionKeys_.empty()) {
     addFields(stream, partitionKeys_);
@@ -1587,6 +1778,111 @@ void WindowNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+namespace {
+RowTypePtr getTopNRowNumberOutputType(
+    const RowTypePtr& inputType,
+    const std::optional<std::string>& rowNumberColumnName) {
+  if (!rowNumberColumnName.has_value()) {
+    return inputType;
+  }
+
+  auto names = inputType->names();
+  auto types = inputType->children();
+  names.push_back(rowNumberColumnName.value());
+  types.push_back(BIGINT());
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+TopNRowNumberNode::TopNRowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    std::vector<FieldAccessTypedExprPtr> sortingKeys,
+    std::vector<SortOrder> sortingOrders,
+    const std::optional<std::string>& rowNumberColumnName,
+    int32_t limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      sortingKeys_(std::move(sortingKeys)),
+      sortingOrders_(std::move(sortingOrders)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getTopNRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_USER_CHECK(
+      !sortingKeys_.empty(), "TopNRowNumber must specify sorting keys");
+  VELOX_USER_CHECK_EQ(
+      sortingKeys_.size(),
+      sortingOrders_.size(),
+      "Number of sorting keys must be equal to the number of sorting orders");
+  VELOX_USER_CHECK_GT(
+      limit_, 0, "TopNRowNumber must specify greater than zero limit");
+
+  std::unordered_set<std::string> keyNames;
+  for (const auto& key : partitionKeys_) {
+    keyNames.insert(key->name());
+  }
+  for (const auto& key : sortingKeys_) {
+    VELOX_USER_CHECK_EQ(
+        keyNames.count(key->name()),
+        0,
+        "Partitioning keys must not overlap with sorting keys: {}",
+        key->name());
+  }
+}
+
+void TopNRowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "] ";
+
+  stream << "order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  stream << "limit " << limit_;
+}
+
+folly::dynamic TopNRowNumberNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
+  obj["sortingKeys"] = ISerializable::serialize(sortingKeys_);
+  obj["sortingOrders"] = serializeSortingOrders(sortingOrders_);
+  if (generateRowNumber()) {
+    obj["rowNumberColumnName"] = outputType_->names().back();
+  }
+  obj["limit"] = limit_;
+  return obj;
+}
+
+// static
+PlanNodePtr TopNRowNumberNode::create(
+    const folly::dynamic& obj,
+    void* context) {
+  auto source = deserializeSingleSource(obj, context);
+  auto partitionKeys = deserializeFields(obj["partitionKeys"], context);
+  auto sortingKeys = deserializeFields(obj["sortingKeys"], context);
+  auto sortingOrders = deserializeSortingOrders(obj["sortingOrders"]);
+
+  std::optional<std::string> rowNumberColumnName;
+  if (obj.count("rowNumberColumnName")) {
+    rowNumberColumnName = obj["rowNumberColumnName"].asString();
+  }
+
+  return std::make_shared<TopNRowNumberNode>(
+      deserializePlanNodeId(obj),
+      partitionKeys,
+      sortingKeys,
+      sortingOrders,
+      rowNumberColumnName,
+      obj["limit"].asInt(),
+      source);
+}
+
 void PlanNode::toString(
     std::stringstream& stream,
     bool detailed,
@@ -1653,6 +1949,7 @@ void PlanNode::registerSerDe() {
   registry.Register("EnforceSingleRowNode", EnforceSingleRowNode::create);
   registry.Register("ExchangeNode", ExchangeNode::create);
   registry.Register("FilterNode", FilterNode::create);
+  registry.Register("GlobalRowNumberNode", GlobalRowNumberNode::create);
   registry.Register("GroupIdNode", GroupIdNode::create);
   registry.Register("HashJoinNode", HashJoinNode::create);
   registry.Register("MergeExchangeNode", MergeExchangeNode::create);
@@ -1670,6 +1967,7 @@ void PlanNode::registerSerDe() {
   registry.Register("UnnestNode", UnnestNode::create);
   registry.Register("ValuesNode", ValuesNode::create);
   registry.Register("WindowNode", WindowNode::create);
+  registry.Register("TopNRowNumberNode", TopNRowNumberNode::create);
   registry.Register(
       "GatherPartitionFunctionSpec", GatherPartitionFunctionSpec::deserialize);
 }
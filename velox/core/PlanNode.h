@@ -548,6 +548,12 @@ class TableWriteNode : public PlanNode {
     return commitStrategy_;
   }
 
+  // Data sinks that buffer rows, e.g. for writing sorted files, may spill
+  // these.
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.writerSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TableWrite";
   }
@@ -604,6 +610,50 @@ class AggregationNode : public PlanNode {
       bool ignoreNullKeys,
       PlanNodePtr source);
 
+  /**
+   * Same as above, but also allows to compute some of the aggregates over
+   * distinct values of their inputs, e.g. count(DISTINCT a).
+   *
+   * @param distinctFlags Can be empty or have one element per aggregate. True
+   * elements mark the aggregates that only see each combination of grouping
+   * keys and argument values once. Only supported for the single step.
+   */
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& distinctFlags,
+      bool ignoreNullKeys,
+      PlanNodePtr source);
+
+  /**
+   * Same as above, but also allows to feed some of the aggregates their input
+   * in a given order within each group, e.g. array_agg(a ORDER BY b).
+   *
+   * @param sortingKeys Can be empty or have one element per aggregate. A
+   * non-empty element lists the keys on which the input of the aggregate is
+   * sorted. Only supported for the single step.
+   * @param sortingOrders Has the same shape as 'sortingKeys' and gives the
+   * order of each key.
+   */
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& distinctFlags,
+      const std::vector<std::vector<FieldAccessTypedExprPtr>>& sortingKeys,
+      const std::vector<std::vector<SortOrder>>& sortingOrders,
+      bool ignoreNullKeys,
+      PlanNodePtr source);
+
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
   }
@@ -636,6 +686,40 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  /// Empty or one flag per aggregate. True if the aggregate is computed over
+  /// distinct values of its inputs.
+  const std::vector<bool>& distinctFlags() const {
+    return distinctFlags_;
+  }
+
+  /// Returns true if at least one of the aggregates is computed over distinct
+  /// values of its inputs.
+  bool hasDistinctAggregates() const {
+    return std::find(distinctFlags_.begin(), distinctFlags_.end(), true) !=
+        distinctFlags_.end();
+  }
+
+  /// Empty or one list of sorting keys per aggregate. The aggregates with a
+  /// non-empty list receive the input of each group sorted on these keys.
+  const std::vector<std::vector<FieldAccessTypedExprPtr>>& sortingKeys()
+      const {
+    return sortingKeys_;
+  }
+
+  /// The sort orders of the keys in 'sortingKeys()'.
+  const std::vector<std::vector<SortOrder>>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  /// Returns true if at least one of the aggregates receives its input in a
+  /// given order.
+  bool hasSortedAggregates() const {
+    return std::any_of(
+        sortingKeys_.begin(), sortingKeys_.end(), [](const auto& keys) {
+          return !keys.empty();
+        });
+  }
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -676,6 +760,9 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  const std::vector<bool> distinctFlags_;
+  const std::vector<std::vector<FieldAccessTypedExprPtr>> sortingKeys_;
+  const std::vector<std::vector<SortOrder>> sortingOrders_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -1013,15 +1100,22 @@ class LocalPartitionNode : public PlanNode {
 
   static Type typeFromName(const std::string& name);
 
+  /// @param scaleWriter If true, the rows go to the first of the downstream
+  /// drivers at first and are spread over more of these as long as the
+  /// downstream pipeline can't keep up. Used in front of table writers to
+  /// write as few files as the input rate allows. The partition function
+  /// is not used then. Requires type kRepartition.
   LocalPartitionNode(
       const PlanNodeId& id,
       Type type,
       PartitionFunctionSpecPtr partitionFunctionSpec,
-      std::vector<PlanNodePtr> sources)
+      std::vector<PlanNodePtr> sources,
+      bool scaleWriter = false)
       : PlanNode(id),
         type_{type},
         sources_{std::move(sources)},
-        partitionFunctionSpec_{std::move(partitionFunctionSpec)} {
+        partitionFunctionSpec_{std::move(partitionFunctionSpec)},
+        scaleWriter_{scaleWriter} {
     VELOX_USER_CHECK_GT(
         sources_.size(),
         0,
@@ -1029,6 +1123,10 @@ class LocalPartitionNode : public PlanNode {
 
     VELOX_USER_CHECK_NOT_NULL(partitionFunctionSpec_);
 
+    VELOX_USER_CHECK(
+        !scaleWriter_ || type_ == Type::kRepartition,
+        "Local writer scaling requires a repartitioning node");
+
     for (auto i = 1; i < sources_.size(); ++i) {
       VELOX_USER_CHECK(
           *sources_[i]->outputType() == *sources_[0]->outputType(),
@@ -1064,6 +1162,10 @@ class LocalPartitionNode : public PlanNode {
     return *partitionFunctionSpec_;
   }
 
+  bool scaleWriter() const {
+    return scaleWriter_;
+  }
+
   std::string_view name() const override {
     return "LocalPartition";
   }
@@ -1078,6 +1180,7 @@ class LocalPartitionNode : public PlanNode {
   const Type type_;
   const std::vector<PlanNodePtr> sources_;
   const PartitionFunctionSpecPtr partitionFunctionSpec_;
+  const bool scaleWriter_;
 };
 
 class PartitionedOutputNode : public PlanNode {
@@ -1422,7 +1525,8 @@ class HashJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      const RowTypePtr outputType)
+      const RowTypePtr outputType,
+      bool useHashTableCache = false)
       : AbstractJoinNode(
             id,
             joinType,
@@ -1432,7 +1536,15 @@ class HashJoinNode : public AbstractJoinNode {
             left,
             right,
             outputType),
-        nullAware_{nullAware} {
+        nullAware_{nullAware},
+        useHashTableCache_{useHashTableCache} {
+    if (useHashTableCache) {
+      VELOX_USER_CHECK(
+          isInnerJoin() || isLeftJoin() || isLeftSemiFilterJoin() ||
+              isLeftSemiProjectJoin() || isAntiJoin(),
+          "Hash table cache is not supported for {} join",
+          joinTypeName(joinType));
+    }
     if (nullAware) {
       VELOX_USER_CHECK(
           isNullAwareSupported(joinType),
@@ -1457,14 +1569,25 @@ class HashJoinNode : public AbstractJoinNode {
     // filter set. It requires to cross join the null-key probe rows with all
     // the build-side rows for filter evaluation which is not supported under
     // spilling.
+    // NOTE: a table shared through the hash table cache must cover all the
+    // build side keys.
     return !(isAntiJoin() && nullAware_ && filter() != nullptr) &&
-        queryConfig.joinSpillEnabled();
+        !useHashTableCache_ && queryConfig.joinSpillEnabled();
   }
 
   bool isNullAware() const {
     return nullAware_;
   }
 
+  /// If true, all the tasks of the query running this node on a worker share
+  /// the hash table built by the first of these tasks, see
+  /// exec::HashTableCache. Only valid for broadcast joins where all these
+  /// tasks get the same build side input, and for join types that don't mark
+  /// the probed build side rows.
+  bool useHashTableCache() const {
+    return useHashTableCache_;
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1473,6 +1596,8 @@ class HashJoinNode : public AbstractJoinNode {
   void addDetails(std::stringstream& stream) const override;
 
   const bool nullAware_;
+
+  const bool useHashTableCache_;
 };
 
 /// Represents inner/outer/semi/anti merge joins. Translates to an
@@ -1505,6 +1630,16 @@ class MergeJoinNode : public AbstractJoinNode {
     return "MergeJoin";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: a spilled right side match is read back one batch at a time and
+    // joined with all the left side rows of the match, so that the output
+    // rows of a left side row are not contiguous. Left join with a filter
+    // needs these to be contiguous to find the left side rows without a
+    // passing match.
+    return !(isLeftJoin() && filter() != nullptr) &&
+        queryConfig.mergeJoinSpillEnabled();
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1516,7 +1651,9 @@ class MergeJoinNode : public AbstractJoinNode {
 /// side when generating exec::Operators.
 /// Nested loop join supports both equal and non-equal joins. Expressions
 /// specified in joinCondition are evaluated on every combination of left/right
-/// tuple, to emit result.
+/// tuple, to emit result. The condition is evaluated by the probe one build
+/// batch at a time, so the full cross product is never materialized. The build
+/// side can be spilled if it does not fit in memory.
 /// This also replaces CrossJoinNode, as cross join is equivalent to inner join
 /// on TRUE. To create a plan node for cross join, use the constructor without
 /// `joinType` and `joinCondition` parameter.
@@ -1556,6 +1693,10 @@ class NestedLoopJoinNode : public PlanNode {
     return joinType_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.nestedLoopJoinSpillEnabled();
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1687,6 +1828,12 @@ class TopNNode : public PlanNode {
     return isPartial_;
   }
 
+  /// A partial TopN keeps at most 'count' rows per driver, so only the final
+  /// TopN spills.
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return !isPartial_ && queryConfig.topNSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TopN";
   }
@@ -1911,6 +2058,42 @@ class AssignUniqueIdNode : public PlanNode {
   std::shared_ptr<std::atomic_int64_t> uniqueIdCounter_;
 };
 
+/// Adds a new BIGINT column named 'rowNumberName' at the end of the input
+/// columns that numbers the rows of all the drivers of a task from 1 without
+/// gaps. The rows of the first driver get the lowest numbers, followed by the
+/// rows of the second driver and so on, each driver in input order. Unlike
+/// row_number() over an unpartitioned window, this runs in any number of
+/// drivers.
+class GlobalRowNumberNode : public PlanNode {
+ public:
+  GlobalRowNumberNode(
+      const PlanNodeId& id,
+      const std::string& rowNumberName,
+      PlanNodePtr source);
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  std::string_view name() const override {
+    return "GlobalRowNumber";
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<PlanNodePtr> sources_;
+  RowTypePtr outputType_;
+};
+
 /// PlanNode used for evaluating Sql window functions.
 /// All window functions evaluated in the operator have the same
 /// window spec (partition keys + order columns).
@@ -1971,6 +2154,9 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted specifies if the input is already sorted on the
+  /// partition and sorting keys. If true, the window functions are evaluated
+  /// in a streaming fashion keeping only the current partition in memory.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1978,6 +2164,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -2006,6 +2193,23 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  /// Returns true if the input is sorted on the partition and sorting keys,
+  /// in which case the window functions are evaluated one partition at a time
+  /// as the input arrives.
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: spilling requires at least one partition or sorting key to split
+    // the input into sorted runs which can be read back one partition at a
+    // time. Streaming window doesn't buffer the input beyond the current
+    // partition so it doesn't need to spill.
+    return !inputsSorted_ &&
+        (!partitionKeys_.empty() || !sortingKeys_.empty()) &&
+        queryConfig.windowSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -2024,6 +2228,88 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Optimized version of a WindowNode for a single row_number function with a
+/// limit over sorted partitions. The output of this node contains all input
+/// columns followed by an optional 'rowNumberColumnName' BIGINT column. Only
+/// the first 'limit' rows of each partition are returned.
+class TopNRowNumberNode : public PlanNode {
+ public:
+  /// @param partitionKeys Partitioning keys. May be empty.
+  /// @param sortingKeys Sorting keys. May not be empty and may not intersect
+  /// with 'partitionKeys'.
+  /// @param sortingOrders Sorting orders, one per sorting key.
+  /// @param rowNumberColumnName Optional name of the column containing row
+  /// numbers. If not specified, the output doesn't include 'row number'
+  /// column. This is used when computing partial results.
+  /// @param limit Per-partition limit. Must be greater than zero.
+  TopNRowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      std::vector<FieldAccessTypedExprPtr> sortingKeys,
+      std::vector<SortOrder> sortingOrders,
+      const std::optional<std::string>& rowNumberColumnName,
+      int32_t limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  int32_t limit() const {
+    return limit_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: with no partition keys there is a single bounded set of top rows,
+    // so there is nothing to gain from spilling.
+    return !partitionKeys_.empty() && queryConfig.topNRowNumberSpillEnabled();
+  }
+
+  std::string_view name() const override {
+    return "TopNRowNumber";
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
+
+  const int32_t limit_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
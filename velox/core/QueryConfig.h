@@ -87,15 +87,91 @@ class QueryConfig {
   static constexpr const char* kMaxLocalExchangeBufferSize =
       "max_local_exchange_buffer_size";
 
+  /// The number of bytes a producer of a writer scaling local exchange sends
+  /// after adding a table writer driver before it may add another one.
+  static constexpr const char* kScaleWriterMinProcessedBytes =
+      "scale_writer_min_processed_bytes";
+
+  /// A hash partitioning local exchange sends the rows of an input batch for
+  /// a partition as a dictionary over the input if there are at least this
+  /// many. Fewer rows are copied into a batch for the partition that is sent
+  /// once it has this many rows. 0 sends all rows as dictionaries.
+  static constexpr const char* kLocalExchangeMinBatchRows =
+      "local_exchange_min_batch_rows";
+
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
   static constexpr const char* kMaxExtendedPartialAggregationMemory =
       "max_extended_partial_aggregation_memory";
 
+  /// Number of input rows a partial aggregation must see before it may give up
+  /// on reducing the input, see kAbandonPartialAggregationMinPct.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// A partial aggregation that has seen at least
+  /// kAbandonPartialAggregationMinRows input rows and produced groups for at
+  /// least this percentage of them stops hashing and converts each input row
+  /// into intermediate results directly. Requires kHashAdaptivityEnabled.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// If true, the drivers of a partial aggregation with grouping keys share
+  /// their hash tables. Each group is accumulated by the table of one driver,
+  /// picked by the hash of its keys, so that a group seen by several drivers
+  /// produces one partial result instead of one per driver.
+  static constexpr const char* kSharedPartialAggregationEnabled =
+      "shared_partial_aggregation_enabled";
+
+  /// If true, a hash join build side whose keys have too many distinct values
+  /// for an exact dynamic filter pushes down a Bloom filter over the key values
+  /// instead. Applies to inner and semi joins on integer or string keys.
+  static constexpr const char* kJoinBloomFilterEnabled =
+      "join_bloom_filter_enabled";
+
+  /// Maximum number of distinct build side keys for which a join Bloom filter
+  /// is built. Larger build sides produce no Bloom filter.
+  static constexpr const char* kJoinBloomFilterMaxRows =
+      "join_bloom_filter_max_rows";
+
+  /// Minimum number of build side rows of an inner hash join without a filter
+  /// for swapping the build and probe sides at run time when the probe side is
+  /// found to be smaller. 0 disables the swap. Applies only to joins that do
+  /// not spill.
+  static constexpr const char* kJoinSwapMinBuildRows =
+      "join_swap_min_build_rows";
+
+  /// Maximum bytes of probe input each HashProbe buffers while waiting for the
+  /// build side when kJoinSwapMinBuildRows is set. A probe side that does not
+  /// fit is never swapped with the build side.
+  static constexpr const char* kJoinSwapMaxProbeBufferBytes =
+      "join_swap_max_probe_buffer_bytes";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// PartitionedOutput operators with at least this many destinations buffer
+  /// rows row-wise and flush the largest destinations when the buffer is
+  /// full. 0 disables this.
+  static constexpr const char* kPartitionedOutputRowWiseDestinations =
+      "driver.partitioned-output-row-wise-destinations";
+
+  /// The codec for compressing the pages sent between tasks, one of "none",
+  /// "lz4", "zstd", "snappy" or "zlib". Must be the same on the producing and
+  /// consuming tasks.
+  static constexpr const char* kShuffleCompressionCodec =
+      "shuffle-compression-codec";
+
+  /// If true, the pages sent between tasks keep the dictionary and constant
+  /// encodings of their columns.
+  static constexpr const char* kShufflePreserveEncodings =
+      "shuffle-preserve-encodings";
+
+  /// If true, the pages sent between tasks reference the memory of the
+  /// serialized columns instead of a copy of it.
+  static constexpr const char* kShuffleZeroCopy = "shuffle-zero-copy";
+
   /// Preferred size of batches in bytes to be returned by operators from
   /// Operator::getOutput. It is used when an estimate of average row size is
   /// known. Otherwise kPreferredOutputBatchRows is used.
@@ -115,6 +191,112 @@ class QueryConfig {
   /// output rows.
   static constexpr const char* kMaxOutputBatchRows = "max_output_batch_rows";
 
+  /// If set, a final OrderBy runs in as many drivers as the pipeline of its
+  /// source allows when the task runs in multiple drivers. Each driver sorts
+  /// its part of the input and a LocalMerge merges the sorted runs.
+  static constexpr const char* kParallelOrderByEnabled =
+      "parallel_order_by_enabled";
+
+  /// If set, an aggregation over a GroupId first aggregates the input of the
+  /// GroupId on all the grouping keys, so that the GroupId replicates the
+  /// partial results instead of every input row once per grouping set.
+  static constexpr const char* kGroupingSetsPreAggregationEnabled =
+      "grouping_sets_pre_aggregation_enabled";
+
+  /// If set, a filter over a table scan is evaluated by the DataSource of the
+  /// scan if its connector supports it, instead of by a FilterProject over
+  /// the scan output. See Connector::pushdownFilter().
+  static constexpr const char* kScanFilterPushdownEnabled =
+      "scan_filter_pushdown_enabled";
+
+  /// The CPU share of the query on a MultiLevelTaskExecutor relative to the
+  /// other queries that have Drivers queued on the same level.
+  static constexpr const char* kQueryCpuShares = "query_cpu_shares";
+
+  /// If set, the subexpressions of a lambda body that depend only on captured
+  /// columns are evaluated once per row of the enclosing expression instead
+  /// of once per element and are shared with identical subexpressions outside
+  /// of the lambda.
+  static constexpr const char* kExprLambdaHoistingEnabled =
+      "expression.lambda_hoisting_enabled";
+
+  /// If set, calls of the functions listed in kExprValueMemoFunctions whose
+  /// only non-constant argument is a string remember their results by argument
+  /// value across batches, see exec::ValueMemo.
+  static constexpr const char* kExprValueMemoEnabled =
+      "expression.value_memo_enabled";
+
+  /// Comma separated names of the functions memoized when
+  /// kExprValueMemoEnabled is set.
+  static constexpr const char* kExprValueMemoFunctions =
+      "expression.value_memo_functions";
+
+  /// The memory a single memoized function call may use for remembered
+  /// arguments and results.
+  static constexpr const char* kExprValueMemoMaxBytes =
+      "expression.value_memo_max_bytes";
+
+  /// If set, FilterProject evaluates filters and projections that only use
+  /// arithmetic, comparisons and logical operators over numeric and boolean
+  /// columns with a fused kernel compiled in process, see exec::FusedKernel.
+  /// Batches the kernel can't handle are evaluated by the interpreter.
+  static constexpr const char* kExprFusedKernelsEnabled =
+      "expression.fused_kernels_enabled";
+
+  /// If set, the per split results of partial aggregations over table scans
+  /// are cached in exec::FragmentResultCache and reused by later queries that
+  /// run the same plan fragment over the same splits.
+  static constexpr const char* kFragmentResultCacheEnabled =
+      "fragment_result_cache_enabled";
+
+  /// If set, each Driver records the intervals it spends queued, running and
+  /// blocked, which are returned in the pipeline stats and can be exported
+  /// as a trace. The totals are always recorded.
+  static constexpr const char* kDriverTimelineEnabled =
+      "driver_timeline_enabled";
+
+  /// If set, the Drivers of a pipeline that reads an Exchange are retired
+  /// while data arrives slower than they consume it and made active again
+  /// when data queues up. Retired Drivers wait without being woken by data.
+  static constexpr const char* kAdaptiveExchangeConsumersEnabled =
+      "adaptive_exchange_consumers_enabled";
+
+  /// If set, a Driver that is unblocked by a Driver of the same executor,
+  /// e.g. by a local exchange producer, runs on the thread of the unblocking
+  /// Driver when that returns instead of being enqueued on the executor.
+  static constexpr const char* kInlineDriverResumeEnabled =
+      "inline_driver_resume_enabled";
+
+  /// When the splits left for a table scan are fewer than its drivers, the
+  /// largest is divided into splits of at least this many bytes for the
+  /// drivers that have nothing to do. 0 disables the dividing.
+  static constexpr const char* kMinDividedSplitBytes =
+      "min_divided_split_bytes";
+
+  /// Number of upcoming splits per driver that a table scan prepares in the
+  /// background once the reads of its current split are scheduled. If not
+  /// set, the split_preload_per_driver flag is used. 0 disables preloading.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
+  /// A table scan starts no new split preloads while the memory of the query
+  /// is above this percentage of its capacity.
+  static constexpr const char* kSplitPreloadMaxMemoryPct =
+      "split_preload_max_memory_pct";
+
+  /// If set, a table scan sizes each batch it asks from its data source by
+  /// the bytes per row of its previous batch, so that the batches stay near
+  /// kPreferredOutputBatchBytes even if the rows are much larger than the
+  /// file statistics suggest. Very large rows get batches of a single row.
+  static constexpr const char* kAdaptiveScanBatchSizeEnabled =
+      "adaptive_scan_batch_size_enabled";
+
+  /// If set, the Driver follows each FilterProject with a filter and each
+  /// HashProbe with a BatchCoalescer that concatenates their small output
+  /// batches up to kPreferredOutputBatchRows or kPreferredOutputBatchBytes.
+  static constexpr const char* kCoalesceBatchesEnabled =
+      "coalesce_batches_enabled";
+
   /// It is used when DataBuffer.reserve() method to reallocated buffer size.
   static constexpr const char* kDataBufferGrowRatio = "data_buffer_grow_ratio";
 
@@ -142,11 +324,46 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// TopNRowNumber spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNRowNumberSpillEnabled =
+      "topn_row_number_spill_enabled";
+
+  /// TopN spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNSpillEnabled = "topn_spill_enabled";
+
+  /// MergeJoin spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kMergeJoinSpillEnabled =
+      "merge_join_spill_enabled";
+
+  /// NestedLoopJoin build side spilling flag, only applies if "spill_enabled"
+  /// flag is set.
+  static constexpr const char* kNestedLoopJoinSpillEnabled =
+      "nested_loop_join_spill_enabled";
+
+  /// Table writer spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWriterSpillEnabled = "writer_spill_enabled";
+
+  /// Output buffer spooling flag, only applies if "spill_enabled" flag is set.
+  /// If set, a task's partitioned output buffer writes pages that are waiting
+  /// to be fetched to its spill directory instead of blocking the producers
+  /// when it is full.
+  static constexpr const char* kPartitionedOutputSpoolEnabled =
+      "partitioned_output_spool_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
       "aggregation_spill_memory_threshold";
 
+  /// If true, the drivers of a final aggregation that has spilled merge the
+  /// spilled partitions of all drivers as they become idle, instead of each
+  /// driver merging its own partitions one at a time.
+  static constexpr const char* kAggregationSpillParallelMergeEnabled =
+      "aggregation_spill_parallel_merge_enabled";
+
   /// The max memory that a hash join can use before spilling. If it 0, then
   /// there is no limit.
   static constexpr const char* kJoinSpillMemoryThreshold =
@@ -157,6 +374,32 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
+  /// The max memory that a TopNRowNumber can use before spilling. If it 0,
+  /// then there is no limit.
+  static constexpr const char* kTopNRowNumberSpillMemoryThreshold =
+      "topn_row_number_spill_memory_threshold";
+
+  /// The max memory that a final TopN can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kTopNSpillMemoryThreshold =
+      "topn_spill_memory_threshold";
+
+  /// The max memory that a merge join can use to buffer the right side rows
+  /// with the same join key before spilling these. If it 0, then there is no
+  /// limit.
+  static constexpr const char* kMergeJoinSpillMemoryThreshold =
+      "merge_join_spill_memory_threshold";
+
+  /// The max memory that a nested loop join can use to hold the build side
+  /// rows before spilling these. If it 0, then there is no limit.
+  static constexpr const char* kNestedLoopJoinSpillMemoryThreshold =
+      "nested_loop_join_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -188,6 +431,32 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// The format of spill files, "presto" or "columnar". See
+  /// exec::SpillFileFormat.
+  static constexpr const char* kSpillFileFormat = "spill-file-format";
+
+  /// The codec for compressing spill files, one of "none", "lz4", "zstd",
+  /// "snappy" or "zlib".
+  static constexpr const char* kSpillCompressionCodec =
+      "spill-compression-codec";
+
+  /// Directory under which the input batches of the plan nodes in
+  /// kInputCapturePlanNodeIds are saved for replay. Empty disables capture.
+  static constexpr const char* kInputCaptureDir = "input_capture_dir";
+
+  /// Comma separated ids of the plan nodes whose input is captured.
+  static constexpr const char* kInputCapturePlanNodeIds =
+      "input_capture_plan_node_ids";
+
+  /// Percentage of the input batches of each captured operator that are
+  /// saved.
+  static constexpr const char* kInputCaptureSamplePct =
+      "input_capture_sample_pct";
+
+  /// Maximum bytes of input saved by each captured operator.
+  static constexpr const char* kInputCaptureMaxBytes =
+      "input_capture_max_bytes";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -198,11 +467,44 @@ class QueryConfig {
     return get<uint64_t>(kMaxExtendedPartialAggregationMemory, kDefault);
   }
 
+  int32_t abandonPartialAggregationMinRows() const {
+    return get<int32_t>(kAbandonPartialAggregationMinRows, 100'000);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
+  }
+
+  bool sharedPartialAggregationEnabled() const {
+    return get<bool>(kSharedPartialAggregationEnabled, false);
+  }
+
+  bool joinBloomFilterEnabled() const {
+    return get<bool>(kJoinBloomFilterEnabled, false);
+  }
+
+  int32_t joinBloomFilterMaxRows() const {
+    return get<int32_t>(kJoinBloomFilterMaxRows, 10'000'000);
+  }
+
+  uint64_t joinSwapMinBuildRows() const {
+    return get<uint64_t>(kJoinSwapMinBuildRows, 0);
+  }
+
+  uint64_t joinSwapMaxProbeBufferBytes() const {
+    static constexpr uint64_t kDefault = 16UL << 20;
+    return get<uint64_t>(kJoinSwapMaxProbeBufferBytes, kDefault);
+  }
+
   uint64_t aggregationSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kAggregationSpillMemoryThreshold, kDefault);
   }
 
+  bool aggregationSpillParallelMergeEnabled() const {
+    return get<bool>(kAggregationSpillParallelMergeEnabled, false);
+  }
+
   uint64_t joinSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kJoinSpillMemoryThreshold, kDefault);
@@ -213,6 +515,31 @@ class QueryConfig {
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNRowNumberSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNRowNumberSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t mergeJoinSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 256UL << 20;
+    return get<uint64_t>(kMergeJoinSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t nestedLoopJoinSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 256UL << 20;
+    return get<uint64_t>(kNestedLoopJoinSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -222,11 +549,36 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  uint32_t partitionedOutputRowWiseDestinations() const {
+    return get<uint32_t>(kPartitionedOutputRowWiseDestinations, 0);
+  }
+
+  std::string shuffleCompressionCodec() const {
+    return get<std::string>(kShuffleCompressionCodec, "none");
+  }
+
+  bool shufflePreserveEncodings() const {
+    return get<bool>(kShufflePreserveEncodings, false);
+  }
+
+  bool shuffleZeroCopy() const {
+    return get<bool>(kShuffleZeroCopy, false);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
   }
 
+  uint64_t scaleWriterMinProcessedBytes() const {
+    static constexpr uint64_t kDefault = 32UL << 20;
+    return get<uint64_t>(kScaleWriterMinProcessedBytes, kDefault);
+  }
+
+  uint32_t localExchangeMinBatchRows() const {
+    return get<uint32_t>(kLocalExchangeMinBatchRows, 0);
+  }
+
   uint64_t preferredOutputBatchBytes() const {
     static constexpr uint64_t kDefault = 10UL << 20;
     return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
@@ -240,6 +592,86 @@ class QueryConfig {
     return get<uint32_t>(kMaxOutputBatchRows, 10'000);
   }
 
+  bool parallelOrderByEnabled() const {
+    return get<bool>(kParallelOrderByEnabled, false);
+  }
+
+  bool groupingSetsPreAggregationEnabled() const {
+    return get<bool>(kGroupingSetsPreAggregationEnabled, false);
+  }
+
+  bool scanFilterPushdownEnabled() const {
+    return get<bool>(kScanFilterPushdownEnabled, false);
+  }
+
+  uint32_t cpuShares() const {
+    return get<uint32_t>(kQueryCpuShares, 1);
+  }
+
+  bool exprLambdaHoistingEnabled() const {
+    return get<bool>(kExprLambdaHoistingEnabled, false);
+  }
+
+  bool exprValueMemoEnabled() const {
+    return get<bool>(kExprValueMemoEnabled, false);
+  }
+
+  std::string exprValueMemoFunctions() const {
+    static const std::string kDefault =
+        "regexp_extract,regexp_like,regexp_replace,json_extract,"
+        "json_extract_scalar,json_array_length,json_size,url_extract_host,"
+        "url_extract_path,url_extract_protocol,url_extract_port,"
+        "url_extract_query,url_extract_fragment,url_extract_parameter,"
+        "parse_datetime,date_parse";
+    return get<std::string>(kExprValueMemoFunctions, kDefault);
+  }
+
+  uint64_t exprValueMemoMaxBytes() const {
+    static constexpr uint64_t kDefault = 1L << 24;
+    return get<uint64_t>(kExprValueMemoMaxBytes, kDefault);
+  }
+
+  bool exprFusedKernelsEnabled() const {
+    return get<bool>(kExprFusedKernelsEnabled, false);
+  }
+
+  bool fragmentResultCacheEnabled() const {
+    return get<bool>(kFragmentResultCacheEnabled, false);
+  }
+
+  bool driverTimelineEnabled() const {
+    return get<bool>(kDriverTimelineEnabled, false);
+  }
+
+  bool adaptiveExchangeConsumersEnabled() const {
+    return get<bool>(kAdaptiveExchangeConsumersEnabled, false);
+  }
+
+  bool inlineDriverResumeEnabled() const {
+    return get<bool>(kInlineDriverResumeEnabled, false);
+  }
+
+  uint64_t minDividedSplitBytes() const {
+    static constexpr uint64_t kDefault = 64UL << 20;
+    return get<uint64_t>(kMinDividedSplitBytes, kDefault);
+  }
+
+  std::optional<int32_t> maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver);
+  }
+
+  int32_t splitPreloadMaxMemoryPct() const {
+    return get<int32_t>(kSplitPreloadMaxMemoryPct, 50);
+  }
+
+  bool adaptiveScanBatchSizeEnabled() const {
+    return get<bool>(kAdaptiveScanBatchSizeEnabled, false);
+  }
+
+  bool coalesceBatchesEnabled() const {
+    return get<bool>(kCoalesceBatchesEnabled, false);
+  }
+
   uint32_t dataBufferGrowRatio() const {
     return get<uint32_t>(kDataBufferGrowRatio, 1);
   }
@@ -336,6 +768,46 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
+  /// Returns 'is topn row number spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNRowNumberSpillEnabled() const {
+    return get<bool>(kTopNRowNumberSpillEnabled, true);
+  }
+
+  /// Returns 'is topn spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNSpillEnabled() const {
+    return get<bool>(kTopNSpillEnabled, true);
+  }
+
+  /// Returns 'is merge join spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool mergeJoinSpillEnabled() const {
+    return get<bool>(kMergeJoinSpillEnabled, true);
+  }
+
+  /// Returns 'is nested loop join spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool nestedLoopJoinSpillEnabled() const {
+    return get<bool>(kNestedLoopJoinSpillEnabled, true);
+  }
+
+  /// Returns 'is table writer spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool writerSpillEnabled() const {
+    return get<bool>(kWriterSpillEnabled, true);
+  }
+
+  bool partitionedOutputSpoolEnabled() const {
+    return get<bool>(kPartitionedOutputSpoolEnabled, false);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -373,6 +845,31 @@ class QueryConfig {
     return get<uint64_t>(kMinSpillRunSize, kDefaultMinSpillRunSize);
   }
 
+  std::string spillFileFormat() const {
+    return get<std::string>(kSpillFileFormat, "presto");
+  }
+
+  std::string spillCompressionCodec() const {
+    return get<std::string>(kSpillCompressionCodec, "none");
+  }
+
+  std::string inputCaptureDir() const {
+    return get<std::string>(kInputCaptureDir, "");
+  }
+
+  std::string inputCapturePlanNodeIds() const {
+    return get<std::string>(kInputCapturePlanNodeIds, "");
+  }
+
+  int32_t inputCaptureSamplePct() const {
+    return get<int32_t>(kInputCaptureSamplePct, 100);
+  }
+
+  uint64_t inputCaptureMaxBytes() const {
+    constexpr uint64_t kDefault = 64 << 20; // 64MB.
+    return get<uint64_t>(kInputCaptureMaxBytes, kDefault);
+  }
+
   /// Returns the spillable memory reservation growth percentage of the previous
   /// memory reservation size. 25 means exponential growth along a series of
   /// integer powers of 5/4. The reservation grows by this much until it no
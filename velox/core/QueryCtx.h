@@ -96,6 +96,11 @@ class QueryCtx : public Context {
     return allocator_;
   }
 
+  /// Returns true if executor() can be called.
+  bool isExecutorSupplied() const {
+    return executor_ != nullptr || executorKeepalive_.get() != nullptr;
+  }
+
   folly::Executor* FOLLY_NONNULL executor() const {
     if (executor_ != nullptr) {
       return executor_;
@@ -157,7 +162,10 @@ class QueryCtx : public Context {
   void initPool(const std::string& queryId) {
     if (pool_ == nullptr) {
       pool_ = memory::defaultMemoryManager().addRootPool(
-          QueryCtx::generatePoolName(queryId));
+          QueryCtx::generatePoolName(queryId),
+          memory::kMaxMemory,
+          true,
+          memory::MemoryReclaimer::create());
     }
   }
 
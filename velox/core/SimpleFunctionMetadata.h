@@ -506,6 +506,7 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
   // are required to provide at least one of the following methods:
@@ -521,6 +522,7 @@ class UDFHolder final
   //
   // - bool|void callAscii(...)
   // - void initialize(...)
+  // - void callBatch(out*, const arg*..., int32_t size)
 
   // call():
   static constexpr bool udf_has_call_return_bool = util::has_method<
@@ -604,6 +606,17 @@ class UDFHolder final
         (udf_has_callAscii_return_void && udf_has_call_return_bool)),
       "The return type for callAscii() must match the return type for call().");
 
+  // callBatch() computes 'size' consecutive results from arrays of arguments.
+  // It must produce the same results as call() and must not throw. 'out' may
+  // alias an argument.
+  static constexpr bool udf_has_callBatch = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      exec_return_type*,
+      const exec_arg_type<TArgs>*...,
+      int32_t>::value;
+
   // initialize():
   static constexpr bool udf_has_initialize = util::has_method<
       Fun,
@@ -719,6 +732,19 @@ class UDFHolder final
     }
   }
 
+  FOLLY_ALWAYS_INLINE void callBatch(
+      exec_return_type* out,
+      const exec_arg_type<TArgs>*... args,
+      int32_t size) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(out, args..., size);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not "
+          "implement callBatch.");
+    }
+  }
+
   FOLLY_ALWAYS_INLINE bool callNullFree(
       exec_return_type& out,
       const exec_no_nulls_arg_type<TArgs>&... args) {
@@ -165,11 +165,85 @@ int32_t decode1To24(
   return i;
 }
 
+// Loads 4 bit fields of 'width' <= 57 bits at the bit positions in 'indices'
+// into 4x64 lanes.
+template <uint8_t width>
+FOLLY_ALWAYS_INLINE __m256i gather4x64(const uint64_t* bits, __m128i indices) {
+  const auto mask = _mm256_set1_epi64x(bits::lowMask(width));
+  auto byteIndices = _mm_srli_epi32(indices, 3);
+  auto shifts =
+      _mm256_cvtepu32_epi64(_mm_and_si128(indices, _mm_set1_epi32(7)));
+  auto data = _mm256_i32gather_epi64(
+      reinterpret_cast<const long long*>(bits), byteIndices, 1);
+  return _mm256_and_si256(_mm256_srlv_epi64(data, shifts), mask);
+}
+
+// Decodes bit fields of 25-32 bits 8 at a time. A field and its bit offset in
+// its first byte fit in 64 bits, so sparse fields are loaded with 64 bit
+// gathers. 8 contiguous fields are loaded 2 at a time and spread into 32 bit
+// lanes with pdep.
+template <uint8_t width, typename T>
+int32_t decode25To32(
+    const uint64_t* bits,
+    int32_t bitOffset,
+    const int* rows,
+    int32_t numRows,
+    T* result) {
+  static_assert(width >= 25 && width <= 32);
+  constexpr uint64_t kDepMask = kPdepMask32[width];
+  // Permutation that moves the low halves of 4x64 lanes to the first 4x32
+  // lanes.
+  const auto lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  int32_t i = 0;
+  for (; i + 8 <= numRows; i += 8) {
+    auto row = rows[i];
+    if (rows[i + 7] - row == 7) {
+      alignas(32) uint64_t words[4];
+      for (auto j = 0; j < 4; ++j) {
+        words[j] = _pdep_u64(
+            bits::detail::loadBits<uint64_t>(
+                bits, bitOffset + width * (row + 2 * j), 2 * width),
+            kDepMask);
+      }
+      store8Ints(
+          _mm256_load_si256(reinterpret_cast<const __m256i*>(words)),
+          i,
+          result);
+      continue;
+    }
+    auto indices = as256i(
+        *reinterpret_cast<const __m256si_u*>(rows + i) * width + bitOffset);
+    auto low = gather4x64<width>(bits, _mm256_extracti128_si256(indices, 0));
+    auto high = gather4x64<width>(bits, _mm256_extracti128_si256(indices, 1));
+    if (sizeof(T) == 8) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), low);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i + 4), high);
+    } else {
+      store8Ints(
+          _mm256_permute2x128_si256(
+              _mm256_permutevar8x32_epi32(low, lowHalves),
+              _mm256_permutevar8x32_epi32(high, lowHalves),
+              0x20),
+          i,
+          result);
+    }
+  }
+  return i;
+}
+
 #define WIDTH_CASE(width)                                                      \
   case width:                                                                  \
     i = decode1To24<width>(bits, bitOffset, rows.data(), numSafeRows, result); \
     break;
 
+#define WIDE_WIDTH_CASE(width)                                                 \
+  case width:                                                                  \
+    if (sizeof(T) == 4 || sizeof(T) == 8) {                                    \
+      i = decode25To32<width>(                                                 \
+          bits, bitOffset, rows.data(), numSafeRows, result);                  \
+    }                                                                          \
+    break;
+
 } // namespace
 
 #endif
@@ -234,7 +308,7 @@ void unpack(
   int32_t i = 0;
 
 #if XSIMD_WITH_AVX2
-  // Use AVX2 for specific widths.
+  // Use AVX2 and BMI2 for widths up to 32.
   switch (bitWidth) {
     WIDTH_CASE(1);
     WIDTH_CASE(2);
@@ -260,6 +334,14 @@ void unpack(
     WIDTH_CASE(22);
     WIDTH_CASE(23);
     WIDTH_CASE(24);
+    WIDE_WIDTH_CASE(25);
+    WIDE_WIDTH_CASE(26);
+    WIDE_WIDTH_CASE(27);
+    WIDE_WIDTH_CASE(28);
+    WIDE_WIDTH_CASE(29);
+    WIDE_WIDTH_CASE(30);
+    WIDE_WIDTH_CASE(31);
+    WIDE_WIDTH_CASE(32);
     default:
       break;
   }
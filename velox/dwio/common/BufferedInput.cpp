@@ -30,6 +30,8 @@ void BufferedInput::load(const LogType logType) {
 
   offsets_.clear();
   offsets_.reserve(regions_.size());
+  views_.clear();
+  views_.reserve(regions_.size());
   buffers_.clear();
   buffers_.reserve(regions_.size());
 
@@ -49,8 +51,11 @@ void BufferedInput::load(const LogType logType) {
           sizeToRead += length;
         });
 
-    // Now we have all buffers and regions, load it in parallel
-    input_->vread(buffers, regions, logType);
+    // Now we have all buffers and regions, load it in parallel. There are
+    // none to load if the file is mapped.
+    if (!buffers.empty()) {
+      input_->vread(buffers, regions, logType);
+    }
   } else {
     loadWithAction(
         logType,
@@ -155,7 +160,7 @@ std::tuple<const char*, uint64_t> BufferedInput::readInternal(
   if (index >= 1) {
     index -= 1;
     uint64_t bufferOffset = offsets_[index];
-    const auto& buffer = buffers_[index];
+    const auto& buffer = views_[index];
     if (bufferOffset + buffer.size() >= offset + length) {
       DWIO_ENSURE_LE(bufferOffset, offset, "Invalid offset for readInternal");
       DWIO_ENSURE_LE(
@@ -126,6 +126,9 @@ class BufferedInput {
 
  private:
   std::vector<uint64_t> offsets_;
+  // The loaded bytes at each of 'offsets_', either in 'buffers_' or in the
+  // mapping of a ReadFile that supports ReadFile::mappedData().
+  std::vector<std::string_view> views_;
   std::vector<DataBuffer<char>> buffers_;
   std::vector<Region> regions_;
 
@@ -142,12 +145,24 @@ class BufferedInput {
       std::function<void(void* FOLLY_NONNULL, uint64_t, uint64_t, LogType)>
           action) {
     offsets_.push_back(region.offset);
-    DataBuffer<char> buffer(pool_, region.length);
-
     // action is required
     DWIO_ENSURE_NOT_NULL(action);
+
+    const auto& readFile = input_->getReadFile();
+    if (auto* mapped = readFile->mappedData(region.offset, region.length)) {
+      // Uses the mapped bytes instead of a copy. The pages are faulted in
+      // ahead of the decoding.
+      readFile->willNeed(region.offset, region.length);
+      if (auto* stats = input_->getStats()) {
+        stats->incRawBytesRead(region.length);
+      }
+      views_.emplace_back(mapped, region.length);
+      return;
+    }
+    DataBuffer<char> buffer(pool_, region.length);
     action(buffer.data(), region.length, region.offset, logType);
 
+    views_.emplace_back(buffer.data(), region.length);
     buffers_.push_back(std::move(buffer));
   }
 
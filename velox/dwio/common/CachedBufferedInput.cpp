@@ -17,6 +17,7 @@
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -24,6 +25,13 @@ DEFINE_int32(
     80,
     "Minimum percentage of actual uses over references to a column for prefetching. No prefetch if > 100");
 
+DEFINE_bool(
+    adaptive_coalesce,
+    false,
+    "Set the coalescing distance and size of storage reads from the latency "
+    "and bandwidth measured for each file system instead of the configured "
+    "distance");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -215,7 +223,11 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  int32_t maxDistance = isSsd ? 20000 : coalesceDistance();
+  int64_t maxIoBytes = std::numeric_limits<int64_t>::max();
+  if (costModel_ && !isSsd) {
+    maxIoBytes = costModel_->maxCoalesceBytes(maxIoBytes);
+  }
   std::sort(
       requests.begin(),
       requests.end(),
@@ -254,7 +266,8 @@ void CachedBufferedInput::makeLoads(
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
         readRegion(ranges, prefetch);
-      });
+      },
+      maxIoBytes);
   if (prefetch && executor_) {
     std::vector<int32_t> doneIndices;
     for (auto i = 0; i < allCoalescedLoads_.size(); ++i) {
@@ -363,10 +376,12 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      IoCostModel* costModel)
       : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
         input_(std::move(input)),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        costModel_(costModel) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<CachePin> pins;
@@ -383,6 +398,10 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
     if (pins.empty()) {
       return pins;
     }
+    // With a native readAsync(), e.g. parallel ranged GETs, the coalesced
+    // reads are all in flight at the same time.
+    const bool async = input_->hasReadAsync();
+    std::vector<folly::SemiFuture<uint64_t>> reads;
     auto stats = cache::readPins(
         pins,
         maxCoalesceDistance_,
@@ -393,14 +412,50 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
+          const auto startMicros = getCurrentTimeMicro();
+          if (async) {
+            auto read = input_->readAsync(buffers, offset, LogType::FILE);
+            if (costModel_) {
+              read = std::move(read).deferValue(
+                  [costModel = costModel_, bytes = totalSize(buffers),
+                   startMicros](uint64_t size) {
+                    costModel->recordRead(
+                        bytes, getCurrentTimeMicro() - startMicros);
+                    return size;
+                  });
+            }
+            reads.push_back(std::move(read));
+          } else {
+            input_->read(buffers, offset, LogType::FILE);
+            if (costModel_) {
+              costModel_->recordRead(
+                  totalSize(buffers), getCurrentTimeMicro() - startMicros);
+            }
+          }
         });
+    if (!reads.empty()) {
+      // Waits for all reads before checking for errors, so that no read is
+      // left writing into 'pins'.
+      auto results = folly::collectAll(std::move(reads)).get();
+      for (auto& result : results) {
+        result.throwUnlessValue();
+      }
+    }
     updateStats(stats, isPrefetch, false);
     return pins;
   }
 
+  static uint64_t totalSize(const std::vector<folly::Range<char*>>& buffers) {
+    uint64_t size = 0;
+    for (const auto& buffer : buffers) {
+      size += buffer.size();
+    }
+    return size;
+  }
+
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
+  IoCostModel* const costModel_;
 };
 
 // Represents a CoalescedLoad from local SSD cache.
@@ -448,8 +503,22 @@ void CachedBufferedInput::readRegion(
   if (!requests[0]->ssdPin.empty()) {
     load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
   } else {
+    if (prefetch) {
+      // A mapped file starts reading the prefetched range in the kernel
+      // before the load copies it.
+      const auto* last = requests.back();
+      input_->getReadFile()->willNeed(
+          requests[0]->key.offset,
+          last->key.offset + last->size - requests[0]->key.offset);
+    }
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_,
+        input_,
+        ioStats_,
+        groupId_,
+        requests,
+        coalesceDistance(),
+        costModel_);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -24,10 +24,12 @@
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/IoCostModel.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Options.h"
 
 DECLARE_int32(cache_load_quantum);
+DECLARE_bool(adaptive_coalesce);
 
 namespace facebook::velox::dwio::common {
 
@@ -77,7 +79,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        costModel_(makeCostModel()) {}
 
   CachedBufferedInput(
       std::shared_ptr<ReadFileInputStream> input,
@@ -99,7 +102,8 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input_->getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        costModel_(makeCostModel()) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : allCoalescedLoads_) {
@@ -176,6 +180,19 @@ class CachedBufferedInput : public BufferedInput {
 
   void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
 
+  // Returns the IoCostModel of the file system of the file if coalescing
+  // adapts to the measured storage costs.
+  IoCostModel* FOLLY_NULLABLE makeCostModel() const {
+    return FLAGS_adaptive_coalesce ? &IoCostModel::forPath(input_->getName())
+                                   : nullptr;
+  }
+
+  // The coalescing distance for storage reads.
+  int32_t coalesceDistance() const {
+    return costModel_ ? costModel_->maxCoalesceDistance(maxCoalesceDistance_)
+                      : maxCoalesceDistance_;
+  }
+
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
   std::shared_ptr<cache::ScanTracker> tracker_;
@@ -198,6 +215,10 @@ class CachedBufferedInput : public BufferedInput {
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
   const int32_t maxCoalesceDistance_;
+
+  // Set if coalescing adapts to the latency and bandwidth measured for the
+  // file system. See FLAGS_adaptive_coalesce.
+  IoCostModel* const FOLLY_NULLABLE costModel_;
 };
 
 } // namespace facebook::velox::dwio::common
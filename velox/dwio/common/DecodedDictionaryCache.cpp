@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/DecodedDictionaryCache.h"
+
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    decoded_dictionary_cache_mb,
+    0,
+    "Size of the process wide cache of decoded stripe dictionaries in MB. 0 "
+    "disables the cache.");
+
+namespace facebook::velox::dwio::common {
+
+namespace {
+std::mutex instanceMutex;
+bool instanceInitialized{false};
+std::shared_ptr<DecodedDictionaryCache> instance;
+} // namespace
+
+std::string DecodedDictionaryCacheStats::toString() const {
+  return fmt::format(
+      "Decoded dictionary cache: {} entries, {} / {} bytes, {} hits / {} "
+      "lookups, {} evictions",
+      numEntries,
+      curBytes,
+      maxBytes,
+      numHits,
+      numLookups,
+      numEvictions);
+}
+
+uint64_t DecodedDictionary::bytes() const {
+  return (values ? values->capacity() : 0) +
+      (strings ? strings->capacity() : 0);
+}
+
+// static
+std::shared_ptr<DecodedDictionaryCache> DecodedDictionaryCache::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  if (!instanceInitialized) {
+    instanceInitialized = true;
+    if (FLAGS_decoded_dictionary_cache_mb > 0) {
+      instance = std::make_shared<DecodedDictionaryCache>(
+          static_cast<uint64_t>(FLAGS_decoded_dictionary_cache_mb) << 20);
+    }
+  }
+  return instance;
+}
+
+// static
+void DecodedDictionaryCache::setInstance(
+    std::shared_ptr<DecodedDictionaryCache> cache) {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  instanceInitialized = true;
+  instance = std::move(cache);
+}
+
+// static
+std::optional<DecodedDictionaryCache::Key> DecodedDictionaryCache::makeKey(
+    const ReadFile& file,
+    uint32_t stripe,
+    uint32_t column,
+    uint64_t offset) {
+  auto name = file.getName();
+  // Files without a path are named like '<InMemoryReadFile>'.
+  if (name.empty() || name[0] == '<') {
+    return std::nullopt;
+  }
+  return Key{std::move(name), file.size(), stripe, column, offset};
+}
+
+// static
+memory::MemoryPool& DecodedDictionaryCache::pool() {
+  static auto pool = memory::addDefaultLeafMemoryPool("decodedDictionaryCache");
+  return *pool;
+}
+
+size_t DecodedDictionaryCache::KeyHasher::operator()(const Key& key) const {
+  return folly::hash::hash_combine(
+      key.offset, key.column, key.stripe, key.fileSize, key.fileName);
+}
+
+std::shared_ptr<const DecodedDictionary> DecodedDictionaryCache::get(
+    const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numLookups_;
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  return it->second.dictionary;
+}
+
+void DecodedDictionaryCache::put(
+    Key key,
+    std::shared_ptr<const DecodedDictionary> dictionary) {
+  const auto bytes = dictionary->bytes();
+  if (bytes > maxBytes_ / 4) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.count(key) != 0) {
+    // Another reader of the same dictionary got here first.
+    return;
+  }
+  makeSpaceLocked(bytes);
+  lru_.push_front(key);
+  entries_.emplace(
+      std::move(key), Entry{std::move(dictionary), bytes, lru_.begin()});
+  curBytes_ += bytes;
+}
+
+void DecodedDictionaryCache::makeSpaceLocked(uint64_t bytes) {
+  while (!lru_.empty() && curBytes_ + bytes > maxBytes_) {
+    auto it = entries_.find(lru_.back());
+    curBytes_ -= it->second.bytes;
+    entries_.erase(it);
+    lru_.pop_back();
+    ++numEvictions_;
+  }
+}
+
+void DecodedDictionaryCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  curBytes_ = 0;
+}
+
+DecodedDictionaryCacheStats DecodedDictionaryCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {
+      maxBytes_,
+      curBytes_,
+      entries_.size(),
+      numHits_,
+      numLookups_,
+      numEvictions_};
+}
+
+} // namespace facebook::velox::dwio::common
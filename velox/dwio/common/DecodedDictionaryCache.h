@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/buffer/Buffer.h"
+#include "velox/common/file/File.h"
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::dwio::common {
+
+struct DecodedDictionaryCacheStats {
+  uint64_t maxBytes{0};
+  uint64_t curBytes{0};
+  uint64_t numEntries{0};
+  uint64_t numHits{0};
+  uint64_t numLookups{0};
+  uint64_t numEvictions{0};
+
+  std::string toString() const;
+};
+
+/// A decoded string dictionary: StringViews in 'values' that point into
+/// 'strings'. Immutable once cached and shared by all readers of the
+/// dictionary.
+struct DecodedDictionary {
+  BufferPtr values;
+  BufferPtr strings;
+  int32_t numValues{0};
+
+  /// The memory the buffers take.
+  uint64_t bytes() const;
+};
+
+/// Process wide cache of decoded stripe dictionaries, so that the splits and
+/// queries that scan the same file skip reading, decompressing and decoding
+/// the dictionaries of its string columns. The AsyncDataCache keeps the raw
+/// bytes of the dictionary streams, this keeps their decoded form. Entries
+/// are evicted in LRU order to stay within the byte budget. Thread safe.
+///
+/// The dictionaries are decoded into buffers of pool(), a leaf of the
+/// default memory manager. When the AsyncDataCache is the allocator of the
+/// memory manager, the decoded dictionaries and the raw cache entries share
+/// its capacity and allocating a dictionary evicts cold raw entries.
+class DecodedDictionaryCache {
+ public:
+  struct Key {
+    std::string fileName;
+    uint64_t fileSize;
+    uint32_t stripe;
+    uint32_t column;
+    // The offset of the dictionary stream in the file.
+    uint64_t offset;
+
+    bool operator==(const Key& other) const {
+      return offset == other.offset && column == other.column &&
+          stripe == other.stripe && fileSize == other.fileSize &&
+          fileName == other.fileName;
+    }
+  };
+
+  explicit DecodedDictionaryCache(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  /// Returns the process wide cache, or nullptr if the cache is disabled. The
+  /// cache is created on first use with a budget of
+  /// FLAGS_decoded_dictionary_cache_mb.
+  static std::shared_ptr<DecodedDictionaryCache> getInstance();
+
+  /// Replaces the process wide cache. nullptr disables caching.
+  static void setInstance(std::shared_ptr<DecodedDictionaryCache> cache);
+
+  /// Returns the key for the dictionary of 'column' in 'stripe' of 'file'
+  /// that is stored at 'offset', or std::nullopt if 'file' has no name that
+  /// identifies it. The file size is part of the key like in
+  /// FileMetadataCache.
+  static std::optional<Key> makeKey(
+      const ReadFile& file,
+      uint32_t stripe,
+      uint32_t column,
+      uint64_t offset);
+
+  /// The pool to decode the dictionaries to cache into. The pool lives as
+  /// long as the process, so that the buffers of an entry are valid for as
+  /// long as the readers and the vectors that reference them.
+  static memory::MemoryPool& pool();
+
+  /// Returns the dictionary cached for 'key' or nullptr.
+  std::shared_ptr<const DecodedDictionary> get(const Key& key);
+
+  /// Caches 'dictionary' for 'key'. The buffers of 'dictionary' must be
+  /// allocated from pool(). Dictionaries larger than a quarter of the budget
+  /// are not cached.
+  void put(Key key, std::shared_ptr<const DecodedDictionary> dictionary);
+
+  void clear();
+
+  DecodedDictionaryCacheStats stats() const;
+
+ private:
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<const DecodedDictionary> dictionary;
+    uint64_t bytes;
+    // Position in 'lru_'.
+    std::list<Key>::iterator lruPosition;
+  };
+
+  // Evicts the least recently used entries until 'bytes' more fit in the
+  // budget. Caller must hold 'mutex_'.
+  void makeSpaceLocked(uint64_t bytes);
+
+  const uint64_t maxBytes_;
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<Key, Entry, KeyHasher> entries_;
+  // Keys of 'entries_', most recently used first.
+  std::list<Key> lru_;
+  uint64_t curBytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numLookups_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace facebook::velox::dwio::common
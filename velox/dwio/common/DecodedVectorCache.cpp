@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/DecodedVectorCache.h"
+
+#include <algorithm>
+
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    decoded_vector_cache_mb,
+    0,
+    "Size of the process wide cache of decoded column vectors in MB. 0 "
+    "disables the cache.");
+
+namespace facebook::velox::dwio::common {
+
+namespace {
+std::mutex instanceMutex;
+bool instanceInitialized{false};
+std::shared_ptr<DecodedVectorCache> instance;
+} // namespace
+
+std::string DecodedVectorCacheStats::toString() const {
+  return fmt::format(
+      "Decoded vector cache: {} entries, {} / {} bytes, {} hits / {} "
+      "lookups, {} evictions",
+      numEntries,
+      curBytes,
+      maxBytes,
+      numHits,
+      numLookups,
+      numEvictions);
+}
+
+// static
+std::shared_ptr<DecodedVectorCache> DecodedVectorCache::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  if (!instanceInitialized) {
+    instanceInitialized = true;
+    if (FLAGS_decoded_vector_cache_mb > 0) {
+      instance = std::make_shared<DecodedVectorCache>(
+          memory::addDefaultLeafMemoryPool("decodedVectorCache"),
+          static_cast<uint64_t>(FLAGS_decoded_vector_cache_mb) << 20);
+      if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(
+              memory::MemoryAllocator::getInstance())) {
+        asyncCache->addDerivedCache(instance);
+      }
+    }
+  }
+  return instance;
+}
+
+// static
+void DecodedVectorCache::setInstance(
+    std::shared_ptr<DecodedVectorCache> cache) {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  instanceInitialized = true;
+  instance = std::move(cache);
+}
+
+size_t DecodedVectorCache::KeyHasher::operator()(const Key& key) const {
+  return folly::hash::hash_combine(
+      key.fileNum, key.rowGroup, key.nodeId, key.firstRow, key.numRows);
+}
+
+VectorPtr DecodedVectorCache::find(const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numLookups_;
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  ++numHits_;
+  it->second.accessStats.touch();
+  return it->second.vector;
+}
+
+VectorPtr DecodedVectorCache::insert(const Key& key, const VectorPtr& vector) {
+  // Copies outside of the mutex since the allocation may make the
+  // AsyncDataCache evict from 'this'.
+  auto copy = BaseVector::create(vector->type(), vector->size(), pool_.get());
+  copy->copy(vector.get(), 0, 0, vector->size());
+  const auto bytes = copy->retainedSize();
+  if (bytes > maxBytes_ / 4) {
+    return vector;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // Another reader of the same data got here first.
+    return it->second.vector;
+  }
+  if (curBytes_ + bytes > maxBytes_) {
+    evictLocked(curBytes_ + bytes - maxBytes_);
+  }
+  auto& entry = entries_[key];
+  entry.vector = std::move(copy);
+  entry.bytes = bytes;
+  entry.accessStats.reset();
+  curBytes_ += bytes;
+  return entry.vector;
+}
+
+uint64_t DecodedVectorCache::evict(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  return evictLocked(bytes);
+}
+
+uint64_t DecodedVectorCache::evictLocked(uint64_t bytes) {
+  const auto now = cache::accessTime();
+  struct Candidate {
+    int32_t score;
+    int32_t numUses;
+    const Key* key;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(entries_.size());
+  for (const auto& [key, entry] : entries_) {
+    candidates.push_back(
+        {entry.accessStats.score(now, entry.bytes),
+         entry.accessStats.numUses,
+         &key});
+  }
+  // Highest score, i.e. coldest, first. The score has a resolution of a
+  // second, so the least used goes first among entries of the same score.
+  std::sort(
+      candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.score != b.score ? a.score > b.score : a.numUses < b.numUses;
+      });
+  uint64_t freed = 0;
+  std::vector<Key> evicted;
+  for (const auto& candidate : candidates) {
+    const auto* key = candidate.key;
+    if (freed >= bytes) {
+      break;
+    }
+    evicted.push_back(*key);
+    freed += entries_.at(*key).bytes;
+  }
+  for (const auto& key : evicted) {
+    entries_.erase(key);
+  }
+  curBytes_ -= freed;
+  numEvictions_ += evicted.size();
+  return freed;
+}
+
+void DecodedVectorCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  curBytes_ = 0;
+}
+
+DecodedVectorCacheStats DecodedVectorCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {
+      maxBytes_,
+      curBytes_,
+      entries_.size(),
+      numHits_,
+      numLookups_,
+      numEvictions_};
+}
+
+} // namespace facebook::velox::dwio::common
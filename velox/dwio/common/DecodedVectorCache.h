@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::dwio::common {
+
+struct DecodedVectorCacheStats {
+  uint64_t maxBytes{0};
+  uint64_t curBytes{0};
+  uint64_t numEntries{0};
+  uint64_t numHits{0};
+  uint64_t numLookups{0};
+  uint64_t numEvictions{0};
+
+  std::string toString() const;
+};
+
+/// Process wide cache of decoded column vectors, so that scans that read the
+/// same data again, e.g. dashboards over hot partitions, do not decompress
+/// and decode it again. AsyncDataCache keeps the encoded bytes; this keeps
+/// the vectors decoded from them.
+///
+/// An entry is a scalar column over a range of rows of a stripe or row group,
+/// with a value for every row of the range, so that it serves scans with any
+/// filter on the other columns. The vectors are copied into a memory pool of
+/// the cache and are immutable once cached. Entries are evicted by
+/// cache::AccessStats::score(), the same as AsyncDataCache entries, to stay
+/// within the byte budget and when the AsyncDataCache this is added to as a
+/// derived cache needs space. Data files are assumed to be immutable, as in
+/// AsyncDataCache. Thread safe.
+class DecodedVectorCache : public cache::DerivedDataCache {
+ public:
+  struct Key {
+    // Identifies the file, e.g. the id of the file name in fileIds().
+    uint64_t fileNum;
+    // Stripe or row group.
+    int32_t rowGroup;
+    // Id of the column in the file schema, see TypeWithId.
+    uint32_t nodeId;
+    // First row of the range in the row group.
+    int32_t firstRow;
+    int32_t numRows;
+
+    bool operator==(const Key& other) const {
+      return fileNum == other.fileNum && rowGroup == other.rowGroup &&
+          nodeId == other.nodeId && firstRow == other.firstRow &&
+          numRows == other.numRows;
+    }
+  };
+
+  /// Keeps up to 'maxBytes' of vectors in 'pool'.
+  DecodedVectorCache(
+      std::shared_ptr<memory::MemoryPool> pool,
+      uint64_t maxBytes)
+      : pool_(std::move(pool)), maxBytes_(maxBytes) {}
+
+  /// Returns the process wide cache, or nullptr if the cache is disabled. The
+  /// cache is created on first use with a budget of
+  /// FLAGS_decoded_vector_cache_mb and is added as a derived cache to the
+  /// process wide MemoryAllocator if this is an AsyncDataCache.
+  static std::shared_ptr<DecodedVectorCache> getInstance();
+
+  /// Replaces the process wide cache. nullptr disables caching.
+  static void setInstance(std::shared_ptr<DecodedVectorCache> cache);
+
+  /// Returns the vector cached for 'key' or nullptr.
+  VectorPtr find(const Key& key);
+
+  /// Caches a copy of 'vector' for 'key' and returns the copy. Returns
+  /// 'vector' if a copy larger than a quarter of the budget would not be
+  /// cached. Returns the cached vector if 'key' is already cached.
+  VectorPtr insert(const Key& key, const VectorPtr& vector);
+
+  uint64_t evict(uint64_t bytes) override;
+
+  void clear();
+
+  DecodedVectorCacheStats stats() const;
+
+ private:
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    VectorPtr vector;
+    uint64_t bytes{0};
+    cache::AccessStats accessStats;
+  };
+
+  // Evicts the entries with the highest score until 'bytes' are freed or
+  // nothing is left. Caller must hold 'mutex_'. Returns the bytes freed.
+  uint64_t evictLocked(uint64_t bytes);
+
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  const uint64_t maxBytes_;
+
+  mutable std::mutex mutex_;
+  // Node map since the atomics in AccessStats do not move.
+  folly::F14NodeMap<Key, Entry, KeyHasher> entries_;
+  uint64_t curBytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numLookups_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    file_metadata_cache_mb,
+    0,
+    "Size of the process wide cache of parsed file footers in MB. 0 disables "
+    "the cache.");
+
+namespace facebook::velox::dwio::common {
+
+namespace {
+std::mutex instanceMutex;
+bool instanceInitialized{false};
+std::shared_ptr<FileMetadataCache> instance;
+} // namespace
+
+std::string FileMetadataCacheStats::toString() const {
+  return fmt::format(
+      "File metadata cache: {} entries, {} / {} bytes, {} hits / {} "
+      "lookups, {} evictions",
+      numEntries,
+      curBytes,
+      maxBytes,
+      numHits,
+      numLookups,
+      numEvictions);
+}
+
+// static
+std::shared_ptr<FileMetadataCache> FileMetadataCache::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  if (!instanceInitialized) {
+    instanceInitialized = true;
+    if (FLAGS_file_metadata_cache_mb > 0) {
+      instance = std::make_shared<FileMetadataCache>(
+          static_cast<uint64_t>(FLAGS_file_metadata_cache_mb) << 20);
+    }
+  }
+  return instance;
+}
+
+// static
+void FileMetadataCache::setInstance(std::shared_ptr<FileMetadataCache> cache) {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  instanceInitialized = true;
+  instance = std::move(cache);
+}
+
+// static
+std::optional<FileMetadataCache::Key> FileMetadataCache::makeKey(
+    FileFormat format,
+    const ReadFile& file) {
+  auto name = file.getName();
+  // Files without a path are named like '<InMemoryReadFile>'.
+  if (name.empty() || name[0] == '<') {
+    return std::nullopt;
+  }
+  return Key{format, std::move(name), file.size()};
+}
+
+size_t FileMetadataCache::KeyHasher::operator()(const Key& key) const {
+  return folly::hash::hash_combine(
+      static_cast<int32_t>(key.format), key.fileSize, key.fileName);
+}
+
+std::shared_ptr<const void> FileMetadataCache::getInternal(const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numLookups_;
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  return it->second.metadata;
+}
+
+void FileMetadataCache::put(
+    Key key,
+    std::shared_ptr<const void> metadata,
+    uint64_t bytes) {
+  if (bytes > maxBytes_ / 4) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.count(key) != 0) {
+    // Another reader of the same file got here first.
+    return;
+  }
+  makeSpaceLocked(bytes);
+  lru_.push_front(key);
+  entries_.emplace(
+      std::move(key), Entry{std::move(metadata), bytes, lru_.begin()});
+  curBytes_ += bytes;
+}
+
+void FileMetadataCache::makeSpaceLocked(uint64_t bytes) {
+  while (!lru_.empty() && curBytes_ + bytes > maxBytes_) {
+    auto it = entries_.find(lru_.back());
+    curBytes_ -= it->second.bytes;
+    entries_.erase(it);
+    lru_.pop_back();
+    ++numEvictions_;
+  }
+}
+
+void FileMetadataCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  curBytes_ = 0;
+}
+
+FileMetadataCacheStats FileMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {
+      maxBytes_,
+      curBytes_,
+      entries_.size(),
+      numHits_,
+      numLookups_,
+      numEvictions_};
+}
+
+} // namespace facebook::velox::dwio::common
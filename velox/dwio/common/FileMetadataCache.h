@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/Options.h"
+
+namespace facebook::velox::dwio::common {
+
+struct FileMetadataCacheStats {
+  uint64_t maxBytes{0};
+  uint64_t curBytes{0};
+  uint64_t numEntries{0};
+  uint64_t numHits{0};
+  uint64_t numLookups{0};
+  uint64_t numEvictions{0};
+
+  std::string toString() const;
+};
+
+/// Process wide cache of the parsed footers of data files, so that the splits
+/// of a file deserialize its footer once instead of once per split. Each
+/// format decides what it caches, e.g. the PostScript and Footer protos for
+/// DWRF and the thrift FileMetaData for Parquet. The cached objects are
+/// immutable and shared by all readers of the file. Entries are evicted in
+/// LRU order to stay within the byte budget. Thread safe.
+class FileMetadataCache {
+ public:
+  struct Key {
+    FileFormat format;
+    std::string fileName;
+    uint64_t fileSize;
+
+    bool operator==(const Key& other) const {
+      return format == other.format && fileSize == other.fileSize &&
+          fileName == other.fileName;
+    }
+  };
+
+  explicit FileMetadataCache(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  /// Returns the process wide cache, or nullptr if the cache is disabled. The
+  /// cache is created on first use with a budget of
+  /// FLAGS_file_metadata_cache_mb.
+  static std::shared_ptr<FileMetadataCache> getInstance();
+
+  /// Replaces the process wide cache. nullptr disables caching.
+  static void setInstance(std::shared_ptr<FileMetadataCache> cache);
+
+  /// Returns the key for the metadata of 'file' in 'format', or std::nullopt
+  /// if 'file' has no name that identifies it, e.g. an in-memory file. The
+  /// file size is part of the key, so that a file that is replaced by one of
+  /// a different size under the same name is not served stale metadata.
+  static std::optional<Key> makeKey(FileFormat format, const ReadFile& file);
+
+  /// Returns the metadata cached for 'key' or nullptr. T must be the type
+  /// the metadata was added with, which is fixed by the format of 'key'.
+  template <typename T>
+  std::shared_ptr<const T> get(const Key& key) {
+    return std::static_pointer_cast<const T>(getInternal(key));
+  }
+
+  /// Caches 'metadata' for 'key'. 'bytes' is the memory 'metadata' takes.
+  /// Metadata larger than a quarter of the budget is not cached.
+  void put(Key key, std::shared_ptr<const void> metadata, uint64_t bytes);
+
+  void clear();
+
+  FileMetadataCacheStats stats() const;
+
+ private:
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<const void> metadata;
+    uint64_t bytes;
+    // Position in 'lru_'.
+    std::list<Key>::iterator lruPosition;
+  };
+
+  std::shared_ptr<const void> getInternal(const Key& key);
+
+  // Evicts the least recently used entries until 'bytes' more fit in the
+  // budget. Caller must hold 'mutex_'.
+  void makeSpaceLocked(uint64_t bytes);
+
+  const uint64_t maxBytes_;
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<Key, Entry, KeyHasher> entries_;
+  // Keys of 'entries_', most recently used first.
+  std::list<Key> lru_;
+  uint64_t curBytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numLookups_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/IoCostModel.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::dwio::common {
+
+// static
+IoCostModel& IoCostModel::forPath(std::string_view path) {
+  static folly::Synchronized<
+      folly::F14FastMap<std::string, std::unique_ptr<IoCostModel>>>
+      models;
+  const auto schemeEnd = path.find("://");
+  const std::string scheme(
+      schemeEnd == std::string_view::npos ? "" : path.substr(0, schemeEnd));
+  {
+    auto rlock = models.rlock();
+    auto it = rlock->find(scheme);
+    if (it != rlock->end()) {
+      return *it->second;
+    }
+  }
+  auto wlock = models.wlock();
+  auto& model = (*wlock)[scheme];
+  if (!model) {
+    model = std::make_unique<IoCostModel>();
+  }
+  return *model;
+}
+
+void IoCostModel::recordRead(uint64_t bytes, uint64_t micros) {
+  const double x = bytes;
+  const double y = micros;
+  std::lock_guard<std::mutex> l(mutex_);
+  sumWeight_ = sumWeight_ * kDecay + 1;
+  sumBytes_ = sumBytes_ * kDecay + x;
+  sumMicros_ = sumMicros_ * kDecay + y;
+  sumBytes2_ = sumBytes2_ * kDecay + x * x;
+  sumBytesMicros_ = sumBytesMicros_ * kDecay + x * y;
+  if (++numReads_ >= kMinReads) {
+    updateLocked();
+  }
+}
+
+void IoCostModel::updateLocked() {
+  const double denominator = sumWeight_ * sumBytes2_ - sumBytes_ * sumBytes_;
+  // Reads of about the same size do not separate latency from bandwidth.
+  if (denominator <= 1e-9 * sumWeight_ * sumBytes2_) {
+    return;
+  }
+  const double microsPerByte =
+      (sumWeight_ * sumBytesMicros_ - sumBytes_ * sumMicros_) / denominator;
+  const double latency = (sumMicros_ - microsPerByte * sumBytes_) / sumWeight_;
+  if (microsPerByte <= 0 || latency <= 0) {
+    // Noise dominates. Keeps the previous estimate.
+    return;
+  }
+  latencyMicros_ = latency;
+  bytesPerMicro_ = 1 / microsPerByte;
+  const double distance = latency * bytesPerMicro_;
+  maxCoalesceDistance_ = static_cast<int32_t>(std::clamp<double>(
+      distance, kMinCoalesceDistance, kMaxCoalesceDistance));
+  maxCoalesceBytes_ = static_cast<int64_t>(std::clamp<double>(
+      distance * kTransferToLatency, kMinCoalesceBytes, kMaxCoalesceBytes));
+}
+
+double IoCostModel::latencyMicros() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return latencyMicros_;
+}
+
+double IoCostModel::bytesPerMicro() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return bytesPerMicro_;
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace facebook::velox::dwio::common {
+
+// Learns the cost of reads from one file system, e.g. local SSD, HDFS or S3,
+// and derives how far apart ranges may be to be read with one request and
+// how large one coalesced read may get. The time of a read is modeled as
+// latency + bytes / bandwidth, fitted by least squares over the timings of
+// recent reads. Reading a gap is cheaper than a separate request as long as
+// the gap takes less time to transfer than the latency of a request, so the
+// coalescing distance is latency * bandwidth. Thread safe.
+class IoCostModel {
+ public:
+  // Returns the model for the file system of 'path'. File systems are told
+  // apart by the scheme of the path, e.g. 's3' in 's3://bucket/key'. Paths
+  // without a scheme are local files.
+  static IoCostModel& forPath(std::string_view path);
+
+  // Records a read of 'bytes' that took 'micros' from issue to completion.
+  void recordRead(uint64_t bytes, uint64_t micros);
+
+  // Returns the largest gap worth reading to save a request, or
+  // 'defaultDistance' if there are not yet enough timings for an estimate.
+  int32_t maxCoalesceDistance(int32_t defaultDistance) const {
+    const auto distance = maxCoalesceDistance_.load(std::memory_order_relaxed);
+    return distance == 0 ? defaultDistance : distance;
+  }
+
+  // Returns the largest number of bytes worth reading with one request, or
+  // 'defaultBytes' if there is no estimate. A larger read is better split in
+  // parallel requests since it spends little of its time on the latency.
+  int64_t maxCoalesceBytes(int64_t defaultBytes) const {
+    const auto bytes = maxCoalesceBytes_.load(std::memory_order_relaxed);
+    return bytes == 0 ? defaultBytes : bytes;
+  }
+
+  // The estimated latency in microseconds and bandwidth in bytes per
+  // microsecond. 0 if there is no estimate.
+  double latencyMicros() const;
+  double bytesPerMicro() const;
+
+  // Bounds of the derived parameters.
+  static constexpr int32_t kMinCoalesceDistance = 4 << 10;
+  static constexpr int32_t kMaxCoalesceDistance = 64 << 20;
+  static constexpr int64_t kMinCoalesceBytes = 1 << 20;
+  static constexpr int64_t kMaxCoalesceBytes = 256 << 20;
+
+  // A coalesced read may take this many times the latency to transfer.
+  static constexpr int32_t kTransferToLatency = 16;
+
+  // Number of reads before the first estimate.
+  static constexpr int32_t kMinReads = 32;
+
+  // The weight of the past reads is multiplied by this for each new read,
+  // so that the model follows changes in the storage.
+  static constexpr double kDecay = 0.99;
+
+ private:
+  // Updates the estimates from the sums. Caller must hold 'mutex_'.
+  void updateLocked();
+
+  mutable std::mutex mutex_;
+  int64_t numReads_{0};
+  // Decayed sums of weights, bytes, micros, bytes^2 and bytes * micros.
+  double sumWeight_{0};
+  double sumBytes_{0};
+  double sumMicros_{0};
+  double sumBytes2_{0};
+  double sumBytesMicros_{0};
+  double latencyMicros_{0};
+  double bytesPerMicro_{0};
+
+  std::atomic<int32_t> maxCoalesceDistance_{0};
+  std::atomic<int64_t> maxCoalesceBytes_{0};
+};
+
+} // namespace facebook::velox::dwio::common
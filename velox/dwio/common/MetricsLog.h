@@ -123,6 +123,11 @@ class MetricsLog {
     int64_t totalMemory;
     int64_t dictionaryMemory;
     int64_t generalMemory;
+    // Number of dictionary encoding switches of the column writers by reason.
+    uint64_t numDictionaryEarlyAborts;
+    uint64_t numDictionaryAbandons;
+    uint64_t numDictionaryForcedAbandons;
+    uint64_t numDictionaryRetries;
   };
 
   virtual void logFileClose(const FileCloseMetrics& /* metrics */) const {}
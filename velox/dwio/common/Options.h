@@ -32,6 +32,8 @@ namespace velox {
 namespace dwio {
 namespace common {
 
+class DecodedVectorCache;
+
 enum class FileFormat {
   UNKNOWN = 0,
   DWRF = 1, // DWRF
@@ -101,7 +103,15 @@ class RowReaderOptions {
   // operations.
   std::shared_ptr<folly::Executor> decodingExecutor_;
   std::shared_ptr<folly::Executor> ioExecutor_;
+  // Executor that decrypts and decompresses the next block of each stream
+  // while the reader decodes the current one.
+  std::shared_ptr<folly::Executor> decompressionExecutor_;
+  // Maximum number of columns of a split decoded at a time with
+  // 'decodingExecutor_', including the calling thread.
+  int32_t decodingParallelism_ = 1;
   bool appendRowNumberColumn_ = false;
+  std::shared_ptr<DecodedVectorCache> decodedVectorCache_;
+  uint64_t decodedVectorCacheFileNum_ = 0;
 
  public:
   RowReaderOptions(const RowReaderOptions& other) {
@@ -115,7 +125,13 @@ class RowReaderOptions {
     metadataFilter_ = other.metadataFilter_;
     returnFlatVector_ = other.returnFlatVector_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
+    decompressionExecutor_ = other.decompressionExecutor_;
+    decodingParallelism_ = other.decodingParallelism_;
     appendRowNumberColumn_ = other.appendRowNumberColumn_;
+    decodedVectorCache_ = other.decodedVectorCache_;
+    decodedVectorCacheFileNum_ = other.decodedVectorCacheFileNum_;
   }
 
   RowReaderOptions() noexcept
@@ -277,6 +293,32 @@ class RowReaderOptions {
     ioExecutor_ = executor;
   }
 
+  /*
+   * Sets an executor on which each compressed or encrypted stream decrypts
+   * and decompresses its next block while the reader decodes the current
+   * one, so that the calling thread mostly decodes and filters. nullptr
+   * decompresses on the calling thread.
+   */
+  void setDecompressionExecutor(std::shared_ptr<folly::Executor> executor) {
+    decompressionExecutor_ = std::move(executor);
+  }
+
+  /*
+   * Sets the maximum number of columns of a split that are decoded at a time
+   * on the decoding executor. The projected columns without filters are then
+   * decoded in parallel once the filters are evaluated. They are returned
+   * loaded instead of as lazy vectors. 1 decodes all columns on the calling
+   * thread.
+   */
+  void setDecodingParallelism(int32_t parallelism) {
+    VELOX_CHECK_GE(parallelism, 1);
+    decodingParallelism_ = parallelism;
+  }
+
+  int32_t getDecodingParallelism() const {
+    return decodingParallelism_;
+  }
+
   /*
    * Set to true, if you want to add a new column to the results containing the
    * row numbers.
@@ -289,6 +331,27 @@ class RowReaderOptions {
     return appendRowNumberColumn_;
   }
 
+  /*
+   * Sets the cache of decoded vectors that the reader consults before
+   * decoding the projected scalar columns without filters. 'fileNum'
+   * identifies the file in the keys of the cache, e.g. the id of the file
+   * name in fileIds().
+   */
+  void setDecodedVectorCache(
+      std::shared_ptr<DecodedVectorCache> cache,
+      uint64_t fileNum) {
+    decodedVectorCache_ = std::move(cache);
+    decodedVectorCacheFileNum_ = fileNum;
+  }
+
+  const std::shared_ptr<DecodedVectorCache>& getDecodedVectorCache() const {
+    return decodedVectorCache_;
+  }
+
+  uint64_t getDecodedVectorCacheFileNum() const {
+    return decodedVectorCacheFileNum_;
+  }
+
   const std::shared_ptr<folly::Executor>& getDecodingExecutor() const {
     return decodingExecutor_;
   }
@@ -296,6 +359,10 @@ class RowReaderOptions {
   const std::shared_ptr<folly::Executor>& getIOExecutor() const {
     return ioExecutor_;
   }
+
+  const std::shared_ptr<folly::Executor>& getDecompressionExecutor() const {
+    return decompressionExecutor_;
+  }
 };
 
 /**
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/ParallelFor.h"
+
+#include "velox/common/base/AsyncSource.h"
+
+namespace facebook::velox::dwio::common {
+
+void runInParallel(
+    folly::Executor* executor,
+    int32_t parallelism,
+    int32_t numItems,
+    const std::function<void(int32_t)>& work) {
+  const auto numTasks = std::min(parallelism, numItems);
+  std::vector<std::shared_ptr<AsyncSource<bool>>> tasks;
+  tasks.reserve(numTasks);
+  for (auto i = 0; i < numTasks; ++i) {
+    tasks.push_back(std::make_shared<AsyncSource<bool>>([=, &work]() {
+      for (auto item = i; item < numItems; item += numTasks) {
+        work(item);
+      }
+      return std::make_unique<bool>(true);
+    }));
+    // The first task runs on the calling thread.
+    if (i > 0) {
+      executor->add([task = tasks.back()]() { task->prepare(); });
+    }
+  }
+  std::exception_ptr error;
+  // All tasks must finish before returning since they reference the caller's
+  // state.
+  for (auto& task : tasks) {
+    try {
+      task->move();
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace facebook::velox::dwio::common
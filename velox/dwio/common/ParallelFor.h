@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <functional>
+
+namespace facebook::velox::dwio::common {
+
+// Runs 'work' for each of [0, 'numItems') on up to 'parallelism' threads of
+// 'executor', one of which is the calling thread. Returns after all items are
+// done and rethrows the first error, if any. Used to decode or encode the
+// columns of a batch concurrently.
+void runInParallel(
+    folly::Executor* FOLLY_NONNULL executor,
+    int32_t parallelism,
+    int32_t numItems,
+    const std::function<void(int32_t)>& work);
+
+} // namespace facebook::velox::dwio::common
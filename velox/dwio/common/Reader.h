@@ -20,7 +20,9 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "velox/common/base/Exceptions.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -75,6 +77,23 @@ class RowReader {
   virtual bool allPrefetchIssued() const {
     return false;
   }
+
+  // Sets up the reading of the first stripe or row group and issues its
+  // reads before the first next(), e.g. when a split is preloaded. The
+  // default does nothing.
+  virtual void startFirstStripe() {}
+};
+
+/**
+ * A stripe or row group of a file, the unit that a file split consists of.
+ * A row reader over the range [start, start + length) reads the sections
+ * whose 'offset' is in the range.
+ */
+struct FileSection {
+  uint64_t offset;
+  // Number of bytes in the section.
+  uint64_t length;
+  uint64_t numRows;
 };
 
 /**
@@ -119,6 +138,15 @@ class Reader {
    */
   virtual const std::shared_ptr<const TypeWithId>& typeWithId() const = 0;
 
+  /**
+   * Get the stripes or row groups of the file from the footer, in file order.
+   * Used for planning splits that fall on section boundaries.
+   * @return the sections of the file
+   */
+  virtual std::vector<FileSection> sections() const {
+    VELOX_UNSUPPORTED("Reader does not enumerate file sections");
+  }
+
   /**
    * Create row reader object to fetch the data.
    * @param options Row reader options describing the data to fetch
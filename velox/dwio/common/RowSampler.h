@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Keeps each row of a scan with a fixed probability, for TABLESAMPLE
+/// BERNOULLI. The decisions come from a pseudo random sequence that is
+/// restarted from a seed, e.g. once per split, so that scanning the same data
+/// with the same seed and filters keeps the same rows.
+///
+/// Set on the root ScanSpec of a scan, where the struct reader applies it to
+/// the rows of each batch before reading any column, like a filter.
+class RowSampler {
+ public:
+  /// Keeps a row with probability 'rate', which is in [0, 1].
+  explicit RowSampler(double rate, uint64_t seed = 0)
+      : keepAll_(rate >= 1), state_(seed) {
+    VELOX_CHECK_GE(rate, 0, "Sample rate must not be negative");
+    // 2^64 * rate, compared to the next 64 random bits.
+    threshold_ = keepAll_ ? 0 : static_cast<uint64_t>(std::ldexp(rate, 64));
+  }
+
+  /// Restarts the sequence of decisions from 'seed'.
+  void reset(uint64_t seed) {
+    state_ = seed;
+  }
+
+  bool keep() {
+    return keepAll_ || next() < threshold_;
+  }
+
+  /// Writes the rows of 'rows' to keep into 'result', which has space for
+  /// all of 'rows'. Returns the number of rows written.
+  template <typename Rows>
+  int32_t sample(const Rows& rows, int32_t* result) {
+    int32_t numKept = 0;
+    for (auto row : rows) {
+      result[numKept] = row;
+      numKept += keep();
+    }
+    return numKept;
+  }
+
+  /// Returns how many of the next 'numRows' rows to keep.
+  int32_t sample(int32_t numRows) {
+    int32_t numKept = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      numKept += keep();
+    }
+    return numKept;
+  }
+
+  /// Returns a seed for a part of a scan, e.g. a split, from the seed of the
+  /// scan and a hash of what identifies the part.
+  static uint64_t mixSeed(uint64_t seed, uint64_t partHash) {
+    uint64_t state = seed ^ (partHash * 0x9e3779b97f4a7c15ULL);
+    return splitMix64(state);
+  }
+
+ private:
+  static uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t next() {
+    return splitMix64(state_);
+  }
+
+  const bool keepAll_;
+  uint64_t threshold_;
+  uint64_t state_;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -29,6 +29,8 @@ ScanSpec& ScanSpec::operator=(const ScanSpec& other) {
     projectOut_ = other.projectOut_;
     extractValues_ = other.extractValues_;
     makeFlat_ = other.makeFlat_;
+    makeBiased_ = other.makeBiased_;
+    minRunLength_ = other.minRunLength_;
     filter_ = other.filter_;
     metadataFilters_ = other.metadataFilters_;
     selectivity_ = other.selectivity_;
@@ -36,8 +38,11 @@ ScanSpec& ScanSpec::operator=(const ScanSpec& other) {
     children_ = other.children_;
     stableChildren_ = other.stableChildren_;
     valueHook_ = other.valueHook_;
+    rowSampler_ = other.rowSampler_;
     isArrayElementOrMapEntry_ = other.isArrayElementOrMapEntry_;
     maxArrayElementsCount_ = other.maxArrayElementsCount_;
+    maxCollectionElements_ = other.maxCollectionElements_;
+    collectionOverflowPolicy_ = other.collectionOverflowPolicy_;
   }
   return *this;
 }
@@ -139,7 +144,7 @@ bool ScanSpec::hasFilter() const {
   if (hasFilter_.has_value()) {
     return hasFilter_.value();
   }
-  if (!isConstant() && filter_) {
+  if ((!isConstant() && filter_) || rowSampler_) {
     hasFilter_ = true;
     return true;
   }
@@ -407,7 +412,24 @@ std::shared_ptr<ScanSpec> ScanSpec::removeChild(const ScanSpec* child) {
   return nullptr;
 }
 
+void ScanSpec::setMaxCollectionElementsRecursively(
+    vector_size_t count,
+    CollectionOverflowPolicy policy) {
+  VELOX_CHECK_GE(count, 0);
+  maxCollectionElements_ = count;
+  collectionOverflowPolicy_ = policy;
+  for (auto& child : children_) {
+    child->setMaxCollectionElementsRecursively(count, policy);
+  }
+}
+
 void ScanSpec::addFilter(const Filter& filter) {
+  if (filter_ && filter.kind() == common::FilterKind::kBloomFilter) {
+    // Most filters do not know how to merge with a Bloom filter. The Bloom
+    // filter keeps the other filter as an exact conjunct.
+    filter_ = filter.mergeWith(filter_.get());
+    return;
+  }
   filter_ = filter_ ? filter_->mergeWith(&filter) : filter.clone();
 }
 
@@ -30,9 +30,19 @@ namespace facebook {
 namespace velox {
 namespace dwio::common {
 class ColumnStatistics;
-}
+class RowSampler;
+} // namespace dwio::common
 namespace common {
 
+/// What a reader does with an array or map value that has more elements than
+/// ScanSpec::maxCollectionElements().
+enum class CollectionOverflowPolicy {
+  // Returns the first maxCollectionElements() elements.
+  kTruncate,
+  // Fails the read with a user error.
+  kError,
+};
+
 // Describes the filtering and value extraction for a
 // SelectiveColumnReader. This is owned by the TableScan Operator and
 // is passed to SelectiveColumnReaders at construction.  This is
@@ -85,6 +95,23 @@ class ScanSpec {
     return maxArrayElementsCount_;
   }
 
+  /// Limits the elements of each array or map value read for 'this' and the
+  /// fields nested in it to 'count', with 'policy' for the values that have
+  /// more. The elements over a truncated value's limit are skipped without
+  /// being decoded, which bounds the memory of reading rows with very large
+  /// collections.
+  void setMaxCollectionElementsRecursively(
+      vector_size_t count,
+      CollectionOverflowPolicy policy);
+
+  vector_size_t maxCollectionElements() const {
+    return maxCollectionElements_;
+  }
+
+  CollectionOverflowPolicy collectionOverflowPolicy() const {
+    return collectionOverflowPolicy_;
+  }
+
   void addMetadataFilter(
       MetadataFilter::LeafNode* leaf,
       std::unique_ptr<common::Filter> filter) {
@@ -253,6 +280,17 @@ class ScanSpec {
     valueHook_ = valueHook;
   }
 
+  // The sampler of TABLESAMPLE BERNOULLI. Set only on the root spec of a
+  // scan. Not owned. Counts as a filter in hasFilter().
+  dwio::common::RowSampler* rowSampler() const {
+    return rowSampler_;
+  }
+
+  void setRowSampler(dwio::common::RowSampler* rowSampler) {
+    rowSampler_ = rowSampler;
+    hasFilter_.reset();
+  }
+
   // Returns true if the corresponding reader only needs to reference
   // the nulls stream. True if filter is is-null with or without value
   // extraction or if filter is is-not-null and no value is extracted.
@@ -277,6 +315,22 @@ class ScanSpec {
     makeFlat_ = makeFlat;
   }
 
+  bool makeBiased() const {
+    return makeBiased_;
+  }
+
+  void setMakeBiased(bool makeBiased) {
+    makeBiased_ = makeBiased;
+  }
+
+  vector_size_t minRunLength() const {
+    return minRunLength_;
+  }
+
+  void setMinRunLength(vector_size_t minRunLength) {
+    minRunLength_ = minRunLength;
+  }
+
   // True if this or a descendant has a filter that will affect the number of
   // output rows.  Note that filter on map keys and array indices is not
   // counted, as they do not change the number of container output rows.
@@ -375,6 +429,14 @@ class ScanSpec {
   // True if a string dictionary or flat map in this field should be
   // returned as flat.
   bool makeFlat_ = false;
+  // True if a BIGINT or INTEGER field should be returned as a BiasVector
+  // when the values of a batch fit a narrower type after subtracting their
+  // minimum.
+  bool makeBiased_ = false;
+  // If non-zero, a BIGINT, INTEGER or SMALLINT field is returned as a
+  // SequenceVector when its runs of equal values in a batch are at least this
+  // long on the average.
+  vector_size_t minRunLength_ = 0;
   std::shared_ptr<common::Filter> filter_;
 
   // Filters that will be only used for row group filtering based on metadata.
@@ -412,6 +474,7 @@ class ScanSpec {
 
   mutable std::optional<bool> hasFilter_;
   ValueHook* valueHook_ = nullptr;
+  dwio::common::RowSampler* rowSampler_ = nullptr;
 
   // If this node is map key/value or array element, filter will not be
   // propagated to parent.
@@ -420,6 +483,14 @@ class ScanSpec {
   // Only take the first maxArrayElementsCount_ elements from each array.
   vector_size_t maxArrayElementsCount_ =
       std::numeric_limits<vector_size_t>::max();
+
+  // Limit of the elements of each array or map value and the action for the
+  // values over it. Unlike 'maxArrayElementsCount_', which comes from the
+  // subscripts a query reads, this is a safety limit set by the connector.
+  vector_size_t maxCollectionElements_ =
+      std::numeric_limits<vector_size_t>::max();
+  CollectionOverflowPolicy collectionOverflowPolicy_ =
+      CollectionOverflowPolicy::kTruncate;
 };
 
 // Returns false if no value from a range defined by stats can pass the
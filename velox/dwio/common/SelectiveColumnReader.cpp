@@ -20,6 +20,44 @@ namespace facebook::velox::dwio::common {
 
 using dwio::common::TypeWithId;
 
+namespace {
+// Returns the narrowest type that stores values of T that are at most
+// 'range' above the bias of a BiasVector, or UNKNOWN if there is none.
+template <typename T>
+TypeKind biasedValueType(uint64_t range) {
+  if (range <= std::numeric_limits<int8_t>::max()) {
+    return TypeKind::TINYINT;
+  }
+  if (sizeof(T) > sizeof(int16_t) &&
+      range <= std::numeric_limits<int16_t>::max()) {
+    return TypeKind::SMALLINT;
+  }
+  if (sizeof(T) > sizeof(int32_t) &&
+      range <= std::numeric_limits<int32_t>::max()) {
+    return TypeKind::INTEGER;
+  }
+  return TypeKind::UNKNOWN;
+}
+
+template <typename T, typename TStored>
+BufferPtr makeBiasedValues(
+    const T* values,
+    vector_size_t size,
+    T bias,
+    memory::MemoryPool* pool) {
+  auto buffer = AlignedBuffer::allocate<TStored>(
+      size + (simd::kPadding / sizeof(TStored)), pool);
+  auto* stored = buffer->asMutable<TStored>();
+  for (auto i = 0; i < size; ++i) {
+    // Values of null rows are arbitrary and may not fit, so the difference is
+    // taken without overflow.
+    stored[i] = static_cast<TStored>(
+        static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(bias));
+  }
+  return buffer;
+}
+} // namespace
+
 velox::common::AlwaysTrue& alwaysTrue() {
   static velox::common::AlwaysTrue alwaysTrue;
   return alwaysTrue;
@@ -214,6 +252,141 @@ void SelectiveColumnReader::getIntValues(
             requestedType->toString());
     }
   }
+  if (scanSpec_->minRunLength() > 0) {
+    bool isSequence = false;
+    switch (requestedType->kind()) {
+      case TypeKind::BIGINT:
+        isSequence = makeSequence<int64_t>(result);
+        break;
+      case TypeKind::INTEGER:
+        isSequence = makeSequence<int32_t>(result);
+        break;
+      case TypeKind::SMALLINT:
+        isSequence = makeSequence<int16_t>(result);
+        break;
+      default:
+        break;
+    }
+    if (isSequence) {
+      return;
+    }
+  }
+  if (scanSpec_->makeBiased()) {
+    if (*requestedType == *BIGINT()) {
+      makeBiased<int64_t>(result);
+    } else if (*requestedType == *INTEGER()) {
+      makeBiased<int32_t>(result);
+    }
+  }
+}
+
+template <typename T>
+bool SelectiveColumnReader::makeSequence(VectorPtr* result) {
+  if ((*result)->encoding() != VectorEncoding::Simple::FLAT) {
+    return false;
+  }
+  auto* flat = (*result)->asUnchecked<FlatVector<T>>();
+  const auto size = flat->size();
+  const auto* values = flat->rawValues();
+  const auto* nulls = flat->rawNulls();
+  const vector_size_t maxRuns = size / scanSpec_->minRunLength();
+  if (maxRuns == 0 || values == nullptr) {
+    return false;
+  }
+  auto startsRun = [&](vector_size_t row) {
+    if (nulls) {
+      const bool isNull = bits::isBitNull(nulls, row);
+      if (isNull != bits::isBitNull(nulls, row - 1)) {
+        return true;
+      }
+      if (isNull) {
+        return false;
+      }
+    }
+    return values[row] != values[row - 1];
+  };
+  // Counts the runs, giving up as soon as there are too many.
+  vector_size_t numRuns = 1;
+  for (auto row = 1; row < size; ++row) {
+    if (startsRun(row) && ++numRuns > maxRuns) {
+      return false;
+    }
+  }
+
+  auto lengths = AlignedBuffer::allocate<vector_size_t>(numRuns, &memoryPool_);
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  auto runValues =
+      BaseVector::create<FlatVector<T>>(flat->type(), numRuns, &memoryPool_);
+  vector_size_t run = 0;
+  vector_size_t start = 0;
+  auto addRun = [&](vector_size_t end) {
+    rawLengths[run] = end - start;
+    if (nulls && bits::isBitNull(nulls, start)) {
+      runValues->setNull(run, true);
+    } else {
+      runValues->set(run, values[start]);
+    }
+    ++run;
+    start = end;
+  };
+  for (auto row = 1; row < size; ++row) {
+    if (startsRun(row)) {
+      addRun(row);
+    }
+  }
+  addRun(size);
+  *result = BaseVector::wrapInSequence(
+      std::move(lengths), size, std::move(runValues));
+  return true;
+}
+
+template <typename T>
+void SelectiveColumnReader::makeBiased(VectorPtr* result) {
+  if ((*result)->encoding() != VectorEncoding::Simple::FLAT) {
+    return;
+  }
+  auto* flat = (*result)->asUnchecked<FlatVector<T>>();
+  const auto size = flat->size();
+  const auto* values = flat->rawValues();
+  const auto* nulls = flat->rawNulls();
+  if (size == 0 || values == nullptr) {
+    return;
+  }
+  T min = std::numeric_limits<T>::max();
+  T max = std::numeric_limits<T>::min();
+  if (nulls) {
+    bits::forEachSetBit(nulls, 0, size, [&](auto row) {
+      min = std::min(min, values[row]);
+      max = std::max(max, values[row]);
+    });
+  } else {
+    for (auto row = 0; row < size; ++row) {
+      min = std::min(min, values[row]);
+      max = std::max(max, values[row]);
+    }
+  }
+  if (min > max) {
+    // All rows are null.
+    return;
+  }
+  const auto valueType = biasedValueType<T>(
+      static_cast<uint64_t>(max) - static_cast<uint64_t>(min));
+  BufferPtr stored;
+  switch (valueType) {
+    case TypeKind::TINYINT:
+      stored = makeBiasedValues<T, int8_t>(values, size, min, &memoryPool_);
+      break;
+    case TypeKind::SMALLINT:
+      stored = makeBiasedValues<T, int16_t>(values, size, min, &memoryPool_);
+      break;
+    case TypeKind::INTEGER:
+      stored = makeBiasedValues<T, int32_t>(values, size, min, &memoryPool_);
+      break;
+    default:
+      return;
+  }
+  *result = std::make_shared<BiasVector<T>>(
+      &memoryPool_, flat->nulls(), size, valueType, std::move(stored), min);
 }
 
 template <>
@@ -496,6 +496,17 @@ class SelectiveColumnReader {
   template <typename T, typename TVector>
   void upcastScalarValues(RowSet rows);
 
+  // Replaces the FlatVector<T> in '*result' with a BiasVector<T> if the
+  // non-null values fit a narrower type after subtracting their minimum.
+  template <typename T>
+  void makeBiased(VectorPtr* FOLLY_NONNULL result);
+
+  // Replaces the FlatVector<T> in '*result' with a SequenceVector and returns
+  // true if the runs of equal values are at least
+  // 'scanSpec_->minRunLength()' long on the average.
+  template <typename T>
+  bool makeSequence(VectorPtr* FOLLY_NONNULL result);
+
   // Returns true if compactScalarValues and upcastScalarValues should
   // move null flags. Checks consistency of nulls-related state.
   bool shouldMoveNulls(RowSet rows);
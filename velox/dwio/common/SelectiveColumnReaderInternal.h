@@ -23,6 +23,7 @@
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/exec/AggregationHook.h"
 #include "velox/type/Timestamp.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/ConstantVector.h"
 #include "velox/vector/DictionaryVector.h"
 #include "velox/vector/FlatVector.h"
@@ -30,11 +30,23 @@ void SelectiveRepeatedColumnReader::makeNestedRowSet(
   // Reads the lengths, leaves an uninitialized gap for a null
   // map/list. Reading these checks the null mask.
   readLengths(allLengths_.data(), maxRow + 1, nulls);
+  const auto maxCollectionElements = scanSpec_->maxCollectionElements();
+  const bool failOnOverflow = scanSpec_->collectionOverflowPolicy() ==
+      velox::common::CollectionOverflowPolicy::kError;
+  // The elements taken from each value. The ones after these are skipped.
+  const auto maxElements = failOnOverflow
+      ? scanSpec_->maxArrayElementsCount()
+      : std::min(scanSpec_->maxArrayElementsCount(), maxCollectionElements);
   vector_size_t nestedLength = 0;
   for (auto row : rows) {
     if (!nulls || !bits::isBitNull(nulls, row)) {
-      nestedLength +=
-          std::min(scanSpec_->maxArrayElementsCount(), allLengths_[row]);
+      VELOX_USER_CHECK(
+          !failOnOverflow || allLengths_[row] <= maxCollectionElements,
+          "Value of {} has {} elements, more than the limit of {}",
+          scanSpec_->fieldName(),
+          allLengths_[row],
+          maxCollectionElements);
+      nestedLength += std::min(maxElements, allLengths_[row]);
     }
   }
   nestedRowsHolder_.resize(nestedLength);
@@ -54,8 +66,7 @@ void SelectiveRepeatedColumnReader::makeNestedRowSet(
     if (nulls && bits::isBitNull(nulls, row)) {
       continue;
     }
-    auto lengthAtRow =
-        std::min(scanSpec_->maxArrayElementsCount(), allLengths_[row]);
+    auto lengthAtRow = std::min(maxElements, allLengths_[row]);
     std::iota(
         nestedRowsHolder_.data() + nestedRow,
         nestedRowsHolder_.data() + nestedRow + lengthAtRow,
@@ -16,7 +16,12 @@
 
 #include "velox/dwio/common/SelectiveStructColumnReader.h"
 
+#include <numeric>
+
 #include "velox/dwio/common/ColumnLoader.h"
+#include "velox/dwio/common/DecodedVectorCache.h"
+#include "velox/dwio/common/ParallelFor.h"
+#include "velox/dwio/common/RowSampler.h"
 
 namespace facebook::velox::dwio::common {
 
@@ -62,6 +67,9 @@ void SelectiveStructColumnReaderBase::next(
     // This can be either count(*) query or a query that select only
     // constant columns (partition keys or columns missing from an old file
     // due to schema evolution)
+    if (auto* sampler = scanSpec_->rowSampler()) {
+      numValues = sampler->sample(numValues);
+    }
     result->resize(numValues);
 
     auto resultRowVector = std::dynamic_pointer_cast<RowVector>(result);
@@ -109,8 +117,23 @@ void SelectiveStructColumnReaderBase::read(
     }
     activeRows = outputRows_;
   }
+  if (auto* sampler = scanSpec_->rowSampler()) {
+    // TABLESAMPLE BERNOULLI drops rows before any field is read. Only the
+    // root spec has a sampler and the root has no null filter, so
+    // 'activeRows' is 'rows' here.
+    hasFilter = true;
+    setNumRows(sampler->sample(activeRows, mutableOutputRows(rows.size())));
+    if (outputRows_.empty()) {
+      recordParentNullsInChildren(offset, rows);
+      lazyVectorReadOffset_ = offset;
+      readOffset_ = offset + rows.back() + 1;
+      return;
+    }
+    activeRows = outputRows_;
+  }
 
-  assert(!children_.empty());
+  // The children without filters to decode in parallel after the filters.
+  std::vector<SelectiveColumnReader*> parallelReaders;
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
     if (childSpec->isConstant()) {
@@ -118,6 +141,10 @@ void SelectiveStructColumnReaderBase::read(
     }
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex);
+    if (!childSpec->hasFilter() && parallelDecoding()) {
+      parallelReaders.push_back(reader);
+      continue;
+    }
     if (reader->isTopLevel() && childSpec->projectOut() &&
         !childSpec->hasFilter() && !childSpec->extractValues()) {
       // Will make a LazyVector.
@@ -145,6 +172,18 @@ void SelectiveStructColumnReaderBase::read(
       reader->read(offset, activeRows, structNulls);
     }
   }
+  if (!parallelReaders.empty() && !activeRows.empty()) {
+    for (auto* reader : parallelReaders) {
+      advanceFieldReader(reader, offset);
+    }
+    runInParallel(
+        decodingExecutor_,
+        decodingParallelism_,
+        parallelReaders.size(),
+        [&](int32_t i) {
+          parallelReaders[i]->read(offset, activeRows, structNulls);
+        });
+  }
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
@@ -203,7 +242,6 @@ void fillRowVectorChildren(
 void SelectiveStructColumnReaderBase::getValues(
     RowSet rows,
     VectorPtr* result) {
-  assert(!children_.empty());
   VELOX_CHECK(
       *result != nullptr,
       "SelectiveStructColumnReaderBase expects a non-null result");
@@ -237,6 +275,8 @@ void SelectiveStructColumnReaderBase::getValues(
   }
   bool lazyPrepared = false;
   auto& childSpecs = scanSpec_->children();
+  // The children whose values are made in parallel.
+  std::vector<std::pair<column_index_t, column_index_t>> parallelChildren;
   for (auto i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
     if (!childSpec->projectOut()) {
@@ -247,9 +287,19 @@ void SelectiveStructColumnReaderBase::getValues(
     if (childSpec->isConstant()) {
       resultRow->childAt(channel) = BaseVector::wrapInConstant(
           rows.size(), 0, childSpec->constantValue());
+    } else if (parallelDecoding()) {
+      parallelChildren.emplace_back(index, channel);
     } else {
       if (!childSpec->extractValues() && !childSpec->hasFilter() &&
           children_[index]->isTopLevel()) {
+        if (decodedVectorCache_ &&
+            getCachedValues(
+                *children_[index],
+                resultRow->type()->childAt(channel),
+                rows,
+                resultRow->childAt(channel))) {
+          continue;
+        }
         // LazyVector result.
         if (!lazyPrepared) {
           if (rows.size() != outputRows_.size()) {
@@ -267,6 +317,56 @@ void SelectiveStructColumnReaderBase::getValues(
       }
     }
   }
+  if (!parallelChildren.empty()) {
+    runInParallel(
+        decodingExecutor_,
+        decodingParallelism_,
+        parallelChildren.size(),
+        [&](int32_t i) {
+          auto [index, channel] = parallelChildren[i];
+          children_[index]->getValues(rows, &resultRow->childAt(channel));
+        });
+  }
+}
+
+bool SelectiveStructColumnReaderBase::getCachedValues(
+    SelectiveColumnReader& child,
+    const TypePtr& type,
+    RowSet rows,
+    VectorPtr& result) {
+  // The key does not have the type, so only columns read as their file type
+  // are cached.
+  if (!type->isPrimitiveType() || !child.type()->equivalent(*type)) {
+    return false;
+  }
+  const auto numRows = readOffset_ - lazyVectorReadOffset_;
+  DecodedVectorCache::Key key{
+      decodedVectorCacheFileNum_,
+      decodedVectorCacheRowGroup_,
+      child.nodeType().id(),
+      static_cast<int32_t>(lazyVectorReadOffset_),
+      static_cast<int32_t>(numRows)};
+  auto values = decodedVectorCache_->find(key);
+  if (!values) {
+    // Decodes all the rows so that the entry does not depend on the filters
+    // of the other columns.
+    allRows_.resize(numRows);
+    std::iota(allRows_.begin(), allRows_.end(), 0);
+    advanceFieldReader(&child, lazyVectorReadOffset_);
+    child.read(lazyVectorReadOffset_, allRows_, nullptr);
+    child.getValues(allRows_, &values);
+    values = decodedVectorCache_->insert(key, values);
+  }
+  if (rows.size() == numRows) {
+    result = std::move(values);
+    return true;
+  }
+  auto indices = allocateIndices(rows.size(), &memoryPool_);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  std::copy(rows.begin(), rows.end(), rawIndices);
+  result = BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), rows.size(), std::move(values));
+  return true;
 }
 
 } // namespace facebook::velox::dwio::common
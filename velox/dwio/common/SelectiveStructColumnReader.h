@@ -18,8 +18,12 @@
 
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwio::common {
 
+class DecodedVectorCache;
+
 class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
  public:
   void resetFilterCaches() override {
@@ -98,6 +102,31 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
     return debugString_;
   }
 
+  /// Makes read() decode the projected children without filters on
+  /// 'executor' after the filters are evaluated, at most 'parallelism'
+  /// children at a time including the calling thread. These children are then
+  /// returned loaded instead of as LazyVectors. Only for the root reader.
+  void setDecodingExecutor(folly::Executor* executor, int32_t parallelism) {
+    VELOX_CHECK_GE(parallelism, 1);
+    decodingExecutor_ = executor;
+    decodingParallelism_ = parallelism;
+  }
+
+  /// Makes getValues() take the projected scalar children without filters
+  /// from 'cache' instead of returning them as LazyVectors. On a miss, the
+  /// child is decoded for all the rows of the batch, whatever the filters on
+  /// the other children, and cached. 'fileNum' and 'rowGroup' are the file
+  /// and the stripe or row group of the rows of 'this'. Only for the root
+  /// reader and only when children are not decoded in parallel.
+  void setDecodedVectorCache(
+      DecodedVectorCache* cache,
+      uint64_t fileNum,
+      int32_t rowGroup) {
+    decodedVectorCache_ = cache;
+    decodedVectorCacheFileNum_ = fileNum;
+    decodedVectorCacheRowGroup_ = rowGroup;
+  }
+
  protected:
   SelectiveStructColumnReaderBase(
       const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
@@ -115,6 +144,19 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // know how much to skip when seeking forward within the row group.
   void recordParentNullsInChildren(vector_size_t offset, RowSet rows);
 
+  bool parallelDecoding() const {
+    return decodingExecutor_ && decodingParallelism_ > 1;
+  }
+
+  // Sets 'result' to the values of 'child' for 'rows' from
+  // 'decodedVectorCache_', decoding and caching them if they are not cached.
+  // Returns false if the values of 'child' as 'type' are not cached.
+  bool getCachedValues(
+      SelectiveColumnReader& child,
+      const TypePtr& type,
+      RowSet rows,
+      VectorPtr& result);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
 
   std::vector<SelectiveColumnReader*> children_;
@@ -134,6 +176,17 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // and query. Set at construction, which takes place on first
   // use. If no ExceptionContext is in effect, this is "".
   const std::string debugString_;
+
+  // Executor and parallelism for decoding children, see setDecodingExecutor().
+  folly::Executor* decodingExecutor_{nullptr};
+  int32_t decodingParallelism_{1};
+
+  // See setDecodedVectorCache().
+  DecodedVectorCache* decodedVectorCache_{nullptr};
+  uint64_t decodedVectorCacheFileNum_{0};
+  int32_t decodedVectorCacheRowGroup_{0};
+  // All the rows of the batch, to decode a child for the cache.
+  raw_vector<vector_size_t> allRows_;
 };
 
 struct SelectiveStructColumnReader : SelectiveStructColumnReaderBase {
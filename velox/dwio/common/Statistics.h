@@ -523,6 +523,14 @@ struct RuntimeStatistics {
   // Total bytes in splits skipped based on statistics.
   int64_t skippedSplitBytes{0};
 
+  // Number of the skipped splits that were skipped before opening the file,
+  // based on partition keys or on statistics passed in the split.
+  int64_t prunedSplits{0};
+
+  // Number of the skipped splits that were left out of a TABLESAMPLE SYSTEM
+  // sample.
+  int64_t sampledOutSplits{0};
+
   // Number of strides (row groups) skipped based on statistics.
   int64_t skippedStrides{0};
 
@@ -535,6 +543,8 @@ struct RuntimeStatistics {
         {"processedSplits", RuntimeCounter(processedSplits)},
         {"skippedSplitBytes",
          RuntimeCounter(skippedSplitBytes, RuntimeCounter::Unit::kBytes)},
+        {"prunedSplits", RuntimeCounter(prunedSplits)},
+        {"sampledOutSplits", RuntimeCounter(sampledOutSplits)},
         {"skippedStrides", RuntimeCounter(skippedStrides)},
         {"processedStrides", RuntimeCounter(processedStrides)}};
   }
@@ -316,7 +316,10 @@ BENCHMARK_UNPACK_ODDROWS_CASE_32(13)
 BENCHMARK_UNPACK_ODDROWS_CASE_32(16)
 BENCHMARK_UNPACK_ODDROWS_CASE_32(22)
 BENCHMARK_UNPACK_ODDROWS_CASE_32(24)
+BENCHMARK_UNPACK_ODDROWS_CASE_32(26)
+BENCHMARK_UNPACK_ODDROWS_CASE_32(28)
 BENCHMARK_UNPACK_ODDROWS_CASE_32(31)
+BENCHMARK_UNPACK_ODDROWS_CASE_32(32)
 
 void populateBitPacked() {
   bitPackedData.resize(33);
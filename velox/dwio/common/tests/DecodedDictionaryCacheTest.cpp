@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/DecodedDictionaryCache.h"
+#include "velox/type/StringView.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+
+DecodedDictionaryCache::Key
+makeKey(const std::string& name, uint32_t stripe = 0, uint64_t offset = 3) {
+  return {name, 1'000, stripe, 1, offset};
+}
+
+// Returns a dictionary of 'numValues' strings of 'size' bytes each.
+std::shared_ptr<const DecodedDictionary> makeDictionary(
+    int32_t numValues,
+    int32_t size) {
+  auto& pool = DecodedDictionaryCache::pool();
+  auto dictionary = std::make_shared<DecodedDictionary>();
+  dictionary->numValues = numValues;
+  dictionary->values = AlignedBuffer::allocate<StringView>(numValues, &pool);
+  dictionary->strings = AlignedBuffer::allocate<char>(numValues * size, &pool);
+  auto* strings = dictionary->strings->asMutable<char>();
+  auto* views = dictionary->values->asMutable<StringView>();
+  for (auto i = 0; i < numValues; ++i) {
+    memset(strings + i * size, 'a' + i % 26, size);
+    views[i] = StringView(strings + i * size, size);
+  }
+  return dictionary;
+}
+
+} // namespace
+
+TEST(DecodedDictionaryCacheTest, getAndPut) {
+  DecodedDictionaryCache cache(1 << 20);
+  ASSERT_EQ(cache.get(makeKey("a")), nullptr);
+  cache.put(makeKey("a"), makeDictionary(10, 20));
+  auto dictionary = cache.get(makeKey("a"));
+  ASSERT_NE(dictionary, nullptr);
+  ASSERT_EQ(dictionary->numValues, 10);
+  ASSERT_EQ(
+      dictionary->values->as<StringView>()[3].str(), std::string(20, 'd'));
+
+  // Another stripe, column, offset or file size is another dictionary.
+  ASSERT_EQ(cache.get(makeKey("a", 1)), nullptr);
+  ASSERT_EQ(cache.get(makeKey("a", 0, 4)), nullptr);
+  ASSERT_EQ(cache.get({"a", 1'000, 0, 2, 3}), nullptr);
+  ASSERT_EQ(cache.get({"a", 1'001, 0, 1, 3}), nullptr);
+
+  // The first put of a key wins.
+  cache.put(makeKey("a"), makeDictionary(5, 20));
+  ASSERT_EQ(cache.get(makeKey("a"))->numValues, 10);
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_EQ(stats.curBytes, dictionary->bytes());
+  ASSERT_EQ(stats.numLookups, 7);
+  ASSERT_EQ(stats.numHits, 2);
+
+  // The buffers stay valid for the holders of an entry after it is dropped.
+  cache.clear();
+  ASSERT_EQ(cache.get(makeKey("a")), nullptr);
+  ASSERT_EQ(cache.stats().curBytes, 0);
+  ASSERT_EQ(
+      dictionary->values->as<StringView>()[9].str(), std::string(20, 'j'));
+}
+
+TEST(DecodedDictionaryCacheTest, evict) {
+  const auto bytes = makeDictionary(100, 100)->bytes();
+  DecodedDictionaryCache cache(4 * bytes);
+  for (auto i = 0; i < 4; ++i) {
+    cache.put(makeKey(fmt::format("file{}", i)), makeDictionary(100, 100));
+  }
+  // Makes file0 the most recently used.
+  ASSERT_NE(cache.get(makeKey("file0")), nullptr);
+  cache.put(makeKey("file4"), makeDictionary(100, 100));
+  ASSERT_EQ(cache.get(makeKey("file1")), nullptr);
+  ASSERT_NE(cache.get(makeKey("file0")), nullptr);
+  ASSERT_NE(cache.get(makeKey("file4")), nullptr);
+  ASSERT_EQ(cache.stats().numEvictions, 1);
+  ASSERT_EQ(cache.stats().curBytes, 4 * bytes);
+
+  // A dictionary larger than a quarter of the budget is not cached.
+  cache.put(makeKey("large"), makeDictionary(100, 200));
+  ASSERT_EQ(cache.get(makeKey("large")), nullptr);
+  ASSERT_EQ(cache.stats().numEntries, 4);
+}
+
+TEST(DecodedDictionaryCacheTest, makeKey) {
+  InMemoryReadFile file(std::string(100, 'x'));
+  ASSERT_FALSE(DecodedDictionaryCache::makeKey(file, 0, 1, 3).has_value());
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/DecodedVectorCache.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+
+DecodedVectorCache::Key makeKey(uint32_t nodeId, int32_t firstRow = 0) {
+  return {1, 0, nodeId, firstRow, 1'000};
+}
+
+class DecodedVectorCacheTest : public testing::Test {
+ protected:
+  // Returns a BIGINT vector of 'size' rows where row 'i' is 'i + start'.
+  VectorPtr makeVector(int32_t size, int64_t start = 0) {
+    auto vector = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), size, pool_.get());
+    for (auto i = 0; i < size; ++i) {
+      vector->set(i, i + start);
+    }
+    return vector;
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{
+      memory::addDefaultLeafMemoryPool()};
+  std::shared_ptr<memory::MemoryPool> cachePool_{
+      memory::addDefaultLeafMemoryPool()};
+};
+
+} // namespace
+
+TEST_F(DecodedVectorCacheTest, findAndInsert) {
+  DecodedVectorCache cache(cachePool_, 1 << 20);
+  ASSERT_EQ(cache.find(makeKey(1)), nullptr);
+  auto vector = makeVector(1'000);
+  auto cached = cache.insert(makeKey(1), vector);
+  // The cache keeps a copy in its own pool.
+  ASSERT_NE(cached, vector);
+  ASSERT_EQ(cached->pool(), cachePool_.get());
+  ASSERT_EQ(cached->size(), 1'000);
+  ASSERT_EQ(cached->asFlatVector<int64_t>()->valueAt(123), 123);
+
+  auto found = cache.find(makeKey(1));
+  ASSERT_EQ(found, cached);
+  // Another column or range of rows is another entry.
+  ASSERT_EQ(cache.find(makeKey(2)), nullptr);
+  ASSERT_EQ(cache.find(makeKey(1, 1'000)), nullptr);
+
+  // The first insert of a key wins.
+  ASSERT_EQ(cache.insert(makeKey(1), makeVector(1'000, 5)), cached);
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_EQ(stats.curBytes, cached->retainedSize());
+  ASSERT_EQ(stats.numLookups, 4);
+  ASSERT_EQ(stats.numHits, 1);
+
+  cache.clear();
+  ASSERT_EQ(cache.find(makeKey(1)), nullptr);
+  ASSERT_EQ(cache.stats().curBytes, 0);
+}
+
+TEST_F(DecodedVectorCacheTest, evict) {
+  const auto entryBytes =
+      DecodedVectorCache(cachePool_, 1 << 20)
+          .insert(makeKey(0), makeVector(1'000))
+          ->retainedSize();
+  DecodedVectorCache cache(cachePool_, 4 * entryBytes);
+  for (auto i = 0; i < 4; ++i) {
+    cache.insert(makeKey(i), makeVector(1'000, i));
+  }
+  ASSERT_EQ(cache.stats().curBytes, 4 * entryBytes);
+  // Makes all but column 1 used more, so that column 1 has the highest score.
+  for (auto i : {0, 2, 3}) {
+    ASSERT_NE(cache.find(makeKey(i)), nullptr);
+  }
+  cache.insert(makeKey(4), makeVector(1'000, 4));
+  ASSERT_EQ(cache.find(makeKey(1)), nullptr);
+  ASSERT_NE(cache.find(makeKey(4)), nullptr);
+  ASSERT_EQ(cache.stats().numEvictions, 1);
+  ASSERT_EQ(cache.stats().curBytes, 4 * entryBytes);
+
+  // Eviction by the AsyncDataCache frees at least the requested bytes.
+  ASSERT_GE(cache.evict(entryBytes + 1), 2 * entryBytes);
+  ASSERT_EQ(cache.stats().numEntries, 2);
+  ASSERT_EQ(cache.stats().curBytes, 2 * entryBytes);
+
+  // A vector larger than a quarter of the budget is returned uncached.
+  auto large = makeVector(2'000);
+  ASSERT_EQ(cache.insert(makeKey(5), large), large);
+  ASSERT_EQ(cache.find(makeKey(5)), nullptr);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+
+FileMetadataCache::Key makeKey(const std::string& name, uint64_t size = 100) {
+  return {FileFormat::DWRF, name, size};
+}
+
+} // namespace
+
+TEST(FileMetadataCacheTest, getAndPut) {
+  FileMetadataCache cache(1'000);
+  ASSERT_EQ(cache.get<std::string>(makeKey("a")), nullptr);
+  cache.put(makeKey("a"), std::make_shared<const std::string>("footer a"), 10);
+  auto footer = cache.get<std::string>(makeKey("a"));
+  ASSERT_NE(footer, nullptr);
+  ASSERT_EQ(*footer, "footer a");
+
+  // Same name with another size or format is another file.
+  ASSERT_EQ(cache.get<std::string>(makeKey("a", 101)), nullptr);
+  ASSERT_EQ(cache.get<std::string>({FileFormat::PARQUET, "a", 100}), nullptr);
+
+  // The first put of a key wins.
+  cache.put(makeKey("a"), std::make_shared<const std::string>("other"), 10);
+  ASSERT_EQ(*cache.get<std::string>(makeKey("a")), "footer a");
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_EQ(stats.curBytes, 10);
+  ASSERT_EQ(stats.numLookups, 5);
+  ASSERT_EQ(stats.numHits, 2);
+
+  cache.clear();
+  ASSERT_EQ(cache.get<std::string>(makeKey("a")), nullptr);
+  ASSERT_EQ(cache.stats().curBytes, 0);
+}
+
+TEST(FileMetadataCacheTest, evict) {
+  FileMetadataCache cache(1'000);
+  for (auto i = 0; i < 4; ++i) {
+    cache.put(
+        makeKey(fmt::format("file{}", i)),
+        std::make_shared<const int32_t>(i),
+        250);
+  }
+  // Makes file0 the most recently used.
+  ASSERT_NE(cache.get<int32_t>(makeKey("file0")), nullptr);
+  cache.put(makeKey("file4"), std::make_shared<const int32_t>(4), 250);
+  ASSERT_EQ(cache.get<int32_t>(makeKey("file1")), nullptr);
+  ASSERT_EQ(*cache.get<int32_t>(makeKey("file0")), 0);
+  ASSERT_EQ(*cache.get<int32_t>(makeKey("file4")), 4);
+  ASSERT_EQ(cache.stats().numEvictions, 1);
+  ASSERT_EQ(cache.stats().curBytes, 1'000);
+
+  // An entry larger than a quarter of the budget is not cached.
+  cache.put(makeKey("large"), std::make_shared<const int32_t>(5), 251);
+  ASSERT_EQ(cache.get<int32_t>(makeKey("large")), nullptr);
+  ASSERT_EQ(cache.stats().numEntries, 4);
+}
+
+TEST(FileMetadataCacheTest, makeKey) {
+  InMemoryReadFile inMemory(std::string(10, 'x'));
+  ASSERT_FALSE(FileMetadataCache::makeKey(FileFormat::DWRF, inMemory));
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/IoCostModel.h"
+
+using namespace facebook::velox::dwio::common;
+
+TEST(IoCostModelTest, estimate) {
+  IoCostModel model;
+  // Reads take 2ms plus 10us per KB, i.e. 100 bytes per us.
+  auto readMicros = [](uint64_t bytes) { return 2'000 + bytes / 100; };
+  for (auto i = 0; i < IoCostModel::kMinReads - 1; ++i) {
+    const uint64_t bytes = (1 + i % 8) << 20;
+    model.recordRead(bytes, readMicros(bytes));
+  }
+  ASSERT_EQ(model.maxCoalesceDistance(123), 123);
+  ASSERT_EQ(model.maxCoalesceBytes(456), 456);
+
+  model.recordRead(64 << 10, readMicros(64 << 10));
+  EXPECT_NEAR(model.latencyMicros(), 2'000, 1);
+  EXPECT_NEAR(model.bytesPerMicro(), 100, 0.1);
+  // The gap that takes as long to read as the latency of a request.
+  EXPECT_NEAR(model.maxCoalesceDistance(123), 200'000, 200);
+  EXPECT_NEAR(
+      model.maxCoalesceBytes(456),
+      200'000 * IoCostModel::kTransferToLatency,
+      200 * IoCostModel::kTransferToLatency);
+}
+
+TEST(IoCostModelTest, bounds) {
+  IoCostModel model;
+  // Very low latency and high bandwidth, as from a local SSD.
+  for (auto i = 0; i < IoCostModel::kMinReads; ++i) {
+    const uint64_t bytes = (1 + i % 4) << 16;
+    model.recordRead(bytes, 1 + bytes / 100'000);
+  }
+  ASSERT_GE(model.maxCoalesceDistance(0), IoCostModel::kMinCoalesceDistance);
+  ASSERT_GE(model.maxCoalesceBytes(0), IoCostModel::kMinCoalesceBytes);
+}
+
+TEST(IoCostModelTest, forPath) {
+  auto& s3 = IoCostModel::forPath("s3://bucket/key");
+  ASSERT_EQ(&s3, &IoCostModel::forPath("s3://other/key"));
+  ASSERT_NE(&s3, &IoCostModel::forPath("hdfs://host:1234/file"));
+  ASSERT_EQ(&IoCostModel::forPath("/tmp/a"), &IoCostModel::forPath("/tmp/b"));
+}
@@ -31,3 +31,75 @@ TEST(TestBufferedInput, ZeroLengthStream) {
   EXPECT_FALSE(ret->Next(&buf, &size));
   EXPECT_EQ(size, 0);
 }
+
+namespace {
+// A file in memory that returns its bytes from mappedData() like a mapped
+// LocalReadFile and fails if it is read with pread.
+class MappedReadFile : public facebook::velox::ReadFile {
+ public:
+  explicit MappedReadFile(std::string data) : data_(std::move(data)) {}
+
+  std::string_view pread(uint64_t, uint64_t, void*) const override {
+    VELOX_FAIL("Mapped file should not be read");
+  }
+
+  const char* mappedData(uint64_t offset, uint64_t length) const override {
+    bytesRead_ += length;
+    return data_.data() + offset;
+  }
+
+  bool shouldCoalesce() const override {
+    return false;
+  }
+
+  uint64_t size() const override {
+    return data_.size();
+  }
+
+  uint64_t memoryUsage() const override {
+    return data_.size();
+  }
+
+  std::string getName() const override {
+    return "<MappedReadFile>";
+  }
+
+  uint64_t getNaturalReadSize() const override {
+    return 1 << 20;
+  }
+
+  const char* data() const {
+    return data_.data();
+  }
+
+ private:
+  const std::string data_;
+};
+} // namespace
+
+TEST(TestBufferedInput, mappedFile) {
+  std::string data(10'000, 'a');
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 26;
+  }
+  auto readFile = std::make_shared<MappedReadFile>(data);
+  auto pool = facebook::velox::memory::addDefaultLeafMemoryPool();
+  BufferedInput input(readFile, *pool);
+  auto first = input.enqueue({100, 50});
+  auto second = input.enqueue({5'000, 26});
+  input.load(LogType::STREAM);
+  EXPECT_EQ(readFile->bytesRead(), 4'926);
+
+  // The streams point into the mapped bytes.
+  const void* buf = nullptr;
+  int32_t size = 0;
+  ASSERT_TRUE(first->Next(&buf, &size));
+  EXPECT_EQ(size, 50);
+  EXPECT_EQ(buf, readFile->data() + 100);
+  ASSERT_TRUE(second->Next(&buf, &size));
+  EXPECT_EQ(size, 26);
+  EXPECT_EQ(
+      std::string_view(static_cast<const char*>(buf), size),
+      data.substr(5'000, 26));
+  EXPECT_EQ(pool->getCurrentBytes(), 0);
+}
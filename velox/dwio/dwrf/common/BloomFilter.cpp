@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <folly/lang/Bits.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+// Seed and constants of the 64 bit Murmur3 used by ORC.
+constexpr uint64_t kSeed = 104729;
+constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t kM = 5;
+constexpr uint64_t kN1 = 0x52dce729;
+
+inline uint64_t rotateLeft(uint64_t value, int32_t shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint64_t mixK1(uint64_t k1) {
+  k1 *= kC1;
+  k1 = rotateLeft(k1, 31);
+  return k1 * kC2;
+}
+
+inline uint64_t fmix64(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Arithmetic right shift as in Java's '>>'.
+inline uint64_t shiftRight(uint64_t value, int32_t shift) {
+  return static_cast<uint64_t>(static_cast<int64_t>(value) >> shift);
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE_GT(expectedEntries, 0);
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Bad bloom filter fpp ", fpp);
+  const auto numBits = static_cast<uint64_t>(
+      -static_cast<double>(expectedEntries) * std::log(fpp) /
+      (std::log(2.0) * std::log(2.0)));
+  numHashFunctions_ = std::max<uint32_t>(
+      1,
+      static_cast<uint32_t>(std::round(
+          static_cast<double>(numBits) / expectedEntries * std::log(2.0))));
+  // Same rounding up to whole words as ORC, which always adds a word.
+  bits_.resize(numBits / 64 + 1);
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& filter)
+    : numHashFunctions_{filter.numhashfunctions()} {
+  if (filter.has_utf8bitset()) {
+    const auto& bytes = filter.utf8bitset();
+    DWIO_ENSURE_EQ(bytes.size() % sizeof(uint64_t), 0, "Bad bloom filter");
+    bits_.resize(bytes.size() / sizeof(uint64_t));
+    for (auto i = 0; i < bits_.size(); ++i) {
+      uint64_t word;
+      memcpy(&word, bytes.data() + i * sizeof(uint64_t), sizeof(word));
+      bits_[i] = folly::Endian::little(word);
+    }
+  } else {
+    bits_.assign(filter.bitset().begin(), filter.bitset().end());
+  }
+  DWIO_ENSURE(!bits_.empty() && numHashFunctions_ > 0, "Bad bloom filter");
+}
+
+void BloomFilter::reset() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void BloomFilter::serialize(proto::BloomFilter& filter) const {
+  filter.set_numhashfunctions(numHashFunctions_);
+  std::string bytes(bits_.size() * sizeof(uint64_t), '\0');
+  for (auto i = 0; i < bits_.size(); ++i) {
+    const uint64_t word = folly::Endian::little(bits_[i]);
+    memcpy(bytes.data() + i * sizeof(uint64_t), &word, sizeof(word));
+  }
+  filter.set_utf8bitset(std::move(bytes));
+}
+
+// static
+uint64_t BloomFilter::getLongHash(int64_t value) {
+  auto key = static_cast<uint64_t>(value);
+  key = ~key + (key << 21);
+  key ^= shiftRight(key, 24);
+  key = key + (key << 3) + (key << 8);
+  key ^= shiftRight(key, 14);
+  key = key + (key << 2) + (key << 4);
+  key ^= shiftRight(key, 28);
+  key += key << 31;
+  return key;
+}
+
+// static
+uint64_t BloomFilter::getBytesHash(std::string_view value) {
+  const auto* data = reinterpret_cast<const uint8_t*>(value.data());
+  const auto length = value.size();
+  const auto numBlocks = length / 8;
+  uint64_t hash = kSeed;
+  for (auto i = 0; i < numBlocks; ++i) {
+    uint64_t k;
+    memcpy(&k, data + i * 8, sizeof(k));
+    hash ^= mixK1(folly::Endian::little(k));
+    hash = rotateLeft(hash, 27) * kM + kN1;
+  }
+  const auto* tail = data + numBlocks * 8;
+  uint64_t k1 = 0;
+  for (auto i = length - numBlocks * 8; i > 0; --i) {
+    k1 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 1) * 8);
+  }
+  if (length % 8 != 0) {
+    hash ^= mixK1(k1);
+  }
+  hash ^= length;
+  return fmix64(hash);
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto position = combined % numBits;
+    bits_[position / 64] |= 1ULL << (position % 64);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  const auto hash1 = static_cast<uint32_t>(hash);
+  const auto hash2 = static_cast<uint32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto position = combined % numBits;
+    if ((bits_[position / 64] & (1ULL << (position % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+// Bloom filter of the values of a column in a row index stride. The hashing
+// and the serialized form are those of the ORC BLOOM_FILTER_UTF8 stream:
+// integers are hashed with Thomas Wang's 64 bit mix and bytes with 64 bit
+// Murmur3, and each hash sets the bits given by double hashing of its two 32
+// bit halves.
+class BloomFilter {
+ public:
+  // Makes an empty filter sized for 'expectedEntries' values at the false
+  // positive probability 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  // Makes a filter from its serialized form.
+  explicit BloomFilter(const proto::BloomFilter& filter);
+
+  void addLong(int64_t value) {
+    addHash(getLongHash(value));
+  }
+
+  void addBytes(std::string_view value) {
+    addHash(getBytesHash(value));
+  }
+
+  // Returns false if 'value' was certainly not added.
+  bool testLong(int64_t value) const {
+    return testHash(getLongHash(value));
+  }
+
+  bool testBytes(std::string_view value) const {
+    return testHash(getBytesHash(value));
+  }
+
+  // Clears all bits.
+  void reset();
+
+  void serialize(proto::BloomFilter& filter) const;
+
+  uint64_t numBits() const {
+    return bits_.size() * 64;
+  }
+
+  uint32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  static uint64_t getLongHash(int64_t value);
+
+  static uint64_t getBytesHash(std::string_view value);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  std::vector<uint64_t> bits_;
+  uint32_t numHashFunctions_;
+};
+
+} // namespace facebook::velox::dwrf
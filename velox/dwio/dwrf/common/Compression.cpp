@@ -25,6 +25,7 @@
 #include <folly/logging/xlog.h>
 #include <lz4.h>
 #include <snappy.h>
+#include <zdict.h>
 #include <zlib.h>
 #include <zstd.h>
 #include <zstd_errors.h>
@@ -35,18 +36,81 @@ using dwio::common::encryption::Decrypter;
 using dwio::common::encryption::Encrypter;
 using memory::MemoryPool;
 
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(static_cast<ZSTD_CDict*>(cdict_));
+  ZSTD_freeDDict(static_cast<ZSTD_DDict*>(ddict_));
+}
+
+const void* ZstdDictionary::compressionDictionary(int32_t level) const {
+  std::call_once(cdictOnce_, [&]() {
+    cdict_ = ZSTD_createCDict(data_.data(), data_.size(), level);
+    DWIO_ENSURE_NOT_NULL(cdict_, "Failed to prepare ZSTD dictionary");
+  });
+  return cdict_;
+}
+
+const void* ZstdDictionary::decompressionDictionary() const {
+  std::call_once(ddictOnce_, [&]() {
+    ddict_ = ZSTD_createDDict(data_.data(), data_.size());
+    DWIO_ENSURE_NOT_NULL(ddict_, "Failed to prepare ZSTD dictionary");
+  });
+  return ddict_;
+}
+
+std::string trainZstdDictionary(
+    const std::vector<std::string>& samples,
+    size_t maxSize) {
+  std::string buffer;
+  std::vector<size_t> sampleSizes;
+  sampleSizes.reserve(samples.size());
+  for (const auto& sample : samples) {
+    buffer.append(sample);
+    sampleSizes.push_back(sample.size());
+  }
+  std::string dictionary(maxSize, '\0');
+  const auto size = ZDICT_trainFromBuffer(
+      dictionary.data(),
+      maxSize,
+      buffer.data(),
+      sampleSizes.data(),
+      sampleSizes.size());
+  if (ZDICT_isError(size)) {
+    VLOG(1) << "No ZSTD dictionary trained: " << ZDICT_getErrorName(size);
+    return "";
+  }
+  dictionary.resize(size);
+  return dictionary;
+}
+
 namespace {
 
 class ZstdCompressor : public Compressor {
  public:
-  explicit ZstdCompressor(int32_t level) : Compressor{level} {}
+  ZstdCompressor(int32_t level, const ZstdDictionary* dictionary)
+      : Compressor{level},
+        dictionary_{
+            dictionary ? static_cast<const ZSTD_CDict*>(
+                             dictionary->compressionDictionary(level))
+                       : nullptr},
+        context_{dictionary_ ? ZSTD_createCCtx() : nullptr} {}
+
+  ~ZstdCompressor() override {
+    ZSTD_freeCCtx(context_);
+  }
 
   uint64_t compress(const void* src, void* dest, uint64_t length) override;
+
+ private:
+  const ZSTD_CDict* const dictionary_;
+  ZSTD_CCtx* const context_;
 };
 
 uint64_t
 ZstdCompressor::compress(const void* src, void* dest, uint64_t length) {
-  auto ret = ZSTD_compress(dest, length, src, length, level_);
+  auto ret = dictionary_
+      ? ZSTD_compress_usingCDict(
+            context_, dest, length, src, length, dictionary_)
+      : ZSTD_compress(dest, length, src, length, level_);
   if (ZSTD_isError(ret)) {
     // it's fine to hit dest size too small
     if (ZSTD_getErrorCode(ret) == ZSTD_ErrorCode::ZSTD_error_dstSize_tooSmall) {
@@ -235,10 +299,20 @@ uint64_t Lz4Decompressor::decompress(
 
 class ZstdDecompressor : public Decompressor {
  public:
-  explicit ZstdDecompressor(
+  ZstdDecompressor(
       uint64_t blockSize,
-      const std::string& streamDebugInfo)
-      : Decompressor{blockSize, streamDebugInfo} {}
+      const std::string& streamDebugInfo,
+      const ZstdDictionary* dictionary)
+      : Decompressor{blockSize, streamDebugInfo},
+        dictionary_{
+            dictionary ? static_cast<const ZSTD_DDict*>(
+                             dictionary->decompressionDictionary())
+                       : nullptr},
+        context_{dictionary_ ? ZSTD_createDCtx() : nullptr} {}
+
+  ~ZstdDecompressor() override {
+    ZSTD_freeDCtx(context_);
+  }
 
   uint64_t decompress(
       const char* src,
@@ -248,6 +322,10 @@ class ZstdDecompressor : public Decompressor {
 
   uint64_t getUncompressedLength(const char* src, uint64_t srcLength)
       const override;
+
+ private:
+  const ZSTD_DDict* const dictionary_;
+  ZSTD_DCtx* const context_;
 };
 
 uint64_t ZstdDecompressor::decompress(
@@ -255,7 +333,10 @@ uint64_t ZstdDecompressor::decompress(
     uint64_t srcLength,
     char* dest,
     uint64_t destLength) {
-  auto ret = ZSTD_decompress(dest, destLength, src, srcLength);
+  auto ret = dictionary_
+      ? ZSTD_decompress_usingDDict(
+            context_, dest, destLength, src, srcLength, dictionary_)
+      : ZSTD_decompress(dest, destLength, src, srcLength);
   DWIO_ENSURE(
       !ZSTD_isError(ret),
       "ZSTD returned an error: ",
@@ -438,7 +519,9 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
     CompressionBufferPool& bufferPool,
     DataBufferHolder& bufferHolder,
     const Config& config,
-    const Encrypter* encrypter) {
+    const Encrypter* encrypter,
+    std::optional<int32_t> level,
+    const ZstdDictionary* dictionary) {
   std::unique_ptr<Compressor> compressor;
   switch (static_cast<int64_t>(kind)) {
     case dwio::common::CompressionKind_NONE:
@@ -448,7 +531,8 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
       // compressor remain as nullptr
       break;
     case dwio::common::CompressionKind_ZLIB: {
-      int32_t zlibCompressionLevel = config.get(Config::ZLIB_COMPRESSION_LEVEL);
+      int32_t zlibCompressionLevel =
+          level.value_or(config.get(Config::ZLIB_COMPRESSION_LEVEL));
       compressor = std::make_unique<ZlibCompressor>(zlibCompressionLevel);
       XLOG_FIRST_N(INFO, 1) << fmt::format(
           "Initialized zlib compressor with compression level {}",
@@ -456,8 +540,10 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
       break;
     }
     case dwio::common::CompressionKind_ZSTD: {
-      int32_t zstdCompressionLevel = config.get(Config::ZSTD_COMPRESSION_LEVEL);
-      compressor = std::make_unique<ZstdCompressor>(zstdCompressionLevel);
+      int32_t zstdCompressionLevel =
+          level.value_or(config.get(Config::ZSTD_COMPRESSION_LEVEL));
+      compressor =
+          std::make_unique<ZstdCompressor>(zstdCompressionLevel, dictionary);
       XLOG_FIRST_N(INFO, 1) << fmt::format(
           "Initialized zstd compressor with compression level {}",
           zstdCompressionLevel);
@@ -479,7 +565,9 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t blockSize,
     MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const Decrypter* decrypter) {
+    const Decrypter* decrypter,
+    const ZstdDictionary* dictionary,
+    folly::Executor* decompressionExecutor) {
   std::unique_ptr<Decompressor> decompressor;
   switch (static_cast<int64_t>(kind)) {
     case dwio::common::CompressionKind_NONE:
@@ -511,8 +599,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
           std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
       break;
     case dwio::common::CompressionKind_ZSTD:
-      decompressor =
-          std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
+      decompressor = std::make_unique<ZstdDecompressor>(
+          blockSize, streamDebugInfo, dictionary);
       break;
     default:
       DWIO_RAISE("Unknown compression codec ", kind);
@@ -522,7 +610,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
       pool,
       std::move(decompressor),
       decrypter,
-      streamDebugInfo);
+      streamDebugInfo,
+      decompressionExecutor);
 }
 
 } // namespace facebook::velox::dwrf
@@ -16,6 +16,11 @@
 
 #pragma once
 
+#include <mutex>
+#include <optional>
+
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/Common.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -29,6 +34,50 @@ namespace facebook::velox::dwrf {
 
 constexpr uint8_t PAGE_HEADER_SIZE = 3;
 
+// A trained ZSTD dictionary. The prepared forms for compressing and for
+// decompressing are made on first use and shared by all the streams compressed
+// with the dictionary.
+class ZstdDictionary {
+ public:
+  explicit ZstdDictionary(std::string data) : data_{std::move(data)} {}
+
+  ~ZstdDictionary();
+
+  const std::string& data() const {
+    return data_;
+  }
+
+  // Returns the ZSTD_CDict. It is prepared for the 'level' of the first call.
+  const void* compressionDictionary(int32_t level) const;
+
+  // Returns the ZSTD_DDict.
+  const void* decompressionDictionary() const;
+
+ private:
+  const std::string data_;
+  mutable std::once_flag cdictOnce_;
+  mutable std::once_flag ddictOnce_;
+  mutable void* cdict_{nullptr};
+  mutable void* ddict_{nullptr};
+};
+
+// Trains a ZSTD dictionary of up to 'maxSize' bytes on 'samples', e.g. the
+// values of a string column. Returns an empty string if there are too few
+// samples to train on.
+std::string trainZstdDictionary(
+    const std::vector<std::string>& samples,
+    size_t maxSize);
+
+// The codec of the streams of a column when it differs from the codec of the
+// file.
+struct ColumnCompression {
+  dwio::common::CompressionKind kind;
+  // Compression level. The level configured for 'kind' if not set.
+  std::optional<int32_t> level;
+  // Set if the ZSTD streams are compressed with a dictionary.
+  std::shared_ptr<const ZstdDictionary> dictionary;
+};
+
 class Compressor {
  public:
   explicit Compressor(int32_t level) : level_{level} {}
@@ -71,6 +120,9 @@ class Decompressor {
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
  * @param pool the memory pool
+ * @param dictionary ZSTD dictionary the input was compressed with
+ * @param decompressionExecutor if set, blocks are decrypted and decompressed
+ * ahead of the reader on this executor, see PagedInputStream
  */
 std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     dwio::common::CompressionKind kind,
@@ -78,7 +130,9 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t bufferSize,
     memory::MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const dwio::common::encryption::Decrypter* decryptr = nullptr);
+    const dwio::common::encryption::Decrypter* decryptr = nullptr,
+    const ZstdDictionary* dictionary = nullptr,
+    folly::Executor* decompressionExecutor = nullptr);
 
 /**
  * Create a compressor for the given compression kind.
@@ -86,13 +140,17 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
  * @param bufferPool pool for compression buffer
  * @param bufferHolder buffer holder that handles buffer allocation and
  * collection
- * @param level compression level
+ * @param config the compression levels and block sizes
+ * @param level compression level overriding the one in 'config'
+ * @param dictionary ZSTD dictionary to compress with
  */
 std::unique_ptr<BufferedOutputStream> createCompressor(
     dwio::common::CompressionKind kind,
     CompressionBufferPool& bufferPool,
     DataBufferHolder& bufferHolder,
     const Config& config,
-    const dwio::common::encryption::Encrypter* encrypter = nullptr);
+    const dwio::common::encryption::Encrypter* encrypter = nullptr,
+    std::optional<int32_t> level = std::nullopt,
+    const ZstdDictionary* dictionary = nullptr);
 
 } // namespace facebook::velox::dwrf
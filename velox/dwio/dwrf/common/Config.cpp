@@ -21,6 +21,85 @@
 
 namespace facebook::velox::dwrf {
 
+namespace {
+
+std::string joinColumns(const std::vector<uint32_t>& val) {
+  return folly::join(",", val);
+}
+
+std::vector<uint32_t> splitColumns(
+    const std::string& /* key */,
+    const std::string& val) {
+  std::vector<uint32_t> result;
+  if (!val.empty()) {
+    std::vector<folly::StringPiece> pieces;
+    folly::split(',', val, pieces, true);
+    for (auto& p : pieces) {
+      const auto& trimmedCol = folly::trimWhitespace(p);
+      if (!trimmedCol.empty()) {
+        result.push_back(folly::to<uint32_t>(trimmedCol));
+      }
+    }
+  }
+  return result;
+}
+
+// Joins and splits a map from column to value, e.g. "1:zstd,3:zlib".
+template <typename T>
+std::string joinColumnMap(
+    const std::map<uint32_t, T>& val,
+    const std::function<std::string(const T&)>& toString) {
+  std::vector<std::string> pieces;
+  pieces.reserve(val.size());
+  for (const auto& [column, value] : val) {
+    pieces.push_back(fmt::format("{}:{}", column, toString(value)));
+  }
+  return folly::join(",", pieces);
+}
+
+template <typename T>
+std::map<uint32_t, T> splitColumnMap(
+    const std::string& key,
+    const std::string& val,
+    const std::function<T(folly::StringPiece)>& fromString) {
+  std::map<uint32_t, T> result;
+  std::vector<folly::StringPiece> pieces;
+  folly::split(',', val, pieces, true);
+  for (auto& p : pieces) {
+    const auto trimmed = folly::trimWhitespace(p);
+    if (trimmed.empty()) {
+      continue;
+    }
+    folly::StringPiece column;
+    folly::StringPiece value;
+    VELOX_CHECK(
+        folly::split(':', trimmed, column, value),
+        "Invalid configuration for key '{}': '{}'",
+        key,
+        val);
+    result[folly::to<uint32_t>(folly::trimWhitespace(column))] =
+        fromString(folly::trimWhitespace(value));
+  }
+  return result;
+}
+
+dwio::common::CompressionKind toCompressionKind(folly::StringPiece name) {
+  for (auto kind :
+       {dwio::common::CompressionKind_NONE,
+        dwio::common::CompressionKind_ZLIB,
+        dwio::common::CompressionKind_SNAPPY,
+        dwio::common::CompressionKind_LZO,
+        dwio::common::CompressionKind_ZSTD,
+        dwio::common::CompressionKind_LZ4}) {
+    if (name == dwio::common::compressionKindToString(kind)) {
+      return kind;
+    }
+  }
+  VELOX_USER_FAIL("Unknown compression kind: {}", name);
+}
+
+} // namespace
+
 Config::Entry<WriterVersion> Config::WRITER_VERSION(
     "orc.writer.version",
     WriterVersion_CURRENT);
@@ -49,6 +128,34 @@ Config::Entry<float> Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO(
     "hive.exec.orc.compress.size.extend.ratio",
     2.0f);
 
+Config::Entry<const std::map<uint32_t, dwio::common::CompressionKind>>
+    Config::COLUMN_COMPRESSION(
+        "orc.column.compress",
+        {},
+        [](const std::map<uint32_t, dwio::common::CompressionKind>& val) {
+          return joinColumnMap<dwio::common::CompressionKind>(
+              val, dwio::common::compressionKindToString);
+        },
+        [](const std::string& key, const std::string& val) {
+          return splitColumnMap<dwio::common::CompressionKind>(
+              key, val, toCompressionKind);
+        });
+
+Config::Entry<const std::map<uint32_t, int32_t>>
+    Config::COLUMN_COMPRESSION_LEVEL(
+        "orc.column.compress.level",
+        {},
+        [](const std::map<uint32_t, int32_t>& val) {
+          return joinColumnMap<int32_t>(val, [](const int32_t& level) {
+            return folly::to<std::string>(level);
+          });
+        },
+        [](const std::string& key, const std::string& val) {
+          return splitColumnMap<int32_t>(key, val, [](folly::StringPiece p) {
+            return folly::to<int32_t>(p);
+          });
+        });
+
 Config::Entry<uint32_t> Config::COMPRESSION_THRESHOLD(
     "orc.compression.threshold",
     256);
@@ -59,6 +166,16 @@ Config::Entry<uint32_t> Config::ROW_INDEX_STRIDE{
     "hive.exec.orc.row.index.stride",
     10000};
 
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLUMNS(
+    "orc.bloom.filter.columns",
+    {},
+    joinColumns,
+    splitColumns);
+
+Config::Entry<float> Config::BLOOM_FILTER_FPP(
+    "orc.bloom.filter.fpp",
+    0.05f);
+
 Config::Entry<proto::ChecksumAlgorithm> Config::CHECKSUM_ALGORITHM{
     "orc.checksum.algorithm",
     proto::ChecksumAlgorithm::XXHASH};
@@ -75,6 +192,10 @@ Config::Entry<uint32_t> Config::DICTIONARY_ENCODING_INTERVAL{
     "hive.exec.orc.encoding.interval",
     30};
 
+Config::Entry<uint32_t> Config::DICTIONARY_EARLY_ABORT_ROWS{
+    "hive.exec.orc.dictionary.early.abort.rows",
+    100000};
+
 Config::Entry<bool> Config::USE_VINTS{"hive.exec.orc.use.vints", true};
 
 Config::Entry<float> Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD{
@@ -126,21 +247,8 @@ Config::Entry<bool> Config::MAP_FLAT_DICT_SHARE(
 Config::Entry<const std::vector<uint32_t>> Config::MAP_FLAT_COLS(
     "orc.map.flat.cols",
     {},
-    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
-    [](const std::string& /* key */, const std::string& val) {
-      std::vector<uint32_t> result;
-      if (!val.empty()) {
-        std::vector<folly::StringPiece> pieces;
-        folly::split(',', val, pieces, true);
-        for (auto& p : pieces) {
-          const auto& trimmedCol = folly::trimWhitespace(p);
-          if (!trimmedCol.empty()) {
-            result.push_back(folly::to<uint32_t>(trimmedCol));
-          }
-        }
-      }
-      return result;
-    });
+    joinColumns,
+    splitColumns);
 
 Config::Entry<const std::vector<std::vector<std::string>>>
     Config::MAP_FLAT_COLS_STRUCT_KEYS(
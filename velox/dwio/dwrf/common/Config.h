@@ -17,6 +17,7 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <unordered_map>
 #include "velox/common/config/Config.h"
 #include "velox/dwio/common/Common.h"
@@ -37,12 +38,34 @@ class Config : public common::ConfigBase<Config> {
   static Entry<uint64_t> COMPRESSION_BLOCK_SIZE_MIN;
   static Entry<float> COMPRESSION_BLOCK_SIZE_EXTEND_RATIO;
   static Entry<uint32_t> COMPRESSION_THRESHOLD;
+  // Codecs of top level columns that are compressed differently from
+  // COMPRESSION, e.g. "1:zstd,4:none". Only NONE, ZLIB and ZSTD are
+  // supported.
+  static Entry<const std::map<uint32_t, dwio::common::CompressionKind>>
+      COLUMN_COMPRESSION;
+  // Compression levels of top level columns, e.g. "1:19". Columns not listed
+  // use ZLIB_COMPRESSION_LEVEL or ZSTD_COMPRESSION_LEVEL.
+  static Entry<const std::map<uint32_t, int32_t>> COLUMN_COMPRESSION_LEVEL;
   static Entry<bool> CREATE_INDEX;
   static Entry<uint32_t> ROW_INDEX_STRIDE;
+  // Top level columns for which a bloom filter is written per row index
+  // stride. Only SMALLINT, INTEGER, BIGINT and VARCHAR columns get one.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLUMNS;
+  // False positive probability of the bloom filters at ROW_INDEX_STRIDE
+  // values.
+  static Entry<float> BLOOM_FILTER_FPP;
   static Entry<proto::ChecksumAlgorithm> CHECKSUM_ALGORITHM;
   static Entry<StripeCacheMode> STRIPE_CACHE_MODE;
   static Entry<uint32_t> STRIPE_CACHE_SIZE;
+  // Number of stripes written with direct encoding after abandoning a
+  // dictionary, after which the column writers try dictionary encoding again.
+  // 0 never retries.
   static Entry<uint32_t> DICTIONARY_ENCODING_INTERVAL;
+  // Number of values after which a dictionary is abandoned at the next index
+  // stride if its ratio of distinct values already exceeds the key size
+  // threshold, instead of keeping it in memory until the stripe is flushed.
+  // 0 disables the early check.
+  static Entry<uint32_t> DICTIONARY_EARLY_ABORT_ROWS;
   static Entry<bool> USE_VINTS;
   static Entry<float> DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD;
   static Entry<float> DICTIONARY_STRING_KEY_SIZE_THRESHOLD;
@@ -454,6 +454,18 @@ class FooterWrapper : public ProtoWrapperBase {
     return dwrfPtr()->encryption();
   }
 
+  // ORC files have one codec for all columns.
+  int columnCompressionSize() const {
+    return format_ == DwrfFormat::kDwrf ? dwrfPtr()->columncompression_size()
+                                        : 0;
+  }
+
+  const ::facebook::velox::dwrf::proto::ColumnCompression& columnCompression(
+      int index) const {
+    VELOX_CHECK_EQ(format_, DwrfFormat::kDwrf);
+    return dwrfPtr()->columncompression(index);
+  }
+
   int stripesSize() const {
     return format_ == DwrfFormat::kDwrf ? dwrfPtr()->stripes_size()
                                         : orcPtr()->stripes_size();
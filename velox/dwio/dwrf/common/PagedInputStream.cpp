@@ -15,73 +15,101 @@
  */
 
 #include "velox/dwio/dwrf/common/PagedInputStream.h"
+
+#include <optional>
+
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
 
+PagedInputStream::~PagedInputStream() {
+  cancelBlockAhead();
+}
+
 void PagedInputStream::prepareOutputBuffer(uint64_t uncompressedLength) {
-  if (!outputBuffer_ || uncompressedLength > outputBuffer_->capacity()) {
-    outputBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
+  prepareOutputBuffer(uncompressedLength, outputBuffer_);
+}
+
+void PagedInputStream::prepareOutputBuffer(
+    uint64_t uncompressedLength,
+    std::unique_ptr<dwio::common::DataBuffer<char>>& buffer) {
+  if (!buffer || uncompressedLength > buffer->capacity()) {
+    buffer = std::make_unique<dwio::common::DataBuffer<char>>(
         pool_, uncompressedLength);
   }
 }
 
-void PagedInputStream::readBuffer(bool failOnEof) {
+bool PagedInputStream::nextInput(bool failOnEof) {
   int32_t length;
   if (!input_->Next(
           reinterpret_cast<const void**>(&inputBufferPtr_), &length)) {
     DWIO_ENSURE(!failOnEof, getName(), ", read past EOF");
-    state_ = State::END;
     inputBufferStart_ = nullptr;
     inputBufferPtr_ = nullptr;
     inputBufferPtrEnd_ = nullptr;
-  } else {
-    inputBufferStart_ = inputBufferPtr_;
-    inputBufferPtrEnd_ = inputBufferPtr_ + length;
+    return false;
+  }
+  inputBufferStart_ = inputBufferPtr_;
+  inputBufferPtrEnd_ = inputBufferPtr_ + length;
+  return true;
+}
+
+void PagedInputStream::readBuffer(bool failOnEof) {
+  if (!nextInput(failOnEof)) {
+    state_ = State::END;
   }
 }
 
-uint32_t PagedInputStream::readByte(bool failOnEof) {
+uint32_t PagedInputStream::readByte() {
   if (UNLIKELY(inputBufferPtr_ == inputBufferPtrEnd_)) {
-    readBuffer(failOnEof);
-    if (state_ == State::END) {
-      return 0;
-    }
+    nextInput(true);
   }
   return static_cast<unsigned char>(*(inputBufferPtr_++));
 }
 
-void PagedInputStream::readHeader() {
-  uint32_t header = readByte(false);
+bool PagedInputStream::readBlockHeader(BlockHeader& header) {
+  if (inputBufferPtr_ == inputBufferPtrEnd_ && !nextInput(false)) {
+    header.offset = input_->ByteCount() - 1;
+    header.original = false;
+    header.length = 0;
+    return false;
+  }
+  header.offset =
+      input_->ByteCount() - (inputBufferPtrEnd_ - inputBufferPtr_);
+  uint32_t value = readByte();
+  value |= readByte() << 8;
+  value |= readByte() << 16;
+  header.original = value & 1;
+  header.length = value >> 1;
+  return true;
+}
 
-  lastHeaderOffset_ =
-      input_->ByteCount() - (inputBufferPtrEnd_ - inputBufferPtr_) - 1;
+void PagedInputStream::readHeader() {
+  BlockHeader header;
+  const bool found = readBlockHeader(header);
+  lastHeaderOffset_ = header.offset;
   bytesReturnedAtLastHeaderOffset_ = bytesReturned_;
-
-  if (state_ != State::END) {
-    header |= readByte(true) << 8;
-    header |= readByte(true) << 16;
-    if (header & 1) {
-      state_ = State::ORIGINAL;
-    } else {
-      state_ = State::START;
-    }
-    remainingLength_ = header >> 1;
+  if (found) {
+    state_ = header.original ? State::ORIGINAL : State::START;
+    remainingLength_ = header.length;
   } else {
+    state_ = State::END;
     remainingLength_ = 0;
   }
 }
 
-const char* PagedInputStream::ensureInput(size_t availableInputBytes) {
+const char* PagedInputStream::ensureInput(
+    size_t availableInputBytes,
+    size_t length) {
   auto input = inputBufferPtr_;
-  if (remainingLength_ <= availableInputBytes) {
+  if (length <= availableInputBytes) {
     inputBufferPtr_ += availableInputBytes;
     return input;
   }
   // make sure input buffer has capacity
-  if (inputBuffer_.capacity() < remainingLength_) {
-    inputBuffer_.reserve(remainingLength_);
+  if (inputBuffer_.capacity() < length) {
+    inputBuffer_.reserve(length);
   }
 
   std::copy(
@@ -90,11 +118,11 @@ const char* PagedInputStream::ensureInput(size_t availableInputBytes) {
       inputBuffer_.data());
   inputBufferPtr_ += availableInputBytes;
 
-  for (size_t pos = availableInputBytes; pos < remainingLength_;) {
-    readBuffer(true);
+  for (size_t pos = availableInputBytes; pos < length;) {
+    nextInput(true);
     availableInputBytes = std::min(
         static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
-        remainingLength_ - pos);
+        length - pos);
     std::copy(
         inputBufferPtr_,
         inputBufferPtr_ + availableInputBytes,
@@ -121,66 +149,67 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   // release previous decryption buffer
   decryptionBuffer_ = nullptr;
 
-  if (state_ == State::HEADER || remainingLength_ == 0) {
+  std::optional<folly::StringPiece> decoded;
+  if (blockAhead_ != nullptr) {
+    auto block = blockAhead_->move();
+    blockAhead_.reset();
+    lastHeaderOffset_ = block->header.offset;
+    bytesReturnedAtLastHeaderOffset_ = bytesReturned_;
+    state_ = block->state;
+    remainingLength_ = block->header.length;
+    if (state_ == State::START) {
+      std::swap(outputBuffer_, block->output);
+      aheadOutputBuffer_ = std::move(block->output);
+      decryptionBuffer_ = std::move(block->decrypted);
+      decoded = block->data;
+    }
+  } else if (state_ == State::HEADER || remainingLength_ == 0) {
     readHeader();
   }
   if (state_ == State::END) {
     return false;
   }
-  if (inputBufferPtr_ == inputBufferPtrEnd_) {
-    readBuffer(true);
-  }
 
-  size_t availSize = std::min(
-      static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
-      remainingLength_);
   // in the case when decompression or decryption is needed, need to copy data
   // to input buffer if the input doesn't contain the entire block
-  bool original = !decrypter_ && (state_ == State::ORIGINAL);
-  const char* input = nullptr;
-  // if no decompression or decryption is needed, simply adjust the output
-  // pointer. Otherwise, make sure we have continuous block
-  if (original) {
-    *data = inputBufferPtr_;
-    *size = static_cast<int32_t>(availSize);
-    outputBufferPtr_ = inputBufferPtr_ + availSize;
-    inputBufferPtr_ += availSize;
-    remainingLength_ -= availSize;
-  } else {
-    input = ensureInput(availSize);
-  }
-
-  // perform decryption
-  if (decrypter_) {
-    decryptionBuffer_ =
-        decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
-    input = reinterpret_cast<const char*>(decryptionBuffer_->data());
-    remainingLength_ = decryptionBuffer_->length();
-    *data = input;
-    *size = remainingLength_;
-    outputBufferPtr_ = input + remainingLength_;
-  }
-
-  // perform decompression
-  if (state_ == State::START) {
-    DWIO_ENSURE_NOT_NULL(decompressor_.get(), "invalid stream state");
-    prepareOutputBuffer(
-        decompressor_->getUncompressedLength(input, remainingLength_));
-    outputBufferLength_ = decompressor_->decompress(
-        input,
-        remainingLength_,
-        outputBuffer_->data(),
-        outputBuffer_->capacity());
-    *data = outputBuffer_->data();
-    *size = static_cast<int32_t>(outputBufferLength_);
-    outputBufferPtr_ = outputBuffer_->data() + outputBufferLength_;
-    // release decryption buffer
-    decryptionBuffer_ = nullptr;
+  const bool original = !decrypter_ && (state_ == State::ORIGINAL);
+  if (!decoded.has_value()) {
+    if (inputBufferPtr_ == inputBufferPtrEnd_) {
+      readBuffer(true);
+    }
+    size_t availSize = std::min(
+        static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+        remainingLength_);
+    // if no decompression or decryption is needed, simply adjust the output
+    // pointer. Otherwise, make sure we have continuous block
+    if (original) {
+      *data = inputBufferPtr_;
+      *size = static_cast<int32_t>(availSize);
+      outputBufferPtr_ = inputBufferPtr_ + availSize;
+      inputBufferPtr_ += availSize;
+      remainingLength_ -= availSize;
+    } else {
+      const char* input = ensureInput(availSize, remainingLength_);
+      decoded = decodeBlock(
+          input,
+          remainingLength_,
+          state_ == State::START,
+          decryptionBuffer_,
+          outputBuffer_);
+    }
   }
 
   if (!original) {
+    *data = decoded->data();
+    *size = static_cast<int32_t>(decoded->size());
+    outputBufferPtr_ = decoded->end();
     remainingLength_ = 0;
     state_ = State::HEADER;
+    // The returned block is in 'outputBuffer_' or 'decryptionBuffer_', so the
+    // input can move on to the next block while the caller consumes this one.
+    if (decompressionExecutor_ != nullptr) {
+      startBlockAhead();
+    }
   }
 
   outputBufferLength_ = 0;
@@ -189,6 +218,80 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+folly::StringPiece PagedInputStream::decodeBlock(
+    const char* input,
+    size_t length,
+    bool compressed,
+    std::unique_ptr<folly::IOBuf>& decrypted,
+    std::unique_ptr<dwio::common::DataBuffer<char>>& output) {
+  // perform decryption
+  if (decrypter_) {
+    decrypted = decrypter_->decrypt(folly::StringPiece{input, length});
+    input = reinterpret_cast<const char*>(decrypted->data());
+    length = decrypted->length();
+  }
+  if (!compressed) {
+    return folly::StringPiece(input, length);
+  }
+
+  // perform decompression
+  DWIO_ENSURE_NOT_NULL(decompressor_.get(), "invalid stream state");
+  prepareOutputBuffer(
+      decompressor_->getUncompressedLength(input, length), output);
+  const auto decompressedLength = decompressor_->decompress(
+      input, length, output->data(), output->capacity());
+  // release decryption buffer
+  decrypted = nullptr;
+  return folly::StringPiece(output->data(), decompressedLength);
+}
+
+std::unique_ptr<PagedInputStream::BlockAhead>
+PagedInputStream::readBlockAhead() {
+  auto block = std::make_unique<BlockAhead>();
+  if (skipBlockAhead_ || !readBlockHeader(block->header)) {
+    return block;
+  }
+  if (block->header.original && !decrypter_) {
+    block->state = State::ORIGINAL;
+    return block;
+  }
+  block->state = State::START;
+  if (inputBufferPtr_ == inputBufferPtrEnd_) {
+    nextInput(true);
+  }
+  const auto length = block->header.length;
+  const auto availSize = std::min(
+      static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_), length);
+  const char* input = ensureInput(availSize, length);
+  block->output = std::move(aheadOutputBuffer_);
+  block->data = decodeBlock(
+      input, length, !block->header.original, block->decrypted, block->output);
+  return block;
+}
+
+void PagedInputStream::startBlockAhead() {
+  VELOX_CHECK_NULL(blockAhead_);
+  blockAhead_ = std::make_shared<AsyncSource<BlockAhead>>(
+      [this]() { return readBlockAhead(); });
+  decompressionExecutor_->add(
+      [blockAhead = blockAhead_]() { blockAhead->prepare(); });
+}
+
+void PagedInputStream::cancelBlockAhead() {
+  if (blockAhead_ == nullptr) {
+    return;
+  }
+  skipBlockAhead_ = true;
+  try {
+    blockAhead_->move();
+  } catch (const std::exception&) {
+    // The block is discarded. An error reading it does not concern the
+    // blocks read after the cancel.
+  }
+  blockAhead_.reset();
+  skipBlockAhead_ = false;
+}
+
 void PagedInputStream::BackUp(int32_t count) {
   DWIO_ENSURE(
       outputBufferPtr_ != nullptr,
@@ -258,6 +361,7 @@ void PagedInputStream::seekToPosition(
   };
 
   if (compressedOffset != lastHeaderOffset_ || outsideOriginalWindow()) {
+    cancelBlockAhead();
     std::vector<uint64_t> positions = {compressedOffset};
     auto provider = dwio::common::PositionProvider(positions);
     input_->seekToPosition(provider);
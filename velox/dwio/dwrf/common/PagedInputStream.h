@@ -16,6 +16,11 @@
 
 #pragma once
 
+#include <atomic>
+
+#include <folly/Executor.h>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 
@@ -23,23 +28,32 @@ namespace facebook::velox::dwrf {
 
 class PagedInputStream : public dwio::common::SeekableInputStream {
  public:
+  /// If 'decompressionExecutor' is set, each call to Next() that returns a
+  /// decompressed or decrypted block starts reading, decrypting and
+  /// decompressing the next block on 'decompressionExecutor'. The next call
+  /// to Next() then takes the block when ready or decodes it itself if the
+  /// executor has not started on it.
   PagedInputStream(
       std::unique_ptr<SeekableInputStream> inStream,
       memory::MemoryPool& memPool,
       std::unique_ptr<Decompressor> decompressor,
       const dwio::common::encryption::Decrypter* decrypter,
-      const std::string& streamDebugInfo)
+      const std::string& streamDebugInfo,
+      folly::Executor* decompressionExecutor = nullptr)
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
         decompressor_{std::move(decompressor)},
         decrypter_{decrypter},
+        decompressionExecutor_{decompressionExecutor},
         streamDebugInfo_{streamDebugInfo} {
     DWIO_ENSURE(
         decompressor_ || decrypter_,
         "one of decompressor or decryptor is required");
   }
 
+  ~PagedInputStream() override;
+
   bool Next(const void** data, int32_t* size) override;
   void BackUp(int32_t count) override;
   bool Skip(int32_t count) override;
@@ -81,9 +95,31 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
 
   void prepareOutputBuffer(uint64_t uncompressedLength);
 
+  void prepareOutputBuffer(
+      uint64_t uncompressedLength,
+      std::unique_ptr<dwio::common::DataBuffer<char>>& buffer);
+
+  // Sets the input range to the next range of 'input_'. Returns false at the
+  // end of 'input_'.
+  bool nextInput(bool failOnEof);
+
   void readBuffer(bool failOnEof);
 
-  uint32_t readByte(bool failOnEof);
+  // Returns the next byte of the input. Throws at the end of the input.
+  uint32_t readByte();
+
+  struct BlockHeader {
+    // Offset of the header in 'input_'.
+    uint64_t offset{0};
+    // True if the block is stored uncompressed.
+    bool original{false};
+    // Size of the block after the header.
+    size_t length{0};
+  };
+
+  // Reads the header of the next block into 'header'. Returns false at the
+  // end of 'input_'. Does not change 'state_' or 'remainingLength_'.
+  bool readBlockHeader(BlockHeader& header);
 
   void readHeader();
 
@@ -91,8 +127,19 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
 
   enum class State { HEADER, START, ORIGINAL, END };
 
-  // make sure input is contiguous for decompression/decryption
-  const char* ensureInput(size_t availableInputBytes);
+  // make sure input is contiguous for decompression/decryption. 'length' is
+  // the size of the block.
+  const char* ensureInput(size_t availableInputBytes, size_t length);
+
+  // Decrypts and decompresses the 'length' bytes at 'input' of a block that
+  // is compressed if 'compressed'. The result is kept in 'decrypted' or
+  // 'output' and its range is returned.
+  folly::StringPiece decodeBlock(
+      const char* input,
+      size_t length,
+      bool compressed,
+      std::unique_ptr<folly::IOBuf>& decrypted,
+      std::unique_ptr<dwio::common::DataBuffer<char>>& output);
 
   // input stream where to read compressed/encrypted data
   std::unique_ptr<SeekableInputStream> input_;
@@ -149,6 +196,44 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   const dwio::common::encryption::Decrypter* decrypter_;
 
  private:
+  // The next block, read and decoded ahead of Next().
+  struct BlockAhead {
+    BlockHeader header;
+    // END at the end of the input. ORIGINAL if the block has neither
+    // compression nor encryption, in which case only the header is read and
+    // Next() returns the block from the input. START otherwise.
+    State state{State::END};
+    // The decoded block, which is in 'decrypted' or 'output'.
+    folly::StringPiece data;
+    std::unique_ptr<folly::IOBuf> decrypted;
+    std::unique_ptr<dwio::common::DataBuffer<char>> output;
+  };
+
+  // Makes the BlockAhead for 'blockAhead_'. Runs on 'decompressionExecutor_'
+  // while the caller consumes the block returned by the last Next(), so it
+  // only reads the input, 'inputBuffer_' and 'aheadOutputBuffer_'.
+  std::unique_ptr<BlockAhead> readBlockAhead();
+
+  // Starts making the next block on 'decompressionExecutor_'.
+  void startBlockAhead();
+
+  // Waits for the block of 'blockAhead_' if the executor is making it and
+  // discards it. The next block is then read from the current position of
+  // the input.
+  void cancelBlockAhead();
+
+  folly::Executor* const decompressionExecutor_{nullptr};
+
+  std::shared_ptr<AsyncSource<BlockAhead>> blockAhead_;
+
+  // Set while cancelling 'blockAhead_' so that readBlockAhead() returns
+  // without reading if it has not started.
+  std::atomic<bool> skipBlockAhead_{false};
+
+  // The buffer that readBlockAhead() decompresses into. Swapped with
+  // 'outputBuffer_' when Next() takes the block.
+  std::unique_ptr<dwio::common::DataBuffer<char>> aheadOutputBuffer_;
+
   // Stream Debug Info
   const std::string streamDebugInfo_;
 };
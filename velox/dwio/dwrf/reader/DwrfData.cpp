@@ -20,6 +20,67 @@
 
 namespace facebook::velox::dwrf {
 
+namespace {
+
+// Returns true if 'filter' passes only the values of a short list, so that a
+// stride can be skipped if its bloom filter has none of them.
+bool isBloomFilterTestable(const common::Filter& filter) {
+  if (filter.testNull()) {
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns false if no value passing 'filter' was added to 'bloomFilter'.
+bool bloomFilterMatches(
+    const BloomFilter& bloomFilter,
+    const common::Filter& filter) {
+  auto mayContain = [&](int64_t value) { return bloomFilter.testLong(value); };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return mayContain(
+          static_cast<const common::BigintRange&>(filter).lower());
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      const auto& values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      const auto values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    case common::FilterKind::kBytesRange:
+      return bloomFilter.testBytes(
+          static_cast<const common::BytesRange&>(filter).lower());
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      return std::any_of(
+          values.begin(), values.end(), [&](const std::string& value) {
+            return bloomFilter.testBytes(value);
+          });
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace
+
 DwrfData::DwrfData(
     std::shared_ptr<const dwio::common::TypeWithId> nodeType,
     StripeStreams& stripe,
@@ -42,6 +103,8 @@ DwrfData::DwrfData(
   // time pushdown.
   indexStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
+  bloomFilterStream_ = stripe.getStream(
+      encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
 }
 
 uint64_t DwrfData::skipNulls(uint64_t numValues, bool /*nullsOnly*/) {
@@ -84,6 +147,18 @@ void DwrfData::ensureRowGroupIndex() {
   }
 }
 
+void DwrfData::ensureBloomFilters() {
+  if (!bloomFilterStream_) {
+    return;
+  }
+  auto index = ProtoUtils::readProto<proto::BloomFilterIndex>(
+      std::move(bloomFilterStream_));
+  bloomFilters_.reserve(index->bloomfilter_size());
+  for (const auto& filter : index->bloomfilter()) {
+    bloomFilters_.emplace_back(filter);
+  }
+}
+
 dwio::common::PositionProvider DwrfData::seekToRowGroup(uint32_t index) {
   ensureRowGroupIndex();
   tempPositions_ = toPositionsInner(index_->entry(index));
@@ -141,6 +216,11 @@ void DwrfData::filterRowGroups(
   }
   ensureRowGroupIndex();
   auto filter = scanSpec.filter();
+  const bool useBloomFilters = filter && isBloomFilterTestable(*filter) &&
+      (bloomFilterStream_ || !bloomFilters_.empty());
+  if (useBloomFilters) {
+    ensureBloomFilters();
+  }
   auto dwrfContext = reinterpret_cast<const StatsContext*>(&writerContext);
   result.totalCount = std::max(result.totalCount, index_->entry_size());
   auto nwords = bits::nwords(result.totalCount);
@@ -162,6 +242,13 @@ void DwrfData::filterRowGroups(
       bits::setBit(result.filterResult.data(), i);
       continue;
     }
+    if (useBloomFilters && i < bloomFilters_.size() &&
+        !bloomFilterMatches(bloomFilters_[i], *filter)) {
+      VLOG(1) << "Drop stride " << i << " on bloom filter of "
+              << scanSpec.toString();
+      bits::setBit(result.filterResult.data(), i);
+      continue;
+    }
     for (int j = 0; j < scanSpec.numMetadataFilters(); ++j) {
       auto* metadataFilter = scanSpec.metadataFilterAt(j);
       if (!testFilter(
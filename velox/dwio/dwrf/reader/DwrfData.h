@@ -20,6 +20,7 @@
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/FormatData.h"
 #include "velox/dwio/common/TypeWithId.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/RLEv1.h"
@@ -89,6 +90,10 @@ class DwrfData : public dwio::common::FormatData {
   }
 
  private:
+  // Decodes the bloom filters of the strides from 'bloomFilterStream_' if
+  // not already decoded.
+  void ensureBloomFilters();
+
   static std::vector<uint64_t> toPositionsInner(
       const proto::RowIndexEntry& entry) {
     return std::vector<uint64_t>(
@@ -101,6 +106,10 @@ class DwrfData : public dwio::common::FormatData {
   std::unique_ptr<ByteRleDecoder> notNullDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
   std::unique_ptr<proto::RowIndex> index_;
+  // Bloom filter per stride if the writer made them. Decoded only for
+  // filters that pass a few values.
+  std::unique_ptr<dwio::common::SeekableInputStream> bloomFilterStream_;
+  std::vector<BloomFilter> bloomFilters_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/common/SelectiveStructColumnReader.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/common/exception/Exception.h"
 
@@ -327,6 +328,19 @@ void DwrfRowReader::startNextStripe() {
     selectiveColumnReader_ = SelectiveDwrfReader::build(
         requestedType, dataType, stripeStreams, scanSpec, flatMapContext);
     selectiveColumnReader_->setIsTopLevel();
+    if (auto* structReader =
+            dynamic_cast<dwio::common::SelectiveStructColumnReaderBase*>(
+                selectiveColumnReader_.get())) {
+      structReader->setDecodingExecutor(
+          options_.getDecodingExecutor().get(),
+          options_.getDecodingParallelism());
+      if (auto& cache = options_.getDecodedVectorCache()) {
+        structReader->setDecodedVectorCache(
+            cache.get(),
+            options_.getDecodedVectorCacheFileNum(),
+            currentStripe);
+      }
+    }
   } else {
     columnReader_ = ColumnReader::build(
         requestedType, dataType, stripeStreams, flatMapContext);
@@ -497,6 +511,20 @@ std::unique_ptr<StripeInformation> DwrfReader::getStripe(
       stripeInfo.numberOfRows());
 }
 
+std::vector<dwio::common::FileSection> DwrfReader::sections() const {
+  const auto& footer = readerBase_->getFooter();
+  std::vector<dwio::common::FileSection> sections;
+  sections.reserve(footer.stripesSize());
+  for (auto i = 0; i < footer.stripesSize(); ++i) {
+    auto stripe = footer.stripes(i);
+    sections.push_back(
+        {stripe.offset(),
+         stripe.indexLength() + stripe.dataLength() + stripe.footerLength(),
+         stripe.numberOfRows()});
+  }
+  return sections;
+}
+
 std::vector<std::string> DwrfReader::getMetadataKeys() const {
   std::vector<std::string> result;
   auto& footer = readerBase_->getFooter();
@@ -670,18 +698,23 @@ uint64_t DwrfReader::getMemoryUse(
 
   // Decompressors need buffers for each stream
   uint64_t decompressorMemory = 0;
-  auto compression = readerBase.getCompressionKind();
-  if (compression != dwio::common::CompressionKind_NONE) {
-    for (int32_t i = 0; i < footer.typesSize(); i++) {
-      if (cs.shouldReadNode(i)) {
-        const auto type = footer.types(i);
-        decompressorMemory +=
-            maxStreamsForType(type) * readerBase.getCompressionBlockSize();
-      }
+  for (int32_t i = 0; i < footer.typesSize(); i++) {
+    if (!cs.shouldReadNode(i)) {
+      continue;
+    }
+    const auto* column = readerBase.getColumnCompression(i);
+    const auto compression =
+        column ? column->kind : readerBase.getCompressionKind();
+    if (compression == dwio::common::CompressionKind_NONE) {
+      continue;
     }
+    const auto type = footer.types(i);
+    auto nodeMemory =
+        maxStreamsForType(type) * readerBase.getCompressionBlockSize();
     if (compression == dwio::common::CompressionKind_SNAPPY) {
-      decompressorMemory *= 2; // Snappy decompressor uses a second buffer
+      nodeMemory *= 2; // Snappy decompressor uses a second buffer
     }
+    decompressorMemory += nodeMemory;
   }
 
   return memory + decompressorMemory;
@@ -95,6 +95,10 @@ class DwrfRowReader : public StrideIndexProvider,
     return true;
   }
 
+  void startFirstStripe() override {
+    startNextStripe();
+  }
+
   // Returns the skipped strides for 'stripe'. Used for testing.
   std::optional<std::vector<uint64_t>> stridesToSkip(uint32_t stripe) const {
     auto it = stripeStridesToSkip_.find(stripe);
@@ -210,6 +214,8 @@ class DwrfReader : public dwio::common::Reader {
 
   std::unique_ptr<StripeInformation> getStripe(uint32_t) const;
 
+  std::vector<dwio::common::FileSection> sections() const override;
+
   uint64_t getFileLength() const {
     return readerBase_->getFileLength();
   }
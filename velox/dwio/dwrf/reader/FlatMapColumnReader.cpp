@@ -79,55 +79,43 @@ std::vector<std::unique_ptr<KeyNode<T>>> getKeyNodesFiltered(
 
   const auto requestedValueType = requestedType->childAt(1);
   const auto dataValueType = dataType->childAt(1);
-  std::unordered_set<size_t> processed;
-
-  // load all sub streams
-  // fetch reader, in map bitmap and key object.
-  auto streams = stripe.visitStreamsOfNode(
-      dataValueType->id, [&](const StreamInformation& stream) {
-        auto sequence = stream.getSequence();
-        // No need to load shared dictionary stream here.
-        if (sequence == 0) {
-          return;
-        }
-        // if this branch (sequence) is in the node list already
-        if (processed.count(sequence)) {
-          return;
-        }
 
-        EncodingKey seqEk(dataValueType->id, sequence);
-        const auto& keyInfo = stripe.getEncoding(seqEk).key();
-        auto key = extractKey<T>(keyInfo);
-        // if key filter not passed through read schema
-        if (!keyPredicate(key)) {
-          return;
-        }
+  // Each key of the stripe is checked once and only the streams of the
+  // selected keys are opened. Sequence 0 is the shared dictionary.
+  const auto sequences = stripe.getSequencesOfNode(dataValueType->id);
+  for (const auto sequence : sequences) {
+    EncodingKey seqEk(dataValueType->id, sequence);
+    const auto& keyInfo = stripe.getEncoding(seqEk).key();
+    auto key = extractKey<T>(keyInfo);
+    // if key filter not passed through read schema
+    if (!keyPredicate(key)) {
+      continue;
+    }
 
-        // fetch reader, in map bitmap and key object.
-        auto inMap =
-            stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
-        DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
-        // build seekable
-        auto inMapDecoder = createBooleanRleDecoder(std::move(inMap), seqEk);
-
-        auto valueReader = ColumnReader::build(
-            requestedValueType,
-            dataValueType,
-            stripe,
-            FlatMapContext{sequence, inMapDecoder.get()});
-
-        keyNodes.push_back(std::make_unique<KeyNode<T>>(
-            std::move(valueReader),
-            std::move(inMapDecoder),
-            key,
-            sequence,
-            memoryPool));
-        processed.insert(sequence);
-      });
+    // fetch reader, in map bitmap and key object.
+    auto inMap =
+        stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+    DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
+    // build seekable
+    auto inMapDecoder = createBooleanRleDecoder(std::move(inMap), seqEk);
+
+    auto valueReader = ColumnReader::build(
+        requestedValueType,
+        dataValueType,
+        stripe,
+        FlatMapContext{sequence, inMapDecoder.get()});
+
+    keyNodes.push_back(std::make_unique<KeyNode<T>>(
+        std::move(valueReader),
+        std::move(inMapDecoder),
+        key,
+        sequence,
+        memoryPool));
+  }
 
   VLOG(1) << "[Flat-Map] Initialized a flat-map column reader for node "
           << dataType->id << ", keys=" << keyNodes.size()
-          << ", streams=" << streams;
+          << ", stripe keys=" << sequences.size();
   return keyNodes;
 }
 
@@ -18,6 +18,7 @@
 
 #include <fmt/format.h>
 
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
@@ -27,6 +28,7 @@ using dwio::common::FileFormat;
 using dwio::common::InputStream;
 using dwio::common::LogType;
 using dwio::common::Statistics;
+using dwio::common::TypeWithId;
 using dwio::common::encryption::DecrypterFactory;
 using encryption::DecryptionHandler;
 using memory::MemoryPool;
@@ -99,12 +101,75 @@ ReaderBase::ReaderBase(
       directorySizeGuess_(directorySizeGuess),
       filePreloadThreshold_(filePreloadThreshold),
       input_(std::move(input)) {
-  // read last bytes into buffer to get PostScript
-  // If file is small, load the entire file.
-  // TODO: make a config
   fileLength_ = input_->getReadFile()->size();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  auto metadataCache = dwio::common::FileMetadataCache::getInstance();
+  std::optional<dwio::common::FileMetadataCache::Key> cacheKey;
+  std::shared_ptr<const FileTail> cachedTail;
+  if (metadataCache) {
+    cacheKey = dwio::common::FileMetadataCache::makeKey(
+        fileFormat, *input_->getReadFile());
+    if (cacheKey.has_value()) {
+      cachedTail = metadataCache->get<FileTail>(*cacheKey);
+    }
+  }
+  if (cachedTail) {
+    setTail(std::move(cachedTail));
+  } else {
+    auto tail = readTail(fileFormat);
+    if (cacheKey.has_value()) {
+      const auto bytes = tail->arena->SpaceAllocated() + tail->psLength;
+      metadataCache->put(std::move(*cacheKey), tail, bytes);
+    }
+  }
+
+  uint64_t footerSize = postScript_->footerLength();
+  uint64_t cacheSize =
+      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
+  uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
+
+  // load stripe index/footer cache
+  if (cacheSize > 0) {
+    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
+    if (input_->shouldPrefetchStripes()) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
+      input_->load(LogType::FOOTER);
+    } else {
+      auto cacheBuffer =
+          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
+          ->readFully(cacheBuffer->data(), cacheSize);
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+    }
+  }
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<FileTail> ReaderBase::readTail(FileFormat fileFormat) {
+  auto tail = std::make_shared<FileTail>();
+  tail->arena = std::make_unique<google::protobuf::Arena>();
+
+  // read last bytes into buffer to get PostScript
+  // If file is small, load the entire file.
+  // TODO: make a config
   auto preloadFile = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -121,6 +186,7 @@ ReaderBase::ReaderBase(
     DWIO_ENSURE(lastByteStream->Next(&buf, &ignored), "failed to read");
     // Make sure 'lastByteStream' is live while dereferencing 'buf'.
     psLength_ = *static_cast<const char*>(buf) & 0xff;
+    tail->psLength = psLength_;
   }
   DWIO_ENSURE_LE(
       psLength_ + 4, // 1 byte for post script len, 3 byte "ORC" header.
@@ -130,12 +196,13 @@ ReaderBase::ReaderBase(
   if (fileFormat == FileFormat::DWRF) {
     auto postScript = ProtoUtils::readProto<proto::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+    tail->postScript = std::make_shared<PostScript>(std::move(postScript));
   } else {
     auto postScript = ProtoUtils::readProto<proto::orc::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+    tail->postScript = std::make_shared<PostScript>(std::move(postScript));
   }
+  postScript_ = tail->postScript;
 
   uint64_t footerSize = postScript_->footerLength();
   uint64_t cacheSize =
@@ -166,56 +233,76 @@ ReaderBase::ReaderBase(
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
-    auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+    auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_shared<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_shared<FooterWrapper>(footer);
   }
 
+  footer_ = tail->footer;
   schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
   DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+  tail->schema = schema_;
+  tail->nodeCompression = makeNodeCompression(*footer_, schema_);
+  nodeCompression_ = tail->nodeCompression;
+  tail_ = tail;
+  return tail;
+}
 
-  // load stripe index/footer cache
-  if (cacheSize > 0) {
-    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
-          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
-      input_->load(LogType::FOOTER);
-    } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
-      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-          ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-    }
+void ReaderBase::setTail(std::shared_ptr<const FileTail> tail) {
+  postScript_ = tail->postScript;
+  footer_ = tail->footer;
+  schema_ = tail->schema;
+  psLength_ = tail->psLength;
+  nodeCompression_ = tail->nodeCompression;
+  tail_ = std::move(tail);
+}
+
+// static
+std::shared_ptr<const NodeCompression> ReaderBase::makeNodeCompression(
+    const FooterWrapper& footer,
+    const RowTypePtr& schema) {
+  if (footer.columnCompressionSize() == 0) {
+    return nullptr;
   }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
+  auto schemaWithId = TypeWithId::create(schema);
+  folly::F14FastMap<uint32_t, const TypeWithId*> columns;
+  for (auto i = 0; i < schemaWithId->size(); ++i) {
+    columns[schemaWithId->childAt(i)->id] = schemaWithId->childAt(i).get();
+  }
+  auto nodeCompression = std::make_shared<NodeCompression>();
+  for (auto i = 0; i < footer.columnCompressionSize(); ++i) {
+    const auto& proto = footer.columnCompression(i);
+    auto it = columns.find(proto.node());
+    DWIO_ENSURE(
+        it != columns.end(),
+        "Column compression of a node that is not a top level column: ",
+        proto.node());
+    auto columnCompression = std::make_shared<ColumnCompression>();
+    columnCompression->kind =
+        static_cast<dwio::common::CompressionKind>(proto.kind());
+    if (proto.has_zstddictionary()) {
+      columnCompression->dictionary =
+          std::make_shared<ZstdDictionary>(proto.zstddictionary());
     }
+    std::function<void(const TypeWithId&)> addNodes = [&](const auto& node) {
+      (*nodeCompression)[node.id] = columnCompression;
+      for (auto j = 0; j < node.size(); ++j) {
+        addNodes(*node.childAt(j));
+      }
+    };
+    addNodes(*it->second);
   }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+  return nodeCompression;
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/SeekableInputStream.h"
@@ -30,6 +32,25 @@ namespace facebook::velox::dwrf {
 
 class ReaderBase;
 
+// The codecs of the nodes of the top level columns that are compressed
+// differently from the file.
+using NodeCompression =
+    folly::F14FastMap<uint32_t, std::shared_ptr<const ColumnCompression>>;
+
+// The parsed PostScript and Footer of a file. Shared through
+// dwio::common::FileMetadataCache by the ReaderBases of the file.
+struct FileTail {
+  // Holds the Footer proto.
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::shared_ptr<const PostScript> postScript;
+  std::shared_ptr<const FooterWrapper> footer;
+  RowTypePtr schema;
+  uint64_t psLength;
+  // nullptr if all columns use the codec of the file. The ZSTD dictionaries
+  // in here are prepared once for all readers of the file.
+  std::shared_ptr<const NodeCompression> nodeCompression;
+};
+
 class FooterStatisticsImpl : public dwio::common::Statistics {
  private:
   std::vector<std::unique_ptr<dwio::common::ColumnStatistics>> colStats_;
@@ -95,6 +116,7 @@ class ReaderBase {
         psLength_{0} {
     DWIO_ENSURE(footer_->getDwrfPtr()->GetArena());
     DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+    nodeCompression_ = makeNodeCompression(*footer_, schema_);
     if (!handler_) {
       handler_ = encryption::DecryptionHandler::create(*footer);
     }
@@ -197,14 +219,55 @@ class ReaderBase {
   std::unique_ptr<dwio::common::SeekableInputStream> createDecompressedStream(
       std::unique_ptr<dwio::common::SeekableInputStream> compressed,
       const std::string& streamDebugInfo,
-      const dwio::common::encryption::Decrypter* decrypter = nullptr) const {
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      folly::Executor* decompressionExecutor = nullptr) const {
     return createDecompressor(
         getCompressionKind(),
         std::move(compressed),
         getCompressionBlockSize(),
         pool_,
         streamDebugInfo,
-        decrypter);
+        decrypter,
+        nullptr,
+        decompressionExecutor);
+  }
+
+  // Returns the codec of the streams of 'node' or nullptr if they use the
+  // codec of the file.
+  const ColumnCompression* getColumnCompression(uint32_t node) const {
+    if (!nodeCompression_) {
+      return nullptr;
+    }
+    auto it = nodeCompression_->find(node);
+    return it == nodeCompression_->end() ? nullptr : it->second.get();
+  }
+
+  // Makes a stream decompressing the data of a stream of 'node'. If
+  // 'decompressionExecutor' is set, the blocks are decrypted and decompressed
+  // ahead of the reader on it.
+  std::unique_ptr<dwio::common::SeekableInputStream> createDecompressedStream(
+      uint32_t node,
+      std::unique_ptr<dwio::common::SeekableInputStream> compressed,
+      const std::string& streamDebugInfo,
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      folly::Executor* decompressionExecutor = nullptr) const {
+    const auto* column = getColumnCompression(node);
+    if (!column) {
+      return createDecompressedStream(
+          std::move(compressed),
+          streamDebugInfo,
+          decrypter,
+          decompressionExecutor);
+    }
+    return createDecompressor(
+        column->kind,
+        std::move(compressed),
+        getCompressionBlockSize(),
+        pool_,
+        streamDebugInfo,
+        decrypter,
+        column->dictionary.get(),
+        decompressionExecutor);
   }
 
   template <typename T>
@@ -230,14 +293,30 @@ class ReaderBase {
       const FooterWrapper& footer,
       uint32_t index = 0);
 
+  // Reads and parses the PostScript and the Footer of the file from 'input_'
+  // and sets 'postScript_', 'footer_', 'schema_' and 'psLength_'.
+  std::shared_ptr<FileTail> readTail(dwio::common::FileFormat fileFormat);
+
+  // Sets 'postScript_', 'footer_', 'schema_' and 'psLength_' from 'tail'.
+  void setTail(std::shared_ptr<const FileTail> tail);
+
+  // Returns the codecs of the nodes of the columns listed in the column
+  // compression of 'footer' or nullptr if there are none.
+  static std::shared_ptr<const NodeCompression> makeNodeCompression(
+      const FooterWrapper& footer,
+      const RowTypePtr& schema);
+
   memory::MemoryPool& pool_;
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
-  std::unique_ptr<FooterWrapper> footer_ = nullptr;
+  // Set if 'postScript_' and 'footer_' belong to a FileTail.
+  std::shared_ptr<const FileTail> tail_;
+  std::shared_ptr<const PostScript> postScript_;
+  std::shared_ptr<const FooterWrapper> footer_ = nullptr;
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
   std::unique_ptr<encryption::DecryptionHandler> handler_;
+  std::shared_ptr<const NodeCompression> nodeCompression_;
   const uint64_t directorySizeGuess_{
       dwio::common::ReaderOptions::kDefaultDirectorySizeGuess};
   const uint64_t filePreloadThreshold_{
@@ -84,7 +84,6 @@ std::vector<KeyNode<T>> getKeyNodes(
   using namespace dwio::common::flatmap;
 
   std::vector<KeyNode<T>> keyNodes;
-  std::unordered_set<size_t> processed;
 
   auto& requestedValueType = requestedType->childAt(1);
   auto& dataValueType = dataType->childAt(1);
@@ -115,59 +114,54 @@ std::vector<KeyNode<T>> getKeyNodes(
     }
   }
 
-  // Load all sub streams.
-  // Fetch reader, in map bitmap and key object.
-  auto streams = stripe.visitStreamsOfNode(
-      dataValueType->id, [&](const StreamInformation& stream) {
-        auto sequence = stream.getSequence();
-        // No need to load shared dictionary stream here.
-        if (sequence == 0 || processed.count(sequence) > 0) {
-          return;
-        }
-        EncodingKey seqEk(dataValueType->id, sequence);
-        const auto& keyInfo = stripe.getEncoding(seqEk).key();
-        auto key = extractKey<T>(keyInfo);
-        // Check if we have key filter passed through read schema.
-        if (!keyPredicate(key)) {
-          return;
-        }
-        common::ScanSpec* childSpec;
-        if (auto it = childSpecs.find(key);
-            it != childSpecs.end() && !it->second->isConstant()) {
-          childSpec = it->second;
-        } else if (asStruct) {
-          // Column not selected in 'scanSpec', skipping it.
-          return;
-        } else {
-          if (keysSpec && keysSpec->filter() &&
-              !common::applyFilter(*keysSpec->filter(), key.get())) {
-            return; // Subfield pruning
-          }
-          childSpec =
-              scanSpec.getOrCreateChild(common::Subfield(toString(key.get())));
-          childSpec->setProjectOut(true);
-          childSpec->setExtractValues(true);
-          if (valuesSpec) {
-            *childSpec = *valuesSpec;
-          }
-          childSpecs[key] = childSpec;
-        }
-        auto inMap =
-            stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
-        VELOX_CHECK(inMap, "In map stream is required");
-        auto inMapDecoder = createBooleanRleDecoder(std::move(inMap), seqEk);
-        DwrfParams childParams(
-            stripe, FlatMapContext(sequence, inMapDecoder.get()));
-        auto reader = SelectiveDwrfReader::build(
-            requestedValueType, dataValueType, childParams, *childSpec);
-        keyNodes.emplace_back(
-            key, sequence, std::move(reader), std::move(inMapDecoder));
-        processed.insert(sequence);
-      });
+  // The sequences of the value node identify the keys of the stripe. Each key
+  // is checked once against the requested keys and only the streams of the
+  // selected keys are opened. Sequence 0 is the shared dictionary.
+  const auto sequences = stripe.getSequencesOfNode(dataValueType->id);
+  for (const auto sequence : sequences) {
+    EncodingKey seqEk(dataValueType->id, sequence);
+    const auto& keyInfo = stripe.getEncoding(seqEk).key();
+    auto key = extractKey<T>(keyInfo);
+    // Check if we have key filter passed through read schema.
+    if (!keyPredicate(key)) {
+      continue;
+    }
+    common::ScanSpec* childSpec;
+    if (auto it = childSpecs.find(key);
+        it != childSpecs.end() && !it->second->isConstant()) {
+      childSpec = it->second;
+    } else if (asStruct) {
+      // Column not selected in 'scanSpec', skipping it.
+      continue;
+    } else {
+      if (keysSpec && keysSpec->filter() &&
+          !common::applyFilter(*keysSpec->filter(), key.get())) {
+        continue; // Subfield pruning
+      }
+      childSpec =
+          scanSpec.getOrCreateChild(common::Subfield(toString(key.get())));
+      childSpec->setProjectOut(true);
+      childSpec->setExtractValues(true);
+      if (valuesSpec) {
+        *childSpec = *valuesSpec;
+      }
+      childSpecs[key] = childSpec;
+    }
+    auto inMap =
+        stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+    VELOX_CHECK(inMap, "In map stream is required");
+    auto inMapDecoder = createBooleanRleDecoder(std::move(inMap), seqEk);
+    DwrfParams childParams(
+        stripe, FlatMapContext(sequence, inMapDecoder.get()));
+    auto reader = SelectiveDwrfReader::build(
+        requestedValueType, dataValueType, childParams, *childSpec);
+    keyNodes.emplace_back(
+        key, sequence, std::move(reader), std::move(inMapDecoder));
+  }
 
   VLOG(1) << "[Flat-Map] Initialized a flat-map column reader for node "
           << dataType->id << ", keys=" << keyNodes.size()
-          << ", streams=" << streams;
+          << ", stripe keys=" << sequences.size();
 
   return keyNodes;
 }
@@ -266,29 +260,27 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
         AlignedBuffer::allocate<vector_size_t>(rows.size(), &memoryPool_);
     auto* rawOffsets = offsets->template asMutable<vector_size_t>();
     auto* rawSizes = sizes->template asMutable<vector_size_t>();
+    // The in-map bitmaps are scanned a key at a time, so that each one is
+    // read sequentially instead of visiting the bitmaps of all keys for each
+    // row. The first pass counts the keys of each row.
+    std::fill(rawSizes, rawSizes + rows.size(), 0);
+    for (int k = 0; k < children_.size(); ++k) {
+      auto* inMap = keyInMap(k);
+      for (vector_size_t i = 0; i < rows.size(); ++i) {
+        if (!inMap || !bits::isBitNull(inMap, rows[i])) {
+          ++rawSizes[i];
+        }
+      }
+    }
     vector_size_t totalSize = 0;
     for (vector_size_t i = 0; i < rows.size(); ++i) {
+      rawOffsets[i] = totalSize;
       if (anyNulls_ && bits::isBitNull(rawResultNulls_, i)) {
+        rawSizes[i] = 0;
         continue;
       }
-      int currentRowSize = 0;
-      for (int k = 0; k < children_.size(); ++k) {
-        auto& data = static_cast<const DwrfData&>(children_[k]->formatData());
-        auto* inMap = data.inMap();
-        if (inMap && bits::isBitNull(inMap, rows[i])) {
-          continue;
-        }
-        copyRanges_[k].push_back({
-            .sourceIndex = i,
-            .targetIndex = totalSize + currentRowSize,
-            .count = 1,
-        });
-        ++currentRowSize;
-      }
-      if (currentRowSize > 0) {
-        rawOffsets[i] = totalSize;
-        rawSizes[i] = currentRowSize;
-        totalSize += currentRowSize;
+      if (rawSizes[i] > 0) {
+        totalSize += rawSizes[i];
       } else {
         if (!rawResultNulls_) {
           setNulls(AlignedBuffer::allocate<bool>(rows.size(), &memoryPool_));
@@ -297,6 +289,25 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
         anyNulls_ = true;
       }
     }
+    // The second pass places the values of each key in their rows, in the
+    // order of the keys. 'rawOffsets' serves as the next free position of
+    // each row and is restored afterwards.
+    for (int k = 0; k < children_.size(); ++k) {
+      auto* inMap = keyInMap(k);
+      for (vector_size_t i = 0; i < rows.size(); ++i) {
+        if (rawSizes[i] == 0 || (inMap && bits::isBitNull(inMap, rows[i]))) {
+          continue;
+        }
+        copyRanges_[k].push_back({
+            .sourceIndex = i,
+            .targetIndex = rawOffsets[i]++,
+            .count = 1,
+        });
+      }
+    }
+    for (vector_size_t i = 0; i < rows.size(); ++i) {
+      rawOffsets[i] -= rawSizes[i];
+    }
     auto& mapType = requestedType_->type->asMap();
     VectorPtr keys =
         BaseVector::create(mapType.keyType(), totalSize, &memoryPool_);
@@ -360,6 +371,12 @@ class SelectiveFlatMapReader : public SelectiveStructColumnReaderBase {
   }
 
  private:
+  // Returns the in-map bitmap of the key of 'children_[k]' for the rows of
+  // the last read or nullptr if the key is in all rows.
+  const uint64_t* keyInMap(int k) const {
+    return static_cast<const DwrfData&>(children_[k]->formatData()).inMap();
+  }
+
   common::ScanSpec structScanSpec_;
   std::vector<KeyNode<T>> keyNodes_;
   std::vector<VectorPtr> childValues_;
@@ -57,6 +57,12 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
 
   blobStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_DICTIONARY_DATA), false);
+  if (auto cache = DecodedDictionaryCache::getInstance()) {
+    dictionaryCacheKey_ = stripe.getDictionaryCacheKey(encodingKey);
+    if (dictionaryCacheKey_.has_value()) {
+      dictionaryCache_ = std::move(cache);
+    }
+  }
 
   // handle in dictionary stream
   std::unique_ptr<SeekableInputStream> inDictStream = stripe.getStream(
@@ -97,10 +103,11 @@ uint64_t SelectiveStringDictionaryColumnReader::skip(uint64_t numValues) {
 void SelectiveStringDictionaryColumnReader::loadDictionary(
     SeekableInputStream& data,
     IntDecoder</*isSigned*/ false>& lengthDecoder,
-    DictionaryValues& values) {
+    DictionaryValues& values,
+    memory::MemoryPool& pool) {
   // read lengths from length reader
   dwio::common::ensureCapacity<StringView>(
-      values.values, values.numValues, &memoryPool_);
+      values.values, values.numValues, &pool);
   // The lengths are read in the low addresses of the string views array.
   int64_t* int64Values = values.values->asMutable<int64_t>();
   lengthDecoder.next(int64Values, values.numValues, nullptr);
@@ -109,7 +116,7 @@ void SelectiveStringDictionaryColumnReader::loadDictionary(
     stringsBytes += int64Values[i];
   }
   // read bytes from underlying string
-  values.strings = AlignedBuffer::allocate<char>(stringsBytes, &memoryPool_);
+  values.strings = AlignedBuffer::allocate<char>(stringsBytes, &pool);
   data.readFully(values.strings->asMutable<char>(), stringsBytes);
   // fill the values with StringViews over the strings. 'strings' will
   // exist even if 'stringsBytes' is 0, which can happen if the only
@@ -125,6 +132,34 @@ void SelectiveStringDictionaryColumnReader::loadDictionary(
   }
 }
 
+bool SelectiveStringDictionaryColumnReader::loadCachedDictionary() {
+  if (!dictionaryCache_) {
+    return false;
+  }
+  auto& dictionary = scanState_.dictionary;
+  auto cached = dictionaryCache_->get(*dictionaryCacheKey_);
+  if (!cached) {
+    // Readers that miss at the same time each decode the dictionary and the
+    // first to finish caches it.
+    DictionaryValues values;
+    values.numValues = dictionary.numValues;
+    loadDictionary(
+        *blobStream_, *lengthDecoder_, values, DecodedDictionaryCache::pool());
+    auto decoded = std::make_shared<DecodedDictionary>();
+    decoded->values = std::move(values.values);
+    decoded->strings = std::move(values.strings);
+    decoded->numValues = values.numValues;
+    dictionaryCache_->put(*dictionaryCacheKey_, decoded);
+    cached = std::move(decoded);
+  }
+  VELOX_CHECK_EQ(cached->numValues, dictionary.numValues);
+  // The cached buffers are shared and never written: the results that wrap
+  // them are copied by ensureWritable() before they are changed.
+  dictionary.values = cached->values;
+  dictionary.strings = cached->strings;
+  return true;
+}
+
 void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   auto nextStride = provider_.getStrideIndex();
   if (nextStride == lastStrideIndex_) {
@@ -134,6 +169,7 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   // get stride dictionary size and load it if needed
   auto& positions =
       formatData_->as<DwrfData>().index().entry(nextStride).positions();
+  const auto previousStrideDictionarySize = scanState_.dictionary2.numValues;
   scanState_.dictionary2.numValues = positions.Get(strideDictSizeOffset_);
   if (scanState_.dictionary2.numValues > 0) {
     // seek stride dictionary related streams
@@ -144,10 +180,18 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
     strideDictLengthDecoder_->seekToRowGroup(pp);
 
     loadDictionary(
-        *strideDictStream_, *strideDictLengthDecoder_, scanState_.dictionary2);
+        *strideDictStream_,
+        *strideDictLengthDecoder_,
+        scanState_.dictionary2,
+        memoryPool_);
   }
   lastStrideIndex_ = nextStride;
-  dictionaryValues_ = nullptr;
+  // The base vector of the results stays the same across strides without
+  // stride dictionaries, so that all batches of such strides share it.
+  if (previousStrideDictionarySize > 0 ||
+      scanState_.dictionary2.numValues > 0) {
+    dictionaryValues_ = nullptr;
+  }
 
   scanState_.filterCache.resize(
       scanState_.dictionary.numValues + scanState_.dictionary2.numValues);
@@ -286,7 +330,10 @@ void SelectiveStringDictionaryColumnReader::ensureInitialized() {
 
   Timer timer;
 
-  loadDictionary(*blobStream_, *lengthDecoder_, scanState_.dictionary);
+  if (!loadCachedDictionary()) {
+    loadDictionary(
+        *blobStream_, *lengthDecoder_, scanState_.dictionary, memoryPool_);
+  }
 
   scanState_.filterCache.resize(scanState_.dictionary.numValues);
   simd::memset(
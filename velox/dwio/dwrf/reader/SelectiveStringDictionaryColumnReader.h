@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "velox/dwio/common/DecodedDictionaryCache.h"
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
 #include "velox/dwio/dwrf/reader/DwrfData.h"
@@ -83,12 +84,17 @@ class SelectiveStringDictionaryColumnReader
       RowSet rows,
       ExtractValues extractValues);
 
-  // Fills 'values' from 'data' and 'lengthDecoder'. The count of
-  // values is in 'values.numValues'.
+  // Fills 'values' from 'data' and 'lengthDecoder' with buffers from 'pool'.
+  // The count of values is in 'values.numValues'.
   void loadDictionary(
       dwio::common::SeekableInputStream& data,
       dwio::common::IntDecoder</*isSigned*/ false>& lengthDecoder,
-      dwio::common::DictionaryValues& values);
+      dwio::common::DictionaryValues& values,
+      memory::MemoryPool& pool);
+
+  // Sets the stripe dictionary from 'dictionaryCache_', decoding it into the
+  // cache if it is not there. Returns false if the dictionary is not cached.
+  bool loadCachedDictionary();
   void ensureInitialized();
 
   dwrf::DwrfFormat format_;
@@ -112,6 +118,11 @@ class SelectiveStringDictionaryColumnReader
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> lengthDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
   bool initialized_{false};
+
+  // The cache of the decoded stripe dictionary and its key, or nullptr if
+  // the dictionary is decoded for this reader only.
+  std::shared_ptr<dwio::common::DecodedDictionaryCache> dictionaryCache_;
+  std::optional<dwio::common::DecodedDictionaryCache::Key> dictionaryCacheKey_;
 };
 
 template <typename TVisitor>
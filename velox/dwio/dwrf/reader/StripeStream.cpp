@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include <folly/ScopeGuard.h>
 #include <folly/container/F14Set.h>
 
@@ -28,6 +30,19 @@ namespace facebook::velox::dwrf {
 using dwio::common::LogType;
 using dwio::common::TypeWithId;
 
+std::vector<uint32_t> StripeStreams::getSequencesOfNode(uint32_t node) const {
+  std::vector<uint32_t> sequences;
+  visitStreamsOfNode(node, [&](const StreamInformation& stream) {
+    if (stream.getSequence() != 0) {
+      sequences.push_back(stream.getSequence());
+    }
+  });
+  std::sort(sequences.begin(), sequences.end());
+  sequences.erase(
+      std::unique(sequences.begin(), sequences.end()), sequences.end());
+  return sequences;
+}
+
 namespace {
 
 template <typename IsProjected>
@@ -284,10 +299,15 @@ std::unique_ptr<dwio::common::SeekableInputStream> StripeStreamsImpl::getStream(
 
   auto streamDebugInfo =
       fmt::format("Stripe {} Stream {}", stripeIndex_, si.toString());
+  // Index streams are read once when positioning, so only data streams are
+  // decompressed ahead.
   return reader_.getReader().createDecompressedStream(
+      si.encodingKey().node,
       std::move(streamRead),
       streamDebugInfo,
-      getDecrypter(si.encodingKey().node));
+      getDecrypter(si.encodingKey().node),
+      isIndexStream(si.kind()) ? nullptr
+                               : opts_.getDecompressionExecutor().get());
 }
 
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
@@ -304,6 +324,47 @@ uint32_t StripeStreamsImpl::visitStreamsOfNode(
   return count;
 }
 
+std::vector<uint32_t> StripeStreamsImpl::getSequencesOfNode(
+    uint32_t node) const {
+  if (!sequencesOfNodes_.has_value()) {
+    auto& sequencesOfNodes = sequencesOfNodes_.emplace();
+    for (auto& item : streams_) {
+      if (const auto sequence = item.first.encodingKey().sequence;
+          sequence != 0) {
+        sequencesOfNodes[item.first.encodingKey().node].push_back(sequence);
+      }
+    }
+    for (auto& [_, sequences] : sequencesOfNodes) {
+      std::sort(sequences.begin(), sequences.end());
+      sequences.erase(
+          std::unique(sequences.begin(), sequences.end()), sequences.end());
+    }
+  }
+  auto it = sequencesOfNodes_->find(node);
+  if (it == sequencesOfNodes_->end()) {
+    return {};
+  }
+  return it->second;
+}
+
+std::optional<dwio::common::DecodedDictionaryCache::Key>
+StripeStreamsImpl::getDictionaryCacheKey(const EncodingKey& ek) const {
+  // The plaintext of encrypted columns is not shared beyond this reader.
+  if (decryptedEncodings_.count(ek) != 0) {
+    return std::nullopt;
+  }
+  const auto& info =
+      getStreamInfo(ek.forKind(proto::Stream_Kind_DICTIONARY_DATA), false);
+  if (!info.valid()) {
+    return std::nullopt;
+  }
+  return dwio::common::DecodedDictionaryCache::makeKey(
+      *reader_.getReader().getBufferedInput().getReadFile(),
+      stripeIndex_,
+      ek.node,
+      stripeStart_ + info.getOffset());
+}
+
 bool StripeStreamsImpl::getUseVInts(const DwrfStreamIdentifier& si) const {
   const auto& info = getStreamInfo(si, false);
   if (!info.valid()) {
@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <optional>
+
 #include "velox/dwio/common/ColumnSelector.h"
+#include "velox/dwio/common/DecodedDictionaryCache.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -135,6 +138,15 @@ class StripeStreams {
 
   virtual std::shared_ptr<StripeDictionaryCache> getStripeDictionaryCache() = 0;
 
+  /// Returns the key of the stripe dictionary of 'ek' in the
+  /// DecodedDictionaryCache, or std::nullopt if the dictionary is not to be
+  /// shared with other readers, e.g. if the column is encrypted or the file
+  /// has no name.
+  virtual std::optional<dwio::common::DecodedDictionaryCache::Key>
+  getDictionaryCacheKey(const EncodingKey& /*ek*/) const {
+    return std::nullopt;
+  }
+
   /**
    * visit all streams of given node and execute visitor logic
    * return number of streams visited
@@ -143,6 +155,12 @@ class StripeStreams {
       uint32_t node,
       std::function<void(const StreamInformation&)> visitor) const = 0;
 
+  /// Returns the distinct non-zero sequences of the streams of 'node' in
+  /// increasing order. For the value node of a flat map these identify the
+  /// keys written in the stripe. The default implementation visits the
+  /// streams of 'node'.
+  virtual std::vector<uint32_t> getSequencesOfNode(uint32_t node) const;
+
   /**
    * Get the value of useVInts for the given column in this stripe.
    * Defaults to true.
@@ -220,6 +238,11 @@ class StripeStreamsImpl : public StripeStreamsBase {
   folly::F14FastMap<EncodingKey, uint32_t, EncodingKeyHash> encodings_;
   folly::F14FastMap<EncodingKey, proto::ColumnEncoding, EncodingKeyHash>
       decryptedEncodings_;
+  // The sorted non-zero sequences of the streams of each node. Built from
+  // 'streams_' on the first getSequencesOfNode() so that readers of flat maps
+  // with many keys do not each visit all streams of the stripe.
+  mutable std::optional<folly::F14FastMap<uint32_t, std::vector<uint32_t>>>
+      sequencesOfNodes_;
 
  public:
   StripeStreamsImpl(
@@ -291,6 +314,11 @@ class StripeStreamsImpl : public StripeStreamsBase {
       uint32_t node,
       std::function<void(const StreamInformation&)> visitor) const override;
 
+  std::vector<uint32_t> getSequencesOfNode(uint32_t node) const override;
+
+  std::optional<dwio::common::DecodedDictionaryCache::Key>
+  getDictionaryCacheKey(const EncodingKey& ek) const override;
+
   bool getUseVInts(const DwrfStreamIdentifier& si) const override;
 
   const StrideIndexProvider& getStrideIndexProvider() const override {
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <fmt/format.h>
+#include <cstring>
+
+using namespace ::testing;
+using namespace facebook::velox::dwrf;
+
+TEST(BloomFilterTests, size) {
+  // Same sizes as the ORC writer.
+  BloomFilter filter(10000, 0.05);
+  EXPECT_EQ(62400, filter.numBits());
+  EXPECT_EQ(4, filter.numHashFunctions());
+
+  BloomFilter small(1, 0.5);
+  EXPECT_EQ(64, small.numBits());
+  EXPECT_EQ(1, small.numHashFunctions());
+}
+
+TEST(BloomFilterTests, longs) {
+  constexpr int32_t kNumValues = 10000;
+  BloomFilter filter(kNumValues, 0.05);
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    filter.addLong(i * 7 - 1000);
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    EXPECT_TRUE(filter.testLong(i * 7 - 1000));
+    numFalsePositives += filter.testLong(i * 7 - 997);
+  }
+  EXPECT_LT(numFalsePositives, kNumValues / 10);
+
+  filter.reset();
+  EXPECT_FALSE(filter.testLong(-1000));
+}
+
+TEST(BloomFilterTests, bytes) {
+  constexpr int32_t kNumValues = 10000;
+  BloomFilter filter(kNumValues, 0.05);
+  for (auto i = 0; i < kNumValues; ++i) {
+    filter.addBytes(fmt::format("value{}", i));
+  }
+  // The empty string and strings of all tail lengths hash consistently.
+  filter.addBytes("");
+  EXPECT_TRUE(filter.testBytes(""));
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < kNumValues; ++i) {
+    EXPECT_TRUE(filter.testBytes(fmt::format("value{}", i)));
+    numFalsePositives += filter.testBytes(fmt::format("other{}", i));
+  }
+  EXPECT_LT(numFalsePositives, kNumValues / 10);
+}
+
+TEST(BloomFilterTests, serialize) {
+  BloomFilter filter(1000, 0.01);
+  for (int64_t i = 0; i < 1000; ++i) {
+    filter.addLong(i);
+    filter.addBytes(fmt::format("{}", i));
+  }
+  proto::BloomFilter proto;
+  filter.serialize(proto);
+  EXPECT_EQ(filter.numHashFunctions(), proto.numhashfunctions());
+  EXPECT_EQ(filter.numBits() / 8, proto.utf8bitset().size());
+
+  BloomFilter copy(proto);
+  EXPECT_EQ(filter.numBits(), copy.numBits());
+  for (int64_t i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(copy.testLong(i));
+    EXPECT_TRUE(copy.testBytes(fmt::format("{}", i)));
+  }
+
+  // Older writers set the bits as 64 bit words.
+  proto::BloomFilter words;
+  words.set_numhashfunctions(proto.numhashfunctions());
+  for (auto i = 0; i < filter.numBits() / 64; ++i) {
+    uint64_t word;
+    memcpy(&word, proto.utf8bitset().data() + i * 8, sizeof(word));
+    words.add_bitset(word);
+  }
+  BloomFilter fromWords(words);
+  for (int64_t i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(fromWords.testLong(i));
+  }
+}
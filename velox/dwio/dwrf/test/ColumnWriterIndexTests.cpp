@@ -669,6 +669,9 @@ class IntegerColumnWriterDirectEncodingIndexTest : public testing::Test {
     config_->set(
         Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD,
         abandonDict ? 1.0f : 0.0f);
+    // Stay with direct encoding for all stripes once the dictionary is
+    // abandoned.
+    config_->set(Config::DICTIONARY_ENCODING_INTERVAL, 0u);
   }
 
  protected:
@@ -983,6 +986,9 @@ class StringColumnWriterDirectEncodingIndexTest : public testing::Test {
         Config::STRING_STATS_LIMIT, std::numeric_limits<uint32_t>::max());
     config_->set(Config::ENTROPY_KEY_STRING_SIZE_THRESHOLD, 0.0f);
     config_->set(Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, 0.0f);
+    // Stay with direct encoding for all stripes once the dictionary is
+    // abandoned.
+    config_->set(Config::DICTIONARY_ENCODING_INTERVAL, 0u);
   }
 
  protected:
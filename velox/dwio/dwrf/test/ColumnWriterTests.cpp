@@ -2700,9 +2700,7 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonDictionaries) {
               successAtNthWriteForStripe(0, 0)),
           1,
           10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DirectEncodingTestCase{
           1000,
           generateRangeWithCustomLimits,
@@ -2721,15 +2719,6 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonDictionaries) {
               successAtNthWriteForStripe(0, 1)),
           2,
           5},
-      // We shouldn't be able to switch encodings beyond the first stripe.
-      DictionaryEncodingTestCase{
-          1000,
-          /* finalDictionarySize */ 1000,
-          generateRangeWithCustomLimits,
-          checkAbandonDict(
-              abandonNthWriteForStripe(1, 0), /* force */ true, noSuccess),
-          2,
-          5},
       // Abandoning at every write to make sure subsequent abandon dict calls
       // are safe.
       DirectEncodingTestCase{
@@ -2832,9 +2821,7 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonDictionariesWithNulls) {
               successAtNthWriteForStripe(0, 0)),
           1,
           10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DirectEncodingTestCase{
           1000,
           generateRangeWithCustomLimits,
@@ -2853,15 +2840,6 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonDictionariesWithNulls) {
               successAtNthWriteForStripe(0, 1)),
           2,
           5},
-      // We shouldn't be able to switch encodings beyond the first stripe.
-      DictionaryEncodingTestCase{
-          1000,
-          /* finalDictionarySize */ 341,
-          generateRangeWithCustomLimits,
-          checkAbandonDict(
-              abandonNthWriteForStripe(1, 0), /* force */ true, noSuccess),
-          2,
-          5},
       // Abandoning at every write to make sure subsequent abandon dict calls
       // are safe.
       DirectEncodingTestCase{
@@ -2994,9 +2972,7 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonLowValueDictionaries) {
               /* force */ false,
               noSuccess),
           /* repCount */ 10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DictionaryEncodingTestCase{
           1000,
           /* dictionaryWriteThreshold */ 1.0f,
@@ -3008,7 +2984,7 @@ TEST(ColumnWriterTests, IntegerColumnWriterAbandonLowValueDictionaries) {
               noSuccess),
           /* repCount */ 5,
           /* stripeCount*/ 2},
-      // We shouldn't be able to switch encodings beyond the first stripe.
+      // Efficient dictionaries are kept beyond the first stripe.
       DictionaryEncodingTestCase{
           1000,
           /* dictionaryWriteThreshold */ 1.0f,
@@ -3660,9 +3636,7 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonDictionaries) {
               successAtNthWriteForStripe(0, 0)),
           1,
           10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DirectEncodingTestCase{
           1000,
           generateStringRange,
@@ -3681,15 +3655,6 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonDictionaries) {
               successAtNthWriteForStripe(0, 1)),
           2,
           5},
-      // We shouldn't be able to switch encodings beyond the first stripe.
-      DictionaryEncodingTestCase{
-          1000,
-          /* finalDictionarySize */ 1000,
-          generateStringRange,
-          checkAbandonDict(
-              abandonNthWriteForStripe(1, 0), /* force */ true, noSuccess),
-          2,
-          5},
       // Abandoning at every write to make sure subsequent abandon dict calls
       // are safe.
       DirectEncodingTestCase{
@@ -3794,9 +3759,7 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonDictionariesWithNulls) {
               successAtNthWriteForStripe(0, 0)),
           1,
           10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DirectEncodingTestCase{
           1000,
           generateStringRange,
@@ -3815,15 +3778,6 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonDictionariesWithNulls) {
               successAtNthWriteForStripe(0, 1)),
           2,
           5},
-      // We shouldn't be able to switch encodings beyond the first stripe.
-      DictionaryEncodingTestCase{
-          1000,
-          /* finalDictionarySize */ 341,
-          generateStringRange,
-          checkAbandonDict(
-              abandonNthWriteForStripe(1, 0), /* force */ true, noSuccess),
-          2,
-          5},
       // Abandoning at every write to make sure subsequent abandon dict calls
       // are safe.
       DirectEncodingTestCase{
@@ -3957,9 +3911,7 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonLowValueDictionaries) {
               /* force */ false,
               noSuccess),
           /* repCount */ 10},
-      // Test abandoning dictionary in multi-write scenarios. For now we could
-      // only abandon dictionary starting from the first stripe, because we
-      // could not switch up encoding of a writer once determined.
+      // Test abandoning dictionary in multi-write scenarios.
       DictionaryEncodingTestCase{
           1000,
           /* dictionaryKeyEfficiencyThreshold */ 1.0f,
@@ -3971,7 +3923,7 @@ TEST(ColumnWriterTests, StringColumnWriterAbandonLowValueDictionaries) {
               noSuccess),
           /* repCount */ 5,
           /* stripeCount*/ 2},
-      // We shouldn't be able to switch encodings beyond the first stripe.
+      // Efficient dictionaries are kept beyond the first stripe.
       DictionaryEncodingTestCase{
           1000,
           /* dictionaryKeyEfficiencyThreshold */ 1.0f,
@@ -4471,4 +4423,169 @@ TEST(ColumnWriterTests, mapDictionary) {
       randomNulls(3));
 }
 
+
+namespace {
+// Reads back the stripe written to 'context' and checks its encoding and
+// values.
+void verifyStripe(
+    WriterContext& context,
+    const proto::StripeFooter& stripeFooter,
+    const VectorPtr& expected,
+    proto::ColumnEncoding_Kind expectedKind) {
+  auto pool = addDefaultLeafMemoryPool();
+  auto rowType = ROW({expected->type()});
+  TestStripeStreams streams(context, stripeFooter, rowType, pool.get());
+  EXPECT_CALL(streams.getMockStrideIndexProvider(), getStrideIndex())
+      .WillRepeatedly(Return(0));
+  ASSERT_EQ(expectedKind, streams.getEncoding(EncodingKey{1}).kind());
+  auto reqType = TypeWithId::create(rowType)->childAt(0);
+  auto reader = ColumnReader::build(reqType, reqType, streams);
+  VectorPtr result;
+  reader->next(expected->size(), result);
+  ASSERT_EQ(expected->size(), result->size());
+  for (auto i = 0; i < expected->size(); ++i) {
+    ASSERT_TRUE(result->equalValueAt(expected.get(), i, i)) << "at index " << i;
+  }
+}
+
+// Writes each of 'stripes' as a stripe of one stride and checks that the
+// stripes get 'expectedKinds'.
+void testEncodingPerStripe(
+    WriterContext& context,
+    const std::vector<VectorPtr>& stripes,
+    const std::vector<proto::ColumnEncoding_Kind>& expectedKinds) {
+  auto typeWithId = TypeWithId::create(stripes[0]->type(), 1);
+  auto writer = BaseColumnWriter::create(context, *typeWithId);
+  for (auto i = 0; i < stripes.size(); ++i) {
+    SCOPED_TRACE(fmt::format("stripe {}", i));
+    writer->write(stripes[i], common::Ranges::of(0, stripes[i]->size()));
+    writer->createIndexEntry();
+    proto::StripeFooter stripeFooter;
+    writer->flush(
+        [&stripeFooter](uint32_t /* unused */) -> proto::ColumnEncoding& {
+          return *stripeFooter.add_encoding();
+        });
+    verifyStripe(context, stripeFooter, stripes[i], expectedKinds[i]);
+    context.nextStripe();
+    writer->reset();
+  }
+}
+} // namespace
+
+TEST(ColumnWriterTests, dictionaryEncodingPerStripe) {
+  auto pool = addDefaultLeafMemoryPool();
+  VectorMaker maker{pool.get()};
+  auto config = std::make_shared<Config>();
+  // Retry dictionary encoding after each direct encoded stripe.
+  config->set(Config::DICTIONARY_ENCODING_INTERVAL, 1u);
+  const auto kDictionary =
+      proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DICTIONARY;
+  const auto kDirect = proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DIRECT;
+
+  std::vector<std::string> lowCardinality;
+  std::vector<std::string> highCardinality;
+  for (auto i = 0; i < 1000; ++i) {
+    lowCardinality.push_back(fmt::format("value {}", i % 10));
+    highCardinality.push_back(fmt::format("value {}", i));
+  }
+  {
+    WriterContext context{config, defaultMemoryManager().addRootPool()};
+    testEncodingPerStripe(
+        context,
+        {maker.flatVector(lowCardinality),
+         maker.flatVector(highCardinality),
+         maker.flatVector(highCardinality),
+         maker.flatVector(lowCardinality)},
+        {kDictionary, kDirect, kDirect, kDictionary});
+    EXPECT_EQ(
+        2,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kAbandon));
+    EXPECT_EQ(
+        2,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kRetry));
+  }
+
+  {
+    WriterContext context{config, defaultMemoryManager().addRootPool()};
+    auto low =
+        maker.flatVector<int64_t>(1000, [](auto row) { return row % 10; });
+    auto high = maker.flatVector<int64_t>(1000, [](auto row) { return row; });
+    testEncodingPerStripe(
+        context,
+        {low, high, high, low},
+        {kDictionary, kDirect, kDirect, kDictionary});
+    EXPECT_EQ(
+        2,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kAbandon));
+    EXPECT_EQ(
+        2,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kRetry));
+  }
+
+  // Without retries, the column stays direct encoded once abandoned.
+  config->set(Config::DICTIONARY_ENCODING_INTERVAL, 0u);
+  {
+    WriterContext context{config, defaultMemoryManager().addRootPool()};
+    testEncodingPerStripe(
+        context,
+        {maker.flatVector(lowCardinality),
+         maker.flatVector(highCardinality),
+         maker.flatVector(lowCardinality)},
+        {kDictionary, kDirect, kDirect});
+    EXPECT_EQ(
+        0,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kRetry));
+  }
+}
+
+TEST(ColumnWriterTests, dictionaryEarlyAbort) {
+  auto pool = addDefaultLeafMemoryPool();
+  VectorMaker maker{pool.get()};
+  auto config = std::make_shared<Config>();
+  config->set(Config::DICTIONARY_EARLY_ABORT_ROWS, 1000u);
+  WriterContext context{config, defaultMemoryManager().addRootPool()};
+  auto typeWithId = TypeWithId::create(VARCHAR(), 1);
+  auto writer = BaseColumnWriter::create(context, *typeWithId);
+
+  std::vector<std::string> values;
+  for (auto i = 0; i < 3000; ++i) {
+    values.push_back(fmt::format("value {}", i));
+  }
+  auto batch = maker.flatVector(values);
+  auto& dictionaryPool =
+      context.getMemoryUsage(MemoryUsageCategory::DICTIONARY);
+  for (auto i = 0; i < 3; ++i) {
+    writer->write(batch, common::Ranges::of(i * 1000, (i + 1) * 1000));
+    const auto dictionaryBytes = dictionaryPool.getCurrentBytes();
+    writer->createIndexEntry();
+    // The dictionary is abandoned and freed at the end of the first stride.
+    EXPECT_EQ(
+        1,
+        context.dictionaryEncodingDecisions(
+            DictionaryEncodingDecision::kEarlyAbort));
+    if (i == 0) {
+      EXPECT_LT(dictionaryPool.getCurrentBytes(), dictionaryBytes);
+    }
+  }
+  proto::StripeFooter stripeFooter;
+  writer->flush(
+      [&stripeFooter](uint32_t /* unused */) -> proto::ColumnEncoding& {
+        return *stripeFooter.add_encoding();
+      });
+  verifyStripe(
+      context,
+      stripeFooter,
+      batch,
+      proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DIRECT);
+  EXPECT_EQ(
+      0,
+      context.dictionaryEncodingDecisions(
+          DictionaryEncodingDecision::kAbandon));
+}
+
 } // namespace facebook::velox::dwrf
@@ -43,12 +43,12 @@ TEST(ConfigTests, Set) {
 
 TEST(ConfigTests, EnumConfig) {
   Config config;
-  config.set(Config::COMPRESSION, CompressionKind::CompressionKind_ZLIB);
+  config.set(Config::COMPRESSION, CompressionKind_ZLIB);
   EXPECT_EQ(
-      config.get(Config::COMPRESSION), CompressionKind::CompressionKind_ZLIB);
-  config.set(Config::COMPRESSION, CompressionKind::CompressionKind_NONE);
+      config.get(Config::COMPRESSION), CompressionKind_ZLIB);
+  config.set(Config::COMPRESSION, CompressionKind_NONE);
   EXPECT_EQ(
-      config.get(Config::COMPRESSION), CompressionKind::CompressionKind_NONE);
+      config.get(Config::COMPRESSION), CompressionKind_NONE);
 }
 
 TEST(ConfigTests, UInt32Config) {
@@ -66,6 +66,29 @@ TEST(ConfigTests, BoolConfig) {
   EXPECT_TRUE(config.get(Config::CREATE_INDEX));
 }
 
+TEST(ConfigTests, ColumnCompression) {
+  auto config = Config::fromMap(
+      {{"orc.column.compress", "1:zstd, 4:none,"},
+       {"orc.column.compress.level", "1:19"}});
+  std::map<uint32_t, CompressionKind> kinds{
+      {1, CompressionKind_ZSTD},
+      {4, CompressionKind_NONE}};
+  EXPECT_EQ(config->get(Config::COLUMN_COMPRESSION), kinds);
+  std::map<uint32_t, int32_t> levels{{1, 19}};
+  EXPECT_EQ(config->get(Config::COLUMN_COMPRESSION_LEVEL), levels);
+  EXPECT_TRUE(Config().get(Config::COLUMN_COMPRESSION).empty());
+
+  Config copy;
+  copy.set<const std::map<uint32_t, CompressionKind>>(
+      Config::COLUMN_COMPRESSION, kinds);
+  EXPECT_EQ(copy.get(Config::COLUMN_COMPRESSION), kinds);
+
+  VELOX_ASSERT_THROW(
+      Config::fromMap({{"orc.column.compress", "1:brotli"}})
+          ->get(Config::COLUMN_COMPRESSION),
+      "Unknown compression kind: brotli");
+}
+
 struct ConfigTestParams {
   std::string inputCols{""}; // input spec
   std::vector<uint32_t> expectedCols{}; // do we expect the spec to be valid
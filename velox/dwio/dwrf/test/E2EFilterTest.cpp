@@ -20,6 +20,7 @@
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
 using namespace facebook::velox::dwio::common;
@@ -89,6 +90,10 @@ class E2EFilterTest : public E2EFilterTestBase {
     if (!flatmapNodeIdsAsStruct_.empty()) {
       opts.setFlatmapNodeIdsAsStruct(flatmapNodeIdsAsStruct_);
     }
+    if (decodingExecutor_) {
+      opts.setDecodingExecutor(decodingExecutor_);
+      opts.setDecodingParallelism(4);
+    }
   }
 
   std::unique_ptr<dwio::common::Reader> makeReader(
@@ -97,13 +102,52 @@ class E2EFilterTest : public E2EFilterTestBase {
     return std::make_unique<DwrfReader>(opts, std::move(input));
   }
 
+  // Returns the number of rows passing 'filter' on 'column' and sets
+  // 'numSkipped' to the number of skipped strides.
+  int64_t countRows(
+      const std::string& column,
+      std::unique_ptr<Filter> filter,
+      int64_t& numSkipped) {
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->getOrCreateChild(Subfield(column))->setFilter(std::move(filter));
+    dwio::common::ReaderOptions readerOpts{leafPool_.get()};
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    auto input = std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+    auto reader = makeReader(readerOpts, std::move(input));
+    dwio::common::RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    VectorPtr result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1000, result)) {
+      numRows += result->size();
+    }
+    RuntimeStatistics stats;
+    rowReader->updateRuntimeStats(stats);
+    numSkipped = stats.skippedStrides;
+    return numRows;
+  }
+
   std::unordered_set<std::string> flatMapColumns_;
+  std::shared_ptr<folly::Executor> decodingExecutor_;
+  // Top level columns with bloom filters.
+  std::vector<uint32_t> bloomFilterColumns_;
+  std::optional<uint32_t> rowIndexStride_;
 
  private:
   WriterOptions createWriterOptions(const TypePtr& type) {
     auto config = std::make_shared<dwrf::Config>();
     config->set(dwrf::Config::COMPRESSION, CompressionKind_NONE);
     config->set(dwrf::Config::USE_VINTS, useVInts_);
+    if (!bloomFilterColumns_.empty()) {
+      config->set<const std::vector<uint32_t>>(
+          dwrf::Config::BLOOM_FILTER_COLUMNS, bloomFilterColumns_);
+    }
+    if (rowIndexStride_.has_value()) {
+      config->set(dwrf::Config::ROW_INDEX_STRIDE, rowIndexStride_.value());
+    }
     auto writerSchema = type;
     if (!flatMapColumns_.empty()) {
       auto& rowType = type->asRow();
@@ -235,6 +279,24 @@ TEST_F(E2EFilterTest, floatAndDouble) {
       false);
 }
 
+TEST_F(E2EFilterTest, parallelDecoding) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(3);
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "struct_val:struct<a:bigint,b:string>,"
+      "array_val:array<int>",
+      [&]() { makeStringDistribution("string_val", 100, true, false); },
+      false,
+      {"short_val", "int_val", "long_val", "double_val", "string_val"},
+      20,
+      true,
+      false);
+}
+
 TEST_F(E2EFilterTest, stringDirect) {
   flushEveryNBatches_ = 1;
   testWithTypes(
@@ -389,6 +451,73 @@ TEST_F(E2EFilterTest, flatMap) {
       kColumns, customize, false, {"long_val"}, numCombinations, true);
 }
 
+TEST_F(E2EFilterTest, bloomFilter) {
+  bloomFilterColumns_ = {0, 1, 2, 3};
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() { makeStringUnique("string_val"); },
+      false,
+      {"short_val", "int_val", "long_val", "string_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, bloomFilterPruning) {
+  bloomFilterColumns_ = {0, 1};
+  rowIndexStride_ = 1000;
+  rowType_ = ROW({"s", "i"}, {VARCHAR(), BIGINT()});
+  constexpr int32_t kNumRows = 5000;
+  auto strings = BaseVector::create<FlatVector<StringView>>(
+      VARCHAR(), kNumRows, leafPool_.get());
+  auto ints = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    // Each stride has the same min and max and one value of its own.
+    const auto stride = i / 1000;
+    const auto value = i % 3 == 0 ? 0 : (i % 3 == 1 ? 100 : 10 + stride);
+    strings->set(i, StringView(fmt::format("s{:03}", value)));
+    ints->set(i, value);
+  }
+  std::vector<RowVectorPtr> batches = {std::make_shared<RowVector>(
+      leafPool_.get(),
+      rowType_,
+      nullptr,
+      kNumRows,
+      std::vector<VectorPtr>{strings, ints})};
+  writeToMemory(rowType_, batches, true);
+
+  int64_t numSkipped;
+  EXPECT_EQ(
+      334,
+      countRows(
+          "s",
+          std::make_unique<BytesRange>(
+              "s012", false, false, "s012", false, false, false),
+          numSkipped));
+  EXPECT_EQ(4, numSkipped);
+  EXPECT_EQ(
+      0,
+      countRows(
+          "s",
+          std::make_unique<BytesValues>(
+              std::vector<std::string>{"s050", "s060"}, false),
+          numSkipped));
+  EXPECT_EQ(5, numSkipped);
+  EXPECT_EQ(
+      666,
+      countRows(
+          "i",
+          std::make_unique<BigintValuesUsingHashTable>(
+              10, 50, std::vector<int64_t>{11, 14, 50}, false),
+          numSkipped));
+  EXPECT_EQ(3, numSkipped);
+  // Ranges are not tested against the bloom filters.
+  countRows("i", std::make_unique<BigintRange>(50, 60, false), numSkipped);
+  EXPECT_EQ(0, numSkipped);
+}
+
 TEST_F(E2EFilterTest, metadataFilter) {
   testMetadataFilter();
 }
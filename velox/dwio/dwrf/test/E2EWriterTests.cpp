@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -333,6 +334,85 @@ TEST_F(E2EWriterTests, E2E) {
   E2EWriterTestUtil::testWriter(*leafPool_, type, batches, 1, 1, config);
 }
 
+TEST_F(E2EWriterTests, parallelEncoding) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "map_val:map<bigint,double>,"
+      "map_val:map<bigint,map<string, int>>,"
+      "struct_val:struct<a:float,b:double>"
+      ">");
+
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {6, 7});
+  // Small compression blocks so that the columns compress while writing.
+  config->set(Config::COMPRESSION_BLOCK_SIZE, static_cast<uint64_t>(1024));
+  config->set(Config::STRIPE_SIZE, static_cast<uint64_t>(256 * 1024));
+
+  auto batches =
+      E2EWriterTestUtil::generateBatches(type, 10, 2'000, 7, *leafPool_);
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(3);
+  for (const auto parallelism : {2, 4, 16}) {
+    SCOPED_TRACE(fmt::format("parallelism: {}", parallelism));
+    E2EWriterTestUtil::testWriter(
+        *leafPool_,
+        type,
+        batches,
+        1,
+        100,
+        config,
+        nullptr,
+        nullptr,
+        std::numeric_limits<int64_t>::max(),
+        true,
+        executor,
+        parallelism);
+  }
+}
+
+TEST_F(E2EWriterTests, columnCompression) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "int_val:int,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "struct_val:struct<a:float,b:double>"
+      ">");
+
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::COMPRESSION_BLOCK_SIZE, static_cast<uint64_t>(1024));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {3});
+  // Column 0 keeps the file codec.
+  config->set<const std::map<uint32_t, CompressionKind>>(
+      Config::COLUMN_COMPRESSION,
+      {{1, CompressionKind_ZSTD},
+       {2, CompressionKind_ZLIB},
+       {3, CompressionKind_ZSTD},
+       {4, CompressionKind_NONE}});
+  config->set<const std::map<uint32_t, int32_t>>(
+      Config::COLUMN_COMPRESSION_LEVEL, {{1, 19}});
+
+  auto batches =
+      E2EWriterTestUtil::generateBatches(type, 4, 2'000, 11, *leafPool_);
+  for (auto compression : {CompressionKind_NONE, CompressionKind_ZLIB}) {
+    SCOPED_TRACE(compressionKindToString(compression));
+    config->set(Config::COMPRESSION, compression);
+    E2EWriterTestUtil::testWriter(*leafPool_, type, batches, 1, 1, config);
+  }
+}
+
 TEST_F(E2EWriterTests, FlatMapDictionaryEncoding) {
   const size_t batchCount = 4;
   // Start with a size larger than stride to cover splitting into
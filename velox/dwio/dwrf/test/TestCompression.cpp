@@ -23,6 +23,8 @@
 #include <folly/Random.h>
 #include <gtest/gtest.h>
 
+#include <fmt/format.h>
+
 #include <algorithm>
 
 using namespace ::testing;
@@ -278,6 +280,91 @@ TEST_P(CompressionTest, compressProtoBuf) {
   verifyProto(memSink, kind_, block, *pool, ps, decrypter_);
 }
 
+namespace {
+std::string makeJsonSample(int32_t i) {
+  return fmt::format(
+      "{{\"user_id\": {}, \"country\": \"country_{}\", "
+      "\"device\": \"device_type_{}\", \"active\": {}}}",
+      i * 7919,
+      i % 17,
+      i % 5,
+      i % 2 == 0 ? "true" : "false");
+}
+
+// Compresses 'data' in blocks of 'block' bytes with ZSTD and 'dictionary' and
+// returns the compressed size after checking that it decompresses back.
+uint64_t zstdRoundTrip(
+    const std::string& data,
+    uint64_t block,
+    const ZstdDictionary* dictionary,
+    MemoryPool& pool) {
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+  TestBufferPool bufferPool(pool, block);
+  DataBufferHolder holder{pool, block, 0, DEFAULT_PAGE_GROW_RATIO, &memSink};
+  Config config;
+  auto compressStream = createCompressor(
+      CompressionKind_ZSTD,
+      bufferPool,
+      holder,
+      config,
+      nullptr,
+      /*level=*/3,
+      dictionary);
+  size_t pos = 0;
+  char* buffer;
+  int32_t size;
+  while (pos < data.size() &&
+         compressStream->Next(reinterpret_cast<void**>(&buffer), &size)) {
+    const auto copySize = std::min<size_t>(size, data.size() - pos);
+    memcpy(buffer, data.data() + pos, copySize);
+    compressStream->BackUp(size - copySize);
+    pos += copySize;
+  }
+  compressStream->flush();
+
+  auto decompressStream = createDecompressor(
+      CompressionKind_ZSTD,
+      std::make_unique<SeekableArrayInputStream>(
+          memSink.getData(), memSink.size()),
+      block,
+      pool,
+      "Test Compression",
+      nullptr,
+      dictionary);
+  std::string result;
+  const void* chunk;
+  while (decompressStream->Next(&chunk, &size)) {
+    result.append(reinterpret_cast<const char*>(chunk), size);
+  }
+  EXPECT_EQ(result, data);
+  return memSink.size();
+}
+} // namespace
+
+TEST(TestCompression, zstdDictionary) {
+  auto pool = addDefaultLeafMemoryPool();
+  std::vector<std::string> samples;
+  for (auto i = 0; i < 2'000; ++i) {
+    samples.push_back(makeJsonSample(i));
+  }
+  auto data = trainZstdDictionary(samples, 4 << 10);
+  ASSERT_FALSE(data.empty());
+  ZstdDictionary dictionary(std::move(data));
+
+  std::string input;
+  for (auto i = 10'000; i < 10'200; ++i) {
+    input += makeJsonSample(i);
+  }
+  // Small blocks are where a dictionary pays off.
+  constexpr uint64_t kBlock = 256;
+  const auto withDictionary = zstdRoundTrip(input, kBlock, &dictionary, *pool);
+  const auto withoutDictionary = zstdRoundTrip(input, kBlock, nullptr, *pool);
+  EXPECT_LT(withDictionary, withoutDictionary);
+
+  // Too few samples to train on.
+  EXPECT_TRUE(trainZstdDictionary({"a", "b"}, 4 << 10).empty());
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     TestCompression,
     CompressionTest,
@@ -18,6 +18,7 @@
 #include <folly/String.h>
 #include <folly/compression/Compression.h>
 #include <folly/compression/Zlib.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/dwio/common/InputStream.h"
@@ -868,6 +869,85 @@ TEST_F(TestSeek, Snappy) {
   runTest(*codec, CompressionKind_SNAPPY);
 }
 
+TEST_F(TestSeek, decompressAhead) {
+  // Compressed blocks with an uncompressed block in the middle.
+  constexpr int32_t kNumBlocks = 6;
+  constexpr int32_t kBlockSize = 1000;
+  constexpr int32_t kOriginalBlock = 3;
+  auto codec = getCodec(CodecType::SNAPPY);
+  std::vector<std::vector<char>> blocks(kNumBlocks);
+  std::vector<char> file(kNumBlocks * (kBlockSize + 100));
+  std::vector<uint64_t> headerOffsets;
+  size_t offset = 0;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    blocks[i].resize(kBlockSize);
+    fillInput(blocks[i].data(), kBlockSize);
+    headerOffsets.push_back(offset);
+    if (i == kOriginalBlock) {
+      writeHeader(file.data() + offset, kBlockSize, true);
+      memcpy(file.data() + offset + 3, blocks[i].data(), kBlockSize);
+      offset += kBlockSize + 3;
+    } else {
+      offset = compress(
+          blocks[i].data(), kBlockSize, file.data(), offset, *codec);
+    }
+  }
+  folly::CPUThreadPoolExecutor executor(2);
+  auto stream = createDecompressor(
+      CompressionKind_SNAPPY,
+      std::make_unique<SeekableArrayInputStream>(file.data(), offset, 300),
+      kBlockSize,
+      *pool,
+      "decompressAhead",
+      nullptr,
+      nullptr,
+      &executor);
+
+  // Reads the stream to the end and checks it against 'blocks' from the
+  // start of 'firstBlock'.
+  auto checkRead = [&](int32_t firstBlock) {
+    std::string expected;
+    for (auto i = firstBlock; i < kNumBlocks; ++i) {
+      expected.append(blocks[i].data(), kBlockSize);
+    }
+    std::string actual;
+    const void* data;
+    int32_t size;
+    while (stream->Next(&data, &size)) {
+      actual.append(static_cast<const char*>(data), size);
+    }
+    EXPECT_EQ(expected, actual);
+  };
+  checkRead(0);
+
+  // Seeks back to each block, with the next block read ahead or not.
+  for (auto i = kNumBlocks - 1; i >= 0; --i) {
+    std::vector<uint64_t> positions{headerOffsets[i], 0};
+    PositionProvider position(positions);
+    stream->seekToPosition(position);
+    checkRead(i);
+  }
+
+  // Backs up in a block while the next one is read ahead.
+  std::vector<uint64_t> positions{0, 0};
+  PositionProvider position(positions);
+  stream->seekToPosition(position);
+  const void* data;
+  int32_t size;
+  ASSERT_TRUE(stream->Next(&data, &size));
+  ASSERT_EQ(size, kBlockSize);
+  stream->BackUp(100);
+  ASSERT_TRUE(stream->Next(&data, &size));
+  ASSERT_EQ(size, 100);
+  EXPECT_EQ(0, memcmp(data, blocks[0].data() + kBlockSize - 100, 100));
+  ASSERT_TRUE(stream->Next(&data, &size));
+  ASSERT_EQ(size, kBlockSize);
+  EXPECT_EQ(0, memcmp(data, blocks[1].data(), kBlockSize));
+
+  // The stream can be destroyed with a block read ahead.
+  stream.reset();
+}
+
 TEST_F(TestSeek, uncompressed) {
   constexpr int32_t kSize = 1000;
   constexpr int32_t kHeaderSize = 3;
@@ -196,6 +196,51 @@ TEST(StripeStream, filterSequences) {
   }
 }
 
+TEST(StripeStream, sequencesOfNode) {
+  auto pool = addDefaultLeafMemoryPool();
+  google::protobuf::Arena arena;
+  auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(&arena);
+  footer->set_rowindexstride(100);
+  auto type = HiveTypeParser().parse("struct<a:map<int,float>,b:int>");
+  ProtoUtils::writeType(*type, *footer);
+  auto readerBase = std::make_shared<ReaderBase>(
+      *pool,
+      std::make_unique<BufferedInput>(
+          std::make_unique<RecordingInputStream>(), *pool),
+      std::make_unique<PostScript>(proto::PostScript{}),
+      footer,
+      nullptr);
+  ColumnSelector cs{readerBase->getSchema(), std::vector<std::string>{"a"}};
+
+  // Node 3 is the value of the flat map. Sequence 0 is its shared
+  // dictionary and the others are keys, each with several streams.
+  auto stripeFooter =
+      google::protobuf::Arena::CreateMessage<proto::StripeFooter>(&arena);
+  std::vector<std::tuple<uint64_t, StreamKind, uint64_t>> ss{
+      std::make_tuple(1, StreamKind::StreamKind_PRESENT, 0),
+      std::make_tuple(3, StreamKind::StreamKind_DICTIONARY_DATA, 0),
+      std::make_tuple(3, StreamKind::StreamKind_IN_MAP, 5),
+      std::make_tuple(3, StreamKind::StreamKind_DATA, 5),
+      std::make_tuple(3, StreamKind::StreamKind_IN_MAP, 2),
+      std::make_tuple(3, StreamKind::StreamKind_PRESENT, 2),
+      std::make_tuple(3, StreamKind::StreamKind_DATA, 2),
+      std::make_tuple(3, StreamKind::StreamKind_IN_MAP, 7),
+      std::make_tuple(4, StreamKind::StreamKind_DATA, 0)};
+  for (const auto& s : ss) {
+    auto&& stream = stripeFooter->add_streams();
+    stream->set_node(std::get<0>(s));
+    stream->set_kind(static_cast<proto::Stream_Kind>(std::get<1>(s)));
+    stream->set_length(100);
+    stream->set_sequence(std::get<2>(s));
+  }
+  StripeReaderBase stripeReader{readerBase, stripeFooter};
+  auto streams = createAndLoadStripeStreams(stripeReader, cs);
+  EXPECT_EQ(streams.getSequencesOfNode(3), (std::vector<uint32_t>{2, 5, 7}));
+  EXPECT_TRUE(streams.getSequencesOfNode(1).empty());
+  // Node 4 is not projected.
+  EXPECT_TRUE(streams.getSequencesOfNode(4).empty());
+}
+
 TEST(StripeStream, zeroLength) {
   auto pool = addDefaultLeafMemoryPool();
   google::protobuf::Arena arena;
@@ -38,7 +38,9 @@ namespace facebook::velox::dwrf {
     std::function<
         std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
         layoutPlannerFactory,
-    const int64_t writerMemoryCap) {
+    const int64_t writerMemoryCap,
+    const std::shared_ptr<folly::Executor>& encodingExecutor,
+    const int32_t encodingParallelism) {
   // write file to memory
   WriterOptions options;
   options.config = config;
@@ -46,6 +48,8 @@ namespace facebook::velox::dwrf {
   options.memoryBudget = writerMemoryCap;
   options.flushPolicyFactory = flushPolicyFactory;
   options.layoutPlannerFactory = layoutPlannerFactory;
+  options.encodingExecutor = encodingExecutor;
+  options.encodingParallelism = encodingParallelism;
 
   auto writer = std::make_unique<Writer>(
       options,
@@ -74,7 +78,9 @@ namespace facebook::velox::dwrf {
         std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
         layoutPlannerFactory,
     const int64_t writerMemoryCap,
-    const bool verifyContent) {
+    const bool verifyContent,
+    const std::shared_ptr<folly::Executor>& encodingExecutor,
+    const int32_t encodingParallelism) {
   // write file to memory
   auto sink = std::make_unique<MemorySink>(pool, 200 * 1024 * 1024);
   auto sinkPtr = sink.get();
@@ -87,7 +93,9 @@ namespace facebook::velox::dwrf {
       config,
       flushPolicyFactory,
       layoutPlannerFactory,
-      writerMemoryCap);
+      writerMemoryCap,
+      encodingExecutor,
+      encodingParallelism);
   // read it back and compare
   auto readFile = std::make_shared<InMemoryReadFile>(
       std::string_view(sinkPtr->getData(), sinkPtr->size()));
@@ -37,6 +37,8 @@ class E2EWriterTestUtil {
    *    layoutPlannerFactory    supplies the layout planner and determine how
    *                            order of the data streams prior to flush
    *    writerMemoryCap         total memory budget for the writer
+   *    encodingExecutor        executor for encoding columns in parallel
+   *    encodingParallelism     max number of columns encoded at a time
    */
   static std::unique_ptr<Writer> writeData(
       std::unique_ptr<dwio::common::DataSink> sink,
@@ -48,7 +50,9 @@ class E2EWriterTestUtil {
       std::function<
           std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
           layoutPlannerFactory = nullptr,
-      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max());
+      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max(),
+      const std::shared_ptr<folly::Executor>& encodingExecutor = nullptr,
+      const int32_t encodingParallelism = 1);
 
   /**
    * Creates a writer with the supplied configuration and check the IO
@@ -70,7 +74,9 @@ class E2EWriterTestUtil {
           std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
           layoutPlannerFactory = nullptr,
       const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max(),
-      const bool verifyContent = true);
+      const bool verifyContent = true,
+      const std::shared_ptr<folly::Executor>& encodingExecutor = nullptr,
+      const int32_t encodingParallelism = 1);
 
   static std::vector<VectorPtr> generateBatches(
       const std::shared_ptr<const Type>& type,
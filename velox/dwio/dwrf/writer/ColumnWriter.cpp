@@ -17,6 +17,7 @@
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
 #include <velox/dwio/common/exception/Exception.h>
 #include "velox/dwio/common/ChainedBuffer.h"
+#include "velox/dwio/common/ParallelFor.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
 #include "velox/dwio/dwrf/writer/EntropyEncodingSelector.h"
@@ -27,6 +28,8 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 
+#include <numeric>
+
 using namespace facebook::velox::dwio::common;
 using namespace facebook::velox::memory;
 
@@ -35,16 +38,17 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto selected = context_.getSelectivityVector(slice->size());
   // initialize
-  selected.clearAll();
+  selected->clearAll();
   for (auto& range : ranges.getRanges()) {
-    selected.setValidRange(std::get<0>(range), std::get<1>(range), true);
+    selected->setValidRange(std::get<0>(range), std::get<1>(range), true);
   }
-  selected.updateBounds();
+  selected->updateBounds();
   // decode
   auto localDecoded = context_.getLocalDecodedVector();
-  localDecoded.get().decode(*slice, selected);
+  localDecoded.get().decode(*slice, *selected);
+  context_.releaseSelectivityVector(std::move(selected));
   return localDecoded;
 }
 
@@ -209,11 +213,12 @@ class IntegerColumnWriter : public BaseColumnWriter {
         dictionaryKeySizeThreshold_{
             getConfig(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        earlyAbortRows_{getConfig(Config::DICTIONARY_EARLY_ABORT_ROWS)},
+        retryInterval_{getConfig(Config::DICTIONARY_ENCODING_INTERVAL)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE_GE(dictionaryKeySizeThreshold_, 0.0);
     DWIO_ENSURE_LE(dictionaryKeySizeThreshold_, 1.0);
-    DWIO_ENSURE(firstStripe_);
     if (!useDictionaryEncoding_) {
       // Suppress the stream used to initialize dictionary encoder.
       // TODO: passing factory method into the dict encoder also works
@@ -233,6 +238,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // time. We would defer recording all stream positions till then, and
     // only record position for PRESENT stream upon construction.
     BaseColumnWriter::recordPosition();
+    maybeRetryDictionaryEncoding();
     // Record starting position only for direct encoding because we don't know
     // until the next flush whether we need to write the IN_DICTIONARY stream.
     if (useDictionaryEncoding_) {
@@ -277,10 +283,8 @@ class IntegerColumnWriter : public BaseColumnWriter {
       data_->flush();
     } else {
       dataDirect_->flush();
+      ++directStripes_;
     }
-
-    // Start the new stripe.
-    firstStripe_ = false;
   }
 
   // FIXME: call base class set encoding first to deal with sequence and
@@ -308,16 +312,15 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
-    // TODO: the only way useDictionaryEncoding_ right now is
-    // through abandonDictionary, so we already have the stream initialization
-    // handled. Might want to rethink stream initialization in the future when
-    // we support starting with low memory mode and switching encoding after
-    // first stripe.
     if (useDictionaryEncoding_) {
       // Record the stride boundaries so that we can backfill the stream
       // positions when actually writing the streams.
       strideOffsets_.append(rows_.size());
+      if (shouldAbortDictionary()) {
+        abandonDictionary(DictionaryEncodingDecision::kEarlyAbort);
+      }
     } else {
       recordDirectEncodingStreamPositions();
     }
@@ -339,33 +342,21 @@ class IntegerColumnWriter : public BaseColumnWriter {
   // This incurs additional memory usage. A good long term adjustment but not
   // viable mitigation to memory pressure.
   bool tryAbandonDictionaries(bool force) override {
-    // We can not switch encodings beyond the first stripe.
     // We won't need to do any additional checks if we are already
     // using direct encodings.
-    if (!useDictionaryEncoding_ || !firstStripe_) {
+    if (!useDictionaryEncoding_) {
       return false;
     }
-
-    useDictionaryEncoding_ = shouldKeepDictionary() && !force;
+    if (force) {
+      abandonDictionary(DictionaryEncodingDecision::kForcedAbandon);
+      return true;
+    }
     // If we are still using dictionary encodings, we are not
     // performing an encoding switch.
-    if (useDictionaryEncoding_) {
+    if (shouldKeepDictionary()) {
       return false;
     }
-
-    initStreamWriters(useDictionaryEncoding_);
-    // Record direct encoding stream starting position.
-    recordDirectEncodingStreamPositions(0);
-    convertToDirectEncoding();
-    // Suppress the stream used to initialize dictionary encoder.
-    // TODO: passing factory method into the dict encoder also works
-    // around this problem but has messier code organization.
-    suppressStream(
-        StreamKind::StreamKind_DICTIONARY_DATA,
-        context_.shareFlatMapDictionaries ? 0 : sequence_);
-    dictEncoder_.clear();
-    rows_.clear();
-    strideOffsets_.clear();
+    abandonDictionary(DictionaryEncodingDecision::kAbandon);
     return true;
   }
 
@@ -431,6 +422,60 @@ class IntegerColumnWriter : public BaseColumnWriter {
         dictionaryKeySizeThreshold_;
   }
 
+  // Returns true if enough values are seen to tell that the dictionary won't
+  // meet the key size threshold at the end of the stripe.
+  bool shouldAbortDictionary() const {
+    auto totalElementCount = dictEncoder_.getTotalCount();
+    return earlyAbortRows_ > 0 && totalElementCount >= earlyAbortRows_ &&
+        dictEncoder_.size() > totalElementCount * dictionaryKeySizeThreshold_;
+  }
+
+  // Switches to direct encoding for the rest of the stripe, converting the
+  // values buffered so far, and frees the dictionary.
+  void abandonDictionary(DictionaryEncodingDecision decision) {
+    useDictionaryEncoding_ = false;
+    directStripes_ = 0;
+    // The dictionary encoding streams exist after the first stripe. The
+    // DICTIONARY_DATA stream belongs to the possibly shared dictionary
+    // encoder.
+    if (data_) {
+      data_.reset();
+      inDictionary_.reset();
+      removeStreams(
+          {StreamKind::StreamKind_DATA, StreamKind::StreamKind_IN_DICTIONARY});
+    }
+    initStreamWriters(useDictionaryEncoding_);
+    // Record direct encoding stream starting position.
+    recordDirectEncodingStreamPositions(0);
+    convertToDirectEncoding();
+    // Suppress the stream used to initialize dictionary encoder.
+    // TODO: passing factory method into the dict encoder also works
+    // around this problem but has messier code organization.
+    suppressStream(
+        StreamKind::StreamKind_DICTIONARY_DATA,
+        context_.shareFlatMapDictionaries ? 0 : sequence_);
+    dictEncoder_.clear();
+    rows_.clear();
+    strideOffsets_.clear();
+    context_.recordDictionaryEncodingDecision(decision);
+  }
+
+  // Switches back to dictionary encoding at the start of a stripe after
+  // 'retryInterval_' stripes of direct encoding. The streams are created at
+  // flush.
+  void maybeRetryDictionaryEncoding() {
+    if (useDictionaryEncoding_ || retryInterval_ == 0 ||
+        directStripes_ < retryInterval_ || !useDictionaryEncoding()) {
+      return;
+    }
+    dataDirect_.reset();
+    removeStreams({StreamKind::StreamKind_DATA});
+    useDictionaryEncoding_ = true;
+    directStripes_ = 0;
+    context_.recordDictionaryEncodingDecision(
+        DictionaryEncodingDecision::kRetry);
+  }
+
   // Should be called only once per stripe for both flushing and abandoning
   // dictionary encoding.
   void populateStrides(
@@ -478,11 +523,15 @@ class IntegerColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   const float dictionaryKeySizeThreshold_;
   const bool sort_;
-  // This value could change if we are writing with low memory mode or if we
-  // determine with the first stripe that the data is not fit for dictionary
-  // encoding.
+  const uint32_t earlyAbortRows_;
+  const uint32_t retryInterval_;
+  // This value changes when the dictionary is abandoned in low memory mode or
+  // because the data is not fit for dictionary encoding, and when dictionary
+  // encoding is retried.
   bool useDictionaryEncoding_;
-  bool firstStripe_{true};
+  // Number of stripes written with direct encoding since the dictionary was
+  // abandoned.
+  uint32_t directStripes_{0};
   DataBuffer<size_t> strideOffsets_;
 };
 
@@ -526,6 +575,9 @@ uint64_t IntegerColumnWriter<T>::writeDict(
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter_) {
+      bloomFilter_->addLong(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -568,6 +620,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
       ranges);
+  if (bloomFilter_) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter_->addLong(vals[pos]);
+      }
+    }
+  }
   auto rawSize = count * sizeof(T) + (ranges.size() - count) * NULL_SIZE;
   indexStatsBuilder_->increaseRawSize(rawSize);
   return rawSize;
@@ -837,9 +896,12 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        dictionaryKeySizeThreshold_{
+            getConfig(Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD)},
+        earlyAbortRows_{getConfig(Config::DICTIONARY_EARLY_ABORT_ROWS)},
+        retryInterval_{getConfig(Config::DICTIONARY_ENCODING_INTERVAL)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
-    DWIO_ENSURE(firstStripe_);
     if (!useDictionaryEncoding_) {
       initStreamWriters(useDictionaryEncoding_);
     }
@@ -853,6 +915,7 @@ class StringColumnWriter : public BaseColumnWriter {
     // time. We would defer recording all stream positions till then, and
     // only record position for PRESENT stream upon construction.
     BaseColumnWriter::recordPosition();
+    maybeRetryDictionaryEncoding();
     // Record starting position only for direct encoding because we don't know
     // until the next flush whether we need to write the IN_DICTIONARY stream.
     if (useDictionaryEncoding_) {
@@ -904,10 +967,8 @@ class StringColumnWriter : public BaseColumnWriter {
     } else {
       dataDirect_->flush();
       dataDirectLength_->flush();
+      ++directStripes_;
     }
-
-    // Start the new stripe.
-    firstStripe_ = false;
   }
 
   // FIXME: call base class set encoding first to deal with sequence and
@@ -935,16 +996,15 @@ class StringColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
-    // TODO: the only way useDictionaryEncoding_ right now is
-    // through abandonDictionary, so we already have the stream initialization
-    // handled. Might want to rethink stream initialization in the future when
-    // we support starting with low memory mode and switching encoding after
-    // first stripe.
     if (useDictionaryEncoding_) {
       // Record the stride boundaries so that we can backfill the stream
       // positions when actually writing the streams.
       strideOffsets_.append(rows_.size());
+      if (shouldAbortDictionary()) {
+        abandonDictionary(DictionaryEncodingDecision::kEarlyAbort);
+      }
     } else {
       recordDirectEncodingStreamPositions();
     }
@@ -971,24 +1031,17 @@ class StringColumnWriter : public BaseColumnWriter {
   }
 
   bool tryAbandonDictionaries(bool force) override {
-    // TODO: hopefully not required in the future, but need to solve the problem
-    // of replacing/deleting streams.
-    if (!useDictionaryEncoding_ || !firstStripe_) {
+    if (!useDictionaryEncoding_) {
       return false;
     }
-
-    useDictionaryEncoding_ = shouldKeepDictionary() && !force;
-    if (useDictionaryEncoding_) {
+    if (force) {
+      abandonDictionary(DictionaryEncodingDecision::kForcedAbandon);
+      return true;
+    }
+    if (shouldKeepDictionary()) {
       return false;
     }
-
-    initStreamWriters(useDictionaryEncoding_);
-    // Record direct encoding stream starting position.
-    recordDirectEncodingStreamPositions(0);
-    convertToDirectEncoding();
-    dictEncoder_.clear();
-    rows_.clear();
-    strideOffsets_.clear();
+    abandonDictionary(DictionaryEncodingDecision::kAbandon);
     return true;
   }
 
@@ -1068,6 +1121,63 @@ class StringColumnWriter : public BaseColumnWriter {
         encodingSelector_.useDictionary(dictEncoder_, rows_.size());
   }
 
+  // Returns true if enough values are seen to tell that the dictionary won't
+  // meet the key size threshold at the end of the stripe. The ratio of
+  // distinct values only goes down as values are added, but slowly once there
+  // are this many.
+  bool shouldAbortDictionary() const {
+    return earlyAbortRows_ > 0 && rows_.size() >= earlyAbortRows_ &&
+        dictEncoder_.size() > rows_.size() * dictionaryKeySizeThreshold_;
+  }
+
+  // Switches to direct encoding for the rest of the stripe, converting the
+  // values buffered so far, and frees the dictionary.
+  void abandonDictionary(DictionaryEncodingDecision decision) {
+    useDictionaryEncoding_ = false;
+    directStripes_ = 0;
+    // The dictionary encoding streams exist after the first stripe.
+    if (data_) {
+      data_.reset();
+      dictionaryData_.reset();
+      dictionaryDataLength_.reset();
+      inDictionary_.reset();
+      strideDictionaryData_.reset();
+      strideDictionaryDataLength_.reset();
+      removeStreams(
+          {StreamKind::StreamKind_DATA,
+           StreamKind::StreamKind_LENGTH,
+           StreamKind::StreamKind_DICTIONARY_DATA,
+           StreamKind::StreamKind_IN_DICTIONARY,
+           StreamKind::StreamKind_STRIDE_DICTIONARY,
+           StreamKind::StreamKind_STRIDE_DICTIONARY_LENGTH});
+    }
+    initStreamWriters(useDictionaryEncoding_);
+    // Record direct encoding stream starting position.
+    recordDirectEncodingStreamPositions(0);
+    convertToDirectEncoding();
+    dictEncoder_.clear();
+    rows_.clear();
+    strideOffsets_.clear();
+    context_.recordDictionaryEncodingDecision(decision);
+  }
+
+  // Switches back to dictionary encoding at the start of a stripe after
+  // 'retryInterval_' stripes of direct encoding. The streams are created at
+  // flush.
+  void maybeRetryDictionaryEncoding() {
+    if (useDictionaryEncoding_ || retryInterval_ == 0 ||
+        directStripes_ < retryInterval_ || !useDictionaryEncoding()) {
+      return;
+    }
+    dataDirect_.reset();
+    dataDirectLength_.reset();
+    removeStreams({StreamKind::StreamKind_DATA, StreamKind::StreamKind_LENGTH});
+    useDictionaryEncoding_ = true;
+    directStripes_ = 0;
+    context_.recordDictionaryEncodingDecision(
+        DictionaryEncodingDecision::kRetry);
+  }
+
   // Should be called only once per stripe for both flushing and abandoning
   // dictionary encoding.
   void populateStrides(
@@ -1123,11 +1233,16 @@ class StringColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   EntropyEncodingSelector encodingSelector_;
   const bool sort_;
-  // This value could change if we are writing with low memory mode or if we
-  // determine with the first stripe that the data is not fit for dictionary
-  // encoding.
+  const float dictionaryKeySizeThreshold_;
+  const uint32_t earlyAbortRows_;
+  const uint32_t retryInterval_;
+  // This value changes when the dictionary is abandoned in low memory mode or
+  // because the data is not fit for dictionary encoding, and when dictionary
+  // encoding is retried.
   bool useDictionaryEncoding_;
-  bool firstStripe_{true};
+  // Number of stripes written with direct encoding since the dictionary was
+  // abandoned.
+  uint32_t directStripes_{0};
   DataBuffer<size_t> strideOffsets_;
 };
 
@@ -1158,6 +1273,9 @@ uint64_t StringColumnWriter::writeDict(
     auto sp = decodedVector.valueAt<StringView>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(std::string_view(sp.data(), sp.size()));
+    }
     rawSize += sp.size();
   };
 
@@ -1203,6 +1321,9 @@ uint64_t StringColumnWriter::writeDirect(
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(std::string_view(sp.data(), size));
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1663,7 +1784,26 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
     const common::Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
-  if (ranges.size() > 0) {
+  if (ranges.size() > 0 && isRoot() && context_.parallelEncoding() &&
+      children_.size() > 1) {
+    // The top level columns have separate streams, so these are encoded and
+    // compressed concurrently. The stripe layout does not depend on the order
+    // in which the streams are written.
+    for (size_t i = 0; i < children_.size(); ++i) {
+      // Lazy columns may share a reader, so these are loaded one at a time.
+      rowSlice->childAt(i)->loadedVector();
+    }
+    std::vector<uint64_t> childRawSizes(children_.size());
+    dwio::common::runInParallel(
+        context_.encodingExecutor(),
+        context_.encodingParallelism(),
+        children_.size(),
+        [&](int32_t i) {
+          childRawSizes[i] = children_[i]->write(rowSlice->childAt(i), ranges);
+        });
+    rawSize = std::accumulate(
+        childRawSizes.begin(), childRawSizes.end(), uint64_t{0});
+  } else if (ranges.size() > 0) {
     for (size_t i = 0; i < children_.size(); ++i) {
       rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
     }
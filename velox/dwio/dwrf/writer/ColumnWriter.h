@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/common/base/GTestMacros.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -84,6 +85,7 @@ class BaseColumnWriter : public ColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_, /*ignoreSize=*/true);
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     recordPosition();
     for (auto& child : children_) {
       child->createIndexEntry();
@@ -117,6 +119,11 @@ class BaseColumnWriter : public ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilter_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterStream_.get());
+      bloomFilterStream_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   uint64_t writeFileStats(std::function<proto::ColumnStatistics&(uint32_t)>
@@ -171,6 +178,11 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (shouldWriteBloomFilter()) {
+      bloomFilter_ = std::make_unique<BloomFilter>(
+          context_.indexStride, getConfig(Config::BLOOM_FILTER_FPP));
+      bloomFilterStream_ = newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8);
+    }
 
     if (format_ == dwrf::DwrfFormat::kDwrf) {
       VELOX_CHECK(rleVersion_ == velox::dwrf::RleVersion_1);
@@ -227,6 +239,15 @@ class BaseColumnWriter : public ColumnWriter {
     return id_ == 0;
   }
 
+  // Adds the bloom filter of the current stride to the bloom filter index and
+  // starts a new one for the next stride.
+  void addBloomFilterEntry() {
+    if (bloomFilter_) {
+      bloomFilter_->serialize(*bloomFilterIndex_.add_bloomfilter());
+      bloomFilter_->reset();
+    }
+  }
+
   std::unique_ptr<BufferedOutputStream> newStream(StreamKind kind) {
     return context_.newStream(
         DwrfStreamIdentifier{id_, sequence_, type_.column, kind});
@@ -241,6 +262,17 @@ class BaseColumnWriter : public ColumnWriter {
     suppressStream(kind, sequence_);
   }
 
+  // Removes the streams of 'kinds' of this column so that they can be created
+  // again for another encoding. The encoders writing to them must be destroyed
+  // first.
+  void removeStreams(const std::vector<StreamKind>& kinds) {
+    context_.removeStreams([&](const DwrfStreamIdentifier& stream) {
+      return stream.encodingKey().node == id_ &&
+          stream.encodingKey().sequence == sequence_ &&
+          std::find(kinds.begin(), kinds.end(), stream.kind()) != kinds.end();
+    });
+  }
+
   template <typename T>
   T getConfig(const Config::Entry<T>& config) const {
     return context_.getConfig(config);
@@ -254,6 +286,27 @@ class BaseColumnWriter : public ColumnWriter {
     return context_.isIndexEnabled;
   }
 
+  // Bloom filters are written for the integer and string top level columns
+  // listed in Config::BLOOM_FILTER_COLUMNS, if the index is written.
+  bool shouldWriteBloomFilter() const {
+    if (!isIndexEnabled() || sequence_ != 0 || type_.parent == nullptr ||
+        type_.parent->id != 0) {
+      return false;
+    }
+    switch (type_.type->kind()) {
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+        break;
+      default:
+        return false;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLUMNS);
+    return std::find(columns.begin(), columns.end(), type_.column) !=
+        columns.end();
+  }
+
   virtual bool useDictionaryEncoding() const {
     if (format_ == velox::dwrf::DwrfFormat::kDwrf) {
       return (sequence_ == 0 ||
@@ -276,6 +329,10 @@ class BaseColumnWriter : public ColumnWriter {
   std::unique_ptr<IndexBuilder> indexBuilder_;
   std::unique_ptr<StatisticsBuilder> indexStatsBuilder_;
   std::unique_ptr<StatisticsBuilder> fileStatsBuilder_;
+  // Set if the writer adds its values to a bloom filter per index stride.
+  std::unique_ptr<BloomFilter> bloomFilter_;
+  proto::BloomFilterIndex bloomFilterIndex_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterStream_;
 
   std::unique_ptr<ByteRleEncoder> present_;
   bool hasNull_ = false;
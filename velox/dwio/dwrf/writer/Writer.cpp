@@ -350,8 +350,8 @@ void Writer::setLowMemoryMode() {
 // pressure because the switch consumes even more memory than a flush.
 void Writer::enterLowMemoryMode() {
   auto& context = getContext();
-  // Until we have capability to abandon dictionary after the first
-  // stripe, do nothing and rely solely on flush to comply with budget.
+  // Past the first stripe, do nothing and rely solely on flush to comply with
+  // budget, since the switch needs more memory than a flush.
   if (UNLIKELY(context.checkLowMemoryMode() && context.stripeIndex == 0)) {
     // Idempotent call to switch to less memory intensive encodings.
     writer_->tryAbandonDictionaries(true);
@@ -639,7 +639,15 @@ void Writer::flushInternal(bool close) {
                     .getCurrentBytes(),
             .generalMemory =
                 context.getMemoryUsage(MemoryUsageCategory::GENERAL)
-                    .getCurrentBytes()});
+                    .getCurrentBytes(),
+            .numDictionaryEarlyAborts = context.dictionaryEncodingDecisions(
+                DictionaryEncodingDecision::kEarlyAbort),
+            .numDictionaryAbandons = context.dictionaryEncodingDecisions(
+                DictionaryEncodingDecision::kAbandon),
+            .numDictionaryForcedAbandons = context.dictionaryEncodingDecisions(
+                DictionaryEncodingDecision::kForcedAbandon),
+            .numDictionaryRetries = context.dictionaryEncodingDecisions(
+                DictionaryEncodingDecision::kRetry)});
   }
 }
 
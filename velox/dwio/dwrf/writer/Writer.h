@@ -120,6 +120,17 @@ struct WriterOptions {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // Executor and max number of concurrent tasks for encoding and compressing
+  // the top level columns of each batch. The calling thread runs one of the
+  // tasks. The columns are encoded serially if there is no executor, if the
+  // parallelism is 1 or if the file is encrypted.
+  std::shared_ptr<folly::Executor> encodingExecutor;
+  int32_t encodingParallelism = 1;
+  // Trained ZSTD dictionaries by top level column, e.g. made with
+  // trainZstdDictionary() from sample values. The streams of a column with a
+  // dictionary must be ZSTD compressed, see Config::COLUMN_COMPRESSION. The
+  // dictionaries are stored in the footer.
+  std::unordered_map<uint32_t, std::string> zstdDictionaries;
   std::function<std::unique_ptr<ColumnWriter>(
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
@@ -144,6 +155,14 @@ class Writer : public WriterBase {
     initContext(options.config, std::move(pool), std::move(handler));
     auto& context = getContext();
     context.buildPhysicalSizeAggregators(*schema_);
+    context.buildColumnCompression(*schema_, options.zstdDictionaries);
+    // Encrypters may be shared between columns.
+    if (options.encodingExecutor && options.encodingParallelism > 1 &&
+        !context.getEncryptionHandler().isEncrypted()) {
+      encodingExecutor_ = options.encodingExecutor;
+      context.setEncodingExecutor(
+          encodingExecutor_.get(), options.encodingParallelism);
+    }
     if (!options.flushPolicyFactory) {
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
           context.stripeSizeFlushThreshold,
@@ -215,6 +234,8 @@ class Writer : public WriterBase {
   }
 
   const std::shared_ptr<const dwio::common::TypeWithId> schema_;
+  // Keeps the executor of the context alive.
+  std::shared_ptr<folly::Executor> encodingExecutor_;
   std::unique_ptr<DWRFFlushPolicy> flushPolicy_;
   std::function<
       std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
@@ -49,6 +49,15 @@ void WriterBase::writeFooter(const Type& type) {
     // file does not have rawSize.
     footer_.set_rawdatasize(context_->fileRawSize);
   }
+  for (const auto& [node, column] : context_->columnCompressions()) {
+    auto* columnCompression = footer_.add_columncompression();
+    columnCompression->set_node(node);
+    columnCompression->set_kind(
+        static_cast<proto::CompressionKind>(column->kind));
+    if (column->dictionary) {
+      columnCompression->set_zstddictionary(column->dictionary->data());
+    }
+  }
   auto checksum = writerSink_->getChecksum();
   footer_.set_checksumalgorithm(
       checksum ? checksum->getType() : proto::ChecksumAlgorithm::NULL_);
@@ -62,8 +71,7 @@ void WriterBase::writeFooter(const Type& type) {
   ps.set_footerlength(footerLength);
   ps.set_compression(
       static_cast<proto::CompressionKind>(context_->compression));
-  if (context_->compression !=
-      dwio::common::CompressionKind::CompressionKind_NONE) {
+  if (context_->hasCompression()) {
     ps.set_compressionblocksize(context_->compressionBlockSize);
   }
   ps.set_cachemode(
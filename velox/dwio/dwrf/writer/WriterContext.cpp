@@ -38,4 +38,56 @@ void WriterContext::validateConfigs() const {
       MIN_PAGE_GROW_RATIO);
 }
 
+void WriterContext::buildColumnCompression(
+    const velox::dwio::common::TypeWithId& schema,
+    const std::unordered_map<uint32_t, std::string>& zstdDictionaries) {
+  const auto& kinds = getConfig(Config::COLUMN_COMPRESSION);
+  const auto& levels = getConfig(Config::COLUMN_COMPRESSION_LEVEL);
+  for (auto i = 0; i < schema.size(); ++i) {
+    const auto& column = *schema.childAt(i);
+    auto kindIt = kinds.find(column.column);
+    auto levelIt = levels.find(column.column);
+    auto dictionaryIt = zstdDictionaries.find(column.column);
+    if (kindIt == kinds.end() && levelIt == levels.end() &&
+        dictionaryIt == zstdDictionaries.end()) {
+      continue;
+    }
+    auto columnCompression = std::make_shared<ColumnCompression>();
+    columnCompression->kind =
+        kindIt == kinds.end() ? compression : kindIt->second;
+    const auto kind = columnCompression->kind;
+    DWIO_ENSURE(
+        kind == dwio::common::CompressionKind_NONE ||
+            kind == dwio::common::CompressionKind_ZLIB ||
+            kind == dwio::common::CompressionKind_ZSTD,
+        "Unsupported compression of column ",
+        column.column,
+        ": ",
+        dwio::common::compressionKindToString(kind));
+    if (levelIt != levels.end()) {
+      columnCompression->level = levelIt->second;
+    }
+    if (dictionaryIt != zstdDictionaries.end() &&
+        !dictionaryIt->second.empty()) {
+      DWIO_ENSURE_EQ(
+          kind,
+          dwio::common::CompressionKind_ZSTD,
+          "ZSTD dictionary for column ",
+          column.column,
+          " that is not ZSTD compressed");
+      columnCompression->dictionary =
+          std::make_shared<ZstdDictionary>(dictionaryIt->second);
+    }
+    columnCompressions_.emplace_back(column.id, columnCompression);
+    std::function<void(const velox::dwio::common::TypeWithId&)> addNodes =
+        [&](const auto& node) {
+          nodeCompression_[node.id] = columnCompression;
+          for (auto j = 0; j < node.size(); ++j) {
+            addNodes(*node.childAt(j));
+          }
+        };
+    addNodes(column);
+  }
+}
+
 } // namespace facebook::velox::dwrf
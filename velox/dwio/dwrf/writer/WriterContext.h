@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <array>
+#include <atomic>
 #include <limits>
+#include <mutex>
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -32,6 +36,21 @@ namespace facebook::velox::dwrf {
 
 enum class MemoryUsageCategory { DICTIONARY, OUTPUT_STREAM, GENERAL };
 
+// Reasons for which the column writers switch between dictionary and direct
+// encoding.
+enum class DictionaryEncodingDecision {
+  // Abandoned before the end of the stripe because the ratio of distinct
+  // values already exceeded the key size threshold.
+  kEarlyAbort,
+  // Abandoned because the dictionary was not efficient for the stripe.
+  kAbandon,
+  // Abandoned regardless of efficiency, e.g. to reduce memory usage.
+  kForcedAbandon,
+  // Dictionary encoding retried after stripes of direct encoding.
+  kRetry,
+  kNumDecisions,
+};
+
 class WriterContext : public CompressionBufferPool {
  public:
   WriterContext(
@@ -72,8 +91,9 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(
+        std::make_unique<dwio::common::DataBuffer<char>>(
+            *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -98,8 +118,12 @@ class WriterContext : public CompressionBufferPool {
   // so accounting for the memory usage can be inflated even aside from the
   // capacity vs actual usage problem. However, this is ok as an upperbound for
   // flush policy evaluation and would be more accurate after flush.
+  //
+  // Flat map writers add streams for new keys while writing, possibly
+  // concurrently with the writers of other columns.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
+    std::unique_lock<std::mutex> lock(streamsMutex_);
     DWIO_ENSURE(
         !hasStream(stream), "Stream already exists ", stream.toString());
     streams_.emplace(
@@ -111,10 +135,21 @@ class WriterContext : public CompressionBufferPool {
             getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
             getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
     auto& holder = streams_.at(stream);
+    lock.unlock();
     auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
         ? std::addressof(
               handler_->getEncryptionProvider(stream.encodingKey().node))
         : nullptr;
+    if (const auto* column = columnCompression(stream.encodingKey().node)) {
+      return createCompressor(
+          column->kind,
+          *this,
+          holder,
+          *config_,
+          encrypter,
+          column->level,
+          column->dictionary.get());
+    }
     return newStream(compression, holder, encrypter);
   }
 
@@ -140,6 +175,7 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    std::lock_guard<std::mutex> l(dictEncodersMutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -177,11 +213,50 @@ class WriterContext : public CompressionBufferPool {
   }
 
   bool isStreamPaged(uint32_t nodeId) const {
-    return (compression !=
+    return (compressionKind(nodeId) !=
             dwio::common::CompressionKind::CompressionKind_NONE) ||
         handler_->isEncrypted(nodeId);
   }
 
+  // Sets up the codecs of the top level columns in Config::COLUMN_COMPRESSION
+  // and Config::COLUMN_COMPRESSION_LEVEL. 'zstdDictionaries' are trained ZSTD
+  // dictionaries by top level column.
+  void buildColumnCompression(
+      const velox::dwio::common::TypeWithId& schema,
+      const std::unordered_map<uint32_t, std::string>& zstdDictionaries);
+
+  // Returns the codec of the streams of 'nodeId' or nullptr if they use the
+  // codec of the file.
+  const ColumnCompression* columnCompression(uint32_t nodeId) const {
+    auto it = nodeCompression_.find(nodeId);
+    return it == nodeCompression_.end() ? nullptr : it->second.get();
+  }
+
+  dwio::common::CompressionKind compressionKind(uint32_t nodeId) const {
+    const auto* column = columnCompression(nodeId);
+    return column ? column->kind : compression;
+  }
+
+  // The node ids of the top level columns with their own codec and the
+  // codecs.
+  const std::vector<
+      std::pair<uint32_t, std::shared_ptr<const ColumnCompression>>>&
+  columnCompressions() const {
+    return columnCompressions_;
+  }
+
+  // Returns true if any stream of the file is compressed.
+  bool hasCompression() const {
+    return compression != dwio::common::CompressionKind::CompressionKind_NONE ||
+        std::any_of(
+               columnCompressions_.begin(),
+               columnCompressions_.end(),
+               [](const auto& column) {
+                 return column.second->kind !=
+                     dwio::common::CompressionKind::CompressionKind_NONE;
+               });
+  }
+
   void nextStripe() {
     fileRowCount += stripeRowCount;
     rowsPerStripe.push_back(stripeRowCount);
@@ -289,6 +364,7 @@ class WriterContext : public CompressionBufferPool {
 
   virtual void removeStreams(
       std::function<bool(const DwrfStreamIdentifier&)> predicate) {
+    std::unique_lock<std::mutex> lock(streamsMutex_);
     auto it = streams_.begin();
     while (it != streams_.end()) {
       if (predicate(it->first)) {
@@ -299,18 +375,31 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Columns encoded in parallel compress concurrently, each with its own
+  // buffer. There is one buffer per concurrent compression.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer;
+    {
+      std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
+      if (!compressionBuffers_.empty()) {
+        buffer = std::move(compressionBuffers_.back());
+        compressionBuffers_.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = std::make_unique<dwio::common::DataBuffer<char>>(
+          *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    }
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
+    compressionBuffers_.push_back(std::move(buffer));
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -390,6 +479,19 @@ class WriterContext : public CompressionBufferPool {
     return lowMemoryMode_;
   }
 
+  // Called by the column writers, possibly from the threads encoding columns
+  // in parallel.
+  void recordDictionaryEncodingDecision(DictionaryEncodingDecision decision) {
+    ++dictionaryEncodingDecisions_[static_cast<int32_t>(decision)];
+  }
+
+  // Returns the number of times the column writers switched encodings for
+  // 'decision'.
+  uint64_t dictionaryEncodingDecisions(
+      DictionaryEncodingDecision decision) const {
+    return dictionaryEncodingDecisions_[static_cast<int32_t>(decision)];
+  }
+
   PhysicalSizeAggregator& getPhysicalSizeAggregator(uint32_t node) {
     return *physicalSizeAggregators_.at(node);
   }
@@ -486,19 +588,56 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  // Returns a reusable SelectivityVector of 'size' rows. Must be returned
+  // with releaseSelectivityVector().
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
+      velox::vector_size_t size) {
+    std::unique_ptr<velox::SelectivityVector> vector;
+    {
+      std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
+      if (!selectivityVectorPool_.empty()) {
+        vector = std::move(selectivityVectorPool_.back());
+        selectivityVectorPool_.pop_back();
+      }
     }
-    return *selectivityVector_;
+    if (!vector) {
+      return std::make_unique<velox::SelectivityVector>(size);
+    }
+    vector->resize(size);
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
+  }
+
+  // Sets the executor and the max number of concurrent tasks to encode the
+  // top level columns of a batch. The calling thread runs one of the tasks.
+  void setEncodingExecutor(folly::Executor* executor, int32_t parallelism) {
+    encodingExecutor_ = executor;
+    encodingParallelism_ = parallelism;
+  }
+
+  folly::Executor* encodingExecutor() const {
+    return encodingExecutor_;
+  }
+
+  int32_t encodingParallelism() const {
+    return encodingParallelism_;
+  }
+
+  // True if the top level columns are encoded in parallel.
+  bool parallelEncoding() const {
+    return encodingExecutor_ && encodingParallelism_ > 1;
   }
 
  private:
   void validateConfigs() const;
 
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -508,6 +647,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(vectorsAndBuffersMutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
@@ -523,21 +663,36 @@ class WriterContext : public CompressionBufferPool {
       DataBufferHolder,
       dwio::common::StreamIdentifierHash>
       streams_;
+  // Serializes adding streams while writing columns in parallel.
+  std::mutex streamsMutex_;
   folly::F14NodeMap<uint32_t, std::unique_ptr<PhysicalSizeAggregator>>
       physicalSizeAggregators_;
+  std::vector<std::pair<uint32_t, std::shared_ptr<const ColumnCompression>>>
+      columnCompressions_;
+  // The codecs of the nodes of the columns in 'columnCompressions_'.
+  folly::F14FastMap<uint32_t, std::shared_ptr<const ColumnCompression>>
+      nodeCompression_;
   folly::F14FastMap<
       EncodingKey,
       std::unique_ptr<AbstractIntegerDictionaryEncoder>,
       EncodingKeyHash>
       dictEncoders_;
+  std::mutex dictEncodersMutex_;
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Guards the pools of compression buffers, DecodedVectors and
+  // SelectivityVectors, which columns encoded in parallel share.
+  std::mutex vectorsAndBuffersMutex_;
+  // A pool of reusable compression buffers.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  // A pool of reusable SelectivityVectors.
+  std::vector<std::unique_ptr<velox::SelectivityVector>> selectivityVectorPool_;
+  folly::Executor* encodingExecutor_{nullptr};
+  int32_t encodingParallelism_{1};
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
@@ -548,6 +703,10 @@ class WriterContext : public CompressionBufferPool {
   AverageRowSizeTracker rowSizeTracker_;
   bool checkLowMemoryMode_;
   bool lowMemoryMode_{false};
+  std::array<
+      std::atomic<uint64_t>,
+      static_cast<int32_t>(DictionaryEncodingDecision::kNumDecisions)>
+      dictionaryEncodingDecisions_{};
 
  public:
   // stats
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+constexpr uint32_t kSalts[] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// The headers are small thrift structs. Reading this many bytes from the
+// start of a filter covers the header without knowing its size.
+constexpr uint64_t kHeaderSizeGuess = 64;
+
+// Filters larger than this are considered corrupt. Writers cap filters at
+// 128MB.
+constexpr int32_t kMaxBloomFilterBytes = 128 << 20;
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(
+    const char* bitset,
+    int32_t numBytes)
+    : numBlocks_(numBytes / kBytesPerBlock) {
+  VELOX_CHECK(
+      numBytes > 0 && numBytes % kBytesPerBlock == 0,
+      "Bad bloom filter size: {}",
+      numBytes);
+  bitset_.resize(numBytes / sizeof(uint32_t));
+  memcpy(bitset_.data(), bitset, numBytes);
+}
+
+bool SplitBlockBloomFilter::mayContain(uint64_t hash) const {
+  const auto* block = bitset_.data() + blockStart(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    if (!(block[i] & (1U << ((key * kSalts[i]) >> 27)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SplitBlockBloomFilter::insert(uint64_t hash) {
+  auto* block = bitset_.data() + blockStart(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    block[i] |= 1U << ((key * kSalts[i]) >> 27);
+  }
+}
+
+uint64_t SplitBlockBloomFilter::hash(int32_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+uint64_t SplitBlockBloomFilter::hash(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+uint64_t SplitBlockBloomFilter::hash(std::string_view value) {
+  return XXH64(value.data(), value.size(), 0);
+}
+
+std::vector<std::unique_ptr<SplitBlockBloomFilter>> readBloomFilters(
+    const std::vector<int64_t>& offsets,
+    const dwio::common::BufferedInput& input) {
+  const uint64_t fileSize = input.getReadFile()->size();
+  auto headerInput = input.clone();
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams;
+  std::vector<uint64_t> headerLengths;
+  streams.reserve(offsets.size());
+  headerLengths.reserve(offsets.size());
+  for (auto offset : offsets) {
+    VELOX_CHECK(
+        offset >= 0 && offset < fileSize,
+        "Bad bloom filter offset: {}",
+        offset);
+    headerLengths.push_back(std::min(kHeaderSizeGuess, fileSize - offset));
+    streams.push_back(headerInput->enqueue(
+        {static_cast<uint64_t>(offset), headerLengths.back()}));
+  }
+  headerInput->load(dwio::common::LogType::STRIPE_INDEX);
+
+  std::vector<thrift::BloomFilterHeader> headers(offsets.size());
+  std::vector<uint32_t> headerSizes(offsets.size());
+  std::vector<char> buffer(kHeaderSizeGuess);
+  for (auto i = 0; i < offsets.size(); ++i) {
+    streams[i]->readFully(buffer.data(), headerLengths[i]);
+    auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+        buffer.data(), headerLengths[i]);
+    apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+        protocol(transport);
+    headerSizes[i] = headers[i].read(&protocol);
+  }
+
+  auto bitsetInput = input.clone();
+  streams.clear();
+  streams.resize(offsets.size());
+  for (auto i = 0; i < offsets.size(); ++i) {
+    const auto& header = headers[i];
+    if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+        !header.compression.__isset.UNCOMPRESSED) {
+      continue;
+    }
+    const uint64_t bitsetOffset = offsets[i] + headerSizes[i];
+    VELOX_CHECK(
+        header.numBytes > 0 && header.numBytes <= kMaxBloomFilterBytes &&
+            bitsetOffset + header.numBytes <= fileSize,
+        "Bad bloom filter size: {}",
+        header.numBytes);
+    streams[i] = bitsetInput->enqueue(
+        {bitsetOffset, static_cast<uint64_t>(header.numBytes)});
+  }
+  bitsetInput->load(dwio::common::LogType::STRIPE_INDEX);
+
+  std::vector<std::unique_ptr<SplitBlockBloomFilter>> filters(offsets.size());
+  for (auto i = 0; i < offsets.size(); ++i) {
+    if (!streams[i]) {
+      continue;
+    }
+    buffer.resize(headers[i].numBytes);
+    streams[i]->readFully(buffer.data(), buffer.size());
+    filters[i] = std::make_unique<SplitBlockBloomFilter>(
+        buffer.data(), headers[i].numBytes);
+  }
+  return filters;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+
+#include <string_view>
+
+namespace facebook::velox::parquet {
+
+// The split block bloom filter of a Parquet column chunk. The bitset is an
+// array of 256 bit blocks. A value selects a block by the high 32 bits of its
+// xxHash64 and sets one bit in each of the 8 32 bit words of the block by the
+// low 32 bits of the hash.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  // 'numBytes' must be a positive multiple of kBytesPerBlock.
+  SplitBlockBloomFilter(const char* bitset, int32_t numBytes);
+
+  // Returns false if no value with 'hash' was inserted.
+  bool mayContain(uint64_t hash) const;
+
+  // Sets the bits for 'hash'. Used for testing.
+  void insert(uint64_t hash);
+
+  // Returns the hash of a value as computed by the writer, i.e. of the PLAIN
+  // encoding of the value without the length of strings.
+  static uint64_t hash(int32_t value);
+  static uint64_t hash(int64_t value);
+  static uint64_t hash(std::string_view value);
+
+  const std::vector<uint32_t>& bitset() const {
+    return bitset_;
+  }
+
+ private:
+  static constexpr int32_t kWordsPerBlock = 8;
+
+  // Returns the first word of the block for 'hash'.
+  int64_t blockStart(uint64_t hash) const {
+    return (((hash >> 32) * numBlocks_) >> 32) * kWordsPerBlock;
+  }
+
+  std::vector<uint32_t> bitset_;
+  const uint64_t numBlocks_;
+};
+
+// Reads the bloom filters at 'offsets' from 'input'. The headers of all
+// filters are fetched in one coalesced load and the bitsets in another. The
+// result has an element per offset, nullptr if the filter is not a split
+// block filter of xxHash64 hashes stored uncompressed.
+std::vector<std::unique_ptr<SplitBlockBloomFilter>> readBloomFilters(
+    const std::vector<int64_t>& offsets,
+    const dwio::common::BufferedInput& input);
+
+} // namespace facebook::velox::parquet
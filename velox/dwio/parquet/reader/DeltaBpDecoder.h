@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/dwio/common/BitPackDecoder.h"
+
+#include <folly/Varint.h>
+
+namespace facebook::velox::parquet {
+
+// Decodes DELTA_BINARY_PACKED data. The data starts with a header of the
+// block size, the number of miniblocks per block, the total number of values
+// and the first value. Each block that follows is the min delta of the block,
+// the bit widths of its miniblocks and the miniblocks of bit packed deltas
+// from the min delta. Since each value depends on the previous one, the values
+// are decoded all at once with decode(). The miniblocks are unpacked with the
+// SIMD bit unpacking of dwio::common::unpack().
+class DeltaBpDecoder {
+ public:
+  DeltaBpDecoder(const char* FOLLY_NONNULL start, const char* FOLLY_NONNULL end)
+      : bufferStart_(start), bufferEnd_(end) {
+    blockSize_ = readVarint();
+    numMiniblocks_ = readVarint();
+    numValues_ = readVarint();
+    firstValue_ = readZigZagVarint();
+    VELOX_CHECK(
+        numMiniblocks_ > 0 && blockSize_ % numMiniblocks_ == 0,
+        "Bad DELTA_BINARY_PACKED header");
+    valuesPerMiniblock_ = blockSize_ / numMiniblocks_;
+    VELOX_CHECK_EQ(
+        valuesPerMiniblock_ % 8, 0, "Bad DELTA_BINARY_PACKED miniblock size");
+  }
+
+  // Returns the number of encoded values.
+  int64_t numValues() const {
+    return numValues_;
+  }
+
+  // Decodes all values into 'result', which must have space for numValues()
+  // elements. T is int32_t or int64_t.
+  template <typename T>
+  void decode(T* FOLLY_NONNULL result) {
+    using U = std::make_unsigned_t<T>;
+    if (numValues_ == 0) {
+      return;
+    }
+    // The arithmetic wraps around as in the writer.
+    U value = static_cast<U>(firstValue_);
+    result[0] = static_cast<T>(value);
+    int64_t numDecoded = 1;
+    while (numDecoded < numValues_) {
+      const U minDelta = static_cast<U>(readZigZagVarint());
+      VELOX_CHECK_LE(
+          bufferStart_ + numMiniblocks_,
+          bufferEnd_,
+          "Truncated DELTA_BINARY_PACKED data");
+      const auto* bitWidths = reinterpret_cast<const uint8_t*>(bufferStart_);
+      bufferStart_ += numMiniblocks_;
+      for (auto i = 0; i < numMiniblocks_ && numDecoded < numValues_; ++i) {
+        const auto bitWidth = bitWidths[i];
+        VELOX_CHECK_LE(bitWidth, sizeof(T) * 8);
+        const auto numMiniblockValues =
+            std::min<int64_t>(valuesPerMiniblock_, numValues_ - numDecoded);
+        T* output = result + numDecoded;
+        if (bitWidth == 0) {
+          for (auto j = 0; j < numMiniblockValues; ++j) {
+            value += minDelta;
+            output[j] = static_cast<T>(value);
+          }
+        } else if (bitWidth <= 32) {
+          unpackMiniblock32(bitWidth);
+          for (auto j = 0; j < numMiniblockValues; ++j) {
+            value += minDelta + static_cast<U>(deltas32_[j]);
+            output[j] = static_cast<T>(value);
+          }
+        } else {
+          unpackMiniblock64(bitWidth);
+          for (auto j = 0; j < numMiniblockValues; ++j) {
+            value += minDelta + static_cast<U>(deltas64_[j]);
+            output[j] = static_cast<T>(value);
+          }
+        }
+        bufferStart_ += miniblockBytes(bitWidth);
+        numDecoded += numMiniblockValues;
+      }
+    }
+  }
+
+  // Returns the first byte after the encoded data. Valid after decode().
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferStart_;
+  }
+
+ private:
+  uint64_t readVarint() {
+    folly::ByteRange range(
+        reinterpret_cast<const uint8_t*>(bufferStart_),
+        reinterpret_cast<const uint8_t*>(bufferEnd_));
+    const auto value = folly::decodeVarint(range);
+    bufferStart_ = reinterpret_cast<const char*>(range.begin());
+    return value;
+  }
+
+  int64_t readZigZagVarint() {
+    return folly::decodeZigZag(readVarint());
+  }
+
+  // Returns the byte size of a miniblock of 'bitWidth' bit deltas. The last
+  // miniblock is padded to full size.
+  uint64_t miniblockBytes(uint8_t bitWidth) const {
+    const uint64_t numBytes =
+        static_cast<uint64_t>(bitWidth) * valuesPerMiniblock_ / 8;
+    VELOX_CHECK_LE(
+        bufferStart_ + numBytes,
+        bufferEnd_,
+        "Truncated DELTA_BINARY_PACKED data");
+    return numBytes;
+  }
+
+  // Unpacks the miniblock at 'bufferStart_' into 'deltas32_'.
+  void unpackMiniblock32(uint8_t bitWidth) {
+    deltas32_.resize(valuesPerMiniblock_);
+    const auto* input = reinterpret_cast<const uint8_t*>(bufferStart_);
+    auto* output = deltas32_.data();
+    dwio::common::unpack<uint32_t>(
+        input, miniblockBytes(bitWidth), valuesPerMiniblock_, bitWidth, output);
+  }
+
+  // Unpacks the miniblock at 'bufferStart_' into 'deltas64_'. Used for bit
+  // widths over 32, which only occur with 64 bit values.
+  void unpackMiniblock64(uint8_t bitWidth) {
+    deltas64_.resize(valuesPerMiniblock_);
+    const auto* input = reinterpret_cast<const uint8_t*>(bufferStart_);
+    const uint64_t mask = bitWidth == 64 ? ~0ULL : (1ULL << bitWidth) - 1;
+    for (auto i = 0; i < valuesPerMiniblock_; ++i) {
+      const uint64_t bitOffset = static_cast<uint64_t>(i) * bitWidth;
+      const auto shift = bitOffset % 8;
+      uint64_t words[2] = {0, 0};
+      memcpy(words, input + bitOffset / 8, (shift + bitWidth + 7) / 8);
+      uint64_t delta = words[0] >> shift;
+      if (shift != 0) {
+        delta |= words[1] << (64 - shift);
+      }
+      deltas64_[i] = delta & mask;
+    }
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL const bufferEnd_;
+  uint64_t blockSize_;
+  uint64_t numMiniblocks_;
+  uint64_t valuesPerMiniblock_;
+  int64_t numValues_;
+  int64_t firstValue_;
+  // Unpacked deltas of the current miniblock.
+  std::vector<uint32_t> deltas32_;
+  std::vector<uint64_t> deltas64_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+
+namespace facebook::velox::parquet {
+
+void removeRowRange(RowRanges& ranges, int64_t begin, int64_t end) {
+  RowRanges result;
+  result.reserve(ranges.size() + 1);
+  for (const auto& [first, second] : ranges) {
+    if (second <= begin || first >= end) {
+      result.emplace_back(first, second);
+      continue;
+    }
+    if (first < begin) {
+      result.emplace_back(first, begin);
+    }
+    if (second > end) {
+      result.emplace_back(end, second);
+    }
+  }
+  ranges = std::move(result);
+}
+
+bool overlapsRowRanges(const RowRanges& ranges, int64_t begin, int64_t end) {
+  auto it = std::upper_bound(
+      ranges.begin(),
+      ranges.end(),
+      begin,
+      [](int64_t row, const std::pair<int64_t, int64_t>& range) {
+        return row < range.second;
+      });
+  return it != ranges.end() && it->first < end;
+}
+
+PageIndex::PageIndex(
+    const thrift::RowGroup& rowGroup,
+    const std::vector<uint32_t>& columns,
+    const dwio::common::BufferedInput& input)
+    : rowGroup_(rowGroup) {
+  int64_t begin = std::numeric_limits<int64_t>::max();
+  int64_t end = 0;
+  for (auto column : columns) {
+    const auto& chunk = rowGroup_.columns[column];
+    if (chunk.__isset.column_index_offset &&
+        chunk.__isset.column_index_length) {
+      begin = std::min(begin, chunk.column_index_offset);
+      end = std::max(
+          end, chunk.column_index_offset + chunk.column_index_length);
+    }
+    if (chunk.__isset.offset_index_offset &&
+        chunk.__isset.offset_index_length) {
+      begin = std::min(begin, chunk.offset_index_offset);
+      end = std::max(
+          end, chunk.offset_index_offset + chunk.offset_index_length);
+    }
+  }
+  if (begin >= end) {
+    return;
+  }
+  offset_ = begin;
+  data_.resize(end - begin);
+  auto stream =
+      input.read(begin, end - begin, dwio::common::LogType::STRIPE_INDEX);
+  stream->readFully(data_.data(), data_.size());
+}
+
+std::optional<thrift::ColumnIndex> PageIndex::columnIndex(
+    uint32_t column) const {
+  const auto& chunk = rowGroup_.columns[column];
+  if (!chunk.__isset.column_index_offset ||
+      !chunk.__isset.column_index_length) {
+    return std::nullopt;
+  }
+  return deserialize<thrift::ColumnIndex>(
+      chunk.column_index_offset, chunk.column_index_length);
+}
+
+std::optional<thrift::OffsetIndex> PageIndex::offsetIndex(
+    uint32_t column) const {
+  const auto& chunk = rowGroup_.columns[column];
+  if (!chunk.__isset.offset_index_offset ||
+      !chunk.__isset.offset_index_length) {
+    return std::nullopt;
+  }
+  return deserialize<thrift::OffsetIndex>(
+      chunk.offset_index_offset, chunk.offset_index_length);
+}
+
+template <typename T>
+T PageIndex::deserialize(int64_t offset, int32_t length) const {
+  VELOX_CHECK(
+      offset >= offset_ && offset + length <= offset_ + data_.size(),
+      "Page index at {} is outside of the read range",
+      offset);
+  auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+      data_.data() + offset - offset_, length);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  T index;
+  index.read(&protocol);
+  return index;
+}
+
+SparseChunkInputStream::SparseChunkInputStream(std::vector<Range> ranges)
+    : ranges_(std::move(ranges)) {
+  VELOX_CHECK(!ranges_.empty());
+  for (auto i = 1; i < ranges_.size(); ++i) {
+    VELOX_CHECK_LE(rangeEnd(i - 1), ranges_[i].offset);
+  }
+  for (const auto& range : ranges_) {
+    VELOX_CHECK(range.stream || range.load);
+  }
+  position_ = ranges_[0].offset;
+}
+
+bool SparseChunkInputStream::Next(const void** data, int32_t* size) {
+  if (position_ == rangeEnd(current_)) {
+    if (current_ + 1 == ranges_.size()) {
+      return false;
+    }
+    VELOX_CHECK_EQ(
+        ranges_[current_ + 1].offset,
+        position_,
+        "Reading an unfetched part of a column chunk at {}",
+        position_);
+    seek(position_);
+  }
+  if (!stream(current_).Next(data, size)) {
+    return false;
+  }
+  position_ += *size;
+  return true;
+}
+
+void SparseChunkInputStream::BackUp(int32_t count) {
+  VELOX_CHECK_LE(count, position_ - ranges_[current_].offset);
+  stream(current_).BackUp(count);
+  position_ -= count;
+}
+
+bool SparseChunkInputStream::Skip(int32_t count) {
+  if (position_ + count <= rangeEnd(current_)) {
+    stream(current_).Skip(count);
+    position_ += count;
+    return true;
+  }
+  seek(position_ + count);
+  return true;
+}
+
+void SparseChunkInputStream::seekToPosition(
+    dwio::common::PositionProvider& position) {
+  seek(position.next());
+}
+
+std::string SparseChunkInputStream::getName() const {
+  return fmt::format("SparseChunkInputStream {} ranges", ranges_.size());
+}
+
+void SparseChunkInputStream::seek(uint64_t offset) {
+  auto it = std::upper_bound(
+      ranges_.begin(),
+      ranges_.end(),
+      offset,
+      [](uint64_t offset, const Range& range) {
+        return offset < range.offset;
+      });
+  VELOX_CHECK(
+      it != ranges_.begin() && offset <= (it - 1)->offset + (it - 1)->size,
+      "Seeking to an unfetched part of a column chunk at {}",
+      offset);
+  --it;
+  current_ = it - ranges_.begin();
+  std::vector<uint64_t> positions = {offset - it->offset};
+  dwio::common::PositionProvider provider(positions);
+  stream(current_).seekToPosition(provider);
+  position_ = offset;
+}
+
+dwio::common::SeekableInputStream& SparseChunkInputStream::stream(
+    int32_t index) {
+  auto& range = ranges_[index];
+  if (!range.stream) {
+    range.stream = range.load();
+    range.load = nullptr;
+  }
+  return *range.stream;
+}
+
+} // namespace facebook::velox::parquet
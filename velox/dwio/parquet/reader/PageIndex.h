@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+
+namespace facebook::velox::parquet {
+
+// Ascending, disjoint ranges [first, second) of rows of a row group.
+using RowRanges = std::vector<std::pair<int64_t, int64_t>>;
+
+// Removes the rows in [begin, end) from 'ranges'.
+void removeRowRange(RowRanges& ranges, int64_t begin, int64_t end);
+
+// Returns true if any row in [begin, end) is in 'ranges'.
+bool overlapsRowRanges(const RowRanges& ranges, int64_t begin, int64_t end);
+
+// The ColumnIndex and OffsetIndex structs of the column chunks of a row group.
+// These are written outside of the row group, usually next to each other
+// before the footer, so the indexes of all requested columns are read in one
+// IO.
+class PageIndex {
+ public:
+  PageIndex(
+      const thrift::RowGroup& rowGroup,
+      const std::vector<uint32_t>& columns,
+      const dwio::common::BufferedInput& input);
+
+  // Returns the ColumnIndex of 'column' or std::nullopt if it has none.
+  // 'column' must be one of the columns given to the constructor.
+  std::optional<thrift::ColumnIndex> columnIndex(uint32_t column) const;
+
+  // Returns the OffsetIndex of 'column' or std::nullopt if it has none.
+  std::optional<thrift::OffsetIndex> offsetIndex(uint32_t column) const;
+
+ private:
+  template <typename T>
+  T deserialize(int64_t offset, int32_t length) const;
+
+  const thrift::RowGroup& rowGroup_;
+
+  // File offset of the first byte of 'data_'.
+  int64_t offset_{0};
+
+  // The bytes covering the indexes of the requested columns.
+  std::vector<char> data_;
+};
+
+// Stream over a column chunk of which only some byte ranges, e.g. the pages
+// selected by a PageIndex, are fetched. Each range has its own stream.
+// Positions are offsets from the start of the chunk. Reading a byte that is
+// not in a fetched range is an error.
+class SparseChunkInputStream : public dwio::common::SeekableInputStream {
+ public:
+  struct Range {
+    // Offset of the range from the start of the chunk.
+    uint64_t offset;
+    uint64_t size;
+    std::unique_ptr<dwio::common::SeekableInputStream> stream;
+    // Makes 'stream' when the range is first read if 'stream' is not given.
+    // Ranges that are never read are then never fetched.
+    std::function<std::unique_ptr<dwio::common::SeekableInputStream>()> load;
+  };
+
+  // 'ranges' must be ascending and must not overlap.
+  explicit SparseChunkInputStream(std::vector<Range> ranges);
+
+  bool Next(const void** data, int32_t* size) override;
+
+  void BackUp(int32_t count) override;
+
+  bool Skip(int32_t count) override;
+
+  google::protobuf::int64 ByteCount() const override {
+    return position_;
+  }
+
+  void seekToPosition(dwio::common::PositionProvider& position) override;
+
+  std::string getName() const override;
+
+  size_t positionSize() override {
+    return 1;
+  }
+
+ private:
+  uint64_t rangeEnd(int32_t index) const {
+    return ranges_[index].offset + ranges_[index].size;
+  }
+
+  // Positions 'this' at 'offset', which must be in or at the end of a fetched
+  // range.
+  void seek(uint64_t offset);
+
+  // Returns the stream of the 'index'th range. Loads the range if it is not
+  // loaded yet.
+  dwio::common::SeekableInputStream& stream(int32_t index);
+
+  std::vector<Range> ranges_;
+
+  // Index of the range containing 'position_'.
+  int32_t current_{0};
+
+  uint64_t position_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -17,6 +17,7 @@
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/ColumnVisitors.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 #include "velox/vector/FlatVector.h"
@@ -37,6 +38,11 @@ void PageReader::seekToPage(int64_t row) {
   // 'rowOfPage_' is the row number of the first row of the next page.
   rowOfPage_ += numRowsInPage_;
   for (;;) {
+    // The dictionary page, if any, is read before jumping over data pages.
+    if (!pageLocations_.empty() && row != kRepDefOnly &&
+        pageStart_ >= static_cast<uint64_t>(pageLocations_[0].offset)) {
+      jumpToPage(row);
+    }
     auto dataStart = pageStart_;
     if (chunkSize_ <= pageStart_) {
       // This may happen if seeking to exactly end of row group.
@@ -75,6 +81,27 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+void PageReader::jumpToPage(int64_t row) {
+  auto it = std::upper_bound(
+      pageLocations_.begin(),
+      pageLocations_.end(),
+      row,
+      [](int64_t row, const thrift::PageLocation& location) {
+        return row < location.first_row_index;
+      });
+  VELOX_CHECK(it != pageLocations_.begin());
+  --it;
+  if (static_cast<uint64_t>(it->offset) <= pageStart_) {
+    return;
+  }
+  pageStart_ = it->offset;
+  rowOfPage_ = it->first_row_index;
+  std::vector<uint64_t> position = {pageStart_};
+  dwio::common::PositionProvider provider(position);
+  inputStream_->seekToPosition(provider);
+  bufferStart_ = bufferEnd_ = nullptr;
+}
+
 PageHeader PageReader::readPageHeader() {
   if (bufferEnd_ == bufferStart_) {
     const void* buffer;
@@ -546,7 +573,9 @@ void PageReader::prepareDictionary(const PageHeader& pageHeader) {
   }
 }
 
-void PageReader::makeFilterCache(dwio::common::ScanState& state) {
+void PageReader::makeFilterCache(
+    dwio::common::ScanState& state,
+    const common::Filter& filter) {
   VELOX_CHECK(
       !state.dictionary2.values, "Parquet supports only one dictionary");
   state.filterCache.resize(state.dictionary.numValues);
@@ -554,9 +583,78 @@ void PageReader::makeFilterCache(dwio::common::ScanState& state) {
       state.filterCache.data(),
       dwio::common::FilterResult::kUnknown,
       state.filterCache.size());
+  // The entries that are not tested here are tested as they are hit.
+  testDictionary(filter, state.dictionary, state.filterCache.data());
   state.rawState.filterCache = state.filterCache.data();
 }
 
+const dwio::common::DictionaryValues& PageReader::readDictionary() {
+  VELOX_CHECK_EQ(rowOfPage_, 0);
+  VELOX_CHECK(pageLocations_.empty());
+  seekToPage(0);
+  return dictionary_;
+}
+
+namespace {
+template <typename T>
+int32_t testDictionaryValues(
+    const common::Filter& filter,
+    const T* values,
+    int32_t numValues,
+    uint8_t* results) {
+  int32_t numPassed = 0;
+  for (auto i = 0; i < numValues; ++i) {
+    const bool passed = common::applyFilter(filter, values[i]);
+    results[i] = passed ? dwio::common::FilterResult::kSuccess
+                        : dwio::common::FilterResult::kFailure;
+    numPassed += passed;
+  }
+  return numPassed;
+}
+} // namespace
+
+int32_t PageReader::testDictionary(
+    const common::Filter& filter,
+    const dwio::common::DictionaryValues& dictionary,
+    uint8_t* results) const {
+  // The result of a non-deterministic filter depends on the row, not only on
+  // the value.
+  if (!dictionary.values || !filter.isDeterministic()) {
+    return -1;
+  }
+  const auto numValues = dictionary.numValues;
+  const auto parquetType = type_->parquetType_.value();
+  switch (type_->type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      if (parquetType != thrift::Type::INT32) {
+        return -1;
+      }
+      return testDictionaryValues(
+          filter, dictionary.values->as<int32_t>(), numValues, results);
+    case TypeKind::BIGINT:
+      if (parquetType != thrift::Type::INT64) {
+        return -1;
+      }
+      return testDictionaryValues(
+          filter, dictionary.values->as<int64_t>(), numValues, results);
+    case TypeKind::REAL:
+      return testDictionaryValues(
+          filter, dictionary.values->as<float>(), numValues, results);
+    case TypeKind::DOUBLE:
+      return testDictionaryValues(
+          filter, dictionary.values->as<double>(), numValues, results);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return testDictionaryValues(
+          filter, dictionary.values->as<StringView>(), numValues, results);
+    default:
+      return -1;
+  }
+}
+
 namespace {
 int32_t parquetTypeBytes(thrift::Type::type type) {
   switch (type) {
@@ -574,6 +672,82 @@ int32_t parquetTypeBytes(thrift::Type::type type) {
 }
 } // namespace
 
+void PageReader::decodeToPlain() {
+  const auto* encodedEnd = pageData_ + encodedDataSize_;
+  const auto parquetType = type_->parquetType_.value();
+  switch (encoding_) {
+    case Encoding::DELTA_BINARY_PACKED: {
+      DeltaBpDecoder decoder(pageData_, encodedEnd);
+      const auto numValues = decoder.numValues();
+      if (parquetType == thrift::Type::INT32) {
+        dwio::common::ensureCapacity<int32_t>(decodedPage_, numValues, &pool_);
+        decoder.decode(decodedPage_->asMutable<int32_t>());
+        encodedDataSize_ = numValues * sizeof(int32_t);
+      } else {
+        VELOX_CHECK_EQ(
+            parquetType,
+            thrift::Type::INT64,
+            "DELTA_BINARY_PACKED is only for INT32 and INT64");
+        dwio::common::ensureCapacity<int64_t>(decodedPage_, numValues, &pool_);
+        decoder.decode(decodedPage_->asMutable<int64_t>());
+        encodedDataSize_ = numValues * sizeof(int64_t);
+      }
+      break;
+    }
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY: {
+      VELOX_CHECK_EQ(
+          parquetType,
+          thrift::Type::BYTE_ARRAY,
+          "DELTA_LENGTH_BYTE_ARRAY is only for BYTE_ARRAY");
+      // The lengths are followed by the concatenated string bytes. The PLAIN
+      // layout interleaves each length with its bytes.
+      DeltaBpDecoder decoder(pageData_, encodedEnd);
+      const auto numValues = decoder.numValues();
+      std::vector<int32_t> lengths(numValues);
+      decoder.decode(lengths.data());
+      const auto* strings = decoder.bufferStart();
+      const auto numStringBytes = encodedEnd - strings;
+      const auto size = numValues * sizeof(int32_t) + numStringBytes;
+      dwio::common::ensureCapacity<char>(
+          decodedPage_, size + simd::kPadding, &pool_);
+      auto* plain = decodedPage_->asMutable<char>();
+      for (auto length : lengths) {
+        VELOX_CHECK_LE(
+            length, encodedEnd - strings, "Truncated DELTA_LENGTH_BYTE_ARRAY");
+        memcpy(plain, &length, sizeof(int32_t));
+        memcpy(plain + sizeof(int32_t), strings, length);
+        plain += sizeof(int32_t) + length;
+        strings += length;
+      }
+      encodedDataSize_ = plain - decodedPage_->as<char>();
+      break;
+    }
+    case Encoding::BYTE_STREAM_SPLIT: {
+      // Byte i of each value is in the i-th of 'width' streams of
+      // 'numValues' bytes. Transposes the streams back into values.
+      const int32_t width = parquetType == thrift::Type::FIXED_LEN_BYTE_ARRAY
+          ? type_->typeLength_
+          : parquetTypeBytes(parquetType);
+      VELOX_CHECK_EQ(
+          encodedDataSize_ % width, 0, "Bad BYTE_STREAM_SPLIT page size");
+      const auto numValues = encodedDataSize_ / width;
+      dwio::common::ensureCapacity<char>(
+          decodedPage_, encodedDataSize_, &pool_);
+      auto* plain = decodedPage_->asMutable<char>();
+      for (auto stream = 0; stream < width; ++stream) {
+        const auto* streamData = pageData_ + stream * numValues;
+        for (auto i = 0; i < numValues; ++i) {
+          plain[i * width + stream] = streamData[i];
+        }
+      }
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+  pageData_ = decodedPage_->as<char>();
+}
+
 void PageReader::preloadRepDefs() {
   hasChunkRepDefs_ = true;
   while (pageStart_ < chunkSize_) {
@@ -693,6 +867,11 @@ void PageReader::makeDecoder() {
       dictionaryIdDecoder_ = std::make_unique<RleBpDataDecoder>(
           pageData_ + 1, pageData_ + encodedDataSize_, pageData_[0]);
       break;
+    case Encoding::DELTA_BINARY_PACKED:
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+    case Encoding::BYTE_STREAM_SPLIT:
+      decodeToPlain();
+      [[fallthrough]];
     case Encoding::PLAIN:
       switch (parquetType) {
         case thrift::Type::BOOLEAN:
@@ -720,9 +899,8 @@ void PageReader::makeDecoder() {
         }
       }
       break;
-    case Encoding::DELTA_BINARY_PACKED:
     default:
-      VELOX_UNSUPPORTED("Encoding not supported yet");
+      VELOX_UNSUPPORTED("Encoding not supported yet: {}", encoding_);
   }
 }
 
@@ -853,7 +1031,7 @@ void PageReader::startVisit(folly::Range<const vector_size_t*> rows) {
 
 bool PageReader::rowsForPage(
     dwio::common::SelectiveColumnReader& reader,
-    bool hasFilter,
+    const common::Filter* FOLLY_NULLABLE filter,
     bool mayProduceNulls,
     folly::Range<const vector_size_t*>& rows,
     const uint64_t* FOLLY_NULLABLE& nulls) {
@@ -874,8 +1052,8 @@ bool PageReader::rowsForPage(
   if (isDictionary()) {
     if (scanState.dictionary.values != dictionary_.values) {
       scanState.dictionary = dictionary_;
-      if (hasFilter) {
-        makeFilterCache(scanState);
+      if (filter) {
+        makeFilterCache(scanState, *filter);
       }
       scanState.updateRawState();
     }
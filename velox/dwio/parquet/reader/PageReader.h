@@ -69,6 +69,16 @@ class PageReader {
   /// Advances 'numRows' top level rows.
   void skip(int64_t numRows);
 
+  /// Sets the locations of the data pages of the column chunk from its
+  /// OffsetIndex, with offsets relative to the start of the chunk. Seeking to
+  /// a row then jumps to its page instead of reading the page headers before
+  /// it, so that the pages in between need not be fetched. Only for columns
+  /// that are not repeated.
+  void setPageLocations(std::vector<thrift::PageLocation> locations) {
+    VELOX_CHECK_EQ(maxRepeat_, 0);
+    pageLocations_ = std::move(locations);
+  }
+
   /// Decodes repdefs for 'numTopLevelRows'. Use getLengthsAndNulls()
   /// to access the lengths and nulls for the different nesting
   /// levels.
@@ -120,6 +130,22 @@ class PageReader {
     dictionaryValues_.reset();
   }
 
+  /// Reads the dictionary page at the start of the column chunk. For a stream
+  /// that covers only the dictionary page, so that the dictionary can be
+  /// tested without reading the data pages. The result has no values if the
+  /// chunk does not start with a dictionary page.
+  const dwio::common::DictionaryValues& readDictionary();
+
+  /// Tests 'filter' on each entry of 'dictionary' and sets the corresponding
+  /// element of 'results' to FilterResult::kSuccess or kFailure. Returns the
+  /// number of passing entries. Returns -1 and leaves 'results' as is if the
+  /// dictionary of the column is not tested up front, e.g. for decimals and
+  /// timestamps.
+  int32_t testDictionary(
+      const common::Filter& filter,
+      const dwio::common::DictionaryValues& dictionary,
+      uint8_t* FOLLY_NONNULL results) const;
+
   /// Returns the range of repdefs for the top level rows covered by the last
   /// decoderepDefs().
   std::pair<int32_t, int32_t> repDefRange() const {
@@ -148,8 +174,12 @@ class PageReader {
   // current page.
   int32_t skipNulls(int32_t numRows);
 
-  // Initializes a filter result cache for the dictionary in 'state'.
-  void makeFilterCache(dwio::common::ScanState& state);
+  // Initializes a filter result cache for the dictionary in 'state' with the
+  // results of 'filter' for all its entries, so that the rows of dictionary
+  // pages are filtered by looking up their dictionary index.
+  void makeFilterCache(
+      dwio::common::ScanState& state,
+      const common::Filter& filter);
 
   // Makes a decoder based on 'encoding_' for bytes from ''pageData_' to
   // 'pageData_' + 'encodedDataSize_'.
@@ -164,6 +194,10 @@ class PageReader {
   // allowed for non-top level columns.
   void seekToPage(int64_t row);
 
+  // Positions the input at the page that contains 'row' according to
+  // 'pageLocations_' if that page is after 'pageStart_'.
+  void jumpToPage(int64_t row);
+
   // Preloads the repdefs for the column chunk. To avoid preloading,
   // would need a way too clone the input stream so that one stream
   // reads ahead for repdefs and the other tracks the data. This is
@@ -186,6 +220,12 @@ class PageReader {
   void prepareDictionary(const thrift::PageHeader& pageHeader);
   void makeDecoder();
 
+  // Decodes a DELTA_BINARY_PACKED, DELTA_LENGTH_BYTE_ARRAY or
+  // BYTE_STREAM_SPLIT encoded page into 'decodedPage_' in PLAIN layout and
+  // points 'pageData_' and 'encodedDataSize_' to it. The PLAIN decoders then
+  // read the page.
+  void decodeToPlain();
+
   // For a non-top level leaf, reads the defs and sets 'leafNulls_' and
   // 'numRowsInPage_' accordingly. This is used for non-top level leaves when
   // 'hasChunkRepDefs_' is false.
@@ -228,14 +268,14 @@ class PageReader {
   // first value. Reads possible nulls and sets 'reader's
   // nullsInReadRange_' to that or to nullptr if no null
   // flags. Returns the data of nullsInReadRange in 'nulls'. Copies
-  // dictionary information into 'reader'. If 'hasFilter' is true,
+  // dictionary information into 'reader'. If 'filter' is not null,
   // sets up dictionary hit cache. If the new page is direct and
   // previous pages are dictionary, converts any accumulated results
   // into flat. 'mayProduceNulls' should be true if nulls may occur in
   // the result if they occur in the data.
   bool rowsForPage(
       dwio::common::SelectiveColumnReader& reader,
-      bool hasFilter,
+      const common::Filter* FOLLY_NULLABLE filter,
       bool mayProduceNulls,
       folly::Range<const vector_size_t*>& rows,
       const uint64_t* FOLLY_NULLABLE& nulls);
@@ -398,6 +438,10 @@ class PageReader {
   // Number of rows in current page.
   int32_t numRowsInPage_{0};
 
+  // Locations of the data pages. Empty if the chunk has no OffsetIndex or the
+  // pages are read sequentially. See setPageLocations().
+  std::vector<thrift::PageLocation> pageLocations_;
+
   // Number of repdefs in page. Not the same as number of rows for a non-top
   // level column.
   int32_t numRepDefsInPage_{0};
@@ -412,6 +456,10 @@ class PageReader {
   // contiguous run of bytes.
   const char* FOLLY_NULLABLE pageData_{nullptr};
 
+  // The data of the current page transcoded to PLAIN layout for encodings
+  // that are not read directly. See decodeToPlain().
+  BufferPtr decodedPage_;
+
   // Dictionary contents.
   dwio::common::DictionaryValues dictionary_;
   thrift::Encoding::type dictionaryEncoding_;
@@ -490,7 +538,11 @@ void PageReader::readWithVisitor(Visitor& visitor) {
   folly::Range<const vector_size_t*> pageRows;
   const uint64_t* nulls = nullptr;
   bool isMultiPage = false;
-  while (rowsForPage(reader, hasFilter, mayProduceNulls, pageRows, nulls)) {
+  const common::Filter* filter = nullptr;
+  if constexpr (hasFilter) {
+    filter = &visitor.filter();
+  }
+  while (rowsForPage(reader, filter, mayProduceNulls, pageRows, nulls)) {
     bool nullsFromFastPath = false;
     int32_t numValuesBeforePage = numRowsInReader<hasFilter>(reader);
     visitor.setNumValuesBias(numValuesBeforePage);
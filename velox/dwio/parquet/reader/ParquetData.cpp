@@ -82,9 +82,311 @@ bool ParquetData::rowGroupMatches(
   return true;
 }
 
+namespace {
+// Returns the file offset of the first page of 'metaData'.
+uint64_t chunkReadOffset(const thrift::ColumnMetaData& metaData) {
+  uint64_t chunkReadOffset = metaData.data_page_offset;
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset >= 4) {
+    // this assumes the data pages follow the dict pages directly.
+    chunkReadOffset = metaData.dictionary_page_offset;
+  }
+  VELOX_CHECK_GE(chunkReadOffset, 0);
+  return chunkReadOffset;
+}
+
+// Returns true if 'filter' passes only the values in a list, which a bloom
+// filter can test. Nulls are not in bloom filters.
+bool isBloomFilterTestable(const common::Filter& filter) {
+  if (filter.testNull()) {
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+void ParquetData::filterPages(
+    uint32_t index,
+    const common::ScanSpec& scanSpec,
+    const PageIndex& pageIndex,
+    RowRanges& rowRanges) {
+  auto* filter = scanSpec.filter();
+  if (!filter) {
+    return;
+  }
+  auto columnIndex = pageIndex.columnIndex(type_->column);
+  auto offsetIndex = pageIndex.offsetIndex(type_->column);
+  if (!columnIndex.has_value() || !offsetIndex.has_value()) {
+    return;
+  }
+  const auto& locations = offsetIndex->page_locations;
+  VELOX_CHECK_EQ(columnIndex->null_pages.size(), locations.size());
+  const auto numRows = rowGroups_[index].num_rows;
+  for (auto i = 0; i < locations.size(); ++i) {
+    const auto firstRow = locations[i].first_row_index;
+    const auto endRow = i + 1 < locations.size()
+        ? locations[i + 1].first_row_index
+        : numRows;
+    if (!pageMatches(*columnIndex, i, endRow - firstRow, filter)) {
+      removeRowRange(rowRanges, firstRow, endRow);
+    }
+  }
+}
+
+bool ParquetData::pageMatches(
+    const thrift::ColumnIndex& columnIndex,
+    int32_t page,
+    int64_t numRows,
+    common::Filter* filter) {
+  // The page stats are encoded like the column chunk stats.
+  thrift::Statistics stats;
+  const bool nullPage = columnIndex.null_pages[page];
+  if (!nullPage) {
+    stats.__set_min_value(columnIndex.min_values[page]);
+    stats.__set_max_value(columnIndex.max_values[page]);
+  }
+  if (columnIndex.__isset.null_counts) {
+    stats.__set_null_count(columnIndex.null_counts[page]);
+  } else if (nullPage) {
+    stats.__set_null_count(numRows);
+  }
+  auto pageStats =
+      buildColumnStatisticsFromThrift(stats, *type_->type, numRows);
+  return testFilter(filter, pageStats.get(), numRows, type_->type);
+}
+
+std::optional<int64_t> ParquetData::bloomFilterOffset(
+    uint32_t index,
+    const common::ScanSpec& scanSpec) const {
+  auto* filter = scanSpec.filter();
+  if (!filter || !isBloomFilterTestable(*filter) ||
+      !type_->parquetType_.has_value()) {
+    return std::nullopt;
+  }
+  const auto physicalType = type_->parquetType_.value();
+  switch (type_->type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+      if (physicalType != thrift::Type::INT32) {
+        return std::nullopt;
+      }
+      break;
+    case TypeKind::BIGINT:
+      if (physicalType != thrift::Type::INT32 &&
+          physicalType != thrift::Type::INT64) {
+        return std::nullopt;
+      }
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      if (physicalType != thrift::Type::BYTE_ARRAY) {
+        return std::nullopt;
+      }
+      break;
+    default:
+      return std::nullopt;
+  }
+  const auto& chunk = rowGroups_[index].columns[type_->column];
+  if (!chunk.__isset.meta_data ||
+      !chunk.meta_data.__isset.bloom_filter_offset) {
+    return std::nullopt;
+  }
+  return chunk.meta_data.bloom_filter_offset;
+}
+
+bool ParquetData::bloomFilterMatches(
+    const SplitBlockBloomFilter& bloomFilter,
+    const common::ScanSpec& scanSpec) const {
+  const bool isInt32 = type_->parquetType_.value() == thrift::Type::INT32;
+  auto mayContain = [&](int64_t value) {
+    if (isInt32) {
+      // A value out of the int32 range may be an unsigned value stored with
+      // the same bits. Do not prune on those.
+      if (value < std::numeric_limits<int32_t>::min() ||
+          value > std::numeric_limits<int32_t>::max()) {
+        return true;
+      }
+      return bloomFilter.mayContain(
+          SplitBlockBloomFilter::hash(static_cast<int32_t>(value)));
+    }
+    return bloomFilter.mayContain(SplitBlockBloomFilter::hash(value));
+  };
+  auto* filter = scanSpec.filter();
+  switch (filter->kind()) {
+    case common::FilterKind::kBigintRange:
+      return mayContain(static_cast<common::BigintRange*>(filter)->lower());
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      const auto& values =
+          static_cast<common::BigintValuesUsingHashTable*>(filter)->values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      const auto values =
+          static_cast<common::BigintValuesUsingBitmask*>(filter)->values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    case common::FilterKind::kBytesRange:
+      return bloomFilter.mayContain(SplitBlockBloomFilter::hash(
+          std::string_view(static_cast<common::BytesRange*>(filter)->lower())));
+    case common::FilterKind::kBytesValues: {
+      for (const auto& value :
+           static_cast<common::BytesValues*>(filter)->values()) {
+        if (bloomFilter.mayContain(
+                SplitBlockBloomFilter::hash(std::string_view(value)))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return true;
+  }
+}
+
+namespace {
+bool isDictionaryEncoding(thrift::Encoding::type encoding) {
+  return encoding == thrift::Encoding::PLAIN_DICTIONARY ||
+      encoding == thrift::Encoding::RLE_DICTIONARY;
+}
+
+// Returns true if all data pages of the column chunk of 'metaData' are
+// dictionary encoded. This is known from the encoding stats or from the
+// encodings of the chunk if these have no other value encoding. The
+// dictionary page itself is PLAIN in newer files, so a chunk with PLAIN
+// among its encodings but no encoding stats may have PLAIN data pages.
+bool allPagesDictionaryEncoded(const thrift::ColumnMetaData& metaData) {
+  if (metaData.__isset.encoding_stats) {
+    bool hasDataPages = false;
+    for (const auto& stats : metaData.encoding_stats) {
+      if (stats.page_type != thrift::PageType::DATA_PAGE &&
+          stats.page_type != thrift::PageType::DATA_PAGE_V2) {
+        continue;
+      }
+      if (stats.count > 0 && !isDictionaryEncoding(stats.encoding)) {
+        return false;
+      }
+      hasDataPages = true;
+    }
+    return hasDataPages;
+  }
+  bool hasDictionaryEncoding = false;
+  for (auto encoding : metaData.encodings) {
+    if (isDictionaryEncoding(encoding)) {
+      hasDictionaryEncoding = true;
+    } else if (
+        encoding != thrift::Encoding::RLE &&
+        encoding != thrift::Encoding::BIT_PACKED) {
+      return false;
+    }
+  }
+  return hasDictionaryEncoding;
+}
+} // namespace
+
+std::optional<std::pair<uint64_t, uint64_t>> ParquetData::dictionaryPageRange(
+    uint32_t index,
+    const common::ScanSpec& scanSpec) const {
+  auto* filter = scanSpec.filter();
+  if (!filter || !filter->isDeterministic() ||
+      !type_->parquetType_.has_value()) {
+    return std::nullopt;
+  }
+  const auto& chunk = rowGroups_[index].columns[type_->column];
+  if (!chunk.__isset.meta_data) {
+    return std::nullopt;
+  }
+  const auto& metaData = chunk.meta_data;
+  if (!metaData.__isset.dictionary_page_offset ||
+      metaData.dictionary_page_offset < 4 ||
+      metaData.data_page_offset <= metaData.dictionary_page_offset ||
+      !allPagesDictionaryEncoded(metaData)) {
+    return std::nullopt;
+  }
+  if (filter->testNull() && maxDefine_ > 0 &&
+      !(metaData.__isset.statistics &&
+        metaData.statistics.__isset.null_count &&
+        metaData.statistics.null_count == 0)) {
+    return std::nullopt;
+  }
+  return std::make_pair(
+      static_cast<uint64_t>(metaData.dictionary_page_offset),
+      static_cast<uint64_t>(
+          metaData.data_page_offset - metaData.dictionary_page_offset));
+}
+
+bool ParquetData::dictionaryMatches(
+    uint32_t index,
+    std::unique_ptr<dwio::common::SeekableInputStream> stream,
+    const common::ScanSpec& scanSpec) const {
+  const auto& metaData = rowGroups_[index].columns[type_->column].meta_data;
+  PageReader reader(
+      std::move(stream),
+      pool_,
+      type_,
+      metaData.codec,
+      metaData.data_page_offset - metaData.dictionary_page_offset);
+  const auto& dictionary = reader.readDictionary();
+  raw_vector<uint8_t> results(dictionary.numValues);
+  return reader.testDictionary(
+             *scanSpec.filter(), dictionary, results.data()) != 0;
+}
+
+void ParquetData::selectPages(
+    uint32_t index,
+    const PageIndex& pageIndex,
+    const RowRanges& rowRanges) {
+  VELOX_CHECK_EQ(maxRepeat_, 0);
+  auto offsetIndex = pageIndex.offsetIndex(type_->column);
+  if (!offsetIndex.has_value() || offsetIndex->page_locations.empty()) {
+    return;
+  }
+  const auto& metaData = rowGroups_[index].columns[type_->column].meta_data;
+  const auto chunkOffset = chunkReadOffset(metaData);
+  const auto numRows = rowGroups_[index].num_rows;
+  SelectedPages pages;
+  pages.locations = std::move(offsetIndex->page_locations);
+  // The dictionary page, if any, precedes the first data page.
+  const uint64_t firstPageOffset = pages.locations[0].offset - chunkOffset;
+  if (firstPageOffset > 0) {
+    pages.byteRanges.emplace_back(0, firstPageOffset);
+  }
+  for (auto i = 0; i < pages.locations.size(); ++i) {
+    auto& location = pages.locations[i];
+    VELOX_CHECK_GE(location.offset, chunkOffset);
+    location.offset -= chunkOffset;
+    const auto endRow = i + 1 < pages.locations.size()
+        ? pages.locations[i + 1].first_row_index
+        : numRows;
+    if (!overlapsRowRanges(rowRanges, location.first_row_index, endRow)) {
+      continue;
+    }
+    const uint64_t begin = location.offset;
+    const uint64_t end = begin + location.compressed_page_size;
+    if (!pages.byteRanges.empty() && pages.byteRanges.back().second == begin) {
+      pages.byteRanges.back().second = end;
+    } else {
+      pages.byteRanges.emplace_back(begin, end);
+    }
+  }
+  selectedPages_[index] = std::move(pages);
+}
+
 void ParquetData::enqueueRowGroup(
     uint32_t index,
-    dwio::common::BufferedInput& input) {
+    dwio::common::BufferedInput& input,
+    bool loadPagesOnDemand) {
   auto& chunk = rowGroups_[index].columns[type_->column];
   streams_.resize(rowGroups_.size());
   VELOX_CHECK(
@@ -92,21 +394,54 @@ void ParquetData::enqueueRowGroup(
       "ColumnMetaData does not exist for schema Id ",
       type_->column);
   auto& metaData = chunk.meta_data;
+  const uint64_t chunkOffset = chunkReadOffset(metaData);
+  auto id = dwio::common::StreamIdentifier(type_->column);
 
-  uint64_t chunkReadOffset = metaData.data_page_offset;
-  if (metaData.__isset.dictionary_page_offset &&
-      metaData.dictionary_page_offset >= 4) {
-    // this assumes the data pages follow the dict pages directly.
-    chunkReadOffset = metaData.dictionary_page_offset;
+  auto selected = selectedPages_.find(index);
+  if (selected != selectedPages_.end() &&
+      !selected->second.byteRanges.empty()) {
+    const auto& byteRanges = selected->second.byteRanges;
+    std::vector<SparseChunkInputStream::Range> ranges;
+    if (loadPagesOnDemand) {
+      // Each selected page and the dictionary page, if any, is a range of its
+      // own that is read from 'input' when first accessed.
+      auto addRange = [&](uint64_t begin, uint64_t size) {
+        auto load = [&input, offset = chunkOffset + begin, size]() {
+          return input.read(offset, size, dwio::common::LogType::STREAM);
+        };
+        ranges.push_back({begin, size, nullptr, std::move(load)});
+      };
+      const auto& locations = selected->second.locations;
+      if (locations[0].offset > 0) {
+        addRange(0, locations[0].offset);
+      }
+      auto byteRange = byteRanges.begin();
+      for (const auto& location : locations) {
+        const uint64_t begin = location.offset;
+        while (byteRange != byteRanges.end() && byteRange->second <= begin) {
+          ++byteRange;
+        }
+        if (byteRange != byteRanges.end() && byteRange->first <= begin) {
+          addRange(begin, location.compressed_page_size);
+        }
+      }
+    } else {
+      for (auto [begin, end] : byteRanges) {
+        ranges.push_back(
+            {begin,
+             end - begin,
+             input.enqueue({chunkOffset + begin, end - begin}, &id)});
+      }
+    }
+    streams_[index] =
+        std::make_unique<SparseChunkInputStream>(std::move(ranges));
+    return;
   }
-  VELOX_CHECK_GE(chunkReadOffset, 0);
 
   uint64_t readSize = (metaData.codec == thrift::CompressionCodec::UNCOMPRESSED)
       ? metaData.total_uncompressed_size
       : metaData.total_compressed_size;
-
-  auto id = dwio::common::StreamIdentifier(type_->column);
-  streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+  streams_[index] = input.enqueue({chunkOffset, readSize}, &id);
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
@@ -120,6 +455,11 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
       type_,
       metadata.codec,
       metadata.total_compressed_size);
+  auto selected = selectedPages_.find(index);
+  if (selected != selectedPages_.end()) {
+    reader_->setPageLocations(std::move(selected->second.locations));
+    selectedPages_.erase(selected);
+  }
   return dwio::common::PositionProvider(empty);
 }
 
@@ -21,6 +21,8 @@
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
@@ -34,6 +36,10 @@ class ParquetParams : public dwio::common::FormatParams {
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const common::ScanSpec& scanSpec) override;
 
+  const thrift::FileMetaData& metaData() const {
+    return metaData_;
+  }
+
  private:
   const thrift::FileMetaData& metaData_;
 };
@@ -52,8 +58,15 @@ class ParquetData : public dwio::common::FormatData {
         maxRepeat_(type_->maxRepeat_),
         rowsInRowGroup_(-1) {}
 
-  /// Prepares to read data for 'index'th row group.
-  void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
+  /// Prepares to read data for 'index'th row group. If 'loadPagesOnDemand'
+  /// is true and selectPages() has selected pages for the row group, each
+  /// selected page is fetched from 'input' only when it is first read, so
+  /// that pages without rows to read are never fetched. 'input' must then
+  /// live until the row group is read.
+  void enqueueRowGroup(
+      uint32_t index,
+      dwio::common::BufferedInput& input,
+      bool loadPagesOnDemand = false);
 
   /// Positions 'this' at 'index'th row group. enqueueRowGroup must be called
   /// first. The returned PositionProvider is empty and should not be used.
@@ -66,6 +79,63 @@ class ParquetData : public dwio::common::FormatData {
       const dwio::common::StatsContext& writerContext,
       FilterRowGroupsResult&) override;
 
+  /// Removes the rows of the pages of row group 'index' whose stats in
+  /// 'pageIndex' do not pass the filter of 'scanSpec' from 'rowRanges'. Does
+  /// nothing if the column chunk has no page index.
+  void filterPages(
+      uint32_t index,
+      const common::ScanSpec& scanSpec,
+      const PageIndex& pageIndex,
+      RowRanges& rowRanges);
+
+  /// Makes enqueueRowGroup() fetch only the pages of row group 'index' that
+  /// have rows in 'rowRanges' and makes the PageReader seek to pages by their
+  /// locations in 'pageIndex'. Only for columns that are not repeated. Does
+  /// nothing if the column chunk has no OffsetIndex.
+  void selectPages(
+      uint32_t index,
+      const PageIndex& pageIndex,
+      const RowRanges& rowRanges);
+
+  /// Returns the file offset of the bloom filter of the column chunk in row
+  /// group 'index' or std::nullopt if the chunk has none or the filter of
+  /// 'scanSpec' is not an equality or IN filter that a bloom filter can test.
+  std::optional<int64_t> bloomFilterOffset(
+      uint32_t index,
+      const common::ScanSpec& scanSpec) const;
+
+  /// Returns false if no value that passes the filter of 'scanSpec' is in
+  /// 'bloomFilter'. The filter must be one for which bloomFilterOffset()
+  /// returns an offset.
+  bool bloomFilterMatches(
+      const SplitBlockBloomFilter& bloomFilter,
+      const common::ScanSpec& scanSpec) const;
+
+  /// Returns the file offset and size of the dictionary page of the column
+  /// chunk in row group 'index' if the chunk can be skipped when no entry of
+  /// the dictionary passes the filter of 'scanSpec'. This is when all data
+  /// pages are dictionary encoded and the filter does not pass nulls or the
+  /// chunk has none. Returns std::nullopt otherwise.
+  std::optional<std::pair<uint64_t, uint64_t>> dictionaryPageRange(
+      uint32_t index,
+      const common::ScanSpec& scanSpec) const;
+
+  /// Returns false if no entry of the dictionary read from 'stream' passes
+  /// the filter of 'scanSpec'. 'stream' covers the range given by
+  /// dictionaryPageRange() for row group 'index'.
+  bool dictionaryMatches(
+      uint32_t index,
+      std::unique_ptr<dwio::common::SeekableInputStream> stream,
+      const common::ScanSpec& scanSpec) const;
+
+  const thrift::RowGroup& rowGroup(uint32_t index) const {
+    return rowGroups_[index];
+  }
+
+  uint32_t column() const {
+    return type_->column;
+  }
+
   PageReader* FOLLY_NONNULL reader() const {
     return reader_.get();
   }
@@ -176,6 +246,23 @@ class ParquetData : public dwio::common::FormatData {
   /// stats in 'rowGroup'.
   bool rowGroupMatches(uint32_t rowGroupId, common::Filter* filter);
 
+  // True if 'filter' may have hits in the page at 'page' in 'columnIndex'.
+  bool pageMatches(
+      const thrift::ColumnIndex& columnIndex,
+      int32_t page,
+      int64_t numRows,
+      common::Filter* filter);
+
+  // The pages of a row group to fetch, see selectPages().
+  struct SelectedPages {
+    // Locations of all data pages, with offsets relative to the start of the
+    // column chunk.
+    std::vector<thrift::PageLocation> locations;
+
+    // Byte ranges [first, second) of the column chunk to fetch.
+    std::vector<std::pair<uint64_t, uint64_t>> byteRanges;
+  };
+
  protected:
   memory::MemoryPool& pool_;
   std::shared_ptr<const ParquetTypeWithId> type_;
@@ -184,6 +271,10 @@ class ParquetData : public dwio::common::FormatData {
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
 
+  // Pages to fetch for row groups whose pages are selected by the page index.
+  // Erased when positioning at the row group.
+  std::unordered_map<uint32_t, SelectedPages> selectedPages_;
+
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
   int64_t rowsInRowGroup_;
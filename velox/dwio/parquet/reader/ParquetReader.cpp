@@ -16,6 +16,7 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
@@ -42,6 +43,33 @@ ReaderBase::ReaderBase(
 }
 
 void ReaderBase::loadFileMetaData() {
+  auto metadataCache = dwio::common::FileMetadataCache::getInstance();
+  std::optional<dwio::common::FileMetadataCache::Key> cacheKey;
+  if (metadataCache) {
+    cacheKey = dwio::common::FileMetadataCache::makeKey(
+        dwio::common::FileFormat::PARQUET, *input_->getReadFile());
+    if (cacheKey.has_value()) {
+      fileMetaData_ = metadataCache->get<thrift::FileMetaData>(*cacheKey);
+      if (fileMetaData_) {
+        return;
+      }
+    }
+  }
+  uint32_t footerLength;
+  fileMetaData_ = readFileMetaData(footerLength);
+  if (cacheKey.has_value()) {
+    // The deserialized footer is a few times larger than the compact
+    // serialized one.
+    constexpr int32_t kDeserializedExpansion = 4;
+    metadataCache->put(
+        std::move(*cacheKey),
+        fileMetaData_,
+        static_cast<uint64_t>(footerLength) * kDeserializedExpansion);
+  }
+}
+
+std::shared_ptr<const thrift::FileMetaData> ReaderBase::readFileMetaData(
+    uint32_t& footerLength) {
   bool preloadFile_ = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -58,7 +86,7 @@ void ReaderBase::loadFileMetaData() {
       strncmp(copy.data() + readSize - 4, "PAR1", 4) == 0,
       "No magic bytes found at end of the Parquet file");
 
-  uint32_t footerLength =
+  footerLength =
       *(reinterpret_cast<const uint32_t*>(copy.data() + readSize - 8));
   VELOX_CHECK_LE(footerLength + 12, fileLength_);
   int32_t footerOffsetInBuffer = readSize - 8 - footerLength;
@@ -83,8 +111,9 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol = std::make_unique<
       apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
       thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_shared<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  return fileMetaData;
 }
 
 void ReaderBase::initializeSchema() {
@@ -452,20 +481,21 @@ std::shared_ptr<const RowType> ReaderBase::createRowType(
 void ReaderBase::scheduleRowGroups(
     const std::vector<uint32_t>& rowGroupIds,
     int32_t currentGroup,
-    StructColumnReader& reader) {
+    StructColumnReader& reader,
+    bool loadPagesOnDemand) {
   auto thisGroup = rowGroupIds[currentGroup];
   auto nextGroup =
       currentGroup + 1 < rowGroupIds.size() ? rowGroupIds[currentGroup + 1] : 0;
   auto input = inputs_[thisGroup].get();
   if (!input) {
     auto newInput = input_->clone();
-    reader.enqueueRowGroup(thisGroup, *newInput);
+    reader.enqueueRowGroup(thisGroup, *newInput, loadPagesOnDemand);
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[thisGroup] = std::move(newInput);
   }
   if (nextGroup) {
     auto newInput = input_->clone();
-    reader.enqueueRowGroup(nextGroup, *newInput);
+    reader.enqueueRowGroup(nextGroup, *newInput, loadPagesOnDemand);
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[nextGroup] = std::move(newInput);
   }
@@ -522,6 +552,10 @@ ParquetRowReader::ParquetRowReader(
       readerBase_->schemaWithId(), // Id is schema id
       params,
       *options_.getScanSpec());
+  dynamic_cast<StructColumnReader&>(*columnReader_)
+      .setDecodingExecutor(
+          options_.getDecodingExecutor().get(),
+          options_.getDecodingParallelism());
 
   filterRowGroups();
   if (!rowGroupIds_.empty()) {
@@ -568,6 +602,34 @@ void ParquetRowReader::filterRowGroups() {
       }
     }
   }
+
+  // Skips the row groups in which a bloom filter shows that no value passes
+  // an equality or IN filter.
+  auto& structReader = dynamic_cast<StructColumnReader&>(*columnReader_);
+  skippedRowGroups_ += structReader.filterRowGroupsByBloomFilters(
+      rowGroupIds_, readerBase_->bufferedInput());
+
+  // Skips the row groups in which a filtered column is dictionary encoded and
+  // no dictionary entry passes the filter.
+  skippedRowGroups_ += structReader.filterRowGroupsByDictionaries(
+      rowGroupIds_, readerBase_->bufferedInput());
+
+  // Narrows down the rows to read in each row group by the page indexes. A row
+  // group is skipped if no page may pass the filters.
+  std::vector<uint32_t> rowGroupIds;
+  rowGroupIds.reserve(rowGroupIds_.size());
+  rowRanges_.reserve(rowGroupIds_.size());
+  for (auto i : rowGroupIds_) {
+    RowRanges rowRanges = {{0, rowGroups_[i].num_rows}};
+    structReader.filterPages(i, readerBase_->bufferedInput(), rowRanges);
+    if (rowRanges.empty()) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    rowGroupIds.push_back(i);
+    rowRanges_.push_back(std::move(rowRanges));
+  }
+  rowGroupIds_ = std::move(rowGroupIds);
 }
 
 uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
@@ -580,17 +642,49 @@ uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
     }
   }
 
-  uint64_t rowsToRead = std::min(
-      static_cast<uint64_t>(size), rowsInCurrentRowGroup_ - currentRowInGroup_);
+  if (auto numSkipped = skipToRowRange()) {
+    result = BaseVector::create(result->type(), 0, &pool_);
+    return numSkipped;
+  }
+
+  const auto& rowRanges = rowRanges_[currentRowGroupIdsIdx_ - 1];
+  uint64_t rowsToRead = std::min<uint64_t>(
+      size, rowRanges[nextRowRange_].second - currentRowInGroup_);
 
   if (rowsToRead > 0) {
     columnReader_->next(rowsToRead, result, nullptr);
     currentRowInGroup_ += rowsToRead;
+    ++numBatches_;
+    numEmptyBatches_ += result->size() == 0;
   }
 
   return rowsToRead;
 }
 
+uint64_t ParquetRowReader::skipToRowRange() {
+  const auto& rowRanges = rowRanges_[currentRowGroupIdsIdx_ - 1];
+  while (nextRowRange_ < rowRanges.size() &&
+         rowRanges[nextRowRange_].second <=
+             static_cast<int64_t>(currentRowInGroup_)) {
+    ++nextRowRange_;
+  }
+  if (nextRowRange_ == rowRanges.size()) {
+    // No more rows to read in the row group. The next row group resets the
+    // column readers.
+    const auto numSkipped = rowsInCurrentRowGroup_ - currentRowInGroup_;
+    currentRowInGroup_ = rowsInCurrentRowGroup_;
+    return numSkipped;
+  }
+  const uint64_t rangeBegin = rowRanges[nextRowRange_].first;
+  if (currentRowInGroup_ >= rangeBegin) {
+    return 0;
+  }
+  const auto numSkipped = rangeBegin - currentRowInGroup_;
+  columnReader_->seekTo(columnReader_->readOffset() + numSkipped, false);
+  currentRowInGroup_ = rangeBegin;
+  return numSkipped;
+}
+
 bool ParquetRowReader::advanceToNextRowGroup() {
   if (currentRowGroupIdsIdx_ == rowGroupIds_.size()) {
     return false;
@@ -600,15 +694,23 @@ bool ParquetRowReader::advanceToNextRowGroup() {
   readerBase_->scheduleRowGroups(
       rowGroupIds_,
       currentRowGroupIdsIdx_,
-      dynamic_cast<StructColumnReader&>(*columnReader_));
+      dynamic_cast<StructColumnReader&>(*columnReader_),
+      loadPagesOnDemand());
   currentRowGroupPtr_ = &rowGroups_[rowGroupIds_[currentRowGroupIdsIdx_]];
   rowsInCurrentRowGroup_ = currentRowGroupPtr_->num_rows;
   currentRowInGroup_ = 0;
+  nextRowRange_ = 0;
   currentRowGroupIdsIdx_++;
   columnReader_->seekToRowGroup(nextRowGroupIndex);
   return true;
 }
 
+bool ParquetRowReader::loadPagesOnDemand() const {
+  // Batches to see before deciding.
+  constexpr int64_t kMinBatches = 8;
+  return numBatches_ >= kMinBatches && 2 * numEmptyBatches_ > numBatches_;
+}
+
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
@@ -632,6 +734,34 @@ ParquetReader::ParquetReader(
     const dwio::common::ReaderOptions& options)
     : readerBase_(std::make_shared<ReaderBase>(std::move(input), options)) {}
 
+std::vector<dwio::common::FileSection> ParquetReader::sections() const {
+  const auto& rowGroups = readerBase_->fileMetaData().row_groups;
+  std::vector<dwio::common::FileSection> sections;
+  sections.reserve(rowGroups.size());
+  for (const auto& rowGroup : rowGroups) {
+    VELOX_CHECK_GT(rowGroup.columns.size(), 0);
+    auto fileOffset = rowGroup.__isset.file_offset
+        ? rowGroup.file_offset
+        : rowGroup.columns[0].file_offset;
+    if (fileOffset <= 0) {
+      return {{0, readerBase_->fileLength(), readerBase_->fileNumRows()}};
+    }
+    int64_t length = 0;
+    if (rowGroup.__isset.total_compressed_size) {
+      length = rowGroup.total_compressed_size;
+    } else {
+      for (const auto& column : rowGroup.columns) {
+        length += column.meta_data.total_compressed_size;
+      }
+    }
+    sections.push_back(
+        {static_cast<uint64_t>(fileOffset),
+         static_cast<uint64_t>(length),
+         static_cast<uint64_t>(rowGroup.num_rows)});
+  }
+  return sections;
+}
+
 std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
     const dwio::common::RowReaderOptions& options) const {
   return std::make_unique<ParquetRowReader>(readerBase_, options);
@@ -20,6 +20,7 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
@@ -72,10 +73,13 @@ class ReaderBase {
 
   /// Ensures that streams are enqueued and loading for the row group at
   /// 'currentGroup'. May start loading one or more subsequent groups.
+  /// 'loadPagesOnDemand' is passed to StructColumnReader::enqueueRowGroup()
+  /// for the groups enqueued by this call.
   void scheduleRowGroups(
       const std::vector<uint32_t>& groups,
       int32_t currentGroup,
-      StructColumnReader& reader);
+      StructColumnReader& reader,
+      bool loadPagesOnDemand = false);
 
   /// Returns the uncompressed size for columns in 'type' and its children in
   /// row
@@ -85,9 +89,14 @@ class ReaderBase {
       const dwio::common::TypeWithId& type) const;
 
  private:
-  // Reads and parses file footer.
+  // Reads and parses file footer, unless it is in FileMetadataCache.
   void loadFileMetaData();
 
+  // Reads and parses file footer and returns its serialized size in
+  // 'footerLength'.
+  std::shared_ptr<const thrift::FileMetaData> readFileMetaData(
+      uint32_t& footerLength);
+
   void initializeSchema();
 
   std::shared_ptr<const ParquetTypeWithId> getParquetColumnInfo(
@@ -110,7 +119,7 @@ class ReaderBase {
   const dwio::common::ReaderOptions& options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -156,6 +165,16 @@ class ParquetRowReader : public dwio::common::RowReader {
   // by filterRowGroups().
   bool advanceToNextRowGroup();
 
+  // Skips the rows of the current row group before the next range in
+  // 'rowRanges_'. Returns the number of rows skipped.
+  uint64_t skipToRowRange();
+
+  // Returns true if the pages of the columns without filters in the row groups
+  // enqueued next should be fetched only when rows of them pass the filters.
+  // This is when most batches so far had no passing rows, so that the passing
+  // rows are likely in few pages.
+  bool loadPagesOnDemand() const;
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions& options_;
@@ -170,9 +189,22 @@ class ParquetRowReader : public dwio::common::RowReader {
   uint64_t rowsInCurrentRowGroup_;
   uint64_t currentRowInGroup_;
 
+  // Ranges of rows that may pass the filters according to the page indexes,
+  // for each of 'rowGroupIds_'.
+  std::vector<RowRanges> rowRanges_;
+
+  // Index of the first range in 'rowRanges_' of the current row group that
+  // ends after 'currentRowInGroup_'.
+  size_t nextRowRange_{0};
+
   // Number of row groups skipped based on stats.
   int32_t skippedRowGroups_{0};
 
+  // Number of batches read from the column readers and the number of those
+  // with no rows passing the filters.
+  int64_t numBatches_{0};
+  int64_t numEmptyBatches_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -205,6 +237,11 @@ class ParquetReader : public dwio::common::Reader {
     return readerBase_->schemaWithId();
   }
 
+  // Returns the row groups. A file with a row group that has no offset is
+  // returned as a single section since ParquetRowReader reads such row groups
+  // in every range.
+  std::vector<dwio::common::FileSection> sections() const override;
+
   std::unique_ptr<dwio::common::RowReader> createRowReader(
       const dwio::common::RowReaderOptions& options = {}) const override;
 
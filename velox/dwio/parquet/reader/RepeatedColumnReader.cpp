@@ -85,6 +85,11 @@ void enqueueChildren(
     dwio::common::SelectiveColumnReader* reader,
     uint32_t index,
     dwio::common::BufferedInput& input) {
+  if (auto structReader = dynamic_cast<StructColumnReader*>(reader)) {
+    // A struct also enqueues the column it reads only for nulls.
+    structReader->enqueueRowGroup(index, input);
+    return;
+  }
   auto children = reader->children();
   if (children.empty()) {
     reader->formatData().as<ParquetData>().enqueueRowGroup(index, input);
@@ -139,6 +139,15 @@ void StringColumnReader::getValues(RowSet rows, VectorPtr* result) {
         numValues_,
         dictionaryValues,
         values_);
+    // All batches of the row group share 'dictionaryValues', so that
+    // downstream operators can work on the distinct values.
+    if (scanSpec_->makeFlat()) {
+      BaseVector::ensureWritable(
+          SelectivityVector::empty(),
+          (*result)->type(),
+          &memoryPool_,
+          *result);
+    }
     return;
   }
   rawStringBuffer_ = nullptr;
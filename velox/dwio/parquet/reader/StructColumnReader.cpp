@@ -19,6 +19,51 @@
 
 namespace facebook::velox::parquet {
 
+namespace {
+// Returns the compressed size of the column chunks of 'type' in the first row
+// group.
+int64_t chunkSize(
+    const ParquetTypeWithId& type,
+    const thrift::FileMetaData& metaData) {
+  if (metaData.row_groups.empty()) {
+    return 0;
+  }
+  if (type.isLeaf()) {
+    return metaData.row_groups[0]
+        .columns[type.column]
+        .meta_data.total_compressed_size;
+  }
+  int64_t size = 0;
+  for (auto& child : type.getChildren()) {
+    size += chunkSize(
+        *reinterpret_cast<const ParquetTypeWithId*>(child.get()), metaData);
+  }
+  return size;
+}
+
+// Sets 'best' to the leaf or the repeated node under the structs in 'type'
+// with the smallest column chunks. Any of them has the levels from which the
+// nulls of 'type' are found.
+void findCheapestRepDefs(
+    const std::shared_ptr<const dwio::common::TypeWithId>& type,
+    const thrift::FileMetaData& metaData,
+    std::shared_ptr<const dwio::common::TypeWithId>& best,
+    int64_t& bestSize) {
+  for (auto& child : type->getChildren()) {
+    if (child->type->kind() == TypeKind::ROW) {
+      findCheapestRepDefs(child, metaData, best, bestSize);
+      continue;
+    }
+    auto size = chunkSize(
+        *reinterpret_cast<const ParquetTypeWithId*>(child.get()), metaData);
+    if (!best || size < bestSize) {
+      best = child;
+      bestSize = size;
+    }
+  }
+}
+} // namespace
+
 StructColumnReader::StructColumnReader(
     const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
     ParquetParams& params,
@@ -38,7 +83,21 @@ StructColumnReader::StructColumnReader(
   if (type->parent) {
     levelMode_ = reinterpret_cast<const ParquetTypeWithId*>(nodeType_.get())
                      ->makeLevelInfo(levelInfo_);
-    childForRepDefs_ = findBestLeaf();
+    if (children_.empty()) {
+      // All fields are pruned. The nulls come from the levels of the column
+      // with the smallest chunks, which are read but whose values are not.
+      std::shared_ptr<const dwio::common::TypeWithId> repDefType;
+      int64_t size = 0;
+      findCheapestRepDefs(nodeType_, params.metaData(), repDefType, size);
+      VELOX_CHECK_NOT_NULL(repDefType);
+      repDefSpec_ = std::make_unique<common::ScanSpec>("<repdefs>");
+      repDefSpec_->addAllChildFields(*repDefType->type);
+      repDefReader_ =
+          ParquetColumnReader::build(repDefType, params, *repDefSpec_);
+      childForRepDefs_ = repDefReader_.get();
+    } else {
+      childForRepDefs_ = findBestLeaf();
+    }
     // Set mode to struct over lists if the child for repdefs has a list between
     // this and the child.
     auto child = childForRepDefs_;
@@ -59,6 +118,181 @@ StructColumnReader::StructColumnReader(
   }
 }
 
+void StructColumnReader::filterPages(
+    uint32_t index,
+    const dwio::common::BufferedInput& input,
+    RowRanges& rowRanges) {
+  VELOX_CHECK_NULL(
+      reinterpret_cast<const ParquetTypeWithId*>(nodeType_.get())->parent);
+  std::vector<dwio::common::SelectiveColumnReader*> leaves;
+  bool hasFilter = false;
+  for (auto* child : children_) {
+    auto kind = child->type()->kind();
+    if (kind == TypeKind::ROW || kind == TypeKind::ARRAY ||
+        kind == TypeKind::MAP) {
+      continue;
+    }
+    leaves.push_back(child);
+    hasFilter |= child->scanSpec()->filter() != nullptr;
+  }
+  if (!hasFilter) {
+    return;
+  }
+  std::vector<uint32_t> columns;
+  columns.reserve(leaves.size());
+  for (auto* leaf : leaves) {
+    columns.push_back(leaf->formatData().as<ParquetData>().column());
+  }
+  PageIndex pageIndex(
+      leaves[0]->formatData().as<ParquetData>().rowGroup(index),
+      columns,
+      input);
+  for (auto* leaf : leaves) {
+    leaf->formatData().as<ParquetData>().filterPages(
+        index, *leaf->scanSpec(), pageIndex, rowRanges);
+  }
+  if (rowRanges.empty()) {
+    return;
+  }
+  for (auto* leaf : leaves) {
+    leaf->formatData().as<ParquetData>().selectPages(
+        index, pageIndex, rowRanges);
+  }
+}
+
+int32_t StructColumnReader::filterRowGroupsByBloomFilters(
+    std::vector<uint32_t>& rowGroupIds,
+    const dwio::common::BufferedInput& input) {
+  // Bounds the memory for the bitsets read at a time.
+  constexpr int32_t kRowGroupsPerBatch = 8;
+  VELOX_CHECK_NULL(
+      reinterpret_cast<const ParquetTypeWithId*>(nodeType_.get())->parent);
+  const auto leaves = filteredLeaves();
+  if (leaves.empty()) {
+    return 0;
+  }
+  std::vector<uint32_t> result;
+  result.reserve(rowGroupIds.size());
+  for (auto begin = 0; begin < rowGroupIds.size();
+       begin += kRowGroupsPerBatch) {
+    const auto end = std::min<size_t>(
+        begin + kRowGroupsPerBatch, rowGroupIds.size());
+    // The row group and the leaf of each bloom filter to read.
+    std::vector<std::pair<uint32_t, dwio::common::SelectiveColumnReader*>>
+        probes;
+    std::vector<int64_t> offsets;
+    for (auto i = begin; i < end; ++i) {
+      for (auto* leaf : leaves) {
+        auto offset =
+            leaf->formatData().as<ParquetData>().bloomFilterOffset(
+                rowGroupIds[i], *leaf->scanSpec());
+        if (offset.has_value()) {
+          probes.emplace_back(i, leaf);
+          offsets.push_back(offset.value());
+        }
+      }
+    }
+    std::vector<bool> pruned(end - begin);
+    if (!offsets.empty()) {
+      auto bloomFilters = readBloomFilters(offsets, input);
+      for (auto j = 0; j < probes.size(); ++j) {
+        auto [i, leaf] = probes[j];
+        if (bloomFilters[j] &&
+            !leaf->formatData().as<ParquetData>().bloomFilterMatches(
+                *bloomFilters[j], *leaf->scanSpec())) {
+          pruned[i - begin] = true;
+        }
+      }
+    }
+    for (auto i = begin; i < end; ++i) {
+      if (!pruned[i - begin]) {
+        result.push_back(rowGroupIds[i]);
+      }
+    }
+  }
+  const int32_t numPruned = rowGroupIds.size() - result.size();
+  rowGroupIds = std::move(result);
+  return numPruned;
+}
+
+int32_t StructColumnReader::filterRowGroupsByDictionaries(
+    std::vector<uint32_t>& rowGroupIds,
+    const dwio::common::BufferedInput& input) {
+  // Bounds the memory for the dictionary pages read at a time.
+  constexpr int32_t kRowGroupsPerBatch = 8;
+  VELOX_CHECK_NULL(
+      reinterpret_cast<const ParquetTypeWithId*>(nodeType_.get())->parent);
+  const auto leaves = filteredLeaves();
+  if (leaves.empty()) {
+    return 0;
+  }
+  std::vector<uint32_t> result;
+  result.reserve(rowGroupIds.size());
+  for (auto begin = 0; begin < rowGroupIds.size();
+       begin += kRowGroupsPerBatch) {
+    const auto end = std::min<size_t>(
+        begin + kRowGroupsPerBatch, rowGroupIds.size());
+    auto dictionaryInput = input.clone();
+    // The row group, the leaf and the stream of each dictionary to test.
+    struct Probe {
+      uint32_t index;
+      dwio::common::SelectiveColumnReader* leaf;
+      std::unique_ptr<dwio::common::SeekableInputStream> stream;
+    };
+    std::vector<Probe> probes;
+    for (auto i = begin; i < end; ++i) {
+      for (auto* leaf : leaves) {
+        auto range =
+            leaf->formatData().as<ParquetData>().dictionaryPageRange(
+                rowGroupIds[i], *leaf->scanSpec());
+        if (range.has_value()) {
+          probes.push_back(
+              {static_cast<uint32_t>(i),
+               leaf,
+               dictionaryInput->enqueue({range->first, range->second})});
+        }
+      }
+    }
+    std::vector<bool> pruned(end - begin);
+    if (!probes.empty()) {
+      dictionaryInput->load(dwio::common::LogType::STREAM);
+      for (auto& probe : probes) {
+        if (pruned[probe.index - begin]) {
+          continue;
+        }
+        if (!probe.leaf->formatData().as<ParquetData>().dictionaryMatches(
+                rowGroupIds[probe.index],
+                std::move(probe.stream),
+                *probe.leaf->scanSpec())) {
+          pruned[probe.index - begin] = true;
+        }
+      }
+    }
+    for (auto i = begin; i < end; ++i) {
+      if (!pruned[i - begin]) {
+        result.push_back(rowGroupIds[i]);
+      }
+    }
+  }
+  const int32_t numPruned = rowGroupIds.size() - result.size();
+  rowGroupIds = std::move(result);
+  return numPruned;
+}
+
+std::vector<dwio::common::SelectiveColumnReader*>
+StructColumnReader::filteredLeaves() const {
+  std::vector<dwio::common::SelectiveColumnReader*> leaves;
+  for (auto* child : children_) {
+    auto kind = child->type()->kind();
+    if (kind == TypeKind::ROW || kind == TypeKind::ARRAY ||
+        kind == TypeKind::MAP || !child->scanSpec()->filter()) {
+      continue;
+    }
+    leaves.push_back(child);
+  }
+  return leaves;
+}
+
 dwio::common::SelectiveColumnReader* FOLLY_NONNULL
 StructColumnReader::findBestLeaf() {
   SelectiveColumnReader* best = nullptr;
@@ -94,7 +328,8 @@ void StructColumnReader::read(
 
 void StructColumnReader::enqueueRowGroup(
     uint32_t index,
-    dwio::common::BufferedInput& input) {
+    dwio::common::BufferedInput& input,
+    bool loadPagesOnDemand) {
   for (auto& child : children_) {
     if (auto structChild = dynamic_cast<StructColumnReader*>(child)) {
       structChild->enqueueRowGroup(index, input);
@@ -103,9 +338,27 @@ void StructColumnReader::enqueueRowGroup(
     } else if (auto mapChild = dynamic_cast<MapColumnReader*>(child)) {
       mapChild->enqueueRowGroup(index, input);
     } else {
-      child->formatData().as<ParquetData>().enqueueRowGroup(index, input);
+      child->formatData().as<ParquetData>().enqueueRowGroup(
+          index, input, loadPagesOnDemand && !child->scanSpec()->hasFilter());
     }
   }
+  if (repDefReader_) {
+    enqueueRepDefs(*repDefReader_, index, input);
+  }
+}
+
+// static
+void StructColumnReader::enqueueRepDefs(
+    dwio::common::SelectiveColumnReader& reader,
+    uint32_t index,
+    dwio::common::BufferedInput& input) {
+  if (auto listReader = dynamic_cast<ListColumnReader*>(&reader)) {
+    listReader->enqueueRowGroup(index, input);
+  } else if (auto mapReader = dynamic_cast<MapColumnReader*>(&reader)) {
+    mapReader->enqueueRowGroup(index, input);
+  } else {
+    reader.formatData().as<ParquetData>().enqueueRowGroup(index, input);
+  }
 }
 
 void StructColumnReader::seekToRowGroup(uint32_t index) {
@@ -116,6 +369,9 @@ void StructColumnReader::seekToRowGroup(uint32_t index) {
   for (auto& child : children_) {
     child->seekToRowGroup(index);
   }
+  if (repDefReader_) {
+    repDefReader_->seekToRowGroup(index);
+  }
 }
 
 bool StructColumnReader::filterMatches(const thrift::RowGroup& /*rowGroup*/) {
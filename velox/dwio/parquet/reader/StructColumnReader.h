@@ -33,8 +33,42 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
 
   void seekToRowGroup(uint32_t index) override;
 
-  /// Creates the streams for 'rowGroup in 'input'. Does not load yet.
-  void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
+  /// Creates the streams for 'rowGroup in 'input'. Does not load yet. If
+  /// 'loadPagesOnDemand' is true, the leaf children without filters fetch
+  /// their pages selected by filterPages() only when reading rows of them.
+  void enqueueRowGroup(
+      uint32_t index,
+      dwio::common::BufferedInput& input,
+      bool loadPagesOnDemand = false);
+
+  /// Reads the page indexes of the leaf children in row group 'index' from
+  /// 'input' and removes the rows of the pages whose stats do not pass the
+  /// filters of the children from 'rowRanges'. The leaf children then fetch
+  /// only the pages with rows in 'rowRanges'. Does nothing if no leaf child
+  /// has a filter. Only for the root reader, whose leaf children are not
+  /// repeated.
+  void filterPages(
+      uint32_t index,
+      const dwio::common::BufferedInput& input,
+      RowRanges& rowRanges);
+
+  /// Removes the row groups from 'rowGroupIds' in which the bloom filter of a
+  /// leaf child shows that no value passes the equality or IN filter of the
+  /// child. The bloom filters of a batch of row groups are read from 'input'
+  /// in two coalesced loads. Returns the number of removed row groups. Only
+  /// for the root reader.
+  int32_t filterRowGroupsByBloomFilters(
+      std::vector<uint32_t>& rowGroupIds,
+      const dwio::common::BufferedInput& input);
+
+  /// Removes the row groups from 'rowGroupIds' in which a leaf child has a
+  /// column chunk with only dictionary encoded data pages and no entry of the
+  /// dictionary passes the filter of the child. The dictionary pages of a
+  /// batch of row groups are read from 'input' in one coalesced load. Returns
+  /// the number of removed row groups. Only for the root reader.
+  int32_t filterRowGroupsByDictionaries(
+      std::vector<uint32_t>& rowGroupIds,
+      const dwio::common::BufferedInput& input);
 
   // No-op in Parquet. All readers switch row groups at the same time, there is
   // no on-demand skipping to a new row group.
@@ -64,8 +98,19 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
 
  private:
   bool filterMatches(const thrift::RowGroup& rowGroup);
+
+  // Returns the children that are not complex types and have a filter.
+  std::vector<dwio::common::SelectiveColumnReader*> filteredLeaves() const;
+
   dwio::common::SelectiveColumnReader* findBestLeaf();
 
+  // Enqueues the column chunks of 'reader', which is a leaf or a repeated
+  // reader, for row group 'index'.
+  static void enqueueRepDefs(
+      dwio::common::SelectiveColumnReader& reader,
+      uint32_t index,
+      dwio::common::BufferedInput& input);
+
   // Leaf column reader used for getting nullability information for
   // 'this'. This is nullptr for the root of a table.
   dwio::common::SelectiveColumnReader* FOLLY_NULLABLE childForRepDefs_{nullptr};
@@ -77,6 +122,12 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
   // The level information for extracting nulls for 'this' from the
   // repdefs in a leaf PageReader.
   ::parquet::internal::LevelInfo levelInfo_;
+
+  // The spec and the reader of the column whose repdefs give the nulls of
+  // 'this' when all fields of 'this' are pruned. The values of the column are
+  // not read.
+  std::unique_ptr<common::ScanSpec> repDefSpec_;
+  std::unique_ptr<dwio::common::SelectiveColumnReader> repDefReader_;
 };
 
 } // namespace facebook::velox::parquet
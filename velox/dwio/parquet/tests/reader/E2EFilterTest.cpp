@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
 #include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
 using namespace facebook::velox;
@@ -60,6 +64,20 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto sink = std::make_unique<MemorySink>(*leafPool_, 200 * 1024 * 1024);
     sinkPtr_ = sink.get();
 
+    if (nativeWriterOptions_.has_value()) {
+      auto options = nativeWriterOptions_.value();
+      options.rowsInRowGroup = rowGroupSize_;
+      NativeWriter writer(
+          std::move(sink),
+          *leafPool_,
+          asRowType(batches[0]->type()),
+          std::move(options));
+      for (auto& batch : batches) {
+        writer.write(batch);
+      }
+      writer.close();
+      return;
+    }
     writer_ = std::make_unique<facebook::velox::parquet::Writer>(
         std::move(sink), *leafPool_, rowGroupSize_, writerProperties_);
     for (auto& batch : batches) {
@@ -74,8 +92,36 @@ class E2EFilterTest : public E2EFilterTestBase {
     return std::make_unique<ParquetReader>(std::move(input), opts);
   }
 
+  void setUpRowReaderOptions(
+      dwio::common::RowReaderOptions& opts,
+      const std::shared_ptr<ScanSpec>& spec) override {
+    E2EFilterTestBase::setUpRowReaderOptions(opts, spec);
+    if (decodingExecutor_) {
+      opts.setDecodingExecutor(decodingExecutor_);
+      opts.setDecodingParallelism(4);
+    }
+  }
+
+  // Returns a reader of the data written by writeToMemory() with 'spec'.
+  std::unique_ptr<dwio::common::RowReader> makeRowReader(
+      const std::shared_ptr<ScanSpec>& spec) {
+    dwio::common::ReaderOptions readerOpts{leafPool_.get()};
+    std::string_view data(sinkPtr_->getData(), sinkPtr_->size());
+    readFile_ = std::make_shared<InMemoryReadFile>(data);
+    reader_ = makeReader(
+        readerOpts, std::make_unique<BufferedInput>(readFile_, *leafPool_));
+    dwio::common::RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(spec);
+    return reader_->createRowReader(rowReaderOpts);
+  }
+
   std::unique_ptr<facebook::velox::parquet::Writer> writer_;
+  std::shared_ptr<InMemoryReadFile> readFile_;
+  std::unique_ptr<dwio::common::Reader> reader_;
   std::shared_ptr<::parquet::WriterProperties> writerProperties_;
+  std::shared_ptr<folly::Executor> decodingExecutor_;
+  // Writes with NativeWriter instead of the Arrow based writer if set.
+  std::optional<NativeWriterOptions> nativeWriterOptions_;
   int32_t rowGroupSize_{10000};
 };
 
@@ -116,6 +162,27 @@ TEST_F(E2EFilterTest, integerDirect) {
       {"short_val", "int_val", "long_val"},
       20);
 }
+TEST_F(E2EFilterTest, integerDeltaBinaryPacked) {
+  writerProperties_ =
+      ::parquet::WriterProperties::Builder()
+          .disable_dictionary()
+          ->encoding("short_val", ::parquet::Encoding::DELTA_BINARY_PACKED)
+          ->encoding("int_val", ::parquet::Encoding::DELTA_BINARY_PACKED)
+          ->encoding("long_val", ::parquet::Encoding::DELTA_BINARY_PACKED)
+          ->encoding("long_null", ::parquet::Encoding::DELTA_BINARY_PACKED)
+          ->data_pagesize(4 * 1024)
+          ->build();
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      true,
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
 TEST_F(E2EFilterTest, compression) {
   for (const auto compression :
        {::parquet::Compression::SNAPPY,
@@ -239,6 +306,26 @@ TEST_F(E2EFilterTest, floatAndDoubleDirect) {
       20);
 }
 
+TEST_F(E2EFilterTest, floatAndDoubleByteStreamSplit) {
+  writerProperties_ =
+      ::parquet::WriterProperties::Builder()
+          .disable_dictionary()
+          ->encoding("float_val", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->encoding("double_val", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->encoding("float_null", ::parquet::Encoding::BYTE_STREAM_SPLIT)
+          ->data_pagesize(4 * 1024)
+          ->build();
+
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_null:float",
+      [&]() { makeAllNulls("float_null"); },
+      true,
+      {"float_val", "double_val", "float_null"},
+      20);
+}
+
 TEST_F(E2EFilterTest, floatAndDouble) {
   // float_val and double_val may be direct since the
   // values are random.float_val2 and double_val2 are expected to be
@@ -419,6 +506,28 @@ TEST_F(E2EFilterTest, stringDirect) {
       20);
 }
 
+TEST_F(E2EFilterTest, stringDeltaLengthByteArray) {
+  writerProperties_ =
+      ::parquet::WriterProperties::Builder()
+          .disable_dictionary()
+          ->encoding("string_val", ::parquet::Encoding::DELTA_LENGTH_BYTE_ARRAY)
+          ->encoding(
+              "string_val_2", ::parquet::Encoding::DELTA_LENGTH_BYTE_ARRAY)
+          ->data_pagesize(4 * 1024)
+          ->build();
+
+  testWithTypes(
+      "string_val:string,"
+      "string_val_2:string",
+      [&]() {
+        makeStringUnique("string_val");
+        makeStringUnique("string_val_2");
+      },
+      true,
+      {"string_val", "string_val_2"},
+      20);
+}
+
 TEST_F(E2EFilterTest, stringDictionary) {
   testWithTypes(
       "string_val:string,"
@@ -563,6 +672,462 @@ TEST_F(E2EFilterTest, largeMetadata) {
   EXPECT_EQ(1000, reader->numberOfRows());
 }
 
+TEST_F(E2EFilterTest, parallelDecoding) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(3);
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "struct_val:struct<a:bigint,b:string>",
+      [&]() { makeStringDistribution("string_val", 100, true, false); },
+      false,
+      {"short_val", "int_val", "long_val", "double_val", "string_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterMagic) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  rowType_ = ROW({INTEGER()});
+  std::vector<RowVectorPtr> batches;
+  batches.push_back(std::static_pointer_cast<RowVector>(
+      test::BatchMaker::createBatch(rowType_, 20000, *leafPool_, nullptr, 0)));
+  writeToMemory(rowType_, batches, false);
+  auto data = sinkPtr_->getData();
+  auto size = sinkPtr_->size();
+  EXPECT_EQ("PAR1", std::string(data, 4));
+  EXPECT_EQ("PAR1", std::string(data + size - 4, 4));
+}
+
+TEST_F(E2EFilterTest, nativeWriterIntegerDictionary) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  nativeWriterOptions_->defaultColumnOptions.pageSize = 4 * 1024;
+  nativeWriterOptions_->defaultColumnOptions.codec =
+      thrift::CompressionCodec::SNAPPY;
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+        makeAllNulls("long_null");
+      },
+      true,
+      {"short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterDataPageV2) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  auto& options = nativeWriterOptions_->defaultColumnOptions;
+  options.enableDictionary = false;
+  options.dataPageVersion = DataPageVersion::kV2;
+  options.codec = thrift::CompressionCodec::ZSTD;
+  options.pageSize = 4 * 1024;
+  options.encoding = thrift::Encoding::DELTA_BINARY_PACKED;
+  nativeWriterOptions_->columnOptions["boolean_val"] = options;
+  nativeWriterOptions_->columnOptions["boolean_val"].encoding =
+      thrift::Encoding::PLAIN;
+  testWithTypes(
+      "boolean_val:boolean,"
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint",
+      nullptr,
+      false,
+      {"boolean_val", "short_val", "int_val", "long_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterFloatAndDouble) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  auto& options = nativeWriterOptions_->defaultColumnOptions;
+  options.enableDictionary = false;
+  options.pageSize = 4 * 1024;
+  options.encoding = thrift::Encoding::BYTE_STREAM_SPLIT;
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_null:float",
+      [&]() { makeAllNulls("float_null"); },
+      false,
+      {"float_val", "double_val", "float_null"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterString) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  auto& options = nativeWriterOptions_->defaultColumnOptions;
+  options.codec = thrift::CompressionCodec::GZIP;
+  options.pageSize = 4 * 1024;
+  options.dictionaryPageSizeLimit = 20'000;
+  options.encoding = thrift::Encoding::DELTA_LENGTH_BYTE_ARRAY;
+  testWithTypes(
+      "string_val:string,"
+      "string_val_2:string,"
+      "string_const: string",
+      [&]() {
+        makeStringDistribution("string_val", 10000000, true, false);
+        makeStringDistribution("string_val_2", 170, false, true);
+        makeStringDistribution("string_const", 1, true, false);
+      },
+      true,
+      {"string_val", "string_val_2"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterStruct) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  testWithTypes(
+      "long_val:bigint,"
+      "outer_struct: struct<nested1:bigint, "
+      "inner_struct: struct<nested2: bigint>>",
+      [&]() {},
+      true,
+      {"long_val"},
+      10);
+}
+
+TEST_F(E2EFilterTest, nativeWriterBloomFilter) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  nativeWriterOptions_->defaultColumnOptions.bloomFilter = true;
+  // Doubles have no bloom filters.
+  nativeWriterOptions_->columnOptions["double_val"] =
+      nativeWriterOptions_->defaultColumnOptions;
+  nativeWriterOptions_->columnOptions["double_val"].bloomFilter = false;
+  testWithTypes(
+      "double_val:double,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() { makeStringUnique("string_val"); },
+      false,
+      {"int_val", "long_val", "string_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, nativeWriterDictionaryPruning) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  rowGroupSize_ = 1000;
+  rowType_ = ROW({"s", "i"}, {VARCHAR(), BIGINT()});
+  constexpr int32_t kNumRows = 5000;
+  auto strings = BaseVector::create<FlatVector<StringView>>(
+      VARCHAR(), kNumRows, leafPool_.get());
+  auto ints = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    // Each row group has "s0", "s2", "s4", "s6" and "s8".
+    strings->set(i, StringView(fmt::format("s{}", 2 * (i % 5))));
+    ints->set(i, i);
+  }
+  std::vector<RowVectorPtr> batches = {std::make_shared<RowVector>(
+      leafPool_.get(),
+      rowType_,
+      nullptr,
+      kNumRows,
+      std::vector<VectorPtr>{strings, ints})};
+  writeToMemory(rowType_, batches, false);
+
+  // Returns the number of rows passing an IN filter on 's' and sets
+  // 'numSkipped' to the number of skipped row groups.
+  auto countRows = [&](const std::vector<std::string>& values,
+                       int64_t& numSkipped) {
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->getOrCreateChild(Subfield("s"))
+        ->setFilter(std::make_unique<BytesValues>(values, false));
+    auto rowReader = makeRowReader(spec);
+    VectorPtr result = BaseVector::create(rowType_, 1, leafPool_.get());
+    int64_t numRows = 0;
+    while (rowReader->next(1000, result)) {
+      numRows += result->size();
+    }
+    RuntimeStatistics stats;
+    rowReader->updateRuntimeStats(stats);
+    numSkipped = stats.skippedStrides;
+    return numRows;
+  };
+
+  // The values are within the min and max of each row group, so only the
+  // dictionaries show that no row passes.
+  int64_t numSkipped;
+  EXPECT_EQ(0, countRows({"s1", "s3"}, numSkipped));
+  EXPECT_EQ(kNumRows / rowGroupSize_, numSkipped);
+  EXPECT_EQ(kNumRows / 5, countRows({"s3", "s4"}, numSkipped));
+  EXPECT_EQ(0, numSkipped);
+  EXPECT_EQ(2 * kNumRows / 5, countRows({"s0", "s5", "s8"}, numSkipped));
+  EXPECT_EQ(0, numSkipped);
+}
+
+TEST_F(E2EFilterTest, loadPagesOnDemand) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  // PLAIN pages of 100 rows.
+  nativeWriterOptions_->defaultColumnOptions.enableDictionary = false;
+  nativeWriterOptions_->defaultColumnOptions.maxRowsInPage = 100;
+  rowGroupSize_ = 2000;
+  rowType_ = ROW({"k", "v"}, {BIGINT(), BIGINT()});
+  constexpr int32_t kNumRows = 20000;
+  auto keys = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  auto values = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    // Only the first page of each row group has 7 in 'k' but the stats of all
+    // pages include 7.
+    auto key = (i * 37) % 1000;
+    keys->set(i, i % rowGroupSize_ < 100 ? 7 : (key == 7 ? 6 : key));
+    values->set(i, i);
+  }
+  writeToMemory(
+      rowType_,
+      {std::make_shared<RowVector>(
+          leafPool_.get(),
+          rowType_,
+          nullptr,
+          kNumRows,
+          std::vector<VectorPtr>{keys, values})},
+      false);
+
+  // Reads 'columns' with the filter k = 7 if 'filter' is true, checks 'v' if
+  // read and returns the number of bytes read from the file.
+  auto readBytes = [&](std::vector<std::string> columns, bool filter) {
+    std::vector<TypePtr> types(columns.size(), BIGINT());
+    auto readType = ROW(std::move(columns), std::move(types));
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*readType);
+    if (filter) {
+      spec->childByName("k")->setFilter(
+          std::make_unique<BigintRange>(7, 7, false));
+    }
+    auto rowReader = makeRowReader(spec);
+    VectorPtr result = BaseVector::create(readType, 1, leafPool_.get());
+    auto valuesIndex = readType->getChildIdxIfExists("v");
+    int32_t numRows = 0;
+    while (rowReader->next(100, result)) {
+      if (valuesIndex.has_value()) {
+        auto* v = result->as<RowVector>()
+                      ->childAt(valuesIndex.value())
+                      ->loadedVector()
+                      ->asFlatVector<int64_t>();
+        for (auto i = 0; i < result->size(); ++i) {
+          const auto row = numRows + i;
+          EXPECT_EQ(
+              filter ? row / 100 * rowGroupSize_ + row % 100 : row,
+              v->valueAt(i));
+        }
+      }
+      numRows += result->size();
+    }
+    EXPECT_EQ(filter ? kNumRows / rowGroupSize_ * 100 : kNumRows, numRows);
+    return readFile_->bytesRead();
+  };
+
+  // After the first row groups show that most batches have no passing rows,
+  // only the first page of 'v' is fetched in each row group.
+  const auto valuesBytes = readBytes({"v"}, false);
+  const auto keysBytes = readBytes({"k"}, true);
+  const auto filteredBytes = readBytes({"k", "v"}, true);
+  EXPECT_LT(filteredBytes - keysBytes, valuesBytes / 2);
+}
+
+TEST_F(E2EFilterTest, dictionaryEncodedStrings) {
+  nativeWriterOptions_ = NativeWriterOptions();
+  rowGroupSize_ = 10000;
+  rowType_ = ROW({"s"}, {VARCHAR()});
+  constexpr int32_t kNumRows = 10000;
+  auto strings = BaseVector::create<FlatVector<StringView>>(
+      VARCHAR(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    strings->set(i, StringView(fmt::format("string {}", i % 7)));
+  }
+  writeToMemory(
+      rowType_,
+      {std::make_shared<RowVector>(
+          leafPool_.get(),
+          rowType_,
+          nullptr,
+          kNumRows,
+          std::vector<VectorPtr>{strings})},
+      false);
+
+  for (auto makeFlat : {false, true}) {
+    SCOPED_TRACE(fmt::format("makeFlat {}", makeFlat));
+    auto spec = std::make_shared<ScanSpec>("<root>");
+    spec->addAllChildFields(*rowType_);
+    spec->childByName("s")->setMakeFlat(makeFlat);
+    auto rowReader = makeRowReader(spec);
+    VectorPtr result = BaseVector::create(rowType_, 1, leafPool_.get());
+    const BaseVector* dictionary = nullptr;
+    int32_t numRead = 0;
+    while (rowReader->next(1000, result)) {
+      auto values = result->as<RowVector>()->childAt(0);
+      // Loads the values if lazy.
+      values = BaseVector::loadedVectorShared(values);
+      for (auto i = 0; i < values->size(); ++i) {
+        ASSERT_EQ(
+            strings->valueAt(numRead + i),
+            values->as<SimpleVector<StringView>>()->valueAt(i));
+      }
+      numRead += values->size();
+      if (makeFlat) {
+        ASSERT_EQ(VectorEncoding::Simple::FLAT, values->encoding());
+        continue;
+      }
+      // All batches of the row group share the dictionary.
+      ASSERT_EQ(VectorEncoding::Simple::DICTIONARY, values->encoding());
+      ASSERT_EQ(7, values->valueVector()->size());
+      if (dictionary) {
+        ASSERT_EQ(dictionary, values->valueVector().get());
+      }
+      dictionary = values->valueVector().get();
+    }
+    ASSERT_EQ(kNumRows, numRead);
+  }
+}
+
+TEST_F(E2EFilterTest, prunedStructFields) {
+  constexpr int32_t kNumRows = 10000;
+  test::VectorMaker vectorMaker(leafPool_.get());
+  auto inner = vectorMaker.rowVector(
+      {"x", "y"},
+      {vectorMaker.flatVector<int32_t>(kNumRows, [](auto i) { return i; }),
+       vectorMaker.arrayVector<int32_t>(
+           kNumRows, [](auto i) { return i % 4; }, [](auto i) { return i; })});
+  auto outer = vectorMaker.rowVector(
+      {"a", "big", "t"},
+      {vectorMaker.flatVector<int64_t>(kNumRows, [](auto i) { return i; }),
+       vectorMaker.flatVector<std::string>(
+           kNumRows, [](auto i) { return std::string(100 + i % 10, 'x'); }),
+       inner});
+  for (auto i = 0; i < kNumRows; ++i) {
+    inner->setNull(i, i % 5 == 0);
+    outer->setNull(i, i % 7 == 0);
+  }
+  auto data = vectorMaker.rowVector(
+      {"c0", "s"},
+      {vectorMaker.flatVector<int64_t>(kNumRows, [](auto i) { return i; }),
+       outer});
+  rowType_ = asRowType(data->type());
+  writeToMemory(rowType_, {data}, false);
+
+  auto nullField = [&](const std::string& name, const TypePtr& type) {
+    return std::make_pair(
+        name, BaseVector::createNullConstant(type, 1, leafPool_.get()));
+  };
+  // Reads 'c0' and 's' with the fields of 's' in 'constantFields' and of 't'
+  // in 'constantInnerFields' pruned, checks the nulls of 's', 't' and the
+  // values of 't.x' if not pruned and returns the bytes read.
+  auto readBytes =
+      [&](std::vector<std::pair<std::string, VectorPtr>> constantFields,
+          std::vector<std::pair<std::string, VectorPtr>> constantInnerFields,
+          bool notNullFilter) {
+        auto spec = std::make_shared<ScanSpec>("<root>");
+        spec->addFieldRecursively("c0", *BIGINT(), 0);
+        auto* s = spec->addField("s", 1);
+        if (notNullFilter) {
+          s->setFilter(std::make_unique<IsNotNull>());
+        }
+        auto& sType = outer->type()->asRow();
+        for (auto i = 0; i < sType.size(); ++i) {
+          auto& name = sType.nameOf(i);
+          auto it = std::find_if(
+              constantFields.begin(), constantFields.end(), [&](auto& field) {
+                return field.first == name;
+              });
+          if (it != constantFields.end()) {
+            s->addField(name, i)->setConstantValue(it->second);
+          } else if (name != "t" || constantInnerFields.empty()) {
+            s->addFieldRecursively(name, *sType.childAt(i), i);
+          } else {
+            auto* t = s->addField(name, i);
+            t->addFieldRecursively("x", *INTEGER(), 0);
+            t->addField("y", 1)->setConstantValue(
+                constantInnerFields[0].second);
+          }
+        }
+        auto rowReader = makeRowReader(spec);
+        VectorPtr result = BaseVector::create(rowType_, 1, leafPool_.get());
+        int32_t numRows = 0;
+        int32_t numRead = 0;
+        while (auto numScanned = rowReader->next(1000, result)) {
+          auto* row = result->as<RowVector>();
+          auto* c0 = row->childAt(0)->loadedVector()->asFlatVector<int64_t>();
+          auto* actual = row->childAt(1)->loadedVector()->as<RowVector>();
+          for (auto i = 0; i < result->size(); ++i) {
+            const auto expected = c0->valueAt(i);
+            EXPECT_EQ(outer->isNullAt(expected), actual->isNullAt(i));
+            if (actual->isNullAt(i) ||
+                actual->childAt(2)->isConstantEncoding()) {
+              continue;
+            }
+            auto* t = actual->childAt(2)->as<RowVector>();
+            EXPECT_EQ(inner->isNullAt(expected), t->isNullAt(i));
+            if (!t->isNullAt(i)) {
+              EXPECT_EQ(
+                  expected,
+                  t->childAt(0)->as<SimpleVector<int32_t>>()->valueAt(i));
+            }
+          }
+          numRows += numScanned;
+          numRead += result->size();
+        }
+        EXPECT_EQ(kNumRows, numRows);
+        EXPECT_EQ(
+            notNullFilter ? kNumRows - (kNumRows + 6) / 7 : kNumRows,
+            numRead);
+        return readFile_->bytesRead();
+      };
+
+  const auto allBytes = readBytes({}, {}, false);
+  // Only 't.x' is read in 's'.
+  const auto innerBytes = readBytes(
+      {nullField("a", BIGINT()), nullField("big", VARCHAR())},
+      {nullField("y", ARRAY(INTEGER()))},
+      false);
+  EXPECT_LT(innerBytes, allBytes / 2);
+  // All fields of 's' are pruned. The nulls of 's' come from the smallest
+  // column, 't.x' of 4 byte values.
+  const auto prunedFields = std::vector<std::pair<std::string, VectorPtr>>{
+      nullField("a", BIGINT()),
+      nullField("big", VARCHAR()),
+      nullField("t", inner->type())};
+  EXPECT_LE(readBytes(prunedFields, {}, false), innerBytes);
+  EXPECT_LE(readBytes(prunedFields, {}, true), innerBytes);
+}
+
+TEST_F(E2EFilterTest, nativeWriterUnsupported) {
+  auto sink = std::make_unique<MemorySink>(*leafPool_, 1024);
+  VELOX_ASSERT_THROW(
+      NativeWriter(
+          std::move(sink), *leafPool_, ROW({"a"}, {ARRAY(BIGINT())})),
+      "ARRAY and MAP columns are not supported by the native Parquet writer");
+  NativeWriterOptions options;
+  options.columnOptions["b"] = ColumnChunkOptions();
+  sink = std::make_unique<MemorySink>(*leafPool_, 1024);
+  VELOX_ASSERT_THROW(
+      NativeWriter(
+          std::move(sink), *leafPool_, ROW({"a"}, {BIGINT()}), options),
+      "No leaf column for options: b");
+  options.columnOptions.clear();
+  options.defaultColumnOptions.encoding =
+      thrift::Encoding::DELTA_LENGTH_BYTE_ARRAY;
+  sink = std::make_unique<MemorySink>(*leafPool_, 1024);
+  VELOX_ASSERT_THROW(
+      NativeWriter(
+          std::move(sink), *leafPool_, ROW({"a"}, {BIGINT()}), options),
+      "DELTA_LENGTH_BYTE_ARRAY is only for BYTE_ARRAY columns");
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
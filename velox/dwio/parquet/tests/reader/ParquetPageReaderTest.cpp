@@ -14,9 +14,17 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+#include "velox/dwio/parquet/writer/PageEncoders.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
 
 using namespace facebook::velox;
 using namespace facebook::velox::common;
@@ -106,3 +114,263 @@ TEST_F(ParquetPageReaderTest, corruptedPageHeader) {
 
   EXPECT_THROW(pageReader->readPageHeader(), VeloxException);
 }
+
+TEST_F(ParquetPageReaderTest, rowRanges) {
+  RowRanges ranges = {{0, 100}};
+  removeRowRange(ranges, 10, 20);
+  EXPECT_EQ(ranges, (RowRanges{{0, 10}, {20, 100}}));
+  removeRowRange(ranges, 0, 10);
+  EXPECT_EQ(ranges, (RowRanges{{20, 100}}));
+  removeRowRange(ranges, 50, 200);
+  EXPECT_EQ(ranges, (RowRanges{{20, 50}}));
+  removeRowRange(ranges, 30, 40);
+  EXPECT_EQ(ranges, (RowRanges{{20, 30}, {40, 50}}));
+
+  EXPECT_FALSE(overlapsRowRanges(ranges, 0, 20));
+  EXPECT_TRUE(overlapsRowRanges(ranges, 0, 21));
+  EXPECT_FALSE(overlapsRowRanges(ranges, 30, 40));
+  EXPECT_TRUE(overlapsRowRanges(ranges, 35, 45));
+  EXPECT_FALSE(overlapsRowRanges(ranges, 50, 60));
+
+  removeRowRange(ranges, 0, 100);
+  EXPECT_TRUE(ranges.empty());
+}
+
+TEST_F(ParquetPageReaderTest, sparseChunkInputStream) {
+  std::string data;
+  for (auto i = 0; i < 100; ++i) {
+    data.push_back(static_cast<char>(i));
+  }
+  // Fetches bytes [0, 10) and [40, 60) in blocks of 7 bytes.
+  std::vector<SparseChunkInputStream::Range> ranges;
+  ranges.push_back(
+      {0, 10, std::make_unique<SeekableArrayInputStream>(data.data(), 10, 7)});
+  ranges.push_back(
+      {40,
+       20,
+       std::make_unique<SeekableArrayInputStream>(data.data() + 40, 20, 7)});
+  SparseChunkInputStream stream(std::move(ranges));
+
+  char buffer[20];
+  stream.readFully(buffer, 10);
+  EXPECT_EQ(0, memcmp(buffer, data.data(), 10));
+  EXPECT_EQ(stream.ByteCount(), 10);
+  const void* chunk;
+  int32_t size;
+  VELOX_ASSERT_THROW(stream.Next(&chunk, &size), "Reading an unfetched part");
+
+  std::vector<uint64_t> position = {45};
+  PositionProvider provider(position);
+  stream.seekToPosition(provider);
+  stream.readFully(buffer, 5);
+  EXPECT_EQ(0, memcmp(buffer, data.data() + 45, 5));
+  stream.BackUp(2);
+  EXPECT_EQ(stream.ByteCount(), 48);
+  stream.Skip(4);
+  stream.readFully(buffer, 8);
+  EXPECT_EQ(0, memcmp(buffer, data.data() + 52, 8));
+  EXPECT_FALSE(stream.Next(&chunk, &size));
+
+  // Skipping from the first range lands in the second one.
+  position = {5};
+  PositionProvider start(position);
+  stream.seekToPosition(start);
+  stream.Skip(45);
+  stream.readFully(buffer, 10);
+  EXPECT_EQ(0, memcmp(buffer, data.data() + 50, 10));
+
+  position = {20};
+  PositionProvider gap(position);
+  VELOX_ASSERT_THROW(stream.seekToPosition(gap), "Seeking to an unfetched");
+}
+
+TEST_F(ParquetPageReaderTest, sparseChunkInputStreamLoadOnDemand) {
+  std::string data;
+  for (auto i = 0; i < 100; ++i) {
+    data.push_back(static_cast<char>(i));
+  }
+  // Ranges [0, 10), [10, 30) and [50, 60), loaded when first read.
+  std::vector<int32_t> numLoads(3);
+  std::vector<SparseChunkInputStream::Range> ranges;
+  auto addRange = [&](int32_t index, uint64_t offset, uint64_t size) {
+    auto load = [&, index, offset, size]() {
+      ++numLoads[index];
+      return std::make_unique<SeekableArrayInputStream>(
+          data.data() + offset, size, 7);
+    };
+    ranges.push_back({offset, size, nullptr, std::move(load)});
+  };
+  addRange(0, 0, 10);
+  addRange(1, 10, 20);
+  addRange(2, 50, 10);
+  SparseChunkInputStream stream(std::move(ranges));
+  EXPECT_EQ(numLoads, std::vector<int32_t>({0, 0, 0}));
+
+  std::vector<uint64_t> position = {52};
+  PositionProvider provider(position);
+  stream.seekToPosition(provider);
+  char buffer[20];
+  stream.readFully(buffer, 5);
+  EXPECT_EQ(0, memcmp(buffer, data.data() + 52, 5));
+  EXPECT_EQ(numLoads, std::vector<int32_t>({0, 0, 1}));
+
+  // Reading past the end of a range continues in the adjacent one.
+  position = {5};
+  PositionProvider start(position);
+  stream.seekToPosition(start);
+  stream.readFully(buffer, 10);
+  EXPECT_EQ(0, memcmp(buffer, data.data() + 5, 10));
+  EXPECT_EQ(numLoads, std::vector<int32_t>({1, 1, 1}));
+}
+
+namespace {
+template <typename T>
+std::string serialize(const T& object) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  return buffer->getBufferAsString();
+}
+} // namespace
+
+TEST_F(ParquetPageReaderTest, pageIndex) {
+  thrift::ColumnIndex columnIndex;
+  columnIndex.__set_null_pages({false, true});
+  columnIndex.__set_min_values({"a", ""});
+  columnIndex.__set_max_values({"m", ""});
+  thrift::OffsetIndex offsetIndex;
+  thrift::PageLocation location;
+  location.__set_offset(4);
+  location.__set_compressed_page_size(100);
+  location.__set_first_row_index(0);
+  offsetIndex.page_locations.push_back(location);
+  location.__set_offset(104);
+  location.__set_first_row_index(1000);
+  offsetIndex.page_locations.push_back(location);
+
+  // The indexes follow some unrelated bytes as in a file.
+  const auto serializedColumnIndex = serialize(columnIndex);
+  const auto serializedOffsetIndex = serialize(offsetIndex);
+  const std::string file = std::string(200, 'x') + serializedColumnIndex +
+      serializedOffsetIndex;
+
+  thrift::RowGroup rowGroup;
+  rowGroup.columns.resize(2);
+  auto& chunk = rowGroup.columns[1];
+  chunk.__set_column_index_offset(200);
+  chunk.__set_column_index_length(serializedColumnIndex.size());
+  chunk.__set_offset_index_offset(200 + serializedColumnIndex.size());
+  chunk.__set_offset_index_length(serializedOffsetIndex.size());
+
+  BufferedInput input(std::make_shared<InMemoryReadFile>(file), *defaultPool);
+  PageIndex pageIndex(rowGroup, {0, 1}, input);
+  EXPECT_FALSE(pageIndex.columnIndex(0).has_value());
+  EXPECT_FALSE(pageIndex.offsetIndex(0).has_value());
+  EXPECT_EQ(pageIndex.columnIndex(1), columnIndex);
+  EXPECT_EQ(pageIndex.offsetIndex(1), offsetIndex);
+}
+
+TEST_F(ParquetPageReaderTest, bloomFilter) {
+  std::vector<char> zeros(SplitBlockBloomFilter::kBytesPerBlock * 64);
+  SplitBlockBloomFilter bloomFilter(zeros.data(), zeros.size());
+  for (int64_t i = 0; i < 100; ++i) {
+    bloomFilter.insert(SplitBlockBloomFilter::hash(i * 7));
+  }
+  bloomFilter.insert(SplitBlockBloomFilter::hash(std::string_view("velox")));
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(bloomFilter.mayContain(SplitBlockBloomFilter::hash(i * 7)));
+  }
+  EXPECT_TRUE(bloomFilter.mayContain(
+      SplitBlockBloomFilter::hash(std::string_view("velox"))));
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 1000; ++i) {
+    numFalsePositives +=
+        bloomFilter.mayContain(SplitBlockBloomFilter::hash(i * 7 + 1));
+  }
+  EXPECT_LT(numFalsePositives, 50);
+  // An int32 hashes its 4 bytes, not the bytes of the widened value.
+  EXPECT_NE(
+      SplitBlockBloomFilter::hash(static_cast<int32_t>(7)),
+      SplitBlockBloomFilter::hash(static_cast<int64_t>(7)));
+
+  thrift::BloomFilterHeader header;
+  header.__set_numBytes(zeros.size());
+  header.algorithm.__set_BLOCK(thrift::SplitBlockAlgorithm());
+  header.hash.__set_XXHASH(thrift::XxHash());
+  header.compression.__set_UNCOMPRESSED(thrift::Uncompressed());
+  const auto serializedHeader = serialize(header);
+  std::string bitset(zeros.size(), 0);
+  memcpy(bitset.data(), bloomFilter.bitset().data(), bitset.size());
+  // A filter of an unsupported algorithm is not returned.
+  thrift::BloomFilterHeader unsupportedHeader;
+  unsupportedHeader.__set_numBytes(zeros.size());
+  const auto serializedUnsupported = serialize(unsupportedHeader);
+  const std::string file = std::string(10, 'x') + serializedHeader + bitset +
+      serializedUnsupported + bitset;
+
+  BufferedInput input(std::make_shared<InMemoryReadFile>(file), *defaultPool);
+  const int64_t unsupportedOffset =
+      10 + serializedHeader.size() + bitset.size();
+  auto bloomFilters = readBloomFilters({unsupportedOffset, 10}, input);
+  ASSERT_EQ(bloomFilters.size(), 2);
+  EXPECT_EQ(bloomFilters[0], nullptr);
+  ASSERT_NE(bloomFilters[1], nullptr);
+  EXPECT_EQ(bloomFilters[1]->bitset(), bloomFilter.bitset());
+  EXPECT_TRUE(
+      bloomFilters[1]->mayContain(SplitBlockBloomFilter::hash(int64_t(693))));
+  VELOX_ASSERT_THROW(
+      readBloomFilters({static_cast<int64_t>(file.size())}, input),
+      "Bad bloom filter offset");
+}
+
+TEST_F(ParquetPageReaderTest, rleBpEncoder) {
+  std::vector<uint32_t> values;
+  for (auto i = 0; i < 100; ++i) {
+    values.push_back(i % 7);
+  }
+  values.insert(values.end(), 50, 3);
+  for (auto i = 0; i < 13; ++i) {
+    values.push_back(i % 5);
+  }
+  RleBpEncoder encoder(3);
+  for (auto value : values) {
+    encoder.put(value);
+  }
+  std::string encoded;
+  encoder.flush(encoded);
+  EXPECT_EQ(encoder.size(), 0);
+  arrow::util::RleDecoder decoder(
+      reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size(), 3);
+  std::vector<uint32_t> decoded(values.size());
+  ASSERT_EQ(decoder.GetBatch(decoded.data(), decoded.size()), values.size());
+  EXPECT_EQ(decoded, values);
+}
+
+TEST_F(ParquetPageReaderTest, deltaBinaryPackedEncoder) {
+  std::vector<int64_t> values = {
+      std::numeric_limits<int64_t>::max(),
+      std::numeric_limits<int64_t>::min(),
+      0,
+      -1};
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(i * i - 1000);
+  }
+  std::string encoded;
+  encodeDeltaBinaryPacked(values.data(), values.size(), encoded);
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+  ASSERT_EQ(decoder.numValues(), values.size());
+  std::vector<int64_t> decoded(values.size());
+  decoder.decode(decoded.data());
+  EXPECT_EQ(decoded, values);
+  EXPECT_EQ(decoder.bufferStart(), encoded.data() + encoded.size());
+
+  std::vector<int32_t> ints = {7, 7, 7, 7, 7, 7, 7, 7, 7, -3};
+  encoded.clear();
+  encodeDeltaBinaryPacked(ints.data(), ints.size(), encoded);
+  DeltaBpDecoder intDecoder(encoded.data(), encoded.data() + encoded.size());
+  std::vector<int32_t> decodedInts(ints.size());
+  intDecoder.decode(decodedInts.data());
+  EXPECT_EQ(decodedInts, ints);
+}
@@ -58,6 +58,39 @@ TEST_F(ParquetReaderTest, parseSample) {
   EXPECT_EQ(type->childByName("b"), col1);
 }
 
+TEST_F(ParquetReaderTest, sections) {
+  // sample.parquet has 2 row groups of 10 rows.
+  auto rowType = ROW({"a"}, {BIGINT()});
+  ReaderOptions readerOpts{defaultPool.get()};
+  ParquetReader reader =
+      createReader(getExampleFilePath("sample.parquet"), readerOpts);
+  auto sections = reader.sections();
+  ASSERT_EQ(sections.size(), 2);
+  EXPECT_EQ(sections[0].numRows, 10);
+  EXPECT_EQ(sections[1].numRows, 10);
+  EXPECT_LT(sections[0].offset, sections[1].offset);
+  EXPECT_GT(sections[0].length, 0);
+
+  // A range from one section offset to the next reads that section.
+  for (auto i = 0; i < sections.size(); ++i) {
+    RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(makeScanSpec(rowType));
+    const auto end = i + 1 < sections.size() ? sections[i + 1].offset
+                                             : sections[i].offset + 1;
+    rowReaderOpts.range(sections[i].offset, end - sections[i].offset);
+    auto rowReader = reader.createRowReader(rowReaderOpts);
+    auto result = BaseVector::create(rowType, 1, pool_.get());
+    ASSERT_TRUE(rowReader->next(100, result));
+    ASSERT_EQ(result->size(), 10);
+    auto* a = result->as<RowVector>()
+                  ->childAt(0)
+                  ->loadedVector()
+                  ->asFlatVector<int64_t>();
+    EXPECT_EQ(a->valueAt(0), 1 + i * 10);
+    ASSERT_FALSE(rowReader->next(100, result));
+  }
+}
+
 TEST_F(ParquetReaderTest, parseInCaseSensitive) {
   // sample.parquet holds three columns (A: BIGINT, b: BIGINT) and
   // 2 rows
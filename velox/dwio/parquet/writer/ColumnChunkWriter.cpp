@@ -0,0 +1,800 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+#include "velox/dwio/parquet/writer/PageEncoders.h"
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include <snappy.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Min and max values longer than this are not written.
+constexpr size_t kMaxStatsSize = 4096;
+
+void appendBytes(
+    dwio::common::DataBuffer<char>& out,
+    const char* data,
+    size_t size) {
+  if (size > 0) {
+    out.extendAppend(out.size(), data, size);
+  }
+}
+
+// Compresses 'input' with 'codec' into 'output'.
+void compress(
+    thrift::CompressionCodec::type codec,
+    const std::string& input,
+    std::string& output) {
+  switch (codec) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      output = input;
+      return;
+    case thrift::CompressionCodec::SNAPPY: {
+      output.resize(snappy::MaxCompressedLength(input.size()));
+      size_t size;
+      snappy::RawCompress(input.data(), input.size(), output.data(), &size);
+      output.resize(size);
+      return;
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      output.resize(ZSTD_compressBound(input.size()));
+      auto size = ZSTD_compress(
+          output.data(),
+          output.size(),
+          input.data(),
+          input.size(),
+          ZSTD_CLEVEL_DEFAULT);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD returned an error: {}",
+          ZSTD_getErrorName(size));
+      output.resize(size);
+      return;
+    }
+    case thrift::CompressionCodec::GZIP: {
+      z_stream stream;
+      memset(&stream, 0, sizeof(stream));
+      // 16 over the window bits writes a gzip header.
+      constexpr int kWindowBits = 15 + 16;
+      auto ret = deflateInit2(
+          &stream,
+          Z_DEFAULT_COMPRESSION,
+          Z_DEFLATED,
+          kWindowBits,
+          8,
+          Z_DEFAULT_STRATEGY);
+      VELOX_CHECK_EQ(ret, Z_OK, "zlib deflateInit failed");
+      output.resize(deflateBound(&stream, input.size()));
+      stream.next_in =
+          const_cast<Bytef*>(reinterpret_cast<const Bytef*>(input.data()));
+      stream.avail_in = input.size();
+      stream.next_out = reinterpret_cast<Bytef*>(output.data());
+      stream.avail_out = output.size();
+      ret = deflate(&stream, Z_FINISH);
+      deflateEnd(&stream);
+      VELOX_CHECK_EQ(ret, Z_STREAM_END, "zlib deflate failed");
+      output.resize(stream.total_out);
+      return;
+    }
+    default:
+      VELOX_UNSUPPORTED("Unsupported Parquet compression type '{}'", codec);
+  }
+}
+
+// Returns the bytes of 'value' in min_value and max_value of Statistics and
+// ColumnIndex.
+template <typename T>
+std::string statsBytes(const T& value) {
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    return std::string(value);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return std::string(1, value ? 1 : 0);
+  } else {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+template <typename T>
+int64_t plainSize(const T& value) {
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    return sizeof(uint32_t) + value.size();
+  } else {
+    return sizeof(T);
+  }
+}
+
+// The key of a dictionary entry. Floating point values are keyed by their bits
+// so that -0.0 and NaN get entries of their own.
+template <typename T>
+struct DictionaryKey {
+  using Type = T;
+  static T of(T value) {
+    return value;
+  }
+};
+
+template <>
+struct DictionaryKey<float> {
+  using Type = uint32_t;
+  static uint32_t of(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template <>
+struct DictionaryKey<double> {
+  using Type = uint64_t;
+  static uint64_t of(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+// Strings are looked up by std::string_view and copied into the key.
+template <>
+struct DictionaryKey<std::string_view> {
+  using Type = std::string;
+  static std::string_view of(std::string_view value) {
+    return value;
+  }
+};
+
+// Writes the values of a leaf column of Velox type V stored as Parquet
+// physical type T.
+template <typename T, typename V>
+class TypedColumnChunkWriter : public ColumnChunkWriter {
+ public:
+  TypedColumnChunkWriter(
+      const TypePtr& type,
+      std::vector<std::string> path,
+      int16_t maxDefine,
+      const ColumnChunkOptions& options,
+      memory::MemoryPool& pool)
+      : type_(type),
+        path_(std::move(path)),
+        maxDefine_(maxDefine),
+        options_(options),
+        pages_(pool) {
+    resetChunk();
+  }
+
+  void write(
+      const DecodedVector& decoded,
+      const vector_size_t* rows,
+      const int16_t* levels,
+      int32_t numRows) override {
+    for (auto i = 0; i < numRows; ++i) {
+      if (levels[i] == maxDefine_ - 1 && !decoded.isNullAt(rows[i])) {
+        levels_.push_back(maxDefine_);
+        append(toPhysical(decoded.valueAt<V>(rows[i])));
+      } else {
+        levels_.push_back(levels[i]);
+      }
+      if (useDictionary_ &&
+          dictionaryBytes_ > options_.dictionaryPageSizeLimit) {
+        // Falls back to 'options_.encoding' for the rest of the chunk.
+        finishPage();
+        useDictionary_ = false;
+      } else if (
+          pageBytes_ >= options_.pageSize ||
+          static_cast<int64_t>(levels_.size()) >= options_.maxRowsInPage) {
+        finishPage();
+      }
+    }
+  }
+
+  uint64_t bufferedBytes() const override {
+    return pages_.size() + pageBytes_ + dictionaryBytes_;
+  }
+
+  FinishedColumnChunk finishChunk(
+      int64_t offset,
+      dwio::common::DataBuffer<char>& out) override;
+
+ private:
+  using StatsType = std::conditional_t<
+      std::is_same_v<T, std::string_view>,
+      std::string,
+      T>;
+  using DictionaryMap = std::conditional_t<
+      std::is_same_v<T, std::string_view>,
+      folly::F14NodeMap<std::string, int32_t>,
+      folly::F14FastMap<typename DictionaryKey<T>::Type, int32_t>>;
+
+  static T toPhysical(const V& value) {
+    if constexpr (std::is_same_v<V, StringView>) {
+      return std::string_view(value.data(), value.size());
+    } else if constexpr (std::is_same_v<V, Date>) {
+      return value.days();
+    } else if constexpr (std::is_same_v<V, UnscaledShortDecimal>) {
+      return value.unscaledValue();
+    } else {
+      return static_cast<T>(value);
+    }
+  }
+
+  static bool isNaN(const T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return std::isnan(value);
+    } else {
+      return false;
+    }
+  }
+
+  static uint64_t bloomFilterHash(const T& value) {
+    if constexpr (
+        std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+        std::is_same_v<T, std::string_view>) {
+      return SplitBlockBloomFilter::hash(value);
+    } else {
+      VELOX_UNREACHABLE();
+    }
+  }
+
+  void append(T value) {
+    pageBytes_ += plainSize(value);
+    if (useDictionary_) {
+      indices_.push_back(dictionaryIndex(value));
+      return;
+    }
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      stringData_.append(value);
+      stringEnds_.push_back(stringData_.size());
+    } else {
+      values_.push_back(value);
+    }
+    if (options_.bloomFilter) {
+      bloomFilterHashes_.insert(bloomFilterHash(value));
+    }
+  }
+
+  int32_t dictionaryIndex(T value) {
+    const auto key = DictionaryKey<T>::of(value);
+    auto it = dictionaryIndex_.find(key);
+    if (it != dictionaryIndex_.end()) {
+      return it->second;
+    }
+    const int32_t index = dictionary_.size();
+    auto inserted = dictionaryIndex_.emplace(key, index).first;
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      // The keys of a node map do not move.
+      dictionary_.push_back(std::string_view(inserted->first));
+    } else {
+      dictionary_.push_back(value);
+    }
+    dictionaryBytes_ += plainSize(value);
+    if (options_.bloomFilter) {
+      bloomFilterHashes_.insert(bloomFilterHash(value));
+    }
+    return index;
+  }
+
+  // Returns the values of the current page when not dictionary encoded.
+  // 'views' holds the strings of a string column.
+  const T* pageValues(std::vector<std::string_view>& views) const {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      views.resize(stringEnds_.size());
+      uint32_t begin = 0;
+      for (auto i = 0; i < stringEnds_.size(); ++i) {
+        views[i] = std::string_view(
+            stringData_.data() + begin, stringEnds_[i] - begin);
+        begin = stringEnds_[i];
+      }
+      return views.data();
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return reinterpret_cast<const bool*>(values_.data());
+    } else {
+      return values_.data();
+    }
+  }
+
+  int64_t numPageValues() const {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return stringEnds_.size();
+    } else {
+      return values_.size();
+    }
+  }
+
+  void encodeValues(const T* values, int64_t numValues, std::string& out) {
+    switch (options_.encoding) {
+      case thrift::Encoding::PLAIN:
+        encodePlain(values, numValues, out);
+        return;
+      case thrift::Encoding::DELTA_BINARY_PACKED:
+        if constexpr (
+            std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+          encodeDeltaBinaryPacked(values, numValues, out);
+          return;
+        }
+        break;
+      case thrift::Encoding::DELTA_LENGTH_BYTE_ARRAY:
+        if constexpr (std::is_same_v<T, std::string_view>) {
+          encodeDeltaLengthByteArray(values, numValues, out);
+          return;
+        }
+        break;
+      case thrift::Encoding::BYTE_STREAM_SPLIT:
+        if constexpr (std::is_floating_point_v<T>) {
+          encodeByteStreamSplit(values, numValues, out);
+          return;
+        }
+        break;
+      default:
+        break;
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Encodes the buffered values and levels into a data page.
+  void finishPage();
+
+  void resetChunk();
+
+  // Returns the serialized header and bitset of the bloom filter of the
+  // values of the chunk.
+  std::string makeBloomFilter() const;
+
+  const TypePtr type_;
+  const std::vector<std::string> path_;
+  const int16_t maxDefine_;
+  const ColumnChunkOptions options_;
+
+  // Data pages of the current chunk.
+  dwio::common::DataBuffer<char> pages_;
+
+  // Values and levels of the current page.
+  std::vector<int16_t> levels_;
+  std::vector<uint32_t> indices_;
+  std::vector<std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>>
+      values_;
+  std::string stringData_;
+  std::vector<uint32_t> stringEnds_;
+  int64_t pageBytes_{0};
+
+  bool useDictionary_;
+  bool chunkHasDictionaryPages_;
+  DictionaryMap dictionaryIndex_;
+  std::vector<T> dictionary_;
+  int64_t dictionaryBytes_;
+
+  // Totals of the current chunk.
+  int64_t numValuesInChunk_;
+  int64_t numNullsInChunk_;
+  int64_t uncompressedSize_;
+  std::optional<StatsType> min_;
+  std::optional<StatsType> max_;
+  bool hasMinMax_;
+  std::set<thrift::Encoding::type> encodings_;
+  // Number of pages by page type and encoding.
+  std::map<std::pair<thrift::PageType::type, thrift::Encoding::type>, int32_t>
+      pageEncodings_;
+  std::vector<thrift::PageLocation> pageLocations_;
+  thrift::ColumnIndex columnIndex_;
+  bool hasColumnIndex_;
+  folly::F14FastSet<uint64_t> bloomFilterHashes_;
+};
+
+template <typename T, typename V>
+void TypedColumnChunkWriter<T, V>::finishPage() {
+  if (levels_.empty()) {
+    return;
+  }
+  const int64_t numValues = levels_.size();
+  std::optional<T> min;
+  std::optional<T> max;
+  auto updateMinMax = [&](const T& value) {
+    if (isNaN(value)) {
+      return;
+    }
+    if (!min.has_value() || value < *min) {
+      min = value;
+    }
+    if (!max.has_value() || value > *max) {
+      max = value;
+    }
+  };
+
+  std::string data;
+  thrift::Encoding::type encoding;
+  int64_t numNonNulls;
+  if (useDictionary_) {
+    numNonNulls = indices_.size();
+    for (auto index : indices_) {
+      updateMinMax(dictionary_[index]);
+    }
+    encoding = thrift::Encoding::RLE_DICTIONARY;
+    const auto indexBitWidth = std::max<uint8_t>(
+        1, bitWidth(dictionary_.empty() ? 0 : dictionary_.size() - 1));
+    data.push_back(indexBitWidth);
+    RleBpEncoder encoder(indexBitWidth);
+    for (auto index : indices_) {
+      encoder.put(index);
+    }
+    encoder.flush(data);
+    chunkHasDictionaryPages_ = true;
+  } else {
+    std::vector<std::string_view> views;
+    const T* values = pageValues(views);
+    numNonNulls = numPageValues();
+    for (auto i = 0; i < numNonNulls; ++i) {
+      updateMinMax(values[i]);
+    }
+    encoding = options_.encoding;
+    encodeValues(values, numNonNulls, data);
+  }
+  std::string levels;
+  if (maxDefine_ > 0) {
+    RleBpEncoder encoder(bitWidth(maxDefine_));
+    for (auto level : levels_) {
+      encoder.put(level);
+    }
+    encoder.flush(levels);
+  }
+
+  thrift::Statistics stats;
+  stats.__set_null_count(numValues - numNonNulls);
+  const bool hasMinMax = min.has_value() &&
+      statsBytes(*min).size() <= kMaxStatsSize &&
+      statsBytes(*max).size() <= kMaxStatsSize;
+  if (hasMinMax) {
+    stats.__set_min_value(statsBytes(*min));
+    stats.__set_max_value(statsBytes(*max));
+  }
+
+  thrift::PageHeader header;
+  std::string body;
+  int32_t uncompressedSize;
+  if (options_.dataPageVersion == DataPageVersion::kV1) {
+    std::string uncompressed;
+    if (maxDefine_ > 0) {
+      const uint32_t levelsSize = levels.size();
+      uncompressed.append(
+          reinterpret_cast<const char*>(&levelsSize), sizeof(levelsSize));
+      uncompressed.append(levels);
+    }
+    uncompressed.append(data);
+    compress(options_.codec, uncompressed, body);
+    uncompressedSize = uncompressed.size();
+    thrift::DataPageHeader dataPageHeader;
+    dataPageHeader.__set_num_values(numValues);
+    dataPageHeader.__set_encoding(encoding);
+    dataPageHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+    dataPageHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+    dataPageHeader.__set_statistics(stats);
+    header.__set_type(thrift::PageType::DATA_PAGE);
+    header.__set_data_page_header(dataPageHeader);
+  } else {
+    // The levels of a v2 page are not compressed.
+    std::string compressed;
+    compress(options_.codec, data, compressed);
+    uncompressedSize = levels.size() + data.size();
+    body = levels + compressed;
+    thrift::DataPageHeaderV2 dataPageHeader;
+    dataPageHeader.__set_num_values(numValues);
+    dataPageHeader.__set_num_nulls(numValues - numNonNulls);
+    dataPageHeader.__set_num_rows(numValues);
+    dataPageHeader.__set_encoding(encoding);
+    dataPageHeader.__set_definition_levels_byte_length(levels.size());
+    dataPageHeader.__set_repetition_levels_byte_length(0);
+    dataPageHeader.__set_is_compressed(
+        options_.codec != thrift::CompressionCodec::UNCOMPRESSED);
+    dataPageHeader.__set_statistics(stats);
+    header.__set_type(thrift::PageType::DATA_PAGE_V2);
+    header.__set_data_page_header_v2(dataPageHeader);
+  }
+  header.__set_uncompressed_page_size(uncompressedSize);
+  header.__set_compressed_page_size(body.size());
+  const auto headerBytes = serializeThrift(header);
+
+  thrift::PageLocation location;
+  location.__set_offset(pages_.size());
+  location.__set_compressed_page_size(headerBytes.size() + body.size());
+  location.__set_first_row_index(numValuesInChunk_);
+  pageLocations_.push_back(location);
+  appendBytes(pages_, headerBytes.data(), headerBytes.size());
+  appendBytes(pages_, body.data(), body.size());
+  uncompressedSize_ += headerBytes.size() + uncompressedSize;
+
+  columnIndex_.null_pages.push_back(numNonNulls == 0);
+  columnIndex_.min_values.push_back(hasMinMax ? stats.min_value : "");
+  columnIndex_.max_values.push_back(hasMinMax ? stats.max_value : "");
+  columnIndex_.null_counts.push_back(numValues - numNonNulls);
+  if (hasMinMax) {
+    if (!min_.has_value() || *min < T(*min_)) {
+      min_ = StatsType(*min);
+    }
+    if (!max_.has_value() || *max > T(*max_)) {
+      max_ = StatsType(*max);
+    }
+  } else if (numNonNulls > 0) {
+    // A page with values needs a min and max in the column index.
+    hasColumnIndex_ = false;
+    hasMinMax_ = false;
+  }
+  numValuesInChunk_ += numValues;
+  numNullsInChunk_ += numValues - numNonNulls;
+  encodings_.insert(encoding);
+  ++pageEncodings_[{header.type, encoding}];
+
+  levels_.clear();
+  indices_.clear();
+  values_.clear();
+  stringData_.clear();
+  stringEnds_.clear();
+  pageBytes_ = 0;
+}
+
+template <typename T, typename V>
+FinishedColumnChunk TypedColumnChunkWriter<T, V>::finishChunk(
+    int64_t offset,
+    dwio::common::DataBuffer<char>& out) {
+  finishPage();
+  int64_t dictionaryPageSize = 0;
+  if (chunkHasDictionaryPages_) {
+    std::string plain;
+    if constexpr (!std::is_same_v<T, bool>) {
+      encodePlain(dictionary_.data(), dictionary_.size(), plain);
+    }
+    std::string compressed;
+    compress(options_.codec, plain, compressed);
+    thrift::DictionaryPageHeader dictionaryPageHeader;
+    dictionaryPageHeader.__set_num_values(dictionary_.size());
+    dictionaryPageHeader.__set_encoding(thrift::Encoding::PLAIN);
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+    header.__set_uncompressed_page_size(plain.size());
+    header.__set_compressed_page_size(compressed.size());
+    header.__set_dictionary_page_header(dictionaryPageHeader);
+    const auto headerBytes = serializeThrift(header);
+    appendBytes(out, headerBytes.data(), headerBytes.size());
+    appendBytes(out, compressed.data(), compressed.size());
+    dictionaryPageSize = headerBytes.size() + compressed.size();
+    uncompressedSize_ += headerBytes.size() + plain.size();
+    encodings_.insert(thrift::Encoding::PLAIN);
+    ++pageEncodings_[{
+        thrift::PageType::DICTIONARY_PAGE, thrift::Encoding::PLAIN}];
+  }
+  appendBytes(out, pages_.data(), pages_.size());
+  const int64_t dataPageOffset = offset + dictionaryPageSize;
+
+  FinishedColumnChunk result;
+  thrift::ColumnMetaData metaData;
+  metaData.__set_type(physicalType(*type_));
+  encodings_.insert(thrift::Encoding::RLE);
+  metaData.__set_encodings(std::vector<thrift::Encoding::type>(
+      encodings_.begin(), encodings_.end()));
+  // The encoding stats tell readers whether all data pages are dictionary
+  // encoded, which 'encodings' does not since the dictionary page is PLAIN.
+  std::vector<thrift::PageEncodingStats> encodingStats;
+  for (const auto& [key, count] : pageEncodings_) {
+    thrift::PageEncodingStats pageStats;
+    pageStats.__set_page_type(key.first);
+    pageStats.__set_encoding(key.second);
+    pageStats.__set_count(count);
+    encodingStats.push_back(pageStats);
+  }
+  metaData.__set_encoding_stats(encodingStats);
+  metaData.__set_path_in_schema(path_);
+  metaData.__set_codec(options_.codec);
+  metaData.__set_num_values(numValuesInChunk_);
+  metaData.__set_total_uncompressed_size(uncompressedSize_);
+  metaData.__set_total_compressed_size(dictionaryPageSize + pages_.size());
+  metaData.__set_data_page_offset(dataPageOffset);
+  if (chunkHasDictionaryPages_) {
+    metaData.__set_dictionary_page_offset(offset);
+  }
+  thrift::Statistics stats;
+  stats.__set_null_count(numNullsInChunk_);
+  if (hasMinMax_ && min_.has_value()) {
+    stats.__set_min_value(statsBytes(T(*min_)));
+    stats.__set_max_value(statsBytes(T(*max_)));
+  }
+  metaData.__set_statistics(stats);
+  result.chunk.__set_file_offset(offset);
+  result.chunk.__set_meta_data(metaData);
+
+  for (auto& location : pageLocations_) {
+    location.offset += dataPageOffset;
+  }
+  result.offsetIndex.__set_page_locations(std::move(pageLocations_));
+  if (hasColumnIndex_) {
+    columnIndex_.__set_boundary_order(thrift::BoundaryOrder::UNORDERED);
+    columnIndex_.__isset.null_counts = true;
+    result.columnIndex = std::move(columnIndex_);
+  }
+  if (options_.bloomFilter) {
+    result.bloomFilter = makeBloomFilter();
+  }
+  resetChunk();
+  return result;
+}
+
+template <typename T, typename V>
+void TypedColumnChunkWriter<T, V>::resetChunk() {
+  pages_.clear();
+  useDictionary_ = options_.enableDictionary && !std::is_same_v<T, bool>;
+  chunkHasDictionaryPages_ = false;
+  dictionaryIndex_.clear();
+  dictionary_.clear();
+  dictionaryBytes_ = 0;
+  numValuesInChunk_ = 0;
+  numNullsInChunk_ = 0;
+  uncompressedSize_ = 0;
+  min_.reset();
+  max_.reset();
+  hasMinMax_ = true;
+  encodings_.clear();
+  pageEncodings_.clear();
+  pageLocations_.clear();
+  columnIndex_ = thrift::ColumnIndex();
+  hasColumnIndex_ = true;
+  bloomFilterHashes_.clear();
+}
+
+template <typename T, typename V>
+std::string TypedColumnChunkWriter<T, V>::makeBloomFilter() const {
+  // The size for 'bloomFilterFpp' with 8 bits set per value, see
+  // https://github.com/apache/parquet-format/blob/master/BloomFilter.md.
+  const double numDistinct =
+      std::max<size_t>(1, bloomFilterHashes_.size());
+  const double numBits = -8 * numDistinct /
+      std::log(1 - std::pow(options_.bloomFilterFpp, 1.0 / 8));
+  int64_t numBytes = SplitBlockBloomFilter::kBytesPerBlock;
+  while (numBytes * 8 < numBits &&
+         numBytes * 2 <= options_.maxBloomFilterBytes) {
+    numBytes *= 2;
+  }
+  std::vector<char> bitset(numBytes);
+  SplitBlockBloomFilter bloomFilter(bitset.data(), numBytes);
+  for (auto hash : bloomFilterHashes_) {
+    bloomFilter.insert(hash);
+  }
+  thrift::BloomFilterHeader header;
+  header.__set_numBytes(numBytes);
+  header.algorithm.__set_BLOCK(thrift::SplitBlockAlgorithm());
+  header.hash.__set_XXHASH(thrift::XxHash());
+  header.compression.__set_UNCOMPRESSED(thrift::Uncompressed());
+  auto result = serializeThrift(header);
+  result.append(
+      reinterpret_cast<const char*>(bloomFilter.bitset().data()), numBytes);
+  return result;
+}
+
+} // namespace
+
+// static
+thrift::Type::type ColumnChunkWriter::physicalType(const Type& type) {
+  switch (type.kind()) {
+    case TypeKind::BOOLEAN:
+      return thrift::Type::BOOLEAN;
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return thrift::Type::INT32;
+    case TypeKind::BIGINT:
+    case TypeKind::SHORT_DECIMAL:
+      return thrift::Type::INT64;
+    case TypeKind::REAL:
+      return thrift::Type::FLOAT;
+    case TypeKind::DOUBLE:
+      return thrift::Type::DOUBLE;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return thrift::Type::BYTE_ARRAY;
+    default:
+      VELOX_UNSUPPORTED(
+          "Type not supported by the native Parquet writer: {}",
+          type.toString());
+  }
+}
+
+// static
+std::unique_ptr<ColumnChunkWriter> ColumnChunkWriter::create(
+    const TypePtr& type,
+    std::vector<std::string> path,
+    int16_t maxDefine,
+    const ColumnChunkOptions& options,
+    memory::MemoryPool& pool) {
+  const auto physical = physicalType(*type);
+  switch (options.encoding) {
+    case thrift::Encoding::PLAIN:
+      break;
+    case thrift::Encoding::DELTA_BINARY_PACKED:
+      VELOX_USER_CHECK(
+          physical == thrift::Type::INT32 || physical == thrift::Type::INT64,
+          "DELTA_BINARY_PACKED is only for INT32 and INT64 columns");
+      break;
+    case thrift::Encoding::DELTA_LENGTH_BYTE_ARRAY:
+      VELOX_USER_CHECK(
+          physical == thrift::Type::BYTE_ARRAY,
+          "DELTA_LENGTH_BYTE_ARRAY is only for BYTE_ARRAY columns");
+      break;
+    case thrift::Encoding::BYTE_STREAM_SPLIT:
+      VELOX_USER_CHECK(
+          physical == thrift::Type::FLOAT || physical == thrift::Type::DOUBLE,
+          "BYTE_STREAM_SPLIT is only for FLOAT and DOUBLE columns");
+      break;
+    default:
+      VELOX_UNSUPPORTED("Encoding not supported yet: {}", options.encoding);
+  }
+  VELOX_USER_CHECK(
+      !options.bloomFilter || physical == thrift::Type::INT32 ||
+          physical == thrift::Type::INT64 ||
+          physical == thrift::Type::BYTE_ARRAY,
+      "Bloom filters are only for INT32, INT64 and BYTE_ARRAY columns");
+  VELOX_USER_CHECK(
+      !options.bloomFilter ||
+          (options.bloomFilterFpp > 0 && options.bloomFilterFpp < 1),
+      "Bloom filter false positive probability must be in (0, 1)");
+  VELOX_USER_CHECK_GE(
+      options.maxBloomFilterBytes, SplitBlockBloomFilter::kBytesPerBlock);
+
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<TypedColumnChunkWriter<bool, bool>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::TINYINT:
+      return std::make_unique<TypedColumnChunkWriter<int32_t, int8_t>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<TypedColumnChunkWriter<int32_t, int16_t>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<TypedColumnChunkWriter<int32_t, int32_t>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::DATE:
+      return std::make_unique<TypedColumnChunkWriter<int32_t, Date>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<TypedColumnChunkWriter<int64_t, int64_t>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::SHORT_DECIMAL:
+      return std::make_unique<
+          TypedColumnChunkWriter<int64_t, UnscaledShortDecimal>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::REAL:
+      return std::make_unique<TypedColumnChunkWriter<float, float>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<TypedColumnChunkWriter<double, double>>(
+          type, std::move(path), maxDefine, options, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<
+          TypedColumnChunkWriter<std::string_view, StringView>>(
+          type, std::move(path), maxDefine, options, pool);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace facebook::velox::parquet
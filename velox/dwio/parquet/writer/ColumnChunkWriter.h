@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/DecodedVector.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+
+namespace facebook::velox::parquet {
+
+// Serializes 'object' with the thrift compact protocol.
+template <typename T>
+std::string serializeThrift(const T& object) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  return buffer->getBufferAsString();
+}
+
+enum class DataPageVersion { kV1, kV2 };
+
+// Options for the column chunks of one leaf column.
+struct ColumnChunkOptions {
+  thrift::CompressionCodec::type codec{
+      thrift::CompressionCodec::UNCOMPRESSED};
+
+  // Encoding of the values when the column is not dictionary encoded.
+  // DELTA_BINARY_PACKED applies to INT32 and INT64, DELTA_LENGTH_BYTE_ARRAY to
+  // BYTE_ARRAY and BYTE_STREAM_SPLIT to FLOAT and DOUBLE columns.
+  thrift::Encoding::type encoding{thrift::Encoding::PLAIN};
+
+  // Dictionary encodes the values until the PLAIN encoded dictionary exceeds
+  // 'dictionaryPageSizeLimit'. The rest of the chunk then uses 'encoding'.
+  bool enableDictionary{true};
+  int64_t dictionaryPageSizeLimit{1 << 20};
+
+  // A page is finished when the PLAIN size of its values reaches 'pageSize'
+  // or it has 'maxRowsInPage' rows.
+  int64_t pageSize{1 << 20};
+  int32_t maxRowsInPage{20'000};
+
+  DataPageVersion dataPageVersion{DataPageVersion::kV1};
+
+  // Writes a split block bloom filter of about 'bloomFilterFpp' false
+  // positive probability per chunk. Only for INT32, INT64 and BYTE_ARRAY
+  // columns.
+  bool bloomFilter{false};
+  double bloomFilterFpp{0.05};
+  int32_t maxBloomFilterBytes{1 << 20};
+};
+
+// The metadata of a column chunk written by ColumnChunkWriter.
+struct FinishedColumnChunk {
+  thrift::ColumnChunk chunk;
+  // Not set if a page has values but no min and max, e.g. only NaNs.
+  std::optional<thrift::ColumnIndex> columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  // The serialized BloomFilterHeader followed by the bitset. Empty if the
+  // column has no bloom filter.
+  std::string bloomFilter;
+};
+
+// Encodes the values of a leaf column into the pages of a column chunk for
+// each row group. The pages are buffered until the chunk is finished since
+// the dictionary page goes first.
+class ColumnChunkWriter {
+ public:
+  // Returns a writer for leaf column at 'path' of 'type' with definition
+  // level 'maxDefine' when not null.
+  static std::unique_ptr<ColumnChunkWriter> create(
+      const TypePtr& type,
+      std::vector<std::string> path,
+      int16_t maxDefine,
+      const ColumnChunkOptions& options,
+      memory::MemoryPool& pool);
+
+  virtual ~ColumnChunkWriter() = default;
+
+  // Returns the Parquet physical type of 'type' or throws if 'type' can not
+  // be written.
+  static thrift::Type::type physicalType(const Type& type);
+
+  // Appends a value or null for each of 'numRows' rows. The rows with
+  // 'levels' maxDefine - 1 are null or the value at 'rows' in 'decoded'.
+  // The others are null at a parent of the leaf.
+  virtual void write(
+      const DecodedVector& decoded,
+      const vector_size_t* rows,
+      const int16_t* levels,
+      int32_t numRows) = 0;
+
+  // Returns the bytes held for the current chunk.
+  virtual uint64_t bufferedBytes() const = 0;
+
+  // Finishes the current chunk and appends its pages to 'out'. The pages
+  // are written at file offset 'offset'. Prepares 'this' for the next chunk.
+  virtual FinishedColumnChunk finishChunk(
+      int64_t offset,
+      dwio::common::DataBuffer<char>& out) = 0;
+};
+
+} // namespace facebook::velox::parquet
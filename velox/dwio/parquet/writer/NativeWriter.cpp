@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <folly/String.h>
+
+#include <numeric>
+#include <unordered_set>
+
+namespace facebook::velox::parquet {
+
+namespace {
+const std::string kMagic = "PAR1";
+
+// Adds the dot separated paths of the leaf columns of 'type' to 'paths'.
+void addLeafPaths(
+    const TypePtr& type,
+    const std::string& path,
+    std::unordered_set<std::string>& paths) {
+  if (type->kind() != TypeKind::ROW) {
+    paths.insert(path);
+    return;
+  }
+  auto& rowType = type->asRow();
+  for (auto i = 0; i < rowType.size(); ++i) {
+    addLeafPaths(
+        rowType.childAt(i),
+        path.empty() ? rowType.nameOf(i) : path + "." + rowType.nameOf(i),
+        paths);
+  }
+}
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    RowTypePtr schema,
+    NativeWriterOptions options)
+    : sink_(std::move(sink)),
+      pool_(pool),
+      schema_(std::move(schema)),
+      options_(std::move(options)) {
+  VELOX_USER_CHECK_GT(options_.rowsInRowGroup, 0);
+  VELOX_USER_CHECK_GT(schema_->size(), 0);
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_repetition_type(thrift::FieldRepetitionType::REQUIRED);
+  root.__set_num_children(schema_->size());
+  schemaElements_.push_back(root);
+  for (auto i = 0; i < schema_->size(); ++i) {
+    fields_.push_back(addField(schema_->childAt(i), {schema_->nameOf(i)}, 1));
+  }
+  std::unordered_set<std::string> leafPaths;
+  addLeafPaths(schema_, "", leafPaths);
+  for (const auto& [path, _] : options_.columnOptions) {
+    VELOX_USER_CHECK(
+        leafPaths.count(path), "No leaf column for options: {}", path);
+  }
+}
+
+NativeWriter::Field NativeWriter::addField(
+    const TypePtr& type,
+    std::vector<std::string> path,
+    int16_t level) {
+  thrift::SchemaElement element;
+  element.__set_name(path.back());
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  Field field{type, level};
+  switch (type->kind()) {
+    case TypeKind::ROW: {
+      auto& rowType = type->asRow();
+      element.__set_num_children(rowType.size());
+      schemaElements_.push_back(element);
+      for (auto i = 0; i < rowType.size(); ++i) {
+        auto childPath = path;
+        childPath.push_back(rowType.nameOf(i));
+        field.children.push_back(
+            addField(rowType.childAt(i), std::move(childPath), level + 1));
+      }
+      return field;
+    }
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+      VELOX_UNSUPPORTED(
+          "ARRAY and MAP columns are not supported by the native Parquet "
+          "writer: {}",
+          folly::join(".", path));
+    default:
+      break;
+  }
+  element.__set_type(ColumnChunkWriter::physicalType(*type));
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      break;
+    case TypeKind::SMALLINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      break;
+    case TypeKind::DATE:
+      element.__set_converted_type(thrift::ConvertedType::DATE);
+      break;
+    case TypeKind::VARCHAR:
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      break;
+    case TypeKind::SHORT_DECIMAL: {
+      const auto [precision, scale] = getDecimalPrecisionScale(*type);
+      element.__set_converted_type(thrift::ConvertedType::DECIMAL);
+      element.__set_precision(precision);
+      element.__set_scale(scale);
+      break;
+    }
+    default:
+      break;
+  }
+  schemaElements_.push_back(element);
+
+  auto it = options_.columnOptions.find(folly::join(".", path));
+  const auto& columnOptions = it != options_.columnOptions.end()
+      ? it->second
+      : options_.defaultColumnOptions;
+  field.leaf = leaves_.size();
+  leaves_.push_back(ColumnChunkWriter::create(
+      type, std::move(path), level, columnOptions, pool_));
+  return field;
+}
+
+void NativeWriter::write(const RowVectorPtr& data) {
+  VELOX_CHECK(!closed_, "Writing to a closed Parquet writer");
+  VELOX_CHECK(
+      data->type()->kindEquals(schema_),
+      "Data of type {} does not match the writer schema {}",
+      data->type()->toString(),
+      schema_->toString());
+  const vector_size_t size = data->size();
+  vector_size_t begin = 0;
+  while (begin < size) {
+    const vector_size_t numRows = std::min<int64_t>(
+        size - begin, options_.rowsInRowGroup - rowsInRowGroup_);
+    std::vector<vector_size_t> rows(numRows);
+    std::iota(rows.begin(), rows.end(), begin);
+    // The top level rows are not null.
+    const std::vector<int16_t> levels(numRows, 0);
+    for (auto i = 0; i < fields_.size(); ++i) {
+      writeField(fields_[i], data->childAt(i), rows, levels);
+    }
+    rowsInRowGroup_ += numRows;
+    begin += numRows;
+    if (rowsInRowGroup_ >= options_.rowsInRowGroup) {
+      flush();
+    }
+  }
+  if (rowsInRowGroup_ > 0 && shouldFlush()) {
+    flush();
+  }
+}
+
+void NativeWriter::writeField(
+    const Field& field,
+    const VectorPtr& vector,
+    const std::vector<vector_size_t>& rows,
+    const std::vector<int16_t>& levels) {
+  DecodedVector decoded(*vector);
+  if (field.leaf >= 0) {
+    leaves_[field.leaf]->write(
+        decoded, rows.data(), levels.data(), rows.size());
+    return;
+  }
+  std::vector<vector_size_t> childRows(rows.size(), 0);
+  std::vector<int16_t> childLevels = levels;
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (levels[i] == field.level - 1 && !decoded.isNullAt(rows[i])) {
+      childLevels[i] = field.level;
+      childRows[i] = decoded.index(rows[i]);
+    }
+  }
+  auto* rowVector = decoded.base()->as<RowVector>();
+  for (auto i = 0; i < field.children.size(); ++i) {
+    writeField(
+        field.children[i], rowVector->childAt(i), childRows, childLevels);
+  }
+}
+
+uint64_t NativeWriter::bufferedBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& leaf : leaves_) {
+    bytes += leaf->bufferedBytes();
+  }
+  return bytes;
+}
+
+bool NativeWriter::shouldFlush() const {
+  if (options_.flushPolicy) {
+    return options_.flushPolicy->shouldFlush(dwio::common::StripeProgress{
+        .stripeIndex = static_cast<uint32_t>(rowGroups_.size()),
+        .stripeRowCount = static_cast<uint64_t>(rowsInRowGroup_),
+        .totalMemoryUsage = pool_.getCurrentBytes(),
+        .stripeSizeEstimate = static_cast<int64_t>(bufferedBytes())});
+  }
+  return bufferedBytes() >= options_.bytesInRowGroup;
+}
+
+void NativeWriter::flush() {
+  if (rowsInRowGroup_ == 0) {
+    return;
+  }
+  if (offset_ == 0) {
+    writeBytes(kMagic);
+  }
+  std::vector<dwio::common::DataBuffer<char>> buffers;
+  thrift::RowGroup rowGroup;
+  std::vector<std::optional<thrift::ColumnIndex>> columnIndexes;
+  std::vector<thrift::OffsetIndex> offsetIndexes;
+  std::vector<std::string> bloomFilters;
+  int64_t offset = offset_;
+  int64_t totalUncompressedSize = 0;
+  for (auto& leaf : leaves_) {
+    buffers.emplace_back(pool_);
+    auto chunk = leaf->finishChunk(offset, buffers.back());
+    offset += buffers.back().size();
+    totalUncompressedSize += chunk.chunk.meta_data.total_uncompressed_size;
+    rowGroup.columns.push_back(std::move(chunk.chunk));
+    columnIndexes.push_back(std::move(chunk.columnIndex));
+    offsetIndexes.push_back(std::move(chunk.offsetIndex));
+    bloomFilters.push_back(std::move(chunk.bloomFilter));
+  }
+  rowGroup.__set_num_rows(rowsInRowGroup_);
+  rowGroup.__set_total_byte_size(totalUncompressedSize);
+  rowGroup.__set_file_offset(offset_);
+  rowGroup.__set_total_compressed_size(offset - offset_);
+  for (auto i = 0; i < bloomFilters.size(); ++i) {
+    if (bloomFilters[i].empty()) {
+      continue;
+    }
+    rowGroup.columns[i].meta_data.__set_bloom_filter_offset(offset);
+    buffers.emplace_back(pool_);
+    buffers.back().extendAppend(
+        0, bloomFilters[i].data(), bloomFilters[i].size());
+    offset += bloomFilters[i].size();
+  }
+  writeBuffers(buffers);
+  VELOX_CHECK_EQ(offset, offset_);
+
+  rowGroups_.push_back(std::move(rowGroup));
+  columnIndexes_.push_back(std::move(columnIndexes));
+  offsetIndexes_.push_back(std::move(offsetIndexes));
+  numRows_ += rowsInRowGroup_;
+  rowsInRowGroup_ = 0;
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  if (offset_ == 0) {
+    writeBytes(kMagic);
+  }
+  if (options_.writePageIndex) {
+    std::string pageIndexes;
+    for (auto i = 0; i < rowGroups_.size(); ++i) {
+      for (auto j = 0; j < leaves_.size(); ++j) {
+        if (!columnIndexes_[i][j].has_value()) {
+          continue;
+        }
+        const auto bytes = serializeThrift(*columnIndexes_[i][j]);
+        auto& chunk = rowGroups_[i].columns[j];
+        chunk.__set_column_index_offset(offset_ + pageIndexes.size());
+        chunk.__set_column_index_length(bytes.size());
+        pageIndexes.append(bytes);
+      }
+    }
+    for (auto i = 0; i < rowGroups_.size(); ++i) {
+      for (auto j = 0; j < leaves_.size(); ++j) {
+        const auto bytes = serializeThrift(offsetIndexes_[i][j]);
+        auto& chunk = rowGroups_[i].columns[j];
+        chunk.__set_offset_index_offset(offset_ + pageIndexes.size());
+        chunk.__set_offset_index_length(bytes.size());
+        pageIndexes.append(bytes);
+      }
+    }
+    writeBytes(pageIndexes);
+  }
+
+  thrift::FileMetaData fileMetaData;
+  fileMetaData.__set_version(1);
+  fileMetaData.__set_schema(schemaElements_);
+  fileMetaData.__set_num_rows(numRows_);
+  fileMetaData.__set_row_groups(rowGroups_);
+  fileMetaData.__set_created_by("velox");
+  auto footer = serializeThrift(fileMetaData);
+  const uint32_t footerLength = footer.size();
+  footer.append(
+      reinterpret_cast<const char*>(&footerLength), sizeof(footerLength));
+  footer.append(kMagic);
+  writeBytes(footer);
+  sink_->close();
+  if (options_.flushPolicy) {
+    options_.flushPolicy->onClose();
+  }
+  closed_ = true;
+}
+
+void NativeWriter::writeBytes(const std::string& bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  std::vector<dwio::common::DataBuffer<char>> buffers;
+  buffers.emplace_back(pool_);
+  buffers.back().extendAppend(0, bytes.data(), bytes.size());
+  writeBuffers(buffers);
+}
+
+void NativeWriter::writeBuffers(
+    std::vector<dwio::common::DataBuffer<char>>& buffers) {
+  std::vector<dwio::common::DataBuffer<char>> nonEmpty;
+  for (auto& buffer : buffers) {
+    if (buffer.size() > 0) {
+      offset_ += buffer.size();
+      nonEmpty.push_back(std::move(buffer));
+    }
+  }
+  if (!nonEmpty.empty()) {
+    sink_->writeWithLogging(nonEmpty);
+  }
+}
+
+} // namespace facebook::velox::parquet
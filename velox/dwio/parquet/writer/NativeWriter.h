@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/FlushPolicy.h"
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions {
+  // A row group is finished after this many rows. Larger batches are split.
+  int64_t rowsInRowGroup{1'000'000};
+
+  // A row group is also finished when 'flushPolicy' says so after a write.
+  // The policy sees the rows and the encoded bytes of the row group and the
+  // memory of the writer's pool, so the DWRF policies, e.g.
+  // dwrf::DefaultFlushPolicy, apply as is. Without a policy a row group is
+  // finished at 'bytesInRowGroup' encoded bytes.
+  std::shared_ptr<dwio::common::FlushPolicy> flushPolicy;
+  int64_t bytesInRowGroup{128 << 20};
+
+  // Options of all leaf columns. 'columnOptions' overrides these for leaf
+  // columns by their dot separated path, e.g. "s.a" for field 'a' of struct
+  // column 's'.
+  ColumnChunkOptions defaultColumnOptions;
+  std::unordered_map<std::string, ColumnChunkOptions> columnOptions;
+
+  // Writes the ColumnIndex and OffsetIndex of each column chunk.
+  bool writePageIndex{true};
+};
+
+// Writes Velox vectors into a DataSink as Parquet. The values are encoded
+// directly from the vectors of any encoding. Columns are scalar types or
+// structs of these. ARRAY and MAP columns are not supported. The pages of a
+// row group are buffered in 'pool' until the row group is finished. The
+// bloom filters of a row group follow it and the page indexes of all row
+// groups go before the footer.
+class NativeWriter {
+ public:
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      RowTypePtr schema,
+      NativeWriterOptions options = {});
+
+  // Appends 'data' of 'schema' into the writer.
+  void write(const RowVectorPtr& data);
+
+  // Finishes the current row group and writes it to the sink.
+  void flush();
+
+  // Closes 'this'. Writes the last row group, the page indexes and the footer
+  // and closes the sink. Data can no longer be added after close.
+  void close();
+
+ private:
+  // A field of the schema. Leaves have the index of their ColumnChunkWriter.
+  struct Field {
+    TypePtr type;
+    // Definition level of a non-null value.
+    int16_t level;
+    int32_t leaf{-1};
+    std::vector<Field> children;
+  };
+
+  // Adds the SchemaElements and leaf writers for 'type' at 'path'.
+  Field addField(
+      const TypePtr& type,
+      std::vector<std::string> path,
+      int16_t level);
+
+  // Appends the values of 'rows' of 'vector' to the leaves of 'field'.
+  // 'levels' are the definition levels of the parent of 'field' for the rows.
+  void writeField(
+      const Field& field,
+      const VectorPtr& vector,
+      const std::vector<vector_size_t>& rows,
+      const std::vector<int16_t>& levels);
+
+  uint64_t bufferedBytes() const;
+
+  bool shouldFlush() const;
+
+  void writeBytes(const std::string& bytes);
+
+  void writeBuffers(std::vector<dwio::common::DataBuffer<char>>& buffers);
+
+  std::unique_ptr<dwio::common::DataSink> sink_;
+  memory::MemoryPool& pool_;
+  const RowTypePtr schema_;
+  const NativeWriterOptions options_;
+
+  std::vector<thrift::SchemaElement> schemaElements_;
+  std::vector<Field> fields_;
+  std::vector<std::unique_ptr<ColumnChunkWriter>> leaves_;
+
+  std::vector<thrift::RowGroup> rowGroups_;
+  // The page indexes of 'rowGroups_', one per leaf.
+  std::vector<std::vector<std::optional<thrift::ColumnIndex>>> columnIndexes_;
+  std::vector<std::vector<thrift::OffsetIndex>> offsetIndexes_;
+
+  int64_t rowsInRowGroup_{0};
+  int64_t numRows_{0};
+  // Bytes written to 'sink_'.
+  int64_t offset_{0};
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
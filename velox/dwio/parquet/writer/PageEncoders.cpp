@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/PageEncoders.h"
+
+namespace facebook::velox::parquet {
+
+int64_t RleBpEncoder::runLength(int64_t begin) const {
+  auto end = begin + 1;
+  while (end < values_.size() && values_[end] == values_[begin]) {
+    ++end;
+  }
+  return end - begin;
+}
+
+void RleBpEncoder::flush(std::string& out) {
+  const int64_t numValues = values_.size();
+  const int32_t valueBytes = (bitWidth_ + 7) / 8;
+  int64_t begin = 0;
+  while (begin < numValues) {
+    const auto run = runLength(begin);
+    if (run >= kGroupSize) {
+      writeVarint(static_cast<uint64_t>(run) << 1, out);
+      const uint32_t value = values_[begin];
+      out.append(reinterpret_cast<const char*>(&value), valueBytes);
+      begin += run;
+      continue;
+    }
+    // Bit packs groups of 8 up to the next group that starts a run. Only the
+    // last group may be padded since the padding would read as values.
+    auto end = begin;
+    while (end < numValues) {
+      if (numValues - end < kGroupSize) {
+        end = numValues;
+        break;
+      }
+      if (end > begin && runLength(end) >= kGroupSize) {
+        break;
+      }
+      end += kGroupSize;
+    }
+    const auto numGroups = (end - begin + kGroupSize - 1) / kGroupSize;
+    writeVarint((static_cast<uint64_t>(numGroups) << 1) | 1, out);
+    std::vector<uint32_t> group(numGroups * kGroupSize, 0);
+    std::copy(values_.begin() + begin, values_.begin() + end, group.begin());
+    bitPack(group.data(), group.size(), bitWidth_, out);
+    begin = end;
+  }
+  values_.clear();
+}
+
+void encodeDeltaLengthByteArray(
+    const std::string_view* values,
+    int64_t numValues,
+    std::string& out) {
+  std::vector<int32_t> lengths(numValues);
+  for (auto i = 0; i < numValues; ++i) {
+    lengths[i] = values[i].size();
+  }
+  encodeDeltaBinaryPacked(lengths.data(), numValues, out);
+  for (auto i = 0; i < numValues; ++i) {
+    out.append(values[i].data(), values[i].size());
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace facebook::velox::parquet {
+
+// Returns the number of bits needed for values up to 'maxValue'.
+inline uint8_t bitWidth(uint64_t maxValue) {
+  return maxValue == 0 ? 0 : 64 - __builtin_clzll(maxValue);
+}
+
+// Appends 'value' as an unsigned LEB128 varint to 'out'.
+inline void writeVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline void writeZigZagVarint(int64_t value, std::string& out) {
+  writeVarint(
+      (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63),
+      out);
+}
+
+// Appends the low 'bitWidth' bits of each of 'values' to 'out', least
+// significant bit first, pads the last byte with zeros.
+template <typename T>
+void bitPack(
+    const T* values,
+    int64_t numValues,
+    uint8_t bitWidth,
+    std::string& out) {
+  uint64_t word = 0;
+  int32_t numBits = 0;
+  for (auto i = 0; i < numValues; ++i) {
+    uint64_t value = static_cast<uint64_t>(values[i]);
+    int32_t remaining = bitWidth;
+    while (remaining > 0) {
+      const int32_t take = std::min(remaining, 64 - numBits);
+      const uint64_t bits =
+          take == 64 ? value : value & ((1ULL << take) - 1);
+      word |= bits << numBits;
+      value = take == 64 ? 0 : value >> take;
+      numBits += take;
+      remaining -= take;
+      if (numBits == 64) {
+        out.append(reinterpret_cast<const char*>(&word), sizeof(word));
+        word = 0;
+        numBits = 0;
+      }
+    }
+  }
+  out.append(reinterpret_cast<const char*>(&word), (numBits + 7) / 8);
+}
+
+// Encodes values of up to 32 bits in the RLE/bit-packing hybrid encoding of
+// definition levels and dictionary indices. Values are buffered by put() and
+// encoded by flush(). Runs of 8 or more equal values become RLE runs, the
+// rest are bit packed in groups of 8.
+class RleBpEncoder {
+ public:
+  explicit RleBpEncoder(uint8_t bitWidth) : bitWidth_(bitWidth) {}
+
+  void put(uint32_t value) {
+    values_.push_back(value);
+  }
+
+  int64_t size() const {
+    return values_.size();
+  }
+
+  // Appends the encoded values to 'out' and clears 'this'.
+  void flush(std::string& out);
+
+ private:
+  static constexpr int32_t kGroupSize = 8;
+
+  // Returns the number of values equal to values_[begin] from 'begin' on.
+  int64_t runLength(int64_t begin) const;
+
+  const uint8_t bitWidth_;
+  std::vector<uint32_t> values_;
+};
+
+// Appends the PLAIN encoding of 'values' to 'out'. Booleans are bit packed,
+// strings are prefixed by their 4 byte length.
+template <typename T>
+void encodePlain(const T* values, int64_t numValues, std::string& out) {
+  if constexpr (std::is_same_v<T, bool>) {
+    bitPack(values, numValues, 1, out);
+  } else if constexpr (std::is_same_v<T, std::string_view>) {
+    for (auto i = 0; i < numValues; ++i) {
+      const uint32_t length = values[i].size();
+      out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+      out.append(values[i].data(), values[i].size());
+    }
+  } else {
+    out.append(
+        reinterpret_cast<const char*>(values), numValues * sizeof(T));
+  }
+}
+
+// Appends the DELTA_BINARY_PACKED encoding of 'values' to 'out'. T is int32_t
+// or int64_t. Blocks have 128 values in 4 miniblocks.
+template <typename T>
+void encodeDeltaBinaryPacked(
+    const T* values,
+    int64_t numValues,
+    std::string& out) {
+  using U = std::make_unsigned_t<T>;
+  constexpr int32_t kBlockSize = 128;
+  constexpr int32_t kNumMiniblocks = 4;
+  constexpr int32_t kMiniblockSize = kBlockSize / kNumMiniblocks;
+  writeVarint(kBlockSize, out);
+  writeVarint(kNumMiniblocks, out);
+  writeVarint(numValues, out);
+  writeZigZagVarint(numValues > 0 ? values[0] : 0, out);
+  U deltas[kBlockSize];
+  for (int64_t begin = 1; begin < numValues; begin += kBlockSize) {
+    const auto numDeltas = std::min<int64_t>(kBlockSize, numValues - begin);
+    // The arithmetic wraps around as in the reader.
+    T minDelta = std::numeric_limits<T>::max();
+    for (auto i = 0; i < numDeltas; ++i) {
+      deltas[i] = static_cast<U>(values[begin + i]) -
+          static_cast<U>(values[begin + i - 1]);
+      minDelta = std::min(minDelta, static_cast<T>(deltas[i]));
+    }
+    for (auto i = 0; i < kBlockSize; ++i) {
+      deltas[i] = i < numDeltas ? deltas[i] - static_cast<U>(minDelta) : 0;
+    }
+    writeZigZagVarint(minDelta, out);
+    uint8_t bitWidths[kNumMiniblocks];
+    for (auto i = 0; i < kNumMiniblocks; ++i) {
+      U maxDelta = 0;
+      for (auto j = 0; j < kMiniblockSize; ++j) {
+        maxDelta = std::max(maxDelta, deltas[i * kMiniblockSize + j]);
+      }
+      bitWidths[i] = bitWidth(maxDelta);
+    }
+    out.append(reinterpret_cast<const char*>(bitWidths), kNumMiniblocks);
+    // Miniblocks after the last value are left out. The last miniblock with
+    // values is padded to full size.
+    for (auto i = 0; i < kNumMiniblocks && i * kMiniblockSize < numDeltas;
+         ++i) {
+      bitPack(deltas + i * kMiniblockSize, kMiniblockSize, bitWidths[i], out);
+    }
+  }
+}
+
+// Appends the DELTA_LENGTH_BYTE_ARRAY encoding of 'values' to 'out'.
+void encodeDeltaLengthByteArray(
+    const std::string_view* values,
+    int64_t numValues,
+    std::string& out);
+
+// Appends the BYTE_STREAM_SPLIT encoding of 'values' to 'out'. T is float or
+// double.
+template <typename T>
+void encodeByteStreamSplit(
+    const T* values,
+    int64_t numValues,
+    std::string& out) {
+  const auto start = out.size();
+  out.resize(start + numValues * sizeof(T));
+  const auto* bytes = reinterpret_cast<const char*>(values);
+  for (auto i = 0; i < sizeof(T); ++i) {
+    char* stream = out.data() + start + i * numValues;
+    for (auto j = 0; j < numValues; ++j) {
+      stream[j] = bytes[j * sizeof(T) + i];
+    }
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -149,6 +149,48 @@ class Aggregate {
       const std::vector<VectorPtr>& args,
       bool mayPushdown) = 0;
 
+  // Returns true if addRawInputDense() and flushDenseAccumulators() are
+  // supported. These keep the accumulators in dense arrays indexed by a group
+  // ID instead of in the group rows. This applies to fixed-width accumulators
+  // of commutative functions, e.g. sum, min and max, where values accumulated
+  // apart can be combined into the accumulator of the group later. A
+  // GroupingSet uses this when its hash table is a small array, so that the
+  // updates for a batch hit a compact, cache resident array instead of rows
+  // scattered across the RowContainer.
+  virtual bool supportsDenseAccumulators() const {
+    return false;
+  }
+
+  // Updates the dense accumulators from raw input data. Must only be called if
+  // supportsDenseAccumulators() is true.
+  // @param groupIds The group ID of each row of 'args'. These are aligned with
+  // the 'args' and are less than 'numGroups'.
+  // @param numGroups The number of group IDs. The dense accumulators grow to
+  // this size if needed.
+  // @param rows Rows of the 'args' to add to the accumulators. 'rows' is
+  // guaranteed to have at least one active row.
+  // @param args Raw input.
+  // @param mayPushdown True if aggregation can be pushdown down via LazyVector.
+  // The pushdown can happen only if this flag is true and 'args' is a single
+  // LazyVector.
+  virtual void addRawInputDense(
+      const uint64_t* /*groupIds*/,
+      int32_t /*numGroups*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/,
+      bool /*mayPushdown*/) {
+    VELOX_UNSUPPORTED();
+  }
+
+  // Combines the values accumulated by addRawInputDense() since the last flush
+  // into the accumulators in the group rows and resets the dense accumulators.
+  // @param groups Pointers to the start of the group rows, indexed by group
+  // ID. Only the entries for the IDs passed to addRawInputDense() since the
+  // last flush are read.
+  virtual void flushDenseAccumulators(char* const* /*groups*/) {
+    VELOX_UNSUPPORTED();
+  }
+
   virtual void retractIntermediateResults(
       char** group,
       const SelectivityVector& rows,
@@ -165,6 +207,31 @@ class Aggregate {
     VELOX_NYI();
   }
 
+  // Returns true if retractSingleGroupRawInput() is supported, e.g. raw input
+  // previously added to an accumulator can be removed from it with the result
+  // being the same as if the input had never been added. Window functions use
+  // this to slide the frame incrementally. Functions that don't support
+  // retracting are evaluated over sliding frames using a segment tree of
+  // intermediate results instead.
+  virtual bool supportsRetract() const {
+    return false;
+  }
+
+  // Removes raw input previously added to the single accumulator via
+  // addSingleGroupRawInput(). Must only be called if supportsRetract() is true.
+  // @param group Pointer to the start of the group row.
+  // @param rows Rows of the 'args' to remove from the accumulator. 'rows' is
+  // guaranteed to have at least one active row.
+  // @param args Raw input to remove from the accumulator.
+  // @param mayPushdown True if aggregation can be pushdown down via LazyVector.
+  virtual void retractSingleGroupRawInput(
+      char* /*group*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/,
+      bool /*mayPushdown*/) {
+    VELOX_NYI();
+  }
+
   // Updates the single partial accumulator from raw input data for global
   // aggregation.
   // @param group Pointer to the start of the group row.
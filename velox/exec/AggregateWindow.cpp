@@ -29,6 +29,15 @@ namespace {
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
 // to frameEnd boundaries at that row using singleGroup.
+//
+// Frames with a fixed start and non-decreasing ends are aggregated by adding
+// the new frame rows to the previous result. Other frames are evaluated
+// incrementally as well if possible: if the Aggregate supports retracting raw
+// input, the accumulator slides from one frame to the next by adding the rows
+// entering the frame and retracting the rows leaving it. Otherwise, large
+// frames are aggregated over a segment tree of intermediate results built for
+// the partition, so each frame costs O(log(partition size)) instead of
+// O(frame size).
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -58,6 +67,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     aggregate_ = exec::Aggregate::create(
         name, core::AggregationNode::Step::kSingle, argTypes_, resultType);
     aggregate_->setAllocator(stringAllocator_);
+    intermediateType_ = exec::Aggregate::intermediateType(name, argTypes_);
 
     // Aggregate initialization.
     // Row layout is:
@@ -89,6 +99,8 @@ class AggregateWindowFunction : public exec::WindowFunction {
     // Constructing a vector of a single result value used for copying from
     // the aggregate to the final result.
     aggregateResultVector_ = BaseVector::create(resultType, 1, pool_);
+    intermediateArgs_.push_back(
+        BaseVector::create(intermediateType_, 0, pool_));
   }
 
   ~AggregateWindowFunction() {
@@ -104,6 +116,8 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    currentFrame_.reset();
+    segmentTreeLevels_.clear();
   }
 
   void apply(
@@ -124,6 +138,18 @@ class AggregateWindowFunction : public exec::WindowFunction {
     FrameMetadata frameMetadata =
         analyzeFrameValues(validRows, rawFrameStarts, rawFrameEnds);
 
+    if (!frameMetadata.incrementalAggregation &&
+        aggregate_->supportsRetract()) {
+      slidingAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
+      previousFrameMetadata_ = frameMetadata;
+      return;
+    }
+
+    // The single group is re-initialized below, so it no longer holds the
+    // aggregate of the frame used by slidingAggregation().
+    currentFrame_.reset();
+
     if (frameMetadata.incrementalAggregation) {
       vector_size_t startRow;
       if (frameMetadata.usePreviousAggregate) {
@@ -137,10 +163,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
         // This is the start of a new incremental aggregation. So the
         // aggregate_ function object should be initialized.
-        auto singleGroup = std::vector<vector_size_t>{0};
-        aggregate_->clear();
-        aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
-        aggregateInitialized_ = true;
+        initializeSingleGroup();
       }
 
       fillArgVectors(startRow, frameMetadata.lastRow);
@@ -151,6 +174,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (frameMetadata.maxFrameSize >= kMinSegmentTreeFrameSize) {
+      segmentTreeAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -166,6 +192,14 @@ class AggregateWindowFunction : public exec::WindowFunction {
   }
 
  private:
+  // Number of children of each node of the segment tree.
+  static constexpr vector_size_t kSegmentTreeFanout = 16;
+
+  // Frames smaller than this are aggregated directly from the input rows, as
+  // the segment tree lookups cost more than aggregating the frame rows.
+  static constexpr vector_size_t kMinSegmentTreeFrameSize =
+      4 * kSegmentTreeFanout;
+
   struct FrameMetadata {
     // Min frame start row required for aggregation.
     vector_size_t firstRow;
@@ -181,6 +215,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
     // Resume incremental aggregation from the prior block.
     bool usePreviousAggregate;
+
+    // Max number of rows in a valid frame of the block.
+    vector_size_t maxFrameSize;
   };
 
   bool handleAllEmptyFrames(
@@ -214,11 +251,14 @@ class AggregateWindowFunction : public exec::WindowFunction {
     vector_size_t fixedFrameStartRow = firstRow;
     vector_size_t lastRow = rawFrameEnds[firstValidRow];
     vector_size_t prevFrameEnds = lastRow;
+    vector_size_t maxFrameSize = 0;
 
     bool incrementalAggregation = true;
     validRows.applyToSelected([&](auto i) {
       firstRow = std::min(firstRow, rawFrameStarts[i]);
       lastRow = std::max(lastRow, rawFrameEnds[i]);
+      maxFrameSize =
+          std::max(maxFrameSize, rawFrameEnds[i] - rawFrameStarts[i] + 1);
 
       // Incremental aggregation can be done if :
       // i) All rows have the same frameStart value.
@@ -242,7 +282,238 @@ class AggregateWindowFunction : public exec::WindowFunction {
       }
     }
 
-    return {firstRow, lastRow, incrementalAggregation, usePreviousAggregate};
+    return {
+        firstRow,
+        lastRow,
+        incrementalAggregation,
+        usePreviousAggregate,
+        maxFrameSize};
+  }
+
+  void initializeSingleGroup() {
+    static const auto kSingleGroup = std::vector<vector_size_t>{0};
+    if (aggregateInitialized_) {
+      aggregate_->destroy(folly::Range(&rawSingleGroupRow_, 1));
+    }
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+    aggregateInitialized_ = true;
+  }
+
+  void extractSingleGroupValue() {
+    BaseVector::prepareForReuse(aggregateResultVector_, 1);
+    aggregate_->extractValues(&rawSingleGroupRow_, 1, &aggregateResultVector_);
+  }
+
+  // Copies the partition rows [firstBegin, firstEnd) followed by the rows
+  // [secondBegin, secondEnd) into 'argVectors_' and resizes 'scratchRows_' to
+  // select all of them. Returns the total number of rows.
+  vector_size_t fillArgVectors(
+      vector_size_t firstBegin,
+      vector_size_t firstEnd,
+      vector_size_t secondBegin,
+      vector_size_t secondEnd) {
+    const auto numFirst = firstEnd - firstBegin;
+    const auto numSecond = secondEnd - secondBegin;
+    const auto numRows = numFirst + numSecond;
+    for (int i = 0; i < argIndices_.size(); i++) {
+      argVectors_[i]->resize(numRows);
+      if (argIndices_[i] != kConstantChannel) {
+        partition_->extractColumn(
+            argIndices_[i], firstBegin, numFirst, 0, argVectors_[i]);
+        if (numSecond > 0) {
+          partition_->extractColumn(
+              argIndices_[i], secondBegin, numSecond, numFirst, argVectors_[i]);
+        }
+      }
+    }
+    scratchRows_.resizeFill(numRows, true);
+    return numRows;
+  }
+
+  // Adds (or retracts if 'retract' is true) the partition rows [begin, end)
+  // to the single group.
+  void updateSingleGroup(vector_size_t begin, vector_size_t end, bool retract) {
+    if (begin >= end) {
+      return;
+    }
+    fillArgVectors(begin, end, end, end);
+    if (retract) {
+      aggregate_->retractSingleGroupRawInput(
+          rawSingleGroupRow_, scratchRows_, argVectors_, false);
+    } else {
+      aggregate_->addSingleGroupRawInput(
+          rawSingleGroupRow_, scratchRows_, argVectors_, false);
+    }
+  }
+
+  // Computes the aggregate of each frame from the aggregate of the previous
+  // frame by adding the rows entering the frame and retracting the rows
+  // leaving it. Starts over when that is more work than aggregating the frame
+  // rows. Requires aggregate_->supportsRetract().
+  void slidingAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    validRows.applyToSelected([&](auto i) {
+      // The frames are [begin, end).
+      const vector_size_t begin = rawFrameStarts[i];
+      const vector_size_t end = rawFrameEnds[i] + 1;
+
+      bool slide = false;
+      if (currentFrame_.has_value()) {
+        const auto [currentBegin, currentEnd] = currentFrame_.value();
+        const auto numChangedRows =
+            std::abs(begin - currentBegin) + std::abs(end - currentEnd);
+        slide = begin < currentEnd && currentBegin < end &&
+            numChangedRows < end - begin;
+      }
+
+      if (slide) {
+        const auto [currentBegin, currentEnd] = currentFrame_.value();
+        updateSingleGroup(begin, currentBegin, false);
+        updateSingleGroup(currentEnd, end, false);
+        updateSingleGroup(currentBegin, begin, true);
+        updateSingleGroup(end, currentEnd, true);
+      } else {
+        initializeSingleGroup();
+        updateSingleGroup(begin, end, false);
+      }
+      currentFrame_ = std::make_pair(begin, end);
+
+      extractSingleGroupValue();
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setNullEmptyFramesResults(validRows, resultOffset, result);
+  }
+
+  // Builds the segment tree over the rows of the current partition. Level 0 is
+  // the input rows. Each entry of level k + 1 holds the intermediate result
+  // (see Aggregate::extractAccumulators()) of 'kSegmentTreeFanout' consecutive
+  // entries of level k. The top level has at most 'kSegmentTreeFanout'
+  // entries.
+  void buildSegmentTree() {
+    VELOX_CHECK(segmentTreeLevels_.empty());
+    // There are no intermediate results for the input rows.
+    segmentTreeLevels_.push_back(nullptr);
+
+    vector_size_t levelSize = partition_->numRows();
+    fillArgVectors(0, levelSize, levelSize, levelSize);
+
+    // The group rows for the nodes of a level have the same layout as the
+    // single group row.
+    const auto nodeRowSize = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
+    while (levelSize > kSegmentTreeFanout) {
+      const auto numNodes = bits::roundUp(levelSize, kSegmentTreeFanout) /
+          kSegmentTreeFanout;
+      auto nodeRowsBuffer =
+          AlignedBuffer::allocate<char>(numNodes * nodeRowSize, pool_);
+      auto rawNodeRows = nodeRowsBuffer->asMutable<char>();
+      std::vector<char*> nodes(numNodes);
+      std::vector<vector_size_t> indices(numNodes);
+      for (auto i = 0; i < numNodes; ++i) {
+        nodes[i] = rawNodeRows + i * nodeRowSize;
+        indices[i] = i;
+      }
+      std::vector<char*> groups(levelSize);
+      for (auto i = 0; i < levelSize; ++i) {
+        groups[i] = nodes[i / kSegmentTreeFanout];
+      }
+
+      aggregate_->clear();
+      aggregate_->initializeNewGroups(nodes.data(), indices);
+      scratchRows_.resizeFill(levelSize, true);
+      if (segmentTreeLevels_.size() == 1) {
+        aggregate_->addRawInput(
+            groups.data(), scratchRows_, argVectors_, false);
+      } else {
+        aggregate_->addIntermediateResults(
+            groups.data(), scratchRows_, {segmentTreeLevels_.back()}, false);
+      }
+
+      auto level = BaseVector::create(intermediateType_, numNodes, pool_);
+      aggregate_->extractAccumulators(nodes.data(), numNodes, &level);
+      aggregate_->destroy(folly::Range(nodes.data(), numNodes));
+      segmentTreeLevels_.push_back(std::move(level));
+      levelSize = numNodes;
+    }
+  }
+
+  // Adds the entries [firstBegin, firstEnd) and [secondBegin, secondEnd) of
+  // segment tree 'level' to the single group.
+  void addSegmentTreeEntries(
+      size_t level,
+      vector_size_t firstBegin,
+      vector_size_t firstEnd,
+      vector_size_t secondBegin,
+      vector_size_t secondEnd) {
+    const auto numFirst = firstEnd - firstBegin;
+    const auto numSecond = secondEnd - secondBegin;
+    if (numFirst + numSecond == 0) {
+      return;
+    }
+
+    if (level == 0) {
+      fillArgVectors(firstBegin, firstEnd, secondBegin, secondEnd);
+      aggregate_->addSingleGroupRawInput(
+          rawSingleGroupRow_, scratchRows_, argVectors_, false);
+      return;
+    }
+
+    const auto& levelVector = segmentTreeLevels_[level];
+    auto& entries = intermediateArgs_[0];
+    entries->resize(numFirst + numSecond);
+    entries->copy(levelVector.get(), 0, firstBegin, numFirst);
+    entries->copy(levelVector.get(), numFirst, secondBegin, numSecond);
+    scratchRows_.resizeFill(numFirst + numSecond, true);
+    aggregate_->addSingleGroupIntermediateResults(
+        rawSingleGroupRow_, scratchRows_, intermediateArgs_, false);
+  }
+
+  // Aggregates each frame over the segment tree. At each level, the entries
+  // at both ends of the frame which don't cover a whole node of the next
+  // level are added to the result. The rest of the frame is covered by the
+  // nodes of the next level.
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    if (segmentTreeLevels_.empty()) {
+      buildSegmentTree();
+    }
+
+    validRows.applyToSelected([&](auto i) {
+      initializeSingleGroup();
+
+      // The entries of the current level are [begin, end).
+      vector_size_t begin = rawFrameStarts[i];
+      vector_size_t end = rawFrameEnds[i] + 1;
+      for (size_t level = 0; begin < end; ++level) {
+        const auto alignedBegin = bits::roundUp(begin, kSegmentTreeFanout);
+        const auto alignedEnd = end / kSegmentTreeFanout * kSegmentTreeFanout;
+        if (level + 1 == segmentTreeLevels_.size() ||
+            alignedBegin >= alignedEnd) {
+          addSegmentTreeEntries(level, begin, end, end, end);
+          break;
+        }
+        addSegmentTreeEntries(level, begin, alignedBegin, alignedEnd, end);
+        begin = alignedBegin / kSegmentTreeFanout;
+        end = alignedEnd / kSegmentTreeFanout;
+      }
+
+      extractSingleGroupValue();
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setNullEmptyFramesResults(validRows, resultOffset, result);
   }
 
   void fillArgVectors(vector_size_t firstRow, vector_size_t lastRow) {
@@ -267,11 +538,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
     rows.setValidRange(startFrame, endFrame, true);
     rows.updateBounds();
 
-    BaseVector::prepareForReuse(aggregateResultVector_, 1);
-
     aggregate_->addSingleGroupRawInput(
         rawSingleGroupRow_, rows, argVectors_, false);
-    aggregate_->extractValues(&rawSingleGroupRow_, 1, &aggregateResultVector_);
+    extractSingleGroupValue();
   }
 
   void incrementalAggregation(
@@ -313,18 +582,12 @@ class AggregateWindowFunction : public exec::WindowFunction {
       const VectorPtr& result) {
     SelectivityVector rows;
     rows.resize(maxFrame + 1 - minFrame);
-    static auto kSingleGroup = std::vector<vector_size_t>{0};
 
     validRows.applyToSelected([&](auto i) {
-      // This is a very naive algorithm.
-      // It evaluates the entire aggregation for each row by iterating over
-      // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
-      aggregate_->clear();
-      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
-      aggregateInitialized_ = true;
+      // This evaluates the entire aggregation for each row by iterating over
+      // input rows from frameStart to frameEnd in the SelectivityVector. It is
+      // only used for small frames which can't be evaluated incrementally.
+      initializeSingleGroup();
 
       auto frameStartIndex = frameStartsVector[i] - minFrame;
       auto frameEndIndex = frameEndsVector[i] - minFrame + 1;
@@ -353,6 +616,17 @@ class AggregateWindowFunction : public exec::WindowFunction {
   std::vector<column_index_t> argIndices_;
   std::vector<VectorPtr> argVectors_;
 
+  // Selects all the rows of 'argVectors_' or 'intermediateArgs_' populated by
+  // the sliding and segment tree aggregations.
+  SelectivityVector scratchRows_;
+
+  // Intermediate type of the aggregate used for the segment tree entries.
+  TypePtr intermediateType_;
+
+  // Single intermediate results vector used to add segment tree entries to the
+  // single group.
+  std::vector<VectorPtr> intermediateArgs_;
+
   // This is a single aggregate row needed by the aggregate function for its
   // computation. These values are for the row and its various components.
   BufferPtr singleGroupRowBufferPtr_;
@@ -366,6 +640,14 @@ class AggregateWindowFunction : public exec::WindowFunction {
   // Stores metadata about the previous output block of the partition
   // to optimize aggregate computation and reading argument vectors.
   std::optional<FrameMetadata> previousFrameMetadata_;
+
+  // The partition rows [begin, end) aggregated in the single group by
+  // slidingAggregation(). Null if the single group holds something else.
+  std::optional<std::pair<vector_size_t, vector_size_t>> currentFrame_;
+
+  // The segment tree levels of the current partition. Built on first use by
+  // segmentTreeAggregation(). See buildSegmentTree().
+  std::vector<VectorPtr> segmentTreeLevels_;
 };
 
 } // namespace
@@ -15,8 +15,10 @@
  */
 #pragma once
 
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
 #include "velox/common/base/Range.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::aggregate {
@@ -176,6 +178,89 @@ class SimpleCallableHook final : public AggregationHook {
   UpdateSingleValue updateSingleValue_;
 };
 
+// Counts the non-null values of each group. Count accumulators are never null.
+class CountHook final : public AggregationHook {
+ public:
+  CountHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  Kind kind() const override {
+    return kGeneric;
+  }
+
+  void addValue(vector_size_t row, const void* /*value*/) override {
+    ++*reinterpret_cast<int64_t*>(findGroup(row) + offset_);
+  }
+
+  void addValues(
+      const vector_size_t* rows,
+      const void* /*values*/,
+      vector_size_t size,
+      uint8_t /*valueWidth*/) override {
+    for (auto i = 0; i < size; ++i) {
+      ++*reinterpret_cast<int64_t*>(findGroup(rows[i]) + offset_);
+    }
+  }
+};
+
+// Updates dense accumulators that are indexed by group id instead of the
+// accumulators in the group rows. Used for grouped aggregation when the hash
+// table is in array mode. 'groupIds' has the group id of each row, 'values'
+// the accumulator of each group and 'hasValue' a bit for each group that has
+// received a value.
+template <typename TValue, typename TData, typename UpdateSingleValue>
+class DenseHook final : public ValueHook {
+ public:
+  DenseHook(
+      const uint64_t* groupIds,
+      TData* values,
+      uint64_t* hasValue,
+      UpdateSingleValue updateSingleValue)
+      : groupIds_(groupIds),
+        values_(values),
+        hasValue_(hasValue),
+        updateSingleValue_(updateSingleValue) {}
+
+  bool acceptsNulls() const override final {
+    return false;
+  }
+
+  Kind kind() const override {
+    return kGeneric;
+  }
+
+  void addValue(vector_size_t row, const void* value) override {
+    const auto groupId = groupIds_[row];
+    updateSingleValue_(
+        values_[groupId], TData(*reinterpret_cast<const TValue*>(value)));
+    bits::setBit(hasValue_, groupId);
+  }
+
+  void addValues(
+      const vector_size_t* rows,
+      const void* values,
+      vector_size_t size,
+      uint8_t /*valueWidth*/) override {
+    auto* typedValues = reinterpret_cast<const TValue*>(values);
+    for (auto i = 0; i < size; ++i) {
+      const auto groupId = groupIds_[rows[i]];
+      updateSingleValue_(values_[groupId], TData(typedValues[i]));
+      bits::setBit(hasValue_, groupId);
+    }
+  }
+
+ private:
+  const uint64_t* const groupIds_;
+  TData* const values_;
+  uint64_t* const hasValue_;
+  UpdateSingleValue updateSingleValue_;
+};
+
 template <typename T, bool isMin>
 class MinMaxHook final : public AggregationHook {
  public:
@@ -223,4 +308,46 @@ class MinMaxHook final : public AggregationHook {
   }
 };
 
+// Loads the lazy 'arg' for 'rows' into the hook returned by
+// 'makeHook(groups)'. 'groups' has the group row or group ID of each row. The
+// hook is called with the positions of the loaded rows, so if not all rows are
+// selected, it gets the elements of 'groups' for the selected rows, which are
+// copied into 'selectedGroups'. 'selectedIndices' is scratch space for the
+// rows to load.
+template <typename TGroup, typename MakeHook>
+void loadWithHook(
+    const SelectivityVector& rows,
+    const VectorPtr& arg,
+    TGroup* groups,
+    std::vector<vector_size_t>& selectedIndices,
+    std::vector<std::remove_const_t<TGroup>>& selectedGroups,
+    MakeHook makeHook) {
+  DecodedVector decoded(*arg, rows, false);
+  const vector_size_t* indices = decoded.indices();
+  // The decoded vector does not really keep the info from the 'rows', except
+  // for the 'upper bound' of it. In case not all rows are selected we need to
+  // generate proper indices, which we 'indirect' through the ones we got from
+  // the decoded vector.
+  vector_size_t numIndices{arg->size()};
+  if (not rows.isAllSelected()) {
+    const auto numSelected = rows.countSelected();
+    if (numSelected != arg->size()) {
+      selectedIndices.resize(numSelected);
+      selectedGroups.resize(numSelected);
+      vector_size_t tgtIndex{0};
+      rows.applyToSelected([&](vector_size_t i) {
+        selectedIndices[tgtIndex] = indices[i];
+        selectedGroups[tgtIndex++] = groups[i];
+      });
+      indices = selectedIndices.data();
+      numIndices = numSelected;
+      groups = selectedGroups.data();
+    }
+  }
+
+  auto hook = makeHook(groups);
+  decoded.base()->as<const LazyVector>()->load(
+      RowSet(indices, numIndices), &hook);
+}
+
 } // namespace facebook::velox::aggregate
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/ArrowStream.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/arrow/Abi.h"
 
 namespace facebook::velox::exec {
@@ -87,4 +88,40 @@ void ArrowStream::close() {
   SourceOperator::close();
 }
 
+void exportToArrowStream(
+    std::shared_ptr<Task> task,
+    ArrowArrayStream& arrowStream) {
+  VELOX_CHECK(
+      task->supportsSingleThreadedExecution(),
+      "Exporting a task to an Arrow stream requires single-threaded execution");
+  // Holds the conversions that are not zero-copy, e.g. of strings.
+  std::shared_ptr<memory::MemoryPool> pool =
+      task->pool()->addLeafChild("ArrowStreamExport");
+  const auto type = task->planFragment().planNode->outputType();
+  auto* rawPool = pool.get();
+  exportToArrowStream(
+      type,
+      [task = std::move(task),
+       pool = std::move(pool),
+       finished = false]() mutable -> RowVectorPtr {
+        while (!finished) {
+          ContinueFuture future = ContinueFuture::makeEmpty();
+          auto batch = task->next(&future);
+          if (batch != nullptr) {
+            return batch;
+          }
+          if (!future.valid()) {
+            // The task has no more output.
+            finished = true;
+            break;
+          }
+          // An operator is blocked on an external event.
+          future.wait();
+        }
+        return nullptr;
+      },
+      rawPool,
+      arrowStream);
+}
+
 } // namespace facebook::velox::exec
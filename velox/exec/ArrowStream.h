@@ -19,6 +19,8 @@
 struct ArrowArrayStream;
 namespace facebook::velox::exec {
 
+class Task;
+
 class ArrowStream : public SourceOperator {
  public:
   ArrowStream(
@@ -46,4 +48,16 @@ class ArrowStream : public SourceOperator {
   std::shared_ptr<ArrowArrayStream> arrowStream_;
 };
 
+/// Exports the results of 'task' as an ArrowArrayStream, the output
+/// counterpart of ArrowStream. Each get_next() on the stream runs 'task' with
+/// the single-threaded Task::next() until it produces a batch, which is
+/// exported with arrow::exportToArrowStream(), i.e. without copying its flat
+/// fixed width columns. The task must support single-threaded execution and
+/// have all its splits added. The stream keeps 'task' and its memory alive
+/// until released, so the exported arrays must be released before the stream.
+/// May be called once per task.
+void exportToArrowStream(
+    std::shared_ptr<Task> task,
+    ArrowArrayStream& arrowStream);
+
 } // namespace facebook::velox::exec
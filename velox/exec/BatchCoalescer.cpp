@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/BatchCoalescer.h"
+
+namespace facebook::velox::exec {
+
+BatchCoalescer::BatchCoalescer(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    RowTypePtr outputType,
+    const core::PlanNodeId& planNodeId)
+    : Operator(
+          driverCtx,
+          std::move(outputType),
+          operatorId,
+          planNodeId,
+          "BatchCoalescer"),
+      targetRows_(outputBatchRows()),
+      targetBytes_(driverCtx->queryConfig().preferredOutputBatchBytes()),
+      minPassThroughRows_(std::max<vector_size_t>(1, targetRows_ / 2)) {}
+
+void BatchCoalescer::addInput(RowVectorPtr input) {
+  addRuntimeStat("inputBatchRows", RuntimeCounter(input->size()));
+  if (input->size() >= minPassThroughRows_) {
+    // The buffered rows go first so that the order of the rows is kept.
+    flush();
+    addRuntimeStat("passedThroughBatches", RuntimeCounter(1));
+    ready_.push_back(std::move(input));
+    return;
+  }
+
+  append(input);
+  addRuntimeStat("coalescedBatches", RuntimeCounter(1));
+  if (numBuffered_ >= targetRows_ || bufferedBytes_ >= targetBytes_) {
+    flush();
+  }
+}
+
+void BatchCoalescer::append(const RowVectorPtr& input) {
+  const auto numInput = input->size();
+  if (!buffer_) {
+    buffer_ = BaseVector::create<RowVector>(outputType_, targetRows_, pool());
+  }
+  if (numBuffered_ + numInput > buffer_->size()) {
+    buffer_->resize(numBuffered_ + numInput);
+  }
+  for (auto i = 0; i < outputType_->size(); ++i) {
+    buffer_->childAt(i)->copy(
+        input->childAt(i)->loadedVector(), numBuffered_, 0, numInput);
+  }
+  numBuffered_ += numInput;
+  bufferedBytes_ += input->estimateFlatSize();
+}
+
+void BatchCoalescer::flush() {
+  if (numBuffered_ == 0) {
+    return;
+  }
+  buffer_->resize(numBuffered_);
+  ready_.push_back(std::move(buffer_));
+  numBuffered_ = 0;
+  bufferedBytes_ = 0;
+}
+
+RowVectorPtr BatchCoalescer::getOutput() {
+  if (noMoreInput_) {
+    flush();
+  }
+  if (ready_.empty()) {
+    return nullptr;
+  }
+  auto output = std::move(ready_.front());
+  ready_.pop_front();
+  addRuntimeStat("outputBatchRows", RuntimeCounter(output->size()));
+  return output;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <deque>
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Concatenates the small batches produced by a selective operator, e.g. a
+/// FilterProject with a filter or a HashProbe, into batches of about
+/// preferred_output_batch_rows rows or preferred_output_batch_bytes bytes,
+/// so that the operators downstream don't pay their per batch overhead on a
+/// handful of rows. The Driver inserts it after such operators when
+/// coalesce_batches_enabled is set. It has the plan node id of the operator
+/// it follows.
+///
+/// Batches of at least half the target rows are passed through as is. The
+/// rows of smaller batches are copied into a flat batch that is returned
+/// once it reaches the target size or the input ends. The order of the rows
+/// is preserved.
+class BatchCoalescer : public Operator {
+ public:
+  BatchCoalescer(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      RowTypePtr outputType,
+      const core::PlanNodeId& planNodeId);
+
+  bool preservesOrder() const override {
+    return true;
+  }
+
+  bool needsInput() const override {
+    return !noMoreInput_ && ready_.empty();
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  bool isFinished() override {
+    return noMoreInput_ && ready_.empty() && numBuffered_ == 0;
+  }
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+ private:
+  // Copies 'input' to the end of 'buffer_'.
+  void append(const RowVectorPtr& input);
+
+  // Moves the buffered rows to 'ready_'.
+  void flush();
+
+  const vector_size_t targetRows_;
+  const uint64_t targetBytes_;
+
+  // The input batches with at least this many rows are not copied.
+  const vector_size_t minPassThroughRows_;
+
+  // The copied rows of small input batches. The first 'numBuffered_' rows
+  // are set.
+  RowVectorPtr buffer_;
+  vector_size_t numBuffered_{0};
+
+  // The estimated flat size of the input batches copied into 'buffer_'.
+  uint64_t bufferedBytes_{0};
+
+  // The batches to return from getOutput, in order.
+  std::deque<RowVectorPtr> ready_;
+};
+
+} // namespace facebook::velox::exec
@@ -18,12 +18,15 @@
 
 namespace facebook::velox::exec {
 
-void CrossJoinBridge::setData(std::vector<VectorPtr> data) {
+void CrossJoinBridge::setData(
+    std::vector<VectorPtr> data,
+    std::vector<std::shared_ptr<const SpillFile>> spillFiles) {
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!data_.has_value(), "setData may be called only once");
     data_ = std::move(data);
+    spillFiles_ = std::move(spillFiles);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -41,6 +44,12 @@ std::optional<std::vector<VectorPtr>> CrossJoinBridge::dataOrFuture(
   return std::nullopt;
 }
 
+std::vector<std::shared_ptr<const SpillFile>> CrossJoinBridge::spillFiles() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(data_.has_value());
+  return spillFiles_;
+}
+
 CrossJoinBuild::CrossJoinBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -50,7 +59,15 @@ CrossJoinBuild::CrossJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "CrossJoinBuild") {}
+          "CrossJoinBuild"),
+      spillMemoryThreshold_{
+          driverCtx->queryConfig().nestedLoopJoinSpillMemoryThreshold()},
+      spillConfig_{
+          joinNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(
+                    Spiller::Type::kNestedLoopJoinBuild)
+              : std::nullopt},
+      buildType_{joinNode->sources()[1]->outputType()} {}
 
 void CrossJoinBuild::addInput(RowVectorPtr input) {
   if (input->size() > 0) {
@@ -58,10 +75,54 @@ void CrossJoinBuild::addInput(RowVectorPtr input) {
     for (auto& child : input->children()) {
       child->loadedVector();
     }
+    dataBytes_ += input->retainedSize();
     data_.emplace_back(std::move(input));
+    maybeSpill();
   }
 }
 
+void CrossJoinBuild::maybeSpill() {
+  if (!spillConfig_.has_value() || spillMemoryThreshold_ == 0 ||
+      dataBytes_ <= spillMemoryThreshold_) {
+    return;
+  }
+  if (spill_ == nullptr) {
+    spill_ = std::make_unique<SpillFileList>(
+        buildType_,
+        0,
+        std::vector<CompareFlags>{},
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        *pool(),
+        spillConfig_->fileOptions);
+  }
+  // Each vector is written as a separate batch, so that the probe reads back
+  // the same batches in the same order.
+  for (const auto& vector : data_) {
+    auto rowVector = std::static_pointer_cast<RowVector>(vector);
+    IndexRange range{0, rowVector->size()};
+    spill_->write(rowVector, folly::Range<IndexRange*>(&range, 1));
+    numSpilledRows_ += rowVector->size();
+  }
+  data_.clear();
+  dataBytes_ = 0;
+}
+
+void CrossJoinBuild::finishSpill() {
+  spill_->finishFile();
+  {
+    auto lockedStats = stats_.wlock();
+    lockedStats->spilledBytes += spill_->spilledBytes();
+    lockedStats->spilledRows += numSpilledRows_;
+    lockedStats->spilledFiles += spill_->spilledFiles();
+    ++lockedStats->spilledPartitions;
+  }
+  for (auto& file : spill_->files()) {
+    spillFiles_.push_back(std::move(file));
+  }
+  spill_.reset();
+}
+
 BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
@@ -72,6 +133,9 @@ BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
 
 void CrossJoinBuild::noMoreInput() {
   Operator::noMoreInput();
+  if (spill_ != nullptr) {
+    finishSpill();
+  }
   std::vector<ContinuePromise> promises;
   std::vector<std::shared_ptr<Driver>> peers;
   // The last Driver to hit CrossJoinBuild::finish gathers the data from
@@ -89,6 +153,10 @@ void CrossJoinBuild::noMoreInput() {
     auto* build = dynamic_cast<CrossJoinBuild*>(op);
     VELOX_CHECK(build);
     data_.insert(data_.begin(), build->data_.begin(), build->data_.end());
+    spillFiles_.insert(
+        spillFiles_.end(),
+        build->spillFiles_.begin(),
+        build->spillFiles_.end());
   }
 
   // Realize the promises so that the other Drivers (which were not
@@ -101,7 +169,7 @@ void CrossJoinBuild::noMoreInput() {
   operatorCtx_->task()
       ->getCrossJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(data_));
+      ->setData(std::move(data_), std::move(spillFiles_));
 }
 
 bool CrossJoinBuild::isFinished() {
@@ -17,17 +17,27 @@
 
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
 class CrossJoinBridge : public JoinBridge {
  public:
-  void setData(std::vector<VectorPtr> data);
+  /// Hands over the build side to the probe. 'data' is the in-memory part,
+  /// 'spillFiles' the batches spilled to disk by the build, if any.
+  void setData(
+      std::vector<VectorPtr> data,
+      std::vector<std::shared_ptr<const SpillFile>> spillFiles = {});
 
   std::optional<std::vector<VectorPtr>> dataOrFuture(ContinueFuture* future);
 
+  /// Returns the spilled build side batches. These come after the in-memory
+  /// batches. Must be called after dataOrFuture() has returned the data.
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles();
+
  private:
   std::optional<std::vector<VectorPtr>> data_;
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles_;
 };
 
 class CrossJoinBuild : public Operator {
@@ -55,12 +65,38 @@ class CrossJoinBuild : public Operator {
 
   void close() override {
     data_.clear();
+    spill_.reset();
+    spillFiles_.clear();
     Operator::close();
   }
 
  private:
+  // Spills all of 'data_' if it takes more than 'spillMemoryThreshold_'.
+  void maybeSpill();
+
+  // Finishes writing the spill files and records the spill stats.
+  void finishSpill();
+
+  // The max memory that the build side can hold before spilling.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  const RowTypePtr buildType_;
+
   std::vector<VectorPtr> data_;
 
+  // Retained bytes of 'data_'.
+  uint64_t dataBytes_{0};
+
+  // Set once the build side has exceeded 'spillMemoryThreshold_'. Holds the
+  // spilled batches until noMoreInput().
+  std::unique_ptr<SpillFileList> spill_;
+  uint64_t numSpilledRows_{0};
+
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles_;
+
   // Future for synchronizing with other Drivers of the same pipeline. All build
   // Drivers must be completed before making data available for the probe side.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
@@ -14,10 +14,22 @@
  * limitations under the License.
  */
 #include "velox/exec/CrossJoinProbe.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
+#include "velox/expression/FieldReference.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+bool needsProbeMismatch(core::JoinType joinType) {
+  return core::isLeftJoin(joinType) || core::isFullJoin(joinType);
+}
+
+bool needsBuildMismatch(core::JoinType joinType) {
+  return core::isRightJoin(joinType) || core::isFullJoin(joinType);
+}
+} // namespace
+
 CrossJoinProbe::CrossJoinProbe(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -28,7 +40,8 @@ CrossJoinProbe::CrossJoinProbe(
           operatorId,
           joinNode->id(),
           "CrossJoinProbe"),
-      outputBatchSize_{outputBatchRows()} {
+      outputBatchSize_{outputBatchRows()},
+      joinType_{joinNode->joinType()} {
   auto probeType = joinNode->sources()[0]->outputType();
   for (auto i = 0; i < probeType->size(); ++i) {
     auto name = probeType->nameOf(i);
@@ -45,25 +58,69 @@ CrossJoinProbe::CrossJoinProbe(
       buildProjections_.emplace_back(tableChannel.value(), i);
     }
   }
+
+  if (joinNode->joinCondition() != nullptr) {
+    initializeJoinCondition(joinNode->joinCondition(), probeType, buildType);
+  }
+}
+
+void CrossJoinProbe::initializeJoinCondition(
+    const core::TypedExprPtr& condition,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> conditions = {condition};
+  joinCondition_ =
+      std::make_unique<ExprSet>(std::move(conditions), operatorCtx_->execCtx());
+
+  column_index_t filterChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto& field : joinCondition_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterProbeProjections_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(probeType->childAt(channel.value()));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterBuildProjections_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(buildType->childAt(channel.value()));
+      continue;
+    }
+    VELOX_FAIL(
+        "Join condition field {} not in probe or build input",
+        field->toString());
+  }
+
+  filterInputType_ = ROW(std::move(names), std::move(types));
 }
 
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForJoinProbe;
+  }
+
   if (buildData_.has_value()) {
     return BlockingReason::kNotBlocked;
   }
 
-  auto buildData =
-      operatorCtx_->task()
-          ->getCrossJoinBridge(
-              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-          ->dataOrFuture(future);
+  auto bridge = operatorCtx_->task()->getCrossJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  auto buildData = bridge->dataOrFuture(future);
   if (!buildData.has_value()) {
     return BlockingReason::kWaitForJoinBuild;
   }
 
   buildData_ = std::move(buildData);
+  buildSpillFiles_ = bridge->spillFiles();
 
-  if (buildData_->empty()) {
+  if (buildData_->empty() && buildSpillFiles_.empty() &&
+      !needsProbeMismatch(joinType_)) {
     // Build side is empty. Return empty set of rows and  terminate the pipeline
     // early.
     buildSideEmpty_ = true;
@@ -80,16 +137,74 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
     child->loadedVector();
   }
   input_ = std::move(input);
+  probeRow_ = 0;
+  if (needsProbeMismatch(joinType_)) {
+    probeMatched_.assign(input_->size(), false);
+  }
+  startBuildBatches();
+}
+
+bool CrossJoinProbe::startBuildBatches() {
+  buildIndex_ = 0;
+  spillFileIndex_ = 0;
+  spillInput_.reset();
+  return loadBuildBatch();
+}
+
+bool CrossJoinProbe::nextBuildBatch() {
+  ++buildIndex_;
+  return loadBuildBatch();
+}
+
+bool CrossJoinProbe::loadBuildBatch() {
+  if (buildIndex_ < buildData_->size()) {
+    buildBatch_ = std::static_pointer_cast<RowVector>(
+        buildData_.value()[buildIndex_]);
+    return true;
+  }
+  while (spillFileIndex_ < buildSpillFiles_.size()) {
+    const auto& file = buildSpillFiles_[spillFileIndex_];
+    if (spillInput_ == nullptr) {
+      spillInput_ = file->makeInput(*pool());
+    }
+    RowVectorPtr batch;
+    if (file->nextBatch(*spillInput_, *pool(), batch)) {
+      buildBatch_ = std::move(batch);
+      return true;
+    }
+    spillInput_.reset();
+    ++spillFileIndex_;
+  }
+  buildBatch_ = nullptr;
+  return false;
 }
 
 RowVectorPtr CrossJoinProbe::getOutput() {
-  if (!input_) {
-    return nullptr;
+  while (input_ != nullptr) {
+    if (buildBatch_ == nullptr) {
+      // All build batches have been joined with 'input_'.
+      auto output = getProbeMismatch();
+      input_.reset();
+      if (output != nullptr) {
+        return output;
+      }
+      break;
+    }
+    if (auto output = getCrossProduct()) {
+      return output;
+    }
   }
 
+  if (lastProber_ && !buildMismatchDone_) {
+    return getBuildMismatch();
+  }
+  return nullptr;
+}
+
+RowVectorPtr CrossJoinProbe::getCrossProduct() {
   const auto inputSize = input_->size();
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
+  auto buildSize = buildBatch_->size();
   vector_size_t probeCnt;
   if (buildSize > outputBatchSize_) {
     probeCnt = 1;
@@ -107,10 +222,9 @@ RowVectorPtr CrossJoinProbe::getOutput() {
         rawIndices + (i + 1) * buildSize,
         probeRow_ + i);
   }
-  auto output = fillOutput(size, indices);
 
   BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
+  if (probeCnt > 1 || joinCondition_ != nullptr) {
     buildIndices = allocateIndices(size, pool());
     auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
     for (auto i = 0; i < probeCnt; ++i) {
@@ -121,36 +235,233 @@ RowVectorPtr CrossJoinProbe::getOutput() {
     }
   }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
-  for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+  if (joinCondition_ != nullptr) {
+    size = evalJoinCondition(size, indices, buildIndices);
+  }
+
+  if (size > 0) {
+    if (needsProbeMismatch(joinType_)) {
+      for (auto i = 0; i < size; ++i) {
+        probeMatched_[rawIndices[i]] = true;
+      }
+    }
+    if (needsBuildMismatch(joinType_)) {
+      markBuildMatched(
+          buildIndices ? buildIndices->as<vector_size_t>() : nullptr, size);
+    }
+  }
+
+  RowVectorPtr output;
+  if (size > 0) {
+    output = fillOutput(size, indices);
+    for (const auto& projection : buildProjections_) {
+      VectorPtr buildVector = buildBatch_->childAt(projection.inputChannel);
 
-    if (buildIndices) {
-      buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+      if (buildIndices) {
+        buildVector = BaseVector::wrapInDictionary(
+            BufferPtr(nullptr), buildIndices, size, buildVector);
+      }
+      output->childAt(projection.outputChannel) = buildVector;
     }
-    output->childAt(projection.outputChannel) = buildVector;
   }
 
   probeRow_ += probeCnt;
   if (probeRow_ == inputSize) {
     probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
-      input_.reset();
+    nextBuildBatch();
+  }
+  return output;
+}
+
+vector_size_t CrossJoinProbe::evalJoinCondition(
+    vector_size_t size,
+    const BufferPtr& probeIndices,
+    const BufferPtr& buildIndices) {
+  std::vector<VectorPtr> children(filterInputType_->size());
+  for (const auto& projection : filterProbeProjections_) {
+    children[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        probeIndices,
+        size,
+        input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : filterBuildProjections_) {
+    children[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        buildIndices,
+        size,
+        buildBatch_->childAt(projection.inputChannel));
+  }
+  auto filterInput = std::make_shared<RowVector>(
+      pool(), filterInputType_, BufferPtr(nullptr), size, std::move(children));
+
+  SelectivityVector rows(size);
+  EvalCtx evalCtx(
+      operatorCtx_->execCtx(), joinCondition_.get(), filterInput.get());
+  joinCondition_->eval(rows, evalCtx, filterResult_);
+  decodedFilterResult_.decode(*filterResult_[0], rows);
+
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto row = 0; row < size; ++row) {
+    if (!decodedFilterResult_.isNullAt(row) &&
+        decodedFilterResult_.valueAt<bool>(row)) {
+      rawProbeIndices[numPassed] = rawProbeIndices[row];
+      rawBuildIndices[numPassed] = rawBuildIndices[row];
+      ++numPassed;
     }
   }
+  return numPassed;
+}
+
+void CrossJoinProbe::markBuildMatched(
+    const vector_size_t* buildIndices,
+    vector_size_t numRows) {
+  if (buildMatched_.size() <= buildIndex_) {
+    buildMatched_.resize(buildIndex_ + 1);
+  }
+  auto& matched = buildMatched_[buildIndex_];
+  matched.resize(buildBatch_->size(), false);
+  for (auto i = 0; i < numRows; ++i) {
+    matched[buildIndices ? buildIndices[i] : i] = true;
+  }
+}
+
+RowVectorPtr CrossJoinProbe::getProbeMismatch() {
+  if (!needsProbeMismatch(joinType_)) {
+    return nullptr;
+  }
+  const auto inputSize = input_->size();
+  BufferPtr indices = allocateIndices(inputSize, pool());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t numMismatch = 0;
+  for (auto row = 0; row < inputSize; ++row) {
+    if (!probeMatched_[row]) {
+      rawIndices[numMismatch++] = row;
+    }
+  }
+  if (numMismatch == 0) {
+    return nullptr;
+  }
+
+  auto output = fillOutput(numMismatch, indices);
+  for (const auto& projection : buildProjections_) {
+    output->childAt(projection.outputChannel) = BaseVector::createNullConstant(
+        outputType_->childAt(projection.outputChannel), numMismatch, pool());
+  }
   return output;
 }
 
+void CrossJoinProbe::noMoreInput() {
+  Operator::noMoreInput();
+  if (!needsBuildMismatch(joinType_) || buildSideEmpty_) {
+    return;
+  }
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish probing merges the matched build rows of all
+  // Drivers and returns the build rows without a match. The other Drivers
+  // wait for this so that their state stays alive until merged.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  mergeBuildMatched(peers);
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+
+  lastProber_ = true;
+  startBuildBatches();
+}
+
+void CrossJoinProbe::mergeBuildMatched(
+    const std::vector<std::shared_ptr<Driver>>& peers) {
+  for (const auto& peer : peers) {
+    auto* probe =
+        dynamic_cast<CrossJoinProbe*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(probe);
+    const auto& peerMatched = probe->buildMatched_;
+    if (buildMatched_.size() < peerMatched.size()) {
+      buildMatched_.resize(peerMatched.size());
+    }
+    for (auto i = 0; i < peerMatched.size(); ++i) {
+      auto& matched = buildMatched_[i];
+      if (matched.size() < peerMatched[i].size()) {
+        matched.resize(peerMatched[i].size(), false);
+      }
+      for (auto row = 0; row < peerMatched[i].size(); ++row) {
+        if (peerMatched[i][row]) {
+          matched[row] = true;
+        }
+      }
+    }
+  }
+}
+
+RowVectorPtr CrossJoinProbe::getBuildMismatch() {
+  while (buildBatch_ != nullptr) {
+    const auto buildSize = buildBatch_->size();
+    const std::vector<bool>* matched = buildIndex_ < buildMatched_.size()
+        ? &buildMatched_[buildIndex_]
+        : nullptr;
+    BufferPtr indices = allocateIndices(buildSize, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t numMismatch = 0;
+    for (auto row = 0; row < buildSize; ++row) {
+      if (matched == nullptr || row >= matched->size() || !(*matched)[row]) {
+        rawIndices[numMismatch++] = row;
+      }
+    }
+
+    auto buildBatch = std::move(buildBatch_);
+    nextBuildBatch();
+    if (numMismatch == 0) {
+      continue;
+    }
+
+    std::vector<VectorPtr> columns(outputType_->size());
+    for (const auto& projection : identityProjections_) {
+      columns[projection.outputChannel] = BaseVector::createNullConstant(
+          outputType_->childAt(projection.outputChannel), numMismatch, pool());
+    }
+    for (const auto& projection : buildProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          numMismatch,
+          indices,
+          buildBatch->childAt(projection.inputChannel));
+    }
+    return std::make_shared<RowVector>(
+        pool(),
+        outputType_,
+        BufferPtr(nullptr),
+        numMismatch,
+        std::move(columns));
+  }
+  buildMismatchDone_ = true;
+  buildMatched_.clear();
+  return nullptr;
+}
+
 bool CrossJoinProbe::isFinished() {
-  return buildSideEmpty_ || (noMoreInput_ && input_ == nullptr);
+  if (buildSideEmpty_) {
+    return true;
+  }
+  if (!noMoreInput_ || input_ != nullptr || future_.valid()) {
+    return false;
+  }
+  return !lastProber_ || buildMismatchDone_;
 }
 
 void CrossJoinProbe::close() {
   buildData_.reset();
+  buildSpillFiles_.clear();
+  buildBatch_.reset();
+  spillInput_.reset();
   Operator::close();
 }
 } // namespace facebook::velox::exec
@@ -17,8 +17,22 @@
 
 #include "velox/exec/CrossJoinBuild.h"
 #include "velox/exec/Operator.h"
+#include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
+
+/// Probe side of a nested loop join. Joins each probe input with the build
+/// side one build batch at a time. The cross product of a few probe rows and a
+/// build batch is made of dictionary wrappers over the inputs and the join
+/// condition, if any, is evaluated over it, so that only the matching rows are
+/// ever produced. For left and full joins, the probe rows without a match are
+/// returned with nulls for the build side after all build batches have been
+/// processed. For right and full joins, the last Driver to finish merges the
+/// matched build rows of all Drivers and returns the build rows without a
+/// match with nulls for the probe side.
+///
+/// If the build side has been spilled, the spilled batches are read back once
+/// per probe input.
 class CrossJoinProbe : public Operator {
  public:
   CrossJoinProbe(
@@ -34,6 +48,8 @@ class CrossJoinProbe : public Operator {
     return !noMoreInput_ && !input_ && !buildSideEmpty_;
   }
 
+  void noMoreInput() override;
+
   BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
@@ -41,20 +57,102 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
+  // Sets up the evaluation of 'condition' over the columns it references.
+  void initializeJoinCondition(
+      const core::TypedExprPtr& condition,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Positions at the first build batch. Returns false if there is none.
+  bool startBuildBatches();
+
+  // Moves to the next build batch. Returns false at the end.
+  bool nextBuildBatch();
+
+  // Sets 'buildBatch_' to the batch at 'buildIndex_'. The in-memory batches
+  // come first, followed by the spilled ones, which must be read in order.
+  bool loadBuildBatch();
+
+  // Joins the next few rows of 'input_' with 'buildBatch_' and advances to
+  // the next rows. Returns nullptr if no row matches.
+  RowVectorPtr getCrossProduct();
+
+  // Evaluates the join condition over the first 'size' rows of the cross
+  // product given by 'probeIndices' and 'buildIndices'. Compacts the indices
+  // to the rows that pass and returns their count.
+  vector_size_t evalJoinCondition(
+      vector_size_t size,
+      const BufferPtr& probeIndices,
+      const BufferPtr& buildIndices);
+
+  // Returns the rows of 'input_' without a match, with nulls for the build
+  // side, or nullptr if all rows have a match.
+  RowVectorPtr getProbeMismatch();
+
+  // Returns the next batch of build rows without a match in any probe Driver,
+  // with nulls for the probe side. Returns nullptr at the end.
+  RowVectorPtr getBuildMismatch();
+
+  void markBuildMatched(
+      const vector_size_t* buildIndices,
+      vector_size_t numRows);
+
+  // Merges the matched build rows of the peer Drivers into this.
+  void mergeBuildMatched(const std::vector<std::shared_ptr<Driver>>& peers);
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
+  const core::JoinType joinType_;
+
   std::vector<IdentityProjection> buildProjections_;
 
+  // Null if there is no join condition.
+  std::unique_ptr<ExprSet> joinCondition_;
+
+  // The columns referenced by 'joinCondition_' and where they come from.
+  RowTypePtr filterInputType_;
+  std::vector<IdentityProjection> filterProbeProjections_;
+  std::vector<IdentityProjection> filterBuildProjections_;
+  std::vector<VectorPtr> filterResult_;
+  DecodedVector decodedFilterResult_;
+
   std::optional<std::vector<VectorPtr>> buildData_;
 
-  // Index into buildData_ for the build side vector to process on next call to
-  // getOutput().
+  std::vector<std::shared_ptr<const SpillFile>> buildSpillFiles_;
+
+  // Ordinal of 'buildBatch_' among all build batches.
   size_t buildIndex_{0};
 
+  // The build batch to process on next call to getOutput().
+  RowVectorPtr buildBatch_;
+
+  // Index into 'buildSpillFiles_' and reader of the spilled batch to read
+  // next.
+  size_t spillFileIndex_{0};
+  std::unique_ptr<SpillInput> spillInput_;
+
   // Input row to process on next call to getOutput().
   vector_size_t probeRow_{0};
 
+  // For left and full joins, true for the rows of 'input_' that have a match.
+  std::vector<bool> probeMatched_;
+
+  // For right and full joins, true for the build rows that have a match,
+  // indexed by build batch and row.
+  std::vector<std::vector<bool>> buildMatched_;
+
   bool buildSideEmpty_{false};
+
+  // True if this Driver returns the build rows without a match.
+  bool lastProber_{false};
+
+  // True once the last prober has returned all build rows without a match.
+  bool buildMismatchDone_{false};
+
+  // Future for synchronizing with other Drivers of the same pipeline. All
+  // probe Drivers must be completed before the last one can return the build
+  // rows without a match.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
 };
 } // namespace facebook::velox::exec
@@ -19,7 +19,13 @@
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/FilterProject.h"
+#include "velox/exec/HashAggregation.h"
+#include "velox/exec/Limit.h"
+#include "velox/exec/MultiLevelTaskExecutor.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
 
@@ -44,7 +50,13 @@ const core::QueryConfig& DriverCtx::queryConfig() const {
 velox::memory::MemoryPool* FOLLY_NONNULL DriverCtx::addOperatorPool(
     const core::PlanNodeId& planNodeId,
     const std::string& operatorType) {
-  return task->addOperatorPool(planNodeId, pipelineId, driverId, operatorType);
+  return task->addOperatorPool(
+      planNodeId,
+      pipelineId,
+      driverId,
+      splitGroupId,
+      operatorType,
+      Operator::MemoryReclaimer::create());
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -82,6 +94,7 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
           state->operator_->recordBlockingTime(
               state->sinceMicros_, state->reason_);
         }
+        driver->recordBlockedTime(state->reason_, state->sinceMicros_);
         VELOX_CHECK(!driver->state().isSuspended);
         VELOX_CHECK(driver->state().hasBlockingFuture);
         driver->state().hasBlockingFuture = false;
@@ -89,7 +102,7 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
           // The thread will be enqueued at resume.
           return;
         }
-        Driver::enqueue(state->driver_);
+        Driver::resume(state->driver_);
       })
       .thenError(
           folly::tag_t<std::exception>{}, [state](std::exception const& e) {
@@ -102,6 +115,15 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
 
 namespace {
 
+// The executor of the Driver::run() on this thread and the Driver to run
+// next on this thread, if any. See Driver::resume().
+struct InlineResumeState {
+  folly::Executor* executor{nullptr};
+  std::shared_ptr<Driver> next;
+};
+
+thread_local InlineResumeState inlineResumeState;
+
 // Ensures that the thread is removed from its Task's thread count on exit.
 class CancelGuard {
  public:
@@ -177,8 +199,31 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  if (auto* multiLevelExecutor =
+          dynamic_cast<MultiLevelTaskExecutor*>(executor)) {
+    multiLevelExecutor->addDriver(driver, [driver]() { Driver::run(driver); });
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
+}
+
+// static
+void Driver::resume(std::shared_ptr<Driver> driver) {
+  // Only one Driver waits for the thread. Others are enqueued, so that the
+  // thread does not run a chain of resumed Drivers while the executor has
+  // other work.
+  if (!driver->inlineResume_ || inlineResumeState.executor == nullptr ||
+      inlineResumeState.next != nullptr ||
+      inlineResumeState.executor != driver->task()->queryCtx()->executor()) {
+    enqueue(std::move(driver));
+    return;
+  }
+  driver->enqueueInternal();
+  if (driver->closed_) {
+    return;
+  }
+  inlineResumeState.next = std::move(driver);
 }
 
 Driver::Driver(
@@ -189,6 +234,23 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  timelineEnabled_ = ctx_->queryConfig().driverTimelineEnabled();
+  stats_.wlock()->driverId = ctx_->driverId;
+  // A MultiLevelTaskExecutor accounts the CPU time of each Driver it runs, so
+  // its threads only run the Drivers it dequeues.
+  inlineResume_ = ctx_->queryConfig().inlineDriverResumeEnabled() &&
+      dynamic_cast<MultiLevelTaskExecutor*>(
+          ctx_->task->queryCtx()->executor()) == nullptr;
+}
+
+void Driver::initializeOperatorReclaimers() {
+  auto self = shared_from_this();
+  for (auto& op : operators_) {
+    if (auto* reclaimer = dynamic_cast<Operator::MemoryReclaimer*>(
+            op->pool()->reclaimer())) {
+      reclaimer->setOperator(op.get(), self);
+    }
+  }
 }
 
 namespace {
@@ -310,6 +372,15 @@ StopReason Driver::runInternal(
         "queuedWallNanos",
         RuntimeCounter(queuedTime, RuntimeCounter::Unit::kNanos));
   }
+  recordTime(
+      DriverStats::EventKind::kQueued,
+      BlockingReason::kNotBlocked,
+      queueTimeStartMicros_,
+      now);
+  runningSinceMicros_ = now;
+  SCOPE_EXIT {
+    finishRunningSlice();
+  };
 
   CancelGuard guard(task().get(), &state_, [&](StopReason reason) {
     // This is run on error or cancel exit.
@@ -396,6 +467,9 @@ StopReason Driver::runInternal(
                 auto lockedStats = nextOp->stats().wlock();
                 lockedStats->addInputVector(resultBytes, result->size());
               }
+              if (auto* capture = nextOp->inputCapture()) {
+                capture->capture(*result);
+              }
               RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
               nextOp->addInput(result);
               // The next iteration will see if operators_[i + 1] has
@@ -443,7 +517,10 @@ StopReason Driver::runInternal(
                 createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                   op->stats().wlock()->getOutputTiming.add(timing);
                 });
-            result = op->getOutput();
+            {
+              RuntimeStatWriterScopeGuard statsWriterGuard(op);
+              result = op->getOutput();
+            }
             if (result) {
               VELOX_CHECK(
                   result->size() > 0,
@@ -485,6 +562,24 @@ StopReason Driver::runInternal(
 
 // static
 void Driver::run(std::shared_ptr<Driver> self) {
+  if (!self->inlineResume_ || inlineResumeState.executor != nullptr) {
+    runOnce(std::move(self));
+    return;
+  }
+  inlineResumeState.executor = self->task()->queryCtx()->executor();
+  SCOPE_EXIT {
+    inlineResumeState.executor = nullptr;
+  };
+  // A Driver unblocked while 'self' runs, e.g. the consumer of the data
+  // 'self' produced, runs next on this thread while its input is in cache.
+  while (self != nullptr) {
+    runOnce(std::move(self));
+    self = std::move(inlineResumeState.next);
+  }
+}
+
+// static
+void Driver::runOnce(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
   auto reason = self->runInternal(self, blockingState, nullResult);
@@ -542,7 +637,64 @@ void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
   }
 }
 
+void Driver::recordBlockedTime(BlockingReason reason, uint64_t sinceMicros) {
+  recordTime(
+      DriverStats::EventKind::kBlocked,
+      reason,
+      sinceMicros,
+      getCurrentTimeMicro());
+}
+
+void Driver::recordTime(
+    DriverStats::EventKind kind,
+    BlockingReason reason,
+    uint64_t startMicros,
+    uint64_t endMicros) {
+  const auto durationMicros =
+      endMicros > startMicros ? endMicros - startMicros : 0;
+  auto lockedStats = stats_.wlock();
+  switch (kind) {
+    case DriverStats::EventKind::kQueued:
+      lockedStats->queuedWallNanos += durationMicros * 1'000;
+      REPORT_ADD_STAT_VALUE(kCounterDriverQueuedWallTimeUs, durationMicros);
+      break;
+    case DriverStats::EventKind::kRunning:
+      lockedStats->runningWallNanos += durationMicros * 1'000;
+      REPORT_ADD_STAT_VALUE(kCounterDriverRunningTimeUs, durationMicros);
+      break;
+    case DriverStats::EventKind::kBlocked:
+      lockedStats->blockedWallNanos[reason] += durationMicros * 1'000;
+      REPORT_ADD_STAT_VALUE(kCounterDriverBlockedTimeUs, durationMicros);
+      break;
+  }
+  if (timelineEnabled_ &&
+      lockedStats->timeline.size() < DriverStats::kMaxTimelineEvents) {
+    lockedStats->timeline.push_back(
+        {kind, reason, startMicros, durationMicros});
+  }
+}
+
+void Driver::finishRunningSlice() {
+  if (runningSinceMicros_ == 0) {
+    return;
+  }
+  recordTime(
+      DriverStats::EventKind::kRunning,
+      BlockingReason::kNotBlocked,
+      runningSinceMicros_,
+      getCurrentTimeMicro());
+  runningSinceMicros_ = 0;
+}
+
+DriverStats Driver::stats() const {
+  return stats_.copy();
+}
+
 void Driver::addStatsToTask() {
+  // The Driver may be closed while running. Counts the running time up to
+  // now.
+  finishRunningSlice();
+  task()->addDriverStats(ctx_->pipelineId, stats());
   for (auto& op : operators_) {
     auto stats = op->stats(true);
     stats.memoryStats.update(op->pool()->getMemoryUsageTracker());
@@ -591,6 +743,49 @@ bool Driver::mayPushdownAggregation(Operator* aggregation) const {
       aggregation->toString());
 }
 
+HashAggregation* Driver::splitResultCachingAggregation() const {
+  for (auto i = 1; i < operators_.size(); ++i) {
+    auto op = operators_[i].get();
+    if (dynamic_cast<FilterProject*>(op) != nullptr) {
+      continue;
+    }
+    auto aggregation = dynamic_cast<HashAggregation*>(op);
+    if (aggregation != nullptr && aggregation->cachesSplitResults()) {
+      return aggregation;
+    }
+    return nullptr;
+  }
+  return nullptr;
+}
+
+bool Driver::isDrainedUpTo(const Operator* op) const {
+  for (auto i = 1; i < operators_.size(); ++i) {
+    if (operators_[i].get() == op) {
+      return true;
+    }
+    if (!operators_[i]->needsInput()) {
+      return false;
+    }
+  }
+  VELOX_FAIL("Operator not found in its Driver: {}", op->toString());
+}
+
+std::optional<int64_t> Driver::sourceRowLimit() const {
+  for (auto i = 1; i < operators_.size(); ++i) {
+    auto op = operators_[i].get();
+    auto filterProject = dynamic_cast<FilterProject*>(op);
+    if (filterProject != nullptr && !filterProject->hasFilter()) {
+      continue;
+    }
+    auto limit = dynamic_cast<Limit*>(op);
+    if (limit != nullptr) {
+      return limit->maxInputRows();
+    }
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
 std::unordered_set<column_index_t> Driver::canPushdownFilters(
     const Operator* FOLLY_NONNULL filterSource,
     const std::vector<column_index_t>& channels) const {
@@ -694,6 +889,18 @@ std::string Driver::label() const {
   return fmt::format("<Driver {}:{}>", task()->taskId(), ctx_->driverId);
 }
 
+std::string driverEventKindToString(DriverStats::EventKind kind) {
+  switch (kind) {
+    case DriverStats::EventKind::kQueued:
+      return "queued";
+    case DriverStats::EventKind::kRunning:
+      return "running";
+    case DriverStats::EventKind::kBlocked:
+      return "blocked";
+  }
+  VELOX_UNREACHABLE();
+}
+
 std::string blockingReasonToString(BlockingReason reason) {
   switch (reason) {
     case BlockingReason::kNotBlocked:
@@ -716,6 +923,8 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForConnector";
     case BlockingReason::kWaitForSpill:
       return "kWaitForSpill";
+    case BlockingReason::kWaitForPeers:
+      return "kWaitForPeers";
   }
   VELOX_UNREACHABLE();
   return "";
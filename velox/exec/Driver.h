@@ -15,9 +15,12 @@
  */
 #pragma once
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
 #include <folly/portability/SysSyscall.h>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/time/CpuWallTimer.h"
@@ -29,6 +32,7 @@ namespace facebook::velox::exec {
 
 class Driver;
 class ExchangeClient;
+class HashAggregation;
 class Operator;
 struct OperatorStats;
 class Task;
@@ -148,6 +152,9 @@ enum class BlockingReason {
   /// Build operator is blocked waiting for all its peers to stop to run group
   /// spill on all of them.
   kWaitForSpill,
+  /// An operator is blocked waiting for the same operator in the other drivers
+  /// of the pipeline to receive all their input.
+  kWaitForPeers,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -196,6 +203,34 @@ class BlockingState {
   static std::atomic_uint64_t numBlockedDrivers_;
 };
 
+/// Time a Driver spent queued on its executor, running on a thread and
+/// blocked, and optionally the intervals of these as a timeline.
+struct DriverStats {
+  enum class EventKind { kQueued, kRunning, kBlocked };
+
+  /// An interval of the timeline. 'reason' is set for kBlocked.
+  struct Event {
+    EventKind kind;
+    BlockingReason reason;
+    uint64_t startMicros;
+    uint64_t durationMicros;
+  };
+
+  /// Max number of events kept per Driver. Later events are only added to
+  /// the totals.
+  static constexpr size_t kMaxTimelineEvents = 10'000;
+
+  int32_t driverId{0};
+  uint64_t queuedWallNanos{0};
+  uint64_t runningWallNanos{0};
+  std::unordered_map<BlockingReason, uint64_t> blockedWallNanos;
+
+  /// The intervals in time order if timelines are enabled, else empty.
+  std::vector<Event> timeline;
+};
+
+std::string driverEventKindToString(DriverStats::EventKind kind);
+
 /// Special group id to reflect the ungrouped execution.
 constexpr uint32_t kUngroupedGroupId{std::numeric_limits<uint32_t>::max()};
 
@@ -235,6 +270,13 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   static void enqueue(std::shared_ptr<Driver> instance);
 
+  /// Runs 'instance' again after the future it was blocked on is realized.
+  /// If inline resume is enabled and the realizing thread is running a Driver
+  /// on the same executor, 'instance' runs on that thread as soon as the
+  /// running Driver returns, without going through the executor queue.
+  /// Otherwise the same as enqueue(). Called inside the Task's mutex.
+  static void resume(std::shared_ptr<Driver> instance);
+
   /// Run the pipeline until it produces a batch of data or gets blocked. Return
   /// the data produced or nullptr if pipeline finished processing and will not
   /// produce more data. Return nullptr and set 'blockingState' if pipeline got
@@ -263,12 +305,31 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void initializeOperatorStats(std::vector<OperatorStats>& stats);
 
+  /// Binds the memory reclaimers of the operator memory pools to the
+  /// operators of 'this'. Called once after construction since it needs the
+  /// shared reference to 'this'.
+  void initializeOperatorReclaimers();
+
   void addStatsToTask();
 
   // Returns true if all operators between the source and 'aggregation' are
   // order-preserving and do not increase cardinality.
   bool mayPushdownAggregation(Operator* FOLLY_NONNULL aggregation) const;
 
+  // Returns the partial aggregation that is fed by the source through filters
+  // and projections and caches its results per split of the source. Returns
+  // nullptr if there is none.
+  HashAggregation* FOLLY_NULLABLE splitResultCachingAggregation() const;
+
+  // Returns true if no operator between the source and 'op' holds input that
+  // it has not passed on.
+  bool isDrainedUpTo(const Operator* FOLLY_NONNULL op) const;
+
+  // Returns the number of rows after which the Limit that is fed by the
+  // source through projections is finished. Returns std::nullopt if there is
+  // no such Limit.
+  std::optional<int64_t> sourceRowLimit() const;
+
   // Returns a subset of channels for which there are operators upstream from
   // filterSource that accept dynamically generated filters.
   std::unordered_set<column_index_t> canPushdownFilters(
@@ -303,11 +364,32 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return blockingReason_;
   }
 
+  /// Adds the time since 'sinceMicros' to the time blocked for 'reason'.
+  /// Called when the future 'this' was blocked on is realized.
+  void recordBlockedTime(BlockingReason reason, uint64_t sinceMicros);
+
+  /// Returns the queued, running and blocked time of 'this' so far.
+  DriverStats stats() const;
+
+  /// Returns the CPU time 'this' has run on a MultiLevelTaskExecutor.
+  uint64_t scheduledCpuNanos() const {
+    return scheduledCpuNanos_;
+  }
+
+  void addScheduledCpuNanos(uint64_t nanos) {
+    scheduledCpuNanos_ += nanos;
+  }
+
  private:
   void enqueueInternal();
 
+  // Runs 'self' and then the Drivers that are resumed inline on this thread
+  // while it runs.
   static void run(std::shared_ptr<Driver> self);
 
+  // Runs 'self' on the thread until it blocks, yields or finishes.
+  static void runOnce(std::shared_ptr<Driver> self);
+
   StopReason runInternal(
       std::shared_ptr<Driver>& self,
       std::shared_ptr<BlockingState>& blockingState,
@@ -315,6 +397,18 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void close();
 
+  // Adds an interval of 'kind' from 'startMicros' to 'endMicros' to the
+  // stats and, if enabled, to the timeline.
+  void recordTime(
+      DriverStats::EventKind kind,
+      BlockingReason reason,
+      uint64_t startMicros,
+      uint64_t endMicros);
+
+  // Records the running time since 'runningSinceMicros_' if 'this' is
+  // running.
+  void finishRunningSlice();
+
   // Push down dynamic filters produced by the operator at the specified
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
@@ -338,6 +432,8 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   // Timer used to track down the time we are sitting in the driver queue.
   size_t queueTimeStartMicros_{0};
+  // Start of the current run on a thread or 0 if not running.
+  size_t runningSinceMicros_{0};
   // Index of the current operator to run (or the 1st one if we haven't started
   // yet). Used to determine which operator's queueTime we should update.
   size_t curOpIndex_{0};
@@ -347,6 +443,18 @@ class Driver : public std::enable_shared_from_this<Driver> {
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  // True if 'stats_' keeps a timeline.
+  bool timelineEnabled_;
+
+  folly::Synchronized<DriverStats> stats_;
+
+  // True if Drivers unblocked by 'this' may run on its thread and 'this' may
+  // run on the thread that unblocks it. See resume().
+  bool inlineResume_;
+
+  // Set by MultiLevelTaskExecutor for choosing the queue level of 'this'.
+  std::atomic<uint64_t> scheduledCpuNanos_{0};
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
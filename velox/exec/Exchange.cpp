@@ -16,6 +16,7 @@
 #include "velox/exec/Exchange.h"
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/Memory.h>
+#include "velox/common/time/Timer.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/vector/VectorStream.h"
 
@@ -56,6 +57,16 @@ void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
   input->resetInput(std::move(ranges_));
 }
 
+VectorSerde::Options shuffleSerdeOptions(const core::QueryConfig& config) {
+  const auto name = config.shuffleCompressionCodec();
+  auto codec = compressionCodecFromName(name);
+  VELOX_USER_CHECK(
+      codec.has_value(), "Unknown shuffle compression codec: {}", name);
+  VectorSerde::Options options(codec.value());
+  options.preserveEncodings = config.shufflePreserveEncodings();
+  return options;
+}
+
 std::shared_ptr<ExchangeSource> ExchangeSource::create(
     const std::string& taskId,
     int destination,
@@ -70,6 +81,24 @@ std::shared_ptr<ExchangeSource> ExchangeSource::create(
   VELOX_FAIL("No ExchangeSource factory matches {}", taskId);
 }
 
+int64_t ExchangeSource::startRequestLocked(int64_t fairShareBytes) {
+  requestBytes_ =
+      std::max<int64_t>(1, std::min(targetRequestBytes_, fairShareBytes));
+  requestStartMicros_ = getCurrentTimeMicro();
+  ++stats_.numRequests;
+  return requestBytes_;
+}
+
+void ExchangeSource::finishRequestLocked(int64_t bytes) {
+  stats_.numBytes += bytes;
+  stats_.waitNanos += (getCurrentTimeMicro() - requestStartMicros_) * 1'000;
+  if (bytes >= requestBytes_) {
+    targetRequestBytes_ = std::min(targetRequestBytes_ * 2, kMaxRequestBytes);
+  } else if (bytes < requestBytes_ / 4) {
+    targetRequestBytes_ = std::max(targetRequestBytes_ / 2, kMinRequestBytes);
+  }
+}
+
 // static
 std::vector<ExchangeSource::Factory>& ExchangeSource::factories() {
   static std::vector<Factory> factories;
@@ -93,7 +122,7 @@ class LocalExchangeSource : public ExchangeSource {
     return !requestPending_.exchange(true);
   }
 
-  void request() override {
+  void request(uint32_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
@@ -102,7 +131,7 @@ class LocalExchangeSource : public ExchangeSource {
     buffers->getData(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
@@ -119,6 +148,7 @@ class LocalExchangeSource : public ExchangeSource {
             sequence = requestedSequence;
           }
           std::vector<std::unique_ptr<SerializedPage>> pages;
+          int64_t totalBytes = 0;
           bool atEnd = false;
           for (auto& inputPage : data) {
             if (!inputPage) {
@@ -129,6 +159,7 @@ class LocalExchangeSource : public ExchangeSource {
             inputPage->unshare();
             pages.push_back(
                 std::make_unique<SerializedPage>(std::move(inputPage), pool_));
+            totalBytes += pages.back()->size();
             inputPage = nullptr;
           }
           int64_t ackSequence;
@@ -136,6 +167,7 @@ class LocalExchangeSource : public ExchangeSource {
             std::vector<ContinuePromise> promises;
             {
               std::lock_guard<std::mutex> l(queue_->mutex());
+              finishRequestLocked(totalBytes);
               requestPending_ = false;
               for (auto& page : pages) {
                 queue_->enqueueLocked(std::move(page), promises);
@@ -163,9 +195,6 @@ class LocalExchangeSource : public ExchangeSource {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     buffers->deleteResults(taskId_, destination_);
   }
-
- private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -184,6 +213,7 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
 
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   std::shared_ptr<ExchangeSource> toRequest;
+  int64_t requestBytes = 0;
   std::shared_ptr<ExchangeSource> toClose;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -203,6 +233,8 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
       queue_->addSourceLocked();
       if (source->shouldRequestLocked()) {
         toRequest = source;
+        requestBytes =
+            source->startRequestLocked(fairShareBytesLocked(sources_.size()));
       }
     }
   }
@@ -211,7 +243,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   if (toClose) {
     toClose->close();
   } else if (toRequest) {
-    toRequest->request();
+    toRequest->request(requestBytes);
   }
 }
 
@@ -227,6 +259,7 @@ void ExchangeClient::close() {
       return;
     }
     closed_ = true;
+    closedStats_ = statsLocked();
     sources = std::move(sources_);
   }
 
@@ -239,13 +272,14 @@ void ExchangeClient::close() {
 
 std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
-    ContinueFuture* future) {
-  std::vector<std::shared_ptr<ExchangeSource>> toRequest;
+    ContinueFuture* future,
+    int32_t consumerId) {
+  std::vector<SourceRequest> toRequest;
   std::unique_ptr<SerializedPage> page;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     *atEnd = false;
-    page = queue_->dequeueLocked(atEnd, future);
+    page = queue_->dequeueLocked(atEnd, future, consumerId);
     if (*atEnd) {
       return page;
     }
@@ -253,21 +287,74 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
       return page;
     }
     // There is space for more data, send requests to sources with no pending
-    // request.
-    for (auto& source : sources_) {
+    // request. The free space is split evenly between these, so that the
+    // sources that respond fast do not fill the queue while a slow one is
+    // pending. Each round starts at the next source so that no source is
+    // always requested last.
+    const auto numSources = sources_.size();
+    for (auto i = 0; i < numSources; ++i) {
+      auto& source = sources_[(nextSourceIndex_ + i) % numSources];
       if (source->shouldRequestLocked()) {
-        toRequest.push_back(source);
+        toRequest.emplace_back(source, 0);
       }
     }
+    if (numSources > 0) {
+      nextSourceIndex_ = (nextSourceIndex_ + 1) % numSources;
+    }
+    const auto fairShareBytes = fairShareBytesLocked(toRequest.size());
+    for (auto& [source, requestBytes] : toRequest) {
+      requestBytes = source->startRequestLocked(fairShareBytes);
+    }
   }
 
   // Outside of lock
-  for (auto& source : toRequest) {
-    source->request();
+  for (auto& [source, requestBytes] : toRequest) {
+    source->request(requestBytes);
   }
   return page;
 }
 
+int64_t ExchangeClient::fairShareBytesLocked(size_t numSources) const {
+  if (numSources == 0 || queue_->totalBytes() >= queue_->minBytes()) {
+    return 0;
+  }
+  return (queue_->minBytes() - queue_->totalBytes()) / numSources;
+}
+
+std::unordered_map<std::string, RuntimeMetric> ExchangeClient::stats() const {
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  if (closed_) {
+    return closedStats_;
+  }
+  return statsLocked();
+}
+
+std::unordered_map<std::string, RuntimeMetric> ExchangeClient::statsLocked()
+    const {
+  RuntimeMetric waitNanos(RuntimeCounter::Unit::kNanos);
+  RuntimeMetric numRequests;
+  RuntimeMetric numBytes(RuntimeCounter::Unit::kBytes);
+  for (const auto& source : sources_) {
+    const auto& sourceStats = source->statsLocked();
+    waitNanos.addValue(sourceStats.waitNanos);
+    numRequests.addValue(sourceStats.numRequests);
+    numBytes.addValue(sourceStats.numBytes);
+  }
+  if (sources_.empty()) {
+    return {};
+  }
+  std::unordered_map<std::string, RuntimeMetric> stats{
+      {"exchangeSourceWaitNanos", waitNanos},
+      {"exchangeSourceRequests", numRequests},
+      {"exchangeSourceBytes", numBytes}};
+  if (const auto minActiveConsumers = queue_->minActiveConsumersLocked()) {
+    RuntimeMetric activeConsumers;
+    activeConsumers.addValue(minActiveConsumers);
+    stats.emplace("exchangeMinActiveConsumers", activeConsumers);
+  }
+  return stats;
+}
+
 ExchangeClient::~ExchangeClient() {
   close();
 }
@@ -306,6 +393,7 @@ bool Exchange::getSplits(ContinueFuture* future) {
         if (atEnd_) {
           operatorCtx_->task()->multipleSplitsFinished(
               stats_.rlock()->numSplits);
+          recordExchangeClientStats();
         }
         return false;
       }
@@ -328,11 +416,13 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   }
 
   ContinueFuture dataFuture;
-  currentPage_ = exchangeClient_->next(&atEnd_, &dataFuture);
+  currentPage_ = exchangeClient_->next(
+      &atEnd_, &dataFuture, operatorCtx_->driverCtx()->driverId);
   if (currentPage_ || atEnd_) {
     if (atEnd_ && noMoreSplits_) {
       const auto numSplits = stats_.rlock()->numSplits;
       operatorCtx_->task()->multipleSplitsFinished(numSplits);
+      recordExchangeClientStats();
     }
     return BlockingReason::kNotBlocked;
   }
@@ -357,6 +447,14 @@ bool Exchange::isFinished() {
   return atEnd_;
 }
 
+void Exchange::recordExchangeClientStats() {
+  auto clientStats = exchangeClient_->stats();
+  auto lockedStats = stats_.wlock();
+  for (auto& [name, metric] : clientStats) {
+    lockedStats->runtimeStats[name] = std::move(metric);
+  }
+}
+
 RowVectorPtr Exchange::getOutput() {
   if (!currentPage_) {
     return nullptr;
@@ -370,7 +468,11 @@ RowVectorPtr Exchange::getOutput() {
   }
 
   getSerde()->deserialize(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      &serdeOptions_);
 
   {
     auto lockedStats = stats_.wlock();
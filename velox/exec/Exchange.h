@@ -18,11 +18,19 @@
 #include <velox/common/memory/Memory.h>
 #include <velox/common/memory/MemoryAllocator.h>
 #include <memory>
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/exec/Operator.h"
+#include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
 
+/// Returns the serde options for the pages exchanged by the tasks of a query,
+/// i.e. with the codec given by 'shuffle-compression-codec' and the encodings
+/// preserved if 'shuffle-preserve-encodings' is set.
+VectorSerde::Options shuffleSerdeOptions(const core::QueryConfig& config);
+
 // Corresponds to Presto SerializedPage, i.e. a container for
 // serialize vectors in Presto wire format.
 class SerializedPage {
@@ -84,10 +92,20 @@ class SerializedPage {
 // for input.
 class ExchangeQueue {
  public:
+  // Number of dequeues after which the number of active consumers is
+  // revised. See setMaxActiveConsumers().
+  static constexpr int32_t kAdaptIntervalDequeues = 64;
+
   explicit ExchangeQueue(int64_t minBytes) : minBytes_(minBytes) {}
 
   ~ExchangeQueue() {
     clearAllPromises();
+    totalQueuedBytes_ -= totalBytes_;
+  }
+
+  /// Returns the bytes held by SerializedPages in all ExchangeQueues.
+  static int64_t totalQueuedBytes() {
+    return totalQueuedBytes_;
   }
 
   std::mutex& mutex() {
@@ -111,7 +129,10 @@ class ExchangeQueue {
       return;
     }
     totalBytes_ += page->size();
+    totalQueuedBytes_ += page->size();
+    REPORT_ADD_STAT_VALUE(kCounterExchangeReceivedBytes, page->size());
     queue_.push_back(std::move(page));
+    // Retired consumers are not resumed by arriving data.
     if (!promises_.empty()) {
       // Resume one of the waiting drivers.
       promises.push_back(std::move(promises_.back()));
@@ -133,15 +154,19 @@ class ExchangeQueue {
       atEnd_ = true;
       // NOTE: clear the serialized page queue as we won't consume from an
       // errored queue.
-      queue_.clear();
+      clearQueueLocked();
       promises = clearAllPromisesLocked();
     }
     clearPromises(promises);
   }
 
+  // Returns the next page or nullptr and sets 'future' if there is none yet.
+  // 'consumerId' identifies the caller if the number of active consumers is
+  // adapted. See setMaxActiveConsumers().
   std::unique_ptr<SerializedPage> dequeueLocked(
       bool* atEnd,
-      ContinueFuture* future) {
+      ContinueFuture* future,
+      int32_t consumerId = 0) {
     VELOX_CHECK(future);
     if (!error_.empty()) {
       *atEnd = true;
@@ -151,8 +176,15 @@ class ExchangeQueue {
       if (atEnd_) {
         *atEnd = true;
       } else {
-        promises_.emplace_back("ExchangeQueue::dequeue");
-        *future = promises_.back().getSemiFuture();
+        adaptActiveConsumersLocked(true);
+        if (consumerId >= numActiveConsumers_) {
+          parkedPromises_.emplace_back(
+              consumerId, ContinuePromise("ExchangeQueue::park"));
+          *future = parkedPromises_.back().second.getSemiFuture();
+        } else {
+          promises_.emplace_back("ExchangeQueue::dequeue");
+          *future = promises_.back().getSemiFuture();
+        }
         *atEnd = false;
       }
       return nullptr;
@@ -161,9 +193,37 @@ class ExchangeQueue {
     queue_.pop_front();
     *atEnd = false;
     totalBytes_ -= page->size();
+    totalQueuedBytes_ -= page->size();
+    adaptActiveConsumersLocked(false);
     return page;
   }
 
+  // Adapts the number of consumers that read from 'this' to the rate at which
+  // data arrives. Consumers have ids from 0 to 'maxConsumers' - 1 and are all
+  // active at first. If the dequeues often find 'this' empty, the consumer
+  // with the highest id is retired. A retired consumer that finds 'this'
+  // empty waits until it is active again or 'this' is at end. Arriving data
+  // resumes only active consumers. If the pages queue up faster than the
+  // active consumers take them, the retired consumer with the lowest id is
+  // made active again. Consumer 0 is always active.
+  void setMaxActiveConsumers(int32_t maxConsumers) {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_GT(maxConsumers, 0);
+    maxActiveConsumers_ = maxConsumers;
+    numActiveConsumers_ = maxConsumers;
+    minActiveConsumers_ = maxConsumers;
+  }
+
+  int32_t numActiveConsumersLocked() const {
+    return numActiveConsumers_;
+  }
+
+  // Returns the fewest active consumers so far or 0 if the number of active
+  // consumers is not adapted.
+  int32_t minActiveConsumersLocked() const {
+    return minActiveConsumers_;
+  }
+
   // Returns the total bytes held by SerializedPages in 'this'.
   uint64_t totalBytes() const {
     return totalBytes_;
@@ -202,10 +262,16 @@ class ExchangeQueue {
 
  private:
   std::vector<ContinuePromise> closeLocked() {
-    queue_.clear();
+    clearQueueLocked();
     return clearAllPromisesLocked();
   }
 
+  void clearQueueLocked() {
+    queue_.clear();
+    totalQueuedBytes_ -= totalBytes_;
+    totalBytes_ = 0;
+  }
+
   std::vector<ContinuePromise> checkCompleteLocked() {
     if (noMoreSources_ && numCompleted_ == numSources_) {
       atEnd_ = true;
@@ -224,7 +290,51 @@ class ExchangeQueue {
   }
 
   std::vector<ContinuePromise> clearAllPromisesLocked() {
-    return std::move(promises_);
+    auto promises = std::move(promises_);
+    for (auto& [consumerId, promise] : parkedPromises_) {
+      promises.push_back(std::move(promise));
+    }
+    parkedPromises_.clear();
+    return promises;
+  }
+
+  // Counts a dequeue that found 'this' 'empty' or left at least as many
+  // pages as active consumers. Every 'kAdaptIntervalDequeues' dequeues,
+  // retires a consumer if at least a third of the dequeues found 'this'
+  // empty or else makes one active again if more than half left such a
+  // backlog.
+  void adaptActiveConsumersLocked(bool empty) {
+    if (maxActiveConsumers_ <= 1) {
+      return;
+    }
+    if (empty) {
+      ++numEmptyDequeues_;
+    } else if (queue_.size() >= static_cast<size_t>(numActiveConsumers_)) {
+      ++numBacklogDequeues_;
+    }
+    if (++numDequeues_ < kAdaptIntervalDequeues) {
+      return;
+    }
+    if (3 * numEmptyDequeues_ >= numDequeues_ && numActiveConsumers_ > 1) {
+      --numActiveConsumers_;
+      minActiveConsumers_ = std::min(minActiveConsumers_, numActiveConsumers_);
+    } else if (
+        2 * numBacklogDequeues_ > numDequeues_ &&
+        numActiveConsumers_ < maxActiveConsumers_) {
+      ++numActiveConsumers_;
+      // The consumer made active is resumed by the next arriving page.
+      for (auto it = parkedPromises_.begin(); it != parkedPromises_.end();) {
+        if (it->first < numActiveConsumers_) {
+          promises_.push_back(std::move(it->second));
+          it = parkedPromises_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    numDequeues_ = 0;
+    numEmptyDequeues_ = 0;
+    numBacklogDequeues_ = 0;
   }
 
   static void clearPromises(std::vector<ContinuePromise>& promises) {
@@ -240,12 +350,28 @@ class ExchangeQueue {
   std::mutex mutex_;
   std::deque<std::unique_ptr<SerializedPage>> queue_;
   std::vector<ContinuePromise> promises_;
+  // Promises of retired consumers waiting to be active again, with their
+  // consumer ids.
+  std::vector<std::pair<int32_t, ContinuePromise>> parkedPromises_;
+  // Number of consumers, the number of these that are active and the fewest
+  // that were active. 0 if the active consumers are not adapted.
+  int32_t maxActiveConsumers_{0};
+  int32_t numActiveConsumers_{std::numeric_limits<int32_t>::max()};
+  int32_t minActiveConsumers_{0};
+  // Dequeues since the active consumers were last revised, and of these the
+  // ones that found the queue empty or left a backlog.
+  int32_t numDequeues_{0};
+  int32_t numEmptyDequeues_{0};
+  int32_t numBacklogDequeues_{0};
   // When set, all promises will be realized and the next dequeue will
   // throw an exception with this message.
   std::string error_;
   // Total size of SerializedPages in queue.
   uint64_t totalBytes_{0};
 
+  // Sum of 'totalBytes_' over all ExchangeQueues.
+  static inline std::atomic<int64_t> totalQueuedBytes_{0};
+
   // If 'totalBytes_' < 'minBytes_', an exchange should request more data from
   // producers.
   uint64_t minBytes_;
@@ -253,6 +379,20 @@ class ExchangeQueue {
 
 class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
  public:
+  // Bounds of the size a source adapts its requests to. The first request
+  // asks for kInitialRequestBytes.
+  static constexpr int64_t kMinRequestBytes = 64 << 10; // 64 KB
+  static constexpr int64_t kInitialRequestBytes = 1 << 20; // 1 MB
+  static constexpr int64_t kMaxRequestBytes = 32 << 20; // 32 MB
+
+  struct Stats {
+    int64_t numRequests{0};
+    int64_t numBytes{0};
+    // Total time between sending the requests and receiving their
+    // responses, i.e. the time the exchange waited for the producer.
+    int64_t waitNanos{0};
+  };
+
   using Factory = std::function<std::shared_ptr<ExchangeSource>(
       const std::string& taskId,
       int destination,
@@ -286,10 +426,30 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   // threads from issuing the same request.
   virtual bool shouldRequestLocked() = 0;
 
-  // Requests the producer to generate more data. Call only if shouldRequest()
-  // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
-  virtual void request() = 0;
+  // Requests the producer to generate up to 'maxBytes' of data. The response
+  // has at least one page if the producer has any. Call only if
+  // shouldRequest() was true. The object handles its own lifetime by
+  // acquiring a shared_from_this() pointer if needed.
+  virtual void request(uint32_t maxBytes) = 0;
+
+  // Returns the number of bytes to ask for in the next request, given that
+  // 'fairShareBytes' of the free space of the exchange queue are for 'this'.
+  // This is the smaller of the two and the size the requests to 'this' have
+  // adapted to. Call while holding a lock over queue_.mutex() after
+  // shouldRequestLocked() returned true.
+  int64_t startRequestLocked(int64_t fairShareBytes);
+
+  // Records that the request started by startRequestLocked() got 'bytes' of
+  // data. A response that fills its request means that the producer has more
+  // data ready, so the next request asks for twice as much. A response that
+  // is under a quarter of its request halves the next one, so that a slow
+  // producer does not hold queue space that it does not fill. Call while
+  // holding a lock over queue_.mutex().
+  void finishRequestLocked(int64_t bytes);
+
+  const Stats& statsLocked() const {
+    return stats_;
+  }
 
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
@@ -324,6 +484,14 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
  protected:
   memory::MemoryPool* pool_;
+
+ private:
+  // Size of the next request before capping by the fair share of the queue.
+  int64_t targetRequestBytes_{kInitialRequestBytes};
+  // Size and start time of the request in flight.
+  int64_t requestBytes_{0};
+  uint64_t requestStartMicros_{0};
+  Stats stats_;
 };
 
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
@@ -374,17 +542,41 @@ class ExchangeClient {
     return queue_;
   }
 
-  std::unique_ptr<SerializedPage> next(bool* atEnd, ContinueFuture* future);
+  // Returns the next page or nullptr and sets 'future' if there is none yet.
+  // 'consumerId' identifies the caller to the queue. See
+  // ExchangeQueue::setMaxActiveConsumers().
+  std::unique_ptr<SerializedPage>
+  next(bool* atEnd, ContinueFuture* future, int32_t consumerId = 0);
+
+  // Returns the runtime stats of the sources. Each of
+  // 'exchangeSourceWaitNanos', 'exchangeSourceRequests' and
+  // 'exchangeSourceBytes' has one value per source, so that e.g. the max of
+  // 'exchangeSourceWaitNanos' is the time spent waiting for the slowest
+  // producer.
+  std::unordered_map<std::string, RuntimeMetric> stats() const;
 
   std::string toString();
 
  private:
+  using SourceRequest = std::pair<std::shared_ptr<ExchangeSource>, int64_t>;
+
+  std::unordered_map<std::string, RuntimeMetric> statsLocked() const;
+
+  // Returns the free space of the queue divided between 'numSources'.
+  int64_t fairShareBytesLocked(size_t numSources) const;
+
   const int destination_;
   memory::MemoryPool* const pool_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
+  // Index in 'sources_' of the first source to consider for a request. Moves
+  // on with every round of requests so that the sources take turns in being
+  // requested first.
+  size_t nextSourceIndex_{0};
   bool closed_{false};
+  // The stats of 'sources_' at close().
+  std::unordered_map<std::string, RuntimeMetric> closedStats_;
 };
 
 class Exchange : public SourceOperator {
@@ -402,6 +594,7 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             operatorType),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(shuffleSerdeOptions(ctx->queryConfig())),
         exchangeClient_(std::move(exchangeClient)) {}
 
   ~Exchange() override {
@@ -437,7 +630,13 @@ class Exchange : public SourceOperator {
   /// exchangeClient_.
   bool getSplits(ContinueFuture* future);
 
+  /// Adds the per source stats of 'exchangeClient_' to the runtime stats.
+  /// Called by the operator that fetches the splits once all data is
+  /// received.
+  void recordExchangeClientStats();
+
   const core::PlanNodeId planNodeId_;
+  const VectorSerde::Options serdeOptions_;
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
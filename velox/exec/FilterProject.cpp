@@ -75,6 +75,14 @@ FilterProject::FilterProject(
     isIdentityProjection_ = true;
   }
   numExprs_ = allExprs.size();
+  if (numExprs_ > 0 && driverCtx->queryConfig().exprFusedKernelsEnabled()) {
+    const auto& inputType = project ? project->sources()[0]->outputType()
+                                    : filter->sources()[0]->outputType();
+    const std::vector<core::TypedExprPtr> projections(
+        allExprs.begin() + (hasFilter_ ? 1 : 0), allExprs.end());
+    fusedKernel_ = FusedKernel::compile(
+        hasFilter_ ? allExprs[0] : nullptr, projections, inputType);
+  }
   exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
 
   if (numExprs_ > 0 && !identityProjections_.empty()) {
@@ -97,12 +105,17 @@ FilterProject::FilterProject(
 void FilterProject::addInput(RowVectorPtr input) {
   input_ = std::move(input);
   numProcessedInputRows_ = 0;
+  // The results which the consumer has released since the previous input go
+  // to the vector pool, from where the expression evaluation gets its result
+  // vectors.
+  recycleRetainedVectors();
   if (!resultProjections_.empty()) {
     results_.resize(resultProjections_.back().inputChannel + 1);
     for (auto& result : results_) {
       if (result && result.unique() && result->isFlatEncoding()) {
         BaseVector::prepareForReuse(result, 0);
       } else {
+        retainForRecycle(std::move(result));
         result.reset();
       }
     }
@@ -129,6 +142,13 @@ RowVectorPtr FilterProject::getOutput() {
     return nullptr;
   }
 
+  if (fusedKernel_ != nullptr) {
+    RowVectorPtr output;
+    if (evalFused(output)) {
+      return output;
+    }
+  }
+
   vector_size_t size = input_->size();
   LocalSelectivityVector localRows(*operatorCtx_->execCtx(), size);
   auto* rows = localRows.get();
@@ -183,6 +203,29 @@ RowVectorPtr FilterProject::getOutput() {
       numOut, allRowsSelected ? nullptr : filterEvalCtx_.selectedIndices);
 }
 
+bool FilterProject::evalFused(RowVectorPtr& output) {
+  vector_size_t numPassed;
+  BufferPtr passedRows;
+  if (!fusedKernel_->eval(
+          *input_, pool(), numPassed, passedRows, fusedResults_)) {
+    addRuntimeStat("fusedKernelFallbackBatches", RuntimeCounter(1));
+    return false;
+  }
+  addRuntimeStat("fusedKernelBatches", RuntimeCounter(1));
+  numProcessedInputRows_ = input_->size();
+  if (numPassed == 0) {
+    input_ = nullptr;
+    output = nullptr;
+    return true;
+  }
+  const auto firstProjection = hasFilter_ ? 1 : 0;
+  for (auto i = 0; i < fusedResults_.size(); ++i) {
+    results_[firstProjection + i] = std::move(fusedResults_[i]);
+  }
+  output = fillOutput(numPassed, passedRows);
+  return true;
+}
+
 void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
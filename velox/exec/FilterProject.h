@@ -17,6 +17,7 @@
 
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
+#include "velox/expression/FusedKernel.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/expression/Expr.h"
 
@@ -33,6 +34,11 @@ class FilterProject : public Operator {
     return true;
   }
 
+  /// True if 'this' drops rows, false if it only projects.
+  bool hasFilter() const {
+    return hasFilter_;
+  }
+
   bool preservesOrder() const override {
     return true;
   }
@@ -73,9 +79,18 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx& evalCtx);
 
+  // Evaluates the input with 'fusedKernel_'. Returns false if the input has to
+  // be evaluated by 'exprs_'. Otherwise sets 'output' to the result, nullptr
+  // if no rows passed the filter.
+  bool evalFused(RowVectorPtr& output);
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
   std::unique_ptr<ExprSet> exprs_;
+  // Compiled equivalent of 'exprs_', nullptr if the expressions are not
+  // supported or the fused kernels are not enabled.
+  std::shared_ptr<const FusedKernel> fusedKernel_;
+  std::vector<VectorPtr> fusedResults_;
   int32_t numExprs_;
 
   FilterEvalCtx filterEvalCtx_;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/FragmentResultCache.h"
+
+#include <folly/hash/SpookyHashV2.h>
+
+#include "velox/common/memory/ByteStream.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Preserves the nanosecond precision of timestamps, see Spill.cpp.
+const serializer::presto::PrestoVectorSerde::PrestoOptions kSerdeOptions(
+    /*useLosslessTimestamp*/ true);
+} // namespace
+
+// static
+FragmentResultCache& FragmentResultCache::getInstance() {
+  static FragmentResultCache instance;
+  return instance;
+}
+
+void FragmentResultCache::setCapacity(uint64_t capacity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  capacity_ = capacity;
+  evictLocked();
+}
+
+std::shared_ptr<const FragmentResultCache::Entry> FragmentResultCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+  return it->second.entry;
+}
+
+void FragmentResultCache::insert(
+    const std::string& key,
+    std::shared_ptr<const Entry> entry) {
+  VELOX_CHECK_NOT_NULL(entry);
+  std::lock_guard<std::mutex> l(mutex_);
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    eraseLocked(it);
+  }
+  if (entry->bytes > capacity_) {
+    return;
+  }
+  bytes_ += entry->bytes;
+  lru_.push_back(key);
+  entries_.emplace(key, CacheEntry{std::move(entry), std::prev(lru_.end())});
+  evictLocked();
+}
+
+void FragmentResultCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+FragmentResultCache::Stats FragmentResultCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEntries = entries_.size();
+  stats.numEvictions = numEvictions_;
+  stats.bytes = bytes_;
+  return stats;
+}
+
+void FragmentResultCache::evictLocked() {
+  while (bytes_ > capacity_) {
+    VELOX_CHECK(!lru_.empty());
+    eraseLocked(entries_.find(lru_.front()));
+    ++numEvictions_;
+  }
+}
+
+void FragmentResultCache::eraseLocked(
+    std::unordered_map<std::string, CacheEntry>::iterator position) {
+  VELOX_CHECK(position != entries_.end());
+  bytes_ -= position->second.entry->bytes;
+  lru_.erase(position->second.lruPosition);
+  entries_.erase(position);
+}
+
+// static
+std::string FragmentResultCache::fingerprint(const std::string& plan) {
+  uint64_t hash1 = 0;
+  uint64_t hash2 = 0;
+  folly::hash::SpookyHashV2::Hash128(plan.data(), plan.size(), &hash1, &hash2);
+  return fmt::format("{:016x}{:016x}", hash1, hash2);
+}
+
+// static
+std::unique_ptr<folly::IOBuf> FragmentResultCache::serialize(
+    const RowVectorPtr& batch,
+    memory::MemoryPool& pool) {
+  VectorStreamGroup stream(&pool);
+  stream.createStreamTree(
+      asRowType(batch->type()), batch->size(), &kSerdeOptions);
+  const IndexRange range{0, batch->size()};
+  stream.append(batch, folly::Range<const IndexRange*>(&range, 1));
+  IOBufOutputStream out(pool);
+  stream.flush(&out);
+  // Copies the data out of 'pool', which belongs to the query.
+  auto iobuf = out.getIOBuf();
+  iobuf->coalesce();
+  return folly::IOBuf::copyBuffer(iobuf->data(), iobuf->length());
+}
+
+// static
+RowVectorPtr FragmentResultCache::deserialize(
+    const folly::IOBuf& batch,
+    const RowTypePtr& type,
+    memory::MemoryPool& pool) {
+  ByteStream input;
+  input.resetInput({ByteRange{
+      const_cast<uint8_t*>(batch.data()),
+      static_cast<int32_t>(batch.length()),
+      0}});
+  RowVectorPtr result;
+  VectorStreamGroup::read(&input, &pool, type, &result, &kSerdeOptions);
+  return result;
+}
+
+} // namespace facebook::velox::exec
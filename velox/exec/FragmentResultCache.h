@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+/// Process wide cache of the results of a plan fragment for single splits.
+/// The fragments are a partial aggregation over a table scan with optional
+/// filters and projections in between, see HashAggregation. A key consists of
+/// the plan node id and a fingerprint of the fragment plus the identity of the
+/// split, see ConnectorSplit::cacheKey(). Hits let the Task skip scanning and
+/// aggregating the split. The entries are kept in serialized form outside of
+/// the memory pools of the queries and evicted in LRU order when the cache
+/// exceeds its capacity.
+class FragmentResultCache {
+ public:
+  /// The output of a fragment for one split, one serialized IOBuf per batch.
+  struct Entry {
+    std::vector<std::unique_ptr<folly::IOBuf>> batches;
+    uint64_t bytes{0};
+  };
+
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEntries{0};
+    uint64_t numEvictions{0};
+    uint64_t bytes{0};
+  };
+
+  static constexpr uint64_t kDefaultCapacity = 256 << 20;
+
+  explicit FragmentResultCache(uint64_t capacity = kDefaultCapacity)
+      : capacity_(capacity) {}
+
+  static FragmentResultCache& getInstance();
+
+  /// Sets the max total byte size of the entries. Evicts entries as needed.
+  void setCapacity(uint64_t capacity);
+
+  uint64_t capacity() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return capacity_;
+  }
+
+  /// Returns the entry for 'key', nullptr if there is none.
+  std::shared_ptr<const Entry> find(const std::string& key);
+
+  /// Adds or replaces the entry for 'key'. Entries larger than the capacity
+  /// are not added.
+  void insert(const std::string& key, std::shared_ptr<const Entry> entry);
+
+  void clear();
+
+  Stats stats() const;
+
+  /// Returns the fingerprint of a plan fragment, given by its detailed,
+  /// recursive string representation.
+  static std::string fingerprint(const std::string& plan);
+
+  /// Serializes 'batch' for an Entry. 'pool' is used for the serialization.
+  /// The result is on the heap.
+  static std::unique_ptr<folly::IOBuf> serialize(
+      const RowVectorPtr& batch,
+      memory::MemoryPool& pool);
+
+  /// Deserializes a batch produced by serialize() into 'pool'.
+  static RowVectorPtr deserialize(
+      const folly::IOBuf& batch,
+      const RowTypePtr& type,
+      memory::MemoryPool& pool);
+
+ private:
+  struct CacheEntry {
+    std::shared_ptr<const Entry> entry;
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  // Evicts entries in LRU order until 'bytes_' is within 'capacity_'.
+  void evictLocked();
+
+  void eraseLocked(
+      std::unordered_map<std::string, CacheEntry>::iterator position);
+
+  mutable std::mutex mutex_;
+  uint64_t capacity_;
+  // The keys with the least recently used first.
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, CacheEntry> entries_;
+  uint64_t bytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+  uint64_t numEvictions_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/GlobalRowNumber.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "velox/exec/Task.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+GlobalRowNumber::GlobalRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::GlobalRowNumberNode>& planNode)
+    : Operator(
+          driverCtx,
+          planNode->outputType(),
+          operatorId,
+          planNode->id(),
+          "GlobalRowNumber") {
+  const auto numColumns = planNode->outputType()->size();
+  identityProjections_.reserve(numColumns - 1);
+  for (column_index_t i = 0; i < numColumns - 1; ++i) {
+    identityProjections_.emplace_back(i, i);
+  }
+
+  resultProjections_.emplace_back(0, numColumns - 1);
+  results_.resize(1);
+}
+
+void GlobalRowNumber::addInput(RowVectorPtr input) {
+  if (input->size() == 0) {
+    return;
+  }
+  // The batches are kept until all the drivers have their input. Lazy vectors
+  // are loaded so that the buffered batches do not refer to the source.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+  numInputRows_ += input->size();
+  inputs_.push_back(std::move(input));
+}
+
+void GlobalRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last driver to finish its input numbers all the drivers. The others
+  // wait in isBlocked() until it has.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  assignRowNumbers(peers);
+
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void GlobalRowNumber::assignRowNumbers(
+    const std::vector<std::shared_ptr<Driver>>& peers) {
+  std::vector<GlobalRowNumber*> drivers;
+  drivers.reserve(peers.size() + 1);
+  drivers.push_back(this);
+  for (auto& peer : peers) {
+    auto* op = dynamic_cast<GlobalRowNumber*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(op);
+    drivers.push_back(op);
+  }
+  std::sort(drivers.begin(), drivers.end(), [](auto* left, auto* right) {
+    return left->operatorCtx_->driverCtx()->driverId <
+        right->operatorCtx_->driverCtx()->driverId;
+  });
+
+  int64_t rowNumber = 1;
+  for (auto* op : drivers) {
+    op->firstRowNumber_ = rowNumber;
+    op->nextRowNumber_ = rowNumber;
+    rowNumber += op->numInputRows_;
+  }
+}
+
+BlockingReason GlobalRowNumber::isBlocked(ContinueFuture* future) {
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  *future = std::move(future_);
+  return BlockingReason::kWaitForPeers;
+}
+
+RowVectorPtr GlobalRowNumber::getOutput() {
+  if (!firstRowNumber_.has_value() || nextInput_ == inputs_.size()) {
+    return nullptr;
+  }
+  input_ = std::move(inputs_[nextInput_++]);
+  generateRowNumberColumn(input_->size());
+  auto output = fillOutput(input_->size(), nullptr);
+  input_ = nullptr;
+  return output;
+}
+
+bool GlobalRowNumber::isFinished() {
+  return noMoreInput_ && firstRowNumber_.has_value() &&
+      nextInput_ == inputs_.size();
+}
+
+void GlobalRowNumber::generateRowNumberColumn(vector_size_t size) {
+  // Re-use memory for the row number vector if possible.
+  VectorPtr& result = results_[0];
+  if (result && result.unique()) {
+    BaseVector::prepareForReuse(result, size);
+  } else {
+    result = BaseVector::create(BIGINT(), size, pool());
+  }
+
+  auto rawResults =
+      result->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
+  std::iota(rawResults, rawResults + size, nextRowNumber_);
+  nextRowNumber_ += size;
+}
+} // namespace facebook::velox::exec
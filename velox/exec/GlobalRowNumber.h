@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Numbers the rows of all the drivers of the pipeline from 1 without sharing
+/// a counter between them. Each driver buffers its input and counts its rows.
+/// When all the drivers have received all their input, the last one to finish
+/// assigns each driver the first number of its rows in the order of the
+/// driver ids, i.e. a prefix sum over the row counts, and the drivers number
+/// and produce their buffered batches independently.
+class GlobalRowNumber : public Operator {
+ public:
+  GlobalRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::GlobalRowNumberNode>& planNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* future) override;
+
+  bool isFinished() override;
+
+ private:
+  // Sets 'firstRowNumber_' of this and 'peers' from the row counts of the
+  // drivers.
+  void assignRowNumbers(const std::vector<std::shared_ptr<Driver>>& peers);
+
+  void generateRowNumberColumn(vector_size_t size);
+
+  // The input batches in arrival order.
+  std::vector<RowVectorPtr> inputs_;
+
+  // The number of rows in 'inputs_'.
+  int64_t numInputRows_{0};
+
+  // The index in 'inputs_' of the next batch to produce.
+  size_t nextInput_{0};
+
+  // The number of the first row of this driver. Set by the last driver to
+  // finish its input.
+  std::optional<int64_t> firstRowNumber_;
+
+  // The number of the next row to produce.
+  int64_t nextRowNumber_{0};
+
+  // Valid while waiting for the peers to finish their input.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+};
+} // namespace facebook::velox::exec
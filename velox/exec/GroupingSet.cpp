@@ -16,10 +16,24 @@
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
+#include "velox/vector/SequenceVector.h"
 
 namespace facebook::velox::exec {
 
 namespace {
+// The number of fixed size accumulators from which the aggregates are
+// extracted a block of groups at a time.
+constexpr int32_t kMinAggregatesForBlockExtraction = 32;
+
+// The bytes of group rows in a block of extracted groups. The block should
+// stay in the L2 cache while all the aggregates are extracted.
+constexpr int32_t kExtractBlockBytes = 256 << 10;
+constexpr int32_t kMinExtractBlockSize = 64;
+
+int32_t extractBlockSize(int32_t fixedRowSize) {
+  return std::max(kMinExtractBlockSize, kExtractBlockBytes / fixedRowSize);
+}
+
 bool allAreSinglyReferenced(
     const std::vector<column_index_t>& argList,
     const std::unordered_map<column_index_t, int>& channelUseCount) {
@@ -35,6 +49,11 @@ bool areAllLazyNotLoaded(const std::vector<VectorPtr>& vectors) {
     return isLazyNotLoaded(*vector);
   });
 }
+
+// The largest array hash table for which the aggregates that support it are
+// updated through dense accumulators. This bounds the dense accumulators of an
+// aggregate to a size that stays in cache.
+constexpr uint64_t kMaxDenseGroups = 64 << 10;
 } // namespace
 
 GroupingSet::GroupingSet(
@@ -45,6 +64,8 @@ GroupingSet::GroupingSet(
     std::vector<std::vector<column_index_t>>&& channelLists,
     std::vector<std::vector<VectorPtr>>&& constantLists,
     std::vector<TypePtr>&& intermediateTypes,
+    std::vector<bool>&& distinctFlags,
+    std::unique_ptr<SortedAggregations> sortedAggregations,
     bool ignoreNullKeys,
     bool isPartial,
     bool isRawInput,
@@ -60,11 +81,16 @@ GroupingSet::GroupingSet(
       channelLists_(std::move(channelLists)),
       constantLists_(std::move(constantLists)),
       intermediateTypes_(std::move(intermediateTypes)),
+      distinctFlags_(std::move(distinctFlags)),
+      sortedAggregations_(std::move(sortedAggregations)),
       ignoreNullKeys_(ignoreNullKeys),
       spillMemoryThreshold_(operatorCtx->driverCtx()
                                 ->queryConfig()
                                 .aggregationSpillMemoryThreshold()),
       spillConfig_(spillConfig),
+      maxMergeBytes_(operatorCtx->driverCtx()
+                         ->queryConfig()
+                         .preferredOutputBatchBytes()),
       stringAllocator_(operatorCtx->pool()),
       rows_(operatorCtx->pool()),
       isAdaptive_(operatorCtx->task()
@@ -81,9 +107,25 @@ GroupingSet::GroupingSet(
       ++channelUseCount[channel];
     }
   }
-  for (const std::vector<column_index_t>& argList : channelLists_) {
-    mayPushdown_.push_back(allAreSinglyReferenced(argList, channelUseCount));
+  for (auto i = 0; i < channelLists_.size(); ++i) {
+    // Aggregates over distinct inputs receive loaded vectors since the
+    // arguments are needed to find the new values.
+    mayPushdown_.push_back(
+        !distinctFlags_[i] &&
+        allAreSinglyReferenced(channelLists_[i], channelUseCount));
   }
+  VELOX_CHECK_EQ(distinctFlags_.size(), aggregates_.size());
+  distinctSets_.resize(aggregates_.size());
+  supportsDenseAccumulators_ = isRawInput_ &&
+      std::any_of(aggregates_.begin(), aggregates_.end(), [](const auto& agg) {
+        return agg->supportsDenseAccumulators();
+      });
+  extractInBlocks_ =
+      std::count_if(
+          aggregates_.begin(),
+          aggregates_.end(),
+          [](const auto& agg) { return agg->isFixedSize(); }) >=
+      kMinAggregatesForBlockExtraction;
 }
 
 GroupingSet::~GroupingSet() {
@@ -177,25 +219,44 @@ void GroupingSet::addInputForActiveRows(
     deselectRowsWithNulls(hashers, activeRows_);
   }
 
-  for (int32_t i = 0; i < hashers.size(); ++i) {
-    if (mode != BaseHashTable::HashMode::kHash) {
+  if (mode != BaseHashTable::HashMode::kHash) {
+    for (int32_t i = 0; i < hashers.size(); ++i) {
       if (!hashers[i]->computeValueIds(activeRows_, lookup_->hashes)) {
         rehash = true;
       }
-    } else {
-      hashers[i]->hash(activeRows_, i > 0, lookup_->hashes);
     }
+  } else {
+    VectorHasher::hash(hashers, activeRows_, lookup_->hashes);
   }
 
   if (rehash) {
     if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      flushDenseAccumulators();
       table_->decideHashMode(input->size());
     }
     addInputForActiveRows(input, mayPushdown);
     return;
   }
 
-  if (activeRows_.isAllSelected()) {
+  const bool probeRuns = findRunStarts(input);
+  if (probeRuns) {
+    lookup_->rows.clear();
+    runFirstRows_.resize(activeRows_.end());
+    vector_size_t firstRow = -1;
+    for (auto row = activeRows_.begin(); row < activeRows_.end(); ++row) {
+      if (bits::isBitSet(runStarts_.data(), row)) {
+        firstRow = -1;
+      }
+      if (!activeRows_.isValid(row)) {
+        continue;
+      }
+      if (firstRow < 0) {
+        firstRow = row;
+        lookup_->rows.push_back(row);
+      }
+      runFirstRows_[row] = firstRow;
+    }
+  } else if (activeRows_.isAllSelected()) {
     std::iota(lookup_->rows.begin(), lookup_->rows.end(), 0);
   } else {
     lookup_->rows.clear();
@@ -204,37 +265,115 @@ void GroupingSet::addInputForActiveRows(
   }
 
   table_->groupProbe(*lookup_);
+  if (probeRuns) {
+    auto& hits = lookup_->hits;
+    activeRows_.applyToSelected(
+        [&](auto row) { hits[row] = hits[runFirstRows_[row]]; });
+  }
   masks_.addInput(input, activeRows_);
+  if (sortedAggregations_) {
+    sortedAggregations_->addInput(
+        lookup_->hits.data(), input, masks_, activeRows_);
+  }
+
+  const bool dense = useDenseAccumulators();
+  if (dense) {
+    updateDenseGroups();
+  }
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
     if (!lookup_->newGroups.empty()) {
       aggregates_[i]->initializeNewGroups(
           lookup_->hits.data(), lookup_->newGroups);
     }
+    // Sorted aggregates receive their input when the groups are produced.
+    if (sortedAggregations_ && sortedAggregations_->isSorted(i)) {
+      continue;
+    }
 
-    const auto& rows = getSelectivityVector(i);
+    const auto* rows = &getSelectivityVector(i);
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!rows->hasSelections()) {
       continue;
     }
+    if (distinctFlags_[i]) {
+      rows = &distinctRows(i, input, *rows);
+      if (!rows->hasSelections()) {
+        continue;
+      }
+    }
 
     populateTempVectors(i, input);
     // TODO(spershin): We disable the pushdown at the moment if selectivity
     // vector has changed after groups generation, we might want to revisit
     // this.
-    const bool canPushdown = (&rows == &activeRows_) && mayPushdown &&
+    const bool canPushdown = (rows == &activeRows_) && mayPushdown &&
         mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
-    if (isRawInput_) {
+    if (dense && aggregates_[i]->supportsDenseAccumulators()) {
+      aggregates_[i]->addRawInputDense(
+          lookup_->hashes.data(),
+          table_->capacity(),
+          *rows,
+          tempVectors_,
+          canPushdown);
+      hasDenseValues_ = true;
+    } else if (isRawInput_) {
       aggregates_[i]->addRawInput(
-          lookup_->hits.data(), rows, tempVectors_, canPushdown);
+          lookup_->hits.data(), *rows, tempVectors_, canPushdown);
     } else {
       aggregates_[i]->addIntermediateResults(
-          lookup_->hits.data(), rows, tempVectors_, canPushdown);
+          lookup_->hits.data(), *rows, tempVectors_, canPushdown);
     }
   }
   tempVectors_.clear();
 }
 
+bool GroupingSet::findRunStarts(const RowVectorPtr& input) {
+  const auto& hashers = lookup_->hashers;
+  if (hashers.empty()) {
+    return false;
+  }
+  runStarts_.resize(bits::nwords(input->size()));
+  std::fill(runStarts_.begin(), runStarts_.end(), 0);
+  for (const auto& hasher : hashers) {
+    const auto* key = input->childAt(hasher->channel())->loadedVector();
+    if (!setRunStarts(*key, runStarts_.data())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GroupingSet::useDenseAccumulators() const {
+  return supportsDenseAccumulators_ &&
+      table_->hashMode() == BaseHashTable::HashMode::kArray &&
+      table_->capacity() <= kMaxDenseGroups;
+}
+
+void GroupingSet::updateDenseGroups() {
+  const auto numGroups = table_->capacity();
+  if (denseGroups_.size() < numGroups) {
+    denseGroups_.resize(numGroups, nullptr);
+  }
+  const auto& hashes = lookup_->hashes;
+  const auto& hits = lookup_->hits;
+  for (auto row : lookup_->rows) {
+    denseGroups_[hashes[row]] = hits[row];
+  }
+}
+
+void GroupingSet::flushDenseAccumulators() {
+  if (!hasDenseValues_) {
+    return;
+  }
+  for (auto& aggregate : aggregates_) {
+    if (aggregate->supportsDenseAccumulators()) {
+      aggregate->flushDenseAccumulators(denseGroups_.data());
+    }
+  }
+  hasDenseValues_ = false;
+}
+
 void GroupingSet::addRemainingInput() {
   activeRows_.resize(remainingInput_->size());
   activeRows_.clearAll();
@@ -259,6 +398,95 @@ void GroupingSet::createHashTable() {
   }
 }
 
+std::unique_ptr<GroupingSet::DistinctSet> GroupingSet::createDistinctSet(
+    size_t aggregateIndex,
+    const RowVectorPtr& input) {
+  const auto& inputType = input->type()->asRow();
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (auto channel : keyChannels_) {
+    hashers.push_back(
+        VectorHasher::create(inputType.childAt(channel), channel));
+  }
+  for (auto channel : channelLists_[aggregateIndex]) {
+    if (channel != kConstantChannel) {
+      hashers.push_back(
+          VectorHasher::create(inputType.childAt(channel), channel));
+    }
+  }
+  VELOX_CHECK(!hashers.empty());
+
+  auto distinctSet = std::make_unique<DistinctSet>();
+  distinctSet->table = HashTable<false>::createForAggregation(
+      std::move(hashers), std::vector<std::unique_ptr<Aggregate>>{}, &pool_);
+  distinctSet->lookup =
+      std::make_unique<HashLookup>(distinctSet->table->hashers());
+  if (!isAdaptive_ &&
+      distinctSet->table->hashMode() != BaseHashTable::HashMode::kHash) {
+    distinctSet->table->forceGenericHashMode();
+  }
+  return distinctSet;
+}
+
+const SelectivityVector& GroupingSet::distinctRows(
+    size_t aggregateIndex,
+    const RowVectorPtr& input,
+    const SelectivityVector& rows) {
+  bool rehash = false;
+  auto& distinctSet = distinctSets_[aggregateIndex];
+  if (!distinctSet) {
+    rehash = true;
+    distinctSet = createDistinctSet(aggregateIndex, input);
+  }
+  auto& table = *distinctSet->table;
+  auto& lookup = *distinctSet->lookup;
+  auto& hashers = lookup.hashers;
+  lookup.reset(rows.end());
+  const auto mode = table.hashMode();
+
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, rows);
+  }
+
+  if (mode != BaseHashTable::HashMode::kHash) {
+    for (auto i = 0; i < hashers.size(); ++i) {
+      if (!hashers[i]->computeValueIds(rows, lookup.hashes)) {
+        rehash = true;
+      }
+    }
+  } else {
+    VectorHasher::hash(hashers, rows, lookup.hashes);
+  }
+
+  if (rehash) {
+    if (table.hashMode() != BaseHashTable::HashMode::kHash) {
+      table.decideHashMode(input->size());
+    }
+    return distinctRows(aggregateIndex, input, rows);
+  }
+
+  lookup.rows.clear();
+  rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+  table.groupProbe(lookup);
+
+  auto& newRows = distinctSet->newRows;
+  newRows.resize(rows.size());
+  newRows.clearAll();
+  for (auto row : lookup.newGroups) {
+    newRows.setValid(row, true);
+  }
+  newRows.updateBounds();
+  return newRows;
+}
+
+void GroupingSet::clearDistinctSets() {
+  for (auto& distinctSet : distinctSets_) {
+    if (distinctSet) {
+      distinctSet->table->clear();
+    }
+  }
+}
+
 void GroupingSet::initializeGlobalAggregation() {
   if (globalAggregationInitialized_) {
     return;
@@ -312,23 +540,37 @@ void GroupingSet::addGlobalAggregationInput(
   activeRows_.setAll();
 
   masks_.addInput(input, activeRows_);
+  if (sortedAggregations_) {
+    globalGroups_.resize(numRows, lookup_->hits[0]);
+    sortedAggregations_->addInput(
+        globalGroups_.data(), input, masks_, activeRows_);
+  }
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    const auto& rows = getSelectivityVector(i);
+    if (sortedAggregations_ && sortedAggregations_->isSorted(i)) {
+      continue;
+    }
+    const auto* rows = &getSelectivityVector(i);
 
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!rows->hasSelections()) {
       continue;
     }
+    if (distinctFlags_[i]) {
+      rows = &distinctRows(i, input, *rows);
+      if (!rows->hasSelections()) {
+        continue;
+      }
+    }
 
     populateTempVectors(i, input);
     const bool canPushdown =
         mayPushdown && mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
     if (isRawInput_) {
       aggregates_[i]->addSingleGroupRawInput(
-          lookup_->hits[0], rows, tempVectors_, canPushdown);
+          lookup_->hits[0], *rows, tempVectors_, canPushdown);
     } else {
       aggregates_[i]->addSingleGroupIntermediateResults(
-          lookup_->hits[0], rows, tempVectors_, canPushdown);
+          lookup_->hits[0], *rows, tempVectors_, canPushdown);
     }
   }
   tempVectors_.clear();
@@ -345,6 +587,9 @@ bool GroupingSet::getGlobalAggregationOutput(
   }
 
   initializeGlobalAggregation();
+  if (sortedAggregations_) {
+    sortedAggregations_->addToAggregates(aggregates_);
+  }
 
   auto groups = lookup_->hits.data();
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
@@ -406,6 +651,10 @@ bool GroupingSet::getOutput(
   if (isGlobal_) {
     return getGlobalAggregationOutput(batchSize, isPartial_, iterator, result);
   }
+  flushDenseAccumulators();
+  if (sortedAggregations_) {
+    sortedAggregations_->addToAggregates(aggregates_);
+  }
   if (spiller_) {
     return getOutputWithSpill(batchSize, result);
   }
@@ -418,6 +667,7 @@ bool GroupingSet::getOutput(
     if (table_) {
       table_->clear();
     }
+    clearDistinctSets();
     if (remainingInput_) {
       addRemainingInput();
     }
@@ -436,23 +686,63 @@ void GroupingSet::extractGroups(
   }
   RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
   auto totalKeys = rows.keyTypes().size();
-  for (int32_t i = 0; i < totalKeys; ++i) {
-    auto keyVector = result->childAt(i);
-    rows.extractColumn(groups.data(), groups.size(), i, keyVector);
+  std::vector<column_index_t> keyColumns(totalKeys);
+  std::iota(keyColumns.begin(), keyColumns.end(), 0);
+  std::vector<VectorPtr> keyVectors(
+      result->children().begin(), result->children().begin() + totalKeys);
+  rows.extractColumns(groups.data(), groups.size(), keyColumns, keyVectors);
+  if (extractInBlocks_ &&
+      groups.size() > extractBlockSize(rows.fixedRowSize())) {
+    extractAggregatesInBlocks(groups, totalKeys, result);
+    return;
   }
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
-    auto& aggregateVector = result->childAt(i + totalKeys);
-    if (isPartial_) {
-      aggregates_[i]->extractAccumulators(
-          groups.data(), groups.size(), &aggregateVector);
-    } else {
-      aggregates_[i]->extractValues(
-          groups.data(), groups.size(), &aggregateVector);
+    extractAggregate(
+        i, groups.data(), groups.size(), &result->childAt(i + totalKeys));
+  }
+}
+
+void GroupingSet::extractAggregate(
+    int32_t aggregateIndex,
+    char** groups,
+    int32_t numGroups,
+    VectorPtr* result) {
+  if (isPartial_) {
+    aggregates_[aggregateIndex]->extractAccumulators(groups, numGroups, result);
+  } else {
+    aggregates_[aggregateIndex]->extractValues(groups, numGroups, result);
+  }
+}
+
+void GroupingSet::extractAggregatesInBlocks(
+    folly::Range<char**> groups,
+    column_index_t numKeys,
+    const RowVectorPtr& result) {
+  RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
+  const int32_t blockSize = extractBlockSize(rows.fixedRowSize());
+  const int32_t numGroups = groups.size();
+  blockResults_.resize(aggregates_.size());
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    result->childAt(i + numKeys)->resize(numGroups);
+  }
+  for (int32_t begin = 0; begin < numGroups; begin += blockSize) {
+    const int32_t size = std::min(blockSize, numGroups - begin);
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      auto& aggregateVector = result->childAt(i + numKeys);
+      auto& blockResult = blockResults_[i];
+      if (blockResult) {
+        BaseVector::prepareForReuse(blockResult, size);
+      } else {
+        blockResult = BaseVector::create(aggregateVector->type(), size, &pool_);
+      }
+      extractAggregate(i, groups.data() + begin, size, &blockResult);
+      aggregateVector->copy(blockResult.get(), begin, 0, size);
     }
   }
 }
 
 void GroupingSet::resetPartial() {
+  flushDenseAccumulators();
   if (table_ != nullptr) {
     table_->clear();
   }
@@ -474,27 +764,99 @@ bool GroupingSet::isPartialFull(int64_t maxBytes) {
   // per 32 buckets.
   if (stats.capacity * sizeof(void*) > maxBytes / 16 &&
       stats.numDistinct < stats.capacity / 32) {
+    flushDenseAccumulators();
     table_->decideHashMode(0, true);
   }
   return allocatedBytes() > maxBytes;
 }
 
 uint64_t GroupingSet::allocatedBytes() const {
+  uint64_t distinctBytes = 0;
+  for (const auto& distinctSet : distinctSets_) {
+    if (distinctSet) {
+      distinctBytes += distinctSet->table->allocatedBytes();
+    }
+  }
+
   if (table_) {
-    return table_->allocatedBytes();
+    return table_->allocatedBytes() + distinctBytes;
   }
 
-  return stringAllocator_.retainedSize() + rows_.allocatedBytes();
+  return stringAllocator_.retainedSize() + rows_.allocatedBytes() +
+      distinctBytes;
 }
 
 const HashLookup& GroupingSet::hashLookup() const {
   return *lookup_;
 }
 
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    const RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_ && isRawInput_);
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK(preGroupedKeyChannels_.empty());
+  VELOX_CHECK_EQ(numDistincts(), 0);
+
+  if (!intermediateRows_) {
+    // NOTE: this sets new offsets in 'aggregates_'. The rows of 'table_' are
+    // not valid accumulators anymore.
+    intermediateRows_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{},
+        false,
+        aggregates_,
+        std::vector<TypePtr>(),
+        false,
+        false,
+        false,
+        false,
+        &pool_,
+        ContainerRowSerde::instance());
+  }
+
+  const auto numRows = input->size();
+  intermediateGroups_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = intermediateRows_->newRow();
+  }
+  if (intermediateRowNumbers_.size() < numRows) {
+    intermediateRowNumbers_.resize(numRows);
+    std::iota(
+        intermediateRowNumbers_.begin(), intermediateRowNumbers_.end(), 0);
+  }
+  const auto rowNumbers = folly::Range<const vector_size_t*>(
+      intermediateRowNumbers_.data(), numRows);
+
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  masks_.addInput(input, activeRows_);
+
+  result->resize(numRows);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+  auto* groups = intermediateGroups_.data();
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    aggregates_[i]->initializeNewGroups(groups, rowNumbers);
+
+    const auto& rows = getSelectivityVector(i);
+    if (rows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregates_[i]->addRawInput(groups, rows, tempVectors_, false);
+    }
+    aggregates_[i]->extractAccumulators(
+        groups, numRows, &result->childAt(i + keyChannels_.size()));
+  }
+  tempVectors_.clear();
+  intermediateRows_->eraseRows(folly::Range<char**>(groups, numRows));
+}
+
 void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
   // Spilling is considered if this is a final or single aggregation and
-  // spillPath is set.
-  if (isPartial_ || spillConfig_ == nullptr) {
+  // spillPath is set. The buffers of the sorted aggregates check their own
+  // memory.
+  if (isPartial_ || spillConfig_ == nullptr || sortedAggregations_) {
     return;
   }
   auto numDistinct = table_->numDistinct();
@@ -574,6 +936,15 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
 }
 
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
+  if (sortedAggregations_) {
+    // The buffered input of the sorted aggregates is usually most of the
+    // memory and is spilled instead of the groups it points to.
+    if (sortedAggregations_->canSpill()) {
+      sortedAggregations_->spill();
+    }
+    return;
+  }
+  flushDenseAccumulators();
   if (!spiller_) {
     auto rows = table_->rows();
     auto types = rows->keyTypes();
@@ -598,7 +969,8 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->fileOptions);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -607,28 +979,20 @@ bool GroupingSet::getOutputWithSpill(
     int32_t batchSize,
     const RowVectorPtr& result) {
   if (outputPartition_ == -1) {
-    mergeArgs_.resize(1);
-    std::vector<TypePtr> keyTypes;
-    for (auto& hasher : table_->hashers()) {
-      keyTypes.push_back(hasher->type());
-    }
-    mergeRows_ = std::make_unique<RowContainer>(
-        keyTypes,
-        !ignoreNullKeys_,
-        aggregates_,
-        std::vector<TypePtr>(),
-        false,
-        false,
-        false,
-        false,
-        &pool_,
-        ContainerRowSerde::instance());
+    createMergeRows();
     // Take ownership of the rows and free the hash table. The table will not be
     // needed for producing spill output.
     rowsWhileReadingSpill_ = table_->moveRows();
     table_.reset();
+    // No more input is expected, so the values seen by the distinct
+    // aggregates are not needed either.
+    for (auto& distinctSet : distinctSets_) {
+      distinctSet.reset();
+    }
     outputPartition_ = 0;
-    nonSpilledRows_ = spiller_->finishSpill();
+    if (!spillPartitionsTaken_) {
+      nonSpilledRows_ = spiller_->finishSpill();
+    }
   }
 
   if (nonSpilledIndex_ < nonSpilledRows_.value().size()) {
@@ -641,6 +1005,9 @@ bool GroupingSet::getOutputWithSpill(
     nonSpilledIndex_ += numGroups;
     return true;
   }
+  if (spillPartitionsTaken_) {
+    return false;
+  }
   while (outputPartition_ < spiller_->state().maxPartitions()) {
     if (!merge_) {
       merge_ = spiller_->startMerge(outputPartition_);
@@ -656,6 +1023,66 @@ bool GroupingSet::getOutputWithSpill(
   return false;
 }
 
+void GroupingSet::createMergeRows() {
+  mergeArgs_.resize(1);
+  std::vector<TypePtr> keyTypes;
+  for (auto& hasher : table_->hashers()) {
+    keyTypes.push_back(hasher->type());
+  }
+  mergeRows_ = std::make_unique<RowContainer>(
+      keyTypes,
+      !ignoreNullKeys_,
+      aggregates_,
+      std::vector<TypePtr>(),
+      false,
+      false,
+      false,
+      false,
+      &pool_,
+      ContainerRowSerde::instance());
+}
+
+SpillPartitionSet GroupingSet::takeSpillPartitions() {
+  VELOX_CHECK(noMoreInput_);
+  VELOX_CHECK(!isPartial_);
+  SpillPartitionSet partitions;
+  if (spiller_ == nullptr) {
+    return partitions;
+  }
+  // The accumulators of the groups to spill must be up to date.
+  flushDenseAccumulators();
+  nonSpilledRows_ = spiller_->finishSpillToFiles(partitions);
+  spillPartitionsTaken_ = true;
+  return partitions;
+}
+
+void GroupingSet::startSpillPartitionMerge(
+    std::unique_ptr<SpillPartition> partition) {
+  VELOX_CHECK_NULL(merge_);
+  if (mergeRows_ == nullptr) {
+    // 'this' has not spilled. Its groups have all been produced, so the
+    // aggregates can be set up for the layout of 'mergeRows_'.
+    VELOX_CHECK_NOT_NULL(table_);
+    createMergeRows();
+  }
+  merge_ = partition->createOrderedReader(
+      spillConfig_ != nullptr ? spillConfig_->executor : nullptr);
+  nextKeyIsEqual_ = false;
+}
+
+bool GroupingSet::getSpillPartitionOutput(
+    int32_t batchSize,
+    const RowVectorPtr& result) {
+  if (merge_ == nullptr) {
+    return false;
+  }
+  if (mergeNext(batchSize, result)) {
+    return true;
+  }
+  merge_ = nullptr;
+  return false;
+}
+
 bool GroupingSet::mergeNext(int32_t batchSize, const RowVectorPtr& result) {
   for (;;) {
     auto next = merge_->nextWithEquals();
@@ -670,13 +1097,20 @@ bool GroupingSet::mergeNext(int32_t batchSize, const RowVectorPtr& result) {
     updateRow(*next.first, mergeState_);
     nextKeyIsEqual_ = next.second;
     next.first->pop();
-    if (!nextKeyIsEqual_ && mergeRows_->numRows() >= batchSize) {
+    if (!nextKeyIsEqual_ &&
+        (mergeRows_->numRows() >= batchSize ||
+         mergeRowsVariableBytes() >= maxMergeBytes_)) {
       extractSpillResult(result);
       return true;
     }
   }
 }
 
+uint64_t GroupingSet::mergeRowsVariableBytes() const {
+  const auto& allocator = mergeRows_->stringAllocator();
+  return allocator.retainedSize() - allocator.freeSpace();
+}
+
 void GroupingSet::initializeRow(
     SpillMergeStream& keys,
     char* FOLLY_NONNULL row) {
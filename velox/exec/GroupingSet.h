@@ -17,6 +17,7 @@
 
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/HashTable.h"
+#include "velox/exec/SortedAggregations.h"
 #include "velox/exec/Spiller.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/VectorHasher.h"
@@ -35,6 +36,8 @@ class GroupingSet {
       std::vector<std::vector<column_index_t>>&& channelLists,
       std::vector<std::vector<VectorPtr>>&& constantLists,
       std::vector<TypePtr>&& intermediateTypes,
+      std::vector<bool>&& distinctFlags,
+      std::unique_ptr<SortedAggregations> sortedAggregations,
       bool ignoreNullKeys,
       bool isPartial,
       bool isRawInput,
@@ -76,6 +79,13 @@ class GroupingSet {
 
   const HashLookup& hashLookup() const;
 
+  /// Converts each row of 'input' into a separate group and copies the grouping
+  /// keys and the intermediate results of the aggregates into 'result'. Used
+  /// by a partial aggregation that no longer reduces its input enough to be
+  /// worth hashing. The hash table must be empty and is not used for
+  /// accumulating groups after this has been called.
+  void toIntermediate(const RowVectorPtr& input, const RowVectorPtr& result);
+
   /// Spills content until under 'targetRows' and under 'targetBytes'
   /// of out of line data are left. If targetRows is 0, spills
   /// everything and physically frees the data in the
@@ -85,9 +95,33 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Finishes spilling after noMoreInput() and returns the spilled partitions
+  /// instead of merging them in getOutput(), which then produces only the
+  /// groups of the partitions that have not spilled. The groups of the
+  /// spilled partitions that are still in memory are written to their files
+  /// first, so that any GroupingSet of the same plan node can merge the
+  /// partitions with startSpillPartitionMerge(). Returns an empty set if
+  /// nothing has spilled.
+  SpillPartitionSet takeSpillPartitions();
+
+  /// Starts merging the groups of 'partition', taken from this or another
+  /// GroupingSet of the same plan node by takeSpillPartitions(). Called after
+  /// getOutput() has produced all groups of 'this'. The groups of 'partition'
+  /// are then produced by getSpillPartitionOutput().
+  void startSpillPartitionMerge(std::unique_ptr<SpillPartition> partition);
+
+  /// Produces the next batch of at most 'batchSize' groups of the partition
+  /// passed to startSpillPartitionMerge() in 'result'. Returns false when all
+  /// groups of the partition have been produced.
+  bool getSpillPartitionOutput(int32_t batchSize, const RowVectorPtr& result);
+
   /// Returns the spiller stats including total bytes and rows spilled so far.
   Spiller::Stats spilledStats() const {
-    return spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
+    auto stats = spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
+    if (sortedAggregations_) {
+      stats += sortedAggregations_->spilledStats();
+    }
+    return stats;
   }
 
   /// Returns the hashtable stats.
@@ -112,6 +146,23 @@ class GroupingSet {
 
   void addRemainingInput();
 
+  // Returns true if the aggregates are updated through their dense
+  // accumulators for the current state of 'table_'.
+  bool useDenseAccumulators() const;
+
+  // Records the group row of each active row of the input at the group ID of
+  // the row for flushing the dense accumulators.
+  void updateDenseGroups();
+
+  // Returns true if all the grouping keys of 'input' are SequenceVectors and
+  // sets the first row of each run where any key changes in 'runStarts_'.
+  bool findRunStarts(const RowVectorPtr& input);
+
+  // Combines the values in the dense accumulators of the aggregates into the
+  // group rows. Must be called before the accumulators in the rows are read or
+  // 'table_' is rehashed or cleared.
+  void flushDenseAccumulators();
+
   void initializeGlobalAggregation();
 
   void destroyGlobalAggregations();
@@ -133,6 +184,33 @@ class GroupingSet {
   // index for this aggregation), otherwise it returns reference to activeRows_.
   const SelectivityVector& getSelectivityVector(size_t aggregateIndex) const;
 
+  // The combinations of grouping keys and argument values seen so far by an
+  // aggregate over distinct inputs. 'table' is keyed on the grouping keys
+  // followed by the non-constant arguments of the aggregate. A row is passed
+  // to the aggregate only if it adds a new entry to 'table'.
+  struct DistinctSet {
+    std::unique_ptr<BaseHashTable> table;
+    std::unique_ptr<HashLookup> lookup;
+    // The rows of the last input that added a new entry to 'table'.
+    SelectivityVector newRows;
+  };
+
+  std::unique_ptr<DistinctSet> createDistinctSet(
+      size_t aggregateIndex,
+      const RowVectorPtr& input);
+
+  // Returns the subset of 'rows' of 'input' that carry a combination of
+  // grouping keys and arguments not seen before by aggregate
+  // 'aggregateIndex', and records these combinations as seen.
+  const SelectivityVector& distinctRows(
+      size_t aggregateIndex,
+      const RowVectorPtr& input,
+      const SelectivityVector& rows);
+
+  // Forgets the values seen by all the aggregates over distinct inputs. Called
+  // when the groups they belong to have been produced.
+  void clearDistinctSets();
+
   // Checks if input will fit in the existing memory and increases
   // reservation if not. If reservation cannot be increased, spills
   // enough to make 'input' fit.
@@ -143,12 +221,33 @@ class GroupingSet {
   // otherwise.
   void extractGroups(folly::Range<char**> groups, const RowVectorPtr& result);
 
+  // Extracts the intermediate or final result of the aggregate at
+  // 'aggregateIndex' for 'numGroups' 'groups' into 'result'.
+  void extractAggregate(
+      int32_t aggregateIndex,
+      char** groups,
+      int32_t numGroups,
+      VectorPtr* result);
+
+  // Extracts the aggregates for 'groups' into the children of 'result' that
+  // follow the 'numKeys' keys a block of groups at a time: all the aggregates
+  // read a block of group rows while it is in cache and their results are
+  // copied into 'result'. Used for wide aggregations, where extracting one
+  // aggregate at a time reloads each group row once per aggregate.
+  void extractAggregatesInBlocks(
+      folly::Range<char**> groups,
+      column_index_t numKeys,
+      const RowVectorPtr& result);
+
   // Produces output in if spilling has occurred. First produces data
   // from non-spilled partitions, then merges spill runs and unspilled data
   // form spilled partitions. Returns nullptr when at end. 'batchSize' specifies
   // the max number of output rows in 'result'.
   bool getOutputWithSpill(int32_t batchSize, const RowVectorPtr& result);
 
+  // Creates 'mergeRows_' for the groups merged from spilled data.
+  void createMergeRows();
+
   // Reads rows from the current spilled partition until producing a batch of
   // final results in 'result'. Returns false and leaves 'result' empty when
   // the partition is fully read. 'batchSize' specifies the max number of output
@@ -171,6 +270,11 @@ class GroupingSet {
   // 'keys'. This is called for each row received from a merge of spilled data.
   void updateRow(SpillMergeStream& keys, char* FOLLY_NONNULL row);
 
+  // Returns the bytes of variable width keys and accumulators of the rows in
+  // 'mergeRows_', e.g. the values collected by array_agg for the groups
+  // merged so far.
+  uint64_t mergeRowsVariableBytes() const;
+
   // Copies the finalized state from 'mergeRows' to 'result' and clears
   // 'mergeRows'. Used for producing a batch of results when aggregating spilled
   // groups.
@@ -197,6 +301,33 @@ class GroupingSet {
   // Types for extracting accumulators for spilling.
   const std::vector<TypePtr> intermediateTypes_;
 
+  // True for the elements of 'aggregates_' computed over distinct inputs.
+  const std::vector<bool> distinctFlags_;
+
+  // The values seen by each aggregate over distinct inputs. Aligned with
+  // 'aggregates_'. Null for aggregates over all inputs and before the first
+  // input is received. These are not spilled: keeping them in memory while
+  // the groups are spilled guarantees that the accumulators merged from the
+  // spill runs of a group cover disjoint sets of values.
+  std::vector<std::unique_ptr<DistinctSet>> distinctSets_;
+
+  // Buffers and sorts the input of the aggregates with an ORDER BY clause.
+  // Null if there are no such aggregates. The buffered rows point to the
+  // groups, so the groups are not spilled when this is set. The buffers spill
+  // instead.
+  std::unique_ptr<SortedAggregations> sortedAggregations_;
+
+  // The group row for each row of the input of a global aggregation. Used for
+  // buffering the input of 'sortedAggregations_'.
+  std::vector<char*> globalGroups_;
+
+  // The rows of the input where a run of equal keys starts if all the keys
+  // are SequenceVectors. Only the first active row of each run is looked up
+  // in 'table_'. 'runFirstRows_' is the first active row of the run of each
+  // active row.
+  std::vector<uint64_t> runStarts_;
+  std::vector<vector_size_t> runFirstRows_;
+
   const bool ignoreNullKeys_;
 
   // The maximum memory usage that a final aggregation can hold before spilling.
@@ -205,12 +336,38 @@ class GroupingSet {
 
   const Spiller::Config* FOLLY_NULLABLE const spillConfig_; // Not owned.
 
+  // The limit on the variable width state of the groups merged from spilled
+  // data before they are produced as a batch of output. Bounds the memory
+  // for merging groups with large accumulators, e.g. array_agg, where the
+  // row count of the output batch would admit too much data.
+  const uint64_t maxMergeBytes_;
+
   // Boolean indicating whether accumulators for a global aggregation (i.e.
   // aggregation with no grouping keys) have been initialized.
   bool globalAggregationInitialized_{false};
 
   std::vector<bool> mayPushdown_;
 
+  // True if all aggregates support dense accumulators and take raw input. See
+  // Aggregate::supportsDenseAccumulators().
+  bool supportsDenseAccumulators_{false};
+
+  // The group row for each group ID, i.e. each position in 'table_' in array
+  // hash mode, seen since the dense accumulators were last flushed.
+  std::vector<char*> denseGroups_;
+
+  // True if the dense accumulators may have values that have not been flushed
+  // into the group rows.
+  bool hasDenseValues_{false};
+
+  // True if the aggregates are extracted a block of groups at a time. Set if
+  // there are many fixed size accumulators.
+  bool extractInBlocks_{false};
+
+  // The results of each aggregate for a block of groups in
+  // extractAggregatesInBlocks().
+  std::vector<VectorPtr> blockResults_;
+
   // Place for the arguments of the aggregate being updated.
   std::vector<VectorPtr> tempVectors_;
   std::unique_ptr<BaseHashTable> table_;
@@ -267,9 +424,18 @@ class GroupingSet {
   // Index of first in 'nonSpilledRows_' that has not been added to output.
   size_t nonSpilledIndex_ = 0;
 
+  // True if the spilled partitions have been taken by takeSpillPartitions()
+  // and are not merged by getOutput().
+  bool spillPartitionsTaken_{false};
+
   // Pool of the OperatorCtx. Used for spilling.
   memory::MemoryPool& pool_;
 
+  // Holds the single-row groups created by toIntermediate(). Has no keys.
+  std::unique_ptr<RowContainer> intermediateRows_;
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
+
   // The RowContainer of 'table_' is moved here before freeing
   // 'table_' when starting to read spill output.
   std::unique_ptr<RowContainer> rowsWhileReadingSpill_;
@@ -20,6 +20,78 @@
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Returns true if the input of 'aggregationNode' comes from a table scan
+// through filters and projections only.
+bool readsTableScan(const core::AggregationNode& aggregationNode) {
+  const core::PlanNode* source = aggregationNode.sources()[0].get();
+  while (dynamic_cast<const core::FilterNode*>(source) != nullptr ||
+         dynamic_cast<const core::ProjectNode*>(source) != nullptr) {
+    source = source->sources()[0].get();
+  }
+  return dynamic_cast<const core::TableScanNode*>(source) != nullptr;
+}
+
+// Returns true if 'input', which added 'numNewGroups' groups, has at most half
+// as many runs of equal 'keys' as rows and all runs but the first started a
+// new group. The first run may continue the last group of the previous batch.
+bool isClusteredBatch(
+    const RowVector& input,
+    const std::vector<column_index_t>& keys,
+    uint64_t numNewGroups) {
+  const auto numRows = input.size();
+  const auto maxRuns = std::min<uint64_t>(numNewGroups + 1, numRows / 2);
+  std::vector<const BaseVector*> keyVectors;
+  keyVectors.reserve(keys.size());
+  for (auto key : keys) {
+    keyVectors.push_back(input.childAt(key)->loadedVector());
+  }
+  uint64_t numRuns = 1;
+  for (vector_size_t row = 1; row < numRows; ++row) {
+    for (const auto* key : keyVectors) {
+      if (!key->equalValueAt(key, row - 1, row)) {
+        if (++numRuns > maxRuns) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  return numRuns <= maxRuns;
+}
+
+// Returns true if the drivers of 'aggregationNode' share their hash tables.
+// Distinct aggregations produce their groups as they see them and
+// pre-grouped keys flush the groups as the keys change, so neither gains from
+// sharing. The groups of a shared table do not belong to any split or driver,
+// so these can't be cached per split or spilled.
+bool sharesPartialAggregation(
+    const core::AggregationNode& aggregationNode,
+    const core::QueryConfig& config) {
+  return config.sharedPartialAggregationEnabled() &&
+      aggregationNode.step() == core::AggregationNode::Step::kPartial &&
+      !aggregationNode.aggregates().empty() &&
+      !aggregationNode.groupingKeys().empty() &&
+      aggregationNode.preGroupedKeys().empty() &&
+      !aggregationNode.canSpill(config) &&
+      !(config.fragmentResultCacheEnabled() &&
+        readsTableScan(aggregationNode));
+}
+
+// Returns true if the drivers of 'aggregationNode' merge each other's spilled
+// partitions. The groups of a final aggregation with more than one driver are
+// partitioned on the grouping keys between the drivers, so that a spilled
+// partition of any driver can be merged into final results on its own. The
+// groups of sorted aggregates are not spilled.
+bool mergesSpillPartitionsInParallel(
+    const core::AggregationNode& aggregationNode,
+    const core::QueryConfig& config) {
+  return config.aggregationSpillParallelMergeEnabled() &&
+      aggregationNode.canSpill(config) &&
+      !aggregationNode.groupingKeys().empty() &&
+      !aggregationNode.hasSortedAggregates();
+}
+} // namespace
 
 HashAggregation::HashAggregation(
     int32_t operatorId,
@@ -46,6 +118,27 @@ HashAggregation::HashAggregation(
           aggregationNode->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kAggregate)
               : std::nullopt),
+      sharePartialAggregation_(sharesPartialAggregation(
+          *aggregationNode,
+          driverCtx->queryConfig())),
+      // The groups of a shared table come from all drivers, so the input of
+      // one driver says nothing about how well they are reduced.
+      canAbandonPartialAggregation_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isDistinct_ && !isGlobal_ &&
+          aggregationNode->preGroupedKeys().empty() &&
+          !aggregationNode->ignoreNullKeys() && !sharePartialAggregation_ &&
+          driverCtx->queryConfig().hashAdaptivityEnabled()),
+      detectClusteredInput_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isDistinct_ && !isGlobal_ &&
+          aggregationNode->preGroupedKeys().empty() &&
+          !sharePartialAggregation_ &&
+          driverCtx->queryConfig().hashAdaptivityEnabled()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {
   VELOX_CHECK_NOT_NULL(memoryTracker_, "Memory usage tracker is not set");
@@ -60,6 +153,7 @@ HashAggregation::HashAggregation(
         channel,
         kConstantChannel,
         "Aggregation doesn't allow constant grouping keys");
+    groupingKeyChannels_.push_back(channel);
     hashers.push_back(VectorHasher::create(key->type(), channel));
   }
 
@@ -79,8 +173,25 @@ HashAggregation::HashAggregation(
   std::vector<std::vector<column_index_t>> args;
   std::vector<std::vector<VectorPtr>> constantLists;
   std::vector<TypePtr> intermediateTypes;
+  const auto& distinctFlags = aggregationNode->distinctFlags();
+  std::vector<bool> aggrDistinctFlags(numAggregates, false);
+  const auto& sortingKeys = aggregationNode->sortingKeys();
+  std::vector<std::vector<column_index_t>> sortingChannels(numAggregates);
+  std::vector<std::vector<CompareFlags>> sortingFlags(numAggregates);
   for (auto i = 0; i < numAggregates; i++) {
     const auto& aggregate = aggregationNode->aggregates()[i];
+    if (i < distinctFlags.size()) {
+      aggrDistinctFlags[i] = distinctFlags[i];
+    }
+    if (i < sortingKeys.size()) {
+      for (auto j = 0; j < sortingKeys[i].size(); ++j) {
+        sortingChannels[i].push_back(
+            exprToChannel(sortingKeys[i][j].get(), inputType));
+        const auto& order = aggregationNode->sortingOrders()[i][j];
+        sortingFlags[i].push_back(
+            {order.isNullsFirst(), order.isAscending(), false, false});
+      }
+    }
 
     std::vector<column_index_t> channels;
     std::vector<VectorPtr> constants;
@@ -120,6 +231,16 @@ HashAggregation::HashAggregation(
       aggrMaskChannels.emplace_back(std::nullopt);
     }
 
+    if (aggrDistinctFlags[i]) {
+      VELOX_USER_CHECK(
+          std::any_of(
+              channels.begin(),
+              channels.end(),
+              [](auto channel) { return channel != kConstantChannel; }),
+          "Distinct aggregate must have at least one non-constant argument: {}",
+          aggregate->toString());
+    }
+
     const auto& resultType = outputType_->childAt(numHashers + i);
     aggregates.push_back(Aggregate::create(
         aggregate->name(), aggregationNode->step(), argTypes, resultType));
@@ -145,6 +266,21 @@ HashAggregation::HashAggregation(
     }
   }
 
+  std::unique_ptr<SortedAggregations> sortedAggregations;
+  if (aggregationNode->hasSortedAggregates()) {
+    sortedAggregations = std::make_unique<SortedAggregations>(
+        inputType,
+        sortingChannels,
+        sortingFlags,
+        args,
+        constantLists,
+        aggrMaskChannels,
+        outputBatchRows(),
+        pool(),
+        spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
+        driverCtx->queryConfig().aggregationSpillMemoryThreshold());
+  }
+
   groupingSet_ = std::make_unique<GroupingSet>(
       std::move(hashers),
       std::move(preGroupedChannels),
@@ -153,14 +289,103 @@ HashAggregation::HashAggregation(
       std::move(args),
       std::move(constantLists),
       std::move(intermediateTypes),
+      std::move(aggrDistinctFlags),
+      std::move(sortedAggregations),
       aggregationNode->ignoreNullKeys(),
       isPartialOutput_,
       isRawInput(aggregationNode->step()),
       spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
       operatorCtx_.get());
+
+  // The operators of all drivers are created under the task lock before any
+  // of them runs, so all shards are added before rows are assigned to them.
+  if (sharePartialAggregation_) {
+    sharedAggregation_ =
+        operatorCtx_->task()->getSharedPartialAggregationLocked(
+            operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+    shard_ = sharedAggregation_->addShard(groupingSet_.get());
+  }
+
+  if (mergesSpillPartitionsInParallel(
+          *aggregationNode, driverCtx->queryConfig())) {
+    spillPartitions_ = operatorCtx_->task()->getSpillPartitionQueueLocked(
+        operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  }
+
+  // The plan string covers the aggregation and everything below it up to the
+  // table scan, but not the plan node ids, so that different queries running
+  // the same fragment share the cache entries.
+  if (driverCtx->queryConfig().fragmentResultCacheEnabled() &&
+      aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+      !isDistinct_ && !isGlobal_ && aggregationNode->preGroupedKeys().empty() &&
+      readsTableScan(*aggregationNode)) {
+    splitResultCachePrefix_ = FragmentResultCache::fingerprint(
+        aggregationNode->toString(/*detailed*/ true, /*recursive*/ true));
+  }
+}
+
+void HashAggregation::updateRuntimeStats() {
+  const auto spillStats = groupingSet_->spilledStats();
+  const auto hashTableStats = groupingSet_->hashTableStats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+
+  lockedStats->runtimeStats["hashtable.capacity"] =
+      RuntimeMetric(hashTableStats.capacity);
+  lockedStats->runtimeStats["hashtable.numRehashes"] =
+      RuntimeMetric(hashTableStats.numRehashes);
+  lockedStats->runtimeStats["hashtable.numDistinct"] =
+      RuntimeMetric(hashTableStats.numDistinct);
+  lockedStats->runtimeStats["hashtable.numTombstones"] =
+      RuntimeMetric(hashTableStats.numTombstones);
+  lockedStats->runtimeStats["hashtable.hashMode"] =
+      RuntimeMetric(hashTableStats.hashMode);
+  lockedStats->runtimeStats["hashtable.numHashModeChanges"] =
+      RuntimeMetric(hashTableStats.numHashModeChanges);
+  if (hashTableStats.hashModeFallback) {
+    lockedStats->runtimeStats["hashtable.hashModeFallback"] = RuntimeMetric(1);
+  }
+  if (hashTableStats.numProbes != 0) {
+    lockedStats->runtimeStats["hashtable.probeChainLengthPct"] =
+        RuntimeMetric(hashTableStats.avgProbeChainLength() * 100);
+  }
+}
+
+bool HashAggregation::canReclaim() const {
+  // Spilling is only possible while accumulating input. The spilled groups are
+  // merged back when producing the output.
+  return spillConfig_.has_value() && !noMoreInput_ &&
+      groupingSet_ != nullptr && groupingSet_->numRows() > 0;
+}
+
+uint64_t HashAggregation::reclaimableBytes() const {
+  return canReclaim() ? groupingSet_->allocatedBytes() : 0;
+}
+
+void HashAggregation::reclaim(uint64_t /*targetBytes*/) {
+  if (!canReclaim()) {
+    return;
+  }
+  // Spills all the groups. This frees the rows of the hash table and keeps it
+  // ready to accumulate more input.
+  groupingSet_->spill(0, 0);
+  updateRuntimeStats();
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartialAggregation_) {
+    // The rows are converted into intermediate results in getOutput().
+    input_ = std::move(input);
+    numInputRows_ += input_->size();
+    return;
+  }
+  if (sharedAggregation_ != nullptr) {
+    addSharedInput(input);
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
@@ -168,24 +393,7 @@ void HashAggregation::addInput(RowVectorPtr input) {
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
   numInputVectors_ += 1;
-  {
-    const auto spillStats = groupingSet_->spilledStats();
-    const auto hashTableStats = groupingSet_->hashTableStats();
-    auto lockedStats = stats_.wlock();
-    lockedStats->spilledBytes = spillStats.spilledBytes;
-    lockedStats->spilledRows = spillStats.spilledRows;
-    lockedStats->spilledPartitions = spillStats.spilledPartitions;
-    lockedStats->spilledFiles = spillStats.spilledFiles;
-
-    lockedStats->runtimeStats["hashtable.capacity"] =
-        RuntimeMetric(hashTableStats.capacity);
-    lockedStats->runtimeStats["hashtable.numRehashes"] =
-        RuntimeMetric(hashTableStats.numRehashes);
-    lockedStats->runtimeStats["hashtable.numDistinct"] =
-        RuntimeMetric(hashTableStats.numDistinct);
-    lockedStats->runtimeStats["hashtable.numTombstones"] =
-        RuntimeMetric(hashTableStats.numTombstones);
-  }
+  updateRuntimeStats();
 
   // NOTE: we should not trigger partial output flush in case of global
   // aggregation as the final aggregator will handle it the same way as the
@@ -204,6 +412,22 @@ void HashAggregation::addInput(RowVectorPtr input) {
         groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
       partialFull_ = true;
     }
+
+    if (abandonPartialAggregationEarly(groupingSet_->numDistincts())) {
+      // Flush the groups accumulated so far and stop hashing afterwards.
+      partialFull_ = true;
+      abandonPartialAggregation_ = true;
+    }
+
+    if (detectClusteredInput_) {
+      updateClusteredInput(*input);
+      if (clusteredInput_) {
+        // The groups of this batch are not expected to recur, except for the
+        // last one, which may continue into the next batch. Producing two
+        // partial results for that group is correct.
+        partialFull_ = true;
+      }
+    }
   }
 
   if (isDistinct_) {
@@ -216,6 +440,138 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
+void HashAggregation::addSharedInput(const RowVectorPtr& input) {
+  const auto numShards = sharedAggregation_->numShards();
+  if (shardFunction_ == nullptr) {
+    shardFunction_ = std::make_unique<HashPartitionFunction>(
+        numShards, asRowType(input->type()), groupingKeyChannels_);
+  }
+  // A LazyVector can't be wrapped in a dictionary per shard before it is
+  // loaded.
+  loadColumns(input, *operatorCtx_->execCtx());
+  shardFunction_->partition(*input, rowShards_);
+
+  const auto numRows = input->size();
+  std::vector<vector_size_t> shardSizes(numShards, 0);
+  for (auto shard : rowShards_) {
+    ++shardSizes[shard];
+  }
+  std::vector<BufferPtr> shardIndices(numShards);
+  std::vector<vector_size_t*> rawShardIndices(numShards, nullptr);
+  for (auto shard = 0; shard < numShards; ++shard) {
+    if (shardSizes[shard] > 0 && shardSizes[shard] < numRows) {
+      shardIndices[shard] = allocateIndices(shardSizes[shard], pool());
+      rawShardIndices[shard] =
+          shardIndices[shard]->asMutable<vector_size_t>();
+    }
+  }
+  std::vector<vector_size_t> shardOffsets(numShards, 0);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    const auto shard = rowShards_[row];
+    if (rawShardIndices[shard] != nullptr) {
+      rawShardIndices[shard][shardOffsets[shard]++] = row;
+    }
+  }
+
+  // Starts with the own shard, so that drivers adding at the same time tend
+  // to be at different shards.
+  for (auto i = 0; i < numShards; ++i) {
+    const auto shard = (shard_ + i) % numShards;
+    if (shardSizes[shard] == 0) {
+      continue;
+    }
+    const auto shardInput = shardIndices[shard] == nullptr
+        ? input
+        : wrap(shardSizes[shard], shardIndices[shard], input);
+    sharedAggregation_->withShard(shard, [&](GroupingSet& groupingSet) {
+      groupingSet.addInput(shardInput, false);
+      if (groupingSet.allocatedBytes() > maxPartialAggregationMemoryUsage_) {
+        flushShard(groupingSet);
+      }
+    });
+  }
+  numInputRows_ += numRows;
+  numInputVectors_ += 1;
+}
+
+void HashAggregation::flushShard(GroupingSet& groupingSet) {
+  const auto batchSize = outputBatchRows(groupingSet.estimateRowSize());
+  RowContainerIterator iterator;
+  int64_t numFlushedRows = 0;
+  for (;;) {
+    auto output = std::static_pointer_cast<RowVector>(
+        BaseVector::create(outputType_, batchSize, pool()));
+    if (!groupingSet.getOutput(batchSize, iterator, output)) {
+      break;
+    }
+    numFlushedRows += output->size();
+    sharedOutputs_.push_back(std::move(output));
+  }
+  groupingSet.resetPartial();
+  auto lockedStats = stats_.wlock();
+  lockedStats->addRuntimeStat(
+      "flushRowCount", RuntimeCounter(numFlushedRows));
+  lockedStats->addRuntimeStat("flushTimes", RuntimeCounter(1));
+}
+
+void HashAggregation::noMoreInput() {
+  if (sharedAggregation_ != nullptr) {
+    Operator::noMoreInput();
+    // The drivers wait until no driver adds to their shards.
+    waitForPeers();
+    return;
+  }
+  groupingSet_->noMoreInput();
+  Operator::noMoreInput();
+  if (spillPartitions_ != nullptr &&
+      operatorCtx_->task()->numDrivers(operatorCtx_->driver()) == 1) {
+    // A single driver merges its partitions in getOutput().
+    spillPartitions_ = nullptr;
+  }
+  if (spillPartitions_ != nullptr) {
+    spillPartitions_->add(groupingSet_->takeSpillPartitions());
+    updateRuntimeStats();
+    // The drivers claim spilled partitions once all drivers have added theirs.
+    waitForPeers();
+  }
+}
+
+void HashAggregation::waitForPeers() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForPeers;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void HashAggregation::updateClusteredInput(const RowVector& input) {
+  if (isClusteredBatch(
+          input,
+          groupingKeyChannels_,
+          groupingSet_->hashLookup().newGroups.size())) {
+    if (!clusteredInput_ && ++numClusteredBatches_ >= kMinClusteredBatches) {
+      clusteredInput_ = true;
+      addRuntimeStat("clusteredInput", RuntimeCounter(1));
+    }
+    return;
+  }
+  numClusteredBatches_ = 0;
+  clusteredInput_ = false;
+}
+
 void HashAggregation::prepareOutput(vector_size_t size) {
   if (output_) {
     VectorPtr output = std::move(output_);
@@ -227,6 +583,29 @@ void HashAggregation::prepareOutput(vector_size_t size) {
   }
 }
 
+bool HashAggregation::abandonPartialAggregationEarly(int64_t numOutput) const {
+  if (!canAbandonPartialAggregation_ ||
+      numInputRows_ < abandonPartialAggregationMinRows_) {
+    return false;
+  }
+  return 100 * numOutput >= abandonPartialAggregationMinPct_ * numInputRows_;
+}
+
+RowVectorPtr HashAggregation::getAbandonedPartialOutput() {
+  if (!input_) {
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+  auto output = std::static_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, input_->size(), pool()));
+  groupingSet_->toIntermediate(input_, output);
+  numOutputRows_ += output->size();
+  input_ = nullptr;
+  return output;
+}
+
 void HashAggregation::resetPartialOutputIfNeed() {
   if (!partialFull_) {
     return;
@@ -244,10 +623,18 @@ void HashAggregation::resetPartialOutputIfNeed() {
   }
   groupingSet_->resetPartial();
   partialFull_ = false;
+  if (abandonPartialAggregation_ ||
+      abandonPartialAggregationEarly(numOutputRows_)) {
+    abandonPartialAggregation_ = false;
+    abandonedPartialAggregation_ = true;
+    addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+  }
   numOutputRows_ = 0;
   numInputRows_ = 0;
   numInputVectors_ = 0;
-  if (!finished_) {
+  // A flush after each batch of clustered input says nothing about the
+  // memory the aggregation needs.
+  if (!finished_ && !clusteredInput_) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
 }
@@ -282,12 +669,121 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
           maxPartialAggregationMemoryUsage_, RuntimeCounter::Unit::kBytes));
 }
 
+bool HashAggregation::startSplit(const std::string& splitKey) {
+  VELOX_CHECK(cachesSplitResults());
+  VELOX_CHECK(!isSplitPending());
+  auto key = fmt::format("{}:{}", splitResultCachePrefix_.value(), splitKey);
+  if (auto entry = FragmentResultCache::getInstance().find(key)) {
+    cachedSplitResult_ = std::move(entry);
+    nextCachedBatch_ = 0;
+    addRuntimeStat("fragmentResultCacheHits", RuntimeCounter(1));
+    return true;
+  }
+  addRuntimeStat("fragmentResultCacheMisses", RuntimeCounter(1));
+  // The output for the split can be told apart only if no groups of earlier
+  // splits remain. These are left by splits that are not cached.
+  if (groupingSet_->numRows() == 0 && !partialFull_ && input_ == nullptr) {
+    splitKey_ = std::move(key);
+    splitResult_ = std::make_shared<FragmentResultCache::Entry>();
+  }
+  return false;
+}
+
+void HashAggregation::finishSplit(bool cache) {
+  if (!splitKey_.has_value()) {
+    return;
+  }
+  if (!cache) {
+    splitKey_.reset();
+    splitResult_.reset();
+    return;
+  }
+  splitFinishing_ = true;
+  if (!abandonedPartialAggregation_) {
+    partialFull_ = true;
+  }
+}
+
+void HashAggregation::recordSplitOutput(const RowVectorPtr& output) {
+  if (splitResult_ == nullptr) {
+    return;
+  }
+  auto batch = FragmentResultCache::serialize(output, *pool());
+  splitResult_->bytes += batch->computeChainDataLength();
+  splitResult_->batches.push_back(std::move(batch));
+  if (splitResult_->bytes > FragmentResultCache::getInstance().capacity()) {
+    // Too large to cache. Stops recording.
+    splitResult_.reset();
+  }
+}
+
+RowVectorPtr HashAggregation::getCachedSplitOutput() {
+  if (nextCachedBatch_ == cachedSplitResult_->batches.size()) {
+    cachedSplitResult_ = nullptr;
+    return nullptr;
+  }
+  return FragmentResultCache::deserialize(
+      *cachedSplitResult_->batches[nextCachedBatch_++], outputType_, *pool());
+}
+
 RowVectorPtr HashAggregation::getOutput() {
+  if (cachedSplitResult_ != nullptr) {
+    if (auto output = getCachedSplitOutput()) {
+      return output;
+    }
+  }
+
+  auto output = getAggregationOutput();
+  if (!splitKey_.has_value()) {
+    return output;
+  }
+  if (output != nullptr) {
+    recordSplitOutput(output);
+  } else if (splitFinishing_ && !partialFull_ && input_ == nullptr) {
+    // All groups of the split have been produced.
+    if (splitResult_ != nullptr) {
+      FragmentResultCache::getInstance().insert(
+          splitKey_.value(), std::move(splitResult_));
+    }
+    splitKey_.reset();
+    splitResult_.reset();
+    splitFinishing_ = false;
+  }
+  return output;
+}
+
+RowVectorPtr HashAggregation::getAggregationOutput() {
   if (finished_) {
     input_ = nullptr;
     return nullptr;
   }
 
+  if (abandonedPartialAggregation_) {
+    return getAbandonedPartialOutput();
+  }
+
+  if (sharedAggregation_ != nullptr) {
+    if (!sharedOutputs_.empty()) {
+      auto output = std::move(sharedOutputs_.front());
+      sharedOutputs_.pop_front();
+      numOutputRows_ += output->size();
+      return output;
+    }
+    if (!noMoreInput_ || future_.valid()) {
+      return nullptr;
+    }
+    if (!peersFinished_) {
+      // No driver adds to 'groupingSet_' anymore.
+      peersFinished_ = true;
+      groupingSet_->noMoreInput();
+      updateRuntimeStats();
+    }
+  }
+
+  if (spillPartitions_ != nullptr && future_.valid()) {
+    return nullptr;
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -330,7 +826,9 @@ RowVectorPtr HashAggregation::getOutput() {
   // Reuse output vectors if possible.
   prepareOutput(batchSize);
 
-  bool hasData = groupingSet_->getOutput(batchSize, resultIterator_, output_);
+  const bool hasData = spillPartitions_ != nullptr
+      ? getOutputWithSpillPartitions(batchSize)
+      : groupingSet_->getOutput(batchSize, resultIterator_, output_);
   if (!hasData) {
     resultIterator_.reset();
     if (noMoreInput_) {
@@ -343,6 +841,26 @@ RowVectorPtr HashAggregation::getOutput() {
   return output_;
 }
 
+bool HashAggregation::getOutputWithSpillPartitions(int32_t batchSize) {
+  if (!mergingSpillPartitions_) {
+    if (groupingSet_->getOutput(batchSize, resultIterator_, output_)) {
+      return true;
+    }
+    mergingSpillPartitions_ = true;
+  }
+  for (;;) {
+    if (groupingSet_->getSpillPartitionOutput(batchSize, output_)) {
+      return true;
+    }
+    auto partition = spillPartitions_->next();
+    if (partition == nullptr) {
+      return false;
+    }
+    groupingSet_->startSpillPartitionMerge(std::move(partition));
+    addRuntimeStat("mergedSpillPartitions", RuntimeCounter(1));
+  }
+}
+
 bool HashAggregation::isFinished() {
   return finished_;
 }
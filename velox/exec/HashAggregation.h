@@ -15,8 +15,14 @@
  */
 #pragma once
 
+#include <deque>
+
+#include "velox/exec/FragmentResultCache.h"
 #include "velox/exec/GroupingSet.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/SharedPartialAggregation.h"
+#include "velox/exec/SpillPartitionQueue.h"
 
 namespace facebook::velox::exec {
 
@@ -32,26 +38,72 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_) && !splitFinishing_ &&
+        cachedSplitResult_ == nullptr && sharedOutputs_.empty();
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
   void close() override {
+    if (sharedAggregation_ != nullptr) {
+      sharedAggregation_->removeShard(shard_);
+    }
     Operator::close();
     groupingSet_.reset();
   }
 
+  bool canReclaim() const override;
+
+  uint64_t reclaimableBytes() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
+  /// Returns true if 'this' is a partial aggregation over a table scan, with
+  /// only filters and projections in between, whose results for single splits
+  /// are kept in the FragmentResultCache.
+  bool cachesSplitResults() const {
+    return splitResultCachePrefix_.has_value();
+  }
+
+  /// Called by the TableScan before it reads a split identified by
+  /// 'splitKey'. Returns true if the results for the split are cached. These
+  /// are then produced by the next calls to getOutput() and the scan skips
+  /// the split. Otherwise 'this' records its output for the split until
+  /// finishSplit().
+  bool startSplit(const std::string& splitKey);
+
+  /// Called by the TableScan after 'this' has received all input of the split
+  /// passed to startSplit(). Flushes the groups of 'this' and caches the
+  /// output if 'cache' is true.
+  void finishSplit(bool cache);
+
+  /// Returns true while the results for a split are being produced, from
+  /// the cache or by the flush after finishSplit(). The TableScan does not
+  /// start the next split in the meantime.
+  bool isSplitPending() const {
+    return splitFinishing_ || cachedSplitResult_ != nullptr;
+  }
+
  private:
+  // Produces the output of the aggregation. getOutput() adds the output for
+  // the cached splits.
+  RowVectorPtr getAggregationOutput();
+
+  // Returns the next batch of 'cachedSplitResult_', nullptr when there are no
+  // more.
+  RowVectorPtr getCachedSplitOutput();
+
+  // Adds 'output' to the results of the split being recorded.
+  void recordSplitOutput(const RowVectorPtr& output);
+
+  // Updates the spill and hash table stats of 'this' from 'groupingSet_'.
+  void updateRuntimeStats();
+
   void prepareOutput(vector_size_t size);
 
   // Invoked to reset partial aggregation state if it was full and has been
@@ -64,6 +116,40 @@ class HashAggregation : public Operator {
   // measure of the effectiveness of the partial aggregation.
   void maybeIncreasePartialAggregationMemoryUsage(double aggregationPct);
 
+  // Returns true if a partial aggregation that has seen 'numInputRows_' rows
+  // and produced 'numOutput' groups from them reduces its input too little to
+  // be worth hashing.
+  bool abandonPartialAggregationEarly(int64_t numOutput) const;
+
+  // Produces the intermediate results for 'input_' after the partial
+  // aggregation has been abandoned.
+  RowVectorPtr getAbandonedPartialOutput();
+
+  // Adds the rows of 'input' to the shards of 'sharedAggregation_' their
+  // grouping keys hash to.
+  void addSharedInput(const RowVectorPtr& input);
+
+  // Moves all groups of 'groupingSet', a shard of 'sharedAggregation_' locked
+  // by the caller, to 'sharedOutputs_' and resets it.
+  void flushShard(GroupingSet& groupingSet);
+
+  // Waits in isBlocked() until all drivers of the pipeline have called this.
+  // The last driver to call this wakes up the others.
+  void waitForPeers();
+
+  // Produces the groups of 'groupingSet_' that have not spilled and then the
+  // groups of the partitions claimed from 'spillPartitions_' into 'output_'.
+  // Returns false when there are no partitions left to claim.
+  bool getOutputWithSpillPartitions(int32_t batchSize);
+
+  // Checks whether the groups of 'input', which has just been added, recur
+  // from the previous batches and updates 'clusteredInput_'.
+  void updateClusteredInput(const RowVector& input);
+
+  // Number of consecutive batches without recurring groups after which the
+  // input is taken to be clustered on the grouping keys.
+  static constexpr int32_t kMinClusteredBatches = 3;
+
   const bool isPartialOutput_;
   const bool isIntermediate_;
   const bool isDistinct_;
@@ -71,17 +157,72 @@ class HashAggregation : public Operator {
   const std::shared_ptr<memory::MemoryUsageTracker> memoryTracker_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
   const std::optional<Spiller::Config> spillConfig_;
+  // True if this is a partial aggregation that shares its hash table with the
+  // other drivers, see QueryConfig::kSharedPartialAggregationEnabled.
+  const bool sharePartialAggregation_;
+  // True if this is a partial aggregation that may switch to converting each
+  // input row into intermediate results once it sees that hashing does not
+  // reduce the input enough.
+  const bool canAbandonPartialAggregation_;
+  // True if this is a partial aggregation that flushes its groups after
+  // each batch while it sees that the input is clustered on the grouping
+  // keys, e.g. read from files sorted on them. The groups of clustered input
+  // do not recur, so the hash table stays small and the output streams.
+  const bool detectClusteredInput_;
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+
+  // Channels of the grouping keys in the input.
+  std::vector<column_index_t> groupingKeyChannels_;
+  // Number of consecutive batches that had no recurring groups.
+  int32_t numClusteredBatches_ = 0;
+  // True while the last kMinClusteredBatches batches had no recurring groups.
+  bool clusteredInput_ = false;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
   bool partialFull_ = false;
+  // Set when the partial aggregation is flushed for being ineffective. The
+  // flush is followed by setting 'abandonedPartialAggregation_'.
+  bool abandonPartialAggregation_ = false;
+  // True if the partial aggregation has been abandoned and the input is
+  // converted into intermediate results row by row.
+  bool abandonedPartialAggregation_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
   RowContainerIterator resultIterator_;
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
 
+  // The hash tables shared with the other drivers if
+  // 'sharePartialAggregation_' is set. 'groupingSet_' is the shard at index
+  // 'shard_'.
+  std::shared_ptr<SharedPartialAggregation> sharedAggregation_;
+  int32_t shard_{0};
+  // Assigns the input rows to shards by the hash of their grouping keys.
+  std::unique_ptr<HashPartitionFunction> shardFunction_;
+  // The shard of each input row.
+  std::vector<uint32_t> rowShards_;
+  // Groups of the shards this driver has flushed for being full. Produced
+  // before any other output.
+  std::deque<RowVectorPtr> sharedOutputs_;
+  // Valid while waiting for the other drivers to finish their input. The
+  // groups of a shard can be produced only once no driver adds to it and a
+  // claimed spill partition only once all drivers have added theirs.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+  // True after all drivers have finished their input.
+  bool peersFinished_ = false;
+
+  // The spilled partitions of all drivers if this is a final aggregation
+  // that merges them in parallel, see
+  // QueryConfig::kAggregationSpillParallelMergeEnabled. Claimed once all
+  // drivers have added theirs.
+  std::shared_ptr<SpillPartitionQueue> spillPartitions_;
+  // True after the groups of 'groupingSet_' that have not spilled have been
+  // produced and the output comes from the claimed partitions.
+  bool mergingSpillPartitions_ = false;
+
   /// Count the number of input rows. It is reset on partial aggregation output
   /// flush.
   int64_t numInputRows_ = 0;
@@ -94,6 +235,24 @@ class HashAggregation : public Operator {
 
   /// Possibly reusable output vector.
   RowVectorPtr output_;
+
+  // The part of the FragmentResultCache keys that identifies the plan fragment
+  // of 'this'. Not set if the results of 'this' are not cached.
+  std::optional<std::string> splitResultCachePrefix_;
+
+  // The key of the split whose output is being recorded, not set if none.
+  std::optional<std::string> splitKey_;
+
+  // The output recorded for 'splitKey_' so far.
+  std::shared_ptr<FragmentResultCache::Entry> splitResult_;
+
+  // True after finishSplit() until the groups of the split have been flushed.
+  bool splitFinishing_ = false;
+
+  // Cached results of a split that remain to be produced and the index of the
+  // next batch to produce.
+  std::shared_ptr<const FragmentResultCache::Entry> cachedSplitResult_;
+  size_t nextCachedBatch_ = 0;
 };
 
 } // namespace facebook::velox::exec
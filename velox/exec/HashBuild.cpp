@@ -41,6 +41,54 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+// Adds the hashes of the non-null values in the first 'size' rows of the flat
+// 'values' to 'bloomFilter'.
+template <typename T>
+void addToBloomFilter(
+    const VectorPtr& values,
+    vector_size_t size,
+    BloomFilter<>& bloomFilter) {
+  const auto* flatValues = values->asFlatVector<T>();
+  for (auto i = 0; i < size; ++i) {
+    if (flatValues->isNullAt(i)) {
+      continue;
+    }
+    if constexpr (std::is_same_v<T, StringView>) {
+      const auto value = flatValues->valueAt(i);
+      bloomFilter.insert(
+          common::BloomFilterValues::hashBytes(value.data(), value.size()));
+    } else {
+      bloomFilter.insert(
+          common::BloomFilterValues::hashInt64(flatValues->valueAt(i)));
+    }
+  }
+}
+
+// Returns true if the probe side of 'joinNode' only needs to know whether a
+// row has a match. This is the case of (left) semi and anti joins with no
+// extra filter, whose build side is then a set of distinct keys: rows with
+// duplicate keys and the non-key columns are not stored.
+bool isMembershipOnly(const core::HashJoinNode& joinNode) {
+  return !joinNode.filter() &&
+      (joinNode.isLeftSemiFilterJoin() || joinNode.isLeftSemiProjectJoin() ||
+       isAntiJoin(joinNode.joinType()));
+}
+
+// Returns true if a Bloom filter can be built over join keys of 'kind'.
+bool supportsBloomFilter(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -70,6 +118,21 @@ HashBuild::HashBuild(
                          : nullptr) {
   VELOX_CHECK_NOT_NULL(joinBridge_);
   joinBridge_->addBuilder();
+  keySketch_.setCapacity(kSkewSketchCapacity);
+  if (canSwapJoinSides(*joinNode_, driverCtx->queryConfig())) {
+    joinSwapMinBuildRows_ = driverCtx->queryConfig().joinSwapMinBuildRows();
+  }
+
+  // NOTE: with grouped execution, each split group builds its own table.
+  if (joinNode_->useHashTableCache() &&
+      driverCtx->splitGroupId == kUngroupedGroupId) {
+    hashTableCacheEntry_ = HashTableCache::instance()->get(
+        operatorCtx_->task()->queryCtx(),
+        planNodeId(),
+        operatorCtx_->taskId());
+    useCachedHashTable_ =
+        !hashTableCacheEntry_->isBuilder(operatorCtx_->taskId());
+  }
 
   auto outputType = joinNode_->sources()[1]->outputType();
 
@@ -90,9 +153,11 @@ HashBuild::HashBuild(
     types.emplace_back(outputType->childAt(channel));
   }
 
-  // Identify the non-key build side columns and make a decoder for each.
+  // Identify the non-key build side columns and make a decoder for each. A
+  // membership only join does not read them.
+  const bool membershipOnly = isMembershipOnly(*joinNode_);
   for (auto i = 0; i < outputType->size(); ++i) {
-    if (keyChannelMap.find(i) == keyChannelMap.end()) {
+    if (!membershipOnly && keyChannelMap.find(i) == keyChannelMap.end()) {
       dependentChannels_.emplace_back(i);
       decoders_.emplace_back(std::make_unique<DecodedVector>());
       names.emplace_back(outputType->nameOf(i));
@@ -134,13 +199,11 @@ void HashBuild::setupTable() {
         dependentTypes,
         true, // allowDuplicates
         true, // hasProbedFlag
-        pool());
+        tablePool());
   } else {
     // (Left) semi and anti join with no extra filter only needs to know whether
     // there is a match. Hence, no need to store entries with duplicate keys.
-    const bool dropDuplicates = !joinNode_->filter() &&
-        (joinNode_->isLeftSemiFilterJoin() ||
-         joinNode_->isLeftSemiProjectJoin() || isAntiJoin(joinType_));
+    const bool dropDuplicates = isMembershipOnly(*joinNode_);
     // Right semi join needs to tag build rows that were probed.
     const bool needProbedFlag = joinNode_->isRightSemiFilterJoin();
     if (isLeftNullAwareJoinWithFilter(joinNode_)) {
@@ -151,7 +214,7 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          tablePool());
     } else {
       // Ignore null keys
       table_ = HashTable<true>::createForJoin(
@@ -159,12 +222,37 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          tablePool());
     }
   }
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
 }
 
+memory::MemoryPool* HashBuild::tablePool() {
+  return hashTableCacheEntry_ != nullptr && !useCachedHashTable_
+      ? hashTableCacheEntry_->pool()
+      : pool();
+}
+
+void HashBuild::useCachedHashTable() {
+  VELOX_CHECK(useCachedHashTable_);
+  if (operatorCtx_->driverCtx()->driverId == 0) {
+    hashTableCacheEntry_->attach(joinBridge_);
+    stats_.wlock()->addRuntimeStat("cachedHashTable", RuntimeCounter(1));
+  }
+  table_.reset();
+  setState(State::kFinish);
+}
+
+void HashBuild::setAntiJoinHasNullKeys() {
+  if (hashTableCacheEntry_ == nullptr) {
+    joinBridge_->setAntiJoinHasNullKeys();
+    return;
+  }
+  hashTableCacheEntry_->setAntiJoinHasNullKeys();
+  hashTableCacheEntry_->attach(joinBridge_);
+}
+
 void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   VELOX_CHECK_NULL(spiller_);
   VELOX_CHECK_NULL(spillInputReader_);
@@ -205,7 +293,8 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.fileOptions);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -355,6 +444,8 @@ void HashBuild::addInput(RowVectorPtr input) {
       analyzeKeys_ = hasher->mayUseValueIds();
     }
   }
+  sampleKeys();
+
   auto rows = table_->rows();
   auto nextOffset = rows->nextOffset();
   activeRows_.applyToSelected([&](auto rowIndex) {
@@ -381,6 +472,13 @@ bool HashBuild::ensureInputFits(RowVectorPtr& input) {
     return true;
   }
 
+  // NOTE: a restored spill partition dominated by a single key is not spilled
+  // any further as all its rows with this key would go to the same partition
+  // at the next spill level, until exceeding the max spill level.
+  if (isInputFromSpill() && isSkewedSpillInput()) {
+    return true;
+  }
+
   // NOTE: we simply reserve memory all inputs even though some of them are
   // spilling directly. It is okay as we will accumulate the extra reservation
   // in the operator's memory pool, and won't make any new reservation if there
@@ -546,19 +644,72 @@ void HashBuild::prepareInputIndicesBuffers(
   std::fill(numSpillInputs_.begin(), numSpillInputs_.end(), 0);
 }
 
-void HashBuild::computeSpillPartitions(const RowVectorPtr& input) {
-  if (hashes_.size() < activeRows_.end()) {
-    hashes_.resize(activeRows_.end());
+void HashBuild::computeHashes(const SelectivityVector& rows) {
+  if (hashes_.size() < rows.end()) {
+    hashes_.resize(rows.end());
   }
-  const auto& hashers = table_->hashers();
-  for (auto i = 0; i < hashers.size(); ++i) {
-    auto& hasher = hashers[i];
-    if (hasher->channel() != kConstantChannel) {
-      hashers[i]->hash(activeRows_, i > 0, hashes_);
-    } else {
-      hashers[i]->hashPrecomputed(activeRows_, i > 0, hashes_);
+  VectorHasher::hash(table_->hashers(), rows, hashes_);
+}
+
+void HashBuild::sampleKeys() {
+  const auto numRows = activeRows_.end();
+  sampleRows_.resize(numRows);
+  sampleRows_.clearAll();
+  auto index = nextSampleRow_;
+  for (; index < numRows; index += kSkewSampleStride) {
+    if (activeRows_.isValid(index)) {
+      sampleRows_.setValid(index, true);
     }
   }
+  nextSampleRow_ = index - numRows;
+  sampleRows_.updateBounds();
+  if (!sampleRows_.hasSelections()) {
+    return;
+  }
+
+  computeHashes(sampleRows_);
+  sampleRows_.applyToSelected([&](auto row) {
+    keySketch_.insert(hashes_[row]);
+    ++numSampledRows_;
+  });
+}
+
+bool HashBuild::isSkewedSpillInput() {
+  if (!skewedSpillInput_ && numSampledRows_ >= kMinSkewSampleRows) {
+    const auto topKeys = keySketch_.topK(1);
+    skewedSpillInput_ = !topKeys.empty() &&
+        topKeys[0].second * 100 >= numSampledRows_ * kSkewedSpillInputPct;
+  }
+  return skewedSpillInput_;
+}
+
+void HashBuild::addSkewStats() {
+  if (numSampledRows_ < kMinSkewSampleRows) {
+    return;
+  }
+  int64_t numSkewedKeys = 0;
+  int64_t maxCount = 0;
+  for (const auto& key : keySketch_.topK(kSkewSketchCapacity)) {
+    maxCount = std::max(maxCount, key.second);
+    if (key.second * 100 >= numSampledRows_ * kSkewedKeyPct) {
+      ++numSkewedKeys;
+    }
+  }
+  if (numSkewedKeys == 0 && !skewedSpillInput_) {
+    return;
+  }
+  auto lockedStats = stats_.wlock();
+  lockedStats->addRuntimeStat("skewedKeys", RuntimeCounter(numSkewedKeys));
+  lockedStats->addRuntimeStat(
+      "maxKeySampledRowsPct",
+      RuntimeCounter(maxCount * 100 / numSampledRows_));
+  if (skewedSpillInput_) {
+    lockedStats->addRuntimeStat("skewedSpillPartitions", RuntimeCounter(1));
+  }
+}
+
+void HashBuild::computeSpillPartitions(const RowVectorPtr& input) {
+  computeHashes(activeRows_);
 
   spillPartitions_.resize(input->size());
   for (auto i = 0; i < spillPartitions_.size(); ++i) {
@@ -665,6 +816,44 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
   }
 }
 
+bool HashBuild::canSpillForReclaim() const {
+  return spillEnabled() && spiller_ != nullptr && isRunning() &&
+      !noMoreInput_ && !operatorCtx_->driver()->isOnThread() &&
+      !spiller_->state().isAllPartitionSpilled();
+}
+
+bool HashBuild::canReclaim() const {
+  return canSpillForReclaim() && table_ != nullptr &&
+      table_->rows()->numRows() > 0 &&
+      spillGroup_->state() == SpillOperatorGroup::State::kRunning &&
+      !spillGroup_->needSpill();
+}
+
+uint64_t HashBuild::reclaimableBytes() const {
+  return canReclaim() ? operatorCtx_->pool()->getCurrentBytes() : 0;
+}
+
+void HashBuild::reclaim(uint64_t targetBytes) {
+  if (!canReclaim()) {
+    return;
+  }
+  // The build operators spill the same partitions, so the spill runs on all of
+  // them. It can only run if none of them is on thread, e.g. in the allocation
+  // which triggered the memory arbitration.
+  constexpr uint64_t kSpillAll = std::numeric_limits<int64_t>::max();
+  numSpillRows_ = targetBytes == 0 ? kSpillAll : 1;
+  numSpillBytes_ = targetBytes == 0 ? kSpillAll : targetBytes;
+  const bool spilled = spillGroup_->runSpillForReclaim([](const Operator& op) {
+    const auto* build = dynamic_cast<const HashBuild*>(&op);
+    VELOX_CHECK_NOT_NULL(build);
+    return !build->operatorCtx_->driver()->isOnThread();
+  });
+  if (!spilled) {
+    numSpillRows_ = 0;
+    numSpillBytes_ = 0;
+  }
+}
+
 void HashBuild::addAndClearSpillTarget(uint64_t& numRows, uint64_t& numBytes) {
   numRows += numSpillRows_;
   numSpillRows_ = 0;
@@ -684,6 +873,8 @@ void HashBuild::noMoreInput() {
 }
 
 void HashBuild::noMoreInputInternal() {
+  addSkewStats();
+
   if (spillEnabled()) {
     spillGroup_->operatorStopped(*this);
   }
@@ -717,7 +908,7 @@ bool HashBuild::finishHashBuild() {
   Spiller::Stats spillStats;
   if (joinHasNullKeys_ && isAntiJoin(joinType_) && nullAware_ &&
       !joinNode_->filter()) {
-    joinBridge_->setAntiJoinHasNullKeys();
+    setAntiJoinHasNullKeys();
   } else {
     for (auto& peer : peers) {
       auto op = peer->findOperator(planNodeId());
@@ -738,8 +929,8 @@ bool HashBuild::finishHashBuild() {
 
     if (joinHasNullKeys_ && isAntiJoin(joinType_) && nullAware_ &&
         !joinNode_->filter()) {
-      joinBridge_->setAntiJoinHasNullKeys();
-    } else {
+      setAntiJoinHasNullKeys();
+    } else if (!maybeSetUnpreparedTables(otherTables)) {
       if (spiller_ != nullptr) {
         spillStats += spiller_->stats();
 
@@ -770,10 +961,21 @@ bool HashBuild::finishHashBuild() {
                                 : nullptr);
 
       addRuntimeStats();
-      if (joinBridge_->setHashTable(
+      // The probe side does not push down filters if there is spilled data
+      // to restore.
+      auto dynamicFilters = spillPartitions.empty()
+          ? makeDynamicFilters()
+          : std::vector<std::shared_ptr<common::Filter>>{};
+      if (hashTableCacheEntry_ != nullptr) {
+        VELOX_CHECK(spillPartitions.empty());
+        hashTableCacheEntry_->setHashTable(
+            std::move(table_), joinHasNullKeys_, std::move(dynamicFilters));
+        hashTableCacheEntry_->attach(joinBridge_);
+      } else if (joinBridge_->setHashTable(
               std::move(table_),
               std::move(spillPartitions),
-              joinHasNullKeys_)) {
+              joinHasNullKeys_,
+              std::move(dynamicFilters))) {
         spillGroup_->restart();
       }
     }
@@ -788,6 +990,28 @@ bool HashBuild::finishHashBuild() {
   return true;
 }
 
+bool HashBuild::maybeSetUnpreparedTables(
+    std::vector<std::unique_ptr<BaseHashTable>>& otherTables) {
+  if (joinSwapMinBuildRows_ == 0 || hashTableCacheEntry_ != nullptr) {
+    return false;
+  }
+  VELOX_CHECK_NULL(spiller_);
+  uint64_t numRows = table_->rows()->numRows();
+  for (const auto& table : otherTables) {
+    numRows += table->rows()->numRows();
+  }
+  if (numRows < joinSwapMinBuildRows_) {
+    return false;
+  }
+  // The probe side may turn out to be the smaller one to build the table
+  // over. No dynamic filters are made since the build side is not known to
+  // be the table side.
+  otherTables.insert(otherTables.begin(), std::move(table_));
+  joinBridge_->setUnpreparedBuildTables(
+      std::move(otherTables), operatorCtx_->task()->queryCtx()->executor());
+  return true;
+}
+
 void HashBuild::postHashBuildProcess() {
   checkRunning();
 
@@ -829,6 +1053,12 @@ void HashBuild::setupSpillInput(HashJoinBridge::SpillInput spillInput) {
       dependentChannels_.end(),
       keyChannels_.size());
 
+  keySketch_ = functions::ApproxMostFrequentStreamSummary<uint64_t>();
+  keySketch_.setCapacity(kSkewSketchCapacity);
+  numSampledRows_ = 0;
+  nextSampleRow_ = 0;
+  skewedSpillInput_ = false;
+
   setupTable();
   setupSpiller(spillInput.spillPartition.get());
 
@@ -848,6 +1078,111 @@ void HashBuild::processSpillInput() {
   noMoreInputInternal();
 }
 
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeDynamicFilters() {
+  if (!isInnerJoin(joinType_) && !isLeftSemiFilterJoin(joinType_) &&
+      !isRightSemiFilterJoin(joinType_) && !isRightSemiProjectJoin(joinType_)) {
+    return {};
+  }
+  const auto& hashers = table_->hashers();
+  std::vector<std::shared_ptr<common::Filter>> filters(hashers.size());
+  if (table_->numDistinct() == 0) {
+    // An empty build side matches no probe rows.
+    for (auto& filter : filters) {
+      filter = std::make_shared<common::AlwaysFalse>();
+    }
+    return filters;
+  }
+
+  // The hashers do not track the key values in kHash mode.
+  if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    for (auto i = 0; i < hashers.size(); ++i) {
+      filters[i] = hashers[i]->getFilter(false);
+    }
+  }
+  addBloomFilters(filters);
+
+  for (const auto& filter : filters) {
+    if (filter != nullptr) {
+      return filters;
+    }
+  }
+  return {};
+}
+
+void HashBuild::addBloomFilters(
+    std::vector<std::shared_ptr<common::Filter>>& filters) {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  if (!queryConfig.joinBloomFilterEnabled()) {
+    return;
+  }
+  const int64_t numDistinct = table_->numDistinct();
+  if (numDistinct > queryConfig.joinBloomFilterMaxRows()) {
+    return;
+  }
+
+  // Only the keys without an exact filter get a Bloom filter.
+  const auto& hashers = table_->hashers();
+  std::vector<column_index_t> keys;
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (filters[i] == nullptr &&
+        supportsBloomFilter(hashers[i]->typeKind())) {
+      keys.push_back(i);
+    }
+  }
+  if (keys.empty()) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<BloomFilter<>>> keyBloomFilters(keys.size());
+  std::vector<VectorPtr> keyValues(keys.size());
+  for (auto i = 0; i < keys.size(); ++i) {
+    keyBloomFilters[i] = std::make_shared<BloomFilter<>>();
+    keyBloomFilters[i]->reset(numDistinct);
+  }
+
+  constexpr int32_t kBatchSize = 1'000;
+  std::vector<char*> rows(kBatchSize);
+  BaseHashTable::RowsIterator iter;
+  while (auto numListed = table_->listAllRows(
+             &iter, kBatchSize, RowContainer::kUnlimited, rows.data())) {
+    for (auto i = 0; i < keys.size(); ++i) {
+      const auto& type = hashers[keys[i]]->type();
+      BaseVector::prepareForReuse(keyValues[i], numListed);
+      if (keyValues[i] == nullptr) {
+        keyValues[i] = BaseVector::create(type, numListed, pool());
+      }
+      RowContainer::extractColumn(
+          rows.data(),
+          numListed,
+          table_->rows()->columnAt(keys[i]),
+          keyValues[i]);
+      auto& bloomFilter = *keyBloomFilters[i];
+      switch (type->kind()) {
+        case TypeKind::TINYINT:
+          addToBloomFilter<int8_t>(keyValues[i], numListed, bloomFilter);
+          break;
+        case TypeKind::SMALLINT:
+          addToBloomFilter<int16_t>(keyValues[i], numListed, bloomFilter);
+          break;
+        case TypeKind::INTEGER:
+          addToBloomFilter<int32_t>(keyValues[i], numListed, bloomFilter);
+          break;
+        case TypeKind::BIGINT:
+          addToBloomFilter<int64_t>(keyValues[i], numListed, bloomFilter);
+          break;
+        default:
+          addToBloomFilter<StringView>(keyValues[i], numListed, bloomFilter);
+          break;
+      }
+    }
+  }
+
+  for (auto i = 0; i < keys.size(); ++i) {
+    filters[keys[i]] = std::make_shared<common::BloomFilterValues>(
+        std::move(keyBloomFilters[i]), false);
+  }
+}
+
 void HashBuild::addRuntimeStats() {
   // Report range sizes and number of distinct values for the join keys.
   const auto& hashers = table_->hashers();
@@ -878,6 +1213,10 @@ void HashBuild::addRuntimeStats() {
     lockedStats->runtimeStats["hashtable.numTombstones"] =
         RuntimeMetric(hashTableStats.numTombstones);
   }
+  lockedStats->runtimeStats["hashtable.hashMode"] =
+      RuntimeMetric(hashTableStats.hashMode);
+  lockedStats->runtimeStats["hashtable.numHashModeChanges"] =
+      RuntimeMetric(hashTableStats.numHashModeChanges);
 
   // Add max spilling level stats if spilling has been triggered.
   if (spiller_ != nullptr && spiller_->isAnySpilled()) {
@@ -893,6 +1232,8 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
     case State::kRunning:
       if (isInputFromSpill()) {
         processSpillInput();
+      } else if (useCachedHashTable_) {
+        useCachedHashTable();
       }
       break;
     case State::kFinish:
@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/exec/HashTable.h"
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/SpillOperatorGroup.h"
@@ -24,6 +25,7 @@
 #include "velox/exec/UnorderedStreamReader.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/Expr.h"
+#include "velox/functions/lib/ApproxMostFrequentStreamSummary.h"
 
 namespace facebook::velox::exec {
 
@@ -68,7 +70,7 @@ class HashBuild final : public Operator {
   }
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    return !noMoreInput_ && !useCachedHashTable_;
   }
 
   void noMoreInput() override;
@@ -77,6 +79,12 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
+  bool canReclaim() const override;
+
+  uint64_t reclaimableBytes() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   void setState(State state);
   void checkStateTransition(State state);
@@ -88,6 +96,20 @@ class HashBuild final : public Operator {
   // Invoked to set up hash table to build.
   void setupTable();
 
+  // Returns the memory pool for the hash table. This is the pool of
+  // 'hashTableCacheEntry_' if this task builds the table for the other tasks of
+  // the query.
+  memory::MemoryPool* tablePool();
+
+  // Invoked instead of processing any input if this task uses the hash table
+  // built by another task of the query. The first driver attaches
+  // 'joinBridge_' to 'hashTableCacheEntry_'. All the drivers then finish.
+  void useCachedHashTable();
+
+  // Hands the null key result of a null-aware anti join to the probe side,
+  // and to the other tasks of the query if the table is shared.
+  void setAntiJoinHasNullKeys();
+
   // Invoked when operator has finished processing the build input and wait for
   // all the other drivers to finish the processing. The last driver that
   // reaches to the hash build barrier, is responsible to build the hash table
@@ -96,6 +118,13 @@ class HashBuild final : public Operator {
   // barrier for the next round of hash table build operation if it needs.
   bool finishHashBuild();
 
+  // Invoked by the last build driver to hand over 'table_' and 'otherTables'
+  // unprepared to 'joinBridge_' if the join sides may be swapped and the build
+  // side has at least QueryConfig::joinSwapMinBuildRows() rows. Returns false
+  // if the join table is to be prepared as usual.
+  bool maybeSetUnpreparedTables(
+      std::vector<std::unique_ptr<BaseHashTable>>& otherTables);
+
   // Invoked after the hash table has been built. It waits for any spill data to
   // process after the probe side has finished processing the previously built
   // hash table. If disk spilling is not enabled or there is no more spill data,
@@ -167,6 +196,24 @@ class HashBuild final : public Operator {
   // enabled. The computed partition numbers are stored in 'spillPartitions_'.
   void computeSpillPartitions(const RowVectorPtr& input);
 
+  // Computes the hashes of the decoded join keys for 'rows' into 'hashes_'.
+  void computeHashes(const SelectivityVector& rows);
+
+  // Adds the key hashes of every 'kSkewSampleStride'th row in 'activeRows_' to
+  // 'keySketch_'.
+  void sampleKeys();
+
+  // Returns true if the most frequent key accounts for at least
+  // 'kSkewedSpillInputPct' percent of the sampled rows restored from a spill
+  // partition. Re-partitioning on more hash bits can't split the rows of a
+  // single key, so spilling such a partition again only moves this key one
+  // spill level down.
+  bool isSkewedSpillInput();
+
+  // Reports the keys with at least 'kSkewedKeyPct' percent of the sampled
+  // build rows in the operator stats.
+  void addSkewStats();
+
   // Invoked to set up 'spillChildVectors_' for spill if 'input' is from build
   // source.
   void maybeSetupSpillChildVectors(const RowVectorPtr& input);
@@ -194,6 +241,11 @@ class HashBuild final : public Operator {
   // 'spillOperators'.
   void runSpill(const std::vector<Operator*>& spillOperators);
 
+  // Returns true if the table of this operator can be spilled together with
+  // its peers on request of the memory arbitrator. Returns false if the Driver
+  // of this operator is on thread.
+  bool canSpillForReclaim() const;
+
   // Invoked by 'runSpill' to sum up the spill targets from all the operators in
   // 'numRows' and 'numBytes'.
   void addAndClearSpillTarget(uint64_t& numRows, uint64_t& numBytes);
@@ -222,6 +274,16 @@ class HashBuild final : public Operator {
 
   void addRuntimeStats();
 
+  // Invoked by the last build driver after the join table is prepared to make
+  // the filters on the join keys that the probe side pushes down and that
+  // other tasks may import. Returns a filter per join key, null for keys
+  // without one, or an empty vector if there are no filters.
+  std::vector<std::shared_ptr<common::Filter>> makeDynamicFilters();
+
+  // Sets Bloom filters in 'filters' for the keys that have too many distinct
+  // values for an exact filter if join Bloom filters are enabled.
+  void addBloomFilters(std::vector<std::shared_ptr<common::Filter>>& filters);
+
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
 
@@ -298,6 +360,50 @@ class HashBuild final : public Operator {
   std::vector<vector_size_t*> rawSpillInputIndicesBuffers_;
   std::vector<VectorPtr> spillChildVectors_;
 
+  // Number of rows between two rows sampled for skew detection.
+  static constexpr vector_size_t kSkewSampleStride = 16;
+
+  // Number of distinct key hashes tracked in 'keySketch_'.
+  static constexpr int32_t kSkewSketchCapacity = 64;
+
+  // Minimum number of sampled rows before the build input is considered for
+  // skew.
+  static constexpr int64_t kMinSkewSampleRows = 128;
+
+  // Percentage of the sampled rows above which a key is reported as skewed.
+  static constexpr int64_t kSkewedKeyPct = 10;
+
+  // Percentage of the sampled rows above which a single key stops recursive
+  // spilling of a restored spill partition.
+  static constexpr int64_t kSkewedSpillInputPct = 50;
+
+  // Approximate most frequent join key hashes of the sampled rows of the
+  // current build input. Reset on each restored spill partition.
+  functions::ApproxMostFrequentStreamSummary<uint64_t> keySketch_;
+
+  // Number of rows added to 'keySketch_'.
+  int64_t numSampledRows_{0};
+
+  // Offset of the next row to sample in the next input batch.
+  vector_size_t nextSampleRow_{0};
+
+  // Reusable memory for sampling rows.
+  SelectivityVector sampleRows_;
+
+  // True if the current restored spill partition is dominated by a single
+  // key and is not spilled any further.
+  bool skewedSpillInput_{false};
+
+  // Set if the hash table is shared among the tasks of the query.
+  std::shared_ptr<HashTableCache::Entry> hashTableCacheEntry_;
+
+  // True if this task uses the hash table built by another task of the query.
+  bool useCachedHashTable_{false};
+
+  // Minimum number of build side rows for swapping the join sides or 0 if the
+  // sides are not swapped. See canSwapJoinSides().
+  uint64_t joinSwapMinBuildRows_{0};
+
   // Indicates whether the filter is null-propagating.
   bool filterPropagatesNulls_{false};
 
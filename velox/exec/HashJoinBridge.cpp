@@ -18,6 +18,16 @@
 
 namespace facebook::velox::exec {
 
+namespace {
+uint64_t numRows(const std::vector<std::unique_ptr<BaseHashTable>>& tables) {
+  uint64_t numRows = 0;
+  for (const auto& table : tables) {
+    numRows += table->rows()->numRows();
+  }
+  return numRows;
+}
+} // namespace
+
 void HashJoinBridge::start() {
   std::lock_guard<std::mutex> l(mutex_);
   started_ = true;
@@ -31,9 +41,10 @@ void HashJoinBridge::addBuilder() {
 }
 
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
-    bool hasNullKeys) {
+    bool hasNullKeys,
+    std::vector<std::shared_ptr<common::Filter>> dynamicFilters) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
 
   auto spillPartitionIdSet = toSpillPartitionIdSet(spillPartitionSet);
@@ -59,20 +70,160 @@ bool HashJoinBridge::setHashTable(
       VELOX_CHECK_EQ(spillPartitionSets_.count(id), 0);
       spillPartitionSets_.emplace(id, std::move(partitionEntry.second));
     }
+    if (!exportedFilters_.has_value()) {
+      // A table restored from spill or a table with spilled partitions only
+      // has part of the build side keys.
+      exportedFilters_ = spillPartitionIdSet.empty() &&
+              !restoringSpillPartitionId_.has_value()
+          ? dynamicFilters
+          : std::vector<std::shared_ptr<common::Filter>>{};
+    }
     buildResult_ = HashBuildResult(
         std::move(table),
         std::move(restoringSpillPartitionId_),
         std::move(spillPartitionIdSet),
-        hasNullKeys);
+        hasNullKeys,
+        std::move(dynamicFilters));
     restoringSpillPartitionId_.reset();
 
     hasSpillData = !spillPartitionSets_.empty();
+    // The probe input buffered in case of swapping the sides is not needed.
+    bufferedProbeTables_.clear();
     promises = std::move(promises_);
   }
   notify(std::move(promises));
   return hasSpillData;
 }
 
+void HashJoinBridge::addProber() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!started_);
+  ++numProbers_;
+}
+
+void HashJoinBridge::setUnpreparedBuildTables(
+    std::vector<std::unique_ptr<BaseHashTable>> tables,
+    folly::Executor* executor) {
+  VELOX_CHECK(!tables.empty());
+  std::vector<std::unique_ptr<BaseHashTable>> tablesToPrepare;
+  bool swapped;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(started_);
+    VELOX_CHECK(!buildResult_.has_value());
+    VELOX_CHECK(!sidesDecided_);
+    VELOX_CHECK_GT(numProbers_, 0);
+    unpreparedBuildTables_ = std::move(tables);
+    buildExecutor_ = executor;
+    if (!takeTablesToPrepareLocked(tablesToPrepare, swapped)) {
+      return;
+    }
+  }
+  prepareTable(std::move(tablesToPrepare), swapped);
+}
+
+void HashJoinBridge::probeInputNotBuffered() {
+  std::vector<std::unique_ptr<BaseHashTable>> tablesToPrepare;
+  bool swapped;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(started_);
+    probeNotBuffered_ = true;
+    bufferedProbeTables_.clear();
+    if (!takeTablesToPrepareLocked(tablesToPrepare, swapped)) {
+      return;
+    }
+  }
+  prepareTable(std::move(tablesToPrepare), swapped);
+}
+
+void HashJoinBridge::probeInputBuffered(std::unique_ptr<BaseHashTable> table) {
+  VELOX_CHECK_NOT_NULL(table);
+  std::vector<std::unique_ptr<BaseHashTable>> tablesToPrepare;
+  bool swapped;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(started_);
+    VELOX_CHECK_LT(numBufferedProbers_, numProbers_);
+    ++numBufferedProbers_;
+    // The buffered input is only needed if the sides can still be swapped.
+    if (sidesDecided_ || probeNotBuffered_ || buildResult_.has_value()) {
+      return;
+    }
+    bufferedProbeTables_.push_back(std::move(table));
+    if (!takeTablesToPrepareLocked(tablesToPrepare, swapped)) {
+      return;
+    }
+  }
+  prepareTable(std::move(tablesToPrepare), swapped);
+}
+
+bool HashJoinBridge::takeTablesToPrepareLocked(
+    std::vector<std::unique_ptr<BaseHashTable>>& tables,
+    bool& swapped) {
+  if (sidesDecided_ || unpreparedBuildTables_.empty()) {
+    return false;
+  }
+  if (!probeNotBuffered_ && numBufferedProbers_ < numProbers_) {
+    return false;
+  }
+  sidesDecided_ = true;
+  swapped = !probeNotBuffered_ &&
+      numRows(bufferedProbeTables_) < numRows(unpreparedBuildTables_);
+  if (swapped) {
+    tables = std::move(bufferedProbeTables_);
+    for (auto& table : unpreparedBuildTables_) {
+      swappedBuildTables_.push_back(std::move(table));
+    }
+  } else {
+    tables = std::move(unpreparedBuildTables_);
+  }
+  unpreparedBuildTables_.clear();
+  bufferedProbeTables_.clear();
+  return true;
+}
+
+void HashJoinBridge::prepareTable(
+    std::vector<std::unique_ptr<BaseHashTable>> tables,
+    bool swapped) {
+  std::shared_ptr<BaseHashTable> table = std::move(tables[0]);
+  std::vector<std::unique_ptr<BaseHashTable>> otherTables;
+  otherTables.reserve(tables.size() - 1);
+  for (auto i = 1; i < tables.size(); ++i) {
+    otherTables.push_back(std::move(tables[i]));
+  }
+  // 'buildExecutor_' is not changed after the sides are decided.
+  auto* executor = otherTables.empty() ? nullptr : buildExecutor_;
+  table->prepareJoinTable(std::move(otherTables), executor);
+  if (!swapped) {
+    setHashTable(std::move(table), {}, false);
+    return;
+  }
+
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!buildResult_.has_value());
+    if (!exportedFilters_.has_value()) {
+      exportedFilters_.emplace();
+    }
+    buildResult_ = HashBuildResult(std::move(table), std::nullopt, {}, false);
+    buildResult_->swapped = true;
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
+std::shared_ptr<BaseHashTable> HashJoinBridge::nextSwappedBuildTable() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (swappedBuildTables_.empty()) {
+    return nullptr;
+  }
+  auto table = std::move(swappedBuildTables_.back());
+  swappedBuildTables_.pop_back();
+  return table;
+}
+
 void HashJoinBridge::setAntiJoinHasNullKeys() {
   std::vector<ContinuePromise> promises;
   SpillPartitionSet spillPartitions;
@@ -83,6 +234,9 @@ void HashJoinBridge::setAntiJoinHasNullKeys() {
     VELOX_CHECK(restoringSpillShards_.empty());
 
     buildResult_ = HashBuildResult{};
+    if (!exportedFilters_.has_value()) {
+      exportedFilters_.emplace();
+    }
     restoringSpillPartitionId_.reset();
     spillPartitions.swap(spillPartitionSets_);
     promises = std::move(promises_);
@@ -103,6 +257,9 @@ std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
   if (buildResult_.has_value()) {
     return buildResult_.value();
   }
+  if (future == nullptr) {
+    return std::nullopt;
+  }
   promises_.emplace_back("HashJoinBridge::tableOrFuture");
   *future = promises_.back().getSemiFuture();
   return std::nullopt;
@@ -164,10 +321,30 @@ std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
   return SpillInput(std::move(spillShard));
 }
 
+std::optional<folly::dynamic> HashJoinBridge::exportDynamicFilters() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!exportedFilters_.has_value()) {
+    return std::nullopt;
+  }
+  folly::dynamic filters = folly::dynamic::array;
+  for (const auto& filter : exportedFilters_.value()) {
+    filters.push_back(filter != nullptr ? filter->serialize() : nullptr);
+  }
+  return filters;
+}
+
 bool isLeftNullAwareJoinWithFilter(
     const std::shared_ptr<const core::HashJoinNode>& joinNode) {
   return (joinNode->isAntiJoin() || joinNode->isLeftSemiProjectJoin() ||
           joinNode->isLeftSemiFilterJoin()) &&
       joinNode->isNullAware() && (joinNode->filter() != nullptr);
 }
+
+bool canSwapJoinSides(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config) {
+  return config.joinSwapMinBuildRows() > 0 && joinNode.isInnerJoin() &&
+      joinNode.filter() == nullptr && !joinNode.isNullAware() &&
+      !joinNode.canSpill(config);
+}
 } // namespace facebook::velox::exec
@@ -37,14 +37,47 @@ class HashJoinBridge : public JoinBridge {
   /// 'spillPartitionSet' contains the spilled partitions while building
   /// 'table'. The function returns true if there is spill data to restore
   /// after HashProbe operators process 'table', otherwise false. This only
-  /// applies if the disk spilling is enabled.
+  /// applies if the disk spilling is enabled. 'dynamicFilters' has an optional
+  /// filter per join key to push down to the probe side. It is empty if the
+  /// join type does not allow filtering the probe side or no filters were made.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
-      bool hasNullKeys);
+      bool hasNullKeys,
+      std::vector<std::shared_ptr<common::Filter>> dynamicFilters = {});
 
   void setAntiJoinHasNullKeys();
 
+  /// Invoked by HashProbe operator ctor if the join sides may be swapped, see
+  /// canSwapJoinSides(). Counts the HashProbe operators that report on their
+  /// input with probeInputBuffered() or probeInputNotBuffered().
+  void addProber();
+
+  /// Invoked by the last HashBuild operator instead of setHashTable() if the
+  /// join sides may be swapped. 'tables' are the tables of all HashBuild
+  /// operators before prepareJoinTable(). Once the probe side is known, the
+  /// table to probe is prepared over the build side tables, or over the
+  /// buffered probe input if all of it fits in the HashProbe buffers and has
+  /// fewer rows. The thread that completes the picture prepares the table.
+  void setUnpreparedBuildTables(
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor);
+
+  /// Invoked by a HashProbe operator whose input does not all fit in its
+  /// buffer. The table is then built over the build side.
+  void probeInputNotBuffered();
+
+  /// Invoked by a HashProbe operator that buffered all its input. 'table' has
+  /// the buffered rows with the probe keys as keys and the other probe
+  /// columns as dependents and is not prepared. It is dropped if the table is
+  /// built over the build side.
+  void probeInputBuffered(std::unique_ptr<BaseHashTable> table);
+
+  /// Returns a not yet taken build side table whose rows the HashProbe
+  /// operators join with the swapped table over the probe side, or nullptr if
+  /// all are taken.
+  std::shared_ptr<BaseHashTable> nextSwappedBuildTable();
+
   /// Represents the result of HashBuild operators: a hash table, an optional
   /// restored spill partition id associated with the table, and the spilled
   /// partitions while building the table if not empty. In case of an anti join,
@@ -56,26 +89,37 @@ class HashJoinBridge : public JoinBridge {
         std::shared_ptr<BaseHashTable> _table,
         std::optional<SpillPartitionId> _restoredPartitionId,
         SpillPartitionIdSet _spillPartitionIds,
-        bool _hasNullKeys)
+        bool _hasNullKeys,
+        std::vector<std::shared_ptr<common::Filter>> _dynamicFilters = {})
         : hasNullKeys(_hasNullKeys),
           table(std::move(_table)),
           restoredPartitionId(std::move(_restoredPartitionId)),
-          spillPartitionIds(std::move(_spillPartitionIds)) {}
+          spillPartitionIds(std::move(_spillPartitionIds)),
+          dynamicFilters(std::move(_dynamicFilters)) {}
 
     HashBuildResult() : hasNullKeys(true) {}
 
     bool hasNullKeys;
     std::shared_ptr<BaseHashTable> table;
+    // True if 'table' is built over the probe side input. The HashProbe
+    // operators then probe it with the rows of nextSwappedBuildTable().
+    bool swapped{false};
     std::optional<SpillPartitionId> restoredPartitionId;
     SpillPartitionIdSet spillPartitionIds;
+    // Filter per join key, null for keys without one. These are exact value
+    // or range filters, or Bloom filters for keys with too many distinct
+    // values. Empty if there are no filters.
+    std::vector<std::shared_ptr<common::Filter>> dynamicFilters;
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
   /// HashBuild operators. If HashProbe operator calls this early, 'future' will
   /// be set to wait asynchronously, otherwise the built table along with
   /// optional spilling related information will be returned in HashBuildResult.
+  /// If 'future' is null, returns std::nullopt without waiting if the table is
+  /// not built yet.
   std::optional<HashBuildResult> tableOrFuture(
-      ContinueFuture* FOLLY_NONNULL future);
+      ContinueFuture* FOLLY_NULLABLE future);
 
   /// Invoked by HashProbe operator after finishes probing the built table to
   /// set one of the previously spilled partition to restore. The HashBuild
@@ -104,11 +148,50 @@ class HashJoinBridge : public JoinBridge {
   std::optional<SpillInput> spillInputOrFuture(
       ContinueFuture* FOLLY_NONNULL future);
 
+  /// Returns the filters on the join keys of the built table, serialized with
+  /// common::Filter::serialize(), for other tasks to import. The result is an
+  /// array with an element per join key, null for keys without a filter.
+  /// Filters are only exported if the build side did not spill, as otherwise
+  /// no single table covers all the build side keys. Returns std::nullopt if
+  /// the table is not built yet.
+  std::optional<folly::dynamic> exportDynamicFilters();
+
  private:
+  // Moves the tables to prepare to 'tables' and sets 'swapped' if the sides
+  // of the join are decided. Returns false if the build side or some of the
+  // probe side is not known yet or if the sides were already decided.
+  bool takeTablesToPrepareLocked(
+      std::vector<std::unique_ptr<BaseHashTable>>& tables,
+      bool& swapped);
+
+  // Prepares the first of 'tables' with the others and hands it over to the
+  // HashProbe operators.
+  void prepareTable(
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      bool swapped);
+
   uint32_t numBuilders_{0};
 
+  // Members for swapping the join sides. See canSwapJoinSides().
+  uint32_t numProbers_{0};
+  uint32_t numBufferedProbers_{0};
+  // Set if some HashProbe operator did not buffer all its input.
+  bool probeNotBuffered_{false};
+  // Set when the side to build the table over is decided.
+  bool sidesDecided_{false};
+  std::vector<std::unique_ptr<BaseHashTable>> unpreparedBuildTables_;
+  folly::Executor* buildExecutor_{nullptr};
+  std::vector<std::unique_ptr<BaseHashTable>> bufferedProbeTables_;
+  // The build side tables not yet taken by nextSwappedBuildTable().
+  std::vector<std::shared_ptr<BaseHashTable>> swappedBuildTables_;
+
   std::optional<HashBuildResult> buildResult_;
 
+  // Set when the first table is built to the filters to export. Kept after
+  // 'buildResult_' is reset at the end of probing.
+  std::optional<std::vector<std::shared_ptr<common::Filter>>>
+      exportedFilters_;
+
   // restoringSpillPartitionXxx member variables are populated by the
   // bridge itself. When probe side finished processing, the bridge picks the
   // first partition from 'spillPartitionSets_', splits it into "even" shards
@@ -134,4 +217,11 @@ class HashJoinBridge : public JoinBridge {
 // has filter set.
 bool isLeftNullAwareJoinWithFilter(
     const std::shared_ptr<const core::HashJoinNode>& joinNode);
+
+/// Returns true if the build and probe sides of 'joinNode' may be swapped at
+/// run time, see QueryConfig::kJoinSwapMinBuildRows. This applies to inner
+/// joins without a filter that do not spill.
+bool canSwapJoinSides(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config);
 } // namespace facebook::velox::exec
@@ -63,21 +63,24 @@ void HashPartitionFunction::partition(
   rows_.setAll();
 
   hashes_.resize(size);
-  for (auto i = 0; i < hashers_.size(); ++i) {
-    auto& hasher = hashers_[i];
+  for (auto& hasher : hashers_) {
     if (hasher->channel() != kConstantChannel) {
-      hashers_[i]->decode(*input.childAt(hasher->channel()), rows_);
-      hashers_[i]->hash(rows_, i > 0, hashes_);
-    } else {
-      hashers_[i]->hashPrecomputed(rows_, i > 0, hashes_);
+      hasher->decode(*input.childAt(hasher->channel()), rows_);
     }
   }
+  VectorHasher::hash(hashers_, rows_, hashes_);
 
   partitions.resize(size);
   if (hashBitRange_.has_value()) {
     for (auto i = 0; i < size; ++i) {
       partitions[i] = hashBitRange_->partition(hashes_[i]);
     }
+  } else if (bits::isPowerOfTwo(numPartitions_)) {
+    // Same as the modulo below without a division per row.
+    const uint64_t mask = numPartitions_ - 1;
+    for (auto i = 0; i < size; ++i) {
+      partitions[i] = hashes_[i] & mask;
+    }
   } else {
     for (auto i = 0; i < size; ++i) {
       partitions[i] = hashes_[i] % numPartitions_;
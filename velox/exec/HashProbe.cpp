@@ -58,20 +58,26 @@ void extractColumns(
     BaseHashTable* table,
     folly::Range<char**> rows,
     folly::Range<const IdentityProjection*> projections,
-    memory::MemoryPool* pool,
+    VectorPool& vectorPool,
     const RowVectorPtr& result) {
+  std::vector<column_index_t> columns;
+  std::vector<VectorPtr> children;
+  columns.reserve(projections.size());
+  children.reserve(projections.size());
   for (auto projection : projections) {
     auto& child = result->childAt(projection.outputChannel);
     // TODO: Consider reuse of complex types.
     if (!child || !BaseVector::isVectorWritable(child) ||
         !child->isFlatEncoding()) {
-      child = BaseVector::create(
-          result->type()->childAt(projection.outputChannel), rows.size(), pool);
+      child = vectorPool.get(
+          result->type()->childAt(projection.outputChannel), rows.size());
     }
     child->resize(rows.size());
-    table->rows()->extractColumn(
-        rows.data(), rows.size(), projection.inputChannel, child);
+    columns.push_back(projection.inputChannel);
+    children.push_back(child);
   }
+  // The build side columns are extracted together a block of rows at a time.
+  table->rows()->extractColumns(rows.data(), rows.size(), columns, children);
 }
 
 folly::Range<vector_size_t*> initializeRowNumberMapping(
@@ -135,8 +141,14 @@ HashProbe::HashProbe(
               : std::nullopt),
       probeType_(joinNode_->sources()[0]->outputType()),
       filterResult_(1),
-      outputTableRows_(outputBatchSize_) {
+      outputTableRows_(outputBatchSize_),
+      maxBufferedBytes_(
+          driverCtx->queryConfig().joinSwapMaxProbeBufferBytes()) {
   VELOX_CHECK_NOT_NULL(joinBridge_);
+  if (canSwapJoinSides(*joinNode_, driverCtx->queryConfig())) {
+    joinBridge_->addProber();
+    bufferInput_ = true;
+  }
 
   auto numKeys = joinNode_->leftKeys().size();
   keyChannels_.reserve(numKeys);
@@ -260,7 +272,8 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.fileOptions);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -276,12 +289,18 @@ void HashProbe::asyncWaitForHashTable() {
   checkRunning();
   VELOX_CHECK_NULL(table_);
 
-  auto hashBuildResult = joinBridge_->tableOrFuture(&future_);
+  // Keeps running to buffer the input while the join sides may be swapped.
+  auto hashBuildResult =
+      joinBridge_->tableOrFuture(bufferInput_ ? nullptr : &future_);
   if (!hashBuildResult.has_value()) {
+    if (bufferInput_) {
+      return;
+    }
     VELOX_CHECK(future_.valid());
     setState(State::kWaitForBuild);
     return;
   }
+  bufferInput_ = false;
 
   if (hashBuildResult->hasNullKeys) {
     VELOX_CHECK(nullAware_);
@@ -298,6 +317,9 @@ void HashProbe::asyncWaitForHashTable() {
 
   table_ = std::move(hashBuildResult->table);
   VELOX_CHECK_NOT_NULL(table_);
+  if (hashBuildResult->swapped) {
+    swapJoinSides();
+  }
 
   maybeSetupSpillInput(
       hashBuildResult->restoredPartitionId, hashBuildResult->spillPartitionIds);
@@ -305,30 +327,32 @@ void HashProbe::asyncWaitForHashTable() {
   if (table_->numDistinct() == 0) {
     if (skipProbeOnEmptyBuild()) {
       if (!needSpillInput()) {
+        bufferedInputs_.clear();
+        swapped_ = false;
         noMoreInput();
       }
     }
   } else if (
-      (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
-       isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
+      !hashBuildResult->dynamicFilters.empty() && !isSpillInput() &&
       !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
-    // dynamic filters on all or a subset of the join keys. Create dynamic
-    // filters to push down.
+    // dynamic filters on all or a subset of the join keys. HashBuild makes
+    // the filters for the join types that allow filtering the probe side:
+    // exact filters for the keys whose values the table tracks and, if
+    // enabled, Bloom filters for the other keys.
     //
     // NOTE: this optimization is not applied in the following cases: (1) if the
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
-    const auto& buildHashers = table_->hashers();
+    const auto& filters = hashBuildResult->dynamicFilters;
+    VELOX_CHECK_EQ(filters.size(), keyChannels_.size());
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
     for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(false)) {
-          dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
-        }
+      if (channels.find(keyChannels_[i]) != channels.end() &&
+          filters[i] != nullptr) {
+        dynamicFilters_.emplace(keyChannels_[i], filters[i]);
       }
     }
   }
@@ -456,8 +480,11 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
       }
       break;
     case State::kRunning:
-      VELOX_CHECK_NOT_NULL(table_);
-      if (spillInputReader_ != nullptr) {
+      if (table_ == nullptr) {
+        // Checks if the table is built while buffering the input.
+        VELOX_CHECK(bufferInput_);
+        asyncWaitForHashTable();
+      } else if (spillInputReader_ != nullptr) {
         addSpillInput();
       }
       break;
@@ -488,9 +515,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBloomFilter) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -514,6 +544,11 @@ void HashProbe::decodeAndDetectNonNullKeys() {
 }
 
 void HashProbe::addInput(RowVectorPtr input) {
+  if (table_ == nullptr) {
+    bufferInput(std::move(input));
+    return;
+  }
+
   input_ = std::move(input);
 
   if (input_->size() > 0) {
@@ -570,14 +605,14 @@ void HashProbe::addInput(RowVectorPtr input) {
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
   auto& buildHashers = table_->hashers();
-  for (auto i = 0; i < keyChannels_.size(); ++i) {
-    if (mode != BaseHashTable::HashMode::kHash) {
+  if (mode != BaseHashTable::HashMode::kHash) {
+    for (auto i = 0; i < keyChannels_.size(); ++i) {
       auto key = input_->childAt(keyChannels_[i]);
       buildHashers[i]->lookupValueIds(
           *key, activeRows_, scratchMemory_, lookup_->hashes);
-    } else {
-      hashers_[i]->hash(activeRows_, i > 0, lookup_->hashes);
     }
+  } else {
+    VectorHasher::hash(hashers_, activeRows_, lookup_->hashes);
   }
   lookup_->rows.clear();
   if (activeRows_.isAllSelected()) {
@@ -620,6 +655,15 @@ void HashProbe::addInput(RowVectorPtr input) {
 }
 
 void HashProbe::prepareOutput(vector_size_t size) {
+  if (output_ && !output_.unique()) {
+    // The consumer still holds the previous output. Its build-side children go
+    // back to the vector pool once the consumer releases it.
+    for (const auto& projection : tableOutputProjections_) {
+      retainForRecycle(output_->childAt(projection.outputChannel));
+    }
+    output_ = nullptr;
+  }
+  recycleRetainedVectors();
   // Try to re-use memory for the output vectors that contain build-side data.
   // We expect output vectors containing probe-side data to be null (reset in
   // clearIdentityProjectedOutput). BaseVector::prepareForReuse keeps null
@@ -629,7 +673,16 @@ void HashProbe::prepareOutput(vector_size_t size) {
     BaseVector::prepareForReuse(output, size);
     output_ = std::static_pointer_cast<RowVector>(output);
   } else {
-    output_ = BaseVector::create<RowVector>(outputType_, size, pool());
+    // The probe-side children are set when filling the output and the
+    // build-side children are taken from the vector pool on extraction. Only
+    // the match column needs to be allocated up front.
+    std::vector<VectorPtr> children(outputType_->size());
+    if (isLeftSemiProjectJoin(joinType_) || isRightSemiProjectJoin(joinType_)) {
+      children.back() =
+          BaseVector::create(outputType_->children().back(), size, pool());
+    }
+    output_ = std::make_shared<RowVector>(
+        pool(), outputType_, BufferPtr(nullptr), size, std::move(children));
   }
 }
 
@@ -704,7 +757,7 @@ void HashProbe::fillOutput(vector_size_t size) {
         table_.get(),
         folly::Range<char**>(outputTableRows_.data(), size),
         tableOutputProjections_,
-        pool(),
+        operatorCtx_->execCtx()->vectorPool(),
         output_);
   }
 }
@@ -748,7 +801,7 @@ RowVectorPtr HashProbe::getBuildSideOutput() {
       table_.get(),
       folly::Range<char**>(outputTableRows_.data(), numOut),
       tableOutputProjections_,
-      pool(),
+      operatorCtx_->execCtx()->vectorPool(),
       output_);
 
   if (isRightSemiProjectJoin(joinType_)) {
@@ -844,6 +897,15 @@ RowVectorPtr HashProbe::getOutput() {
   checkRunning();
 
   clearIdentityProjectedOutput();
+  while (!input_ && table_ && !bufferedInputs_.empty()) {
+    auto input = std::move(bufferedInputs_.front());
+    bufferedInputs_.pop_front();
+    addInput(std::move(input));
+  }
+  if (swapped_) {
+    while (!input_ && addSwappedInput()) {
+    }
+  }
   if (!input_) {
     if (!hasMoreInput()) {
       if (needLastProbe() && lastProber_) {
@@ -1344,6 +1406,163 @@ void HashProbe::ensureLoadedIfNotAtEnd(column_index_t channel) {
 void HashProbe::noMoreInput() {
   Operator::noMoreInput();
   noMoreInputInternal();
+  if (bufferInput_) {
+    finishBufferingInput();
+  }
+}
+
+void HashProbe::bufferInput(RowVectorPtr input) {
+  VELOX_CHECK(bufferInput_);
+  // The input is kept past the next batch and then may not be lazy.
+  for (auto& child : input->children()) {
+    child = BaseVector::loadedVectorShared(child);
+  }
+  bufferedBytes_ += input->retainedSize();
+  bufferedInputs_.push_back(std::move(input));
+  if (bufferedBytes_ <= maxBufferedBytes_) {
+    return;
+  }
+  bufferInput_ = false;
+  joinBridge_->probeInputNotBuffered();
+  asyncWaitForHashTable();
+}
+
+void HashProbe::finishBufferingInput() {
+  VELOX_CHECK(bufferInput_);
+  bufferInput_ = false;
+  joinBridge_->probeInputBuffered(makeBufferedInputTable());
+  asyncWaitForHashTable();
+}
+
+std::unique_ptr<BaseHashTable> HashProbe::makeBufferedInputTable() {
+  const auto tableType = makeTableType(probeType_.get(), joinNode_->leftKeys());
+  const auto numKeys = keyChannels_.size();
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.reserve(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    keyHashers.push_back(
+        std::make_unique<VectorHasher>(tableType->childAt(i), keyChannels_[i]));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  for (auto i = numKeys; i < tableType->size(); ++i) {
+    dependentTypes.push_back(tableType->childAt(i));
+    dependentChannels.push_back(probeType_->getChildIdx(tableType->nameOf(i)));
+  }
+  // Rows with null keys have no match in an inner join.
+  auto table = HashTable<true>::createForJoin(
+      std::move(keyHashers),
+      dependentTypes,
+      true, // allowDuplicates
+      false, // hasProbedFlag
+      pool());
+
+  // Like HashBuild, runs the keys through the hashers to find out whether the
+  // table can use value ids.
+  auto& hashers = table->hashers();
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  std::vector<DecodedVector> decoded(dependentChannels.size());
+  auto* rowContainer = table->rows();
+  const auto nextOffset = rowContainer->nextOffset();
+  for (const auto& input : bufferedInputs_) {
+    rows.resize(input->size());
+    rows.setAll();
+    for (auto& hasher : hashers) {
+      hasher->decode(*input->childAt(hasher->channel()), rows);
+    }
+    deselectRowsWithNulls(hashers, rows);
+    if (!rows.hasSelections()) {
+      continue;
+    }
+    for (auto i = 0; i < dependentChannels.size(); ++i) {
+      decoded[i].decode(*input->childAt(dependentChannels[i]), rows);
+    }
+    if (analyzeKeys) {
+      hashes.resize(rows.end());
+      for (auto& hasher : hashers) {
+        hasher->computeValueIds(rows, hashes);
+        analyzeKeys = hasher->mayUseValueIds();
+        if (!analyzeKeys) {
+          break;
+        }
+      }
+    }
+    rows.applyToSelected([&](auto row) {
+      char* newRow = rowContainer->newRow();
+      if (nextOffset) {
+        *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+      }
+      for (auto i = 0; i < numKeys; ++i) {
+        rowContainer->store(hashers[i]->decodedVector(), row, newRow, i);
+      }
+      for (auto i = 0; i < dependentChannels.size(); ++i) {
+        rowContainer->store(decoded[i], row, newRow, i + numKeys);
+      }
+    });
+  }
+  return table;
+}
+
+void HashProbe::swapJoinSides() {
+  // The build side table rows become the input with the build keys first as
+  // in the table over the build side.
+  const auto buildType = joinNode_->sources()[1]->outputType();
+  swappedInputType_ = makeTableType(buildType.get(), joinNode_->rightKeys());
+  const auto tableType = makeTableType(probeType_.get(), joinNode_->leftKeys());
+  const auto numKeys = keyChannels_.size();
+  keyChannels_.clear();
+  hashers_.clear();
+  for (column_index_t i = 0; i < numKeys; ++i) {
+    keyChannels_.push_back(i);
+    hashers_.push_back(
+        std::make_unique<VectorHasher>(swappedInputType_->childAt(i), i));
+  }
+
+  identityProjections_.clear();
+  tableOutputProjections_.clear();
+  for (column_index_t i = 0; i < outputType_->size(); ++i) {
+    const auto& name = outputType_->nameOf(i);
+    if (auto channel = swappedInputType_->getChildIdxIfExists(name)) {
+      identityProjections_.emplace_back(channel.value(), i);
+    } else {
+      tableOutputProjections_.emplace_back(tableType->getChildIdx(name), i);
+    }
+  }
+  isIdentityProjection_ = false;
+
+  bufferedInputs_.clear();
+  swapped_ = true;
+  addRuntimeStat("swappedJoinSides", RuntimeCounter(1));
+}
+
+bool HashProbe::addSwappedInput() {
+  for (;;) {
+    if (swappedBuildTable_ == nullptr) {
+      swappedBuildTable_ = joinBridge_->nextSwappedBuildTable();
+      if (swappedBuildTable_ == nullptr) {
+        return false;
+      }
+      swappedBuildIterator_.reset();
+    }
+    auto* rows = swappedBuildTable_->rows();
+    swappedBuildRows_.resize(outputBatchSize_);
+    const auto numRows = rows->listRows(
+        &swappedBuildIterator_, outputBatchSize_, swappedBuildRows_.data());
+    if (numRows == 0) {
+      swappedBuildTable_.reset();
+      continue;
+    }
+    auto input =
+        BaseVector::create<RowVector>(swappedInputType_, numRows, pool());
+    for (auto i = 0; i < swappedInputType_->size(); ++i) {
+      rows->extractColumn(
+          swappedBuildRows_.data(), numRows, i, input->childAt(i));
+    }
+    addInput(std::move(input));
+    return true;
+  }
 }
 
 bool HashProbe::hasMoreInput() const {
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <deque>
+
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/HashTable.h"
@@ -64,6 +66,9 @@ class HashProbe : public Operator {
       return false;
     }
     if (table_) {
+      return bufferedInputs_.empty();
+    }
+    if (bufferInput_) {
       return true;
     }
     // NOTE: if we can't apply dynamic filtering, then we can start early to
@@ -229,6 +234,28 @@ class HashProbe : public Operator {
   /// Decode join key inputs and populate 'nonNullInputRows_'.
   void decodeAndDetectNonNullKeys();
 
+  // Adds 'input' to 'bufferedInputs_' while the table is not built and the
+  // join sides may be swapped. Stops buffering if the buffered inputs are
+  // over 'maxBufferedBytes_'.
+  void bufferInput(RowVectorPtr input);
+
+  // Invoked at the end of the input while buffering. Hands the buffered rows
+  // over to 'joinBridge_' in a table to build the join table over if the
+  // sides are swapped.
+  void finishBufferingInput();
+
+  // Makes an unprepared table over 'bufferedInputs_' with the probe keys as
+  // keys and the other probe columns as dependents.
+  std::unique_ptr<BaseHashTable> makeBufferedInputTable();
+
+  // Invoked when 'table_' is built over the probe side. Sets the keys and
+  // projections for taking the rows of the build side tables as input.
+  void swapJoinSides();
+
+  // Adds the next batch of rows of the build side tables as input if the join
+  // sides are swapped. Returns false if there are no more build side rows.
+  bool addSwappedInput();
+
   // Invoked when there is no more input from either upstream task or spill
   // input. If there is remaining spilled data, then the last finished probe
   // operator is responsible for notifying the hash build operators to build the
@@ -572,6 +599,29 @@ class HashProbe : public Operator {
 
   // The spilled probe partitions remaining to restore.
   SpillPartitionSet spillPartitionSet_;
+
+  // True while the input is buffered before the table is built in case the
+  // join sides are swapped. See canSwapJoinSides().
+  bool bufferInput_{false};
+
+  const uint64_t maxBufferedBytes_;
+
+  // The buffered input. Joined with 'table_' once it is built unless the
+  // sides are swapped.
+  std::deque<RowVectorPtr> bufferedInputs_;
+  uint64_t bufferedBytes_{0};
+
+  // True if 'table_' is built over the probe side.
+  bool swapped_{false};
+
+  // Type of the input made of build side table rows if 'swapped_'.
+  RowTypePtr swappedInputType_;
+
+  // The build side table whose rows are the input if 'swapped_' and the
+  // position in its rows.
+  std::shared_ptr<BaseHashTable> swappedBuildTable_;
+  RowContainerIterator swappedBuildIterator_;
+  std::vector<char*> swappedBuildRows_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, HashProbe::State state) {
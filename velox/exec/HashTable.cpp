@@ -28,6 +28,14 @@ using facebook::velox::common::testutil::TestValue;
 namespace facebook::velox::exec {
 namespace {
 constexpr int32_t kMinTableSizeForParallelJoinBuild = 1000;
+
+// Log2 of the number of table slots in a partition of a parallel join build.
+// The tags and table slots of 64K entries take 576KB, which is about the size
+// of L2, so that the inserts into a partition do not miss the cache.
+constexpr int32_t kJoinBuildPartitionSizeBits = 16;
+
+// Join build partition numbers are kept in one byte per row.
+constexpr int32_t kMaxJoinBuildPartitionBits = 8;
 }
 
 // static
@@ -92,14 +100,36 @@ class ProbeState {
   static constexpr uint8_t kEmptyTag = 0x00;
   static constexpr int32_t kFullMask = 0xffff;
 
+  // Number of probes ahead of the current one for which the tags and table
+  // slots are prefetched. Covers the latency of a cache miss with the work of
+  // four groups of four interleaved probes.
+  static constexpr int32_t kPrefetchDistance = 16;
+
   static inline int32_t tagsByteOffset(uint64_t hash, uint64_t sizeMask) {
     return (hash & sizeMask) & ~(sizeof(BaseHashTable::TagVector) - 1);
   }
 
+  // Prefetches the tags and the table slots that preProbe() and firstProbe()
+  // load for 'hash'.
+  static inline void
+  prefetch(uint8_t* tags, char* table, uint64_t sizeMask, uint64_t hash) {
+    const auto tagIndex = tagsByteOffset(hash, sizeMask);
+    __builtin_prefetch(tags + tagIndex);
+    __builtin_prefetch(
+        table +
+        static_cast<int64_t>(tagIndex) * BaseHashTable::kPackedPointerBytes);
+  }
+
   int32_t row() const {
     return row_;
   }
 
+  // Returns the number of tag groups after the first one that the last
+  // fullProbe() went through.
+  int32_t numExtraGroups() const {
+    return numExtraGroups_;
+  }
+
   // Use one instruction to load 16 tags
   // Use another instruction to make 16 copies of the tag being searched for
   inline void
@@ -111,12 +141,13 @@ class ProbeState {
     wantedTags_ = BaseHashTable::TagVector::broadcast(tag);
     group_ = nullptr;
     indexInTags_ = kNotSet;
+    numExtraGroups_ = 0;
   }
 
   // Use one instruction to compare the tag being searched for to 16 tags
   // If there is a match, load corresponding data from the table
   template <Operation op = Operation::kProbe>
-  inline void firstProbe(char** table, int32_t firstKey) {
+  inline void firstProbe(char* table, int32_t firstKey) {
     hits_ = simd::toBitMask(tagsInTable_ == wantedTags_);
     if (hits_) {
       loadNextHit<op>(table, firstKey);
@@ -126,7 +157,7 @@ class ProbeState {
   template <Operation op, typename Compare, typename Insert>
   inline char* FOLLY_NULLABLE fullProbe(
       uint8_t* tags,
-      char** table,
+      char* table,
       uint64_t sizeMask,
       int32_t firstKey,
       Compare compare,
@@ -188,6 +219,7 @@ class ProbeState {
         auto pos = bits::getAndClearLastSetBit(empty);
         return insert(row_, tagIndex_ + pos);
       }
+      ++numExtraGroups_;
       if (op == Operation::kInsert && indexInTags_ == kNotSet) {
         // We passed through a full group.
         uint16_t tombstones =
@@ -205,7 +237,7 @@ class ProbeState {
 
   FOLLY_ALWAYS_INLINE char* FOLLY_NULLABLE joinNormalizedKeyFullProbe(
       uint8_t* tags,
-      char** table,
+      char* table,
       uint64_t sizeMask,
       const uint64_t* keys) {
     if (group_ && RowContainer::normalizedKey(group_) == keys[row_]) {
@@ -236,7 +268,7 @@ class ProbeState {
   static constexpr uint8_t kNotSet = 0xff;
 
   template <Operation op>
-  inline void loadNextHit(char** table, int32_t firstKey) {
+  inline void loadNextHit(char* table, int32_t firstKey) {
     int32_t hit = bits::getAndClearLastSetBit(hits_);
 
     if (op == Operation::kErase) {
@@ -262,6 +294,7 @@ class ProbeState {
   int32_t row_;
   int32_t tagIndex_;
   BaseHashTable::MaskType hits_;
+  int32_t numExtraGroups_{0};
 
   // If op is kErase, this is the index of the current hit within the
   // group of 'tagIndex_'. If op is kInsert, this is the index of the
@@ -289,10 +322,12 @@ void HashTable<ignoreNullKeys>::storeRowPointer(
     int32_t index,
     uint64_t hash,
     char* row) {
-  if (hashMode_ != HashMode::kArray) {
-    tags_[index] = hashTag(hash);
+  if (hashMode_ == HashMode::kArray) {
+    table_[index] = row;
+    return;
   }
-  table_[index] = row;
+  tags_[index] = hashTag(hash);
+  storeRow(packedTable(), index, row);
 }
 
 template <bool ignoreNullKeys>
@@ -360,7 +395,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
     // NOLINT
     lookup.hits[state.row()] = state.fullProbe<op>(
         tags_,
-        table_,
+        packedTable(),
         sizeMask_,
         -static_cast<int32_t>(sizeof(normalized_key_t)),
         [&](char* group, int32_t row) INLINE_LAMBDA {
@@ -372,12 +407,15 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
         },
         numTombstones_,
         !isJoin && extraCheck);
+    if constexpr (!isJoin) {
+      numExtraProbeGroups_ += state.numExtraGroups();
+    }
     return;
   }
   // NOLINT
   lookup.hits[state.row()] = state.fullProbe<op>(
       tags_,
-      table_,
+      packedTable(),
       sizeMask_,
       0,
       [&](char* group, int32_t row) { return compareKeys(group, lookup, row); },
@@ -386,6 +424,11 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
       },
       numTombstones_,
       !isJoin && extraCheck);
+  if constexpr (!isJoin) {
+    // A join table may be probed by multiple threads, so only the probes of
+    // group by tables are counted.
+    numExtraProbeGroups_ += state.numExtraGroups();
+  }
 }
 
 namespace {
@@ -417,10 +460,32 @@ void populateNormalizedKeys(HashLookup& lookup, int8_t sizeBits) {
     hashes[row] = mixNormalizedKey(hash, sizeBits);
   }
 }
+
+// Prefetches the tags and table slots for the four probes that are
+// ProbeState::kPrefetchDistance after 'probeIndex', so that they are in
+// cache by the time these are probed.
+inline void prefetchProbes(
+    uint8_t* tags,
+    char* table,
+    uint64_t sizeMask,
+    const uint64_t* hashes,
+    const vector_size_t* rows,
+    int32_t probeIndex,
+    int32_t numProbes) {
+  const auto prefetchIndex = probeIndex + ProbeState::kPrefetchDistance;
+  if (prefetchIndex + 4 > numProbes) {
+    return;
+  }
+  for (auto i = 0; i < 4; ++i) {
+    ProbeState::prefetch(
+        tags, table, sizeMask, hashes[rows[prefetchIndex + i]]);
+  }
+}
 } // namespace
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
+  numGroupProbeRows_ += lookup.rows.size();
   if (hashMode_ == HashMode::kArray) {
     arrayGroupProbe(lookup);
     return;
@@ -437,8 +502,17 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   ProbeState state4;
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
+  numHashProbes_ += numProbes;
   auto rows = lookup.rows.data();
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    prefetchProbes(
+        tags_,
+        packedTable(),
+        sizeMask_,
+        lookup.hashes.data(),
+        rows,
+        probeIndex,
+        numProbes);
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -447,10 +521,10 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
     state3.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 3];
     state4.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state2.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state3.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state4.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
+    state1.firstProbe<ProbeState::Operation::kInsert>(packedTable(), 0);
+    state2.firstProbe<ProbeState::Operation::kInsert>(packedTable(), 0);
+    state3.firstProbe<ProbeState::Operation::kInsert>(packedTable(), 0);
+    state4.firstProbe<ProbeState::Operation::kInsert>(packedTable(), 0);
     fullProbe<false>(lookup, state1, false);
     fullProbe<false>(lookup, state2, true);
     fullProbe<false>(lookup, state3, true);
@@ -459,7 +533,7 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   for (; probeIndex < numProbes; ++probeIndex) {
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
+    state1.firstProbe(packedTable(), 0);
     fullProbe<false>(lookup, state1, false);
   }
 }
@@ -538,6 +612,14 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   ProbeState state3;
   ProbeState state4;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    prefetchProbes(
+        tags_,
+        packedTable(),
+        sizeMask_,
+        lookup.hashes.data(),
+        rows,
+        probeIndex,
+        numProbes);
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -546,10 +628,10 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     state3.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 3];
     state4.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
-    state2.firstProbe(table_, 0);
-    state3.firstProbe(table_, 0);
-    state4.firstProbe(table_, 0);
+    state1.firstProbe(packedTable(), 0);
+    state2.firstProbe(packedTable(), 0);
+    state3.firstProbe(packedTable(), 0);
+    state4.firstProbe(packedTable(), 0);
     fullProbe<true>(lookup, state1, false);
     fullProbe<true>(lookup, state2, false);
     fullProbe<true>(lookup, state3, false);
@@ -558,7 +640,7 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   for (; probeIndex < numProbes; ++probeIndex) {
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
+    state1.firstProbe(packedTable(), 0);
     fullProbe<true>(lookup, state1, false);
   }
 }
@@ -575,7 +657,10 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   const uint64_t* keys = lookup.normalizedKeys.data();
   const uint64_t* hashes = lookup.hashes.data();
   char** hits = lookup.hits.data();
+  char* table = packedTable();
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    prefetchProbes(
+        tags_, table, sizeMask_, hashes, rows, probeIndex, numProbes);
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, hashes[row], row);
     row = rows[probeIndex + 1];
@@ -584,25 +669,25 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
     state3.preProbe(tags_, sizeMask_, hashes[row], row);
     row = rows[probeIndex + 3];
     state4.preProbe(tags_, sizeMask_, hashes[row], row);
-    state1.firstProbe(table_, 0);
-    state2.firstProbe(table_, 0);
-    state3.firstProbe(table_, 0);
-    state4.firstProbe(table_, 0);
+    state1.firstProbe(table, 0);
+    state2.firstProbe(table, 0);
+    state3.firstProbe(table, 0);
+    state4.firstProbe(table, 0);
     hits[state1.row()] =
-        state1.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+        state1.joinNormalizedKeyFullProbe(tags_, table, sizeMask_, keys);
     hits[state2.row()] =
-        state2.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+        state2.joinNormalizedKeyFullProbe(tags_, table, sizeMask_, keys);
     hits[state3.row()] =
-        state3.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+        state3.joinNormalizedKeyFullProbe(tags_, table, sizeMask_, keys);
     hits[state4.row()] =
-        state4.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+        state4.joinNormalizedKeyFullProbe(tags_, table, sizeMask_, keys);
   }
   for (; probeIndex < numProbes; ++probeIndex) {
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
+    state1.firstProbe(table, 0);
     hits[row] =
-        state1.joinNormalizedKeyFullProbe(tags_, table_, sizeMask_, keys);
+        state1.joinNormalizedKeyFullProbe(tags_, table, sizeMask_, keys);
   }
 }
 
@@ -615,15 +700,17 @@ void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
   sizeMask_ = capacity_ - 1;
   sizeBits_ = __builtin_popcountll(sizeMask_);
   constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
-  // The total size is 9 bytes per slot, 8 in the pointers table and 1 in the
-  // tags table.
-  auto numPages = bits::roundUp(size * 9, kPageSize) / kPageSize;
+  // The total size is 7 bytes per slot, 6 in the packed pointers table and 1
+  // in the tags table. The tags follow the pointers, so that loadRow() can
+  // read past the end of the last pointer.
+  const auto pointerBytes = size * kPackedPointerBytes;
+  auto numPages = bits::roundUp(pointerBytes + size, kPageSize) / kPageSize;
   rows_->pool()->allocateContiguous(numPages, tableAllocation_);
   table_ = tableAllocation_.data<char*>();
-  tags_ = reinterpret_cast<uint8_t*>(table_ + size);
+  tags_ = reinterpret_cast<uint8_t*>(packedTable() + pointerBytes);
   memset(tags_, 0, capacity_);
   // Not strictly necessary to clear 'table_' but more debuggable.
-  memset(table_, 0, capacity_ * sizeof(char*));
+  memset(table_, 0, pointerBytes);
 }
 
 template <bool ignoreNullKeys>
@@ -633,7 +720,12 @@ void HashTable<ignoreNullKeys>::clear() {
     memset(tags_, 0, capacity_);
   }
   if (table_) {
-    memset(table_, 0, sizeof(char*) * capacity_);
+    memset(
+        table_,
+        0,
+        capacity_ *
+            (hashMode_ == HashMode::kArray ? sizeof(char*)
+                                           : kPackedPointerBytes));
   }
   numDistinct_ = 0;
 }
@@ -766,23 +858,29 @@ template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::parallelJoinBuild() {
   TestValue::adjust(
       "facebook::velox::exec::HashTable::parallelJoinBuild", nullptr);
-  int32_t numPartitions = 1 + otherTables_.size();
+  const int32_t numTables = 1 + otherTables_.size();
   VELOX_CHECK_GT(
-      capacity_ / numPartitions,
+      capacity_ / numTables,
       kMinTableSizeForParallelJoinBuild,
       "Less than {} entries per partition for parallel build",
       kMinTableSizeForParallelJoinBuild);
+  // The partitions are the high bits of the table index. There are at least
+  // as many partitions as build threads and, for large tables, enough of them
+  // for the tags and table slots of a partition to stay in cache while it is
+  // built.
+  const int32_t numPartitionBits = std::min<int32_t>(
+      kMaxJoinBuildPartitionBits,
+      std::max<int32_t>(
+          __builtin_ctzll(bits::nextPowerOfTwo(numTables)),
+          sizeBits_ - kJoinBuildPartitionSizeBits));
+  VELOX_CHECK_GE(
+      capacity_ >> numPartitionBits,
+      folly::hardware_destructive_interference_size);
+  buildPartitionBits_ = HashBitRange(sizeBits_ - numPartitionBits, sizeBits_);
+  const int32_t numPartitions = buildPartitionBits_.numPartitions();
   buildPartitionBounds_.resize(numPartitions + 1);
-  // Pad the tail of buildPartitionBounds_ to max int.
-  std::fill(
-      buildPartitionBounds_.begin(),
-      buildPartitionBounds_.begin() + buildPartitionBounds_.capacity(),
-      std::numeric_limits<int32_t>::max());
   for (auto i = 0; i < numPartitions; ++i) {
-    // The bounds are rounded up to cache line size.
-    buildPartitionBounds_[i] = bits::roundUp(
-        (capacity_ / numPartitions) * i,
-        folly::hardware_destructive_interference_size);
+    buildPartitionBounds_[i] = (capacity_ >> numPartitionBits) * i;
   }
   buildPartitionBounds_.back() = capacity_;
   std::vector<std::shared_ptr<AsyncSource<bool>>> partitionSteps;
@@ -795,10 +893,10 @@ void HashTable<ignoreNullKeys>::parallelJoinBuild() {
     syncWorkItems(buildSteps, error, true);
   });
 
-  for (auto i = 0; i < numPartitions; ++i) {
+  for (auto i = 0; i < numTables; ++i) {
     auto table = i == 0 ? this : otherTables_[i - 1].get();
     partitionSteps.push_back(
-        std::make_shared<AsyncSource<bool>>([this, table, numPartitions]() {
+        std::make_shared<AsyncSource<bool>>([this, table]() {
           partitionRows(*table);
           return std::make_unique<bool>(true);
         }));
@@ -810,11 +908,16 @@ void HashTable<ignoreNullKeys>::parallelJoinBuild() {
   if (error) {
     std::rethrow_exception(error);
   }
+  // Each build thread builds every 'numTables'th partition, one partition at a
+  // time.
   std::vector<std::vector<char*>> overflowPerPartition(numPartitions);
-  for (auto i = 0; i < numPartitions; ++i) {
-    buildSteps.push_back(
-        std::make_shared<AsyncSource<bool>>([i, &overflowPerPartition, this]() {
-          buildJoinPartition(i, overflowPerPartition[i]);
+  for (auto i = 0; i < numTables; ++i) {
+    buildSteps.push_back(std::make_shared<AsyncSource<bool>>(
+        [i, numTables, numPartitions, &overflowPerPartition, this]() {
+          for (auto partition = i; partition < numPartitions;
+               partition += numTables) {
+            buildJoinPartition(partition, overflowPerPartition[partition]);
+          }
           return std::make_unique<bool>(true);
         }));
     assert(!buildSteps.empty()); // lint
@@ -839,30 +942,13 @@ void HashTable<ignoreNullKeys>::parallelJoinBuild() {
         0,
         capacity_,
         nullptr);
+  }
+  for (auto i = 0; i < numTables; ++i) {
     auto table = i == 0 ? this : otherTables_[i - 1].get();
     VELOX_CHECK_EQ(table->rows()->numRows(), table->numParallelBuildRows_);
   }
 }
 
-namespace {
-// Returns an index into 'buildPartitionBounds_' given an index into tags of the
-// HashTable.
-int32_t
-findPartition(int32_t index, const int32_t* bounds, int32_t numPartitions) {
-  // The partition bounds are padded to batch size.
-  constexpr int32_t kBatch = xsimd::batch<int32_t>::size;
-  auto indexVector = xsimd::batch<int32_t>::broadcast(index);
-  for (auto i = 1; i < numPartitions; i += kBatch) {
-    uint8_t bits = simd::toBitMask(
-        indexVector < xsimd::batch<int32_t>::load_unaligned(bounds + i));
-    if (bits) {
-      return i + __builtin_ctz(bits) - 1;
-    }
-  }
-  VELOX_UNREACHABLE("Partition index out of range");
-}
-} // namespace
-
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::partitionRows(
     HashTable<ignoreNullKeys>& subtable) {
@@ -874,14 +960,8 @@ void HashTable<ignoreNullKeys>::partitionRows(
   while (auto numRows = subtable.rows_->listRows(
              &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
     hashRows(folly::Range<char**>(rows.data(), numRows), true, hashes);
-    VELOX_DCHECK_EQ(
-        0,
-        buildPartitionBounds_.capacity() % xsimd::batch<int32_t>::size,
-        "partition bounds must be padded to SIMD width");
     for (auto i = 0; i < numRows; ++i) {
-      auto index = ProbeState::tagsByteOffset(hashes[i], sizeMask_);
-      partitions[i] = findPartition(
-          index, buildPartitionBounds_.data(), buildPartitionBounds_.size());
+      partitions[i] = buildPartitionBits_.partition(hashes[i]);
     }
     subtable.rows_->partitions().appendPartitions(
         folly::Range<const uint8_t*>(partitions.data(), numRows));
@@ -1010,7 +1090,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
   if (hashMode_ == HashMode::kNormalizedKey) {
     state.fullProbe<ProbeState::Operation::kInsert>(
         tags_,
-        table_,
+        packedTable(),
         sizeMask_,
         -static_cast<int32_t>(sizeof(normalized_key_t)),
         [&](char* group, int32_t /*row*/) {
@@ -1030,7 +1110,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
   } else {
     state.fullProbe<ProbeState::Operation::kInsert>(
         tags_,
-        table_,
+        packedTable(),
         sizeMask_,
         0,
         [&](char* group, int32_t /*row*/) {
@@ -1071,7 +1151,7 @@ void HashTable<ignoreNullKeys>::insertForJoin(
   ProbeState state1;
   for (auto i = 0; i < numGroups; ++i) {
     state1.preProbe(tags_, sizeMask_, hashes[i], i);
-    state1.firstProbe(table_, 0);
+    state1.firstProbe(packedTable(), 0);
     buildFullProbe(
         state1,
         hashes[i],
@@ -1116,6 +1196,14 @@ void HashTable<ignoreNullKeys>::rehash() {
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::setHashMode(HashMode mode, int32_t numNew) {
   VELOX_CHECK_NE(hashMode_, HashMode::kHash);
+  if (numDistinct_ > 0) {
+    // All rows are inserted again into the new table.
+    ++numHashModeChanges_;
+    if (mode == HashMode::kNormalizedKey) {
+      ++numNormalizedKeyChanges_;
+      numNormalizedKeyChangeRows_ += numDistinct_;
+    }
+  }
   if (mode == HashMode::kArray) {
     auto bytes = capacity_ * sizeof(char*);
     constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
@@ -1281,6 +1369,11 @@ void HashTable<ignoreNullKeys>::decideHashMode(
   }
   disableRangeArrayHash_ |= disableRangeArrayHash;
   if (numDistinct_ && !isJoinBuild_) {
+    if (normalizedKeyModeTooCostly()) {
+      hashModeFallback_ = true;
+      setHashMode(HashMode::kHash, numNew);
+      return;
+    }
     if (!analyze()) {
       setHashMode(HashMode::kHash, numNew);
       return;
@@ -1357,10 +1450,12 @@ std::string HashTable<ignoreNullKeys>::toString() {
   int32_t occupied = 0;
   if (table_ && tableAllocation_.data() && tableAllocation_.size()) {
     // 'size_' and 'table_' may not be set if initializing.
-    uint64_t size =
-        std::min<uint64_t>(tableAllocation_.size() / sizeof(char*), capacity_);
+    uint64_t size = std::min<uint64_t>(
+        tableAllocation_.size() / tableBytesPerEntry(), capacity_);
     for (int32_t i = 0; i < size; ++i) {
-      occupied += table_[i] != nullptr;
+      occupied += hashMode_ == HashMode::kArray
+          ? table_[i] != nullptr
+          : loadRow(packedTable(), i) != nullptr;
     }
   }
   out << "[HashTable  size: " << capacity_ << " occupied: " << occupied
@@ -1689,10 +1784,10 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
     for (auto i = 0; i < numRows; ++i) {
       state.preProbe(tags_, sizeMask_, hashes[i], i);
 
-      state.firstProbe<ProbeState::Operation::kErase>(table_, 0);
+      state.firstProbe<ProbeState::Operation::kErase>(packedTable(), 0);
       state.fullProbe<ProbeState::Operation::kErase>(
           tags_,
-          table_,
+          packedTable(),
           sizeMask_,
           0,
           [&](const char* group, int32_t row) { return rows[row] == group; },
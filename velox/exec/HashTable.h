@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <folly/Portability.h>
+
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
 #include "velox/exec/VectorHasher.h"
@@ -54,6 +57,23 @@ struct HashTableStats {
   int64_t numDistinct{0};
   /// Counts the number of tombstone table slots.
   int64_t numTombstones{0};
+  /// The current BaseHashTable::HashMode as an integer.
+  int32_t hashMode{0};
+  /// Number of times the hash mode of a non-empty table was decided again.
+  /// Each of these inserts all the rows into a new table.
+  int64_t numHashModeChanges{0};
+  /// True if the table switched to kHash mode because deciding the
+  /// kNormalizedKey mode again and again cost more than it saved.
+  bool hashModeFallback{false};
+  /// Number of rows looked up by groupProbe() in kHash and kNormalizedKey
+  /// modes and the total number of tag groups these went through.
+  int64_t numProbes{0};
+  int64_t numProbeGroups{0};
+
+  /// Returns the average number of tag groups a probe goes through.
+  double avgProbeChainLength() const {
+    return numProbes == 0 ? 0 : static_cast<double>(numProbeGroups) / numProbes;
+  }
 };
 
 class BaseHashTable {
@@ -69,6 +89,17 @@ class BaseHashTable {
   // 2M entries, i.e. 16MB is the largest array based hash table.
   static constexpr uint64_t kArrayHashMaxSize = 2L << 20;
 
+  /// Size of a row pointer in the table in kHash and kNormalizedKey modes.
+  /// User space addresses fit in 48 bits on the supported platforms, so the
+  /// pointers are stored in 6 bytes instead of 8. kArray mode tables are
+  /// indexed directly and keep full pointers.
+  static constexpr int32_t kPackedPointerBytes = 6;
+  static constexpr uint64_t kPackedPointerMask =
+      (1UL << (8 * kPackedPointerBytes)) - 1;
+  static_assert(
+      folly::kIsLittleEndian,
+      "Packed row pointers assume a little endian layout");
+
   /// Specifies the hash mode of a table.
   enum class HashMode { kHash, kArray, kNormalizedKey };
 
@@ -286,10 +317,40 @@ class BaseHashTable {
 #endif
   }
 
-  /// Loads the payload row pointer corresponding to the tag at 'index'.
+  /// Loads the payload row pointer corresponding to the tag at 'index' from
+  /// a table of pointers packed into kPackedPointerBytes each. Reads past the
+  /// end of the pointer, so there must be at least 2 addressable bytes after
+  /// the last pointer. Disables tsan errors for the same reason as loadTags().
+#if defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+  __attribute__((__no_sanitize__("thread")))
+#endif
+#endif
   static char* FOLLY_NULLABLE
-  loadRow(char* FOLLY_NULLABLE* FOLLY_NULLABLE table, int32_t index) {
-    return table[index];
+  loadRow(char* FOLLY_NULLABLE table, int32_t index) {
+    uint64_t pointer;
+    memcpy(
+        &pointer,
+        table + static_cast<int64_t>(index) * kPackedPointerBytes,
+        sizeof(pointer));
+    return reinterpret_cast<char*>(pointer & kPackedPointerMask);
+  }
+
+  /// Stores the payload row pointer corresponding to the tag at 'index' into a
+  /// table of pointers packed into kPackedPointerBytes each.
+  static void storeRow(
+      char* FOLLY_NULLABLE table,
+      int32_t index,
+      char* FOLLY_NULLABLE row) {
+    VELOX_DCHECK_EQ(
+        reinterpret_cast<uint64_t>(row) & ~kPackedPointerMask,
+        0,
+        "Row pointer does not fit in {} bytes",
+        kPackedPointerBytes);
+    memcpy(
+        table + static_cast<int64_t>(index) * kPackedPointerBytes,
+        &row,
+        kPackedPointerBytes);
   }
 
  protected:
@@ -396,9 +457,9 @@ class HashTable : public BaseHashTable {
   void clear() override;
 
   int64_t allocatedBytes() const override {
-    // for each row: 1 byte per tag + sizeof(Entry) per table entry + memory
-    // allocated with MemoryAllocator for fixed-width rows and strings.
-    return (1 + sizeof(char*)) * capacity_ + rows_->allocatedBytes();
+    // for each row: 1 byte per tag + packed row pointer per table entry +
+    // memory allocated with MemoryAllocator for fixed-width rows and strings.
+    return tableBytesPerEntry() * capacity_ + rows_->allocatedBytes();
   }
 
   HashStringAllocator* FOLLY_NULLABLE stringAllocator() override {
@@ -415,7 +476,15 @@ class HashTable : public BaseHashTable {
 
   HashTableStats stats() const override {
     return HashTableStats{
-        capacity_, numRehashes_, numDistinct_, numTombstones_};
+        capacity_,
+        numRehashes_,
+        numDistinct_,
+        numTombstones_,
+        static_cast<int32_t>(hashMode_),
+        numHashModeChanges_,
+        hashModeFallback_,
+        numHashProbes_,
+        numHashProbes_ + numExtraProbeGroups_};
   }
 
   bool hasDuplicateKeys() const override {
@@ -448,8 +517,8 @@ class HashTable : public BaseHashTable {
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
       // If rehashed, the table adds size_ entries (i.e. doubles),
-      // adding one pointer and one tag byte for each new position.
-      return capacity_ * (sizeof(void*) + 1);
+      // adding one packed pointer and one tag byte for each new position.
+      return capacity_ * (kPackedPointerBytes + 1);
     }
     return 0;
   }
@@ -525,6 +594,18 @@ class HashTable : public BaseHashTable {
 
   void storeRowPointer(int32_t index, uint64_t hash, char* FOLLY_NULLABLE row);
 
+  // Returns the row pointers of the table in kHash and kNormalizedKey modes.
+  // These are packed into kPackedPointerBytes each, see loadRow().
+  char* FOLLY_NULLABLE packedTable() const {
+    return reinterpret_cast<char*>(table_);
+  }
+
+  // Returns the bytes taken by one entry of the table, including the tag.
+  int32_t tableBytesPerEntry() const {
+    return hashMode_ == HashMode::kArray ? sizeof(char*)
+                                         : 1 + kPackedPointerBytes;
+  }
+
   // Allocates new tables for tags and payload pointers. The size must
   // a power of 2.
   void allocateTables(uint64_t size);
@@ -576,11 +657,12 @@ class HashTable : public BaseHashTable {
 
   // Builds a join table with '1 + otherTables_.size()' independent
   // threads using 'executor_'. First all RowContainers get partition
-  // numbers assigned to each row. Next, all threads pick all rows
-  // assigned to their thread-specific partition and insert these. If
-  // a row would overflow past the end of its partition it is added to
-  // a set of overflow rows that are sequentially inserted after all
-  // else.
+  // numbers assigned to each row from the high bits of the row's table
+  // index. Large tables get more partitions than threads so that the table
+  // range of each partition fits in cache. Next, each thread inserts the
+  // rows of its partitions, one partition at a time. If a row would
+  // overflow past the end of its partition it is added to a set of
+  // overflow rows that are sequentially inserted after all else.
   void parallelJoinBuild();
 
   // Inserts the rows in 'partition' from this and 'otherTables' into 'this'.
@@ -648,6 +730,17 @@ class HashTable : public BaseHashTable {
   // content. Returns true if all hashers offer a mapping to value ids
   // for array or normalized key.
   bool analyze();
+
+  // Returns true if the table has gone into kNormalizedKey mode at least
+  // kMinNormalizedKeyChanges times and the rows inserted again on these
+  // changes are more than the rows probed. A lookup with a normalized key
+  // saves less than the insert of a row costs, so kHash mode is cheaper if the
+  // key ranges keep growing.
+  bool normalizedKeyModeTooCostly() const {
+    return hashMode_ == HashMode::kNormalizedKey &&
+        numNormalizedKeyChanges_ >= kMinNormalizedKeyChanges &&
+        numNormalizedKeyChangeRows_ > numGroupProbeRows_;
+  }
   // Erases the entries of rows from the hash table and its RowContainer.
   // 'hashes' must be computed according to 'hashMode_'.
   void eraseWithHashes(
@@ -682,6 +775,23 @@ class HashTable : public BaseHashTable {
   int64_t numTombstones_{0};
   /// Counts the number of rehash() calls.
   int64_t numRehashes_{0};
+
+  static constexpr int32_t kMinNormalizedKeyChanges = 4;
+
+  // Counts the calls to setHashMode() on a non-empty table.
+  int64_t numHashModeChanges_{0};
+  // Counts the setHashMode(kNormalizedKey) calls on a non-empty table and the
+  // rows inserted again on these.
+  int64_t numNormalizedKeyChanges_{0};
+  int64_t numNormalizedKeyChangeRows_{0};
+  // Number of rows looked up by groupProbe() in any mode.
+  int64_t numGroupProbeRows_{0};
+  // Number of rows looked up by groupProbe() in kHash and kNormalizedKey
+  // modes and the tag groups after the first these went through.
+  int64_t numHashProbes_{0};
+  int64_t numExtraProbeGroups_{0};
+  // Set if normalizedKeyModeTooCostly() made the table switch to kHash.
+  bool hashModeFallback_{false};
   HashMode hashMode_ = HashMode::kArray;
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
@@ -692,6 +802,10 @@ class HashTable : public BaseHashTable {
   // of cache line  size.
   raw_vector<int32_t> buildPartitionBounds_;
 
+  // The bits of the hash number that give the partition of a row in a
+  // parallel join build. These are the high bits of the table index.
+  HashBitRange buildPartitionBits_;
+
   // Executor for parallelizing hash join build. This may be the
   // executor for Drivers. If this executor is indefinitely taken by
   // other work, the thread of prepareJoinTables() will sequentially
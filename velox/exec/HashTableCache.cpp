@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/HashTableCache.h"
+
+namespace facebook::velox::exec {
+
+HashTableCache::Entry::Entry(
+    const std::shared_ptr<core::QueryCtx>& queryCtx,
+    const core::PlanNodeId& planNodeId,
+    const std::string& builderTaskId)
+    : queryCtx_(queryCtx),
+      builderTaskId_(builderTaskId),
+      pool_(queryCtx->pool()->addLeafChild(
+          fmt::format("hashTableCache.{}", planNodeId))) {}
+
+void HashTableCache::Entry::setHashTable(
+    std::unique_ptr<BaseHashTable> table,
+    bool hasNullKeys,
+    std::vector<std::shared_ptr<common::Filter>> dynamicFilters) {
+  VELOX_CHECK_NOT_NULL(table);
+  std::vector<std::shared_ptr<HashJoinBridge>> bridges;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!ready_);
+    ready_ = true;
+    // The bridges may release the table after this entry.
+    table_ = std::shared_ptr<BaseHashTable>(
+        table.release(),
+        [pool = pool_](BaseHashTable* table) { delete table; });
+    hasNullKeys_ = hasNullKeys;
+    dynamicFilters_ = std::move(dynamicFilters);
+    bridges.swap(pendingBridges_);
+  }
+  for (auto& bridge : bridges) {
+    setOnBridge(*bridge);
+  }
+}
+
+void HashTableCache::Entry::setAntiJoinHasNullKeys() {
+  std::vector<std::shared_ptr<HashJoinBridge>> bridges;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!ready_);
+    ready_ = true;
+    hasNullKeys_ = true;
+    bridges.swap(pendingBridges_);
+  }
+  for (auto& bridge : bridges) {
+    setOnBridge(*bridge);
+  }
+}
+
+void HashTableCache::Entry::attach(std::shared_ptr<HashJoinBridge> bridge) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!ready_) {
+      pendingBridges_.push_back(std::move(bridge));
+      return;
+    }
+  }
+  setOnBridge(*bridge);
+}
+
+void HashTableCache::Entry::setOnBridge(HashJoinBridge& bridge) {
+  // NOTE: the table and the filters don't change after 'ready_' is set.
+  if (table_ == nullptr) {
+    bridge.setAntiJoinHasNullKeys();
+  } else {
+    bridge.setHashTable(table_, {}, hasNullKeys_, dynamicFilters_);
+  }
+}
+
+// static
+HashTableCache* HashTableCache::instance() {
+  static HashTableCache cache;
+  return &cache;
+}
+
+std::shared_ptr<HashTableCache::Entry> HashTableCache::get(
+    const std::shared_ptr<core::QueryCtx>& queryCtx,
+    const core::PlanNodeId& planNodeId,
+    const std::string& taskId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second->expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto& entry = entries_[{queryCtx->queryId(), planNodeId}];
+  if (entry == nullptr || !entry->belongsTo(queryCtx)) {
+    entry = std::make_shared<Entry>(queryCtx, planNodeId, taskId);
+  }
+  return entry;
+}
+} // namespace facebook::velox::exec
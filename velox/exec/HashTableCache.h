@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <map>
+
+#include "velox/core/QueryCtx.h"
+#include "velox/exec/HashJoinBridge.h"
+
+namespace facebook::velox::exec {
+
+/// Shares the hash tables of broadcast joins among the tasks of the same query
+/// on a worker. All these tasks get the same build side input, so the first
+/// task to create a HashBuild operator for a join builds the table and the
+/// other tasks probe the same table instead of building their own copies. Only
+/// used for the joins with core::HashJoinNode::useHashTableCache() set.
+///
+/// The tables are kept as long as the QueryCtx of the query is alive, so that
+/// the tasks which start after the table is built can still use it.
+class HashTableCache {
+ public:
+  /// The shared table of one hash join of a query.
+  class Entry {
+   public:
+    Entry(
+        const std::shared_ptr<core::QueryCtx>& queryCtx,
+        const core::PlanNodeId& planNodeId,
+        const std::string& builderTaskId);
+
+    /// Returns true if the task 'taskId' builds the table.
+    bool isBuilder(const std::string& taskId) const {
+      return taskId == builderTaskId_;
+    }
+
+    /// Returns the memory pool for the table. This is owned by the entry so
+    /// that the table can outlive the task which builds it.
+    memory::MemoryPool* pool() const {
+      return pool_.get();
+    }
+
+    /// Invoked by the builder task after the table is built from 'pool()'.
+    /// Hands the table to the bridges attached so far. The table keeps
+    /// 'pool()' alive.
+    void setHashTable(
+        std::unique_ptr<BaseHashTable> table,
+        bool hasNullKeys,
+        std::vector<std::shared_ptr<common::Filter>> dynamicFilters);
+
+    /// Invoked by the builder task instead of setHashTable() if the build side
+    /// of a null-aware anti join has a null join key.
+    void setAntiJoinHasNullKeys();
+
+    /// Invoked once by each task, including the builder task, to get the
+    /// table through 'bridge'. The table is set on 'bridge' right away if it
+    /// is built, otherwise when the builder task sets it.
+    void attach(std::shared_ptr<HashJoinBridge> bridge);
+
+    /// Returns true if the query of this entry has finished.
+    bool expired() const {
+      return queryCtx_.expired();
+    }
+
+    /// Returns true if this entry belongs to 'queryCtx'.
+    bool belongsTo(const std::shared_ptr<core::QueryCtx>& queryCtx) const {
+      return queryCtx_.lock() == queryCtx;
+    }
+
+   private:
+    // Sets the table or the null key result on 'bridge'.
+    void setOnBridge(HashJoinBridge& bridge);
+
+    const std::weak_ptr<core::QueryCtx> queryCtx_;
+    const std::string builderTaskId_;
+    const std::shared_ptr<memory::MemoryPool> pool_;
+
+    std::mutex mutex_;
+
+    // True once the builder task has set the table or the null key result.
+    bool ready_{false};
+
+    // The shared table. Null if the build side of a null-aware anti join has
+    // a null join key.
+    std::shared_ptr<BaseHashTable> table_;
+    bool hasNullKeys_{false};
+    std::vector<std::shared_ptr<common::Filter>> dynamicFilters_;
+
+    // The bridges attached before the table is built.
+    std::vector<std::shared_ptr<HashJoinBridge>> pendingBridges_;
+  };
+
+  static HashTableCache* instance();
+
+  /// Returns the entry for the hash join 'planNodeId' of the query of
+  /// 'queryCtx'. Creates the entry with task 'taskId' as the builder if there
+  /// is none. Drops the entries of the finished queries.
+  std::shared_ptr<Entry> get(
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      const core::PlanNodeId& planNodeId,
+      const std::string& taskId);
+
+  /// Returns the number of cached entries. Used for testing.
+  size_t size() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+
+  // Keyed on query id and plan node id.
+  std::map<std::pair<std::string, core::PlanNodeId>, std::shared_ptr<Entry>>
+      entries_;
+};
+} // namespace facebook::velox::exec
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/InputCapture.h"
+
+#include <folly/String.h>
+#include <folly/json.h>
+
+#include "velox/common/base/Fs.h"
+#include "velox/exec/Task.h"
+#include "velox/vector/VectorSaver.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+bool isCaptured(const std::string& planNodeIds, const core::PlanNodeId& id) {
+  std::vector<folly::StringPiece> ids;
+  folly::split(',', planNodeIds, ids);
+  for (auto captured : ids) {
+    if (folly::trimWhitespace(captured) == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the filter under 'node' if 'node' is a project over a filter. The
+// LocalPlanner makes one FilterProject operator with the id of the project
+// for both.
+const core::FilterNode* fusedFilter(const core::PlanNode& node) {
+  if (!dynamic_cast<const core::ProjectNode*>(&node)) {
+    return nullptr;
+  }
+  return dynamic_cast<const core::FilterNode*>(node.sources()[0].get());
+}
+} // namespace
+
+// static
+std::unique_ptr<InputCapture> InputCapture::create(
+    const DriverCtx& driverCtx,
+    const core::PlanNodeId& planNodeId) {
+  const auto& config = driverCtx.queryConfig();
+  const auto baseDirectory = config.inputCaptureDir();
+  if (baseDirectory.empty()) {
+    return nullptr;
+  }
+  const auto& task = driverCtx.task;
+  const auto* planNode = core::PlanNode::findFirstNode(
+      task->planFragment().planNode.get(),
+      [&](const core::PlanNode* node) { return node->id() == planNodeId; });
+  // Operators of plan nodes with multiple sources, e.g. the build and probe
+  // of a join, would capture their inputs together.
+  if (planNode == nullptr || planNode->sources().size() != 1) {
+    return nullptr;
+  }
+  const auto ids = config.inputCapturePlanNodeIds();
+  const auto* filter = fusedFilter(*planNode);
+  if (!isCaptured(ids, planNodeId) &&
+      !(filter && isCaptured(ids, filter->id()))) {
+    return nullptr;
+  }
+  auto path = directory(baseDirectory, task->taskId(), planNodeId);
+  try {
+    // Serializes in all drivers so that none captures input that can't be
+    // replayed.
+    auto serialized = folly::toJson(planNode->serialize());
+    VELOX_CHECK(
+        common::generateFileDirectory(path.c_str()),
+        "Failed to create directory {}",
+        path);
+    if (driverCtx.driverId == 0) {
+      saveStringToFile(
+          serialized, fmt::format("{}/{}", path, kPlanFileName).c_str());
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Not capturing the input of plan node " << planNodeId
+                 << ": " << e.what();
+    return nullptr;
+  }
+  return std::make_unique<InputCapture>(
+      std::move(path),
+      driverCtx.driverId,
+      config.inputCaptureSamplePct(),
+      config.inputCaptureMaxBytes());
+}
+
+InputCapture::InputCapture(
+    std::string directory,
+    int32_t driverId,
+    int32_t samplePct,
+    uint64_t maxBytes)
+    : directory_(std::move(directory)),
+      driverId_(driverId),
+      samplePct_(std::clamp(samplePct, 0, 100)),
+      maxBytes_(maxBytes) {}
+
+// static
+std::string InputCapture::directory(
+    const std::string& baseDirectory,
+    const std::string& taskId,
+    const core::PlanNodeId& planNodeId) {
+  return fmt::format("{}/{}/{}", baseDirectory, taskId, planNodeId);
+}
+
+void InputCapture::capture(const RowVector& input) {
+  if (done_) {
+    return;
+  }
+  const auto batch = numBatches_++;
+  if (batch * samplePct_ % 100 >= samplePct_) {
+    return;
+  }
+  try {
+    std::ostringstream out;
+    saveVector(input, out);
+    auto serialized = out.str();
+    if (capturedBytes_ + serialized.size() > maxBytes_) {
+      done_ = true;
+      return;
+    }
+    saveStringToFile(
+        serialized,
+        fmt::format(
+            "{}/{}{}_{}", directory_, kInputFilePrefix, driverId_, batch)
+            .c_str());
+    capturedBytes_ += serialized.size();
+    ++numCaptured_;
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Stopped capturing input to " << directory_ << ": "
+                 << e.what();
+    done_ = true;
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+struct DriverCtx;
+
+/// Saves the input batches of an operator together with its plan node, so
+/// that the plan node can be re-executed offline over the same input, e.g.
+/// under a profiler, by InputReplayer. Enabled per query for the plan nodes
+/// listed in QueryConfig::kInputCapturePlanNodeIds that have one source.
+///
+/// The files of a plan node are in '{kInputCaptureDir}/{taskId}/{planNodeId}'.
+/// 'plan' holds the plan node serialized to JSON and each
+/// 'input_{driverId}_{sequence}' holds one batch written by saveVector(). A
+/// filter with a project over it runs as one operator, which is captured
+/// under the id of the project if either id is listed.
+///
+/// Capture is best effort: an error in writing the files is logged and stops
+/// the capture for the operator without failing the query.
+class InputCapture {
+ public:
+  static constexpr const char* kPlanFileName = "plan";
+  static constexpr const char* kInputFilePrefix = "input_";
+
+  /// Returns an InputCapture for the operator of 'planNodeId' in the driver
+  /// of 'driverCtx' or nullptr if the input of the plan node is not captured.
+  /// The first driver of the pipeline writes the plan node.
+  static std::unique_ptr<InputCapture> create(
+      const DriverCtx& driverCtx,
+      const core::PlanNodeId& planNodeId);
+
+  /// Saves every batch out of 100 / 'samplePct' to 'directory' until the
+  /// saved batches would be over 'maxBytes'.
+  InputCapture(
+      std::string directory,
+      int32_t driverId,
+      int32_t samplePct,
+      uint64_t maxBytes);
+
+  /// Returns the directory of the captured files of 'planNodeId' in 'taskId'
+  /// under 'baseDirectory'.
+  static std::string directory(
+      const std::string& baseDirectory,
+      const std::string& taskId,
+      const core::PlanNodeId& planNodeId);
+
+  /// Saves 'input' if it is in the sample and within the byte budget. The
+  /// sample is deterministic: batch 'n' of the operator is saved if
+  /// 'n * samplePct % 100 < samplePct'.
+  void capture(const RowVector& input);
+
+  int32_t numCaptured() const {
+    return numCaptured_;
+  }
+
+  uint64_t capturedBytes() const {
+    return capturedBytes_;
+  }
+
+ private:
+  const std::string directory_;
+  const int32_t driverId_;
+  const int32_t samplePct_;
+  const uint64_t maxBytes_;
+
+  // Number of batches seen by capture().
+  int64_t numBatches_{0};
+  int32_t numCaptured_{0};
+  uint64_t capturedBytes_{0};
+  // Set when a batch does not fit in 'maxBytes_' or a write fails.
+  bool done_{false};
+};
+
+} // namespace facebook::velox::exec
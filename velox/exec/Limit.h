@@ -38,6 +38,12 @@ class Limit : public Operator {
     return finished_ || (noMoreInput_ && input_ == nullptr);
   }
 
+  /// Returns the number of further input rows after which 'this' is
+  /// finished.
+  int64_t maxInputRows() const {
+    return static_cast<int64_t>(remainingOffset_) + remainingLimit_;
+  }
+
  private:
   int32_t remainingOffset_;
   int32_t remainingLimit_;
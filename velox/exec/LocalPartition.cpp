@@ -55,6 +55,11 @@ std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
   return promises;
 }
 
+bool LocalExchangeMemoryManager::isHalfFull() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return bufferedBytes_ >= maxBufferSize_ / 2;
+}
+
 void LocalExchangeQueue::addProducer() {
   queue_.withWLock([&](auto& /*queue*/) {
     VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
@@ -84,15 +89,14 @@ void LocalExchangeQueue::noMoreProducers() {
 
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
+    int64_t inputBytes,
     ContinueFuture* future) {
-  auto inputBytes = input->retainedSize();
-
   std::vector<ContinuePromise> consumerPromises;
   bool isClosed = queue_.withWLock([&](auto& queue) {
     if (closed_) {
       return true;
     }
-    queue.push(std::move(input));
+    queue.emplace(std::move(input), inputBytes);
     consumerPromises = std::move(consumerPromises_);
     return false;
   });
@@ -146,12 +150,10 @@ BlockingReason LocalExchangeQueue::next(
       return BlockingReason::kWaitForProducer;
     }
 
-    *data = queue.front();
+    *data = std::move(queue.front().first);
+    memoryPromises = memoryManager_->decreaseMemoryUsage(queue.front().second);
     queue.pop();
 
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
-
     if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
       producerPromises = std::move(producerPromises_);
     }
@@ -164,7 +166,7 @@ BlockingReason LocalExchangeQueue::next(
 }
 
 bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
+    const std::queue<Entry>& queue) const {
   if (closed_) {
     return true;
   }
@@ -200,7 +202,7 @@ void LocalExchangeQueue::close() {
   queue_.withWLock([&](auto& queue) {
     uint64_t freedBytes = 0;
     while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
+      freedBytes += queue.front().second;
       queue.pop();
     }
 
@@ -217,6 +219,10 @@ void LocalExchangeQueue::close() {
   notify(memoryPromises);
 }
 
+bool LocalExchangeQueue::isClosed() {
+  return queue_.withWLock([&](auto& /*queue*/) { return closed_; });
+}
+
 LocalExchange::LocalExchange(
     int32_t operatorId,
     DriverCtx* ctx,
@@ -276,12 +282,20 @@ LocalPartition::LocalPartition(
       queues_{
           ctx->task->getLocalExchangeQueues(ctx->splitGroupId, planNode->id())},
       numPartitions_{queues_.size()},
+      scaleWriter_{planNode->scaleWriter()},
+      scaleWriterMinProcessedBytes_{
+          ctx->queryConfig().scaleWriterMinProcessedBytes()},
       partitionFunction_(
-          numPartitions_ == 1
+          numPartitions_ == 1 || scaleWriter_
               ? nullptr
               : planNode->partitionFunctionSpec().create(numPartitions_)),
+      minBatchRows_(ctx->queryConfig().localExchangeMinBatchRows()),
       blockingReasons_{numPartitions_} {
-  VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
+  VELOX_CHECK(
+      numPartitions_ == 1 || scaleWriter_ || partitionFunction_ != nullptr);
+  if (partitionFunction_ != nullptr && minBatchRows_ > 0) {
+    smallBatches_.resize(numPartitions_);
+  }
 
   for (auto& queue : queues_) {
     queue->addProducer();
@@ -339,12 +353,9 @@ void LocalPartition::addInput(RowVectorPtr input) {
   input_ = std::move(input);
 
   if (numPartitions_ == 1) {
-    ContinueFuture future;
-    auto blockingReason = queues_[0]->enqueue(input_, &future);
-    if (blockingReason != BlockingReason::kNotBlocked) {
-      blockingReasons_.push_back(blockingReason);
-      futures_.push_back(std::move(future));
-    }
+    enqueue(0, input_);
+  } else if (scaleWriter_) {
+    enqueue(nextWriter(input_), input_);
   } else {
     partitionFunction_->partition(*input_, partitions_);
 
@@ -366,19 +377,69 @@ void LocalPartition::addInput(RowVectorPtr input) {
         continue;
       }
       indexBuffers[i]->setSize(partitionSize * sizeof(vector_size_t));
-      auto partitionData =
-          wrapChildren(input_, partitionSize, std::move(indexBuffers[i]));
-
-      ContinueFuture future;
-      auto reason = queues_[i]->enqueue(partitionData, &future);
-      if (reason != BlockingReason::kNotBlocked) {
-        blockingReasons_.push_back(reason);
-        futures_.push_back(std::move(future));
-      }
+      addPartitionRows(i, partitionSize, std::move(indexBuffers[i]));
     }
   }
 }
 
+void LocalPartition::addPartitionRows(
+    int partition,
+    vector_size_t size,
+    BufferPtr indices) {
+  auto partitionData = wrapChildren(input_, size, std::move(indices));
+  if (smallBatches_.empty() || size >= minBatchRows_) {
+    // The views share the buffers of 'input_'. Each counts its share of these
+    // against the buffer size of the exchange.
+    enqueue(
+        partition,
+        partitionData,
+        (int64_t)input_->retainedSize() * size / input_->size());
+    return;
+  }
+  auto& batch = smallBatches_[partition];
+  if (batch == nullptr) {
+    batch = BaseVector::create<RowVector>(outputType_, 0, pool());
+  }
+  const auto numRows = batch->size();
+  batch->resize(numRows + size);
+  batch->copy(partitionData.get(), numRows, 0, size);
+  if (batch->size() >= minBatchRows_) {
+    enqueue(partition, batch);
+    batch = nullptr;
+  }
+}
+
+void LocalPartition::enqueue(int partition, const RowVectorPtr& data) {
+  enqueue(partition, data, data->retainedSize());
+}
+
+void LocalPartition::enqueue(
+    int partition,
+    const RowVectorPtr& data,
+    int64_t dataBytes) {
+  ContinueFuture future;
+  auto reason = queues_[partition]->enqueue(data, dataBytes, &future);
+  if (reason != BlockingReason::kNotBlocked) {
+    blockingReasons_.push_back(reason);
+    futures_.push_back(std::move(future));
+    blockedSinceScaleUp_ = true;
+  }
+}
+
+int LocalPartition::nextWriter(const RowVectorPtr& input) {
+  if (numWriters_ < numPartitions_ &&
+      processedBytes_ >= scaleWriterMinProcessedBytes_ &&
+      (blockedSinceScaleUp_ || queues_[0]->memoryManager()->isHalfFull())) {
+    ++numWriters_;
+    processedBytes_ = 0;
+    blockedSinceScaleUp_ = false;
+    addRuntimeStat("numScaledWriters", RuntimeCounter(1));
+  }
+  processedBytes_ += input->retainedSize();
+  lastWriter_ = (lastWriter_ + 1) % numWriters_;
+  return lastWriter_;
+}
+
 BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
   if (!futures_.empty()) {
     auto blockingReason = blockingReasons_.front();
@@ -393,16 +454,30 @@ BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
 
 void LocalPartition::noMoreInput() {
   Operator::noMoreInput();
+  for (auto i = 0; i < smallBatches_.size(); ++i) {
+    if (smallBatches_[i] != nullptr) {
+      enqueue(i, smallBatches_[i]);
+      smallBatches_[i] = nullptr;
+    }
+  }
   for (const auto& queue : queues_) {
     queue->noMoreData();
   }
 }
 
 bool LocalPartition::isFinished() {
-  if (!futures_.empty() || !noMoreInput_) {
+  if (!futures_.empty()) {
     return false;
   }
 
-  return true;
+  if (noMoreInput_) {
+    return true;
+  }
+
+  // The consumers need no more data, e.g. a Limit downstream has all its
+  // rows. Finishing lets the Driver close the operators upstream.
+  return std::all_of(queues_.begin(), queues_.end(), [](const auto& queue) {
+    return queue->isClosed();
+  });
 }
 } // namespace facebook::velox::exec
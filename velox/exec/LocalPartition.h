@@ -36,6 +36,10 @@ class LocalExchangeMemoryManager {
   /// caller to fulfill.
   std::vector<ContinuePromise> decreaseMemoryUsage(int64_t removed);
 
+  /// Returns true if at least half of the buffer limit is in use, i.e. the
+  /// consumers are not keeping up with the producers.
+  bool isHalfFull();
+
  private:
   const int64_t maxBufferSize_;
   std::mutex mutex_;
@@ -67,7 +71,16 @@ class LocalExchangeQueue {
   /// Used by a producer to add data. Returning kNotBlocked if can accept more
   /// data. Otherwise returns kWaitForConsumer and sets future that will be
   /// completed when ready to accept more data.
-  BlockingReason enqueue(RowVectorPtr input, ContinueFuture* future);
+  BlockingReason enqueue(RowVectorPtr input, ContinueFuture* future) {
+    auto inputBytes = input->retainedSize();
+    return enqueue(std::move(input), inputBytes, future);
+  }
+
+  /// Same as above but counts 'inputBytes' against the buffer size. Used for
+  /// views over inputs shared by several queues, of which each queue only
+  /// counts its part.
+  BlockingReason
+  enqueue(RowVectorPtr input, int64_t inputBytes, ContinueFuture* future);
 
   /// Called by a producer to indicate that no more data will be added.
   void noMoreData();
@@ -96,12 +109,22 @@ class LocalExchangeQueue {
   /// called before all the data has been processed. No-op otherwise.
   void close();
 
+  /// Returns true if the consumer closed the queue and takes no more data.
+  bool isClosed();
+
+  const std::shared_ptr<LocalExchangeMemoryManager>& memoryManager() const {
+    return memoryManager_;
+  }
+
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  // A queued vector and the bytes counted for it.
+  using Entry = std::pair<RowVectorPtr, int64_t>;
+
+  bool isFinishedLocked(const std::queue<Entry>& queue) const;
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+  folly::Synchronized<std::queue<Entry>> queue_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
   // and pendingProducers_ is zero.
@@ -153,7 +176,20 @@ class LocalExchange : public SourceOperator {
 };
 
 /// Hash partitions the data using specified keys. The number of partitions is
-/// determined by the number of LocalExchangeQueues(s) found in the task.
+/// determined by the number of LocalExchangeQueues(s) found in the task. The
+/// rows of a partition are sent as dictionaries over the input, so that the
+/// columns are not copied. The rows of a partition that has fewer than
+/// 'local_exchange_min_batch_rows' rows in an input are instead copied into a
+/// batch for the partition, which is sent when it has that many rows or when
+/// there is no more input.
+///
+/// For a writer scaling node, sends each input batch whole to one of the
+/// first 'numWriters_' queues in turn. Starts with one and takes one more
+/// queue when the table writers are slower than the upstream and at least
+/// 'scaleWriterMinProcessedBytes' were sent since the last scale up. The
+/// writers are slower if the queues are at least half full or if this
+/// producer was blocked on the full queues since the last scale up. Each
+/// producer scales on its own.
 class LocalPartition : public Operator {
  public:
   LocalPartition(
@@ -184,10 +220,38 @@ class LocalPartition : public Operator {
   bool isFinished() override;
 
  private:
+  void enqueue(int partition, const RowVectorPtr& data);
+
+  void enqueue(int partition, const RowVectorPtr& data, int64_t dataBytes);
+
+  // Adds 'size' rows of 'input_' at 'indices' to 'partition'. Sends them as
+  // a dictionary over 'input_' or adds them to 'smallBatches_'.
+  void addPartitionRows(int partition, vector_size_t size, BufferPtr indices);
+
+  // Returns the queue for the next input batch of a writer scaling node.
+  // Adds a writer first if these are behind.
+  int nextWriter(const RowVectorPtr& input);
+
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
+  const bool scaleWriter_;
+  const uint64_t scaleWriterMinProcessedBytes_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
 
+  // The number of queues a writer scaling node sends to, the bytes sent since
+  // the last scale up, whether the queues were full since then and the queue
+  // of the last input batch.
+  int numWriters_{1};
+  uint64_t processedBytes_{0};
+  bool blockedSinceScaleUp_{false};
+  int lastWriter_{0};
+
+  const vector_size_t minBatchRows_;
+
+  // Per partition, the rows copied from inputs with few rows for the
+  // partition. nullptr if there are none.
+  std::vector<RowVectorPtr> smallBatches_;
+
   std::vector<BlockingReason> blockingReasons_;
   std::vector<ContinueFuture> futures_;
 
@@ -15,8 +15,10 @@
  */
 #include "velox/exec/LocalPlanner.h"
 #include "velox/core/PlanFragment.h"
+#include "velox/exec/Aggregate.h"
 #include "velox/exec/ArrowStream.h"
 #include "velox/exec/AssignUniqueId.h"
+#include "velox/exec/BatchCoalescer.h"
 #include "velox/exec/CallbackSink.h"
 #include "velox/exec/CrossJoinBuild.h"
 #include "velox/exec/CrossJoinProbe.h"
@@ -24,6 +26,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/Expand.h"
 #include "velox/exec/FilterProject.h"
+#include "velox/exec/GlobalRowNumber.h"
 #include "velox/exec/GroupId.h"
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/HashBuild.h"
@@ -37,6 +40,7 @@
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
 #include "velox/exec/TopN.h"
+#include "velox/exec/TopNRowNumber.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/ValueStream.h"
 #include "velox/exec/Values.h"
@@ -128,12 +132,210 @@ OperatorSupplier makeConsumerSupplier(
   return Operator::operatorSupplierFromPlanNode(planNode);
 }
 
+/// Returns 'aggregation' over a GroupId rewritten as a partial aggregation of
+/// the input of the GroupId on all its grouping keys, followed by the GroupId
+/// over the partial results and an aggregation of these, or nullptr if the
+/// aggregates cannot be computed this way. The aggregation of each grouping
+/// set then merges the partial results of the finest set instead of
+/// aggregating the replicated input rows.
+core::PlanNodePtr makeGroupingSetsPreAggregation(
+    const core::AggregationNode& aggregation) {
+  using Step = core::AggregationNode::Step;
+  const auto step = aggregation.step();
+  if ((step != Step::kSingle && step != Step::kPartial) ||
+      aggregation.hasDistinctAggregates() ||
+      aggregation.hasSortedAggregates() ||
+      !aggregation.preGroupedKeys().empty()) {
+    return nullptr;
+  }
+  auto groupId = std::dynamic_pointer_cast<const core::GroupIdNode>(
+      aggregation.sources()[0]);
+  if (!groupId) {
+    return nullptr;
+  }
+
+  // The output of the GroupId has the grouping keys, then the aggregation
+  // inputs, then the grouping set id. The aggregation inputs are the same in
+  // all grouping sets, so the aggregates and masks may only read these.
+  const auto& groupIdType = groupId->outputType();
+  const auto isAggregationInput = [&](const core::FieldAccessTypedExpr& field) {
+    const auto channel = groupIdType->getChildIdxIfExists(field.name());
+    return field.isInputColumn() && channel.has_value() &&
+        channel.value() >= groupId->numGroupingKeys() &&
+        channel.value() + 1 < groupIdType->size();
+  };
+  for (const auto& key : aggregation.groupingKeys()) {
+    if (isAggregationInput(*key)) {
+      return nullptr;
+    }
+  }
+  for (const auto& mask : aggregation.aggregateMasks()) {
+    if (mask && !isAggregationInput(*mask)) {
+      return nullptr;
+    }
+  }
+
+  std::vector<core::FieldAccessTypedExprPtr> preGroupingKeys;
+  std::unordered_set<std::string> preGroupingKeyNames;
+  for (const auto& info : groupId->groupingKeyInfos()) {
+    if (preGroupingKeyNames.insert(info.input->name()).second) {
+      preGroupingKeys.push_back(info.input);
+    }
+  }
+
+  const auto& aggregateNames = aggregation.aggregateNames();
+  std::vector<core::CallTypedExprPtr> preAggregates;
+  std::vector<core::FieldAccessTypedExprPtr> partialResults;
+  std::vector<core::CallTypedExprPtr> aggregates;
+  for (auto i = 0; i < aggregateNames.size(); ++i) {
+    const auto& aggregate = aggregation.aggregates()[i];
+    // The partial results keep the names of the aggregates.
+    if (preGroupingKeyNames.count(aggregateNames[i])) {
+      return nullptr;
+    }
+    std::vector<TypePtr> argTypes;
+    for (const auto& arg : aggregate->inputs()) {
+      auto field =
+          std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(arg);
+      if (field ? !isAggregationInput(*field)
+                : !std::dynamic_pointer_cast<const core::ConstantTypedExpr>(
+                      arg)) {
+        return nullptr;
+      }
+      argTypes.push_back(arg->type());
+    }
+    const auto intermediateType =
+        Aggregate::intermediateType(aggregate->name(), argTypes);
+    preAggregates.push_back(std::make_shared<core::CallTypedExpr>(
+        intermediateType, aggregate->inputs(), aggregate->name()));
+    partialResults.push_back(std::make_shared<core::FieldAccessTypedExpr>(
+        intermediateType, aggregateNames[i]));
+    aggregates.push_back(std::make_shared<core::CallTypedExpr>(
+        aggregate->type(),
+        std::vector<core::TypedExprPtr>{partialResults.back()},
+        aggregate->name()));
+  }
+
+  auto preAggregation = std::make_shared<core::AggregationNode>(
+      fmt::format("{}.pre", aggregation.id()),
+      Step::kPartial,
+      preGroupingKeys,
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregateNames,
+      preAggregates,
+      aggregation.aggregateMasks(),
+      false,
+      groupId->sources()[0]);
+  auto replicated = std::make_shared<core::GroupIdNode>(
+      groupId->id(),
+      groupId->groupingSets(),
+      groupId->groupingKeyInfos(),
+      partialResults,
+      groupIdType->names().back(),
+      preAggregation);
+  // Keeps the id of the original aggregation, so that its stats are reported
+  // for the plan node.
+  return std::make_shared<core::AggregationNode>(
+      aggregation.id(),
+      step == Step::kSingle ? Step::kFinal : Step::kIntermediate,
+      aggregation.groupingKeys(),
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregateNames,
+      aggregates,
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregation.ignoreNullKeys(),
+      replicated);
+}
+
 void plan(
     const std::shared_ptr<const core::PlanNode>& planNode,
     std::vector<std::shared_ptr<const core::PlanNode>>* currentPlanNodes,
     const std::shared_ptr<const core::PlanNode>& consumerNode,
     OperatorSupplier consumerSupplier,
-    std::vector<std::unique_ptr<DriverFactory>>* driverFactories) {
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    bool parallelOrderBy,
+    bool preAggregateGroupingSets,
+    bool pushdownScanFilters) {
+  if (pushdownScanFilters) {
+    if (auto filter =
+            std::dynamic_pointer_cast<const core::FilterNode>(planNode)) {
+      if (auto scan = std::dynamic_pointer_cast<const core::TableScanNode>(
+              filter->sources()[0])) {
+        auto tableHandle =
+            connector::getConnector(scan->tableHandle()->connectorId())
+                ->pushdownFilter(
+                    scan->tableHandle(), scan->assignments(), filter->filter());
+        if (tableHandle != nullptr) {
+          // The filter is evaluated by the DataSource on the rows the reader
+          // produces. The scan keeps its id, so that it gets the same splits.
+          auto filteredScan = std::make_shared<core::TableScanNode>(
+              scan->id(), scan->outputType(), tableHandle, scan->assignments());
+          plan(
+              filteredScan,
+              currentPlanNodes,
+              consumerNode,
+              consumerSupplier,
+              driverFactories,
+              parallelOrderBy,
+              preAggregateGroupingSets,
+              pushdownScanFilters);
+          return;
+        }
+      }
+    }
+  }
+
+  if (preAggregateGroupingSets) {
+    if (auto aggregation =
+            std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
+      if (auto preAggregated = makeGroupingSetsPreAggregation(*aggregation)) {
+        plan(
+            preAggregated,
+            currentPlanNodes,
+            consumerNode,
+            consumerSupplier,
+            driverFactories,
+            parallelOrderBy,
+            preAggregateGroupingSets,
+            pushdownScanFilters);
+        return;
+      }
+    }
+  }
+
+  if (parallelOrderBy) {
+    if (auto orderBy =
+            std::dynamic_pointer_cast<const core::OrderByNode>(planNode)) {
+      if (!orderBy->isPartial()) {
+        // Plans the final OrderBy as a partial OrderBy in each driver of the
+        // source pipeline, followed by a LocalMerge of the sorted runs. The
+        // partial OrderBy keeps the id of the final one, so that its stats
+        // are reported for the plan node.
+        auto partialOrderBy = std::make_shared<core::OrderByNode>(
+            orderBy->id(),
+            orderBy->sortingKeys(),
+            orderBy->sortingOrders(),
+            true,
+            orderBy->sources()[0]);
+        auto localMerge = std::make_shared<core::LocalMergeNode>(
+            fmt::format("{}.merge", orderBy->id()),
+            orderBy->sortingKeys(),
+            orderBy->sortingOrders(),
+            std::vector<core::PlanNodePtr>{partialOrderBy});
+        plan(
+            localMerge,
+            currentPlanNodes,
+            consumerNode,
+            consumerSupplier,
+            driverFactories,
+            parallelOrderBy,
+            preAggregateGroupingSets,
+            pushdownScanFilters);
+        return;
+      }
+    }
+  }
+
   if (!currentPlanNodes) {
     driverFactories->push_back(std::make_unique<DriverFactory>());
     currentPlanNodes = &driverFactories->back()->planNodes;
@@ -151,7 +353,10 @@ void plan(
           mustStartNewPipeline(planNode, i) ? nullptr : currentPlanNodes,
           planNode,
           makeConsumerSupplier(planNode),
-          driverFactories);
+          driverFactories,
+          parallelOrderBy,
+          preAggregateGroupingSets,
+          pushdownScanFilters);
     }
   }
 
@@ -204,6 +409,20 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
       if (!orderBy->isPartial()) {
         return 1;
       }
+    } else if (
+        auto window = std::dynamic_pointer_cast<const core::WindowNode>(node)) {
+      // Window without partition keys processes all rows as a single
+      // partition, so must run single-threaded.
+      if (window->partitionKeys().empty()) {
+        return 1;
+      }
+    } else if (
+        auto topNRowNumber =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(node)) {
+      // Same as Window, without partition keys all rows are in one partition.
+      if (topNRowNumber->partitionKeys().empty()) {
+        return 1;
+      }
     } else if (
         auto localExchange =
             std::dynamic_pointer_cast<const core::LocalPartitionNode>(node)) {
@@ -252,13 +471,23 @@ void LocalPlanner::plan(
     const core::PlanFragment& planFragment,
     ConsumerSupplier consumerSupplier,
     std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    const core::QueryConfig& queryConfig,
     uint32_t maxDrivers) {
+  // The pipelines of a LocalMerge are not matched to the sources of a
+  // LocalPartition when determining the grouped execution pipelines, so a
+  // final OrderBy is only parallelized in ungrouped execution.
+  const bool parallelOrderBy = maxDrivers > 1 &&
+      !planFragment.isGroupedExecution() &&
+      queryConfig.parallelOrderByEnabled();
   detail::plan(
       planFragment.planNode,
       nullptr,
       nullptr,
       detail::makeConsumerSupplier(consumerSupplier),
-      driverFactories);
+      driverFactories,
+      parallelOrderBy,
+      queryConfig.groupingSetsPreAggregationEnabled(),
+      queryConfig.scanFilterPushdownEnabled());
 
   (*driverFactories)[0]->outputDriver = true;
 
@@ -374,6 +603,15 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
   std::vector<std::unique_ptr<Operator>> operators;
   operators.reserve(planNodes.size());
 
+  // Follows a selective operator with a BatchCoalescer if enabled.
+  const bool coalesceBatches = ctx->queryConfig().coalesceBatchesEnabled();
+  auto addBatchCoalescer = [&](const core::PlanNodePtr& planNode) {
+    if (coalesceBatches) {
+      operators.push_back(std::make_unique<BatchCoalescer>(
+          operators.size(), ctx.get(), planNode->outputType(), planNode->id()));
+    }
+  };
+
   for (int32_t i = 0; i < planNodes.size(); i++) {
     // Id of the Operator being made. This is not the same as 'i'
     // because some PlanNodes may get fused.
@@ -387,12 +625,14 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
                 std::dynamic_pointer_cast<const core::ProjectNode>(next)) {
           operators.push_back(std::make_unique<FilterProject>(
               id, ctx.get(), filterNode, projectNode));
+          addBatchCoalescer(projectNode);
           i++;
           continue;
         }
       }
       operators.push_back(
           std::make_unique<FilterProject>(id, ctx.get(), filterNode, nullptr));
+      addBatchCoalescer(filterNode);
     } else if (
         auto projectNode =
             std::dynamic_pointer_cast<const core::ProjectNode>(planNode)) {
@@ -445,6 +685,7 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto joinNode =
             std::dynamic_pointer_cast<const core::HashJoinNode>(planNode)) {
       operators.push_back(std::make_unique<HashProbe>(id, ctx.get(), joinNode));
+      addBatchCoalescer(joinNode);
     } else if (
         auto joinNode =
             std::dynamic_pointer_cast<const core::NestedLoopJoinNode>(
@@ -456,7 +697,9 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
             std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
       if (!aggregationNode->preGroupedKeys().empty() &&
           aggregationNode->preGroupedKeys().size() ==
-              aggregationNode->groupingKeys().size()) {
+              aggregationNode->groupingKeys().size() &&
+          !aggregationNode->hasDistinctAggregates() &&
+          !aggregationNode->hasSortedAggregates()) {
         operators.push_back(std::make_unique<StreamingAggregation>(
             id, ctx.get(), aggregationNode));
       } else {
@@ -489,6 +732,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto windowNode =
             std::dynamic_pointer_cast<const core::WindowNode>(planNode)) {
       operators.push_back(std::make_unique<Window>(id, ctx.get(), windowNode));
+    } else if (
+        auto topNRowNumberNode =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(
+                planNode)) {
+      operators.push_back(
+          std::make_unique<TopNRowNumber>(id, ctx.get(), topNRowNumberNode));
     } else if (
         auto localMerge =
             std::dynamic_pointer_cast<const core::LocalMergeNode>(planNode)) {
@@ -531,6 +780,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
           assignUniqueIdNode,
           assignUniqueIdNode->taskUniqueId(),
           assignUniqueIdNode->uniqueIdCounter()));
+    } else if (
+        auto globalRowNumberNode =
+            std::dynamic_pointer_cast<const core::GlobalRowNumberNode>(
+                planNode)) {
+      operators.push_back(std::make_unique<GlobalRowNumber>(
+          id, ctx.get(), globalRowNumberNode));
     } else {
       std::unique_ptr<Operator> extended;
       if (planNode->requiresExchangeClient()) {
@@ -550,7 +805,9 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     operators.push_back(consumerSupplier(operators.size(), ctx.get()));
   }
 
-  return std::make_shared<Driver>(std::move(ctx), std::move(operators));
+  auto driver = std::make_shared<Driver>(std::move(ctx), std::move(operators));
+  driver->initializeOperatorReclaimers();
+  return driver;
 }
 
 std::vector<core::PlanNodeId> DriverFactory::needsHashJoinBridges() const {
@@ -180,7 +180,17 @@ void Merge::close() {
 
 bool SourceStream::operator<(const MergeStream& other) const {
   const auto& otherCursor = static_cast<const SourceStream&>(other);
-  for (auto i = 0; i < sortingKeys_.size(); ++i) {
+  auto firstKey = 0;
+  if (!normalizedKeys_.empty() && !otherCursor.normalizedKeys_.empty()) {
+    const auto left = normalizedKeys_[currentSourceRow_];
+    const auto right =
+        otherCursor.normalizedKeys_[otherCursor.currentSourceRow_];
+    if (left != right) {
+      return left < right;
+    }
+    firstKey = 1;
+  }
+  for (auto i = firstKey; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
         !compareFlags.stopAtNull,
@@ -255,10 +265,64 @@ bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
     for (const auto& key : sortingKeys_) {
       keyColumns_.push_back(data_->childAt(key.first).get());
     }
+    makeNormalizedKeys();
   }
   return false;
 }
 
+namespace {
+template <typename T>
+void normalizeKeys(
+    const DecodedVector& decoded,
+    bool ascending,
+    std::vector<uint64_t>& keys) {
+  // Flipping the sign bit makes the unsigned order the signed order.
+  constexpr uint64_t kSignBit = 1ULL << 63;
+  const uint64_t mask = ascending ? 0 : ~0ULL;
+  for (auto i = 0; i < keys.size(); ++i) {
+    const auto value = static_cast<int64_t>(decoded.valueAt<T>(i));
+    keys[i] = (static_cast<uint64_t>(value) ^ kSignBit) ^ mask;
+  }
+}
+} // namespace
+
+void SourceStream::makeNormalizedKeys() {
+  normalizedKeys_.clear();
+  const auto* key = keyColumns_[0];
+  switch (key->typeKind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      break;
+    default:
+      return;
+  }
+  const SelectivityVector rows(data_->size());
+  DecodedVector decoded(*key, rows);
+  if (decoded.mayHaveNulls()) {
+    return;
+  }
+  normalizedKeys_.resize(data_->size());
+  const bool ascending = sortingKeys_[0].second.ascending;
+  switch (key->typeKind()) {
+    case TypeKind::TINYINT:
+      normalizeKeys<int8_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::SMALLINT:
+      normalizeKeys<int16_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::INTEGER:
+      normalizeKeys<int32_t>(decoded, ascending, normalizedKeys_);
+      break;
+    case TypeKind::BIGINT:
+      normalizeKeys<int64_t>(decoded, ascending, normalizedKeys_);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 LocalMerge::LocalMerge(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -296,7 +360,8 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(shuffleSerdeOptions(driverCtx->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
@@ -320,11 +385,13 @@ BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
             operatorCtx_->planNodeId(),
             operatorCtx_->driverCtx()->pipelineId,
             numSplits_);
+        auto* queryCtx = operatorCtx_->task()->queryCtx().get();
         sources_.emplace_back(MergeSource::createMergeExchangeSource(
             this,
             remoteSplit->taskId,
             operatorCtx_->task()->destination(),
-            pool));
+            pool,
+            queryCtx->isExecutorSupplied() ? queryCtx->executor() : nullptr));
         ++numSplits_;
       } else {
         noMoreSplits_ = true;
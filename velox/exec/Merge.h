@@ -136,6 +136,10 @@ class SourceStream final : public MergeStream {
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  /// Sets 'normalizedKeys_' if the first sorting key of 'data_' is an integer
+  /// without nulls.
+  void makeNormalizedKeys();
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
@@ -147,6 +151,12 @@ class SourceStream final : public MergeStream {
   /// order as 'sortingKeys_'.
   std::vector<BaseVector*> keyColumns_;
 
+  /// The first sorting key of each row of 'data_' as an unsigned integer
+  /// that compares in the sort order of the key, so that most comparisons
+  /// do not go through BaseVector::compare(). Empty if the key can't be
+  /// normalized.
+  std::vector<uint64_t> normalizedKeys_;
+
   /// Index of the current row.
   vector_size_t currentSourceRow_{0};
 
@@ -191,10 +201,16 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  /// Options for deserializing the pages of the sources.
+  const VectorSerde::Options& serdeOptions() const {
+    return serdeOptions_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const VectorSerde::Options serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
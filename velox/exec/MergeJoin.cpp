@@ -32,7 +32,14 @@ MergeJoin::MergeJoin(
           "MergeJoin"),
       outputBatchSize_{outputBatchRows()},
       joinType_{joinNode->joinType()},
-      numKeys_{joinNode->leftKeys().size()} {
+      numKeys_{joinNode->leftKeys().size()},
+      spillMemoryThreshold_{
+          driverCtx->queryConfig().mergeJoinSpillMemoryThreshold()},
+      spillConfig_{
+          joinNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kMergeJoin)
+              : std::nullopt},
+      rightType_{joinNode->sources()[1]->outputType()} {
   VELOX_USER_CHECK(
       joinNode->isInnerJoin() || joinNode->isLeftJoin(),
       "Merge join supports only inner and left joins. Other join types are not supported yet.");
@@ -45,7 +52,7 @@ MergeJoin::MergeJoin(
     leftKeys_.push_back(leftType->getChildIdx(key->name()));
   }
 
-  auto rightType = joinNode->sources()[1]->outputType();
+  const auto& rightType = rightType_;
   for (auto& key : joinNode->rightKeys()) {
     rightKeys_.push_back(rightType->getChildIdx(key->name()));
   }
@@ -193,6 +200,103 @@ bool MergeJoin::findEndOfMatch(
   return true;
 }
 
+namespace {
+// Writes rows [begin, end) of 'input' to 'spill'. Returns the number of rows
+// written.
+vector_size_t spillRows(
+    SpillFileList& spill,
+    const RowVectorPtr& input,
+    vector_size_t begin,
+    vector_size_t end) {
+  IndexRange range{begin, end - begin};
+  spill.write(input, folly::Range<IndexRange*>(&range, 1));
+  return end - begin;
+}
+} // namespace
+
+void MergeJoin::maybeSpillRightMatch() {
+  if (!spillConfig_.has_value() || spillMemoryThreshold_ == 0) {
+    return;
+  }
+  auto& match = rightMatch_.value();
+  VELOX_CHECK(!match.complete);
+  if (rightMatchSpill_ == nullptr) {
+    uint64_t numBytes = 0;
+    for (const auto& input : match.inputs) {
+      numBytes += input->retainedSize();
+    }
+    if (numBytes <= spillMemoryThreshold_) {
+      return;
+    }
+    rightMatchSpill_ = std::make_unique<SpillFileList>(
+        rightType_,
+        0,
+        std::vector<CompareFlags>{},
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        *pool(),
+        spillConfig_->fileOptions);
+    numRightMatchSpilledRows_ = spillRows(
+        *rightMatchSpill_,
+        match.inputs[0],
+        match.startIndex,
+        match.inputs[0]->size());
+    for (auto i = 1; i < match.inputs.size(); ++i) {
+      numRightMatchSpilledRows_ += spillRows(
+          *rightMatchSpill_, match.inputs[i], 0, match.inputs[i]->size());
+    }
+  } else {
+    // The first batch has been spilled before and is only kept to compare
+    // keys with.
+    VELOX_CHECK_EQ(match.inputs.size(), 2);
+    numRightMatchSpilledRows_ += spillRows(
+        *rightMatchSpill_, match.inputs[1], 0, match.inputs[1]->size());
+  }
+  match.inputs = {match.inputs.back()};
+  match.startIndex = 0;
+}
+
+void MergeJoin::finishRightMatchSpill() {
+  auto& match = rightMatch_.value();
+  VELOX_CHECK(match.complete);
+  // The first batch has been spilled. If there is a second one, it is the
+  // last batch of the match, which ends at 'endIndex'.
+  VELOX_CHECK_LE(match.inputs.size(), 2);
+  if (match.inputs.size() == 2) {
+    numRightMatchSpilledRows_ += spillRows(
+        *rightMatchSpill_, match.inputs[1], 0, match.endIndex);
+  }
+  rightMatchSpill_->finishFile();
+  {
+    auto lockedStats = stats_.wlock();
+    lockedStats->spilledBytes += rightMatchSpill_->spilledBytes();
+    lockedStats->spilledRows += numRightMatchSpilledRows_;
+    lockedStats->spilledFiles += rightMatchSpill_->spilledFiles();
+    ++lockedStats->spilledPartitions;
+  }
+  rightMatchFiles_ = rightMatchSpill_->files();
+  rightMatchSpill_.reset();
+  rightMatchFileIndex_ = 0;
+  rightMatchFiles_[0]->startRead();
+  VELOX_CHECK(nextSpilledRightMatch());
+}
+
+bool MergeJoin::nextSpilledRightMatch() {
+  while (rightMatchFileIndex_ < rightMatchFiles_.size()) {
+    RowVectorPtr batch;
+    if (rightMatchFiles_[rightMatchFileIndex_]->nextBatch(batch)) {
+      const auto numRows = batch->size();
+      rightMatch_ = Match{{std::move(batch)}, 0, numRows, true, std::nullopt};
+      return true;
+    }
+    if (++rightMatchFileIndex_ < rightMatchFiles_.size()) {
+      rightMatchFiles_[rightMatchFileIndex_]->startRead();
+    }
+  }
+  rightMatchFiles_.clear();
+  return false;
+}
+
 namespace {
 void copyRow(
     const RowVectorPtr& source,
@@ -302,50 +406,59 @@ void MergeJoin::prepareOutput() {
 bool MergeJoin::addToOutput() {
   prepareOutput();
 
-  size_t firstLeftBatch;
-  vector_size_t leftStartIndex;
-  if (leftMatch_->cursor) {
-    firstLeftBatch = leftMatch_->cursor->batchIndex;
-    leftStartIndex = leftMatch_->cursor->index;
-  } else {
-    firstLeftBatch = 0;
-    leftStartIndex = leftMatch_->startIndex;
-  }
-
-  size_t numLefts = leftMatch_->inputs.size();
-  for (size_t l = firstLeftBatch; l < numLefts; ++l) {
-    auto left = leftMatch_->inputs[l];
-    auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
-    auto leftEnd = l == numLefts - 1 ? leftMatch_->endIndex : left->size();
-
-    for (auto i = leftStart; i < leftEnd; ++i) {
-      auto firstRightBatch =
-          (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
-          ? rightMatch_->cursor->batchIndex
-          : 0;
-
-      auto rightStartIndex =
-          (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
-          ? rightMatch_->cursor->index
-          : rightMatch_->startIndex;
-
-      auto numRights = rightMatch_->inputs.size();
-      for (size_t r = firstRightBatch; r < numRights; ++r) {
-        auto right = rightMatch_->inputs[r];
-        auto rightStart = r == firstRightBatch ? rightStartIndex : 0;
-        auto rightEnd =
-            r == numRights - 1 ? rightMatch_->endIndex : right->size();
-
-        for (auto j = rightStart; j < rightEnd; ++j) {
-          if (outputSize_ == outputBatchSize_) {
-            leftMatch_->setCursor(l, i);
-            rightMatch_->setCursor(r, j);
-            return true;
+  for (;;) {
+    size_t firstLeftBatch;
+    vector_size_t leftStartIndex;
+    if (leftMatch_->cursor) {
+      firstLeftBatch = leftMatch_->cursor->batchIndex;
+      leftStartIndex = leftMatch_->cursor->index;
+    } else {
+      firstLeftBatch = 0;
+      leftStartIndex = leftMatch_->startIndex;
+    }
+
+    size_t numLefts = leftMatch_->inputs.size();
+    for (size_t l = firstLeftBatch; l < numLefts; ++l) {
+      auto left = leftMatch_->inputs[l];
+      auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
+      auto leftEnd = l == numLefts - 1 ? leftMatch_->endIndex : left->size();
+
+      for (auto i = leftStart; i < leftEnd; ++i) {
+        auto firstRightBatch =
+            (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
+            ? rightMatch_->cursor->batchIndex
+            : 0;
+
+        auto rightStartIndex =
+            (l == firstLeftBatch && i == leftStart && rightMatch_->cursor)
+            ? rightMatch_->cursor->index
+            : rightMatch_->startIndex;
+
+        auto numRights = rightMatch_->inputs.size();
+        for (size_t r = firstRightBatch; r < numRights; ++r) {
+          auto right = rightMatch_->inputs[r];
+          auto rightStart = r == firstRightBatch ? rightStartIndex : 0;
+          auto rightEnd =
+              r == numRights - 1 ? rightMatch_->endIndex : right->size();
+
+          for (auto j = rightStart; j < rightEnd; ++j) {
+            if (outputSize_ == outputBatchSize_) {
+              leftMatch_->setCursor(l, i);
+              rightMatch_->setCursor(r, j);
+              return true;
+            }
+            addOutputRow(left, i, right, j);
           }
-          addOutputRow(left, i, right, j);
         }
       }
     }
+
+    // Join the left side rows with the next batch of a spilled right side
+    // match, if any.
+    if (!nextSpilledRightMatch()) {
+      break;
+    }
+    leftMatch_->cursor.reset();
   }
 
   leftMatch_.reset();
@@ -470,6 +583,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
 
     if (rightInput_) {
       if (!findEndOfMatch(rightMatch_.value(), rightInput_, rightKeys_)) {
+        maybeSpillRightMatch();
         // Continue looking for the end of the match.
         rightInput_ = nullptr;
         return nullptr;
@@ -495,6 +609,10 @@ RowVectorPtr MergeJoin::doGetOutput() {
     VELOX_CHECK(leftMatch_->complete);
     VELOX_CHECK(rightMatch_ && rightMatch_->complete);
 
+    if (rightMatchSpill_ != nullptr) {
+      finishRightMatchSpill();
+    }
+
     if (addToOutput()) {
       return std::move(output_);
     }
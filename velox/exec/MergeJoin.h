@@ -16,6 +16,7 @@
 #pragma once
 #include "velox/exec/MergeSource.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 class MergeJoin : public Operator {
@@ -151,13 +152,29 @@ class MergeJoin : public Operator {
   /// it is null.
   void prepareOutput();
 
+  // Spills the buffered rows of 'rightMatch_' if these take more than
+  // 'spillMemoryThreshold_' or if the match is already being spilled. Only
+  // the last batch of the match stays in 'rightMatch_' to compare keys with
+  // the next batch of right side input.
+  void maybeSpillRightMatch();
+
+  // Spills the rest of the complete 'rightMatch_' and replaces it with the
+  // first batch of the spilled rows read back.
+  void finishRightMatchSpill();
+
+  // Replaces 'rightMatch_' with the next batch of spilled rows of the right
+  // side match. Returns false if all spilled batches have been read.
+  bool nextSpilledRightMatch();
+
   // Appends a cartesian product of the current set of matching rows, leftMatch_
   // x rightMatch_, to output_. Returns true if output_ is full. Sets
   // leftMatchCursor_ and rightMatchCursor_ if output_ filled up before all the
   // rows were added. Fills up output starting from leftMatchCursor_ and
   // rightMatchCursor_ positions if these are set. Clears leftMatch_ and
   // rightMatch_ if all rows were added. Updates leftMatchCursor_ and
-  // rightMatchCursor_ if output_ filled up before all rows were added.
+  // rightMatchCursor_ if output_ filled up before all rows were added. If the
+  // right side match is spilled, joins leftMatch_ with each spilled batch in
+  // turn.
   bool addToOutput();
 
   // Adds one row of output by copying values from left and right batches at the
@@ -344,6 +361,16 @@ class MergeJoin : public Operator {
   /// Number of join keys.
   const size_t numKeys_;
 
+  /// The max memory used to buffer the right side rows of a match before
+  /// spilling these.
+  const uint64_t spillMemoryThreshold_;
+
+  /// The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  /// Type of the right side input. Used for spilling.
+  const RowTypePtr rightType_;
+
   std::vector<column_index_t> leftKeys_;
   std::vector<column_index_t> rightKeys_;
   std::vector<IdentityProjection> leftProjections_;
@@ -385,6 +412,18 @@ class MergeJoin : public Operator {
   /// A set of rows with matching keys on the right side.
   std::optional<Match> rightMatch_;
 
+  /// Spill files being written for the right side rows of the current match.
+  /// Set when the buffered rows of the match exceed 'spillMemoryThreshold_'.
+  std::unique_ptr<SpillFileList> rightMatchSpill_;
+
+  /// Number of rows written to 'rightMatchSpill_'.
+  uint64_t numRightMatchSpilledRows_{0};
+
+  /// The spilled right side rows of the current match being read back. The
+  /// file at 'rightMatchFileIndex_' is the one being read.
+  SpillFiles rightMatchFiles_;
+  size_t rightMatchFileIndex_{0};
+
   RowVectorPtr output_;
 
   /// Number of rows accumulated in the output_.
@@ -17,6 +17,7 @@
 #include "velox/exec/MergeSource.h"
 
 #include <boost/circular_buffer.hpp>
+#include <condition_variable>
 #include "velox/exec/Merge.h"
 #include "velox/vector/VectorStream.h"
 
@@ -114,21 +115,31 @@ class LocalMergeSource : public MergeSource {
   folly::Synchronized<LocalMergeSourceQueue> queue_;
 };
 
-class MergeExchangeSource : public MergeSource {
+class MergeExchangeSource
+    : public MergeSource,
+      public std::enable_shared_from_this<MergeExchangeSource> {
  public:
   MergeExchangeSource(
       MergeExchange* mergeExchange,
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool)
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      folly::Executor* FOLLY_NULLABLE executor)
       : mergeExchange_(mergeExchange),
-        client_(std::make_unique<ExchangeClient>(destination, pool)) {
+        outputType_(mergeExchange->outputType()),
+        serdeOptions_(mergeExchange->serdeOptions()),
+        pool_(pool),
+        executor_(executor),
+        client_(std::make_shared<ExchangeClient>(destination, pool)) {
     client_->addRemoteTaskId(taskId);
     client_->noMoreRemoteTasks();
   }
 
   BlockingReason next(RowVectorPtr& data, ContinueFuture* future) override {
     data.reset();
+    if (executor_ != nullptr) {
+      return nextPrefetched(data, future);
+    }
 
     if (atEnd_) {
       return BlockingReason::kNotBlocked;
@@ -155,7 +166,8 @@ class MergeExchangeSource : public MergeSource {
           inputStream_.get(),
           mergeExchange_->pool(),
           mergeExchange_->outputType(),
-          &data);
+          &data,
+          &mergeExchange_->serdeOptions());
 
       auto lockedStats = mergeExchange_->stats().wlock();
       lockedStats->addInputVector(data->estimateFlatSize(), data->size());
@@ -173,19 +185,160 @@ class MergeExchangeSource : public MergeSource {
   }
 
   void close() override {
-    if (client_) {
-      client_->close();
-      client_ = nullptr;
+    std::shared_ptr<ExchangeClient> client;
+    {
+      // Waits for a running prefetch, which may use 'client_' and 'pool_'.
+      std::unique_lock<std::mutex> l(mutex_);
+      closed_ = true;
+      prefetchDone_.wait(l, [&]() { return !prefetchRunning_; });
+      client = std::move(client_);
+      prefetched_.clear();
+    }
+    if (client) {
+      client->close();
     }
   }
 
  private:
+  // Max number of deserialized vectors to keep ahead of next().
+  static constexpr int32_t kMaxPrefetchedVectors = 2;
+
+  // Returns the next vector deserialized by prefetch() and starts a prefetch
+  // if there is none and 'prefetched_' has room.
+  BlockingReason nextPrefetched(RowVectorPtr& data, ContinueFuture* future) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    if (!prefetched_.empty()) {
+      data = std::move(prefetched_.front());
+      prefetched_.pop_front();
+      auto lockedStats = mergeExchange_->stats().wlock();
+      lockedStats->rawInputBytes += std::exchange(rawInputBytes_, 0);
+      lockedStats->addInputVector(data->estimateFlatSize(), data->size());
+    } else if (!prefetchAtEnd_) {
+      consumerPromise_ = ContinuePromise("MergeExchangeSource::next");
+      *future = consumerPromise_->getSemiFuture();
+    }
+    if (!prefetchScheduled_ && !prefetchAtEnd_ &&
+        prefetched_.size() < kMaxPrefetchedVectors) {
+      prefetchScheduled_ = true;
+      executor_->add([self = shared_from_this()]() { self->prefetch(); });
+    }
+    return data == nullptr && !prefetchAtEnd_
+        ? BlockingReason::kWaitForProducer
+        : BlockingReason::kNotBlocked;
+  }
+
+  // Runs on 'executor_'. Deserializes pages into 'prefetched_' until it is
+  // full or the client has no page. In the latter case, continues on
+  // 'executor_' when the client has a page.
+  void prefetch() {
+    for (;;) {
+      std::shared_ptr<ExchangeClient> client;
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        if (closed_ || prefetched_.size() >= kMaxPrefetchedVectors) {
+          prefetchScheduled_ = false;
+          prefetchRunning_ = false;
+          prefetchDone_.notify_all();
+          return;
+        }
+        prefetchRunning_ = true;
+        client = client_;
+      }
+
+      bool atEnd = false;
+      ContinueFuture future;
+      std::unique_ptr<SerializedPage> page;
+      std::vector<RowVectorPtr> vectors;
+      std::exception_ptr error;
+      try {
+        page = client->next(&atEnd, &future);
+        if (page != nullptr) {
+          vectors = readPage(*page);
+        }
+      } catch (const std::exception&) {
+        error = std::current_exception();
+      }
+
+      std::optional<ContinuePromise> promise;
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        prefetchRunning_ = false;
+        if (error || atEnd) {
+          error_ = error;
+          prefetchAtEnd_ = true;
+          prefetchScheduled_ = false;
+        } else if (page != nullptr) {
+          rawInputBytes_ += page->size();
+          for (auto& vector : vectors) {
+            prefetched_.push_back(std::move(vector));
+          }
+        }
+        if (page != nullptr || error || atEnd) {
+          promise = std::move(consumerPromise_);
+          consumerPromise_.reset();
+        }
+        prefetchDone_.notify_all();
+      }
+      if (promise) {
+        promise->setValue();
+      }
+      if (error || atEnd) {
+        return;
+      }
+      if (page == nullptr) {
+        std::move(future).via(executor_).thenValue(
+            [self = shared_from_this()](auto&& /* unused */) {
+              self->prefetch();
+            });
+        return;
+      }
+    }
+  }
+
+  // Deserializes all vectors of 'page' into 'pool_'.
+  std::vector<RowVectorPtr> readPage(SerializedPage& page) {
+    ByteStream input;
+    page.prepareStreamForDeserialize(&input);
+    std::vector<RowVectorPtr> vectors;
+    while (!input.atEnd()) {
+      RowVectorPtr vector;
+      VectorStreamGroup::read(
+          &input, pool_, outputType_, &vector, &serdeOptions_);
+      vectors.push_back(std::move(vector));
+    }
+    return vectors;
+  }
+
   MergeExchange* const mergeExchange_;
-  std::unique_ptr<ExchangeClient> client_;
+  // Copies of the properties of 'mergeExchange_' used off the driver thread.
+  const RowTypePtr outputType_;
+  const VectorSerde::Options serdeOptions_;
+  memory::MemoryPool* const pool_;
+  folly::Executor* const executor_;
+  std::shared_ptr<ExchangeClient> client_;
   std::unique_ptr<ByteStream> inputStream_;
   std::unique_ptr<SerializedPage> currentPage_;
   bool atEnd_ = false;
 
+  // State shared with prefetch() if 'executor_' is set.
+  std::mutex mutex_;
+  std::condition_variable prefetchDone_;
+  std::deque<RowVectorPtr> prefetched_;
+  // Raw input bytes of 'prefetched_' not yet added to the operator stats.
+  uint64_t rawInputBytes_{0};
+  // True from scheduling prefetch() until it stops without waiting for the
+  // client.
+  bool prefetchScheduled_{false};
+  // True while prefetch() uses 'client_'.
+  bool prefetchRunning_{false};
+  bool prefetchAtEnd_{false};
+  bool closed_{false};
+  std::exception_ptr error_;
+  std::optional<ContinuePromise> consumerPromise_;
+
   BlockingReason enqueue(RowVectorPtr input, ContinueFuture* future) override {
     VELOX_FAIL();
   }
@@ -203,9 +356,10 @@ std::shared_ptr<MergeSource> MergeSource::createMergeExchangeSource(
     MergeExchange* mergeExchange,
     const std::string& taskId,
     int destination,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    folly::Executor* executor) {
   return std::make_shared<MergeExchangeSource>(
-      mergeExchange, taskId, destination, pool);
+      mergeExchange, taskId, destination, pool, executor);
 }
 
 namespace {
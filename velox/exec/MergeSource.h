@@ -36,11 +36,15 @@ class MergeSource {
   // Factory methods to create MergeSources.
   static std::shared_ptr<MergeSource> createLocalMergeSource();
 
+  /// If 'executor' is set, the pages from 'taskId' are deserialized on it
+  /// ahead of next(), into vectors allocated from 'pool'. Otherwise, next()
+  /// deserializes each page into the pool of 'mergeExchange'.
   static std::shared_ptr<MergeSource> createMergeExchangeSource(
       MergeExchange* mergeExchange,
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool);
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 };
 
 /// Coordinates data transfer between single producer and single consumer. Used
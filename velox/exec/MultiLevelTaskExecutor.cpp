@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MultiLevelTaskExecutor.h"
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/process/ProcessBase.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/Driver.h"
+#include "velox/exec/Task.h"
+
+#include <cmath>
+#include <optional>
+
+namespace facebook::velox::exec {
+
+thread_local MultiLevelTaskExecutor::Running*
+    MultiLevelTaskExecutor::currentRunning_{nullptr};
+
+MultiLevelTaskExecutor::MultiLevelTaskExecutor(Options options)
+    : levelThresholdNanos_(std::move(options.levelThresholdNanos)),
+      levelTimeMultiplier_(options.levelTimeMultiplier),
+      timeSliceMicros_(options.timeSliceMicros),
+      levelCpuNanos_(levelThresholdNanos_.size() + 1, 0),
+      levelQueued_(levelThresholdNanos_.size() + 1, 0),
+      running_(options.numThreads) {
+  VELOX_CHECK_GT(options.numThreads, 0);
+  VELOX_CHECK_GE(levelTimeMultiplier_, 1);
+  VELOX_CHECK(
+      std::is_sorted(levelThresholdNanos_.begin(), levelThresholdNanos_.end()),
+      "Level thresholds must be ascending");
+  stats_.levelCpuNanos.resize(numLevels(), 0);
+  for (auto level = 0; level < numLevels(); ++level) {
+    levelCpuKeys_.push_back(
+        fmt::format("{}.{}", kCounterDriverLevelCpuTimeMs, level));
+    REPORT_ADD_STAT_EXPORT_TYPE(levelCpuKeys_.back().c_str(), StatType::SUM);
+  }
+  threads_.reserve(options.numThreads);
+  for (auto i = 0; i < options.numThreads; ++i) {
+    threads_.emplace_back([this, i]() { runThread(i); });
+  }
+  if (timeSliceMicros_ > 0) {
+    timeSliceThread_ = std::thread([this]() { runTimeSlices(); });
+  }
+}
+
+MultiLevelTaskExecutor::~MultiLevelTaskExecutor() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stopped_ = true;
+  }
+  workAvailable_.notify_all();
+  stopTimeSlices_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  if (timeSliceThread_.joinable()) {
+    timeSliceThread_.join();
+  }
+}
+
+void MultiLevelTaskExecutor::add(folly::Func func) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    tasks_.push_back(std::move(func));
+  }
+  workAvailable_.notify_one();
+}
+
+void MultiLevelTaskExecutor::addDriver(
+    std::shared_ptr<Driver> driver,
+    folly::Func run) {
+  if (currentRunning_ != nullptr && currentRunning_->driver == driver) {
+    // The Driver yielded and is added again from its run. Counts the time
+    // so far for choosing its level.
+    addCpuTime(*currentRunning_);
+  }
+  const auto level = levelFor(driver->scheduledCpuNanos());
+  auto queryCtx = driver->task()->queryCtx();
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& state = queryStateLocked(queryCtx);
+    if (levelQueued_[level] == 0) {
+      // The level has not competed for threads while it was empty. Raises
+      // its CPU time to that of the least served other level with queued
+      // Drivers so that it gets its share from now on, not the share it
+      // missed.
+      std::optional<double> minNormalizedCpu;
+      for (auto other = 0; other < numLevels(); ++other) {
+        if (other != level && levelQueued_[other] > 0) {
+          const auto normalizedCpu = normalizedLevelCpuLocked(other);
+          if (!minNormalizedCpu.has_value() ||
+              normalizedCpu < minNormalizedCpu.value()) {
+            minNormalizedCpu = normalizedCpu;
+          }
+        }
+      }
+      if (minNormalizedCpu.has_value()) {
+        levelCpuNanos_[level] = std::max(
+            levelCpuNanos_[level],
+            minNormalizedCpu.value() *
+                std::pow(levelTimeMultiplier_, numLevels() - 1 - level));
+      }
+    }
+    state.levels[level].push_back(
+        {std::move(driver), std::move(run), getCurrentTimeMicro()});
+    ++state.numQueued;
+    ++levelQueued_[level];
+  }
+  workAvailable_.notify_one();
+}
+
+MultiLevelTaskExecutor::Stats MultiLevelTaskExecutor::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.levelQueuedDrivers = levelQueued_;
+  return stats;
+}
+
+void MultiLevelTaskExecutor::runThread(int32_t threadId) {
+  auto& running = running_[threadId];
+  for (;;) {
+    folly::Func func;
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      workAvailable_.wait(l, [&]() {
+        return stopped_ || !tasks_.empty() || hasQueuedDriversLocked();
+      });
+      func = nextLocked(running);
+      if (!func) {
+        VELOX_CHECK(stopped_);
+        return;
+      }
+    }
+    currentRunning_ = running.driver != nullptr ? &running : nullptr;
+    try {
+      func();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "MultiLevelTaskExecutor: Work threw: " << e.what();
+    }
+    currentRunning_ = nullptr;
+    func = nullptr;
+    if (running.driver != nullptr) {
+      addCpuTime(running);
+      std::shared_ptr<Driver> driver;
+      {
+        std::lock_guard<std::mutex> l(mutex_);
+        driver = std::move(running.driver);
+        running.queryCtx = nullptr;
+      }
+      // 'driver' may be the last reference to its Task, which is then freed
+      // outside of 'mutex_'.
+    }
+  }
+}
+
+void MultiLevelTaskExecutor::runTimeSlices() {
+  std::unique_lock<std::mutex> l(mutex_);
+  while (!stopped_) {
+    stopTimeSlices_.wait_for(
+        l, std::chrono::microseconds(timeSliceMicros_), [&]() {
+          return stopped_;
+        });
+    if (stopped_ || !hasQueuedDriversLocked()) {
+      continue;
+    }
+    const auto sliceStartMicros = getCurrentTimeMicro() - timeSliceMicros_;
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (const auto& running : running_) {
+      if (running.driver != nullptr &&
+          running.startMicros < sliceStartMicros) {
+        tasks.push_back(running.driver->task());
+      }
+    }
+    if (tasks.empty()) {
+      continue;
+    }
+    l.unlock();
+    uint64_t numYields = 0;
+    for (auto& task : tasks) {
+      if (task->yieldIfDue(sliceStartMicros) > 0) {
+        ++numYields;
+      }
+    }
+    tasks.clear();
+    l.lock();
+    stats_.numYields += numYields;
+  }
+}
+
+folly::Func MultiLevelTaskExecutor::nextLocked(Running& running) {
+  if (!tasks_.empty()) {
+    auto func = std::move(tasks_.front());
+    tasks_.pop_front();
+    return func;
+  }
+  int32_t level = -1;
+  for (auto i = 0; i < numLevels(); ++i) {
+    if (levelQueued_[i] > 0 &&
+        (level < 0 ||
+         normalizedLevelCpuLocked(i) < normalizedLevelCpuLocked(level))) {
+      level = i;
+    }
+  }
+  if (level < 0) {
+    return nullptr;
+  }
+  core::QueryCtx* queryCtx = nullptr;
+  QueryState* query = nullptr;
+  for (auto& [key, state] : queries_) {
+    if (state.levels[level].empty()) {
+      continue;
+    }
+    if (query == nullptr ||
+        state.cpuNanos / static_cast<double>(state.cpuShares) <
+            query->cpuNanos / static_cast<double>(query->cpuShares)) {
+      queryCtx = key;
+      query = &state;
+    }
+  }
+  VELOX_CHECK_NOT_NULL(query);
+  auto queued = std::move(query->levels[level].front());
+  query->levels[level].pop_front();
+  --query->numQueued;
+  --levelQueued_[level];
+
+  const auto now = getCurrentTimeMicro();
+  const uint64_t queuedNanos = (now - queued.enqueueMicros) * 1'000;
+  ++stats_.numRuns;
+  stats_.totalQueuedNanos += queuedNanos;
+  stats_.maxQueuedNanos = std::max(stats_.maxQueuedNanos, queuedNanos);
+  REPORT_ADD_HISTOGRAM_VALUE(
+      kCounterDriverQueuedTimeMs, queuedNanos / 1'000'000);
+
+  running.driver = std::move(queued.driver);
+  running.queryCtx = queryCtx;
+  running.level = level;
+  running.startMicros = now;
+  running.startCpuNanos = process::threadCpuNanos();
+  return std::move(queued.run);
+}
+
+bool MultiLevelTaskExecutor::hasQueuedDriversLocked() const {
+  return std::any_of(levelQueued_.begin(), levelQueued_.end(), [](auto n) {
+    return n > 0;
+  });
+}
+
+int32_t MultiLevelTaskExecutor::levelFor(uint64_t cpuNanos) const {
+  const auto& thresholds = levelThresholdNanos_;
+  return std::upper_bound(thresholds.begin(), thresholds.end(), cpuNanos) -
+      thresholds.begin();
+}
+
+double MultiLevelTaskExecutor::normalizedLevelCpuLocked(int32_t level) const {
+  return levelCpuNanos_[level] /
+      std::pow(levelTimeMultiplier_, numLevels() - 1 - level);
+}
+
+void MultiLevelTaskExecutor::addCpuTime(Running& running) {
+  const auto cpuNanos = process::threadCpuNanos();
+  const auto deltaNanos = cpuNanos - running.startCpuNanos;
+  running.startCpuNanos = cpuNanos;
+  running.driver->addScheduledCpuNanos(deltaNanos);
+  REPORT_ADD_STAT_VALUE(levelCpuKeys_[running.level], deltaNanos / 1'000'000);
+  std::lock_guard<std::mutex> l(mutex_);
+  levelCpuNanos_[running.level] += deltaNanos;
+  stats_.levelCpuNanos[running.level] += deltaNanos;
+  auto it = queries_.find(running.queryCtx);
+  if (it != queries_.end()) {
+    it->second.cpuNanos += deltaNanos;
+  }
+}
+
+MultiLevelTaskExecutor::QueryState& MultiLevelTaskExecutor::queryStateLocked(
+    const std::shared_ptr<core::QueryCtx>& queryCtx) {
+  auto it = queries_.find(queryCtx.get());
+  if (it != queries_.end() && !it->second.queryCtx.expired()) {
+    return it->second;
+  }
+  // Drops the states of the finished queries. These have no queued Drivers
+  // since a queued Driver references its query.
+  for (auto stateIt = queries_.begin(); stateIt != queries_.end();) {
+    if (stateIt->second.queryCtx.expired()) {
+      VELOX_CHECK_EQ(stateIt->second.numQueued, 0);
+      stateIt = queries_.erase(stateIt);
+    } else {
+      ++stateIt;
+    }
+  }
+  auto& state = queries_[queryCtx.get()];
+  state.queryCtx = queryCtx;
+  state.cpuShares = std::max<uint32_t>(1, queryCtx->queryConfig().cpuShares());
+  state.cpuNanos = 0;
+  state.numQueued = 0;
+  state.levels.resize(numLevels());
+  return state;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/container/F14Map.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace facebook::velox::core {
+class QueryCtx;
+} // namespace facebook::velox::core
+
+namespace facebook::velox::exec {
+
+class Driver;
+
+/// Executor that runs Drivers on its own threads with a multi-level feedback
+/// queue. A Driver starts on the first level and moves to the next level each
+/// time the CPU time it has run on 'this' passes a threshold, so that short
+/// queries are not queued behind long ones. When several levels have queued
+/// Drivers, each level gets 'levelTimeMultiplier' times the CPU time of the
+/// next one. Within a level, the query that has used the least CPU time for
+/// its core::QueryConfig::cpuShares() runs next. Driver::enqueue() adds the
+/// Drivers of a query whose QueryCtx has this executor with addDriver().
+/// Other work, e.g. future continuations, runs before any Driver in FIFO
+/// order.
+///
+/// Drivers only leave the thread at a blocking or yield point. Drivers that
+/// have been on a thread longer than 'timeSliceMicros' while other Drivers
+/// are queued are asked to yield with Task::yieldIfDue().
+class MultiLevelTaskExecutor : public folly::Executor {
+ public:
+  struct Options {
+    int32_t numThreads{
+        static_cast<int32_t>(std::thread::hardware_concurrency())};
+
+    /// The CPU time of a Driver at which it moves to the second, third etc.
+    /// level. The number of levels is one more than the number of thresholds.
+    std::vector<uint64_t> levelThresholdNanos{
+        1'000'000'000,
+        10'000'000'000,
+        60'000'000'000,
+        300'000'000'000};
+
+    /// The CPU time a level gets relative to the next level while both have
+    /// queued Drivers.
+    double levelTimeMultiplier{2};
+
+    /// Time after which a running Driver is asked to yield if other Drivers
+    /// are queued. 0 means Drivers are never asked to yield.
+    uint64_t timeSliceMicros{1'000'000};
+  };
+
+  struct Stats {
+    /// CPU time of the Drivers run on each level.
+    std::vector<uint64_t> levelCpuNanos;
+
+    /// Number of Drivers queued on each level.
+    std::vector<int32_t> levelQueuedDrivers;
+
+    /// Number of Drivers run and their total and max time in the queue.
+    uint64_t numRuns{0};
+    uint64_t totalQueuedNanos{0};
+    uint64_t maxQueuedNanos{0};
+
+    /// Number of times Drivers were asked to yield at the end of a time slice.
+    uint64_t numYields{0};
+  };
+
+  explicit MultiLevelTaskExecutor(Options options);
+
+  /// Runs the work that is still queued and joins the threads.
+  ~MultiLevelTaskExecutor() override;
+
+  /// Adds work that is not a Driver. Runs before the queued Drivers.
+  void add(folly::Func func) override;
+
+  /// Adds 'run', which runs 'driver', to the queue of the level that matches
+  /// the CPU time of 'driver'.
+  void addDriver(std::shared_ptr<Driver> driver, folly::Func run);
+
+  int32_t numLevels() const {
+    return static_cast<int32_t>(levelCpuNanos_.size());
+  }
+
+  Stats stats() const;
+
+ private:
+  struct QueuedDriver {
+    std::shared_ptr<Driver> driver;
+    folly::Func run;
+    uint64_t enqueueMicros;
+  };
+
+  struct QueryState {
+    // Used for telling if the QueryCtx at the key of the state is still the
+    // query that made the state.
+    std::weak_ptr<core::QueryCtx> queryCtx;
+    uint32_t cpuShares{1};
+    // CPU time of the Drivers of the query.
+    uint64_t cpuNanos{0};
+    int32_t numQueued{0};
+    std::vector<std::deque<QueuedDriver>> levels;
+  };
+
+  // The Driver a thread runs and when it started.
+  struct Running {
+    std::shared_ptr<Driver> driver;
+    core::QueryCtx* queryCtx{nullptr};
+    int32_t level{0};
+    uint64_t startMicros{0};
+    uint64_t startCpuNanos{0};
+  };
+
+  void runThread(int32_t threadId);
+
+  // Runs the time slices of the running Drivers.
+  void runTimeSlices();
+
+  // Returns the next work to run or nullptr if there is no queued work.
+  // Sets 'running' if the work is a Driver.
+  folly::Func nextLocked(Running& running);
+
+  bool hasQueuedDriversLocked() const;
+
+  // Returns the level of a Driver that has run for 'cpuNanos'.
+  int32_t levelFor(uint64_t cpuNanos) const;
+
+  // Returns the CPU time of 'level' divided by its share of the CPU time.
+  double normalizedLevelCpuLocked(int32_t level) const;
+
+  // Adds the CPU time of 'running' since its start to its Driver, level and
+  // query and restarts the time.
+  void addCpuTime(Running& running);
+
+  QueryState& queryStateLocked(const std::shared_ptr<core::QueryCtx>& query);
+
+  // The work of an executor thread that runs a Driver, nullptr otherwise.
+  static thread_local Running* currentRunning_;
+
+  const std::vector<uint64_t> levelThresholdNanos_;
+  const double levelTimeMultiplier_;
+  const uint64_t timeSliceMicros_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable workAvailable_;
+  std::condition_variable stopTimeSlices_;
+  bool stopped_{false};
+
+  std::deque<folly::Func> tasks_;
+  folly::F14FastMap<core::QueryCtx*, QueryState> queries_;
+
+  // CPU time used for choosing the next level. A level which gets queued
+  // Drivers after being empty is raised so that it does not take all threads
+  // for catching up.
+  std::vector<double> levelCpuNanos_;
+  std::vector<int32_t> levelQueued_;
+
+  // The Driver running on each thread.
+  std::vector<Running> running_;
+
+  Stats stats_;
+
+  // StatsReporter keys for the CPU time of each level.
+  std::vector<std::string> levelCpuKeys_;
+
+  std::vector<std::thread> threads_;
+  std::thread timeSliceThread_;
+};
+
+} // namespace facebook::velox::exec
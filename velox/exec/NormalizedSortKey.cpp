@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/NormalizedSortKey.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// Returns the number of value bits of a key of 'kind' or 0 if keys of 'kind'
+// are not encoded.
+int32_t valueBits(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return 1;
+    case TypeKind::TINYINT:
+      return 8;
+    case TypeKind::SMALLINT:
+      return 16;
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return 32;
+    case TypeKind::BIGINT:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+// Returns the value at 'offset' of 'row' as an unsigned integer of the same
+// width that orders like the signed value.
+template <typename T>
+uint64_t biasedValue(const char* row, int32_t offset) {
+  using U = std::make_unsigned_t<T>;
+  const auto value = static_cast<U>(*reinterpret_cast<const T*>(row + offset));
+  return value ^ (static_cast<U>(1) << (sizeof(T) * 8 - 1));
+}
+
+// Writes the low 'numBits' bits of 'value' to 'key' starting at bit
+// 'position', counting from the most significant bit of the first word.
+void appendBits(
+    uint64_t value,
+    int32_t numBits,
+    int32_t& position,
+    uint64_t* key) {
+  const auto word = position / 64;
+  const auto freeBits = 64 - position % 64;
+  if (numBits <= freeBits) {
+    key[word] |= value << (freeBits - numBits);
+  } else {
+    key[word] |= value >> (numBits - freeBits);
+    key[word + 1] |= value << (64 - (numBits - freeBits));
+  }
+  position += numBits;
+}
+} // namespace
+
+NormalizedSortKey::NormalizedSortKey(
+    const RowContainer& container,
+    const std::vector<CompareFlags>& compareFlags)
+    : numSortingKeys_(compareFlags.size()) {
+  VELOX_CHECK_LE(numSortingKeys_, container.keyTypes().size());
+  for (auto i = 0; i < numSortingKeys_; ++i) {
+    const auto kind = container.keyTypes()[i]->kind();
+    const auto numBits = valueBits(kind);
+    if (numBits == 0 || numBits_ + 1 + numBits > kNumWords * 64) {
+      break;
+    }
+    keys_.push_back({kind, container.columnAt(i), compareFlags[i], numBits});
+    numBits_ += 1 + numBits;
+  }
+}
+
+void NormalizedSortKey::encode(const char* row, uint64_t* key) const {
+  std::fill(key, key + kNumWords, 0);
+  int32_t position = 0;
+  for (const auto& [kind, column, flags, numBits] : keys_) {
+    if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+      // The value bits of a null are left 0.
+      appendBits(flags.nullsFirst ? 0 : 1, 1, position, key);
+      position += numBits;
+      continue;
+    }
+    appendBits(flags.nullsFirst ? 1 : 0, 1, position, key);
+    uint64_t value;
+    switch (kind) {
+      case TypeKind::BOOLEAN:
+        value = *reinterpret_cast<const bool*>(row + column.offset()) ? 1 : 0;
+        break;
+      case TypeKind::TINYINT:
+        value = biasedValue<int8_t>(row, column.offset());
+        break;
+      case TypeKind::SMALLINT:
+        value = biasedValue<int16_t>(row, column.offset());
+        break;
+      case TypeKind::INTEGER:
+      case TypeKind::DATE:
+        value = biasedValue<int32_t>(row, column.offset());
+        break;
+      case TypeKind::BIGINT:
+        value = biasedValue<int64_t>(row, column.offset());
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    if (!flags.ascending) {
+      value = ~value;
+      if (numBits < 64) {
+        value &= (1ULL << numBits) - 1;
+      }
+    }
+    appendBits(value, numBits, position, key);
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/CompareFlags.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Encodes the leading sorting keys of rows in a RowContainer into
+/// kNumWords 64 bit words. Comparing the words of two rows in order as
+/// unsigned integers gives the same result as comparing the encoded keys
+/// with RowContainer::compare() and their CompareFlags, so a sort compares
+/// a couple of integers per row pair instead of dispatching on the type of
+/// each key. Each key is encoded as a null bit followed by the bits of the
+/// value, with the sign bit flipped and all bits inverted for descending
+/// order. Only BOOLEAN, TINYINT, SMALLINT, INTEGER, BIGINT and DATE keys are
+/// encoded. The encoding stops at the first key of another type or at the
+/// first key that does not fit in the remaining bits. The keys after that
+/// are compared with RowContainer::compare() on ties.
+class NormalizedSortKey {
+ public:
+  static constexpr int32_t kNumWords = 2;
+
+  /// @param container Holds the rows. The sorting keys are the first
+  /// 'compareFlags.size()' key columns of 'container'.
+  /// @param compareFlags Compare flags of the sorting keys.
+  NormalizedSortKey(
+      const RowContainer& container,
+      const std::vector<CompareFlags>& compareFlags);
+
+  /// Returns the number of leading sorting keys that are encoded. 0 if the
+  /// first key can't be encoded.
+  int32_t numKeys() const {
+    return keys_.size();
+  }
+
+  /// Returns the number of leading bytes of the normalized key that
+  /// hold encoded bits. The bytes are counted from the most significant
+  /// byte of the first word.
+  int32_t numBytes() const {
+    return bits::nbytes(numBits_);
+  }
+
+  /// Returns byte 'index' of 'key', counting from the most significant byte
+  /// of the first word.
+  static uint8_t byteAt(const uint64_t* FOLLY_NONNULL key, int32_t index) {
+    return key[index / 8] >> (56 - 8 * (index % 8));
+  }
+
+  /// Returns true if all sorting keys are encoded, so that rows with equal
+  /// normalized keys are equal on all sorting keys.
+  bool isComplete() const {
+    return keys_.size() == numSortingKeys_;
+  }
+
+  /// Writes the normalized key of 'row' to 'key', which has kNumWords words.
+  void encode(const char* FOLLY_NONNULL row, uint64_t* FOLLY_NONNULL key)
+      const;
+
+  /// Compares two normalized keys made by encode(). Returns a negative
+  /// number, 0 or a positive number like RowContainer::compare().
+  static int32_t compare(
+      const uint64_t* FOLLY_NONNULL left,
+      const uint64_t* FOLLY_NONNULL right) {
+    for (auto i = 0; i < kNumWords; ++i) {
+      if (left[i] != right[i]) {
+        return left[i] < right[i] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  struct Key {
+    TypeKind kind;
+    RowColumn column;
+    CompareFlags flags;
+    // Number of bits of the value, not counting the null bit.
+    int32_t numBits;
+  };
+
+  const size_t numSortingKeys_;
+  std::vector<Key> keys_;
+
+  // Number of encoded bits, including the null bits.
+  int32_t numBits_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -74,12 +74,13 @@ OperatorCtx::OperatorCtx(
       planNodeId_(planNodeId),
       operatorId_(operatorId),
       operatorType_(operatorType),
-      pool_(driverCtx_->addOperatorPool(planNodeId, operatorType)) {}
+      pool_(driverCtx_->addOperatorPool(planNodeId, operatorType)
+                ->shared_from_this()) {}
 
 core::ExecCtx* OperatorCtx::execCtx() const {
   if (!execCtx_) {
     execCtx_ = std::make_unique<core::ExecCtx>(
-        pool_, driverCtx_->task->queryCtx().get());
+        pool_.get(), driverCtx_->task->queryCtx().get());
   }
   return execCtx_.get();
 }
@@ -88,9 +89,10 @@ std::shared_ptr<connector::ConnectorQueryCtx>
 OperatorCtx::createConnectorQueryCtx(
     const std::string& connectorId,
     const std::string& planNodeId,
-    memory::MemoryPool* connectorPool) const {
+    memory::MemoryPool* connectorPool,
+    const SpillConfig* spillConfig) const {
   return std::make_shared<connector::ConnectorQueryCtx>(
-      pool_,
+      pool_.get(),
       connectorPool,
       driverCtx_->task->queryCtx()->getConnectorConfig(connectorId),
       std::make_unique<SimpleExpressionEvaluator>(
@@ -98,7 +100,8 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->allocator(),
       taskId(),
       planNodeId,
-      driverCtx_->driverId);
+      driverCtx_->driverId,
+      spillConfig);
 }
 
 std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
@@ -110,7 +113,7 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
   if (driverCtx_->task->spillDirectory().empty()) {
     return std::nullopt;
   }
-  return Spiller::Config(
+  Spiller::Config config(
       makeOperatorSpillPath(
           driverCtx_->task->spillDirectory(),
           driverCtx()->pipelineId,
@@ -126,6 +129,20 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
       queryConfig.testingSpillPct());
+  config.fileOptions.format =
+      spillFileFormatFromName(queryConfig.spillFileFormat());
+  config.fileOptions.compression =
+      spillCompressionFromName(queryConfig.spillCompressionCodec());
+  config.fileOptions.writeExecutor = config.executor;
+  config.fileOptions.queryId = driverCtx_->task->queryCtx()->queryId();
+  for (const auto& directory : driverCtx_->task->spillStripeDirectories()) {
+    config.fileOptions.stripePaths.push_back(makeOperatorSpillPath(
+        directory,
+        driverCtx()->pipelineId,
+        driverCtx()->driverId,
+        operatorId_));
+  }
+  return config;
 }
 
 Operator::Operator(
@@ -144,7 +161,9 @@ Operator::Operator(
           driverCtx->pipelineId,
           std::move(planNodeId),
           std::move(operatorType)}),
-      outputType_(std::move(outputType)) {
+      outputType_(std::move(outputType)),
+      inputCapture_(
+          InputCapture::create(*driverCtx, operatorCtx_->planNodeId())) {
   auto memoryUsageTracker = pool()->getMemoryUsageTracker();
   if (memoryUsageTracker) {
     memoryUsageTracker->setMakeMemoryCapExceededMessage(
@@ -277,6 +296,33 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
       std::move(columns));
 }
 
+void Operator::retainForRecycle(VectorPtr vector) {
+  if (vector == nullptr || vector->pool() != operatorCtx_->pool()) {
+    return;
+  }
+  if (retainedVectors_.size() >= kMaxRetainedVectors) {
+    retainedVectors_.erase(retainedVectors_.begin());
+  }
+  retainedVectors_.push_back(std::move(vector));
+}
+
+void Operator::recycleRetainedVectors() {
+  if (retainedVectors_.empty()) {
+    return;
+  }
+  auto& vectorPool = operatorCtx_->execCtx()->vectorPool();
+  auto it = retainedVectors_.begin();
+  while (it != retainedVectors_.end()) {
+    if (!it->unique()) {
+      ++it;
+      continue;
+    }
+    // A vector which is not recyclable, e.g. not flat, is freed.
+    vectorPool.release(*it);
+    it = retainedVectors_.erase(it);
+  }
+}
+
 OperatorStats Operator::stats(bool clear) {
   if (!clear) {
     return *stats_.rlock();
@@ -342,6 +388,109 @@ std::string Operator::toString() const {
   return out.str();
 }
 
+std::shared_ptr<Operator::MemoryReclaimer> Operator::MemoryReclaimer::create() {
+  return std::shared_ptr<MemoryReclaimer>(new MemoryReclaimer());
+}
+
+void Operator::MemoryReclaimer::setOperator(
+    Operator* op,
+    const std::shared_ptr<Driver>& driver) {
+  VELOX_CHECK_NOT_NULL(op);
+  VELOX_CHECK_NOT_NULL(driver);
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_NULL(op_, "Operator of memory reclaimer is already set");
+  op_ = op;
+  driver_ = driver;
+}
+
+void Operator::MemoryReclaimer::enterArbitration() {
+  std::shared_ptr<Driver> driver;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    driver = driver_.lock();
+  }
+  // Only the Driver thread enters a suspended section. The pool might also be
+  // allocated from by other threads, e.g. a parallel spill.
+  if (driver == nullptr ||
+      driver->state().thread != std::this_thread::get_id()) {
+    return;
+  }
+  if (driver->task()->enterSuspended(driver->state()) != StopReason::kNone) {
+    // The Task is terminating. The arbitration proceeds and the Driver unwinds
+    // on its next check of the Task state.
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  suspendedDriver_ = std::move(driver);
+}
+
+void Operator::MemoryReclaimer::leaveArbitration() noexcept {
+  std::shared_ptr<Driver> driver;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (suspendedDriver_ == nullptr ||
+        suspendedDriver_->state().thread != std::this_thread::get_id()) {
+      return;
+    }
+    driver = std::move(suspendedDriver_);
+  }
+  try {
+    // A terminate requested during the arbitration is seen by the Driver on
+    // its next check of the Task state.
+    driver->task()->leaveSuspended(driver->state());
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to leave suspended section of " << driver->label()
+               << " after memory arbitration: " << e.what();
+  }
+}
+
+std::shared_ptr<Driver> Operator::MemoryReclaimer::offThreadDriver() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto driver = driver_.lock();
+  if (driver == nullptr || driver->isOnThread() || driver->isTerminated()) {
+    return nullptr;
+  }
+  return driver;
+}
+
+bool Operator::MemoryReclaimer::canReclaim(
+    const memory::MemoryPool& /*unused*/) const {
+  const auto driver = offThreadDriver();
+  return driver != nullptr && op_->canReclaim();
+}
+
+uint64_t Operator::MemoryReclaimer::reclaimableBytes(
+    const memory::MemoryPool& /*unused*/) const {
+  const auto driver = offThreadDriver();
+  if (driver == nullptr || !op_->canReclaim()) {
+    return 0;
+  }
+  return op_->reclaimableBytes();
+}
+
+uint64_t Operator::MemoryReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  const auto driver = offThreadDriver();
+  if (driver == nullptr || !op_->canReclaim()) {
+    return 0;
+  }
+  const int64_t bytesBefore = pool->getCurrentBytes();
+  try {
+    op_->reclaim(targetBytes);
+  } catch (const std::exception&) {
+    // The operator state is undefined after a failed reclaim.
+    driver->task()->setError(std::current_exception());
+    throw;
+  }
+  // Returns the released reservation to the query memory pool, from where the
+  // memory arbitrator takes it out.
+  if (auto tracker = pool->getMemoryUsageTracker()) {
+    tracker->release();
+  }
+  return std::max<int64_t>(0, bytesBefore - pool->getCurrentBytes());
+}
+
 std::vector<column_index_t> toChannels(
     const RowTypePtr& rowType,
     const std::vector<core::TypedExprPtr>& exprs) {
@@ -19,6 +19,7 @@
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
+#include "velox/exec/InputCapture.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spiller.h"
 #include "velox/type/Filter.h"
@@ -194,7 +195,7 @@ class OperatorCtx {
   }
 
   velox::memory::MemoryPool* FOLLY_NONNULL pool() const {
-    return pool_;
+    return pool_.get();
   }
 
   const core::PlanNodeId& planNodeId() const {
@@ -214,11 +215,14 @@ class OperatorCtx {
   /// Makes an extract of QueryCtx for use in a connector. 'planNodeId'
   /// is the id of the calling TableScan. This and the task id identify the scan
   /// for column access tracking. 'connectorPool' is an aggregate memory pool
-  /// for connector use.
+  /// for connector use. 'spillConfig' is the spill config for a data sink, or
+  /// nullptr if it is not allowed to spill. It must outlive the returned
+  /// context.
   std::shared_ptr<connector::ConnectorQueryCtx> createConnectorQueryCtx(
       const std::string& connectorId,
       const std::string& planNodeId,
-      memory::MemoryPool* connectorPool) const;
+      memory::MemoryPool* connectorPool,
+      const SpillConfig* FOLLY_NULLABLE spillConfig = nullptr) const;
 
   /// Generates the spiller config for a given spiller 'type' if the disk
   /// spilling is enabled, otherwise returns null.
@@ -229,7 +233,9 @@ class OperatorCtx {
   const core::PlanNodeId planNodeId_;
   const int32_t operatorId_;
   const std::string operatorType_;
-  velox::memory::MemoryPool* const FOLLY_NONNULL pool_;
+  // Holds a reference as the Task releases the pools of grouped execution
+  // drivers when their split group finishes.
+  const std::shared_ptr<velox::memory::MemoryPool> pool_;
 
   // These members are created on demand.
   mutable std::unique_ptr<core::ExecCtx> execCtx_;
@@ -381,6 +387,7 @@ class Operator : public BaseRuntimeStatWriter {
   virtual void close() {
     input_ = nullptr;
     results_.clear();
+    retainedVectors_.clear();
     if (operatorCtx_->pool()->getMemoryUsageTracker() != nullptr) {
       // Release the unused memory reservation on close.
       operatorCtx_->pool()->getMemoryUsageTracker()->release();
@@ -396,6 +403,65 @@ class Operator : public BaseRuntimeStatWriter {
     return false;
   }
 
+  /// Returns true if 'this' can release some of its memory on request of the
+  /// memory arbitrator, e.g. by spilling its buffered state to disk. The
+  /// memory reclaim methods are only invoked with the Driver of 'this' off
+  /// thread. canReclaim() and reclaimableBytes() give an estimate used to pick
+  /// the operators to reclaim from.
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  /// Returns the number of bytes 'this' can release through reclaim().
+  virtual uint64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  /// Releases at least 'targetBytes' of memory if possible. If 'targetBytes'
+  /// is 0, releases all the reclaimable memory. Invoked with the Task of
+  /// 'this' paused.
+  virtual void reclaim(uint64_t /*targetBytes*/) {}
+
+  /// The memory reclaimer of an operator memory pool. It puts the Driver of the
+  /// operator in a suspended section while an allocation of the operator waits
+  /// for memory arbitration, so that the Task of the operator can be paused to
+  /// reclaim memory from it. The memory reclaim calls are forwarded to the
+  /// operator only if its Driver is alive and off thread.
+  class MemoryReclaimer : public memory::MemoryReclaimer {
+   public:
+    static std::shared_ptr<MemoryReclaimer> create();
+
+    /// Binds 'op' and its 'driver' to 'this'. Nothing is reclaimed before this
+    /// is called once the Driver is fully constructed.
+    void setOperator(Operator* op, const std::shared_ptr<Driver>& driver);
+
+    void enterArbitration() override;
+
+    void leaveArbitration() noexcept override;
+
+    bool canReclaim(const memory::MemoryPool& pool) const override;
+
+    uint64_t reclaimableBytes(const memory::MemoryPool& pool) const override;
+
+    uint64_t reclaim(memory::MemoryPool* pool, uint64_t targetBytes) override;
+
+   private:
+    MemoryReclaimer() = default;
+
+    // Returns the Driver of 'op_' if it is alive and off thread, otherwise
+    // null. The operator can't run while the returned reference is held and
+    // the Task is paused.
+    std::shared_ptr<Driver> offThreadDriver() const;
+
+    mutable std::mutex mutex_;
+    Operator* op_{nullptr};
+    std::weak_ptr<Driver> driver_;
+
+    // The Driver which entered a suspended section in enterArbitration() and
+    // leaves it in leaveArbitration().
+    std::shared_ptr<Driver> suspendedDriver_;
+  };
+
   /// Returns copy of operator stats. If 'clear' is true, the function also
   /// clears the operator stats after retrieval.
   OperatorStats stats(bool clear);
@@ -469,6 +535,12 @@ class Operator : public BaseRuntimeStatWriter {
     return operatorCtx_.get();
   }
 
+  /// Returns the capture of the input of this operator or nullptr if the
+  /// input is not captured. Called by the Driver before addInput().
+  InputCapture* inputCapture() const {
+    return inputCapture_.get();
+  }
+
  protected:
   static std::vector<std::unique_ptr<PlanNodeTranslator>>& translators();
 
@@ -476,6 +548,19 @@ class Operator : public BaseRuntimeStatWriter {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Keeps 'vector' of a previous output which a consumer still references,
+  // so that recycleRetainedVectors() can move it into the vector pool of
+  // 'this' once the consumer has released it. Ignores a vector that is not
+  // allocated from the pool of 'this', e.g. an input column, as keeping it
+  // would prevent the upstream operator from reusing it.
+  void retainForRecycle(VectorPtr vector);
+
+  // Moves the retained vectors which are no longer referenced elsewhere into
+  // the vector pool of 'this', from where the next output batches get their
+  // vectors. Keeps at most kMaxRetainedVectors of the still referenced ones,
+  // dropping the oldest.
+  void recycleRetainedVectors();
+
   // Returns the number of rows for the output batch. This uses averageRowSize
   // to calculate how many rows fit in preferredOutputBatchBytes. It caps the
   // number of rows at 10K and returns at least one row. The averageRowSize must
@@ -489,6 +574,10 @@ class Operator : public BaseRuntimeStatWriter {
   folly::Synchronized<OperatorStats> stats_;
   const RowTypePtr outputType_;
 
+  // Saves the input for replay if the query captures the input of the plan
+  // node. See QueryConfig::kInputCaptureDir.
+  std::unique_ptr<InputCapture> inputCapture_;
+
   // Holds the last data from addInput until it is processed. Reset after the
   // input is processed.
   RowVectorPtr input_;
@@ -507,6 +596,12 @@ class Operator : public BaseRuntimeStatWriter {
 
   std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
       dynamicFilters_;
+
+ private:
+  static constexpr int32_t kMaxRetainedVectors = 64;
+
+  // The vectors kept by retainForRecycle(), oldest first.
+  std::vector<VectorPtr> retainedVectors_;
 };
 
 /// Given a row type returns indices for the specified subset of columns.
@@ -17,8 +17,7 @@
 
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
-#include "velox/exec/RowContainer.h"
-#include "velox/exec/Spiller.h"
+#include "velox/exec/SortBuffer.h"
 
 namespace facebook::velox::exec {
 
@@ -27,7 +26,7 @@ namespace facebook::velox::exec {
 /// it blocks the pipeline. Once all inputs are available, it sorts pointers
 /// to the rows using the RowContainer's compare() function. And finally it
 /// constructs and returns the sorted output RowVector using the data in the
-/// RowContainer.
+/// RowContainer. The buffering, spilling and sorting is done by SortBuffer.
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
@@ -56,76 +55,17 @@ class OrderBy : public Operator {
     return finished_;
   }
 
- private:
-  // Checks if input will fit in the existing memory and increases
-  // reservation if not. If reservation cannot be increased, spills enough to
-  // make 'input' fit.
-  void ensureInputFits(const RowVectorPtr& input);
-
-  // Prepare the reusable output buffer based on the output batch size and the
-  // remaining rows to return.
-  void prepareOutput();
-
-  void getOutputWithoutSpill();
-  void getOutputWithSpill();
-
-  // Spills content until under 'targetRows' and under 'targetBytes' of out of
-  // line data are left. If 'targetRows' is 0, spills everything and physically
-  // frees the data in the 'data_'. This is called by ensureInputFits or by
-  // external memory management. In the latter case, the Driver of this will be
-  // in a paused state and off thread.
-  void spill(int64_t targetRows, int64_t targetBytes);
-
-  const int32_t numSortKeys_;
-
-  // The maximum memory usage that an order by can hold before spilling.
-  // If it is zero, then there is no such limit.
-  const uint64_t spillMemoryThreshold_;
-
-  // Filesystem path for spill files, empty if spilling is disabled.
-  // The disk spilling related configs if spilling is enabled, otherwise null.
-  const std::optional<Spiller::Config> spillConfig_;
-
-  // The map from column channel in 'output_' to the corresponding one stored in
-  // 'data_'. The column channel might be reordered to ensure the sorting key
-  // columns stored first in 'data_'.
-  std::vector<IdentityProjection> columnMap_;
-
-  std::vector<CompareFlags> keyCompareFlags_;
+  bool canReclaim() const override;
 
-  std::unique_ptr<RowContainer> data_;
+  uint64_t reclaimableBytes() const override;
 
-  // The row type used to store input data in row container and for spilling
-  // internally.
-  RowTypePtr internalStoreType_;
+  void reclaim(uint64_t targetBytes) override;
 
-  // Maximum number of rows in the output batch.
-  uint32_t outputBatchSize_;
-
-  // Possibly reusable output vector.
-  RowVectorPtr output_;
-
-  // The number of input rows.
-  size_t numRows_ = 0;
-
-  // The number of rows has been returned for output.
-  size_t numRowsReturned_ = 0;
-
-  // Used to collect sorted rows from 'data_' on non-spilling output path.
-  std::vector<char*> returningRows_;
-
-  std::unique_ptr<Spiller> spiller_;
-
-  // Counts input batches and triggers spilling if folly hash of this % 100 <=
-  // 'testSpillPct_';.
-  uint64_t spillTestCounter_{0};
-
-  // Set to read back spilled data if disk spilling has been triggered.
-  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+ private:
+  // Updates the spill stats of 'this' from 'sortBuffer_'.
+  void updateSpillStats();
 
-  // Record the source rows to copy to 'output_' in order.
-  std::vector<const RowVector*> spillSources_;
-  std::vector<vector_size_t> spillSourceRows_;
+  std::unique_ptr<SortBuffer> sortBuffer_;
 
   bool finished_ = false;
 };
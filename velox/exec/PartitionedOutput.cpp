@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 
 namespace facebook::velox::exec {
@@ -59,6 +60,74 @@ BlockingReason Destination::advance(
   return BlockingReason::kNotBlocked;
 }
 
+void Destination::appendRowWise(const RowVectorPtr& output) {
+  if (row_ >= rows_.size()) {
+    return;
+  }
+  if (rowWiseStream_ == nullptr) {
+    rowType_ = asRowType(output->type());
+    rowWiseArena_ = std::make_unique<StreamArena>(pool_);
+    rowWiseStream_ = std::make_unique<ByteStream>(rowWiseArena_.get());
+    rowWiseStream_->startWrite(1024);
+  }
+  const auto numColumns = output->childrenSize();
+  std::vector<const BaseVector*> columns(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    columns[i] = output->childAt(i)->loadedVector();
+  }
+  const auto& serde = ContainerRowSerde::instance();
+  std::vector<uint64_t> nulls(bits::nwords(numColumns));
+  for (; row_ < rows_.size(); ++row_) {
+    const auto& range = rows_[row_];
+    for (auto row = range.begin; row < range.begin + range.size; ++row) {
+      std::fill(nulls.begin(), nulls.end(), 0);
+      for (auto i = 0; i < numColumns; ++i) {
+        if (columns[i]->isNullAt(row)) {
+          bits::setBit(nulls.data(), i);
+        }
+      }
+      rowWiseStream_->append<uint64_t>(nulls);
+      for (auto i = 0; i < numColumns; ++i) {
+        if (!bits::isBitSet(nulls.data(), i)) {
+          serde.serialize(*columns[i], row, *rowWiseStream_);
+        }
+      }
+    }
+    numRowWiseRows_ += range.size;
+  }
+  bytesInCurrent_ = rowWiseStream_->size();
+}
+
+RowVectorPtr Destination::readRowWise() {
+  auto result =
+      BaseVector::create<RowVector>(rowType_, numRowWiseRows_, pool_);
+  std::vector<ByteRange> ranges = rowWiseStream_->ranges();
+  for (auto& range : ranges) {
+    range.position = 0;
+  }
+  ranges.back().size = rowWiseStream_->lastRangeEnd();
+  ByteStream input;
+  input.resetInput(std::move(ranges));
+
+  const auto numColumns = rowType_->size();
+  const auto& serde = ContainerRowSerde::instance();
+  std::vector<uint64_t> nulls(bits::nwords(numColumns));
+  for (auto row = 0; row < numRowWiseRows_; ++row) {
+    for (auto& word : nulls) {
+      word = input.read<uint64_t>();
+    }
+    for (auto i = 0; i < numColumns; ++i) {
+      auto& column = result->childAt(i);
+      if (bits::isBitSet(nulls.data(), i)) {
+        column->setNull(row, true);
+      } else {
+        serde.deserialize(input, row, column.get());
+      }
+    }
+  }
+  return result;
+}
+
 void Destination::serialize(
     const RowVectorPtr& output,
     vector_size_t begin,
@@ -70,7 +139,7 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    current_->createStreamTree(rowType, numRows, &serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -79,18 +148,40 @@ BlockingReason Destination::flush(
     PartitionedOutputBufferManager& bufferManager,
     const std::function<void()>& bufferReleaseFn,
     ContinueFuture* future) {
+  if (numRowWiseRows_ > 0) {
+    auto rows = readRowWise();
+    rowWiseStream_.reset();
+    rowWiseArena_.reset();
+    numRowWiseRows_ = 0;
+    current_ = std::make_unique<VectorStreamGroup>(pool_);
+    current_->createStreamTree(rowType_, rows->size(), &serdeOptions_);
+    IndexRange allRows{0, rows->size()};
+    current_->append(rows, folly::Range(&allRows, 1));
+  }
   if (!current_) {
     return BlockingReason::kNotBlocked;
   }
   // Upper limit of message size with no columns.
   constexpr int32_t kMinMessageSize = 128;
   auto listener = bufferManager.newListener();
+  // The pages of a zero copy flush keep 'group' alive and reference its
+  // ranges, so the stream needs space only for what is copied.
+  std::shared_ptr<VectorStreamGroup> group = std::move(current_);
   IOBufOutputStream stream(
-      *current_->pool(),
+      *group->pool(),
       listener.get(),
-      std::max<int64_t>(kMinMessageSize, current_->size()));
-  current_->flush(&stream);
-  current_.reset();
+      zeroCopy_ ? kMinMessageSize
+                : std::max<int64_t>(kMinMessageSize, group->size()));
+  if (zeroCopy_) {
+    stream.shareRanges(group);
+  }
+  group->flush(&stream);
+  if (recordRuntimeStat_) {
+    for (const auto& [name, value] : group->runtimeStats()) {
+      recordRuntimeStat_(name, value);
+    }
+  }
+  group.reset();
   bytesInCurrent_ = 0;
   setTargetSizePct();
 
@@ -130,7 +221,15 @@ PartitionedOutput::PartitionedOutput(
       bufferReleaseFn_([task = operatorCtx_->task()]() {}),
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
-                            .maxPartitionedOutputBufferSize()) {
+                            .maxPartitionedOutputBufferSize()),
+      serdeOptions_(
+          shuffleSerdeOptions(ctx->task->queryCtx()->queryConfig())),
+      zeroCopy_(ctx->queryConfig().shuffleZeroCopy()),
+      rowWise_(
+          numDestinations_ > 1 &&
+          ctx->queryConfig().partitionedOutputRowWiseDestinations() > 0 &&
+          numDestinations_ >=
+              ctx->queryConfig().partitionedOutputRowWiseDestinations()) {
   if (numDestinations_ == 1 || planNode->isBroadcast()) {
     VELOX_CHECK(keyChannels_.empty());
     VELOX_CHECK_NULL(partitionFunction_);
@@ -162,7 +261,15 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(std::make_unique<Destination>(taskId, i, pool()));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId,
+          i,
+          pool(),
+          serdeOptions_,
+          [this](const std::string& name, const RuntimeCounter& value) {
+            addRuntimeStat(name, value);
+          },
+          zeroCopy_));
     }
   }
 }
@@ -282,8 +389,14 @@ RowVectorPtr PartitionedOutput::getOutput() {
   VELOX_CHECK_NOT_NULL(
       bufferManager, "PartitionedOutputBufferManager was already destructed");
 
-  bool workLeft;
-  do {
+  if (rowWise_) {
+    if (advanceRowWise(*bufferManager)) {
+      return nullptr;
+    }
+  }
+
+  bool workLeft = !rowWise_;
+  while (workLeft) {
     workLeft = false;
     for (auto& destination : destinations_) {
       bool atEnd = false;
@@ -307,7 +420,7 @@ RowVectorPtr PartitionedOutput::getOutput() {
         workLeft = true;
       }
     }
-  } while (workLeft);
+  }
 
   if (blockedDestination) {
     // If we are going off-thread, we may as well make the output in
@@ -343,6 +456,55 @@ RowVectorPtr PartitionedOutput::getOutput() {
   return nullptr;
 }
 
+bool PartitionedOutput::advanceRowWise(
+    PartitionedOutputBufferManager& bufferManager) {
+  if (output_ != nullptr) {
+    for (auto& destination : destinations_) {
+      destination->appendRowWise(output_);
+    }
+  }
+
+  const uint64_t maxBytes = maxBufferedBytes_;
+  uint64_t bufferedBytes = 0;
+  for (auto& destination : destinations_) {
+    if (destination->serializedBytes() >= kMaxRowWisePageSize) {
+      blockingReason_ =
+          destination->flush(bufferManager, bufferReleaseFn_, &future_);
+      if (blockingReason_ != BlockingReason::kNotBlocked) {
+        return true;
+      }
+    }
+    bufferedBytes += destination->serializedBytes();
+  }
+  if (bufferedBytes <= maxBytes) {
+    return false;
+  }
+
+  std::vector<Destination*> largest;
+  largest.reserve(destinations_.size());
+  for (auto& destination : destinations_) {
+    largest.push_back(destination.get());
+  }
+  std::sort(
+      largest.begin(),
+      largest.end(),
+      [](Destination* left, Destination* right) {
+        return left->serializedBytes() > right->serializedBytes();
+      });
+  for (auto* destination : largest) {
+    if (bufferedBytes <= maxBytes / 2) {
+      break;
+    }
+    bufferedBytes -= destination->serializedBytes();
+    blockingReason_ =
+        destination->flush(bufferManager, bufferReleaseFn_, &future_);
+    if (blockingReason_ != BlockingReason::kNotBlocked) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool PartitionedOutput::isFinished() {
   return finished_;
 }
@@ -24,11 +24,28 @@ namespace facebook::velox::exec {
 
 class Destination {
  public:
+  /// Receives the runtime stats of the serializer, e.g. of compression, for
+  /// each flushed page.
+  using RuntimeStatsRecorder =
+      std::function<void(const std::string& name, const RuntimeCounter&)>;
+
+  /// @param serdeOptions Options of the serializer, e.g. the compression
+  /// codec.
+  /// @param zeroCopy If true, the pages reference the serialized columns
+  /// instead of copies of them, see IOBufOutputStream::shareRanges().
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool)
-      : taskId_(taskId), destination_(destination), pool_(pool) {
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const VectorSerde::Options& serdeOptions = {},
+      RuntimeStatsRecorder recordRuntimeStat = nullptr,
+      bool zeroCopy = false)
+      : taskId_(taskId),
+        destination_(destination),
+        pool_(pool),
+        serdeOptions_(serdeOptions),
+        recordRuntimeStat_(std::move(recordRuntimeStat)),
+        zeroCopy_(zeroCopy) {
     setTargetSizePct();
   }
 
@@ -55,6 +72,13 @@ class Destination {
       bool* FOLLY_NONNULL atEnd,
       ContinueFuture* FOLLY_NONNULL future);
 
+  /// Serializes the rows added since beginBatch() that are not yet
+  /// serialized into a row-wise buffer instead of a page. The buffer holds
+  /// the rows in one stream instead of streams per column, so that many
+  /// destinations can buffer more rows in the same memory. flush() makes a
+  /// page of the buffered rows.
+  void appendRowWise(const RowVectorPtr& output);
+
   BlockingReason flush(
       PartitionedOutputBufferManager& bufferManager,
       const std::function<void()>& bufferReleaseFn,
@@ -73,6 +97,9 @@ class Destination {
   }
 
  private:
+  // Returns the rows in 'rowWiseStream_'.
+  RowVectorPtr readRowWise();
+
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
@@ -92,6 +119,9 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MemoryPool* FOLLY_NONNULL const pool_;
+  const VectorSerde::Options serdeOptions_;
+  const RuntimeStatsRecorder recordRuntimeStat_;
+  const bool zeroCopy_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
@@ -100,6 +130,13 @@ class Destination {
   std::unique_ptr<VectorStreamGroup> current_;
   bool finished_{false};
 
+  // The rows buffered by appendRowWise(), serialized with ContainerRowSerde.
+  // Each row starts with the null flags of its columns.
+  RowTypePtr rowType_;
+  std::unique_ptr<StreamArena> rowWiseArena_;
+  std::unique_ptr<ByteStream> rowWiseStream_;
+  vector_size_t numRowWiseRows_{0};
+
   // Flush accumulated data to buffer manager after reaching this
   // percentage of target bytes or rows. This will make data for
   // different destinations ready at different times to flatten a
@@ -122,12 +159,22 @@ class Destination {
 // partitioned, and divides the stream into a series of output data ready to be
 // sent to other workers. This operator is also capable of re-ordering and
 // dropping columns from its input.
+//
+// With many destinations, each destination gets a small share of the buffer
+// size and the pages are small. With at least
+// 'driver.partitioned-output-row-wise-destinations' destinations, the rows
+// are instead buffered row-wise per destination. The destinations then share
+// the buffer size, and the largest ones are flushed when the buffers are full.
 class PartitionedOutput : public Operator {
  public:
   // Minimum flush size for non-final flush. 60KB + overhead fits a
   // network MTU of 64K.
   static constexpr uint64_t kMinDestinationSize = 60 * 1024;
 
+  /// With row-wise buffering, a destination is flushed when its buffer
+  /// reaches this size.
+  static constexpr uint64_t kMaxRowWisePageSize = 1 << 20;
+
   PartitionedOutput(
       int32_t operatorId,
       DriverCtx* FOLLY_NONNULL ctx,
@@ -173,6 +220,12 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  /// Adds the rows of 'output_' to the row-wise buffers of the destinations.
+  /// Flushes the destinations that reach kMaxRowWisePageSize and, if the
+  /// buffers take more than 'maxBufferedBytes_', the largest ones until they
+  /// take less than half of it. Returns true if a flush was blocked.
+  bool advanceRowWise(PartitionedOutputBufferManager& bufferManager);
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -182,6 +235,12 @@ class PartitionedOutput : public Operator {
   const std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
+  const VectorSerde::Options serdeOptions_;
+  // See QueryConfig::kShuffleZeroCopy.
+  const bool zeroCopy_;
+  // True if the destinations buffer rows row-wise and share
+  // 'maxBufferedBytes_'. See 'driver.partitioned-output-row-wise-destinations'.
+  const bool rowWise_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
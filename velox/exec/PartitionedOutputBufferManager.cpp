@@ -25,7 +25,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
 
-  if (sequence - sequence_ > data_.size()) {
+  if (sequence - sequence_ > numPages()) {
     VLOG(0) << this << " Out of order get: " << sequence << " over "
             << sequence_ << " Setting second notify " << notifySequence_
             << " / " << sequence;
@@ -34,13 +34,14 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     notifyMaxBytes_ = maxBytes;
     return {};
   }
-  if (sequence - sequence_ == data_.size()) {
+  if (sequence - sequence_ == numPages()) {
     notify_ = notify;
     notifySequence_ = sequence;
     notifyMaxBytes_ = maxBytes;
     return {};
   }
 
+  unspool(sequence - sequence_, maxBytes);
   std::vector<std::unique_ptr<folly::IOBuf>> result;
   uint64_t resultBytes = 0;
   for (auto i = sequence - sequence_; i < data_.size(); i++) {
@@ -120,12 +121,112 @@ DestinationBuffer::deleteResults() {
     freed.push_back(std::move(data_[i]));
   }
   data_.clear();
+  for (auto& page : tail_) {
+    if (page) {
+      freed.push_back(std::move(page));
+    }
+  }
+  tail_.clear();
+  // The spill files are removed with the spill directory of the task.
+  spooled_.clear();
+  numSpooledPages_ = 0;
   return freed;
 }
 
+uint64_t DestinationBuffer::spoolableBytes() const {
+  const auto& pages = spooled_.empty() ? data_ : tail_;
+  uint64_t bytes = 0;
+  for (auto i = spooled_.empty() ? 1 : 0; i < pages.size(); ++i) {
+    if (pages[i]) {
+      bytes += pages[i]->size();
+    }
+  }
+  return bytes;
+}
+
+uint64_t DestinationBuffer::spool(
+    const std::string& path,
+    memory::MemoryPool& pool) {
+  auto& pages = spooled_.empty() ? data_ : tail_;
+  const int32_t begin = spooled_.empty() ? 1 : 0;
+  int32_t end = pages.size();
+  const bool atEnd = end > begin && pages.back() == nullptr;
+  if (atEnd) {
+    --end;
+  }
+  if (end <= begin) {
+    return 0;
+  }
+
+  auto file = std::make_unique<SpillFile>(
+      ROW({}, {}), 0, std::vector<CompareFlags>{}, path, pool);
+  auto& output = file->output();
+  uint64_t bytes = 0;
+  for (auto i = begin; i < end; ++i) {
+    // Each page is written as its size followed by its bytes.
+    const int64_t size = pages[i]->size();
+    output.append(std::string_view(
+        reinterpret_cast<const char*>(&size), sizeof(size)));
+    auto iobuf = pages[i]->getIOBuf();
+    for (const auto& range : *iobuf) {
+      output.append(std::string_view(
+          reinterpret_cast<const char*>(range.data()), range.size()));
+    }
+    bytes += size;
+  }
+  file->finishWrite();
+
+  spoolPool_ = &pool;
+  spooled_.push_back({std::move(file), end - begin, nullptr});
+  numSpooledPages_ += end - begin;
+  pages.resize(begin);
+  // An end marker goes after the spooled pages.
+  if (atEnd) {
+    tail_.push_back(nullptr);
+  }
+  return bytes;
+}
+
+void DestinationBuffer::unspool(int64_t index, uint64_t maxBytes) {
+  if (spooled_.empty()) {
+    return;
+  }
+  uint64_t bytes = 0;
+  for (auto i = index; i < data_.size(); ++i) {
+    bytes += data_[i]->size();
+  }
+  while (!spooled_.empty() && (data_.size() <= index || bytes < maxBytes)) {
+    auto& spooled = spooled_.front();
+    if (spooled.input == nullptr) {
+      spooled.input = spooled.file->makeInput(*spoolPool_);
+    }
+    const auto size = spooled.input->read<int64_t>();
+    auto iobuf = folly::IOBuf::create(size);
+    spooled.input->readBytes(iobuf->writableData(), size);
+    iobuf->append(size);
+    data_.push_back(std::make_shared<SerializedPage>(std::move(iobuf)));
+    if (data_.size() > index) {
+      bytes += size;
+    }
+    unspooledBytes_ += size;
+    --numSpooledPages_;
+    if (--spooled.numPages == 0) {
+      spooled_.pop_front();
+    }
+  }
+  if (spooled_.empty()) {
+    data_.insert(
+        data_.end(),
+        std::make_move_iterator(tail_.begin()),
+        std::make_move_iterator(tail_.end()));
+    tail_.clear();
+  }
+}
+
 std::string DestinationBuffer::toString() {
   std::stringstream out;
-  out << "[available: " << data_.size() << ", "
+  out << "[available: " << numPages() << ", "
+      << "spooled: " << numSpooledPages_ << ", "
       << "sequence: " << sequence_ << ", "
       << (notify_ ? "notify registered, " : "") << this << "]";
   return out.str();
@@ -144,6 +245,18 @@ void releaseAfterAcknowledge(
     promise.setValue();
   }
 }
+
+// Returns the path prefix of the spill files of spooled pages or an empty
+// string if 'task' does not spool its output.
+std::string makeSpoolPath(const Task& task, bool broadcast) {
+  const auto& config = task.queryCtx()->queryConfig();
+  if (broadcast || !config.spillEnabled() ||
+      !config.partitionedOutputSpoolEnabled() ||
+      task.spillDirectory().empty()) {
+    return "";
+  }
+  return fmt::format("{}/output-buffer", task.spillDirectory());
+}
 } // namespace
 
 PartitionedOutputBuffer::PartitionedOutputBuffer(
@@ -156,7 +269,11 @@ PartitionedOutputBuffer::PartitionedOutputBuffer(
       numDrivers_(numDrivers),
       maxSize_(
           task_->queryCtx()->queryConfig().maxPartitionedOutputBufferSize()),
-      continueSize_((maxSize_ * kContinuePct) / 100) {
+      continueSize_((maxSize_ * kContinuePct) / 100),
+      spoolPath_(makeSpoolPath(*task_, broadcast_)) {
+  if (!spoolPath_.empty()) {
+    spoolPool_ = task_->pool()->addLeafChild("outputBufferSpool");
+  }
   buffers_.reserve(numDestinations);
   for (int i = 0; i < numDestinations; i++) {
     buffers_.push_back(std::make_unique<DestinationBuffer>());
@@ -252,6 +369,7 @@ BlockingReason PartitionedOutputBuffer::enqueue(
       if (auto buffer = buffers_[destination].get()) {
         buffer->enqueue(std::move(data));
         dataAvailableCallbacks.emplace_back(buffer->getAndClearNotify());
+        addUnspooledBytesLocked(*buffer);
       } else {
         // Some downstream tasks may finish early and delete the
         // corresponding buffers. Further data for these buffers is dropped.
@@ -259,6 +377,9 @@ BlockingReason PartitionedOutputBuffer::enqueue(
       }
     }
 
+    if (totalSize_ > maxSize_ && !spoolPath_.empty()) {
+      spoolLocked();
+    }
     if (totalSize_ > maxSize_ && future) {
       promises_.emplace_back("PartitionedOutputBuffer::enqueue");
       *future = promises_.back().getSemiFuture();
@@ -275,6 +396,32 @@ BlockingReason PartitionedOutputBuffer::enqueue(
                  : BlockingReason::kNotBlocked;
 }
 
+void PartitionedOutputBuffer::spoolLocked() {
+  std::vector<std::pair<uint64_t, DestinationBuffer*>> candidates;
+  for (auto& buffer : buffers_) {
+    if (buffer) {
+      const auto bytes = buffer->spoolableBytes();
+      if (bytes > 0) {
+        candidates.emplace_back(bytes, buffer.get());
+      }
+    }
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  for (auto& [bytes, buffer] : candidates) {
+    if (totalSize_ < continueSize_) {
+      break;
+    }
+    const auto spooledBytes = buffer->spool(spoolPath_, *spoolPool_);
+    VELOX_CHECK_LE(spooledBytes, totalSize_);
+    totalSize_ -= spooledBytes;
+  }
+}
+
 void PartitionedOutputBuffer::noMoreData() {
   checkIfDone(true); // Increment number of finished drivers.
 }
@@ -300,6 +447,7 @@ void PartitionedOutputBuffer::checkIfDone(bool oneDriverFinished) {
         if (buffer) {
           buffer->enqueue(nullptr);
           finished.push_back(buffer->getAndClearNotify());
+          addUnspooledBytesLocked(*buffer);
         }
       }
     }
@@ -431,6 +579,7 @@ void PartitionedOutputBuffer::getData(
     freed = destinationBuffer->acknowledge(sequence, true);
     updateAfterAcknowledgeLocked(freed, promises);
     data = destinationBuffer->getData(maxBytes, sequence, notify);
+    addUnspooledBytesLocked(*destinationBuffer);
   }
   releaseAfterAcknowledge(freed, promises);
   if (!data.empty()) {
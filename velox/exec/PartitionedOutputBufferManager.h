@@ -17,6 +17,7 @@
 
 #include "velox/exec/Exchange.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -40,15 +41,20 @@ struct DataAvailable {
   }
 };
 
+// Queue of pages for one destination. Pages that wait to be fetched may be
+// spooled to disk with spool(). The queue is then 'data_', followed by the
+// pages in 'spooled_', followed by 'tail_'. The spooled pages are read back
+// into 'data_' when they are fetched.
 class DestinationBuffer {
  public:
   void enqueue(std::shared_ptr<SerializedPage> data) {
+    auto& pages = spooled_.empty() ? data_ : tail_;
     // drop duplicate end markers
-    if (data == nullptr && !data_.empty() && data_.back() == nullptr) {
+    if (data == nullptr && !pages.empty() && pages.back() == nullptr) {
       return;
     }
 
-    data_.push_back(std::move(data));
+    pages.push_back(std::move(data));
   }
 
   // Returns a shallow copy (folly::IOBuf::clone) of the data starting at
@@ -72,10 +78,49 @@ class DestinationBuffer {
   // the callback.
   DataAvailable getAndClearNotify();
 
+  // Returns the bytes of the pages that spool() would write.
+  uint64_t spoolableBytes() const;
+
+  // Writes the pages that wait to be fetched to a new spill file with path
+  // prefix 'path' and removes them from memory. Keeps the first page of
+  // 'data_' in memory for the next fetch. Returns the bytes of the removed
+  // pages.
+  uint64_t spool(const std::string& path, memory::MemoryPool& pool);
+
+  // Returns the bytes of the pages read back from spill files since the last
+  // call.
+  uint64_t takeUnspooledBytes() {
+    return std::exchange(unspooledBytes_, 0);
+  }
+
   std::string toString();
 
  private:
+  struct SpooledPages {
+    std::unique_ptr<SpillFile> file;
+    int32_t numPages;
+    // Reads 'file'. Set when the first page is read back.
+    std::unique_ptr<SpillInput> input;
+  };
+
+  // Returns the number of pages, including the spooled ones.
+  int64_t numPages() const {
+    return data_.size() + numSpooledPages_ + tail_.size();
+  }
+
+  // Reads back spooled pages into 'data_' until 'data_' has at least
+  // 'maxBytes' from 'index' or there are no more spooled pages. Moves
+  // 'tail_' to 'data_' once all spooled pages are read back.
+  void unspool(int64_t index, uint64_t maxBytes);
+
   std::vector<std::shared_ptr<SerializedPage>> data_;
+  // Spill files with the pages that follow 'data_', in order.
+  std::deque<SpooledPages> spooled_;
+  int64_t numSpooledPages_{0};
+  // Pages enqueued after the first spill file was written.
+  std::vector<std::shared_ptr<SerializedPage>> tail_;
+  memory::MemoryPool* spoolPool_{nullptr};
+  uint64_t unspooledBytes_{0};
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
   DataAvailableCallback notify_ = nullptr;
@@ -154,6 +199,15 @@ class PartitionedOutputBuffer {
   /// and enqueue data that has been produced so far (e.g. dataToBroadcast_).
   void addBroadcastOutputBuffersLocked(int numBuffers);
 
+  /// Spools the largest destinations until 'totalSize_' is below
+  /// 'continueSize_' or no more pages can be spooled.
+  void spoolLocked();
+
+  /// Adds the bytes 'buffer' read back from spill files to 'totalSize_'.
+  void addUnspooledBytesLocked(DestinationBuffer& buffer) {
+    totalSize_ += buffer.takeUnspooledBytes();
+  }
+
   const std::shared_ptr<Task> task_;
   const bool broadcast_;
   /// Total number of drivers expected to produce results. This number will
@@ -166,6 +220,12 @@ class PartitionedOutputBuffer {
   /// resumed.
   const uint64_t continueSize_;
 
+  /// Path prefix of the spill files of spooled pages. Empty if spooling is
+  /// disabled.
+  const std::string spoolPath_;
+  /// Pool for reading back spooled pages. Set if 'spoolPath_' is set.
+  std::shared_ptr<memory::MemoryPool> spoolPool_;
+
   bool noMoreBroadcastBuffers_ = false;
 
   // While noMoreBroadcastBuffers_ is false, stores the enqueued data to
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/PeriodicStatsReporter.h"
+
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/exec/Driver.h"
+#include "velox/exec/Exchange.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// Returns the growth of a cumulative stat since the previous report.
+template <typename T>
+size_t delta(T current, T previous) {
+  return current > previous ? current - previous : 0;
+}
+} // namespace
+
+PeriodicStatsReporter::PeriodicStatsReporter(const Options& options)
+    : options_(options) {
+  VELOX_CHECK_GT(options_.intervalMs, 0);
+}
+
+PeriodicStatsReporter::~PeriodicStatsReporter() {
+  stop();
+}
+
+void PeriodicStatsReporter::start() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!thread_.joinable(), "PeriodicStatsReporter already started");
+  stop_ = false;
+  thread_ = std::thread([this]() {
+    std::unique_lock<std::mutex> l(mutex_);
+    while (!stop_) {
+      stopped_.wait_for(
+          l, std::chrono::milliseconds(options_.intervalMs), [&]() {
+            return stop_;
+          });
+      if (stop_) {
+        break;
+      }
+      l.unlock();
+      report();
+      l.lock();
+    }
+  });
+}
+
+void PeriodicStatsReporter::stop() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stop_ = true;
+  }
+  stopped_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PeriodicStatsReporter::report() {
+  reportAllocatorStats();
+  reportCacheStats();
+  reportArbitratorStats();
+  reportExecutorStats();
+  REPORT_ADD_STAT_VALUE(
+      kCounterNumBlockedDrivers, BlockingState::numBlockedDrivers());
+  REPORT_ADD_STAT_VALUE(
+      kCounterExchangeQueuedBytes,
+      std::max<int64_t>(0, ExchangeQueue::totalQueuedBytes()));
+}
+
+void PeriodicStatsReporter::reportAllocatorStats() {
+  const auto* allocator = options_.allocator;
+  if (allocator == nullptr) {
+    return;
+  }
+  REPORT_ADD_STAT_VALUE(
+      kCounterAllocatedBytes,
+      allocator->numAllocated() * memory::AllocationTraits::kPageSize);
+  REPORT_ADD_STAT_VALUE(
+      kCounterMappedBytes,
+      allocator->numMapped() * memory::AllocationTraits::kPageSize);
+  REPORT_ADD_STAT_VALUE(kCounterAllocatorCachedBytes, allocator->cachedBytes());
+}
+
+void PeriodicStatsReporter::reportCacheStats() {
+  const auto* cache = options_.cache;
+  if (cache == nullptr) {
+    return;
+  }
+  const auto stats = cache->refreshStats();
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumEntries, stats.numEntries);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumEmptyEntries, stats.numEmptyEntries);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumSharedEntries, stats.numShared);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumExclusiveEntries, stats.numExclusive);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumPrefetchedEntries, stats.numPrefetch);
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheTotalBytes, stats.tinySize + stats.largeSize);
+  REPORT_ADD_STAT_VALUE(kCounterCachePrefetchBytes, stats.prefetchBytes);
+
+  const auto numHits = delta(stats.numHit, lastCacheStats_.numHit);
+  const auto numNew = delta(stats.numNew, lastCacheStats_.numNew);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumHits, numHits);
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheHitBytes, delta(stats.hitBytes, lastCacheStats_.hitBytes));
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumNew, numNew);
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumEvicts, delta(stats.numEvict, lastCacheStats_.numEvict));
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumEvictChecks,
+      delta(stats.numEvictChecks, lastCacheStats_.numEvictChecks));
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumWaitExclusive,
+      delta(stats.numWaitExclusive, lastCacheStats_.numWaitExclusive));
+  // A lookup either hits or makes a new entry. There is no rate for an
+  // interval without lookups.
+  if (numHits + numNew > 0) {
+    REPORT_ADD_STAT_VALUE(
+        kCounterCacheHitRatePct, numHits * 100 / (numHits + numNew));
+  }
+  lastCacheStats_ = stats;
+
+  if (cache->ssdCache() == nullptr) {
+    return;
+  }
+  const auto ssdStats = cache->ssdCache()->stats();
+  const auto& last = lastSsdStats_;
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheEntriesRead,
+      delta<uint64_t>(ssdStats.entriesRead, last.entriesRead));
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheBytesRead,
+      delta<uint64_t>(ssdStats.bytesRead, last.bytesRead));
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheEntriesWritten,
+      delta<uint64_t>(ssdStats.entriesWritten, last.entriesWritten));
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheBytesWritten,
+      delta<uint64_t>(ssdStats.bytesWritten, last.bytesWritten));
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheEntriesCached,
+      static_cast<uint64_t>(ssdStats.entriesCached));
+  REPORT_ADD_STAT_VALUE(
+      kCounterSsdCacheBytesCached, static_cast<uint64_t>(ssdStats.bytesCached));
+  lastSsdStats_ = ssdStats;
+}
+
+void PeriodicStatsReporter::reportArbitratorStats() {
+  const auto* arbitrator = options_.arbitrator;
+  if (arbitrator == nullptr) {
+    return;
+  }
+  const auto stats = arbitrator->stats();
+  const auto& last = lastArbitratorStats_;
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorNumRequests,
+      delta(stats.numRequests, last.numRequests));
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorNumFailures,
+      delta(stats.numFailures, last.numFailures));
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorQueueTimeUs,
+      delta(stats.queueTimeUs, last.queueTimeUs));
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorArbitrationTimeUs,
+      delta(stats.arbitrationTimeUs, last.arbitrationTimeUs));
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorShrunkBytes,
+      delta(stats.numShrunkBytes, last.numShrunkBytes));
+  REPORT_ADD_STAT_VALUE(
+      kCounterArbitratorReclaimedBytes,
+      delta(stats.numReclaimedBytes, last.numReclaimedBytes));
+  lastArbitratorStats_ = stats;
+}
+
+void PeriodicStatsReporter::reportExecutorStats() {
+  const auto* executor = options_.executor;
+  if (executor == nullptr) {
+    return;
+  }
+  auto stats = executor->stats();
+  uint64_t numQueued = 0;
+  for (auto count : stats.levelQueuedDrivers) {
+    numQueued += count;
+  }
+  REPORT_ADD_STAT_VALUE(kCounterNumQueuedDrivers, numQueued);
+  REPORT_ADD_STAT_VALUE(
+      kCounterNumDriverRuns, delta(stats.numRuns, lastExecutorStats_.numRuns));
+  REPORT_ADD_STAT_VALUE(
+      kCounterNumDriverYields,
+      delta(stats.numYields, lastExecutorStats_.numYields));
+  lastExecutorStats_ = std::move(stats);
+}
+
+} // namespace facebook::velox::exec
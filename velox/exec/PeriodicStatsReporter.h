@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/SsdFile.h"
+#include "velox/common/memory/MemoryAllocator.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+#include "velox/exec/MultiLevelTaskExecutor.h"
+
+namespace facebook::velox::exec {
+
+/// Reports the stats of the cache, the memory allocator, the memory
+/// arbitrator and the executor of a process through BaseStatsReporter at a
+/// fixed interval. Gauges like the cached bytes or the number of queued
+/// Drivers are reported as is. Cumulative stats like cache hits or
+/// arbitration requests are reported as the difference since the previous
+/// report, so that a SUM counter adds up to the total. The counter keys are
+/// in velox/common/base/Counters.h.
+///
+/// Events that are not kept in any of these objects, e.g. spill writes,
+/// memory allocation failures and the time Drivers spend in each state, are
+/// reported where they happen.
+class PeriodicStatsReporter {
+ public:
+  struct Options {
+    /// The objects to report on. Any of them may be nullptr.
+    const memory::MemoryAllocator* allocator{nullptr};
+    const cache::AsyncDataCache* cache{nullptr};
+    const memory::MemoryArbitrator* arbitrator{nullptr};
+    const MultiLevelTaskExecutor* executor{nullptr};
+
+    /// Time between two reports of the background thread.
+    uint64_t intervalMs{60'000};
+  };
+
+  explicit PeriodicStatsReporter(const Options& options);
+
+  /// Stops the background thread if running.
+  ~PeriodicStatsReporter();
+
+  /// Starts a thread that calls report() every 'intervalMs'.
+  void start();
+
+  /// Stops and joins the thread started by start().
+  void stop();
+
+  /// Reports all stats once. Called by the background thread and by tests.
+  void report();
+
+ private:
+  void reportAllocatorStats();
+
+  void reportCacheStats();
+
+  void reportArbitratorStats();
+
+  void reportExecutorStats();
+
+  const Options options_;
+
+  // The cumulative stats at the previous report.
+  cache::CacheStats lastCacheStats_;
+  cache::SsdCacheStats lastSsdStats_;
+  memory::MemoryArbitrator::Stats lastArbitratorStats_;
+  MultiLevelTaskExecutor::Stats lastExecutorStats_;
+
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+} // namespace facebook::velox::exec
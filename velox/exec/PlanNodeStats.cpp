@@ -142,11 +142,17 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
       stat["outputVectors"] = operatorStat.second->outputVectors;
       stat["outputBytes"] = operatorStat.second->outputBytes;
       stat["cpuWallTiming"] = operatorStat.second->cpuWallTiming.toString();
+      stat["cpuNanos"] = operatorStat.second->cpuWallTiming.cpuNanos;
+      stat["wallNanos"] = operatorStat.second->cpuWallTiming.wallNanos;
       stat["blockedWallNanos"] = operatorStat.second->blockedWallNanos;
       stat["peakMemoryBytes"] = operatorStat.second->peakMemoryBytes;
       stat["numMemoryAllocations"] = operatorStat.second->numMemoryAllocations;
       stat["numDrivers"] = operatorStat.second->numDrivers;
       stat["numSplits"] = operatorStat.second->numSplits;
+      stat["spilledBytes"] = operatorStat.second->spilledBytes;
+      stat["spilledRows"] = operatorStat.second->spilledRows;
+      stat["spilledPartitions"] = operatorStat.second->spilledPartitions;
+      stat["spilledFiles"] = operatorStat.second->spilledFiles;
 
       folly::dynamic cs = folly::dynamic::object;
       for (const auto& cstat : operatorStat.second->customStats) {
@@ -160,6 +166,34 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
   return jsonStats;
 }
 
+folly::dynamic toDriverTimelinesJson(const TaskStats& stats) {
+  folly::dynamic events = folly::dynamic::array;
+  for (auto pipelineId = 0; pipelineId < stats.pipelineStats.size();
+       ++pipelineId) {
+    for (const auto& driverStats :
+         stats.pipelineStats[pipelineId].driverStats) {
+      for (const auto& event : driverStats.timeline) {
+        folly::dynamic traceEvent = folly::dynamic::object;
+        const auto kind = driverEventKindToString(event.kind);
+        traceEvent["name"] = event.kind == DriverStats::EventKind::kBlocked
+            ? fmt::format("{} {}", kind, blockingReasonToString(event.reason))
+            : kind;
+        traceEvent["cat"] = kind;
+        traceEvent["ph"] = "X";
+        traceEvent["ts"] = event.startMicros;
+        traceEvent["dur"] = event.durationMicros;
+        traceEvent["pid"] = pipelineId;
+        traceEvent["tid"] = driverStats.driverId;
+        events.push_back(std::move(traceEvent));
+      }
+    }
+  }
+  folly::dynamic trace = folly::dynamic::object;
+  trace["traceEvents"] = std::move(events);
+  trace["displayTimeUnit"] = "ms";
+  return trace;
+}
+
 namespace {
 void printCustomStats(
     const std::unordered_map<std::string, RuntimeMetric>& stats,
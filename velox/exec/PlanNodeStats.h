@@ -129,6 +129,13 @@ std::unordered_map<core::PlanNodeId, PlanNodeStats> toPlanStats(
 
 folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats);
 
+/// Returns the Driver timelines in 'stats' in the Chrome trace event format,
+/// which chrome://tracing and Perfetto open. Each pipeline is a process and
+/// each Driver a thread, with one complete event per queued, running or
+/// blocked interval. Empty unless the timelines were enabled with
+/// QueryConfig::kDriverTimelineEnabled.
+folly::dynamic toDriverTimelinesJson(const TaskStats& stats);
+
 /// Returns human-friendly representation of the plan augmented with runtime
 /// statistics. The result has the same plan representation as in
 /// PlanNode::toString(true, true), but each plan node includes an additional
@@ -16,9 +16,19 @@
 
 #include "velox/exec/RowContainer.h"
 
+#include "velox/common/base/SimdUtil.h"
+#include "velox/common/process/ProcessBase.h"
+
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 
+DEFINE_bool(
+    velox_row_container_string_key_prefix,
+    false,
+    "If true, RowContainer keeps the first 12 characters of VARCHAR and "
+    "VARBINARY keys in the row, so that most comparisons of long keys do not "
+    "read the out of line data");
+
 namespace facebook::velox::exec {
 namespace {
 template <TypeKind Kind>
@@ -44,6 +54,100 @@ setBit(char* bits, uint32_t idx) {
   auto bitsAs8Bit = reinterpret_cast<uint8_t*>(bits);
   bitsAs8Bit[idx / 8] |= (1 << (idx % 8));
 }
+
+// Returns the width of a value of 'kind' if it is stored in a row the way
+// it is stored in a FlatVector, 0 otherwise.
+int32_t fixedWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+      return typeKindSize(kind);
+    default:
+      return 0;
+  }
+}
+
+template <TypeKind Kind>
+char* mutableRawValues(BaseVector& vector, vector_size_t size) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  return vector.as<FlatVector<T>>()
+      ->mutableValues(size)
+      ->template asMutable<char>();
+}
+
+// A fixed width column copied by RowContainer::extractColumns.
+struct FixedWidthColumn {
+  int32_t offset;
+  int32_t nullByte;
+  uint8_t nullMask;
+  int32_t width;
+  char* values;
+  // Nullptr if the column has no null flags and no row is null.
+  uint64_t* nulls;
+};
+
+// Copies the 8 byte values at 'offset' of the rows in [begin, end) with a
+// gather per batch of rows. Returns the first row that is not copied.
+int32_t gatherValues(
+    const char* const* rows,
+    int32_t begin,
+    int32_t end,
+    int32_t offset,
+    int64_t* values) {
+  using Batch = xsimd::batch<int64_t>;
+  const auto offsets = xsimd::broadcast<int64_t>(offset);
+  auto row = begin;
+  for (; row + Batch::size <= end; row += Batch::size) {
+    auto addresses =
+        Batch::load_unaligned(reinterpret_cast<const int64_t*>(rows + row)) +
+        offsets;
+    simd::gather<int64_t, int64_t, 1>(
+        static_cast<const int64_t*>(nullptr), addresses)
+        .store_unaligned(values + row);
+  }
+  return row;
+}
+
+template <int32_t kWidth>
+void extractFixedWidth(
+    const char* const* rows,
+    int32_t begin,
+    int32_t end,
+    const FixedWidthColumn& column) {
+  if (!column.nulls) {
+    auto row = begin;
+    if constexpr (kWidth == sizeof(int64_t)) {
+      if (process::hasAvx2()) {
+        row = gatherValues(
+            rows,
+            begin,
+            end,
+            column.offset,
+            reinterpret_cast<int64_t*>(column.values));
+      }
+    }
+    for (; row < end; ++row) {
+      memcpy(column.values + row * kWidth, rows[row] + column.offset, kWidth);
+    }
+    return;
+  }
+  for (auto row = begin; row < end; ++row) {
+    const char* rowPtr = rows[row];
+    if (rowPtr == nullptr ||
+        (column.nullMask && (rowPtr[column.nullByte] & column.nullMask))) {
+      bits::setNull(column.nulls, row, true);
+    } else {
+      bits::setNull(column.nulls, row, false);
+      memcpy(column.values + row * kWidth, rowPtr + column.offset, kWidth);
+    }
+  }
+}
 } // namespace
 
 RowContainer::RowContainer(
@@ -90,6 +194,11 @@ RowContainer::RowContainer(
   // cardinality grows too large for packing all in 64
   // bits. 'numRowsWithNormalizedKey_' gives the number of rows with
   // the extra field.
+  //
+  // If FLAGS_velox_row_container_string_key_prefix is set, each VARCHAR or
+  // VARBINARY key is followed by kStringKeyPrefixSize bytes that hold the
+  // characters after the prefix of a non-inline StringView.
+  hasStringKeyPrefixes_ = FLAGS_velox_row_container_string_key_prefix;
   int32_t offset = 0;
   int32_t nullOffset = 0;
   bool isVariableWidth = false;
@@ -98,12 +207,18 @@ RowContainer::RowContainer(
     types_.push_back(type);
     offsets_.push_back(offset);
     offset += typeKindSize(type->kind());
+    if (hasStringKeyPrefixes_ &&
+        (type->kind() == TypeKind::VARCHAR ||
+         type->kind() == TypeKind::VARBINARY)) {
+      offset += kStringKeyPrefixSize;
+    }
     nullOffsets_.push_back(nullOffset);
     isVariableWidth |= !type->isFixedWidth();
     if (nullableKeys) {
       ++nullOffset;
     }
   }
+  keysEndOffset_ = offset;
   // Make offset at least sizeof pointer so that there is space for a
   // free list next pointer below the bit at 'freeFlagOffset_'.
   offset = std::max<int32_t>(offset, sizeof(void*));
@@ -368,6 +483,78 @@ void RowContainer::extractString(
       index, StringView(buffer->as<char>() + start, value.size()));
 }
 
+void RowContainer::extractColumns(
+    const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+    int32_t numRows,
+    folly::Range<const column_index_t*> columnIndices,
+    const std::vector<VectorPtr>& results) {
+  VELOX_CHECK_EQ(columnIndices.size(), results.size());
+  const bool hasNullRows =
+      std::find(rows, rows + numRows, nullptr) != rows + numRows;
+  std::vector<FixedWidthColumn> fixedWidthColumns;
+  int32_t maxOffset = 0;
+  for (auto i = 0; i < columnIndices.size(); ++i) {
+    const auto& result = results[i];
+    const auto column = columnAt(columnIndices[i]);
+    const auto width = fixedWidth(result->typeKind());
+    if (width == 0 || !result->isFlatEncoding()) {
+      extractColumn(rows, numRows, column, result);
+      continue;
+    }
+    result->resize(numRows);
+    uint64_t* nulls = nullptr;
+    if (column.nullMask() || hasNullRows) {
+      nulls = result->mutableRawNulls();
+    } else if (result->rawNulls()) {
+      result->clearNulls(0, numRows);
+    }
+    fixedWidthColumns.push_back(
+        {column.offset(),
+         column.nullByte(),
+         column.nullMask(),
+         width,
+         VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+             mutableRawValues, result->typeKind(), *result, numRows),
+         nulls});
+    maxOffset = std::max(maxOffset, column.offset());
+  }
+  if (fixedWidthColumns.empty()) {
+    return;
+  }
+
+  constexpr int32_t kBlockSize = 64;
+  for (int32_t begin = 0; begin < numRows; begin += kBlockSize) {
+    const auto end = std::min(begin + kBlockSize, numRows);
+    for (auto row = end; row < std::min(end + kBlockSize, numRows); ++row) {
+      if (rows[row]) {
+        __builtin_prefetch(rows[row]);
+        __builtin_prefetch(rows[row] + maxOffset);
+      }
+    }
+    for (const auto& column : fixedWidthColumns) {
+      switch (column.width) {
+        case 1:
+          extractFixedWidth<1>(rows, begin, end, column);
+          break;
+        case 2:
+          extractFixedWidth<2>(rows, begin, end, column);
+          break;
+        case 4:
+          extractFixedWidth<4>(rows, begin, end, column);
+          break;
+        case 8:
+          extractFixedWidth<8>(rows, begin, end, column);
+          break;
+        case 16:
+          extractFixedWidth<16>(rows, begin, end, column);
+          break;
+        default:
+          VELOX_UNREACHABLE();
+      }
+    }
+  }
+}
+
 void RowContainer::storeComplexType(
     const DecodedVector& decoded,
     vector_size_t index,
@@ -23,6 +23,8 @@
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/VectorTypeUtils.h"
 
+DECLARE_bool(velox_row_container_string_key_prefix);
+
 namespace facebook::velox::exec {
 
 using normalized_key_t = uint64_t;
@@ -299,6 +301,18 @@ class RowContainer {
         rows, rowNumbers, columnAt(columnIndex), resultOffset, result);
   }
 
+  /// Copies the values at 'columnIndices' into the vectors at the same
+  /// positions in 'results' for the 'numRows' rows pointed to by 'rows'. The
+  /// result is the same as calling extractColumn for each column. The fixed
+  /// width columns are copied together one block of rows at a time, so that
+  /// the cache lines of a row are loaded once for all of them, and the rows
+  /// of the next block are prefetched while a block is copied.
+  void extractColumns(
+      const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+      int32_t numRows,
+      folly::Range<const column_index_t*> columnIndices,
+      const std::vector<VectorPtr>& results);
+
   /// Copies the 'probed' flags for the specified rows into 'result'.
   /// The 'result' is expected to be flat vector of type boolean.
   /// For rows with null keys, sets null in 'result' if 'setNullForNullKeysRow'
@@ -623,6 +637,13 @@ class RowContainer {
   // Offset of the pointer to the next free row on a free row.
   static constexpr int32_t kNextFreeOffset = 0;
 
+  // Bytes after the StringView of a string key that hold the characters of a
+  // non-inline value following the prefix of the StringView if
+  // FLAGS_velox_row_container_string_key_prefix is set. With these, the first
+  // StringView::kInlineSize characters of any key are in the row.
+  static constexpr int32_t kStringKeyPrefixSize =
+      StringView::kInlineSize - StringView::kPrefixSize;
+
   template <typename T>
   static inline T valueAt(const char* FOLLY_NONNULL group, int32_t offset) {
     return *reinterpret_cast<const T*>(group + offset);
@@ -714,6 +735,7 @@ class RowContainer {
     }
     *reinterpret_cast<T*>(row + offset) = decoded.valueAt<T>(index);
     if constexpr (std::is_same_v<T, StringView>) {
+      storeStringKeyPrefix(row, offset);
       RowSizeTracker tracker(row[rowSizeOffset_], stringAllocator_);
       stringAllocator_.copyMultipart(row, offset);
     }
@@ -728,6 +750,7 @@ class RowContainer {
     using T = typename TypeTraits<Kind>::NativeType;
     *reinterpret_cast<T*>(group + offset) = decoded.valueAt<T>(index);
     if constexpr (std::is_same_v<T, StringView>) {
+      storeStringKeyPrefix(group, offset);
       RowSizeTracker tracker(group[rowSizeOffset_], stringAllocator_);
       stringAllocator_.copyMultipart(group, offset);
     }
@@ -839,8 +862,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(row, offset, decoded, index);
     }
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
   }
@@ -858,8 +880,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(row, offset, decoded, index);
     }
 
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
@@ -886,8 +907,7 @@ class RowContainer {
       return compareComplexType(row, column.offset(), decoded, index);
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      auto result = compareStringAsc(
-          valueAt<StringView>(row, column.offset()), decoded, index);
+      auto result = compareString(row, column.offset(), decoded, index);
       return flags.ascending ? result : result * -1;
     }
     auto left = valueAt<T>(row, column.offset());
@@ -920,9 +940,7 @@ class RowContainer {
       return compareComplexType(left, right, type, offset, flags);
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      auto leftValue = valueAt<StringView>(left, offset);
-      auto rightValue = valueAt<StringView>(right, offset);
-      auto result = compareStringAsc(leftValue, rightValue);
+      auto result = compareString(left, right, offset);
       return flags.ascending ? result : result * -1;
     }
     auto leftValue = valueAt<T>(left, offset);
@@ -999,6 +1017,144 @@ class RowContainer {
 
   static int32_t compareStringAsc(StringView left, StringView right);
 
+  // True if the StringView at 'offset' is a key followed by
+  // kStringKeyPrefixSize bytes of its value.
+  bool hasStringKeyPrefix(int32_t offset) const {
+    return hasStringKeyPrefixes_ && offset < keysEndOffset_;
+  }
+
+  // Copies the characters after the prefix of the non-inline StringView at
+  // 'offset' in 'row' after the StringView if 'offset' is a key with a string
+  // prefix. Called before the value is copied to 'stringAllocator_'.
+  void storeStringKeyPrefix(char* FOLLY_NONNULL row, int32_t offset) {
+    const auto value = valueAt<StringView>(row, offset);
+    if (!value.isInline() && hasStringKeyPrefix(offset)) {
+      memcpy(
+          row + offset + sizeof(StringView),
+          value.data() + StringView::kPrefixSize,
+          kStringKeyPrefixSize);
+    }
+  }
+
+  // Copies the leading characters of the StringView at 'offset' in 'row'
+  // that are in the row to 'prefix' and returns their count. This is the
+  // whole value if inline, else StringView::kPrefixSize characters or
+  // StringView::kInlineSize with a string key prefix. 'prefix' must have
+  // space for StringView::kInlineSize characters.
+  int32_t inlineStringBytes(
+      const char* FOLLY_NONNULL row,
+      int32_t offset,
+      char* FOLLY_NONNULL prefix) const {
+    static_assert(sizeof(StringView) == 16);
+    const auto value = valueAt<StringView>(row, offset);
+    if (value.isInline()) {
+      memcpy(prefix, value.data(), value.size());
+      return value.size();
+    }
+    // The prefix of a non-inline StringView follows its uint32_t size.
+    memcpy(prefix, row + offset + sizeof(uint32_t), StringView::kPrefixSize);
+    if (!hasStringKeyPrefix(offset)) {
+      return StringView::kPrefixSize;
+    }
+    memcpy(
+        prefix + StringView::kPrefixSize,
+        row + offset + sizeof(StringView),
+        kStringKeyPrefixSize);
+    return StringView::kInlineSize;
+  }
+
+  // Compares the leading characters of two strings of 'leftSize' and
+  // 'rightSize' characters of which 'leftBytes' and 'rightBytes' are in
+  // 'left' and 'right'. Returns std::nullopt if the result depends on the
+  // characters that are not given.
+  static std::optional<int32_t> compareStringPrefixes(
+      const char* FOLLY_NONNULL left,
+      int32_t leftBytes,
+      int32_t leftSize,
+      const char* FOLLY_NONNULL right,
+      int32_t rightBytes,
+      int32_t rightSize) {
+    const auto numBytes = std::min(leftBytes, rightBytes);
+    if (auto result = memcmp(left, right, numBytes)) {
+      return result;
+    }
+    if (numBytes == leftSize || numBytes == rightSize) {
+      return leftSize < rightSize ? -1 : leftSize == rightSize ? 0 : 1;
+    }
+    return std::nullopt;
+  }
+
+  // Equality of the VARCHAR or VARBINARY at 'offset' in 'row' and
+  // 'decoded[index]'. Compares the size and the characters in the row before
+  // reading the characters in 'stringAllocator_'.
+  bool equalsString(
+      const char* FOLLY_NONNULL row,
+      int32_t offset,
+      const DecodedVector& decoded,
+      vector_size_t index) const {
+    const auto stored = valueAt<StringView>(row, offset);
+    const auto value = decoded.valueAt<StringView>(index);
+    if (stored.size() != value.size()) {
+      return false;
+    }
+    if (stored.isInline()) {
+      return stored == value;
+    }
+    char prefix[StringView::kInlineSize];
+    const auto numBytes = inlineStringBytes(row, offset, prefix);
+    if (memcmp(prefix, value.data(), numBytes) != 0) {
+      return false;
+    }
+    return compareStringAsc(stored, decoded, index) == 0;
+  }
+
+  // Ascending comparison of the VARCHAR or VARBINARY at 'offset' in 'row' and
+  // 'decoded[index]'.
+  int32_t compareString(
+      const char* FOLLY_NONNULL row,
+      int32_t offset,
+      const DecodedVector& decoded,
+      vector_size_t index) const {
+    const auto value = decoded.valueAt<StringView>(index);
+    char prefix[StringView::kInlineSize];
+    const auto numBytes = inlineStringBytes(row, offset, prefix);
+    const auto storedSize = valueAt<StringView>(row, offset).size();
+    const auto valueBytes =
+        std::min<int32_t>(value.size(), StringView::kInlineSize);
+    if (auto result = compareStringPrefixes(
+            prefix,
+            numBytes,
+            storedSize,
+            value.data(),
+            valueBytes,
+            value.size())) {
+      return result.value();
+    }
+    return compareStringAsc(valueAt<StringView>(row, offset), decoded, index);
+  }
+
+  // Ascending comparison of the VARCHAR or VARBINARY at 'offset' in 'left'
+  // and 'right'.
+  int32_t compareString(
+      const char* FOLLY_NONNULL left,
+      const char* FOLLY_NONNULL right,
+      int32_t offset) const {
+    char leftPrefix[StringView::kInlineSize];
+    char rightPrefix[StringView::kInlineSize];
+    const auto leftValue = valueAt<StringView>(left, offset);
+    const auto rightValue = valueAt<StringView>(right, offset);
+    if (auto result = compareStringPrefixes(
+            leftPrefix,
+            inlineStringBytes(left, offset, leftPrefix),
+            leftValue.size(),
+            rightPrefix,
+            inlineStringBytes(right, offset, rightPrefix),
+            rightValue.size())) {
+      return result.value();
+    }
+    return compareStringAsc(leftValue, rightValue);
+  }
+
   int32_t compareComplexType(
       const char* FOLLY_NONNULL row,
       int32_t offset,
@@ -1049,6 +1205,13 @@ class RowContainer {
   int32_t freeFlagOffset_ = 0;
   int32_t rowSizeOffset_ = 0;
 
+  // True if VARCHAR and VARBINARY keys are followed by kStringKeyPrefixSize
+  // bytes of their value. Set from FLAGS_velox_row_container_string_key_prefix
+  // so that all RowContainers of a process have the same layout.
+  bool hasStringKeyPrefixes_{false};
+  // Offset of the first byte after the keys.
+  int32_t keysEndOffset_{0};
+
   int32_t fixedRowSize_;
   // True if normalized keys are enabled in initial state.
   const bool hasNormalizedKeys_;
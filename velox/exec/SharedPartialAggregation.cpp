@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SharedPartialAggregation.h"
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+
+int32_t SharedPartialAggregation::addShard(GroupingSet* groupingSet) {
+  VELOX_CHECK_NOT_NULL(groupingSet);
+  auto shard = std::make_unique<Shard>();
+  shard->groupingSet = groupingSet;
+  shards_.push_back(std::move(shard));
+  return shards_.size() - 1;
+}
+
+bool SharedPartialAggregation::withShard(
+    int32_t shard,
+    const std::function<void(GroupingSet&)>& func) {
+  VELOX_CHECK_LT(shard, shards_.size());
+  auto& state = *shards_[shard];
+  std::lock_guard<std::mutex> l(state.mutex);
+  if (state.groupingSet == nullptr) {
+    return false;
+  }
+  func(*state.groupingSet);
+  return true;
+}
+
+void SharedPartialAggregation::removeShard(int32_t shard) {
+  VELOX_CHECK_LT(shard, shards_.size());
+  auto& state = *shards_[shard];
+  std::lock_guard<std::mutex> l(state.mutex);
+  state.groupingSet = nullptr;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+class GroupingSet;
+
+/// The hash tables of the drivers of a partial aggregation plan node within a
+/// task (split group) if QueryConfig::kSharedPartialAggregationEnabled is set.
+/// Each driver's GroupingSet is a shard that holds the groups whose keys hash
+/// to it. Any driver may add rows to any shard under the lock of the shard, so
+/// that a group seen by several drivers is accumulated in one place. The
+/// shards are added while the drivers are created, before any of them runs.
+class SharedPartialAggregation {
+ public:
+  /// Adds 'groupingSet' as the next shard and returns its index.
+  int32_t addShard(GroupingSet* groupingSet);
+
+  int32_t numShards() const {
+    return shards_.size();
+  }
+
+  /// Runs 'func' on the GroupingSet of 'shard' under the lock of the shard.
+  /// Does nothing and returns false if the shard has been removed.
+  bool withShard(int32_t shard, const std::function<void(GroupingSet&)>& func);
+
+  /// Removes 'shard'. Called when its driver closes. Rows for a removed shard
+  /// are dropped, which happens only if the task is terminating before all
+  /// drivers have finished their input.
+  void removeShard(int32_t shard);
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    // Owned by the HashAggregation of the driver. Null once removed.
+    GroupingSet* groupingSet;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace facebook::velox::exec
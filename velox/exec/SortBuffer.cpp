@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortBuffer.h"
+#include <folly/ScopeGuard.h>
+#include "velox/common/base/AsyncSource.h"
+#include "velox/exec/OperatorUtils.h"
+
+namespace facebook::velox::exec {
+
+SortBuffer::SortBuffer(
+    const RowTypePtr& input,
+    const std::vector<column_index_t>& sortColumnIndices,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    uint32_t outputBatchSize,
+    memory::MemoryPool* pool,
+    std::optional<SpillConfig> spillConfig,
+    uint64_t spillMemoryThreshold,
+    folly::Executor* sortExecutor)
+    : input_(input),
+      sortCompareFlags_(sortCompareFlags),
+      outputBatchSize_(outputBatchSize),
+      pool_(pool),
+      spillConfig_(std::move(spillConfig)),
+      spillMemoryThreshold_(spillMemoryThreshold),
+      sortExecutor_(sortExecutor) {
+  VELOX_CHECK_EQ(sortColumnIndices.size(), sortCompareFlags_.size());
+  VELOX_CHECK_GT(outputBatchSize_, 0);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  // Setup column projections to store sort key columns in row container first.
+  // This enables to use the sorting facility provided by the row container. It
+  // also facilitates the sort merge read handling required by disk spilling.
+  std::unordered_set<column_index_t> keyChannelSet;
+  columnMap_.reserve(input_->size());
+  for (column_index_t i = 0; i < sortColumnIndices.size(); ++i) {
+    const auto channel = sortColumnIndices[i];
+    VELOX_CHECK_LT(channel, input_->size());
+    columnMap_.emplace_back(i, channel);
+    keyTypes.push_back(input_->childAt(channel));
+    types.push_back(keyTypes.back());
+    names.push_back(input_->nameOf(channel));
+    keyChannelSet.emplace(channel);
+  }
+
+  // Store non-sort key columns as dependents in row container.
+  for (column_index_t inputChannel = 0,
+                      nextContainerChannel = sortColumnIndices.size();
+       inputChannel < input_->size();
+       ++inputChannel) {
+    if (keyChannelSet.count(inputChannel) != 0) {
+      continue;
+    }
+    columnMap_.emplace_back(nextContainerChannel++, inputChannel);
+    dependentTypes.push_back(input_->childAt(inputChannel));
+    types.push_back(dependentTypes.back());
+    names.push_back(input_->nameOf(inputChannel));
+  }
+
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool_);
+  spillerStoreType_ = ROW(std::move(names), std::move(types));
+#ifndef NDEBUG
+  for (int i = 0; i < spillerStoreType_->size(); ++i) {
+    VELOX_DCHECK_EQ(spillerStoreType_->childAt(i), data_->columnTypes()[i]);
+  }
+#endif
+}
+
+void SortBuffer::addInput(const RowVectorPtr& input) {
+  VELOX_CHECK(!noMoreInput_);
+  ensureInputFits(input);
+
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (int row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  for (const auto& columnProjection : columnMap_) {
+    DecodedVector decoded(
+        *input->childAt(columnProjection.outputChannel), allRows);
+    for (int i = 0; i < input->size(); ++i) {
+      data_->store(decoded, i, rows[i], columnProjection.inputChannel);
+    }
+  }
+  numInputRows_ += allRows.size();
+}
+
+void SortBuffer::noMoreInput() {
+  VELOX_CHECK(!noMoreInput_);
+  noMoreInput_ = true;
+
+  // No data.
+  if (numInputRows_ == 0) {
+    return;
+  }
+
+  if (spiller_ == nullptr) {
+    VELOX_CHECK_EQ(numInputRows_, data_->numRows());
+    // Sort the pointers to the rows in 'data_' instead of sorting the rows.
+    sortedRows_.resize(numInputRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numInputRows_, sortedRows_.data());
+    NormalizedSortKey normalizedKey(*data_, sortCompareFlags_);
+    if (normalizedKey.numKeys() > 0) {
+      sortWithNormalizedKeys(normalizedKey);
+    } else {
+      std::stable_sort(
+          sortedRows_.begin(),
+          sortedRows_.end(),
+          [this](const char* leftRow, const char* rightRow) {
+            return compareRows(leftRow, rightRow, 0) < 0;
+          });
+    }
+  } else {
+    // Finish spill, and we shouldn't get any rows from non-spilled partition as
+    // there is only one hash partition.
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    VELOX_CHECK_NULL(spillMerge_);
+
+    spillMerge_ = spiller_->startMerge(0);
+    spillSources_.resize(outputBatchSize_);
+    spillSourceRows_.resize(outputBatchSize_);
+  }
+}
+
+int32_t SortBuffer::compareRows(
+    const char* leftRow,
+    const char* rightRow,
+    int32_t firstKey) const {
+  for (vector_size_t index = firstKey; index < sortCompareFlags_.size();
+       ++index) {
+    if (auto result = data_->compare(
+            leftRow, rightRow, index, sortCompareFlags_[index])) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+void SortBuffer::sortWithNormalizedKeys(
+    const NormalizedSortKey& normalizedKey) {
+  std::vector<KeyAndRow> keys(sortedRows_.size());
+  for (auto i = 0; i < sortedRows_.size(); ++i) {
+    normalizedKey.encode(sortedRows_[i], keys[i].key);
+    keys[i].row = sortedRows_[i];
+  }
+  const auto firstKey = normalizedKey.numKeys();
+  const auto numBytes = normalizedKey.numBytes();
+  if (normalizedKey.isComplete()) {
+    radixSort(
+        keys,
+        numBytes,
+        [](const KeyAndRow& left, const KeyAndRow& right) {
+          return NormalizedSortKey::compare(left.key, right.key) < 0;
+        });
+  } else {
+    radixSort(
+        keys, numBytes, [&](const KeyAndRow& left, const KeyAndRow& right) {
+          if (auto result = NormalizedSortKey::compare(left.key, right.key)) {
+            return result < 0;
+          }
+          return compareRows(left.row, right.row, firstKey) < 0;
+        });
+  }
+  for (auto i = 0; i < keys.size(); ++i) {
+    sortedRows_[i] = keys[i].row;
+  }
+}
+
+template <typename Less>
+void SortBuffer::radixSort(
+    std::vector<KeyAndRow>& keys,
+    int32_t numBytes,
+    const Less& less) {
+  std::vector<KeyAndRow> temp(keys.size());
+  if (sortExecutor_ == nullptr || keys.size() < kMinParallelSortRows) {
+    radixSort(keys.data(), temp.data(), keys.size(), 0, numBytes, less);
+    return;
+  }
+
+  // Distributes the rows on the first byte that differs and sorts the
+  // buckets in parallel. The buckets not started on 'sortExecutor_' by the
+  // time they are needed are sorted on this thread.
+  std::array<size_t, kNumBuckets + 1> bounds;
+  int32_t byte = 0;
+  while (byte < numBytes &&
+         !distribute(keys.data(), temp.data(), keys.size(), byte, bounds)) {
+    ++byte;
+  }
+  if (byte == numBytes) {
+    std::stable_sort(keys.begin(), keys.end(), less);
+    return;
+  }
+  std::vector<std::shared_ptr<AsyncSource<bool>>> sorts;
+  for (auto bucket = 0; bucket < kNumBuckets; ++bucket) {
+    const auto begin = bounds[bucket];
+    const auto size = bounds[bucket + 1] - begin;
+    if (size <= 1) {
+      continue;
+    }
+    sorts.push_back(std::make_shared<AsyncSource<bool>>(
+        [&, begin, size, byte]() {
+          radixSort(
+              keys.data() + begin,
+              temp.data() + begin,
+              size,
+              byte + 1,
+              numBytes,
+              less);
+          return std::make_unique<bool>(true);
+        }));
+    sortExecutor_->add([source = sorts.back()]() { source->prepare(); });
+  }
+  auto sync = folly::makeGuard([&]() {
+    // Waits for the sorts that run on 'sortExecutor_' since these reference
+    // 'keys' and 'temp'. The first error is rethrown below.
+    for (auto& sort : sorts) {
+      try {
+        sort->move();
+      } catch (const std::exception& e) {
+      }
+    }
+  });
+  for (auto& sort : sorts) {
+    sort->move();
+  }
+}
+
+template <typename Less>
+void SortBuffer::radixSort(
+    KeyAndRow* keys,
+    KeyAndRow* temp,
+    size_t size,
+    int32_t byte,
+    int32_t numBytes,
+    const Less& less) {
+  std::array<size_t, kNumBuckets + 1> bounds;
+  for (;;) {
+    if (size <= kMinRadixSortRows || byte == numBytes) {
+      std::stable_sort(keys, keys + size, less);
+      return;
+    }
+    if (distribute(keys, temp, size, byte, bounds)) {
+      break;
+    }
+    // All rows have the same value of 'byte'.
+    ++byte;
+  }
+  for (auto bucket = 0; bucket < kNumBuckets; ++bucket) {
+    const auto begin = bounds[bucket];
+    const auto bucketSize = bounds[bucket + 1] - begin;
+    if (bucketSize > 1) {
+      radixSort(
+          keys + begin, temp + begin, bucketSize, byte + 1, numBytes, less);
+    }
+  }
+}
+
+// static
+bool SortBuffer::distribute(
+    KeyAndRow* keys,
+    KeyAndRow* temp,
+    size_t size,
+    int32_t byte,
+    std::array<size_t, kNumBuckets + 1>& bounds) {
+  std::array<size_t, kNumBuckets> counts{};
+  for (size_t i = 0; i < size; ++i) {
+    ++counts[NormalizedSortKey::byteAt(keys[i].key, byte)];
+  }
+  if (counts[NormalizedSortKey::byteAt(keys[0].key, byte)] == size) {
+    return false;
+  }
+  bounds[0] = 0;
+  for (auto bucket = 0; bucket < kNumBuckets; ++bucket) {
+    bounds[bucket + 1] = bounds[bucket] + counts[bucket];
+  }
+  // Scatters to 'temp' in input order so that the sort stays stable.
+  std::array<size_t, kNumBuckets> offsets;
+  std::copy(bounds.begin(), bounds.end() - 1, offsets.begin());
+  for (size_t i = 0; i < size; ++i) {
+    temp[offsets[NormalizedSortKey::byteAt(keys[i].key, byte)]++] = keys[i];
+  }
+  std::copy(temp, temp + size, keys);
+  return true;
+}
+
+RowVectorPtr SortBuffer::getOutput() {
+  VELOX_CHECK(noMoreInput_);
+  if (numOutputRows_ == numInputRows_) {
+    return nullptr;
+  }
+  prepareOutput();
+
+  if (spiller_ != nullptr) {
+    getOutputWithSpill();
+  } else {
+    getOutputWithoutSpill();
+  }
+  return output_;
+}
+
+bool SortBuffer::canSpill() const {
+  // The sorted output is produced from 'data_' after all input is added, so
+  // only the input accumulation can be spilled.
+  return spillConfig_.has_value() && !noMoreInput_ && data_->numRows() > 0;
+}
+
+uint64_t SortBuffer::spillableBytes() const {
+  return canSpill() ? data_->pool()->getCurrentBytes() : 0;
+}
+
+void SortBuffer::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  // Test-only spill path.
+  if (spillConfig_->testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig_->testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  auto tracker = pool_->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig_->spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig_->spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void SortBuffer::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK(spillConfig_.has_value());
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK_NOT_NULL(pool_->getMemoryUsageTracker());
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillerStoreType_,
+        data_->keyTypes().size(),
+        sortCompareFlags_,
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        spillConfig_->minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig_->executor,
+        spillConfig_->fileOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void SortBuffer::prepareOutput() {
+  VELOX_CHECK_GT(numInputRows_, numOutputRows_);
+
+  const vector_size_t batchSize = std::min<uint64_t>(
+      numInputRows_ - numOutputRows_, outputBatchSize_);
+  if (output_ != nullptr) {
+    VectorPtr output = std::move(output_);
+    BaseVector::prepareForReuse(output, batchSize);
+    output_ = std::static_pointer_cast<RowVector>(output);
+  } else {
+    output_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(input_, batchSize, pool_));
+  }
+
+  for (auto& child : output_->children()) {
+    child->resize(batchSize);
+  }
+}
+
+void SortBuffer::getOutputWithoutSpill() {
+  VELOX_CHECK_GT(output_->size(), 0);
+  VELOX_DCHECK_LE(output_->size(), outputBatchSize_);
+  VELOX_CHECK_LE(output_->size() + numOutputRows_, numInputRows_);
+  VELOX_DCHECK_EQ(numInputRows_, sortedRows_.size());
+
+  for (const auto& columnProjection : columnMap_) {
+    data_->extractColumn(
+        sortedRows_.data() + numOutputRows_,
+        output_->size(),
+        columnProjection.inputChannel,
+        output_->childAt(columnProjection.outputChannel));
+  }
+  numOutputRows_ += output_->size();
+}
+
+void SortBuffer::getOutputWithSpill() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  VELOX_DCHECK_EQ(sortedRows_.size(), 0);
+  VELOX_DCHECK_EQ(spillSources_.size(), outputBatchSize_);
+  VELOX_DCHECK_EQ(spillSourceRows_.size(), outputBatchSize_);
+
+  int32_t outputRow = 0;
+  int32_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < output_->size()) {
+    VELOX_DCHECK_LT(outputRow, output_->size());
+    VELOX_DCHECK_LT(outputRow + outputSize, output_->size());
+
+    SpillMergeStream* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          output_.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+  VELOX_CHECK_EQ(outputRow + outputSize, output_->size());
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        output_.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+  }
+
+  numOutputRows_ += output_->size();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/NormalizedSortKey.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Buffers input rows in a RowContainer and returns them sorted on the given
+/// columns once all input is added. If a spill config is given, the buffered
+/// rows are spilled as sorted runs when memory runs low, and the runs are
+/// merged when producing the output. Used by the OrderBy operator and by
+/// writers that produce sorted files.
+class SortBuffer {
+ public:
+  /// @param input Type of the input and of the output rows.
+  /// @param sortColumnIndices Channels of the sorting keys in 'input', in
+  /// sort order.
+  /// @param sortCompareFlags Compare flags of the sorting keys. Has the same
+  /// size as 'sortColumnIndices'.
+  /// @param outputBatchSize Max number of rows in a batch from getOutput().
+  /// @param pool Pool for the buffered rows and the output.
+  /// @param spillConfig Spill config or std::nullopt if spilling is disabled.
+  /// Each SortBuffer needs its own spill file path.
+  /// @param spillMemoryThreshold Memory usage of 'pool' above which the
+  /// buffered rows are spilled. 0 means no limit.
+  /// @param sortExecutor Executor for sorting parts of large inputs in
+  /// parallel or nullptr to sort on the calling thread only.
+  SortBuffer(
+      const RowTypePtr& input,
+      const std::vector<column_index_t>& sortColumnIndices,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      uint32_t outputBatchSize,
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      std::optional<SpillConfig> spillConfig = std::nullopt,
+      uint64_t spillMemoryThreshold = 0,
+      folly::Executor* FOLLY_NULLABLE sortExecutor = nullptr);
+
+  void addInput(const RowVectorPtr& input);
+
+  /// Indicates no more input is coming and sorts the buffered rows or starts
+  /// merging the spilled runs.
+  void noMoreInput();
+
+  /// Returns the next batch of sorted rows or nullptr if all rows have been
+  /// returned. Must be called after noMoreInput(). The returned vector may be
+  /// reused by the next call.
+  RowVectorPtr getOutput();
+
+  /// Returns true if the buffered rows can be spilled to free memory.
+  bool canSpill() const;
+
+  /// Returns the memory held by the buffered rows. 0 if these can't be
+  /// spilled.
+  uint64_t spillableBytes() const;
+
+  /// Spills until under 'targetRows' and under 'targetBytes' of out of line
+  /// data are left. If 'targetRows' is 0, spills everything and physically
+  /// frees the buffered rows. Must only be called if canSpill().
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  /// Returns the spill stats or std::nullopt if nothing was spilled.
+  std::optional<Spiller::Stats> spilledStats() const {
+    if (spiller_ == nullptr) {
+      return std::nullopt;
+    }
+    return spiller_->stats();
+  }
+
+  uint64_t numInputRows() const {
+    return numInputRows_;
+  }
+
+  uint64_t numOutputRows() const {
+    return numOutputRows_;
+  }
+
+ private:
+  // Checks if 'input' will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills enough
+  // to make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Prepares the reusable output buffer based on the output batch size and the
+  // remaining rows to return.
+  void prepareOutput();
+
+  // Compares 'leftRow' and 'rightRow' of 'data_' on the sorting keys from
+  // 'firstKey' on.
+  int32_t compareRows(
+      const char* FOLLY_NONNULL leftRow,
+      const char* FOLLY_NONNULL rightRow,
+      int32_t firstKey) const;
+
+  // Number of buckets of a radix sort pass, one per byte value.
+  static constexpr int32_t kNumBuckets = 256;
+
+  // Inputs with fewer rows are sorted with std::stable_sort instead of
+  // another radix sort pass.
+  static constexpr size_t kMinRadixSortRows = 64;
+
+  // Inputs with fewer rows are sorted on the calling thread only.
+  static constexpr size_t kMinParallelSortRows = 1'000'000;
+
+  // A row and its normalized key. The key is next to the row pointer so
+  // that most comparisons don't touch the rows.
+  struct KeyAndRow {
+    uint64_t key[NormalizedSortKey::kNumWords];
+    char* row;
+  };
+
+  // Sorts 'sortedRows_' on the normalized keys made by 'normalizedKey'. Ties
+  // are broken on the sorting keys that are not in the normalized key.
+  void sortWithNormalizedKeys(const NormalizedSortKey& normalizedKey);
+
+  // Sorts 'keys' with an MSD radix sort on the first 'numBytes' bytes of the
+  // normalized keys. Sorts the buckets of the first pass in parallel on
+  // 'sortExecutor_' if 'keys' is large. 'less' orders rows with
+  // equal normalized key bytes.
+  template <typename Less>
+  void radixSort(
+      std::vector<KeyAndRow>& keys,
+      int32_t numBytes,
+      const Less& less);
+
+  // Sorts 'size' rows at 'keys' on the normalized key bytes from 'byte' on.
+  // 'temp' has space for 'size' rows. The rows of a bucket that is too small
+  // for another pass are sorted with 'less'.
+  template <typename Less>
+  static void radixSort(
+      KeyAndRow* FOLLY_NONNULL keys,
+      KeyAndRow* FOLLY_NONNULL temp,
+      size_t size,
+      int32_t byte,
+      int32_t numBytes,
+      const Less& less);
+
+  // Reorders 'size' rows at 'keys' on the normalized key byte 'byte' and
+  // sets 'bounds' to the start of each bucket followed by 'size'. Returns
+  // false without reordering if all rows have the same 'byte'.
+  static bool distribute(
+      KeyAndRow* FOLLY_NONNULL keys,
+      KeyAndRow* FOLLY_NONNULL temp,
+      size_t size,
+      int32_t byte,
+      std::array<size_t, kNumBuckets + 1>& bounds);
+
+  void getOutputWithoutSpill();
+  void getOutputWithSpill();
+
+  const RowTypePtr input_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  const uint32_t outputBatchSize_;
+  memory::MemoryPool* const pool_;
+  const std::optional<SpillConfig> spillConfig_;
+  const uint64_t spillMemoryThreshold_;
+  folly::Executor* const sortExecutor_;
+
+  // The map from the column channel in 'input_' to the corresponding one
+  // stored in 'data_'. The columns are reordered to store the sorting keys
+  // first in 'data_'.
+  std::vector<IdentityProjection> columnMap_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  // The row type used to store input data in 'data_' and for spilling.
+  RowTypePtr spillerStoreType_;
+
+  bool noMoreInput_{false};
+
+  uint64_t numInputRows_{0};
+
+  // The number of rows returned by getOutput() so far.
+  uint64_t numOutputRows_{0};
+
+  // Possibly reusable output vector.
+  RowVectorPtr output_;
+
+  // Used to collect sorted rows from 'data_' on the non-spilling output path.
+  std::vector<char*> sortedRows_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers test spilling if folly hash of this %
+  // 100 <= 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Records the source rows to copy to 'output_' in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortedAggregations.h"
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+bool sameFlags(
+    const std::vector<CompareFlags>& left,
+    const std::vector<CompareFlags>& right) {
+  return std::equal(
+      left.begin(),
+      left.end(),
+      right.begin(),
+      right.end(),
+      [](const auto& x, const auto& y) {
+        return x.nullsFirst == y.nullsFirst && x.ascending == y.ascending;
+      });
+}
+
+void addChannel(std::vector<column_index_t>& channels, column_index_t channel) {
+  if (std::find(channels.begin(), channels.end(), channel) == channels.end()) {
+    channels.push_back(channel);
+  }
+}
+} // namespace
+
+SortedAggregations::SortedAggregations(
+    const RowTypePtr& inputType,
+    const std::vector<std::vector<column_index_t>>& sortingKeys,
+    const std::vector<std::vector<CompareFlags>>& sortingFlags,
+    const std::vector<std::vector<column_index_t>>& channelLists,
+    const std::vector<std::vector<VectorPtr>>& constantLists,
+    const std::vector<std::optional<column_index_t>>& maskChannels,
+    uint32_t outputBatchSize,
+    memory::MemoryPool* pool,
+    const SpillConfig* spillConfig,
+    uint64_t spillMemoryThreshold)
+    : inputType_(inputType),
+      channelLists_(channelLists),
+      constantLists_(constantLists),
+      outputBatchSize_(outputBatchSize),
+      pool_(pool),
+      spillConfig_(spillConfig),
+      spillMemoryThreshold_(spillMemoryThreshold) {
+  VELOX_CHECK_EQ(sortingKeys.size(), channelLists_.size());
+  VELOX_CHECK_EQ(sortingFlags.size(), channelLists_.size());
+  VELOX_CHECK_EQ(maskChannels.size(), channelLists_.size());
+  bufferIndices_.resize(channelLists_.size(), kNotSorted);
+  for (auto i = 0; i < channelLists_.size(); ++i) {
+    if (sortingKeys[i].empty()) {
+      continue;
+    }
+    auto it = std::find_if(
+        buffers_.begin(), buffers_.end(), [&](const Buffer& buffer) {
+          return buffer.sortingKeys == sortingKeys[i] &&
+              sameFlags(buffer.sortingFlags, sortingFlags[i]) &&
+              buffer.maskChannel == maskChannels[i];
+        });
+    if (it == buffers_.end()) {
+      Buffer buffer;
+      buffer.sortingKeys = sortingKeys[i];
+      buffer.sortingFlags = sortingFlags[i];
+      buffer.maskChannel = maskChannels[i];
+      for (auto channel : buffer.sortingKeys) {
+        addChannel(buffer.inputChannels, channel);
+      }
+      buffers_.push_back(std::move(buffer));
+      it = buffers_.end() - 1;
+    }
+    it->aggregates.push_back(i);
+    for (auto channel : channelLists_[i]) {
+      if (channel != kConstantChannel) {
+        addChannel(it->inputChannels, channel);
+      }
+    }
+    bufferIndices_[i] = it - buffers_.begin();
+  }
+
+  for (auto& buffer : buffers_) {
+    std::vector<std::string> names{"c0"};
+    std::vector<TypePtr> types{BIGINT()};
+    for (auto channel : buffer.inputChannels) {
+      names.push_back(fmt::format("c{}", names.size()));
+      types.push_back(inputType_->childAt(channel));
+    }
+    buffer.rowType = ROW(std::move(names), std::move(types));
+  }
+}
+
+// static
+column_index_t SortedAggregations::columnOf(
+    const Buffer& buffer,
+    column_index_t channel) {
+  auto it = std::find(
+      buffer.inputChannels.begin(), buffer.inputChannels.end(), channel);
+  VELOX_CHECK(it != buffer.inputChannels.end());
+  return 1 + (it - buffer.inputChannels.begin());
+}
+
+void SortedAggregations::createSortBuffer(int32_t bufferIndex) {
+  auto& buffer = buffers_[bufferIndex];
+  // The rows are sorted on the group row first, so that the rows of each
+  // group are next to each other.
+  std::vector<column_index_t> sortColumns{0};
+  std::vector<CompareFlags> sortFlags{CompareFlags{}};
+  for (auto i = 0; i < buffer.sortingKeys.size(); ++i) {
+    sortColumns.push_back(columnOf(buffer, buffer.sortingKeys[i]));
+    sortFlags.push_back(buffer.sortingFlags[i]);
+  }
+
+  std::optional<SpillConfig> spillConfig;
+  if (spillConfig_ != nullptr) {
+    // Each SortBuffer needs its own spill files.
+    spillConfig = *spillConfig_;
+    spillConfig->filePath =
+        fmt::format("{}-sorted-{}", spillConfig_->filePath, bufferIndex);
+  }
+  buffer.sortBuffer = std::make_unique<SortBuffer>(
+      buffer.rowType,
+      sortColumns,
+      sortFlags,
+      outputBatchSize_,
+      pool_,
+      std::move(spillConfig),
+      spillMemoryThreshold_);
+}
+
+void SortedAggregations::addInput(
+    char* const* groups,
+    const RowVectorPtr& input,
+    const AggregationMasks& masks,
+    const SelectivityVector& activeRows) {
+  for (auto i = 0; i < buffers_.size(); ++i) {
+    auto& buffer = buffers_[i];
+    const auto* rows = buffer.maskChannel.has_value()
+        ? masks.activeRows(buffer.aggregates[0])
+        : &activeRows;
+    VELOX_CHECK_NOT_NULL(rows);
+    const auto numRows = rows->countSelected();
+    if (numRows == 0) {
+      continue;
+    }
+
+    groupRows_ = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), numRows, pool_);
+    auto* rawGroupRows = groupRows_->mutableRawValues();
+    BufferPtr indices;
+    if (numRows < input->size()) {
+      indices = allocateIndices(numRows, pool_);
+      auto* rawIndices = indices->asMutable<vector_size_t>();
+      vector_size_t next = 0;
+      rows->applyToSelected([&](auto row) {
+        rawIndices[next] = row;
+        rawGroupRows[next++] = reinterpret_cast<int64_t>(groups[row]);
+      });
+    } else {
+      for (auto row = 0; row < numRows; ++row) {
+        rawGroupRows[row] = reinterpret_cast<int64_t>(groups[row]);
+      }
+    }
+
+    std::vector<VectorPtr> children{groupRows_};
+    for (auto channel : buffer.inputChannels) {
+      auto column = BaseVector::loadedVectorShared(input->childAt(channel));
+      children.push_back(
+          indices ? BaseVector::wrapInDictionary(
+                        nullptr, indices, numRows, std::move(column))
+                  : std::move(column));
+    }
+
+    if (!buffer.sortBuffer) {
+      createSortBuffer(i);
+    }
+    buffer.sortBuffer->addInput(std::make_shared<RowVector>(
+        pool_, buffer.rowType, nullptr, numRows, std::move(children)));
+  }
+}
+
+void SortedAggregations::makeArgs(
+    int32_t aggregateIndex,
+    const Buffer& buffer,
+    const RowVectorPtr& sorted,
+    std::vector<VectorPtr>& args) const {
+  const auto& channels = channelLists_[aggregateIndex];
+  args.resize(channels.size());
+  for (auto i = 0; i < channels.size(); ++i) {
+    if (channels[i] == kConstantChannel) {
+      args[i] = BaseVector::wrapInConstant(
+          sorted->size(), 0, constantLists_[aggregateIndex][i]);
+    } else {
+      args[i] = sorted->childAt(columnOf(buffer, channels[i]));
+    }
+  }
+}
+
+void SortedAggregations::addToAggregates(
+    std::vector<std::unique_ptr<Aggregate>>& aggregates) {
+  std::vector<VectorPtr> args;
+  SelectivityVector rows;
+  for (auto& buffer : buffers_) {
+    if (!buffer.sortBuffer) {
+      continue;
+    }
+    buffer.sortBuffer->noMoreInput();
+    // The aggregates see the rows of each group in order, possibly over
+    // several batches.
+    while (auto sorted = buffer.sortBuffer->getOutput()) {
+      auto* groups = reinterpret_cast<char**>(
+          sorted->childAt(0)->asFlatVector<int64_t>()->mutableRawValues());
+      rows.resizeFill(sorted->size(), true);
+      for (auto aggregateIndex : buffer.aggregates) {
+        makeArgs(aggregateIndex, buffer, sorted, args);
+        aggregates[aggregateIndex]->addRawInput(groups, rows, args, false);
+      }
+      args.clear();
+    }
+    if (auto stats = buffer.sortBuffer->spilledStats()) {
+      buffer.spilledStats += stats.value();
+    }
+    buffer.sortBuffer.reset();
+  }
+}
+
+bool SortedAggregations::canSpill() const {
+  return std::any_of(buffers_.begin(), buffers_.end(), [](const auto& buffer) {
+    return buffer.sortBuffer && buffer.sortBuffer->canSpill();
+  });
+}
+
+void SortedAggregations::spill() {
+  for (auto& buffer : buffers_) {
+    if (buffer.sortBuffer && buffer.sortBuffer->canSpill()) {
+      buffer.sortBuffer->spill(0, 0);
+    }
+  }
+}
+
+Spiller::Stats SortedAggregations::spilledStats() const {
+  Spiller::Stats stats;
+  for (const auto& buffer : buffers_) {
+    stats += buffer.spilledStats;
+    if (buffer.sortBuffer) {
+      if (auto current = buffer.sortBuffer->spilledStats()) {
+        stats += current.value();
+      }
+    }
+  }
+  return stats;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/AggregationMasks.h"
+#include "velox/exec/SortBuffer.h"
+
+namespace facebook::velox::exec {
+
+class Aggregate;
+
+/// Feeds the aggregates with an ORDER BY clause, e.g. array_agg(a ORDER BY b),
+/// their input sorted within each group. The input rows of these aggregates
+/// are buffered together with the group row they belong to. Once all the input
+/// of the groups has been received, the buffered rows are sorted on the group
+/// row and the sorting keys and added to the aggregates in that order.
+///
+/// Aggregates with the same sorting keys, orders and mask share a buffer, so
+/// that each input row is buffered and sorted once for all of them. The
+/// buffers are SortBuffers and spill as sorted runs if a spill config is
+/// given.
+class SortedAggregations {
+ public:
+  /// @param inputType Type of the input of the aggregation.
+  /// @param sortingKeys The channels of the sorting keys of each aggregate.
+  /// Empty for the aggregates that are not sorted.
+  /// @param sortingFlags The compare flags of 'sortingKeys'.
+  /// @param channelLists The argument channels of each aggregate.
+  /// @param constantLists The constant arguments of each aggregate. Used at
+  /// the positions where 'channelLists' has kConstantChannel.
+  /// @param maskChannels The mask channel of each aggregate.
+  /// @param outputBatchSize Max number of sorted rows added to the aggregates
+  /// at a time.
+  /// @param spillConfig Spill config or nullptr if spilling is disabled.
+  /// @param spillMemoryThreshold Memory usage of 'pool' above which the
+  /// buffered rows are spilled. 0 means no limit.
+  SortedAggregations(
+      const RowTypePtr& inputType,
+      const std::vector<std::vector<column_index_t>>& sortingKeys,
+      const std::vector<std::vector<CompareFlags>>& sortingFlags,
+      const std::vector<std::vector<column_index_t>>& channelLists,
+      const std::vector<std::vector<VectorPtr>>& constantLists,
+      const std::vector<std::optional<column_index_t>>& maskChannels,
+      uint32_t outputBatchSize,
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const SpillConfig* FOLLY_NULLABLE spillConfig,
+      uint64_t spillMemoryThreshold);
+
+  /// Returns true if the aggregate at 'aggregateIndex' receives its input
+  /// through 'this'.
+  bool isSorted(int32_t aggregateIndex) const {
+    return bufferIndices_[aggregateIndex] != kNotSorted;
+  }
+
+  /// Buffers the rows of 'input' for the sorted aggregates. 'groups' has the
+  /// group row for each row of 'input'. 'masks' must have been updated for
+  /// 'input' and 'activeRows' gives the rows of the aggregates without a mask.
+  void addInput(
+      char* FOLLY_NONNULL const* FOLLY_NONNULL groups,
+      const RowVectorPtr& input,
+      const AggregationMasks& masks,
+      const SelectivityVector& activeRows);
+
+  /// Adds the buffered rows to the sorted elements of 'aggregates' in order
+  /// of the sorting keys within each group and frees the buffers. Called
+  /// before the results of the groups are extracted. 'this' is ready to buffer
+  /// the input of new groups afterwards.
+  void addToAggregates(std::vector<std::unique_ptr<Aggregate>>& aggregates);
+
+  /// Returns true if any of the buffers can be spilled.
+  bool canSpill() const;
+
+  /// Spills all the buffered rows. Must only be called if canSpill().
+  void spill();
+
+  /// Returns the spill stats summed over the buffers.
+  Spiller::Stats spilledStats() const;
+
+ private:
+  static constexpr int32_t kNotSorted = -1;
+
+  // The sorted aggregates with the same sorting keys, orders and mask.
+  struct Buffer {
+    std::vector<column_index_t> sortingKeys;
+    std::vector<CompareFlags> sortingFlags;
+    std::optional<column_index_t> maskChannel;
+
+    // The indices of the aggregates sharing 'this'.
+    std::vector<int32_t> aggregates;
+
+    // The input channels stored in the rows, from column 1 on. Column 0 is
+    // the group row.
+    std::vector<column_index_t> inputChannels;
+
+    // Type of the buffered rows.
+    RowTypePtr rowType;
+
+    // Created on the first input, reset after the rows are added to the
+    // aggregates.
+    std::unique_ptr<SortBuffer> sortBuffer;
+
+    // The stats of the SortBuffers that have been reset.
+    Spiller::Stats spilledStats;
+  };
+
+  // Returns the column of 'buffer' that stores 'channel' of the input.
+  static column_index_t columnOf(const Buffer& buffer, column_index_t channel);
+
+  void createSortBuffer(int32_t bufferIndex);
+
+  // Builds the arguments of the aggregate 'aggregateIndex' from a batch of
+  // sorted rows of 'buffer'.
+  void makeArgs(
+      int32_t aggregateIndex,
+      const Buffer& buffer,
+      const RowVectorPtr& sorted,
+      std::vector<VectorPtr>& args) const;
+
+  const RowTypePtr inputType_;
+  const std::vector<std::vector<column_index_t>> channelLists_;
+  const std::vector<std::vector<VectorPtr>> constantLists_;
+  const uint32_t outputBatchSize_;
+  memory::MemoryPool* const pool_;
+  const SpillConfig* const spillConfig_;
+  const uint64_t spillMemoryThreshold_;
+
+  // The index in 'buffers_' of each aggregate or kNotSorted.
+  std::vector<int32_t> bufferIndices_;
+
+  std::vector<Buffer> buffers_;
+
+  // The group row of each row of the input being buffered.
+  FlatVectorPtr<int64_t> groupRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -15,7 +15,10 @@
  */
 
 #include "velox/exec/Spill.h"
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
@@ -31,7 +34,347 @@ static const serializer::presto::PrestoVectorSerde::PrestoOptions
 
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+namespace {
+// A kColumnar batch is its byte size as an uint64_t followed by the number of
+// rows and columns as uint32_t and then by each column in turn. A column is
+// the byte size of its nulls as an uint64_t, 0 if it has no nulls, followed by
+// the nulls and the values. Fixed width values are as in a FlatVector. String
+// values are their int32_t lengths followed by the byte size of the string
+// data as an uint64_t and the string data. Each of the parts is padded to
+// 'kColumnarAlignment' so that the values can be used in place after reading.
+constexpr int32_t kColumnarAlignment = 8;
+
+int64_t columnarPadded(int64_t size) {
+  return bits::roundUp(size, kColumnarAlignment);
+}
+
+template <typename T>
+char* appendColumnar(char* out, T value) {
+  *reinterpret_cast<T*>(out) = value;
+  return out + columnarPadded(sizeof(T));
+}
+
+template <TypeKind Kind>
+int64_t columnarValuesSize(
+    const DecodedVector& decoded,
+    const std::vector<vector_size_t>& rows) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (std::is_same_v<T, bool>) {
+    return columnarPadded(bits::nbytes(rows.size()));
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    int64_t dataSize = 0;
+    for (auto row : rows) {
+      if (!decoded.isNullAt(row)) {
+        dataSize += decoded.valueAt<StringView>(row).size();
+      }
+    }
+    return columnarPadded(rows.size() * sizeof(int32_t)) +
+        columnarPadded(sizeof(uint64_t)) + columnarPadded(dataSize);
+  } else {
+    return columnarPadded(rows.size() * sizeof(T));
+  }
+}
+
+template <TypeKind Kind>
+char* writeColumnarValues(
+    const DecodedVector& decoded,
+    const std::vector<vector_size_t>& rows,
+    char* out) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto numRows = rows.size();
+  if constexpr (std::is_same_v<T, bool>) {
+    auto* rawBits = reinterpret_cast<uint64_t*>(out);
+    const auto size = columnarPadded(bits::nbytes(numRows));
+    memset(out, 0, size);
+    for (auto i = 0; i < numRows; ++i) {
+      if (!decoded.isNullAt(rows[i]) && decoded.valueAt<bool>(rows[i])) {
+        bits::setBit(rawBits, i);
+      }
+    }
+    return out + size;
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    auto* lengths = reinterpret_cast<int32_t*>(out);
+    out += columnarPadded(numRows * sizeof(int32_t));
+    auto* dataSize = reinterpret_cast<uint64_t*>(out);
+    out += columnarPadded(sizeof(uint64_t));
+    char* data = out;
+    for (auto i = 0; i < numRows; ++i) {
+      if (decoded.isNullAt(rows[i])) {
+        lengths[i] = 0;
+        continue;
+      }
+      const auto value = decoded.valueAt<StringView>(rows[i]);
+      lengths[i] = value.size();
+      memcpy(data, value.data(), value.size());
+      data += value.size();
+    }
+    *dataSize = data - out;
+    const auto paddedSize = columnarPadded(*dataSize);
+    memset(data, 0, paddedSize - *dataSize);
+    return out + paddedSize;
+  } else {
+    auto* values = reinterpret_cast<T*>(out);
+    for (auto i = 0; i < numRows; ++i) {
+      values[i] = decoded.isNullAt(rows[i]) ? T() : decoded.valueAt<T>(rows[i]);
+    }
+    const auto size = numRows * sizeof(T);
+    memset(out + size, 0, columnarPadded(size) - size);
+    return out + columnarPadded(size);
+  }
+}
+
+bool hasNulls(
+    const DecodedVector& decoded,
+    const std::vector<vector_size_t>& rows) {
+  if (!decoded.mayHaveNulls()) {
+    return false;
+  }
+  for (auto row : rows) {
+    if (decoded.isNullAt(row)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Keeps the buffer of a kColumnar batch alive for the vectors made over it.
+class ColumnarBatchReleaser {
+ public:
+  explicit ColumnarBatchReleaser(BufferPtr batch) : batch_(std::move(batch)) {}
+
+  void addRef() const {}
+
+  void release() const {}
+
+ private:
+  const BufferPtr batch_;
+};
+
+// Reads kColumnar batch contents from a buffer.
+class ColumnarBatchReader {
+ public:
+  explicit ColumnarBatchReader(BufferPtr batch)
+      : batch_(std::move(batch)), data_(batch_->as<char>()) {}
+
+  template <typename T>
+  T read() {
+    VELOX_CHECK_LE(offset_ + sizeof(T), batch_->size());
+    const auto value = *reinterpret_cast<const T*>(data_ + offset_);
+    offset_ += columnarPadded(sizeof(T));
+    return value;
+  }
+
+  // Returns a view on the next 'size' bytes of the batch.
+  BufferPtr view(int64_t size) {
+    VELOX_CHECK_LE(offset_ + size, batch_->size());
+    auto result = BufferView<ColumnarBatchReleaser>::create(
+        reinterpret_cast<const uint8_t*>(data_ + offset_),
+        size,
+        ColumnarBatchReleaser(batch_));
+    offset_ += columnarPadded(size);
+    return result;
+  }
+
+  const char* current() const {
+    return data_ + offset_;
+  }
+
+  void skip(int64_t size) {
+    VELOX_CHECK_LE(offset_ + size, batch_->size());
+    offset_ += columnarPadded(size);
+  }
+
+  bool atEnd() const {
+    return offset_ == batch_->size();
+  }
+
+  template <TypeKind Kind>
+  VectorPtr readColumn(
+      const TypePtr& type,
+      vector_size_t numRows,
+      memory::MemoryPool& pool) {
+    using T = typename TypeTraits<Kind>::NativeType;
+    const auto nullsSize = read<uint64_t>();
+    BufferPtr nulls = nullsSize ? view(nullsSize) : nullptr;
+    if constexpr (std::is_same_v<T, StringView>) {
+      const auto* lengths = reinterpret_cast<const int32_t*>(current());
+      skip(numRows * sizeof(int32_t));
+      const auto dataSize = read<uint64_t>();
+      std::vector<BufferPtr> stringBuffers;
+      const char* data = current();
+      if (dataSize > 0) {
+        stringBuffers.push_back(view(dataSize));
+      }
+      // Only the StringViews are made. The string data stays in the batch.
+      auto values = AlignedBuffer::allocate<StringView>(numRows, &pool);
+      auto* rawValues = values->asMutable<StringView>();
+      for (auto i = 0; i < numRows; ++i) {
+        rawValues[i] = StringView(data, lengths[i]);
+        data += lengths[i];
+      }
+      return std::make_shared<FlatVector<StringView>>(
+          &pool,
+          type,
+          std::move(nulls),
+          numRows,
+          std::move(values),
+          std::move(stringBuffers));
+    } else {
+      const auto valuesSize = std::is_same_v<T, bool>
+          ? bits::nbytes(numRows)
+          : numRows * sizeof(T);
+      return std::make_shared<FlatVector<T>>(
+          &pool,
+          type,
+          std::move(nulls),
+          numRows,
+          view(valuesSize),
+          std::vector<BufferPtr>{});
+    }
+  }
+
+ private:
+  const BufferPtr batch_;
+  const char* const data_;
+  int64_t offset_{0};
+};
+
+RowVectorPtr readColumnarBatch(
+    const RowTypePtr& type,
+    BufferPtr batch,
+    memory::MemoryPool& pool) {
+  ColumnarBatchReader reader(std::move(batch));
+  const auto numRows = reader.read<uint32_t>();
+  const auto numColumns = reader.read<uint32_t>();
+  VELOX_CHECK_EQ(numColumns, type->size());
+  std::vector<VectorPtr> children(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    children[i] = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        reader.readColumn,
+        type->childAt(i)->kind(),
+        type->childAt(i),
+        numRows,
+        pool);
+  }
+  VELOX_CHECK(reader.atEnd(), "Unexpected data after columnar spill batch");
+  return std::make_shared<RowVector>(
+      &pool, type, nullptr, numRows, std::move(children));
+}
+} // namespace
+
+SpillFileFormat spillFileFormatFromName(const std::string& name) {
+  if (name == "presto") {
+    return SpillFileFormat::kPresto;
+  }
+  if (name == "columnar") {
+    return SpillFileFormat::kColumnar;
+  }
+  VELOX_USER_FAIL("Unknown spill file format: {}", name);
+}
+
+std::string spillFileFormatName(SpillFileFormat format) {
+  switch (format) {
+    case SpillFileFormat::kPresto:
+      return "presto";
+    case SpillFileFormat::kColumnar:
+      return "columnar";
+  }
+  VELOX_UNREACHABLE();
+}
+
+folly::io::CodecType spillCompressionFromName(const std::string& name) {
+  auto codec = compressionCodecFromName(name);
+  VELOX_USER_CHECK(
+      codec.has_value(), "Unknown spill compression codec: {}", name);
+  return codec.value();
+}
+
+bool isColumnarSpillable(const RowType& type) {
+  for (const auto& child : type.children()) {
+    switch (child->kind()) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+      case TypeKind::TIMESTAMP:
+      case TypeKind::DATE:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+BufferPtr SpillInput::readBatch(memory::MemoryPool& pool) {
+  VELOX_CHECK_NULL(buffer_);
+  if (codec_ != nullptr) {
+    // The writer does not split batches between frames.
+    if (ranges()[0].position == ranges()[0].size) {
+      next(true);
+    }
+    const auto batchSize = read<uint64_t>();
+    const auto data = nextView(batchSize);
+    VELOX_CHECK_EQ(
+        data.size(), batchSize, "Columnar spill batch is split between frames");
+    return BufferView<ColumnarBatchReleaser>::create(
+        reinterpret_cast<const uint8_t*>(data.data()),
+        batchSize,
+        ColumnarBatchReleaser(frame_));
+  }
+  VELOX_CHECK_LE(offset_ + sizeof(uint64_t), size_);
+  uint64_t batchSize;
+  input_->pread(offset_, sizeof(batchSize), &batchSize);
+  offset_ += sizeof(batchSize);
+  VELOX_CHECK_LE(offset_ + batchSize, size_, "Truncated columnar spill file");
+  auto batch = AlignedBuffer::allocate<char>(batchSize, &pool);
+  input_->pread(offset_, batchSize, batch->asMutable<char>());
+  offset_ += batchSize;
+  return batch;
+}
+
+void SpillInput::readFrame() {
+  uint32_t header[2];
+  VELOX_CHECK_LE(
+      offset_ + sizeof(header), size_, "Reading past end of spill file");
+  input_->pread(offset_, sizeof(header), header);
+  offset_ += sizeof(header);
+  const auto compressedSize = header[0];
+  const auto uncompressedSize = header[1];
+  VELOX_CHECK_LE(offset_ + compressedSize, size_, "Truncated spill file");
+  if (compressed_ == nullptr || compressed_->capacity() < compressedSize) {
+    compressed_ = AlignedBuffer::allocate<char>(compressedSize, pool_);
+  }
+  input_->pread(offset_, compressedSize, compressed_->asMutable<char>());
+  offset_ += compressedSize;
+
+  const auto compressed =
+      folly::IOBuf::wrapBufferAsValue(compressed_->as<char>(), compressedSize);
+  const auto uncompressed = codec_->uncompress(&compressed, uncompressedSize);
+  // The previous frame stays alive as long as batches made over it do.
+  frame_ = AlignedBuffer::allocate<char>(uncompressedSize, pool_);
+  auto* out = frame_->asMutable<char>();
+  for (const auto range : *uncompressed) {
+    memcpy(out, range.data(), range.size());
+    out += range.size();
+  }
+  VELOX_CHECK_EQ(out - frame_->as<char>(), uncompressedSize);
+  setRange(
+      {frame_->asMutable<uint8_t>(),
+       static_cast<int32_t>(uncompressedSize),
+       0});
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
+  if (codec_ != nullptr) {
+    readFrame();
+    return;
+  }
   int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
   VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
   setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
@@ -45,6 +388,80 @@ void SpillMergeStream::pop() {
   }
 }
 
+std::vector<std::unique_ptr<SpillMergeStream>> FileSpillMergeStream::create(
+    SpillFiles spillFiles,
+    folly::Executor* readExecutor) {
+  std::vector<FileSpillMergeStream*> streams;
+  std::vector<std::unique_ptr<SpillMergeStream>> result;
+  for (auto& file : spillFiles) {
+    file->startRead();
+    streams.push_back(new FileSpillMergeStream(std::move(file), readExecutor));
+    result.emplace_back(streams.back());
+  }
+  if (readExecutor != nullptr) {
+    // Reads the first batches of all files in parallel.
+    for (auto* stream : streams) {
+      stream->startReadAhead();
+    }
+  }
+  for (auto* stream : streams) {
+    stream->nextBatch();
+  }
+  return result;
+}
+
+FileSpillMergeStream::~FileSpillMergeStream() {
+  // The read ahead refers to 'spillFile_'.
+  if (readAhead_ != nullptr) {
+    try {
+      readAhead_->move();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to read ahead spill file: " << e.what();
+    }
+  }
+}
+
+void FileSpillMergeStream::nextBatch() {
+  index_ = 0;
+  if (readExecutor_ == nullptr) {
+    if (!spillFile_->nextBatch(rowVector_)) {
+      size_ = 0;
+      return;
+    }
+    size_ = rowVector_->size();
+    return;
+  }
+  if (nextReadAheadBatch_ == readAheadBatches_.size() &&
+      readAhead_ != nullptr) {
+    auto readAhead = std::move(readAhead_);
+    readAheadBatches_ = std::move(*readAhead->move());
+    nextReadAheadBatch_ = 0;
+    if (!readAheadBatches_.empty()) {
+      startReadAhead();
+    }
+  }
+  if (nextReadAheadBatch_ == readAheadBatches_.size()) {
+    size_ = 0;
+    return;
+  }
+  rowVector_ = std::move(readAheadBatches_[nextReadAheadBatch_++]);
+  size_ = rowVector_->size();
+}
+
+void FileSpillMergeStream::startReadAhead() {
+  VELOX_CHECK_NULL(readAhead_);
+  readAhead_ = std::make_shared<AsyncSource<std::vector<RowVectorPtr>>>(
+      [file = spillFile_.get()]() {
+        auto batches = std::make_unique<std::vector<RowVectorPtr>>();
+        RowVectorPtr batch;
+        while (batches->size() < kReadAheadBatches && file->nextBatch(batch)) {
+          batches->push_back(std::move(batch));
+        }
+        return batches;
+      });
+  readExecutor_->add([readAhead = readAhead_]() { readAhead->prepare(); });
+}
+
 WriteFile& SpillFile::output() {
   if (!output_) {
     auto fs = filesystems::getFileSystem(path_, nullptr);
@@ -54,26 +471,95 @@ WriteFile& SpillFile::output() {
 }
 
 void SpillFile::startRead() {
+  VELOX_CHECK(!input_);
+  input_ = makeInput(pool_);
+}
+
+bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
+  return nextBatch(*input_, pool_, rowVector);
+}
+
+std::unique_ptr<SpillInput> SpillFile::makeInput(
+    memory::MemoryPool& pool) const {
   constexpr uint64_t kMaxReadBufferSize =
       (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
   VELOX_CHECK(!output_);
-  VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
+  if (compression_ != folly::io::CodecType::NO_COMPRESSION) {
+    return std::make_unique<SpillInput>(
+        std::move(file), nullptr, folly::io::getCodec(compression_), &pool);
+  }
+  if (format_ == SpillFileFormat::kColumnar) {
+    // Batches are read whole into buffers of their own.
+    return std::make_unique<SpillInput>(std::move(file), nullptr);
+  }
   auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool);
+  return std::make_unique<SpillInput>(std::move(file), std::move(buffer));
 }
 
-bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
-  if (input_->atEnd()) {
+bool SpillFile::nextBatch(
+    SpillInput& input,
+    memory::MemoryPool& pool,
+    RowVectorPtr& rowVector) const {
+  if (input.atEnd()) {
     return false;
   }
+  if (format_ == SpillFileFormat::kColumnar) {
+    rowVector = readColumnarBatch(type_, input.readBatch(pool), pool);
+    return true;
+  }
   VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+      &input, &pool, type_, &rowVector, &kDefaultSerdeOptions);
   return true;
 }
 
+SpillFileList::SpillFileList(
+    RowTypePtr type,
+    int32_t numSortingKeys,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    const std::string& path,
+    uint64_t targetFileSize,
+    memory::MemoryPool& pool,
+    const SpillFileOptions& options)
+    : type_(std::move(type)),
+      numSortingKeys_(numSortingKeys),
+      sortCompareFlags_(sortCompareFlags),
+      path_(path),
+      targetFileSize_(targetFileSize),
+      pool_(pool),
+      format_(
+          options.format == SpillFileFormat::kColumnar &&
+                  isColumnarSpillable(*type_)
+              ? SpillFileFormat::kColumnar
+              : SpillFileFormat::kPresto),
+      compression_(options.compression),
+      writeExecutor_(options.writeExecutor),
+      queryId_(options.queryId),
+      ioDevice_(SpillIoScheduler::getInstance().deviceFor(path_)) {
+  // NOTE: if the associated spilling operator has specified the sort
+  // comparison flags, then it must match the number of sorting keys.
+  VELOX_CHECK(
+      sortCompareFlags_.empty() || sortCompareFlags_.size() == numSortingKeys_);
+  if (compression_ != folly::io::CodecType::NO_COMPRESSION) {
+    VELOX_CHECK(
+        folly::io::hasCodec(compression_),
+        "Spill compression codec is not available: {}",
+        static_cast<int>(compression_));
+    codec_ = folly::io::getCodec(compression_);
+  }
+}
+
+SpillFileList::~SpillFileList() {
+  // The pending write refers to 'this'.
+  try {
+    waitForWrite();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to write spill file: " << e.what();
+  }
+}
+
 WriteFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_) {
@@ -85,11 +571,116 @@ WriteFile& SpillFileList::currentOutput() {
         numSortingKeys_,
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        SpillFileOptions{.format = format_, .compression = compression_}));
+    REPORT_ADD_STAT_VALUE(kCounterSpillFiles);
   }
   return files_.back()->output();
 }
 
+void SpillFileList::append(std::string_view data) {
+  if (!buffersWrites()) {
+    auto& output = currentOutput();
+    uint64_t writeMicros{0};
+    {
+      MicrosecondTimer timer(&writeMicros);
+      output.append(data);
+    }
+    spilledBytes_ += data.size();
+    REPORT_ADD_STAT_VALUE(kCounterSpillWriteBytes, data.size());
+    REPORT_ADD_STAT_VALUE(kCounterSpillWriteTimeUs, writeMicros);
+    return;
+  }
+  if (writeBuffer_ != nullptr &&
+      writeBuffer_->size() + data.size() > writeBuffer_->capacity()) {
+    startWrite();
+  }
+  if (writeBuffer_ == nullptr) {
+    if (spareBuffer_ != nullptr && spareBuffer_->capacity() >= data.size()) {
+      writeBuffer_ = std::move(spareBuffer_);
+    } else {
+      writeBuffer_ = AlignedBuffer::allocate<char>(
+          std::max<uint64_t>(kWriteBufferSize, data.size()), &pool_);
+    }
+    writeBuffer_->setSize(0);
+  }
+  const auto size = writeBuffer_->size();
+  memcpy(writeBuffer_->asMutable<char>() + size, data.data(), data.size());
+  writeBuffer_->setSize(size + data.size());
+}
+
+void SpillFileList::startWrite() {
+  if (writeBuffer_ == nullptr || writeBuffer_->size() == 0) {
+    return;
+  }
+  // There is at most one write in progress. This also makes it safe to rotate
+  // the output file.
+  waitForWrite();
+  auto* file = &currentOutput();
+  auto write = std::make_shared<AsyncSource<BufferPtr>>(
+      [this, file, buffer = std::move(writeBuffer_)]() {
+        writeBuffer(*file, *buffer);
+        return std::make_unique<BufferPtr>(buffer);
+      });
+  if (writeExecutor_ == nullptr) {
+    spareBuffer_ = std::move(*write->move());
+    return;
+  }
+  writeExecutor_->add([write]() { write->prepare(); });
+  pendingWrite_ = std::move(write);
+}
+
+void SpillFileList::waitForWrite() {
+  if (pendingWrite_ == nullptr) {
+    return;
+  }
+  auto write = std::move(pendingWrite_);
+  auto buffer = write->move();
+  if (buffer != nullptr) {
+    spareBuffer_ = std::move(*buffer);
+  }
+}
+
+void SpillFileList::writeBuffer(WriteFile& file, const Buffer& buffer) {
+  const std::string_view data(buffer.as<char>(), buffer.size());
+  if (codec_ == nullptr) {
+    writeToDevice(data.size(), [&]() { file.append(data); });
+    spilledBytes_ += data.size();
+    return;
+  }
+  const auto uncompressed =
+      folly::IOBuf::wrapBufferAsValue(data.data(), data.size());
+  const auto compressed = codec_->compress(&uncompressed);
+  const uint32_t header[2] = {
+      static_cast<uint32_t>(compressed->computeChainDataLength()),
+      static_cast<uint32_t>(data.size())};
+  writeToDevice(sizeof(header) + header[0], [&]() {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(header), sizeof(header)));
+    for (const auto range : *compressed) {
+      file.append(std::string_view(
+          reinterpret_cast<const char*>(range.data()), range.size()));
+    }
+  });
+  spilledBytes_ += sizeof(header) + header[0];
+}
+
+void SpillFileList::writeToDevice(
+    uint64_t bytes,
+    const std::function<void()>& write) {
+  uint64_t writeMicros{0};
+  {
+    MicrosecondTimer timer(&writeMicros);
+    if (ioDevice_ == nullptr) {
+      write();
+    } else {
+      ioDevice_->write(queryId_, bytes, write);
+    }
+  }
+  REPORT_ADD_STAT_VALUE(kCounterSpillWriteBytes, bytes);
+  REPORT_ADD_STAT_VALUE(kCounterSpillWriteTimeUs, writeMicros);
+}
+
 void SpillFileList::flush() {
   if (batch_) {
     IOBufOutputStream out(
@@ -97,17 +688,81 @@ void SpillFileList::flush() {
     batch_->flush(&out);
     batch_.reset();
     auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
     for (auto& range : *iobuf) {
-      file.append(std::string_view(
+      append(std::string_view(
           reinterpret_cast<const char*>(range.data()), range.size()));
     }
   }
 }
 
+void SpillFileList::writeColumnar(
+    const RowVectorPtr& rows,
+    const folly::Range<IndexRange*>& indices) {
+  std::vector<vector_size_t> rowNumbers;
+  SelectivityVector selected(rows->size(), false);
+  for (const auto& range : indices) {
+    selected.setValidRange(range.begin, range.begin + range.size, true);
+    for (auto i = 0; i < range.size; ++i) {
+      rowNumbers.push_back(range.begin + i);
+    }
+  }
+  selected.updateBounds();
+  if (rowNumbers.empty()) {
+    return;
+  }
+
+  const auto numColumns = rows->childrenSize();
+  std::vector<DecodedVector> decoded(numColumns);
+  std::vector<bool> columnHasNulls(numColumns);
+  int64_t batchSize = 2 * columnarPadded(sizeof(uint32_t));
+  for (auto i = 0; i < numColumns; ++i) {
+    decoded[i].decode(*rows->childAt(i), selected);
+    columnHasNulls[i] = hasNulls(decoded[i], rowNumbers);
+    batchSize += columnarPadded(sizeof(uint64_t));
+    if (columnHasNulls[i]) {
+      batchSize += columnarPadded(bits::nbytes(rowNumbers.size()));
+    }
+    batchSize += VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        columnarValuesSize, type_->childAt(i)->kind(), decoded[i], rowNumbers);
+  }
+
+  const int64_t size = columnarPadded(sizeof(uint64_t)) + batchSize;
+  auto buffer = AlignedBuffer::allocate<char>(size, &pool_);
+  char* const start = buffer->asMutable<char>();
+  char* out = appendColumnar<uint64_t>(start, batchSize);
+  out = appendColumnar<uint32_t>(out, rowNumbers.size());
+  out = appendColumnar<uint32_t>(out, numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    if (!columnHasNulls[i]) {
+      out = appendColumnar<uint64_t>(out, 0);
+    } else {
+      const auto nullsSize = bits::nbytes(rowNumbers.size());
+      out = appendColumnar<uint64_t>(out, nullsSize);
+      auto* nulls = reinterpret_cast<uint64_t*>(out);
+      memset(out, 0, columnarPadded(nullsSize));
+      for (auto row = 0; row < rowNumbers.size(); ++row) {
+        bits::setBit(nulls, row, !decoded[i].isNullAt(rowNumbers[row]));
+      }
+      out += columnarPadded(nullsSize);
+    }
+    out = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        writeColumnarValues,
+        type_->childAt(i)->kind(),
+        decoded[i],
+        rowNumbers,
+        out);
+  }
+  VELOX_CHECK_EQ(out - start, size);
+  append(std::string_view(start, size));
+}
+
 void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
+  if (format_ == SpillFileFormat::kColumnar) {
+    writeColumnar(rows, indices);
+    return;
+  }
   if (!batch_) {
     batch_ = std::make_unique<VectorStreamGroup>(&pool_);
     batch_->createStreamTree(
@@ -122,6 +777,8 @@ void SpillFileList::write(
 
 void SpillFileList::finishFile() {
   flush();
+  startWrite();
+  waitForWrite();
   if (files_.empty()) {
     return;
   }
@@ -130,14 +787,6 @@ void SpillFileList::finishFile() {
   }
 }
 
-uint64_t SpillFileList::spilledBytes() const {
-  uint64_t bytes = 0;
-  for (auto& file : files_) {
-    bytes += file->size();
-  }
-  return bytes;
-}
-
 void SpillFileList::recordRuntimeStats() {
   for (const auto& file : files_) {
     addThreadLocalRuntimeStat(
@@ -171,9 +820,10 @@ void SpillState::appendToPartition(
         std::static_pointer_cast<const RowType>(rows->type()),
         numSortingKeys_,
         sortCompareFlags_,
-        fmt::format("{}-spill-{}", path_, partition),
+        fmt::format("{}-spill-{}", partitionPath(partition), partition),
         targetFileSize_,
-        pool_);
+        pool_,
+        fileOptions_);
   }
 
   IndexRange range{0, rows->size()};
@@ -182,13 +832,12 @@ void SpillState::appendToPartition(
 
 std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
     int32_t partition,
-    std::unique_ptr<SpillMergeStream>&& extra) {
+    std::unique_ptr<SpillMergeStream>&& extra,
+    folly::Executor* readExecutor) {
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillMergeStream>> result;
   if (auto list = std::move(files_[partition]); list) {
-    for (auto& file : list->files()) {
-      result.push_back(FileSpillMergeStream::create(std::move(file)));
-    }
+    result = FileSpillMergeStream::create(list->files(), readExecutor);
   }
   VELOX_DCHECK_EQ(!result.empty(), isPartitionSpilled(partition));
   if (extra != nullptr) {
@@ -271,6 +920,14 @@ std::vector<std::unique_ptr<SpillPartition>> SpillPartition::split(
   return shards;
 }
 
+uint64_t SpillPartition::size() const {
+  uint64_t size = 0;
+  for (const auto& file : files_) {
+    size += file->size();
+  }
+  return size;
+}
+
 std::unique_ptr<UnorderedStreamReader<BatchStream>>
 SpillPartition::createReader() {
   std::vector<std::unique_ptr<BatchStream>> streams;
@@ -283,6 +940,16 @@ SpillPartition::createReader() {
       std::move(streams));
 }
 
+std::unique_ptr<TreeOfLosers<SpillMergeStream>>
+SpillPartition::createOrderedReader(folly::Executor* readExecutor) {
+  if (files_.empty()) {
+    return nullptr;
+  }
+  auto streams = FileSpillMergeStream::create(std::move(files_), readExecutor);
+  files_.clear();
+  return std::make_unique<TreeOfLosers<SpillMergeStream>>(std::move(streams));
+}
+
 SpillPartitionIdSet toSpillPartitionIdSet(
     const SpillPartitionSet& partitionSet) {
   SpillPartitionIdSet partitionIdSet;
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <folly/compression/Compression.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/file/File.h"
+#include "velox/exec/SpillIoScheduler.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
 #include "velox/vector/ComplexVector.h"
@@ -27,27 +31,105 @@
 
 namespace facebook::velox::exec {
 
+/// The format of spill files.
+enum class SpillFileFormat {
+  /// Batches in Presto serialization. Supports all types.
+  kPresto,
+  /// Batches of flat columns laid out as they are in memory. A batch is read
+  /// back with one read and its vectors refer to the read buffer instead of
+  /// being deserialized. Supports row types whose columns are all of fixed
+  /// width, VARCHAR or VARBINARY. See isColumnarSpillable().
+  kColumnar,
+};
+
+/// Returns the format named 'name', "presto" or "columnar".
+SpillFileFormat spillFileFormatFromName(const std::string& name);
+
+std::string spillFileFormatName(SpillFileFormat format);
+
+/// Returns true if data of 'type' can be spilled in kColumnar format.
+bool isColumnarSpillable(const RowType& type);
+
+/// Returns the codec named 'name', one of "none", "lz4", "zstd", "snappy" or
+/// "zlib".
+folly::io::CodecType spillCompressionFromName(const std::string& name);
+
+/// Specifies how spill files are written.
+struct SpillFileOptions {
+  SpillFileFormat format{SpillFileFormat::kPresto};
+
+  /// The codec for compressing the spill files. The data is compressed in
+  /// frames of about SpillFileList::kWriteBufferSize bytes. A frame is the
+  /// compressed and uncompressed sizes as uint32_t followed by the compressed
+  /// data.
+  folly::io::CodecType compression{folly::io::CodecType::NO_COMPRESSION};
+
+  /// If set, spill data is buffered and each full buffer is compressed and
+  /// written on this executor while the next buffer is filled. Not owned.
+  folly::Executor* writeExecutor{nullptr};
+
+  /// The query the spill files belong to. Writes to a spill device
+  /// registered with SpillIoScheduler are admitted fairly between queries.
+  std::string queryId;
+
+  /// Path prefixes, typically on other spill devices, in addition to the
+  /// spill path of SpillState. The partitions of SpillState are striped over
+  /// the spill path and these.
+  std::vector<std::string> stripePaths;
+};
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'buffer' is
+  // nullptr, 'this' reads whole kColumnar batches with readBatch() and is not
+  // used as a ByteStream. If 'codec' is set, 'input' consists of frames
+  // compressed with 'codec' and 'buffer' must be nullptr. Each frame is read
+  // into a buffer of its own allocated from 'pool', so that the kColumnar
+  // batches returned by readBatch() can refer to it.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      std::unique_ptr<folly::io::Codec> codec = nullptr,
+      memory::MemoryPool* pool = nullptr)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
+        codec_(std::move(codec)),
+        pool_(pool),
         size_(input_->size()) {
-    next(true);
+    VELOX_CHECK(codec_ == nullptr || (buffer_ == nullptr && pool_ != nullptr));
+    if (buffer_ != nullptr || codec_ != nullptr) {
+      next(true);
+    }
   }
 
   void next(bool throwIfPastEnd) override;
 
+  // Reads the next kColumnar batch. The batch is prefixed by its size in the
+  // file. If the file is not compressed, the batch is read into a buffer
+  // allocated from 'pool'.
+  BufferPtr readBatch(memory::MemoryPool& pool);
+
   // True if all of the file has been read into vectors.
   bool atEnd() const {
+    if (buffer_ == nullptr && codec_ == nullptr) {
+      return offset_ >= size_;
+    }
     return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
   }
 
  private:
+  // Reads and decompresses the next frame into 'frame_'.
+  void readFrame();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  memory::MemoryPool* const pool_;
+  // The compressed data of the last frame.
+  BufferPtr compressed_;
+  // The uncompressed data of the current frame.
+  BufferPtr frame_;
   const uint64_t size_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
@@ -68,11 +150,14 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      const SpillFileOptions& options = {})
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         pool_(pool),
+        format_(options.format),
+        compression_(options.compression),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
     // NOTE: if the spilling operator has specified the sort comparison flags,
@@ -80,6 +165,14 @@ class SpillFile {
     VELOX_CHECK(
         sortCompareFlags_.empty() ||
         sortCompareFlags_.size() == numSortingKeys_);
+    VELOX_CHECK(
+        format_ != SpillFileFormat::kColumnar || isColumnarSpillable(*type_),
+        "Type can't be spilled in columnar format: {}",
+        type_->toString());
+  }
+
+  SpillFileFormat format() const {
+    return format_;
   }
 
   int32_t numSortingKeys() const {
@@ -114,6 +207,19 @@ class SpillFile {
 
   bool nextBatch(RowVectorPtr& rowVector);
 
+  /// Returns a new input stream positioned at the first row of content. Unlike
+  /// startRead(), this may be called any number of times, also from different
+  /// threads, to read the file repeatedly. The read buffer is allocated from
+  /// 'pool'. The caller must call output() and finishWrite() before this.
+  std::unique_ptr<SpillInput> makeInput(memory::MemoryPool& pool) const;
+
+  /// Reads the next batch from 'input' made by makeInput() into 'rowVector',
+  /// allocated from 'pool'. Returns false if 'input' is at end.
+  bool nextBatch(
+      SpillInput& input,
+      memory::MemoryPool& pool,
+      RowVectorPtr& rowVector) const;
+
   /// Returns the file size in bytes. During the writing phase this is
   /// the current size of the file, during reading this is the final
   // size.
@@ -140,6 +246,8 @@ class SpillFile {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   memory::MemoryPool& pool_;
+  const SpillFileFormat format_;
+  const folly::io::CodecType compression_;
 
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
@@ -162,7 +270,9 @@ class SpillFileList {
   /// content. 'numSortingKeys' is the number of leading columns on which the
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' is used for
-  /// buffering and constructing the result data read from 'this'.
+  /// buffering and constructing the result data read from 'this'. 'options'
+  /// specifies the format and compression of the files. kColumnar falls back
+  /// to kPresto if 'type' is not columnar spillable.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -172,19 +282,15 @@ class SpillFileList {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
-      : type_(type),
-        numSortingKeys_(numSortingKeys),
-        sortCompareFlags_(sortCompareFlags),
-        path_(path),
-        targetFileSize_(targetFileSize),
-        pool_(pool) {
-    // NOTE: if the associated spilling operator has specified the sort
-    // comparison flags, then it must match the number of sorting keys.
-    VELOX_CHECK(
-        sortCompareFlags_.empty() ||
-        sortCompareFlags_.size() == numSortingKeys_);
-  }
+      memory::MemoryPool& pool,
+      const SpillFileOptions& options = {});
+
+  ~SpillFileList();
+
+  /// The size of the buffers in which spill data is collected before it is
+  /// compressed and written if the data is compressed or written on an
+  /// executor.
+  static constexpr uint64_t kWriteBufferSize = 1 << 20;
 
   /// Adds 'rows' for the positions in 'indices' into 'this'. The indices
   /// must produce a view where the rows are sorted if sorting is desired.
@@ -205,7 +311,11 @@ class SpillFileList {
     return std::move(files_);
   }
 
-  uint64_t spilledBytes() const;
+  /// Returns the bytes written to the files so far. This does not include the
+  /// data being written on 'writeExecutor_'.
+  uint64_t spilledBytes() const {
+    return spilledBytes_;
+  }
 
   uint64_t spilledFiles() const {
     return files_.size();
@@ -220,6 +330,38 @@ class SpillFileList {
   // Writes data from 'batch_' to the current output file.
   void flush();
 
+  // Returns true if the data is collected into 'writeBuffer_' before it is
+  // written.
+  bool buffersWrites() const {
+    return codec_ != nullptr || writeExecutor_ != nullptr ||
+        ioDevice_ != nullptr;
+  }
+
+  // Writes 'data' to the current output file or adds it to 'writeBuffer_' if
+  // writes are buffered. The data of one call is not split between frames.
+  void append(std::string_view data);
+
+  // Starts writing 'writeBuffer_' to the current output file. The write runs
+  // on 'writeExecutor_' if set and otherwise on the caller thread.
+  void startWrite();
+
+  // Waits for the write started by startWrite(), if any, and rethrows its
+  // error.
+  void waitForWrite();
+
+  // Writes 'buffer' to 'file', compressed as one frame if 'codec_' is set.
+  void writeBuffer(WriteFile& file, const Buffer& buffer);
+
+  // Runs 'write' of 'bytes' through 'ioDevice_' if set and otherwise
+  // directly.
+  void writeToDevice(uint64_t bytes, const std::function<void()>& write);
+
+  // Writes the rows of 'rows' in 'indices' as one kColumnar batch to the
+  // current output file.
+  void writeColumnar(
+      const RowVectorPtr& rows,
+      const folly::Range<IndexRange*>& indices);
+
   // Invoked by 'files()' to record stats when finish writing all the spill
   // files.
   void recordRuntimeStats();
@@ -230,8 +372,25 @@ class SpillFileList {
   const std::string path_;
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
+  const SpillFileFormat format_;
+  const folly::io::CodecType compression_;
+  folly::Executor* const writeExecutor_;
+  const std::string queryId_;
+  // The registered spill device the files are on, nullptr if none.
+  SpillIoDevice* const ioDevice_;
+  // Compresses the frames if the files are compressed. Used by one write at
+  // a time.
+  std::unique_ptr<folly::io::Codec> codec_;
   std::unique_ptr<VectorStreamGroup> batch_;
   SpillFiles files_;
+  std::atomic<uint64_t> spilledBytes_{0};
+
+  // The buffer being filled if writes are buffered.
+  BufferPtr writeBuffer_;
+  // The buffer of the last finished write, reused for 'writeBuffer_'.
+  BufferPtr spareBuffer_;
+  // The write in progress. Its result is the written buffer.
+  std::shared_ptr<AsyncSource<BufferPtr>> pendingWrite_;
 };
 
 // A source of sorted spilled RowVectors coming either from a file or memory.
@@ -332,7 +491,7 @@ class SpillMergeStream : public MergeStream {
     ensureRows();
     decoded_.resize(index + 1);
     for (auto i = oldSize; i <= index; ++i) {
-      decoded_[index].decode(*rowVector_->childAt(index), rows_);
+      decoded_[i].decode(*rowVector_->childAt(i), rows_);
     }
   }
 
@@ -362,17 +521,32 @@ class SpillMergeStream : public MergeStream {
 // A source of spilled RowVectors coming from a file.
 class FileSpillMergeStream : public SpillMergeStream {
  public:
+  // Number of batches read ahead at a time if reading on an executor.
+  static constexpr int32_t kReadAheadBatches = 16;
+
   static std::unique_ptr<SpillMergeStream> create(
       std::unique_ptr<SpillFile> spillFile) {
     spillFile->startRead();
-    auto* spillStream = new FileSpillMergeStream(std::move(spillFile));
+    auto* spillStream = new FileSpillMergeStream(std::move(spillFile), nullptr);
     spillStream->nextBatch();
     return std::unique_ptr<SpillMergeStream>(spillStream);
   }
 
+  // Makes a stream for each of 'spillFiles'. If 'readExecutor' is set, the
+  // files are read, decompressed and deserialized on it, in parallel with each
+  // other and with the merge. Each stream then reads up to kReadAheadBatches
+  // ahead of the batch being merged.
+  static std::vector<std::unique_ptr<SpillMergeStream>> create(
+      SpillFiles spillFiles,
+      folly::Executor* readExecutor);
+
+  ~FileSpillMergeStream() override;
+
  private:
-  explicit FileSpillMergeStream(std::unique_ptr<SpillFile> spillFile)
-      : spillFile_(std::move(spillFile)) {
+  FileSpillMergeStream(
+      std::unique_ptr<SpillFile> spillFile,
+      folly::Executor* readExecutor)
+      : spillFile_(std::move(spillFile)), readExecutor_(readExecutor) {
     VELOX_CHECK_NOT_NULL(spillFile_);
   }
 
@@ -384,16 +558,20 @@ class FileSpillMergeStream : public SpillMergeStream {
     return spillFile_->sortCompareFlags();
   }
 
-  void nextBatch() override {
-    index_ = 0;
-    if (!spillFile_->nextBatch(rowVector_)) {
-      size_ = 0;
-      return;
-    }
-    size_ = rowVector_->size();
-  }
+  void nextBatch() override;
+
+  // Starts reading the next kReadAheadBatches batches on 'readExecutor_'.
+  void startReadAhead();
 
   std::unique_ptr<SpillFile> spillFile_;
+  folly::Executor* const readExecutor_;
+  // The batches read ahead. The next batch to merge is at
+  // 'nextReadAheadBatch_'.
+  std::vector<RowVectorPtr> readAheadBatches_;
+  size_t nextReadAheadBatch_{0};
+  // The read of the batches after 'readAheadBatches_'. An empty result means
+  // that the file is at end.
+  std::shared_ptr<AsyncSource<std::vector<RowVectorPtr>>> readAhead_;
 };
 
 /// A source of spilled RowVectors coming from a file. The spill data might not
@@ -521,6 +699,9 @@ class SpillPartition {
     return files_.size();
   }
 
+  /// Returns the total size of the spill files in bytes.
+  uint64_t size() const;
+
   /// Invoked to split this spill partition into 'numShards' to process in
   /// parallel.
   ///
@@ -531,6 +712,13 @@ class SpillPartition {
   /// The created reader will take the ownership of the spill files.
   std::unique_ptr<UnorderedStreamReader<BatchStream>> createReader();
 
+  /// Invoked to create a sorted merge reader over the runs in the spill files
+  /// of this partition. The created reader will take the ownership of the
+  /// spill files. Returns nullptr if there are no files. If 'readExecutor' is
+  /// set, the files are read ahead of the merge on it.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> createOrderedReader(
+      folly::Executor* readExecutor = nullptr);
+
  private:
   SpillPartitionId id_;
   SpillFiles files_;
@@ -549,19 +737,21 @@ class SpillState {
   /// 'numSortingKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// results. 'fileOptions' specifies how the spill files are written.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      const SpillFileOptions& fileOptions = {})
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        fileOptions_(fileOptions),
         pool_(pool),
         files_(maxPartitions_) {}
 
@@ -583,6 +773,10 @@ class SpillState {
     return targetFileSize_;
   }
 
+  const SpillFileOptions& fileOptions() const {
+    return fileOptions_;
+  }
+
   memory::MemoryPool& pool() const {
     return pool_;
   }
@@ -617,10 +811,12 @@ class SpillState {
 
   // Starts reading values for 'partition'. If 'extra' is non-null, it can be
   // a stream of rows from a RowContainer so as to merge unspilled data with
-  // spilled data.
+  // spilled data. If 'readExecutor' is set, the spill files are read ahead of
+  // the merge on it.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> startMerge(
       int32_t partition,
-      std::unique_ptr<SpillMergeStream>&& extra);
+      std::unique_ptr<SpillMergeStream>&& extra,
+      folly::Executor* readExecutor = nullptr);
 
   bool hasFiles(int32_t partition) const {
     return partition < files_.size() && files_[partition];
@@ -640,12 +836,21 @@ class SpillState {
   std::vector<std::string> testingSpilledFilePaths() const;
 
  private:
+  // Returns the path prefix of the files of 'partition'. The partitions are
+  // striped over 'path_' and the stripe paths in 'fileOptions_'.
+  const std::string& partitionPath(int32_t partition) const {
+    const auto& stripePaths = fileOptions_.stripePaths;
+    const auto stripe = partition % (stripePaths.size() + 1);
+    return stripe == 0 ? path_ : stripePaths[stripe - 1];
+  }
+
   const RowTypePtr type_;
   const std::string path_;
   const int32_t maxPartitions_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const uint64_t targetFileSize_;
+  const SpillFileOptions fileOptions_;
 
   memory::MemoryPool& pool_;
 
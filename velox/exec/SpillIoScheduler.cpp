@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SpillIoScheduler.h"
+
+#include <folly/ScopeGuard.h>
+#include <chrono>
+#include <thread>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+uint64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+void SpillIoDevice::write(
+    const std::string& queryId,
+    uint64_t bytes,
+    const std::function<void()>& write) {
+  const auto startNanos = nowNanos();
+  uint64_t writeStartNanos;
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    if (numWaiting_ == 0 && hasCapacityLocked()) {
+      ++numRunning_;
+    } else {
+      Waiter waiter;
+      auto& queryWaiters = waiters_[queryId];
+      if (queryWaiters.empty()) {
+        queryTurns_.push_back(queryId);
+      }
+      queryWaiters.push_back(&waiter);
+      ++numWaiting_;
+      stats_.maxQueueDepth = std::max(stats_.maxQueueDepth, numWaiting_);
+      admittedCv_.wait(l, [&]() { return waiter.admitted; });
+    }
+    writeStartNanos = reserveBandwidthLocked(bytes);
+  }
+
+  auto finish = folly::makeGuard([&]() {
+    const auto endNanos = nowNanos();
+    std::lock_guard<std::mutex> l(mutex_);
+    --numRunning_;
+    ++stats_.numWrites;
+    stats_.writtenBytes += bytes;
+    stats_.waitNanos += std::max(writeStartNanos, startNanos) - startNanos;
+    stats_.writeNanos += endNanos - std::max(writeStartNanos, startNanos);
+    admitWaitersLocked();
+  });
+  const auto now = nowNanos();
+  if (writeStartNanos > now) {
+    std::this_thread::sleep_for(
+        std::chrono::nanoseconds(writeStartNanos - now));
+  }
+  write();
+}
+
+void SpillIoDevice::admitWaitersLocked() {
+  bool admitted = false;
+  while (!queryTurns_.empty() && hasCapacityLocked()) {
+    auto queryId = std::move(queryTurns_.front());
+    queryTurns_.pop_front();
+    auto it = waiters_.find(queryId);
+    VELOX_CHECK(it != waiters_.end());
+    auto& queryWaiters = it->second;
+    queryWaiters.front()->admitted = true;
+    queryWaiters.pop_front();
+    --numWaiting_;
+    ++numRunning_;
+    admitted = true;
+    if (queryWaiters.empty()) {
+      waiters_.erase(it);
+    } else {
+      queryTurns_.push_back(std::move(queryId));
+    }
+  }
+  if (admitted) {
+    admittedCv_.notify_all();
+  }
+}
+
+uint64_t SpillIoDevice::reserveBandwidthLocked(uint64_t bytes) {
+  const auto now = nowNanos();
+  if (options_.maxBytesPerSec == 0) {
+    return now;
+  }
+  const auto startNanos = std::max(now, bandwidthFreeNanos_);
+  bandwidthFreeNanos_ = startNanos +
+      static_cast<uint64_t>(bytes * 1'000'000'000.0 / options_.maxBytesPerSec);
+  return startNanos;
+}
+
+SpillIoDevice::Stats SpillIoDevice::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.path = path_;
+  return stats;
+}
+
+// static
+SpillIoScheduler& SpillIoScheduler::getInstance() {
+  static SpillIoScheduler instance;
+  return instance;
+}
+
+void SpillIoScheduler::addDevice(
+    const std::string& path,
+    const SpillIoDevice::Options& options) {
+  VELOX_CHECK(!path.empty());
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& device : devices_) {
+    VELOX_CHECK_NE(
+        device->path(), path, "Spill device is already registered");
+  }
+  devices_.push_back(std::make_unique<SpillIoDevice>(path, options));
+}
+
+SpillIoDevice* SpillIoScheduler::deviceFor(const std::string& filePath) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  SpillIoDevice* result = nullptr;
+  for (const auto& device : devices_) {
+    const auto& path = device->path();
+    if (filePath.compare(0, path.size(), path) == 0 &&
+        (result == nullptr || path.size() > result->path().size())) {
+      result = device.get();
+    }
+  }
+  return result;
+}
+
+std::vector<SpillIoDevice::Stats> SpillIoScheduler::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  std::vector<SpillIoDevice::Stats> stats;
+  stats.reserve(devices_.size());
+  for (const auto& device : devices_) {
+    stats.push_back(device->stats());
+  }
+  return stats;
+}
+
+} // namespace facebook::velox::exec
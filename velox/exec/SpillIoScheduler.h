@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// One spill device, e.g. a disk mounted under a directory. Throttles the
+/// spill writes of all queries to the device to a bandwidth budget and a
+/// number of concurrent writes. Writes that have to wait are admitted round
+/// robin between queries, so that a query spilling heavily does not starve
+/// the others.
+class SpillIoDevice {
+ public:
+  struct Options {
+    /// The max write bandwidth of the device in bytes per second. 0 means
+    /// no limit.
+    uint64_t maxBytesPerSec{0};
+
+    /// The max number of writes to the device in progress at a time. 0 means
+    /// no limit.
+    int32_t maxConcurrentWrites{0};
+  };
+
+  struct Stats {
+    std::string path;
+    uint64_t numWrites{0};
+    uint64_t writtenBytes{0};
+    /// Time spent in the writes.
+    uint64_t writeNanos{0};
+    /// Time the writes waited for admission and bandwidth.
+    uint64_t waitNanos{0};
+    /// Max number of writes waiting for admission at a time.
+    int32_t maxQueueDepth{0};
+
+    /// Returns the bytes written per second of write time.
+    double writeBytesPerSec() const {
+      return writeNanos == 0 ? 0 : writtenBytes * 1'000'000'000.0 / writeNanos;
+    }
+  };
+
+  SpillIoDevice(std::string path, const Options& options)
+      : path_(std::move(path)), options_(options) {}
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  /// Runs 'write' of 'bytes' for 'queryId' when the device admits it. Blocks
+  /// the caller until then.
+  void write(
+      const std::string& queryId,
+      uint64_t bytes,
+      const std::function<void()>& write);
+
+  Stats stats() const;
+
+ private:
+  struct Waiter {
+    bool admitted{false};
+  };
+
+  // Returns true if a write can start now.
+  bool hasCapacityLocked() const {
+    return options_.maxConcurrentWrites == 0 ||
+        numRunning_ < options_.maxConcurrentWrites;
+  }
+
+  // Admits waiting writes while there is capacity, taking one write from
+  // each query in turn.
+  void admitWaitersLocked();
+
+  // Reserves 'bytes' of bandwidth and returns the steady clock time in
+  // nanoseconds at which the write may start.
+  uint64_t reserveBandwidthLocked(uint64_t bytes);
+
+  const std::string path_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable admittedCv_;
+  int32_t numRunning_{0};
+  int32_t numWaiting_{0};
+  // Waiting writes per query, in arrival order.
+  std::unordered_map<std::string, std::deque<Waiter*>> waiters_;
+  // Queries with waiting writes in the order they get their next turn.
+  std::deque<std::string> queryTurns_;
+  // The steady clock time in nanoseconds when the bandwidth reserved so far
+  // is used up.
+  uint64_t bandwidthFreeNanos_{0};
+  Stats stats_;
+};
+
+/// Process wide registry of spill devices. Spill files whose path is under a
+/// registered device are written through that device. Other spill files are
+/// written directly.
+class SpillIoScheduler {
+ public:
+  static SpillIoScheduler& getInstance();
+
+  /// Registers the spill device mounted at 'path'. Devices cannot be
+  /// removed, so that the spill files can hold on to theirs.
+  void addDevice(
+      const std::string& path,
+      const SpillIoDevice::Options& options);
+
+  /// Returns the device with the longest path that is a prefix of
+  /// 'filePath', nullptr if none.
+  SpillIoDevice* deviceFor(const std::string& filePath) const;
+
+  /// Returns the stats of all devices in registration order.
+  std::vector<SpillIoDevice::Stats> stats() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<SpillIoDevice>> devices_;
+};
+
+} // namespace facebook::velox::exec
@@ -167,6 +167,27 @@ bool SpillOperatorGroup::waitSpillLocked(
   return true;
 }
 
+bool SpillOperatorGroup::runSpillForReclaim(
+    const std::function<bool(const Operator& op)>& canSpill) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (state_ != State::kRunning || needSpill_) {
+      return false;
+    }
+    for (const auto* op : operators_) {
+      if (!canSpill(*op)) {
+        return false;
+      }
+    }
+    VELOX_CHECK_EQ(numWaitingOperators_, 0);
+    needSpill_ = true;
+  }
+  // No operator waits for the spill as their drivers are paused.
+  std::vector<ContinuePromise> promises;
+  runSpill(promises);
+  return true;
+}
+
 void SpillOperatorGroup::runSpill(std::vector<ContinuePromise>& promises) {
   VELOX_CHECK(needSpill_);
   spillRunner_(operators_);
@@ -110,6 +110,13 @@ class SpillOperatorGroup {
   /// spill for the group.
   bool waitSpill(Operator& op, ContinueFuture& future);
 
+  /// Invoked to run the group spill on request of the memory arbitrator with
+  /// the task paused, instead of on the spill barrier. The function returns
+  /// false without spilling if the group is not running, there is a pending
+  /// spill request or 'canSpill' returns false for any of the operators.
+  bool runSpillForReclaim(
+      const std::function<bool(const Operator& op)>& canSpill);
+
  private:
   void checkStoppedStateLocked() const;
 
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SpillPartitionQueue.h"
+
+#include <algorithm>
+
+namespace facebook::velox::exec {
+
+void SpillPartitionQueue::add(SpillPartitionSet partitions) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [id, partition] : partitions) {
+    partitions_.push_back(std::move(partition));
+  }
+}
+
+std::unique_ptr<SpillPartition> SpillPartitionQueue::next() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (partitions_.empty()) {
+    return nullptr;
+  }
+  auto largest = std::max_element(
+      partitions_.begin(),
+      partitions_.end(),
+      [](const auto& left, const auto& right) {
+        return left->size() < right->size();
+      });
+  auto partition = std::move(*largest);
+  partitions_.erase(largest);
+  return partition;
+}
+
+} // namespace facebook::velox::exec
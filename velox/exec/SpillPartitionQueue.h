@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "velox/exec/Spill.h"
+
+namespace facebook::velox::exec {
+
+/// The spilled partitions of the drivers of a final aggregation plan node
+/// within a task (split group) if
+/// QueryConfig::kAggregationSpillParallelMergeEnabled is set. Each driver
+/// adds its spilled partitions once it has received all its input. The
+/// drivers then claim the partitions one at a time and merge each into final
+/// results independently, so that the partitions of a driver with many
+/// spilled groups are merged by the drivers that are done with their own
+/// groups.
+class SpillPartitionQueue {
+ public:
+  /// Adds 'partitions' to be claimed by next().
+  void add(SpillPartitionSet partitions);
+
+  /// Returns the largest partition that has not been claimed yet or nullptr
+  /// if there is none. Merging the largest first keeps the drivers busy for
+  /// about the same time.
+  std::unique_ptr<SpillPartition> next();
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<SpillPartition>> partitions_;
+};
+
+} // namespace facebook::velox::exec
@@ -37,7 +37,8 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    const SpillFileOptions& fileOptions)
     : Spiller(
           type,
           container,
@@ -50,8 +51,10 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          fileOptions) {
+  VELOX_CHECK(
+      isSinglePartition(), "Unexpected spiller type: {}", typeName(type_));
 }
 
 Spiller::Spiller(
@@ -62,7 +65,8 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    const SpillFileOptions& fileOptions)
     : Spiller(
           type,
           nullptr,
@@ -75,7 +79,8 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
+          executor,
+          fileOptions) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -91,7 +96,8 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    const SpillFileOptions& fileOptions)
     : type_(type),
       container_(container),
       eraser_(eraser),
@@ -104,15 +110,17 @@ Spiller::Spiller(
           numSortingKeys,
           sortCompareFlags,
           targetFileSize,
-          pool),
+          pool,
+          fileOptions),
       pool_(pool),
       executor_(executor) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
   VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kOrderBy, kWindow, kTopNRowNumber and kTopN spiller types must only have
+  // one partition.
+  VELOX_CHECK(!isSinglePartition() || (state_.maxPartitions() == 1));
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(pool_);
@@ -129,9 +137,11 @@ void Spiller::extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr) {
   }
   auto result = resultPtr.get();
   auto& types = container_->columnTypes();
-  for (auto i = 0; i < types.size(); ++i) {
-    container_->extractColumn(rows.data(), rows.size(), i, result->childAt(i));
-  }
+  std::vector<column_index_t> columns(types.size());
+  std::iota(columns.begin(), columns.end(), 0);
+  std::vector<VectorPtr> columnVectors(
+      result->children().begin(), result->children().begin() + types.size());
+  container_->extractColumns(rows.data(), rows.size(), columns, columnVectors);
   auto& aggregates = container_->aggregates();
   auto numKeys = types.size();
   for (auto i = 0; i < aggregates.size(); ++i) {
@@ -507,7 +517,30 @@ Spiller::SpillRows Spiller::finishSpill() {
 void Spiller::finishSpill(SpillPartitionSet& partitionSet) {
   VELOX_CHECK(!spillFinalized_);
   spillFinalized_ = true;
+  addSpilledPartitions(partitionSet);
+}
+
+Spiller::SpillRows Spiller::finishSpillToFiles(
+    SpillPartitionSet& partitionSet) {
+  VELOX_CHECK(!spillFinalized_);
+  VELOX_CHECK_NE(type_, Type::kHashJoinProbe);
+  VELOX_CHECK(pendingSpillPartitions_.empty());
+  fillSpillRuns(nullptr);
+  for (auto partition : state_.spilledPartitionSet()) {
+    if (!spillRuns_[partition].rows.empty()) {
+      pendingSpillPartitions_.insert(partition);
+    }
+  }
+  while (!pendingSpillPartitions_.empty()) {
+    advanceSpill();
+  }
+  // Only the rows of the partitions that have not spilled are left.
+  auto rows = finishSpill();
+  addSpilledPartitions(partitionSet);
+  return rows;
+}
 
+void Spiller::addSpilledPartitions(SpillPartitionSet& partitionSet) {
   for (auto& partition : state_.spilledPartitionSet()) {
     const SpillPartitionId partitionId(bits_.begin(), partition);
     if (FOLLY_UNLIKELY(partitionSet.count(partitionId) == 0)) {
@@ -548,7 +581,7 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition = isSinglePartition()
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -586,7 +619,7 @@ std::string Spiller::toString() const {
       spillFinalized_);
 }
 
-int32_t Spiller::Config::spillLevel(uint8_t startBitOffset) const {
+int32_t SpillConfig::spillLevel(uint8_t startBitOffset) const {
   const auto numPartitionBits = hashBitRange.numBits();
   VELOX_CHECK_LE(
       startBitOffset + numPartitionBits,
@@ -605,7 +638,7 @@ int32_t Spiller::Config::spillLevel(uint8_t startBitOffset) const {
   return deltaBits / numPartitionBits;
 }
 
-bool Spiller::Config::exceedSpillLevelLimit(uint8_t startBitOffset) const {
+bool SpillConfig::exceedSpillLevelLimit(uint8_t startBitOffset) const {
   if (startBitOffset + hashBitRange.numBits() > 64) {
     return true;
   }
@@ -626,6 +659,16 @@ std::string Spiller::typeName(Type type) {
       return "HASH_JOIN_PROBE";
     case Type::kAggregate:
       return "AGGREGATE";
+    case Type::kWindow:
+      return "WINDOW";
+    case Type::kTopNRowNumber:
+      return "TOPN_ROW_NUMBER";
+    case Type::kTopN:
+      return "TOPN";
+    case Type::kMergeJoin:
+      return "MERGE_JOIN";
+    case Type::kNestedLoopJoinBuild:
+      return "NESTED_LOOP_JOIN_BUILD";
     default:
       VELOX_UNREACHABLE("Unknown type: {}", static_cast<int>(type));
       return fmt::format("UNKNOWN TYPE: {}", static_cast<int>(type));
@@ -20,6 +20,79 @@
 
 namespace facebook::velox::exec {
 
+/// Specifies the config for spilling.
+struct SpillConfig {
+  SpillConfig(
+      const std::string& _filePath,
+      uint64_t _maxFileSize,
+      uint64_t _minSpillRunSize,
+      folly::Executor* FOLLY_NULLABLE _executor,
+      int32_t _spillableReservationGrowthPct,
+      const HashBitRange& _hashBitRange,
+      int32_t _maxSpillLevel,
+      int32_t _testSpillPct)
+      : filePath(_filePath),
+        maxFileSize(
+            _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
+                              : _maxFileSize),
+        minSpillRunSize(_minSpillRunSize),
+        executor(_executor),
+        spillableReservationGrowthPct(_spillableReservationGrowthPct),
+        hashBitRange(_hashBitRange),
+        maxSpillLevel(_maxSpillLevel),
+        testSpillPct(_testSpillPct) {}
+
+  /// Returns the spilling level with given 'startBitOffset'.
+  ///
+  /// NOTE: we advance (or right shift) the partition bit offset when goes to
+  /// the next level of recursive spilling.
+  int32_t spillLevel(uint8_t startBitOffset) const;
+
+  /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
+  bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
+
+  /// Filesystem path for spill files.
+  std::string filePath;
+
+  /// The max spill file size. If it is zero, there is no limit on the spill
+  /// file size.
+  uint64_t maxFileSize;
+
+  /// The min spill run size (bytes) limit used to select partitions for
+  /// spilling. The spiller tries to spill a previously spilled partitions if
+  /// its data size exceeds this limit, otherwise it spills the partition with
+  /// most data. If the limit is zero, then the spiller always spill a
+  /// previously spilled partition if it has any data. This is to avoid spill
+  /// from a partition wigth a small amount of data which might result in
+  /// generating too many small spilled files.
+  uint64_t minSpillRunSize;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE executor; // Not owned.
+
+  // The spillable memory reservation growth percentage of the current
+  // reservation size.
+  int32_t spillableReservationGrowthPct;
+
+  // Used to calculate the spill hash partition number.
+  HashBitRange hashBitRange;
+
+  // The max allowed spilling level with zero being the initial spilling
+  // level. This only applies for hash build spilling which needs recursive
+  // spilling when the build table is too big. If it is set to -1, then there
+  // is no limit and then some extreme large query might run out of spilling
+  // partition bits at the end.
+  int32_t maxSpillLevel;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  int32_t testSpillPct;
+
+  // Specifies the format and compression of the spill files and the
+  // executor for writing them.
+  SpillFileOptions fileOptions;
+};
+
 /// Manages spilling data from a RowContainer.
 class Spiller {
  public:
@@ -33,83 +106,27 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
+    // Used for top-n row number.
+    kTopNRowNumber = 5,
+    // Used for top-n.
+    kTopN = 6,
+    // Used for merge join.
+    kMergeJoin = 7,
+    // Used for nested loop join build.
+    kNestedLoopJoinBuild = 8,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 9;
   static std::string typeName(Type);
 
-  // Specifies the config for spilling.
-  struct Config {
-    Config(
-        const std::string& _filePath,
-        uint64_t _maxFileSize,
-        uint64_t _minSpillRunSize,
-        folly::Executor* FOLLY_NULLABLE _executor,
-        int32_t _spillableReservationGrowthPct,
-        const HashBitRange& _hashBitRange,
-        int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
-        : filePath(_filePath),
-          maxFileSize(
-              _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
-                                : _maxFileSize),
-          minSpillRunSize(_minSpillRunSize),
-          executor(_executor),
-          spillableReservationGrowthPct(_spillableReservationGrowthPct),
-          hashBitRange(_hashBitRange),
-          maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
-
-    /// Returns the spilling level with given 'startBitOffset'.
-    ///
-    /// NOTE: we advance (or right shift) the partition bit offset when goes to
-    /// the next level of recursive spilling.
-    int32_t spillLevel(uint8_t startBitOffset) const;
-
-    /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
-    bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
-
-    /// Filesystem path for spill files.
-    std::string filePath;
-
-    /// The max spill file size. If it is zero, there is no limit on the spill
-    /// file size.
-    uint64_t maxFileSize;
-
-    /// The min spill run size (bytes) limit used to select partitions for
-    /// spilling. The spiller tries to spill a previously spilled partitions if
-    /// its data size exceeds this limit, otherwise it spills the partition with
-    /// most data. If the limit is zero, then the spiller always spill a
-    /// previously spilled partition if it has any data. This is to avoid spill
-    /// from a partition wigth a small amount of data which might result in
-    /// generating too many small spilled files.
-    uint64_t minSpillRunSize;
-
-    // Executor for spilling. If nullptr spilling writes on the Driver's thread.
-    folly::Executor* FOLLY_NULLABLE executor; // Not owned.
-
-    // The spillable memory reservation growth percentage of the current
-    // reservation size.
-    int32_t spillableReservationGrowthPct;
-
-    // Used to calculate the spill hash partition number.
-    HashBitRange hashBitRange;
-
-    // The max allowed spilling level with zero being the initial spilling
-    // level. This only applies for hash build spilling which needs recursive
-    // spilling when the build table is too big. If it is set to -1, then there
-    // is no limit and then some extreme large query might run out of spilling
-    // partition bits at the end.
-    int32_t maxSpillLevel;
-
-    // Percentage of input batches to be spilled for testing. 0 means no
-    // spilling for test.
-    int32_t testSpillPct;
-  };
+  using Config = SpillConfig;
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy, kWindow,
+  // kTopNRowNumber and kTopN spiller types as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +138,8 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      const SpillFileOptions& fileOptions = {});
 
   Spiller(
       Type type,
@@ -131,7 +149,8 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      const SpillFileOptions& fileOptions = {});
 
   Spiller(
       Type type,
@@ -145,7 +164,8 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      const SpillFileOptions& fileOptions = {});
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -201,7 +221,8 @@ class Spiller {
     if (FOLLY_UNLIKELY(!needSort())) {
       VELOX_FAIL("Can't sort merge the unsorted spill data: {}", toString());
     }
-    return state_.startMerge(partition, spillMergeStreamOverRows(partition));
+    return state_.startMerge(
+        partition, spillMergeStreamOverRows(partition), executor_);
   }
 
   // Extracts up to 'maxRows' or 'maxBytes' from 'rows' into
@@ -219,6 +240,14 @@ class Spiller {
   /// 'partitionSet' by spill partition id.
   void finishSpill(SpillPartitionSet& partitionSet);
 
+  /// Writes the rows of the spilled partitions that are still in the row
+  /// container to their spill files and finishes spilling. Accumulates the
+  /// spilled partition data in 'partitionSet' by spill partition id and
+  /// returns the rows that are in partitions that have not started spilling.
+  /// Used for merging the spilled partitions independently of the row
+  /// container, e.g. on other drivers.
+  SpillRows finishSpillToFiles(SpillPartitionSet& partitionSet);
+
   const SpillState& state() const {
     return state_;
   }
@@ -381,6 +410,10 @@ class Spiller {
   // Clears pending spill state.
   void clearSpillRuns();
 
+  // Moves the files of the spilled partitions into 'partitionSet'. Called
+  // when finishing spilling.
+  void addSpilledPartitions(SpillPartitionSet& partitionSet);
+
   // Clears runs that have not started spilling.
   void clearNonSpillingRuns();
 
@@ -401,6 +434,14 @@ class Spiller {
   // non hash join types of spilling.
   bool needSort() const;
 
+  // Indicates if the spiller only uses a single partition. This applies to
+  // the spiller types that sort the spilled data globally, such as kOrderBy,
+  // kWindow, kTopNRowNumber and kTopN.
+  bool isSinglePartition() const {
+    return type_ == Type::kOrderBy || type_ == Type::kWindow ||
+        type_ == Type::kTopNRowNumber || type_ == Type::kTopN;
+  }
+
   const Type type_;
   // NOTE: for hash join probe type, there is no associated row container for
   // the spiller.
@@ -16,6 +16,7 @@
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/vector/SequenceVector.h"
 
 namespace facebook::velox::exec {
 
@@ -206,8 +207,12 @@ void StreamingAggregation::assignGroups() {
     auto* newGroup = startNewGroup(index);
     inputGroups_[index] = newGroup;
 
+    const bool hasRuns = findRunStarts();
     for (auto i = index + 1; i < numInput; ++i) {
-      if (equalKeys(groupingKeys_, input_, index, input_, i)) {
+      if (hasRuns && !bits::isBitSet(runStarts_.data(), i)) {
+        // Same keys as the previous row.
+        inputGroups_[i] = inputGroups_[i - 1];
+      } else if (equalKeys(groupingKeys_, input_, index, input_, i)) {
         inputGroups_[i] = inputGroups_[index];
       } else {
         newGroup = startNewGroup(i);
@@ -218,6 +223,21 @@ void StreamingAggregation::assignGroups() {
   }
 }
 
+bool StreamingAggregation::findRunStarts() {
+  if (groupingKeys_.empty()) {
+    return false;
+  }
+  runStarts_.resize(bits::nwords(input_->size()));
+  std::fill(runStarts_.begin(), runStarts_.end(), 0);
+  for (auto channel : groupingKeys_) {
+    if (!setRunStarts(
+            *input_->childAt(channel)->loadedVector(), runStarts_.data())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 const SelectivityVector& StreamingAggregation::getSelectivityVector(
     size_t aggregateIndex) const {
   auto* rows = masks_->activeRows(aggregateIndex);
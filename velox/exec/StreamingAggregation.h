@@ -65,6 +65,10 @@ class StreamingAggregation : public Operator {
   // assignments in inputGroups_.
   void assignGroups();
 
+  // Returns true if all the grouping keys of 'input_' are SequenceVectors and
+  // sets the first row of each run where any key changes in 'runStarts_'.
+  bool findRunStarts();
+
   // Add input data to accumulators.
   void evaluateAggregates();
 
@@ -99,6 +103,10 @@ class StreamingAggregation : public Operator {
   // Pointers to groups for all input rows.
   std::vector<char*> inputGroups_;
 
+  // The rows of 'input_' where a run of equal keys starts if all the keys are
+  // SequenceVectors. The keys are compared only at these rows.
+  std::vector<uint64_t> runStarts_;
+
   // A subset of input rows to evaluate the aggregate function on. Rows
   // where aggregation mask is false are excluded.
   SelectivityVector inputRows_;
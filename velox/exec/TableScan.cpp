@@ -15,6 +15,7 @@
  */
 #include "velox/exec/TableScan.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/HashAggregation.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
 
@@ -37,15 +38,21 @@ TableScan::TableScan(
       tableHandle_(tableScanNode->tableHandle()),
       columnHandles_(tableScanNode->assignments()),
       driverCtx_(driverCtx),
-      connectorPool_(driverCtx_->task->addConnectorPoolLocked(
-          planNodeId(),
-          driverCtx_->pipelineId,
-          driverCtx_->driverId,
-          operatorType(),
-          tableHandle_->connectorId())),
+      connectorPool_(driverCtx_->task
+                         ->addConnectorPoolLocked(
+                             planNodeId(),
+                             driverCtx_->pipelineId,
+                             driverCtx_->driverId,
+                             driverCtx_->splitGroupId,
+                             operatorType(),
+                             tableHandle_->connectorId())
+                         ->shared_from_this()),
       readBatchSize_(driverCtx_->task->queryCtx()
                          ->queryConfig()
-                         .preferredOutputBatchRows()) {
+                         .preferredOutputBatchRows()),
+      adaptiveBatchSize_(driverCtx_->task->queryCtx()
+                             ->queryConfig()
+                             .adaptiveScanBatchSizeEnabled()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
 }
 
@@ -54,8 +61,32 @@ RowVectorPtr TableScan::getOutput() {
     return nullptr;
   }
 
+  if (!cachingAggregationChecked_) {
+    cachingAggregation_ =
+        operatorCtx_->driver()->splitResultCachingAggregation();
+    remainingRowLimit_ = operatorCtx_->driver()->sourceRowLimit();
+    cachingAggregationChecked_ = true;
+  }
+
   for (;;) {
+    addImportedDynamicFilters();
+    if (splitDataDone_) {
+      if (!operatorCtx_->driver()->isDrainedUpTo(cachingAggregation_)) {
+        return nullptr;
+      }
+      cachingAggregation_->finishSplit(!hasDynamicFilters_);
+      splitDataDone_ = false;
+      cachingSplit_ = false;
+      endSplit();
+      // Lets the Driver pass the results of the split downstream before the
+      // next split starts.
+      return nullptr;
+    }
     if (needNewSplit_) {
+      if (cachingAggregation_ != nullptr &&
+          cachingAggregation_->isSplitPending()) {
+        return nullptr;
+      }
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
           driverCtx_->splitGroupId,
@@ -71,37 +102,29 @@ RowVectorPtr TableScan::getOutput() {
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
         if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          auto lockedStats = stats_.wlock();
-          for (const auto& [name, counter] : connectorStats) {
-            if (name == "ioWaitNanos") {
-              ioWaitNanos_ += counter.value - lastIoWaitNanos_;
-              lastIoWaitNanos_ = counter.value;
-            }
-            if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
-              lockedStats->runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(
-                  lockedStats->runtimeStats.at(name).unit, counter.unit);
-            }
-            lockedStats->runtimeStats.at(name).addValue(counter.value);
-          }
+          recordDataSourceStats();
+          dataSource_.reset();
         }
         return nullptr;
       }
 
       const auto& connectorSplit = split.connectorSplit;
-      needNewSplit_ = false;
 
       VELOX_CHECK_EQ(
           connector_->connectorId(),
           connectorSplit->connectorId,
           "Got splits with different connector IDs");
 
+      if (startCachedSplit(*connectorSplit)) {
+        endSplit();
+        // Lets the Driver produce the cached results of the split.
+        return nullptr;
+      }
+      needNewSplit_ = false;
+
       if (!dataSource_) {
         connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-            connectorSplit->connectorId, planNodeId(), connectorPool_);
+            connectorSplit->connectorId, planNodeId(), connectorPool_.get());
         dataSource_ = connector_->createDataSource(
             outputType_,
             tableHandle_,
@@ -161,7 +184,13 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
-    auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
+    adaptBatchSize();
+    auto batchSize = readBatchSize_;
+    if (remainingRowLimit_.has_value()) {
+      batchSize = std::max<int64_t>(
+          1, std::min<int64_t>(batchSize, remainingRowLimit_.value()));
+    }
+    auto dataOptional = dataSource_->next(batchSize, blockingFuture_);
     checkPreload();
 
     {
@@ -183,29 +212,108 @@ RowVectorPtr TableScan::getOutput() {
       if (data) {
         if (data->size() > 0) {
           lockedStats->addInputVector(data->estimateFlatSize(), data->size());
+          if (remainingRowLimit_.has_value()) {
+            remainingRowLimit_ = remainingRowLimit_.value() - data->size();
+          }
+          if (adaptiveBatchSize_) {
+            lastBatch_ = data;
+          }
           return data;
         }
         continue;
       }
     }
 
-    {
-      auto lockedStats = stats_.wlock();
-      if (numPreloadedSplits_ > 0) {
-        lockedStats->addRuntimeStat(
-            "preloadedSplits", RuntimeCounter(numPreloadedSplits_));
-        numPreloadedSplits_ = 0;
-      }
-      if (numReadyPreloadedSplits_ > 0) {
-        lockedStats->addRuntimeStat(
-            "readyPreloadedSplits", RuntimeCounter(numReadyPreloadedSplits_));
-        numReadyPreloadedSplits_ = 0;
-      }
+    if (cachingSplit_) {
+      splitDataDone_ = true;
+      continue;
     }
+    endSplit();
+  }
+}
 
-    driverCtx_->task->splitFinished();
-    needNewSplit_ = true;
+void TableScan::adaptBatchSize() {
+  if (lastBatch_ == nullptr) {
+    return;
+  }
+  const auto lastRows = lastBatch_->size();
+  const auto rowSize = lastBatch_->estimateFlatSize() / lastRows;
+  lastBatch_.reset();
+  // Grows by at most 2x a batch, so that a run of small rows after large
+  // ones does not make a batch of maxOutputBatchRows large rows at once.
+  const auto batchSize = std::min<int64_t>(
+      outputBatchRows(rowSize), 2 * static_cast<int64_t>(lastRows));
+  if (batchSize < lastRows) {
+    stats_.wlock()->addRuntimeStat("batchSizeReductions", RuntimeCounter(1));
   }
+  readBatchSize_ = batchSize;
+}
+
+void TableScan::close() {
+  Operator::close();
+  lastBatch_.reset();
+  if (dataSource_) {
+    recordDataSourceStats();
+    dataSource_.reset();
+  }
+}
+
+void TableScan::recordDataSourceStats() {
+  auto connectorStats = dataSource_->runtimeStats();
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] : connectorStats) {
+    if (name == "ioWaitNanos") {
+      ioWaitNanos_ += counter.value - lastIoWaitNanos_;
+      lastIoWaitNanos_ = counter.value;
+    }
+    if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
+      lockedStats->runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit)));
+    } else {
+      VELOX_CHECK_EQ(lockedStats->runtimeStats.at(name).unit, counter.unit);
+    }
+    lockedStats->runtimeStats.at(name).addValue(counter.value);
+  }
+}
+
+void TableScan::endSplit() {
+  {
+    auto lockedStats = stats_.wlock();
+    if (numPreloadedSplits_ > 0) {
+      lockedStats->addRuntimeStat(
+          "preloadedSplits", RuntimeCounter(numPreloadedSplits_));
+      numPreloadedSplits_ = 0;
+    }
+    if (numReadyPreloadedSplits_ > 0) {
+      lockedStats->addRuntimeStat(
+          "readyPreloadedSplits", RuntimeCounter(numReadyPreloadedSplits_));
+      numReadyPreloadedSplits_ = 0;
+    }
+    if (numMemoryLimitedPreloads_ > 0) {
+      lockedStats->addRuntimeStat(
+          "memoryLimitedPreloads", RuntimeCounter(numMemoryLimitedPreloads_));
+      numMemoryLimitedPreloads_ = 0;
+    }
+  }
+
+  driverCtx_->task->splitFinished();
+  needNewSplit_ = true;
+}
+
+bool TableScan::startCachedSplit(const connector::ConnectorSplit& split) {
+  cachingSplit_ = false;
+  if (cachingAggregation_ == nullptr || hasDynamicFilters_) {
+    return false;
+  }
+  const auto key = split.cacheKey();
+  if (!key.has_value()) {
+    return false;
+  }
+  if (cachingAggregation_->startSplit(key.value())) {
+    return true;
+  }
+  cachingSplit_ = true;
+  return false;
 }
 
 void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
@@ -221,7 +329,7 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
        columns = columnHandles_,
        connector = connector_,
        ctx = operatorCtx_->createConnectorQueryCtx(
-           split->connectorId, planNodeId(), connectorPool_),
+           split->connectorId, planNodeId(), connectorPool_.get()),
        task = operatorCtx_->task(),
        split]() -> std::unique_ptr<DataSourcePtr> {
         if (task->isCancelled()) {
@@ -241,19 +349,37 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
           return nullptr;
         }
         (*ptr)->addSplit(split);
+        if (task->isCancelled()) {
+          return nullptr;
+        }
+        (*ptr)->prefetch();
         return ptr;
       });
 }
 
 void TableScan::checkPreload() {
   auto executor = connector_->executor();
-  if (FLAGS_split_preload_per_driver == 0 || !executor ||
+  const auto& queryConfig = driverCtx_->queryConfig();
+  const auto preloadPerDriver = queryConfig.maxSplitPreloadPerDriver().value_or(
+      FLAGS_split_preload_per_driver);
+  if (preloadPerDriver <= 0 || !executor ||
       !connector_->supportsSplitPreload()) {
     return;
   }
   if (dataSource_->allPrefetchIssued()) {
-    maxPreloadedSplits_ = driverCtx_->task->numDrivers(driverCtx_->driver) *
-        FLAGS_split_preload_per_driver;
+    // The preloaded splits hold their footers and first stripes in memory
+    // until read. Starts no new preloads while the query is short of memory.
+    auto* queryPool = operatorCtx_->task()->queryCtx()->pool();
+    const auto capacity = queryPool->capacity();
+    if (capacity != memory::kMaxMemory &&
+        queryPool->getCurrentBytes() * 100 >
+            capacity * queryConfig.splitPreloadMaxMemoryPct()) {
+      maxPreloadedSplits_ = 0;
+      ++numMemoryLimitedPreloads_;
+      return;
+    }
+    maxPreloadedSplits_ =
+        driverCtx_->task->numDrivers(driverCtx_->driver) * preloadPerDriver;
     if (!splitPreloader_) {
       splitPreloader_ =
           [executor, this](std::shared_ptr<connector::ConnectorSplit> split) {
@@ -271,11 +397,31 @@ bool TableScan::isFinished() {
 void TableScan::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
+  hasDynamicFilters_ = true;
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
   } else {
-    pendingDynamicFilters_.emplace(outputChannel, filter);
+    pendingDynamicFilters_.emplace_back(outputChannel, filter);
+  }
+}
+
+void TableScan::addImportedDynamicFilters() {
+  const auto numImported = driverCtx_->task->numImportedDynamicFilters();
+  if (numImported == lastNumImportedDynamicFilters_) {
+    return;
+  }
+  lastNumImportedDynamicFilters_ = numImported;
+  const auto filters = driverCtx_->task->importedDynamicFilters(
+      planNodeId(), numImportedDynamicFilters_);
+  if (filters.empty()) {
+    return;
+  }
+  for (const auto& [channel, filter] : filters) {
+    addDynamicFilter(channel, filter);
   }
+  numImportedDynamicFilters_ += filters.size();
+  stats_.wlock()->addRuntimeStat(
+      "importedDynamicFilters", RuntimeCounter(filters.size()));
 }
 
 } // namespace facebook::velox::exec
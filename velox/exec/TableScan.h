@@ -22,6 +22,8 @@ DECLARE_int32(split_preload_per_driver);
 
 namespace facebook::velox::exec {
 
+class HashAggregation;
+
 class TableScan : public SourceOperator {
  public:
   TableScan(
@@ -41,6 +43,11 @@ class TableScan : public SourceOperator {
 
   bool isFinished() override;
 
+  /// Destroys the DataSource so that a scan that stops before the end of its
+  /// splits, e.g. under a Limit, frees its reader and cancels its pending
+  /// reads at once instead of when the Task goes away.
+  void close() override;
+
   bool canAddDynamicFilter() const override {
     return connector_->canAddDynamicFilter();
   }
@@ -69,6 +76,26 @@ class TableScan : public SourceOperator {
   // needed before prepare is done, it will be made when needed.
   void preload(std::shared_ptr<connector::ConnectorSplit> split);
 
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'.
+  void recordDataSourceStats();
+
+  // Adds the filters imported into the Task for this scan since the last call.
+  void addImportedDynamicFilters();
+
+  // Records the stats of the current split and tells the Task that it is
+  // done.
+  void endSplit();
+
+  // Returns true if the results of 'split' for the plan fragment of
+  // 'cachingAggregation_' are cached. Otherwise has 'cachingAggregation_'
+  // record them if possible.
+  bool startCachedSplit(const connector::ConnectorSplit& split);
+
+  // Sets 'readBatchSize_' from the bytes per row of 'lastBatch_' if
+  // QueryConfig::kAdaptiveScanBatchSizeEnabled is set and releases
+  // 'lastBatch_'.
+  void adaptBatchSize();
+
   // Process-wide IO wait time.
   static std::atomic<uint64_t> ioWaitNanos_;
 
@@ -77,7 +104,9 @@ class TableScan : public SourceOperator {
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
           columnHandles_;
   DriverCtx* const driverCtx_;
-  memory::MemoryPool* const connectorPool_;
+  // Holds a reference as the Task releases the pools of grouped execution
+  // drivers when their split group finishes.
+  const std::shared_ptr<memory::MemoryPool> connectorPool_;
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
   BlockingReason blockingReason_;
   bool needNewSplit_ = true;
@@ -85,10 +114,39 @@ class TableScan : public SourceOperator {
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSource> dataSource_;
   bool noMoreSplits_ = false;
+  // True if dynamic filters have been added. The results of the splits are
+  // then not cached since they depend on the filters.
+  bool hasDynamicFilters_ = false;
+
+  // The aggregation that caches its results per split of 'this', nullptr if
+  // none. Set at the first getOutput() when the Driver is known.
+  HashAggregation* cachingAggregation_{nullptr};
+  bool cachingAggregationChecked_{false};
+
+  // The number of rows after which the Limit fed by 'this' is finished, less
+  // the rows produced so far. Caps the rows asked from 'dataSource_' at a
+  // time. std::nullopt if there is no such Limit. Set at the first
+  // getOutput() together with 'cachingAggregation_'.
+  std::optional<int64_t> remainingRowLimit_;
+  // True if the results of the current split are recorded by
+  // 'cachingAggregation_'.
+  bool cachingSplit_{false};
+  // True if the current split has no more data and its results are to be
+  // handed to 'cachingAggregation_' once the operators in between are
+  // drained.
+  bool splitDataDone_{false};
+
   // Dynamic filters to add to the data source when it gets created.
-  std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
       pendingDynamicFilters_;
 
+  // The value of Task::numImportedDynamicFilters() when last checked for
+  // filters imported from other tasks.
+  uint64_t lastNumImportedDynamicFilters_{0};
+
+  // Number of filters imported from other tasks added to this so far.
+  size_t numImportedDynamicFilters_{0};
+
   int32_t maxPreloadedSplits_{0};
 
   // Callback passed to getSplitOrFuture() for triggering async
@@ -105,8 +163,20 @@ class TableScan : public SourceOperator {
   // Count of splits that finished preloading before being read.
   int32_t numReadyPreloadedSplits_{0};
 
+  // Count of checkPreload() calls that started no preloads because the query
+  // used too much memory.
+  int32_t numMemoryLimitedPreloads_{0};
+
   int32_t readBatchSize_;
 
+  const bool adaptiveBatchSize_;
+
+  // The last batch returned if 'adaptiveBatchSize_' is set. Measured at the
+  // next getOutput(), after the operators downstream have loaded its lazy
+  // columns, and released before reading the next batch so that the data
+  // source can reuse its vectors.
+  RowVectorPtr lastBatch_;
+
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
 
@@ -31,19 +31,29 @@ TableWriter::TableWriter(
           tableWriteNode->id(),
           "TableWrite"),
       driverCtx_(driverCtx),
-      connectorPool_(driverCtx_->task->addConnectorPoolLocked(
-          planNodeId(),
-          driverCtx_->pipelineId,
-          driverCtx_->driverId,
-          operatorType(),
-          tableWriteNode->insertTableHandle()->connectorId())),
+      connectorPool_(driverCtx_->task
+                         ->addConnectorPoolLocked(
+                             planNodeId(),
+                             driverCtx_->pipelineId,
+                             driverCtx_->driverId,
+                             driverCtx_->splitGroupId,
+                             operatorType(),
+                             tableWriteNode->insertTableHandle()->connectorId())
+                         ->shared_from_this()),
       insertTableHandle_(
           tableWriteNode->insertTableHandle()->connectorInsertTableHandle()),
-      commitStrategy_(tableWriteNode->commitStrategy()) {
+      commitStrategy_(tableWriteNode->commitStrategy()),
+      spillConfig_(
+          tableWriteNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy)
+              : std::nullopt) {
   const auto& connectorId = tableWriteNode->insertTableHandle()->connectorId();
   connector_ = connector::getConnector(connectorId);
   connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-      connectorId, planNodeId(), connectorPool_);
+      connectorId,
+      planNodeId(),
+      connectorPool_.get(),
+      spillConfig_.has_value() ? &spillConfig_.value() : nullptr);
 
   auto names = tableWriteNode->columnNames();
   auto types = tableWriteNode->columns()->children();
@@ -67,6 +77,17 @@ void TableWriter::createDataSink() {
       commitStrategy_);
 }
 
+void TableWriter::updateSinkStats() {
+  const auto sinkStats = dataSink_->runtimeStats();
+  if (sinkStats.empty()) {
+    return;
+  }
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] : sinkStats) {
+    lockedStats->addRuntimeStat(name, counter);
+  }
+}
+
 void TableWriter::addInput(RowVectorPtr input) {
   if (input->size() == 0) {
     return;
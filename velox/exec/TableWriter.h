@@ -50,6 +50,7 @@ class TableWriter : public Operator {
     if (!closed_) {
       if (dataSink_) {
         dataSink_->close();
+        updateSinkStats();
       }
       closed_ = true;
     }
@@ -64,11 +65,19 @@ class TableWriter : public Operator {
  private:
   void createDataSink();
 
+  // Adds the runtime stats of 'dataSink_' to the operator stats.
+  void updateSinkStats();
+
   const DriverCtx* const driverCtx_;
-  memory::MemoryPool* const connectorPool_;
+  // Holds a reference as the Task releases the pools of grouped execution
+  // drivers when their split group finishes.
+  const std::shared_ptr<memory::MemoryPool> connectorPool_;
   const std::shared_ptr<connector::ConnectorInsertTableHandle>
       insertTableHandle_;
   const connector::CommitStrategy commitStrategy_;
+  // Spill config for the data sink if spilling is enabled, otherwise null.
+  // The data sink spills with it when sorting the written rows.
+  const std::optional<Spiller::Config> spillConfig_;
   std::shared_ptr<connector::Connector> connector_;
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSink> dataSink_;
@@ -18,6 +18,8 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <string>
 
+#include <folly/ScopeGuard.h>
+
 #include "velox/codegen/Codegen.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
@@ -185,7 +187,8 @@ Task::Task(
       destination_(destination),
       queryCtx_(std::move(queryCtx)),
       pool_(queryCtx_->pool()->addAggregateChild(
-          fmt::format("task.{}", taskId_.c_str()))),
+          fmt::format("task.{}", taskId_.c_str()),
+          MemoryReclaimer::create())),
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
       splitsStates_(buildSplitStates(planFragment_.planNode)),
@@ -245,12 +248,20 @@ bool Task::allNodesReceivedNoMoreSplitsMessageLocked() const {
 }
 
 void Task::removeSpillDirectoryIfExists() {
-  if (!spillDirectory_.empty()) {
+  if (spillDirectory_.empty()) {
+    return;
+  }
+  std::vector<std::string> directories{spillDirectory_};
+  directories.insert(
+      directories.end(),
+      spillStripeDirectories_.begin(),
+      spillStripeDirectories_.end());
+  for (const auto& directory : directories) {
     try {
-      auto fs = filesystems::getFileSystem(spillDirectory_, nullptr);
-      fs->rmdir(spillDirectory_);
+      auto fs = filesystems::getFileSystem(directory, nullptr);
+      fs->rmdir(directory);
     } catch (const std::exception& e) {
-      LOG(ERROR) << "Failed to remove spill directory '" << spillDirectory_
+      LOG(ERROR) << "Failed to remove spill directory '" << directory
                  << "' for Task " << taskId() << ": " << e.what();
     }
   }
@@ -262,39 +273,59 @@ Task::getOrAddNodePool(const core::PlanNodeId& planNodeId) {
     return nodePools_[planNodeId];
   }
 
-  childPools_.push_back(
-      pool_->addAggregateChild(fmt::format("node.{}", planNodeId)));
+  childPools_.push_back(pool_->addAggregateChild(
+      fmt::format("node.{}", planNodeId), memory::MemoryReclaimer::create()));
   auto* nodePool = childPools_.back().get();
   nodePools_[planNodeId] = nodePool;
   return nodePool;
 }
 
+memory::MemoryPool* Task::addChildPoolLocked(
+    std::shared_ptr<memory::MemoryPool> pool,
+    uint32_t splitGroupId) {
+  auto* rawPool = pool.get();
+  if (splitGroupId == kUngroupedGroupId) {
+    childPools_.push_back(std::move(pool));
+  } else {
+    splitGroupStates_[splitGroupId].pools.push_back(std::move(pool));
+  }
+  return rawPool;
+}
+
 velox::memory::MemoryPool* Task::addOperatorPool(
     const core::PlanNodeId& planNodeId,
     int pipelineId,
     uint32_t driverId,
-    const std::string& operatorType) {
+    uint32_t splitGroupId,
+    const std::string& operatorType,
+    std::shared_ptr<memory::MemoryReclaimer> reclaimer) {
   auto* nodePool = getOrAddNodePool(planNodeId);
-  childPools_.push_back(nodePool->addLeafChild(fmt::format(
-      "op.{}.{}.{}.{}", planNodeId, pipelineId, driverId, operatorType)));
-  return childPools_.back().get();
+  return addChildPoolLocked(
+      nodePool->addLeafChild(
+          fmt::format(
+              "op.{}.{}.{}.{}", planNodeId, pipelineId, driverId, operatorType),
+          true,
+          std::move(reclaimer)),
+      splitGroupId);
 }
 
 velox::memory::MemoryPool* Task::addConnectorPoolLocked(
     const core::PlanNodeId& planNodeId,
     int pipelineId,
     uint32_t driverId,
+    uint32_t splitGroupId,
     const std::string& operatorType,
     const std::string& connectorId) {
   auto* nodePool = getOrAddNodePool(planNodeId);
-  childPools_.push_back(nodePool->addAggregateChild(fmt::format(
-      "op.{}.{}.{}.{}.{}",
-      planNodeId,
-      pipelineId,
-      driverId,
-      operatorType,
-      connectorId)));
-  return childPools_.back().get();
+  return addChildPoolLocked(
+      nodePool->addAggregateChild(fmt::format(
+          "op.{}.{}.{}.{}.{}",
+          planNodeId,
+          pipelineId,
+          driverId,
+          operatorType,
+          connectorId)),
+      splitGroupId);
 }
 
 velox::memory::MemoryPool* Task::addMergeSourcePool(
@@ -324,7 +355,8 @@ bool Task::supportsSingleThreadedExecution() const {
     return false;
   }
 
-  LocalPlanner::plan(planFragment_, nullptr, &driverFactories, 1);
+  LocalPlanner::plan(
+      planFragment_, nullptr, &driverFactories, queryCtx_->queryConfig(), 1);
 
   for (const auto& factory : driverFactories) {
     if (!factory->supportsSingleThreadedExecution()) {
@@ -361,7 +393,8 @@ RowVectorPtr Task::next(ContinueFuture* future) {
         "Single-threaded execution doesn't support delivering results to a "
         "callback");
 
-    LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, 1);
+    LocalPlanner::plan(
+        planFragment_, nullptr, &driverFactories_, queryCtx_->queryConfig(), 1);
     exchangeClients_.resize(driverFactories_.size());
 
     // In Task::next() we always assume ungrouped execution.
@@ -457,6 +490,11 @@ void Task::start(
       1,
       "concurrentSplitGroups parameter must be greater then or equal to 1");
 
+  if (auto* reclaimer =
+          dynamic_cast<MemoryReclaimer*>(self->pool_->reclaimer())) {
+    reclaimer->setTask(self);
+  }
+
   uint32_t numPipelines;
   {
     std::unique_lock<std::mutex> l(self->mutex_);
@@ -485,6 +523,7 @@ void Task::start(
         self->planFragment_,
         self->consumerSupplier(),
         &self->driverFactories_,
+        self->queryCtx_->queryConfig(),
         maxDrivers);
 
     // Keep one exchange client per pipeline (NULL if not used).
@@ -639,7 +678,12 @@ void Task::resume(std::shared_ptr<Task> self) {
         // enqueued twice.
         continue;
       }
-      VELOX_CHECK(!driver->isOnThread() && !driver->isTerminated());
+      if (driver->isOnThread()) {
+        // A Driver which has not gone off thread for a pause that timed out
+        // sees the cleared pause request on its next check.
+        continue;
+      }
+      VELOX_CHECK(!driver->isTerminated());
       if (!driver->state().hasBlockingFuture) {
         // Do not continue a Driver that is blocked on external
         // event. The Driver gets enqueued by the promise realization.
@@ -813,7 +857,7 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
         if (splitGroupId != kUngroupedGroupId) {
           --self->numRunningSplitGroups_;
           self->taskStats_.completedSplitGroups.emplace(splitGroupId);
-          splitGroupState.clear();
+          self->releaseSplitGroupLocked(splitGroupId);
           self->ensureSplitGroupsAreBeingProcessedLocked(self);
         } else {
           splitGroupState.clear();
@@ -840,6 +884,29 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
   }
 }
 
+void Task::releaseSplitGroupLocked(uint32_t splitGroupId) {
+  VELOX_CHECK_NE(splitGroupId, kUngroupedGroupId);
+  auto it = splitGroupStates_.find(splitGroupId);
+  VELOX_CHECK(it != splitGroupStates_.end());
+  auto& splitGroupState = it->second;
+  VELOX_CHECK_EQ(splitGroupState.numRunningDrivers, 0);
+  VELOX_CHECK(!splitGroupState.mixedExecutionMode);
+  for (auto& pool : splitGroupState.pools) {
+    // The task keeps the pools that still have memory allocated, e.g. for
+    // vectors passed to an ungrouped pipeline through a local exchange. The
+    // operators hold references to their own pools.
+    if (pool->getCurrentBytes() != 0) {
+      childPools_.push_back(std::move(pool));
+    }
+  }
+  splitGroupStates_.erase(it);
+
+  std::lock_guard<std::mutex> splitsLock(splitsMutex_);
+  for (auto& [planNodeId, splitsState] : splitsStates_) {
+    splitsState.groupSplitsStores.erase(splitGroupId);
+  }
+}
+
 void Task::ensureSplitGroupsAreBeingProcessedLocked(
     std::shared_ptr<Task>& self) {
   // Only try creating more drivers if we are running.
@@ -878,7 +945,7 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
 void Task::setMaxSplitSequenceId(
     const core::PlanNodeId& planNodeId,
     long maxSequenceId) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<std::mutex> l(splitsMutex_);
   if (isRunningLocked()) {
     auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
     // We could have been sent an old split again, so only change max id, when
@@ -896,7 +963,13 @@ bool Task::addSplitWithSequence(
   bool added = false;
   bool isTaskRunning;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    // Ungrouped splits are added under 'splitsMutex_' only. The first split
+    // of a split group may start its Drivers, which needs 'mutex_'.
+    std::unique_lock<std::mutex> taskLock(mutex_, std::defer_lock);
+    if (split.hasGroup()) {
+      taskLock.lock();
+    }
+    std::lock_guard<std::mutex> l(splitsMutex_);
     isTaskRunning = isRunningLocked();
     if (isTaskRunning) {
       // The same split can be added again in some systems. The systems that
@@ -925,7 +998,11 @@ void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
   bool isTaskRunning;
   std::unique_ptr<ContinuePromise> promise;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::unique_lock<std::mutex> taskLock(mutex_, std::defer_lock);
+    if (split.hasGroup()) {
+      taskLock.lock();
+    }
+    std::lock_guard<std::mutex> l(splitsMutex_);
     isTaskRunning = isRunningLocked();
     if (isTaskRunning) {
       promise = addSplitLocked(
@@ -1008,6 +1085,7 @@ void Task::noMoreSplitsForGroup(
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<std::mutex> splitsLock(splitsMutex_);
 
     auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
     auto& splitsStore = splitsState.groupSplitsStores[splitGroupId];
@@ -1031,6 +1109,7 @@ void Task::noMoreSplits(const core::PlanNodeId& planNodeId) {
   std::shared_ptr<ExchangeClient> exchangeClient;
   {
     std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<std::mutex> splitsLock(splitsMutex_);
 
     // Global 'no more splits' for a plan node comes in case of ungrouped
     // execution when no more splits will arrive. For grouped execution it
@@ -1106,13 +1185,67 @@ BlockingReason Task::getSplitOrFuture(
     ContinueFuture& future,
     int32_t maxPreloadSplits,
     std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<std::mutex> l(splitsMutex_);
+  auto& splitsStore =
+      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId];
+  divideSplitsLocked(planNodeId, splitsStore);
   return getSplitOrFutureLocked(
-      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
-      split,
-      future,
-      maxPreloadSplits,
-      preload);
+      splitsStore, split, future, maxPreloadSplits, preload);
+}
+
+void Task::divideSplitsLocked(
+    const core::PlanNodeId& planNodeId,
+    SplitsStore& splitsStore) {
+  // Only the splits left at the end of the scan are divided, so that the
+  // drivers that run out of splits get parts of the large ones instead of
+  // waiting for the drivers that run these.
+  if (!splitsStore.noMoreSplits || splitsStore.splits.empty()) {
+    return;
+  }
+  uint32_t numDrivers = 0;
+  for (const auto& factory : driverFactories_) {
+    if (factory->leafNodeId() == planNodeId) {
+      numDrivers = factory->numDrivers;
+      break;
+    }
+  }
+  if (splitsStore.splits.size() >= numDrivers) {
+    return;
+  }
+  const auto minSize = queryCtx_->queryConfig().minDividedSplitBytes();
+  if (minSize == 0) {
+    return;
+  }
+  // Divides the largest split that is not preloading.
+  int32_t largest = -1;
+  uint64_t largestSize = 0;
+  for (auto i = 0; i < splitsStore.splits.size(); ++i) {
+    const auto& connectorSplit = splitsStore.splits[i].connectorSplit;
+    if (connectorSplit == nullptr || connectorSplit->dataSource != nullptr) {
+      continue;
+    }
+    if (connectorSplit->size() > largestSize) {
+      largest = i;
+      largestSize = connectorSplit->size();
+    }
+  }
+  if (largest < 0) {
+    return;
+  }
+  auto it = splitsStore.splits.begin() + largest;
+  auto parts = it->connectorSplit->divide(
+      numDrivers - splitsStore.splits.size() + 1, minSize);
+  if (parts.size() < 2) {
+    return;
+  }
+  const auto groupId = it->groupId;
+  it = splitsStore.splits.erase(it);
+  for (auto& part : parts) {
+    it = splitsStore.splits.emplace(it, std::move(part), groupId) + 1;
+  }
+  taskStats_.numTotalSplits += parts.size() - 1;
+  taskStats_.numQueuedSplits += parts.size() - 1;
+  ++taskStats_.numDividedSplits;
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1171,21 +1304,21 @@ exec::Split Task::getSplitLocked(
 }
 
 void Task::splitFinished() {
-  std::lock_guard<std::mutex> l(mutex_);
-  ++taskStats_.numFinishedSplits;
-  --taskStats_.numRunningSplits;
-  if (isAllSplitsFinishedLocked()) {
-    taskStats_.executionEndTimeMs = getCurrentTimeMs();
-  }
+  multipleSplitsFinished(1);
 }
 
 void Task::multipleSplitsFinished(int32_t numSplits) {
-  std::lock_guard<std::mutex> l(mutex_);
-  taskStats_.numFinishedSplits += numSplits;
-  taskStats_.numRunningSplits -= numSplits;
-  if (isAllSplitsFinishedLocked()) {
-    taskStats_.executionEndTimeMs = getCurrentTimeMs();
+  {
+    std::lock_guard<std::mutex> l(splitsMutex_);
+    taskStats_.numFinishedSplits += numSplits;
+    taskStats_.numRunningSplits -= numSplits;
+    if (!isAllSplitsFinishedLocked()) {
+      return;
+    }
   }
+  // 'executionEndTimeMs' is also set by terminate() under 'mutex_'.
+  std::lock_guard<std::mutex> l(mutex_);
+  taskStats_.executionEndTimeMs = getCurrentTimeMs();
 }
 
 bool Task::isGroupedExecution() const {
@@ -1390,6 +1523,59 @@ std::shared_ptr<HashJoinBridge> Task::getHashJoinBridgeLocked(
   return getJoinBridgeInternalLocked<HashJoinBridge>(splitGroupId, planNodeId);
 }
 
+std::optional<folly::dynamic> Task::exportDynamicFilters(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  return getHashJoinBridge(splitGroupId, planNodeId)->exportDynamicFilters();
+}
+
+void Task::importDynamicFilters(
+    const core::PlanNodeId& planNodeId,
+    const folly::dynamic& filters) {
+  const auto* tableScanNode = dynamic_cast<const core::TableScanNode*>(
+      core::PlanNode::findFirstNode(
+          planFragment_.planNode.get(), [&](const core::PlanNode* node) {
+            return node->id() == planNodeId;
+          }));
+  VELOX_USER_CHECK_NOT_NULL(
+      tableScanNode,
+      "Dynamic filters can only be imported into a TableScan: {}",
+      planNodeId);
+  VELOX_USER_CHECK(
+      connector::getConnector(tableScanNode->tableHandle()->connectorId())
+          ->canAddDynamicFilter(),
+      "The connector of TableScan {} does not accept dynamic filters",
+      planNodeId);
+
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+      newFilters;
+  for (const auto& [name, filter] : filters.items()) {
+    const auto channel =
+        tableScanNode->outputType()->getChildIdx(name.asString());
+    newFilters.emplace_back(channel, common::Filter::create(filter));
+  }
+
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& scanFilters = importedDynamicFilters_[planNodeId];
+  for (auto& filter : newFilters) {
+    scanFilters.push_back(std::move(filter));
+  }
+  numImportedDynamicFilters_ += newFilters.size();
+}
+
+std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+Task::importedDynamicFilters(
+    const core::PlanNodeId& planNodeId,
+    size_t startIndex) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = importedDynamicFilters_.find(planNodeId);
+  if (it == importedDynamicFilters_.end() ||
+      startIndex >= it->second.size()) {
+    return {};
+  }
+  return {it->second.begin() + startIndex, it->second.end()};
+}
+
 std::shared_ptr<CrossJoinBridge> Task::getCrossJoinBridge(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId) {
@@ -1470,7 +1656,10 @@ ContinueFuture Task::terminate(TaskState terminalState) {
     if (not isRunningLocked()) {
       return makeFinishFutureLocked("Task::terminate");
     }
-    state_ = terminalState;
+    {
+      std::lock_guard<std::mutex> splitsLock(splitsMutex_);
+      state_ = terminalState;
+    }
     if (state_ == TaskState::kCanceled || state_ == TaskState::kAborted) {
       try {
         VELOX_FAIL(
@@ -1545,6 +1734,7 @@ ContinueFuture Task::terminate(TaskState terminalState) {
           remainingRemoteSplits;
   {
     std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<std::mutex> splitsLock(splitsMutex_);
     // Collect all the join bridges to clear them.
     for (auto& splitGroupState : splitGroupStates_) {
       for (auto& pair : splitGroupState.second.bridges) {
@@ -1630,12 +1820,23 @@ void Task::addOperatorStats(OperatorStats& stats) {
       .add(stats);
 }
 
+void Task::addDriverStats(int pipelineId, DriverStats stats) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      pipelineId >= 0 && pipelineId < taskStats_.pipelineStats.size());
+  taskStats_.pipelineStats[pipelineId].addDriverStats(std::move(stats));
+}
+
 TaskStats Task::taskStats() const {
   std::lock_guard<std::mutex> l(mutex_);
 
   // 'taskStats_' contains task stats plus stats for the completed drivers
   // (their operators).
-  TaskStats taskStats = taskStats_;
+  TaskStats taskStats;
+  {
+    std::lock_guard<std::mutex> splitsLock(splitsMutex_);
+    taskStats = taskStats_;
+  }
 
   taskStats.numTotalDrivers = drivers_.size();
 
@@ -1647,6 +1848,8 @@ TaskStats Task::taskStats() const {
       continue;
     }
 
+    taskStats.pipelineStats[driver->driverCtx()->pipelineId].addDriverStats(
+        driver->stats());
     for (auto& op : driver->operators()) {
       auto statsCopy = op->stats(false);
       aggregateOperatorRuntimeStats(statsCopy.runtimeStats);
@@ -1690,6 +1893,7 @@ void Task::onTaskCompletion() {
     std::exception_ptr exception;
     {
       std::lock_guard<std::mutex> l(mutex_);
+      std::lock_guard<std::mutex> splitsLock(splitsMutex_);
       stats = taskStats_;
       state = state_;
       exception = exception_;
@@ -2045,6 +2249,55 @@ ContinueFuture Task::requestPause() {
   return makeFinishFutureLocked("Task::requestPause");
 }
 
+bool Task::isOnDriverThread() const {
+  const auto threadId = std::this_thread::get_id();
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& driver : drivers_) {
+    if (driver != nullptr && driver->state().thread == threadId &&
+        !driver->state().isSuspended) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<Task::MemoryReclaimer> Task::MemoryReclaimer::create() {
+  return std::shared_ptr<MemoryReclaimer>(new MemoryReclaimer());
+}
+
+void Task::MemoryReclaimer::setTask(const std::shared_ptr<Task>& task) {
+  std::lock_guard<std::mutex> l(mutex_);
+  task_ = task;
+}
+
+uint64_t Task::MemoryReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  std::shared_ptr<Task> task;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    task = task_.lock();
+  }
+  if (task == nullptr || !task->isRunning() || task->isOnDriverThread()) {
+    return 0;
+  }
+  auto pauseFuture = task->requestPause().wait(kMaxPauseWait);
+  SCOPE_EXIT {
+    try {
+      Task::resume(task);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to resume Task " << task->taskId()
+                   << " after memory reclaim: " << e.what();
+    }
+  };
+  if (!pauseFuture.isReady()) {
+    LOG(WARNING) << "Task " << task->taskId() << " didn't pause in "
+                 << kMaxPauseWait.count() << "ms for memory reclaim";
+    return 0;
+  }
+  return memory::MemoryReclaimer::reclaim(pool, targetBytes);
+}
+
 Task::TaskCompletionNotifier::~TaskCompletionNotifier() {
   notify();
 }
@@ -2090,6 +2343,12 @@ void Task::createExchangeClient(
       addExchangeClientPool(planNodeId, pipelineId),
       queryCtx()->queryConfig().maxPartitionedOutputBufferSize() / 2);
   exchangeClientByPlanNode_.emplace(planNodeId, exchangeClients_[pipelineId]);
+  const auto& factory = driverFactories_[pipelineId];
+  if (queryCtx()->queryConfig().adaptiveExchangeConsumersEnabled() &&
+      !factory->groupedExecution && factory->numDrivers > 1) {
+    exchangeClients_[pipelineId]->queue()->setMaxActiveConsumers(
+        factory->numDrivers);
+  }
 }
 
 std::shared_ptr<ExchangeClient> Task::getExchangeClientLocked(
@@ -2273,6 +2532,30 @@ std::shared_ptr<SpillOperatorGroup> Task::getSpillOperatorGroupLocked(
   return group;
 }
 
+std::shared_ptr<SharedPartialAggregation>
+Task::getSharedPartialAggregationLocked(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  auto& aggregations =
+      splitGroupStates_[splitGroupId].sharedPartialAggregations;
+  auto& aggregation = aggregations[planNodeId];
+  if (aggregation == nullptr) {
+    aggregation = std::make_shared<SharedPartialAggregation>();
+  }
+  return aggregation;
+}
+
+std::shared_ptr<SpillPartitionQueue> Task::getSpillPartitionQueueLocked(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  auto& queue =
+      splitGroupStates_[splitGroupId].spillPartitionQueues[planNodeId];
+  if (queue == nullptr) {
+    queue = std::make_shared<SpillPartitionQueue>();
+  }
+  return queue;
+}
+
 std::string Task::getErrorMsgOnMemCapExceeded(
     memory::MemoryUsageTracker& /*tracker*/) {
   return getQueryMemoryUsageString(queryCtx()->pool());
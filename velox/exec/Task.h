@@ -72,6 +72,13 @@ class Task : public std::enable_shared_from_this<Task> {
     spillDirectory_ = spillDirectory;
   }
 
+  /// Specify directories, typically on other spill devices, over which the
+  /// spill partitions are striped together with the spill directory. These
+  /// are removed together with the spill directory.
+  void setSpillStripeDirectories(std::vector<std::string> directories) {
+    spillStripeDirectories_ = std::move(directories);
+  }
+
   std::string toString() const;
 
   /// Returns universally unique identifier of the task.
@@ -92,6 +99,11 @@ class Task : public std::enable_shared_from_this<Task> {
   // in debugging messages and listings.
   static std::string shortId(const std::string& id);
 
+  /// Returns the plan fragment specified in the constructor.
+  const core::PlanFragment& planFragment() const {
+    return planFragment_;
+  }
+
   /// Returns QueryCtx specified in the constructor.
   const std::shared_ptr<core::QueryCtx>& queryCtx() const {
     return queryCtx_;
@@ -277,20 +289,28 @@ class Task : public std::enable_shared_from_this<Task> {
 
   /// Creates new instance of MemoryPool for an operator, stores it in the task
   /// to ensure lifetime and returns a raw pointer. Not thread safe, e.g. must
-  /// be called from the Operator's constructor.
+  /// be called from the Operator's constructor. 'reclaimer' is the memory
+  /// reclaimer of the operator pool, if any. The pool of a grouped execution
+  /// driver is released when its split group finishes, so the caller must
+  /// hold a reference to it for as long as it uses it.
   velox::memory::MemoryPool* FOLLY_NONNULL addOperatorPool(
       const core::PlanNodeId& planNodeId,
       int pipelineId,
       uint32_t driverId,
-      const std::string& operatorType);
+      uint32_t splitGroupId,
+      const std::string& operatorType,
+      std::shared_ptr<memory::MemoryReclaimer> reclaimer = nullptr);
 
   /// Creates new instance of MemoryPool with aggregate kind for the connector
   /// use, stores it in the task to ensure lifetime and returns a raw pointer.
   /// Not thread safe, e.g. must be called from the Operator's constructor.
+  /// Like operator pools, the pool of a grouped execution driver is released
+  /// when its split group finishes.
   velox::memory::MemoryPool* addConnectorPoolLocked(
       const core::PlanNodeId& planNodeId,
       int pipelineId,
       uint32_t driverId,
+      uint32_t splitGroupId,
       const std::string& operatorType,
       const std::string& connectorId);
 
@@ -317,7 +337,9 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that will complete when split becomes available or no-more-splits
   /// signal is received. If 'maxPreloadSplits' is given, ensures that
   /// so many of splits at the head of the queue are preloading. If
-  /// they are not, calls preload on them to start preload.
+  /// they are not, calls preload on them to start preload. Takes only
+  /// 'splitsMutex_', so that Drivers fetching splits don't contend with the
+  /// other users of the Task mutex.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -429,10 +451,54 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the filters on the join keys of the hash join 'planNodeId' for
+  /// other tasks to import, see HashJoinBridge::exportDynamicFilters(). A
+  /// coordinator can combine the filters of several tasks and deliver them to
+  /// table scans in other tasks with importDynamicFilters(). Returns
+  /// std::nullopt if the build side has not finished yet.
+  std::optional<folly::dynamic> exportDynamicFilters(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
+  /// Adds filters made by other tasks to the TableScan 'planNodeId'. 'filters'
+  /// is an object mapping output column names of the scan to filters
+  /// serialized with common::Filter::serialize(). All the drivers of the scan
+  /// apply the filters before reading their next batch. A filter is combined
+  /// with AND with the filters already on the same column.
+  void importDynamicFilters(
+      const core::PlanNodeId& planNodeId,
+      const folly::dynamic& filters);
+
+  /// Returns the total number of filters imported so far for all the table
+  /// scans. Used by TableScan to cheaply check for new filters.
+  uint64_t numImportedDynamicFilters() const {
+    return numImportedDynamicFilters_;
+  }
+
+  /// Returns the filters imported for the TableScan 'planNodeId' starting at
+  /// 'startIndex', as pairs of output channel and filter.
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+  importedDynamicFilters(
+      const core::PlanNodeId& planNodeId,
+      size_t startIndex) const;
+
   std::shared_ptr<SpillOperatorGroup> getSpillOperatorGroupLocked(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the hash tables shared by the drivers of the partial aggregation
+  /// 'planNodeId' in 'splitGroupId'. Creates them for the first driver.
+  std::shared_ptr<SharedPartialAggregation> getSharedPartialAggregationLocked(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
+  /// Returns the spilled partitions of the final aggregation 'planNodeId' in
+  /// 'splitGroupId' that are merged by any of its drivers. Creates them for
+  /// the first driver.
+  std::shared_ptr<SpillPartitionQueue> getSpillPartitionQueueLocked(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
   /// Transitions this to kFinished state if all Drivers are
   /// finished. Otherwise sets a flag so that the last Driver to finish
   /// will transition the state.
@@ -442,6 +508,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// stats. Called from Drivers upon their closure.
   void addOperatorStats(OperatorStats& stats);
 
+  /// Adds the queued, running and blocked time of a finished Driver of
+  /// 'pipelineId' to the pipeline stats.
+  void addDriverStats(int pipelineId, DriverStats stats);
+
   /// Returns kNone if no pause or terminate is requested. The thread count is
   /// incremented if kNone is returned. If something else is returned the
   /// calling thread should unwind and return itself to its pool. If 'this' goes
@@ -547,6 +617,10 @@ class Task : public std::enable_shared_from_this<Task> {
     return spillDirectory_;
   }
 
+  const std::vector<std::string>& spillStripeDirectories() const {
+    return spillStripeDirectories_;
+  }
+
   /// True if produces output via PartitionedOutputBufferManager.
   bool hasPartitionedOutput() const {
     return numDriversInPartitionedOutput_ > 0;
@@ -567,13 +641,14 @@ class Task : public std::enable_shared_from_this<Task> {
 
   // Returns reference to the SplitsState structure for the specified plan node
   // id. Throws if not found, meaning that plan node does not expect splits.
+  // Call under 'splitsMutex_'.
   SplitsState& getPlanNodeSplitsStateLocked(const core::PlanNodeId& planNodeId);
 
   // Validate that the supplied grouped execution leaf nodes make sense.
   void validateGroupedExecutionLeafNodes();
 
   // Returns true if all nodes expecting splits have received 'no more splits'
-  // message.
+  // message. Call under 'splitsMutex_'.
   bool allNodesReceivedNoMoreSplitsMessageLocked() const;
 
   // Remove the spill directory, if the Task was creating it for potential
@@ -612,7 +687,8 @@ class Task : public std::enable_shared_from_this<Task> {
     ++numDeletedTasks_;
   }
 
-  /// Returns true if state is 'running'.
+  /// Returns true if state is 'running'. Call under 'mutex_' or
+  /// 'splitsMutex_'.
   bool isRunningLocked() const;
 
   /// Returns true if state is 'finished'.
@@ -634,6 +710,14 @@ class Task : public std::enable_shared_from_this<Task> {
       const core::PlanNodeId& planNodeId,
       const exec::Split& split);
 
+  /// Replaces the largest queued split of 'splitsStore' with smaller splits
+  /// if the queued splits are the last ones for 'planNodeId' and fewer than
+  /// its drivers. The split functions below ending in Locked are called
+  /// under 'splitsMutex_'.
+  void divideSplitsLocked(
+      const core::PlanNodeId& planNodeId,
+      SplitsStore& splitsStore);
+
   /// Retrieve a split or split future from the given split store structure.
   BlockingReason getSplitOrFutureLocked(
       SplitsStore& splitsStore,
@@ -654,6 +738,18 @@ class Task : public std::enable_shared_from_this<Task> {
   /// structure, which stores inter-operator state (local exchange, bridges).
   void createSplitGroupStateLocked(uint32_t splitGroupId);
 
+  /// Releases the state of a finished grouped execution split group: its
+  /// join bridges, local exchanges, split stores and the memory pools of its
+  /// operators.
+  void releaseSplitGroupLocked(uint32_t splitGroupId);
+
+  /// Keeps 'pool' alive for the lifetime of the split group if
+  /// 'splitGroupId' is a grouped execution split group, otherwise for the
+  /// lifetime of the task. Returns the raw pointer of 'pool'.
+  memory::MemoryPool* addChildPoolLocked(
+      std::shared_ptr<memory::MemoryPool> pool,
+      uint32_t splitGroupId);
+
   /// Creates a bunch of drivers for the given split group.
   void createDriversLocked(
       std::shared_ptr<Task>& self,
@@ -689,6 +785,9 @@ class Task : public std::enable_shared_from_this<Task> {
   // splits coming for the task.
   bool isAllSplitsFinishedLocked();
 
+  // Adds 'split' to 'splitsState'. Call under 'splitsMutex_'. A split of a
+  // split group must be added under 'mutex_' as well, since the first split
+  // of a group may start Drivers for it.
   std::unique_ptr<ContinuePromise> addSplitLocked(
       SplitsState& splitsState,
       exec::Split&& split);
@@ -784,6 +883,34 @@ class Task : public std::enable_shared_from_this<Task> {
   /// Failed Operator: PartialAggregation.3: 11.98MB
   std::string getErrorMsgOnMemCapExceeded(memory::MemoryUsageTracker& tracker);
 
+  // The memory reclaimer of the Task memory pool. It pauses the Task to
+  // reclaim memory from the operators of the Task and resumes it afterwards.
+  // It is bound to the Task when the Task starts, so there is nothing to
+  // reclaim from a Task executed by Task::next().
+  class MemoryReclaimer : public memory::MemoryReclaimer {
+   public:
+    // The max time to wait for the Task to pause. A Driver thread which waits
+    // for memory outside of a suspended section can't go off thread until the
+    // memory arbitration which pauses its Task completes.
+    static constexpr std::chrono::milliseconds kMaxPauseWait{5'000};
+
+    static std::shared_ptr<MemoryReclaimer> create();
+
+    void setTask(const std::shared_ptr<Task>& task);
+
+    uint64_t reclaim(memory::MemoryPool* pool, uint64_t targetBytes) override;
+
+   private:
+    MemoryReclaimer() = default;
+
+    std::mutex mutex_;
+    std::weak_ptr<Task> task_;
+  };
+
+  // Returns true if the calling thread runs one of 'drivers_' outside of a
+  // suspended section. Such a thread can't wait for 'this' to pause.
+  bool isOnDriverThread() const;
+
   // RAII helper class to satisfy 'stateChangePromises_' and notify listeners
   // that task is complete outside of the mutex. Inactive on creation. Must be
   // activated explicitly by calling 'activate'.
@@ -871,6 +998,11 @@ class Task : public std::enable_shared_from_this<Task> {
   std::exception_ptr exception_ = nullptr;
   mutable std::mutex mutex_;
 
+  // Guards 'splitsStates_' and the split counters and split start times in
+  // 'taskStats_'. Drivers take only this lock to get and finish splits. When
+  // both locks are needed, 'mutex_' is taken first.
+  mutable std::mutex splitsMutex_;
+
   // Exchange clients. One per pipeline / source. Null for pipelines, which
   // don't need it.
   //
@@ -887,6 +1019,16 @@ class Task : public std::enable_shared_from_this<Task> {
 
   ConsumerSupplier consumerSupplier_;
 
+  // Filters imported from other tasks, keyed on TableScan plan node ID. Each
+  // entry is an output channel of the scan and a filter on it.
+  std::unordered_map<
+      core::PlanNodeId,
+      std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>>
+      importedDynamicFilters_;
+
+  // Total number of entries in 'importedDynamicFilters_'.
+  std::atomic<uint64_t> numImportedDynamicFilters_{0};
+
   // The function that is executed when the task encounters its first error,
   // that is, serError() is called for the first time.
   std::function<void(std::exception_ptr)> onError_;
@@ -946,12 +1088,15 @@ class Task : public std::enable_shared_from_this<Task> {
   /// queued split groups.
   std::queue<uint32_t> queuedSplitGroups_;
 
+  /// Set under both 'mutex_' and 'splitsMutex_', so either one is enough to
+  /// read it.
   TaskState state_ = TaskState::kRunning;
 
   /// Stores splits state structure for each plan node.
   /// At construction populated with all leaf plan nodes that require splits.
   /// Afterwards accessed with getPlanNodeSplitsStateLocked() to ensure we only
-  /// manage splits of the plan nodes that expect splits.
+  /// manage splits of the plan nodes that expect splits. Guarded by
+  /// 'splitsMutex_'.
   std::unordered_map<core::PlanNodeId, SplitsState> splitsStates_;
 
   std::vector<ContinuePromise> stateChangePromises_;
@@ -989,6 +1134,10 @@ class Task : public std::enable_shared_from_this<Task> {
 
   // Base spill directory for this task.
   std::string spillDirectory_;
+
+  // Spill directories the spill partitions are striped over in addition to
+  // 'spillDirectory_'.
+  std::vector<std::string> spillStripeDirectories_;
 };
 
 /// Listener invoked on task completion.
@@ -20,6 +20,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/exec/Driver.h"
 
 namespace facebook::velox::exec {
@@ -39,8 +40,37 @@ struct PipelineStats {
   // True if contains the sync node for the task.
   bool outputPipeline;
 
+  // Time the Drivers of the pipeline spent queued on the executor, running
+  // and blocked by reason, summed over the Drivers.
+  uint64_t queuedWallNanos{0};
+  uint64_t runningWallNanos{0};
+  std::unordered_map<BlockingReason, uint64_t> blockedWallNanos;
+
+  // Distributions over the Drivers of the time each spent queued, running
+  // and blocked. A max far above the average points at a straggler.
+  RuntimeMetric driverQueuedWallNanos{RuntimeCounter::Unit::kNanos};
+  RuntimeMetric driverRunningWallNanos{RuntimeCounter::Unit::kNanos};
+  RuntimeMetric driverBlockedWallNanos{RuntimeCounter::Unit::kNanos};
+
+  // The stats of each Driver, with timelines if enabled.
+  std::vector<DriverStats> driverStats;
+
   PipelineStats(bool _inputPipeline, bool _outputPipeline)
       : inputPipeline{_inputPipeline}, outputPipeline{_outputPipeline} {}
+
+  void addDriverStats(DriverStats stats) {
+    queuedWallNanos += stats.queuedWallNanos;
+    runningWallNanos += stats.runningWallNanos;
+    uint64_t blockedNanos = 0;
+    for (const auto& [reason, nanos] : stats.blockedWallNanos) {
+      blockedWallNanos[reason] += nanos;
+      blockedNanos += nanos;
+    }
+    driverQueuedWallNanos.addValue(stats.queuedWallNanos);
+    driverRunningWallNanos.addValue(stats.runningWallNanos);
+    driverBlockedWallNanos.addValue(blockedNanos);
+    driverStats.push_back(std::move(stats));
+  }
 };
 
 /// Stores execution stats per task.
@@ -49,6 +79,9 @@ struct TaskStats {
   int32_t numFinishedSplits{0};
   int32_t numRunningSplits{0};
   int32_t numQueuedSplits{0};
+  // Number of splits that were divided into smaller splits at the end of
+  // the scan.
+  int32_t numDividedSplits{0};
   std::unordered_set<int32_t> completedSplitGroups;
 
   /// The subscript is given by each Operator's
@@ -18,7 +18,9 @@
 #include <unordered_set>
 #include <vector>
 
+#include "velox/exec/SharedPartialAggregation.h"
 #include "velox/exec/SpillOperatorGroup.h"
+#include "velox/exec/SpillPartitionQueue.h"
 
 namespace facebook::velox::exec {
 
@@ -85,6 +87,19 @@ struct SplitGroupState {
   std::unordered_map<core::PlanNodeId, std::shared_ptr<SpillOperatorGroup>>
       spillOperatorGroups;
 
+  /// Map from the plan node id of a partial aggregation to the hash tables
+  /// shared by its drivers, see QueryConfig::kSharedPartialAggregationEnabled.
+  std::unordered_map<
+      core::PlanNodeId,
+      std::shared_ptr<SharedPartialAggregation>>
+      sharedPartialAggregations;
+
+  /// Map from the plan node id of a final aggregation to the spilled
+  /// partitions merged by its drivers, see
+  /// QueryConfig::kAggregationSpillParallelMergeEnabled.
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<SpillPartitionQueue>>
+      spillPartitionQueues;
+
   /// Holds states for Task::allPeersFinished.
   std::unordered_map<core::PlanNodeId, BarrierState> barriers;
 
@@ -111,6 +126,10 @@ struct SplitGroupState {
   /// e.g. Limit.
   uint32_t numFinishedOutputDrivers{0};
 
+  /// Memory pools of the operators of the split group's drivers. Released
+  /// when the split group finishes, see Task::releaseSplitGroupLocked().
+  std::vector<std::shared_ptr<memory::MemoryPool>> pools;
+
   // True if the state contains structures used for connecting ungrouped
   // execution pipeline with grouped excution pipeline. In that case we don't
   // want to clean up some of these structures.
@@ -121,6 +140,8 @@ struct SplitGroupState {
     if (!mixedExecutionMode) {
       bridges.clear();
       spillOperatorGroups.clear();
+      sharedPartialAggregations.clear();
+      spillPartitionQueues.clear();
       barriers.clear();
     }
     localMergeSources.clear();
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
@@ -29,33 +30,71 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
-      data_(std::make_unique<RowContainer>(outputType_->children(), pool())),
-      comparator_(
-          outputType_,
-          topNNode->sortingKeys(),
-          topNNode->sortingOrders(),
-          data_.get()),
+      spillMemoryThreshold_(
+          operatorCtx_->driverCtx()->queryConfig().topNSpillMemoryThreshold()),
+      spillConfig_(
+          topNNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kTopN)
+              : std::nullopt),
+      comparator_(nullptr, nullptr, nullptr),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
-
-TopN::Comparator::Comparator(
-    const RowTypePtr& type,
-    const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-        sortingKeys,
-    const std::vector<core::SortOrder>& sortingOrders,
-    RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
-  auto numKeys = sortingKeys.size();
-  for (int i = 0; i < numKeys; ++i) {
-    auto channel = exprToChannel(sortingKeys[i].get(), type);
+      decodedVectors_(outputType_->children().size()) {
+  createRowContainer(topNNode->sortingKeys(), topNNode->sortingOrders());
+  comparator_ = Comparator(&keyInfo_, &inputChannels_, data_.get());
+  topRows_ =
+      std::priority_queue<char*, std::vector<char*>, Comparator>(comparator_);
+}
+
+void TopN::createRowContainer(
+    const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<core::SortOrder>& sortingOrders) {
+  const auto numColumns = outputType_->size();
+  std::vector<column_index_t> inputColumnToDataColumn(
+      numColumns, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+
+  // Returns false if 'channel' is already a column of 'data_'.
+  auto addColumn = [&](column_index_t channel, bool isKey) {
+    if (inputColumnToDataColumn[channel] != kConstantChannel) {
+      return false;
+    }
+    inputColumnToDataColumn[channel] = inputChannels_.size();
+    columnMap_.emplace_back(inputChannels_.size(), channel);
+    inputChannels_.push_back(channel);
+    (isKey ? keyTypes : dependentTypes).push_back(outputType_->childAt(channel));
+    names.push_back(outputType_->nameOf(channel));
+    return true;
+  };
+
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    auto channel = exprToChannel(sortingKeys[i].get(), outputType_);
     VELOX_CHECK(
         channel != kConstantChannel,
         "TopN doesn't allow constant comparison keys");
-    keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
+    // A repeated sorting key doesn't change the order.
+    if (addColumn(channel, true)) {
+      const auto& sortOrder = sortingOrders[i];
+      keyInfo_.emplace_back(inputChannels_.size() - 1, sortOrder);
+      spillCompareFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+    }
+  }
+
+  for (column_index_t channel = 0; channel < numColumns; ++channel) {
+    addColumn(channel, false);
   }
+
+  auto types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  spillType_ = ROW(std::move(names), std::move(types));
 }
 
 void TopN::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
 
   // TODO Decode keys first, then decode the rest only for passing positions
@@ -66,6 +105,11 @@ void TopN::addInput(RowVectorPtr input) {
   for (int row = 0; row < input->size(); ++row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
+      // There are already 'count_' spilled rows not after 'spillCutoffRow_'.
+      if (spillCutoffRow_ != nullptr &&
+          !(*spillCutoffComparator_)(decodedVectors_, row, spillCutoffRow_)) {
+        continue;
+      }
       newRow = data_->newRow();
     } else {
       char* topRow = topRows_.top();
@@ -78,8 +122,8 @@ void TopN::addInput(RowVectorPtr input) {
       newRow = data_->initializeRow(topRow, true /* reuse */);
     }
 
-    for (int col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+    for (int col = 0; col < inputChannels_.size(); ++col) {
+      data_->store(decodedVectors_[inputChannels_[col]], row, newRow, col);
     }
 
     topRows_.push(newRow);
@@ -91,6 +135,10 @@ RowVectorPtr TopN::getOutput() {
     return nullptr;
   }
 
+  if (spillMerge_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
   uint32_t numRowsToReturn =
       std::min(kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
   VELOX_CHECK(numRowsToReturn > 0);
@@ -98,20 +146,94 @@ RowVectorPtr TopN::getOutput() {
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
 
-  for (int i = 0; i < outputType_->size(); ++i) {
+  for (const auto& columnProjection : columnMap_) {
     data_->extractColumn(
         rows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
-        result->childAt(i));
+        columnProjection.inputChannel,
+        result->childAt(columnProjection.outputChannel));
   }
   numRowsReturned_ += numRowsToReturn;
   finished_ = (numRowsReturned_ == rows_.size());
   return result;
 }
 
+RowVectorPtr TopN::getOutputWithSpill() {
+  const vector_size_t numRowsToReturn =
+      std::min<size_t>(kMaxNumRowsToReturn, count_ - numRowsReturned_);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
+
+  spillSources_.resize(numRowsToReturn);
+  spillSourceRows_.resize(numRowsToReturn);
+  vector_size_t outputRow = 0;
+  vector_size_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < numRowsToReturn) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+
+    // Advance the stream.
+    stream->pop();
+  }
+
+  if (FOLLY_LIKELY(outputSize != 0)) {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += outputSize;
+  }
+
+  numRowsReturned_ += outputRow;
+  if (outputRow < numRowsToReturn) {
+    // The spilled runs are exhausted.
+    finished_ = true;
+    if (outputRow == 0) {
+      return nullptr;
+    }
+    result->resize(outputRow);
+  }
+  finished_ = finished_ || (numRowsReturned_ == count_);
+  return result;
+}
+
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows so that all rows are read back from the
+    // merged spill runs in order.
+    spill();
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    updateSpillStats();
+    spillMerge_ = spiller_->startMerge(0);
+    return;
+  }
+
   if (topRows_.empty()) {
     finished_ = true;
     return;
@@ -126,4 +248,140 @@ void TopN::noMoreInput() {
 bool TopN::isFinished() {
   return finished_;
 }
+
+void TopN::updateSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+}
+
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  // Once there are 'count_' rows, the new rows replace the existing ones.
+  if ((topRows_.size() == count_ || freeRows > input->size()) &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const auto numNewRows =
+      std::min<int64_t>(input->size(), count_ - topRows_.size());
+  const int64_t incrementBytes =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopN::spill() {
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kTopN,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.fileOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  // The rows kept so far are the first rows of the input received since the
+  // previous spill. Once there are 'count_' of them, no later row after the
+  // largest of them can be in the result.
+  if (topRows_.size() == count_) {
+    updateSpillCutoff();
+  }
+
+  // The priority queue points to the rows in 'data_', so all the rows are
+  // spilled and the priority queue starts over.
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  topRows_ =
+      std::priority_queue<char*, std::vector<char*>, Comparator>(comparator_);
+}
+
+void TopN::updateSpillCutoff() {
+  if (spillCutoffData_ == nullptr) {
+    spillCutoffData_ =
+        std::make_unique<RowContainer>(data_->keyTypes(), pool());
+    spillCutoffComparator_.emplace(
+        &keyInfo_, &inputChannels_, spillCutoffData_.get());
+    spillCutoffRow_ = spillCutoffData_->newRow();
+  } else {
+    spillCutoffData_->initializeRow(spillCutoffRow_, true /* reuse */);
+  }
+
+  char* topRow = topRows_.top();
+  SelectivityVector row(1);
+  for (auto i = 0; i < data_->keyTypes().size(); ++i) {
+    auto key = BaseVector::create(data_->keyTypes()[i], 1, pool());
+    data_->extractColumn(&topRow, 1, i, key);
+    DecodedVector decoded(*key, row);
+    spillCutoffData_->store(decoded, 0, spillCutoffRow_, i);
+  }
+}
 } // namespace facebook::velox::exec
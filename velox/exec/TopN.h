@@ -17,9 +17,19 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Returns the first 'count' rows of the input sorted on the sorting keys. The
+/// operator keeps a priority queue of at most 'count' rows.
+///
+/// If spilling is enabled and memory runs low, the rows kept so far are
+/// spilled as a sorted run and the priority queue starts over. The largest
+/// spilled row is remembered if there are 'count' spilled rows, as no row after
+/// it can be in the result, so the rows in each spilled run and in memory are
+/// limited to 'count'. After all input is received, the runs are merged and
+/// the merge stops after 'count' rows.
 class TopN : public Operator {
  public:
   TopN(
@@ -45,21 +55,25 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Orders rows of a RowContainer whose leading key columns are the sorting
+  // keys. This is copied into the priority queue, so it only holds pointers.
   class Comparator {
    public:
     Comparator(
-        const RowTypePtr& outputType,
-        const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-            sortingKeys,
-        const std::vector<core::SortOrder>& sortingOrders,
-        RowContainer* rowContainer);
+        const std::vector<std::pair<column_index_t, core::SortOrder>>* keyInfo,
+        const std::vector<column_index_t>* inputChannels,
+        RowContainer* rowContainer)
+        : keyInfo_(keyInfo),
+          inputChannels_(inputChannels),
+          rowContainer_(rowContainer) {}
 
     // Returns true if lhs < rhs, false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
-      for (auto& key : keyInfo_) {
+      for (auto& key : *keyInfo_) {
         if (auto result = rowContainer_->compare(
                 lhs,
                 rhs,
@@ -76,11 +90,11 @@ class TopN : public Operator {
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index,
         const char* rhs) {
-      for (auto& key : keyInfo_) {
+      for (auto& key : *keyInfo_) {
         if (auto result = rowContainer_->compare(
                 rhs,
                 rowContainer_->columnAt(key.first),
-                decodedVectors[key.first],
+                decodedVectors[(*inputChannels_)[key.first]],
                 index,
                 {key.second.isNullsFirst(), key.second.isAscending(), false})) {
           return result > 0;
@@ -90,15 +104,59 @@ class TopN : public Operator {
     }
 
    private:
-    std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+    // The sorting keys over the columns of 'rowContainer_'.
+    const std::vector<std::pair<column_index_t, core::SortOrder>>* keyInfo_;
+    // Maps the columns of 'rowContainer_' to the input channels.
+    const std::vector<column_index_t>* inputChannels_;
     RowContainer* rowContainer_;
   };
 
+  // Creates 'data_' with the distinct sorting keys as key columns, followed by
+  // the rest of the input columns as dependents.
+  void createRowContainer(
+      const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+      const std::vector<core::SortOrder>& sortingOrders);
+
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills all the
+  // rows kept so far.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the rows in 'data_' and resets 'topRows_'.
+  void spill();
+
+  // Copies the sorting keys of the largest row in 'topRows_' into
+  // 'spillCutoffRow_'.
+  void updateSpillCutoff();
+
+  // Copies the spill stats from 'spiller_' into the operator stats.
+  void updateSpillStats();
+
+  // Returns the next batch of rows from the merged spill runs. Returns null
+  // once 'count_' rows have been returned or the runs are exhausted.
+  RowVectorPtr getOutputWithSpill();
+
   const int32_t count_;
 
+  // The maximum memory usage that a final TopN can hold before spilling.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
+  // Maps the columns of 'data_' to the input channels.
+  std::vector<column_index_t> inputChannels_;
+
+  // Maps the columns of 'data_' to the output channels. Used to copy the rows
+  // from 'data_' and the spilled runs to the output.
+  std::vector<IdentityProjection> columnMap_;
+
+  // Sorting keys info over the columns of 'data_'.
+  std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
   // RowContainer (data_). We only update the RowContainer if a row is a
@@ -114,5 +172,31 @@ class TopN : public Operator {
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  // The compare flags of the sorting keys used to sort the spilled runs.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Holds the sorting keys of the largest spilled row once at least 'count_'
+  // rows have been spilled. There are 'count_' spilled rows not after it, so
+  // input rows not before it are dropped.
+  std::unique_ptr<RowContainer> spillCutoffData_;
+  char* spillCutoffRow_{nullptr};
+  std::optional<Comparator> spillCutoffComparator_;
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // The source vectors and rows of the next output batch from 'spillMerge_'.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TopNRowNumber.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+TopNRowNumber::TopNRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::TopNRowNumberNode>& node)
+    : Operator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "TopNRowNumber"),
+      limit_(node->limit()),
+      generateRowNumber_(node->generateRowNumber()),
+      numInputColumns_(node->sources()[0]->outputType()->size()),
+      spillMemoryThreshold_(operatorCtx_->driverCtx()
+                                ->queryConfig()
+                                .topNRowNumberSpillMemoryThreshold()),
+      spillConfig_(
+          node->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kTopNRowNumber)
+              : std::nullopt),
+      decodedVectors_(numInputColumns_) {
+  const auto& inputType = node->sources()[0]->outputType();
+  createRowContainer(
+      inputType,
+      node->partitionKeys(),
+      node->sortingKeys(),
+      node->sortingOrders());
+
+  if (node->partitionKeys().empty()) {
+    partitions_.emplace_back(comparator());
+  } else {
+    createHashTable(inputType, node->partitionKeys());
+  }
+}
+
+void TopNRowNumber::createRowContainer(
+    const RowTypePtr& inputType,
+    const std::vector<core::FieldAccessTypedExprPtr>& partitionKeys,
+    const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<core::SortOrder>& sortingOrders) {
+  inputColumnToDataColumn_.assign(numInputColumns_, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+
+  // Returns false if 'channel' is already a column of 'data_'.
+  auto addColumn = [&](column_index_t channel, bool isKey) {
+    VELOX_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "TopNRowNumber doesn't allow constant partition or sorting keys");
+    if (inputColumnToDataColumn_[channel] != kConstantChannel) {
+      return false;
+    }
+    inputColumnToDataColumn_[channel] = inputChannels_.size();
+    inputChannels_.push_back(channel);
+    (isKey ? keyTypes : dependentTypes).push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+    return true;
+  };
+
+  for (const auto& key : partitionKeys) {
+    if (addColumn(exprToChannel(key.get(), inputType), true)) {
+      // The partition keys only need a consistent order in the spilled runs.
+      spillCompareFlags_.push_back({true, true, false, false});
+    }
+  }
+  numPartitionKeys_ = inputChannels_.size();
+
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    // A repeated sorting key doesn't change the order.
+    if (addColumn(exprToChannel(sortingKeys[i].get(), inputType), true)) {
+      const auto& sortOrder = sortingOrders[i];
+      sortKeyInfo_.emplace_back(inputChannels_.size() - 1, sortOrder);
+      spillCompareFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+    }
+  }
+
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    addColumn(channel, false);
+  }
+
+  auto types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  spillType_ = ROW(std::move(names), std::move(types));
+}
+
+void TopNRowNumber::createHashTable(
+    const RowTypePtr& inputType,
+    const std::vector<core::FieldAccessTypedExprPtr>& partitionKeys) {
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(partitionKeys.size());
+  for (const auto& key : partitionKeys) {
+    const auto channel = exprToChannel(key.get(), inputType);
+    hashers.push_back(VectorHasher::create(key->type(), channel));
+  }
+
+  // Each group row of the table holds the index of the partition in
+  // 'partitions_' in a BIGINT dependent column after the keys. Null partition
+  // keys form a partition of their own.
+  static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+  table_ = std::make_unique<HashTable<false>>(
+      std::move(hashers),
+      kNoAggregates,
+      std::vector<TypePtr>{BIGINT()},
+      false, // allowDuplicates
+      false, // isJoinBuild
+      false, // hasProbedFlag
+      pool());
+  partitionIndexOffset_ =
+      table_->rows()->columnAt(partitionKeys.size()).offset();
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+}
+
+void TopNRowNumber::lookupPartitions(const RowVectorPtr& input) {
+  const auto numInput = input->size();
+  SelectivityVector rows(numInput);
+  auto& hashers = lookup_->hashers;
+  lookup_->reset(numInput);
+
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, rows);
+  }
+
+  const auto mode = table_->hashMode();
+  bool rehash = false;
+  if (mode != BaseHashTable::HashMode::kHash) {
+    for (auto i = 0; i < hashers.size(); ++i) {
+      if (!hashers[i]->computeValueIds(rows, lookup_->hashes)) {
+        rehash = true;
+      }
+    }
+  } else {
+    VectorHasher::hash(hashers, rows, lookup_->hashes);
+  }
+
+  if (rehash) {
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      table_->decideHashMode(numInput);
+    }
+    lookupPartitions(input);
+    return;
+  }
+
+  std::iota(lookup_->rows.begin(), lookup_->rows.end(), 0);
+  table_->groupProbe(*lookup_);
+
+  for (auto row : lookup_->newGroups) {
+    *reinterpret_cast<int64_t*>(lookup_->hits[row] + partitionIndexOffset_) =
+        partitions_.size();
+    partitions_.emplace_back(comparator());
+  }
+
+  partitionIndices_.resize(numInput);
+  for (auto row = 0; row < numInput; ++row) {
+    partitionIndices_[row] = partitionIndex(lookup_->hits[row]);
+  }
+}
+
+void TopNRowNumber::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
+  SelectivityVector allRows(input->size());
+  for (auto col = 0; col < numInputColumns_; ++col) {
+    decodedVectors_[col].decode(*input->childAt(col), allRows);
+  }
+
+  if (table_ == nullptr) {
+    auto& partition = partitions_[0];
+    for (auto row = 0; row < input->size(); ++row) {
+      addRow(partition, row);
+    }
+    return;
+  }
+
+  lookupPartitions(input);
+  for (auto row = 0; row < input->size(); ++row) {
+    addRow(partitions_[partitionIndices_[row]], row);
+  }
+}
+
+void TopNRowNumber::addRow(TopRows& partition, vector_size_t index) {
+  char* newRow = nullptr;
+  if (partition.size() < limit_) {
+    newRow = data_->newRow();
+  } else {
+    char* topRow = partition.top();
+    if (!comparator()(decodedVectors_, inputChannels_, index, topRow)) {
+      return;
+    }
+    partition.pop();
+    // Reuse the topRow's memory.
+    newRow = data_->initializeRow(topRow, true /* reuse */);
+  }
+
+  for (auto col = 0; col < inputChannels_.size(); ++col) {
+    data_->store(decodedVectors_[inputChannels_[col]], index, newRow, col);
+  }
+  partition.push(newRow);
+}
+
+void TopNRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+  outputBatchSize_ = outputBatchRows(data_->estimateRowSize());
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows so that all partitions are read back from the
+    // merged spill runs in order.
+    spill();
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    updateSpillStats();
+    spillMerge_ = spiller_->startMerge(0);
+    nextSpillStream_ = spillMerge_->next();
+    return;
+  }
+
+  prepareOutputRows();
+  if (outputRows_.empty()) {
+    finished_ = true;
+  }
+}
+
+void TopNRowNumber::prepareOutputRows() {
+  const auto numRows = data_->numRows();
+  outputRows_.resize(numRows);
+  outputRowNumbers_.resize(numRows);
+
+  size_t offset = 0;
+  for (auto& partition : partitions_) {
+    const auto numPartitionRows = partition.size();
+    for (auto i = numPartitionRows; i > 0; --i) {
+      outputRows_[offset + i - 1] = partition.top();
+      outputRowNumbers_[offset + i - 1] = i;
+      partition.pop();
+    }
+    offset += numPartitionRows;
+  }
+  VELOX_CHECK_EQ(offset, numRows);
+  partitions_.clear();
+}
+
+RowVectorPtr TopNRowNumber::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (spillMerge_ != nullptr) {
+    if (numOutputRowsReturned_ == outputRows_.size() && !loadSpilledRows()) {
+      finished_ = true;
+      return nullptr;
+    }
+    return makeOutput();
+  }
+
+  auto output = makeOutput();
+  finished_ = (numOutputRowsReturned_ == outputRows_.size());
+  return output;
+}
+
+RowVectorPtr TopNRowNumber::makeOutput() {
+  const vector_size_t numOutputRows = std::min<size_t>(
+      outputBatchSize_, outputRows_.size() - numOutputRowsReturned_);
+  VELOX_CHECK_GT(numOutputRows, 0);
+
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
+
+  for (auto i = 0; i < numInputColumns_; ++i) {
+    data_->extractColumn(
+        outputRows_.data() + numOutputRowsReturned_,
+        numOutputRows,
+        inputColumnToDataColumn_[i],
+        result->childAt(i));
+  }
+
+  if (generateRowNumber_) {
+    auto rowNumbers =
+        result->childAt(numInputColumns_)->asFlatVector<int64_t>();
+    for (auto i = 0; i < numOutputRows; ++i) {
+      rowNumbers->set(i, outputRowNumbers_[numOutputRowsReturned_ + i]);
+    }
+  }
+
+  numOutputRowsReturned_ += numOutputRows;
+  return result;
+}
+
+void TopNRowNumber::updateSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+}
+
+void TopNRowNumber::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  const auto tableIncrement = table_->hashTableSizeIncrease(input->size());
+
+  if (!tableIncrement && freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed. Each input row may also start
+  // a new partition.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0) +
+      table_->rows()->sizeIncrement(input->size(), 0) + tableIncrement;
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  spill();
+}
+
+void TopNRowNumber::spill() {
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kTopNRowNumber,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.fileOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  // The priority queues point to the rows in 'data_', so all the rows are
+  // spilled and the partitions start over. Each spilled run has at most
+  // 'limit_' rows per partition.
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  table_->clear();
+  partitions_.clear();
+}
+
+bool TopNRowNumber::isNewPartition(SpillMergeStream* stream, const char* row) {
+  const auto index = stream->currentIndex();
+  for (auto i = 0; i < numPartitionKeys_; ++i) {
+    if (data_->compare(row, data_->columnAt(i), stream->decoded(i), index) !=
+        0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TopNRowNumber::loadSpilledRows() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  data_->clear();
+  outputRows_.clear();
+  outputRowNumbers_.clear();
+  numOutputRowsReturned_ = 0;
+
+  // The previous load stopped at a partition boundary so the first row starts
+  // a new partition.
+  int64_t rowNumber = 0;
+  while (nextSpillStream_ != nullptr) {
+    auto* stream = nextSpillStream_;
+    if (!outputRows_.empty() && isNewPartition(stream, outputRows_.back())) {
+      if (outputRows_.size() >= outputBatchSize_) {
+        // Keep the first row of the next partition in 'stream' for the next
+        // load.
+        break;
+      }
+      rowNumber = 0;
+    }
+
+    // Skip the rows past the limit of the current partition.
+    if (rowNumber < limit_) {
+      const auto index = stream->currentIndex();
+      char* newRow = data_->newRow();
+      for (auto col = 0; col < spillType_->size(); ++col) {
+        data_->store(stream->decoded(col), index, newRow, col);
+      }
+      outputRows_.push_back(newRow);
+      outputRowNumbers_.push_back(++rowNumber);
+    }
+
+    stream->pop();
+    nextSpillStream_ = spillMerge_->next();
+  }
+
+  return !outputRows_.empty();
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Computes row_number() over (partition by ... order by ...) and returns only
+/// the rows with row numbers <= limit. This is equivalent to a Window operator
+/// followed by a Filter, but instead of materializing and sorting all the
+/// input, the operator keeps a bounded priority queue of at most 'limit' rows
+/// per partition. The partitions are looked up in a HashTable keyed on the
+/// partition keys. Memory is bounded by the number of partitions times the
+/// limit, rather than by the size of the input.
+///
+/// If spilling is enabled and memory runs low, all the rows kept so far are
+/// spilled as a run sorted on (partition keys + sorting keys) and the
+/// partitions state is reset. Each run has at most 'limit' rows per
+/// partition. After all input is received the runs are merged and the first
+/// 'limit' rows of each partition are returned.
+class TopNRowNumber : public Operator {
+ public:
+  TopNRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::TopNRowNumberNode>& node);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+ private:
+  // Orders rows of 'data_' on the sorting keys. This is copied into the
+  // priority queue of each partition, so it only holds pointers.
+  class Comparator {
+   public:
+    Comparator(
+        const std::vector<std::pair<column_index_t, core::SortOrder>>* keyInfo,
+        RowContainer* rowContainer)
+        : keyInfo_(keyInfo), rowContainer_(rowContainer) {}
+
+    // Returns true if lhs < rhs, false otherwise.
+    bool operator()(const char* lhs, const char* rhs) {
+      if (lhs == rhs) {
+        return false;
+      }
+      for (const auto& [column, sortOrder] : *keyInfo_) {
+        if (auto result = rowContainer_->compare(
+                lhs,
+                rhs,
+                column,
+                {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+          return result < 0;
+        }
+      }
+      return false;
+    }
+
+    // Returns true if decodedVectors[channel] at 'index' < rhs, false
+    // otherwise. 'inputChannels' maps the key columns of 'rowContainer_' to
+    // the channels of 'decodedVectors'.
+    bool operator()(
+        const std::vector<DecodedVector>& decodedVectors,
+        const std::vector<column_index_t>& inputChannels,
+        vector_size_t index,
+        const char* rhs) {
+      for (const auto& [column, sortOrder] : *keyInfo_) {
+        if (auto result = rowContainer_->compare(
+                rhs,
+                rowContainer_->columnAt(column),
+                decodedVectors[inputChannels[column]],
+                index,
+                {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+          return result > 0;
+        }
+      }
+      return false;
+    }
+
+   private:
+    const std::vector<std::pair<column_index_t, core::SortOrder>>* keyInfo_;
+    RowContainer* rowContainer_;
+  };
+
+  // The top rows of a single partition. The root of the queue is the largest
+  // of the kept rows, which is the one to evict when a smaller row arrives.
+  using TopRows = std::priority_queue<char*, std::vector<char*>, Comparator>;
+
+  // Creates 'data_' with the partition and sorting keys as key columns,
+  // followed by the rest of the input columns as dependents.
+  void createRowContainer(
+      const RowTypePtr& inputType,
+      const std::vector<core::FieldAccessTypedExprPtr>& partitionKeys,
+      const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+      const std::vector<core::SortOrder>& sortingOrders);
+
+  // Creates 'table_' used to look up partitions on 'partitionKeys'.
+  void createHashTable(
+      const RowTypePtr& inputType,
+      const std::vector<core::FieldAccessTypedExprPtr>& partitionKeys);
+
+  Comparator comparator() {
+    return Comparator(&sortKeyInfo_, data_.get());
+  }
+
+  // Finds or creates the partition of each row in 'input'. Sets the indices
+  // into 'partitions_' in 'partitionIndices_'.
+  void lookupPartitions(const RowVectorPtr& input);
+
+  // Adds row 'index' of the decoded input to 'partition' if it is among the
+  // top 'limit_' rows seen so far.
+  void addRow(TopRows& partition, vector_size_t index);
+
+  // Returns the index into 'partitions_' stored in a row of 'table_'.
+  int64_t partitionIndex(const char* group) const {
+    return *reinterpret_cast<const int64_t*>(group + partitionIndexOffset_);
+  }
+
+  // Moves the rows of all partitions into 'outputRows_' in output order.
+  void prepareOutputRows();
+
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills all the
+  // rows kept so far.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the rows in 'data_' and resets the partitions state.
+  void spill();
+
+  // Copies the spill stats from 'spiller_' into the operator stats.
+  void updateSpillStats();
+
+  // Loads the next rows from the merged spill runs into 'data_' and
+  // 'outputRows_'. Only the first 'limit_' rows of each partition are kept.
+  // Stops at a partition boundary once there are at least 'outputBatchSize_'
+  // rows. Returns false if there is no more spilled data.
+  bool loadSpilledRows();
+
+  // Returns true if the current row of 'stream' belongs to a different
+  // partition than 'row' of 'data_'.
+  bool isNewPartition(SpillMergeStream* stream, const char* row);
+
+  // Produces an output batch from 'outputRows_' starting at
+  // 'numOutputRowsReturned_'.
+  RowVectorPtr makeOutput();
+
+  const int32_t limit_;
+
+  const bool generateRowNumber_;
+
+  const column_index_t numInputColumns_;
+
+  // The maximum memory usage that a top-n row number can hold before
+  // spilling.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // Maps the columns of 'data_' to the input channels and back.
+  std::vector<column_index_t> inputChannels_;
+  std::vector<column_index_t> inputColumnToDataColumn_;
+
+  // Number of distinct partition key columns. These are the leading columns
+  // of 'data_'.
+  size_t numPartitionKeys_{0};
+
+  // Sorting keys info over the columns of 'data_'.
+  std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
+
+  // Stores the rows in the top rows of some partition.
+  std::unique_ptr<RowContainer> data_;
+
+  // HashTable keyed on the partition keys. Each group row holds an index into
+  // 'partitions_'. Null if there are no partition keys.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+
+  // Offset of the partition index column in the rows of 'table_'.
+  int32_t partitionIndexOffset_{0};
+
+  // The partitions seen so far. There is a single partition if there are no
+  // partition keys.
+  std::vector<TopRows> partitions_;
+
+  // Partition index for each row of the current input.
+  std::vector<int64_t> partitionIndices_;
+
+  std::vector<DecodedVector> decodedVectors_;
+
+  // The rows to output, grouped by partition and ordered by the sorting keys
+  // within each partition, with the corresponding row numbers.
+  std::vector<char*> outputRows_;
+  std::vector<int64_t> outputRowNumbers_;
+
+  // Number of rows in 'outputRows_' returned so far.
+  size_t numOutputRowsReturned_{0};
+
+  // The number of rows per output batch.
+  uint32_t outputBatchSize_{0};
+
+  bool finished_{false};
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  // The compare flags of the key columns in 'data_' used to sort the spilled
+  // runs.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // The stream holding the next row to read from the merged spill runs.
+  SpillMergeStream* nextSpillStream_{nullptr};
+};
+} // namespace facebook::velox::exec
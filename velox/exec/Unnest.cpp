@@ -30,7 +30,8 @@ Unnest::Unnest(
           operatorId,
           unnestNode->id(),
           "Unnest"),
-      withOrdinality_(unnestNode->withOrdinality()) {
+      withOrdinality_(unnestNode->withOrdinality()),
+      maxOutputRows_(outputBatchRows()) {
   const auto& inputType = unnestNode->sources()[0]->outputType();
   const auto& unnestVariables = unnestNode->unnestVariables();
   for (const auto& variable : unnestVariables) {
@@ -41,6 +42,9 @@ Unnest::Unnest(
   }
 
   unnestDecoded_.resize(unnestVariables.size());
+  rawSizes_.resize(unnestVariables.size());
+  rawOffsets_.resize(unnestVariables.size());
+  rawIndices_.resize(unnestVariables.size());
 
   if (withOrdinality_) {
     VELOX_CHECK_EQ(
@@ -58,65 +62,101 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
-
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
 
-  auto size = input_->size();
+  const auto size = input_->size();
   inputRows_.resize(size);
-
-  // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
-
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
-
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  maxSizes_.assign(size, 0);
+  nextRow_ = 0;
+  nextElement_ = 0;
 
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
     unnestDecoded_[channel].decode(*unnestVector, inputRows_);
 
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    rawIndices_[channel] = currentDecoded.indices();
 
-    const ArrayVector* unnestBaseArray;
-    const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
-      unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      const auto* unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
-      unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      const auto* unnestBaseMap = currentDecoded.base()->as<MapVector>();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = rawIndices_[channel];
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
-        if (rawMaxSizes[row] < unnestSize) {
-          rawMaxSizes[row] = unnestSize;
+        if (maxSizes_[row] < unnestSize) {
+          maxSizes_[row] = unnestSize;
         }
       }
     }
   }
+}
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+template <typename TFunc>
+void Unnest::forEachOutputRow(
+    vector_size_t firstRow,
+    vector_size_t firstElement,
+    vector_size_t lastRow,
+    vector_size_t lastElement,
+    TFunc func) const {
+  for (auto row = firstRow; row <= lastRow; ++row) {
+    func(
+        row,
+        row == firstRow ? firstElement : 0,
+        row == lastRow ? lastElement : maxSizes_[row]);
+  }
+}
+
+VectorPtr Unnest::makeElements(
+    const VectorPtr& elements,
+    vector_size_t numElements,
+    const BufferPtr& elementIndices,
+    const BufferPtr& nulls,
+    std::optional<vector_size_t> sliceStart) const {
+  if (!sliceStart.has_value()) {
+    return wrapChild(numElements, elementIndices, elements, nulls);
+  }
+  if (sliceStart.value() == 0 && numElements == elements->size()) {
+    return elements;
+  }
+  return elements->slice(sliceStart.value(), numElements);
+}
+
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  const auto size = input_->size();
+
+  // Find the elements that go into this batch: from 'nextElement_' of
+  // 'nextRow_' up to but not including 'lastElement' of 'lastRow'.
+  const auto firstRow = nextRow_;
+  const auto firstElement = nextElement_;
+  vector_size_t numElements = 0;
+  vector_size_t lastRow = firstRow;
+  vector_size_t lastElement = firstElement;
+  while (nextRow_ < size && numElements < maxOutputRows_) {
+    const auto numTaken = std::min(
+        maxSizes_[nextRow_] - nextElement_, maxOutputRows_ - numElements);
+    numElements += numTaken;
+    lastRow = nextRow_;
+    lastElement = nextElement_ + numTaken;
+    if (lastElement == maxSizes_[nextRow_]) {
+      ++nextRow_;
+      nextElement_ = 0;
+    } else {
+      nextElement_ = lastElement;
+    }
   }
 
   if (numElements == 0) {
@@ -130,11 +170,16 @@ RowVectorPtr Unnest::getOutput() {
   auto repeatedIndices = allocateIndices(numElements, pool());
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
-    }
-  }
+  forEachOutputRow(
+      firstRow,
+      firstElement,
+      lastRow,
+      lastElement,
+      [&](auto row, auto begin, auto end) {
+        for (auto i = begin; i < end; ++i) {
+          rawRepeatedIndices[index++] = row;
+        }
+      });
 
   // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
   std::vector<VectorPtr> outputs(outputType_->size());
@@ -147,9 +192,9 @@ RowVectorPtr Unnest::getOutput() {
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentOffsets = rawOffsets_[channel];
+    auto currentIndices = rawIndices_[channel];
 
     BufferPtr elementIndices = allocateIndices(numElements, pool());
     auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
@@ -159,58 +204,67 @@ RowVectorPtr Unnest::getOutput() {
     auto rawNulls = nulls->asMutable<uint64_t>();
 
     // Make dictionary index for elements column since they may be out of order.
+    // If the elements are consecutive and none are null, the output is a slice
+    // of the elements vector instead.
     index = 0;
-    bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-
-      if (!currentDecoded.isNullAt(row)) {
-        auto offset = currentOffsets[currentIndices[row]];
-        auto unnestSize = currentSizes[currentIndices[row]];
-
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
-        }
-
-        for (auto i = 0; i < unnestSize; i++) {
-          rawElementIndices[index++] = offset + i;
-        }
-
-        for (auto i = unnestSize; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      } else if (maxSize > 0) {
-        identityMapping = false;
-
-        for (auto i = 0; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      }
-    }
+    bool consecutive = true;
+    forEachOutputRow(
+        firstRow,
+        firstElement,
+        lastRow,
+        lastElement,
+        [&](auto row, auto begin, auto end) {
+          if (currentDecoded.isNullAt(row)) {
+            consecutive = false;
+            for (auto i = begin; i < end; ++i) {
+              bits::setNull(rawNulls, index++, true);
+            }
+            return;
+          }
+          const auto offset = currentOffsets[currentIndices[row]];
+          const auto unnestSize = currentSizes[currentIndices[row]];
+          if (index > 0 && begin < unnestSize &&
+              offset + begin != rawElementIndices[0] + index) {
+            consecutive = false;
+          }
+          for (auto i = begin; i < std::min(end, unnestSize); ++i) {
+            rawElementIndices[index++] = offset + i;
+          }
+          for (auto i = std::max(begin, unnestSize); i < end; ++i) {
+            consecutive = false;
+            bits::setNull(rawNulls, index++, true);
+          }
+        });
+    const auto sliceStart = consecutive
+        ? std::optional<vector_size_t>(rawElementIndices[0])
+        : std::nullopt;
 
     if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
       // Construct unnest column using Array elements wrapped using above
       // created dictionary.
       auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+      outputs[outputsIndex++] = makeElements(
+          unnestBaseArray->elements(),
+          numElements,
+          elementIndices,
+          nulls,
+          sliceStart);
     } else {
       // Construct two unnest columns for Map keys and values vectors wrapped
       // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      outputs[outputsIndex++] = makeElements(
+          unnestBaseMap->mapKeys(),
+          numElements,
+          elementIndices,
+          nulls,
+          sliceStart);
+      outputs[outputsIndex++] = makeElements(
+          unnestBaseMap->mapValues(),
+          numElements,
+          elementIndices,
+          nulls,
+          sliceStart);
     }
   }
 
@@ -221,19 +275,26 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
-    }
+    forEachOutputRow(
+        firstRow,
+        firstElement,
+        lastRow,
+        lastElement,
+        [&](auto /*row*/, auto begin, auto end) {
+          std::iota(rawOrdinality, rawOrdinality + (end - begin), begin + 1);
+          rawOrdinality += end - begin;
+        });
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
-  return std::make_shared<RowVector>(
+  auto output = std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
+  if (nextRow_ == size) {
+    input_ = nullptr;
+  }
+  return output;
 }
 
 bool Unnest::isFinished() {
@@ -29,7 +29,7 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return !input_;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -39,11 +39,50 @@ class Unnest : public Operator {
   bool isFinished() override;
 
  private:
+  // Calls 'func(row, begin, end)' for each row of 'input_' that produces
+  // output in the current batch. 'begin' and 'end' are the range of the
+  // elements of 'row' that go into the batch.
+  template <typename TFunc>
+  void forEachOutputRow(
+      vector_size_t firstRow,
+      vector_size_t firstElement,
+      vector_size_t lastRow,
+      vector_size_t lastElement,
+      TFunc func) const;
+
+  // Makes the output column for the elements of 'elements' at
+  // 'elementIndices'. Returns a zero-copy slice if the elements are
+  // consecutive and not null.
+  VectorPtr makeElements(
+      const VectorPtr& elements,
+      vector_size_t numElements,
+      const BufferPtr& elementIndices,
+      const BufferPtr& nulls,
+      std::optional<vector_size_t> sliceStart) const;
+
   std::vector<column_index_t> unnestChannels_;
 
   SelectivityVector inputRows_;
   std::vector<DecodedVector> unnestDecoded_;
 
   const bool withOrdinality_;
+
+  // The max number of rows in an output batch. Rows of 'input_' with more
+  // elements are split over several batches.
+  const vector_size_t maxOutputRows_;
+
+  // The sizes, offsets and indices of the unnested columns of 'input_'.
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+  std::vector<const vector_size_t*> rawIndices_;
+
+  // The max number of elements at each row of 'input_' across all unnested
+  // columns.
+  std::vector<vector_size_t> maxSizes_;
+
+  // The row of 'input_' and the element within the row at which the next
+  // output batch starts.
+  vector_size_t nextRow_{0};
+  vector_size_t nextElement_{0};
 };
 } // namespace facebook::velox::exec
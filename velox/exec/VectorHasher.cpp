@@ -108,6 +108,96 @@ void VectorHasher::hashValues(
   }
 }
 
+namespace {
+// True if the flat vector of 'Kind' stores its values in an array of
+// KindToFlatVector<Kind>::HashRowType.
+constexpr bool hasRawHashValues(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+template <TypeKind Kind>
+void VectorHasher::hashBlock(
+    const SelectivityVector& rows,
+    vector_size_t begin,
+    vector_size_t end,
+    bool allSelected,
+    bool mix,
+    uint64_t* result) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  const auto forEachRow = [&](auto func) {
+    if (allSelected) {
+      for (auto row = begin; row < end; ++row) {
+        func(row);
+      }
+    } else {
+      bits::forEachSetBit(rows.asRange().bits(), begin, end, func);
+    }
+  };
+  const auto store = [&](vector_size_t row, uint64_t hash) {
+    result[row] = mix ? bits::hashMix(result[row], hash) : hash;
+  };
+
+  if (channel_ == kConstantChannel) {
+    forEachRow([&](vector_size_t row) { store(row, precomputedHash_); });
+  } else if (decoded_.isConstantMapping()) {
+    const auto hash =
+        decoded_.isNullAt(begin) ? kNullHash : hashOne<Kind>(decoded_, begin);
+    forEachRow([&](vector_size_t row) { store(row, hash); });
+  } else if (decoded_.isIdentityMapping()) {
+    if constexpr (hasRawHashValues(Kind)) {
+      if (allSelected && !decoded_.mayHaveNulls()) {
+        // The common case of a flat key without nulls.
+        const auto* values = decoded_.data<T>();
+        if (mix) {
+          for (auto row = begin; row < end; ++row) {
+            result[row] =
+                bits::hashMix(result[row], folly::hasher<T>()(values[row]));
+          }
+        } else {
+          for (auto row = begin; row < end; ++row) {
+            result[row] = folly::hasher<T>()(values[row]);
+          }
+        }
+        return;
+      }
+    }
+    forEachRow([&](vector_size_t row) {
+      store(
+          row,
+          decoded_.isNullAt(row) ? kNullHash : hashOne<Kind>(decoded_, row));
+    });
+  } else {
+    forEachRow([&](vector_size_t row) {
+      if (decoded_.isNullAt(row)) {
+        store(row, kNullHash);
+        return;
+      }
+      const auto baseIndex = decoded_.index(row);
+      uint64_t hash = cachedHashes_[baseIndex];
+      if (hash == kNullHash) {
+        hash = hashOne<Kind>(decoded_, row);
+        cachedHashes_[baseIndex] = hash;
+      }
+      store(row, hash);
+    });
+  }
+}
+
 template <TypeKind Kind>
 bool VectorHasher::makeValueIds(
     const SelectivityVector& rows,
@@ -128,6 +218,19 @@ bool VectorHasher::makeValueIds(
     return true;
   }
 
+  if constexpr (
+      std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t> ||
+      std::is_same_v<T, int16_t>) {
+    if (isRange_ && decoded_.isIdentityMapping() &&
+        decoded_.base()->encoding() == VectorEncoding::Simple::BIASED &&
+        tryMapBiasedToRange(
+            *decoded_.base()->template asUnchecked<BiasVector<T>>(),
+            rows,
+            result)) {
+      return true;
+    }
+  }
+
   if (decoded_.isIdentityMapping()) {
     if (decoded_.mayHaveNulls()) {
       return makeValueIdsFlatWithNulls<T>(rows, result);
@@ -320,6 +423,58 @@ bool VectorHasher::makeValueIdsDecoded<bool, false>(
   return true;
 }
 
+template <typename T>
+bool VectorHasher::tryMapBiasedToRange(
+    const BiasVector<T>& vector,
+    const SelectivityVector& rows,
+    uint64_t* result) {
+  switch (vector.valueType()) {
+    case TypeKind::TINYINT:
+      return tryMapBiasedToRange<T, int8_t>(vector, rows, result);
+    case TypeKind::SMALLINT:
+      return tryMapBiasedToRange<T, int16_t>(vector, rows, result);
+    case TypeKind::INTEGER:
+      return tryMapBiasedToRange<T, int32_t>(vector, rows, result);
+    default:
+      return false;
+  }
+}
+
+template <typename T, typename TStored>
+bool VectorHasher::tryMapBiasedToRange(
+    const BiasVector<T>& vector,
+    const SelectivityVector& rows,
+    uint64_t* result) {
+  // The id of a value is its distance from 'min_' plus 1, which is the stored
+  // value plus 'offset'. A bias that is very far from the range is left to
+  // the general path so that the sum does not overflow.
+  constexpr int64_t kMaxOffset = 1LL << 62;
+  int64_t offset;
+  const int64_t bias = vector.bias();
+  if (__builtin_sub_overflow(bias, min_, &offset) || offset >= kMaxOffset ||
+      offset <= -kMaxOffset) {
+    return false;
+  }
+  ++offset;
+  const int64_t maxId = max_ - min_ + 1;
+  const auto* stored = vector.values()->template as<TStored>();
+  const auto* nulls = vector.rawNulls();
+  return rows.testSelected([&](vector_size_t row) INLINE_LAMBDA {
+    if (nulls && bits::isBitNull(nulls, row)) {
+      if (multiplier_ == 1) {
+        result[row] = 0;
+      }
+      return true;
+    }
+    const int64_t id = stored[row] + offset;
+    if (id < 1 || id > maxId) {
+      return false;
+    }
+    result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
+    return true;
+  });
+}
+
 bool VectorHasher::computeValueIds(
     const SelectivityVector& rows,
     raw_vector<uint64_t>& result) {
@@ -525,6 +680,44 @@ void VectorHasher::hash(
   VELOX_DYNAMIC_TYPE_DISPATCH(hashValues, typeKind_, rows, mix, result.data());
 }
 
+// static
+void VectorHasher::hash(
+    const std::vector<std::unique_ptr<VectorHasher>>& hashers,
+    const SelectivityVector& rows,
+    raw_vector<uint64_t>& result) {
+  for (auto& hasher : hashers) {
+    const auto& decoded = hasher->decoded_;
+    if (hasher->channel_ != kConstantChannel &&
+        !decoded.isIdentityMapping() && !decoded.isConstantMapping()) {
+      hasher->cachedHashes_.resize(decoded.base()->size());
+      std::fill(
+          hasher->cachedHashes_.begin(),
+          hasher->cachedHashes_.end(),
+          kNullHash);
+    }
+  }
+
+  const auto* rowBits = rows.asRange().bits();
+  for (auto begin = rows.begin(); begin < rows.end();
+       begin += kHashBlockSize) {
+    const auto end = std::min(begin + kHashBlockSize, rows.end());
+    const bool allSelected =
+        rows.isAllSelected() || bits::isAllSet(rowBits, begin, end);
+    for (auto i = 0; i < hashers.size(); ++i) {
+      auto& hasher = hashers[i];
+      VELOX_DYNAMIC_TYPE_DISPATCH(
+          hasher->hashBlock,
+          hasher->typeKind_,
+          rows,
+          begin,
+          end,
+          allSelected,
+          i > 0,
+          result.data());
+    }
+  }
+}
+
 void VectorHasher::hashPrecomputed(
     const SelectivityVector& rows,
     bool mix,
@@ -20,6 +20,7 @@
 #include <velox/type/Filter.h>
 #include "velox/common/base/RawVector.h"
 #include "velox/exec/Operator.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/VectorTypeUtils.h"
 
@@ -185,6 +186,19 @@ class VectorHasher {
   void
   hash(const SelectivityVector& rows, bool mix, raw_vector<uint64_t>& result);
 
+  // Computes the combined hash of all 'hashers' for 'rows' and stores it in
+  // 'result'. Gives the same result as calling hash(), or hashPrecomputed()
+  // for a hasher of kConstantChannel, for each hasher in order with 'mix'
+  // set for all but the first. The rows are hashed kHashBlockSize at a time
+  // for all the keys, so that 'result' for a block stays in cache while the
+  // keys are mixed into it. Flat keys without nulls are hashed in a tight
+  // loop over their values. The hashers for non-constant channels must be
+  // decoded.
+  static void hash(
+      const std::vector<std::unique_ptr<VectorHasher>>& hashers,
+      const SelectivityVector& rows,
+      raw_vector<uint64_t>& result);
+
   // Computes a hash for 'rows' using precomputedHash_ (just like from a const
   // vector) and stores it in 'result'.
   // If 'mix' is true, mixes the hash with existing value in 'result'.
@@ -349,6 +363,20 @@ class VectorHasher {
   template <typename T, bool mayHaveNulls>
   bool makeValueIdsDecoded(const SelectivityVector& rows, uint64_t* result);
 
+  // Maps the values of a BiasVector to ids in the range mode without adding
+  // the bias to each value. Returns false if a value is out of range.
+  template <typename T>
+  bool tryMapBiasedToRange(
+      const BiasVector<T>& vector,
+      const SelectivityVector& rows,
+      uint64_t* result);
+
+  template <typename T, typename TStored>
+  bool tryMapBiasedToRange(
+      const BiasVector<T>& vector,
+      const SelectivityVector& rows,
+      uint64_t* result);
+
   template <TypeKind Kind>
   bool makeValueIdsForRows(
       char** groups,
@@ -531,6 +559,22 @@ class VectorHasher {
   template <TypeKind Kind>
   void hashValues(const SelectivityVector& rows, bool mix, uint64_t* result);
 
+  // Number of rows for which the static hash() mixes all the keys before
+  // moving to the next rows.
+  static constexpr vector_size_t kHashBlockSize = 1024;
+
+  // Hashes the rows of 'rows' in ['begin', 'end') into 'result'.
+  // 'allSelected' is true if all the rows in the range are selected.
+  // 'cachedHashes_' must be initialized if 'decoded_' is a dictionary.
+  template <TypeKind Kind>
+  void hashBlock(
+      const SelectivityVector& rows,
+      vector_size_t begin,
+      vector_size_t end,
+      bool allSelected,
+      bool mix,
+      uint64_t* result);
+
   const column_index_t channel_;
   const TypePtr type_;
   const TypeKind typeKind_;
@@ -53,9 +53,14 @@ Window::Window(
           windowNode->id(),
           "Window"),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          pool())),
+      inputsSorted_(windowNode->inputsSorted()),
+      spillMemoryThreshold_(operatorCtx_->driverCtx()
+                                ->queryConfig()
+                                .windowSpillMemoryThreshold()),
+      spillConfig_(
+          windowNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kWindow)
+              : std::nullopt),
       decodedInputVectors_(numInputColumns_),
       stringAllocator_(pool()) {
   auto inputType = windowNode->sources()[0]->outputType();
@@ -71,9 +76,11 @@ Window::Window(
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
 
+  createRowContainer(inputType);
+
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(inputColumnToDataColumn_[i]));
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
@@ -84,7 +91,40 @@ Window::Window(
 
   createWindowFunctions(windowNode, inputType);
 
-  initRangeValuesMap();
+  initRangeIndex();
+}
+
+void Window::createRowContainer(const RowTypePtr& inputType) {
+  inputColumnToDataColumn_.assign(numInputColumns_, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+  column_index_t nextColumn = 0;
+  for (const auto& [channel, sortOrder] : allKeyInfo_) {
+    // A column could be both a partition and a sort key.
+    if (inputColumnToDataColumn_[channel] != kConstantChannel) {
+      continue;
+    }
+    inputColumnToDataColumn_[channel] = nextColumn++;
+    keyTypes.push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+    spillCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+  }
+
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (inputColumnToDataColumn_[channel] != kConstantChannel) {
+      continue;
+    }
+    inputColumnToDataColumn_[channel] = nextColumn++;
+    dependentTypes.push_back(inputType->childAt(channel));
+    names.push_back(inputType->nameOf(channel));
+  }
+
+  auto types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  spillType_ = ROW(std::move(names), std::move(types));
 }
 
 Window::WindowFrame Window::createWindowFrame(
@@ -161,41 +201,205 @@ void Window::createWindowFunctions(
   }
 }
 
-void Window::initRangeValuesMap() {
+void Window::initRangeIndex() {
   auto isKBoundFrame = [](core::WindowNode::BoundType boundType) -> bool {
     return boundType == core::WindowNode::BoundType::kPreceding ||
         boundType == core::WindowNode::BoundType::kFollowing;
   };
 
-  hasKRangeFrames_ = false;
   for (const auto& frame : windowFrames_) {
     if (frame.type == core::WindowNode::WindowType::kRange &&
         (isKBoundFrame(frame.startType) || isKBoundFrame(frame.endType))) {
-      hasKRangeFrames_ = true;
-      rangeValuesMap_.rangeType = outputType_->childAt(sortKeyInfo_[0].first);
-      rangeValuesMap_.rangeValues =
-          BaseVector::create(rangeValuesMap_.rangeType, 0, pool());
+      const auto& [channel, sortOrder] = sortKeyInfo_[0];
+      rangeIndex_ = RangeIndex{
+          data_->columnAt(inputColumnToDataColumn_[channel]),
+          sortOrder.isAscending()};
       break;
     }
   }
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
     decodedInputVectors_[col].decode(*input->childAt(col), inputRows_);
   }
 
+  const vector_size_t firstNewRow = sortedRows_.size();
+
   // Add all the rows into the RowContainer.
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
     for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+      data_->store(
+          decodedInputVectors_[col],
+          row,
+          newRow,
+          inputColumnToDataColumn_[col]);
+    }
+    if (inputsSorted_) {
+      // The input arrives in the output order so there is no need to sort.
+      sortedRows_.push_back(newRow);
     }
   }
   numRows_ += inputRows_.size();
+
+  if (inputsSorted_) {
+    updatePartitionStartRows(firstNewRow);
+    return;
+  }
+  updateSpillStats();
+}
+
+void Window::updatePartitionStartRows(vector_size_t firstNewRow) {
+  if (sortedRows_.empty()) {
+    return;
+  }
+  if (partitionStartRows_.empty()) {
+    partitionStartRows_.push_back(0);
+  }
+  for (auto i = std::max<vector_size_t>(1, firstNewRow); i < sortedRows_.size();
+       ++i) {
+    if (compareRowsWithKeys(
+            sortedRows_[i - 1], sortedRows_[i], partitionKeyInfo_)) {
+      partitionStartRows_.push_back(i);
+    }
+  }
+}
+
+void Window::eraseProcessedRows() {
+  VELOX_CHECK_EQ(numProcessedRows_, numCompleteRows());
+  if (numProcessedRows_ == 0) {
+    return;
+  }
+  data_->eraseRows(folly::Range<char**>(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  partitionStartRows_.clear();
+  partitionStartRows_.push_back(0);
+  currentPartition_ = 0;
+  numProcessedRows_ = 0;
+}
+
+void Window::updateSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if ((spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) ||
+      tracker->highUsage()) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.fileOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -209,7 +413,7 @@ inline bool Window::compareRowsWithKeys(
     if (auto result = data_->compare(
             lhs,
             rhs,
-            key.first,
+            inputColumnToDataColumn_[key.first],
             {key.second.isNullsFirst(), key.second.isAscending(), false})) {
       return result < 0;
     }
@@ -244,8 +448,8 @@ void Window::createPeerAndFrameBuffers() {
 }
 
 void Window::computePartitionStartRows() {
-  // Randomly assuming that max 10000 partitions are in the data.
-  partitionStartRows_.reserve(numRows_);
+  partitionStartRows_.clear();
+  partitionStartRows_.reserve(sortedRows_.size() + 1);
   auto partitionCompare = [&](const char* lhs, const char* rhs) -> bool {
     return compareRowsWithKeys(lhs, rhs, partitionKeyInfo_);
   };
@@ -298,42 +502,115 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (inputsSorted_) {
+    if (numProcessedRows_ == sortedRows_.size()) {
+      // All the rows have been output.
+      finished_ = true;
+      return;
+    }
+    // The last partition is complete now. Set the startRow of the (last + 1)
+    // partition to help for last partition related calculations.
+    partitionStartRows_.push_back(sortedRows_.size());
+    return;
+  }
+
+  createPeerAndFrameBuffers();
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows so that 'data_' only holds the partitions
+    // loaded back from the merged spill runs. There is only one spill
+    // partition for window, so there are no rows from non-spilled partitions.
+    spill(0, 0);
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    VELOX_CHECK_EQ(data_->numRows(), 0);
+    updateSpillStats();
+    spillMerge_ = spiller_->startMerge(0);
+    nextSpillStream_ = spillMerge_->next();
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
   // separated into partitions and sort by ORDER BY keys within
   // the partition. This will order the rows for getOutput().
   sortPartitions();
-  createPeerAndFrameBuffers();
 }
 
-void Window::computeRangeValuesMap() {
-  auto peerCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithKeys(lhs, rhs, sortKeyInfo_);
-  };
-  auto firstPartitionRow = partitionStartRows_[currentPartition_];
-  auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
-  auto numRows = lastPartitionRow - firstPartitionRow + 1;
-  rangeValuesMap_.rangeValues->resize(numRows);
-  rangeValuesMap_.rowIndices.resize(numRows);
+bool Window::isNewPartition(SpillMergeStream* stream, const char* row) {
+  const auto index = stream->currentIndex();
+  for (const auto& key : partitionKeyInfo_) {
+    const auto column = inputColumnToDataColumn_[key.first];
+    if (data_->compare(
+            row,
+            data_->columnAt(column),
+            stream->decoded(column),
+            index,
+            {key.second.isNullsFirst(), key.second.isAscending(), false}) !=
+        0) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  rangeValuesMap_.rowIndices[0] = 0;
-  int j = 1;
-  for (auto i = firstPartitionRow + 1; i <= lastPartitionRow; i++) {
-    // Here, we removed the below check code, in order to keep raw values.
-    // if (peerCompare(sortedRows_[i - 1], sortedRows_[i])) {
-    // The order by values are extracted from the Window partition which
-    // starts from row number 0 for the firstPartitionRow. So the index
-    // requires adjustment.
-    rangeValuesMap_.rowIndices[j++] = i - firstPartitionRow;
-    // }
+bool Window::loadSpilledPartitions() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  data_->clear();
+  sortedRows_.clear();
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+
+  while (nextSpillStream_ != nullptr) {
+    auto* stream = nextSpillStream_;
+    if (sortedRows_.size() >= numRowsPerOutput_ &&
+        isNewPartition(stream, sortedRows_.back())) {
+      // Keep the first row of the next partition in 'stream' for the next
+      // load.
+      break;
+    }
+
+    const auto index = stream->currentIndex();
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < spillType_->size(); ++col) {
+      data_->store(stream->decoded(col), index, newRow, col);
+    }
+    sortedRows_.push_back(newRow);
+
+    stream->pop();
+    nextSpillStream_ = spillMerge_->next();
   }
 
-  // If sort key is desc then reverse the rowIndices so that the range values
-  // are guaranteed ascending for the further lookup logic.
-  auto valueIndexesRange = folly::Range(rangeValuesMap_.rowIndices.data(), j);
-  windowPartition_->extractColumn(
-      sortKeyInfo_[0].first, valueIndexesRange, 0, rangeValuesMap_.rangeValues);
+  if (sortedRows_.empty()) {
+    return false;
+  }
+  computePartitionStartRows();
+  return true;
+}
+
+void Window::computeRangeIndex() {
+  const auto firstPartitionRow = partitionStartRows_[currentPartition_];
+  const auto numRows =
+      partitionStartRows_[currentPartition_ + 1] - firstPartitionRow;
+  const auto* begin = sortedRows_.data() + firstPartitionRow;
+  const auto* end = begin + numRows;
+
+  // The null rows are sorted either before or after all the non-null rows.
+  const auto& column = rangeIndex_->column;
+  auto isNull = [&](const char* row) {
+    return RowContainer::isNullAt(row, column.nullByte(), column.nullMask());
+  };
+  if (sortKeyInfo_[0].second.isNullsFirst()) {
+    rangeIndex_->nonNullBegin = std::partition_point(begin, end, isNull) - begin;
+    rangeIndex_->nonNullEnd = numRows;
+  } else {
+    rangeIndex_->nonNullBegin = 0;
+    rangeIndex_->nonNullEnd =
+        std::partition_point(
+            begin, end, [&](const char* row) { return !isNull(row); }) -
+        begin;
+  }
 }
 
 void Window::callResetPartition(vector_size_t partitionNumber) {
@@ -347,8 +624,8 @@ void Window::callResetPartition(vector_size_t partitionNumber) {
     windowFunctions_[i]->resetPartition(windowPartition_.get());
   }
 
-  if (hasKRangeFrames_) {
-    computeRangeValuesMap();
+  if (rangeIndex_.has_value()) {
+    computeRangeIndex();
   }
 }
 
@@ -401,73 +678,40 @@ void Window::updateKRowsFrameBounds(
 namespace {
 
 template <typename T>
-vector_size_t findIndex(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    const FlatVectorPtr<T>& values,
-    bool findStart) {
-  vector_size_t originalRightBound = rightBound;
-  vector_size_t originalLeftBound = leftBound;
-  while (leftBound < rightBound) {
-    vector_size_t mid = round((leftBound + rightBound) / 2.0);
-    auto midValue = values->valueAt(mid);
-    if (value == midValue) {
-      return mid;
-    }
-
-    if (value < midValue) {
-      rightBound = mid - 1;
-    } else {
-      leftBound = mid + 1;
-    }
-  }
+inline int128_t toRangeValue(T value) {
+  return value;
+}
 
-  // The value is not found but leftBound == rightBound at this point.
-  // This could be a value which is the least number greater than
-  // or the largest number less than value.
-  // The semantics of this function are to always return the smallest larger
-  // value (or rightBound if end of range).
-  if (findStart) {
-    if (value <= values->valueAt(rightBound)) {
-      // return std::max(originalLeftBound, rightBound);
-      return rightBound;
-    }
-    return std::min(originalRightBound, rightBound + 1);
-  }
-  if (value < values->valueAt(rightBound)) {
-    return std::max(originalLeftBound, rightBound - 1);
-  }
-  // std::max(originalLeftBound, rightBound)?
-  return std::min(originalRightBound, rightBound);
+template <>
+inline int128_t toRangeValue(Date value) {
+  return value.days();
 }
 
 } // namespace
 
-// TODO: unify into one function.
-template <typename T>
-inline vector_size_t Window::kRangeStartBoundSearch(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    const FlatVectorPtr<T>& valuesVector,
-    const vector_size_t* rawPeerStarts) {
-  auto index = findIndex<T>(value, leftBound, rightBound, valuesVector, true);
-  // Since this is a kPreceding bound it includes the row at the index.
-  return rangeValuesMap_.rowIndices[rawPeerStarts[index]];
-}
-
-// TODO: lastRightBoundRow looks useless.
 template <typename T>
-vector_size_t Window::kRangeEndBoundSearch(
-    const T value,
-    vector_size_t leftBound,
-    vector_size_t rightBound,
-    vector_size_t lastRightBoundRow,
-    const FlatVectorPtr<T>& valuesVector,
-    const vector_size_t* rawPeerEnds) {
-  auto index = findIndex<T>(value, leftBound, rightBound, valuesVector, false);
-  return rangeValuesMap_.rowIndices[rawPeerEnds[index]];
+vector_size_t Window::kRangeBoundSearch(
+    int128_t target,
+    bool isStartBound,
+    const char* const* partitionRows) const {
+  const auto offset = rangeIndex_->column.offset();
+  const auto isAscending = rangeIndex_->isAscending;
+  // Returns true if 'row' is before the rows in the frame bound.
+  auto isBefore = [&](const char* row) {
+    const auto value =
+        toRangeValue(*reinterpret_cast<const T*>(row + offset));
+    if (isStartBound) {
+      return isAscending ? value < target : value > target;
+    }
+    return isAscending ? value <= target : value >= target;
+  };
+
+  const auto* begin = partitionRows + rangeIndex_->nonNullBegin;
+  const auto* end = partitionRows + rangeIndex_->nonNullEnd;
+  const vector_size_t index =
+      std::partition_point(begin, end, isBefore) - partitionRows;
+  // The end bound is the last row before the first row after 'target'.
+  return isStartBound ? index : index - 1;
 }
 
 template <TypeKind T>
@@ -480,81 +724,45 @@ void Window::updateKRangeFrameBounds(
     const vector_size_t* rawPeerStarts,
     const vector_size_t* rawPeerEnds) {
   using NativeType = typename TypeTraits<T>::NativeType;
-  // Extract the order by key column to calculate the range values for the frame
-  // boundaries.
-  std::shared_ptr<const Type> sortKeyType =
-      outputType_->childAt(sortKeyInfo_[0].first);
-  auto orderByValues = BaseVector::create(sortKeyType, numRows, pool());
-  windowPartition_->extractColumn(
-      sortKeyInfo_[0].first, partitionOffset_, numRows, 0, orderByValues);
-  auto* rangeValuesFlatVector = orderByValues->asFlatVector<NativeType>();
-  auto* rawRangeValues = rangeValuesFlatVector->mutableRawValues();
 
-  if (frameArg.index == kConstantChannel) {
-    auto constantOffset = frameArg.constant.value();
-    constantOffset = isKPreceding ? -constantOffset : constantOffset;
-    for (int i = 0; i < numRows; i++) {
-      rawRangeValues[i] = rangeValuesFlatVector->valueAt(i) + constantOffset;
-    }
-  } else {
+  const int64_t* offsets = nullptr;
+  if (frameArg.index != kConstantChannel) {
     windowPartition_->extractColumn(
         frameArg.index, partitionOffset_, numRows, 0, frameArg.value);
-    auto offsets = frameArg.value->values()->as<int64_t>();
+    offsets = frameArg.value->values()->as<int64_t>();
     for (auto i = 0; i < numRows; i++) {
       VELOX_USER_CHECK(
           !frameArg.value->isNullAt(i), "k in frame bounds cannot be null");
       VELOX_USER_CHECK_GE(
           offsets[i], 1, "k in frame bounds must be at least 1");
     }
-
-    auto precedingFactor = isKPreceding ? -1 : 1;
-    for (auto i = 0; i < numRows; i++) {
-      rawRangeValues[i] = rangeValuesFlatVector->valueAt(i) +
-          vector_size_t(precedingFactor * offsets[i]);
-    }
   }
 
-  // Set the frame bounds from looking up the rangeValues index.
-  auto leftBound = 0;
-  auto rightBound = rangeValuesMap_.rowIndices.size() - 1;
-  auto lastPartitionRow = partitionStartRows_[currentPartition_ + 1] - 1;
-  auto rangeIndexValues = std::dynamic_pointer_cast<FlatVector<NativeType>>(
-      rangeValuesMap_.rangeValues);
-  if (isStartBound) {
-    for (auto i = 0; i < numRows; i++) {
-      // Handle null.
-      // Different with duckDB result. May need to separate the handling for
-      // spark & presto.
-      if (rangeValuesFlatVector->mayHaveNulls() &&
-          rangeValuesFlatVector->isNullAt(i)) {
-        rawFrameBounds[i] = i;
-        continue;
-      }
-      rawFrameBounds[i] = kRangeStartBoundSearch<NativeType>(
-          rawRangeValues[i],
-          leftBound,
-          rightBound,
-          rangeIndexValues,
-          rawPeerStarts);
-    }
-  } else {
-    for (auto i = 0; i < numRows; i++) {
-      // Handle null.
-      // Different with duckDB result. May need to separate the handling for
-      // spark & presto.
-      if (rangeValuesFlatVector->mayHaveNulls() &&
-          rangeValuesFlatVector->isNullAt(i)) {
-        rawFrameBounds[i] = i;
-        continue;
-      }
-      rawFrameBounds[i] = kRangeEndBoundSearch<NativeType>(
-          rawRangeValues[i],
-          leftBound,
-          rightBound,
-          lastPartitionRow,
-          rangeIndexValues,
-          rawPeerEnds);
+  // Preceding rows have smaller values in ascending order and larger values
+  // in descending order.
+  const int precedingFactor =
+      isKPreceding == rangeIndex_->isAscending ? -1 : 1;
+  const auto& column = rangeIndex_->column;
+  const auto* partitionRows =
+      sortedRows_.data() + partitionStartRows_[currentPartition_];
+  for (auto i = 0; i < numRows; i++) {
+    const auto* row = partitionRows[partitionOffset_ + i];
+    // The frame of a row with a null ORDER BY value is its peer rows, i.e.
+    // all the null rows of the partition.
+    if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+      rawFrameBounds[i] = isStartBound ? rawPeerStarts[i] : rawPeerEnds[i];
+      continue;
     }
+
+    const int64_t offset =
+        offsets ? offsets[i] : frameArg.constant.value();
+    // The frame values are computed in 128 bits so that they don't overflow.
+    const int128_t target =
+        toRangeValue(*reinterpret_cast<const NativeType*>(
+            row + column.offset())) +
+        precedingFactor * static_cast<int128_t>(offset);
+    rawFrameBounds[i] =
+        kRangeBoundSearch<NativeType>(target, isStartBound, partitionRows);
   }
 }
 
@@ -866,13 +1074,7 @@ void Window::callApplyLoop(
   }
 }
 
-RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
-    return nullptr;
-  }
-
-  auto numRowsLeft = numRows_ - numProcessedRows_;
-  auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
+RowVectorPtr Window::createOutput(vector_size_t numOutputRows) {
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
@@ -881,7 +1083,7 @@ RowVectorPtr Window::getOutput() {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
+        inputColumnToDataColumn_[i],
         result->childAt(i));
   }
 
@@ -900,8 +1102,62 @@ RowVectorPtr Window::getOutput() {
   for (int j = numInputColumns_; j < outputType_->size(); j++) {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
+  return result;
+}
+
+RowVectorPtr Window::getStreamingOutput() {
+  if (finished_) {
+    return nullptr;
+  }
+
+  const auto numCompleteRows = this->numCompleteRows();
+  if (numProcessedRows_ == numCompleteRows) {
+    // Waiting for the current partition to complete.
+    return nullptr;
+  }
+
+  if (peerStartBuffer_ == nullptr) {
+    createPeerAndFrameBuffers();
+  }
+
+  const auto numOutputRows =
+      std::min(numRowsPerOutput_, numCompleteRows - numProcessedRows_);
+  auto result = createOutput(numOutputRows);
+
+  if (noMoreInput_) {
+    finished_ = (numProcessedRows_ == sortedRows_.size());
+  } else if (numProcessedRows_ == numCompleteRows) {
+    // All the complete partitions have been output. Free their rows so
+    // that only the current partition remains resident.
+    eraseProcessedRows();
+  }
+  return result;
+}
+
+RowVectorPtr Window::getOutput() {
+  if (inputsSorted_) {
+    return getStreamingOutput();
+  }
+
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (spillMerge_ != nullptr && numProcessedRows_ == sortedRows_.size()) {
+    if (!loadSpilledPartitions()) {
+      finished_ = true;
+      return nullptr;
+    }
+  }
+
+  vector_size_t numRowsLeft = sortedRows_.size() - numProcessedRows_;
+  auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
+  auto result = createOutput(numOutputRows);
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  finished_ = spillMerge_ == nullptr
+      ? (numProcessedRows_ == sortedRows_.size())
+      : (numProcessedRows_ == sortedRows_.size() &&
+         nextSpillStream_ == nullptr);
   return result;
 }
 
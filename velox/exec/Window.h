@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -32,6 +33,18 @@ namespace facebook::velox::exec {
 /// It is also sorted in the order required for the WindowFunction
 /// to process it.
 ///
+/// If the input is already sorted on (partition_by keys + order_by keys), the
+/// operator runs in a streaming mode instead: there is no sorting, and each
+/// partition is output as soon as the first row of the next partition is
+/// received. Only the rows of the partitions that have not been output yet
+/// are kept in memory.
+///
+/// If spilling is enabled, the input rows are spilled as sorted runs on
+/// (partition_by keys + order_by keys) when the operator runs out of memory.
+/// The sorted runs are merged back after receiving all the input, and only
+/// the partitions needed for the next output batch are loaded back into
+/// memory at a time.
+///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
 class Window : public Operator {
@@ -46,6 +59,10 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
+    if (inputsSorted_) {
+      // Output the complete partitions before accepting more input.
+      return !noMoreInput_ && numProcessedRows_ == numCompleteRows();
+    }
     return !noMoreInput_;
   }
 
@@ -80,14 +97,66 @@ class Window : public Operator {
     const std::optional<FrameChannelArg> end;
   };
 
+  // Returns the number of leading rows in 'sortedRows_' which belong to
+  // complete partitions and are ready for output in streaming mode. The rows
+  // of the last partition are complete only after all the input is received.
+  vector_size_t numCompleteRows() const {
+    return partitionStartRows_.empty() ? 0 : partitionStartRows_.back();
+  }
+
+  // Adds the rows stored in 'sortedRows_' from 'firstNewRow' to the partition
+  // boundaries in 'partitionStartRows_' in streaming mode.
+  void updatePartitionStartRows(vector_size_t firstNewRow);
+
+  // Frees the rows of the partitions that have been output in streaming mode,
+  // and moves the rows of the incomplete partition to the front of
+  // 'sortedRows_'.
+  void eraseProcessedRows();
+
+  // Sets up the RowContainer that stores the input rows. The distinct
+  // partition and sort key columns are stored first in the container so that
+  // the rows can be spilled as runs sorted on those keys.
+  void createRowContainer(const RowTypePtr& inputType);
+
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills enough to
+  // make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left. If 'targetRows' is 0, spills everything and physically
+  // frees the data in the 'data_'.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Copies the spill stats from 'spiller_' into the operator stats.
+  void updateSpillStats();
+
+  // Loads the next set of window partitions from the merged spill runs
+  // into 'data_'. Whole partitions are loaded until there are at least
+  // 'numRowsPerOutput_' rows or the spilled data is exhausted. Returns false
+  // if there is no more spilled data.
+  bool loadSpilledPartitions();
+
+  // Returns true if the current row of 'stream' belongs to a different
+  // partition than 'row' in 'data_'.
+  bool isNewPartition(SpillMergeStream* stream, const char* row);
+
+  // Creates the output vector for the next 'numOutputRows' rows in
+  // 'sortedRows_' and computes the window function values for them.
+  RowVectorPtr createOutput(vector_size_t numOutputRows);
+
+  // Implements getOutput() in streaming mode. Outputs the rows of the
+  // complete partitions received so far.
+  RowVectorPtr getStreamingOutput();
+
   // Helper function to create WindowFunction and frame objects
   // for this operator.
   void createWindowFunctions(
       const std::shared_ptr<const core::WindowNode>& windowNode,
       const RowTypePtr& inputType);
 
-  // Helper function to initialize range values map for k Range frames.
-  void initRangeValuesMap();
+  // Helper function to initialize 'rangeIndex_' for k Range frames.
+  void initRangeIndex();
 
   // Helper function to create the buffers for peer and frame
   // row indices to send in window function apply invocations.
@@ -113,10 +182,9 @@ class Window : public Operator {
   // all WindowFunctions.
   void callResetPartition(vector_size_t partitionNumber);
 
-  // For k Range frames an auxiliary structure used to look up the index
-  // of frame values is required. This function computes that structure for
-  // each partition of rows.
-  void computeRangeValuesMap();
+  // Finds the rows with non-null ORDER BY values in the current partition
+  // for the k Range frame bound searches.
+  void computeRangeIndex();
 
   // Helper method to call WindowFunction::apply to all the rows
   // of a partition between startRow and endRow. The outputs
@@ -176,31 +244,61 @@ class Window : public Operator {
       const vector_size_t* rawPeerEnds,
       vector_size_t* rawFrameBounds);
 
+  // Returns the frame bound for a k Range frame with ORDER BY value
+  // 'target' in the current partition. This is the first row with a value
+  // not before 'target' in sort order for a start bound, and the last row
+  // with a value not after 'target' for an end bound. 'partitionRows' are the
+  // rows of the current partition.
   template <typename T>
-  vector_size_t kRangeStartBoundSearch(
-      const T value,
-      vector_size_t leftBound,
-      vector_size_t rightBound,
-      const FlatVectorPtr<T>& valuesVector,
-      const vector_size_t* rawPeerStarts);
-
-  template <typename T>
-  vector_size_t kRangeEndBoundSearch(
-      const T value,
-      vector_size_t leftBound,
-      vector_size_t rightBound,
-      vector_size_t lastRightBoundRow,
-      const FlatVectorPtr<T>& valuesVector,
-      const vector_size_t* rawPeerEnds);
+  vector_size_t kRangeBoundSearch(
+      int128_t target,
+      bool isStartBound,
+      const char* const* partitionRows) const;
 
   bool finished_ = false;
   const vector_size_t numInputColumns_;
 
+  // True if the input is sorted on the partition and sort keys.
+  const bool inputsSorted_;
+
+  // The maximum memory usage that a window can hold before spilling.
+  // If it is zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
   // we store the rows in the RowContainer (data_).
   std::unique_ptr<RowContainer> data_;
 
+  // The column index in 'data_' of each input column. The distinct partition
+  // and sort key columns are stored first in 'data_', followed by the rest
+  // of the input columns.
+  std::vector<column_index_t> inputColumnToDataColumn_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
+  // The compare flags of the key columns in 'data_' used to sort the spilled
+  // runs on.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // The merge stream whose current row starts the next set of partitions to
+  // load by loadSpilledPartitions(). The row is not popped off the stream
+  // until it is loaded.
+  SpillMergeStream* nextSpillStream_{nullptr};
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
@@ -251,7 +349,8 @@ class Window : public Operator {
   // This is a vector that gives the index of the start row
   // (in sortedRows_) of each partition in the RowContainer data_.
   // This auxiliary structure helps demarcate partitions in
-  // getOutput calls.
+  // getOutput calls. In streaming mode, the last entry is the start of
+  // the partition still receiving input until noMoreInput() is called.
   std::vector<vector_size_t> partitionStartRows_;
 
   // The following 4 Buffers are used to pass peer and frame start and
@@ -278,26 +377,26 @@ class Window : public Operator {
   // There is one SelectivityVector per window function.
   std::vector<SelectivityVector> validFrames_;
 
-  // When computing k Range frames, the range value for the frame index needs
-  // to be mapped to the partition row for the value.
-  // This is an auxiliary structure to materialize a mapping from
-  // range value -> row index (in RowContainer) for that purpose.
-  // It uses a vector of the ordered range values and another vector of the
-  // corresponding row indices. Ideally a binary search
-  // tree or B-tree index (especially if the data is spilled to disk) should be
-  // used.
-  struct RangeValuesMap {
-    TypePtr rangeType;
-    // The range values appear in sorted order in this vector.
-    VectorPtr rangeValues;
-    // TODO (Make this a BufferPtr so that it can be allocated in the
-    // MemoryPool) ?
-    std::vector<vector_size_t> rowIndices;
+  // When computing k Range frames, the frame bounds are the first and last
+  // partition rows with ORDER BY values in the range of the frame. The rows of
+  // a partition are sorted on the ORDER BY key, so these are found by binary
+  // searching the partition rows in 'data_' in O(log n). This works the same
+  // for partitions read back from spilled data, and needs no memory besides
+  // the rows. Rows with null ORDER BY values are grouped at one end of the
+  // partition and are excluded from the searches.
+  struct RangeIndex {
+    // The ORDER BY column in 'data_'.
+    RowColumn column;
+    bool isAscending;
+    // The rows with non-null ORDER BY values in the current partition are
+    // [nonNullBegin, nonNullEnd). The indices are relative to the partition
+    // start.
+    vector_size_t nonNullBegin{0};
+    vector_size_t nonNullEnd{0};
   };
-  RangeValuesMap rangeValuesMap_;
 
-  // The above mapping is built only if required for k range frames.
-  bool hasKRangeFrames_;
+  // Set only if there are k Range frames.
+  std::optional<RangeIndex> rangeIndex_;
 
   // Number of rows output from the WindowOperator so far. The rows
   // are output in the same order of the pointers in sortedRows. This
@@ -28,6 +28,10 @@
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
 DEFINE_int32(width, 16, "Number of parties in shuffle");
+DEFINE_bool(
+    inline_resume,
+    false,
+    "Run Drivers unblocked by exchange data on the producing thread");
 
 /// Benchmarks repartition/exchange with different batch sizes,
 /// numbers of destinations and data type mixes.  Generates a plan
@@ -148,6 +152,8 @@ class ExchangeBenchmark : public VectorTestBase {
       int destination,
       Consumer consumer = nullptr,
       int64_t maxMemory = kMaxMemory) {
+    configSettings_[core::QueryConfig::kInlineDriverResumeEnabled] =
+        FLAGS_inline_resume ? "true" : "false";
     auto queryCtx = std::make_shared<core::QueryCtx>(
         executor_.get(), std::make_shared<core::MemConfig>(configSettings_));
     queryCtx->testingOverrideMemoryPool(
@@ -0,0 +1,525 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+
+#include <fstream>
+#include <random>
+#include <regex>
+#include <thread>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/HashTable.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/lib/ZetaDistribution.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_string(
+    num_keys,
+    "10000,1000000",
+    "Comma separated numbers of distinct build side keys. The build side has "
+    "one row per key");
+DEFINE_int32(
+    probe_ratio,
+    10,
+    "Number of probe rows per build row. The aggregation groups the probe "
+    "rows");
+DEFINE_string(
+    key_types,
+    "bigint,varchar,multi",
+    "Comma separated key types. 'multi' is a bigint and a varchar key");
+DEFINE_string(
+    key_domains,
+    "dense,sparse",
+    "Comma separated key domains. 'dense' keys are consecutive integers, "
+    "which allows array and normalized key hash modes. 'sparse' keys are "
+    "spread over the 64 bit range, which needs the hash mode");
+DEFINE_string(
+    distributions,
+    "uniform,zipf",
+    "Comma separated distributions of the probe keys");
+DEFINE_double(zipf_s, 1.2, "Exponent of the Zipf distribution");
+DEFINE_string(
+    spill_ratios,
+    "0,0.1",
+    "Comma separated ratios of the memory limit of the hash table to its "
+    "unconstrained peak memory. 0 means no limit, 0.1 that the data is 10x "
+    "the memory the join or aggregation may use before spilling");
+DEFINE_string(queries, "join,aggregation", "Comma separated queries to run");
+DEFINE_int32(num_drivers, 4, "Number of drivers of each pipeline");
+DEFINE_int32(batch_size, 10'000, "Number of rows in each input batch");
+DEFINE_int32(num_repeats, 3, "Number of runs of each case. Reports the best");
+DEFINE_int32(seed, 1, "Seed of the data generation");
+DEFINE_string(
+    filter,
+    "",
+    "If set, only runs the cases whose name matches this regex");
+DEFINE_string(
+    json_output,
+    "",
+    "If set, writes the results of all cases as JSON to this file");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+namespace {
+
+struct Case {
+  std::string query;
+  int64_t numKeys;
+  std::string keyType;
+  std::string keyDomain;
+  std::string distribution;
+  double spillRatio;
+
+  std::string dataName() const {
+    return fmt::format(
+        "{}_{}_{}_{}", numKeys, keyType, keyDomain, distribution);
+  }
+
+  std::string name() const {
+    return fmt::format(
+        "{}_{}_spill{}",
+        query,
+        dataName(),
+        static_cast<int32_t>(spillRatio * 100));
+  }
+};
+
+/// Time and memory of one operator of a query.
+struct PhaseStats {
+  uint64_t wallNanos{0};
+  uint64_t cpuNanos{0};
+  uint64_t peakMemoryBytes{0};
+  uint64_t spilledBytes{0};
+  uint32_t spilledPartitions{0};
+
+  static PhaseStats from(const PlanNodeStats& stats) {
+    PhaseStats phase;
+    phase.wallNanos = stats.cpuWallTiming.wallNanos;
+    phase.cpuNanos = stats.cpuWallTiming.cpuNanos;
+    phase.peakMemoryBytes = stats.peakMemoryBytes;
+    phase.spilledBytes = stats.spilledBytes;
+    phase.spilledPartitions = stats.spilledPartitions;
+    return phase;
+  }
+
+  folly::dynamic toJson() const {
+    folly::dynamic json = folly::dynamic::object;
+    json["wallNanos"] = wallNanos;
+    json["cpuNanos"] = cpuNanos;
+    json["peakMemoryBytes"] = peakMemoryBytes;
+    json["spilledBytes"] = spilledBytes;
+    json["spilledPartitions"] = spilledPartitions;
+    return json;
+  }
+};
+
+struct Result {
+  uint64_t micros{0};
+  uint64_t numInputRows{0};
+  uint64_t numOutputRows{0};
+  // HashBuild and HashProbe for join, Aggregation for aggregation.
+  std::map<std::string, PhaseStats> phases;
+  // The hash mode of the join table, if known.
+  std::string hashMode;
+
+  uint64_t peakMemoryBytes() const {
+    uint64_t peak = 0;
+    for (const auto& [_, phase] : phases) {
+      peak = std::max(peak, phase.peakMemoryBytes);
+    }
+    return peak;
+  }
+
+  uint64_t spilledBytes() const {
+    uint64_t bytes = 0;
+    for (const auto& [_, phase] : phases) {
+      bytes += phase.spilledBytes;
+    }
+    return bytes;
+  }
+};
+
+std::vector<std::string> splitFlag(const std::string& flag) {
+  std::vector<std::string> values;
+  folly::split(',', flag, values, true);
+  return values;
+}
+
+/// Runs hash joins and hash aggregations over generated keys through
+/// PlanBuilder and AssertQueryBuilder. Each case builds on one row per key and
+/// probes, or groups, 'probe_ratio' rows per key drawn from a uniform or Zipf
+/// distribution, so that a skewed probe side hits a few hot keys most of the
+/// time.
+class HashJoinAggregationBenchmark : public VectorTestBase {
+ public:
+  HashJoinAggregationBenchmark()
+      : executor_(std::make_unique<folly::CPUThreadPoolExecutor>(
+            std::thread::hardware_concurrency())) {}
+
+  Result run(const Case& testCase) {
+    if (testCase.dataName() != dataName_) {
+      makeData(testCase);
+    }
+    auto plan = makePlan(testCase);
+
+    // Runs once without a memory limit to size the limit of spilling cases.
+    uint64_t spillThreshold = 0;
+    if (testCase.spillRatio > 0) {
+      auto unconstrained = runOnce(testCase, plan, 0);
+      spillThreshold = std::max<uint64_t>(
+          1, unconstrained.peakMemoryBytes() * testCase.spillRatio);
+    }
+
+    Result best;
+    for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+      auto result = runOnce(testCase, plan, spillThreshold);
+      if (repeat == 0 || result.micros < best.micros) {
+        best = std::move(result);
+      }
+    }
+    return best;
+  }
+
+ private:
+  // Returns the key at 'rank', 0 being the most frequent key of a skewed
+  // distribution.
+  static int64_t keyAt(int64_t rank, const std::string& keyDomain) {
+    if (keyDomain == "dense") {
+      return rank;
+    }
+    // Odd multiplier, so that different ranks get different keys.
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(rank) * 0x9E3779B97F4A7C15UL);
+  }
+
+  // Makes the key columns for 'keys'. 'multi' splits each key into a bigint
+  // and a varchar column.
+  std::vector<VectorPtr> makeKeys(
+      const std::vector<int64_t>& keys,
+      const std::string& keyType) {
+    const vector_size_t size = keys.size();
+    if (keyType == "bigint") {
+      return {makeFlatVector<int64_t>(
+          size, [&](auto row) { return keys[row]; })};
+    }
+    if (keyType == "varchar") {
+      return {makeFlatVector<std::string>(size, [&](auto row) {
+        return fmt::format("key-{:016x}", keys[row]);
+      })};
+    }
+    VELOX_USER_CHECK_EQ(keyType, "multi", "Unknown key type");
+    return {
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return keys[row] & 1023; }),
+        makeFlatVector<std::string>(size, [&](auto row) {
+          return fmt::format("key-{:016x}", keys[row] >> 10);
+        })};
+  }
+
+  // Makes batches of 'keys' with columns '<prefix>k0', ..., and a bigint
+  // payload '<prefix>v'.
+  std::vector<RowVectorPtr> makeBatches(
+      const std::vector<int64_t>& keys,
+      const std::string& keyType,
+      const std::string& prefix) {
+    std::vector<RowVectorPtr> batches;
+    for (size_t start = 0; start < keys.size(); start += FLAGS_batch_size) {
+      const auto end =
+          std::min<size_t>(start + FLAGS_batch_size, keys.size());
+      std::vector<int64_t> batchKeys(keys.begin() + start, keys.begin() + end);
+      auto children = makeKeys(batchKeys, keyType);
+      std::vector<std::string> names;
+      for (auto i = 0; i < children.size(); ++i) {
+        names.push_back(fmt::format("{}k{}", prefix, i));
+      }
+      names.push_back(prefix + "v");
+      children.push_back(makeFlatVector<int64_t>(
+          batchKeys.size(), [&](auto row) { return start + row; }));
+      batches.push_back(makeRowVector(names, children));
+    }
+    return batches;
+  }
+
+  void makeData(const Case& testCase) {
+    const auto numKeys = testCase.numKeys;
+    std::vector<int64_t> buildKeys(numKeys);
+    for (auto i = 0; i < numKeys; ++i) {
+      buildKeys[i] = keyAt(i, testCase.keyDomain);
+    }
+    // The build side is not sorted on the key.
+    std::mt19937 rng(FLAGS_seed);
+    std::shuffle(buildKeys.begin(), buildKeys.end(), rng);
+
+    // Half of the uniform probe keys miss. The skewed ones mostly hit.
+    const int64_t numProbeKeys = 2 * numKeys;
+    std::vector<int64_t> probeKeys(numKeys * FLAGS_probe_ratio);
+    if (testCase.distribution == "zipf") {
+      VELOX_CHECK_LE(numProbeKeys, std::numeric_limits<int32_t>::max());
+      functions::ZetaDistribution zipf(FLAGS_zipf_s, numProbeKeys);
+      for (auto& key : probeKeys) {
+        key = keyAt(zipf(rng) - 1, testCase.keyDomain);
+      }
+    } else {
+      VELOX_USER_CHECK_EQ(
+          testCase.distribution, "uniform", "Unknown distribution");
+      std::uniform_int_distribution<int64_t> uniform(0, numProbeKeys - 1);
+      for (auto& key : probeKeys) {
+        key = keyAt(uniform(rng), testCase.keyDomain);
+      }
+    }
+
+    build_ = makeBatches(buildKeys, testCase.keyType, "b_");
+    probe_ = makeBatches(probeKeys, testCase.keyType, "p_");
+    dataName_ = testCase.dataName();
+  }
+
+  static std::vector<std::string> keyNames(
+      const RowVectorPtr& batch,
+      const std::string& prefix) {
+    std::vector<std::string> names;
+    for (const auto& name : asRowType(batch->type())->names()) {
+      if (name != prefix + "v") {
+        names.push_back(name);
+      }
+    }
+    return names;
+  }
+
+  // Returns the plan of 'testCase'. The inputs are spread over the drivers
+  // round robin. The plan ends in a count per driver, so that the time to
+  // collect the results does not count.
+  core::PlanNodePtr makePlan(const Case& testCase) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    const auto probeKeys = keyNames(probe_[0], "p_");
+    if (testCase.query == "join") {
+      auto build = PlanBuilder(planNodeIdGenerator)
+                       .values(build_)
+                       .localPartitionRoundRobin()
+                       .planNode();
+      return PlanBuilder(planNodeIdGenerator)
+          .values(probe_)
+          .localPartitionRoundRobin()
+          .hashJoin(
+              probeKeys, keyNames(build_[0], "b_"), build, "", {"p_v", "b_v"})
+          .capturePlanNodeId(nodeId_)
+          .partialAggregation({}, {"count(1)"})
+          .planNode();
+    }
+    VELOX_USER_CHECK_EQ(testCase.query, "aggregation", "Unknown query");
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probe_)
+        .localPartition(probeKeys)
+        .singleAggregation(probeKeys, {"sum(p_v)", "count(1)"})
+        .capturePlanNodeId(nodeId_)
+        .partialAggregation({}, {"count(1)"})
+        .planNode();
+  }
+
+  // Runs 'plan' once. Spills if 'spillThreshold' is not 0 and the join or
+  // aggregation uses more memory than 'spillThreshold'.
+  Result runOnce(
+      const Case& testCase,
+      const core::PlanNodePtr& plan,
+      uint64_t spillThreshold) {
+    AssertQueryBuilder builder(plan);
+    builder.maxDrivers(FLAGS_num_drivers)
+        .queryCtx(std::make_shared<core::QueryCtx>(executor_.get()));
+    std::shared_ptr<TempDirectoryPath> spillDirectory;
+    if (spillThreshold > 0) {
+      spillDirectory = TempDirectoryPath::create();
+      builder.spillDirectory(spillDirectory->path)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kJoinSpillEnabled, "true")
+          .config(core::QueryConfig::kAggregationSpillEnabled, "true")
+          .config(
+              core::QueryConfig::kJoinSpillMemoryThreshold,
+              std::to_string(spillThreshold))
+          .config(
+              core::QueryConfig::kAggregationSpillMemoryThreshold,
+              std::to_string(spillThreshold));
+    }
+
+    Result result;
+    std::shared_ptr<Task> task;
+    RowVectorPtr counts;
+    {
+      MicrosecondTimer timer(&result.micros);
+      counts = builder.copyResults(pool(), task);
+    }
+    auto* rawCounts = counts->childAt(0)->asFlatVector<int64_t>();
+    for (auto i = 0; i < counts->size(); ++i) {
+      result.numOutputRows += rawCounts->valueAt(i);
+    }
+    for (const auto& batch : probe_) {
+      result.numInputRows += batch->size();
+    }
+
+    const auto planStats = toPlanStats(task->taskStats());
+    const auto& nodeStats = planStats.at(nodeId_);
+    if (testCase.query == "join") {
+      for (const auto& [name, stats] : nodeStats.operatorStats) {
+        result.phases[name] = PhaseStats::from(*stats);
+      }
+      auto it = nodeStats.customStats.find("hashtable.hashMode");
+      if (it != nodeStats.customStats.end()) {
+        result.hashMode = BaseHashTable::modeString(
+            static_cast<BaseHashTable::HashMode>(it->second.max));
+      }
+      for (const auto& batch : build_) {
+        result.numInputRows += batch->size();
+      }
+    } else {
+      result.phases["Aggregation"] = PhaseStats::from(nodeStats);
+    }
+    return result;
+  }
+
+  std::unique_ptr<folly::Executor> executor_;
+  std::string dataName_;
+  std::vector<RowVectorPtr> build_;
+  std::vector<RowVectorPtr> probe_;
+  core::PlanNodeId nodeId_;
+};
+
+std::vector<Case> makeCases() {
+  std::optional<std::regex> filter;
+  if (!FLAGS_filter.empty()) {
+    filter = std::regex(FLAGS_filter);
+  }
+  std::vector<Case> cases;
+  // The cases of the same data are next to each other, so that the data is
+  // made once.
+  for (const auto& numKeys : splitFlag(FLAGS_num_keys)) {
+    for (const auto& keyType : splitFlag(FLAGS_key_types)) {
+      for (const auto& keyDomain : splitFlag(FLAGS_key_domains)) {
+        for (const auto& distribution : splitFlag(FLAGS_distributions)) {
+          for (const auto& query : splitFlag(FLAGS_queries)) {
+            for (const auto& spillRatio : splitFlag(FLAGS_spill_ratios)) {
+              Case testCase{
+                  query,
+                  folly::to<int64_t>(numKeys),
+                  keyType,
+                  keyDomain,
+                  distribution,
+                  folly::to<double>(spillRatio)};
+              if (!filter || std::regex_search(testCase.name(), *filter)) {
+                cases.push_back(std::move(testCase));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return cases;
+}
+
+void printResult(const Case& testCase, const Result& result) {
+  std::cout << fmt::format(
+      "{:<55} {:>10} {:>12.0f} {:>10} {:>10} {:>12}\n",
+      testCase.name(),
+      succinctMicros(result.micros),
+      result.numInputRows * 1'000'000.0 / std::max<uint64_t>(result.micros, 1),
+      succinctBytes(result.peakMemoryBytes()),
+      succinctBytes(result.spilledBytes()),
+      result.hashMode);
+  for (const auto& [name, phase] : result.phases) {
+    std::cout << fmt::format(
+        "    {:<12} wall {:>10} cpu {:>10} peak {:>10} spilled {:>10}\n",
+        name,
+        succinctNanos(phase.wallNanos),
+        succinctNanos(phase.cpuNanos),
+        succinctBytes(phase.peakMemoryBytes),
+        succinctBytes(phase.spilledBytes));
+  }
+}
+
+folly::dynamic toJson(const Case& testCase, const Result& result) {
+  folly::dynamic json = folly::dynamic::object;
+  json["name"] = testCase.name();
+  json["query"] = testCase.query;
+  json["numKeys"] = testCase.numKeys;
+  json["keyType"] = testCase.keyType;
+  json["keyDomain"] = testCase.keyDomain;
+  json["distribution"] = testCase.distribution;
+  json["spillRatio"] = testCase.spillRatio;
+  json["micros"] = result.micros;
+  json["numInputRows"] = result.numInputRows;
+  json["numOutputRows"] = result.numOutputRows;
+  json["hashMode"] = result.hashMode;
+  folly::dynamic phases = folly::dynamic::object;
+  for (const auto& [name, phase] : result.phases) {
+    phases[name] = phase.toJson();
+  }
+  json["phases"] = std::move(phases);
+  return json;
+}
+
+} // namespace
+
+// Measures hash joins and aggregations over key types, key domains, probe
+// key distributions and memory limits, e.g.:
+//
+//   velox_hash_join_aggregation_benchmark --num_keys=1000000
+//       --key_types=bigint --distributions=zipf --spill_ratios=0,0.1
+//
+// Prints the time and input rows per second of each case, followed by the
+// wall and CPU time, peak memory and spilled bytes of the HashBuild and
+// HashProbe or the Aggregation operators.
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+
+  std::cout << fmt::format(
+      "{:<55} {:>10} {:>12} {:>10} {:>10} {:>12}\n",
+      "Case",
+      "Time",
+      "Rows/s",
+      "Peak",
+      "Spilled",
+      "Hash mode");
+
+  HashJoinAggregationBenchmark benchmark;
+  folly::dynamic results = folly::dynamic::array;
+  for (const auto& testCase : makeCases()) {
+    auto result = benchmark.run(testCase);
+    printResult(testCase, result);
+    results.push_back(toJson(testCase, result));
+  }
+
+  if (!FLAGS_json_output.empty()) {
+    std::ofstream out(FLAGS_json_output);
+    VELOX_CHECK(out.good(), "Cannot open {}", FLAGS_json_output);
+    out << folly::toPrettyJson(results) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <numeric>
+#include <random>
+
+#include "velox/exec/HashTable.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+// Measures joinProbe() and groupProbe() on hash tables with random BIGINT keys
+// in kHash mode. The small table fits in cache, the large one does not, so the
+// difference between the two shows how much of the probe time goes to cache
+// misses on the tags and the table slots.
+class HashTableProbeBenchmark {
+ public:
+  static constexpr vector_size_t kBatchSize = 1'024;
+  static constexpr int32_t kNumBatches = 1'000;
+
+  explicit HashTableProbeBenchmark(vector_size_t numKeys) {
+    std::mt19937 rng(numKeys);
+    std::vector<int64_t> keys(numKeys);
+    for (auto& key : keys) {
+      key = rng();
+      key = (key << 32) | rng();
+    }
+    auto keyVector = vectorMaker_.flatVector(keys);
+    makeJoinTable(keyVector);
+    makeGroupTable(keyVector);
+
+    // Probe keys are drawn at random from the build side, so that every probe
+    // has a hit.
+    std::uniform_int_distribution<vector_size_t> index(0, numKeys - 1);
+    for (auto i = 0; i < kNumBatches; ++i) {
+      probeBatches_.push_back(vectorMaker_.flatVector<int64_t>(
+          kBatchSize, [&](auto /*row*/) { return keys[index(rng)]; }));
+    }
+  }
+
+  void joinProbe() {
+    HashLookup lookup(joinTable_->hashers());
+    for (const auto& batch : probeBatches_) {
+      hash(*joinTable_, batch, lookup);
+      joinTable_->joinProbe(lookup);
+      folly::doNotOptimizeAway(lookup.hits[0]);
+    }
+  }
+
+  void groupProbe() {
+    HashLookup lookup(groupTable_->hashers());
+    for (const auto& batch : probeBatches_) {
+      hash(*groupTable_, batch, lookup);
+      groupTable_->groupProbe(lookup);
+      VELOX_CHECK(lookup.newGroups.empty());
+    }
+  }
+
+ private:
+  void makeJoinTable(const VectorPtr& keys) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    joinTable_ = HashTable<true>::createForJoin(
+        std::move(hashers), {}, true, false, pool_.get());
+    joinTable_->forceGenericHashMode();
+
+    auto rowContainer = joinTable_->rows();
+    const auto nextOffset = rowContainer->nextOffset();
+    SelectivityVector rows(keys->size());
+    DecodedVector decoded(*keys, rows);
+    for (auto i = 0; i < keys->size(); ++i) {
+      char* newRow = rowContainer->newRow();
+      if (nextOffset) {
+        *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+      }
+      rowContainer->store(decoded, i, newRow, 0);
+    }
+    joinTable_->prepareJoinTable({});
+  }
+
+  void makeGroupTable(const VectorPtr& keys) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    groupTable_ = HashTable<true>::createForAggregation(
+        std::move(hashers), {}, pool_.get());
+    groupTable_->forceGenericHashMode();
+
+    HashLookup lookup(groupTable_->hashers());
+    for (vector_size_t offset = 0; offset < keys->size();
+         offset += kBatchSize) {
+      const auto size =
+          std::min<vector_size_t>(kBatchSize, keys->size() - offset);
+      hash(*groupTable_, keys->slice(offset, size), lookup);
+      groupTable_->groupProbe(lookup);
+    }
+  }
+
+  static void hash(
+      const BaseHashTable& table,
+      const VectorPtr& keys,
+      HashLookup& lookup) {
+    const auto size = keys->size();
+    SelectivityVector rows(size);
+    lookup.reset(size);
+    std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+    auto& hasher = table.hashers()[0];
+    hasher->decode(*keys, rows);
+    hasher->hash(rows, false, lookup.hashes);
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::unique_ptr<BaseHashTable> joinTable_;
+  std::unique_ptr<BaseHashTable> groupTable_;
+  std::vector<VectorPtr> probeBatches_;
+};
+
+std::unique_ptr<HashTableProbeBenchmark> smallTable;
+std::unique_ptr<HashTableProbeBenchmark> largeTable;
+
+BENCHMARK(joinProbeSmallTable) {
+  smallTable->joinProbe();
+}
+
+BENCHMARK_RELATIVE(joinProbeLargeTable) {
+  largeTable->joinProbe();
+}
+
+BENCHMARK(groupProbeSmallTable) {
+  smallTable->groupProbe();
+}
+
+BENCHMARK_RELATIVE(groupProbeLargeTable) {
+  largeTable->groupProbe();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  smallTable = std::make_unique<HashTableProbeBenchmark>(10'000);
+  largeTable = std::make_unique<HashTableProbeBenchmark>(10'000'000);
+  folly::runBenchmarks();
+  smallTable.reset();
+  largeTable.reset();
+  return 0;
+}
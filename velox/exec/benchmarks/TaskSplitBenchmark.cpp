@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <gflags/gflags.h>
+
+#include <thread>
+
+#include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+DEFINE_int32(num_splits, 100'000, "Number of splits fetched per iteration");
+
+// Measures the throughput of Task::getSplitOrFuture() and
+// Task::splitFinished() when many Drivers take small splits at the same time,
+// while another thread keeps adding splits.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+std::shared_ptr<Task> makeTask(core::PlanNodeId& scanId) {
+  auto plan = test::PlanBuilder()
+                  .tableScan(ROW({"c0"}, {BIGINT()}))
+                  .capturePlanNodeId(scanId)
+                  .planFragment();
+  return std::make_shared<Task>(
+      "split.benchmark",
+      std::move(plan),
+      0,
+      std::make_shared<core::QueryCtx>());
+}
+
+Split makeSplit(int32_t index) {
+  return Split(std::make_shared<connector::hive::HiveConnectorSplit>(
+      "test-hive",
+      fmt::format("file:/tmp/split.benchmark.{}", index),
+      dwio::common::FileFormat::DWRF));
+}
+
+void fetchSplits(int32_t numDrivers) {
+  std::shared_ptr<Task> task;
+  core::PlanNodeId scanId;
+  std::vector<Split> splits;
+  BENCHMARK_SUSPEND {
+    task = makeTask(scanId);
+    splits.reserve(FLAGS_num_splits);
+    for (auto i = 0; i < FLAGS_num_splits; ++i) {
+      splits.push_back(makeSplit(i));
+    }
+  }
+
+  std::vector<std::thread> drivers;
+  drivers.reserve(numDrivers);
+  for (auto i = 0; i < numDrivers; ++i) {
+    drivers.emplace_back([&]() {
+      for (;;) {
+        Split split;
+        ContinueFuture future;
+        auto reason = task->getSplitOrFuture(0, scanId, split, future);
+        if (reason == BlockingReason::kWaitForSplit) {
+          future.wait();
+          continue;
+        }
+        if (!split.hasConnectorSplit()) {
+          return;
+        }
+        task->splitFinished();
+      }
+    });
+  }
+  for (auto& split : splits) {
+    task->addSplit(scanId, std::move(split));
+  }
+  task->noMoreSplits(scanId);
+  for (auto& driver : drivers) {
+    driver.join();
+  }
+
+  BENCHMARK_SUSPEND {
+    VELOX_CHECK_EQ(task->taskStats().numFinishedSplits, FLAGS_num_splits);
+    task->requestCancel();
+    task.reset();
+  }
+}
+
+BENCHMARK_NAMED_PARAM(fetchSplits, 1_driver, 1);
+BENCHMARK_NAMED_PARAM(fetchSplits, 4_drivers, 4);
+BENCHMARK_NAMED_PARAM(fetchSplits, 16_drivers, 16);
+BENCHMARK_NAMED_PARAM(fetchSplits, 64_drivers, 64);
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Math.h>
+#include <folly/String.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
@@ -24,6 +25,7 @@
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Values.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -416,6 +418,68 @@ TEST_F(AggregationTest, global) {
   EXPECT_EQ(NonPODInt64::constructed, NonPODInt64::destructed);
 }
 
+TEST_F(AggregationTest, globalFlatInput) {
+  // Flat inputs with and without nulls, including runs of nulls longer than
+  // 64 rows, and masks that select part of the rows.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row * i - 300; }),
+        makeFlatVector<int32_t>(
+            1'000,
+            [&](auto row) { return (row * 17 + i) % 1'001; },
+            nullEvery(7)),
+        makeFlatVector<double>(
+            1'000,
+            [&](auto row) { return row * 0.25 + i; },
+            [](auto row) { return row >= 100 && row < 300; }),
+        makeFlatVector<bool>(
+            1'000,
+            [&](auto row) { return row % 13 != i; },
+            nullEvery(5)),
+        makeFlatVector<bool>(1'000, [](auto row) { return row % 5 != 0; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c0)",
+      "min(c0)",
+      "max(c0)",
+      "sum(c1)",
+      "min(c1)",
+      "max(c1)",
+      "avg(c2)",
+      "var_samp(c2)",
+      "count(c2)",
+      "bool_and(c3)",
+      "bool_or(c3)",
+      "bitwise_or_agg(c1)",
+      "sum(c0)",
+      "max(c2)",
+      "count(c1)"};
+  std::vector<std::string> masks(aggregates.size() - 3, "");
+  masks.insert(masks.end(), {"c4", "c4", "c4"});
+  const std::string expected =
+      "SELECT sum(c0), min(c0), max(c0), sum(c1), min(c1), max(c1), avg(c2), "
+      "var_samp(c2), count(c2), bool_and(c3), bool_or(c3), bit_or(c1), "
+      "sum(c0) FILTER (WHERE c4), max(c2) FILTER (WHERE c4), "
+      "count(c1) FILTER (WHERE c4) FROM tmp";
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({}, aggregates, masks)
+                  .planNode();
+  assertQuery(plan, expected);
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .partialAggregation({}, aggregates, masks)
+             .finalAggregation()
+             .planNode();
+  assertQuery(plan, expected);
+}
+
 TEST_F(AggregationTest, singleBigintKey) {
   auto vectors = makeVectors(rowType_, 10, 100);
   createDuckDbTable(vectors);
@@ -573,6 +637,67 @@ TEST_F(AggregationTest, rangeToDistinct) {
       " GROUP BY c0, c1, c2, c3, c4, c5");
 }
 
+TEST_F(AggregationTest, sequenceKeys) {
+  const vector_size_t size = 1'000;
+  // Returns the lengths of runs of 1 to 'maxLength' rows that add up to
+  // 'size'.
+  auto makeLengths = [&](int32_t maxLength) {
+    std::vector<vector_size_t> lengths;
+    vector_size_t numRows = 0;
+    while (numRows < size) {
+      const vector_size_t length = 1 + (lengths.size() * 7) % maxLength;
+      lengths.push_back(std::min(length, size - numRows));
+      numRows += lengths.back();
+    }
+    return lengths;
+  };
+  auto makeSequence = [&](const std::vector<vector_size_t>& lengths,
+                          const VectorPtr& runValues) {
+    auto lengthsBuffer = allocateSizes(lengths.size(), pool_.get());
+    std::copy(
+        lengths.begin(),
+        lengths.end(),
+        lengthsBuffer->asMutable<vector_size_t>());
+    return BaseVector::wrapInSequence(lengthsBuffer, size, runValues);
+  };
+
+  // The runs of the two keys start at different rows.
+  const auto lengths0 = makeLengths(19);
+  const auto lengths1 = makeLengths(39);
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(makeRowVector({
+        makeSequence(
+            lengths0,
+            makeFlatVector<int64_t>(
+                lengths0.size(),
+                [&](auto row) { return (row + i) % 13; },
+                nullEvery(11))),
+        makeSequence(
+            lengths1,
+            makeFlatVector<StringView>(
+                lengths1.size(),
+                [&](auto row) {
+                  return StringView::makeInline(fmt::format("k{}", row % 5));
+                })),
+        makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+    }));
+  }
+
+  createDuckDbTable(batches);
+  auto op = PlanBuilder()
+                .values(batches)
+                .singleAggregation({"c0", "c1"}, {"sum(c2)", "count(1)"})
+                .planNode();
+  assertQuery(op, "SELECT c0, c1, sum(c2), count(1) FROM tmp GROUP BY 1, 2");
+
+  op = PlanBuilder()
+           .values(batches)
+           .singleAggregation({"c0"}, {"sum(c2)", "max(c1)"})
+           .planNode();
+  assertQuery(op, "SELECT c0, sum(c2), max(c1) FROM tmp GROUP BY 1");
+}
+
 TEST_F(AggregationTest, allKeyTypes) {
   // Covers different key types. Unlike the integer/string tests, the
   // hash table begins life in the generic mode, not array or
@@ -678,6 +803,203 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  // c0 is unique, c1 has few distinct values.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(5)),
+        makeFlatVector<bool>(1'000, [](auto row) { return row % 3 == 0; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto makePlan = [&](const std::string& key) {
+    return PlanBuilder()
+        .values(vectors)
+        .partialAggregation(
+            {key},
+            {"count(1)", "sum(c2)", "avg(c2)", "max(c2)"},
+            {"", "", "", "c3"})
+        .capturePlanNodeId(aggNodeId)
+        .finalAggregation()
+        .planNode();
+  };
+  auto makeSql = [](const std::string& key) {
+    return fmt::format(
+        "SELECT {0}, count(1), sum(c2), avg(c2), max(c2) FILTER (WHERE c3) "
+        "FROM tmp GROUP BY {0}",
+        key);
+  };
+  auto numAbandoned = [&](const std::shared_ptr<Task>& task) {
+    return toPlanStats(task->taskStats())
+        .at(aggNodeId)
+        .customStats.count("abandonedPartialAggregation");
+  };
+
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+          .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+          .plan(makePlan("c0"))
+          .assertResults(makeSql("c0"));
+  EXPECT_EQ(1, numAbandoned(task));
+
+  // Low cardinality keys keep being aggregated.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+             .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+             .plan(makePlan("c1"))
+             .assertResults(makeSql("c1"));
+  EXPECT_EQ(0, numAbandoned(task));
+
+  // No abandoning if hash adaptivity is disabled.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+             .config(QueryConfig::kAbandonPartialAggregationMinPct, "50")
+             .config(QueryConfig::kHashAdaptivityEnabled, "false")
+             .plan(makePlan("c0"))
+             .assertResults(makeSql("c0"));
+  EXPECT_EQ(0, numAbandoned(task));
+}
+
+TEST_F(AggregationTest, clusteredPartialAggregation) {
+  // c0 is clustered, with runs of 100 rows that continue from one batch to
+  // the next. c1 has the same values in no particular order.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row + 50) / 100; }),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row * 7) % 101; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto makePlan = [&](const std::string& key) {
+    return PlanBuilder()
+        .values(vectors)
+        .partialAggregation({key}, {"count(1)", "sum(c2)"})
+        .capturePlanNodeId(aggNodeId)
+        .finalAggregation()
+        .planNode();
+  };
+  auto makeSql = [](const std::string& key) {
+    return fmt::format(
+        "SELECT {0}, count(1), sum(c2) FROM tmp GROUP BY {0}", key);
+  };
+  auto customStats = [&](const std::shared_ptr<Task>& task) {
+    return toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  };
+
+  // The groups are flushed after each batch from the third on.
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(makePlan("c0"))
+                  .assertResults(makeSql("c0"));
+  auto stats = customStats(task);
+  EXPECT_EQ(1, stats.count("clusteredInput"));
+  EXPECT_EQ(8, stats.at("flushTimes").sum);
+
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .plan(makePlan("c1"))
+             .assertResults(makeSql("c1"));
+  stats = customStats(task);
+  EXPECT_EQ(0, stats.count("clusteredInput"));
+  EXPECT_EQ(0, stats.count("flushTimes"));
+
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(QueryConfig::kHashAdaptivityEnabled, "false")
+             .plan(makePlan("c0"))
+             .assertResults(makeSql("c0"));
+  EXPECT_EQ(0, customStats(task).count("clusteredInput"));
+}
+
+TEST_F(AggregationTest, sharedPartialAggregation) {
+  // Each of the 4 drivers reads all of 'vectors' and sees all 100 values of
+  // c0 and null.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row % 100; }, nullEvery(11)),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  std::vector<RowVectorPtr> allVectors;
+  for (auto i = 0; i < 4; ++i) {
+    allVectors.insert(allVectors.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(allVectors);
+
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors, true)
+                  .partialAggregation(
+                      {"c0"}, {"count(1)", "sum(c1)", "array_agg(c1)"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .project({"c0", "a0", "a1", "cardinality(a2)"})
+                  .planNode();
+  const std::string sql =
+      "SELECT c0, count(1), sum(c1), count(1) FROM tmp GROUP BY 1";
+  auto partialStats = [&](const std::shared_ptr<Task>& task) {
+    return toPlanStats(task->taskStats()).at(aggNodeId);
+  };
+
+  // Each driver produces a partial result for each group.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(4)
+                  .assertResults(sql);
+  EXPECT_EQ(4 * 101, partialStats(task).outputRows);
+
+  // Each group is accumulated by one driver.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .maxDrivers(4)
+             .config(QueryConfig::kSharedPartialAggregationEnabled, "true")
+             .assertResults(sql);
+  EXPECT_EQ(101, partialStats(task).outputRows);
+  EXPECT_EQ(0, partialStats(task).customStats.count("flushTimes"));
+
+  // Full shards are flushed by the driver that fills them.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .maxDrivers(4)
+             .config(QueryConfig::kSharedPartialAggregationEnabled, "true")
+             .config(QueryConfig::kMaxPartialAggregationMemory, "1")
+             .assertResults(sql);
+  EXPECT_LT(0, partialStats(task).customStats.at("flushTimes").sum);
+
+  // Distinct and global aggregations are not shared.
+  AssertQueryBuilder(
+      PlanBuilder()
+          .values(vectors, true)
+          .partialAggregation({"c0"}, {})
+          .finalAggregation()
+          .planNode(),
+      duckDbQueryRunner_)
+      .maxDrivers(4)
+      .config(QueryConfig::kSharedPartialAggregationEnabled, "true")
+      .assertResults("SELECT DISTINCT c0 FROM tmp");
+  AssertQueryBuilder(
+      PlanBuilder()
+          .values(vectors, true)
+          .partialAggregation({}, {"sum(c1)"})
+          .finalAggregation()
+          .planNode(),
+      duckDbQueryRunner_)
+      .maxDrivers(4)
+      .config(QueryConfig::kSharedPartialAggregationEnabled, "true")
+      .assertResults("SELECT sum(c1) FROM tmp");
+}
+
 TEST_F(AggregationTest, largeValueRangeArray) {
   // We have keys that map to integer range. The keys are
   // a little under max array hash table size apart. This wastes 16MB of
@@ -1285,6 +1607,100 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, groupingSetsPreAggregation) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "a", "b"},
+      {
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 11; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 17; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) {
+                auto str = std::string(row % 12, 'x');
+                return StringView(str);
+              }),
+      });
+
+  createDuckDbTable({data});
+
+  // Returns the number of rows produced by the GroupId.
+  const auto numReplicatedRows = [&](const core::PlanNodePtr& plan,
+                                     const core::PlanNodeId& groupIdNodeId,
+                                     const std::string& duckDbSql) {
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .config(
+                        core::QueryConfig::kGroupingSetsPreAggregationEnabled,
+                        "true")
+                    .plan(plan)
+                    .assertResults(duckDbSql);
+    return toPlanStats(task->taskStats()).at(groupIdNodeId).outputRows;
+  };
+
+  // Cube. The GroupId replicates the 11 * 17 combinations of k1 and k2 for
+  // each of the 4 grouping sets instead of the 1'000 input rows.
+  core::PlanNodeId groupIdNodeId;
+  auto plan =
+      PlanBuilder()
+          .values({data})
+          .groupId({{"k1", "k2"}, {"k1"}, {"k2"}, {}}, {"a", "b"})
+          .capturePlanNodeId(groupIdNodeId)
+          .singleAggregation(
+              {"k1", "k2", "group_id"},
+              {"count(1) as count_1",
+               "sum(a) as sum_a",
+               "avg(a) as avg_a",
+               "max(b) as max_b"})
+          .project({"k1", "k2", "count_1", "sum_a", "avg_a", "max_b"})
+          .planNode();
+  EXPECT_EQ(
+      numReplicatedRows(
+          plan,
+          groupIdNodeId,
+          "SELECT k1, k2, count(1), sum(a), avg(a), max(b) FROM tmp "
+          "GROUP BY CUBE (k1, k2)"),
+      4 * 11 * 17);
+
+  // Rollup with partial and final aggregations.
+  plan = PlanBuilder()
+             .values({data})
+             .groupId({{"k1", "k2"}, {"k1"}, {}}, {"a", "b"})
+             .capturePlanNodeId(groupIdNodeId)
+             .partialAggregation(
+                 {"k1", "k2", "group_id"},
+                 {"count(1) as count_1", "sum(a) as sum_a", "max(b) as max_b"})
+             .finalAggregation()
+             .project({"k1", "k2", "count_1", "sum_a", "max_b"})
+             .planNode();
+  EXPECT_EQ(
+      numReplicatedRows(
+          plan,
+          groupIdNodeId,
+          "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp "
+          "GROUP BY ROLLUP (k1, k2)"),
+      3 * 11 * 17);
+
+  // An aggregate over a grouping key sees the nulls of the grouping sets
+  // that do not have the key, so the input is replicated.
+  plan = PlanBuilder()
+             .values({data})
+             .groupId({{"k1"}, {"k2"}}, {"a"})
+             .capturePlanNodeId(groupIdNodeId)
+             .singleAggregation(
+                 {"k1", "k2", "group_id"},
+                 {"count(k1) as count_k1", "sum(a) as sum_a"})
+             .project({"k1", "k2", "count_k1", "sum_a"})
+             .planNode();
+  EXPECT_EQ(
+      numReplicatedRows(
+          plan,
+          groupIdNodeId,
+          "SELECT k1, k2, count(k1), sum(a) FROM tmp "
+          "GROUP BY GROUPING SETS ((k1), (k2))"),
+      2 * size);
+}
+
 TEST_F(AggregationTest, groupingSetsByExpand) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1507,6 +1923,87 @@ TEST_F(AggregationTest, outputBatchSizeCheckWithSpill) {
   }
 }
 
+TEST_F(AggregationTest, spillWithVariableWidthAccumulators) {
+  // 100 groups with 1'000 distinct histogram entries each.
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int32_t>(10'000, [](auto row) { return row % 100; }),
+        makeFlatVector<int64_t>(
+            10'000, [i](auto row) { return i * 10'000 + row; }),
+    }));
+  }
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .singleAggregation({"c0"}, {"histogram(c1)"})
+                  .planNode();
+  auto results = AssertQueryBuilder(plan).copyResults(pool_.get());
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(plan)
+                  .spillDirectory(tempDirectory->path)
+                  .config(QueryConfig::kPreferredOutputBatchBytes, "65536")
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kSpillPartitionBits, "0")
+                  .config(QueryConfig::kAggregationSpillMemoryThreshold, "1")
+                  .assertResults(results);
+
+  const auto opStats = task->taskStats().pipelineStats[0].operatorStats[1];
+  ASSERT_GT(opStats.spilledBytes, 0);
+  // The histograms of the merged groups take much more than the preferred
+  // output batch size, so the groups are produced a few at a time.
+  ASSERT_GT(opStats.outputVectors, 10);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
+TEST_F(AggregationTest, spillParallelMerge) {
+  // A local exchange partitions 3'000 groups of c0 and null between the 4
+  // drivers of the final aggregation.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [i](auto row) { return (i * 1'000 + row) % 3'000; },
+            nullEvery(17)),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .partialAggregation(
+                      {"c0"}, {"count(1)", "sum(c1)", "array_agg(c1)"})
+                  .localPartition({"c0"})
+                  .finalAggregation()
+                  .capturePlanNodeId(aggNodeId)
+                  .project({"c0", "a0", "a1", "cardinality(a2)"})
+                  .planNode();
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .maxDrivers(4)
+          .spillDirectory(spillDirectory->path)
+          .config(QueryConfig::kSpillEnabled, "true")
+          .config(QueryConfig::kAggregationSpillEnabled, "true")
+          // Spills after each input batch.
+          .config(QueryConfig::kAggregationSpillMemoryThreshold, "1")
+          .config(QueryConfig::kAggregationSpillParallelMergeEnabled, "true")
+          .assertResults(
+              "SELECT c0, count(1), sum(c1), count(1) FROM tmp GROUP BY 1");
+  auto stats = toPlanStats(task->taskStats()).at(aggNodeId);
+  ASSERT_GT(stats.spilledBytes, 0);
+  // Each spilled partition of each driver is merged once by some driver.
+  ASSERT_EQ(
+      stats.spilledPartitions,
+      stats.customStats.at("mergedSpillPartitions").sum);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
 TEST_F(AggregationTest, distinctWithSpilling) {
   auto vectors = makeVectors(rowType_, 10, 100);
   createDuckDbTable(vectors);
@@ -1566,6 +2063,323 @@ TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(AggregationTest, distinctAggregates) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 17; }),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row + i) % 23; }, nullEvery(7)),
+        makeFlatVector<std::string>(
+            1'000, [&](auto row) { return fmt::format("{}", (row * i) % 31); }),
+        makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Multiple distinct aggregates over different columns mixed with an
+  // aggregate over all inputs.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation(
+                      {"c0"},
+                      {"count(c1)", "sum(c1)", "count(c2)", "sum(c3)"},
+                      {},
+                      {true, true, true, false})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, count(DISTINCT c1), sum(DISTINCT c1), count(DISTINCT c2), "
+      "sum(c3) FROM tmp GROUP BY 1");
+
+  // Global aggregation.
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation(
+                 {},
+                 {"count(c1)", "count(c2)", "max(c3)"},
+                 {},
+                 {true, true, false})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT count(DISTINCT c1), count(DISTINCT c2), max(c3) FROM tmp");
+
+  // Distinct aggregate over one of the grouping keys.
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation({"c0", "c1"}, {"count(c0)"}, {}, {true})
+             .planNode();
+  assertQuery(
+      plan, "SELECT c0, c1, count(DISTINCT c0) FROM tmp GROUP BY 1, 2");
+
+  // Distinct aggregates are only supported in single aggregation.
+  VELOX_ASSERT_THROW(
+      std::make_shared<core::AggregationNode>(
+          "agg",
+          core::AggregationNode::Step::kPartial,
+          std::vector<core::FieldAccessTypedExprPtr>{},
+          std::vector<core::FieldAccessTypedExprPtr>{},
+          std::vector<std::string>{"a0"},
+          std::dynamic_pointer_cast<const core::AggregationNode>(plan)
+              ->aggregates(),
+          std::vector<core::FieldAccessTypedExprPtr>{nullptr},
+          std::vector<bool>{true},
+          false,
+          plan->sources()[0]),
+      "Distinct aggregates are only supported in single aggregation");
+}
+
+TEST_F(AggregationTest, distinctAggregatesWithSpilling) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 97; }),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row * i) % 53; }),
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row + i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .spillDirectory(spillDirectory->path)
+          .config(QueryConfig::kSpillEnabled, "true")
+          .config(QueryConfig::kAggregationSpillEnabled, "true")
+          .config(QueryConfig::kTestingSpillPct, "100")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .singleAggregation(
+                        {"c0"},
+                        {"count(c1)", "sum(c1)", "sum(c2)"},
+                        {},
+                        {true, true, false})
+                    .capturePlanNodeId(aggrNodeId)
+                    .planNode())
+          .assertResults(
+              "SELECT c0, count(DISTINCT c1), sum(DISTINCT c1), sum(c2) "
+              "FROM tmp GROUP BY 1");
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
+TEST_F(AggregationTest, denseAccumulators) {
+  // The keys fit an array hash table, so sum, min and max accumulate into
+  // dense arrays while count does not. The last batches have keys outside of
+  // the array range, which switches the table to hash mode.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 12; ++i) {
+    const int64_t keyScale = i < 10 ? 1 : 1'000'003;
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row * 7 + i) % 300 * keyScale; }),
+        makeFlatVector<int32_t>(
+            1'000,
+            [&](auto row) { return row * i - 500; },
+            [&](auto row) { return (row + i) % 11 == 0; }),
+        makeFlatVector<double>(1'000, [&](auto row) { return row * 0.5 - i; }),
+        makeFlatVector<bool>(1'000, [&](auto row) { return row % 3 == i % 2; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)",
+      "min(c1)",
+      "max(c1)",
+      "sum(c2)",
+      "min(c2)",
+      "count(c1)",
+      "sum(c1)"};
+  const std::vector<std::string> masks = {"", "", "", "", "", "", "c3"};
+  const std::string expected =
+      "SELECT c0, sum(c1), min(c1), max(c1), sum(c2), min(c2), count(c1), "
+      "sum(c1) FILTER (WHERE c3) FROM tmp GROUP BY 1";
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0"}, aggregates, masks)
+                  .planNode();
+  assertQuery(plan, expected);
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .partialAggregation({"c0"}, aggregates, masks)
+             .finalAggregation()
+             .planNode();
+  assertQuery(plan, expected);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .spillDirectory(spillDirectory->path)
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .plan(PlanBuilder()
+                            .values(vectors)
+                            .singleAggregation({"c0"}, aggregates, masks)
+                            .capturePlanNodeId(aggrNodeId)
+                            .planNode())
+                  .assertResults(expected);
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
+TEST_F(AggregationTest, wideAggregation) {
+  // With many fixed size accumulators the aggregates are extracted a block of
+  // groups at a time. The output batches span several blocks.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            5'000, [&](auto row) { return (row * 17 + i) % 4'000; }),
+        makeFlatVector<int32_t>(
+            5'000,
+            [&](auto row) { return row * i - 2'000; },
+            [&](auto row) { return (row + i) % 13 == 0; }),
+        makeFlatVector<double>(5'000, [&](auto row) { return row * 0.25 - i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  std::vector<std::string> aggregates;
+  for (auto i = 0; i < 8; ++i) {
+    const auto column = i % 2 == 0 ? "c1" : "c2";
+    for (const auto* function : {"sum", "min", "max", "avg", "count"}) {
+      aggregates.push_back(fmt::format("{}({})", function, column));
+    }
+  }
+  const std::string expected = fmt::format(
+      "SELECT c0, {} FROM tmp GROUP BY 1", folly::join(", ", aggregates));
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0"}, aggregates)
+                  .planNode();
+  assertQuery(plan, expected);
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .partialAggregation({"c0"}, aggregates)
+             .finalAggregation()
+             .planNode();
+  assertQuery(plan, expected);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .spillDirectory(spillDirectory->path)
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .plan(PlanBuilder()
+                            .values(vectors)
+                            .singleAggregation({"c0"}, aggregates)
+                            .planNode())
+                  .assertResults(expected);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
+TEST_F(AggregationTest, sortedAggregates) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 17; }),
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return (row * 7 + i) % 101; },
+            nullEvery(11)),
+        // Unique across the batches, so that the order of the rows of a group
+        // is fully determined.
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return (row * 37) % 1'000 + i * 1'000; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // The first two aggregates share the buffer sorted on c2.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .sortedAggregation(
+                      {"c0"},
+                      {"array_agg(c1)",
+                       "array_agg(c2)",
+                       "array_agg(c2)",
+                       "sum(c1)"},
+                      {{"c2 DESC"}, {"c2 DESC"}, {"c1 NULLS FIRST", "c2"}, {}})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, array_agg(c1 ORDER BY c2 DESC), "
+      "array_agg(c2 ORDER BY c2 DESC), "
+      "array_agg(c2 ORDER BY c1 ASC NULLS FIRST, c2), sum(c1) "
+      "FROM tmp GROUP BY 1");
+
+  // Global aggregation.
+  plan = PlanBuilder()
+             .values(vectors)
+             .sortedAggregation(
+                 {}, {"array_agg(c1)", "count(c1)"}, {{"c2"}, {}})
+             .planNode();
+  assertQuery(plan, "SELECT array_agg(c1 ORDER BY c2), count(c1) FROM tmp");
+
+  // Sorted aggregates are only supported in single aggregation.
+  auto aggregationNode =
+      std::dynamic_pointer_cast<const core::AggregationNode>(plan);
+  VELOX_ASSERT_THROW(
+      std::make_shared<core::AggregationNode>(
+          "agg",
+          core::AggregationNode::Step::kPartial,
+          std::vector<core::FieldAccessTypedExprPtr>{},
+          std::vector<core::FieldAccessTypedExprPtr>{},
+          std::vector<std::string>{"a0", "a1"},
+          aggregationNode->aggregates(),
+          std::vector<core::FieldAccessTypedExprPtr>{nullptr, nullptr},
+          std::vector<bool>{},
+          aggregationNode->sortingKeys(),
+          aggregationNode->sortingOrders(),
+          false,
+          plan->sources()[0]),
+      "Sorted aggregates are only supported in single aggregation");
+}
+
+TEST_F(AggregationTest, sortedAggregatesWithSpilling) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 97; }),
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row * 10 + i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .spillDirectory(spillDirectory->path)
+          .config(QueryConfig::kSpillEnabled, "true")
+          .config(QueryConfig::kAggregationSpillEnabled, "true")
+          .config(QueryConfig::kTestingSpillPct, "100")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .sortedAggregation(
+                        {"c0"},
+                        {"array_agg(c1)", "max(c1)"},
+                        {{"c1 DESC"}, {}})
+                    .capturePlanNodeId(aggrNodeId)
+                    .planNode())
+          .assertResults(
+              "SELECT c0, array_agg(c1 ORDER BY c1 DESC), max(c1) "
+              "FROM tmp GROUP BY 1");
+  // The sorted input is spilled while the groups stay in memory.
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
 TEST_F(AggregationTest, adaptiveOutputBatchRows) {
   int32_t defaultOutputBatchRows = 10;
   vector_size_t size = defaultOutputBatchRows * 5;
@@ -1614,5 +2428,62 @@ TEST_F(AggregationTest, adaptiveOutputBatchRows) {
   }
 }
 
+DEBUG_ONLY_TEST_F(AggregationTest, reclaimDuringInput) {
+  const int kNumBatches = 5;
+  const int kNumRows = 1'000;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(kNumRows, [](auto row) { return row % 500; }),
+         makeFlatVector<int64_t>(
+             kNumRows, [i](auto row) { return row + i; })}));
+  }
+  createDuckDbTable(batches);
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  // Pauses the task once the aggregation has received some input and reclaims
+  // from the query memory pool after the pause.
+  std::thread reclaimThread;
+  bool canReclaim{false};
+  uint64_t reclaimedBytes{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Values::getOutput",
+      std::function<void(const exec::Values*)>(
+          ([&](const exec::Values* values) {
+            if (values->testingCurrent() != 2) {
+              return;
+            }
+            auto pauseFuture =
+                values->testingOperatorCtx()->task()->requestPause();
+            reclaimThread = std::thread(
+                [&, pauseFuture = std::move(pauseFuture)]() mutable {
+                  std::move(pauseFuture).wait();
+                  canReclaim = queryCtx->pool()->canReclaim();
+                  reclaimedBytes = queryCtx->pool()->reclaim(0);
+                });
+          })));
+
+  auto task =
+      AssertQueryBuilder(
+          PlanBuilder()
+              .values(batches)
+              .singleAggregation({"c0"}, {"sum(c1)"})
+              .planNode(),
+          duckDbQueryRunner_)
+          .queryCtx(queryCtx)
+          .spillDirectory(tempDirectory->path)
+          .config(QueryConfig::kSpillEnabled, "true")
+          .config(QueryConfig::kAggregationSpillEnabled, "true")
+          .assertResults("SELECT c0, sum(c1) FROM tmp GROUP BY c0");
+  reclaimThread.join();
+
+  ASSERT_TRUE(canReclaim);
+  ASSERT_GT(reclaimedBytes, 0);
+  auto stats = task->taskStats().pipelineStats;
+  ASSERT_GT(stats[0].operatorStats[1].spilledRows, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
 } // namespace
 } // namespace facebook::velox::exec::test
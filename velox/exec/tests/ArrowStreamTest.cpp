@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/ArrowStream.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -226,3 +227,36 @@ TEST_F(ArrowStreamTest, error) {
       AssertQueryBuilder(plan).copyResults(pool_.get()),
       "Failed to call get_schema on ArrowStream: get_schema failed.");
 }
+
+TEST_F(ArrowStreamTest, exportTask) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             size, [&](auto row) { return size * i + row; }, nullEvery(5)),
+         makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+         makeFlatVector<StringView>(size, [](auto row) {
+           return StringView::makeInline(std::to_string(row % 100));
+         })}));
+  }
+  createDuckDbTable(vectors);
+
+  // The constant column is flattened by the export.
+  auto task = std::make_shared<exec::Task>(
+      "arrow.export.task.0",
+      PlanBuilder()
+          .values(vectors)
+          .project({"c0", "c1 * 2", "c2", "'x'"})
+          .planFragment(),
+      0,
+      std::make_shared<core::QueryCtx>());
+  auto type = task->planFragment().planNode->outputType();
+  struct ArrowArrayStream arrowStream;
+  exec::exportToArrowStream(task, arrowStream);
+  task.reset();
+
+  auto plan = std::make_shared<core::ArrowStreamNode>(
+      "0", type, std::make_shared<ArrowArrayStream>(arrowStream));
+  assertQuery(plan, "SELECT c0, c1 * 2, c2, 'x' FROM tmp");
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class BatchCoalescerTest : public OperatorTestBase {
+ protected:
+  // Returns 'numBatches' batches of 1'000 rows with a sequential c0, a string
+  // c1 and a dictionary encoded c2.
+  std::vector<RowVectorPtr> makeBatches(int32_t numBatches) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < numBatches; ++i) {
+      const vector_size_t size = 1'000;
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              size, [&](auto row) { return i * size + row; }),
+          makeFlatVector<std::string>(
+              size,
+              [&](auto row) { return fmt::format("string value {}", row); },
+              nullEvery(7)),
+          wrapInDictionary(
+              makeIndicesInReverse(size),
+              size,
+              makeFlatVector<int32_t>(size, [](auto row) { return row; })),
+      }));
+    }
+    return batches;
+  }
+
+  // Returns the stats of the BatchCoalescer, which has the plan node id of
+  // the operator it follows.
+  static const PlanNodeStats& coalescerStats(
+      const std::unordered_map<core::PlanNodeId, PlanNodeStats>& planStats,
+      const core::PlanNodeId& planNodeId) {
+    return *planStats.at(planNodeId).operatorStats.at("BatchCoalescer");
+  }
+};
+
+TEST_F(BatchCoalescerTest, filter) {
+  auto batches = makeBatches(50);
+  createDuckDbTable(batches);
+
+  // The filter and the projection run in one FilterProject that has the id
+  // of the projection.
+  core::PlanNodeId projectId;
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .filter("c0 % 100 = 7")
+                  .project({"c0", "c1", "c2 + 1"})
+                  .capturePlanNodeId(projectId)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kCoalesceBatchesEnabled, "true")
+                  .config(core::QueryConfig::kPreferredOutputBatchRows, "200")
+                  .assertResults(
+                      "SELECT c0, c1, c2 + 1 FROM tmp WHERE c0 % 100 = 7");
+
+  // 50 batches of 10 rows are coalesced in batches of 200 rows.
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& stats = coalescerStats(planStats, projectId);
+  EXPECT_EQ(stats.inputVectors, 50);
+  EXPECT_EQ(stats.inputRows, 500);
+  EXPECT_EQ(stats.outputVectors, 3);
+  EXPECT_EQ(stats.outputRows, 500);
+  EXPECT_EQ(stats.customStats.at("coalescedBatches").sum, 50);
+  EXPECT_EQ(stats.customStats.at("outputBatchRows").max, 200);
+
+  // The order of the rows is kept.
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .config(core::QueryConfig::kCoalesceBatchesEnabled, "true")
+      .config(core::QueryConfig::kPreferredOutputBatchRows, "200")
+      .assertResults(
+          "SELECT c0, c1, c2 + 1 FROM tmp WHERE c0 % 100 = 7 ORDER BY c0",
+          std::vector<uint32_t>{0});
+}
+
+TEST_F(BatchCoalescerTest, passThrough) {
+  auto batches = makeBatches(10);
+  createDuckDbTable(batches);
+
+  // Every other batch passes the filter entirely and is not copied.
+  core::PlanNodeId filterId;
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .filter("c0 / 1000 % 2 = 0 OR c0 % 100 = 0")
+                  .capturePlanNodeId(filterId)
+                  .planNode();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kCoalesceBatchesEnabled, "true")
+          .assertResults(
+              "SELECT * FROM tmp WHERE c0 / 1000 % 2 = 0 OR c0 % 100 = 0");
+
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& stats = coalescerStats(planStats, filterId);
+  EXPECT_EQ(stats.customStats.at("passedThroughBatches").sum, 5);
+  EXPECT_EQ(stats.customStats.at("coalescedBatches").sum, 5);
+  EXPECT_EQ(stats.outputRows, 5 * 1'000 + 5 * 10);
+}
+
+TEST_F(BatchCoalescerTest, hashProbe) {
+  auto probe = makeBatches(20);
+  auto build = makeRowVector(
+      {"u0"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row * 97; })});
+  createDuckDbTable("t", probe);
+  createDuckDbTable("u", {build});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId joinId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probe)
+                  .hashJoin(
+                      {"c0"},
+                      {"u0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values({build})
+                          .planNode(),
+                      "",
+                      {"c0", "c1", "u0"})
+                  .capturePlanNodeId(joinId)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kCoalesceBatchesEnabled, "true")
+                  .assertResults("SELECT c0, c1, u0 FROM t, u WHERE c0 = u0");
+
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& stats = coalescerStats(planStats, joinId);
+  EXPECT_EQ(stats.outputRows, 100);
+  EXPECT_EQ(stats.outputVectors, 1);
+}
+
+TEST_F(BatchCoalescerTest, disabled) {
+  auto batches = makeBatches(5);
+  createDuckDbTable(batches);
+  core::PlanNodeId filterId;
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .filter("c0 % 100 = 7")
+                  .capturePlanNodeId(filterId)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults("SELECT * FROM tmp WHERE c0 % 100 = 7");
+  EXPECT_EQ(
+      toPlanStats(task->taskStats()).at(filterId).operatorStats.count(
+          "BatchCoalescer"),
+      0);
+}
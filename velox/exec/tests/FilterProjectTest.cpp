@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -227,6 +228,32 @@ TEST_F(FilterProjectTest, filterProject) {
   assertQuery(plan, "SELECT c0, c1, c0 + c1 FROM tmp WHERE c1 % 10 > 0");
 }
 
+TEST_F(FilterProjectTest, recycleHeldOutput) {
+  // The query results are held by the task cursor, so the projection results
+  // are still referenced when the next input arrives. They go back to the
+  // vector pool once released and must not be handed out while still in use.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 100; ++i) {
+    auto vector = std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 100, *pool_));
+    vectors.push_back(vector);
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 + 1", "c1 * 2", "c3 / 2"})
+                  .planNode();
+  assertQuery(plan, "SELECT c0 + 1, c1 * 2, c3 / 2 FROM tmp");
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .filter("c1 % 3 > 0")
+             .project({"c0 + c1", "c3 * 2"})
+             .planNode();
+  assertQuery(plan, "SELECT c0 + c1, c3 * 2 FROM tmp WHERE c1 % 3 > 0");
+}
+
 TEST_F(FilterProjectTest, dereference) {
   std::vector<RowVectorPtr> vectors;
   for (int32_t i = 0; i < 10; ++i) {
@@ -322,3 +349,37 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, fusedKernel) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(2'000, [&](auto row) { return row * i; }),
+        makeFlatVector<double>(2'000, [](auto row) { return row * 0.5; }),
+    }));
+  }
+  // A batch with nulls is evaluated by the interpreter.
+  vectors.push_back(makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+      makeFlatVector<double>({1, 2, 3}),
+  }));
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId projectId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c0 > 100 and c1 < 800.0")
+                  .project({"c0", "c0 * 2 + 1", "c1 - 1.5", "c0 < 1000"})
+                  .capturePlanNodeId(projectId)
+                  .planNode();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kExprFusedKernelsEnabled, "true")
+          .assertResults(
+              "SELECT c0, c0 * 2 + 1, c1 - 1.5, c0 < 1000 FROM tmp "
+              "WHERE c0 > 100 and c1 < 800.0");
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& stats = planStats.at(projectId).customStats;
+  EXPECT_EQ(stats.at("fusedKernelBatches").sum, 5);
+  EXPECT_EQ(stats.at("fusedKernelFallbackBatches").sum, 1);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+using namespace facebook::velox::exec::test;
+
+class GlobalRowNumberTest : public OperatorTestBase {
+ protected:
+  // Runs 'input' through GlobalRowNumber in 'numDrivers' drivers, each of which
+  // reads all of 'input', and verifies that the rows are numbered 1..n and
+  // that the rows of each driver have consecutive numbers in input order.
+  void verifyRowNumbers(
+      const std::vector<RowVectorPtr>& input,
+      int32_t numDrivers) {
+    auto plan = PlanBuilder()
+                    .values(input, true)
+                    .globalRowNumber("rn")
+                    .capturePlanNodeId(rowNumberNodeId_)
+                    .planNode();
+
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = numDrivers;
+    auto result = readCursor(params, [](auto /*task*/) {});
+
+    std::vector<int32_t> inputValues;
+    for (const auto& vector : input) {
+      auto values = vector->childAt(0)->asFlatVector<int32_t>();
+      for (auto i = 0; i < vector->size(); ++i) {
+        inputValues.push_back(values->valueAt(i));
+      }
+    }
+
+    // The input value of each row by its row number.
+    std::vector<std::optional<int32_t>> valueByRowNumber(
+        inputValues.size() * numDrivers);
+    for (const auto& output : result.second) {
+      ASSERT_EQ(output->childrenSize(), 2);
+      auto values = output->childAt(0)->asFlatVector<int32_t>();
+      auto rowNumbers = output->childAt(1)->asFlatVector<int64_t>();
+      for (auto i = 0; i < output->size(); ++i) {
+        auto rowNumber = rowNumbers->valueAt(i);
+        ASSERT_GE(rowNumber, 1);
+        ASSERT_LE(rowNumber, valueByRowNumber.size());
+        ASSERT_FALSE(valueByRowNumber[rowNumber - 1].has_value());
+        valueByRowNumber[rowNumber - 1] = values->valueAt(i);
+      }
+    }
+
+    for (auto i = 0; i < valueByRowNumber.size(); ++i) {
+      ASSERT_TRUE(valueByRowNumber[i].has_value()) << i + 1;
+      ASSERT_EQ(
+          valueByRowNumber[i].value(), inputValues[i % inputValues.size()])
+          << i + 1;
+    }
+
+    auto stats = toPlanStats(result.first->task()->taskStats());
+    ASSERT_EQ(
+        stats.at(rowNumberNodeId_).outputRows, valueByRowNumber.size());
+  }
+
+  core::PlanNodeId rowNumberNodeId_;
+};
+
+TEST_F(GlobalRowNumberTest, basic) {
+  std::vector<RowVectorPtr> input;
+  for (int i = 0; i < 5; ++i) {
+    input.push_back(makeRowVector({makeFlatVector<int32_t>(
+        100 + i * 37, [i](auto row) { return i * 1'000 + row; })}));
+  }
+
+  for (auto numDrivers : {1, 2, 4, 7}) {
+    SCOPED_TRACE(fmt::format("numDrivers: {}", numDrivers));
+    verifyRowNumbers(input, numDrivers);
+  }
+}
+
+TEST_F(GlobalRowNumberTest, emptyInput) {
+  auto input = makeRowVector({makeFlatVector<int32_t>({})});
+  auto plan = PlanBuilder().values({input}, true).globalRowNumber().planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.maxDrivers = 3;
+  auto result = readCursor(params, [](auto /*task*/) {});
+  ASSERT_TRUE(result.second.empty());
+}
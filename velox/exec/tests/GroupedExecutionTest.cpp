@@ -54,6 +54,30 @@ class GroupedExecutionTest : public virtual HiveConnectorTestBase {
     return PlanBuilder().tableScan(outputType).planNode();
   }
 
+  // Returns the number of memory pools under the plan node pools of 'task'.
+  static uint64_t numOperatorPools(const std::shared_ptr<exec::Task>& task) {
+    uint64_t numPools{0};
+    task->pool()->visitChildren([&](memory::MemoryPool* nodePool) {
+      numPools += nodePool->getChildCount();
+      return true;
+    });
+    return numPools;
+  }
+
+  // Waits until 'task' has at most 'maxPools' operator memory pools.
+  static void waitForOperatorPools(
+      const std::shared_ptr<exec::Task>& task,
+      uint64_t maxPools) {
+    // Limit wait to 10 seconds.
+    size_t iteration{0};
+    while (numOperatorPools(task) > maxPools and iteration < 100) {
+      /* sleep override */
+      usleep(100'000); // 0.1 second.
+      ++iteration;
+    }
+    ASSERT_LE(numOperatorPools(task), maxPools);
+  }
+
   static std::unordered_set<int32_t> getCompletedSplitGroups(
       const std::shared_ptr<exec::Task>& task) {
     return task->taskStats().completedSplitGroups;
@@ -521,4 +545,60 @@ TEST_F(GroupedExecutionTest, groupedExecution) {
   EXPECT_EQ(numRead, numSplits * 10'000);
 }
 
+// Checks that the memory pools of the operators of a split group are released
+// when the split group finishes, so that the memory of a task running grouped
+// execution does not grow with the number of split groups.
+TEST_F(GroupedExecutionTest, releaseSplitGroupPools) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+
+  // The filter drops all the groups so that no output holds on to memory of
+  // the operators.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId tableScanNodeId;
+  auto planFragment = PlanBuilder(planNodeIdGenerator)
+                          .tableScan(rowType_)
+                          .capturePlanNodeId(tableScanNodeId)
+                          .partialAggregation({"c0"}, {"count(1)"})
+                          .localPartition({"c0"})
+                          .finalAggregation()
+                          .filter("a0 < 0")
+                          .partitionedOutput({}, 1)
+                          .planFragment();
+  planFragment.executionStrategy = core::ExecutionStrategy::kGrouped;
+  planFragment.groupedExecutionLeafNodeIds.emplace(tableScanNodeId);
+  planFragment.numSplitGroups = 10;
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  auto task = std::make_shared<exec::Task>(
+      "0", std::move(planFragment), 0, std::move(queryCtx));
+  // 3 drivers max and 1 concurrent split group.
+  task->start(task, 3, 1);
+
+  task->addSplit(tableScanNodeId, makeHiveSplitWithGroup(filePath->path, 0));
+  task->addSplit(tableScanNodeId, makeHiveSplitWithGroup(filePath->path, 1));
+  task->addSplit(tableScanNodeId, makeHiveSplitWithGroup(filePath->path, 2));
+  // One split group is processed at a time, 3 drivers per pipeline.
+  EXPECT_EQ(6, task->numRunningDrivers());
+  const auto numPoolsOneGroup = numOperatorPools(task);
+  ASSERT_GT(numPoolsOneGroup, 0);
+
+  for (auto group = 0; group < 3; ++group) {
+    task->noMoreSplitsForGroup(tableScanNodeId, group);
+    waitForFinishedDrivers(task, 6 * (group + 1));
+    // Only the pools of the running split group remain.
+    waitForOperatorPools(task, numPoolsOneGroup);
+  }
+  EXPECT_EQ(0, task->numRunningDrivers());
+  EXPECT_EQ(
+      std::unordered_set<int32_t>({0, 1, 2}), getCompletedSplitGroups(task));
+  waitForOperatorPools(task, 0);
+
+  task->noMoreSplits(tableScanNodeId);
+  auto outputBufferManager =
+      exec::PartitionedOutputBufferManager::getInstance().lock();
+  outputBufferManager->deleteResults(task->taskId(), 0);
+  EXPECT_EQ(exec::TaskState::kFinished, task->state());
+}
+
 } // namespace facebook::velox::exec::test
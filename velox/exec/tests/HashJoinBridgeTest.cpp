@@ -175,16 +175,29 @@ TEST_P(HashJoinBridgeTest, withoutSpill) {
       ASSERT_TRUE(futures[i].valid());
     }
 
+    ASSERT_FALSE(joinBridge->exportDynamicFilters().has_value());
     BaseHashTable* rawTable = nullptr;
     if (hasNullKeys) {
       joinBridge->setAntiJoinHasNullKeys();
       ASSERT_ANY_THROW(joinBridge->setAntiJoinHasNullKeys());
+      ASSERT_EQ(joinBridge->exportDynamicFilters()->size(), 0);
     } else {
       auto table = createFakeHashTable();
       rawTable = table.get();
-      joinBridge->setHashTable(std::move(table), {}, false);
+      joinBridge->setHashTable(
+          std::move(table),
+          {},
+          false,
+          {std::make_shared<common::BigintRange>(1, 10, false), nullptr});
       ASSERT_ANY_THROW(
           joinBridge->setHashTable(createFakeHashTable(), {}, false));
+      auto filters = joinBridge->exportDynamicFilters();
+      ASSERT_TRUE(filters.has_value());
+      ASSERT_EQ(filters->size(), 2);
+      ASSERT_EQ(
+          common::Filter::create(filters.value()[0])->kind(),
+          common::FilterKind::kBigintRange);
+      ASSERT_TRUE(filters.value()[1].isNull());
     }
 
     for (int32_t i = 0; i < numProbers_; ++i) {
@@ -220,6 +233,8 @@ TEST_P(HashJoinBridgeTest, withoutSpill) {
     // Probe side completion.
     ASSERT_FALSE(joinBridge->probeFinished());
     ASSERT_ANY_THROW(joinBridge->probeFinished());
+    // The exported filters outlive the table.
+    ASSERT_TRUE(joinBridge->exportDynamicFilters().has_value());
   }
 }
 
@@ -1064,6 +1064,43 @@ TEST_P(MultiThreadedHashJoinTest, arrayBasedLookup) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, skewedBuildKeys) {
+  // Three quarters of the build rows have the same key.
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 20; ++i) {
+    const auto offset = i * 1'000;
+    buildVectors.push_back(makeRowVector(
+        {"u_k0", "u_data"},
+        {makeFlatVector<int32_t>(
+             1'000,
+             [&](auto row) {
+               return (offset + row) % 4 == 0 ? offset + row : 7;
+             }),
+         makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return offset + row; })}));
+  }
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector(
+      {"t_k0"}, {makeFlatVector<int32_t>(100, [](auto row) { return row; })})};
+
+  HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+      .numDrivers(numDrivers_)
+      .probeKeys({"t_k0"})
+      .probeVectors(std::move(probeVectors))
+      .buildKeys({"u_k0"})
+      .buildVectors(std::move(buildVectors))
+      .joinOutputLayout({"t_k0", "u_data"})
+      .referenceQuery("SELECT t_k0, u_data FROM t, u WHERE t.t_k0 = u.u_k0")
+      .verifier([&](const std::shared_ptr<Task>& task, bool /*hasSpill*/) {
+        auto buildStats = task->taskStats()
+                              .pipelineStats.back()
+                              .operatorStats.back()
+                              .runtimeStats;
+        ASSERT_GE(buildStats["skewedKeys"].sum, 1);
+        ASSERT_GE(buildStats["maxKeySampledRowsPct"].max, 50);
+      })
+      .run();
+}
+
 TEST_P(MultiThreadedHashJoinTest, joinSidesDifferentSchema) {
   // In this join, the tables have different schema. LHS table t has schema
   // {INTEGER, VARCHAR, INTEGER}. RHS table u has schema {INTEGER, REAL,
@@ -1161,6 +1198,58 @@ TEST_P(MultiThreadedHashJoinTest, innerJoinWithEmptyBuild) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, swapJoinSides) {
+  std::vector<RowVectorPtr> probeVectors = makeBatches(2, [&](int32_t batch) {
+    return makeRowVector(
+        {"t_k", "t_v"},
+        {makeFlatVector<int32_t>(
+             100,
+             [batch](auto row) { return (row + batch) % 150; },
+             nullEvery(11)),
+         makeFlatVector<int64_t>(
+             100, [batch](auto row) { return row + batch * 100; })});
+  });
+  std::vector<RowVectorPtr> buildVectors = makeBatches(10, [&](int32_t batch) {
+    return makeRowVector(
+        {"u_k", "u_v"},
+        {makeFlatVector<int32_t>(
+             1'000,
+             [batch](auto row) { return (row * 7 + batch) % 2'000; },
+             nullEvery(13)),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  });
+
+  // The probe side is swapped with the much larger build side unless its
+  // input does not fit in the buffers.
+  struct {
+    uint64_t maxProbeBufferBytes;
+    bool swapped;
+  } testSettings[] = {{16 << 20, true}, {1, false}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(fmt::format("swapped: {}", testData.swapped));
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .probeKeys({"t_k"})
+        .probeVectors(std::vector<RowVectorPtr>(probeVectors))
+        .buildKeys({"u_k"})
+        .buildVectors(std::vector<RowVectorPtr>(buildVectors))
+        .config(core::QueryConfig::kJoinSwapMinBuildRows, "1000")
+        .config(
+            core::QueryConfig::kJoinSwapMaxProbeBufferBytes,
+            std::to_string(testData.maxProbeBufferBytes))
+        .referenceQuery(
+            "SELECT t_k, t_v, u_k, u_v FROM t, u WHERE t_k = u_k")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          // A join that can spill is never swapped.
+          const auto numSwapped =
+              getOperatorRuntimeStats(task, 1, "swappedJoinSides").sum;
+          ASSERT_EQ(
+              numSwapped, testData.swapped && !hasSpill ? numDrivers_ : 0);
+        })
+        .run();
+  }
+}
+
 TEST_P(MultiThreadedHashJoinTest, leftSemiJoinFilter) {
   HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
       .numDrivers(numDrivers_)
@@ -2907,6 +2996,93 @@ TEST_F(HashJoinTest, semiProject) {
       .run();
 }
 
+TEST_F(HashJoinTest, semiAndAntiJoinWithoutFilterSkipBuildPayload) {
+  auto probeVectors = makeBatches(2, [&](int32_t /*unused*/) {
+    return makeRowVector(
+        {"t0", "t1"},
+        {
+            makeFlatVector<int64_t>(2'000, [](auto row) { return row; }),
+            makeFlatVector<int64_t>(2'000, [](auto row) { return row * 10; }),
+        });
+  });
+  // 1'000 distinct keys with a large string that the join does not read.
+  const std::string payload(1'000, 'x');
+  auto buildVectors = makeBatches(5, [&](int32_t /*unused*/) {
+    return makeRowVector(
+        {"u0", "u1"},
+        {
+            makeFlatVector<int64_t>(
+                2'000, [](auto row) { return row % 1'000; }),
+            makeFlatVector<std::string>(
+                2'000, [&](auto /*row*/) { return payload; }),
+        });
+  });
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // Returns the peak memory of the build side.
+  const auto runJoin = [&](const std::vector<std::string>& buildColumns,
+                           core::JoinType joinType,
+                           const std::vector<std::string>& outputLayout,
+                           const std::string& referenceQuery) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinNodeId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .hashJoin(
+                        {"t0"},
+                        {"u0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .project(buildColumns)
+                            .planNode(),
+                        "",
+                        outputLayout,
+                        joinType)
+                    .capturePlanNodeId(joinNodeId)
+                    .planNode();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .assertResults(referenceQuery);
+    return toPlanStats(task->taskStats())
+        .at(joinNodeId)
+        .operatorStats.at("HashBuild")
+        ->peakMemoryBytes;
+  };
+
+  struct TestCase {
+    core::JoinType joinType;
+    std::vector<std::string> outputLayout;
+    std::string referenceQuery;
+  };
+  std::vector<TestCase> testCases = {
+      {core::JoinType::kLeftSemiFilter,
+       {"t0", "t1"},
+       "SELECT * FROM t WHERE t0 IN (SELECT u0 FROM u)"},
+      {core::JoinType::kLeftSemiProject,
+       {"t0", "t1", "match"},
+       "SELECT t0, t1, t0 IN (SELECT u0 FROM u) FROM t"},
+      {core::JoinType::kAnti,
+       {"t0", "t1"},
+       "SELECT * FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE u0 = t0)"},
+  };
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE(core::joinTypeName(testCase.joinType));
+    // The table has the 1'000 distinct keys without the payload, the same as
+    // when the build side has the keys only.
+    EXPECT_EQ(
+        runJoin(
+            {"u0", "u1"},
+            testCase.joinType,
+            testCase.outputLayout,
+            testCase.referenceQuery),
+        runJoin(
+            {"u0"},
+            testCase.joinType,
+            testCase.outputLayout,
+            testCase.referenceQuery));
+  }
+}
+
 TEST_F(HashJoinTest, semiProjectWithNullKeys) {
   // Some keys have multiple rows: 2, 3, 5.
   auto probeVectors = makeBatches(3, [&](int32_t /*unused*/) {
@@ -4503,4 +4679,170 @@ TEST_F(HashJoinTest, dynamicFilterOnPartitionKey) {
       .run();
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 1'000;
+  const int32_t numRowsBuild = 100;
+
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  std::vector<exec::Split> probeSplits;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<std::string>(
+            numRowsProbe,
+            [&](auto row) {
+              return fmt::format("key{}", i * numRowsProbe + row);
+            }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+    probeSplits.push_back(
+        exec::Split(makeHiveConnectorSplit(tempFiles.back()->path)));
+  }
+
+  // String keys have no exact dynamic filter, only a Bloom filter.
+  std::vector<RowVectorPtr> buildVectors{makeRowVector({
+      makeFlatVector<std::string>(
+          numRowsBuild,
+          [](auto row) { return fmt::format("key{}", row * 37); }),
+      makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row; }),
+  })};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {VARCHAR(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0", "c1 AS u_c1"})
+                       .planNode();
+
+  struct {
+    core::JoinType joinType;
+    std::vector<std::string> outputLayout;
+    std::string referenceQuery;
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       {"c0", "c1", "u_c1"},
+       "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0"},
+      {core::JoinType::kLeftSemiFilter,
+       {"c0", "c1"},
+       "SELECT t.c0, t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u)"}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(core::joinTypeName(testData.joinType));
+    for (const bool bloomFilterEnabled : {false, true}) {
+      SCOPED_TRACE(fmt::format("bloomFilterEnabled: {}", bloomFilterEnabled));
+      core::PlanNodeId probeScanId;
+      auto op = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(probeType)
+                    .capturePlanNodeId(probeScanId)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        buildSide,
+                        "",
+                        testData.outputLayout,
+                        testData.joinType)
+                    .planNode();
+      SplitInput splits;
+      splits.emplace(probeScanId, probeSplits);
+
+      HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+          .planNode(std::move(op))
+          .inputSplits(splits)
+          .config(
+              core::QueryConfig::kJoinBloomFilterEnabled,
+              bloomFilterEnabled ? "true" : "false")
+          .referenceQuery(testData.referenceQuery)
+          .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+            SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+            if (hasSpill || !bloomFilterEnabled) {
+              ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+              ASSERT_EQ(0, getFiltersAccepted(task, 0).sum);
+              ASSERT_EQ(getInputPositions(task, 1), numRowsProbe * numSplits);
+            } else {
+              ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+              ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+              // A Bloom filter has false positives, so the join is never
+              // replaced with the pushed down filter.
+              ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+              ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+            }
+          })
+          .run();
+    }
+  }
+}
+
 } // namespace
+
+TEST_F(HashJoinTest, hashTableCache) {
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector(
+      {"t_k0", "t_v0"},
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 300; }),
+       makeFlatVector<int64_t>(1'000, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> buildVectors = {makeRowVector(
+      {"u_k0", "u_v0"},
+      {makeFlatVector<int32_t>(200, [](auto row) { return row * 2; }),
+       makeFlatVector<int64_t>(200, [](auto row) { return row; })})};
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto makePlan = [&](core::JoinType joinType) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probeVectors)
+        .hashJoin(
+            {"t_k0"},
+            {"u_k0"},
+            PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode(),
+            "",
+            {"t_k0", "t_v0", "u_v0"},
+            joinType,
+            false,
+            true)
+        .planNode();
+  };
+
+  // All the tasks of the query get the same build side input. The first task
+  // builds the table and the others use it.
+  const auto plan = makePlan(core::JoinType::kLeft);
+  auto queryCtx = std::make_shared<core::QueryCtx>(driverExecutor_.get());
+  std::vector<std::shared_ptr<Task>> tasks;
+  for (auto i = 0; i < 3; ++i) {
+    tasks.push_back(
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .queryCtx(queryCtx)
+            .maxDrivers(2)
+            .assertResults(
+                "SELECT t_k0, t_v0, u_v0 FROM t LEFT JOIN u ON t_k0 = u_k0"));
+  }
+  for (auto i = 0; i < tasks.size(); ++i) {
+    auto buildStats = tasks[i]
+                          ->taskStats()
+                          .pipelineStats.back()
+                          .operatorStats.back()
+                          .runtimeStats;
+    ASSERT_EQ(buildStats.count("cachedHashTable"), i == 0 ? 0 : 1);
+  }
+
+  // A query with a new QueryCtx builds its own table.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_).assertResults(
+      "SELECT t_k0, t_v0, u_v0 FROM t LEFT JOIN u ON t_k0 = u_k0");
+  ASSERT_EQ(
+      task->taskStats()
+          .pipelineStats.back()
+          .operatorStats.back()
+          .runtimeStats.count("cachedHashTable"),
+      0);
+
+  // The probe side of right joins marks the build side rows.
+  VELOX_ASSERT_THROW(
+      makePlan(core::JoinType::kRight),
+      "Hash table cache is not supported for RIGHT join");
+}
@@ -541,6 +541,16 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+TEST_P(HashTableTest, parallelBuildManyPartitions) {
+  // The table has well over 64K slots per build thread, so that with parallel
+  // build each thread inserts the rows of several cache sized partitions.
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  testCycle(BaseHashTable::HashMode::kHash, 300000, 2, type, 6);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -689,6 +699,37 @@ TEST_P(HashTableTest, arrayProbeNormalizedKey) {
   ASSERT_EQ(table->hashMode(), BaseHashTable::HashMode::kNormalizedKey);
 }
 
+TEST_P(HashTableTest, normalizedKeyFallback) {
+  auto table = createHashTableForAggregation(ROW({"a"}, {BIGINT()}), 1);
+  auto lookup = std::make_unique<HashLookup>(table->hashers());
+
+  // More distinct keys than a hasher keeps track of, so that the key is
+  // mapped by range.
+  auto data = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(
+          VectorHasher::kMaxDistinct + 1, [](auto row) { return row; }),
+  });
+  insertGroups(*data, *lookup, *table);
+
+  // Every batch doubles the key range, so that each batch inserts all the rows
+  // again into a new kNormalizedKey table, while adding only a few rows.
+  for (auto i = 0; i < 20; ++i) {
+    data = vectorMaker_->rowVector({
+        vectorMaker_->flatVector<int64_t>(
+            10, [&](auto row) { return (1L << (20 + i)) + row; }),
+    });
+    insertGroups(*data, *lookup, *table);
+  }
+
+  ASSERT_EQ(table->hashMode(), BaseHashTable::HashMode::kHash);
+  const auto stats = table->stats();
+  ASSERT_TRUE(stats.hashModeFallback);
+  ASSERT_GE(stats.numHashModeChanges, 4);
+  ASSERT_EQ(stats.numDistinct, VectorHasher::kMaxDistinct + 1 + 20 * 10);
+  ASSERT_GT(stats.numProbes, 0);
+  ASSERT_GE(stats.avgProbeChainLength(), 1);
+}
+
 TEST_P(HashTableTest, regularHashingTableSize) {
   keySpacing_ = 1000;
   auto checkTableSize = [&](BaseHashTable::HashMode mode,
@@ -752,6 +793,25 @@ TEST_P(HashTableTest, checkSizeValidation) {
   ASSERT_EQ(table->capacity(), 512 << 10);
 }
 
+TEST_P(HashTableTest, packedRowPointers) {
+  constexpr int32_t kNumPointers = 100;
+  // loadRow() reads 8 bytes, so the buffer has 2 bytes past the last pointer.
+  std::vector<char> table(
+      kNumPointers * BaseHashTable::kPackedPointerBytes + 2);
+  std::vector<int64_t> rows(kNumPointers);
+  for (auto i = 0; i < kNumPointers; ++i) {
+    BaseHashTable::storeRow(
+        table.data(), i, reinterpret_cast<char*>(&rows[i]));
+  }
+  // Overwriting a pointer does not change its neighbours.
+  BaseHashTable::storeRow(table.data(), 10, nullptr);
+  for (auto i = 0; i < kNumPointers; ++i) {
+    ASSERT_EQ(
+        i == 10 ? nullptr : reinterpret_cast<char*>(&rows[i]),
+        BaseHashTable::loadRow(table.data(), i));
+  }
+}
+
 TEST_P(HashTableTest, listNullKeyRows) {
   VectorPtr keys = vectorMaker_->flatVector<int64_t>(500, folly::identity);
   testListNullKeyRows(keys, BaseHashTable::HashMode::kArray);
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filesystem>
+
+#include "velox/exec/InputCapture.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/InputReplayer.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/vector/VectorSaver.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class InputCaptureTest : public OperatorTestBase {
+ protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    Type::registerSerDe();
+    core::PlanNode::registerSerDe();
+    core::ITypedExpr::registerSerDe();
+  }
+
+  std::vector<RowVectorPtr> makeVectors(int32_t numVectors) {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numVectors; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(100, [&](auto row) { return i * 100 + row; }),
+          makeFlatVector<StringView>(
+              100, [](auto row) { return StringView::makeInline("xyz"); }),
+      }));
+    }
+    return vectors;
+  }
+};
+
+TEST_F(InputCaptureTest, captureAndReplay) {
+  auto vectors = makeVectors(10);
+  auto directory = TempDirectoryPath::create();
+  core::PlanNodeId filterId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c0 % 3 = 0")
+                  .capturePlanNodeId(filterId)
+                  .project({"c0 + 1"})
+                  .planNode();
+  std::shared_ptr<Task> task;
+  auto expected =
+      AssertQueryBuilder(plan)
+          .config(core::QueryConfig::kInputCaptureDir, directory->path)
+          .config(core::QueryConfig::kInputCapturePlanNodeIds, filterId)
+          .copyResults(pool(), task);
+  ASSERT_EQ(expected->size(), 334);
+
+  // The filter and the project run as one operator, which is captured under
+  // the id of the project.
+  InputReplayer replayer(
+      InputCapture::directory(directory->path, task->taskId(), plan->id()),
+      pool());
+  ASSERT_EQ(replayer.input().size(), vectors.size());
+  for (auto i = 0; i < vectors.size(); ++i) {
+    assertEqualVectors(vectors[i], replayer.input()[i]);
+  }
+
+  auto result = replayer.replay();
+  assertEqualVectors(expected, result.output);
+  ASSERT_GT(result.nodeTiming.count, 0);
+
+  result = replayer.replay(2);
+  ASSERT_EQ(result.output->size(), 2 * expected->size());
+}
+
+TEST_F(InputCaptureTest, notCaptured) {
+  auto directory = TempDirectoryPath::create();
+  auto plan =
+      PlanBuilder().values(makeVectors(2)).filter("c0 % 3 = 0").planNode();
+  std::shared_ptr<Task> task;
+  AssertQueryBuilder(plan)
+      .config(core::QueryConfig::kInputCaptureDir, directory->path)
+      .config(core::QueryConfig::kInputCapturePlanNodeIds, "no-such-node")
+      .copyResults(pool(), task);
+  ASSERT_FALSE(std::filesystem::exists(
+      fmt::format("{}/{}", directory->path, task->taskId())));
+}
+
+TEST_F(InputCaptureTest, sampleAndMaxBytes) {
+  auto vectors = makeVectors(10);
+  auto directory = TempDirectoryPath::create();
+
+  // Batches 0, 4 and 7 are in a 30% sample.
+  InputCapture sampled(directory->path, 0, 30, 1 << 30);
+  for (const auto& vector : vectors) {
+    sampled.capture(*vector);
+  }
+  ASSERT_EQ(sampled.numCaptured(), 3);
+  for (auto batch : {0, 4, 7}) {
+    ASSERT_TRUE(std::filesystem::exists(
+        fmt::format("{}/input_0_{}", directory->path, batch)));
+  }
+
+  std::ostringstream out;
+  saveVector(*vectors[0], out);
+  const auto batchBytes = out.str().size();
+  InputCapture bounded(directory->path, 1, 100, 2 * batchBytes + 1);
+  for (const auto& vector : vectors) {
+    bounded.capture(*vector);
+  }
+  ASSERT_EQ(bounded.numCaptured(), 2);
+  ASSERT_EQ(bounded.capturedBytes(), 2 * batchBytes);
+}
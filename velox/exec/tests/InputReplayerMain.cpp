@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/exec/tests/utils/InputReplayer.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+
+DEFINE_string(
+    capture_dir,
+    "",
+    "Directory of the captured input of a plan node, i.e. "
+    "{input_capture_dir}/{taskId}/{planNodeId}.");
+
+DEFINE_int32(num_runs, 3, "Number of times the plan node is replayed.");
+
+DEFINE_int32(
+    repeat_times,
+    1,
+    "Number of times the captured input is fed to the plan node in each run.");
+
+using namespace facebook::velox;
+
+// Re-executes a plan node over the input captured with the
+// 'input_capture_dir' query config and prints the time of each run. Run
+// under a profiler to see where the plan node spends its time.
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  VELOX_USER_CHECK(!FLAGS_capture_dir.empty(), "--capture_dir is required");
+
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  window::prestosql::registerAllWindowFunctions();
+  Type::registerSerDe();
+  core::PlanNode::registerSerDe();
+  core::ITypedExpr::registerSerDe();
+
+  auto pool = memory::addDefaultLeafMemoryPool();
+  exec::test::InputReplayer replayer(FLAGS_capture_dir, pool.get());
+  uint64_t numRows = 0;
+  for (const auto& input : replayer.input()) {
+    numRows += input->size();
+  }
+  std::cout << "Replaying " << replayer.input().size() << " batches, "
+            << numRows << " rows:" << std::endl
+            << replayer.makePlan()->toString(true, false) << std::endl;
+
+  for (auto run = 0; run < FLAGS_num_runs; ++run) {
+    auto result = replayer.replay(FLAGS_repeat_times);
+    std::cout << "Run " << run << ": " << result.output->size()
+              << " output rows, wall "
+              << succinctMicros(result.wallMicros) << ", plan node "
+              << result.nodeTiming.toString() << std::endl;
+  }
+  return 0;
+}
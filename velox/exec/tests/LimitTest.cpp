@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -97,3 +99,81 @@ TEST_F(LimitTest, limitOverLocalExchange) {
   ASSERT_EQ(20, numRead);
   ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
 }
+
+TEST_F(LimitTest, limitCapsScanBatchSize) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(10'000, [](auto row) { return row; })});
+
+  auto file = TempFilePath::create();
+  writeToFile(file->path, {data});
+
+  // Returns the number of rows the scan produced for 'plan'.
+  auto scanOutputRows = [&](const core::PlanNodePtr& plan,
+                            const core::PlanNodeId& scanNodeId) {
+    std::shared_ptr<exec::Task> task;
+    AssertQueryBuilder(plan)
+        .split(makeHiveConnectorSplit(file->path))
+        .copyResults(pool(), task);
+    return exec::toPlanStats(task->taskStats()).at(scanNodeId).outputRows;
+  };
+
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(data->type()))
+                  .capturePlanNodeId(scanNodeId)
+                  .limit(0, 10, true)
+                  .planNode();
+  EXPECT_EQ(10, scanOutputRows(plan, scanNodeId));
+
+  // Projections do not change the number of rows the Limit needs.
+  plan = PlanBuilder()
+             .tableScan(asRowType(data->type()))
+             .capturePlanNodeId(scanNodeId)
+             .project({"c0 + 1 AS x"})
+             .limit(5, 10, true)
+             .planNode();
+  EXPECT_EQ(15, scanOutputRows(plan, scanNodeId));
+
+  // A filter does.
+  plan = PlanBuilder()
+             .tableScan(asRowType(data->type()))
+             .capturePlanNodeId(scanNodeId)
+             .filter("c0 % 2 = 0")
+             .limit(0, 10, true)
+             .planNode();
+  EXPECT_LT(10, scanOutputRows(plan, scanNodeId));
+}
+
+TEST_F(LimitTest, limitOverLocalExchangeStopsScan) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
+
+  std::vector<std::shared_ptr<TempFilePath>> files;
+  for (auto i = 0; i < 20; ++i) {
+    files.push_back(TempFilePath::create());
+    writeToFile(files.back()->path, {data});
+  }
+
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(data->type()))
+                  .capturePlanNodeId(scanNodeId)
+                  .localPartition({})
+                  .limit(0, 10, true)
+                  .planNode();
+
+  // The scans block after each batch until the Limit takes it. Once the Limit
+  // has its rows, the closed exchange finishes the scans before they read
+  // all splits.
+  std::shared_ptr<exec::Task> task;
+  auto result =
+      AssertQueryBuilder(plan)
+          .splits(makeHiveConnectorSplits(files))
+          .maxDrivers(2)
+          .config(core::QueryConfig::kMaxLocalExchangeBufferSize, "1")
+          .copyResults(pool(), task);
+  ASSERT_EQ(10, result->size());
+  EXPECT_LT(
+      exec::toPlanStats(task->taskStats()).at(scanNodeId).numSplits,
+      files.size());
+}
@@ -279,6 +279,48 @@ TEST_F(LocalPartitionTest, maxBufferSizePartition) {
   verifyExchangeSourceOperatorStats(task, 2100, 42);
 }
 
+TEST_F(LocalPartitionTest, inlineDriverResume) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 21; i++) {
+    vectors.emplace_back(makeRowVector({makeFlatVector<int32_t>(
+        100, [i](auto row) { return -71 + i * 10 + row; })}));
+  }
+
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+
+  auto valuesNode = [&](int start, int end) {
+    return PlanBuilder(planNodeIdGenerator)
+        .values(std::vector<RowVectorPtr>(
+            vectors.begin() + start, vectors.begin() + end))
+        .planNode();
+  };
+
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .localPartition(
+                    {"c0"},
+                    {
+                        valuesNode(0, 7),
+                        valuesNode(7, 14),
+                        valuesNode(14, 21),
+                    })
+                .partialAggregation({"c0"}, {"count(1)"})
+                .planNode();
+
+  // A small buffer makes the producers and the consumers block on each other
+  // at every batch, so that each unblocks the other from its thread.
+  for (const auto& bufferSize : {"100", "10240"}) {
+    SCOPED_TRACE(bufferSize);
+    auto task =
+        AssertQueryBuilder(op, duckDbQueryRunner_)
+            .config(core::QueryConfig::kMaxLocalExchangeBufferSize, bufferSize)
+            .config(core::QueryConfig::kInlineDriverResumeEnabled, "true")
+            .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+    verifyExchangeSourceOperatorStats(task, 2100, 21);
+  }
+}
+
 TEST_F(LocalPartitionTest, multipleExchanges) {
   std::vector<RowVectorPtr> vectors = {
       makeRowVector({
@@ -509,3 +551,46 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, minBatchRows) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 21; i++) {
+    vectors.emplace_back(makeRowVector({makeFlatVector<int32_t>(
+        100, [i](auto row) { return -71 + i * 10 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto valuesNode = [&](int start, int end) {
+    return PlanBuilder(planNodeIdGenerator)
+        .values(std::vector<RowVectorPtr>(
+            vectors.begin() + start, vectors.begin() + end))
+        .planNode();
+  };
+
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .localPartition(
+                    {"c0"},
+                    {
+                        valuesNode(0, 7),
+                        valuesNode(7, 14),
+                        valuesNode(14, 21),
+                    })
+                .partialAggregation({"c0"}, {"count(1)"})
+                .planNode();
+
+  // Each of the 3 producers sends about 25 rows of each input to each of
+  // the 4 partitions. These are sent as dictionaries without batching.
+  auto task = AssertQueryBuilder(op, duckDbQueryRunner_)
+                  .maxDrivers(4)
+                  .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  verifyExchangeSourceOperatorStats(task, 2100, 21 * 4);
+
+  // With batching, a producer sends fewer than 1000 rows to a partition, so
+  // all its rows for a partition are in one batch sent at the end.
+  task = AssertQueryBuilder(op, duckDbQueryRunner_)
+             .maxDrivers(4)
+             .config(core::QueryConfig::kLocalExchangeMinBatchRows, "1000")
+             .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  verifyExchangeSourceOperatorStats(task, 2100, 3 * 4);
+}
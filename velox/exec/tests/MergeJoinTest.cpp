@@ -14,9 +14,11 @@
  * limitations under the License.
  */
 
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -541,3 +543,66 @@ TEST_F(MergeJoinTest, nullKeys) {
   AssertQueryBuilder(plan, duckDbQueryRunner_)
       .assertResults("SELECT * FROM t LEFT JOIN u ON t.t0 = u.u0");
 }
+
+TEST_F(MergeJoinTest, spillRightMatch) {
+  // Most keys on both sides are the same, so that the right side rows with
+  // this key span many batches and exceed the spill memory threshold.
+  std::vector<RowVectorPtr> left;
+  std::vector<RowVectorPtr> right;
+  for (auto i = 0; i < 10; ++i) {
+    const auto offset = i * 100;
+    left.push_back(makeRowVector(
+        {"t0", "t1"},
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return offset + row < 900 ? 7 : 8; }),
+         makeFlatVector<int64_t>(
+             100, [&](auto row) { return offset + row; })}));
+    right.push_back(makeRowVector(
+        {"u0", "u1"},
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return offset + row < 950 ? 7 : 8; }),
+         makeFlatVector<std::string>(100, [&](auto row) {
+           return fmt::format("string value {}", offset + row);
+         })}));
+  }
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId mergeJoinId;
+    auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .values(left)
+            .mergeJoin(
+                {"t0"},
+                {"u0"},
+                PlanBuilder(planNodeIdGenerator).values(right).planNode(),
+                "",
+                {"t0", "t1", "u0", "u1"},
+                joinType)
+            .capturePlanNodeId(mergeJoinId)
+            .planNode();
+
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kMergeJoinSpillEnabled, "true")
+            .config(core::QueryConfig::kMergeJoinSpillMemoryThreshold, "1")
+            .config(core::QueryConfig::kPreferredOutputBatchRows, "1000")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(fmt::format(
+                "SELECT t0, t1, u0, u1 FROM t {} JOIN u ON t0 = u0",
+                joinType == core::JoinType::kLeft ? "LEFT" : "INNER"));
+
+    auto taskStats = toPlanStats(task->taskStats());
+    const auto& stats = taskStats.at(mergeJoinId);
+    ASSERT_GT(stats.spilledBytes, 0);
+    // All the right side rows with key 7 are spilled.
+    ASSERT_EQ(stats.spilledRows, 950);
+    ASSERT_EQ(stats.spilledPartitions, 1);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
@@ -182,3 +182,31 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchRows, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+TEST_F(MergeTest, normalizedKeys) {
+  // Negative and positive integer keys of different widths. Half of the
+  // batches have nulls in the keys, so that batches with and without
+  // normalized keys are merged with each other.
+  vector_size_t batchSize = 500;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 4; ++i) {
+    auto isNullAt = i % 2 == 0 ? nullEvery(7)
+                               : std::function<bool(vector_size_t)>(nullptr);
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](auto row) { return (row * 7919 + i) % 1000 - 500; },
+        isNullAt);
+    auto c1 = makeFlatVector<int8_t>(
+        batchSize, [&](auto row) { return row % 256 - 128; }, isNullAt);
+    auto c2 = makeFlatVector<int32_t>(
+        batchSize, [&](auto row) { return row * i - 1000; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  testSingleKey(vectors, "c0");
+  testSingleKey(vectors, "c1");
+  testSingleKey(vectors, "c2");
+
+  testTwoKeys(vectors, "c1", "c0");
+}
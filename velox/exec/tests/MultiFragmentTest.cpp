@@ -270,6 +270,98 @@ TEST_F(MultiFragmentTest, aggregationMultiKey) {
   }
 }
 
+TEST_F(MultiFragmentTest, rowWisePartitionedOutput) {
+  setupSources(10, 1'000);
+  // Buffer the rows row-wise for 3 or more destinations and use a small
+  // output buffer so that the largest destinations are flushed early.
+  configSettings_[core::QueryConfig::kPartitionedOutputRowWiseDestinations] =
+      "3";
+  configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] =
+      "10000";
+
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan =
+      PlanBuilder().values(vectors_).partitionedOutput({"c0"}, 3).planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  tasks.push_back(leafTask);
+  Task::start(leafTask, 1);
+
+  core::PlanNodePtr exchangePlan;
+  std::vector<std::string> exchangeTaskIds;
+  for (int i = 0; i < 3; i++) {
+    exchangePlan = PlanBuilder()
+                       .exchange(leafPlan->outputType())
+                       .partitionedOutput({}, 1)
+                       .planNode();
+
+    exchangeTaskIds.push_back(makeTaskId("exchange", i));
+    auto task = makeTask(exchangeTaskIds.back(), exchangePlan, i);
+    tasks.push_back(task);
+    Task::start(task, 1);
+    addRemoteSplits(task, {leafTaskId});
+  }
+
+  auto op = PlanBuilder().exchange(exchangePlan->outputType()).planNode();
+  assertQuery(op, exchangeTaskIds, "SELECT * FROM tmp");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+}
+
+TEST_F(MultiFragmentTest, exchangeSourceStats) {
+  setupSources(10, 1'000);
+  // Use a small exchange queue so that the sources share it over many
+  // requests.
+  configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] =
+      "100000";
+
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::string> leafTaskIds;
+  auto leafPlan =
+      PlanBuilder().values(vectors_).partitionedOutput({}, 1).planNode();
+  for (int i = 0; i < 3; i++) {
+    leafTaskIds.push_back(makeTaskId("leaf", i));
+    auto task = makeTask(leafTaskIds.back(), leafPlan, i);
+    tasks.push_back(task);
+    Task::start(task, 1);
+  }
+
+  core::PlanNodeId exchangeNodeId;
+  auto exchangePlan = PlanBuilder()
+                          .exchange(leafPlan->outputType())
+                          .capturePlanNodeId(exchangeNodeId)
+                          .partitionedOutput({}, 1)
+                          .planNode();
+  auto exchangeTaskId = makeTaskId("exchange", 0);
+  auto exchangeTask = makeTask(exchangeTaskId, exchangePlan, 0);
+  Task::start(exchangeTask, 2);
+  addRemoteSplits(exchangeTask, leafTaskIds);
+
+  auto op = PlanBuilder().exchange(exchangePlan->outputType()).planNode();
+  assertQuery(
+      op,
+      {exchangeTaskId},
+      "SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+      "UNION ALL SELECT * FROM tmp");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+  ASSERT_TRUE(waitForTaskCompletion(exchangeTask.get()));
+
+  // One value per source.
+  const auto stats = toPlanStats(exchangeTask->taskStats())
+                         .at(exchangeNodeId)
+                         .customStats;
+  ASSERT_EQ(stats.at("exchangeSourceWaitNanos").count, 3);
+  ASSERT_EQ(stats.at("exchangeSourceRequests").count, 3);
+  ASSERT_GE(stats.at("exchangeSourceRequests").min, 1);
+  ASSERT_EQ(stats.at("exchangeSourceBytes").count, 3);
+  ASSERT_GT(stats.at("exchangeSourceBytes").min, 0);
+}
+
 TEST_F(MultiFragmentTest, distributedTableScan) {
   setupSources(10, 1000);
   // Run the table scan several times to test the caching.
@@ -608,6 +700,57 @@ TEST_F(MultiFragmentTest, limit) {
   ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
 }
 
+TEST_F(MultiFragmentTest, topN) {
+  setupSources(20, 1000);
+
+  std::vector<std::shared_ptr<TempFilePath>> filePaths0(
+      filePaths_.begin(), filePaths_.begin() + 10);
+  std::vector<std::shared_ptr<TempFilePath>> filePaths1(
+      filePaths_.begin() + 10, filePaths_.end());
+  std::vector<std::vector<std::shared_ptr<TempFilePath>>> filePathsList = {
+      filePaths0, filePaths1};
+
+  // Make leaf tasks: TableScan -> PartialTopN(10) -> Repartitioning(0). Each
+  // driver of a leaf task sends only its top 10 rows.
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::string> leafTaskIds;
+  core::PlanNodeId partialTopNId;
+  RowTypePtr outputType;
+  for (int i = 0; i < 2; ++i) {
+    auto leafTaskId = makeTaskId("leaf", i);
+    leafTaskIds.push_back(leafTaskId);
+    auto leafPlan = PlanBuilder()
+                        .tableScan(rowType_)
+                        .topN({"c0 DESC", "c1"}, 10, true)
+                        .capturePlanNodeId(partialTopNId)
+                        .partitionedOutput({}, 1)
+                        .planNode();
+    auto leafTask = makeTask(leafTaskId, leafPlan, i);
+    tasks.push_back(leafTask);
+    Task::start(leafTask, 4);
+    addHiveSplits(leafTask, filePathsList[i]);
+    outputType = leafPlan->outputType();
+  }
+
+  // Make final task: Exchange -> FinalTopN(10).
+  auto plan = PlanBuilder()
+                  .exchange(outputType)
+                  .topN({"c0 DESC", "c1"}, 10, false)
+                  .planNode();
+  assertQueryOrdered(
+      plan,
+      leafTaskIds,
+      "SELECT * FROM tmp ORDER BY c0 DESC NULLS LAST, c1 NULLS LAST LIMIT 10",
+      {0, 1});
+
+  for (auto& leafTask : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+    const auto leafStats = toPlanStats(leafTask->taskStats());
+    // Up to 10 rows per leaf task driver.
+    ASSERT_LE(leafStats.at(partialTopNId).outputRows, 4 * 10);
+  }
+}
+
 TEST_F(MultiFragmentTest, mergeExchangeOverEmptySources) {
   std::vector<std::shared_ptr<Task>> tasks;
   std::vector<std::string> leafTaskIds;
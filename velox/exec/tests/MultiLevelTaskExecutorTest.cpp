@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MultiLevelTaskExecutor.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class MultiLevelTaskExecutorTest : public OperatorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeVectors(int32_t numVectors) {
+    std::vector<RowVectorPtr> vectors;
+    for (int32_t i = 0; i < numVectors; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(1'000, [&](auto row) { return row + i; }),
+          makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+      }));
+    }
+    return vectors;
+  }
+};
+
+TEST_F(MultiLevelTaskExecutorTest, add) {
+  std::atomic<int32_t> numRun{0};
+  {
+    MultiLevelTaskExecutor::Options options;
+    options.numThreads = 3;
+    MultiLevelTaskExecutor executor(options);
+    for (auto i = 0; i < 100; ++i) {
+      executor.add([&]() { ++numRun; });
+    }
+    // The destructor runs the work that is still queued.
+  }
+  EXPECT_EQ(numRun, 100);
+}
+
+TEST_F(MultiLevelTaskExecutorTest, drivers) {
+  const int32_t numDrivers = 4;
+  auto vectors = makeVectors(10);
+  std::vector<RowVectorPtr> expected;
+  for (auto i = 0; i < numDrivers; ++i) {
+    expected.insert(expected.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(expected);
+
+  MultiLevelTaskExecutor::Options options;
+  options.numThreads = 3;
+  // A Driver moves to the second level after any CPU time, so that the
+  // Drivers that block on the local exchange continue on the second level.
+  options.levelThresholdNanos = {1, 1'000'000'000'000};
+  MultiLevelTaskExecutor executor(options);
+  EXPECT_EQ(executor.numLevels(), 3);
+  {
+    auto queryCtx = std::make_shared<core::QueryCtx>(&executor);
+    auto plan = PlanBuilder()
+                    .values(vectors, true)
+                    .localPartition({"c1"})
+                    .project({"c0 + 1 AS c0", "c1"})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .queryCtx(queryCtx)
+        .maxDrivers(numDrivers)
+        .assertResults("SELECT c0 + 1, c1 FROM tmp");
+  }
+
+  const auto stats = executor.stats();
+  EXPECT_GT(stats.numRuns, numDrivers);
+  EXPECT_GE(stats.totalQueuedNanos, stats.maxQueuedNanos);
+  EXPECT_GT(stats.levelCpuNanos[0], 0);
+  EXPECT_GT(stats.levelCpuNanos[1], 0);
+  EXPECT_EQ(stats.levelCpuNanos[2], 0);
+  for (auto numQueued : stats.levelQueuedDrivers) {
+    EXPECT_EQ(numQueued, 0);
+  }
+}
+
+TEST_F(MultiLevelTaskExecutorTest, concurrentQueries) {
+  auto vectors = makeVectors(20);
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .partialAggregation({"c1"}, {"sum(c0)"})
+                  .localPartition({"c1"})
+                  .finalAggregation()
+                  .planNode();
+  auto expected = AssertQueryBuilder(plan).copyResults(pool());
+
+  MultiLevelTaskExecutor::Options options;
+  options.numThreads = 2;
+  options.timeSliceMicros = 1'000;
+  MultiLevelTaskExecutor executor(options);
+  std::vector<RowVectorPtr> results(4);
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      auto queryCtx = std::make_shared<core::QueryCtx>(&executor);
+      queryCtx->setConfigOverridesUnsafe({
+          {core::QueryConfig::kQueryCpuShares, std::to_string(i + 1)},
+      });
+      results[i] = AssertQueryBuilder(plan)
+                       .queryCtx(queryCtx)
+                       .maxDrivers(2)
+                       .copyResults(pool());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& result : results) {
+    assertEqualResults({expected}, {result});
+  }
+  EXPECT_GT(executor.stats().numRuns, 0);
+}
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -22,6 +25,12 @@ using namespace facebook::velox::exec::test;
 
 class NestedLoopJoinTest : public HiveConnectorTestBase {
  protected:
+  static constexpr core::JoinType kJoinTypes[] = {
+      core::JoinType::kInner,
+      core::JoinType::kLeft,
+      core::JoinType::kRight,
+      core::JoinType::kFull};
+
   void SetUp() override {
     HiveConnectorTestBase::SetUp();
   }
@@ -257,3 +266,149 @@ TEST_F(NestedLoopJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(NestedLoopJoinTest, joinCondition) {
+  // Range join of probe timestamps with build intervals. Each probe row matches
+  // a few intervals, some match none and some intervals match no probe row.
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 5; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"t_ts", "t_k"},
+        {makeFlatVector<int32_t>(
+             97, [i](auto row) { return i * 97 + row; }, nullEvery(13)),
+         makeFlatVector<int64_t>(
+             97, [i](auto row) { return i * 100 + row; })}));
+  }
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 3; ++i) {
+    buildVectors.push_back(makeRowVector(
+        {"u_start", "u_end"},
+        {makeFlatVector<int32_t>(
+             41, [i](auto row) { return (i * 41 + row) * 17 % 600; }),
+         makeFlatVector<int32_t>(
+             41,
+             [i](auto row) { return (i * 41 + row) * 17 % 600 + row % 7; },
+             nullEvery(11))}));
+  }
+
+  // The probe runs in 'kNumDrivers' threads and each gets all of
+  // 'probeVectors'.
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> duckDbProbeVectors;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    duckDbProbeVectors.insert(
+        duckDbProbeVectors.end(), probeVectors.begin(), probeVectors.end());
+  }
+  createDuckDbTable("t", duckDbProbeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  for (auto joinType : kJoinTypes) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors, true)
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "t_ts BETWEEN u_start AND u_end",
+                        {"t_k", "t_ts", "u_start", "u_end"},
+                        joinType)
+                    .planNode();
+
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .maxDrivers(kNumDrivers)
+        .config(core::QueryConfig::kPreferredOutputBatchRows, "100")
+        .assertResults(fmt::format(
+            "SELECT t_k, t_ts, u_start, u_end FROM t {} JOIN u "
+            "ON t_ts BETWEEN u_start AND u_end",
+            core::joinTypeName(joinType)));
+  }
+}
+
+TEST_F(NestedLoopJoinTest, emptyBuildWithCondition) {
+  auto probeVectors = {makeRowVector({"t0"}, {sequence<int32_t>(10)})};
+  auto buildVectors = {makeRowVector({"u0"}, {sequence<int32_t>(10)})};
+  createDuckDbTable("t", {probeVectors});
+  createDuckDbTable("u", {buildVectors});
+
+  for (auto joinType : kJoinTypes) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({probeVectors})
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({buildVectors})
+                            .filter("u0 > 100")
+                            .planNode(),
+                        "t0 < u0",
+                        {"t0", "u0"},
+                        joinType)
+                    .planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT t0, u0 FROM t {} JOIN (SELECT * FROM u WHERE u0 > 100) "
+            "ON t0 < u0",
+            core::joinTypeName(joinType)));
+  }
+}
+
+TEST_F(NestedLoopJoinTest, spillBuild) {
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 4; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"t0"}, {makeFlatVector<int64_t>(50, [i](auto row) {
+          return i * 50 + row;
+        })}));
+  }
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 10; ++i) {
+    buildVectors.push_back(makeRowVector(
+        {"u0", "u1"},
+        {makeFlatVector<int64_t>(
+             100, [i](auto row) { return (i * 100 + row) % 300; }),
+         makeFlatVector<std::string>(100, [i](auto row) {
+           return fmt::format("payload {}", i * 100 + row);
+         })}));
+  }
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kFull}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    core::PlanNodeId joinNodeId;
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "t0 + 100 = u0",
+                        {"t0", "u0", "u1"},
+                        joinType)
+                    .capturePlanNodeId(joinNodeId)
+                    .planNode();
+
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kNestedLoopJoinSpillEnabled, "true")
+            .config(
+                core::QueryConfig::kNestedLoopJoinSpillMemoryThreshold, "1")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(fmt::format(
+                "SELECT t0, u0, u1 FROM t {} JOIN u ON t0 + 100 = u0",
+                core::joinTypeName(joinType)));
+
+    auto planStats = toPlanStats(task->taskStats());
+    const auto& stats = planStats.at(joinNodeId);
+    ASSERT_EQ(stats.spilledRows, 1'000);
+    ASSERT_GT(stats.spilledBytes, 0);
+    ASSERT_EQ(stats.spilledPartitions, 1);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
@@ -13,10 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/testutil/TestValue.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Spiller.h"
+#include "velox/exec/Values.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -28,6 +31,7 @@ using namespace facebook::velox;
 using namespace facebook::velox::exec;
 using namespace facebook::velox::core;
 using namespace facebook::velox::exec::test;
+using namespace facebook::velox::common::testutil;
 
 namespace {
 // Returns aggregated spilled stats by 'task'.
@@ -48,6 +52,11 @@ Spiller::Stats spilledStats(const exec::Task& task) {
 
 class OrderByTest : public OperatorTestBase {
  protected:
+  static void SetUpTestCase() {
+    OperatorTestBase::SetUpTestCase();
+    TestValue::enable();
+  }
+
   void SetUp() override {
     filesystems::registerLocalFileSystem();
     if (!isRegisteredVectorSerde()) {
@@ -289,6 +298,126 @@ TEST_F(OrderByTest, multipleKeys) {
       {0, 1});
 }
 
+TEST_F(OrderByTest, normalizedKeys) {
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 2; ++i) {
+    // c0, c1 and c2 are encoded in the normalized key. c3 is a double, so it
+    // is compared on ties.
+    auto c0 = makeFlatVector<int8_t>(
+        batchSize,
+        [](vector_size_t row) { return row % 7 - 3; },
+        nullEvery(5));
+    auto c1 = makeFlatVector<bool>(
+        batchSize,
+        [](vector_size_t row) { return row % 3 == 0; },
+        nullEvery(7));
+    auto c2 = makeFlatVector<int64_t>(
+        batchSize,
+        [](vector_size_t row) { return (row % 11) * (row % 2 ? -1 : 1); },
+        nullEvery(3));
+    auto c3 = makeFlatVector<double>(
+        batchSize, [](vector_size_t row) { return row * 0.1; }, nullEvery(11));
+    vectors.push_back(makeRowVector({c0, c1, c2, c3}));
+  }
+  createDuckDbTable(vectors);
+
+  testSingleKey(vectors, "c0");
+  testSingleKey(vectors, "c1");
+  testTwoKeys(vectors, "c0", "c1");
+  testTwoKeys(vectors, "c1", "c2");
+
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy(
+                      {"c0 DESC NULLS LAST",
+                       "c1 ASC NULLS FIRST",
+                       "c2 DESC NULLS FIRST",
+                       "c3 ASC NULLS LAST"},
+                      false)
+                  .capturePlanNodeId(orderById)
+                  .planNode();
+  runTest(
+      plan,
+      orderById,
+      "SELECT * FROM tmp ORDER BY c0 DESC NULLS LAST, c1 NULLS FIRST, "
+      "c2 DESC NULLS FIRST, c3 NULLS LAST",
+      {0, 1, 2, 3});
+}
+
+TEST_F(OrderByTest, parallelSort) {
+  // Enough rows for sorting the radix sort buckets on the query executor.
+  vector_size_t batchSize = 100'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 11; ++i) {
+    auto c0 = makeFlatVector<int32_t>(
+        batchSize,
+        [&](vector_size_t row) {
+          return folly::hasher<int64_t>()(i * batchSize + row) % 100'000;
+        },
+        nullEvery(13));
+    auto c1 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return i * batchSize + row; });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .values(vectors)
+                        .orderBy({"c0 DESC NULLS LAST", "c1"}, false)
+                        .planNode();
+  params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  assertQueryOrdered(
+      params, "SELECT * FROM tmp ORDER BY c0 DESC NULLS LAST, c1", {0, 1});
+}
+
+TEST_F(OrderByTest, parallelOrderBy) {
+  const int32_t numDrivers = 4;
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](vector_size_t row) { return (row * 17 + i) % 101; },
+        nullEvery(7));
+    auto c1 = makeFlatVector<StringView>(batchSize, [&](vector_size_t row) {
+      return StringView::makeInline(std::to_string(row % 13 + i));
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  // Each driver of a parallelizable Values produces all of 'vectors'.
+  std::vector<RowVectorPtr> expected;
+  for (int32_t i = 0; i < numDrivers; ++i) {
+    expected.insert(expected.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(expected);
+
+  for (const auto& [enabled, expectedDrivers] :
+       std::vector<std::pair<bool, int32_t>>{{false, 1}, {true, numDrivers}}) {
+    SCOPED_TRACE(fmt::format("parallel order by: {}", enabled));
+    core::PlanNodeId orderById;
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .values(vectors, true)
+                          .orderBy({"c0 DESC NULLS FIRST", "c1"}, false)
+                          .capturePlanNodeId(orderById)
+                          .planNode();
+    params.maxDrivers = numDrivers;
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    params.queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kParallelOrderByEnabled,
+         enabled ? "true" : "false"},
+    });
+    auto task = assertQueryOrdered(
+        params, "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST, c1", {0, 1});
+    const auto stats = toPlanStats(task->taskStats()).at(orderById);
+    EXPECT_EQ(stats.numDrivers, expectedDrivers);
+    EXPECT_EQ(stats.inputRows, numDrivers * 3 * batchSize);
+  }
+}
+
 TEST_F(OrderByTest, multiBatchResult) {
   vector_size_t batchSize = 5000;
   std::vector<RowVectorPtr> vectors;
@@ -516,3 +645,65 @@ TEST_F(OrderByTest, spillWithMemoryLimit) {
     OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
   }
 }
+
+DEBUG_ONLY_TEST_F(OrderByTest, reclaimDuringInput) {
+  const int kNumBatches = 5;
+  const int kNumRows = 1'000;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             kNumRows, [i](auto row) { return (row * 7 + i) % 1'000; }),
+         makeFlatVector<StringView>(kNumRows, [](auto row) {
+           return StringView(fmt::format("string value {}", row));
+         })}));
+  }
+  createDuckDbTable(batches);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  // Pauses the task once the order by has received some input and reclaims
+  // from the query memory pool after the pause.
+  std::thread reclaimThread;
+  bool canReclaim{false};
+  uint64_t reclaimedBytes{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Values::getOutput",
+      std::function<void(const exec::Values*)>(
+          ([&](const exec::Values* values) {
+            if (values->testingCurrent() != 2) {
+              return;
+            }
+            auto pauseFuture =
+                values->testingOperatorCtx()->task()->requestPause();
+            reclaimThread = std::thread(
+                [&, pauseFuture = std::move(pauseFuture)]() mutable {
+                  std::move(pauseFuture).wait();
+                  canReclaim = queryCtx->pool()->canReclaim();
+                  reclaimedBytes = queryCtx->pool()->reclaim(0);
+                });
+          })));
+
+  auto task =
+      AssertQueryBuilder(
+          PlanBuilder()
+              .values(batches)
+              .orderBy({"c0 ASC NULLS LAST"}, false)
+              .planNode(),
+          duckDbQueryRunner_)
+          .queryCtx(queryCtx)
+          .spillDirectory(spillDirectory->path)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kOrderBySpillEnabled, "true")
+          .assertResults(
+              "SELECT * FROM tmp ORDER BY c0 ASC NULLS LAST", {{0}});
+  reclaimThread.join();
+
+  ASSERT_TRUE(canReclaim);
+  ASSERT_GT(reclaimedBytes, 0);
+  const auto stats = spilledStats(*task);
+  ASSERT_GT(stats.spilledRows, 0);
+  ASSERT_LT(stats.spilledRows, kNumBatches * kNumRows);
+  ASSERT_EQ(stats.spilledPartitions, 1);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
@@ -16,9 +16,11 @@
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include <gtest/gtest.h>
 #include <velox/common/memory/MemoryAllocator.h>
+#include "velox/common/file/FileSystems.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 using namespace facebook::velox;
@@ -29,6 +31,7 @@ using facebook::velox::test::BatchMaker;
 class PartitionedOutputBufferManagerTest : public testing::Test {
  protected:
   void SetUp() override {
+    filesystems::registerLocalFileSystem();
     pool_ = facebook::velox::memory::addDefaultLeafMemoryPool();
     bufferManager_ = PartitionedOutputBufferManager::getInstance().lock();
     if (!isRegisteredVectorSerde()) {
@@ -45,7 +48,9 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
       const std::string& taskId,
       const RowTypePtr& rowType,
       int numDestinations,
-      int numDrivers) {
+      int numDrivers,
+      std::unordered_map<std::string, std::string> config = {},
+      const std::string& spillDirectory = "") {
     bufferManager_->removeTask(taskId);
 
     auto planFragment = exec::test::PlanBuilder()
@@ -56,7 +61,10 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
         taskId,
         std::move(planFragment),
         0,
-        std::make_shared<core::QueryCtx>(executor_.get()));
+        std::make_shared<core::QueryCtx>(
+            executor_.get(),
+            std::make_shared<core::MemConfig>(std::move(config))));
+    task->setSpillDirectory(spillDirectory);
 
     bufferManager_->initializeTask(task, false, numDestinations, numDrivers);
     return task;
@@ -330,6 +338,66 @@ TEST_F(PartitionedOutputBufferManagerTest, maxBytes) {
   bufferManager_->removeTask(taskId);
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, spool) {
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  const std::string taskId = "t0";
+  // Room for about 3 pages.
+  auto task = initializeTask(
+      taskId,
+      rowType,
+      2,
+      1,
+      {{core::QueryConfig::kSpillEnabled, "true"},
+       {core::QueryConfig::kPartitionedOutputSpoolEnabled, "true"},
+       {core::QueryConfig::kMaxPartitionedOutputBufferSize, "3000"}},
+      spillDirectory->path);
+
+  // The producer is not blocked since the pages are spooled.
+  constexpr int32_t kNumPages = 10;
+  std::vector<std::vector<uint64_t>> pageSizes(2);
+  for (auto i = 0; i < kNumPages; ++i) {
+    for (auto destination = 0; destination < 2; ++destination) {
+      auto page = makeSerializedPage(rowType, 100);
+      pageSizes[destination].push_back(page->size());
+      ContinueFuture future;
+      ASSERT_EQ(
+          bufferManager_->enqueue(
+              taskId, destination, std::move(page), &future),
+          BlockingReason::kNotBlocked);
+    }
+  }
+  noMoreData(taskId);
+  auto fs = filesystems::getFileSystem(spillDirectory->path, nullptr);
+  ASSERT_FALSE(fs->list(spillDirectory->path).empty());
+
+  // The consumers get all pages back in order.
+  for (auto destination = 0; destination < 2; ++destination) {
+    for (auto i = 0; i < kNumPages; ++i) {
+      bool receivedData = false;
+      ASSERT_TRUE(bufferManager_->getData(
+          taskId,
+          destination,
+          1,
+          i,
+          [&](std::vector<std::unique_ptr<folly::IOBuf>> pages,
+              int64_t sequence) {
+            ASSERT_EQ(sequence, i);
+            ASSERT_EQ(pages.size(), 1);
+            ASSERT_TRUE(pages[0] != nullptr);
+            ASSERT_EQ(
+                pages[0]->computeChainDataLength(),
+                pageSizes[destination][i]);
+            receivedData = true;
+          }));
+      ASSERT_TRUE(receivedData);
+    }
+    fetchEndMarker(taskId, destination, kNumPages);
+  }
+  bufferManager_->removeTask(taskId);
+  EXPECT_TRUE(task->isFinished());
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, outOfOrderAcks) {
   std::vector<std::string> names = {"c0", "c1"};
   std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
@@ -408,6 +476,56 @@ TEST_F(PartitionedOutputBufferManagerTest, setQueueErrorWithPendingPages) {
       auto page = queue->dequeueLocked(&atEnd, &future), std::runtime_error);
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, adaptiveQueueConsumers) {
+  auto queue = std::make_shared<ExchangeQueue>(1 << 20);
+  queue->setMaxActiveConsumers(4);
+  std::lock_guard<std::mutex> l(queue->mutex());
+  std::vector<ContinuePromise> promises;
+  auto enqueue = [&]() {
+    queue->enqueueLocked(
+        std::make_unique<SerializedPage>(folly::IOBuf::copyBuffer("", 0)),
+        promises);
+  };
+  bool atEnd;
+
+  // Data trickles in. Every other dequeue of consumer 0 finds the queue
+  // empty, so that consumers are retired down to consumer 0.
+  for (auto i = 0; i < 4 * ExchangeQueue::kAdaptIntervalDequeues; ++i) {
+    ContinueFuture future;
+    ASSERT_EQ(queue->dequeueLocked(&atEnd, &future, 0), nullptr);
+    enqueue();
+    ASSERT_EQ(promises.size(), 1);
+    promises.clear();
+    ASSERT_NE(queue->dequeueLocked(&atEnd, &future, 0), nullptr);
+  }
+  ASSERT_EQ(queue->numActiveConsumersLocked(), 1);
+  ASSERT_EQ(queue->minActiveConsumersLocked(), 1);
+
+  // A retired consumer is not woken by arriving data.
+  ContinueFuture parkedFuture;
+  ASSERT_EQ(queue->dequeueLocked(&atEnd, &parkedFuture, 3), nullptr);
+  ASSERT_FALSE(atEnd);
+  enqueue();
+  ASSERT_TRUE(promises.empty());
+
+  // Pages queue up, so that the consumers are made active again.
+  for (auto i = 0; i < 4 * ExchangeQueue::kAdaptIntervalDequeues; ++i) {
+    enqueue();
+    enqueue();
+  }
+  for (auto i = 0; i < 3 * ExchangeQueue::kAdaptIntervalDequeues; ++i) {
+    ContinueFuture future;
+    ASSERT_NE(queue->dequeueLocked(&atEnd, &future, 0), nullptr);
+  }
+  ASSERT_EQ(queue->numActiveConsumersLocked(), 4);
+  ASSERT_TRUE(promises.empty());
+  enqueue();
+  ASSERT_EQ(promises.size(), 1);
+  promises.back().setValue();
+  ASSERT_TRUE(parkedFuture.isReady());
+  ASSERT_EQ(queue->minActiveConsumersLocked(), 1);
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, serializedPage) {
   const uint64_t kBufferSize = 128;
   // IOBuf managed memory case
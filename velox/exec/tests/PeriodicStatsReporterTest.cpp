@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/PeriodicStatsReporter.h"
+
+#include <folly/Singleton.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// Sums the values reported for each key.
+class TestReporter : public BaseStatsReporter {
+ public:
+  size_t value(folly::StringPiece key) const {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = counters_.find(key.str());
+    return it == counters_.end() ? 0 : it->second;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> l(mutex_);
+    counters_.clear();
+  }
+
+  void addStatExportType(const char* /*key*/, StatType /*statType*/)
+      const override {}
+
+  void addStatExportType(folly::StringPiece /*key*/, StatType /*statType*/)
+      const override {}
+
+  void addHistogramExportPercentiles(
+      const char* /*key*/,
+      int64_t /*bucketWidth*/,
+      int64_t /*min*/,
+      int64_t /*max*/,
+      const std::vector<int32_t>& /*pcts*/) const override {}
+
+  void addHistogramExportPercentiles(
+      folly::StringPiece /*key*/,
+      int64_t /*bucketWidth*/,
+      int64_t /*min*/,
+      int64_t /*max*/,
+      const std::vector<int32_t>& /*pcts*/) const override {}
+
+  void addStatValue(const std::string& key, size_t value) const override {
+    std::lock_guard<std::mutex> l(mutex_);
+    counters_[key] += value;
+  }
+
+  void addStatValue(const char* key, size_t value) const override {
+    addStatValue(std::string(key), value);
+  }
+
+  void addStatValue(folly::StringPiece key, size_t value) const override {
+    addStatValue(key.str(), value);
+  }
+
+  void addHistogramValue(const std::string& /*key*/, size_t /*value*/)
+      const override {}
+
+  void addHistogramValue(const char* /*key*/, size_t /*value*/)
+      const override {}
+
+  void addHistogramValue(folly::StringPiece /*key*/, size_t /*value*/)
+      const override {}
+
+ private:
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, size_t> counters_;
+};
+
+folly::Singleton<BaseStatsReporter> reporter([]() {
+  return new TestReporter();
+});
+
+class PeriodicStatsReporterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    wasRegistered_ = BaseStatsReporter::registered;
+    BaseStatsReporter::registered = true;
+    reporter_ = std::dynamic_pointer_cast<TestReporter>(
+        folly::Singleton<BaseStatsReporter>::try_get());
+    ASSERT_TRUE(reporter_ != nullptr);
+    reporter_->clear();
+
+    memory::MmapAllocator::Options options;
+    options.capacity = 64 << 20;
+    allocator_ = std::make_shared<memory::MmapAllocator>(options);
+    cache_ = std::make_shared<cache::AsyncDataCache>(allocator_, 64 << 20);
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    allocator_.reset();
+    BaseStatsReporter::registered = wasRegistered_;
+  }
+
+  // Looks up the entry that newEntry() makes.
+  void hit() {
+    auto pin = cache_->findOrCreate(kKey, kEntrySize, nullptr);
+    ASSERT_FALSE(pin.empty());
+    ASSERT_TRUE(pin.checkedEntry()->isShared());
+  }
+
+  void newEntry() {
+    auto pin = cache_->findOrCreate(kKey, kEntrySize, nullptr);
+    ASSERT_FALSE(pin.empty());
+    ASSERT_TRUE(pin.checkedEntry()->isExclusive());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+
+  static constexpr cache::RawFileCacheKey kKey{1, 0};
+  static constexpr uint64_t kEntrySize = 1 << 20;
+
+  bool wasRegistered_;
+  std::shared_ptr<TestReporter> reporter_;
+  std::shared_ptr<memory::MmapAllocator> allocator_;
+  std::shared_ptr<cache::AsyncDataCache> cache_;
+};
+
+TEST_F(PeriodicStatsReporterTest, cache) {
+  PeriodicStatsReporter statsReporter(
+      {.allocator = allocator_.get(), .cache = cache_.get()});
+  newEntry();
+  hit();
+  hit();
+  statsReporter.report();
+  EXPECT_EQ(reporter_->value(kCounterCacheNumNew), 1);
+  EXPECT_EQ(reporter_->value(kCounterCacheNumHits), 2);
+  EXPECT_EQ(reporter_->value(kCounterCacheHitBytes), 2 * kEntrySize);
+  EXPECT_EQ(reporter_->value(kCounterCacheHitRatePct), 66);
+  EXPECT_EQ(reporter_->value(kCounterCacheNumEntries), 1);
+  EXPECT_GE(reporter_->value(kCounterCacheTotalBytes), kEntrySize);
+  EXPECT_GE(reporter_->value(kCounterAllocatedBytes), kEntrySize);
+
+  // Cumulative stats are reported as the growth since the last report, so
+  // that their sum is the total.
+  hit();
+  statsReporter.report();
+  EXPECT_EQ(reporter_->value(kCounterCacheNumNew), 1);
+  EXPECT_EQ(reporter_->value(kCounterCacheNumHits), 3);
+  EXPECT_EQ(reporter_->value(kCounterCacheHitRatePct), 166);
+  EXPECT_EQ(reporter_->value(kCounterCacheNumEntries), 2);
+
+  // There is no hit rate for an interval without lookups.
+  statsReporter.report();
+  EXPECT_EQ(reporter_->value(kCounterCacheNumHits), 3);
+  EXPECT_EQ(reporter_->value(kCounterCacheHitRatePct), 166);
+}
+
+TEST_F(PeriodicStatsReporterTest, background) {
+  PeriodicStatsReporter statsReporter(
+      {.cache = cache_.get(), .intervalMs = 10});
+  newEntry();
+  statsReporter.start();
+  while (reporter_->value(kCounterCacheNumNew) == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+  }
+  statsReporter.stop();
+  EXPECT_EQ(reporter_->value(kCounterCacheNumNew), 1);
+}
+
+} // namespace
+} // namespace facebook::velox::exec
@@ -65,6 +65,24 @@ TEST_F(PlanNodeSerdeTest, aggregation) {
                   .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .singleAggregation(
+                 {"c0"}, {"count(c1)", "sum(c1)"}, {}, {true, false})
+             .planNode();
+
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .sortedAggregation(
+                 {"c0"},
+                 {"array_agg(c1)", "sum(c1)"},
+                 {{"c1 DESC NULLS FIRST", "c2"}, {}})
+             .planNode();
+
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, assignUniqueId) {
@@ -98,6 +116,16 @@ TEST_F(PlanNodeSerdeTest, nestedLoopJoin) {
               {"t0", "u1", "t2", "t1"})
           .planNode();
   testSerde(plan);
+
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .nestedLoopJoin(
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "t0 < u0 AND t1 + u1 > 20",
+                 {"t0", "u1", "t2", "t1"},
+                 core::JoinType::kFull)
+             .planNode();
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, enforceSingleRow) {
@@ -118,6 +146,11 @@ TEST_F(PlanNodeSerdeTest, filter) {
   testSerde(plan);
 }
 
+TEST_F(PlanNodeSerdeTest, globalRowNumber) {
+  auto plan = PlanBuilder().values({data_}).globalRowNumber("rn").planNode();
+  testSerde(plan);
+}
+
 TEST_F(PlanNodeSerdeTest, groupId) {
   auto plan = PlanBuilder()
                   .values({data_})
@@ -315,6 +348,20 @@ TEST_F(PlanNodeSerdeTest, topN) {
   testSerde(plan);
 }
 
+TEST_F(PlanNodeSerdeTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({}, {"c0", "c2"}, 10, false)
+                  .planNode();
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({"c0"}, {"c1 DESC NULLS FIRST"}, 5, true)
+             .planNode();
+  testSerde(plan);
+}
+
 TEST_F(PlanNodeSerdeTest, unnest) {
   auto data = makeRowVector({
       makeFlatVector<int64_t>({1, 2, 3}),
@@ -364,6 +411,13 @@ TEST_F(PlanNodeSerdeTest, window) {
              .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .streamingWindow({"sum(c0) over (partition by c1 order by c2)"})
+             .planNode();
+
+  testSerde(plan);
 }
 
 } // namespace facebook::velox::exec::test
@@ -231,6 +231,28 @@ TEST_F(PlanNodeToStringTest, aggregation) {
   ASSERT_EQ(
       "-- Aggregation[SINGLE [c0] a := sum(ROW[\"c1\"]) mask: m1, b := avg(ROW[\"c2\"]) mask: m2] -> c0:BIGINT, a:BIGINT, b:DOUBLE\n",
       plan->toString(true, false));
+
+  // Group-by aggregation with a distinct aggregate.
+  plan = PlanBuilder()
+             .values({data})
+             .singleAggregation(
+                 {"c0"}, {"sum(c1) AS a", "avg(c2) AS b"}, {}, {true, false})
+             .planNode();
+
+  ASSERT_EQ(
+      "-- Aggregation[SINGLE [c0] a := sum(ROW[\"c1\"]) distinct, b := avg(ROW[\"c2\"])] -> c0:BIGINT, a:BIGINT, b:DOUBLE\n",
+      plan->toString(true, false));
+
+  // Group-by aggregation with a sorted aggregate.
+  plan = PlanBuilder()
+             .values({data})
+             .sortedAggregation(
+                 {"c0"}, {"sum(c1) AS a", "avg(c2) AS b"}, {{"c2 DESC"}, {}})
+             .planNode();
+
+  ASSERT_EQ(
+      "-- Aggregation[SINGLE [c0] a := sum(ROW[\"c1\"]) ORDER BY c2 DESC NULLS LAST, b := avg(ROW[\"c2\"])] -> c0:BIGINT, a:BIGINT, b:DOUBLE\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, expand) {
@@ -466,6 +488,28 @@ TEST_F(PlanNodeToStringTest, topN) {
       plan->toString(true, false));
 }
 
+TEST_F(PlanNodeToStringTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({}, {"c0 NULLS FIRST"}, 10, false)
+                  .planNode();
+
+  ASSERT_EQ("-- TopNRowNumber\n", plan->toString());
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [] order by [c0 ASC NULLS FIRST] limit 10] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({"c0"}, {"c1 DESC", "c2"}, 5, true)
+             .planNode();
+
+  ASSERT_EQ("-- TopNRowNumber\n", plan->toString());
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [c0] order by [c1 DESC NULLS LAST, c2 ASC NULLS LAST] limit 5] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT, row_number:BIGINT\n",
+      plan->toString(true, false));
+}
+
 TEST_F(PlanNodeToStringTest, enforceSingleRow) {
   auto plan = PlanBuilder().values({data_}).enforceSingleRow().planNode();
 
@@ -519,6 +563,13 @@ TEST_F(PlanNodeToStringTest, localPartition) {
   ASSERT_EQ(
       "-- LocalPartition[REPARTITION ROUND ROBIN] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder().values({data_}).scaleWriterLocalPartition().planNode();
+
+  ASSERT_EQ("-- LocalPartition\n", plan->toString());
+  ASSERT_EQ(
+      "-- LocalPartition[REPARTITION scaleWriter] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, partitionedOutput) {
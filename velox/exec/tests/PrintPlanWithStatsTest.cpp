@@ -160,7 +160,9 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
        {"     HashBuild: Input: 100 rows \\(.+\\), Output: 0 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1"},
        {"        distinctKey0\\s+sum: 101, count: 1, min: 101, max: 101"},
        {"        hashtable.capacity\\s+sum: 200, count: 1, min: 200, max: 200"},
+       {"        hashtable.hashMode\\s+sum: .+, count: 1, min: .+, max: .+"},
        {"        hashtable.numDistinct\\s+sum: 100, count: 1, min: 100, max: 100"},
+       {"        hashtable.numHashModeChanges\\s+sum: .+, count: 1, min: .+, max: .+"},
        {"        hashtable.numRehashes\\s+sum: 1, count: 1, min: 1, max: 1"},
        {"        queuedWallNanos\\s+sum: .+, count: 1, min: .+, max: .+"},
        {"        rangeKey0\\s+sum: 200, count: 1, min: 200, max: 200"},
@@ -245,9 +247,13 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
          {"   Output: .+, Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1"},
          {"      dataSourceLazyWallNanos\\s+sum: .+, count: 1, min: .+, max: .+"},
          {"      hashtable.capacity\\s+sum: 1252, count: 1, min: 1252, max: 1252"},
+         {"      hashtable.hashMode\\s+sum: .+, count: 1, min: .+, max: .+"},
          {"      hashtable.numDistinct\\s+sum: 835, count: 1, min: 835, max: 835"},
+         {"      hashtable.numHashModeChanges\\s+sum: .+, count: 1, min: .+, max: .+"},
          {"      hashtable.numRehashes\\s+sum: 1, count: 1, min: 1, max: 1"},
-         {"      hashtable.numTombstones    sum: 0, count: 1, min: 0, max: 0"},
+         {"      hashtable.numTombstones\\s+sum: 0, count: 1, min: 0, max: 0"},
+         {"      hashtable.probeChainLengthPct\\s+sum: .+, count: 1, min: .+, max: .+",
+          true}, // Only reported if the table is probed in kHash mode.
          {"      loadedToValueHook\\s+sum: 50000, count: 5, min: 10000, max: 10000"},
          {"  -- TableScan\\[table: hive_table\\] -> c0:BIGINT, c1:INTEGER, c2:SMALLINT, c3:REAL, c4:DOUBLE, c5:VARCHAR"},
          {"     Input: 10000 rows \\(.+\\), Output: 10000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1, Splits: 1"},
@@ -274,3 +280,69 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
          {"        totalScanTime    [ ]* sum: .+, count: .+, min: .+, max: .+"}});
   }
 }
+
+TEST_F(PrintPlanWithStatsTest, driverTimelines) {
+  RowTypePtr rowType{ROW({"c0", "c1"}, {BIGINT(), INTEGER()})};
+  auto vectors = makeVectors(rowType, 10, 1'000);
+  createDuckDbTable(vectors);
+
+  auto op = PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c1"}, {"sum(c0)"})
+                .planNode();
+
+  for (const auto timelineEnabled : {false, true}) {
+    SCOPED_TRACE(fmt::format("timelineEnabled {}", timelineEnabled));
+    auto task =
+        AssertQueryBuilder(op, duckDbQueryRunner_)
+            .config(
+                core::QueryConfig::kDriverTimelineEnabled,
+                timelineEnabled ? "true" : "false")
+            .assertResults("SELECT c1, sum(c0) FROM tmp GROUP BY 1");
+    ensureTaskCompletion(task.get());
+
+    auto stats = task->taskStats();
+    ASSERT_EQ(stats.pipelineStats.size(), 1);
+    const auto& pipelineStats = stats.pipelineStats[0];
+    ASSERT_EQ(pipelineStats.driverStats.size(), 1);
+    ASSERT_EQ(pipelineStats.driverRunningWallNanos.count, 1);
+    ASSERT_EQ(
+        pipelineStats.driverRunningWallNanos.sum,
+        static_cast<int64_t>(pipelineStats.runningWallNanos));
+    const auto& driverStats = pipelineStats.driverStats[0];
+    ASSERT_EQ(driverStats.runningWallNanos, pipelineStats.runningWallNanos);
+
+    auto trace = toDriverTimelinesJson(stats);
+    if (!timelineEnabled) {
+      ASSERT_TRUE(driverStats.timeline.empty());
+      ASSERT_TRUE(trace["traceEvents"].empty());
+      continue;
+    }
+
+    // The Driver is queued before each run.
+    const auto& timeline = driverStats.timeline;
+    ASSERT_GE(timeline.size(), 2);
+    ASSERT_EQ(timeline[0].kind, exec::DriverStats::EventKind::kQueued);
+    ASSERT_EQ(timeline[1].kind, exec::DriverStats::EventKind::kRunning);
+    uint64_t runningMicros = 0;
+    for (auto i = 0; i < timeline.size(); ++i) {
+      if (i > 0) {
+        ASSERT_GE(timeline[i].startMicros, timeline[i - 1].startMicros);
+      }
+      if (timeline[i].kind == exec::DriverStats::EventKind::kRunning) {
+        runningMicros += timeline[i].durationMicros;
+      }
+    }
+    ASSERT_EQ(runningMicros * 1'000, driverStats.runningWallNanos);
+
+    ASSERT_EQ(trace["traceEvents"].size(), timeline.size());
+    const auto& event = trace["traceEvents"][1];
+    ASSERT_EQ(event["name"].asString(), "running");
+    ASSERT_EQ(event["ph"].asString(), "X");
+    ASSERT_EQ(event["pid"].asInt(), 0);
+    ASSERT_EQ(event["tid"].asInt(), 0);
+    ASSERT_EQ(
+        event["dur"].asInt(),
+        static_cast<int64_t>(timeline[1].durationMicros));
+  }
+}
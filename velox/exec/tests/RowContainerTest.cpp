@@ -1036,3 +1036,138 @@ TEST_F(RowContainerTest, probedFlag) {
           {true, true, true, true, std::nullopt, true}),
       result);
 }
+
+TEST_F(RowContainerTest, extractColumns) {
+  constexpr int32_t kNumRows = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row * 3; }),
+      makeFlatVector<int32_t>(kNumRows, [](auto row) { return row; }),
+      makeNullableFlatVector<int64_t>(
+          kNumRows,
+          [](auto row) { return row - 100; },
+          [](auto row) { return row % 7 == 0; }),
+      makeNullableFlatVector<int16_t>(
+          kNumRows,
+          [](auto row) { return row % 100; },
+          [](auto row) { return row % 11 == 0; }),
+      makeFlatVector<double>(kNumRows, [](auto row) { return row * 0.5; }),
+      makeFlatVector<std::string>(
+          kNumRows, [](auto row) { return std::string(row % 20, 'x'); }),
+      makeFlatVector<bool>(kNumRows, [](auto row) { return row % 3 == 0; }),
+      makeFlatVector<Timestamp>(
+          kNumRows, [](auto row) { return Timestamp(row, row); }),
+  });
+  const auto& types = asRowType(input->type())->children();
+  std::vector<TypePtr> keys(types.begin(), types.begin() + 2);
+  std::vector<TypePtr> dependents(types.begin() + 2, types.end());
+  auto data = makeRowContainer(keys, dependents);
+
+  std::vector<char*> rows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = data->newRow();
+  }
+  SelectivityVector allRows(kNumRows);
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    DecodedVector decoded(*input->childAt(column), allRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+
+  auto assertExtractColumns = [&](const std::vector<char*>& extractRows) {
+    std::vector<column_index_t> columns(input->childrenSize());
+    std::iota(columns.begin(), columns.end(), 0);
+    std::vector<VectorPtr> results;
+    for (const auto& type : types) {
+      results.push_back(BaseVector::create(type, 0, pool_.get()));
+    }
+    data->extractColumns(
+        extractRows.data(), extractRows.size(), columns, results);
+    for (auto column = 0; column < columns.size(); ++column) {
+      auto expected = BaseVector::create(types[column], 0, pool_.get());
+      expected->resize(extractRows.size());
+      data->extractColumn(
+          extractRows.data(), extractRows.size(), column, expected);
+      assertEqualVectors(expected, results[column]);
+    }
+  };
+
+  assertExtractColumns(rows);
+
+  // Rows that are not found in a join are extracted as nulls.
+  auto someNullRows = rows;
+  for (auto i = 0; i < kNumRows; i += 5) {
+    someNullRows[i] = nullptr;
+  }
+  assertExtractColumns(someNullRows);
+
+  // A number of rows that is not a multiple of the block size.
+  assertExtractColumns({rows.begin() + 10, rows.begin() + 107});
+}
+
+TEST_F(RowContainerTest, stringKeyPrefix) {
+  // Strings that differ in and after the characters kept in the row with
+  // the string key prefix, inline and not.
+  std::vector<std::string> strings = {
+      "",
+      "abc",
+      "abcd",
+      "abcdefghijk",
+      "abcdefghijkl",
+      "abcdefghijklm",
+      "abcdefghijklmnopqrstuvwxyz",
+      "abcdefghijklmnopqrstuvwxyZ",
+      "abcdefghijkLmnopqrstuvwxyz",
+      "abcdEfghijklmnopqrstuvwxyz",
+      "abcdefghijklmnopqrstuvwxyz0",
+      std::string(1'000, 'a'),
+      std::string(1'000, 'a') + "b",
+  };
+  auto input = makeRowVector({
+      makeFlatVector<std::string>(strings),
+      makeFlatVector<int64_t>(strings.size(), [](auto row) { return row; }),
+  });
+  const auto& types = asRowType(input->type())->children();
+  const auto rowSize =
+      makeRowContainer({VARCHAR()}, {BIGINT()})->fixedRowSize();
+
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_row_container_string_key_prefix = true;
+  auto data = makeRowContainer({VARCHAR()}, {BIGINT()});
+  ASSERT_EQ(
+      data->fixedRowSize(),
+      rowSize + StringView::kInlineSize - StringView::kPrefixSize);
+
+  SelectivityVector allRows(strings.size());
+  std::vector<char*> rows(strings.size());
+  for (auto i = 0; i < strings.size(); ++i) {
+    rows[i] = data->newRow();
+  }
+  for (auto column = 0; column < types.size(); ++column) {
+    DecodedVector decoded(*input->childAt(column), allRows);
+    for (auto i = 0; i < strings.size(); ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+
+  auto extracted = BaseVector::create(VARCHAR(), strings.size(), pool_.get());
+  data->extractColumn(rows.data(), rows.size(), 0, extracted);
+  assertEqualVectors(input->childAt(0), extracted);
+
+  DecodedVector decoded(*input->childAt(0), allRows);
+  for (auto i = 0; i < strings.size(); ++i) {
+    for (auto j = 0; j < strings.size(); ++j) {
+      auto expected = sign(strings[i].compare(strings[j]));
+      EXPECT_EQ(
+          data->equals<false>(rows[i], data->columnAt(0), decoded, j),
+          expected == 0)
+          << strings[i] << " " << strings[j];
+      EXPECT_EQ(
+          sign(data->compare(rows[i], data->columnAt(0), decoded, j)),
+          expected)
+          << strings[i] << " " << strings[j];
+      EXPECT_EQ(sign(data->compare(rows[i], rows[j], 0)), expected)
+          << strings[i] << " " << strings[j];
+    }
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SpillIoScheduler.h"
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include "velox/common/base/tests/GTestUtils.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+void waitForQueueDepth(const SpillIoDevice& device, int32_t depth) {
+  while (device.stats().maxQueueDepth < depth) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+} // namespace
+
+TEST(SpillIoSchedulerTest, deviceFor) {
+  SpillIoScheduler scheduler;
+  ASSERT_EQ(nullptr, scheduler.deviceFor("/disk1/spill"));
+  scheduler.addDevice("/disk1", {});
+  scheduler.addDevice("/disk1/fast", {});
+  VELOX_ASSERT_THROW(
+      scheduler.addDevice("/disk1", {}), "Spill device is already registered");
+
+  ASSERT_EQ("/disk1", scheduler.deviceFor("/disk1/spill")->path());
+  ASSERT_EQ("/disk1/fast", scheduler.deviceFor("/disk1/fast/spill")->path());
+  ASSERT_EQ(nullptr, scheduler.deviceFor("/disk2/spill"));
+
+  scheduler.deviceFor("/disk1/spill")->write("q", 10, []() {});
+  const auto stats = scheduler.stats();
+  ASSERT_EQ(2, stats.size());
+  ASSERT_EQ("/disk1", stats[0].path);
+  ASSERT_EQ(1, stats[0].numWrites);
+  ASSERT_EQ(10, stats[0].writtenBytes);
+  ASSERT_EQ(0, stats[1].numWrites);
+}
+
+TEST(SpillIoSchedulerTest, fairAdmission) {
+  SpillIoDevice device("/disk", {.maxConcurrentWrites = 1});
+  std::mutex mutex;
+  std::vector<std::string> order;
+  auto write = [&](const std::string& name) {
+    return [&, name]() {
+      std::lock_guard<std::mutex> l(mutex);
+      order.push_back(name);
+    };
+  };
+
+  // Occupies the only write slot until released.
+  folly::Baton<> blockerStarted;
+  folly::Baton<> releaseBlocker;
+  std::thread blocker([&]() {
+    device.write("a", 1, [&]() {
+      blockerStarted.post();
+      releaseBlocker.wait();
+    });
+  });
+  blockerStarted.wait();
+
+  // Query 'a' queues two writes before query 'b' queues one.
+  std::vector<std::thread> threads;
+  int32_t depth = 0;
+  for (const auto& [queryId, name] :
+       std::vector<std::pair<std::string, std::string>>{
+           {"a", "a1"}, {"a", "a2"}, {"b", "b1"}}) {
+    threads.emplace_back([&, queryId = queryId, name = name]() {
+      device.write(queryId, 1, write(name));
+    });
+    waitForQueueDepth(device, ++depth);
+  }
+  releaseBlocker.post();
+  blocker.join();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // 'b' gets its turn before the second write of 'a'.
+  ASSERT_EQ((std::vector<std::string>{"a1", "b1", "a2"}), order);
+  const auto stats = device.stats();
+  ASSERT_EQ(4, stats.numWrites);
+  ASSERT_EQ(3, stats.maxQueueDepth);
+  ASSERT_GT(stats.waitNanos, 0);
+}
+
+TEST(SpillIoSchedulerTest, bandwidthLimit) {
+  constexpr uint64_t kMB = 1 << 20;
+  SpillIoDevice device("/disk", {.maxBytesPerSec = 20 * kMB});
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 5; ++i) {
+    threads.emplace_back([&]() { device.write("q", 2 * kMB, []() {}); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // 10MB at 20MB/s. The first write starts right away.
+  ASSERT_GE(elapsed, std::chrono::milliseconds(400));
+  const auto stats = device.stats();
+  ASSERT_EQ(5, stats.numWrites);
+  ASSERT_EQ(10 * kMB, stats.writtenBytes);
+  ASSERT_GE(stats.waitNanos, 400'000'000);
+}
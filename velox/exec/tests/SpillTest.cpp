@@ -14,10 +14,12 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -372,6 +374,212 @@ TEST_F(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_F(SpillTest, readAheadMerge) {
+  // Run 'run' has the values 'run', 'run' + kNumRuns, 'run' + 2 * kNumRuns
+  // and so on, in batches of 'kBatchSize' rows. Merging the runs gives all
+  // values in order.
+  constexpr int32_t kNumRuns = 8;
+  constexpr int32_t kNumBatches = 3 * FileSpillMergeStream::kReadAheadBatches;
+  constexpr int32_t kBatchSize = 10;
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto* readExecutor :
+       std::vector<folly::Executor*>{nullptr, &executor}) {
+    SCOPED_TRACE(fmt::format("read ahead: {}", readExecutor != nullptr));
+    SpillState state(
+        fmt::format("{}/readAhead-{}", tempDir_->path, readExecutor != nullptr),
+        1,
+        1,
+        {},
+        kGB,
+        *pool());
+    state.setPartitionSpilled(0);
+    for (auto run = 0; run < kNumRuns; ++run) {
+      for (auto batch = 0; batch < kNumBatches; ++batch) {
+        state.appendToPartition(
+            0,
+            makeRowVector({makeFlatVector<int64_t>(
+                kBatchSize, [&](auto row) {
+                  return (batch * kBatchSize + row) * kNumRuns + run;
+                })}));
+      }
+      state.finishWrite(0);
+    }
+    ASSERT_EQ(kNumRuns, state.spilledFiles());
+
+    auto merge = state.startMerge(0, nullptr, readExecutor);
+    for (auto i = 0; i < kNumRuns * kNumBatches * kBatchSize; ++i) {
+      auto* stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
+TEST_F(SpillTest, columnarFormat) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 3, 4, 5, 6}),
+      makeNullableFlatVector<std::string>(
+          {"short",
+           std::nullopt,
+           "a string that is too long to be inlined",
+           "",
+           "another long string that is not inlined",
+           "x"}),
+      makeFlatVector<bool>({true, false, true, true, false, true}),
+      makeFlatVector<Timestamp>(
+          {Timestamp{0, 0},
+           Timestamp{1, 17'123'456},
+           Timestamp{-1, 17'123'456},
+           Timestamp{12, 0},
+           Timestamp{3, 3},
+           Timestamp{4, 4}}),
+      // A dictionary is written flat.
+      wrapInDictionary(
+          makeIndices({5, 4, 3, 2, 1, 0}),
+          makeNullableFlatVector<double>(
+              {1.5, 2.5, std::nullopt, 4.5, 5.5, 6.5})),
+  });
+  auto rowType = asRowType(data->type());
+  ASSERT_TRUE(isColumnarSpillable(*rowType));
+  ASSERT_FALSE(isColumnarSpillable(*ROW({"a"}, {ARRAY(BIGINT())})));
+  ASSERT_EQ(
+      SpillFileFormat::kColumnar,
+      spillFileFormatFromName(spillFileFormatName(SpillFileFormat::kColumnar)));
+  VELOX_ASSERT_THROW(spillFileFormatFromName("orc"), "Unknown spill file");
+
+  SpillFileList list(
+      rowType,
+      0,
+      {},
+      tempDir_->path + "/columnar",
+      kGB,
+      *pool(),
+      SpillFileOptions{.format = SpillFileFormat::kColumnar});
+  // A batch of rows 1-2 and 4-5, then a batch of all rows.
+  std::vector<IndexRange> ranges{{1, 2}, {4, 2}};
+  list.write(data, folly::Range<IndexRange*>(ranges.data(), ranges.size()));
+  IndexRange all{0, data->size()};
+  list.write(data, folly::Range<IndexRange*>(&all, 1));
+  auto files = list.files();
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(SpillFileFormat::kColumnar, files[0]->format());
+
+  // Returns rows [offset, offset + size) of 'data'.
+  auto rows = [&](vector_size_t offset, vector_size_t size) {
+    std::vector<VectorPtr> children;
+    for (const auto& child : data->children()) {
+      children.push_back(child->slice(offset, size));
+    }
+    return makeRowVector(children);
+  };
+  auto input = files[0]->makeInput(*pool());
+  RowVectorPtr batch;
+  ASSERT_TRUE(files[0]->nextBatch(*input, *pool(), batch));
+  ASSERT_EQ(4, batch->size());
+  facebook::velox::test::assertEqualVectors(rows(1, 2), batch->slice(0, 2));
+  facebook::velox::test::assertEqualVectors(rows(4, 2), batch->slice(2, 2));
+  ASSERT_TRUE(files[0]->nextBatch(*input, *pool(), batch));
+  facebook::velox::test::assertEqualVectors(data, batch);
+  // The values are read in place, not copied.
+  ASSERT_TRUE(batch->childAt(0)->values()->isView());
+  ASSERT_TRUE(batch->childAt(0)->nulls()->isView());
+  ASSERT_EQ(VectorEncoding::Simple::FLAT, batch->childAt(4)->encoding());
+  ASSERT_FALSE(files[0]->nextBatch(*input, *pool(), batch));
+
+  // A type that can't be spilled in columnar format falls back to Presto.
+  auto arrays = makeRowVector({makeArrayVector<int64_t>({{1, 2}, {3}})});
+  SpillFileList arrayList(
+      asRowType(arrays->type()),
+      0,
+      {},
+      tempDir_->path + "/arrays",
+      kGB,
+      *pool(),
+      SpillFileOptions{.format = SpillFileFormat::kColumnar});
+  IndexRange arrayRange{0, arrays->size()};
+  arrayList.write(arrays, folly::Range<IndexRange*>(&arrayRange, 1));
+  auto arrayFiles = arrayList.files();
+  ASSERT_EQ(SpillFileFormat::kPresto, arrayFiles[0]->format());
+  auto arrayInput = arrayFiles[0]->makeInput(*pool());
+  ASSERT_TRUE(arrayFiles[0]->nextBatch(*arrayInput, *pool(), batch));
+  facebook::velox::test::assertEqualVectors(arrays, batch);
+}
+
+TEST_F(SpillTest, compression) {
+  if (!folly::io::hasCodec(folly::io::CodecType::ZSTD)) {
+    GTEST_SKIP() << "ZSTD is not available";
+  }
+  ASSERT_EQ(folly::io::CodecType::ZSTD, spillCompressionFromName("zstd"));
+  VELOX_ASSERT_THROW(
+      spillCompressionFromName("brotli"), "Unknown spill compression codec");
+
+  // 100 batches of compressible data make several frames.
+  constexpr int32_t kNumBatches = 100;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 100; }),
+      makeFlatVector<std::string>(
+          1'000,
+          [](auto row) {
+            return fmt::format("a string that repeats {}", row % 10);
+          }),
+  });
+  IndexRange all{0, data->size()};
+  folly::CPUThreadPoolExecutor executor(2);
+  uint64_t uncompressedBytes{0};
+  for (auto format : {SpillFileFormat::kPresto, SpillFileFormat::kColumnar}) {
+    for (auto compressed : {false, true}) {
+      for (auto* writeExecutor :
+           std::vector<folly::Executor*>{nullptr, &executor}) {
+        SCOPED_TRACE(fmt::format(
+            "{} compressed: {} async: {}",
+            spillFileFormatName(format),
+            compressed,
+            writeExecutor != nullptr));
+        SpillFileList list(
+            asRowType(data->type()),
+            0,
+            {},
+            fmt::format(
+                "{}/compression-{}-{}-{}",
+                tempDir_->path,
+                spillFileFormatName(format),
+                compressed,
+                writeExecutor != nullptr),
+            kGB,
+            *pool(),
+            SpillFileOptions{
+                .format = format,
+                .compression = compressed
+                    ? folly::io::CodecType::ZSTD
+                    : folly::io::CodecType::NO_COMPRESSION,
+                .writeExecutor = writeExecutor});
+        for (auto i = 0; i < kNumBatches; ++i) {
+          list.write(data, folly::Range<IndexRange*>(&all, 1));
+        }
+        auto files = list.files();
+        ASSERT_EQ(1, files.size());
+        ASSERT_EQ(files[0]->size(), list.spilledBytes());
+        if (!compressed) {
+          uncompressedBytes = files[0]->size();
+        } else {
+          ASSERT_LT(files[0]->size() * 2, uncompressedBytes);
+        }
+        ASSERT_GT(files[0]->size(), 0);
+
+        auto input = files[0]->makeInput(*pool());
+        RowVectorPtr batch;
+        for (auto i = 0; i < kNumBatches; ++i) {
+          ASSERT_TRUE(files[0]->nextBatch(*input, *pool(), batch));
+          facebook::velox::test::assertEqualVectors(data, batch);
+        }
+        ASSERT_FALSE(files[0]->nextBatch(*input, *pool(), batch));
+      }
+    }
+  }
+}
+
 TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
@@ -391,6 +599,57 @@ TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   spillStateTest(1, 2, 10, 10, {}, 10 * 2);
 }
 
+TEST_F(SpillTest, stripedSpillDevices) {
+  // The partitions are striped over two directories. The first one is a
+  // registered spill device that the writes are scheduled on.
+  auto stripeDir = exec::test::TempDirectoryPath::create();
+  SpillIoScheduler::getInstance().addDevice(
+      tempDir_->path, {.maxConcurrentWrites = 1});
+  SpillFileOptions options;
+  options.queryId = "striped";
+  options.stripePaths = {stripeDir->path + "/stripe"};
+  SpillState state(
+      tempDir_->path + "/striped", 4, 1, {}, kGB, *pool(), options);
+  for (auto partition = 0; partition < 4; ++partition) {
+    state.setPartitionSpilled(partition);
+    state.appendToPartition(
+        partition,
+        makeRowVector({makeFlatVector<int64_t>(
+            100, [&](auto row) { return row * 4 + partition; })}));
+    state.finishWrite(partition);
+  }
+
+  const auto paths = state.testingSpilledFilePaths();
+  ASSERT_EQ(4, paths.size());
+  for (auto partition = 0; partition < 4; ++partition) {
+    const auto& expectedDir =
+        partition % 2 == 0 ? tempDir_->path : stripeDir->path;
+    ASSERT_EQ(0, paths[partition].find(expectedDir)) << paths[partition];
+  }
+
+  const auto* device =
+      SpillIoScheduler::getInstance().deviceFor(tempDir_->path + "/striped");
+  ASSERT_NE(nullptr, device);
+  const auto stats = device->stats();
+  // One buffered write per partition on the device.
+  ASSERT_EQ(2, stats.numWrites);
+  ASSERT_GT(stats.writtenBytes, 0);
+  ASSERT_LT(stats.writtenBytes, state.spilledBytes());
+
+  for (auto partition = 0; partition < 4; ++partition) {
+    auto merge = state.startMerge(partition, nullptr);
+    for (auto i = 0; i < 100; ++i) {
+      auto* stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(
+          i * 4 + partition,
+          stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
 TEST_F(SpillTest, spillPartitionId) {
   SpillPartitionId partitionId1_2(1, 2);
   ASSERT_EQ(partitionId1_2.partitionBitOffset(), 1);
@@ -67,6 +67,12 @@ struct TestParamsBuilder {
     std::vector<TestParam> params;
     for (int i = 0; i < Spiller::kNumTypes; ++i) {
       const auto type = static_cast<Spiller::Type>(i);
+      // MergeJoin and NestedLoopJoin write their spill files directly without
+      // a Spiller.
+      if (type == Spiller::Type::kMergeJoin ||
+          type == Spiller::Type::kNestedLoopJoinBuild) {
+        continue;
+      }
       if (typesToExclude.find(type) == typesToExclude.end()) {
         for (int poolSize : {0, 8}) {
           params.emplace_back(type, poolSize);
@@ -90,6 +96,12 @@ void setSequentialValue(
   }
 }
 
+// Returns true if the spiller 'type' only uses one spill partition.
+bool isSinglePartitionType(Spiller::Type type) {
+  return type == Spiller::Type::kOrderBy || type == Spiller::Type::kWindow ||
+      type == Spiller::Type::kTopNRowNumber || type == Spiller::Type::kTopN;
+}
+
 void resizeVector(RowVector& vector, vector_size_t size) {
   vector.prepareForReuse();
   vector.resize(size);
@@ -109,7 +121,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(0, isSinglePartitionType(type_) ? 0 : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -402,9 +414,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (isSinglePartitionType(type_)) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -432,7 +444,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (isSinglePartitionType(type_)) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -829,7 +841,10 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow,
+             Spiller::Type::kTopNRowNumber,
+             Spiller::Type::kTopN}}
         .getTestParams();
   }
 };
@@ -1013,7 +1028,7 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (isSinglePartitionType(type_) || type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
@@ -217,6 +217,35 @@ TEST_F(StreamingAggregationTest, multipleKeys) {
   testMultiKeyAggregation(keys, 3);
 }
 
+TEST_F(StreamingAggregationTest, sequenceKeys) {
+  // Run-length encoded keys. The keys are compared only where a run starts.
+  std::vector<VectorPtr> keys = {
+      vectorMaker_.sequenceVector<int32_t>(
+          {1, 1, 1, std::nullopt, std::nullopt, 2, 2, 3}),
+      vectorMaker_.sequenceVector<int32_t>({3, 3, 4, 4, 4, 4, 5}),
+      makeFlatVector<int32_t>({5, 5, 6}),
+      vectorMaker_.sequenceVector<int32_t>({6, 6, 6, 6}),
+  };
+
+  testAggregation(keys);
+  testAggregation(keys, 2);
+
+  std::vector<RowVectorPtr> multipleKeys = {
+      makeRowVector({
+          vectorMaker_.sequenceVector<int32_t>({1, 1, 1, 1, 2, 2}),
+          vectorMaker_.sequenceVector<int64_t>({10, 10, 20, 20, 20, 20}),
+      }),
+      makeRowVector({
+          vectorMaker_.sequenceVector<int32_t>({2, 2, 3, 3}),
+          vectorMaker_.sequenceVector<int64_t>(
+              {20, std::nullopt, std::nullopt, 30}),
+      }),
+  };
+
+  testMultiKeyAggregation(multipleKeys);
+  testMultiKeyAggregation(multipleKeys, 2);
+}
+
 TEST_F(StreamingAggregationTest, regularSizeInputBatches) {
   auto size = 1'024;
 
@@ -20,6 +20,7 @@
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
+#include "velox/exec/FragmentResultCache.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -692,6 +693,110 @@ TEST_F(TableScanTest, batchSize) {
   }
 }
 
+TEST_F(TableScanTest, adaptiveBatchSize) {
+  // Rows 500 to 509 have arrays of 20K elements, which are larger than the
+  // preferred batch bytes. The other rows have 1 element.
+  auto isLarge = [](vector_size_t row) { return row >= 500 && row < 510; };
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+       makeArrayVector<int64_t>(
+           1'000,
+           [&](auto row) { return isLarge(row) ? 20'000 : 1; },
+           [](auto row, auto index) { return row + index; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {vector});
+
+  // The filter makes the reader load the arrays before the scan returns.
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(vector->type()), {"c1 is not null"})
+                  .planNode();
+  auto task = AssertQueryBuilder(plan)
+                  .splits(makeHiveConnectorSplits({filePath}))
+                  .config(QueryConfig::kPreferredOutputBatchBytes, "100000")
+                  .assertResults(vector);
+  EXPECT_EQ(getTableScanRuntimeStats(task).count("batchSizeReductions"), 0);
+
+  task = AssertQueryBuilder(plan)
+             .splits(makeHiveConnectorSplits({filePath}))
+             .config(QueryConfig::kPreferredOutputBatchBytes, "100000")
+             .config(QueryConfig::kAdaptiveScanBatchSizeEnabled, "true")
+             .assertResults(vector);
+  EXPECT_GT(getTableScanRuntimeStats(task).at("batchSizeReductions").sum, 0);
+}
+
+TEST_F(TableScanTest, maxCollectionElements) {
+  auto sizeAt = [](vector_size_t row) { return row % 5; };
+  auto vector = makeRowVector(
+      {makeArrayVector<int64_t>(
+           100, sizeAt, [](auto row, auto index) { return row + index; }),
+       makeMapVector<int64_t, int64_t>(
+           100,
+           sizeAt,
+           [](auto index) { return index; },
+           [](auto index) { return 2 * index; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {vector});
+  auto plan = PlanBuilder().tableScan(asRowType(vector->type())).planNode();
+
+  // Without a limit all the elements are read.
+  AssertQueryBuilder(plan)
+      .splits(makeHiveConnectorSplits({filePath}))
+      .assertResults(vector);
+
+  // Truncating keeps the first 2 elements of each array and map.
+  auto truncatedSizeAt = [&](vector_size_t row) {
+    return std::min(2, sizeAt(row));
+  };
+  // Index of the first map entry of 'row' in the written vector.
+  auto firstEntryAt = [&](vector_size_t row) {
+    vector_size_t offset = 0;
+    for (auto i = 0; i < row; ++i) {
+      offset += sizeAt(i);
+    }
+    return offset;
+  };
+  std::vector<vector_size_t> entries;
+  for (auto row = 0; row < 100; ++row) {
+    for (auto i = 0; i < truncatedSizeAt(row); ++i) {
+      entries.push_back(firstEntryAt(row) + i);
+    }
+  }
+  auto expected = makeRowVector(
+      {makeArrayVector<int64_t>(
+           100,
+           truncatedSizeAt,
+           [](auto row, auto index) { return row + index; }),
+       makeMapVector<int64_t, int64_t>(
+           100,
+           truncatedSizeAt,
+           [&](auto index) { return entries[index]; },
+           [&](auto index) { return 2 * entries[index]; })});
+  AssertQueryBuilder(plan)
+      .splits(makeHiveConnectorSplits({filePath}))
+      .connectorConfig(
+          kHiveConnectorId, HiveConfig::kMaxCollectionElements, "2")
+      .assertResults(expected);
+
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan)
+          .splits(makeHiveConnectorSplits({filePath}))
+          .connectorConfig(
+              kHiveConnectorId, HiveConfig::kMaxCollectionElements, "2")
+          .connectorConfig(
+              kHiveConnectorId, HiveConfig::kCollectionOverflowPolicy, "error")
+          .copyResults(pool_.get()),
+      "elements, more than the limit of 2");
+
+  // The error policy accepts data within the limit.
+  AssertQueryBuilder(plan)
+      .splits(makeHiveConnectorSplits({filePath}))
+      .connectorConfig(
+          kHiveConnectorId, HiveConfig::kMaxCollectionElements, "4")
+      .connectorConfig(
+          kHiveConnectorId, HiveConfig::kCollectionOverflowPolicy, "error")
+      .assertResults(vector);
+}
+
 // Test that adding the same split with the same sequence id does not cause
 // double read and the 2nd split is ignored.
 TEST_F(TableScanTest, sequentialSplitNoDoubleRead) {
@@ -803,6 +908,52 @@ TEST_F(TableScanTest, multipleSplits) {
   }
 }
 
+TEST_F(TableScanTest, splitPreloadConfig) {
+  auto filePaths = makeFilePaths(50);
+  auto vectors = makeVectors(50, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .config(QueryConfig::kMaxSplitPreloadPerDriver, "0")
+                  .splits(makeHiveConnectorSplits(filePaths))
+                  .assertResults("SELECT * FROM tmp");
+  EXPECT_EQ(getTableScanRuntimeStats(task).count("preloadedSplits"), 0);
+
+  task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+             .config(QueryConfig::kMaxSplitPreloadPerDriver, "4")
+             .connectorConfig(
+                 kHiveConnectorId,
+                 HiveConfig::kPreloadFirstStripe,
+                 folly::to<std::string>(false))
+             .splits(makeHiveConnectorSplits(filePaths))
+             .assertResults("SELECT * FROM tmp");
+  EXPECT_GT(getTableScanRuntimeStats(task).at("preloadedSplits").sum, 10);
+
+  task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+             .config(QueryConfig::kMaxSplitPreloadPerDriver, "4")
+             .splits(makeHiveConnectorSplits(filePaths))
+             .assertResults("SELECT * FROM tmp");
+  EXPECT_GT(getTableScanRuntimeStats(task).at("preloadedSplits").sum, 10);
+
+  // No preloads while the query uses more than 0% of its capacity.
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->testingOverrideMemoryPool(
+      memory::defaultMemoryManager().addRootPool(
+          queryCtx->queryId(), 1L << 30));
+  task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+             .queryCtx(queryCtx)
+             .config(QueryConfig::kMaxSplitPreloadPerDriver, "4")
+             .config(QueryConfig::kSplitPreloadMaxMemoryPct, "0")
+             .splits(makeHiveConnectorSplits(filePaths))
+             .assertResults("SELECT * FROM tmp");
+  auto stats = getTableScanRuntimeStats(task);
+  EXPECT_EQ(stats.count("preloadedSplits"), 0);
+  EXPECT_GT(stats.at("memoryLimitedPreloads").sum, 0);
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -844,6 +995,31 @@ TEST_F(TableScanTest, splitOffsetAndLength) {
       "SELECT * FROM tmp LIMIT 0");
 }
 
+TEST_F(TableScanTest, divideSplits) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(dwrf::Config::STRIPE_SIZE, uint64_t(1'000));
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  const auto fileSize = fs::file_size(filePath->path);
+  for (const auto minBytes : {uint64_t(0), fileSize / 4}) {
+    SCOPED_TRACE(fmt::format("minBytes: {}", minBytes));
+    auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                    .split(makeHiveConnectorSplit(filePath->path, 0, fileSize))
+                    .maxDrivers(4)
+                    .config(
+                        core::QueryConfig::kMinDividedSplitBytes,
+                        std::to_string(minBytes))
+                    .assertResults("SELECT * FROM tmp");
+    // If enabled, the only split is divided into one split per driver.
+    const auto stats = task->taskStats();
+    EXPECT_EQ(stats.numTotalSplits, minBytes == 0 ? 1 : 4);
+    EXPECT_EQ(stats.numDividedSplits, minBytes == 0 ? 0 : 1);
+  }
+}
+
 TEST_F(TableScanTest, fileNotFound) {
   CursorParameters params;
   params.planNode = tableScanNode();
@@ -1199,6 +1375,70 @@ TEST_F(TableScanTest, statsBasedSkipping) {
   EXPECT_EQ(2, getSkippedStridesStat(task));
 }
 
+// Test skipping splits on partition keys and split statistics before opening
+// the file. The skipped splits point to a file that does not exist.
+TEST_F(TableScanTest, splitPruning) {
+  auto vectors = makeVectors(1, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+  const auto missingPath = filePath->path + ".missing";
+
+  ColumnHandleMap assignments = {
+      {"pkey", partitionKey("pkey", BIGINT())},
+      {"c0", regularColumn("c0", BIGINT())}};
+  auto makePlan = [&](SubfieldFilters filters) {
+    return PlanBuilder()
+        .tableScan(
+            ROW({"pkey", "c0"}, {BIGINT(), BIGINT()}),
+            makeTableHandle(std::move(filters)),
+            assignments)
+        .planNode();
+  };
+
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits = {
+      HiveConnectorSplitBuilder(filePath->path)
+          .partitionKey("pkey", "1")
+          .build(),
+      HiveConnectorSplitBuilder(missingPath).partitionKey("pkey", "2").build(),
+      HiveConnectorSplitBuilder(missingPath)
+          .partitionKey("pkey", std::nullopt)
+          .build(),
+  };
+  auto task = assertQuery(
+      makePlan(singleSubfieldFilter("pkey", lessThanOrEqual(1))),
+      splits,
+      "SELECT 1::BIGINT, c0 FROM tmp");
+  EXPECT_EQ(2, getSkippedSplitsStat(task));
+  EXPECT_EQ(2, getTableScanRuntimeStats(task)["prunedSplits"].sum);
+
+  // Statistics of c0 in the split.
+  auto stats = std::make_shared<dwio::common::IntegerColumnStatistics>(
+      1'000, false, std::nullopt, std::nullopt, -100, 100, std::nullopt);
+  auto allNull = std::make_shared<dwio::common::IntegerColumnStatistics>(
+      0, true, std::nullopt, std::nullopt, std::nullopt, std::nullopt, 0);
+  splits = {
+      HiveConnectorSplitBuilder(filePath->path)
+          .partitionKey("pkey", "1")
+          .build(),
+      HiveConnectorSplitBuilder(missingPath)
+          .partitionKey("pkey", "1")
+          .columnStatistics("c0", stats)
+          .numRows(1'000)
+          .build(),
+      HiveConnectorSplitBuilder(missingPath)
+          .partitionKey("pkey", "1")
+          .columnStatistics("c0", allNull)
+          .numRows(1'000)
+          .build(),
+  };
+  task = assertQuery(
+      makePlan(singleSubfieldFilter("c0", greaterThanOrEqual(1'000))),
+      splits,
+      "SELECT 1::BIGINT, c0 FROM tmp WHERE c0 >= 1000");
+  EXPECT_EQ(2, getTableScanRuntimeStats(task)["prunedSplits"].sum);
+}
+
 // Test skipping files and row groups containing constant values based on
 // statistics
 TEST_F(TableScanTest, statsBasedSkippingConstants) {
@@ -2008,6 +2248,82 @@ TEST_F(TableScanTest, remainingFilterSkippedStrides) {
   EXPECT_EQ(skippedStrides.sum, 1);
 }
 
+TEST_F(TableScanTest, remainingFilterSingleColumnConjuncts) {
+  auto rowType = ROW({{"c0", BIGINT()}, {"c1", BIGINT()}});
+  std::vector<RowVectorPtr> vectors;
+  auto filePaths = makeFilePaths(3);
+  for (int i = 0; i < filePaths.size(); ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [&](auto row) { return i * 100 + row; }),
+        makeFlatVector<int64_t>(100, [](auto row) { return row % 7; }),
+    }));
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // 'c0 >= 150' is applied by the reader and skips the first file by its
+  // statistics. 'c0 + c1 < 230' stays in the remaining filter.
+  auto task = assertQuery(
+      PlanBuilder()
+          .tableScan(rowType, {}, "c0 >= 150 AND c0 + c1 < 230")
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c0 >= 150 AND c0 + c1 < 230");
+  EXPECT_EQ(getSkippedSplitsStat(task), 1);
+  EXPECT_EQ(getTableScanStats(task).rawInputRows, 200);
+}
+
+TEST_F(TableScanTest, filterOverScanPushdown) {
+  std::vector<RowVectorPtr> vectors;
+  auto filePaths = makeFilePaths(2);
+  for (int i = 0; i < filePaths.size(); ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+    }));
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // The filter refers to the columns by their aliases and is combined with
+  // the filters of the scan.
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      "hive_table",
+                      ROW({"a", "b"}, {BIGINT(), BIGINT()}),
+                      {{"a", "c0"}, {"b", "c1"}},
+                      {"a >= 10"},
+                      "a + b < 1500")
+                  .capturePlanNodeId(scanNodeId)
+                  .filter("a % 3 = 0 AND b > 2")
+                  .project({"a + b"})
+                  .planNode();
+  const std::string sql =
+      "SELECT c0 + c1 FROM tmp WHERE c0 >= 10 AND c0 + c1 < 1500 "
+      "AND c0 % 3 = 0 AND c1 > 2";
+
+  for (bool pushdown : {false, true}) {
+    SCOPED_TRACE(fmt::format("pushdown: {}", pushdown));
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(plan)
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .config(
+                        QueryConfig::kScanFilterPushdownEnabled,
+                        pushdown ? "true" : "false")
+                    .assertResults(sql);
+    // With the filter pushed down the scan produces only the passing rows.
+    auto planStats = toPlanStats(task->taskStats());
+    const auto numResultRows = planStats.at(plan->id()).outputRows;
+    if (pushdown) {
+      EXPECT_EQ(planStats.at(scanNodeId).outputRows, numResultRows);
+    } else {
+      EXPECT_GT(planStats.at(scanNodeId).outputRows, numResultRows);
+    }
+  }
+}
+
 /// Test the handling of constant remaining filter results which occur when
 /// filter input is a dictionary vector with all indices being the same (i.e.
 /// DictionaryVector::isConstant() == true).
@@ -2116,6 +2432,34 @@ TEST_F(TableScanTest, aggregationPushdown) {
   // 5 aggregates processing 10K rows each via pushdown.
   EXPECT_EQ(5 * 10'000, loadedToValueHook(task, 1));
 
+  op = PlanBuilder()
+           .tableScan(rowType_)
+           .singleAggregation(
+               {"c5"},
+               {"count(c0)", "avg(c1)", "avg(c2)", "avg(c3)", "avg(c4)"})
+           .planNode();
+
+  task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c5, count(c0), avg(c1), avg(c2), avg(c3), avg(c4) FROM tmp group by c5");
+  // 5 aggregates processing 10K rows each via pushdown.
+  EXPECT_EQ(5 * 10'000, loadedToValueHook(task, 1));
+
+  // Grouping on a tinyint key makes the hash table use array mode, where the
+  // values are pushed down into the dense accumulators.
+  op = PlanBuilder()
+           .tableScan(rowType_)
+           .singleAggregation({"c6"}, {"max(c0)", "sum(c1)", "min(c2)"})
+           .planNode();
+
+  task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c6, max(c0), sum(c1), min(c2) FROM tmp group by c6");
+  // 3 aggregates processing 10K rows each via pushdown.
+  EXPECT_EQ(3 * 10'000, loadedToValueHook(task, 1));
+
   // Pushdown should also happen if there is a FilterProject node that doesn't
   // touch columns being aggregated
   op = PlanBuilder()
@@ -2435,3 +2779,213 @@ TEST_F(TableScanTest, parallelPrepare) {
   }
   AssertQueryBuilder(plan).splits(splits).copyResults(pool_.get());
 }
+
+TEST_F(TableScanTest, fragmentResultCache) {
+  auto& cache = FragmentResultCache::getInstance();
+  cache.clear();
+  std::vector<std::shared_ptr<TempFilePath>> filePaths;
+  std::vector<RowVectorPtr> allVectors;
+  for (auto i = 0; i < 3; ++i) {
+    auto vectors = makeVectors(2, 1'000);
+    filePaths.push_back(TempFilePath::create());
+    writeToFile(filePaths.back()->path, vectors);
+    allVectors.insert(allVectors.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(allVectors);
+
+  core::PlanNodeId aggregationId;
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .filter("c0 % 3 <> 0")
+                  .partialAggregation({"c5"}, {"sum(c1)", "max(c0)"})
+                  .capturePlanNodeId(aggregationId)
+                  .finalAggregation()
+                  .planNode();
+  const std::string duckDbSql =
+      "SELECT c5, sum(c1), max(c0) FROM tmp WHERE c0 % 3 <> 0 GROUP BY c5";
+
+  auto cacheStat = [&](const std::shared_ptr<Task>& task,
+                       const std::string& name) {
+    const auto stats = toPlanStats(task->taskStats()).at(aggregationId);
+    auto it = stats.customStats.find(name);
+    return it == stats.customStats.end() ? 0 : it->second.sum;
+  };
+
+  auto runQuery = [&](bool cacheEnabled) {
+    return AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .splits(makeHiveConnectorSplits(filePaths))
+        .config(
+            QueryConfig::kFragmentResultCacheEnabled,
+            cacheEnabled ? "true" : "false")
+        .assertResults(duckDbSql);
+  };
+
+  // The first query computes and caches the results of each split.
+  auto task = runQuery(true);
+  EXPECT_EQ(0, cacheStat(task, "fragmentResultCacheHits"));
+  EXPECT_EQ(3, cacheStat(task, "fragmentResultCacheMisses"));
+  EXPECT_EQ(3, cache.stats().numEntries);
+
+  // The second query takes them from the cache without reading the files.
+  task = runQuery(true);
+  EXPECT_EQ(3, cacheStat(task, "fragmentResultCacheHits"));
+  EXPECT_EQ(0, cacheStat(task, "fragmentResultCacheMisses"));
+  EXPECT_EQ(0, toPlanStats(task->taskStats()).at(aggregationId).inputRows);
+
+  // The cache is not used unless enabled.
+  task = runQuery(false);
+  EXPECT_EQ(0, cacheStat(task, "fragmentResultCacheHits"));
+
+  // A different fragment does not match the cached results.
+  plan = PlanBuilder()
+             .tableScan(rowType_)
+             .filter("c0 % 3 <> 1")
+             .partialAggregation({"c5"}, {"sum(c1)", "max(c0)"})
+             .capturePlanNodeId(aggregationId)
+             .finalAggregation()
+             .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .splits(makeHiveConnectorSplits(filePaths))
+      .config(QueryConfig::kFragmentResultCacheEnabled, "true")
+      .assertResults(
+          "SELECT c5, sum(c1), max(c0) FROM tmp WHERE c0 % 3 <> 1 "
+          "GROUP BY c5");
+  EXPECT_EQ(6, cache.stats().numEntries);
+  cache.clear();
+}
+
+TEST_F(TableScanTest, biasedIntegerVectors) {
+  // c0 fits in 1 byte and c2 in 4 bytes after subtracting the minimum. c1 does
+  // not fit in 2 bytes and stays flat.
+  const vector_size_t size = 10'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return 1'000'000'000'000 + row % 100; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row * 7 - 5'000; }),
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return -(row * 100'000LL); },
+          nullEvery(11)),
+  });
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {data});
+  createDuckDbTable({data});
+
+  auto assertQuery = [&](const core::PlanNodePtr& plan,
+                         const std::string& duckDbSql) {
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .split(makeHiveConnectorSplit(filePath->path))
+        .connectorConfig(
+            kHiveConnectorId, HiveConfig::kBiasedIntegerVectors, "true")
+        .assertResults(duckDbSql);
+  };
+  auto rowType = asRowType(data->type());
+
+  assertQuery(
+      PlanBuilder().tableScan(rowType).planNode(), "SELECT * FROM tmp");
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType)
+          .singleAggregation({}, {"sum(c0)", "sum(c1)", "sum(c2)"})
+          .planNode(),
+      "SELECT sum(c0), sum(c1), sum(c2) FROM tmp");
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType)
+          .filter("c2 < -100000000")
+          .singleAggregation({"c0"}, {"count(1)", "max(c2)"})
+          .planNode(),
+      "SELECT c0, count(1), max(c2) FROM tmp WHERE c2 < -100000000 "
+      "GROUP BY c0");
+}
+
+TEST_F(TableScanTest, tableSampleSystem) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+
+  auto makePlan = [&](double percentage, uint64_t seed) {
+    return PlanBuilder()
+        .tableScan(
+            rowType_,
+            makeTableHandle(
+                SubfieldFilters{},
+                nullptr,
+                "hive_table",
+                HiveTableSample{
+                    HiveTableSample::Method::kSystem, percentage, seed}),
+            allRegularColumns(rowType_))
+        .planNode();
+  };
+
+  std::shared_ptr<Task> task;
+  auto sample = AssertQueryBuilder(makePlan(50, 7))
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .copyResults(pool(), task);
+  auto sampledOut = getTableScanRuntimeStats(task)["sampledOutSplits"].sum;
+  EXPECT_GT(sampledOut, 0);
+  EXPECT_LT(sampledOut, 20);
+  EXPECT_EQ(sampledOut, getSkippedSplitsStat(task));
+  // The splits are read whole or not at all.
+  EXPECT_EQ(sample->size(), (20 - sampledOut) * 100);
+
+  // The same seed reads the same splits.
+  AssertQueryBuilder(makePlan(50, 7))
+      .splits(makeHiveConnectorSplits(filePaths))
+      .assertResults(sample);
+
+  createDuckDbTable(vectors);
+  assertQuery(makePlan(100, 7), filePaths, "SELECT * FROM tmp");
+  assertQuery(makePlan(0, 7), filePaths, "SELECT * FROM tmp WHERE false");
+}
+
+TEST_F(TableScanTest, tableSampleBernoulli) {
+  auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), DOUBLE()});
+  auto filePath = TempFilePath::create();
+  auto vectors = makeVectors(10, 1'000, rowType);
+  writeToFile(filePath->path, vectors);
+
+  auto makeHandle = [&](const core::TypedExprPtr& remainingFilter = nullptr) {
+    return makeTableHandle(
+        SubfieldFilters{},
+        remainingFilter,
+        "hive_table",
+        HiveTableSample{HiveTableSample::Method::kBernoulli, 10, 3});
+  };
+  auto makePlan = [&](const core::TypedExprPtr& remainingFilter = nullptr) {
+    return PlanBuilder()
+        .tableScan(
+            rowType, makeHandle(remainingFilter), allRegularColumns(rowType))
+        .planNode();
+  };
+
+  auto sample = AssertQueryBuilder(makePlan())
+                    .split(makeHiveConnectorSplit(filePath->path))
+                    .copyResults(pool());
+  EXPECT_GT(sample->size(), 700);
+  EXPECT_LT(sample->size(), 1'300);
+
+  // The same seed keeps the same rows.
+  AssertQueryBuilder(makePlan())
+      .split(makeHiveConnectorSplit(filePath->path))
+      .assertResults(sample);
+
+  // A count(*) scan reads no columns and keeps as many rows.
+  AssertQueryBuilder(
+      PlanBuilder()
+          .tableScan(ROW({}, {}), makeHandle(), {})
+          .singleAggregation({}, {"count(1)"})
+          .planNode(),
+      duckDbQueryRunner_)
+      .split(makeHiveConnectorSplit(filePath->path))
+      .assertResults(fmt::format("SELECT {}", sample->size()));
+
+  // A filter applies to the rows of the sample.
+  createDuckDbTable({sample});
+  AssertQueryBuilder(
+      makePlan(parseExpr("c1 > c0", rowType)), duckDbQueryRunner_)
+      .split(makeHiveConnectorSplit(filePath->path))
+      .assertResults("SELECT * FROM tmp WHERE c1 > c0");
+}
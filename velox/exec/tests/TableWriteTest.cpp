@@ -17,6 +17,7 @@
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
 #include "velox/dwio/common/DataSink.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -24,6 +25,7 @@
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <numeric>
 #include <regex>
 
 using namespace facebook::velox;
@@ -94,6 +96,68 @@ class TableWriteTest : public HiveConnectorTestBase {
     return getRecursiveFiles(directoryPath).size();
   }
 
+  // Returns a plan writing 'input' to a table bucketed by 'bucketProperty' in
+  // 'outputDirectoryPath'.
+  PlanNodePtr createBucketedInsertPlan(
+      const std::vector<RowVectorPtr>& input,
+      const std::string& outputDirectoryPath,
+      std::shared_ptr<const HiveBucketProperty> bucketProperty) {
+    auto rowType = asRowType(input[0]->type());
+    return PlanBuilder()
+        .values(input)
+        .tableWrite(
+            rowType->names(),
+            std::make_shared<core::InsertTableHandle>(
+                kHiveConnectorId,
+                makeHiveInsertTableHandle(
+                    rowType->names(),
+                    rowType->children(),
+                    {},
+                    makeLocationHandle(outputDirectoryPath),
+                    std::move(bucketProperty))),
+            CommitStrategy::kNoCommit,
+            "rows")
+        .project({"rows"})
+        .planNode();
+  }
+
+  // Verifies that each file in 'directoryPath' has only rows of the bucket
+  // its name starts with and, if 'sortChannel' is set, that the rows are in
+  // ascending order of 'sortChannel'. Returns the number of files.
+  int32_t verifyBucketedFiles(
+      const std::string& directoryPath,
+      const RowTypePtr& rowType,
+      int32_t numBuckets,
+      const std::vector<column_index_t>& bucketChannels,
+      std::optional<column_index_t> sortChannel = std::nullopt) {
+    std::vector<int> bucketToPartition(numBuckets);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    HivePartitionFunction bucketFunction(
+        numBuckets, bucketToPartition, bucketChannels);
+    std::vector<uint32_t> buckets;
+    const auto files = getRecursiveFiles(directoryPath);
+    for (const auto& file : files) {
+      const auto fileName = fs::path(file).filename().string();
+      const auto bucket = folly::to<uint32_t>(fileName.substr(0, 6));
+      EXPECT_LT(bucket, numBuckets);
+      auto data =
+          AssertQueryBuilder(PlanBuilder().tableScan(rowType).planNode())
+              .split(makeHiveConnectorSplit(file))
+              .copyResults(pool());
+      bucketFunction.partition(*data, buckets);
+      const VectorPtr sortColumn =
+          sortChannel.has_value() ? data->childAt(*sortChannel) : nullptr;
+      for (auto row = 0; row < data->size(); ++row) {
+        EXPECT_EQ(buckets[row], bucket) << fileName << " row " << row;
+        if (sortColumn != nullptr && row > 0) {
+          EXPECT_LE(sortColumn->compare(sortColumn.get(), row - 1, row), 0)
+              << fileName << " row " << row;
+        }
+      }
+    }
+    return files.size();
+  }
+
   // Helper method to return InsertTableHandle.
   std::shared_ptr<core::InsertTableHandle> createInsertTableHandle(
       const RowTypePtr& outputRowType,
@@ -556,6 +620,174 @@ TEST_F(TableWriteTest, maxPartitions) {
       fmt::format("Exceeded limit of {} distinct partitions.", maxPartitions));
 }
 
+// Test that the writers flush their stripes and the writers of partitions
+// without rows in the last input roll over to new files when over the writer
+// memory budget.
+TEST_F(TableWriteTest, maxWriterMemory) {
+  constexpr int32_t kNumPartitions = 10;
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  // The batches alternate between two sets of partitions.
+  auto input = makeBatches(4, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return batch * 1'000 + row; }),
+         makeFlatVector<int32_t>(1'000, [&](auto row) {
+           return (batch % 2) * kNumPartitions + row % kNumPartitions;
+         })});
+  });
+  createDuckDbTable(input);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = createInsertPlan(
+      PlanBuilder().values(input), rowType, outputDirectory->path, {"p0"});
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .connectorConfig(
+                      kHiveConnectorId, HiveConfig::kMaxWriterMemory, "1")
+                  .assertResults("SELECT count(*) FROM tmp");
+
+  std::unordered_map<std::string, RuntimeMetric> runtimeStats;
+  for (const auto& pipelineStats : task->taskStats().pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      if (operatorStats.operatorType == "TableWrite") {
+        runtimeStats = operatorStats.runtimeStats;
+      }
+    }
+  }
+  // Every writer flushes after each of its inputs.
+  EXPECT_EQ(runtimeStats.at("numWriterFlushes").sum, 4 * kNumPartitions);
+  // The writers of the partitions without rows roll over after each input but
+  // the first.
+  EXPECT_EQ(runtimeStats.at("numWriterRollovers").sum, 3 * kNumPartitions);
+
+  // Each partition has a file per input with its rows.
+  const auto partitionDirectories =
+      getLeafSubdirectories(outputDirectory->path);
+  EXPECT_EQ(partitionDirectories.size(), 2 * kNumPartitions);
+  for (const auto& directory : partitionDirectories) {
+    EXPECT_EQ(countRecursiveFiles(directory), 2);
+  }
+  assertQuery(
+      PlanBuilder().tableScan(rowType).planNode(),
+      makeHiveConnectorSplits(outputDirectory),
+      "SELECT * FROM tmp");
+}
+
+TEST_F(TableWriteTest, maxTargetFileSize) {
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  auto input = makeBatches(4, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return batch * 1'000 + row; }),
+         makeFlatVector<int32_t>(1'000, [](auto row) { return row % 2; })});
+  });
+  createDuckDbTable(input);
+
+  // Every input reaches the target size.
+  for (const auto& partitionedBy : std::vector<std::vector<std::string>>{
+           {}, {"p0"}}) {
+    SCOPED_TRACE(folly::join(",", partitionedBy));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = createInsertPlan(
+        PlanBuilder().values(input),
+        rowType,
+        outputDirectory->path,
+        partitionedBy);
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .connectorConfig(
+                        kHiveConnectorId, HiveConfig::kMaxTargetFileSize, "1")
+                    .assertResults("SELECT count(*) FROM tmp");
+
+    const auto numWriters = partitionedBy.empty() ? 1 : 2;
+    for (const auto& pipelineStats : task->taskStats().pipelineStats) {
+      for (const auto& operatorStats : pipelineStats.operatorStats) {
+        if (operatorStats.operatorType == "TableWrite") {
+          EXPECT_EQ(
+              operatorStats.runtimeStats.at("numWriterRollovers").sum,
+              4 * numWriters);
+        }
+      }
+    }
+    EXPECT_EQ(countRecursiveFiles(outputDirectory->path), 4 * numWriters);
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
+
+TEST_F(TableWriteTest, scaleWriters) {
+  auto input = makeBatches(8, [&](auto batch) {
+    return makeRowVector(
+        rowType_->names(),
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return batch * 100 + row; }),
+         makeFlatVector<int32_t>(100, [](auto row) { return row; }),
+         makeFlatVector<int16_t>(100, [](auto row) { return row; }),
+         makeFlatVector<float>(100, [](auto row) { return row; }),
+         makeFlatVector<double>(100, [](auto row) { return row; }),
+         makeFlatVector<StringView>(
+             100, [](auto row) { return StringView("abc"); })});
+  });
+  createDuckDbTable(input);
+
+  auto runWrite = [&](const std::string& minProcessedBytes) {
+    auto outputDirectory = TempDirectoryPath::create();
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    // Each writer driver returns the number of rows it wrote.
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(input)
+                    .scaleWriterLocalPartition()
+                    .tableWrite(
+                        rowType_->names(),
+                        createInsertTableHandle(
+                            rowType_,
+                            LocationHandle::TableType::kNew,
+                            outputDirectory->path,
+                            {}),
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .localPartition({})
+                    .singleAggregation({}, {"sum(rows)"})
+                    .planNode();
+    // The tiny exchange buffer makes the writers fall behind on every input.
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(4)
+                    .config(core::QueryConfig::kMaxLocalExchangeBufferSize, "1")
+                    .config(
+                        core::QueryConfig::kScaleWriterMinProcessedBytes,
+                        minProcessedBytes)
+                    .assertResults("SELECT count(*) FROM tmp");
+    int64_t numScaledWriters = 0;
+    for (const auto& pipelineStats : task->taskStats().pipelineStats) {
+      for (const auto& operatorStats : pipelineStats.operatorStats) {
+        if (operatorStats.operatorType == "LocalPartition" &&
+            operatorStats.runtimeStats.count("numScaledWriters")) {
+          numScaledWriters +=
+              operatorStats.runtimeStats.at("numScaledWriters").sum;
+        }
+      }
+    }
+    assertQuery(
+        PlanBuilder().tableScan(rowType_).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+    return std::make_pair(
+        numScaledWriters, countRecursiveFiles(outputDirectory->path));
+  };
+
+  // Scales up to a writer per driver, one more on each input.
+  auto [numScaledWriters, numFiles] = runWrite("0");
+  EXPECT_EQ(numScaledWriters, 3);
+  EXPECT_EQ(numFiles, 4);
+
+  // The input is too small to add a writer.
+  std::tie(numScaledWriters, numFiles) = runWrite("1000000000");
+  EXPECT_EQ(numScaledWriters, 0);
+  EXPECT_EQ(numFiles, 1);
+}
+
 // Test TableWriter does not create a file if input is empty.
 TEST_F(TableWriteTest, writeNoFile) {
   auto outputDirectory = TempDirectoryPath::create();
@@ -666,3 +898,109 @@ TEST_F(TableWriteTest, appendToAnExistingUnpartitionedTable) {
         "SELECT * FROM tmp");
   }
 }
+
+TEST_F(TableWriteTest, bucketedWrite) {
+  constexpr int32_t kNumBuckets = 4;
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), INTEGER()});
+  auto input = makeBatches(3, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return batch * 1'000 + row; }),
+         makeFlatVector<int32_t>(
+             1'000, [&](auto row) { return (row * 7) % 101; })});
+  });
+  createDuckDbTable(input);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = createBucketedInsertPlan(
+      input,
+      outputDirectory->path,
+      std::make_shared<HiveBucketProperty>(
+          kNumBuckets, std::vector<std::string>{"c0"}));
+  assertQuery(plan, "SELECT count(*) FROM tmp");
+
+  // One file per bucket.
+  EXPECT_EQ(
+      verifyBucketedFiles(outputDirectory->path, rowType, kNumBuckets, {0}),
+      kNumBuckets);
+  assertQuery(
+      PlanBuilder().tableScan(rowType).planNode(),
+      makeHiveConnectorSplits(outputDirectory),
+      "SELECT * FROM tmp");
+}
+
+TEST_F(TableWriteTest, sortedBucketedWrite) {
+  constexpr int32_t kNumBuckets = 3;
+  auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), INTEGER(), VARCHAR()});
+  auto input = makeBatches(5, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             500, [&](auto row) { return batch * 500 + row; }),
+         makeFlatVector<int32_t>(
+             500, [&](auto row) { return (row * 7 + batch) % 103; }),
+         makeFlatVector<StringView>(500, [&](auto row) {
+           return StringView(fmt::format("string value {}", row));
+         })});
+  });
+  createDuckDbTable(input);
+
+  auto bucketProperty = std::make_shared<HiveBucketProperty>(
+      kNumBuckets,
+      std::vector<std::string>{"c0"},
+      std::vector<HiveSortingColumn>{{"c1", core::kAscNullsFirst}});
+  for (const bool spill : {false, true}) {
+    SCOPED_TRACE(fmt::format("spill: {}", spill));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = createBucketedInsertPlan(
+        input, outputDirectory->path, bucketProperty);
+    AssertQueryBuilder builder(plan, duckDbQueryRunner_);
+    if (spill) {
+      builder.spillDirectory(spillDirectory->path)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kTestingSpillPct, "100");
+    }
+    builder.assertResults("SELECT count(*) FROM tmp");
+
+    EXPECT_EQ(
+        verifyBucketedFiles(
+            outputDirectory->path, rowType, kNumBuckets, {0}, 1),
+        kNumBuckets);
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+}
+
+TEST_F(TableWriteTest, bucketedWriteErrors) {
+  VELOX_ASSERT_THROW(
+      HiveBucketProperty(0, {"c0"}), "Bucket count must be positive");
+  VELOX_ASSERT_THROW(
+      HiveBucketProperty(4, {}), "A bucketed table needs bucketing columns");
+
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  auto input = makeRowVector(
+      rowType->names(),
+      {makeFlatVector<int64_t>({1, 2}), makeFlatVector<int32_t>({1, 2})});
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .tableWrite(
+                      rowType->names(),
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          makeHiveInsertTableHandle(
+                              rowType->names(),
+                              rowType->children(),
+                              {"p0"},
+                              makeLocationHandle(outputDirectory->path),
+                              std::make_shared<HiveBucketProperty>(
+                                  4, std::vector<std::string>{"p0"}))))
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()),
+      "Partition key p0 can't be a bucketing or sorting column");
+}
@@ -581,6 +581,98 @@ TEST_F(TaskTest, singleThreadedHashJoin) {
   }
 }
 
+TEST_F(TaskTest, exportAndImportDynamicFilters) {
+  auto left = makeRowVector(
+      {"t_c0", "t_c1"},
+      {
+          makeFlatVector<int64_t>({1, 2, 3, 4}),
+          makeFlatVector<int64_t>({10, 20, 30, 40}),
+      });
+  auto leftPath = TempFilePath::create();
+  writeToFile(leftPath->path, {left});
+
+  auto right = makeRowVector(
+      {"u_c0"},
+      {
+          makeFlatVector<int64_t>({0, 1, 3, 5}),
+      });
+  auto rightPath = TempFilePath::create();
+  writeToFile(rightPath->path, {right});
+
+  // Export the build side filters of a join in one task.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId leftScanId;
+  core::PlanNodeId rightScanId;
+  core::PlanNodeId joinId;
+  auto joinPlan = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(asRowType(left->type()))
+                      .capturePlanNodeId(leftScanId)
+                      .hashJoin(
+                          {"t_c0"},
+                          {"u_c0"},
+                          PlanBuilder(planNodeIdGenerator)
+                              .tableScan(asRowType(right->type()))
+                              .capturePlanNodeId(rightScanId)
+                              .planNode(),
+                          "",
+                          {"t_c0", "t_c1"})
+                      .capturePlanNodeId(joinId)
+                      .planFragment();
+
+  auto joinTask = std::make_shared<exec::Task>(
+      "join.task.0", joinPlan, 0, std::make_shared<core::QueryCtx>());
+  joinTask->addSplit(
+      leftScanId, exec::Split(makeHiveConnectorSplit(leftPath->path)));
+  joinTask->noMoreSplits(leftScanId);
+  joinTask->addSplit(
+      rightScanId, exec::Split(makeHiveConnectorSplit(rightPath->path)));
+  joinTask->noMoreSplits(rightScanId);
+
+  // The build side is done once the probe side produces output.
+  auto result = joinTask->next();
+  ASSERT_NE(result, nullptr);
+  auto exported = joinTask->exportDynamicFilters(kUngroupedGroupId, joinId);
+  ASSERT_TRUE(exported.has_value());
+  ASSERT_EQ(exported->size(), 1);
+  ASSERT_FALSE(exported.value()[0].isNull());
+  while (joinTask->next() != nullptr) {
+  }
+  ASSERT_TRUE(waitForTaskCompletion(joinTask.get()));
+
+  // Import the filters into the scan of another task.
+  core::PlanNodeId scanId;
+  auto scanPlan = PlanBuilder()
+                      .tableScan(asRowType(left->type()))
+                      .capturePlanNodeId(scanId)
+                      .planFragment();
+  auto scanTask = std::make_shared<exec::Task>(
+      "scan.task.0", scanPlan, 0, std::make_shared<core::QueryCtx>());
+  folly::dynamic filters = folly::dynamic::object;
+  filters["t_c0"] = exported.value()[0];
+  scanTask->importDynamicFilters(scanId, filters);
+  ASSERT_EQ(scanTask->numImportedDynamicFilters(), 1);
+  VELOX_ASSERT_THROW(
+      scanTask->importDynamicFilters("unknown", filters),
+      "Dynamic filters can only be imported into a TableScan");
+
+  scanTask->addSplit(
+      scanId, exec::Split(makeHiveConnectorSplit(leftPath->path)));
+  scanTask->noMoreSplits(scanId);
+  std::vector<RowVectorPtr> results;
+  while (auto output = scanTask->next()) {
+    results.push_back(output);
+  }
+  ASSERT_TRUE(waitForTaskCompletion(scanTask.get()));
+
+  auto expectedResult = makeRowVector({
+      makeFlatVector<int64_t>({1, 3}),
+      makeFlatVector<int64_t>({10, 30}),
+  });
+  assertEqualResults({expectedResult}, results);
+  auto stats = toPlanStats(scanTask->taskStats());
+  ASSERT_EQ(stats.at(scanId).customStats.at("importedDynamicFilters").sum, 1);
+}
+
 TEST_F(TaskTest, singleThreadedCrossJoin) {
   auto left = makeRowVector({"t_c0"}, {makeFlatVector<int64_t>({1, 2, 3})});
   auto leftPath = TempFilePath::create();
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class TopNRowNumberTest : public OperatorTestBase {
+ protected:
+  // Returns 'numBatches' batches of 'batchSize' rows with a BIGINT partition
+  // key c0 with 'numPartitions' distinct values, a unique BIGINT sorting key
+  // c1 and a VARCHAR payload c2.
+  std::vector<RowVectorPtr> makeInput(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> input;
+    for (auto i = 0; i < numBatches; ++i) {
+      const auto offset = i * batchSize;
+      input.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % numPartitions; },
+              nullEvery(17)),
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) * 7'919 % 1'000'003; }),
+          makeFlatVector<std::string>(
+              batchSize,
+              [&](auto row) { return fmt::format("{}", offset + row); }),
+      }));
+    }
+    return input;
+  }
+
+  static std::string makeSql(
+      const std::string& partitionBy,
+      const std::string& orderBy,
+      int32_t limit,
+      bool generateRowNumber) {
+    return fmt::format(
+        "SELECT c0, c1, c2{} FROM (SELECT *, row_number() OVER ({} ORDER BY {}) as rn FROM tmp) WHERE rn <= {}",
+        generateRowNumber ? ", rn" : "",
+        partitionBy.empty() ? "" : fmt::format("PARTITION BY {}", partitionBy),
+        orderBy,
+        limit);
+  }
+};
+
+TEST_F(TopNRowNumberTest, basic) {
+  auto data = makeInput(3, 1'000, 11);
+  createDuckDbTable(data);
+
+  for (auto limit : {1, 5, 100, 1'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    for (auto generateRowNumber : {false, true}) {
+      auto plan = PlanBuilder()
+                      .values(data)
+                      .topNRowNumber({"c0"}, {"c1"}, limit, generateRowNumber)
+                      .planNode();
+      assertQuery(plan, makeSql("c0", "c1", limit, generateRowNumber));
+
+      plan = PlanBuilder()
+                 .values(data)
+                 .topNRowNumber(
+                     {"c0"}, {"c1 DESC NULLS FIRST"}, limit, generateRowNumber)
+                 .planNode();
+      assertQuery(
+          plan,
+          makeSql("c0", "c1 DESC NULLS FIRST", limit, generateRowNumber));
+    }
+  }
+}
+
+TEST_F(TopNRowNumberTest, noPartitionKeys) {
+  auto data = makeInput(3, 1'000, 11);
+  createDuckDbTable(data);
+
+  for (auto limit : {1, 50, 5'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    auto plan = PlanBuilder()
+                    .values(data)
+                    .topNRowNumber({}, {"c0", "c1"}, limit, true)
+                    .planNode();
+    assertQuery(plan, makeSql("", "c0, c1", limit, true));
+  }
+}
+
+TEST_F(TopNRowNumberTest, multipleKeys) {
+  auto data = makeInput(2, 1'000, 13);
+  createDuckDbTable(data);
+
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .project({"c0 % 3 AS c0", "c1", "c2"})
+                  .topNRowNumber({"c0", "c2"}, {"c1 DESC"}, 2, true)
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, c1, c2, rn FROM (SELECT *, row_number() OVER (PARTITION BY c0, c2 ORDER BY c1 DESC) as rn FROM (SELECT c0 % 3 AS c0, c1, c2 FROM tmp)) WHERE rn <= 2");
+}
+
+TEST_F(TopNRowNumberTest, spill) {
+  auto data = makeInput(10, 1'000, 200);
+  createDuckDbTable(data);
+
+  core::PlanNodeId topNRowNumberId;
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .topNRowNumber({"c0"}, {"c1"}, 3, true)
+                  .capturePlanNodeId(topNRowNumberId)
+                  .planNode();
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kTopNRowNumberSpillEnabled, "true")
+          .config(core::QueryConfig::kTestingSpillPct, "100")
+          .config(core::QueryConfig::kPreferredOutputBatchRows, "100")
+          .spillDirectory(spillDirectory->path)
+          .assertResults(makeSql("c0", "c1", 3, true));
+
+  auto taskStats = exec::toPlanStats(task->taskStats());
+  const auto& stats = taskStats.at(topNRowNumberId);
+  ASSERT_GT(stats.spilledBytes, 0);
+  ASSERT_GT(stats.spilledRows, 0);
+  ASSERT_EQ(stats.spilledPartitions, 1);
+  // Each spill run keeps at most 3 rows per partition.
+  ASSERT_LE(stats.spilledRows, 10 * 3 * 201);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
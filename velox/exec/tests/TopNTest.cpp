@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -261,3 +264,53 @@ TEST_F(TopNTest, lowCardinality) {
 
   testTwoKeys(vectors, "c0", "c1", 200);
 }
+
+TEST_F(TopNTest, spill) {
+  const vector_size_t batchSize = 1'000;
+  const int32_t numBatches = 10;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < numBatches; ++i) {
+    const auto offset = i * batchSize;
+    // c0 values are unique across batches and arrive in random order.
+    auto c0 = makeFlatVector<int64_t>(batchSize, [&](vector_size_t row) {
+      return (offset + row) * 7'919 % 1'000'003;
+    });
+    auto c1 = makeFlatVector<StringView>(batchSize, [&](vector_size_t row) {
+      return StringView(fmt::format("{}", offset + row));
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto limit : {5, 2'000, 20'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    for (const auto& sortOrderSql : getSortOrderSqls()) {
+      const auto sql = fmt::format("c0 {}", sortOrderSql);
+      core::PlanNodeId topNId;
+      auto plan = PlanBuilder()
+                      .values(vectors)
+                      .topN({sql}, limit, false)
+                      .capturePlanNodeId(topNId)
+                      .planNode();
+      auto spillDirectory = exec::test::TempDirectoryPath::create();
+      auto task =
+          AssertQueryBuilder(plan, duckDbQueryRunner_)
+              .config(core::QueryConfig::kSpillEnabled, "true")
+              .config(core::QueryConfig::kTopNSpillEnabled, "true")
+              .config(core::QueryConfig::kTestingSpillPct, "100")
+              .spillDirectory(spillDirectory->path)
+              .assertResults(
+                  fmt::format(
+                      "SELECT * FROM tmp ORDER BY {} LIMIT {}", sql, limit),
+                  {{0}});
+
+      auto taskStats = exec::toPlanStats(task->taskStats());
+      const auto& stats = taskStats.at(topNId);
+      ASSERT_GT(stats.spilledBytes, 0);
+      ASSERT_EQ(stats.spilledPartitions, 1);
+      // Each spilled run has at most 'limit' rows.
+      ASSERT_LE(stats.spilledRows, numBatches * limit);
+      OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+    }
+  }
+}
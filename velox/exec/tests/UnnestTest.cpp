@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -352,6 +353,72 @@ TEST_F(UnnestTest, multipleColumnsWithOrdinality) {
   assertQuery(op, expected);
 }
 
+TEST_F(UnnestTest, outputBatchRows) {
+  // Arrays with more elements than the output batch size are split over
+  // several output batches.
+  const std::vector<vector_size_t> sizes = {2'500, 0, 10'000, 3};
+  auto otherSize = [](auto row) { return row == 2 ? 1 : 2; };
+  auto elementAt = [](auto row, auto index) -> int64_t {
+    return row * 100'000 + index;
+  };
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(4, [](auto row) { return row; }),
+      makeArrayVector<int64_t>(
+          4, [&](auto row) { return sizes[row]; }, elementAt),
+      makeArrayVector<int64_t>(4, otherSize, elementAt),
+  });
+
+  std::vector<int64_t> replicated;
+  std::vector<int64_t> elements;
+  std::vector<int64_t> ordinality;
+  std::vector<int64_t> twoColumnsReplicated;
+  std::vector<std::optional<int64_t>> firstElements;
+  std::vector<std::optional<int64_t>> secondElements;
+  for (auto row = 0; row < sizes.size(); ++row) {
+    for (auto i = 0; i < sizes[row]; ++i) {
+      replicated.push_back(row);
+      elements.push_back(elementAt(row, i));
+      ordinality.push_back(i + 1);
+    }
+    for (auto i = 0; i < std::max(sizes[row], otherSize(row)); ++i) {
+      twoColumnsReplicated.push_back(row);
+      firstElements.push_back(
+          i < sizes[row] ? std::optional(elementAt(row, i)) : std::nullopt);
+      secondElements.push_back(
+          i < otherSize(row) ? std::optional(elementAt(row, i))
+                             : std::nullopt);
+    }
+  }
+
+  auto op = PlanBuilder()
+                .values({vector})
+                .unnest({"c0"}, {"c1"}, "ordinal")
+                .planNode();
+  auto task = AssertQueryBuilder(op)
+                  .config(core::QueryConfig::kPreferredOutputBatchRows, "1000")
+                  .assertResults(makeRowVector({
+                      makeFlatVector<int64_t>(replicated),
+                      makeFlatVector<int64_t>(elements),
+                      makeFlatVector<int64_t>(ordinality),
+                  }));
+  auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_EQ(stats.outputPositions, elements.size());
+  EXPECT_EQ(stats.outputVectors, bits::roundUp(elements.size(), 1000) / 1000);
+
+  op = PlanBuilder().values({vector}).unnest({"c0"}, {"c1", "c2"}).planNode();
+  task = AssertQueryBuilder(op)
+             .config(core::QueryConfig::kPreferredOutputBatchRows, "1000")
+             .assertResults(makeRowVector({
+                 makeFlatVector<int64_t>(twoColumnsReplicated),
+                 makeNullableFlatVector<int64_t>(firstElements),
+                 makeNullableFlatVector<int64_t>(secondElements),
+             }));
+  stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_EQ(
+      stats.outputVectors,
+      bits::roundUp(twoColumnsReplicated.size(), 1000) / 1000);
+}
+
 TEST_F(UnnestTest, allEmptyOrNullArrays) {
   auto vector = makeRowVector(
       {makeFlatVector<int64_t>(100, [](auto row) { return row; }),
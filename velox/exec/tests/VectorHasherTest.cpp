@@ -942,3 +942,116 @@ TEST_F(VectorHasherTest, simdRange) {
     }
   }
 }
+
+TEST_F(VectorHasherTest, biasedRange) {
+  constexpr int32_t kNumRows = 1000;
+  constexpr int64_t kBias = 1'000'000;
+  auto flat = vectorMaker_->flatVector<int64_t>(
+      kNumRows,
+      [](auto row) { return kBias + row % 50; },
+      [](auto row) { return row % 10 == 0; });
+  auto stored = AlignedBuffer::allocate<int8_t>(kNumRows, pool_.get());
+  auto* rawStored = stored->asMutable<int8_t>();
+  for (auto i = 0; i < kNumRows; ++i) {
+    rawStored[i] = i % 50;
+  }
+  auto biased = std::make_shared<BiasVector<int64_t>>(
+      pool_.get(), flat->nulls(), kNumRows, TypeKind::TINYINT, stored, kBias);
+
+  auto hasher = exec::VectorHasher::create(BIGINT(), 0);
+  SelectivityVector rows(kNumRows);
+  raw_vector<uint64_t> expected(kNumRows);
+  hasher->decode(*flat, rows);
+  hasher->computeValueIds(rows, expected);
+  hasher->enableValueRange(1, 0);
+  hasher->decode(*flat, rows);
+  ASSERT_TRUE(hasher->computeValueIds(rows, expected));
+
+  raw_vector<uint64_t> result(kNumRows);
+  hasher->decode(*biased, rows);
+  ASSERT_TRUE(hasher->computeValueIds(rows, result));
+  for (auto i = 0; i < kNumRows; ++i) {
+    ASSERT_EQ(expected[i], result[i]) << "at " << i;
+  }
+
+  // A value below the range is not mappable.
+  rawStored[1] = -1;
+  hasher->decode(*biased, rows);
+  EXPECT_FALSE(hasher->computeValueIds(rows, result));
+}
+
+TEST_F(VectorHasherTest, hashMultipleKeys) {
+  // More than one block of rows.
+  constexpr vector_size_t kSize = 2'500;
+  auto indices = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < kSize; ++i) {
+    rawIndices[i] = (i * 7) % 100;
+  }
+  std::vector<VectorPtr> keys = {
+      vectorMaker_->flatVector<int64_t>(kSize, [](auto row) { return row; }),
+      vectorMaker_->flatVector<int32_t>(
+          kSize,
+          [](auto row) { return row % 31; },
+          test::VectorMaker::nullEvery(7)),
+      vectorMaker_->flatVector<StringView>(
+          kSize,
+          [](auto row) {
+            return StringView(row % 3 == 0 ? "a long enough string" : "abc");
+          }),
+      BaseVector::wrapInDictionary(
+          nullptr,
+          indices,
+          kSize,
+          vectorMaker_->flatVector<int16_t>(
+              100,
+              [](auto row) { return row * 3; },
+              test::VectorMaker::nullEvery(11))),
+      BaseVector::createConstant(DOUBLE(), 1.5, kSize, pool_.get()),
+      vectorMaker_->flatVector<bool>(
+          kSize, [](auto row) { return row % 4 == 0; }),
+      vectorMaker_->flatVector<Timestamp>(
+          kSize, [](auto row) { return Timestamp(row, 0); }),
+  };
+
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (auto i = 0; i < keys.size(); ++i) {
+    hashers.push_back(VectorHasher::create(keys[i]->type(), i));
+  }
+
+  auto testRows = [&](const SelectivityVector& rows) {
+    raw_vector<uint64_t> expected(kSize);
+    raw_vector<uint64_t> result(kSize);
+    for (auto i = 0; i < hashers.size(); ++i) {
+      hashers[i]->decode(*keys[i], rows);
+      hashers[i]->hash(rows, i > 0, expected);
+    }
+    VectorHasher::hash(hashers, rows, result);
+    rows.applyToSelected(
+        [&](auto row) { ASSERT_EQ(expected[row], result[row]) << row; });
+  };
+
+  testRows(SelectivityVector(kSize));
+  testRows(makeOddRows(kSize));
+  SelectivityVector range(kSize, false);
+  range.setValidRange(700, 2'100, true);
+  range.updateBounds();
+  testRows(range);
+
+  // A single key and a key that is not a column.
+  hashers.resize(1);
+  testRows(SelectivityVector(kSize));
+  hashers.push_back(VectorHasher::create(BIGINT(), kConstantChannel));
+  hashers.back()->precompute(*BaseVector::createConstant(
+      BIGINT(), int64_t(11), 1, pool_.get()));
+  raw_vector<uint64_t> expected(kSize);
+  raw_vector<uint64_t> result(kSize);
+  SelectivityVector rows(kSize);
+  hashers[0]->decode(*keys[0], rows);
+  hashers[0]->hash(rows, false, expected);
+  hashers[1]->hashPrecomputed(rows, true, expected);
+  VectorHasher::hash(hashers, rows, result);
+  for (auto i = 0; i < kSize; ++i) {
+    ASSERT_EQ(expected[i], result[i]) << i;
+  }
+}
@@ -152,7 +152,9 @@ HiveConnectorTestBase::makeHiveInsertTableHandle(
     const std::vector<std::string>& tableColumnNames,
     const std::vector<TypePtr>& tableColumnTypes,
     const std::vector<std::string>& partitionedBy,
-    std::shared_ptr<connector::hive::LocationHandle> locationHandle) {
+    std::shared_ptr<connector::hive::LocationHandle> locationHandle,
+    std::shared_ptr<const connector::hive::HiveBucketProperty>
+        bucketProperty) {
   std::vector<std::shared_ptr<const connector::hive::HiveColumnHandle>>
       columnHandles;
   for (int i = 0; i < tableColumnNames.size(); ++i) {
@@ -175,7 +177,7 @@ HiveConnectorTestBase::makeHiveInsertTableHandle(
   }
 
   return std::make_shared<connector::hive::HiveInsertTableHandle>(
-      columnHandles, locationHandle);
+      columnHandles, locationHandle, std::move(bucketProperty));
 }
 
 std::shared_ptr<connector::hive::HiveColumnHandle>
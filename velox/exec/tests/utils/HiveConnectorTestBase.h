@@ -75,13 +75,15 @@ class HiveConnectorTestBase : public OperatorTestBase {
   static std::shared_ptr<connector::hive::HiveTableHandle> makeTableHandle(
       common::test::SubfieldFilters subfieldFilters = {},
       const core::TypedExprPtr& remainingFilter = nullptr,
-      const std::string& tableName = "hive_table") {
+      const std::string& tableName = "hive_table",
+      std::optional<connector::hive::HiveTableSample> sample = std::nullopt) {
     return std::make_shared<connector::hive::HiveTableHandle>(
         kHiveConnectorId,
         tableName,
         true,
         std::move(subfieldFilters),
-        remainingFilter);
+        remainingFilter,
+        std::move(sample));
   }
 
   /// @param targetDirectory Final directory of the target table after commit.
@@ -105,12 +107,16 @@ class HiveConnectorTestBase : public OperatorTestBase {
   /// name of tableColumnTypes[i] is tableColumnNames[i].
   /// @param partitionedBy A list of partition columns of the target table.
   /// @param locationHandle Location handle for the table write.
+  /// @param bucketProperty Bucketing and sorting properties of the target
+  /// table, nullptr if the table is not bucketed.
   static std::shared_ptr<connector::hive::HiveInsertTableHandle>
   makeHiveInsertTableHandle(
       const std::vector<std::string>& tableColumnNames,
       const std::vector<TypePtr>& tableColumnTypes,
       const std::vector<std::string>& partitionedBy,
-      std::shared_ptr<connector::hive::LocationHandle> locationHandle);
+      std::shared_ptr<connector::hive::LocationHandle> locationHandle,
+      std::shared_ptr<const connector::hive::HiveBucketProperty>
+          bucketProperty = nullptr);
 
   static std::shared_ptr<connector::hive::HiveColumnHandle> regularColumn(
       const std::string& name,
@@ -171,6 +177,18 @@ class HiveConnectorSplitBuilder {
     return *this;
   }
 
+  HiveConnectorSplitBuilder& columnStatistics(
+      std::string name,
+      std::shared_ptr<dwio::common::ColumnStatistics> stats) {
+    columnStatistics_.emplace(std::move(name), std::move(stats));
+    return *this;
+  }
+
+  HiveConnectorSplitBuilder& numRows(uint64_t numRows) {
+    numRows_ = numRows;
+    return *this;
+  }
+
   std::shared_ptr<connector::hive::HiveConnectorSplit> build() const {
     return std::make_shared<connector::hive::HiveConnectorSplit>(
         kHiveConnectorId,
@@ -179,7 +197,9 @@ class HiveConnectorSplitBuilder {
         start_,
         length_,
         partitionKeys_,
-        tableBucketNumber_);
+        tableBucketNumber_,
+        columnStatistics_,
+        numRows_);
   }
 
  private:
@@ -189,6 +209,11 @@ class HiveConnectorSplitBuilder {
   uint64_t length_{std::numeric_limits<uint64_t>::max()};
   std::unordered_map<std::string, std::optional<std::string>> partitionKeys_;
   std::optional<int32_t> tableBucketNumber_;
+  std::unordered_map<
+      std::string,
+      std::shared_ptr<dwio::common::ColumnStatistics>>
+      columnStatistics_;
+  std::optional<uint64_t> numRows_;
 };
 
 } // namespace facebook::velox::exec::test
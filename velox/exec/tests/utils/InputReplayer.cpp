@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/InputReplayer.h"
+
+#include <folly/json.h>
+#include <filesystem>
+
+#include "velox/common/time/Timer.h"
+#include "velox/exec/InputCapture.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/vector/VectorSaver.h"
+
+namespace facebook::velox::exec::test {
+
+namespace fs = std::filesystem;
+
+namespace {
+// Returns the node in 'plan' that consumes the captured input. A project over
+// a filter runs as one operator, which gets the input of the filter.
+folly::dynamic& inputConsumer(folly::dynamic& plan) {
+  if (plan["name"] == "ProjectNode" &&
+      plan["sources"][0]["name"] == "FilterNode") {
+    return plan["sources"][0];
+  }
+  return plan;
+}
+} // namespace
+
+InputReplayer::InputReplayer(
+    const std::string& directory,
+    memory::MemoryPool* pool)
+    : pool_(pool) {
+  plan_ = folly::parseJson(restoreStringFromFile(
+      fmt::format("{}/{}", directory, InputCapture::kPlanFileName).c_str()));
+  VELOX_USER_CHECK_EQ(
+      plan_["sources"].size(),
+      1,
+      "Only plan nodes with one source can be replayed");
+
+  // (driver id, sequence number, path) of the captured batches.
+  std::vector<std::tuple<int32_t, int64_t, std::string>> files;
+  const std::string prefix = InputCapture::kInputFilePrefix;
+  for (const auto& entry : fs::directory_iterator(directory)) {
+    auto name = entry.path().filename().string();
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    int32_t driverId;
+    int64_t sequence;
+    VELOX_CHECK_EQ(
+        sscanf(name.c_str() + prefix.size(), "%d_%ld", &driverId, &sequence),
+        2,
+        "Unexpected file in capture directory: {}",
+        name);
+    files.emplace_back(driverId, sequence, entry.path().string());
+  }
+  std::sort(files.begin(), files.end());
+  for (const auto& [driverId, sequence, path] : files) {
+    input_.push_back(std::dynamic_pointer_cast<RowVector>(
+        restoreVectorFromFile(path.c_str(), pool_)));
+  }
+  VELOX_USER_CHECK(!input_.empty(), "No captured input in {}", directory);
+}
+
+core::PlanNodePtr InputReplayer::makePlan(size_t repeatTimes) const {
+  auto plan = plan_;
+  auto& consumer = inputConsumer(plan);
+  auto values = std::make_shared<core::ValuesNode>(
+      consumer["sources"][0]["id"].asString(), input_, false, repeatTimes);
+  consumer["sources"] = folly::dynamic::array(values->serialize());
+  return ISerializable::deserialize<core::PlanNode>(plan, pool_);
+}
+
+InputReplayResult InputReplayer::replay(size_t repeatTimes) const {
+  auto plan = makePlan(repeatTimes);
+  InputReplayResult result;
+  std::shared_ptr<Task> task;
+  {
+    MicrosecondTimer timer(&result.wallMicros);
+    result.output =
+        AssertQueryBuilder(plan).maxDrivers(1).copyResults(pool_, task);
+  }
+  auto stats = toPlanStats(task->taskStats());
+  auto it = stats.find(plan->id());
+  if (it != stats.end()) {
+    result.nodeTiming = it->second.cpuWallTiming;
+  }
+  return result;
+}
+
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/time/CpuWallTimer.h"
+#include "velox/core/PlanNode.h"
+
+namespace facebook::velox::exec::test {
+
+struct InputReplayResult {
+  /// The output of the replayed plan node.
+  RowVectorPtr output;
+
+  /// Wall time of the whole replay, including the task setup.
+  uint64_t wallMicros{0};
+
+  /// Time spent in the operators of the replayed plan node.
+  CpuWallTiming nodeTiming;
+};
+
+/// Re-executes a plan node over the input saved by InputCapture. The node is
+/// deserialized from the 'plan' file of the capture directory and its source,
+/// or the source of the filter under a project, is replaced by a Values node
+/// with the captured batches, so that the node runs in isolation from the
+/// rest of the original plan.
+///
+/// Requires Type, PlanNode and ITypedExpr serde and the functions used by
+/// the plan node to be registered. Only plan nodes with one source can be
+/// replayed.
+class InputReplayer {
+ public:
+  /// 'directory' is the capture directory of the plan node, see
+  /// InputCapture::directory(). The captured batches are read into 'pool'
+  /// in driver and then capture order.
+  InputReplayer(const std::string& directory, memory::MemoryPool* pool);
+
+  const std::vector<RowVectorPtr>& input() const {
+    return input_;
+  }
+
+  /// Returns the plan node over a Values node that produces the input
+  /// 'repeatTimes' times.
+  core::PlanNodePtr makePlan(size_t repeatTimes = 1) const;
+
+  /// Runs the plan of makePlan('repeatTimes') in one driver.
+  InputReplayResult replay(size_t repeatTimes = 1) const;
+
+ private:
+  memory::MemoryPool* const pool_;
+  folly::dynamic plan_;
+  std::vector<RowVectorPtr> input_;
+};
+
+} // namespace facebook::velox::exec::test
@@ -612,6 +612,61 @@ PlanBuilder& PlanBuilder::aggregation(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::singleAggregation(
+    const std::vector<std::string>& groupingKeys,
+    const std::vector<std::string>& aggregates,
+    const std::vector<std::string>& masks,
+    const std::vector<bool>& distinctFlags) {
+  auto numAggregates = aggregates.size();
+  auto step = core::AggregationNode::Step::kSingle;
+  auto aggregatesAndNames =
+      createAggregateExpressionsAndNames(aggregates, step, {});
+  planNode_ = std::make_shared<core::AggregationNode>(
+      nextPlanNodeId(),
+      step,
+      fields(groupingKeys),
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregatesAndNames.names,
+      aggregatesAndNames.expressions,
+      createAggregateMasks(numAggregates, masks),
+      distinctFlags,
+      false,
+      planNode_);
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::sortedAggregation(
+    const std::vector<std::string>& groupingKeys,
+    const std::vector<std::string>& aggregates,
+    const std::vector<std::vector<std::string>>& sortingKeys) {
+  VELOX_CHECK_EQ(aggregates.size(), sortingKeys.size());
+  auto step = core::AggregationNode::Step::kSingle;
+  auto aggregatesAndNames =
+      createAggregateExpressionsAndNames(aggregates, step, {});
+  std::vector<std::vector<core::FieldAccessTypedExprPtr>> keys;
+  std::vector<std::vector<core::SortOrder>> orders;
+  for (const auto& aggregateKeys : sortingKeys) {
+    auto [sortFields, sortOrders] =
+        parseOrderByClauses(aggregateKeys, planNode_->outputType(), pool_);
+    keys.push_back(std::move(sortFields));
+    orders.push_back(std::move(sortOrders));
+  }
+  planNode_ = std::make_shared<core::AggregationNode>(
+      nextPlanNodeId(),
+      step,
+      fields(groupingKeys),
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregatesAndNames.names,
+      aggregatesAndNames.expressions,
+      createAggregateMasks(aggregates.size(), {}),
+      std::vector<bool>{},
+      keys,
+      orders,
+      false,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::streamingAggregation(
     const std::vector<std::string>& groupingKeys,
     const std::vector<std::string>& aggregates,
@@ -786,6 +841,12 @@ PlanBuilder& PlanBuilder::assignUniqueId(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::globalRowNumber(const std::string& rowNumberName) {
+  planNode_ = std::make_shared<core::GlobalRowNumberNode>(
+      nextPlanNodeId(), rowNumberName, planNode_);
+  return *this;
+}
+
 namespace {
 class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
  public:
@@ -993,6 +1054,16 @@ PlanBuilder& PlanBuilder::localPartitionRoundRobin() {
   return *this;
 }
 
+PlanBuilder& PlanBuilder::scaleWriterLocalPartition() {
+  planNode_ = std::make_shared<core::LocalPartitionNode>(
+      nextPlanNodeId(),
+      core::LocalPartitionNode::Type::kRepartition,
+      std::make_shared<RoundRobinPartitionFunctionSpec>(),
+      std::vector<core::PlanNodePtr>{planNode_},
+      /*scaleWriter=*/true);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::hashJoin(
     const std::vector<std::string>& leftKeys,
     const std::vector<std::string>& rightKeys,
@@ -1000,7 +1071,8 @@ PlanBuilder& PlanBuilder::hashJoin(
     const std::string& filter,
     const std::vector<std::string>& outputLayout,
     core::JoinType joinType,
-    bool nullAware) {
+    bool nullAware,
+    bool useHashTableCache) {
   VELOX_CHECK_EQ(leftKeys.size(), rightKeys.size());
 
   auto leftType = planNode_->outputType();
@@ -1040,7 +1112,8 @@ PlanBuilder& PlanBuilder::hashJoin(
       std::move(filterExpr),
       std::move(planNode_),
       build,
-      outputType);
+      outputType,
+      useHashTableCache);
   return *this;
 }
 
@@ -1087,6 +1160,28 @@ PlanBuilder& PlanBuilder::nestedLoopJoin(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::nestedLoopJoin(
+    const core::PlanNodePtr& right,
+    const std::string& joinCondition,
+    const std::vector<std::string>& outputLayout,
+    core::JoinType joinType) {
+  auto resultType = concat(planNode_->outputType(), right->outputType());
+  core::TypedExprPtr joinConditionExpr;
+  if (!joinCondition.empty()) {
+    joinConditionExpr = parseExpr(joinCondition, resultType, options_, pool_);
+  }
+  auto outputType = extract(resultType, outputLayout);
+
+  planNode_ = std::make_shared<core::NestedLoopJoinNode>(
+      nextPlanNodeId(),
+      joinType,
+      std::move(joinConditionExpr),
+      std::move(planNode_),
+      right,
+      outputType);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::unnest(
     const std::vector<std::string>& replicateColumns,
     const std::vector<std::string>& unnestColumns,
@@ -1333,6 +1428,61 @@ bool equalSortOrderList(
 
 PlanBuilder& PlanBuilder::window(
     const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, false);
+}
+
+PlanBuilder& PlanBuilder::streamingWindow(
+    const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, true);
+}
+
+PlanBuilder& PlanBuilder::parallelWindow(
+    const std::vector<std::string>& windowFunctions) {
+  VELOX_CHECK_GT(
+      windowFunctions.size(),
+      0,
+      "Window Node requires at least one window function.");
+  // window() checks that all the functions have the same PARTITION BY keys.
+  const auto& windowString = windowFunctions[0];
+  const auto partitionKeys = parsePartitionKeys(
+      duckdb::parseWindowExpr(windowString),
+      windowString,
+      planNode_->outputType(),
+      pool_);
+  std::vector<std::string> keys;
+  keys.reserve(partitionKeys.size());
+  for (const auto& partitionKey : partitionKeys) {
+    keys.push_back(partitionKey->name());
+  }
+  localPartition(keys);
+  return window(windowFunctions, false);
+}
+
+PlanBuilder& PlanBuilder::topNRowNumber(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    int32_t limit,
+    bool generateRowNumber) {
+  auto [sortingFields, sortingOrders] =
+      parseOrderByClauses(sortingKeys, planNode_->outputType(), pool_);
+  std::optional<std::string> rowNumberColumnName;
+  if (generateRowNumber) {
+    rowNumberColumnName = "row_number";
+  }
+  planNode_ = std::make_shared<core::TopNRowNumberNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingFields,
+      sortingOrders,
+      rowNumberColumnName,
+      limit,
+      planNode_);
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1411,6 +1561,7 @@ PlanBuilder& PlanBuilder::window(
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
   return *this;
 }
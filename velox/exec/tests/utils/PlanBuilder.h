@@ -357,6 +357,30 @@ class PlanBuilder {
         false);
   }
 
+  /// Same as above, but computes the aggregates with a true element in
+  /// 'distinctFlags' over distinct values of their inputs. For example,
+  ///
+  ///     singleAggregation({"k"}, {"count(a)", "sum(b)"}, {}, {true, false})
+  ///
+  /// computes count(DISTINCT a) and sum(b) for each value of k.
+  PlanBuilder& singleAggregation(
+      const std::vector<std::string>& groupingKeys,
+      const std::vector<std::string>& aggregates,
+      const std::vector<std::string>& masks,
+      const std::vector<bool>& distinctFlags);
+
+  /// Add a single AggregationNode in which the aggregates with a non-empty
+  /// element in 'sortingKeys' receive the input of each group sorted on these
+  /// keys. The keys use the syntax of orderBy(). For example,
+  ///
+  ///     sortedAggregation({"k"}, {"array_agg(a)", "sum(b)"}, {{"c DESC"}, {}})
+  ///
+  /// computes array_agg(a ORDER BY c DESC) and sum(b) for each value of k.
+  PlanBuilder& sortedAggregation(
+      const std::vector<std::string>& groupingKeys,
+      const std::vector<std::string>& aggregates,
+      const std::vector<std::vector<std::string>>& sortingKeys);
+
   /// Add an AggregationNode using specified grouping keys,
   /// aggregate expressions and masks. See 'partialAggregation' method for the
   /// supported types of aggregate expressions.
@@ -511,6 +535,13 @@ class PlanBuilder {
       const std::string& idName = "unique",
       const int32_t taskUniqueId = 1);
 
+  /// Add a GlobalRowNumberNode to add a BIGINT column that numbers the rows of
+  /// all the drivers of the pipeline from 1. The rows of the driver with the
+  /// lowest id get the lowest numbers, each driver in input order.
+  ///
+  /// @param rowNumberName The name of the output column with the row numbers.
+  PlanBuilder& globalRowNumber(const std::string& rowNumberName = "row_number");
+
   /// Add a PartitionedOutputNode to hash-partition the input on the specified
   /// keys using exec::HashPartitionFunction.
   ///
@@ -574,6 +605,11 @@ class PlanBuilder {
   /// current plan node).
   PlanBuilder& localPartitionRoundRobin();
 
+  /// Add a writer scaling LocalPartitionNode over the current plan node. The
+  /// input batches go to more of the downstream drivers as these fall behind.
+  /// Used in front of a tableWrite().
+  PlanBuilder& scaleWriterLocalPartition();
+
   /// Add a HashJoinNode to join two inputs using one or more join keys and an
   /// optional filter.
   ///
@@ -591,6 +627,8 @@ class PlanBuilder {
   /// @param joinType Type of the join: inner, left, right, full, semi, or anti.
   /// @param nullAware Applies to semi and anti joins. Indicates whether the
   /// join follows IN (null-aware) or EXISTS (regular) semantic.
+  /// @param useHashTableCache Shares the hash table among the tasks of the
+  /// same query. See core::HashJoinNode::useHashTableCache().
   PlanBuilder& hashJoin(
       const std::vector<std::string>& leftKeys,
       const std::vector<std::string>& rightKeys,
@@ -598,7 +636,8 @@ class PlanBuilder {
       const std::string& filter,
       const std::vector<std::string>& outputLayout,
       core::JoinType joinType = core::JoinType::kInner,
-      bool nullAware = false);
+      bool nullAware = false,
+      bool useHashTableCache = false);
 
   /// Add a MergeJoinNode to join two inputs using one or more join keys and an
   /// optional filter. The caller is responsible to ensure that inputs are
@@ -626,6 +665,20 @@ class PlanBuilder {
       const core::PlanNodePtr& right,
       const std::vector<std::string>& outputLayout);
 
+  /// Add a NestedLoopJoinNode to join two inputs using a join condition.
+  ///
+  /// @param right Right-side input.
+  /// @param joinCondition SQL expression evaluated on every combination of
+  /// left and right rows. Empty string means no condition.
+  /// @param outputLayout Output layout consisting of columns from left and
+  /// right sides.
+  /// @param joinType Type of the join: inner, left, right or full.
+  PlanBuilder& nestedLoopJoin(
+      const core::PlanNodePtr& right,
+      const std::string& joinCondition,
+      const std::vector<std::string>& outputLayout,
+      core::JoinType joinType = core::JoinType::kInner);
+
   /// Add an UnnestNode to unnest one or more columns of type array or map.
   ///
   /// The output will contain 'replicatedColumns' followed by unnested columns,
@@ -671,6 +724,42 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Adds a WindowNode which assumes the input is already sorted on the
+  /// PARTITION BY and ORDER BY keys of 'windowFunctions'. The window functions
+  /// are computed one partition at a time as the input arrives. The window
+  /// function strings have the same format as in window().
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
+  /// Adds a LocalPartitionNode to hash-partition the input on the PARTITION BY
+  /// keys of 'windowFunctions' followed by a WindowNode, so that the window
+  /// functions are computed in parallel by all the drivers of the downstream
+  /// pipeline. Each driver receives all the rows of a subset of the partitions
+  /// and sorts only these. If there are no PARTITION BY keys, all input is
+  /// gathered into a single driver. The window function strings have the same
+  /// format as in window().
+  PlanBuilder& parallelWindow(const std::vector<std::string>& windowFunctions);
+
+  /// Add a TopNRowNumberNode to compute single row_number window function with
+  /// a limit applied to sorted partitions.
+  ///
+  /// For example,
+  ///
+  ///     .topNRowNumber({"a"}, {"b DESC", "c"}, 10, true)
+  ///
+  /// is equivalent to "row_number() over (partition by a order by b DESC, c)
+  /// as row_number" followed by a "row_number <= 10" filter.
+  ///
+  /// @param partitionKeys Partition keys. May be empty.
+  /// @param sortingKeys Sorting keys in the same format as orderBy().
+  /// @param limit Per-partition limit.
+  /// @param generateRowNumber Boolean indicating whether to add a row_number
+  /// column to the output.
+  PlanBuilder& topNRowNumber(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      int32_t limit,
+      bool generateRowNumber);
+
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
   /// when adding splits at runtime.
@@ -756,6 +845,10 @@ class PlanBuilder {
       const RowTypePtr& inputType,
       const std::string& name);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   core::PlanNodePtr createIntermediateOrFinalAggregation(
       core::AggregationNode::Step step,
       const core::AggregationNode* partialAggNode);
@@ -0,0 +1,540 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/TpcdsQueryBuilder.h"
+
+namespace facebook::velox::exec::test {
+
+void TpcdsQueryBuilder::initialize(const std::string& dataPath) {
+  tableMetadata_ = readTableMetadata(dataPath, kTables_, format_, pool_.get());
+}
+
+// static
+const std::vector<int>& TpcdsQueryBuilder::getQueryIds() {
+  static const std::vector<int> kQueryIds = {3, 7, 42, 52, 55, 96};
+  return kQueryIds;
+}
+
+TpchPlan TpcdsQueryBuilder::getQueryPlan(int queryId) const {
+  switch (queryId) {
+    case 3:
+      return getStoreSalesByItemPlan(
+          {"d_moy = 11"},
+          {"i_brand_id", "i_brand", "i_manufact_id"},
+          {"i_manufact_id = 128"},
+          {"d_year", "i_brand", "i_brand_id"},
+          {"d_year", "ext_price DESC", "i_brand_id"});
+    case 7:
+      return getQ7Plan();
+    case 42:
+      return getStoreSalesByItemPlan(
+          {"d_moy = 11", "d_year = 2000"},
+          {"i_category_id", "i_category", "i_manager_id"},
+          {"i_manager_id = 1"},
+          {"d_year", "i_category_id", "i_category"},
+          {"ext_price DESC", "d_year", "i_category_id", "i_category"});
+    case 52:
+      return getStoreSalesByItemPlan(
+          {"d_moy = 11", "d_year = 2000"},
+          {"i_brand_id", "i_brand", "i_manager_id"},
+          {"i_manager_id = 1"},
+          {"d_year", "i_brand", "i_brand_id"},
+          {"d_year", "ext_price DESC", "i_brand_id"});
+    case 55:
+      return getStoreSalesByItemPlan(
+          {"d_moy = 11", "d_year = 1999"},
+          {"i_brand_id", "i_brand", "i_manager_id"},
+          {"i_manager_id = 28"},
+          {"i_brand_id", "i_brand"},
+          {"ext_price DESC", "i_brand_id"});
+    case 96:
+      return getQ96Plan();
+    default:
+      VELOX_NYI("TPC-DS query {} is not supported yet", queryId);
+  }
+}
+
+TpchPlan TpcdsQueryBuilder::getStoreSalesByItemPlan(
+    const std::vector<std::string>& dateFilters,
+    const std::vector<std::string>& itemColumns,
+    const std::vector<std::string>& itemFilters,
+    const std::vector<std::string>& groupingKeys,
+    const std::vector<std::string>& orderBy) const {
+  std::vector<std::string> storeSalesColumns = {
+      "ss_sold_date_sk", "ss_item_sk", "ss_ext_sales_price"};
+  std::vector<std::string> dateDimColumns = {"d_date_sk", "d_year", "d_moy"};
+  std::vector<std::string> itemSelectedColumns = {"i_item_sk"};
+  itemSelectedColumns.insert(
+      itemSelectedColumns.end(), itemColumns.begin(), itemColumns.end());
+
+  const auto storeSalesSelectedRowType =
+      getRowType(kStoreSales, storeSalesColumns);
+  const auto& storeSalesFileColumns = getFileColumnNames(kStoreSales);
+  const auto dateDimSelectedRowType = getRowType(kDateDim, dateDimColumns);
+  const auto& dateDimFileColumns = getFileColumnNames(kDateDim);
+  const auto itemSelectedRowType = getRowType(kItem, itemSelectedColumns);
+  const auto& itemFileColumns = getFileColumnNames(kItem);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId storeSalesScanNodeId;
+  core::PlanNodeId dateDimScanNodeId;
+  core::PlanNodeId itemScanNodeId;
+
+  auto dateDim = PlanBuilder(planNodeIdGenerator)
+                     .tableScan(
+                         kDateDim,
+                         dateDimSelectedRowType,
+                         dateDimFileColumns,
+                         dateFilters)
+                     .capturePlanNodeId(dateDimScanNodeId)
+                     .planNode();
+
+  auto item =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kItem, itemSelectedRowType, itemFileColumns, itemFilters)
+          .capturePlanNodeId(itemScanNodeId)
+          .planNode();
+
+  std::vector<std::string> itemJoinOutput = groupingKeys;
+  itemJoinOutput.push_back("ss_ext_sales_price");
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kStoreSales,
+                      storeSalesSelectedRowType,
+                      storeSalesFileColumns)
+                  .capturePlanNodeId(storeSalesScanNodeId)
+                  .hashJoin(
+                      {"ss_sold_date_sk"},
+                      {"d_date_sk"},
+                      dateDim,
+                      "",
+                      {"ss_item_sk", "ss_ext_sales_price", "d_year"})
+                  .hashJoin(
+                      {"ss_item_sk"},
+                      {"i_item_sk"},
+                      item,
+                      "",
+                      itemJoinOutput)
+                  .partialAggregation(
+                      groupingKeys, {"sum(ss_ext_sales_price) as ext_price"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy(orderBy, false)
+                  .limit(0, 100, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[storeSalesScanNodeId] = getTableFilePaths(kStoreSales);
+  context.dataFiles[dateDimScanNodeId] = getTableFilePaths(kDateDim);
+  context.dataFiles[itemScanNodeId] = getTableFilePaths(kItem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpcdsQueryBuilder::getQ7Plan() const {
+  std::vector<std::string> storeSalesColumns = {
+      "ss_sold_date_sk",
+      "ss_item_sk",
+      "ss_cdemo_sk",
+      "ss_promo_sk",
+      "ss_quantity",
+      "ss_list_price",
+      "ss_sales_price",
+      "ss_coupon_amt"};
+  std::vector<std::string> customerDemographicsColumns = {
+      "cd_demo_sk", "cd_gender", "cd_marital_status", "cd_education_status"};
+  std::vector<std::string> dateDimColumns = {"d_date_sk", "d_year"};
+  std::vector<std::string> itemColumns = {"i_item_sk", "i_item_id"};
+  std::vector<std::string> promotionColumns = {
+      "p_promo_sk", "p_channel_email", "p_channel_event"};
+
+  const auto storeSalesSelectedRowType =
+      getRowType(kStoreSales, storeSalesColumns);
+  const auto& storeSalesFileColumns = getFileColumnNames(kStoreSales);
+  const auto customerDemographicsSelectedRowType =
+      getRowType(kCustomerDemographics, customerDemographicsColumns);
+  const auto& customerDemographicsFileColumns =
+      getFileColumnNames(kCustomerDemographics);
+  const auto dateDimSelectedRowType = getRowType(kDateDim, dateDimColumns);
+  const auto& dateDimFileColumns = getFileColumnNames(kDateDim);
+  const auto itemSelectedRowType = getRowType(kItem, itemColumns);
+  const auto& itemFileColumns = getFileColumnNames(kItem);
+  const auto promotionSelectedRowType =
+      getRowType(kPromotion, promotionColumns);
+  const auto& promotionFileColumns = getFileColumnNames(kPromotion);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId storeSalesScanNodeId;
+  core::PlanNodeId customerDemographicsScanNodeId;
+  core::PlanNodeId dateDimScanNodeId;
+  core::PlanNodeId itemScanNodeId;
+  core::PlanNodeId promotionScanNodeId;
+
+  auto customerDemographics =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kCustomerDemographics,
+              customerDemographicsSelectedRowType,
+              customerDemographicsFileColumns,
+              {"cd_gender = 'M'",
+               "cd_marital_status = 'S'",
+               "cd_education_status = 'College'"})
+          .capturePlanNodeId(customerDemographicsScanNodeId)
+          .planNode();
+
+  auto dateDim = PlanBuilder(planNodeIdGenerator)
+                     .tableScan(
+                         kDateDim,
+                         dateDimSelectedRowType,
+                         dateDimFileColumns,
+                         {"d_year = 2000"})
+                     .capturePlanNodeId(dateDimScanNodeId)
+                     .planNode();
+
+  auto promotion = PlanBuilder(planNodeIdGenerator)
+                       .tableScan(
+                           kPromotion,
+                           promotionSelectedRowType,
+                           promotionFileColumns,
+                           {},
+                           "p_channel_email = 'N' OR p_channel_event = 'N'")
+                       .capturePlanNodeId(promotionScanNodeId)
+                       .planNode();
+
+  auto item = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(kItem, itemSelectedRowType, itemFileColumns)
+                  .capturePlanNodeId(itemScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kStoreSales, storeSalesSelectedRowType, storeSalesFileColumns)
+          .capturePlanNodeId(storeSalesScanNodeId)
+          .hashJoin(
+              {"ss_cdemo_sk"},
+              {"cd_demo_sk"},
+              customerDemographics,
+              "",
+              {"ss_sold_date_sk",
+               "ss_item_sk",
+               "ss_promo_sk",
+               "ss_quantity",
+               "ss_list_price",
+               "ss_sales_price",
+               "ss_coupon_amt"})
+          .hashJoin(
+              {"ss_sold_date_sk"},
+              {"d_date_sk"},
+              dateDim,
+              "",
+              {"ss_item_sk",
+               "ss_promo_sk",
+               "ss_quantity",
+               "ss_list_price",
+               "ss_sales_price",
+               "ss_coupon_amt"})
+          .hashJoin(
+              {"ss_promo_sk"},
+              {"p_promo_sk"},
+              promotion,
+              "",
+              {"ss_item_sk",
+               "ss_quantity",
+               "ss_list_price",
+               "ss_sales_price",
+               "ss_coupon_amt"})
+          .hashJoin(
+              {"ss_item_sk"},
+              {"i_item_sk"},
+              item,
+              "",
+              {"i_item_id",
+               "ss_quantity",
+               "ss_list_price",
+               "ss_sales_price",
+               "ss_coupon_amt"})
+          .partialAggregation(
+              {"i_item_id"},
+              {"avg(ss_quantity) as agg1",
+               "avg(ss_list_price) as agg2",
+               "avg(ss_coupon_amt) as agg3",
+               "avg(ss_sales_price) as agg4"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"i_item_id"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[storeSalesScanNodeId] = getTableFilePaths(kStoreSales);
+  context.dataFiles[customerDemographicsScanNodeId] =
+      getTableFilePaths(kCustomerDemographics);
+  context.dataFiles[dateDimScanNodeId] = getTableFilePaths(kDateDim);
+  context.dataFiles[itemScanNodeId] = getTableFilePaths(kItem);
+  context.dataFiles[promotionScanNodeId] = getTableFilePaths(kPromotion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpcdsQueryBuilder::getQ96Plan() const {
+  std::vector<std::string> storeSalesColumns = {
+      "ss_sold_time_sk", "ss_hdemo_sk", "ss_store_sk"};
+  std::vector<std::string> householdDemographicsColumns = {
+      "hd_demo_sk", "hd_dep_count"};
+  std::vector<std::string> timeDimColumns = {
+      "t_time_sk", "t_hour", "t_minute"};
+  std::vector<std::string> storeColumns = {"s_store_sk", "s_store_name"};
+
+  const auto storeSalesSelectedRowType =
+      getRowType(kStoreSales, storeSalesColumns);
+  const auto& storeSalesFileColumns = getFileColumnNames(kStoreSales);
+  const auto householdDemographicsSelectedRowType =
+      getRowType(kHouseholdDemographics, householdDemographicsColumns);
+  const auto& householdDemographicsFileColumns =
+      getFileColumnNames(kHouseholdDemographics);
+  const auto timeDimSelectedRowType = getRowType(kTimeDim, timeDimColumns);
+  const auto& timeDimFileColumns = getFileColumnNames(kTimeDim);
+  const auto storeSelectedRowType = getRowType(kStore, storeColumns);
+  const auto& storeFileColumns = getFileColumnNames(kStore);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId storeSalesScanNodeId;
+  core::PlanNodeId householdDemographicsScanNodeId;
+  core::PlanNodeId timeDimScanNodeId;
+  core::PlanNodeId storeScanNodeId;
+
+  auto householdDemographics =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kHouseholdDemographics,
+              householdDemographicsSelectedRowType,
+              householdDemographicsFileColumns,
+              {"hd_dep_count = 7"})
+          .capturePlanNodeId(householdDemographicsScanNodeId)
+          .planNode();
+
+  auto timeDim = PlanBuilder(planNodeIdGenerator)
+                     .tableScan(
+                         kTimeDim,
+                         timeDimSelectedRowType,
+                         timeDimFileColumns,
+                         {"t_hour = 20", "t_minute >= 30"})
+                     .capturePlanNodeId(timeDimScanNodeId)
+                     .planNode();
+
+  auto store = PlanBuilder(planNodeIdGenerator)
+                   .tableScan(
+                       kStore,
+                       storeSelectedRowType,
+                       storeFileColumns,
+                       {"s_store_name = 'ese'"})
+                   .capturePlanNodeId(storeScanNodeId)
+                   .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kStoreSales, storeSalesSelectedRowType, storeSalesFileColumns)
+          .capturePlanNodeId(storeSalesScanNodeId)
+          .hashJoin(
+              {"ss_hdemo_sk"},
+              {"hd_demo_sk"},
+              householdDemographics,
+              "",
+              {"ss_sold_time_sk", "ss_store_sk"})
+          .hashJoin(
+              {"ss_sold_time_sk"},
+              {"t_time_sk"},
+              timeDim,
+              "",
+              {"ss_store_sk"})
+          .hashJoin({"ss_store_sk"}, {"s_store_sk"}, store, "", {})
+          .partialAggregation({}, {"count(0) as cnt"})
+          .localPartition({})
+          .finalAggregation()
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[storeSalesScanNodeId] = getTableFilePaths(kStoreSales);
+  context.dataFiles[householdDemographicsScanNodeId] =
+      getTableFilePaths(kHouseholdDemographics);
+  context.dataFiles[timeDimScanNodeId] = getTableFilePaths(kTimeDim);
+  context.dataFiles[storeScanNodeId] = getTableFilePaths(kStore);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+const std::unordered_map<std::string, std::vector<std::string>>
+    TpcdsQueryBuilder::kTables_ = {
+        {"store_sales",
+         {"ss_sold_date_sk",
+          "ss_sold_time_sk",
+          "ss_item_sk",
+          "ss_customer_sk",
+          "ss_cdemo_sk",
+          "ss_hdemo_sk",
+          "ss_addr_sk",
+          "ss_store_sk",
+          "ss_promo_sk",
+          "ss_ticket_number",
+          "ss_quantity",
+          "ss_wholesale_cost",
+          "ss_list_price",
+          "ss_sales_price",
+          "ss_ext_discount_amt",
+          "ss_ext_sales_price",
+          "ss_ext_wholesale_cost",
+          "ss_ext_list_price",
+          "ss_ext_tax",
+          "ss_coupon_amt",
+          "ss_net_paid",
+          "ss_net_paid_inc_tax",
+          "ss_net_profit"}},
+        {"date_dim",
+         {"d_date_sk",
+          "d_date_id",
+          "d_date",
+          "d_month_seq",
+          "d_week_seq",
+          "d_quarter_seq",
+          "d_year",
+          "d_dow",
+          "d_moy",
+          "d_dom",
+          "d_qoy",
+          "d_fy_year",
+          "d_fy_quarter_seq",
+          "d_fy_week_seq",
+          "d_day_name",
+          "d_quarter_name",
+          "d_holiday",
+          "d_weekend",
+          "d_following_holiday",
+          "d_first_dom",
+          "d_last_dom",
+          "d_same_day_ly",
+          "d_same_day_lq",
+          "d_current_day",
+          "d_current_week",
+          "d_current_month",
+          "d_current_quarter",
+          "d_current_year"}},
+        {"item",
+         {"i_item_sk",
+          "i_item_id",
+          "i_rec_start_date",
+          "i_rec_end_date",
+          "i_item_desc",
+          "i_current_price",
+          "i_wholesale_cost",
+          "i_brand_id",
+          "i_brand",
+          "i_class_id",
+          "i_class",
+          "i_category_id",
+          "i_category",
+          "i_manufact_id",
+          "i_manufact",
+          "i_size",
+          "i_formulation",
+          "i_color",
+          "i_units",
+          "i_container",
+          "i_manager_id",
+          "i_product_name"}},
+        {"store",
+         {"s_store_sk",
+          "s_store_id",
+          "s_rec_start_date",
+          "s_rec_end_date",
+          "s_closed_date_sk",
+          "s_store_name",
+          "s_number_employees",
+          "s_floor_space",
+          "s_hours",
+          "s_manager",
+          "s_market_id",
+          "s_geography_class",
+          "s_market_desc",
+          "s_market_manager",
+          "s_division_id",
+          "s_division_name",
+          "s_company_id",
+          "s_company_name",
+          "s_street_number",
+          "s_street_name",
+          "s_street_type",
+          "s_suite_number",
+          "s_city",
+          "s_county",
+          "s_state",
+          "s_zip",
+          "s_country",
+          "s_gmt_offset",
+          "s_tax_precentage"}},
+        {"household_demographics",
+         {"hd_demo_sk",
+          "hd_income_band_sk",
+          "hd_buy_potential",
+          "hd_dep_count",
+          "hd_vehicle_count"}},
+        {"time_dim",
+         {"t_time_sk",
+          "t_time_id",
+          "t_time",
+          "t_hour",
+          "t_minute",
+          "t_second",
+          "t_am_pm",
+          "t_shift",
+          "t_sub_shift",
+          "t_meal_time"}},
+        {"customer_demographics",
+         {"cd_demo_sk",
+          "cd_gender",
+          "cd_marital_status",
+          "cd_education_status",
+          "cd_purchase_estimate",
+          "cd_credit_rating",
+          "cd_dep_count",
+          "cd_dep_employed_count",
+          "cd_dep_college_count"}},
+        {"promotion",
+         {"p_promo_sk",
+          "p_promo_id",
+          "p_start_date_sk",
+          "p_end_date_sk",
+          "p_item_sk",
+          "p_cost",
+          "p_response_target",
+          "p_promo_name",
+          "p_channel_dmail",
+          "p_channel_email",
+          "p_channel_catalog",
+          "p_channel_tv",
+          "p_channel_radio",
+          "p_channel_press",
+          "p_channel_event",
+          "p_channel_demo",
+          "p_channel_details",
+          "p_purpose",
+          "p_discount_active"}}};
+
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/tests/utils/TpchQueryBuilder.h"
+
+namespace facebook::velox::exec::test {
+
+/// Builds a representative subset of the TPC-DS queries using TPC-DS data
+/// files located in the specified directory. The data layout and the mapping
+/// of file column names to standard names are the same as for
+/// TpchQueryBuilder: there is a sub-directory per table and the columns of the
+/// files are in the order of the TPC-DS standard.
+///
+/// The queries are star joins of the store_sales fact table with its
+/// dimensions, with selective filters on the dimensions followed by grouping
+/// or global aggregation. getQueryIds() lists the supported queries.
+class TpcdsQueryBuilder {
+ public:
+  explicit TpcdsQueryBuilder(dwio::common::FileFormat format)
+      : format_(format) {}
+
+  /// Read each data file, initialize row types, and determine data paths for
+  /// each table.
+  /// @param dataPath path to the data files
+  void initialize(const std::string& dataPath);
+
+  /// Get the query plan for a given TPC-DS query number.
+  /// @param queryId TPC-DS query number
+  TpchPlan getQueryPlan(int queryId) const;
+
+  /// Returns the numbers of the supported TPC-DS queries.
+  static const std::vector<int>& getQueryIds();
+
+ private:
+  TpchPlan getQ7Plan() const;
+  TpchPlan getQ96Plan() const;
+
+  // Returns the plan of queries 3, 42, 52 and 55, which sum the
+  // ss_ext_sales_price of the store sales on the dates that pass
+  // 'dateFilters' for the items that pass 'itemFilters', grouped on
+  // 'groupingKeys'. The date_dim columns in 'groupingKeys' are d_year and
+  // the others are 'itemColumns'. The groups are sorted on 'orderBy', in
+  // which the sum is 'ext_price', and the first 100 are returned.
+  TpchPlan getStoreSalesByItemPlan(
+      const std::vector<std::string>& dateFilters,
+      const std::vector<std::string>& itemColumns,
+      const std::vector<std::string>& itemFilters,
+      const std::vector<std::string>& groupingKeys,
+      const std::vector<std::string>& orderBy) const;
+
+  const std::vector<std::string>& getTableFilePaths(
+      const std::string& tableName) const {
+    return tableMetadata_.at(tableName).dataFiles;
+  }
+
+  std::shared_ptr<const RowType> getRowType(
+      const std::string& tableName,
+      const std::vector<std::string>& columnNames) const {
+    auto columnSelector = std::make_shared<dwio::common::ColumnSelector>(
+        tableMetadata_.at(tableName).type, columnNames);
+    return columnSelector->buildSelectedReordered();
+  }
+
+  const std::unordered_map<std::string, std::string>& getFileColumnNames(
+      const std::string& tableName) const {
+    return tableMetadata_.at(tableName).fileColumnNames;
+  }
+
+  std::unordered_map<std::string, TpchTableMetadata> tableMetadata_;
+  const dwio::common::FileFormat format_;
+  static const std::unordered_map<std::string, std::vector<std::string>>
+      kTables_;
+
+  static constexpr const char* kStoreSales = "store_sales";
+  static constexpr const char* kDateDim = "date_dim";
+  static constexpr const char* kItem = "item";
+  static constexpr const char* kStore = "store";
+  static constexpr const char* kHouseholdDemographics =
+      "household_demographics";
+  static constexpr const char* kTimeDim = "time_dim";
+  static constexpr const char* kCustomerDemographics = "customer_demographics";
+  static constexpr const char* kPromotion = "promotion";
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
+};
+
+} // namespace facebook::velox::exec::test
@@ -68,8 +68,13 @@ std::vector<std::string> mergeColumnNames(
 };
 } // namespace
 
-void TpchQueryBuilder::initialize(const std::string& dataPath) {
-  for (const auto& [tableName, columns] : kTables_) {
+std::unordered_map<std::string, TpchTableMetadata> readTableMetadata(
+    const std::string& dataPath,
+    const std::unordered_map<std::string, std::vector<std::string>>& tables,
+    dwio::common::FileFormat format,
+    memory::MemoryPool* pool) {
+  std::unordered_map<std::string, TpchTableMetadata> tableMetadata;
+  for (const auto& [tableName, columns] : tables) {
     const fs::path tablePath{dataPath + "/" + tableName};
     for (auto const& dirEntry : fs::directory_iterator{tablePath}) {
       if (!dirEntry.is_regular_file()) {
@@ -79,9 +84,9 @@ void TpchQueryBuilder::initialize(const std::string& dataPath) {
       if (dirEntry.path().filename().c_str()[0] == '.') {
         continue;
       }
-      if (tableMetadata_[tableName].dataFiles.empty()) {
-        dwio::common::ReaderOptions readerOptions{pool_.get()};
-        readerOptions.setFileFormat(format_);
+      if (tableMetadata[tableName].dataFiles.empty()) {
+        dwio::common::ReaderOptions readerOptions{pool};
+        readerOptions.setFileFormat(format);
         auto input = std::make_unique<dwio::common::BufferedInput>(
             std::make_shared<LocalReadFile>(dirEntry.path().string()),
             readerOptions.getMemoryPool());
@@ -103,14 +108,19 @@ void TpchQueryBuilder::initialize(const std::string& dataPath) {
         auto columnNames = columns;
         auto types = fileType->children();
         types.resize(columnNames.size());
-        tableMetadata_[tableName].type =
+        tableMetadata[tableName].type =
             std::make_shared<RowType>(std::move(columnNames), std::move(types));
-        tableMetadata_[tableName].fileColumnNames =
+        tableMetadata[tableName].fileColumnNames =
             std::move(fileColumnNamesMap);
       }
-      tableMetadata_[tableName].dataFiles.push_back(dirEntry.path());
+      tableMetadata[tableName].dataFiles.push_back(dirEntry.path());
     }
   }
+  return tableMetadata;
+}
+
+void TpchQueryBuilder::initialize(const std::string& dataPath) {
+  tableMetadata_ = readTableMetadata(dataPath, kTables_, format_, pool_.get());
 }
 
 const std::vector<std::string>& TpchQueryBuilder::getTableNames() {
@@ -121,8 +131,12 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
@@ -135,6 +149,8 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
     case 12:
       return getQ12Plan();
     case 13:
@@ -215,6 +231,189 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_type", "p_size"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> supplierColumnsSubQuery = {
+      "s_suppkey", "s_nationkey"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto supplierSelectedRowTypeSubQuery =
+      getRowType(kSupplier, supplierColumnsSubQuery);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const std::string regionNameFilter = "r_name = 'EUROPE'";
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+  core::PlanNodeId regionScanNodeId;
+  core::PlanNodeId regionScanNodeIdSubQuery;
+
+  // The nations in Europe. The main query and the subquery each scan these.
+  auto europeNations = [&](core::PlanNodeId& nationScanId,
+                           core::PlanNodeId& regionScanId) {
+    auto region = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kRegion,
+                          regionSelectedRowType,
+                          regionFileColumns,
+                          {regionNameFilter})
+                      .capturePlanNodeId(regionScanId)
+                      .planNode();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+        .capturePlanNodeId(nationScanId)
+        .hashJoin(
+            {"n_regionkey"},
+            {"r_regionkey"},
+            region,
+            "",
+            {"n_nationkey", "n_name"})
+        .planNode();
+  };
+
+  // The lowest supply cost of each part in Europe.
+  auto europeSuppliersSubQuery =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kSupplier, supplierSelectedRowTypeSubQuery, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeIdSubQuery)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              europeNations(nationScanNodeIdSubQuery, regionScanNodeIdSubQuery),
+              "",
+              {"s_suppkey"})
+          .planNode();
+
+  auto minSupplyCost =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeIdSubQuery)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeSuppliersSubQuery,
+              "",
+              {"ps_partkey", "ps_supplycost"})
+          .partialAggregation(
+              {"ps_partkey"}, {"min(ps_supplycost) as min_supplycost"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"ps_partkey as min_partkey", "min_supplycost"})
+          .planNode();
+
+  auto europeSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              europeNations(nationScanNodeId, regionScanNodeId),
+              "",
+              {"s_suppkey",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type like '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_suppkey", "ps_supplycost", "p_partkey", "p_mfgr"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeSuppliers,
+              "",
+              {"ps_supplycost",
+               "p_partkey",
+               "p_mfgr",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .hashJoin(
+              {"p_partkey", "ps_supplycost"},
+              {"min_partkey", "min_supplycost"},
+              minSupplyCost,
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "p_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "p_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFiles[regionScanNodeIdSubQuery] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -303,6 +502,64 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string orderDateFilter = formatDateFilter(
+      "o_orderdate", ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderDateFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  // The orders with a line item that was received after its commit date.
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kLineitem,
+                      lineitemSelectedRowType,
+                      lineitemFileColumns,
+                      {},
+                      "l_commitdate < l_receiptdate")
+                  .capturePlanNodeId(lineitemScanNodeId)
+                  .hashJoin(
+                      {"l_orderkey"},
+                      {"o_orderkey"},
+                      orders,
+                      "",
+                      {"o_orderpriority"},
+                      core::JoinType::kRightSemiFilter)
+                  .partialAggregation(
+                      {"o_orderpriority"}, {"count(0) as order_count"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"o_orderpriority"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -1036,6 +1293,97 @@ TpchPlan TpchQueryBuilder::getQ10Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const std::string nationNameFilter = "n_name = 'GERMANY'";
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+
+  // The value of the stock of each part in Germany. The main query and the
+  // subquery each compute this.
+  auto germanStock = [&](core::PlanNodeId& partsuppScanId,
+                         core::PlanNodeId& supplierScanId,
+                         core::PlanNodeId& nationScanId) {
+    auto nation = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kNation,
+                          nationSelectedRowType,
+                          nationFileColumns,
+                          {nationNameFilter})
+                      .capturePlanNodeId(nationScanId)
+                      .planNode();
+    auto supplier =
+        PlanBuilder(planNodeIdGenerator)
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanId)
+            .hashJoin(
+                {"s_nationkey"}, {"n_nationkey"}, nation, "", {"s_suppkey"})
+            .planNode();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+        .capturePlanNodeId(partsuppScanId)
+        .hashJoin(
+            {"ps_suppkey"},
+            {"s_suppkey"},
+            supplier,
+            "",
+            {"ps_partkey", "ps_availqty", "ps_supplycost"})
+        .project(
+            {"ps_partkey",
+             "ps_supplycost * cast(ps_availqty as double) as part_value"});
+  };
+
+  auto threshold =
+      germanStock(
+          partsuppScanNodeIdSubQuery,
+          supplierScanNodeIdSubQuery,
+          nationScanNodeIdSubQuery)
+          .partialAggregation({}, {"sum(part_value) as total_value"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total_value * 0.0001 as threshold"})
+          .planNode();
+
+  auto plan =
+      germanStock(partsuppScanNodeId, supplierScanNodeId, nationScanNodeId)
+          .partialAggregation({"ps_partkey"}, {"sum(part_value) as value"})
+          .localPartition({})
+          .finalAggregation()
+          .nestedLoopJoin(threshold, {"ps_partkey", "value", "threshold"})
+          .filter("value > threshold")
+          .orderBy({"value DESC"}, false)
+          .project({"ps_partkey", "value"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ12Plan() const {
   std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
   std::vector<std::string> lineitemColumns = {
@@ -40,6 +40,16 @@ struct TpchTableMetadata {
   std::unordered_map<std::string, std::string> fileColumnNames;
 };
 
+/// Reads the types of the tables in 'tables', which maps each table name to
+/// its standard column names, from the data files in the sub-directory of
+/// 'dataPath' named after the table. Used by the TPC-H and TPC-DS query
+/// builders.
+std::unordered_map<std::string, TpchTableMetadata> readTableMetadata(
+    const std::string& dataPath,
+    const std::unordered_map<std::string, std::vector<std::string>>& tables,
+    dwio::common::FileFormat format,
+    memory::MemoryPool* pool);
+
 /// Builds TPC-H queries using TPC-H data files located in the specified
 /// directory. Each table data must be placed in hive-style partitioning. That
 /// is, the top-level directory is expected to contain a sub-directory per table
@@ -77,13 +87,16 @@ class TpchQueryBuilder {
 
  private:
   TpchPlan getQ1Plan() const;
+  TpchPlan getQ2Plan() const;
   TpchPlan getQ3Plan() const;
+  TpchPlan getQ4Plan() const;
   TpchPlan getQ5Plan() const;
   TpchPlan getQ6Plan() const;
   TpchPlan getQ7Plan() const;
   TpchPlan getQ8Plan() const;
   TpchPlan getQ9Plan() const;
   TpchPlan getQ10Plan() const;
+  TpchPlan getQ11Plan() const;
   TpchPlan getQ12Plan() const;
   TpchPlan getQ13Plan() const;
   TpchPlan getQ14Plan() const;
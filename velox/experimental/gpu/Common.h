@@ -74,6 +74,14 @@ struct CudaFreeDeleter<T[]> {
   }
 };
 
+template <typename T>
+struct CudaFreeHostDeleter {
+  static_assert(std::is_trivially_destructible_v<T>);
+  void operator()(T* ptr) const {
+    CUDA_CHECK_LOG(cudaFreeHost(ptr));
+  }
+};
+
 struct CudaEventDestroyDeleter {
   void operator()(cudaEvent_t ptr) const {
     CUDA_CHECK_LOG(cudaEventDestroy(ptr));
@@ -95,6 +103,25 @@ struct CudaStreamDestroyDeleter {
 template <typename T>
 using CudaPtr = std::unique_ptr<T, detail::CudaFreeDeleter<T>>;
 
+/// A unique_ptr to page locked host memory of 'count' elements of T. Copies
+/// between such memory and the device can be asynchronous.
+template <typename T>
+using CudaHostPtr = std::unique_ptr<T[], detail::CudaFreeHostDeleter<T>>;
+
+template <typename T>
+CudaHostPtr<T> allocateCudaHost(size_t count) {
+  T* ptr;
+  CUDA_CHECK_FATAL(cudaMallocHost(&ptr, count * sizeof(T)));
+  return CudaHostPtr<T>(ptr);
+}
+
+template <typename T>
+CudaPtr<T[]> allocateCudaDevice(size_t count) {
+  T* ptr;
+  CUDA_CHECK_FATAL(cudaMalloc(&ptr, count * sizeof(T)));
+  return CudaPtr<T[]>(ptr);
+}
+
 using CudaEvent = std::unique_ptr<CUevent_st, detail::CudaEventDestroyDeleter>;
 
 inline CudaEvent createCudaEvent() {
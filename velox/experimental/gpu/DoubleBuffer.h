@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cassert>
+
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// Streams batches of host data to the device for processing, so that the
+/// copy of a batch overlaps the processing of the previous one. This is the
+/// pattern measured by tests/DoubleBufferProcessTest.cu: there are two slots,
+/// each with a page locked host buffer, a device buffer and a stream. A batch
+/// is filled into the host buffer of a slot, copied and processed on the
+/// stream of the slot, while the next batch is filled into and copied by the
+/// other slot.
+///
+/// Not thread safe. The producer of the batches is a single host thread.
+class DoubleBuffer {
+ public:
+  /// Each batch holds up to 'capacity' bytes.
+  explicit DoubleBuffer(size_t capacity) : capacity_(capacity) {
+    for (auto& slot : slots_) {
+      slot.host = allocateCudaHost<char>(capacity);
+      slot.device = allocateCudaDevice<char>(capacity);
+      slot.stream = createCudaStream();
+      slot.processed = createCudaEvent();
+    }
+  }
+
+  ~DoubleBuffer() {
+    synchronize();
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /// Returns the host buffer to fill with the next batch. Waits until the
+  /// previous batch of the same slot is processed.
+  char* nextHostBuffer() {
+    auto& slot = slots_[next_];
+    if (slot.busy) {
+      CUDA_CHECK_FATAL(cudaEventSynchronize(slot.processed.get()));
+      slot.busy = false;
+    }
+    return slot.host.get();
+  }
+
+  /// Copies the first 'size' bytes of the buffer returned by the last
+  /// nextHostBuffer() to the device and calls 'process' with the device copy
+  /// and the stream of the slot. 'process' enqueues the processing of the
+  /// batch on the stream and does not wait for it.
+  template <typename Process>
+  void submit(size_t size, Process process) {
+    assert(size <= capacity_);
+    auto& slot = slots_[next_];
+    auto* stream = slot.stream.get();
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        slot.device.get(),
+        slot.host.get(),
+        size,
+        cudaMemcpyHostToDevice,
+        stream));
+    process(static_cast<const char*>(slot.device.get()), stream);
+    CUDA_CHECK_FATAL(cudaGetLastError());
+    CUDA_CHECK_FATAL(cudaEventRecord(slot.processed.get(), stream));
+    slot.busy = true;
+    next_ = 1 - next_;
+  }
+
+  /// Waits until all submitted batches are processed.
+  void synchronize() {
+    for (auto& slot : slots_) {
+      if (slot.busy) {
+        CUDA_CHECK_FATAL(cudaEventSynchronize(slot.processed.get()));
+        slot.busy = false;
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    CudaHostPtr<char> host;
+    CudaPtr<char[]> device;
+    CudaStream stream;
+    // Recorded on 'stream' after the processing of the last batch.
+    CudaEvent processed;
+    // True if a batch submitted to the slot may not be processed yet.
+    bool busy{false};
+  };
+
+  const size_t capacity_;
+  Slot slots_[2];
+  // The slot of the next batch.
+  int32_t next_{0};
+};
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/experimental/gpu/GroupBySum.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "velox/experimental/gpu/DoubleBuffer.h"
+#include "velox/experimental/gpu/Kernels.cuh"
+
+namespace facebook::velox::gpu {
+namespace {
+
+constexpr int32_t kBlockSize = 256;
+constexpr int32_t kMaxBlocks = 1024;
+
+// Adds 'values' to the groups of 'keys' in 'table', for the rows where
+// 'filterColumn <filter.op> filter.constant' if 'hasFilter'.
+__global__ void groupBySumKernel(
+    const int64_t* keys,
+    const int64_t* values,
+    const int64_t* filterColumn,
+    bool hasFilter,
+    CompareFilter filter,
+    int32_t size,
+    DeviceGroupByTable table) {
+  constexpr auto kEmpty =
+      static_cast<unsigned long long>(DeviceGroupByTable::kEmptyKey);
+  for (int32_t row = blockIdx.x * blockDim.x + threadIdx.x; row < size;
+       row += blockDim.x * gridDim.x) {
+    if (hasFilter && !compare(filter.op, filterColumn[row], filter.constant)) {
+      continue;
+    }
+    const auto key = static_cast<unsigned long long>(keys[row]);
+    uint32_t slot = table.capacityMask + 1;
+    if (key != kEmpty) {
+      slot = hashKey(key) & table.capacityMask;
+      bool found = false;
+      for (uint32_t probe = 0; probe <= table.capacityMask; ++probe) {
+        const auto previous = atomicCAS(&table.keys[slot], kEmpty, key);
+        if (previous == kEmpty) {
+          atomicAdd(table.numGroups, 1u);
+        }
+        if (previous == kEmpty || previous == key) {
+          found = true;
+          break;
+        }
+        slot = (slot + 1) & table.capacityMask;
+      }
+      if (!found) {
+        atomicExch(table.overflow, 1);
+        continue;
+      }
+    }
+    atomicAdd(
+        &table.sums[slot], static_cast<unsigned long long>(values[row]));
+    atomicAdd(&table.counts[slot], 1ULL);
+  }
+}
+
+} // namespace
+
+struct GroupBySum::Impl {
+  Impl(
+      int32_t maxGroups,
+      int32_t maxBatchRows,
+      std::optional<CompareFilter> filter)
+      : maxGroups(maxGroups),
+        maxBatchRows(maxBatchRows),
+        filter(filter),
+        numColumns(filter.has_value() ? 3 : 2),
+        buffer(numColumns * sizeof(int64_t) * maxBatchRows) {
+    // At most half full with 'maxGroups' keys.
+    uint64_t capacity = 1;
+    while (capacity < 2 * static_cast<uint64_t>(maxGroups)) {
+      capacity *= 2;
+    }
+    const auto numSlots = capacity + 1;
+    keys = allocateCudaDevice<unsigned long long>(numSlots);
+    sums = allocateCudaDevice<unsigned long long>(numSlots);
+    counts = allocateCudaDevice<unsigned long long>(numSlots);
+    numGroups = allocateCudaDevice<unsigned int>(1);
+    overflow = allocateCudaDevice<int>(1);
+
+    std::vector<unsigned long long> emptyKeys(
+        numSlots,
+        static_cast<unsigned long long>(DeviceGroupByTable::kEmptyKey));
+    CUDA_CHECK_FATAL(cudaMemcpy(
+        keys.get(),
+        emptyKeys.data(),
+        numSlots * sizeof(unsigned long long),
+        cudaMemcpyHostToDevice));
+    CUDA_CHECK_FATAL(
+        cudaMemset(sums.get(), 0, numSlots * sizeof(unsigned long long)));
+    CUDA_CHECK_FATAL(
+        cudaMemset(counts.get(), 0, numSlots * sizeof(unsigned long long)));
+    CUDA_CHECK_FATAL(cudaMemset(numGroups.get(), 0, sizeof(unsigned int)));
+    CUDA_CHECK_FATAL(cudaMemset(overflow.get(), 0, sizeof(int)));
+
+    table = DeviceGroupByTable{
+        keys.get(),
+        sums.get(),
+        counts.get(),
+        static_cast<uint32_t>(capacity - 1),
+        numGroups.get(),
+        overflow.get()};
+  }
+
+  const int32_t maxGroups;
+  const int32_t maxBatchRows;
+  const std::optional<CompareFilter> filter;
+  // The number of BIGINT columns of a batch: keys, values and the filtered
+  // column if there is a filter.
+  const int32_t numColumns;
+
+  DoubleBuffer buffer;
+
+  CudaPtr<unsigned long long[]> keys;
+  CudaPtr<unsigned long long[]> sums;
+  CudaPtr<unsigned long long[]> counts;
+  CudaPtr<unsigned int[]> numGroups;
+  CudaPtr<int[]> overflow;
+  DeviceGroupByTable table;
+};
+
+GroupBySum::GroupBySum(
+    int32_t maxGroups,
+    int32_t maxBatchRows,
+    std::optional<CompareFilter> filter)
+    : impl_(std::make_unique<Impl>(maxGroups, maxBatchRows, filter)) {}
+
+GroupBySum::~GroupBySum() = default;
+
+void GroupBySum::addBatch(
+    const int64_t* keys,
+    const int64_t* values,
+    const int64_t* filterColumn,
+    int32_t size) {
+  assert(size <= impl_->maxBatchRows);
+  if (size == 0) {
+    return;
+  }
+  // The columns are copied one after another into the host buffer.
+  const auto columnBytes = size * sizeof(int64_t);
+  auto* host = impl_->buffer.nextHostBuffer();
+  memcpy(host, keys, columnBytes);
+  memcpy(host + columnBytes, values, columnBytes);
+  const auto& filter = impl_->filter;
+  if (filter.has_value()) {
+    memcpy(host + 2 * columnBytes, filterColumn, columnBytes);
+  }
+  const auto numBlocks =
+      std::min(kMaxBlocks, (size + kBlockSize - 1) / kBlockSize);
+  impl_->buffer.submit(
+      impl_->numColumns * columnBytes,
+      [&](const char* device, cudaStream_t stream) {
+        const auto* columns = reinterpret_cast<const int64_t*>(device);
+        groupBySumKernel<<<numBlocks, kBlockSize, 0, stream>>>(
+            columns,
+            columns + size,
+            filter.has_value() ? columns + 2 * size : nullptr,
+            filter.has_value(),
+            filter.value_or(CompareFilter{CompareOp::kEq, 0}),
+            size,
+            impl_->table);
+      });
+}
+
+std::optional<GroupBySumResult> GroupBySum::finish() {
+  impl_->buffer.synchronize();
+  unsigned int numGroups;
+  int overflow;
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      &numGroups,
+      impl_->numGroups.get(),
+      sizeof(numGroups),
+      cudaMemcpyDeviceToHost));
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      &overflow,
+      impl_->overflow.get(),
+      sizeof(overflow),
+      cudaMemcpyDeviceToHost));
+  if (overflow || numGroups > impl_->maxGroups) {
+    return std::nullopt;
+  }
+
+  const auto numSlots = impl_->table.capacityMask + 2;
+  std::vector<unsigned long long> keys(numSlots);
+  std::vector<unsigned long long> sums(numSlots);
+  std::vector<unsigned long long> counts(numSlots);
+  const auto bytes = numSlots * sizeof(unsigned long long);
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      keys.data(), impl_->keys.get(), bytes, cudaMemcpyDeviceToHost));
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      sums.data(), impl_->sums.get(), bytes, cudaMemcpyDeviceToHost));
+  CUDA_CHECK_FATAL(cudaMemcpy(
+      counts.data(), impl_->counts.get(), bytes, cudaMemcpyDeviceToHost));
+
+  GroupBySumResult result;
+  for (uint32_t slot = 0; slot < numSlots; ++slot) {
+    // The group of kEmptyKey is in the last slot and exists if it has rows.
+    if (counts[slot] == 0) {
+      continue;
+    }
+    result.keys.push_back(
+        slot == numSlots - 1 ? DeviceGroupByTable::kEmptyKey
+                             : static_cast<int64_t>(keys[slot]));
+    result.sums.push_back(static_cast<int64_t>(sums[slot]));
+    result.counts.push_back(static_cast<int64_t>(counts[slot]));
+  }
+  impl_.reset();
+  return result;
+}
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Host interface of the device group by. Does not include CUDA headers, so
+// that it can be used from code that is compiled without nvcc.
+namespace facebook::velox::gpu {
+
+enum class CompareOp : int32_t { kEq, kNe, kLt, kLe, kGt, kGe };
+
+/// Keeps the rows where 'column <op> constant'.
+struct CompareFilter {
+  CompareOp op;
+  int64_t constant;
+};
+
+struct GroupBySumResult {
+  std::vector<int64_t> keys;
+  std::vector<int64_t> sums;
+  std::vector<int64_t> counts;
+};
+
+/// Computes sum(value) and count(*) grouped by a BIGINT key on the device,
+/// optionally over the rows that pass a CompareFilter on a third BIGINT
+/// column. The batches are copied to the device through a DoubleBuffer, so
+/// that the copy of a batch overlaps the aggregation of the previous one. The
+/// groups are kept in an open addressing table in device memory that is
+/// updated with atomics by all threads.
+///
+/// Inputs that this cannot compute are to be aggregated on the CPU: keys,
+/// values or filter columns that have nulls or are not BIGINT, other
+/// aggregates or filters, and inputs with more than 'maxGroups' distinct
+/// keys, for which finish() returns std::nullopt.
+class GroupBySum {
+ public:
+  GroupBySum(
+      int32_t maxGroups,
+      int32_t maxBatchRows,
+      std::optional<CompareFilter> filter = std::nullopt);
+
+  ~GroupBySum();
+
+  /// Adds 'size' rows, up to 'maxBatchRows'. 'filterColumn' is the filtered
+  /// column if there is a filter and is ignored otherwise. The rows are
+  /// copied before this returns while their aggregation may still be running.
+  void addBatch(
+      const int64_t* keys,
+      const int64_t* values,
+      const int64_t* filterColumn,
+      int32_t size);
+
+  /// Waits for the added batches and returns the groups in no particular
+  /// order, or std::nullopt if there are more than 'maxGroups'. The
+  /// GroupBySum can't be used after this.
+  std::optional<GroupBySumResult> finish();
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cuda_runtime.h>
+#include <cstdint>
+#include <limits>
+
+#include "velox/experimental/gpu/GroupBySum.h"
+
+namespace facebook::velox::gpu {
+
+template <typename T>
+__host__ __device__ inline bool compare(CompareOp op, T value, T constant) {
+  switch (op) {
+    case CompareOp::kEq:
+      return value == constant;
+    case CompareOp::kNe:
+      return value != constant;
+    case CompareOp::kLt:
+      return value < constant;
+    case CompareOp::kLe:
+      return value <= constant;
+    case CompareOp::kGt:
+      return value > constant;
+    case CompareOp::kGe:
+      return value >= constant;
+  }
+  return false;
+}
+
+/// Sets 'selected[i]' to 1 if 'values[i] <op> constant' and to 0 otherwise.
+template <typename T>
+__global__ void compareKernel(
+    const T* values,
+    int32_t size,
+    CompareOp op,
+    T constant,
+    uint8_t* selected) {
+  for (int32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < size;
+       i += blockDim.x * gridDim.x) {
+    selected[i] = compare(op, values[i], constant);
+  }
+}
+
+/// Groups with a sum and a count per BIGINT key in device memory. Slots with
+/// kEmptyKey are empty. kEmptyKey is itself a valid key and its group is in
+/// the extra slot at 'capacityMask + 1'. The counters are unsigned for
+/// atomicAdd() and wrap around like the signed sums on the CPU.
+struct DeviceGroupByTable {
+  static constexpr int64_t kEmptyKey = std::numeric_limits<int64_t>::min();
+
+  // 'capacityMask' + 2 elements each.
+  unsigned long long* keys;
+  unsigned long long* sums;
+  unsigned long long* counts;
+  // The number of slots minus 1. The number of slots is a power of 2.
+  uint32_t capacityMask;
+  // Counts the groups, not including the one of kEmptyKey.
+  unsigned int* numGroups;
+  // Set to 1 if a key finds no free slot.
+  int* overflow;
+};
+
+__device__ inline uint32_t hashKey(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return static_cast<uint32_t>(key);
+}
+
+} // namespace facebook::velox::gpu
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include "velox/experimental/gpu/Common.h"
+#include "velox/experimental/gpu/GroupBySum.h"
+#include "velox/experimental/gpu/Kernels.cuh"
+
+DEFINE_int32(batch_rows, 1 << 20, "");
+DEFINE_int32(num_batches, 20, "");
+DEFINE_int32(num_keys, 10'000, "");
+DEFINE_int32(seed, 0, "");
+
+namespace facebook::velox::gpu {
+namespace {
+
+struct Batch {
+  std::vector<int64_t> keys;
+  std::vector<int64_t> values;
+  std::vector<int64_t> filterColumn;
+};
+
+struct Group {
+  int64_t sum{0};
+  int64_t count{0};
+};
+
+std::vector<Batch> makeBatches(std::mt19937& rng) {
+  std::uniform_int_distribution<int64_t> keyDist(0, FLAGS_num_keys - 1);
+  std::uniform_int_distribution<int64_t> valueDist(-1'000'000, 1'000'000);
+  std::vector<Batch> batches(FLAGS_num_batches);
+  for (auto& batch : batches) {
+    for (auto i = 0; i < FLAGS_batch_rows; ++i) {
+      // The minimum of int64_t is the empty marker of the device table and
+      // needs to work as a key too.
+      const auto key = keyDist(rng);
+      batch.keys.push_back(
+          key == 0 ? DeviceGroupByTable::kEmptyKey : key * 7'919);
+      batch.values.push_back(valueDist(rng));
+      batch.filterColumn.push_back(valueDist(rng));
+    }
+  }
+  return batches;
+}
+
+std::unordered_map<int64_t, Group> expectedGroups(
+    const std::vector<Batch>& batches,
+    std::optional<CompareFilter> filter) {
+  std::unordered_map<int64_t, Group> groups;
+  for (auto& batch : batches) {
+    for (auto i = 0; i < batch.keys.size(); ++i) {
+      if (filter.has_value() &&
+          !compare(filter->op, batch.filterColumn[i], filter->constant)) {
+        continue;
+      }
+      auto& group = groups[batch.keys[i]];
+      group.sum += batch.values[i];
+      ++group.count;
+    }
+  }
+  return groups;
+}
+
+void checkGroupBy(
+    const std::vector<Batch>& batches,
+    std::optional<CompareFilter> filter) {
+  const auto start = std::chrono::steady_clock::now();
+  GroupBySum groupBy(FLAGS_num_keys, FLAGS_batch_rows, filter);
+  for (auto& batch : batches) {
+    groupBy.addBatch(
+        batch.keys.data(),
+        batch.values.data(),
+        batch.filterColumn.data(),
+        batch.keys.size());
+  }
+  auto result = groupBy.finish();
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  if (!result.has_value()) {
+    fprintf(stderr, "Unexpected overflow of the group by\n");
+    abort();
+  }
+  printf(
+      "Group by %s filter: %.2f M rows/s\n",
+      filter.has_value() ? "with" : "without",
+      1.0 * FLAGS_num_batches * FLAGS_batch_rows / micros);
+
+  auto expected = expectedGroups(batches, filter);
+  if (result->keys.size() != expected.size()) {
+    fprintf(
+        stderr,
+        "Expected %ld groups, got %ld\n",
+        expected.size(),
+        result->keys.size());
+    abort();
+  }
+  for (auto i = 0; i < result->keys.size(); ++i) {
+    auto it = expected.find(result->keys[i]);
+    if (it == expected.end() || it->second.sum != result->sums[i] ||
+        it->second.count != result->counts[i]) {
+      fprintf(stderr, "Wrong group for key %ld\n", result->keys[i]);
+      abort();
+    }
+  }
+}
+
+void checkTooManyGroups(const std::vector<Batch>& batches) {
+  // The caller aggregates on the CPU when there are more groups than
+  // planned for.
+  GroupBySum groupBy(FLAGS_num_keys / 10, FLAGS_batch_rows);
+  for (auto& batch : batches) {
+    groupBy.addBatch(
+        batch.keys.data(), batch.values.data(), nullptr, batch.keys.size());
+  }
+  if (groupBy.finish().has_value()) {
+    fprintf(stderr, "Expected too many groups\n");
+    abort();
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::gpu
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox::gpu;
+  folly::init(&argc, &argv);
+  std::mt19937 rng(FLAGS_seed);
+  const auto batches = makeBatches(rng);
+  checkGroupBy(batches, std::nullopt);
+  checkGroupBy(batches, CompareFilter{CompareOp::kGt, 250'000});
+  checkGroupBy(batches, CompareFilter{CompareOp::kEq, 0});
+  checkTooManyGroups(batches);
+  printf("Passed\n");
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include <stdexcept>
 
 #include <fmt/format.h>
+#include <folly/Conv.h>
 
 #include <velox/common/base/VeloxException.h>
 #include "velox/common/base/Exceptions.h"
@@ -27,6 +28,7 @@
 #include "velox/expression/StringWriter.h"
 #include "velox/external/date/tz.h"
 #include "velox/functions/lib/RowsTranslationUtil.h"
+#include "velox/type/Conversions.h"
 #include "velox/type/DecimalUtilOp.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FunctionVector.h"
@@ -114,6 +116,58 @@ std::string makeErrorMessage(
       input.toString(row));
 }
 
+// Returns an error for a cast that failed without throwing it, so that rows
+// that fail when errors are not thrown, e.g. under TRY, do not pay for stack
+// unwinding.
+std::exception_ptr makeCastError(const std::string& message) {
+  return std::make_exception_ptr(VeloxUserError(
+      __FILE__,
+      __LINE__,
+      __FUNCTION__,
+      "",
+      message,
+      error_source::kErrorSourceUser,
+      error_code::kInvalidArgument,
+      false));
+}
+
+template <typename T>
+constexpr bool kCastFromStringByTryTo = std::is_same_v<T, bool> ||
+    std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Casts strings to a boolean or number with folly::tryTo(), which returns
+// errors instead of throwing them. Gives the same results and error messages
+// as the Converter without truncation, which calls folly::to().
+template <typename To>
+void applyCastFromStringNoThrow(
+    const SelectivityVector& rows,
+    exec::EvalCtx& context,
+    const BaseVector& input,
+    FlatVector<To>* result) {
+  auto* strings = input.as<SimpleVector<StringView>>();
+  rows.applyToSelected([&](vector_size_t row) {
+    const auto value = strings->valueAt(row);
+    const folly::StringPiece piece(value.data(), value.size());
+    To fastOutput;
+    if (util::detail::tryCastFromStringFast(piece, fastOutput)) {
+      result->set(row, fastOutput);
+      return;
+    }
+    auto output = folly::tryTo<To>(piece);
+    if (output.hasValue()) {
+      result->set(row, output.value());
+      return;
+    }
+    context.setVeloxExceptionError(
+        row,
+        makeCastError(
+            makeErrorMessage(input, row, result->type()) + " " +
+            folly::makeConversionError(output.error(), piece).what()));
+  });
+}
+
 template <typename TInput, typename TOutput>
 void applyDecimalCastKernel(
     const SelectivityVector& rows,
@@ -251,6 +305,26 @@ void CastExpr::applyCastWithTry(
 
   auto* inputSimpleVector = input.as<SimpleVector<From>>();
 
+  if constexpr (
+      std::is_same_v<From, StringView> && kCastFromStringByTryTo<To>) {
+    if (!context.throwOnError() &&
+        (!isCastIntByTruncate || !std::is_integral_v<To> ||
+         std::is_same_v<To, bool>)) {
+      applyCastFromStringNoThrow(rows, context, input, resultFlatVector);
+      return;
+    }
+  }
+
+  // Reports a cast that produced no value. Does not throw if errors are not
+  // thrown.
+  const auto setNullOutputError = [&](vector_size_t row) {
+    auto message = makeErrorMessage(input, row, resultFlatVector->type());
+    if (context.throwOnError()) {
+      VELOX_USER_FAIL(message);
+    }
+    context.setVeloxExceptionError(row, makeCastError(message));
+  };
+
   if (!isCastIntByTruncate) {
     context.applyToSelectedNoThrow(rows, [&](int row) {
       bool nullOutput = false;
@@ -278,7 +352,7 @@ void CastExpr::applyCastWithTry(
       }
 
       if (nullOutput) {
-        VELOX_USER_FAIL(makeErrorMessage(input, row, resultFlatVector->type()));
+        setNullOutputError(row);
       }
     });
   } else {
@@ -308,7 +382,7 @@ void CastExpr::applyCastWithTry(
       }
 
       if (nullOutput) {
-        VELOX_USER_FAIL(makeErrorMessage(input, row, resultFlatVector->type()));
+        setNullOutputError(row);
       }
     });
   }
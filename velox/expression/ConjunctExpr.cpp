@@ -172,22 +172,28 @@ void ConjunctExpr::evalSpecialForm(
 }
 
 void ConjunctExpr::maybeReorderInputs() {
-  bool reorder = false;
-  for (auto i = 1; i < inputs_.size(); ++i) {
-    if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
-        selectivity_[inputOrder_[i]].timeToDropValue()) {
-      reorder = true;
-      break;
+  // Non-deterministic inputs stay in place so that they see the same rows as
+  // in the original order. The deterministic inputs between them are ordered
+  // by the time spent per row dropped. Errors are kept per row and cleared
+  // for the rows decided by other inputs, so the order does not change which
+  // rows fail.
+  const auto lessTimeToDrop = [this](int32_t left, int32_t right) {
+    return selectivity_[left].timeToDropValue() <
+        selectivity_[right].timeToDropValue();
+  };
+  auto begin = inputOrder_.begin();
+  while (begin != inputOrder_.end()) {
+    if (!inputs_[*begin]->isDeterministic()) {
+      ++begin;
+      continue;
     }
-  }
-  if (reorder) {
-    std::sort(
-        inputOrder_.begin(),
-        inputOrder_.end(),
-        [this](size_t left, size_t right) {
-          return selectivity_[left].timeToDropValue() <
-              selectivity_[right].timeToDropValue();
-        });
+    auto end = std::find_if(begin, inputOrder_.end(), [this](int32_t input) {
+      return !inputs_[input]->isDeterministic();
+    });
+    if (!std::is_sorted(begin, end, lessTimeToDrop)) {
+      std::sort(begin, end, lessTimeToDrop);
+    }
+    begin = end;
   }
 }
 
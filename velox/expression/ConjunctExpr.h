@@ -68,6 +68,11 @@ class ConjunctExpr : public SpecialForm {
     return selectivity_[inputOrder_[index]];
   }
 
+  /// The indices of 'inputs_' in the order of evaluation.
+  const std::vector<int32_t>& inputOrder() const {
+    return inputOrder_;
+  }
+
   std::string toSql(
       std::vector<VectorPtr>* complexConstants = nullptr) const override;
 
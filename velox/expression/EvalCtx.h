@@ -19,6 +19,7 @@
 #include <functional>
 
 #include "velox/common/base/Portability.h"
+#include "velox/common/base/VeloxException.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
@@ -87,6 +88,14 @@ class EvalCtx {
       const SelectivityVector& rows,
       const std::exception_ptr& exceptionPtr);
 
+  /// Same as 'setError' for an 'exceptionPtr' that holds a VeloxException.
+  /// Unlike 'setError', does not rethrow the exception to check its type, so
+  /// an error made with std::make_exception_ptr() is recorded without any
+  /// throwing if 'throwOnError' is false.
+  void setVeloxExceptionError(
+      vector_size_t index,
+      const std::exception_ptr& exceptionPtr);
+
   /// Invokes a function on each selected row. Records per-row exceptions by
   /// calling 'setError'. The function must take a single "row" argument of type
   /// vector_size_t and return void.
@@ -95,6 +104,8 @@ class EvalCtx {
     rows.template applyToSelected([&](auto row) INLINE_LAMBDA {
       try {
         func(row);
+      } catch (const VeloxException& e) {
+        setVeloxExceptionError(row, std::current_exception());
       } catch (const std::exception& e) {
         setError(row, std::current_exception());
       }
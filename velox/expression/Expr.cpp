@@ -20,6 +20,7 @@
 
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Fs.h"
+#include "velox/common/base/SamplingProfiler.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/core/Expressions.h"
 #include "velox/expression/ConstantExpr.h"
@@ -663,6 +664,7 @@ void Expr::evaluateSharedSubexpr(
 
   if (rows.isSubset(*sharedSubexprRows)) {
     // We have results for all requested rows. No need to compute anything.
+    stats_.numReusedRows += rows.countSelected();
     context.moveOrCopyResult(sharedSubexprValues, rows, result);
     return;
   }
@@ -676,6 +678,7 @@ void Expr::evaluateSharedSubexpr(
   auto missingRows = missingRowsHolder.get();
   missingRows->deselect(*sharedSubexprRows);
   VELOX_DCHECK(missingRows->hasSelections());
+  stats_.numReusedRows += rows.countSelected() - missingRows->countSelected();
 
   // Fix finalSelection to avoid losing values outside missingRows.
   // Final selection of rows need to include sharedSubexprRows_, missingRows and
@@ -1313,6 +1316,7 @@ void Expr::applyFunction(
   stats_.numProcessedVectors += 1;
   stats_.numProcessedRows += rows.countSelected();
   auto timer = cpuWallTimer();
+  SamplingProfiler::LabelScope profilerLabel(name_);
 
   computeIsAsciiForInputs(vectorFunction_.get(), inputValues_, rows);
   auto isAscii = type()->isVarchar()
@@ -1320,7 +1324,11 @@ void Expr::applyFunction(
       : std::nullopt;
 
   try {
-    vectorFunction_->apply(rows, inputValues_, type(), context, result);
+    if (!valueMemo_ ||
+        !valueMemo_->apply(
+            *vectorFunction_, rows, inputValues_, type(), context, result)) {
+      vectorFunction_->apply(rows, inputValues_, type(), context, result);
+    }
   } catch (const VeloxException& ve) {
     throw;
   } catch (const std::exception& e) {
@@ -1361,6 +1369,7 @@ void Expr::evalSpecialFormWithStats(
   stats_.numProcessedVectors += 1;
   stats_.numProcessedRows += rows.countSelected();
   auto timer = cpuWallTimer();
+  SamplingProfiler::LabelScope profilerLabel(name_);
 
   evalSpecialForm(rows, context, result);
 }
@@ -24,6 +24,7 @@
 #include "velox/core/Expressions.h"
 #include "velox/expression/DecodedArgs.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/expression/ValueMemo.h"
 #include "velox/vector/SimpleVector.h"
 
 /// GFlag used to enable saving input vector and expression SQL on disk in case
@@ -56,18 +57,25 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of rows of a common subexpression that reused the results of an
+  /// earlier evaluation of the same batch instead of being evaluated again.
+  uint64_t numReusedRows{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numReusedRows += other.numReusedRows;
   }
 
   std::string toString() const {
     return fmt::format(
-        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}",
+        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}, "
+        "numReusedRows: {}",
         timing.toString(),
         numProcessedRows,
-        numProcessedVectors);
+        numProcessedVectors,
+        numReusedRows);
   }
 };
 
@@ -166,6 +174,19 @@ class Expr {
     baseDictionary_ = nullptr;
     dictionaryCache_ = nullptr;
     cachedDictionaryIndices_ = nullptr;
+    if (valueMemo_) {
+      valueMemo_->clear();
+    }
+  }
+
+  /// Makes 'this' remember the results of its function by argument value, see
+  /// ValueMemo.
+  void setValueMemo(std::unique_ptr<ValueMemo> valueMemo) {
+    valueMemo_ = std::move(valueMemo);
+  }
+
+  const ValueMemo* FOLLY_NULLABLE valueMemo() const {
+    return valueMemo_.get();
   }
 
   const TypePtr& type() const {
@@ -455,6 +476,10 @@ class Expr {
   // Count of times the cacheable vector is seen for a non-first time.
   int32_t numCacheableRepeats_{0};
 
+  // Results of the function by argument value, kept across batches. Set only
+  // for some deterministic functions of one string argument.
+  std::unique_ptr<ValueMemo> valueMemo_;
+
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
 };
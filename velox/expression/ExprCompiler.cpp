@@ -38,6 +38,12 @@ const char* const kAnd = "and";
 const char* const kOr = "or";
 const char* const kRowConstructor = "row_constructor";
 const char* const kRowConstructorWithNull = "row_constructor_with_null";
+const char* const kJsonExtractScalar = "json_extract_scalar";
+const char* const kJsonExtractScalars = "$internal$json_extract_scalars";
+const char* const kTransform = "transform";
+const char* const kReduce = "reduce";
+const char* const kFilter = "filter";
+const char* const kMapFilter = "map_filter";
 
 struct ITypedExprHasher {
   size_t operator()(const ITypedExpr* expr) const {
@@ -83,6 +89,14 @@ struct Scope {
   // Deduplicatable ITypedExprs. Only applies within the one scope.
   ExprDedupMap visited;
 
+  // True if the subexpressions of the lambda body that reference only
+  // captures are compiled in 'parent' and referenced as extra captures.
+  bool hoistInvariants{false};
+  // Names of the extra captures. Corresponds 1:1 to 'hoistedExprs'.
+  std::vector<std::string> hoistedNames;
+  // Expressions of 'parent' whose values the lambda body references.
+  std::vector<ExprPtr> hoistedExprs;
+
   Scope(std::vector<std::string>&& _locals, Scope* _parent, ExprSet* _exprSet)
       : locals(_locals), parent(_parent), exprSet(_exprSet) {}
 
@@ -112,6 +126,15 @@ bool isCall(const TypedExprPtr& expr, const std::string& name) {
   return false;
 }
 
+// Returns 'name' without the prefix a function may be registered with, e.g.
+// presto.default.
+std::string_view withoutPrefix(std::string_view name) {
+  if (auto pos = name.rfind('.'); pos != std::string_view::npos) {
+    return name.substr(pos + 1);
+  }
+  return name;
+}
+
 // Flattens nested ANDs or ORs into a vector of conjuncts
 // Examples:
 // in: a AND (b AND (c AND d))
@@ -145,6 +168,123 @@ ExprPtr compileExpression(
     const std::unordered_set<std::string>& flatteningCandidates,
     bool enableConstantFolding);
 
+// Minimum number of equalities of the same column to constants in a
+// disjunction that are replaced by an IN predicate.
+constexpr int32_t kMinEqualitiesForIn = 3;
+
+// Returns true if 'expr' is a column or a field of a struct column.
+bool isColumnAccess(const core::ITypedExpr& expr) {
+  auto access = dynamic_cast<const core::FieldAccessTypedExpr*>(&expr);
+  if (!access) {
+    return false;
+  }
+  return access->isInputColumn() || access->inputs().empty() ||
+      isColumnAccess(*access->inputs()[0]);
+}
+
+// If 'expr' is an equality of a column to a non-null constant, returns the
+// column and the constant as a vector of size 1.
+std::optional<std::pair<TypedExprPtr, VectorPtr>> asColumnEqualsConstant(
+    const TypedExprPtr& expr,
+    memory::MemoryPool* pool) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (!call || call->inputs().size() != 2) {
+    return std::nullopt;
+  }
+  if (withoutPrefix(call->name()) != "eq") {
+    return std::nullopt;
+  }
+  for (auto i = 0; i < 2; ++i) {
+    const auto& column = call->inputs()[i];
+    auto constant = dynamic_cast<const core::ConstantTypedExpr*>(
+        call->inputs()[1 - i].get());
+    if (!constant || !isColumnAccess(*column) ||
+        !(*constant->type() == *column->type())) {
+      continue;
+    }
+    auto value = constant->toConstantVector(pool);
+    if (!value->isNullAt(0)) {
+      return std::make_pair(column, value);
+    }
+  }
+  return std::nullopt;
+}
+
+// Replaces kMinEqualitiesForIn or more equalities of the same column to
+// constants in the disjuncts 'flat' with an IN predicate at the position of
+// the first of them, e.g. a = 1 OR b > 0 OR a = 2 OR a = 3 becomes
+// a IN (1, 2, 3) OR b > 0. The IN predicate probes a hash table or bitmap
+// built once instead of comparing to each constant.
+void rewriteEqualitiesAsIn(
+    std::vector<TypedExprPtr>& flat,
+    memory::MemoryPool* pool) {
+  if (flat.size() < kMinEqualitiesForIn) {
+    return;
+  }
+  // The positions in 'flat' and the constants of the equalities by column.
+  struct Equalities {
+    TypedExprPtr column;
+    std::vector<size_t> positions;
+    std::vector<VectorPtr> constants;
+  };
+  std::vector<Equalities> equalities;
+  folly::F14FastMap<
+      const core::ITypedExpr*,
+      size_t,
+      ITypedExprHasher,
+      ITypedExprComparer>
+      columnIndices;
+  for (auto i = 0; i < flat.size(); ++i) {
+    if (auto equality = asColumnEqualsConstant(flat[i], pool)) {
+      auto [it, inserted] =
+          columnIndices.emplace(equality->first.get(), equalities.size());
+      if (inserted) {
+        equalities.push_back({equality->first, {}, {}});
+      }
+      equalities[it->second].positions.push_back(i);
+      equalities[it->second].constants.push_back(equality->second);
+    }
+  }
+
+  std::vector<bool> removed(flat.size(), false);
+  for (const auto& [column, positions, constants] : equalities) {
+    const auto& type = column->type();
+    if (positions.size() < kMinEqualitiesForIn ||
+        !resolveVectorFunction("in", {type, ARRAY(type)})) {
+      continue;
+    }
+    auto elements = BaseVector::create(type, constants.size(), pool);
+    for (auto i = 0; i < constants.size(); ++i) {
+      elements->copy(constants[i].get(), i, 0, 1);
+    }
+    auto inList = std::make_shared<ArrayVector>(
+        pool,
+        ARRAY(type),
+        nullptr,
+        1,
+        allocateOffsets(1, pool),
+        allocateSizes(1, pool),
+        elements);
+    inList->setOffsetAndSize(0, 0, constants.size());
+    flat[positions[0]] = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<TypedExprPtr>{
+            column, std::make_shared<core::ConstantTypedExpr>(inList)},
+        "in");
+    for (auto i = 1; i < positions.size(); ++i) {
+      removed[positions[i]] = true;
+    }
+  }
+
+  auto numKept = 0;
+  for (auto i = 0; i < flat.size(); ++i) {
+    if (!removed[i]) {
+      flat[numKept++] = std::move(flat[i]);
+    }
+  }
+  flat.resize(numKept);
+}
+
 std::vector<ExprPtr> compileInputs(
     const TypedExprPtr& expr,
     Scope* scope,
@@ -154,33 +294,38 @@ std::vector<ExprPtr> compileInputs(
     bool enableConstantFolding) {
   std::vector<ExprPtr> compiledInputs;
   auto flattenIf = shouldFlatten(expr, flatteningCandidates);
+  if (flattenIf.has_value()) {
+    std::vector<TypedExprPtr> flat;
+    for (auto& input : expr->inputs()) {
+      flattenInput(input, flattenIf.value(), flat);
+    }
+    if (flattenIf.value() == kOr) {
+      rewriteEqualitiesAsIn(flat, pool);
+    }
+    for (auto& input : flat) {
+      compiledInputs.push_back(compileExpression(
+          input,
+          scope,
+          config,
+          pool,
+          flatteningCandidates,
+          enableConstantFolding));
+    }
+    return compiledInputs;
+  }
   for (auto& input : expr->inputs()) {
     if (dynamic_cast<const core::InputTypedExpr*>(input.get())) {
       VELOX_CHECK(
           dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get()),
           "An InputReference can only occur under a FieldReference");
     } else {
-      if (flattenIf.has_value()) {
-        std::vector<TypedExprPtr> flat;
-        flattenInput(input, flattenIf.value(), flat);
-        for (auto& input : flat) {
-          compiledInputs.push_back(compileExpression(
-              input,
-              scope,
-              config,
-              pool,
-              flatteningCandidates,
-              enableConstantFolding));
-        }
-      } else {
-        compiledInputs.push_back(compileExpression(
-            input,
-            scope,
-            config,
-            pool,
-            flatteningCandidates,
-            enableConstantFolding));
-      }
+      compiledInputs.push_back(compileExpression(
+          input,
+          scope,
+          config,
+          pool,
+          flatteningCandidates,
+          enableConstantFolding));
     }
   }
   return compiledInputs;
@@ -275,6 +420,71 @@ void captureFieldReference(
   }
 }
 
+// Returns true if 'expr' has no lambda and references no column in 'locals'.
+// Sets 'hasField' if 'expr' references a column.
+bool referencesOnlyCaptures(
+    const core::ITypedExpr& expr,
+    const std::vector<std::string>& locals,
+    bool& hasField) {
+  if (dynamic_cast<const core::LambdaTypedExpr*>(&expr)) {
+    return false;
+  }
+  if (auto access = dynamic_cast<const core::FieldAccessTypedExpr*>(&expr)) {
+    if (access->isInputColumn()) {
+      hasField = true;
+      return std::find(locals.begin(), locals.end(), access->name()) ==
+          locals.end();
+    }
+  }
+  for (const auto& input : expr.inputs()) {
+    if (!referencesOnlyCaptures(*input, locals, hasField)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compiles 'expr' of a lambda body in the enclosing scope of 'scope' if it is
+// a call that references only captures and is deterministic. Returns a
+// reference to its value as an extra capture of the lambda or nullptr if
+// 'expr' is not hoisted.
+ExprPtr maybeHoist(
+    const TypedExprPtr& expr,
+    Scope* scope,
+    const core::QueryConfig& config,
+    memory::MemoryPool* pool,
+    const std::unordered_set<std::string>& flatteningCandidates,
+    bool enableConstantFolding) {
+  if (!dynamic_cast<const core::CallTypedExpr*>(expr.get()) &&
+      !dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return nullptr;
+  }
+  bool hasField = false;
+  if (!referencesOnlyCaptures(*expr, scope->locals, hasField) || !hasField) {
+    return nullptr;
+  }
+  // Identical expressions of the enclosing scope are shared with the hoisted
+  // one.
+  auto outer = compileExpression(
+      expr,
+      scope->parent,
+      config,
+      pool,
+      flatteningCandidates,
+      enableConstantFolding);
+  if (!outer->isDeterministic() ||
+      dynamic_cast<const ConstantExpr*>(outer.get())) {
+    return nullptr;
+  }
+  auto name = fmt::format("__hoisted{}", scope->hoistedExprs.size());
+  scope->hoistedNames.push_back(name);
+  scope->hoistedExprs.push_back(std::move(outer));
+  auto reference = std::make_shared<FieldReference>(
+      expr->type(), std::vector<ExprPtr>{}, name);
+  reference->computeMetadata();
+  return reference;
+}
+
 std::shared_ptr<Expr> compileLambda(
     const core::LambdaTypedExpr* lambda,
     Scope* scope,
@@ -312,12 +522,79 @@ std::shared_ptr<Expr> compileLambda(
 
   auto functionType = std::make_shared<FunctionType>(
       std::vector<TypePtr>(signature->children()), body->type());
-  return std::make_shared<LambdaExpr>(
+  auto lambdaExpr = std::make_shared<LambdaExpr>(
       std::move(functionType),
-      std::move(signature),
+      RowTypePtr(signature),
       std::move(captureReferences),
       std::move(body),
       config.exprTrackCpuUsage());
+
+  if (config.exprLambdaHoistingEnabled()) {
+    // Compiles the body a second time with the subexpressions that depend
+    // only on captures moved to the enclosing scope. The body as written is
+    // kept for batches where one of these fails. The hoisted body references
+    // a subset of the captures of the body as written.
+    auto hoistingLocals = signature->names();
+    Scope hoistingScope(std::move(hoistingLocals), scope, scope->exprSet);
+    hoistingScope.hoistInvariants = true;
+    auto hoistedBody = compileExpression(
+        lambda->body(),
+        &hoistingScope,
+        config,
+        pool,
+        flatteningCandidates,
+        enableConstantFolding);
+    if (!hoistingScope.hoistedExprs.empty()) {
+      lambdaExpr->setHoisted(
+          std::move(hoistingScope.hoistedNames),
+          std::move(hoistingScope.hoistedExprs),
+          std::move(hoistedBody));
+    }
+  }
+  return lambdaExpr;
+}
+
+// Makes 'expr' remember the results of its function by argument value if the
+// function is configured for this, deterministic, has default null behavior
+// and a primitive result, and all but one string argument are constant.
+void maybeSetValueMemo(
+    Expr& expr,
+    const core::QueryConfig& config,
+    Scope* scope) {
+  if (expr.isSpecialForm() || !expr.vectorFunction() ||
+      !expr.isDeterministic() ||
+      !expr.vectorFunction()->isDefaultNullBehavior() ||
+      !expr.type()->isPrimitiveType()) {
+    return;
+  }
+
+  std::optional<column_index_t> keyIndex;
+  const auto& inputs = expr.inputs();
+  for (auto i = 0; i < inputs.size(); ++i) {
+    if (dynamic_cast<const ConstantExpr*>(inputs[i].get())) {
+      continue;
+    }
+    const auto kind = inputs[i]->type()->kind();
+    if (keyIndex.has_value() ||
+        (kind != TypeKind::VARCHAR && kind != TypeKind::VARBINARY)) {
+      return;
+    }
+    keyIndex = i;
+  }
+  if (!keyIndex.has_value()) {
+    return;
+  }
+
+  const auto name = withoutPrefix(expr.name());
+  std::vector<std::string> functions;
+  folly::split(',', config.exprValueMemoFunctions(), functions, true);
+  if (std::find(functions.begin(), functions.end(), name) == functions.end()) {
+    return;
+  }
+
+  expr.setValueMemo(
+      std::make_unique<ValueMemo>(*keyIndex, config.exprValueMemoMaxBytes()));
+  scope->exprSet->addToMemo(&expr);
 }
 
 ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
@@ -388,6 +665,19 @@ ExprPtr compileExpression(
     return alreadyCompiled;
   }
 
+  if (scope->hoistInvariants) {
+    if (auto hoisted = maybeHoist(
+            expr,
+            scope,
+            config,
+            pool,
+            flatteningCandidates,
+            enableConstantFolding)) {
+      scope->visited[expr.get()] = hoisted;
+      return hoisted;
+    }
+  }
+
   const bool trackCpuUsage = config.exprTrackCpuUsage();
 
   ExprPtr result;
@@ -508,6 +798,9 @@ ExprPtr compileExpression(
 
   auto folded =
       enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
+  if (folded == result && config.exprValueMemoEnabled()) {
+    maybeSetValueMemo(*result, config, scope);
+  }
   scope->visited[expr.get()] = folded;
   return folded;
 }
@@ -548,6 +841,394 @@ std::unordered_set<std::string> collectFlatteningCandidates(
     return flatteningCandidates;
   });
 }
+
+using TypedExprIndexMap = folly::F14FastMap<
+    const ITypedExpr*,
+    size_t,
+    ITypedExprHasher,
+    ITypedExprComparer>;
+
+// The json_extract_scalar calls with constant paths on the same input.
+struct JsonExtracts {
+  TypedExprPtr input;
+  // The function name, including the prefix it is registered with.
+  std::string name;
+  // The distinct paths.
+  std::vector<std::string> paths;
+  // The calls and, at the same positions, the index of their path in 'paths'.
+  std::vector<TypedExprPtr> calls;
+  std::vector<size_t> pathIndices;
+};
+
+// Adds the json_extract_scalar calls in 'expr' with a non-null constant path
+// and an input that is not constant to 'groups', by input. The bodies of
+// lambdas are not visited.
+void collectJsonExtracts(
+    const TypedExprPtr& expr,
+    memory::MemoryPool* pool,
+    TypedExprIndexMap& groupIndices,
+    std::vector<JsonExtracts>& groups) {
+  if (dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    return;
+  }
+  for (const auto& input : expr->inputs()) {
+    collectJsonExtracts(input, pool, groupIndices, groups);
+  }
+
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (!call || call->inputs().size() != 2 ||
+      withoutPrefix(call->name()) != kJsonExtractScalar) {
+    return;
+  }
+  const auto& input = call->inputs()[0];
+  auto path =
+      dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+  if (!path || path->type()->kind() != TypeKind::VARCHAR ||
+      dynamic_cast<const core::ConstantTypedExpr*>(input.get())) {
+    return;
+  }
+  auto value = path->toConstantVector(pool);
+  if (value->isNullAt(0)) {
+    return;
+  }
+
+  auto [it, inserted] = groupIndices.emplace(input.get(), groups.size());
+  if (inserted) {
+    groups.push_back({input, call->name(), {}, {}, {}});
+  }
+  auto& group = groups[it->second];
+  if (group.name != call->name()) {
+    return;
+  }
+  auto pathString = value->as<SimpleVector<StringView>>()->valueAt(0).str();
+  const size_t pathIndex =
+      std::find(group.paths.begin(), group.paths.end(), pathString) -
+      group.paths.begin();
+  if (pathIndex == group.paths.size()) {
+    group.paths.push_back(std::move(pathString));
+  }
+  group.calls.push_back(expr);
+  group.pathIndices.push_back(pathIndex);
+}
+
+// Returns a copy of 'expr' with 'inputs' as inputs. 'expr' is not a lambda.
+TypedExprPtr withInputs(
+    const TypedExprPtr& expr,
+    std::vector<TypedExprPtr> inputs) {
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), std::move(inputs), call->name());
+  }
+  if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CastTypedExpr>(
+        cast->type(), inputs, cast->nullOnFailure());
+  }
+  if (auto access =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    return std::make_shared<core::FieldAccessTypedExpr>(
+        access->type(), inputs[0], access->name());
+  }
+  if (dynamic_cast<const core::ConcatTypedExpr*>(expr.get())) {
+    return std::make_shared<core::ConcatTypedExpr>(
+        expr->type()->asRow().names(), inputs);
+  }
+  VELOX_UNREACHABLE("Unexpected typed expression: {}", expr->toString());
+}
+
+// Returns 'expr' with the subtrees that are keys of 'replacements' replaced by
+// the mapped expressions. The bodies of lambdas are not visited.
+TypedExprPtr replaceSubtrees(
+    const TypedExprPtr& expr,
+    const folly::F14FastMap<
+        const ITypedExpr*,
+        TypedExprPtr,
+        ITypedExprHasher,
+        ITypedExprComparer>& replacements) {
+  if (auto it = replacements.find(expr.get()); it != replacements.end()) {
+    return it->second;
+  }
+  if (dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    return expr;
+  }
+
+  std::vector<TypedExprPtr> inputs;
+  bool changed = false;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(replaceSubtrees(input, replacements));
+    changed |= inputs.back() != input;
+  }
+  return changed ? withInputs(expr, std::move(inputs)) : expr;
+}
+
+// Returns 'expr' with the column references that are keys of 'replacements'
+// replaced by the mapped expressions. 'expr' has no lambdas.
+TypedExprPtr replaceColumns(
+    const TypedExprPtr& expr,
+    const std::unordered_map<std::string, TypedExprPtr>& replacements) {
+  if (auto access =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    if (access->isInputColumn()) {
+      auto it = replacements.find(access->name());
+      return it == replacements.end() ? expr : it->second;
+    }
+  }
+
+  std::vector<TypedExprPtr> inputs;
+  bool changed = false;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(replaceColumns(input, replacements));
+    changed |= inputs.back() != input;
+  }
+  return changed ? withInputs(expr, std::move(inputs)) : expr;
+}
+
+// Adds the names of the columns 'expr' references to 'names'. Returns false
+// if 'expr' has a lambda.
+bool collectColumnNames(
+    const TypedExprPtr& expr,
+    std::unordered_set<std::string>& names) {
+  if (dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    return false;
+  }
+  if (auto access =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    if (access->isInputColumn()) {
+      names.insert(access->name());
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    if (!collectColumnNames(input, names)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns a call equivalent to 'call' that applies its lambda and the lambda
+// of the call producing its first argument in one pass over the elements of
+// the argument of that call, or nullptr if the calls do not compose:
+//  - transform(transform(a, x -> f), y -> g) is transform(a, x -> g[y := f]);
+//  - reduce(transform(a, x -> f), s0, (s, y) -> g, o) is
+//    reduce(a, s0, (s, x) -> g[y := f], o);
+//  - filter(filter(a, x -> p), y -> q) is filter(a, x -> if(p, q[y := x],
+//    false)) and map_filter(map_filter(m, ...), ...) is composed the same
+//    way. The second predicate is only evaluated for the elements that pass
+//    the first one, so errors are raised for the same elements.
+// The intermediate arrays or maps are not produced. Lambdas with nested
+// lambdas and lambdas whose captures would be shadowed by the parameters of
+// the composed lambda are not composed.
+TypedExprPtr composeLambdaCalls(const core::CallTypedExpr& call) {
+  const auto name = withoutPrefix(call.name());
+  const bool isFilter = name == kFilter || name == kMapFilter;
+  if (!isFilter && name != kTransform && name != kReduce) {
+    return nullptr;
+  }
+  auto inner = dynamic_cast<const core::CallTypedExpr*>(call.inputs()[0].get());
+  if (!inner || inner->inputs().size() != 2) {
+    return nullptr;
+  }
+  const auto innerName = withoutPrefix(inner->name());
+  if ((isFilter ? innerName != name : innerName != kTransform) ||
+      inner->name().substr(0, inner->name().size() - innerName.size()) !=
+          call.name().substr(0, call.name().size() - name.size())) {
+    return nullptr;
+  }
+  const auto lambdaIndex = name == kReduce ? 2 : 1;
+  if (call.inputs().size() <= lambdaIndex) {
+    return nullptr;
+  }
+  auto innerLambda =
+      dynamic_cast<const core::LambdaTypedExpr*>(inner->inputs()[1].get());
+  auto lambda = dynamic_cast<const core::LambdaTypedExpr*>(
+      call.inputs()[lambdaIndex].get());
+  if (!innerLambda || !lambda) {
+    return nullptr;
+  }
+
+  // The last parameters of 'lambda' take the elements, or the keys and
+  // values, that 'innerLambda' takes as parameters. The composed lambda takes
+  // the parameters of 'innerLambda' in their place.
+  const auto& innerParams = *innerLambda->signature();
+  const auto& params = *lambda->signature();
+  if (params.size() < innerParams.size()) {
+    return nullptr;
+  }
+  const auto firstElementParam = params.size() - innerParams.size();
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < firstElementParam; ++i) {
+    names.push_back(params.nameOf(i));
+    types.push_back(params.childAt(i));
+  }
+  for (auto i = 0; i < innerParams.size(); ++i) {
+    names.push_back(innerParams.nameOf(i));
+    types.push_back(innerParams.childAt(i));
+  }
+  if (std::unordered_set<std::string>(names.begin(), names.end()).size() !=
+      names.size()) {
+    return nullptr;
+  }
+
+  std::unordered_set<std::string> innerColumns;
+  std::unordered_set<std::string> columns;
+  if (!collectColumnNames(innerLambda->body(), innerColumns) ||
+      !collectColumnNames(lambda->body(), columns)) {
+    return nullptr;
+  }
+  const auto isParam = [&](const std::string& column) {
+    return std::find(names.begin(), names.end(), column) != names.end();
+  };
+  for (const auto& column : innerColumns) {
+    if (!innerParams.containsChild(column) && isParam(column)) {
+      return nullptr;
+    }
+  }
+  for (const auto& column : columns) {
+    if (!params.containsChild(column) && isParam(column)) {
+      return nullptr;
+    }
+  }
+
+  std::unordered_map<std::string, TypedExprPtr> replacements;
+  TypedExprPtr body;
+  if (isFilter) {
+    for (auto i = 0; i < innerParams.size(); ++i) {
+      replacements.emplace(
+          params.nameOf(firstElementParam + i),
+          std::make_shared<core::FieldAccessTypedExpr>(
+              innerParams.childAt(i), innerParams.nameOf(i)));
+    }
+    body = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<TypedExprPtr>{
+            innerLambda->body(),
+            replaceColumns(lambda->body(), replacements),
+            std::make_shared<core::ConstantTypedExpr>(
+                BOOLEAN(), variant(false))},
+        "if");
+  } else {
+    replacements.emplace(
+        params.nameOf(firstElementParam), innerLambda->body());
+    body = replaceColumns(lambda->body(), replacements);
+  }
+
+  auto inputs = call.inputs();
+  inputs[0] = inner->inputs()[0];
+  inputs[lambdaIndex] = std::make_shared<core::LambdaTypedExpr>(
+      ROW(std::move(names), std::move(types)), std::move(body));
+  return std::make_shared<core::CallTypedExpr>(
+      call.type(), std::move(inputs), call.name());
+}
+
+// Returns 'expr' with the chains of lambda functions composed bottom up by
+// composeLambdaCalls(), including the chains in the bodies of lambdas.
+TypedExprPtr composeLambdaChains(const TypedExprPtr& expr) {
+  if (auto lambda = dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    auto body = composeLambdaChains(lambda->body());
+    if (body == lambda->body()) {
+      return expr;
+    }
+    return std::make_shared<core::LambdaTypedExpr>(
+        lambda->signature(), std::move(body));
+  }
+
+  std::vector<TypedExprPtr> inputs;
+  bool changed = false;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(composeLambdaChains(input));
+    changed |= inputs.back() != input;
+  }
+  auto result = changed ? withInputs(expr, std::move(inputs)) : expr;
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(result.get())) {
+    if (auto composed = composeLambdaCalls(*call)) {
+      return composed;
+    }
+  }
+  return result;
+}
+
+std::vector<TypedExprPtr> composeLambdaChains(
+    const std::vector<TypedExprPtr>& sources) {
+  std::vector<TypedExprPtr> composed;
+  composed.reserve(sources.size());
+  for (const auto& source : sources) {
+    composed.push_back(composeLambdaChains(source));
+  }
+  return composed;
+}
+
+// Rewrites json_extract_scalar calls with different constant paths on the
+// same input, e.g. json_extract_scalar(j, '$.a') and
+// json_extract_scalar(j, '$.b'), to the fields p0 and p1 of one call to
+// $internal$json_extract_scalars(j, ROW('$.a', '$.b')). The call is a common
+// subexpression of 'sources', so each document is scanned once for all the
+// paths instead of once per path.
+std::vector<TypedExprPtr> rewriteJsonExtracts(
+    const std::vector<TypedExprPtr>& sources,
+    memory::MemoryPool* pool) {
+  TypedExprIndexMap groupIndices;
+  std::vector<JsonExtracts> groups;
+  for (const auto& source : sources) {
+    collectJsonExtracts(source, pool, groupIndices, groups);
+  }
+
+  folly::F14FastMap<
+      const ITypedExpr*,
+      TypedExprPtr,
+      ITypedExprHasher,
+      ITypedExprComparer>
+      replacements;
+  for (const auto& [input, name, paths, calls, pathIndices] : groups) {
+    if (paths.size() < 2) {
+      continue;
+    }
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    std::vector<VectorPtr> children;
+    for (auto i = 0; i < paths.size(); ++i) {
+      names.push_back(fmt::format("p{}", i));
+      types.push_back(VARCHAR());
+      auto child =
+          BaseVector::create<FlatVector<StringView>>(VARCHAR(), 1, pool);
+      child->set(0, StringView(paths[i]));
+      children.push_back(std::move(child));
+    }
+    auto rowType = ROW(std::move(names), std::move(types));
+    auto constantPaths = std::make_shared<core::ConstantTypedExpr>(
+        std::make_shared<RowVector>(
+            pool, rowType, nullptr, 1, std::move(children)));
+
+    // The function has the same prefix as json_extract_scalar. The
+    // rewrite is skipped if it is not registered or rejects the paths.
+    const auto extractName =
+        name.substr(0, name.rfind('.') + 1) + kJsonExtractScalars;
+    if (!getVectorFunction(
+            extractName,
+            {input->type(), rowType},
+            {nullptr, constantPaths->valueVector()})) {
+      continue;
+    }
+
+    auto extract = std::make_shared<core::CallTypedExpr>(
+        rowType, std::vector<TypedExprPtr>{input, constantPaths}, extractName);
+    for (auto i = 0; i < calls.size(); ++i) {
+      replacements.emplace(
+          calls[i].get(),
+          std::make_shared<core::FieldAccessTypedExpr>(
+              VARCHAR(), extract, rowType->nameOf(pathIndices[i])));
+    }
+  }
+  if (replacements.empty()) {
+    return sources;
+  }
+
+  std::vector<TypedExprPtr> rewritten;
+  rewritten.reserve(sources.size());
+  for (const auto& source : sources) {
+    rewritten.push_back(replaceSubtrees(source, replacements));
+  }
+  return rewritten;
+}
 } // namespace
 
 std::vector<std::shared_ptr<Expr>> compileExpressions(
@@ -559,11 +1240,16 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
   std::vector<std::shared_ptr<Expr>> exprs;
   exprs.reserve(sources.size());
 
+  // The deduplication of subexpressions refers to the rewritten expressions,
+  // so these are kept until the end of compilation.
+  const auto rewritten =
+      rewriteJsonExtracts(composeLambdaChains(sources), execCtx->pool());
+
   // Precompute a set of function calls that support flattening. This allows to
   // lock function registry once vs. locking for each function call.
-  auto flatteningCandidates = collectFlatteningCandidates(sources);
+  auto flatteningCandidates = collectFlatteningCandidates(rewritten);
 
-  for (auto& source : sources) {
+  for (auto& source : rewritten) {
     exprs.push_back(compileExpression(
         source,
         &scope,
@@ -15,6 +15,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <optional>
+
 #include "velox/expression/SignatureBinder.h"
 #include "velox/type/Type.h"
 
@@ -49,24 +54,86 @@ struct FunctionEntry {
   const FunctionFactory factory_;
 };
 
+/// Registry of the signatures of functions by name.
+///
+/// Registration can be lazy: in the scope of a LazyRegistration, a function
+/// registered under aliases only records how to build its metadata and the
+/// metadata of all functions of a name is built by the first lookup of the
+/// name. Building the metadata parses the signature of each instantiation,
+/// which is most of the cost of registering the hundreds of instantiations of
+/// a function library at startup, and most of these are never looked up.
+///
+/// Lookups only bind the signatures that have the number of arguments of the
+/// call and whose argument type kinds match the call, instead of all the
+/// signatures of the name.
+///
+/// Registration is not thread safe, lookups are.
 template <typename Function, typename Metadata>
 class FunctionRegistry {
   using SignatureMap = std::unordered_map<
       FunctionSignature,
       std::unique_ptr<const FunctionEntry<Function, Metadata>>>;
-  using FunctionMap = std::unordered_map<std::string, SignatureMap>;
+
+  // A signature with the kinds of the types of its arguments. The kind is
+  // std::nullopt for arguments that bind to types of more than one kind, like
+  // type variables, 'any', decimals and custom types.
+  struct Candidate {
+    const typename SignatureMap::value_type* signatureAndEntry;
+    std::vector<std::optional<TypeKind>> argumentKinds;
+  };
+
+  // The functions registered under a name.
+  struct Functions {
+    SignatureMap signatures;
+
+    // Registrations that have not built their metadata yet.
+    std::vector<void (*)(Functions&)> pending;
+
+    // True once 'pending' is empty and 'signatures' are indexed in
+    // 'fixedArity' and 'variableArity'.
+    std::atomic<bool> materialized{false};
+
+    // The signatures without variable arity by number of arguments.
+    std::unordered_map<size_t, std::vector<Candidate>> fixedArity;
+    std::vector<Candidate> variableArity;
+  };
+
+  using FunctionMap =
+      std::unordered_map<std::string, std::unique_ptr<Functions>>;
 
  public:
+  /// Makes the registrations with aliases lazy while alive. Registrations
+  /// without aliases are never lazy since their name comes from their
+  /// metadata. Errors in the metadata of a lazily registered function are
+  /// raised by the first lookup of its name.
+  class LazyRegistration {
+   public:
+    explicit LazyRegistration(FunctionRegistry& registry)
+        : registry_(registry) {
+      ++registry_.lazyRegistrationDepth_;
+    }
+
+    ~LazyRegistration() {
+      --registry_.lazyRegistrationDepth_;
+    }
+
+   private:
+    FunctionRegistry& registry_;
+  };
+
   template <typename UDF>
   void registerFunction(const std::vector<std::string>& aliases = {}) {
-    const auto& metadata = GetSingletonUdfMetadata<typename UDF::Metadata>();
-    const auto factory = [metadata]() { return CreateUdf<UDF>(); };
-
     if (aliases.empty()) {
-      registerFunctionInternal(metadata->getName(), metadata, factory);
-    } else {
-      for (const auto& name : aliases) {
-        registerFunctionInternal(name, metadata, factory);
+      const auto& metadata = GetSingletonUdfMetadata<typename UDF::Metadata>();
+      addFunction<UDF>(functionsOf(metadata->getName()));
+      return;
+    }
+    for (const auto& name : aliases) {
+      auto& functions = functionsOf(name);
+      if (lazyRegistrationDepth_ > 0 && !functions.materialized) {
+        functions.pending.push_back(&addFunction<UDF>);
+      } else {
+        addFunction<UDF>(functions);
       }
     }
   }
@@ -90,9 +157,9 @@ class FunctionRegistry {
   std::vector<const FunctionSignature*> getFunctionSignatures(
       const std::string& name) const {
     std::vector<const FunctionSignature*> signatures;
-    if (const auto* signatureMap = getSignatureMap(name)) {
-      signatures.reserve(signatureMap->size());
-      for (const auto& pair : *signatureMap) {
+    if (const auto* functions = getFunctions(name)) {
+      signatures.reserve(functions->signatures.size());
+      for (const auto& pair : functions->signatures) {
         signatures.emplace_back(&pair.first);
       }
     }
@@ -129,19 +196,33 @@ class FunctionRegistry {
       const std::vector<TypePtr>& argTypes) const {
     const FunctionEntry<Function, Metadata>* selectedCandidate = nullptr;
     TypePtr selectedCandidateType = nullptr;
-    if (const auto* signatureMap = getSignatureMap(name)) {
-      for (const auto& [candidateSignature, functionEntry] : *signatureMap) {
-        SignatureBinder binder(candidateSignature, argTypes);
-        if (binder.tryBind()) {
-          auto* currentCandidate = functionEntry.get();
-          if (!selectedCandidate ||
-              currentCandidate->getMetadata().priority() <
-                  selectedCandidate->getMetadata().priority()) {
-            selectedCandidate = currentCandidate;
-            selectedCandidateType = binder.tryResolveReturnType();
-          }
+    auto tryCandidate = [&](const Candidate& candidate) {
+      if (!matchesKinds(candidate, argTypes)) {
+        return;
+      }
+      const auto& [candidateSignature, functionEntry] =
+          *candidate.signatureAndEntry;
+      SignatureBinder binder(candidateSignature, argTypes);
+      if (binder.tryBind()) {
+        auto* currentCandidate = functionEntry.get();
+        if (!selectedCandidate ||
+            currentCandidate->getMetadata().priority() <
+                selectedCandidate->getMetadata().priority()) {
+          selectedCandidate = currentCandidate;
+          selectedCandidateType = binder.tryResolveReturnType();
+        }
+      }
+    };
+    if (const auto* functions = getFunctions(name)) {
+      auto it = functions->fixedArity.find(argTypes.size());
+      if (it != functions->fixedArity.end()) {
+        for (const auto& candidate : it->second) {
+          tryCandidate(candidate);
         }
       }
+      for (const auto& candidate : functions->variableArity) {
+        tryCandidate(candidate);
+      }
     }
 
     VELOX_DCHECK(!selectedCandidate || selectedCandidateType);
@@ -162,24 +243,101 @@ class FunctionRegistry {
     return std::make_unique<T>();
   }
 
-  void registerFunctionInternal(
-      const std::string& name,
-      const std::shared_ptr<const Metadata>& metadata,
-      const typename FunctionEntry<Function, Metadata>::FunctionFactory&
-          factory) {
-    const auto sanitizedName = sanitizeName(name);
-    SignatureMap& signatureMap = registeredFunctions_[sanitizedName];
-    signatureMap[*metadata->signature()] =
+  // Builds the metadata of UDF and adds its signature to 'functions'.
+  template <typename UDF>
+  static void addFunction(Functions& functions) {
+    const auto& metadata = GetSingletonUdfMetadata<typename UDF::Metadata>();
+    const auto factory = [metadata]() { return CreateUdf<UDF>(); };
+    functions.signatures[*metadata->signature()] =
         std::make_unique<const FunctionEntry<Function, Metadata>>(
             metadata, factory);
+    if (functions.materialized) {
+      indexSignatures(functions);
+    }
+  }
+
+  Functions& functionsOf(const std::string& name) {
+    auto& functions = registeredFunctions_[sanitizeName(name)];
+    if (!functions) {
+      functions = std::make_unique<Functions>();
+    }
+    return *functions;
+  }
+
+  // Returns the functions of 'name' with their pending registrations done, or
+  // nullptr if there are none.
+  const Functions* getFunctions(const std::string& name) const {
+    const auto it = registeredFunctions_.find(sanitizeName(name));
+    if (it == registeredFunctions_.end()) {
+      return nullptr;
+    }
+    auto& functions = *it->second;
+    if (!functions.materialized.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> l(materializeMutex_);
+      if (!functions.materialized.load(std::memory_order_relaxed)) {
+        for (auto* add : functions.pending) {
+          add(functions);
+        }
+        functions.pending.clear();
+        indexSignatures(functions);
+        functions.materialized.store(true, std::memory_order_release);
+      }
+    }
+    return &functions;
   }
 
-  const SignatureMap* getSignatureMap(const std::string& name) const {
-    const auto sanitizedName = sanitizeName(name);
-    const auto it = registeredFunctions_.find(sanitizedName);
-    return it != registeredFunctions_.end() ? &it->second : nullptr;
+  static void indexSignatures(Functions& functions) {
+    functions.fixedArity.clear();
+    functions.variableArity.clear();
+    for (const auto& signatureAndEntry : functions.signatures) {
+      const auto& signature = signatureAndEntry.first;
+      Candidate candidate{&signatureAndEntry, {}};
+      for (const auto& argument : signature.argumentTypes()) {
+        candidate.argumentKinds.push_back(argumentKind(signature, argument));
+      }
+      if (signature.variableArity()) {
+        functions.variableArity.push_back(std::move(candidate));
+      } else {
+        functions.fixedArity[signature.argumentTypes().size()].push_back(
+            std::move(candidate));
+      }
+    }
+  }
+
+  // The kind of the types that SignatureBinder binds to 'argument', which
+  // have the name of 'argument' unless it is a variable, 'any' or 'decimal'.
+  static std::optional<TypeKind> argumentKind(
+      const FunctionSignature& signature,
+      const TypeSignature& argument) {
+    if (signature.variables().count(argument.baseName())) {
+      return std::nullopt;
+    }
+    std::string upperName = argument.baseName();
+    for (auto& c : upperName) {
+      c = std::toupper(static_cast<unsigned char>(c));
+    }
+    return tryMapNameToTypeKind(upperName);
+  }
+
+  // Returns false if 'argTypes' can't bind to the signature of 'candidate'.
+  static bool matchesKinds(
+      const Candidate& candidate,
+      const std::vector<TypePtr>& argTypes) {
+    const auto& kinds = candidate.argumentKinds;
+    for (auto i = 0; i < kinds.size() && i < argTypes.size(); ++i) {
+      if (kinds[i].has_value() &&
+          (!argTypes[i] || argTypes[i]->kind() != kinds[i].value())) {
+        return false;
+      }
+    }
+    return true;
   }
 
   FunctionMap registeredFunctions_;
+
+  // Serializes the pending registrations run by lookups.
+  mutable std::mutex materializeMutex_;
+
+  int32_t lazyRegistrationDepth_{0};
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,845 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/expression/FusedKernel.h"
+
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+namespace detail {
+
+constexpr vector_size_t kTileSize = 1024;
+constexpr size_t kSlotBytes = kTileSize * sizeof(int64_t);
+
+// The rows of the tile being evaluated and the scratch space for the results
+// of the nodes.
+struct TileState {
+  // The row numbers in the input, 'numRows' of them.
+  const vector_size_t* rows;
+  vector_size_t numRows;
+  // The decoded input columns by channel. Only the referenced ones are set.
+  std::vector<DecodedVector>* columns;
+  // One tile of kSlotBytes per node.
+  char* scratch;
+  // Set if integer arithmetic overflowed or divided by zero.
+  bool failed{false};
+
+  template <typename T>
+  T* slot(int32_t index) {
+    return reinterpret_cast<T*>(scratch + index * kSlotBytes);
+  }
+};
+
+class FusedNode {
+ public:
+  explicit FusedNode(int32_t slot) : slot_(slot) {}
+
+  virtual ~FusedNode() = default;
+
+  // Writes the values for the rows of 'state' to 'result', which points to
+  // values of the type of 'this'.
+  virtual void eval(TileState& state, void* result) const = 0;
+
+  // Writes the values for the rows of 'state' to the flat vector 'result'
+  // starting at 'offset'.
+  virtual void evalInto(
+      TileState& state,
+      BaseVector& result,
+      vector_size_t offset) const = 0;
+
+  // The index of the scratch tile for the results of 'this'.
+  int32_t slot() const {
+    return slot_;
+  }
+
+ protected:
+  // Evaluates 'input' into its scratch tile and returns the values.
+  template <typename T>
+  static const T* evalInput(const FusedNode& input, TileState& state) {
+    auto* values = state.slot<T>(input.slot());
+    input.eval(state, values);
+    return values;
+  }
+
+  const int32_t slot_;
+};
+
+namespace {
+
+template <typename T>
+class TypedNode : public FusedNode {
+ public:
+  using FusedNode::FusedNode;
+
+  void eval(TileState& state, void* result) const final {
+    evalTyped(state, static_cast<T*>(result));
+  }
+
+  void evalInto(TileState& state, BaseVector& result, vector_size_t offset)
+      const final {
+    auto* flat = result.asUnchecked<FlatVector<T>>();
+    if constexpr (std::is_same_v<T, bool>) {
+      auto* values = state.slot<bool>(slot_);
+      evalTyped(state, values);
+      auto* bits = flat->template mutableRawValues<uint64_t>();
+      for (auto i = 0; i < state.numRows; ++i) {
+        bits::setBit(bits, offset + i, values[i]);
+      }
+    } else {
+      evalTyped(state, flat->mutableRawValues() + offset);
+    }
+  }
+
+ protected:
+  virtual void evalTyped(TileState& state, T* result) const = 0;
+};
+
+template <typename T>
+class FieldNode : public TypedNode<T> {
+ public:
+  FieldNode(int32_t slot, column_index_t channel)
+      : TypedNode<T>(slot), channel_(channel) {}
+
+ protected:
+  void evalTyped(TileState& state, T* result) const override {
+    auto& decoded = (*state.columns)[channel_];
+    const auto* rows = state.rows;
+    const auto numRows = state.numRows;
+    if constexpr (std::is_same_v<T, bool>) {
+      for (auto i = 0; i < numRows; ++i) {
+        result[i] = decoded.valueAt<bool>(rows[i]);
+      }
+    } else {
+      const auto* values = decoded.data<T>();
+      if (decoded.isIdentityMapping()) {
+        for (auto i = 0; i < numRows; ++i) {
+          result[i] = values[rows[i]];
+        }
+      } else if (decoded.isConstantMapping()) {
+        std::fill_n(result, numRows, values[decoded.index(0)]);
+      } else {
+        const auto* indices = decoded.indices();
+        for (auto i = 0; i < numRows; ++i) {
+          result[i] = values[indices[rows[i]]];
+        }
+      }
+    }
+  }
+
+ private:
+  const column_index_t channel_;
+};
+
+template <typename T>
+class ConstantNode : public TypedNode<T> {
+ public:
+  ConstantNode(int32_t slot, const variant& value)
+      : TypedNode<T>(slot), value_(value.value<T>()) {}
+
+ protected:
+  void evalTyped(TileState& state, T* result) const override {
+    std::fill_n(result, state.numRows, value_);
+  }
+
+ private:
+  const T value_;
+};
+
+// The arithmetic operators set 'result' and return false if the Presto
+// function of the same name would raise an error.
+struct PlusOp {
+  template <typename T>
+  static bool apply(T a, T b, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      return !__builtin_add_overflow(a, b, &result);
+    } else {
+      result = a + b;
+      return true;
+    }
+  }
+};
+
+struct MinusOp {
+  template <typename T>
+  static bool apply(T a, T b, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      return !__builtin_sub_overflow(a, b, &result);
+    } else {
+      result = a - b;
+      return true;
+    }
+  }
+};
+
+struct MultiplyOp {
+  template <typename T>
+  static bool apply(T a, T b, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      return !__builtin_mul_overflow(a, b, &result);
+    } else {
+      result = a * b;
+      return true;
+    }
+  }
+};
+
+struct DivideOp {
+  template <typename T>
+  static bool apply(T a, T b, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      if (b == 0 || (b == -1 && a == std::numeric_limits<T>::min())) {
+        result = 0;
+        return false;
+      }
+    }
+    result = a / b;
+    return true;
+  }
+};
+
+template <typename T, typename TOp>
+class ArithmeticNode : public TypedNode<T> {
+ public:
+  ArithmeticNode(
+      int32_t slot,
+      std::unique_ptr<FusedNode> left,
+      std::unique_ptr<FusedNode> right)
+      : TypedNode<T>(slot), left_(std::move(left)), right_(std::move(right)) {}
+
+ protected:
+  void evalTyped(TileState& state, T* result) const override {
+    const auto* left = FusedNode::evalInput<T>(*left_, state);
+    const auto* right = FusedNode::evalInput<T>(*right_, state);
+    bool ok = true;
+    for (auto i = 0; i < state.numRows; ++i) {
+      ok &= TOp::apply(left[i], right[i], result[i]);
+    }
+    if (!ok) {
+      state.failed = true;
+    }
+  }
+
+ private:
+  const std::unique_ptr<FusedNode> left_;
+  const std::unique_ptr<FusedNode> right_;
+};
+
+template <typename TOp>
+struct ArithmeticNodes {
+  template <typename T>
+  using Node = ArithmeticNode<T, TOp>;
+};
+
+template <typename T>
+class NegateNode : public TypedNode<T> {
+ public:
+  NegateNode(int32_t slot, std::unique_ptr<FusedNode> input)
+      : TypedNode<T>(slot), input_(std::move(input)) {}
+
+ protected:
+  void evalTyped(TileState& state, T* result) const override {
+    const auto* input = FusedNode::evalInput<T>(*input_, state);
+    bool ok = true;
+    for (auto i = 0; i < state.numRows; ++i) {
+      if constexpr (std::is_integral_v<T>) {
+        ok &= input[i] != std::numeric_limits<T>::min();
+      }
+      result[i] = -input[i];
+    }
+    if (!ok) {
+      state.failed = true;
+    }
+  }
+
+ private:
+  const std::unique_ptr<FusedNode> input_;
+};
+
+template <typename T, typename TCompare>
+class ComparisonNode : public TypedNode<bool> {
+ public:
+  ComparisonNode(
+      int32_t slot,
+      std::unique_ptr<FusedNode> left,
+      std::unique_ptr<FusedNode> right)
+      : TypedNode<bool>(slot),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+ protected:
+  void evalTyped(TileState& state, bool* result) const override {
+    const auto* left = evalInput<T>(*left_, state);
+    const auto* right = evalInput<T>(*right_, state);
+    TCompare compare;
+    for (auto i = 0; i < state.numRows; ++i) {
+      result[i] = compare(left[i], right[i]);
+    }
+  }
+
+ private:
+  const std::unique_ptr<FusedNode> left_;
+  const std::unique_ptr<FusedNode> right_;
+};
+
+template <typename TCompare>
+struct ComparisonNodes {
+  template <typename T>
+  using Node = ComparisonNode<T, TCompare>;
+};
+
+class ConjunctNode : public TypedNode<bool> {
+ public:
+  ConjunctNode(
+      int32_t slot,
+      bool isAnd,
+      std::vector<std::unique_ptr<FusedNode>> inputs)
+      : TypedNode<bool>(slot), isAnd_(isAnd), inputs_(std::move(inputs)) {}
+
+ protected:
+  // Evaluates all inputs. The inputs can't raise errors, so there is no need
+  // to skip the rows that are decided by the earlier inputs.
+  void evalTyped(TileState& state, bool* result) const override {
+    inputs_[0]->eval(state, result);
+    for (auto i = 1; i < inputs_.size(); ++i) {
+      const auto* input = evalInput<bool>(*inputs_[i], state);
+      if (isAnd_) {
+        for (auto row = 0; row < state.numRows; ++row) {
+          result[row] = result[row] & input[row];
+        }
+      } else {
+        for (auto row = 0; row < state.numRows; ++row) {
+          result[row] = result[row] | input[row];
+        }
+      }
+    }
+  }
+
+ private:
+  const bool isAnd_;
+  const std::vector<std::unique_ptr<FusedNode>> inputs_;
+};
+
+class NotNode : public TypedNode<bool> {
+ public:
+  NotNode(int32_t slot, std::unique_ptr<FusedNode> input)
+      : TypedNode<bool>(slot), input_(std::move(input)) {}
+
+ protected:
+  void evalTyped(TileState& state, bool* result) const override {
+    const auto* input = evalInput<bool>(*input_, state);
+    for (auto i = 0; i < state.numRows; ++i) {
+      result[i] = !input[i];
+    }
+  }
+
+ private:
+  const std::unique_ptr<FusedNode> input_;
+};
+
+template <typename TFrom, typename TTo>
+class CastNode : public TypedNode<TTo> {
+ public:
+  CastNode(int32_t slot, std::unique_ptr<FusedNode> input)
+      : TypedNode<TTo>(slot), input_(std::move(input)) {}
+
+ protected:
+  void evalTyped(TileState& state, TTo* result) const override {
+    const auto* input = FusedNode::evalInput<TFrom>(*input_, state);
+    for (auto i = 0; i < state.numRows; ++i) {
+      result[i] = static_cast<TTo>(input[i]);
+    }
+  }
+
+ private:
+  const std::unique_ptr<FusedNode> input_;
+};
+
+template <typename TTo>
+struct CastNodes {
+  template <typename TFrom>
+  using Node = CastNode<TFrom, TTo>;
+};
+
+template <template <typename> class TNode, typename... TArgs>
+std::unique_ptr<FusedNode> makeNumericNode(TypeKind kind, TArgs&&... args) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return std::make_unique<TNode<int8_t>>(std::forward<TArgs>(args)...);
+    case TypeKind::SMALLINT:
+      return std::make_unique<TNode<int16_t>>(std::forward<TArgs>(args)...);
+    case TypeKind::INTEGER:
+      return std::make_unique<TNode<int32_t>>(std::forward<TArgs>(args)...);
+    case TypeKind::BIGINT:
+      return std::make_unique<TNode<int64_t>>(std::forward<TArgs>(args)...);
+    case TypeKind::REAL:
+      return std::make_unique<TNode<float>>(std::forward<TArgs>(args)...);
+    case TypeKind::DOUBLE:
+      return std::make_unique<TNode<double>>(std::forward<TArgs>(args)...);
+    default:
+      return nullptr;
+  }
+}
+
+template <template <typename> class TNode, typename... TArgs>
+std::unique_ptr<FusedNode> makeScalarNode(TypeKind kind, TArgs&&... args) {
+  if (kind == TypeKind::BOOLEAN) {
+    return std::make_unique<TNode<bool>>(std::forward<TArgs>(args)...);
+  }
+  return makeNumericNode<TNode>(kind, std::forward<TArgs>(args)...);
+}
+
+std::unique_ptr<FusedNode> makeCastNode(
+    TypeKind from,
+    TypeKind to,
+    int32_t slot,
+    std::unique_ptr<FusedNode> input) {
+  switch (to) {
+    case TypeKind::SMALLINT:
+      return makeNumericNode<CastNodes<int16_t>::template Node>(
+          from, slot, std::move(input));
+    case TypeKind::INTEGER:
+      return makeNumericNode<CastNodes<int32_t>::template Node>(
+          from, slot, std::move(input));
+    case TypeKind::BIGINT:
+      return makeNumericNode<CastNodes<int64_t>::template Node>(
+          from, slot, std::move(input));
+    case TypeKind::DOUBLE:
+      return makeNumericNode<CastNodes<double>::template Node>(
+          from, slot, std::move(input));
+    default:
+      return nullptr;
+  }
+}
+
+int32_t integerWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+      return 4;
+    case TypeKind::BIGINT:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+bool isNumeric(TypeKind kind) {
+  return integerWidth(kind) > 0 || kind == TypeKind::REAL ||
+      kind == TypeKind::DOUBLE;
+}
+
+// Returns true for the casts that are a static_cast in Presto semantics and
+// can't fail.
+bool isWideningCast(TypeKind from, TypeKind to) {
+  if (integerWidth(from) > 0) {
+    return integerWidth(to) > integerWidth(from) || to == TypeKind::DOUBLE;
+  }
+  return from == TypeKind::REAL && to == TypeKind::DOUBLE;
+}
+
+// Translates typed expressions into FusedNodes. Returns nullptr for
+// expressions that are not supported.
+class Compiler {
+ public:
+  explicit Compiler(const RowType& inputType) : inputType_(inputType) {}
+
+  std::unique_ptr<FusedNode> compile(const core::TypedExprPtr& expr) {
+    const auto kind = expr->type()->kind();
+    if (auto field =
+            dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+      return compileField(*field);
+    }
+    if (auto constant =
+            dynamic_cast<const core::ConstantTypedExpr*>(expr.get())) {
+      if (constant->hasValueVector() || constant->value().isNull() ||
+          constant->value().kind() != kind) {
+        return nullptr;
+      }
+      return makeScalarNode<ConstantNode>(
+          kind, nextSlot(), constant->value());
+    }
+    if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+      auto input = compile(cast->inputs()[0]);
+      const auto fromKind = cast->inputs()[0]->type()->kind();
+      if (input == nullptr || fromKind == kind) {
+        return input;
+      }
+      if (!isWideningCast(fromKind, kind)) {
+        return nullptr;
+      }
+      return makeCastNode(fromKind, kind, nextSlot(), std::move(input));
+    }
+    if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+      return compileCall(*call);
+    }
+    return nullptr;
+  }
+
+  std::vector<column_index_t> channels() const {
+    return {channels_.begin(), channels_.end()};
+  }
+
+  int32_t numSlots() const {
+    return numSlots_;
+  }
+
+ private:
+  int32_t nextSlot() {
+    return numSlots_++;
+  }
+
+  std::unique_ptr<FusedNode> compileField(
+      const core::FieldAccessTypedExpr& field) {
+    const auto& inputs = field.inputs();
+    if (!inputs.empty() &&
+        !(inputs.size() == 1 &&
+          dynamic_cast<const core::InputTypedExpr*>(inputs[0].get()))) {
+      return nullptr;
+    }
+    const auto channel = inputType_.getChildIdxIfExists(field.name());
+    if (!channel.has_value() ||
+        !inputType_.childAt(channel.value())->kindEquals(field.type())) {
+      return nullptr;
+    }
+    channels_.insert(channel.value());
+    return makeScalarNode<FieldNode>(
+        field.type()->kind(), nextSlot(), channel.value());
+  }
+
+  std::unique_ptr<FusedNode> compileCall(const core::CallTypedExpr& call) {
+    const auto kind = call.type()->kind();
+    const auto& name = call.name();
+    if (call.inputs().empty()) {
+      return nullptr;
+    }
+    const auto inputKind = call.inputs()[0]->type()->kind();
+    std::vector<std::unique_ptr<FusedNode>> inputs;
+    for (const auto& input : call.inputs()) {
+      if (input->type()->kind() != inputKind) {
+        return nullptr;
+      }
+      inputs.push_back(compile(input));
+      if (inputs.back() == nullptr) {
+        return nullptr;
+      }
+    }
+
+    if (name == "and" || name == "or") {
+      if (kind != TypeKind::BOOLEAN || inputKind != TypeKind::BOOLEAN ||
+          inputs.size() < 2) {
+        return nullptr;
+      }
+      return std::make_unique<ConjunctNode>(
+          nextSlot(), name == "and", std::move(inputs));
+    }
+    if (name == "not") {
+      if (kind != TypeKind::BOOLEAN || inputKind != TypeKind::BOOLEAN ||
+          inputs.size() != 1) {
+        return nullptr;
+      }
+      return std::make_unique<NotNode>(nextSlot(), std::move(inputs[0]));
+    }
+    if (name == "negate") {
+      if (kind != inputKind || inputs.size() != 1) {
+        return nullptr;
+      }
+      return makeNumericNode<NegateNode>(
+          kind, nextSlot(), std::move(inputs[0]));
+    }
+    if (inputs.size() != 2) {
+      return nullptr;
+    }
+    if (kind == inputKind && isNumeric(kind)) {
+      if (name == "plus") {
+        return makeArithmeticNode<PlusOp>(kind, inputs);
+      }
+      if (name == "minus") {
+        return makeArithmeticNode<MinusOp>(kind, inputs);
+      }
+      if (name == "multiply") {
+        return makeArithmeticNode<MultiplyOp>(kind, inputs);
+      }
+      if (name == "divide") {
+        return makeArithmeticNode<DivideOp>(kind, inputs);
+      }
+      return nullptr;
+    }
+    if (kind != TypeKind::BOOLEAN ||
+        !(isNumeric(inputKind) || inputKind == TypeKind::BOOLEAN)) {
+      return nullptr;
+    }
+    if (name == "eq") {
+      return makeComparisonNode<std::equal_to<>>(inputKind, inputs);
+    }
+    if (name == "neq") {
+      return makeComparisonNode<std::not_equal_to<>>(inputKind, inputs);
+    }
+    if (name == "lt") {
+      return makeComparisonNode<std::less<>>(inputKind, inputs);
+    }
+    if (name == "lte") {
+      return makeComparisonNode<std::less_equal<>>(inputKind, inputs);
+    }
+    if (name == "gt") {
+      return makeComparisonNode<std::greater<>>(inputKind, inputs);
+    }
+    if (name == "gte") {
+      return makeComparisonNode<std::greater_equal<>>(inputKind, inputs);
+    }
+    return nullptr;
+  }
+
+  template <typename TOp>
+  std::unique_ptr<FusedNode> makeArithmeticNode(
+      TypeKind kind,
+      std::vector<std::unique_ptr<FusedNode>>& inputs) {
+    return makeNumericNode<ArithmeticNodes<TOp>::template Node>(
+        kind, nextSlot(), std::move(inputs[0]), std::move(inputs[1]));
+  }
+
+  template <typename TCompare>
+  std::unique_ptr<FusedNode> makeComparisonNode(
+      TypeKind inputKind,
+      std::vector<std::unique_ptr<FusedNode>>& inputs) {
+    return makeScalarNode<ComparisonNodes<TCompare>::template Node>(
+        inputKind, nextSlot(), std::move(inputs[0]), std::move(inputs[1]));
+  }
+
+  const RowType& inputType_;
+  std::set<column_index_t> channels_;
+  int32_t numSlots_{0};
+};
+
+void appendFingerprint(const core::TypedExprPtr& expr, std::string& out) {
+  out += expr->type()->toString();
+  if (auto field =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    out += ":field:" + field->name();
+  } else if (dynamic_cast<const core::ConstantTypedExpr*>(expr.get())) {
+    out += ":constant:" + expr->toString();
+  } else if (dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    out += ":cast";
+  } else if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    out += ":call:" + call->name();
+  } else {
+    out += ":other:" + expr->toString();
+  }
+  out += "(";
+  for (const auto& input : expr->inputs()) {
+    appendFingerprint(input, out);
+    out += ",";
+  }
+  out += ")";
+}
+
+std::string fingerprint(
+    const core::TypedExprPtr& filter,
+    const std::vector<core::TypedExprPtr>& projections,
+    const RowType& inputType) {
+  std::string key = inputType.toString();
+  key += "|";
+  if (filter != nullptr) {
+    appendFingerprint(filter, key);
+  }
+  for (const auto& projection : projections) {
+    key += "|";
+    appendFingerprint(projection, key);
+  }
+  return key;
+}
+
+// The kernels by fingerprint. Holds nullptr for the expressions that can't be
+// compiled.
+struct KernelCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const FusedKernel>> kernels;
+};
+
+constexpr size_t kMaxCachedKernels = 10'000;
+
+KernelCache& kernelCache() {
+  static KernelCache cache;
+  return cache;
+}
+
+} // namespace
+} // namespace detail
+
+FusedKernel::FusedKernel(
+    std::unique_ptr<detail::FusedNode> filter,
+    std::vector<std::unique_ptr<detail::FusedNode>> projections,
+    std::vector<TypePtr> projectionTypes,
+    std::vector<column_index_t> channels,
+    int32_t numSlots)
+    : filter_(std::move(filter)),
+      projections_(std::move(projections)),
+      projectionTypes_(std::move(projectionTypes)),
+      channels_(std::move(channels)),
+      numSlots_(numSlots) {}
+
+FusedKernel::~FusedKernel() = default;
+
+// static
+std::shared_ptr<const FusedKernel> FusedKernel::compile(
+    const core::TypedExprPtr& filter,
+    const std::vector<core::TypedExprPtr>& projections,
+    const RowTypePtr& inputType) {
+  const auto key = detail::fingerprint(filter, projections, *inputType);
+  auto& cache = detail::kernelCache();
+  {
+    std::lock_guard<std::mutex> l(cache.mutex);
+    auto it = cache.kernels.find(key);
+    if (it != cache.kernels.end()) {
+      return it->second;
+    }
+  }
+
+  detail::Compiler compiler(*inputType);
+  bool supported = true;
+  std::unique_ptr<detail::FusedNode> filterNode;
+  if (filter != nullptr) {
+    if (filter->type()->kind() == TypeKind::BOOLEAN) {
+      filterNode = compiler.compile(filter);
+    }
+    supported = filterNode != nullptr;
+  }
+  std::vector<std::unique_ptr<detail::FusedNode>> projectionNodes;
+  std::vector<TypePtr> projectionTypes;
+  for (const auto& projection : projections) {
+    if (!supported) {
+      break;
+    }
+    projectionNodes.push_back(compiler.compile(projection));
+    projectionTypes.push_back(projection->type());
+    supported = projectionNodes.back() != nullptr;
+  }
+
+  std::shared_ptr<const FusedKernel> kernel;
+  if (supported) {
+    kernel.reset(new FusedKernel(
+        std::move(filterNode),
+        std::move(projectionNodes),
+        std::move(projectionTypes),
+        compiler.channels(),
+        compiler.numSlots()));
+  }
+  std::lock_guard<std::mutex> l(cache.mutex);
+  if (cache.kernels.size() < detail::kMaxCachedKernels) {
+    cache.kernels.emplace(key, kernel);
+  }
+  return kernel;
+}
+
+// static
+size_t FusedKernel::cacheSize() {
+  auto& cache = detail::kernelCache();
+  std::lock_guard<std::mutex> l(cache.mutex);
+  return cache.kernels.size();
+}
+
+// static
+void FusedKernel::clearCache() {
+  auto& cache = detail::kernelCache();
+  std::lock_guard<std::mutex> l(cache.mutex);
+  cache.kernels.clear();
+}
+
+bool FusedKernel::eval(
+    const RowVector& input,
+    memory::MemoryPool* pool,
+    vector_size_t& numPassed,
+    BufferPtr& passedRows,
+    std::vector<VectorPtr>& results) const {
+  const auto size = input.size();
+  std::vector<DecodedVector> columns(input.childrenSize());
+  for (auto channel : channels_) {
+    auto& decoded = columns[channel];
+    decoded.decode(*input.childAt(channel));
+    if (decoded.mayHaveNulls()) {
+      return false;
+    }
+    const auto encoding = decoded.base()->encoding();
+    if (encoding != VectorEncoding::Simple::FLAT &&
+        encoding != VectorEncoding::Simple::CONSTANT) {
+      return false;
+    }
+  }
+
+  std::vector<int64_t> scratch(numSlots_ * detail::kTileSize);
+  std::vector<vector_size_t> tileRows(detail::kTileSize);
+  vector_size_t* rawPassedRows = nullptr;
+  if (filter_ != nullptr) {
+    passedRows = AlignedBuffer::allocate<vector_size_t>(size, pool);
+    rawPassedRows = passedRows->asMutable<vector_size_t>();
+  }
+  results.resize(projections_.size());
+  for (auto i = 0; i < projections_.size(); ++i) {
+    results[i] = BaseVector::create(projectionTypes_[i], size, pool);
+  }
+
+  numPassed = 0;
+  for (vector_size_t begin = 0; begin < size; begin += detail::kTileSize) {
+    const auto numRows = std::min(detail::kTileSize, size - begin);
+    std::iota(tileRows.begin(), tileRows.begin() + numRows, begin);
+    detail::TileState state{
+        tileRows.data(),
+        numRows,
+        &columns,
+        reinterpret_cast<char*>(scratch.data())};
+    if (filter_ != nullptr) {
+      auto* passed = state.slot<bool>(filter_->slot());
+      filter_->eval(state, passed);
+      // The passing rows of the tile are the rows of the tile for the
+      // projections. Compacts without branching on the filter result.
+      auto* tilePassedRows = rawPassedRows + numPassed;
+      vector_size_t numTilePassed = 0;
+      for (auto i = 0; i < numRows; ++i) {
+        tilePassedRows[numTilePassed] = tileRows[i];
+        numTilePassed += passed[i];
+      }
+      state.rows = tilePassedRows;
+      state.numRows = numTilePassed;
+    }
+    if (state.numRows > 0) {
+      for (auto i = 0; i < projections_.size(); ++i) {
+        projections_[i]->evalInto(state, *results[i], numPassed);
+      }
+    }
+    if (state.failed) {
+      return false;
+    }
+    numPassed += state.numRows;
+  }
+
+  if (numPassed == size) {
+    passedRows = nullptr;
+  } else {
+    for (auto& result : results) {
+      result->resize(numPassed);
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/Expressions.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+namespace detail {
+class FusedNode;
+} // namespace detail
+
+/// A filter and a list of projections compiled in process into a single
+/// kernel. The kernel evaluates the expressions over tiles of rows with tight
+/// loops over the raw values, one loop per expression node and tile, instead
+/// of dispatching per Expr node and allocating a vector per intermediate
+/// result. The filter is applied first and the projections are computed only
+/// for the passing rows.
+///
+/// Supported are columns and constants of boolean, integer and floating point
+/// types, the arithmetic functions plus, minus, multiply, divide and negate,
+/// the comparisons eq, neq, lt, lte, gt and gte, and, or, not and widening
+/// casts. These follow the semantics of the Presto functions of the same
+/// names. Inputs may be flat, constant or dictionary encoded.
+///
+/// eval() returns false for inputs it doesn't handle: inputs with nulls and
+/// batches where integer arithmetic overflows or divides by zero. The caller
+/// then evaluates the batch with ExprSet, which produces the nulls or raises
+/// the errors.
+class FusedKernel {
+ public:
+  /// Returns the kernel for 'filter' and 'projections' over rows of
+  /// 'inputType', nullptr if any of the expressions can't be compiled.
+  /// 'filter' may be nullptr. Kernels are cached process wide by the
+  /// fingerprint of the expressions and the input type, so this compiles
+  /// each distinct combination once.
+  static std::shared_ptr<const FusedKernel> compile(
+      const core::TypedExprPtr& filter,
+      const std::vector<core::TypedExprPtr>& projections,
+      const RowTypePtr& inputType);
+
+  /// Returns the number of distinct expression combinations in the cache of
+  /// compile(), including the ones that could not be compiled.
+  static size_t cacheSize();
+
+  static void clearCache();
+
+  ~FusedKernel();
+
+  /// Evaluates the kernel on 'input'. On success sets 'numPassed' to the
+  /// number of rows that passed the filter, 'passedRows' to their indices in
+  /// 'input' or nullptr if all rows passed, and 'results' to one flat vector
+  /// of 'numPassed' rows per projection. Returns false if 'input' has to be
+  /// evaluated by the interpreter.
+  bool eval(
+      const RowVector& input,
+      memory::MemoryPool* pool,
+      vector_size_t& numPassed,
+      BufferPtr& passedRows,
+      std::vector<VectorPtr>& results) const;
+
+  bool hasFilter() const {
+    return filter_ != nullptr;
+  }
+
+  size_t numProjections() const {
+    return projections_.size();
+  }
+
+ private:
+  FusedKernel(
+      std::unique_ptr<detail::FusedNode> filter,
+      std::vector<std::unique_ptr<detail::FusedNode>> projections,
+      std::vector<TypePtr> projectionTypes,
+      std::vector<column_index_t> channels,
+      int32_t numSlots);
+
+  const std::unique_ptr<detail::FusedNode> filter_;
+  const std::vector<std::unique_ptr<detail::FusedNode>> projections_;
+  const std::vector<TypePtr> projectionTypes_;
+  // The input columns referenced by the expressions.
+  const std::vector<column_index_t> channels_;
+  // The number of scratch tiles for intermediate results, one per node.
+  const int32_t numSlots_;
+};
+
+} // namespace facebook::velox::exec
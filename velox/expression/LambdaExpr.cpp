@@ -183,6 +183,10 @@ void LambdaExpr::evalSpecialForm(
     assert(!values.empty());
     values[signature_->size() + i] = context.getField(captureChannels_[i]);
   }
+  auto body = body_;
+  if (!hoisted_.empty() && evalHoisted(rows, context, values)) {
+    body = hoistedBody_;
+  }
   auto capture = std::make_shared<RowVector>(
       context.pool(),
       typeWithCapture_,
@@ -190,7 +194,7 @@ void LambdaExpr::evalSpecialForm(
       rows.end(),
       values,
       0);
-  auto callable = std::make_shared<ExprCallable>(signature_, capture, body_);
+  auto callable = std::make_shared<ExprCallable>(signature_, capture, body);
   std::shared_ptr<FunctionVector> functions;
   if (!result) {
     functions = std::make_shared<FunctionVector>(context.pool(), type_);
@@ -202,10 +206,39 @@ void LambdaExpr::evalSpecialForm(
   functions->addFunction(callable, rows);
 }
 
+bool LambdaExpr::evalHoisted(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    std::vector<VectorPtr>& values) {
+  const auto offset = signature_->size() + capture_.size();
+  bool ok = true;
+  {
+    // The errors are only raised by 'body_' for the elements that reach the
+    // failing subexpression.
+    ScopedVarSetter throwOnError(context.mutableThrowOnError(), false);
+    ScopedVarSetter<ErrorVectorPtr> errorsSetter(context.errorsPtr(), nullptr);
+    for (auto i = 0; i < hoisted_.size() && ok; ++i) {
+      hoisted_[i]->eval(rows, context, values[offset + i]);
+      if (auto* errors = context.errors()) {
+        ok = rows.testSelected([&](auto row) {
+          return row >= errors->size() || errors->isNullAt(row);
+        });
+      }
+    }
+  }
+  if (!ok) {
+    for (auto i = 0; i < hoisted_.size(); ++i) {
+      values[offset + i] = BaseVector::createNullConstant(
+          hoisted_[i]->type(), rows.end(), context.pool());
+    }
+  }
+  return ok;
+}
+
 void LambdaExpr::makeTypeWithCapture(EvalCtx& context) {
   // On first use, compose the type of parameters + capture and set
   // the indices of captures in the context row.
-  if (capture_.empty()) {
+  if (capture_.empty() && hoisted_.empty()) {
     typeWithCapture_ = signature_;
   } else {
     auto& contextType = context.row()->type()->as<TypeKind::ROW>();
@@ -218,6 +251,10 @@ void LambdaExpr::makeTypeWithCapture(EvalCtx& context) {
       parameterNames.push_back(name);
       parameterTypes.push_back(contextType.childAt(channel));
     }
+    for (auto i = 0; i < hoisted_.size(); ++i) {
+      parameterNames.push_back(hoistedNames_[i]);
+      parameterTypes.push_back(hoisted_[i]->type());
+    }
     typeWithCapture_ =
         ROW(std::move(parameterNames), std::move(parameterTypes));
   }
@@ -63,10 +63,33 @@ class LambdaExpr : public SpecialForm {
       EvalCtx& context,
       VectorPtr& result) override;
 
+  /// Sets the expressions of the enclosing scope that 'body' references
+  /// as extra captures named 'names'. 'body' is the original body with the
+  /// subexpressions that depend only on captures replaced by these.
+  void setHoisted(
+      std::vector<std::string>&& names,
+      std::vector<ExprPtr>&& exprs,
+      ExprPtr&& body) {
+    hoistedNames_ = std::move(names);
+    hoisted_ = std::move(exprs);
+    hoistedBody_ = std::move(body);
+  }
+
+  const std::vector<ExprPtr>& hoisted() const {
+    return hoisted_;
+  }
+
  private:
   /// Used to initialize captureChannels_ and typeWithCapture_ on first use.
   void makeTypeWithCapture(EvalCtx& context);
 
+  /// Evaluates 'hoisted_' on 'rows' into 'values' after the captures. Returns
+  /// false without raising errors if any of them fails for a row in 'rows'.
+  bool evalHoisted(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      std::vector<VectorPtr>& values);
+
   RowTypePtr signature_;
 
   /// The inner expression that will be applied to the elements of the input
@@ -76,6 +99,13 @@ class LambdaExpr : public SpecialForm {
   /// List of field references to columns in the input row vector.
   std::vector<std::shared_ptr<FieldReference>> capture_;
 
+  /// Expressions evaluated on the input row vector. Their values follow the
+  /// captures in the row fed to 'hoistedBody_', which is used instead of
+  /// 'body_' when all of them succeed.
+  std::vector<std::string> hoistedNames_;
+  std::vector<ExprPtr> hoisted_;
+  ExprPtr hoistedBody_;
+
   /// These contain column indices of the captured columns with respect to the
   /// input row vector. Stored in the same order as in capture_. Filled on first
   /// use.
@@ -83,9 +113,9 @@ class LambdaExpr : public SpecialForm {
 
   /// A row type representing column types in the order starting with inner
   /// types of the array/map it operates on followed by types of the columns
-  /// that it captures (in the same order as that in capture_). This is used to
-  /// create an input row vector which is fed to the inner expression. Filled on
-  /// first use.
+  /// that it captures (in the same order as that in capture_) and of the
+  /// hoisted expressions. This is used to create an input row vector which is
+  /// fed to the inner expression. Filled on first use.
   RowTypePtr typeWithCapture_;
 };
 } // namespace facebook::velox::exec
@@ -133,6 +133,34 @@ class SimpleFunctionAdapter : public VectorFunction {
     }() && ...);
   }
 
+  template <size_t... Is>
+  constexpr bool static allArgsBatchEligibleImpl(std::index_sequence<Is...>) {
+    return ([&]() {
+      if constexpr (isVariadicType<arg_at<Is>>::value) {
+        return false;
+      } else {
+        return SimpleTypeTrait<arg_at<Is>>::isPrimitiveType &&
+            SimpleTypeTrait<arg_at<Is>>::isFixedWidth &&
+            SimpleTypeTrait<arg_at<Is>>::typeKind != TypeKind::BOOLEAN;
+      }
+    }() && ...);
+  }
+
+  /// Returns true if the UDF provides callBatch() and the adapter calls it on
+  /// runs of consecutive rows when all arguments are flat or constant. This
+  /// requires fixed-width arguments and results other than boolean, default
+  /// null behavior and a function that never returns null.
+  constexpr bool static batchIteration() {
+    return FUNC::udf_has_callBatch && fastPathIteration &&
+        return_type_traits::typeKind != TypeKind::BOOLEAN &&
+        FUNC::is_default_null_behavior && !FUNC::can_produce_null_output &&
+        allArgsBatchEligibleImpl(std::make_index_sequence<FUNC::num_args>());
+  }
+
+  /// The maximum number of rows passed to callBatch(). Constant arguments are
+  /// repeated over this many values.
+  static constexpr vector_size_t kBatchSize = 1'024;
+
   /// When true, a fast path for each possible combination of encodings will be
   /// used for reading arguments when all arguments are flat or constant
   /// primitivies.
@@ -331,7 +359,12 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
 
     std::vector<std::optional<LocalDecodedVector>> decoded;
-    if (allPrimitiveArgsFlatConstant(args)) {
+    if (batchIteration() && allPrimitiveArgsFlatConstant(args)) {
+      if constexpr (batchIteration()) {
+        applyBatch(
+            applyContext, args, std::make_index_sequence<FUNC::num_args>());
+      }
+    } else if (allPrimitiveArgsFlatConstant(args)) {
       if constexpr (
           allArgsFlatConstantFastPathEligible() && specializeForAllEncodings) {
         unpackSpecializeForAllEncodings<0>(applyContext, args);
@@ -355,18 +388,27 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
 
     // Check if the function reuses input strings for the result, and add
-    // references to input string buffers to all result vectors.
+    // references to input string buffers to all result vectors. The argument
+    // may be a string or a complex type with strings nested in it, e.g. an
+    // array of strings whose elements are copied to the result without copying
+    // their bytes.
     auto reuseStringsFromArg = reuseStringsFromArgValue();
     if (reuseStringsFromArg >= 0) {
       VELOX_CHECK_LT(reuseStringsFromArg, args.size());
-      VELOX_CHECK_EQ(args[reuseStringsFromArg]->typeKind(), TypeKind::VARCHAR);
+      const auto argKind = args[reuseStringsFromArg]->typeKind();
+      VELOX_CHECK(
+          argKind == TypeKind::VARCHAR || argKind == TypeKind::VARBINARY ||
+              argKind == TypeKind::ARRAY || argKind == TypeKind::MAP ||
+              argKind == TypeKind::ROW,
+          "Cannot reuse strings from an argument of type {}",
+          args[reuseStringsFromArg]->type()->toString());
       if (decoded.size() == 0 || !decoded.at(reuseStringsFromArg).has_value()) {
         // If we're here, we're guaranteed the argument is either a Flat
         // or Constant vector so no decoding is necessary.
-        tryAcquireStringBuffer(
+        acquireStringBuffersFrom(
             reusableResult->get(), args.at(reuseStringsFromArg).get());
       } else {
-        tryAcquireStringBuffer(
+        acquireStringBuffersFrom(
             reusableResult->get(),
             decoded.at(reuseStringsFromArg).value().get()->base());
       }
@@ -376,6 +418,38 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
   }
 
+  // Acquires the string buffers of all string vectors nested in 'source',
+  // including 'source' itself, for the string vectors in 'vector'.
+  void acquireStringBuffersFrom(BaseVector* vector, const BaseVector* source)
+      const {
+    const auto* leaf = source->wrappedVector();
+    switch (leaf->typeKind()) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        tryAcquireStringBuffer(vector, leaf);
+        break;
+      case TypeKind::ARRAY:
+        acquireStringBuffersFrom(
+            vector, leaf->asUnchecked<ArrayVector>()->elements().get());
+        break;
+      case TypeKind::MAP: {
+        auto* map = leaf->asUnchecked<MapVector>();
+        acquireStringBuffersFrom(vector, map->mapKeys().get());
+        acquireStringBuffersFrom(vector, map->mapValues().get());
+        break;
+      }
+      case TypeKind::ROW:
+        for (const auto& child : leaf->asUnchecked<RowVector>()->children()) {
+          if (child) {
+            acquireStringBuffersFrom(vector, child.get());
+          }
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
   // Acquire string buffer from source if vector is a string flat vector.
   void tryAcquireStringBuffer(BaseVector* vector, const BaseVector* source)
       const {
@@ -430,6 +504,77 @@ class SimpleFunctionAdapter : public VectorFunction {
   }
 
  private:
+  // Reads a flat or constant argument for callBatch().
+  template <typename TArg>
+  class BatchArgReader {
+   public:
+    explicit BatchArgReader(const BaseVector& arg) {
+      if (arg.isConstantEncoding()) {
+        repeated_.resize(
+            kBatchSize, arg.asUnchecked<ConstantVector<TArg>>()->valueAt(0));
+      } else {
+        rawValues_ = arg.asUnchecked<FlatVector<TArg>>()->rawValues();
+      }
+    }
+
+    // Returns the values starting at 'row'.
+    const TArg* FOLLY_NONNULL at(vector_size_t row) const {
+      return rawValues_ ? rawValues_ + row : repeated_.data();
+    }
+
+   private:
+    const TArg* rawValues_{nullptr};
+    std::vector<TArg> repeated_;
+  };
+
+  // Calls 'func(begin, end)' for each run of consecutive rows in 'rows'.
+  template <typename Func>
+  static void forEachRun(const SelectivityVector& rows, Func func) {
+    if (rows.isAllSelected()) {
+      func(rows.begin(), rows.end());
+      return;
+    }
+    const auto* bits = rows.asRange().bits();
+    const auto end = rows.end();
+    auto row = bits::findFirstBit(bits, rows.begin(), end);
+    while (row >= 0 && row < end) {
+      auto runEnd = row + 1;
+      while (runEnd < end) {
+        if (runEnd % 64 == 0 && runEnd + 64 <= end &&
+            bits[runEnd / 64] == ~0ULL) {
+          runEnd += 64;
+        } else if (bits::isBitSet(bits, runEnd)) {
+          ++runEnd;
+        } else {
+          break;
+        }
+      }
+      func(row, runEnd);
+      row = runEnd < end ? bits::findFirstBit(bits, runEnd, end) : -1;
+    }
+  }
+
+  // Evaluates the function with callBatch() over runs of at most kBatchSize
+  // rows. All arguments are flat or constant. Rows not in 'rows' may have
+  // nulls but are not written.
+  template <size_t... Is>
+  void applyBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<Is...>) const {
+    std::tuple<BatchArgReader<exec_arg_at<Is>>...> readers{
+        BatchArgReader<exec_arg_at<Is>>(*args[Is])...};
+    auto* data = applyContext.resultWriter.data_;
+    forEachRun(*applyContext.rows, [&](auto begin, auto end) {
+      for (auto row = begin; row < end; row += kBatchSize) {
+        fn_->callBatch(
+            data + row,
+            std::get<Is>(readers).at(row)...,
+            std::min(end - row, kBatchSize));
+      }
+    });
+  }
+
   // This is called only when we know that all args are flat or constant and are
   // eligible for the optimization and the optimization is enabled.
   template <int32_t POSITION, typename... TReader>
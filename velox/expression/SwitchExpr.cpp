@@ -25,6 +25,27 @@ namespace {
 bool hasElseClause(const std::vector<ExprPtr>& inputs) {
   return inputs.size() % 2 == 1;
 }
+
+const ConstantExpr* FOLLY_NULLABLE asConstant(const ExprPtr& expr) {
+  return dynamic_cast<const ConstantExpr*>(expr.get());
+}
+
+// Returns true if 'expr' is a call of Presto's eq, ignoring the prefix the
+// function is registered with.
+bool isEqualityCall(const Expr& expr) {
+  if (expr.isSpecialForm() || expr.inputs().size() != 2) {
+    return false;
+  }
+  std::string_view name = expr.name();
+  if (auto pos = name.rfind('.'); pos != std::string_view::npos) {
+    name = name.substr(pos + 1);
+  }
+  return name == "eq";
+}
+
+// Integer constants are looked up in an array if their range is no larger than
+// this or a small multiple of the number of cases.
+constexpr uint64_t kMaxDenseRange = 1'024;
 } // namespace
 
 SwitchExpr::SwitchExpr(
@@ -49,6 +70,261 @@ SwitchExpr::SwitchExpr(
 
   // Apply type checking.
   resolveType(inputTypes);
+
+  initConstantResults();
+}
+
+void SwitchExpr::initConstantResults() {
+  for (auto i = 0; i < numCases_; ++i) {
+    if (!asConstant(inputs_[2 * i + 1])) {
+      return;
+    }
+  }
+  if (hasElseClause_ && !asConstant(inputs_.back())) {
+    return;
+  }
+  hasConstantResults_ = true;
+
+  ExprPtr key;
+  std::vector<VectorPtr> whenValues;
+  for (auto i = 0; i < numCases_; ++i) {
+    const auto& condition = inputs_[2 * i];
+    if (!isEqualityCall(*condition)) {
+      return;
+    }
+    const auto& args = condition->inputs();
+    const auto constantIndex = asConstant(args[1]) ? 1 : 0;
+    const auto* constant = asConstant(args[constantIndex]);
+    const auto& other = args[1 - constantIndex];
+    if (!constant || asConstant(other) || (key && key != other)) {
+      return;
+    }
+    key = other;
+    whenValues.push_back(constant->value());
+  }
+  if (!key->isDeterministic()) {
+    return;
+  }
+
+  switch (key->type()->kind()) {
+    case TypeKind::TINYINT:
+      initIntegerLookup<int8_t>(whenValues);
+      break;
+    case TypeKind::SMALLINT:
+      initIntegerLookup<int16_t>(whenValues);
+      break;
+    case TypeKind::INTEGER:
+      initIntegerLookup<int32_t>(whenValues);
+      break;
+    case TypeKind::BIGINT:
+      initIntegerLookup<int64_t>(whenValues);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      initStringLookup(whenValues);
+      break;
+    default:
+      return;
+  }
+  lookupKey_ = key;
+}
+
+template <typename T>
+void SwitchExpr::initIntegerLookup(const std::vector<VectorPtr>& whenValues) {
+  // A value that occurs in more than one condition gets the first case.
+  // Null constants never compare equal.
+  for (auto i = 0; i < whenValues.size(); ++i) {
+    if (!whenValues[i]->isNullAt(0)) {
+      integerLookup_.emplace(
+          whenValues[i]->as<SimpleVector<T>>()->valueAt(0), i);
+    }
+  }
+  if (integerLookup_.empty()) {
+    return;
+  }
+
+  auto [min, max] = std::minmax_element(
+      integerLookup_.begin(),
+      integerLookup_.end(),
+      [](const auto& left, const auto& right) {
+        return left.first < right.first;
+      });
+  const uint64_t range = static_cast<uint64_t>(max->first) -
+      static_cast<uint64_t>(min->first) + 1;
+  if (range > std::max<uint64_t>(kMaxDenseRange, 8 * numCases_)) {
+    return;
+  }
+  denseBase_ = min->first;
+  denseLookup_.resize(range, numCases_);
+  for (const auto& [value, index] : integerLookup_) {
+    denseLookup_[static_cast<uint64_t>(value) - denseBase_] = index;
+  }
+  integerLookup_.clear();
+}
+
+void SwitchExpr::initStringLookup(const std::vector<VectorPtr>& whenValues) {
+  for (auto i = 0; i < whenValues.size(); ++i) {
+    if (!whenValues[i]->isNullAt(0)) {
+      stringLookup_.emplace(
+          whenValues[i]->as<SimpleVector<StringView>>()->valueAt(0), i);
+    }
+  }
+}
+
+void SwitchExpr::evalConstantResults(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (!rows.hasSelections()) {
+    return;
+  }
+  if (!constantResults_) {
+    constantResults_ =
+        BaseVector::create(type(), numCases_ + 1, context.pool());
+    for (auto i = 0; i < numCases_; ++i) {
+      constantResults_->copy(
+          asConstant(inputs_[2 * i + 1])->value().get(), i, 0, 1);
+    }
+    if (hasElseClause_) {
+      constantResults_->copy(
+          asConstant(inputs_.back())->value().get(), numCases_, 0, 1);
+    } else {
+      constantResults_->setNull(numCases_, true);
+    }
+  }
+
+  LocalSelectivityVector remainingRows(context, rows);
+  auto cases = allocateIndices(rows.end(), context.pool());
+  auto* rawCases = cases->asMutable<vector_size_t>();
+  if (lookupKey_) {
+    lookupCases(*remainingRows, context, rawCases);
+  } else {
+    evalCases(*remainingRows, context, rawCases);
+  }
+
+  if (remainingRows->hasSelections()) {
+    context.ensureWritable(*remainingRows, type(), result);
+    result->copy(constantResults_.get(), *remainingRows, rawCases);
+  }
+}
+
+void SwitchExpr::evalCases(
+    SelectivityVector& rows,
+    EvalCtx& context,
+    vector_size_t* cases) {
+  LocalSelectivityVector remainingRows(context, rows);
+  LocalSelectivityVector thenRows(context);
+  VectorPtr condition;
+  const uint64_t* values;
+
+  for (auto i = 0; i < numCases_; i++) {
+    if (!remainingRows->hasSelections()) {
+      break;
+    }
+    inputs_[2 * i]->eval(*remainingRows, context, condition);
+
+    if (context.errors()) {
+      context.deselectErrors(*remainingRows);
+    }
+
+    const auto booleanMix = getFlatBool(
+        condition.get(),
+        *remainingRows,
+        context,
+        &tempValues_,
+        nullptr,
+        true,
+        &values,
+        nullptr);
+    context.releaseVector(condition);
+    switch (booleanMix) {
+      case BooleanMix::kAllTrue:
+        remainingRows->applyToSelected([&](auto row) { cases[row] = i; });
+        remainingRows->clearAll();
+        continue;
+      case BooleanMix::kAllNull:
+      case BooleanMix::kAllFalse:
+        continue;
+      default: {
+        bits::andBits(
+            thenRows.get(rows.end(), false)->asMutableRange().bits(),
+            remainingRows->asRange().bits(),
+            values,
+            0,
+            rows.end());
+        thenRows->updateBounds();
+        thenRows->applyToSelected([&](auto row) { cases[row] = i; });
+        remainingRows->deselect(*thenRows);
+      }
+    }
+  }
+
+  remainingRows->applyToSelected([&](auto row) { cases[row] = numCases_; });
+  if (context.errors()) {
+    context.deselectErrors(rows);
+  }
+}
+
+void SwitchExpr::lookupCases(
+    SelectivityVector& rows,
+    EvalCtx& context,
+    vector_size_t* cases) {
+  VectorPtr keys;
+  lookupKey_->eval(rows, context, keys);
+  if (context.errors()) {
+    context.deselectErrors(rows);
+  }
+
+  LocalDecodedVector decodedKeys(context, *keys, rows);
+  switch (lookupKey_->type()->kind()) {
+    case TypeKind::TINYINT:
+      lookupIntegerCases<int8_t>(*decodedKeys, rows, cases);
+      break;
+    case TypeKind::SMALLINT:
+      lookupIntegerCases<int16_t>(*decodedKeys, rows, cases);
+      break;
+    case TypeKind::INTEGER:
+      lookupIntegerCases<int32_t>(*decodedKeys, rows, cases);
+      break;
+    case TypeKind::BIGINT:
+      lookupIntegerCases<int64_t>(*decodedKeys, rows, cases);
+      break;
+    default:
+      rows.applyToSelected([&](auto row) {
+        if (decodedKeys->isNullAt(row)) {
+          cases[row] = numCases_;
+          return;
+        }
+        auto it = stringLookup_.find(decodedKeys->valueAt<StringView>(row));
+        cases[row] = it == stringLookup_.end() ? numCases_ : it->second;
+      });
+  }
+  context.releaseVector(keys);
+}
+
+template <typename T>
+void SwitchExpr::lookupIntegerCases(
+    const DecodedVector& keys,
+    const SelectivityVector& rows,
+    vector_size_t* cases) const {
+  if (!denseLookup_.empty()) {
+    rows.applyToSelected([&](auto row) {
+      const auto offset = static_cast<uint64_t>(keys.valueAt<T>(row)) -
+          static_cast<uint64_t>(denseBase_);
+      cases[row] = offset < denseLookup_.size() && !keys.isNullAt(row)
+          ? denseLookup_[offset]
+          : numCases_;
+    });
+    return;
+  }
+  rows.applyToSelected([&](auto row) {
+    if (keys.isNullAt(row)) {
+      cases[row] = numCases_;
+      return;
+    }
+    auto it = integerLookup_.find(keys.valueAt<T>(row));
+    cases[row] = it == integerLookup_.end() ? numCases_ : it->second;
+  });
 }
 
 void SwitchExpr::evalSpecialForm(
@@ -81,6 +357,10 @@ void SwitchExpr::evalSpecialForm(
       }
     }
   }
+  if (hasConstantResults_) {
+    evalConstantResults(*remainingRows, context, result);
+    remainingRows->clearAll();
+  }
   for (auto i = 0; i < numCases_; i++) {
     if (!remainingRows.get()->hasSelections()) {
       break;
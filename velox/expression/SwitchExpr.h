@@ -34,6 +34,13 @@ namespace facebook::velox::exec {
 ///
 /// IF expression can be represented as a CASE expression with a single
 /// condition.
+///
+/// If all results are constant, the conditions only choose a result for each
+/// row and the results are copied in one pass at the end. If, in addition,
+/// every condition compares the same expression with a constant of an integer
+/// or string type, e.g. CASE x WHEN 1 THEN 'a' WHEN 2 THEN 'b' END, the
+/// expression is evaluated once and its values are looked up in a table from
+/// constant to case. Integer constants within a small range use an array.
 class SwitchExpr : public SpecialForm {
  public:
   /// Inputs are concatenated conditions and results with an optional "else" at
@@ -57,10 +64,64 @@ class SwitchExpr : public SpecialForm {
  private:
   static TypePtr resolveType(const std::vector<TypePtr>& argTypes);
 
+  // Sets 'hasConstantResults_' and the lookup table if the conditions
+  // qualify.
+  void initConstantResults();
+
+  template <typename T>
+  void initIntegerLookup(const std::vector<VectorPtr>& whenValues);
+
+  void initStringLookup(const std::vector<VectorPtr>& whenValues);
+
+  // Evaluates the expression for 'rows' when 'hasConstantResults_' is set.
+  void evalConstantResults(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  // Sets the case that applies to each of 'rows' in 'cases' by evaluating the
+  // conditions. The 'else' case is 'numCases_'. Deselects rows with errors.
+  void evalCases(
+      SelectivityVector& rows,
+      EvalCtx& context,
+      vector_size_t* cases);
+
+  // Same as evalCases() using 'lookupKey_' and the lookup table.
+  void lookupCases(
+      SelectivityVector& rows,
+      EvalCtx& context,
+      vector_size_t* cases);
+
+  template <typename T>
+  void lookupIntegerCases(
+      const DecodedVector& keys,
+      const SelectivityVector& rows,
+      vector_size_t* cases) const;
+
   const size_t numCases_;
   const bool hasElseClause_;
   BufferPtr tempValues_;
 
+  // True if all 'then' and 'else' clauses are constant.
+  bool hasConstantResults_{false};
+
+  // The results of the cases followed by the 'else' result or null. Made on
+  // first use.
+  VectorPtr constantResults_;
+
+  // Set if all conditions compare this with a constant. The cases are then
+  // found in 'denseLookup_', 'integerLookup_' or 'stringLookup_'.
+  ExprPtr lookupKey_;
+
+  // The case for each integer from 'denseBase_' on.
+  std::vector<vector_size_t> denseLookup_;
+  int64_t denseBase_{0};
+
+  folly::F14FastMap<int64_t, vector_size_t> integerLookup_;
+
+  // The keys point to the constants of the conditions.
+  folly::F14FastMap<StringView, vector_size_t> stringLookup_;
+
   friend class SwitchCallToSpecialForm;
 };
 
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/ValueMemo.h"
+#include "velox/expression/VectorFunction.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// The memory of an entry besides the string data: the key in 'keys_' and in
+// the hash table and the position in the hash table.
+constexpr uint64_t kEntryOverhead =
+    2 * sizeof(StringView) + sizeof(vector_size_t);
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+uint64_t nonInlineSize(StringView value) {
+  return value.isInline() ? 0 : value.size();
+}
+} // namespace
+
+bool ValueMemo::apply(
+    const VectorFunction& function,
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args,
+    const TypePtr& outputType,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (!enabled_) {
+    return false;
+  }
+
+  LocalDecodedVector decodedKeys(context, *args[keyIndex_], rows);
+  LocalSelectivityVector hitHolder(context);
+  auto* hitRows = hitHolder.get(rows.end(), false);
+  // The first row of each distinct value that is not remembered.
+  LocalSelectivityVector missHolder(context);
+  auto* missRows = missHolder.get(rows.end(), false);
+  // The other rows with a value that is not remembered.
+  LocalSelectivityVector duplicateHolder(context);
+  auto* duplicateRows = duplicateHolder.get(rows.end(), false);
+
+  // For hits, the position in 'values_'. For misses, the row in the results
+  // of the function.
+  auto sourceRows = allocateIndices(rows.end(), context.pool());
+  auto* rawSourceRows = sourceRows->asMutable<vector_size_t>();
+  folly::F14FastMap<StringView, vector_size_t> firstMisses;
+  std::vector<vector_size_t> missRowList;
+
+  const auto noNulls = rows.testSelected([&](vector_size_t row) {
+    if (decodedKeys->isNullAt(row)) {
+      return false;
+    }
+    const auto key = decodedKeys->valueAt<StringView>(row);
+    auto it = indices_.find(key);
+    if (it != indices_.end()) {
+      hitRows->setValid(row, true);
+      rawSourceRows[row] = it->second;
+      return true;
+    }
+    auto [first, inserted] = firstMisses.emplace(key, row);
+    if (inserted) {
+      missRows->setValid(row, true);
+      missRowList.push_back(row);
+    } else {
+      duplicateRows->setValid(row, true);
+    }
+    rawSourceRows[row] = first->second;
+    return true;
+  });
+  if (!noNulls) {
+    return false;
+  }
+  hitRows->updateBounds();
+  missRows->updateBounds();
+  duplicateRows->updateBounds();
+
+  VectorPtr missResults;
+  if (missRows->hasSelections()) {
+    function.apply(*missRows, args, outputType, context, missResults);
+
+    if (auto* errors = context.errors()) {
+      const auto hasError = [&](vector_size_t row) {
+        return row < errors->size() && !errors->isNullAt(row);
+      };
+      if (!missRows->testSelected([&](auto row) { return !hasError(row); })) {
+        // The rows that repeat a value that failed must fail the same way, so
+        // these are evaluated by themselves. Values that failed are not
+        // remembered.
+        if (duplicateRows->hasSelections()) {
+          function.apply(
+              *duplicateRows, args, outputType, context, missResults);
+          duplicateRows->applyToSelected(
+              [&](auto row) { rawSourceRows[row] = row; });
+        }
+        missRowList.erase(
+            std::remove_if(missRowList.begin(), missRowList.end(), hasError),
+            missRowList.end());
+        context.deselectErrors(*missRows);
+        context.deselectErrors(*duplicateRows);
+      }
+    }
+
+    if (missResults) {
+      addEntries(missRowList, *decodedKeys, *missResults, context.pool());
+    }
+  }
+
+  if (hitRows->hasSelections() || missResults) {
+    context.ensureWritable(rows, outputType, result);
+    if (hitRows->hasSelections()) {
+      result->copy(values_.get(), *hitRows, rawSourceRows);
+    }
+    if (missResults) {
+      result->copy(missResults.get(), *missRows, rawSourceRows);
+      result->copy(missResults.get(), *duplicateRows, rawSourceRows);
+    }
+  }
+
+  updateHitRate(rows.countSelected(), hitRows->countSelected());
+  return true;
+}
+
+void ValueMemo::addEntries(
+    const std::vector<vector_size_t>& rows,
+    const DecodedVector& keys,
+    const BaseVector& results,
+    memory::MemoryPool* pool) {
+  if (rows.empty() || bytes_ >= maxBytes_) {
+    return;
+  }
+  if (!keys_) {
+    keys_ = BaseVector::create<FlatVector<StringView>>(VARCHAR(), 0, pool);
+    values_ = BaseVector::create(results.type(), 0, pool);
+  }
+
+  const bool stringResults = isStringKind(values_->typeKind());
+  const uint64_t fixedValueSize =
+      stringResults ? sizeof(StringView) : values_->type()->cppSizeInBytes();
+  DecodedVector decodedResults(results);
+
+  // Adds entries while under the limit, so the memo may exceed it by the size
+  // of one entry.
+  int32_t numNew = 0;
+  for (auto row : rows) {
+    if (bytes_ >= maxBytes_) {
+      break;
+    }
+    bytes_ += kEntryOverhead + fixedValueSize +
+        nonInlineSize(keys.valueAt<StringView>(row));
+    if (stringResults && !decodedResults.isNullAt(row)) {
+      bytes_ += nonInlineSize(decodedResults.valueAt<StringView>(row));
+    }
+    ++numNew;
+  }
+
+  const auto offset = keys_->size();
+  keys_->resize(offset + numNew);
+  values_->resize(offset + numNew);
+  auto* stringValues =
+      stringResults ? values_->asFlatVector<StringView>() : nullptr;
+  for (auto i = 0; i < numNew; ++i) {
+    const auto row = rows[i];
+    const auto index = offset + i;
+    keys_->set(index, keys.valueAt<StringView>(row));
+    if (!stringResults) {
+      values_->copy(&results, index, row, 1);
+    } else if (decodedResults.isNullAt(row)) {
+      values_->setNull(index, true);
+    } else {
+      stringValues->set(index, decodedResults.valueAt<StringView>(row));
+    }
+    indices_.emplace(keys_->valueAt(index), index);
+  }
+}
+
+void ValueMemo::updateHitRate(uint64_t numLookups, uint64_t numHits) {
+  numLookups_ += numLookups;
+  numHits_ += numHits;
+  windowLookups_ += numLookups;
+  windowHits_ += numHits;
+  if (windowLookups_ < kWindowRows) {
+    return;
+  }
+  if (windowHits_ < windowLookups_ * kMinHitRate) {
+    enabled_ = false;
+    clear();
+  }
+  windowLookups_ = 0;
+  windowHits_ = 0;
+}
+
+void ValueMemo::clear() {
+  keys_.reset();
+  values_.reset();
+  indices_ = {};
+  bytes_ = 0;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/expression/EvalCtx.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+class VectorFunction;
+
+/// Remembers the results of a deterministic function call by the value of its
+/// only non-constant argument, a string. Unlike the memo of Expr over a
+/// dictionary, which lasts while consecutive batches share the same base
+/// vector, the remembered results are kept across batches and splits for the
+/// lifetime of the ExprSet. This pays off for expensive functions, e.g.
+/// regular expressions or JSON and URL parsing, applied to a column with
+/// few distinct values.
+///
+/// The remembered argument values and results are copied into vectors of the
+/// pool of the evaluation and their size is limited to 'maxBytes'. Once the
+/// limit is reached, no more values are added. The hit rate is checked every
+/// kWindowRows rows. If less than kMinHitRate of the rows hit, the memo is
+/// freed and the function is evaluated directly from then on.
+class ValueMemo {
+ public:
+  static constexpr uint64_t kWindowRows = 64 << 10;
+  static constexpr double kMinHitRate = 0.5;
+
+  /// @param keyIndex The index of the non-constant argument.
+  /// @param maxBytes The limit on the memory used by the memo.
+  ValueMemo(column_index_t keyIndex, uint64_t maxBytes)
+      : keyIndex_(keyIndex), maxBytes_(maxBytes) {}
+
+  /// Returns false if the memo was disabled for a low hit rate.
+  bool enabled() const {
+    return enabled_;
+  }
+
+  /// Evaluates 'function' on 'rows' of 'args' into 'result', calling the
+  /// function only for the argument values that are not remembered, once per
+  /// distinct value. Returns false without evaluating anything if the memo is
+  /// disabled or the key argument is null in any of 'rows'.
+  bool apply(
+      const VectorFunction& function,
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  /// Frees the remembered values.
+  void clear();
+
+  size_t numEntries() const {
+    return indices_.size();
+  }
+
+  uint64_t bytes() const {
+    return bytes_;
+  }
+
+  /// The number of rows looked up and the number of them that were found.
+  uint64_t numLookups() const {
+    return numLookups_;
+  }
+
+  uint64_t numHits() const {
+    return numHits_;
+  }
+
+ private:
+  // Adds the arguments and results at 'rows' to the memo until 'maxBytes_'
+  // is reached.
+  void addEntries(
+      const std::vector<vector_size_t>& rows,
+      const DecodedVector& keys,
+      const BaseVector& results,
+      memory::MemoryPool* pool);
+
+  // Disables the memo if the hit rate over the last window is too low.
+  void updateHitRate(uint64_t numLookups, uint64_t numHits);
+
+  const column_index_t keyIndex_;
+  const uint64_t maxBytes_;
+
+  bool enabled_{true};
+
+  // The remembered arguments and, at the same positions, their results.
+  // String results are deep copied so as not to retain the buffers of the
+  // input batches.
+  FlatVectorPtr<StringView> keys_;
+  VectorPtr values_;
+
+  // Maps an argument value in 'keys_' to its position.
+  folly::F14FastMap<StringView, vector_size_t> indices_;
+
+  // Estimated memory of 'keys_', 'values_' and 'indices_'.
+  uint64_t bytes_{0};
+
+  uint64_t windowLookups_{0};
+  uint64_t windowHits_{0};
+  uint64_t numLookups_{0};
+  uint64_t numHits_{0};
+};
+
+} // namespace facebook::velox::exec
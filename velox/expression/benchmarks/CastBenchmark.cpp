@@ -28,20 +28,43 @@ class CastBenchmark : public functions::test::FunctionBenchmarkBase {
   CastBenchmark() : FunctionBenchmarkBase() {}
 
   size_t doRun(const TypePtr& inputType, const TypePtr& outputType) {
+    folly::BenchmarkSuspender suspender;
+    facebook::velox::VectorFuzzer fuzzer({}, pool());
+    // With encodings, evalMemo can get invoked which does a copy and adds a lot
+    // of overhead.
+    auto input = fuzzer.fuzzFlatNotNull(inputType);
+    suspender.dismiss();
+
+    return doRun(input, outputType);
+  }
+
+  // Casts 10K strings made by 'makeString' from their row number to
+  // 'outputType'.
+  size_t doRunStrings(
+      const TypePtr& outputType,
+      std::function<std::string(vector_size_t)> makeString) {
+    folly::BenchmarkSuspender suspender;
+    std::vector<std::string> strings;
+    for (auto i = 0; i < 10'000; ++i) {
+      strings.push_back(makeString(i));
+    }
+    auto input = vectorMaker_.flatVector(strings);
+    suspender.dismiss();
+
+    return doRun(input, outputType);
+  }
+
+  size_t doRun(const VectorPtr& input, const TypePtr& outputType) {
     folly::BenchmarkSuspender suspender;
     std::string colName = "c0";
     std::vector<facebook::velox::core::TypedExprPtr> inputs{
         std::make_shared<facebook::velox::core::FieldAccessTypedExpr>(
-            inputType, colName)};
+            input->type(), colName)};
     std::vector<facebook::velox::core::TypedExprPtr> expr{
         std::make_shared<facebook::velox::core::CastTypedExpr>(
             outputType, inputs, false)};
     exec::ExprSet exprSet(expr, &execCtx_);
 
-    facebook::velox::VectorFuzzer fuzzer({}, pool());
-    // With encodings, evalMemo can get invoked which does a copy and adds a lot
-    // of overhead.
-    auto input = fuzzer.fuzzFlatNotNull(inputType);
     auto rowVector = vectorMaker_.rowVector({colName}, {input});
     suspender.dismiss();
 
@@ -69,6 +92,55 @@ BENCHMARK_MULTI(scalar) {
   return benchmark.doRun(INTEGER(), BIGINT());
 }
 
+BENCHMARK_MULTI(stringToBigint) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(BIGINT(), [](auto row) {
+    return std::to_string((row * 1'000'003L) % 10'000'000'000L - 5'000'000);
+  });
+}
+
+BENCHMARK_MULTI(stringToDouble) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(DOUBLE(), [](auto row) {
+    return fmt::format("{}.{:02}", row * 37 % 100'000, row % 100);
+  });
+}
+
+BENCHMARK_MULTI(stringToDate) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(DATE(), [](auto row) {
+    return fmt::format(
+        "{}-{:02}-{:02}", 1970 + row % 60, 1 + row % 12, 1 + row % 28);
+  });
+}
+
+BENCHMARK_MULTI(stringToTimestamp) {
+  folly::BenchmarkSuspender suspender;
+  CastBenchmark benchmark;
+  suspender.dismiss();
+
+  return benchmark.doRunStrings(TIMESTAMP(), [](auto row) {
+    return fmt::format(
+        "{}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
+        1970 + row % 60,
+        1 + row % 12,
+        1 + row % 28,
+        row % 24,
+        row % 60,
+        row * 7 % 60,
+        row % 1000);
+  });
+}
+
 BENCHMARK_MULTI(renameSmallStruct) {
   folly::BenchmarkSuspender suspender;
   CastBenchmark benchmark;
@@ -1025,6 +1025,63 @@ TEST_F(CastExprTest, castInTry) {
       ARRAY(ARRAY(VARCHAR())), ARRAY(ARRAY(BIGINT())), nested, nestedExpected);
 }
 
+TEST_F(CastExprTest, errorsWithoutThrowing) {
+  auto data = makeRowVector({makeFlatVector<std::string>(
+      {"1", "2a", " 3", "", "-9223372036854775808", "1e3", "true", "0.5"})});
+  const auto rowType = asRowType(data->type());
+
+  for (const auto& type : {"bigint", "tinyint", "double", "boolean"}) {
+    SCOPED_TRACE(type);
+    const auto expression = fmt::format("cast(c0 as {})", type);
+    auto exprSet = compileExpression(expression, rowType);
+    exec::EvalCtx context(&execCtx_, exprSet.get(), data.get());
+    *context.mutableThrowOnError() = false;
+    SelectivityVector rows(data->size());
+    std::vector<VectorPtr> results(1);
+    exprSet->eval(rows, context, results);
+
+    // The error recorded for each row has the same message as the error
+    // thrown when casting that row alone. The rows that succeed have the same
+    // values.
+    auto* errors = context.errors();
+    for (auto row = 0; row < data->size(); ++row) {
+      auto rowData = makeRowVector({data->childAt(0)->slice(row, 1)});
+      if (errors && row < errors->size() && !errors->isNullAt(row)) {
+        std::string message;
+        try {
+          std::rethrow_exception(*std::static_pointer_cast<std::exception_ptr>(
+              errors->valueAt(row)));
+        } catch (const VeloxUserError& e) {
+          message = e.message();
+        }
+        VELOX_ASSERT_THROW(evaluate(expression, rowData), message);
+      } else {
+        assertEqualVectors(
+            evaluate(expression, rowData), results[0]->slice(row, 1));
+      }
+    }
+  }
+
+  // try_cast produces nulls for the rows that fail.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"1", "2a", "", "-9223372036854775808", "1e3", std::nullopt},
+      {1,
+       std::nullopt,
+       std::nullopt,
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt,
+       std::nullopt},
+      false,
+      true);
+  testCast<std::string, double>(
+      "double",
+      {"1e3", "x", "0.5", std::nullopt},
+      {1000.0, std::nullopt, 0.5, std::nullopt},
+      false,
+      true);
+}
+
 TEST_F(CastExprTest, primitiveNullConstant) {
   // Evaluate cast(NULL::double as bigint).
   auto cast =
@@ -15,6 +15,7 @@
  */
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/types/JsonType.h"
@@ -154,6 +155,49 @@ TEST_F(ExprCompilerTest, orFlattening) {
   ASSERT_EQ("and(a, or(b, c, d))", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, orOfEqualitiesToIn) {
+  auto rowType = ROW({"a", "b"}, {BIGINT(), VARCHAR()});
+
+  auto field = makeField(rowType);
+  auto aEquals = [&](int64_t value) {
+    return call("eq", {field("a"), bigint(value)});
+  };
+
+  // a = 1 OR b = 'x' OR 2 = a OR a = 3 => a IN (1, 2, 3) OR b = 'x'
+  auto expression = orCall(
+      aEquals(1),
+      orCall(
+          call("eq", {field("b"), varchar("x")}),
+          orCall(call("eq", {bigint(2), field("a")}), aEquals(3))));
+  auto exprSet = compile(expression);
+  const auto& disjunction = exprSet->expr(0);
+  ASSERT_EQ("or", disjunction->name());
+  ASSERT_EQ(2, disjunction->inputs().size());
+  const auto& in = disjunction->inputs()[0];
+  ASSERT_EQ("in", in->name());
+  EXPECT_EQ("a", in->inputs()[0]->toString());
+  auto inList =
+      std::dynamic_pointer_cast<ConstantExpr>(in->inputs()[1])->value();
+  auto* array = inList->wrappedVector()->as<ArrayVector>();
+  EXPECT_EQ(3, array->sizeAt(inList->wrappedIndex(0)));
+  EXPECT_EQ("eq", disjunction->inputs()[1]->name());
+
+  // Too few equalities.
+  expression = orCall(aEquals(1), aEquals(2));
+  ASSERT_EQ(
+      "or(eq(a, 1:BIGINT), eq(a, 2:BIGINT))", compile(expression)->toString());
+
+  // Equalities of different columns.
+  expression = orCall(
+      aEquals(1),
+      orCall(
+          aEquals(2),
+          call("eq", {call("plus", {field("a"), bigint(1)}), bigint(3)})));
+  ASSERT_EQ(
+      "or(eq(a, 1:BIGINT), eq(a, 2:BIGINT), eq(plus(a, 1:BIGINT), 3:BIGINT))",
+      compile(expression)->toString());
+}
+
 TEST_F(ExprCompilerTest, concatFlattening) {
   auto rowType =
       ROW({"a", "b", "c", "d"}, {VARCHAR(), VARCHAR(), VARCHAR(), VARCHAR()});
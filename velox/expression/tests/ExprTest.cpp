@@ -26,6 +26,7 @@
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
+#include "velox/expression/LambdaExpr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/parse/Expressions.h"
@@ -384,6 +385,58 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderAroundNonDeterministic) {
+  constexpr int32_t kTestSize = 20'000;
+
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(kTestSize, [](auto row) { return row; })});
+  auto exprSet = compileExpression(
+      "c0 % 2000 < 1999 and c0 % 103 < 30 and rand() < 2.0 "
+      "and c0 % 3000 < 2999 and c0 % 409 < 30",
+      asRowType(data->type()));
+  auto result = evaluate(exprSet.get(), data);
+
+  auto expectedResult = makeFlatVector<bool>(kTestSize, [](auto row) {
+    return (row % 2000) < 1999 && (row % 103) < 30 && (row % 3000) < 2999 &&
+        (row % 409) < 30;
+  });
+  assertEqualVectors(expectedResult, result);
+
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+  // The more selective input moves first on each side of rand(), which stays
+  // in place.
+  EXPECT_EQ(condition->inputOrder(), (std::vector<int32_t>{1, 0, 2, 4, 3}));
+}
+
+TEST_F(ExprTest, orOfEqualities) {
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 10; }, nullEvery(5)),
+      makeFlatVector<std::string>(
+          size, [](auto row) { return std::string(1, 'a' + row % 4); }),
+  });
+
+  // Evaluated as c0 IN (1, 5, 7).
+  auto result = evaluate("c0 = 1 or c0 = 5 or 7 = c0", data);
+  auto expected = makeFlatVector<bool>(
+      size,
+      [](auto row) { return row % 10 == 1 || row % 10 == 7; },
+      nullEvery(5));
+  assertEqualVectors(expected, result);
+
+  result = evaluate("c1 = 'a' or c0 = 3 or c1 = 'c' or c1 = 'x'", data);
+  expected = makeFlatVector<bool>(
+      size,
+      [](auto row) { return row % 4 == 0 || row % 4 == 2 || row % 10 == 3; },
+      [](auto row) {
+        return row % 5 == 0 && row % 4 != 0 && row % 4 != 2;
+      });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -1595,6 +1648,75 @@ TEST_F(ExprTest, switchExpr) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ExprTest, switchExprLookup) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(
+          size, [](auto row) { return row % 70 - 10; }, nullEvery(7)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 100'003; }),
+      makeFlatVector<std::string>(
+          size,
+          [](auto row) { return fmt::format("code-{}", row % 13); },
+          nullEvery(11)),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 3; }),
+  });
+
+  // 50 cases on a dense range of integers.
+  std::string sql = "case c0";
+  for (auto i = 0; i < 50; ++i) {
+    sql += fmt::format(" when {} then 'label {}'", i, i);
+  }
+  auto result = evaluate(sql + " else 'other' end", data);
+  auto expected = makeFlatVector<std::string>(size, [](auto row) {
+    const auto value = row % 70 - 10;
+    return row % 7 == 0 || value < 0 || value >= 50
+        ? std::string("other")
+        : fmt::format("label {}", value);
+  });
+  assertEqualVectors(expected, result);
+
+  // The same over a dictionary.
+  auto indices = makeIndicesInReverse(size);
+  result = evaluate(
+      sql + " else 'other' end",
+      makeRowVector({wrapInDictionary(indices, size, data->childAt(0))}));
+  assertEqualVectors(wrapInDictionary(indices, size, expected), result);
+
+  // Sparse integers, no else clause.
+  result = evaluate(
+      "case c1 when 0 then 1 when 300009 then 2 when 99902997 then 3 "
+      "when 99902997 then 4 end",
+      data);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>({1, std::nullopt, std::nullopt, 2}),
+      result->slice(0, 4));
+  EXPECT_EQ(result->as<SimpleVector<int64_t>>()->valueAt(999), 3);
+
+  // Strings with the constant on the left.
+  result = evaluate(
+      "case when 'code-1' = c2 then 1 when c2 = 'code-12' then 2 "
+      "when c2 = 'code-1' then 3 else 0 end",
+      data);
+  expected = makeFlatVector<int64_t>(size, [](auto row) {
+    if (row % 11 == 0) {
+      return 0;
+    }
+    return row % 13 == 1 ? 1 : (row % 13 == 12 ? 2 : 0);
+  });
+  assertEqualVectors(expected, result);
+
+  // Errors in the key are raised for the rows that fail.
+  VELOX_ASSERT_THROW(
+      evaluate("case 6 / c3 when 3 then 'a' else 'b' end", data),
+      "division by zero");
+  result = evaluate("try(case 6 / c3 when 3 then 'a' else 'b' end)", data);
+  expected = makeFlatVector<std::string>(
+      size,
+      [](auto row) { return row % 3 == 2 ? "a" : "b"; },
+      [](auto row) { return row % 3 == 0; });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(ExprTest, swithExprSanityChecks) {
   auto vector = makeRowVector({makeFlatVector<int32_t>({1, 2, 3})});
 
@@ -2715,6 +2837,93 @@ TEST_F(ExprTest, lambdaWithRowField) {
   assertEqualVectors(array, evalResult);
 }
 
+TEST_F(ExprTest, lambdaHoisting) {
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeArrayVector<int64_t>(
+          size,
+          [](auto row) { return row % 5; },
+          [](auto row) { return row % 37; },
+          nullEvery(11)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 13; }),
+  });
+
+  const auto setHoisting = [&](bool enabled) {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprLambdaHoistingEnabled,
+         enabled ? "true" : "false"},
+    });
+  };
+  const auto getLambda = [](const exec::Expr& call) {
+    auto lambda = std::dynamic_pointer_cast<exec::LambdaExpr>(call.inputs()[1]);
+    VELOX_CHECK_NOT_NULL(lambda);
+    return lambda;
+  };
+  const auto assertHoisting = [&](const std::vector<std::string>& texts,
+                                  const RowVectorPtr& input) {
+    auto expected = evaluateMultiple(texts, input);
+    setHoisting(true);
+    auto results = evaluateMultiple(texts, input);
+    setHoisting(false);
+    for (auto i = 0; i < texts.size(); ++i) {
+      assertEqualVectors(expected[i], results[i]);
+    }
+  };
+
+  setHoisting(true);
+  auto exprSet = compileMultiple(
+      {"c1 * 2 > 10", "filter(c0, x -> x > c1 * 2 and x < c1 + 20)"},
+      asRowType(data->type()));
+  auto lambda = getLambda(*exprSet->expr(1));
+  ASSERT_EQ(lambda->hoisted().size(), 2);
+  // The hoisted multiply is the one of the first expression.
+  EXPECT_EQ(lambda->hoisted()[0], exprSet->expr(0)->inputs()[0]);
+
+  // Non-deterministic expressions stay in the lambda.
+  exprSet = compileExpression(
+      "transform(c0, x -> x + cast(rand() * c1 as bigint))",
+      asRowType(data->type()));
+  EXPECT_TRUE(getLambda(*exprSet->expr(0))->hoisted().empty());
+  setHoisting(false);
+
+  assertHoisting(
+      {"c1 * 2 > 10", "filter(c0, x -> x > c1 * 2 and x < c1 + 20)"}, data);
+  assertHoisting({"transform(c0, x -> x * (c1 + 1) + c1 % 3)"}, data);
+  // Nested lambdas.
+  assertHoisting(
+      {"transform(c0, x -> filter(c0, y -> y * (c1 + 1) > x))"}, data);
+
+  // The division fails only for rows with empty arrays, so the lambda as
+  // written does not fail.
+  auto divisors = makeRowVector({
+      makeArrayVector<int64_t>({{1, 2}, {}, {3}}),
+      makeFlatVector<int64_t>({1, 0, 2}),
+  });
+  assertHoisting({"transform(c0, x -> x + 10 / c1)"}, divisors);
+  divisors = makeRowVector({
+      makeArrayVector<int64_t>({{1, 2}, {3}}),
+      makeFlatVector<int64_t>({1, 0}),
+  });
+  setHoisting(true);
+  VELOX_ASSERT_THROW(
+      evaluate("transform(c0, x -> x + 10 / c1)", divisors),
+      "division by zero");
+  setHoisting(false);
+}
+
+TEST_F(ExprTest, commonSubexpressionReuse) {
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+  });
+
+  auto [results, stats] =
+      evaluateMultipleWithStats({"c0 * 3 > 10", "c0 * 3 + 1"}, data);
+  EXPECT_EQ(stats.at("multiply").numProcessedRows, size);
+  EXPECT_EQ(stats.at("multiply").numReusedRows, size);
+  EXPECT_EQ(stats.at("plus").numReusedRows, 0);
+}
+
 TEST_F(ExprTest, flatNoNullsFastPath) {
   auto data = makeRowVector(
       {"a", "b", "c", "d"},
@@ -61,6 +61,8 @@ int main(int argc, char** argv) {
       "in",
       "element_at",
       "width_bucket",
+      // Only called by the ExprCompiler with a constant ROW of JSON paths.
+      "$internal$json_extract_scalars",
   };
   size_t initialSeed = FLAGS_seed == 0 ? std::time(nullptr) : FLAGS_seed;
   return FuzzerRunner::run(
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/FusedKernel.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+class FusedKernelTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    FusedKernel::clearCache();
+  }
+
+  std::shared_ptr<const FusedKernel> compile(
+      const std::string& filter,
+      const std::vector<std::string>& projections,
+      const RowVectorPtr& data) {
+    const auto rowType = asRowType(data->type());
+    std::vector<core::TypedExprPtr> projectionExprs;
+    for (const auto& projection : projections) {
+      projectionExprs.push_back(makeTypedExpr(projection, rowType));
+    }
+    return FusedKernel::compile(
+        filter.empty() ? nullptr : makeTypedExpr(filter, rowType),
+        projectionExprs,
+        rowType);
+  }
+
+  // Checks that the fused kernel for 'filter' and 'projections' produces the
+  // same results as the interpreter.
+  void assertFused(
+      const std::string& filter,
+      const std::vector<std::string>& projections,
+      const RowVectorPtr& data) {
+    auto kernel = compile(filter, projections, data);
+    ASSERT_NE(kernel, nullptr);
+
+    vector_size_t numPassed;
+    BufferPtr passedRows;
+    std::vector<VectorPtr> results;
+    ASSERT_TRUE(kernel->eval(*data, pool(), numPassed, passedRows, results));
+
+    std::vector<vector_size_t> expectedRows;
+    if (filter.empty()) {
+      expectedRows.resize(data->size());
+      std::iota(expectedRows.begin(), expectedRows.end(), 0);
+    } else {
+      auto passed = evaluate<SimpleVector<bool>>(filter, data);
+      for (auto i = 0; i < data->size(); ++i) {
+        if (passed->valueAt(i)) {
+          expectedRows.push_back(i);
+        }
+      }
+    }
+    ASSERT_EQ(numPassed, expectedRows.size());
+    if (expectedRows.size() == data->size()) {
+      ASSERT_EQ(passedRows, nullptr);
+    } else {
+      auto* rawPassedRows = passedRows->as<vector_size_t>();
+      for (auto i = 0; i < numPassed; ++i) {
+        ASSERT_EQ(rawPassedRows[i], expectedRows[i]);
+      }
+    }
+
+    ASSERT_EQ(results.size(), projections.size());
+    for (auto i = 0; i < projections.size(); ++i) {
+      auto expected = wrapInDictionary(
+          makeIndices(expectedRows),
+          expectedRows.size(),
+          evaluate(projections[i], data));
+      assertEqualVectors(expected, results[i]);
+    }
+  }
+
+  // Returns true if the fused kernel evaluates 'data'.
+  bool evalFused(
+      const std::string& filter,
+      const std::vector<std::string>& projections,
+      const RowVectorPtr& data) {
+    auto kernel = compile(filter, projections, data);
+    VELOX_CHECK_NOT_NULL(kernel);
+    vector_size_t numPassed;
+    BufferPtr passedRows;
+    std::vector<VectorPtr> results;
+    return kernel->eval(*data, pool(), numPassed, passedRows, results);
+  }
+
+  // Returns 3 tiles worth of rows.
+  RowVectorPtr makeData() {
+    const vector_size_t size = 3'000;
+    return makeRowVector({
+        makeFlatVector<int64_t>(size, [](auto row) { return row - 1'000; }),
+        makeFlatVector<double>(size, [](auto row) { return row * 0.25; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 77; }),
+        makeFlatVector<bool>(size, [](auto row) { return row % 3 == 0; }),
+    });
+  }
+};
+
+TEST_F(FusedKernelTest, filterAndProject) {
+  auto data = makeData();
+  assertFused(
+      "c0 > 10 and c1 < 600.0",
+      {"c0 + c0 * 2", "c1 / 2.0 - c1", "c2 * c2", "-c0"},
+      data);
+  assertFused(
+      "c0 >= cast(c2 as bigint) or c3", {"c0 = 5 or not (c1 > 3.0)"}, data);
+  assertFused("", {"cast(c2 as bigint) + c0", "c2 - c2 * c2"}, data);
+  assertFused("c2 <> 7", {}, data);
+
+  // No rows pass the filter.
+  assertFused("c0 > 1000000", {"c0 + 1"}, data);
+}
+
+TEST_F(FusedKernelTest, encodings) {
+  auto data = makeData();
+  const auto size = data->size();
+  data = makeRowVector({
+      wrapInDictionary(makeIndicesInReverse(size), size, data->childAt(0)),
+      makeConstant(1.5, size),
+      wrapInDictionary(
+          makeIndices(size, [](auto row) { return row / 2; }),
+          size,
+          data->childAt(2)),
+      makeConstant(true, size),
+  });
+  assertFused(
+      "c0 > cast(c2 as bigint) and c3",
+      {"c0 + cast(c2 as bigint)", "c1 * 2.0", "c3 and c0 < 0"},
+      data);
+}
+
+TEST_F(FusedKernelTest, fallback) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+      makeFlatVector<int64_t>({1, 0, std::numeric_limits<int64_t>::max()}),
+  });
+  // Nulls in a referenced column.
+  EXPECT_FALSE(evalFused("", {"c0 + 1"}, data));
+  // The fused kernel doesn't need the column with nulls.
+  EXPECT_TRUE(evalFused("", {"c1 + 0"}, data));
+  // Overflow.
+  EXPECT_FALSE(evalFused("", {"c1 + 1"}, data));
+  // Division by zero.
+  EXPECT_FALSE(evalFused("", {"10 / c1"}, data));
+  // The rows that fail the filter are not computed.
+  EXPECT_TRUE(evalFused("c1 = 1", {"c1 + 1", "10 / c1"}, data));
+}
+
+TEST_F(FusedKernelTest, unsupported) {
+  auto data = makeData();
+  EXPECT_EQ(compile("c0 % 2 = 0", {}, data), nullptr);
+  EXPECT_EQ(compile("", {"c0", "abs(c0)"}, data), nullptr);
+  EXPECT_EQ(compile("", {"cast(c1 as bigint)"}, data), nullptr);
+  EXPECT_EQ(compile("", {"if(c3, c0, c0 + 1)"}, data), nullptr);
+}
+
+TEST_F(FusedKernelTest, cache) {
+  auto data = makeData();
+  auto kernel = compile("c0 > 10", {"c0 + 1"}, data);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(FusedKernel::cacheSize(), 1);
+  EXPECT_EQ(compile("c0 > 10", {"c0 + 1"}, data), kernel);
+  EXPECT_EQ(FusedKernel::cacheSize(), 1);
+
+  EXPECT_NE(compile("c0 > 10", {"c0 + 2"}, data), kernel);
+  EXPECT_EQ(FusedKernel::cacheSize(), 2);
+
+  // Expressions that are not supported are cached as well.
+  EXPECT_EQ(compile("c0 % 2 = 0", {}, data), nullptr);
+  EXPECT_EQ(FusedKernel::cacheSize(), 3);
+}
@@ -804,6 +804,57 @@ TEST_F(SimpleFunctionTest, stringReuseConstant) {
   assertEqualVectors(expected, result);
 }
 
+template <typename T>
+struct LongestElementFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  static constexpr int32_t reuse_strings_from_arg = 0;
+
+  bool call(out_type<Varchar>& out, const arg_type<Array<Varchar>>& input) {
+    std::optional<StringView> longest;
+    for (const auto& item : input) {
+      if (item.has_value() && (!longest || item->size() > longest->size())) {
+        longest = item.value();
+      }
+    }
+    if (!longest) {
+      return false;
+    }
+    out.setNoCopy(longest.value());
+    return true;
+  }
+};
+
+TEST_F(SimpleFunctionTest, stringReuseFromComplexType) {
+  registerFunction<LongestElementFunction, Varchar, Array<Varchar>>(
+      {"longest_element"});
+
+  auto input = makeRowVector({makeArrayVector<StringView>({
+      {"a long string that is not inlined"_sv, "b"_sv},
+      {},
+      {"cc"_sv, "another string that is too long to inline"_sv},
+  })});
+  auto result =
+      evaluate<FlatVector<StringView>>("longest_element(c0)", input);
+
+  // The result references the buffers of the array elements.
+  auto* elements = input->childAt(0)
+                       ->as<ArrayVector>()
+                       ->elements()
+                       ->asFlatVector<StringView>();
+  ASSERT_FALSE(elements->stringBuffers().empty());
+  EXPECT_EQ(result->stringBuffers(), elements->stringBuffers());
+
+  // The result outlives the input.
+  input.reset();
+  assertEqualVectors(
+      makeNullableFlatVector<StringView>(
+          {"a long string that is not inlined"_sv,
+           std::nullopt,
+           "another string that is too long to inline"_sv}),
+      result);
+}
+
 template <typename T>
 struct MapStringOut {
   VELOX_DEFINE_FUNCTION_TYPES(T);
@@ -1110,4 +1161,74 @@ TEST_F(SimpleFunctionTest, testAllNotNull) {
   assertEqualVectors(expected, result);
 }
 
+int32_t numBatchCalls = 0;
+
+template <typename T>
+struct BatchMultiplyAdd {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  void call(double& out, double a, double b) {
+    out = a * b + 1;
+  }
+
+  void callBatch(double* out, const double* a, const double* b, int32_t size) {
+    ++numBatchCalls;
+    for (auto i = 0; i < size; ++i) {
+      out[i] = a[i] * b[i] + 1;
+    }
+  }
+};
+
+// Test that callBatch is called on runs of flat or constant arguments and
+// gives the same results as call.
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchMultiplyAdd, double, double, double>(
+      {"batch_multiply_add"});
+  const vector_size_t size = 3'000;
+  auto a = makeFlatVector<double>(size, [](auto row) { return row * 0.5; });
+  auto b = makeFlatVector<double>(size, [](auto row) { return row % 7; });
+  auto expected = makeFlatVector<double>(
+      size, [](auto row) { return row * 0.5 * (row % 7) + 1; });
+
+  numBatchCalls = 0;
+  auto result = evaluate("batch_multiply_add(c0, c1)", makeRowVector({a, b}));
+  assertEqualVectors(expected, result);
+  // 3 batches of at most 1024 rows.
+  EXPECT_EQ(numBatchCalls, 3);
+
+  // A constant argument.
+  numBatchCalls = 0;
+  result = evaluate("batch_multiply_add(c0, 2.0)", makeRowVector({a}));
+  assertEqualVectors(
+      makeFlatVector<double>(size, [](auto row) { return row + 1.0; }),
+      result);
+  EXPECT_EQ(numBatchCalls, 3);
+
+  // Nulls split the rows into runs.
+  numBatchCalls = 0;
+  auto nullableA = makeFlatVector<double>(
+      size, [](auto row) { return row * 0.5; }, nullEvery(100));
+  result =
+      evaluate("batch_multiply_add(c0, c1)", makeRowVector({nullableA, b}));
+  assertEqualVectors(
+      makeFlatVector<double>(
+          size,
+          [](auto row) { return row * 0.5 * (row % 7) + 1; },
+          nullEvery(100)),
+      result);
+  EXPECT_EQ(numBatchCalls, 30);
+
+  // Dictionary arguments use call.
+  numBatchCalls = 0;
+  result = evaluate(
+      "batch_multiply_add(c0, c1)",
+      makeRowVector({
+          wrapInDictionary(
+              makeIndices(size, [](auto row) { return row; }), size, a),
+          b,
+      }));
+  assertEqualVectors(expected, result);
+  EXPECT_EQ(numBatchCalls, 0);
+}
+
 } // namespace
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/ValueMemo.h"
+#include "velox/expression/Expr.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+class ValueMemoTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    setMemoEnabled(true);
+  }
+
+  void setMemoEnabled(bool enabled, const std::string& maxBytes = "16777216") {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprValueMemoEnabled, enabled ? "true" : "false"},
+        {core::QueryConfig::kExprValueMemoMaxBytes, maxBytes},
+    });
+  }
+
+  // Returns 'size' user agent strings with 'numDistinct' distinct values.
+  VectorPtr makeAgents(vector_size_t size, int32_t numDistinct) {
+    return makeFlatVector<std::string>(size, [&](auto row) {
+      return fmt::format("Mozilla/{0}.0 (Agent {0})", row % numDistinct);
+    });
+  }
+
+  // Evaluates 'expression' over 'batches' with a single ExprSet and checks the
+  // results against an evaluation without memo. Returns the first memo found
+  // in the expression tree.
+  const ValueMemo* assertMemoized(
+      const std::string& expression,
+      const std::vector<RowVectorPtr>& batches) {
+    auto exprSet =
+        compileExpression(expression, asRowType(batches[0]->type()));
+    std::vector<VectorPtr> results;
+    for (const auto& batch : batches) {
+      results.push_back(evaluate(*exprSet, batch));
+    }
+
+    setMemoEnabled(false);
+    for (auto i = 0; i < batches.size(); ++i) {
+      assertEqualVectors(evaluate(expression, batches[i]), results[i]);
+    }
+    setMemoEnabled(true);
+
+    exprSet_ = std::move(exprSet);
+    return findMemo(exprSet_->expr(0).get());
+  }
+
+  static const ValueMemo* findMemo(const Expr* expr) {
+    if (expr->valueMemo()) {
+      return expr->valueMemo();
+    }
+    for (const auto& input : expr->inputs()) {
+      if (auto* memo = findMemo(input.get())) {
+        return memo;
+      }
+    }
+    return nullptr;
+  }
+
+  std::unique_ptr<ExprSet> exprSet_;
+};
+
+TEST_F(ValueMemoTest, acrossBatches) {
+  const vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<std::string>(
+        size,
+        [](auto row) { return fmt::format("Mozilla/{}.0 (X11)", row % 10); },
+        [](auto row) { return row % 17 == 0; })}));
+  }
+
+  auto* memo = assertMemoized(
+      "regexp_extract(c0, '([A-Za-z]+)/([0-9.]+)', 2)", batches);
+  ASSERT_NE(memo, nullptr);
+  EXPECT_TRUE(memo->enabled());
+  EXPECT_EQ(memo->numEntries(), 10);
+  EXPECT_GT(memo->bytes(), 0);
+  // Only the first occurrence of each value in the first batch misses.
+  const auto numNotNull = 3 * (size - (size + 16) / 17);
+  EXPECT_EQ(memo->numLookups(), numNotNull);
+  EXPECT_EQ(memo->numHits(), numNotNull - 10);
+
+  // Clearing the ExprSet frees the memo.
+  exprSet_->clear();
+  EXPECT_EQ(memo->numEntries(), 0);
+  EXPECT_EQ(memo->bytes(), 0);
+}
+
+TEST_F(ValueMemoTest, encodings) {
+  const vector_size_t size = 1'000;
+  auto agents = makeAgents(size, 20);
+  std::vector<RowVectorPtr> batches = {
+      makeRowVector({wrapInDictionary(
+          makeIndices(size, [](auto row) { return (row * 7) % 1'000; }),
+          size,
+          agents)}),
+      makeRowVector({makeConstant("Mozilla/5.0 (Agent 5)", size)}),
+      makeRowVector({agents}),
+  };
+
+  auto* memo =
+      assertMemoized("regexp_like(c0, 'Mozilla/1[0-9]\\.0')", batches);
+  ASSERT_NE(memo, nullptr);
+  EXPECT_EQ(memo->numEntries(), 20);
+
+  // The argument is computed.
+  memo = assertMemoized(
+      "url_extract_host(concat('http://', c0, '.example.com/x'))", batches);
+  ASSERT_NE(memo, nullptr);
+  EXPECT_EQ(memo->numEntries(), 20);
+}
+
+TEST_F(ValueMemoTest, errors) {
+  auto data = makeRowVector({makeFlatVector<std::string>(
+      3'000, [](auto row) {
+        return row % 3 == 0 ? "2023-01-0" + std::to_string(row % 9 + 1)
+                            : "not a date";
+      })});
+
+  auto* memo = assertMemoized("try(date_parse(c0, '%Y-%m-%d'))", {data, data});
+  ASSERT_NE(memo, nullptr);
+  // The value that fails to parse is not remembered.
+  EXPECT_EQ(memo->numEntries(), 3);
+}
+
+TEST_F(ValueMemoTest, lowHitRate) {
+  const vector_size_t size = ValueMemo::kWindowRows + 1'000;
+  auto data = makeRowVector({makeAgents(size, size)});
+
+  auto* memo = assertMemoized("regexp_extract(c0, '[0-9]+')", {data, data});
+  ASSERT_NE(memo, nullptr);
+  EXPECT_FALSE(memo->enabled());
+  EXPECT_EQ(memo->numEntries(), 0);
+  EXPECT_EQ(memo->numLookups(), size);
+}
+
+TEST_F(ValueMemoTest, maxBytes) {
+  setMemoEnabled(true, "1000");
+  auto data = makeRowVector({makeAgents(1'000, 100)});
+
+  auto* memo = assertMemoized(
+      "regexp_replace(c0, '[0-9]+', '#')", {data, data, data});
+  ASSERT_NE(memo, nullptr);
+  EXPECT_TRUE(memo->enabled());
+  EXPECT_GT(memo->numEntries(), 0);
+  EXPECT_LT(memo->numEntries(), 100);
+}
+
+TEST_F(ValueMemoTest, notMemoized) {
+  auto data = makeRowVector({
+      makeAgents(100, 10),
+      makeFlatVector<std::string>(100, [](auto /*row*/) { return "a"; }),
+  });
+  // Not configured.
+  EXPECT_EQ(assertMemoized("length(c0)", {data}), nullptr);
+  // Two arguments that are not constant.
+  EXPECT_EQ(assertMemoized("url_extract_parameter(c0, c1)", {data}), nullptr);
+  // Disabled.
+  setMemoEnabled(false);
+  auto exprSet = compileExpression("regexp_extract(c0, 'a')", ROW({VARCHAR()}));
+  EXPECT_EQ(findMemo(exprSet->expr(0).get()), nullptr);
+}
@@ -18,6 +18,7 @@
 #include <folly/String.h>
 #include <velox/common/base/Exceptions.h>
 #include <velox/type/Date.h>
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 #include "velox/external/date/date.h"
@@ -180,40 +181,6 @@ static std::
         };
 constexpr int monthsFullLength[] = {7, 8, 5, 5, 3, 4, 4, 6, 9, 7, 8, 8};
 
-/// Pads the content with desired padding characters. E.g. if we need to pad 999
-/// with three 0s in front, the result will be '000999'
-/// \param content the content that is going to be padded.
-/// \param padding the padding that is going to be used to pad the content.
-/// \param totalDigits the total number of digits the padded result is desired
-/// to be. If totalDigits is already smaller than content length, the original
-/// content will be returned with no padding
-/// \param padFront if the padding is in front of the content or back of the
-/// content.
-template <typename T>
-std::string padContent(
-    const T& content,
-    char padding,
-    size_t totalDigits,
-    bool padFront = true) {
-  std::string strContent = folly::to<std::string>(content);
-  auto contentLength = strContent.size();
-  if (contentLength == 0) {
-    return std::string(totalDigits, padding);
-  }
-
-  bool isNegative = strContent[0] == '-';
-  auto digitLength = contentLength - (isNegative ? 1 : 0);
-  if (digitLength >= totalDigits) {
-    return strContent;
-  }
-  std::string paddingStr(totalDigits - digitLength, padding);
-  if (padFront) {
-    return strContent.insert((isNegative ? 1 : 0), paddingStr);
-  } else {
-    return strContent.append(paddingStr);
-  }
-}
-
 void validateTimePoint(const std::chrono::time_point<
                        std::chrono::system_clock,
                        std::chrono::milliseconds>& timePoint) {
@@ -484,31 +451,64 @@ int64_t parseHalfDayOfDay(const char* cur, const char* end, Date& date) {
   }
 }
 
-std::string formatFractionOfSecond(
-    uint16_t subseconds,
-    size_t minRepresentDigits) {
-  char toAdd[minRepresentDigits > 3 ? minRepresentDigits + 1 : 4];
-
-  if (subseconds < 10) {
-    toAdd[0] = '0';
-    toAdd[1] = '0';
-    toAdd[2] = char(subseconds + '0');
-  } else if (subseconds < 100) {
-    toAdd[2] = char(subseconds % 10 + '0');
-    toAdd[1] = char((subseconds / 10) % 10 + '0');
-    toAdd[0] = '0';
-  } else {
-    toAdd[2] = char(subseconds % 10 + '0');
-    toAdd[1] = char((subseconds / 10) % 10 + '0');
-    toAdd[0] = char((subseconds / 100) % 10 + '0');
+// The size of the longest month or weekday name.
+constexpr size_t kMaxTextSize = 9;
+
+// Returns the most characters writePadded() writes for 'minDigits'.
+constexpr size_t maxPaddedSize(size_t minDigits) {
+  // A sign and up to 19 digits.
+  return std::max<size_t>(minDigits, 19) + 1;
+}
+
+// Writes 'value' into 'out' with leading zeros up to 'minDigits' digits. The
+// sign of a negative value goes before the zeros. Returns the number of
+// characters written.
+size_t writePadded(int64_t value, size_t minDigits, char* out) {
+  char* start = out;
+  uint64_t magnitude = value;
+  if (value < 0) {
+    *out++ = '-';
+    magnitude = -magnitude;
   }
+  char digits[20];
+  size_t numDigits = 0;
+  do {
+    digits[numDigits++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (numDigits < minDigits) {
+    memset(out, '0', minDigits - numDigits);
+    out += minDigits - numDigits;
+  }
+  while (numDigits > 0) {
+    *out++ = digits[--numDigits];
+  }
+  return out - start;
+}
 
-  if (minRepresentDigits > 3) {
-    memset(toAdd + 3, '0', minRepresentDigits - 3);
+// Writes the first 'minDigits' digits of the 3 digit 'millis' followed by
+// zeros if 'minDigits' is more than 3. Returns 'minDigits'.
+size_t writeFractionOfSecond(uint16_t millis, size_t minDigits, char* out) {
+  const char digits[3] = {
+      char('0' + millis / 100 % 10),
+      char('0' + millis / 10 % 10),
+      char('0' + millis % 10)};
+  const auto numDigits = std::min<size_t>(minDigits, 3);
+  memcpy(out, digits, numDigits);
+  if (minDigits > 3) {
+    memset(out + 3, '0', minDigits - 3);
   }
+  return minDigits;
+}
+
+bool isYearSpecifier(DateTimeFormatSpecifier specifier) {
+  return specifier == DateTimeFormatSpecifier::YEAR ||
+      specifier == DateTimeFormatSpecifier::YEAR_OF_ERA;
+}
 
-  toAdd[minRepresentDigits] = '\0';
-  return toAdd;
+size_t writeText(std::string_view text, char* out) {
+  memcpy(out, text.data(), text.size());
+  return text.size();
 }
 
 // According to DateTimeFormatSpecifier enum class
@@ -949,9 +949,48 @@ void parseFromPattern(
 
 } // namespace
 
+size_t DateTimeFormatter::maxResultSize(const date::time_zone* timezone) const {
+  size_t size = 0;
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      size += token.literal.size();
+      continue;
+    }
+    switch (token.pattern.specifier) {
+      case DateTimeFormatSpecifier::ERA:
+      case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
+        size += 2;
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_WEEK_TEXT:
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR_TEXT:
+        size += kMaxTextSize;
+        break;
+      case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+        size += token.pattern.minRepresentDigits;
+        break;
+      case DateTimeFormatSpecifier::TIMEZONE:
+        size += timezone == nullptr ? 0 : timezone->name().size();
+        break;
+      default:
+        size += maxPaddedSize(token.pattern.minRepresentDigits);
+        break;
+    }
+  }
+  return size;
+}
+
 std::string DateTimeFormatter::format(
     const Timestamp& timestamp,
     const date::time_zone* timezone) const {
+  std::string result(maxResultSize(timezone), '\0');
+  result.resize(format(timestamp, timezone, result.data()));
+  return result;
+}
+
+size_t DateTimeFormatter::format(
+    const Timestamp& timestamp,
+    const date::time_zone* timezone,
+    char* result) const {
   const std::chrono::
       time_point<std::chrono::system_clock, std::chrono::milliseconds>
           timePoint(std::chrono::milliseconds(timestamp.toMillis()));
@@ -962,30 +1001,32 @@ std::string DateTimeFormatter::format(
   const date::year_month_day calDate(daysTimePoint);
   const date::weekday weekday(daysTimePoint);
 
-  std::string result;
+  char* out = result;
   for (auto& token : tokens_) {
     if (token.type == DateTimeToken::Type::kLiteral) {
-      result += token.literal;
+      out += writeText(token.literal, out);
     } else {
+      const auto minDigits = token.pattern.minRepresentDigits;
       switch (token.pattern.specifier) {
         case DateTimeFormatSpecifier::ERA:
-          result += static_cast<signed>(calDate.year()) > 0 ? "AD" : "BC";
+          out += writeText(
+              static_cast<signed>(calDate.year()) > 0 ? "AD" : "BC", out);
           break;
 
         case DateTimeFormatSpecifier::CENTURY_OF_ERA: {
           auto year = static_cast<signed>(calDate.year());
           year = (year < 0 ? -year : year);
           auto century = year / 100;
-          result += padContent(century, '0', token.pattern.minRepresentDigits);
+          out += writePadded(century, minDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::YEAR_OF_ERA: {
           auto year = static_cast<signed>(calDate.year());
-          if (token.pattern.minRepresentDigits == 2) {
-            result += padContent(std::abs(year) % 100, '0', 2);
+          if (minDigits == 2) {
+            out += writePadded(std::abs(year) % 100, 2, out);
           } else {
             year = year <= 0 ? std::abs(year - 1) : year;
-            result += padContent(year, '0', token.pattern.minRepresentDigits);
+            out += writePadded(year, minDigits, out);
           }
         } break;
 
@@ -997,31 +1038,24 @@ std::string DateTimeFormatter::format(
                   DateTimeFormatSpecifier::DAY_OF_WEEK_1_BASED) {
             weekdayNum = 7;
           }
-          result +=
-              padContent(weekdayNum, '0', token.pattern.minRepresentDigits);
+          out += writePadded(weekdayNum, minDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::DAY_OF_WEEK_TEXT: {
           auto weekdayNum = weekday.c_encoding();
-          if (token.pattern.minRepresentDigits <= 3) {
-            result += weekdaysShort[weekdayNum];
+          if (minDigits <= 3) {
+            out += writeText(weekdaysShort[weekdayNum], out);
           } else {
-            result += weekdaysFull[weekdayNum];
+            out += writeText(weekdaysFull[weekdayNum], out);
           }
         } break;
 
         case DateTimeFormatSpecifier::YEAR: {
           auto year = static_cast<signed>(calDate.year());
-          if (token.pattern.minRepresentDigits == 2) {
-            year = std::abs(year);
-            auto twoDigitYear = year % 100;
-            result +=
-                padContent(twoDigitYear, '0', token.pattern.minRepresentDigits);
+          if (minDigits == 2) {
+            out += writePadded(std::abs(year) % 100, minDigits, out);
           } else {
-            result += padContent(
-                static_cast<signed>(calDate.year()),
-                '0',
-                token.pattern.minRepresentDigits);
+            out += writePadded(year, minDigits, out);
           }
         } break;
 
@@ -1032,33 +1066,32 @@ std::string DateTimeFormatter::format(
               (date::sys_days{calDate} - date::sys_days{firstDayOfTheYear})
                   .count();
           delta += 1;
-          result += padContent(delta, '0', token.pattern.minRepresentDigits);
+          out += writePadded(delta, minDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::MONTH_OF_YEAR:
-          result += padContent(
-              static_cast<unsigned>(calDate.month()),
-              '0',
-              token.pattern.minRepresentDigits);
+          out += writePadded(
+              static_cast<unsigned>(calDate.month()), minDigits, out);
           break;
 
         case DateTimeFormatSpecifier::MONTH_OF_YEAR_TEXT:
-          if (token.pattern.minRepresentDigits <= 3) {
-            result += monthsShort[static_cast<unsigned>(calDate.month()) - 1];
+          if (minDigits <= 3) {
+            out += writeText(
+                monthsShort[static_cast<unsigned>(calDate.month()) - 1], out);
           } else {
-            result += monthsFull[static_cast<unsigned>(calDate.month()) - 1];
+            out += writeText(
+                monthsFull[static_cast<unsigned>(calDate.month()) - 1], out);
           }
           break;
 
         case DateTimeFormatSpecifier::DAY_OF_MONTH:
-          result += padContent(
-              static_cast<unsigned>(calDate.day()),
-              '0',
-              token.pattern.minRepresentDigits);
+          out +=
+              writePadded(static_cast<unsigned>(calDate.day()), minDigits, out);
           break;
 
         case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
-          result += durationInTheDay.hours().count() < 12 ? "AM" : "PM";
+          out += writeText(
+              durationInTheDay.hours().count() < 12 ? "AM" : "PM", out);
           break;
 
         case DateTimeFormatSpecifier::HOUR_OF_HALFDAY:
@@ -1078,40 +1111,34 @@ std::string DateTimeFormatter::format(
               DateTimeFormatSpecifier::CLOCK_HOUR_OF_DAY) {
             hourNum = (hourNum + 23) % 24 + 1;
           }
-          result += padContent(hourNum, '0', token.pattern.minRepresentDigits);
+          out += writePadded(hourNum, minDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
-          result += padContent(
-              durationInTheDay.minutes().count() % 60,
-              '0',
-              token.pattern.minRepresentDigits);
+          out += writePadded(
+              durationInTheDay.minutes().count() % 60, minDigits, out);
           break;
 
         case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
-          result += padContent(
-              durationInTheDay.seconds().count() % 60,
-              '0',
-              token.pattern.minRepresentDigits);
+          out += writePadded(
+              durationInTheDay.seconds().count() % 60, minDigits, out);
           break;
 
-        case DateTimeFormatSpecifier::FRACTION_OF_SECOND: {
-          result += formatFractionOfSecond(
-              durationInTheDay.subseconds().count(),
-              token.pattern.minRepresentDigits);
+        case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+          out += writeFractionOfSecond(
+              durationInTheDay.subseconds().count(), minDigits, out);
           break;
-        }
 
         case DateTimeFormatSpecifier::TIMEZONE:
           // TODO: implement short name time zone, need a map from full name to
           // short name
-          if (token.pattern.minRepresentDigits <= 3) {
+          if (minDigits <= 3) {
             VELOX_UNSUPPORTED("short name time zone is not yet supported")
           }
           if (timezone == nullptr) {
             VELOX_USER_FAIL("Timezone unknown")
           }
-          result += timezone->name();
+          out += writeText(timezone->name(), out);
           break;
 
         case DateTimeFormatSpecifier::TIMEZONE_OFFSET_ID:
@@ -1126,10 +1153,173 @@ std::string DateTimeFormatter::format(
       }
     }
   }
-  return result;
+  return out - result;
+}
+
+void DateTimeFormatter::compileFixedWidthParser() {
+  std::vector<FixedWidthField> fields;
+  std::vector<std::pair<uint32_t, std::string_view>> literals;
+  uint32_t offset = 0;
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      // A digit in a literal could be taken for a digit of a field.
+      if (std::any_of(
+              token.literal.begin(), token.literal.end(), characterIsDigit)) {
+        return;
+      }
+      literals.emplace_back(offset, token.literal);
+      offset += token.literal.size();
+      continue;
+    }
+    const auto specifier = token.pattern.specifier;
+    const auto digits = token.pattern.minRepresentDigits;
+    uint32_t size = 0;
+    switch (specifier) {
+      case DateTimeFormatSpecifier::YEAR:
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        size = digits == 4 ? 4 : 0;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        size = digits == 2 ? 2 : 0;
+        break;
+      case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+        size = digits;
+        break;
+      default:
+        break;
+    }
+    if (size == 0) {
+      return;
+    }
+    for (const auto& field : fields) {
+      if (field.specifier == specifier ||
+          (isYearSpecifier(field.specifier) && isYearSpecifier(specifier))) {
+        return;
+      }
+    }
+    fields.push_back({specifier, offset, size});
+    offset += size;
+  }
+  fixedWidthFields_ = std::move(fields);
+  fixedWidthLiterals_ = std::move(literals);
+  fixedWidthSize_ = offset;
+}
+
+std::optional<DateTimeResult> DateTimeFormatter::parseFixedWidth(
+    const std::string_view& input) const {
+  if (input.size() != fixedWidthSize_) {
+    return std::nullopt;
+  }
+  for (const auto& [offset, literal] : fixedWidthLiterals_) {
+    if (std::memcmp(input.data() + offset, literal.data(), literal.size()) !=
+        0) {
+      return std::nullopt;
+    }
+  }
+
+  int32_t year = 1970;
+  int32_t month = 1;
+  int32_t day = 1;
+  int32_t hour = 0;
+  int32_t minute = 0;
+  int32_t second = 0;
+  int32_t millis = 0;
+  bool hasYear = false;
+  bool hasMonthOrDay = false;
+  for (const auto& field : fixedWidthFields_) {
+    const char* digits = input.data() + field.offset;
+    // Only the first 3 digits of a fraction of second are kept.
+    const auto numValueDigits =
+        field.specifier == DateTimeFormatSpecifier::FRACTION_OF_SECOND
+        ? std::min<uint32_t>(field.size, 3)
+        : field.size;
+    int32_t value = 0;
+    for (uint32_t i = 0; i < field.size; ++i) {
+      if (!characterIsDigit(digits[i])) {
+        return std::nullopt;
+      }
+      if (i < numValueDigits) {
+        value = value * 10 + (digits[i] - '0');
+      }
+    }
+    switch (field.specifier) {
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        if (value == 0) {
+          return std::nullopt;
+        }
+        year = value;
+        hasYear = true;
+        break;
+      case DateTimeFormatSpecifier::YEAR:
+        year = value;
+        hasYear = true;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        if (value < 1 || value > 12) {
+          return std::nullopt;
+        }
+        month = value;
+        hasMonthOrDay = true;
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        day = value;
+        hasMonthOrDay = true;
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        if (value > 23) {
+          return std::nullopt;
+        }
+        hour = value;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        if (value > 59) {
+          return std::nullopt;
+        }
+        minute = value;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        if (value > 59) {
+          return std::nullopt;
+        }
+        second = value;
+        break;
+      case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+        for (auto i = numValueDigits; i < 3; ++i) {
+          value *= 10;
+        }
+        millis = value;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+
+  // Same as the general path: the year defaults to 2000 instead of 1970 if
+  // the month or the day is given.
+  if (!hasYear && hasMonthOrDay) {
+    year = 2000;
+  }
+  if (!util::isValidDate(year, month, day)) {
+    return std::nullopt;
+  }
+  return DateTimeResult{
+      util::fromDatetime(
+          util::daysSinceEpochFromDate(year, month, day),
+          util::fromTime(hour, minute, second, millis * util::kMicrosPerMsec)),
+      -1};
 }
 
 DateTimeResult DateTimeFormatter::parse(const std::string_view& input) const {
+  if (!fixedWidthFields_.empty()) {
+    if (auto result = parseFixedWidth(input)) {
+      return *result;
+    }
+  }
+
   Date date;
   const char* cur = input.data();
   const char* end = cur + input.size();
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 #include "velox/common/base/Exceptions.h"
@@ -159,7 +160,9 @@ class DateTimeFormatter {
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
         tokens_(std::move(tokens)),
-        type_(type) {}
+        type_(type) {
+    compileFixedWidthParser();
+  }
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -173,17 +176,56 @@ class DateTimeFormatter {
     return tokens_;
   }
 
+  /// Parses 'input'. If all fields of the format have a fixed number of
+  /// digits, e.g. 'yyyy-MM-dd HH:mm:ss', an input that matches the format
+  /// exactly is parsed at fixed offsets without going through the tokens.
   DateTimeResult parse(const std::string_view& input) const;
 
+  /// Returns the most characters format() writes for 'timezone'.
+  size_t maxResultSize(const date::time_zone* timezone) const;
+
+  /// Writes 'timestamp' formatted into 'result', which must have space for
+  /// maxResultSize(timezone) characters. Returns the number of characters
+  /// written.
+  size_t format(
+      const Timestamp& timestamp,
+      const date::time_zone* timezone,
+      char* result) const;
+
   std::string format(
       const Timestamp& timestamp,
       const date::time_zone* timezone) const;
 
  private:
+  struct FixedWidthField {
+    DateTimeFormatSpecifier specifier;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  // Sets the fixed width fields and literals if the format only has numeric
+  // fields of a fixed number of digits, each at most once, and literals
+  // without digits.
+  void compileFixedWidthParser();
+
+  // Parses 'input' at the offsets of the fixed width fields. Returns
+  // std::nullopt if 'input' does not match the format or has a value out of
+  // range, in which case parse() takes the general path, which reports the
+  // error.
+  std::optional<DateTimeResult> parseFixedWidth(
+      const std::string_view& input) const;
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
   DateTimeFormatterType type_;
+
+  // The fields and the literals with their offsets in an input that matches
+  // a format of fixed width fields. Empty if the format is not like that.
+  std::vector<FixedWidthField> fixedWidthFields_;
+  std::vector<std::pair<uint32_t, std::string_view>> fixedWidthLiterals_;
+  // The size of an input that matches the fixed width fields.
+  size_t fixedWidthSize_{0};
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <queue>
 #include <type_traits>
@@ -293,6 +294,47 @@ void KllSketch<T, A, C>::insert(T value) {
   doInsert(value);
 }
 
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::insertBatch(folly::Range<const T*> values) {
+  if (values.empty()) {
+    return;
+  }
+  auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end(), C());
+  if (n_ == 0) {
+    minValue_ = *minIt;
+    maxValue_ = *maxIt;
+  } else {
+    minValue_ = std::min(minValue_, *minIt, C());
+    maxValue_ = std::max(maxValue_, *maxIt, C());
+  }
+
+  VELOX_DCHECK_GT(k_, 0);
+  VELOX_DCHECK_GE(levels_.size(), 2);
+  auto next = values.begin();
+  while (next != values.end()) {
+    const size_t remaining = values.end() - next;
+    size_t count;
+    if (items_.size() < k_ && numLevels() == 1) {
+      // Same as doInsert(): grow the only level up to k items.
+      count = std::min<size_t>(k_ - items_.size(), remaining);
+      items_.insert(items_.end(), next, next + count);
+      levels_[1] += count;
+    } else if (levels_[0] > 0) {
+      // Level zero is filled downwards from levels_[0]. Its order does not
+      // matter since it is sorted before being compacted or read.
+      count = std::min<size_t>(levels_[0], remaining);
+      levels_[0] -= count;
+      std::copy(next, next + count, items_.begin() + levels_[0]);
+    } else {
+      count = 1;
+      items_[insertPosition()] = *next;
+    }
+    next += count;
+    n_ += count;
+  }
+  isLevelZeroSorted_ = false;
+}
+
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::doInsert(T value) {
   VELOX_DCHECK_GT(k_, 0);
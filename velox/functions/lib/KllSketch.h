@@ -60,6 +60,11 @@ struct KllSketch {
   /// Add one new value to the sketch.
   void insert(T value);
 
+  /// Add a batch of values to the sketch.  Equivalent to calling insert() for
+  /// each value, but copies the values into the free space of level zero in
+  /// bulk and only compacts when that space runs out.
+  void insertBatch(folly::Range<const T*> values);
+
   /// Call this before serialization can optimize the space used.
   void compact();
 
@@ -16,8 +16,11 @@
 #include "velox/functions/lib/Re2Functions.h"
 
 #include <re2/re2.h>
+#include <cctype>
+#include <cstring>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "velox/expression/VectorWriters.h"
 
@@ -89,6 +92,14 @@ bool re2PartialMatch(StringView str, const RE2& re) {
   return RE2::PartialMatch(toStringPiece(str), re);
 }
 
+// Returns false if 'str' does not contain 'literal', in which case a pattern
+// that requires 'literal' does not match 'str'.
+bool containsLiteral(StringView str, const std::string& literal) {
+  return literal.empty() ||
+      std::string_view(str.data(), str.size()).find(literal) !=
+      std::string_view::npos;
+}
+
 bool re2Extract(
     FlatVector<StringView>& result,
     int row,
@@ -181,7 +192,9 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        literal_(requiredLiteral(
+            std::string_view(pattern.data(), pattern.size()))) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -200,12 +213,16 @@ class Re2MatchConstantPattern final : public VectorFunction {
     }
 
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      const auto str = toSearch->valueAt<StringView>(i);
+      result.set(i, containsLiteral(str, literal_) && Fn(str, re_));
     });
   }
 
  private:
   RE2 re_;
+  // A string that every match contains. Strings without it are rejected
+  // without running RE2.
+  const std::string literal_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -400,6 +417,17 @@ bool matchPrefixPattern(
       std::memcmp(input.data(), pattern.data(), length) == 0;
 }
 
+// Match any 'length' consecutive characters of string 'input' with the fixed
+// part of a substring pattern, which starts at 'pattern'.
+bool matchSubstringPattern(
+    StringView input,
+    StringView pattern,
+    vector_size_t length) {
+  return std::string_view(input.data(), input.size())
+             .find(std::string_view(pattern.data(), length)) !=
+      std::string_view::npos;
+}
+
 // Match the last 'length' characters of string 'input' and suffix pattern.
 bool matchSuffixPattern(
     StringView input,
@@ -432,6 +460,8 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
         return matchPrefixPattern(input, pattern_, reducedPatternLength_);
       case PatternKind::kSuffix:
         return matchSuffixPattern(input, pattern_, reducedPatternLength_);
+      case PatternKind::kSubstring:
+        return matchSubstringPattern(input, pattern_, reducedPatternLength_);
     }
   }
 
@@ -476,9 +506,13 @@ class LikeWithRe2 final : public VectorFunction {
   LikeWithRe2(StringView pattern, std::optional<char> escapeChar) {
     RE2::Options opt{RE2::Quiet};
     opt.set_dot_nl(true);
-    re_.emplace(
-        toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
-        opt);
+    const auto regex = likePatternToRe2(pattern, escapeChar, validPattern_);
+    re_.emplace(toStringPiece(regex), opt);
+    literal_ = requiredLiteral(regex);
+  }
+
+  bool match(StringView input) const {
+    return containsLiteral(input, literal_) && re2FullMatch(input, *re_);
   }
 
   void apply(
@@ -511,15 +545,15 @@ class LikeWithRe2 final : public VectorFunction {
     if (toSearch->isIdentityMapping()) {
       auto rawStrings = toSearch->data<StringView>();
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], *re_));
+        result.set(i, match(rawStrings[i]));
       });
       return;
     }
 
     if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), *re_);
+      bool matchResult = match(toSearch->valueAt<StringView>(0));
       context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, match); });
+          rows, [&](vector_size_t i) { result.set(i, matchResult); });
       return;
     }
 
@@ -532,6 +566,8 @@ class LikeWithRe2 final : public VectorFunction {
  private:
   std::optional<RE2> re_;
   bool validPattern_;
+  // A string that every match contains.
+  std::string literal_;
 };
 
 void re2ExtractAll(
@@ -852,6 +888,25 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   vector_size_t singleCharacterWildcardCount = 0;
   auto patternStr = pattern.data();
 
+  // A fixed pattern between runs of '%', e.g. '%foo%'.
+  if (patternLength > 2 && patternStr[0] == '%' &&
+      patternStr[patternLength - 1] == '%') {
+    vector_size_t begin = 0;
+    while (begin < patternLength && patternStr[begin] == '%') {
+      ++begin;
+    }
+    vector_size_t end = patternLength;
+    while (end > begin && patternStr[end - 1] == '%') {
+      --end;
+    }
+    if (begin < end &&
+        std::none_of(patternStr + begin, patternStr + end, [](char c) {
+          return c == '%' || c == '_';
+        })) {
+      return {PatternKind::kSubstring, end - begin};
+    }
+  }
+
   while (i < patternLength) {
     if (patternStr[i] == '%' || patternStr[i] == '_') {
       // Ensures that pattern has a single contiguous stream of wildcard
@@ -906,6 +961,162 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   return {PatternKind::kSuffix, patternLength - fixedPatternStart};
 }
 
+namespace {
+
+// Returns the position after the character class that starts at 'pos' in
+// 'pattern', or std::string_view::npos if the class is not closed.
+size_t skipCharacterClass(std::string_view pattern, size_t pos) {
+  ++pos;
+  if (pos < pattern.size() && pattern[pos] == '^') {
+    ++pos;
+  }
+  // A ']' first in the class is a literal.
+  if (pos < pattern.size() && pattern[pos] == ']') {
+    ++pos;
+  }
+  while (pos < pattern.size()) {
+    if (pattern[pos] == '\\') {
+      pos += 2;
+      continue;
+    }
+    if (pattern.substr(pos, 2) == "[:") {
+      const auto end = pattern.find(":]", pos + 2);
+      if (end != std::string_view::npos) {
+        pos = end + 2;
+        continue;
+      }
+    }
+    if (pattern[pos] == ']') {
+      return pos + 1;
+    }
+    ++pos;
+  }
+  return std::string_view::npos;
+}
+
+// Returns the position after the group that starts at 'pos' in 'pattern', or
+// std::string_view::npos if the group is not closed.
+size_t skipGroup(std::string_view pattern, size_t pos) {
+  int32_t depth = 0;
+  while (pos < pattern.size()) {
+    switch (pattern[pos]) {
+      case '\\':
+        pos += 2;
+        continue;
+      case '[':
+        pos = skipCharacterClass(pattern, pos);
+        if (pos == std::string_view::npos) {
+          return pos;
+        }
+        continue;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        if (--depth == 0) {
+          return pos + 1;
+        }
+        break;
+    }
+    ++pos;
+  }
+  return std::string_view::npos;
+}
+
+bool isQuantifier(char c) {
+  return c == '*' || c == '+' || c == '?' || c == '{';
+}
+
+} // namespace
+
+std::string requiredLiteral(std::string_view pattern) {
+  std::string longest;
+  std::string current;
+  const auto endLiteral = [&]() {
+    if (current.size() > longest.size()) {
+      longest = current;
+    }
+    current.clear();
+  };
+
+  size_t pos = 0;
+  while (pos < pattern.size()) {
+    const char c = pattern[pos];
+    // The literal character at 'pos', if any, and the position after it.
+    std::optional<char> literal;
+    size_t next = pos + 1;
+    switch (c) {
+      case '|':
+        return "";
+      case '(':
+        // Flags, e.g. (?i), change the meaning of what follows.
+        if (pattern.substr(pos, 2) == "(?" &&
+            pattern.substr(pos, 3) != "(?:" &&
+            pattern.substr(pos, 3) != "(?P") {
+          return "";
+        }
+        next = skipGroup(pattern, pos);
+        break;
+      case '[':
+        next = skipCharacterClass(pattern, pos);
+        break;
+      case '{':
+        next = pattern.find('}', pos);
+        if (next != std::string_view::npos) {
+          ++next;
+        }
+        break;
+      case '\\': {
+        if (pos + 1 == pattern.size()) {
+          return "";
+        }
+        const auto escaped = static_cast<unsigned char>(pattern[pos + 1]);
+        next = pos + 2;
+        if (escaped < 0x80 && std::ispunct(escaped)) {
+          literal = escaped;
+        } else if (!std::strchr("dDwWsSbBAz", escaped) || escaped == '\0') {
+          // Escapes that span more characters, e.g. \x41, \pL or \Q...\E.
+          return "";
+        }
+        break;
+      }
+      case '.':
+      case '^':
+      case '$':
+      case '*':
+      case '+':
+      case '?':
+        break;
+      default:
+        // Multi-byte UTF-8 characters are not split by a quantifier.
+        if (static_cast<unsigned char>(c) < 0x80) {
+          literal = c;
+        }
+    }
+    if (next == std::string_view::npos) {
+      return "";
+    }
+
+    if (literal.has_value()) {
+      // A quantifier applies to the literal before it. It is required only
+      // with '+', and the literal that follows may not be adjacent to it.
+      if (next < pattern.size() && isQuantifier(pattern[next])) {
+        if (pattern[next] == '+') {
+          current += *literal;
+        }
+        endLiteral();
+      } else {
+        current += *literal;
+      }
+    } else {
+      endLiteral();
+    }
+    pos = next;
+  }
+  endLiteral();
+  return longest;
+}
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -987,6 +1198,16 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       case PatternKind::kSuffix:
         return std::make_shared<OptimizedLikeWithMemcmp<PatternKind::kSuffix>>(
             pattern, reducedLength);
+      case PatternKind::kSubstring: {
+        // The fixed part follows the leading '%'s.
+        auto* begin = pattern.data();
+        while (*begin == '%') {
+          ++begin;
+        }
+        return std::make_shared<
+            OptimizedLikeWithMemcmp<PatternKind::kSubstring>>(
+            StringView(begin, reducedLength), reducedLength);
+      }
       default:
         return std::make_shared<LikeWithRe2>(pattern, escapeChar);
     }
@@ -39,6 +39,9 @@ enum class PatternKind {
   kPrefix,
   /// Fixed pattern preceded by one or more '%', such as '%foo', '%%%hello'.
   kSuffix,
+  /// Fixed pattern preceded and followed by one or more '%', such as '%foo%',
+  /// '%%hello%'.
+  kSubstring,
   /// Patterns which do not fit any of the above types, such as 'hello_world',
   /// '_presto%'.
   kGeneric,
@@ -96,11 +99,19 @@ std::shared_ptr<exec::VectorFunction> makeRe2Extract(
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 
 /// Return the pair {pattern kind, length of the fixed pattern} for fixed,
-/// prefix, and suffix patterns. Return the pair {pattern kind, number of '_'
-/// characters} for patterns with wildcard characters only. Return
+/// prefix, suffix and substring patterns. Return the pair {pattern kind, number
+/// of '_' characters} for patterns with wildcard characters only. Return
 /// {kGenericPattern, 0} for generic patterns).
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern);
 
+/// Returns the longest string that occurs in every string with a match of the
+/// RE2 'pattern', taken from the literal characters outside of groups,
+/// character classes and optional repetitions. Returns an empty string if
+/// there is no such literal or the pattern uses syntax that is not analyzed,
+/// e.g. alternation outside of groups or flags. A string that does not contain
+/// the literal cannot match, so it is rejected without running RE2.
+std::string requiredLiteral(std::string_view pattern);
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
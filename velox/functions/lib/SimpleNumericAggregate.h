@@ -23,6 +23,98 @@
 
 namespace facebook::velox::aggregate {
 
+/// The number of independent partial results kept by foldValues().
+constexpr int32_t kNumFoldLanes = 4;
+
+/// Combines 'size' consecutive 'values' into 'initialValue' with
+/// 'update(TData& result, TData value)', which must be commutative and
+/// associative and have 'initialValue' as its identity. The values are folded
+/// into kNumFoldLanes independent partial results that are combined at the
+/// end. This lets the compiler vectorize the loop and, for floating point
+/// sums, removes the dependency of each addition on the previous one.
+template <typename TData, typename TValue, typename Update>
+TData foldValues(
+    const TValue* values,
+    vector_size_t size,
+    TData initialValue,
+    Update update) {
+  TData partials[kNumFoldLanes];
+  std::fill(partials, partials + kNumFoldLanes, initialValue);
+  vector_size_t i = 0;
+  for (; i + kNumFoldLanes <= size; i += kNumFoldLanes) {
+    for (auto lane = 0; lane < kNumFoldLanes; ++lane) {
+      update(partials[lane], TData(values[i + lane]));
+    }
+  }
+  for (; i < size; ++i) {
+    update(partials[0], TData(values[i]));
+  }
+  for (auto lane = 1; lane < kNumFoldLanes; ++lane) {
+    update(partials[0], partials[lane]);
+  }
+  return partials[0];
+}
+
+/// Like foldValues() over the positions of flat 'values' that are selected in
+/// 'rows' and not null in 'nulls'. 'nulls' may be nullptr. Runs of 64 rows
+/// that are all selected and not null go through foldValues(), the other rows
+/// are folded one at a time. Booleans are bits, so these are folded as one
+/// true and one false value depending on which of the two occur, which
+/// requires 'update' to be idempotent as well, e.g. 'and', 'or', min and max.
+/// Sets 'numValues' to the number of values folded.
+template <typename TData, typename TValue, typename Update>
+TData foldSelectedValues(
+    const TValue* values,
+    const uint64_t* nulls,
+    const SelectivityVector& rows,
+    TData initialValue,
+    Update update,
+    vector_size_t& numValues) {
+  constexpr uint64_t kAllSet = ~0ULL;
+  TData result = initialValue;
+  numValues = 0;
+  const auto* selected = rows.asRange().bits();
+  if constexpr (std::is_same_v<TValue, bool>) {
+    const auto* valueBits = reinterpret_cast<const uint64_t*>(values);
+    vector_size_t numTrue = 0;
+    bits::forEachWord(rows.begin(), rows.end(), [&](auto index, auto mask) {
+      auto word = selected[index] & mask;
+      if (nulls) {
+        word &= nulls[index];
+      }
+      numValues += __builtin_popcountll(word);
+      numTrue += __builtin_popcountll(word & valueBits[index]);
+    });
+    if (numTrue > 0) {
+      update(result, TData(true));
+    }
+    if (numValues > numTrue) {
+      update(result, TData(false));
+    }
+    return result;
+  }
+  auto foldWord = [&](int32_t wordIndex, uint64_t mask) {
+    auto word = selected[wordIndex] & mask;
+    if (nulls) {
+      word &= nulls[wordIndex];
+    }
+    const auto* wordValues = values + wordIndex * 64;
+    if (word == kAllSet) {
+      update(result, foldValues(wordValues, 64, initialValue, update));
+      numValues += 64;
+      return;
+    }
+    numValues += __builtin_popcountll(word);
+    for (; word; word &= word - 1) {
+      update(result, TData(wordValues[__builtin_ctzll(word)]));
+    }
+  };
+  bits::forEachWord(rows.begin(), rows.end(), foldWord, [&](int32_t index) {
+    foldWord(index, kAllSet);
+  });
+  return result;
+}
+
 template <typename TInput, typename TAccumulator, typename TResult>
 class SimpleNumericAggregate : public exec::Aggregate {
  protected:
@@ -144,7 +236,9 @@ class SimpleNumericAggregate : public exec::Aggregate {
   // TAccumulator or TResult, which in most cases are the same, but for
   // sum(real) can differ. TValue is used to decode the update input 'args'.
   // It can be either TAccumulator or TInput, which is most cases are the same
-  // but for sum(real) can differ.
+  // but for sum(real) can differ. Flat input is folded with
+  // foldSelectedValues(), so 'updateSingleValue' must be commutative and
+  // associative with 'initialValue' as its identity.
   template <
       typename TData = TResult,
       typename TValue = TInput,
@@ -169,6 +263,20 @@ class SimpleNumericAggregate : public exec::Aggregate {
             rows.countSelected());
         updateNonNullValue<true, TData>(group, initialValue, updateSingleValue);
       }
+    } else if (decoded.isIdentityMapping()) {
+      // Flat values, with or without nulls, are folded into a local value
+      // that updates the group once.
+      vector_size_t numValues;
+      const auto result = foldSelectedValues(
+          decoded.data<TValue>(),
+          decoded.nulls(),
+          rows,
+          initialValue,
+          updateSingleValue,
+          numValues);
+      if (numValues > 0) {
+        updateNonNullValue<true, TData>(group, result, updateSingleValue);
+      }
     } else if (decoded.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
@@ -177,51 +285,116 @@ class SimpleNumericAggregate : public exec::Aggregate {
         updateNonNullValue<true, TData>(
             group, TData(decoded.valueAt<TValue>(i)), updateSingleValue);
       });
-    } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
-      auto data = decoded.data<TValue>();
+    } else {
       rows.applyToSelected([&](vector_size_t i) {
         updateNonNullValue<true, TData>(
-            group, TData(data[i]), updateSingleValue);
+            group, TData(decoded.valueAt<TValue>(i)), updateSingleValue);
       });
+    }
+  }
+
+  // Updates the dense accumulators of the groups in 'groupIds' with the values
+  // of 'arg'. The dense accumulators are allocated for 'numGroups' groups on
+  // first use and start out at 'initialValue'. TData and TValue are as in
+  // updateGroups(). If 'mayPushdown' is true and 'arg' is lazy, the values are
+  // added to the dense accumulators while the column is read.
+  template <
+      typename TData = TResult,
+      typename TValue = TInput,
+      typename UpdateSingleValue>
+  void updateDense(
+      const uint64_t* groupIds,
+      int32_t numGroups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateSingleValue updateSingleValue,
+      TData initialValue,
+      bool mayPushdown = false) {
+    ensureDenseCapacity<TData>(numGroups, initialValue);
+    auto* values = denseValues_->asMutable<TData>();
+    auto* hasValue = denseHasValue_->asMutable<uint64_t>();
+    if (mayPushdown && arg->isLazy()) {
+      loadWithHook(
+          rows,
+          arg,
+          groupIds,
+          pushdownCustomIndices_,
+          pushdownGroupIds_,
+          [&](const uint64_t* ids) {
+            return DenseHook<TValue, TData, UpdateSingleValue>(
+                ids, values, hasValue, updateSingleValue);
+          });
+      return;
+    }
+    auto update = [&](vector_size_t i, TData value) {
+      const auto groupId = groupIds[i];
+      VELOX_DCHECK_LT(groupId, numDenseGroups_);
+      updateSingleValue(values[groupId], value);
+      bits::setBit(hasValue, groupId);
+    };
+
+    DecodedVector decoded(*arg, rows);
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        const TData value(decoded.valueAt<TValue>(0));
+        rows.applyToSelected([&](vector_size_t i) { update(i, value); });
+      }
+    } else if (decoded.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          update(i, TData(decoded.valueAt<TValue>(i)));
+        }
+      });
+    } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
+      auto data = decoded.data<TValue>();
+      rows.applyToSelected([&](vector_size_t i) { update(i, TData(data[i])); });
     } else {
       rows.applyToSelected([&](vector_size_t i) {
-        updateNonNullValue<true, TData>(
-            group, TData(decoded.valueAt<TValue>(i)), updateSingleValue);
+        update(i, TData(decoded.valueAt<TValue>(i)));
       });
     }
   }
 
+  // Combines the dense accumulators that have a value into the accumulators
+  // of the corresponding rows of 'groups' and resets them to 'initialValue'.
+  template <typename TData = TResult, typename UpdateSingleValue>
+  void flushDense(
+      char* const* groups,
+      UpdateSingleValue updateSingleValue,
+      TData initialValue) {
+    if (!denseHasValue_) {
+      return;
+    }
+    auto* values = denseValues_->asMutable<TData>();
+    auto* hasValue = denseHasValue_->asMutable<uint64_t>();
+    bits::forEachSetBit(hasValue, 0, numDenseGroups_, [&](auto groupId) {
+      char* group = groups[groupId];
+      VELOX_DCHECK_NOT_NULL(group);
+      exec::Aggregate::clearNull(group);
+      updateSingleValue(
+          *exec::Aggregate::value<TData>(group), values[groupId]);
+      values[groupId] = initialValue;
+    });
+    bits::fillBits(hasValue, 0, numDenseGroups_, false);
+  }
+
   template <typename THook>
   void
   pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
-    DecodedVector decoded(*arg, rows, false);
-    const vector_size_t* indices = decoded.indices();
-    THook hook(
-        exec::Aggregate::offset_,
-        exec::Aggregate::nullByte_,
-        exec::Aggregate::nullMask_,
+    loadWithHook(
+        rows,
+        arg,
         groups,
-        &this->exec::Aggregate::numNulls_);
-    // The decoded vector does not really keep the info from the 'rows', except
-    // for the 'upper bound' of it. In case not all rows are selected we need to
-    // generate proper indices, which we 'indirect' through the ones we got from
-    // the decoded vector.
-    vector_size_t numIndices{arg->size()};
-    if (not rows.isAllSelected()) {
-      const auto numSelected = rows.countSelected();
-      if (numSelected != arg->size()) {
-        pushdownCustomIndices_.resize(numSelected);
-        vector_size_t tgtIndex{0};
-        rows.template applyToSelected([&](vector_size_t i) {
-          pushdownCustomIndices_[tgtIndex++] = indices[i];
+        pushdownCustomIndices_,
+        pushdownGroups_,
+        [&](char** rowGroups) {
+          return THook(
+              exec::Aggregate::offset_,
+              exec::Aggregate::nullByte_,
+              exec::Aggregate::nullMask_,
+              rowGroups,
+              &this->exec::Aggregate::numNulls_);
         });
-        indices = pushdownCustomIndices_.data();
-        numIndices = numSelected;
-      }
-    }
-
-    decoded.base()->as<const LazyVector>()->load(
-        RowSet(indices, numIndices), &hook);
   }
 
  private:
@@ -238,6 +411,35 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
     updateValue(*exec::Aggregate::value<TDataType>(group), value);
   }
+
+  template <typename TData>
+  void ensureDenseCapacity(int32_t numGroups, TData initialValue) {
+    if (numGroups <= numDenseGroups_) {
+      return;
+    }
+    if (!denseValues_) {
+      auto* pool = exec::Aggregate::allocator_->pool();
+      denseValues_ =
+          AlignedBuffer::allocate<TData>(numGroups, pool, initialValue);
+      denseHasValue_ = AlignedBuffer::allocate<bool>(numGroups, pool, false);
+    } else {
+      AlignedBuffer::reallocate<TData>(&denseValues_, numGroups, initialValue);
+      AlignedBuffer::reallocate<bool>(&denseHasValue_, numGroups, false);
+    }
+    numDenseGroups_ = numGroups;
+  }
+
+  // The accumulators updated by updateDense(), indexed by group ID, and a bit
+  // per group ID that is set if the accumulator has received a value since
+  // the last flushDense().
+  BufferPtr denseValues_;
+  BufferPtr denseHasValue_;
+  int32_t numDenseGroups_{0};
+
+  // The groups and group IDs of the selected rows in pushdown when not all
+  // rows are selected.
+  std::vector<char*> pushdownGroups_;
+  std::vector<uint64_t> pushdownGroupIds_;
 };
 
 } // namespace facebook::velox::aggregate
@@ -20,6 +20,7 @@
 #include "velox/external/date/tz.h"
 #include "velox/functions/Macros.h"
 #include "velox/type/Date.h"
+#include "velox/type/tz/TimeZoneOffsetCache.h"
 
 namespace facebook::velox::functions {
 namespace {
@@ -46,11 +47,16 @@ getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
     return timestamp.getSeconds();
   }
 }
-} // namespace
 
-FOLLY_ALWAYS_INLINE
-std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
-  int64_t seconds = getSeconds(timestamp, timeZone);
+FOLLY_ALWAYS_INLINE int64_t
+getSeconds(Timestamp timestamp, util::TimeZoneOffsetCache& timeZone) {
+  if (timeZone.zone() != nullptr) {
+    timeZone.toTimezone(timestamp);
+  }
+  return timestamp.getSeconds();
+}
+
+FOLLY_ALWAYS_INLINE std::tm toDateTime(int64_t seconds) {
   std::tm dateTime;
   VELOX_USER_CHECK_NOT_NULL(
       gmtime_r((const time_t*)&seconds, &dateTime),
@@ -58,6 +64,31 @@ std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
       seconds);
   return dateTime;
 }
+} // namespace
+
+FOLLY_ALWAYS_INLINE
+std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
+  return toDateTime(getSeconds(timestamp, timeZone));
+}
+
+FOLLY_ALWAYS_INLINE
+std::tm getDateTime(Timestamp timestamp, util::TimeZoneOffsetCache& timeZone) {
+  return toDateTime(getSeconds(timestamp, timeZone));
+}
+
+/// Returns the seconds since midnight of 'seconds' since epoch. Same as the
+/// time of day of getDateTime() without the conversion to a calendar date.
+FOLLY_ALWAYS_INLINE int64_t getSecondOfDay(int64_t seconds) {
+  // Years this far from the epoch do not fit in std::tm. Keeps the error of
+  // getDateTime() for them.
+  constexpr int64_t kMaxSeconds = 10'000'000'000'000'000;
+  if (FOLLY_UNLIKELY(seconds >= kMaxSeconds || seconds <= -kMaxSeconds)) {
+    const auto dateTime = toDateTime(seconds);
+    return dateTime.tm_hour * 3'600 + dateTime.tm_min * 60 + dateTime.tm_sec;
+  }
+  const auto secondOfDay = seconds % kSecondsInDay;
+  return secondOfDay < 0 ? secondOfDay + kSecondsInDay : secondOfDay;
+}
 
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
@@ -73,12 +104,12 @@ std::tm getDateTime(Date date) {
 template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
-  const date::time_zone* timeZone_{nullptr};
+  util::TimeZoneOffsetCache timeZone_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Timestamp>* /*timestamp*/) {
-    timeZone_ = getTimeZoneFromConfig(config);
+    timeZone_ = util::TimeZoneOffsetCache(getTimeZoneFromConfig(config));
   }
 };
 } // namespace facebook::velox::functions
@@ -20,6 +20,7 @@
 #include <string_view>
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -44,16 +45,32 @@
 namespace facebook::velox::functions {
 namespace stringCore {
 
+/// Returns the number of leading ASCII bytes of 'str'. Checks a SIMD batch of
+/// bytes at a time.
+FOLLY_ALWAYS_INLINE size_t asciiPrefixLength(const char* str, size_t length) {
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  for (; i + Batch::size <= length; i += Batch::size) {
+    const auto nonAscii = simd::toBitMask(
+        Batch::load_unaligned(reinterpret_cast<const int8_t*>(str + i)) <
+        Batch(0));
+    if (nonAscii) {
+      return i + __builtin_ctz(nonAscii);
+    }
+  }
+  for (; i < length; ++i) {
+    if (str[i] & 0x80) {
+      return i;
+    }
+  }
+  return length;
+}
+
 /// Check if a given string is ascii
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
-    if (str[i] & 0x80) {
-      return false;
-    }
-  }
-  return true;
+  return asciiPrefixLength(str, length) == length;
 }
 
 /// Perform reverse for ascii string input
@@ -68,6 +85,10 @@ reverseAscii(char* output, const char* input, size_t length) {
 /// Perform reverse for utf8 string input
 FOLLY_ALWAYS_INLINE static void
 reverseUnicode(char* output, const char* input, size_t length) {
+  if (isAscii(input, length)) {
+    reverseAscii(output, input, length);
+    return;
+  }
   auto inputIdx = 0;
   auto outputIdx = length;
   while (inputIdx < length) {
@@ -126,6 +147,16 @@ FOLLY_ALWAYS_INLINE size_t upperUnicode(
   auto outputIdx = 0;
 
   while (inputIdx < inputLength) {
+    // Converts the ASCII characters up to the next multi-byte one together.
+    const auto numAscii =
+        asciiPrefixLength(&input[inputIdx], inputLength - inputIdx);
+    upperAscii(&output[outputIdx], &input[inputIdx], numAscii);
+    inputIdx += numAscii;
+    outputIdx += numAscii;
+    if (inputIdx == inputLength) {
+      break;
+    }
+
     utf8proc_int32_t nextCodePoint;
     int size;
     nextCodePoint =
@@ -166,6 +197,16 @@ FOLLY_ALWAYS_INLINE size_t lowerUnicode(
   auto outputIdx = 0;
 
   while (inputIdx < inputLength) {
+    // Converts the ASCII characters up to the next multi-byte one together.
+    const auto numAscii =
+        asciiPrefixLength(&input[inputIdx], inputLength - inputIdx);
+    lowerAscii(&output[outputIdx], &input[inputIdx], numAscii);
+    inputIdx += numAscii;
+    outputIdx += numAscii;
+    if (inputIdx == inputLength) {
+      break;
+    }
+
     utf8proc_int32_t nextCodePoint;
     int size;
     nextCodePoint =
@@ -222,6 +263,14 @@ lengthUnicode(const char* inputBuffer, size_t bufferLength) {
   auto currentChar = inputBuffer;
   int64_t size = 0;
   while (currentChar < buffEndAddress) {
+    // Each ASCII byte is a character.
+    const auto numAscii =
+        asciiPrefixLength(currentChar, buffEndAddress - currentChar);
+    currentChar += numAscii;
+    size += numAscii;
+    if (currentChar >= buffEndAddress) {
+      break;
+    }
     auto chrOffset = utf8proc_char_length(currentChar);
     // Skip bad byte if we get utf length < 0.
     currentChar += UNLIKELY(chrOffset < 0) ? 1 : chrOffset;
@@ -421,17 +470,31 @@ getByteRange(const char* str, size_t startCharPosition, size_t length) {
     size_t startByteIndex = 0;
     size_t nextCharOffset = 0;
 
-    // Find startByteIndex
-    for (auto i = 0; i < startCharPosition - 1; i++) {
-      nextCharOffset += utf8proc_char_length(&str[nextCharOffset]);
-    }
+    // Skips 'numChars' characters from 'nextCharOffset'. The string has at
+    // least 'numChars' more bytes, so whole batches of ASCII bytes are
+    // skipped without reading past its end.
+    auto skipChars = [&](size_t numChars) {
+      using Batch = xsimd::batch<int8_t>;
+      while (numChars > 0) {
+        if (numChars >= Batch::size &&
+            simd::toBitMask(
+                Batch::load_unaligned(reinterpret_cast<const int8_t*>(
+                    str + nextCharOffset)) < Batch(0)) == 0) {
+          nextCharOffset += Batch::size;
+          numChars -= Batch::size;
+          continue;
+        }
+        nextCharOffset += utf8proc_char_length(&str[nextCharOffset]);
+        --numChars;
+      }
+    };
 
+    // Find startByteIndex
+    skipChars(startCharPosition - 1);
     startByteIndex = nextCharOffset;
 
     // Find endByteIndex
-    for (auto i = 0; i < length; i++) {
-      nextCharOffset += utf8proc_char_length(&str[nextCharOffset]);
-    }
+    skipChars(length);
 
     return std::make_pair(startByteIndex, nextCharOffset);
   }
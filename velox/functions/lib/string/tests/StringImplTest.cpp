@@ -399,6 +399,46 @@ TEST_F(StringImplTest, getByteRange) {
   }
 }
 
+// Checks the kernels on strings with ASCII runs longer than a SIMD batch
+// around multi-byte characters.
+TEST_F(StringImplTest, longMixedStrings) {
+  const std::string ascii = "the quick brown fox jumps over the lazy dog 01";
+  const std::string asciiUpper =
+      "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 01";
+  const std::string input = ascii + "\u00E4\u00F6" + ascii + "\u4F60" + ascii;
+  const std::string inputUpper =
+      asciiUpper + "\u00C4\u00D6" + asciiUpper + "\u4F60" + asciiUpper;
+  const auto numChars = 3 * ascii.size() + 3;
+
+  EXPECT_EQ(asciiPrefixLength(input.data(), input.size()), ascii.size());
+  EXPECT_EQ(asciiPrefixLength(ascii.data(), ascii.size()), ascii.size());
+  EXPECT_EQ(asciiPrefixLength(ascii.data(), 5), 5);
+  EXPECT_FALSE(isAscii(input.data(), input.size()));
+  EXPECT_TRUE(isAscii(ascii.data(), ascii.size()));
+
+  EXPECT_EQ(length</*isAscii*/ false>(input), numChars);
+
+  std::string output;
+  upper</*ascii*/ false>(output, input);
+  EXPECT_EQ(output, inputUpper);
+  lower</*ascii*/ false>(output, inputUpper);
+  EXPECT_EQ(output, input);
+
+  // The second copy of 'ascii' starts after the two 2-byte characters.
+  auto range = getByteRange</*isAscii*/ false>(
+      input.data(), ascii.size() + 3, ascii.size());
+  EXPECT_EQ(range.first, ascii.size() + 4);
+  EXPECT_EQ(range.second, 2 * ascii.size() + 4);
+
+  range = getByteRange</*isAscii*/ false>(input.data(), 1, numChars);
+  EXPECT_EQ(range.first, 0);
+  EXPECT_EQ(range.second, input.size());
+
+  output.resize(ascii.size());
+  reverseUnicode(output.data(), ascii.data(), ascii.size());
+  EXPECT_EQ(output, std::string(ascii.rbegin(), ascii.rend()));
+}
+
 TEST_F(StringImplTest, pad) {
   auto runTest = [](const std::string& string,
                     const int64_t size,
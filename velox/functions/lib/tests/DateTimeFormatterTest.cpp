@@ -1359,6 +1359,45 @@ TEST_F(JodaDateTimeFormatterTest, parseConsecutiveSpecifiers) {
   EXPECT_THROW(parseJoda("12312", "yyH"), VeloxUserError);
 }
 
+TEST_F(JodaDateTimeFormatterTest, parseFixedWidth) {
+  // Inputs that match a format of fixed width fields exactly are parsed at
+  // fixed offsets, the others by the general path. Both give the same
+  // results.
+  EXPECT_EQ(
+      util::fromTimestampString("2019-07-03 11:04:10.123"),
+      parseJoda("2019-07-03 11:04:10.123", "yyyy-MM-dd HH:mm:ss.SSS")
+          .timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2019-07-03 11:04:10"),
+      parseJoda("2019-7-3 11:04:10", "yyyy-MM-dd HH:mm:ss").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2019-07-03 11:04:10"),
+      parseJoda("11:04:10 03/07/2019", "HH:mm:ss dd/MM/YYYY").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2020-02-29"),
+      parseJoda("20200229", "yyyyMMdd").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2000-07-03"),
+      parseJoda("07-03", "MM-dd").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("1970-01-01 11:04:00"),
+      parseJoda("11:04", "HH:mm").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2019-07-03 11:04:10.120"),
+      parseMysql("2019-07-03 11:04:10.120999", "%Y-%m-%d %H:%i:%s.%f"));
+
+  // Out of range values and inputs that do not match the format fail with
+  // the errors of the general path.
+  EXPECT_THROW(parseJoda("2019-13-03", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2019-02-29", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("0000-01-01", "YYYY-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("24:00", "HH:mm"), VeloxUserError);
+  EXPECT_THROW(parseJoda("12:60", "HH:mm"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2019/07/03", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2019-07-03 ", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2019-0a-03", "yyyy-MM-dd"), VeloxUserError);
+}
+
 class MysqlDateTimeTest : public DateTimeFormatterTest {};
 
 TEST_F(MysqlDateTimeTest, validBuild) {
@@ -1803,6 +1842,18 @@ TEST_F(MysqlDateTimeTest, formatCompositeTime) {
       "23:59:59");
 }
 
+TEST_F(MysqlDateTimeTest, formatIntoBuffer) {
+  auto* timezone = date::locate_zone("GMT");
+  auto formatter = buildMysqlDateTimeFormatter("%W %M %d %Y %H:%i:%s.%f");
+  const auto timestamp = util::fromTimestampString("2019-09-04 01:02:03.456");
+  std::string buffer(formatter->maxResultSize(timezone), 'x');
+  const auto size = formatter->format(timestamp, timezone, buffer.data());
+  EXPECT_EQ(
+      std::string_view(buffer.data(), size),
+      "Wednesday September 04 2019 01:02:03.456000");
+  EXPECT_EQ(formatter->format(timestamp, timezone), buffer.substr(0, size));
+}
+
 // Same semantic as YEAR_OF_ERA, except that it accepts zero and negative years.
 TEST_F(MysqlDateTimeTest, parseFourDigitYear) {
   EXPECT_EQ(util::fromTimestampString("123-01-01"), parseMysql("123", "%Y"));
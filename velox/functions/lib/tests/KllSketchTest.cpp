@@ -122,6 +122,42 @@ TEST(KllSketchTest, randomInput) {
   }
 }
 
+TEST(KllSketchTest, insertBatch) {
+  constexpr int N = 1e5;
+  constexpr int M = 1001;
+  std::default_random_engine gen(0);
+  std::normal_distribution<> dist;
+  std::vector<double> values(N);
+  for (auto& v : values) {
+    v = dist(gen);
+  }
+
+  // The same seed and the same values give the same sketch, whether inserted
+  // one at a time or in batches of different sizes.
+  KllSketch<double> expected(kDefaultK, {}, 0);
+  for (auto v : values) {
+    expected.insert(v);
+  }
+  KllSketch<double> kll(kDefaultK, {}, 0);
+  const std::vector<int> batchSizes = {1, 7, 333, 1'024, 5'000};
+  for (int i = 0, j = 0; i < N; ++j) {
+    auto size = std::min(batchSizes[j % batchSizes.size()], N - i);
+    kll.insertBatch(folly::Range<const double*>(values.data() + i, size));
+    i += size;
+  }
+  kll.insertBatch({});
+  EXPECT_EQ(kll.totalCount(), N);
+
+  expected.finish();
+  kll.finish();
+  auto q = linspace(M);
+  EXPECT_EQ(
+      kll.estimateQuantiles(folly::Range(q.begin(), q.end())),
+      expected.estimateQuantiles(folly::Range(q.begin(), q.end())));
+  EXPECT_EQ(kll.estimateQuantile(0.0), expected.estimateQuantile(0.0));
+  EXPECT_EQ(kll.estimateQuantile(1.0), expected.estimateQuantile(1.0));
+}
+
 TEST(KllSketchTest, merge) {
   constexpr int N = 1e4;
   constexpr int M = 1001;
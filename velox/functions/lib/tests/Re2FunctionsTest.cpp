@@ -439,6 +439,52 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("%%_%aBcD", PatternKind::kGeneric, 0);
   testPattern("%%a%%BcD", PatternKind::kGeneric, 0);
   testPattern("foo%bar", PatternKind::kGeneric, 0);
+
+  testPattern("%presto%", PatternKind::kSubstring, 6);
+  testPattern("%%hello%%%", PatternKind::kSubstring, 5);
+  testPattern("%a%", PatternKind::kSubstring, 1);
+  testPattern("%a_b%", PatternKind::kGeneric, 0);
+  testPattern("%a%b%", PatternKind::kGeneric, 0);
+  testPattern("%_a%", PatternKind::kGeneric, 0);
+}
+
+TEST_F(Re2FunctionsTest, requiredLiteral) {
+  EXPECT_EQ(requiredLiteral("abc"), "abc");
+  EXPECT_EQ(requiredLiteral(".*error: [0-9]+ at .*"), "error: ");
+  EXPECT_EQ(requiredLiteral("^GET /admin/[a-z]+\\.php$"), "GET /admin/");
+  EXPECT_EQ(requiredLiteral("ab?cd"), "cd");
+  EXPECT_EQ(requiredLiteral("xa+bc"), "xa");
+  EXPECT_EQ(requiredLiteral("ab{2}c"), "a");
+  EXPECT_EQ(requiredLiteral("a(b|c)*de"), "de");
+  EXPECT_EQ(requiredLiteral("user\\.name[[:alpha:]]x"), "user.name");
+  EXPECT_EQ(requiredLiteral("\\d+ms"), "ms");
+  EXPECT_EQ(requiredLiteral("^\\Qa.b\\E$"), "");
+  EXPECT_EQ(requiredLiteral("a\\x41"), "");
+  EXPECT_EQ(requiredLiteral("foo|bar"), "");
+  EXPECT_EQ(requiredLiteral("(?i)foo"), "");
+  EXPECT_EQ(requiredLiteral("(?:foo)bar"), "bar");
+  EXPECT_EQ(requiredLiteral(".*"), "");
+  EXPECT_EQ(requiredLiteral("[abc"), "");
+
+  // Strings without the literal are rejected before RE2 runs. The results
+  // match those of RE2 alone.
+  auto data = makeRowVector({makeFlatVector<std::string>({
+      "GET /admin/index.php",
+      "GET /admin/1.php",
+      "POST /admin/index.php",
+      "get /admin/index.php",
+      "",
+      "error: 42 at main",
+  })});
+  assertEqualVectors(
+      makeFlatVector<bool>({true, false, false, false, false, false}),
+      evaluate("re2_search(c0, 'GET /admin/[a-z]+\\.php')", data));
+  assertEqualVectors(
+      makeFlatVector<bool>({false, false, false, false, false, true}),
+      evaluate("re2_match(c0, '.*: [0-9]+ at .*')", data));
+  assertEqualVectors(
+      makeFlatVector<bool>({true, true, false, false, false, false}),
+      evaluate("like(c0, 'GET%/_%.php')", data));
 }
 
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
@@ -592,6 +638,34 @@ TEST_F(Re2FunctionsTest, likePatternSuffix) {
   EXPECT_TRUE(like(input, generateString(kAnyWildcardCharacter) + input));
 }
 
+TEST_F(Re2FunctionsTest, likePatternSubstring) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%abcde%"));
+  EXPECT_TRUE(like("abcde", "%bcd%"));
+  EXPECT_TRUE(like("abcde", "%%a%"));
+  EXPECT_TRUE(like("abcde", "%e%%"));
+  EXPECT_TRUE(like("
+abc
+de
+", "%c
+d%"));
+  EXPECT_FALSE(like("", "%a%"));
+  EXPECT_FALSE(like("abcde", "%bd%"));
+  EXPECT_FALSE(like("abcde", "%abcdef%"));
+  EXPECT_FALSE(like("ABCDE", "%bcd%"));
+
+  // Longer than the inline part of StringView.
+  std::string input = generateString(kLikePatternCharacterSet, 65);
+  EXPECT_TRUE(like(input, "%" + input.substr(10, 20) + "%"));
+  EXPECT_TRUE(like("xx" + input + "yy", "%%" + input + "%"));
+}
+
 TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   auto like = ([&](std::optional<std::string> str,
                    std::optional<std::string> pattern,
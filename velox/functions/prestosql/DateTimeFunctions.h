@@ -399,7 +399,7 @@ struct HourFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_hour;
+    result = getSecondOfDay(getSeconds(timestamp, this->timeZone_)) / 3'600;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -410,7 +410,7 @@ struct HourFunction : public InitSessionTimezone<T>,
       int64_t& result,
       const arg_type<TimestampWithTimezone>& timestampWithTimezone) {
     auto timestamp = this->toTimestamp(timestampWithTimezone);
-    result = getDateTime(timestamp, nullptr).tm_hour;
+    result = getSecondOfDay(timestamp.getSeconds()) / 3'600;
   }
 };
 
@@ -422,7 +422,7 @@ struct MinuteFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_min;
+    result = getSecondOfDay(getSeconds(timestamp, this->timeZone_)) / 60 % 60;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -433,7 +433,7 @@ struct MinuteFunction : public InitSessionTimezone<T>,
       int64_t& result,
       const arg_type<TimestampWithTimezone>& timestampWithTimezone) {
     auto timestamp = this->toTimestamp(timestampWithTimezone);
-    result = getDateTime(timestamp, nullptr).tm_min;
+    result = getSecondOfDay(timestamp.getSeconds()) / 60 % 60;
   }
 };
 
@@ -444,7 +444,7 @@ struct SecondFunction : public TimestampWithTimezoneSupport<T> {
   FOLLY_ALWAYS_INLINE void call(
       int64_t& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, nullptr).tm_sec;
+    result = getSecondOfDay(timestamp.getSeconds()) % 60;
   }
 
   FOLLY_ALWAYS_INLINE void call(int64_t& result, const arg_type<Date>& date) {
@@ -455,7 +455,7 @@ struct SecondFunction : public TimestampWithTimezoneSupport<T> {
       int64_t& result,
       const arg_type<TimestampWithTimezone>& timestampWithTimezone) {
     auto timestamp = this->toTimestamp(timestampWithTimezone);
-    result = getDateTime(timestamp, nullptr).tm_sec;
+    result = getSecondOfDay(timestamp.getSeconds()) % 60;
   }
 };
 
@@ -570,14 +570,14 @@ template <typename T>
 struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* timeZone_ = nullptr;
+  util::TimeZoneOffsetCache timeZone_;
   std::optional<DateTimeUnit> unit_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Varchar>* unitString,
       const arg_type<Timestamp>* /*timestamp*/) {
-    timeZone_ = getTimeZoneFromConfig(config);
+    timeZone_ = util::TimeZoneOffsetCache(getTimeZoneFromConfig(config));
 
     if (unitString != nullptr) {
       unit_ = getTimestampUnit(*unitString);
@@ -646,12 +646,32 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
       return;
     }
 
-    auto dateTime = getDateTime(timestamp, timeZone_);
-    adjustDateTime(dateTime, unit);
-
-    result = Timestamp(timegm(&dateTime), 0);
-    if (timeZone_ != nullptr) {
-      result.toGMT(*timeZone_);
+    // Units of fixed length are truncated without the conversion to and
+    // from a calendar date.
+    int64_t unitSeconds = 0;
+    switch (unit) {
+      case DateTimeUnit::kMinute:
+        unitSeconds = 60;
+        break;
+      case DateTimeUnit::kHour:
+        unitSeconds = 3'600;
+        break;
+      case DateTimeUnit::kDay:
+        unitSeconds = kSecondsInDay;
+        break;
+      default:
+        break;
+    }
+    if (unitSeconds > 0) {
+      const auto seconds = getSeconds(timestamp, timeZone_);
+      result = Timestamp(seconds - getSecondOfDay(seconds) % unitSeconds, 0);
+    } else {
+      auto dateTime = getDateTime(timestamp, timeZone_);
+      adjustDateTime(dateTime, unit);
+      result = Timestamp(timegm(&dateTime), 0);
+    }
+    if (timeZone_.zone() != nullptr) {
+      timeZone_.toGMT(result);
     }
   }
 
@@ -905,12 +925,9 @@ struct DateFormatFunction : public TimestampWithTimezoneSupport<T> {
           std::string_view(formatString.data(), formatString.size()));
     }
 
-    auto formattedResult = mysqlDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    result.resize(mysqlDateTime_->maxResultSize(sessionTimeZone_));
+    result.resize(
+        mysqlDateTime_->format(timestamp, sessionTimeZone_, result.data()));
     return true;
   }
 
@@ -997,12 +1014,9 @@ struct FormatDateTimeFunction {
           std::string_view(formatString.data(), formatString.size()));
     }
 
-    auto formattedResult = jodaDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    result.resize(jodaDateTime_->maxResultSize(sessionTimeZone_));
+    result.resize(
+        jodaDateTime_->format(timestamp, sessionTimeZone_, result.data()));
     return true;
   }
 };
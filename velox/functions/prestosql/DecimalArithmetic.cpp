@@ -163,14 +163,10 @@ class Addition {
   {
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (DecimalUtil::rescaleWithOverflow(
+            a.unscaledValue(), aRescale, aRescaled) ||
+        DecimalUtil::rescaleWithOverflow(
+            b.unscaledValue(), bRescale, bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} + {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -209,14 +205,10 @@ class Subtraction {
   {
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (DecimalUtil::rescaleWithOverflow(
+            a.unscaledValue(), aRescale, aRescaled) ||
+        DecimalUtil::rescaleWithOverflow(
+            b.unscaledValue(), bRescale, bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} - {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -243,9 +235,27 @@ class Multiply {
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale) {
-    r = checkedMultiply<R>(
-        checkedMultiply<R>(R(a), R(b)),
-        R(DecimalUtil::kPowersOfTen[aRescale + bRescale]));
+    int128_t product;
+    if (UNLIKELY(
+            DecimalUtil::multiplyWithOverflow(
+                a.unscaledValue(), b.unscaledValue(), product) ||
+            !DecimalUtil::valueInRange<R>(product))) {
+      VELOX_ARITHMETIC_ERROR(
+          "Decimal overflow: {} * {}", a.unscaledValue(), b.unscaledValue());
+    }
+    const auto rescale = aRescale + bRescale;
+    if (rescale > 0) {
+      const auto unrescaled = product;
+      if (UNLIKELY(
+              DecimalUtil::rescaleWithOverflow(unrescaled, rescale, product) ||
+              !DecimalUtil::valueInRange<R>(product))) {
+        VELOX_ARITHMETIC_ERROR(
+            "Decimal overflow: {} * {}",
+            unrescaled,
+            DecimalUtil::kPowersOfTen[rescale]);
+      }
+    }
+    r = R(product);
   }
 
   inline static uint8_t
@@ -267,7 +277,10 @@ class Divide {
   template <typename R, typename A, typename B>
   inline static void
   apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t /*bRescale*/) {
-    DecimalUtil::divideWithRoundUp<R, A, B>(r, a, b, false, aRescale, 0);
+    int128_t quotient;
+    DecimalUtil::divideUnscaledWithRoundUp<R>(
+        quotient, a.unscaledValue(), b.unscaledValue(), false, aRescale);
+    r = R(quotient);
   }
 
   inline static uint8_t
@@ -291,10 +304,14 @@ class Round {
   template <typename R, typename A>
   inline static void apply(R& r, const A& a, uint8_t aRescale) {
     // aRescale holds the scale of the input.
-    auto temp = a;
-    DecimalUtil::divideWithRoundUp<A, A, int128_t>(
-        temp, a, DecimalUtil::kPowersOfTen[aRescale], false, 0, 0);
-    r = R(temp.unscaledValue());
+    int128_t rounded;
+    DecimalUtil::divideUnscaledWithRoundUp<A>(
+        rounded,
+        a.unscaledValue(),
+        DecimalUtil::kPowersOfTen[aRescale],
+        false,
+        0);
+    r = R(rounded);
   }
 
   inline static uint8_t computeRescaleFactor(
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 
 namespace facebook::velox::functions {
@@ -116,6 +117,94 @@ class JsonParseFunction : public exec::VectorFunction {
   }
 };
 
+// $internal$json_extract_scalars(json, paths) -> row(varchar, ...)
+// Extracts the scalar values at several JSON paths, given as the VARCHAR
+// fields of the constant ROW 'paths', into the fields of a ROW of the same
+// type. json_extract_scalar calls with constant paths on the same input are
+// rewritten by the ExprCompiler to read the fields of one call to this
+// function, so that each document is scanned once for all of them.
+class JsonExtractScalarsFunction : public exec::VectorFunction {
+ public:
+  explicit JsonExtractScalarsFunction(const std::vector<std::string>& paths)
+      : extractor_(paths) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    const auto numPaths = extractor_.numPaths();
+    std::vector<VectorPtr> fields(numPaths);
+    std::vector<FlatVector<StringView>*> flatFields(numPaths);
+    for (auto i = 0; i < numPaths; ++i) {
+      fields[i] = BaseVector::create(VARCHAR(), rows.end(), context.pool());
+      flatFields[i] = fields[i]->asFlatVector<StringView>();
+    }
+
+    exec::LocalDecodedVector decodedJson(context, *args[0], rows);
+    std::vector<folly::Optional<std::string>> values;
+    context.applyToSelectedNoThrow(rows, [&](auto row) {
+      extractor_.extractScalars(
+          decodedJson->valueAt<StringView>(row), values);
+      for (auto i = 0; i < numPaths; ++i) {
+        if (values[i].hasValue()) {
+          flatFields[i]->set(row, StringView(*values[i]));
+        } else {
+          flatFields[i]->setNull(row, true);
+        }
+      }
+    });
+
+    VectorPtr localResult = std::make_shared<RowVector>(
+        context.pool(), outputType, nullptr, rows.end(), std::move(fields));
+    context.moveOrCopyResult(localResult, rows, result);
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // json, T -> T
+    return {exec::FunctionSignatureBuilder()
+                .typeVariable("T")
+                .returnType("T")
+                .argumentType("json")
+                .argumentType("T")
+                .build()};
+  }
+
+  // Returns nullptr if the paths are not a constant ROW of non-null VARCHARs
+  // or any of them is invalid. The ExprCompiler then leaves the
+  // json_extract_scalar calls as they are, so that an invalid path fails only
+  // where json_extract_scalar would.
+  static std::shared_ptr<exec::VectorFunction> create(
+      const std::string& /* name */,
+      const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    VELOX_CHECK_EQ(inputArgs.size(), 2);
+    const auto& constantPaths = inputArgs[1].constantValue;
+    if (!constantPaths || constantPaths->typeKind() != TypeKind::ROW ||
+        constantPaths->isNullAt(0)) {
+      return nullptr;
+    }
+    const auto* paths = constantPaths->wrappedVector()->as<RowVector>();
+    const auto index = constantPaths->wrappedIndex(0);
+    std::vector<std::string> pathStrings;
+    for (const auto& path : paths->children()) {
+      if (path->typeKind() != TypeKind::VARCHAR || path->isNullAt(index)) {
+        return nullptr;
+      }
+      pathStrings.push_back(
+          path->as<SimpleVector<StringView>>()->valueAt(index).str());
+    }
+    try {
+      return std::make_shared<JsonExtractScalarsFunction>(pathStrings);
+    } catch (const VeloxUserError&) {
+      return nullptr;
+    }
+  }
+
+ private:
+  const JsonMultiPathExtractor extractor_;
+};
+
 } // namespace
 
 VELOX_DECLARE_VECTOR_FUNCTION(
@@ -127,4 +216,9 @@ VELOX_DECLARE_VECTOR_FUNCTION(
     udf_json_parse,
     JsonParseFunction::signatures(),
     std::make_unique<JsonParseFunction>());
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_json_extract_scalars,
+    JsonExtractScalarsFunction::signatures(),
+    JsonExtractScalarsFunction::create);
 } // namespace facebook::velox::functions
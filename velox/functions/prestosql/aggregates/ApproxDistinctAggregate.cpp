@@ -54,6 +54,16 @@ struct HllAccumulator {
     }
   }
 
+  void append(folly::Range<const uint64_t*> hashes) {
+    auto it = hashes.begin();
+    for (; isSparse_ && it != hashes.end(); ++it) {
+      append(*it);
+    }
+    if (it != hashes.end()) {
+      denseHll_.insertHashes({it, hashes.end()});
+    }
+  }
+
   int64_t cardinality() const {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
@@ -253,18 +263,20 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
+      hashes_.clear();
       rows.applyToSelected([&](auto row) {
-        if (decodedValue_.isNullAt(row)) {
-          return;
+        if (!decodedValue_.isNullAt(row)) {
+          hashes_.push_back(hashOne(decodedValue_.valueAt<T>(row)));
         }
-
-        auto accumulator = value<HllAccumulator>(group);
-        clearNull(group);
-        accumulator->setIndexBitLength(indexBitLength_);
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
       });
+      if (hashes_.empty()) {
+        return;
+      }
+
+      auto accumulator = value<HllAccumulator>(group);
+      clearNull(group);
+      accumulator->setIndexBitLength(indexBitLength_);
+      accumulator->append(hashes_);
     }
   }
 
@@ -378,6 +390,9 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+
+  // The hashes of the values added to a single group by one call.
+  std::vector<uint64_t> hashes_;
 };
 
 template <TypeKind kind>
@@ -33,6 +33,10 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
     return sizeof(StreamSummary);
   }
 
+  bool isFixedSize() const override {
+    return false;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -56,6 +60,7 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
     decodeArguments(rows, args);
     rows.applyToSelected([&](auto row) {
       if (!decodedValues_.isNullAt(row)) {
+        auto tracker = trackRowSize(groups[row]);
         auto summary = initSummary(groups[row]);
         summary->insert(decodedValues_.valueAt<T>(row));
       }
@@ -76,6 +81,7 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
       const std::vector<VectorPtr>& args,
       bool) override {
     decodeArguments(rows, args);
+    auto tracker = trackRowSize(group);
     auto summary = initSummary(group);
     rows.applyToSelected([&](auto row) {
       if (!decodedValues_.isNullAt(row)) {
@@ -256,12 +262,15 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
       int i = decoded.index(row);
       setConstantArgument("Buckets", buckets_, buckets->valueAt(i));
       setConstantArgument("Capacity", capacity_, capacity->valueAt(i));
+      char* groupRow;
       if constexpr (kSingleGroup) {
-        if (!summary) {
-          summary = initSummary(group);
-        }
+        groupRow = group;
       } else {
-        summary = initSummary(group[row]);
+        groupRow = group[row];
+      }
+      auto tracker = trackRowSize(groupRow);
+      if (!kSingleGroup || !summary) {
+        summary = initSummary(groupRow);
       }
       auto size = values->sizeAt(i);
       VELOX_DCHECK_EQ(counts->sizeAt(i), size);
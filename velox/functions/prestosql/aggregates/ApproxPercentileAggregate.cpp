@@ -52,6 +52,10 @@ struct KllSketchAccumulator {
     sketch_.insert(value);
   }
 
+  void append(folly::Range<const T*> values) {
+    sketch_.insertBatch(values);
+  }
+
   void append(T value, int64_t count) {
     constexpr size_t kMaxBufferSize = 4096;
     constexpr int64_t kMinCountToBuffer = 512;
@@ -375,19 +379,21 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         accumulator->append(value, weight);
       });
     } else {
-      if (decodedValue_.mayHaveNulls()) {
-        rows.applyToSelected([&](auto row) {
-          if (decodedValue_.isNullAt(row)) {
-            return;
-          }
-
-          accumulator->append(decodedValue_.valueAt<T>(row));
-        });
-      } else {
-        rows.applyToSelected([&](auto row) {
-          accumulator->append(decodedValue_.valueAt<T>(row));
-        });
+      // All the values go to one sketch, so they are inserted in one batch.
+      if (decodedValue_.isIdentityMapping() && !decodedValue_.mayHaveNulls() &&
+          rows.isAllSelected()) {
+        accumulator->append(
+            folly::Range<const T*>(decodedValue_.data<T>(), rows.end()));
+        return;
       }
+      values_.clear();
+      rows.applyToSelected([&](auto row) {
+        if (!decodedValue_.isNullAt(row)) {
+          values_.push_back(decodedValue_.valueAt<T>(row));
+        }
+      });
+      accumulator->append(
+          folly::Range<const T*>(values_.data(), values_.size()));
     }
   }
 
@@ -643,6 +649,8 @@ class ApproxPercentileAggregate : public exec::Aggregate {
   double accuracy_{kMissingNormalizedValue};
   DecodedVector decodedValue_;
   DecodedVector decodedWeight_;
+  // The values added to a single group by one call.
+  std::vector<T> values_;
   DecodedVector decodedAccuracy_;
   DecodedVector decodedDigest_;
 };
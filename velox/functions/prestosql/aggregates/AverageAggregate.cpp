@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/AggregationHook.h"
 #include "velox/expression/FunctionSignature.h"
+#include "velox/functions/lib/SimpleNumericAggregate.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
 #include "velox/functions/prestosql/aggregates/DecimalAggregate.h"
 #include "velox/type/DecimalUtil.h"
@@ -40,6 +42,31 @@ struct SumCount {
 //     REAL            |     DOUBLE          |    REAL
 //     ALL INTs        |     DOUBLE          |    DOUBLE
 //
+// Adds the values of a column to the sum and count of their groups while the
+// column is read. The group nulls are cleared before the column is loaded.
+template <typename TInput, typename TAccumulator>
+class AverageHook final : public AggregationHook {
+ public:
+  AverageHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  Kind kind() const override {
+    return kGeneric;
+  }
+
+  void addValue(vector_size_t row, const void* value) override {
+    auto* sumCount =
+        reinterpret_cast<SumCount<TAccumulator>*>(findGroup(row) + offset_);
+    sumCount->sum += TAccumulator(*reinterpret_cast<const TInput*>(value));
+    ++sumCount->count;
+  }
+};
+
 template <typename TInput, typename TAccumulator, typename TResult>
 class AverageAggregate : public exec::Aggregate {
  public:
@@ -93,7 +120,25 @@ class AverageAggregate : public exec::Aggregate {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
+    if (mayPushdown && args[0]->isLazy()) {
+      // Spark expects the result of partial avg to be non-nullable, also for
+      // the groups that only get nulls, which the hook does not see.
+      rows.applyToSelected(
+          [&](vector_size_t i) { exec::Aggregate::clearNull(groups[i]); });
+      loadWithHook(
+          rows,
+          args[0],
+          groups,
+          pushdownCustomIndices_,
+          pushdownGroups_,
+          [&](char** rowGroups) {
+            return AverageHook<TInput, TAccumulator>(
+                offset_, nullByte_, nullMask_, rowGroups, &numNulls_);
+          });
+      return;
+    }
+
     decodedRaw_.decode(*args[0], rows);
     if (decodedRaw_.isConstantMapping()) {
       if (!decodedRaw_.isNullAt(0)) {
@@ -145,6 +190,18 @@ class AverageAggregate : public exec::Aggregate {
         // Spark expects the result of partial avg to be non-nullable.
         exec::Aggregate::clearNull(group);
       }
+    } else if (decodedRaw_.isIdentityMapping()) {
+      vector_size_t count;
+      const auto totalSum = foldSelectedValues(
+          decodedRaw_.data<TInput>(),
+          decodedRaw_.nulls(),
+          rows,
+          TAccumulator(0),
+          [](TAccumulator& sum, TAccumulator value) { sum += value; },
+          count);
+      // Also clears the null flag if all the values are null, since Spark
+      // expects the result of partial avg to be non-nullable.
+      updateNonNullValue(group, count, totalSum);
     } else if (decodedRaw_.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (!decodedRaw_.isNullAt(i)) {
@@ -155,11 +212,6 @@ class AverageAggregate : public exec::Aggregate {
           exec::Aggregate::clearNull(group);
         }
       });
-    } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
-      const TInput* data = decodedRaw_.data<TInput>();
-      TAccumulator totalSum(0);
-      rows.applyToSelected([&](vector_size_t i) { totalSum += data[i]; });
-      updateNonNullValue<false>(group, rows.countSelected(), totalSum);
     } else {
       TAccumulator totalSum(0);
       rows.applyToSelected(
@@ -168,6 +220,31 @@ class AverageAggregate : public exec::Aggregate {
     }
   }
 
+  // Retracting is exact only if the sum of the inputs is, i.e. for integer
+  // inputs. The accumulator keeps the count so the result becomes null again
+  // once all the non-null inputs are retracted.
+  bool supportsRetract() const override {
+    return std::is_integral_v<TInput>;
+  }
+
+  void retractSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedRaw_.decode(*args[0], rows);
+
+    TAccumulator totalSum(0);
+    int64_t totalCount = 0;
+    rows.applyToSelected([&](vector_size_t i) {
+      if (!decodedRaw_.isNullAt(i)) {
+        totalSum += decodedRaw_.valueAt<TInput>(i);
+        ++totalCount;
+      }
+    });
+    updateNonNullValue(group, -totalCount, -totalSum);
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -347,6 +424,10 @@ class AverageAggregate : public exec::Aggregate {
 
   DecodedVector decodedRaw_;
   DecodedVector decodedPartial_;
+
+  // The groups of the selected rows in pushdown when not all rows are
+  // selected.
+  std::vector<char*> pushdownGroups_;
 };
 
 void checkSumCountRowType(TypePtr type, const std::string& errorMessage) {
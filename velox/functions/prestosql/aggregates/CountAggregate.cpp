@@ -52,12 +52,18 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
     if (args.empty()) {
       rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
       return;
     }
 
+    if (mayPushdown && args[0]->isLazy() &&
+        hookSupported(args[0]->typeKind())) {
+      BaseAggregate::template pushdown<CountHook>(groups, rows, args[0]);
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
@@ -92,27 +98,19 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    if (args.empty()) {
-      addToGroup(group, rows.countSelected());
-      return;
-    }
+    addToGroup(group, countRawInput(rows, args));
+  }
 
-    DecodedVector decoded(*args[0], rows);
-    if (decoded.isConstantMapping()) {
-      if (!decoded.isNullAt(0)) {
-        addToGroup(group, rows.countSelected());
-      }
-    } else if (decoded.mayHaveNulls()) {
-      int64_t nonNullCount = 0;
-      rows.applyToSelected([&](vector_size_t i) {
-        if (!decoded.isNullAt(i)) {
-          ++nonNullCount;
-        }
-      });
-      addToGroup(group, nonNullCount);
-    } else {
-      addToGroup(group, rows.countSelected());
-    }
+  bool supportsRetract() const override {
+    return true;
+  }
+
+  void retractSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addToGroup(group, -countRawInput(rows, args));
   }
 
   void addSingleGroupIntermediateResults(
@@ -139,10 +137,65 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
   }
 
  private:
+  // Returns true if the column readers pass the values of columns of 'kind' to
+  // a ValueHook.
+  static bool hookSupported(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   inline void addToGroup(char* group, int64_t count) {
     *value<int64_t>(group) += count;
   }
 
+  // Returns the number of 'rows' to count, e.g. all the rows for count(*) or
+  // the rows with non-null 'args' for count(x).
+  int64_t countRawInput(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    if (args.empty()) {
+      return rows.countSelected();
+    }
+
+    DecodedVector decoded(*args[0], rows);
+    if (decoded.isConstantMapping()) {
+      return decoded.isNullAt(0) ? 0 : rows.countSelected();
+    }
+    if (decoded.mayHaveNulls() && decoded.isIdentityMapping()) {
+      // Counts the rows that are both selected and not null a word at a time.
+      const auto* selected = rows.asRange().bits();
+      const auto* nulls = decoded.nulls();
+      int64_t nonNullCount = 0;
+      bits::forEachWord(rows.begin(), rows.end(), [&](auto index, auto mask) {
+        nonNullCount +=
+            __builtin_popcountll(selected[index] & nulls[index] & mask);
+      });
+      return nonNullCount;
+    }
+    if (decoded.mayHaveNulls()) {
+      int64_t nonNullCount = 0;
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          ++nonNullCount;
+        }
+      });
+      return nonNullCount;
+    }
+    return rows.countSelected();
+  }
+
   DecodedVector decodedIntermediate_;
 };
 
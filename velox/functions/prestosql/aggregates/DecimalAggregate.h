@@ -149,10 +149,8 @@ class DecimalAggregate : public exec::Aggregate {
     } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
       const TInputType* data = decodedRaw_.data<TInputType>();
       LongDecimalWithOverflowState accumulator;
-      rows.applyToSelected([&](vector_size_t i) {
-        accumulator.overflow += DecimalUtil::addWithOverflow(
-            accumulator.sum, data[i].unscaledValue(), accumulator.sum);
-      });
+      addToAccumulator(
+          accumulator, rows, [&](vector_size_t i) { return data[i]; });
       accumulator.count = rows.countSelected();
       char rawData[LongDecimalWithOverflowState::serializedSize()];
       StringView serialized(
@@ -161,11 +159,8 @@ class DecimalAggregate : public exec::Aggregate {
       mergeAccumulators<false>(group, serialized);
     } else {
       LongDecimalWithOverflowState accumulator;
-      rows.applyToSelected([&](vector_size_t i) {
-        accumulator.overflow += DecimalUtil::addWithOverflow(
-            accumulator.sum,
-            decodedRaw_.valueAt<TInputType>(i).unscaledValue(),
-            accumulator.sum);
+      addToAccumulator(accumulator, rows, [&](vector_size_t i) {
+        return decodedRaw_.valueAt<TInputType>(i);
       });
       accumulator.count = rows.countSelected();
       char rawData[LongDecimalWithOverflowState::serializedSize()];
@@ -330,6 +325,28 @@ class DecimalAggregate : public exec::Aggregate {
   }
 
  private:
+  // Adds the values of 'rows' to the sum of 'accumulator'. A batch of short
+  // decimals cannot overflow 128 bits, so their sum is taken with plain 128
+  // bit additions and the overflow is checked once for the batch.
+  template <typename ValueAt>
+  void addToAccumulator(
+      LongDecimalWithOverflowState& accumulator,
+      const SelectivityVector& rows,
+      ValueAt valueAt) {
+    if constexpr (std::is_same_v<TInputType, UnscaledShortDecimal>) {
+      int128_t sum = 0;
+      rows.applyToSelected(
+          [&](vector_size_t i) { sum += valueAt(i).unscaledValue(); });
+      accumulator.overflow += DecimalUtil::addWithOverflow(
+          accumulator.sum, sum, accumulator.sum);
+    } else {
+      rows.applyToSelected([&](vector_size_t i) {
+        accumulator.overflow += DecimalUtil::addWithOverflow(
+            accumulator.sum, valueAt(i).unscaledValue(), accumulator.sum);
+      });
+    }
+  }
+
   inline LongDecimalWithOverflowState* decimalAccumulator(char* group) {
     return exec::Aggregate::value<LongDecimalWithOverflowState>(group);
   }
@@ -62,6 +62,10 @@ class HistogramAggregate : public exec::Aggregate {
     return sizeof(ValueMap<T>);
   }
 
+  bool isFixedSize() const override {
+    return false;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -124,6 +128,7 @@ class HistogramAggregate : public exec::Aggregate {
       // Nulls among the values being aggregated are ignored.
       if (!decodedKeys_.isNullAt(row)) {
         auto group = groups[row];
+        auto tracker = trackRowSize(group);
         auto groupMap = value<ValueMap<T>>(group);
 
         (*groupMap)[decodedKeys_.valueAt<T>(row)]++;
@@ -137,6 +142,7 @@ class HistogramAggregate : public exec::Aggregate {
       const std::vector<VectorPtr>& args,
       bool /* mayPushdown */) override {
     decodedKeys_.decode(*args[0], rows);
+    auto tracker = trackRowSize(group);
     auto groupMap = value<ValueMap<T>>(group);
     rows.applyToSelected([&](auto row) {
       // Nulls among the values being aggregated are ignored.
@@ -166,6 +172,7 @@ class HistogramAggregate : public exec::Aggregate {
     rows.applyToSelected([&](vector_size_t row) {
       if (!decodedIntermediate_.isNullAt(row)) {
         auto group = groups[row];
+        auto tracker = trackRowSize(group);
         auto groupMap = value<ValueMap<T>>(group);
 
         addToFinalAggregation<T>(
@@ -189,6 +196,7 @@ class HistogramAggregate : public exec::Aggregate {
     VELOX_CHECK_NOT_NULL(mapKeys);
     VELOX_CHECK_NOT_NULL(mapValues);
 
+    auto tracker = trackRowSize(group);
     auto groupMap = value<ValueMap<T>>(group);
 
     auto rawSizes = mapVector->rawSizes();
@@ -67,6 +67,11 @@ class MinMaxAggregate : public SimpleNumericAggregate<T, T, T> {
     return 1;
   }
 
+  bool supportsDenseAccumulators() const override {
+    // The dense accumulators of booleans would be bits.
+    return !std::is_same_v<T, bool>;
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     BaseAggregate::template doExtractValues<T>(
@@ -152,6 +157,26 @@ class MaxAggregate : public MinMaxAggregate<T> {
     addRawInput(groups, rows, args, mayPushdown);
   }
 
+  void addRawInputDense(
+      const uint64_t* groupIds,
+      int32_t numGroups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override {
+    BaseAggregate::updateDense(
+        groupIds,
+        numGroups,
+        rows,
+        args[0],
+        &updateMax,
+        kInitialValue_,
+        mayPushdown);
+  }
+
+  void flushDenseAccumulators(char* const* groups) override {
+    BaseAggregate::flushDense(groups, &updateMax, kInitialValue_);
+  }
+
   void addSingleGroupRawInput(
       char* group,
       const SelectivityVector& rows,
@@ -180,6 +205,12 @@ class MaxAggregate : public MinMaxAggregate<T> {
   }
 
  private:
+  static void updateMax(T& result, T value) {
+    if (result < value) {
+      result = value;
+    }
+  }
+
   static const T kInitialValue_;
 };
 
@@ -232,6 +263,26 @@ class MinAggregate : public MinMaxAggregate<T> {
     addRawInput(groups, rows, args, mayPushdown);
   }
 
+  void addRawInputDense(
+      const uint64_t* groupIds,
+      int32_t numGroups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override {
+    BaseAggregate::updateDense(
+        groupIds,
+        numGroups,
+        rows,
+        args[0],
+        &updateMin,
+        kInitialValue_,
+        mayPushdown);
+  }
+
+  void flushDenseAccumulators(char* const* groups) override {
+    BaseAggregate::flushDense(groups, &updateMin, kInitialValue_);
+  }
+
   void addSingleGroupRawInput(
       char* group,
       const SelectivityVector& rows,
@@ -256,6 +307,12 @@ class MinAggregate : public MinMaxAggregate<T> {
   }
 
  private:
+  static void updateMin(T& result, T value) {
+    if (result > value) {
+      result = value;
+    }
+  }
+
   static const T kInitialValue_;
 };
 
@@ -19,6 +19,7 @@
 #include "velox/functions/lib/SimpleNumericAggregate.h"
 #include "velox/functions/prestosql/CheckedArithmeticImpl.h"
 #include "velox/functions/prestosql/aggregates/DecimalAggregate.h"
+#include "velox/vector/BiasVector.h"
 
 namespace facebook::velox::aggregate::prestosql {
 
@@ -83,11 +84,52 @@ class SumAggregate
     updateInternal<TAccumulator, TAccumulator>(groups, rows, args, mayPushdown);
   }
 
+  bool supportsDenseAccumulators() const override {
+    return true;
+  }
+
+  void addRawInputDense(
+      const uint64_t* groupIds,
+      int32_t numGroups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override {
+    BaseAggregate::template updateDense<TAccumulator>(
+        groupIds,
+        numGroups,
+        rows,
+        args[0],
+        &updateSingleValue<TAccumulator>,
+        TAccumulator(0),
+        mayPushdown);
+  }
+
+  void flushDenseAccumulators(char* const* groups) override {
+    BaseAggregate::template flushDense<TAccumulator>(
+        groups, &updateSingleValue<TAccumulator>, TAccumulator(0));
+  }
+
   void addSingleGroupRawInput(
       char* group,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if constexpr (
+        std::is_same_v<TAccumulator, int64_t> &&
+        (std::is_same_v<TInput, int64_t> || std::is_same_v<TInput, int32_t> ||
+         std::is_same_v<TInput, int16_t>)) {
+      const auto& arg = args[0];
+      if (!arg->isLazy() || arg->asUnchecked<LazyVector>()->isLoaded()) {
+        const auto* loaded = arg->loadedVector();
+        if (loaded->encoding() == VectorEncoding::Simple::BIASED) {
+          addBiasedInput(
+              group,
+              rows,
+              *loaded->template asUnchecked<BiasVector<TInput>>());
+          return;
+        }
+      }
+    }
     BaseAggregate::template updateOneGroup<TAccumulator>(
         group,
         rows,
@@ -143,6 +185,55 @@ class SumAggregate
   }
 
  private:
+  // Adds the values of a BiasVector without decoding these: the sum is the
+  // sum of the stored values plus the bias times the number of non-null rows.
+  void addBiasedInput(
+      char* group,
+      const SelectivityVector& rows,
+      const BiasVector<TInput>& vector) {
+    switch (vector.valueType()) {
+      case TypeKind::TINYINT:
+        addBiasedInput<int8_t>(group, rows, vector);
+        break;
+      case TypeKind::SMALLINT:
+        addBiasedInput<int16_t>(group, rows, vector);
+        break;
+      case TypeKind::INTEGER:
+        addBiasedInput<int32_t>(group, rows, vector);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+
+  template <typename TStored>
+  void addBiasedInput(
+      char* group,
+      const SelectivityVector& rows,
+      const BiasVector<TInput>& vector) {
+    const auto* stored = vector.values()->template as<TStored>();
+    const auto* nulls = vector.rawNulls();
+    int64_t sum = 0;
+    int64_t count = 0;
+    if (nulls) {
+      rows.applyToSelected([&](vector_size_t row) {
+        if (!bits::isBitNull(nulls, row)) {
+          sum += stored[row];
+          ++count;
+        }
+      });
+    } else {
+      rows.applyToSelected([&](vector_size_t row) { sum += stored[row]; });
+      count = rows.countSelected();
+    }
+    if (count == 0) {
+      return;
+    }
+    exec::Aggregate::clearNull(group);
+    *exec::Aggregate::value<TAccumulator>(group) +=
+        sum + count * static_cast<int64_t>(vector.bias());
+  }
+
   /// Update functions that check for overflows for integer types.
   /// For floating points, an overflow results in +/- infinity which is a
   /// valid output.
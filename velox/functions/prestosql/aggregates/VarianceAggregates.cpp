@@ -15,6 +15,7 @@
  */
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
+#include "velox/functions/lib/SimpleNumericAggregate.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
@@ -38,6 +39,48 @@ struct VarianceAccumulator {
   VarianceAccumulator(int64_t count, double value)
       : count_(count), mean_(value), m2_(0.0) {}
 
+  VarianceAccumulator(int64_t count, double mean, double m2)
+      : count_(count), mean_(mean), m2_(m2) {}
+
+  // Returns the accumulator of the values at the selected 'rows' of flat
+  // 'data' that are not null in 'nulls', which may be nullptr. Computes the
+  // mean first and then the sum of squared differences from the mean. Unlike
+  // update() per value, neither pass divides or depends on the previous value
+  // and the two pass result is at least as accurate.
+  template <typename T>
+  static VarianceAccumulator twoPass(
+      const T* data,
+      const uint64_t* nulls,
+      const SelectivityVector& rows) {
+    vector_size_t count;
+    const double sum = foldSelectedValues(
+        data,
+        nulls,
+        rows,
+        0.0,
+        [](double& result, double value) { result += value; },
+        count);
+    if (count == 0) {
+      return VarianceAccumulator();
+    }
+    const double mean = sum / count;
+    double m2 = 0;
+    auto addSquare = [&](vector_size_t row) {
+      const double delta = data[row] - mean;
+      m2 += delta * delta;
+    };
+    if (nulls) {
+      rows.applyToSelected([&](vector_size_t row) {
+        if (!bits::isBitNull(nulls, row)) {
+          addSquare(row);
+        }
+      });
+    } else {
+      rows.applyToSelected(addSquare);
+    }
+    return VarianceAccumulator(count, mean, m2);
+  }
+
   double count() const {
     return count_;
   }
@@ -224,17 +267,18 @@ class VarianceAggregate : public exec::Aggregate {
         VarianceAccumulator accData(numRows, (double)value);
         updateNonNullValue(group, accData);
       }
+    } else if (decodedRaw_.isIdentityMapping()) {
+      const auto accData = VarianceAccumulator::twoPass(
+          decodedRaw_.data<T>(), decodedRaw_.nulls(), rows);
+      if (accData.count() > 0) {
+        updateNonNullValue(group, accData);
+      }
     } else if (decodedRaw_.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (!decodedRaw_.isNullAt(i)) {
           updateNonNullValue(group, decodedRaw_.valueAt<T>(i));
         }
       });
-    } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
-      const T* data = decodedRaw_.data<T>();
-      VarianceAccumulator accData;
-      rows.applyToSelected([&](vector_size_t i) { accData.update(data[i]); });
-      updateNonNullValue<false>(group, accData);
     } else {
       VarianceAccumulator accData;
       rows.applyToSelected(
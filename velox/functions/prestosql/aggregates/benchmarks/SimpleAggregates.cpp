@@ -118,7 +118,10 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
 
     auto plan = PlanBuilder()
                     .tableScan(inputType_)
-                    .partialAggregation({key}, {aggregate})
+                    .partialAggregation(
+                        key.empty() ? std::vector<std::string>{}
+                                    : std::vector<std::string>{key},
+                        {aggregate})
                     .finalAggregation()
                     .planFragment();
 
@@ -252,6 +255,40 @@ AGG_BENCHMARKS(stddev, k_norm)
 AGG_BENCHMARKS(stddev, k_hash)
 BENCHMARK_DRAW_LINE();
 
+// Approx percentile aggregate. A global aggregation inserts whole batches
+// into one sketch.
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_BIGINT_global,
+    "",
+    "approx_percentile(i64, 0.5)");
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_DOUBLE_global,
+    "",
+    "approx_percentile(f64, 0.99)");
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_DOUBLE_NULLS_global,
+    "",
+    "approx_percentile(f64_halfnull, 0.99)");
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_DOUBLE_accuracy_global,
+    "",
+    "approx_percentile(f64, 0.99, 0.05)");
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_DOUBLE_k_array,
+    "k_array",
+    "approx_percentile(f64, 0.99)");
+BENCHMARK_NAMED_PARAM(
+    doRun,
+    approx_percentile_DOUBLE_k_hash,
+    "k_hash",
+    "approx_percentile(f64, 0.99)");
+BENCHMARK_DRAW_LINE();
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -19,6 +19,7 @@
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+#include "velox/vector/BiasVector.h"
 
 using facebook::velox::exec::test::PlanBuilder;
 using namespace facebook::velox::exec::test;
@@ -225,6 +226,55 @@ TEST_F(SumTest, sumBigIntOverflow) {
       "SELECT sum(c0) FROM tmp");
 }
 
+TEST_F(SumTest, biased) {
+  const vector_size_t size = 1'000;
+  constexpr int64_t kBias = 1'000'000'000'000;
+  auto stored = AlignedBuffer::allocate<int8_t>(size, pool());
+  auto* rawStored = stored->asMutable<int8_t>();
+  auto stored16 = AlignedBuffer::allocate<int16_t>(size, pool());
+  auto* rawStored16 = stored16->asMutable<int16_t>();
+  int64_t expected = 0;
+  int64_t expected16 = 0;
+  for (auto i = 0; i < size; ++i) {
+    rawStored[i] = i % 100 - 50;
+    rawStored16[i] = i * 10;
+    if (i % 7 != 0) {
+      expected += kBias + rawStored[i];
+    }
+    expected16 += -5 + rawStored16[i];
+  }
+  auto nulls = makeNulls(size, [](auto row) { return row % 7 == 0; });
+  auto data = makeRowVector({
+      std::make_shared<BiasVector<int64_t>>(
+          pool(), nulls, size, TypeKind::TINYINT, stored, kBias),
+      std::make_shared<BiasVector<int32_t>>(
+          pool(), nullptr, size, TypeKind::SMALLINT, stored16, -5),
+  });
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .singleAggregation({}, {"sum(c0)", "sum(c1)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      makeRowVector({
+          makeFlatVector<int64_t>(std::vector<int64_t>{expected}),
+          makeFlatVector<int64_t>(std::vector<int64_t>{expected16}),
+      }));
+
+  // All rows are null.
+  nulls = makeNulls(size, [](auto /*row*/) { return true; });
+  data = makeRowVector({std::make_shared<BiasVector<int64_t>>(
+      pool(), nulls, size, TypeKind::TINYINT, stored, kBias)});
+  plan = PlanBuilder()
+             .values({data})
+             .singleAggregation({}, {"sum(c0)"})
+             .planNode();
+  assertQuery(
+      plan,
+      makeRowVector({makeNullableFlatVector<int64_t>({std::nullopt})}));
+}
+
 TEST_F(SumTest, sumFloat) {
   auto data = makeRowVector({makeFlatVector<float>({2.00, 1.00})});
   createDuckDbTable({data});
@@ -124,6 +124,28 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Evaluates 'expression' over timestamps that increase by a few seconds
+  // from one row to the next, as in data sorted or clustered on time. With
+  // the session time zone set, the conversions of consecutive rows use the
+  // same offset.
+  void runSorted(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto data = vectorMaker_.rowVector({vectorMaker_.flatVector<Timestamp>(
+        10'000,
+        [](auto row) { return Timestamp(1'600'000'000 + row * 37, 0); })});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
+  void setSessionTimezone(const std::string& timezone) {
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kSessionTimezone, timezone},
+        {core::QueryConfig::kAdjustTimestampToTimezone, "true"},
+    });
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -197,6 +219,52 @@ BENCHMARK(second) {
   DateTimeBenchmark benchmark;
   benchmark.run("second");
 }
+
+BENCHMARK(hourSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSorted("hour(c0)");
+}
+
+BENCHMARK(hourLosAngeles) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.run("hour");
+}
+
+BENCHMARK(hourLosAngelesSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.runSorted("hour(c0)");
+}
+
+BENCHMARK(yearLosAngelesSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.runSorted("year(c0)");
+}
+
+BENCHMARK(truncHourSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSorted("date_trunc('hour', c0)");
+}
+
+BENCHMARK(truncHourLosAngelesSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.runSorted("date_trunc('hour', c0)");
+}
+
+BENCHMARK(truncDayLosAngelesSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.runSorted("date_trunc('day', c0)");
+}
+
+BENCHMARK(truncMonthLosAngelesSorted) {
+  DateTimeBenchmark benchmark;
+  benchmark.setSessionTimezone("America/Los_Angeles");
+  benchmark.runSorted("date_trunc('month', c0)");
+}
 } // namespace
 
 int main(int argc, char** argv) {
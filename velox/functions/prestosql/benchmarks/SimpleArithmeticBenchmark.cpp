@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/functions/Registerer.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+// The same as 'multiply' but without callBatch(), so the adapter calls it one
+// row at a time.
+template <typename T>
+struct MultiplyScalarFunction {
+  void call(double& result, const double& a, const double& b) {
+    result = a * b;
+  }
+};
+
+class SimpleArithmeticBenchmark
+    : public functions::test::FunctionBenchmarkBase {
+ public:
+  SimpleArithmeticBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArithmeticFunctions();
+    registerFunction<MultiplyScalarFunction, double, double, double>(
+        {"multiply_scalar"});
+  }
+
+  void run(const std::string& expression, bool withNulls) {
+    folly::BenchmarkSuspender suspender;
+    constexpr vector_size_t size = 10'000;
+    auto data = vectorMaker_.rowVector({
+        vectorMaker_.flatVector<double>(
+            size,
+            [](auto row) { return row * 0.1; },
+            withNulls ? VectorMaker::nullEvery(17) : nullptr),
+        vectorMaker_.flatVector<double>(size, [](auto row) { return row; }),
+    });
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    int cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, data)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+};
+
+BENCHMARK(scalarMultiply) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply_scalar(c0, c1)", false);
+}
+
+BENCHMARK_RELATIVE(batchMultiply) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply(c0, c1)", false);
+}
+
+BENCHMARK(scalarMultiplyConstant) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply_scalar(c0, 1.5)", false);
+}
+
+BENCHMARK_RELATIVE(batchMultiplyConstant) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply(c0, 1.5)", false);
+}
+
+BENCHMARK(scalarMultiplyNulls) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply_scalar(c0, c1)", true);
+}
+
+BENCHMARK_RELATIVE(batchMultiplyNulls) {
+  SimpleArithmeticBenchmark benchmark;
+  benchmark.run("multiply(c0, c1)", true);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  folly::runBenchmarks();
+  return 0;
+}
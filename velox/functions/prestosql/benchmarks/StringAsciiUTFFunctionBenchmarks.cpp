@@ -114,6 +114,31 @@ class StringAsciiUTFFunctionBenchmark
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates 'expression' over mostly ASCII text with a few multi-byte
+  // characters per string, as in user content. The vector is not all ASCII,
+  // so the functions take their UTF-8 paths.
+  void runMixed(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+
+    static const std::vector<std::string> kWords = {
+        "the ", "caf\u00e9 ", "order ", "shipped ", "r\u00e9sum\u00e9 ",
+        "to ", "M\u00fcnchen ", "and ", "customer ", "\u4f60\u597d ",
+        "request ", "with "};
+    auto vector = vectorMaker_.flatVector<std::string>(10'000, [](auto row) {
+      std::string text;
+      for (auto i = 0; text.size() < 100; ++i) {
+        text += kWords[(row + i * 7) % kWords.size()];
+      }
+      return text;
+    });
+
+    auto rowVector = vectorMaker_.rowVector({vector});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -172,6 +197,38 @@ BENCHMARK_RELATIVE(aciiRPad) {
   StringAsciiUTFFunctionBenchmark benchmark;
   benchmark.runLPadRPad("rpad", false);
 }
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(mixedLower) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("lower(c0)");
+}
+
+BENCHMARK(mixedUpper) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("upper(c0)");
+}
+
+BENCHMARK(mixedLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("length(c0)");
+}
+
+BENCHMARK(mixedReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("reverse(c0)");
+}
+
+BENCHMARK(mixedSubStr) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("substr(c0, 60, 30)");
+}
+
+BENCHMARK(mixedFromUtf8) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("from_utf8(to_utf8(c0))");
+}
 } // namespace
 
 // Preliminary release run, before ascii optimization.
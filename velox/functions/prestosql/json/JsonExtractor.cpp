@@ -16,7 +16,10 @@
 
 #include "velox/functions/prestosql/json/JsonExtractor.h"
 
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
 
@@ -32,6 +35,40 @@ namespace {
 
 using JsonVector = std::vector<const folly::dynamic*>;
 
+void extractObject(
+    const folly::dynamic* jsonObj,
+    const std::string& key,
+    JsonVector& ret) {
+  auto val = jsonObj->get_ptr(key);
+  if (val) {
+    ret.push_back(val);
+  }
+}
+
+void extractArray(
+    const folly::dynamic* jsonArray,
+    const std::string& key,
+    JsonVector& ret) {
+  auto arrayLen = jsonArray->size();
+  if (key == "*") {
+    for (size_t i = 0; i < arrayLen; ++i) {
+      ret.push_back(jsonArray->get_ptr(i));
+    }
+  } else {
+    auto rv = folly::tryTo<int32_t>(key);
+    if (rv.hasValue()) {
+      auto idx = rv.value();
+      if (idx >= 0 && idx < arrayLen) {
+        ret.push_back(jsonArray->get_ptr(idx));
+      }
+    }
+  }
+}
+
+} // namespace
+
+namespace detail {
+
 class JsonExtractor {
  public:
   // Use this method to get an instance of JsonExtractor given a json path.
@@ -53,13 +90,38 @@ class JsonExtractor {
     return *op;
   }
 
-  folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
+  folly::Optional<folly::dynamic> extract(const folly::dynamic& json) const;
+
+  enum class ScanResult { kFound, kNotFound, kUnsupported };
+
+  // Finds the value at the path in 'json' without parsing it into a
+  // folly::dynamic. Sets 'value' to the text of the value if found. Returns
+  // kUnsupported if the path has a wildcard or 'json' is not handled by the
+  // scanner, in which case the caller parses 'json' and calls extract().
+  ScanResult scan(folly::StringPiece json, folly::StringPiece& value) const;
 
-  // Shouldn't instantiate directly - use getInstance().
+  // Prefer getInstance(), which reuses the tokenized path within the thread.
   explicit JsonExtractor(const std::string& path) {
     if (!tokenize(path)) {
       VELOX_USER_FAIL("Invalid JSON path: {}", path);
     }
+    for (const auto& token : tokens_) {
+      hasWildcard_ |= token == "*";
+      auto index = folly::tryTo<int32_t>(token);
+      indices_.push_back(index.hasValue() ? index.value() : -1);
+    }
+  }
+
+  const std::vector<std::string>& tokens() const {
+    return tokens_;
+  }
+
+  const std::vector<int32_t>& indices() const {
+    return indices_;
+  }
+
+  bool hasWildcard() const {
+    return hasWildcard_;
   }
 
  private:
@@ -93,44 +155,315 @@ class JsonExtractor {
   static const uint32_t kMaxCacheNum{32};
 
   std::vector<std::string> tokens_;
+
+  // The array index for each token, or -1 if the token is not a valid index.
+  std::vector<int32_t> indices_;
+
+  bool hasWildcard_{false};
 };
 
-thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
-    JsonExtractor::kExtractorCache;
-thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
+// Scans a JSON document for the values at up to kMaxPaths paths of object keys
+// and array indices without building a DOM. The whole document is checked
+// against the JSON grammar, so that a document that folly::parseJson() rejects
+// is not scanned successfully either. Inputs for which the two might not
+// agree, e.g. deep nesting, integers that may overflow, control characters or
+// escaped keys on a path, stop the scan as unsupported.
+class JsonPathScanner {
+ public:
+  static constexpr int32_t kMaxPaths = 64;
 
-void extractObject(
-    const folly::dynamic* jsonObj,
-    const std::string& key,
-    JsonVector& ret) {
-  auto val = jsonObj->get_ptr(key);
-  if (val) {
-    ret.push_back(val);
+  // 'paths' must not have wildcards.
+  JsonPathScanner(
+      folly::Range<const JsonExtractor* const*> paths,
+      folly::StringPiece json)
+      : paths_(paths), pos_(json.begin()), end_(json.end()) {
+    VELOX_DCHECK_LE(paths.size(), static_cast<size_t>(kMaxPaths));
+    matchedDepth_.fill(-1);
   }
-}
 
-void extractArray(
-    const folly::dynamic* jsonArray,
-    const std::string& key,
-    JsonVector& ret) {
-  auto arrayLen = jsonArray->size();
-  if (key == "*") {
-    for (size_t i = 0; i < arrayLen; ++i) {
-      ret.push_back(jsonArray->get_ptr(i));
+  // Returns false if the document is not supported. Otherwise returns true,
+  // sets bit i of 'found' if paths[i] is in the document and sets values[i]
+  // to the text of its value.
+  bool scan(uint64_t& found, folly::StringPiece* values) {
+    values_ = values;
+    const int32_t numPaths = paths_.size();
+    if (!scanValue(
+            numPaths == kMaxPaths ? ~0ULL : (1ULL << numPaths) - 1, 0)) {
+      return false;
     }
-  } else {
-    auto rv = folly::tryTo<int32_t>(key);
-    if (rv.hasValue()) {
-      auto idx = rv.value();
-      if (idx >= 0 && idx < arrayLen) {
-        ret.push_back(jsonArray->get_ptr(idx));
+    skipWhitespace();
+    if (pos_ != end_) {
+      return false;
+    }
+    found = found_;
+    return true;
+  }
+
+ private:
+  // folly::parseJson() fails above a nesting depth of 100.
+  static constexpr int32_t kMaxNesting = 64;
+
+  // The longest number with a fraction or exponent, e.g. 1.5e10, that is
+  // scanned. Longer ones are left to folly.
+  static constexpr int32_t kMaxDoubleLength = 32;
+
+  // Returns the paths in 'active' that have more than 'nesting' tokens.
+  uint64_t continuing(uint64_t active, int32_t nesting) const {
+    uint64_t result = 0;
+    for (auto bits = active; bits; bits &= bits - 1) {
+      const auto i = __builtin_ctzll(bits);
+      if (static_cast<int32_t>(paths_[i]->tokens().size()) > nesting) {
+        result |= 1ULL << i;
       }
     }
+    return result;
+  }
+
+  // Scans the value at 'pos_'. 'active' has a bit set for each path whose
+  // first 'nesting' tokens are matched by the keys and indices leading to the
+  // value.
+  bool scanValue(uint64_t active, int32_t nesting) {
+    skipWhitespace();
+    if (pos_ == end_ || nesting > kMaxNesting) {
+      return false;
+    }
+    const char* begin = pos_;
+    bool ok;
+    switch (*pos_) {
+      case '{':
+        ok = scanObject(active, nesting);
+        break;
+      case '[':
+        ok = scanArray(active, nesting);
+        break;
+      case '"': {
+        folly::StringPiece contents;
+        bool hasEscapes;
+        ok = scanString(contents, hasEscapes);
+        break;
+      }
+      case 't':
+        ok = scanLiteral("true");
+        break;
+      case 'f':
+        ok = scanLiteral("false");
+        break;
+      case 'n':
+        ok = scanLiteral("null");
+        break;
+      default:
+        ok = scanNumber();
+    }
+    if (ok && active) {
+      for (auto bits = active & ~continuing(active, nesting); bits;
+           bits &= bits - 1) {
+        const auto i = __builtin_ctzll(bits);
+        found_ |= 1ULL << i;
+        values_[i] = folly::StringPiece(begin, pos_);
+      }
+    }
+    return ok;
+  }
+
+  bool scanObject(uint64_t active, int32_t nesting) {
+    const uint64_t onPath = continuing(active, nesting);
+    ++pos_;
+    skipWhitespace();
+    if (consume('}')) {
+      return true;
+    }
+    do {
+      skipWhitespace();
+      folly::StringPiece key;
+      bool hasEscapes;
+      if (pos_ == end_ || *pos_ != '"' || !scanString(key, hasEscapes)) {
+        return false;
+      }
+      uint64_t childActive = 0;
+      if (onPath) {
+        if (hasEscapes) {
+          return false;
+        }
+        for (auto bits = onPath; bits; bits &= bits - 1) {
+          const auto i = __builtin_ctzll(bits);
+          if (key != paths_[i]->tokens()[nesting]) {
+            continue;
+          }
+          // The last of duplicate keys wins in folly::dynamic. Give up
+          // rather than undo what was found under the earlier one. A path
+          // continues into one object per nesting level, so an earlier match
+          // at this level was in this object.
+          if (matchedDepth_[i] >= nesting) {
+            return false;
+          }
+          matchedDepth_[i] = nesting;
+          childActive |= 1ULL << i;
+        }
+      }
+      skipWhitespace();
+      if (!consume(':') || !scanValue(childActive, nesting + 1)) {
+        return false;
+      }
+      skipWhitespace();
+    } while (consume(','));
+    return consume('}');
   }
-}
+
+  bool scanArray(uint64_t active, int32_t nesting) {
+    const uint64_t onPath = continuing(active, nesting);
+    ++pos_;
+    skipWhitespace();
+    if (consume(']')) {
+      return true;
+    }
+    int32_t index = 0;
+    do {
+      uint64_t childActive = 0;
+      for (auto bits = onPath; bits; bits &= bits - 1) {
+        const auto i = __builtin_ctzll(bits);
+        if (paths_[i]->indices()[nesting] == index) {
+          childActive |= 1ULL << i;
+        }
+      }
+      if (!scanValue(childActive, nesting + 1)) {
+        return false;
+      }
+      ++index;
+      skipWhitespace();
+    } while (consume(','));
+    return consume(']');
+  }
+
+  // Scans a string at 'pos_' and sets 'contents' to the text between the
+  // quotes.
+  bool scanString(folly::StringPiece& contents, bool& hasEscapes) {
+    hasEscapes = false;
+    const char* begin = ++pos_;
+    while (pos_ < end_) {
+      const auto c = static_cast<unsigned char>(*pos_);
+      if (c == '"') {
+        contents = folly::StringPiece(begin, pos_);
+        ++pos_;
+        return true;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      if (c == '\\') {
+        hasEscapes = true;
+        if (++pos_ == end_) {
+          return false;
+        }
+        if (*pos_ == 'u') {
+          if (end_ - pos_ < 5) {
+            return false;
+          }
+          uint32_t codePoint = 0;
+          for (auto i = 1; i <= 4; ++i) {
+            if (!std::isxdigit(pos_[i])) {
+              return false;
+            }
+            const int digit = std::tolower(pos_[i]);
+            codePoint *= 16;
+            codePoint += digit <= '9' ? digit - '0' : digit - 'a' + 10;
+          }
+          // Leave surrogate pairs to folly.
+          if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+            return false;
+          }
+          pos_ += 4;
+        } else if (!std::strchr("\"\\/bfnrt", *pos_) || *pos_ == '\0') {
+          return false;
+        }
+      }
+      ++pos_;
+    }
+    return false;
+  }
+
+  // Scans -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  bool scanNumber() {
+    consume('-');
+    const char* integerBegin = pos_;
+    if (consume('0')) {
+      if (pos_ < end_ && std::isdigit(*pos_)) {
+        return false;
+      }
+    } else if (!scanDigits()) {
+      return false;
+    }
+    bool isInteger = true;
+    if (consume('.')) {
+      isInteger = false;
+      if (!scanDigits()) {
+        return false;
+      }
+    }
+    if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+      isInteger = false;
+      ++pos_;
+      if (!consume('+')) {
+        consume('-');
+      }
+      const char* exponentBegin = pos_;
+      if (!scanDigits() || pos_ - exponentBegin > 2) {
+        return false;
+      }
+    }
+    // Integers out of the range of int64_t fail to parse in folly. Leave
+    // numbers that may overflow a double to folly as well.
+    return isInteger ? pos_ - integerBegin <= 18
+                     : pos_ - integerBegin <= kMaxDoubleLength;
+  }
+
+  bool scanDigits() {
+    const char* begin = pos_;
+    while (pos_ < end_ && std::isdigit(*pos_)) {
+      ++pos_;
+    }
+    return pos_ != begin;
+  }
+
+  bool scanLiteral(folly::StringPiece literal) {
+    if (folly::StringPiece(pos_, end_).startsWith(literal)) {
+      pos_ += literal.size();
+      return true;
+    }
+    return false;
+  }
+
+  bool consume(char c) {
+    if (pos_ < end_ && *pos_ == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  void skipWhitespace() {
+    while (pos_ < end_ &&
+           (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\t' || *pos_ == '\r')) {
+      ++pos_;
+    }
+  }
+
+  const folly::Range<const JsonExtractor* const*> paths_;
+  const char* pos_;
+  const char* const end_;
+
+  // The deepest nesting level at which a key matched each path.
+  std::array<int32_t, kMaxPaths> matchedDepth_;
+
+  uint64_t found_{0};
+  folly::StringPiece* values_{nullptr};
+};
+
+thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
+    JsonExtractor::kExtractorCache;
+thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
 
 folly::Optional<folly::dynamic> JsonExtractor::extract(
-    const folly::dynamic& json) {
+    const folly::dynamic& json) const {
   JsonVector input;
   // Temporary extraction result holder, swap with input after
   // each iteration.
@@ -166,6 +499,27 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
+JsonExtractor::ScanResult JsonExtractor::scan(
+    folly::StringPiece json,
+    folly::StringPiece& value) const {
+  if (hasWildcard_) {
+    return ScanResult::kUnsupported;
+  }
+  const JsonExtractor* self = this;
+  uint64_t found;
+  if (!JsonPathScanner({&self, 1}, json).scan(found, &value)) {
+    return ScanResult::kUnsupported;
+  }
+  return found ? ScanResult::kFound : ScanResult::kNotFound;
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::JsonExtractor;
+using detail::JsonPathScanner;
+
 bool isScalarType(const folly::Optional<folly::dynamic>& json) {
   return json.has_value() && !json->isObject() && !json->isArray() &&
       !json->isNull();
@@ -182,6 +536,15 @@ folly::Optional<folly::dynamic> jsonExtract(
     // json parsing failures (in which cases we return folly::none instead of
     // throw).
     auto& extractor = JsonExtractor::getInstance(path);
+    folly::StringPiece value;
+    switch (extractor.scan(json, value)) {
+      case JsonExtractor::ScanResult::kFound:
+        return folly::parseJson(value);
+      case JsonExtractor::ScanResult::kNotFound:
+        return folly::none;
+      case JsonExtractor::ScanResult::kUnsupported:
+        break;
+    }
     return extractor.extract(folly::parseJson(json));
   } catch (const folly::json::parse_error&) {
   } catch (const folly::ConversionError&) {
@@ -207,19 +570,70 @@ folly::Optional<folly::dynamic> jsonExtract(
   return folly::none;
 }
 
+namespace {
+
+// Returns the scalar value of the JSON text 'value' as jsonExtractScalar()
+// does. Strings without escapes and integers are taken as they are. Other
+// values are parsed to be formatted the same way folly::dynamic does.
+folly::Optional<std::string> scalarFromText(folly::StringPiece value) {
+  switch (value.front()) {
+    case '{':
+    case '[':
+    case 'n':
+      return folly::none;
+    case 't':
+      return std::string{"true"};
+    case 'f':
+      return std::string{"false"};
+    case '"':
+      if (value.find('\\') == folly::StringPiece::npos) {
+        return value.subpiece(1, value.size() - 2).str();
+      }
+      return folly::parseJson(value).asString();
+    default:
+      if (value.find_first_of(".eE") == folly::StringPiece::npos &&
+          value != "-0") {
+        return value.str();
+      }
+      return folly::parseJson(value).asString();
+  }
+}
+
+// Returns the scalar value of 'json' as jsonExtractScalar() does, or
+// folly::none if it is not a scalar.
+folly::Optional<std::string> scalarFromDynamic(
+    const folly::Optional<folly::dynamic>& json) {
+  if (!isScalarType(json)) {
+    return folly::none;
+  }
+  if (json->isBool()) {
+    return json->asBool() ? std::string{"true"} : std::string{"false"};
+  }
+  return json->asString();
+}
+
+} // namespace
+
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
+  try {
+    folly::StringPiece value;
+    switch (JsonExtractor::getInstance(path).scan(json, value)) {
+      case JsonExtractor::ScanResult::kFound:
+        return scalarFromText(value);
+      case JsonExtractor::ScanResult::kNotFound:
+        return folly::none;
+      case JsonExtractor::ScanResult::kUnsupported:
+        break;
     }
+  } catch (const folly::json::parse_error&) {
+    return folly::none;
+  } catch (const folly::ConversionError&) {
+    return folly::none;
   }
-  return folly::none;
+
+  return scalarFromDynamic(jsonExtract(json, path));
 }
 
 folly::Optional<std::string> jsonExtractScalar(
@@ -231,4 +645,70 @@ folly::Optional<std::string> jsonExtractScalar(
   return jsonExtractScalar(jsonPiece, pathPiece);
 }
 
+JsonMultiPathExtractor::JsonMultiPathExtractor(
+    const std::vector<std::string>& paths) {
+  extractors_.reserve(paths.size());
+  for (const auto& path : paths) {
+    extractors_.push_back(std::make_unique<JsonExtractor>(
+        folly::trimWhitespace(path).str()));
+    if (!extractors_.back()->hasWildcard()) {
+      scanned_.push_back(extractors_.back().get());
+      scannedPositions_.push_back(extractors_.size() - 1);
+    }
+  }
+}
+
+JsonMultiPathExtractor::~JsonMultiPathExtractor() = default;
+
+void JsonMultiPathExtractor::extractScalars(
+    folly::StringPiece json,
+    std::vector<folly::Optional<std::string>>& results) const {
+  results.assign(extractors_.size(), folly::none);
+  // Whether each extractor is left to extract from the parsed document.
+  std::vector<bool> needsParse(extractors_.size(), true);
+  bool anyNeedsParse = scanned_.size() < extractors_.size();
+
+  std::array<folly::StringPiece, JsonPathScanner::kMaxPaths> values;
+  for (size_t begin = 0; begin < scanned_.size();
+       begin += JsonPathScanner::kMaxPaths) {
+    const auto end = std::min<size_t>(
+        begin + JsonPathScanner::kMaxPaths, scanned_.size());
+    uint64_t found;
+    if (!JsonPathScanner({scanned_.data() + begin, scanned_.data() + end}, json)
+             .scan(found, values.data())) {
+      anyNeedsParse = true;
+      continue;
+    }
+    for (auto i = begin; i < end; ++i) {
+      const auto position = scannedPositions_[i];
+      needsParse[position] = false;
+      if (!(found & (1ULL << (i - begin)))) {
+        continue;
+      }
+      try {
+        results[position] = scalarFromText(values[i - begin]);
+      } catch (const folly::json::parse_error&) {
+      } catch (const folly::ConversionError&) {
+      }
+    }
+  }
+  if (!anyNeedsParse) {
+    return;
+  }
+
+  folly::dynamic parsed;
+  try {
+    parsed = folly::parseJson(json);
+  } catch (const folly::json::parse_error&) {
+    return;
+  } catch (const folly::ConversionError&) {
+    return;
+  }
+  for (auto i = 0; i < extractors_.size(); ++i) {
+    if (needsParse[i]) {
+      results[i] = scalarFromDynamic(extractors_[i]->extract(parsed));
+    }
+  }
+}
+
 } // namespace facebook::velox::functions
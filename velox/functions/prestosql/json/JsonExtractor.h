@@ -16,13 +16,19 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "folly/Range.h"
 #include "folly/dynamic.h"
 
 namespace facebook::velox::functions {
 
+namespace detail {
+class JsonExtractor;
+} // namespace detail
+
 /**
  * Extract a json object from path
  * @param json: A json object
@@ -71,4 +77,34 @@ folly::Optional<std::string> jsonExtractScalar(
     const std::string& json,
     const std::string& path);
 
+/// Extracts the scalar values at several paths from the same JSON documents.
+/// Each document is scanned once for all the paths, instead of once per path
+/// as separate jsonExtractScalar() calls do. The results are the same as those
+/// of jsonExtractScalar() for each path.
+class JsonMultiPathExtractor {
+ public:
+  /// Throws VeloxUserError if any of 'paths' is invalid.
+  explicit JsonMultiPathExtractor(const std::vector<std::string>& paths);
+
+  ~JsonMultiPathExtractor();
+
+  size_t numPaths() const {
+    return extractors_.size();
+  }
+
+  /// Sets 'results' to the scalar value at each of the paths in 'json', or to
+  /// folly::none where jsonExtractScalar() returns folly::none.
+  void extractScalars(
+      folly::StringPiece json,
+      std::vector<folly::Optional<std::string>>& results) const;
+
+ private:
+  std::vector<std::unique_ptr<detail::JsonExtractor>> extractors_;
+
+  // The extractors that the scanner supports, i.e. those without wildcards,
+  // and their positions in 'extractors_'.
+  std::vector<const detail::JsonExtractor*> scanned_;
+  std::vector<size_t> scannedPositions_;
+};
+
 } // namespace facebook::velox::functions
@@ -23,6 +23,7 @@
 using facebook::velox::VeloxUserError;
 using facebook::velox::functions::jsonExtract;
 using facebook::velox::functions::jsonExtractScalar;
+using facebook::velox::functions::JsonMultiPathExtractor;
 using folly::json::parse_error;
 using namespace std::string_literals;
 
@@ -501,3 +502,93 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+// The values found without parsing the document into a folly::dynamic match
+// those found by walking the parsed document.
+TEST(JsonExtractorTest, scanWithoutParsing) {
+  // Numbers are formatted as by folly::dynamic.
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": -0}"s, "$.a"s, "0"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1.50}"s, "$.a"s, "1.5"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1e2}"s, "$.a"s, "100"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 123456789012}"s, "$.a"s, "123456789012"s);
+  EXPECT_SCALAR_VALUE_EQ("[true, false]"s, "$[1]"s, "false"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": \"x\\ny\"}"s, "$.a"s, "x\ny"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": \"\\u00e9\"}"s, "$.a"s, "\u00e9"s);
+
+  // Values are skipped without being matched.
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"b\": {\"a\": 1}, \"c\": [\"a\", {\"a\": 2}], \"a\": 3}"s,
+      "$.a"s,
+      "3"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"b\": \"}\\\"\", \"a\": {\"c\": [[], {}, \"]\"]}}"s,
+      "$.a.c[2]"s,
+      "]"s);
+  EXPECT_JSON_VALUE_EQ(
+      "{\"a\": {\"b\": [1, {\"c\": null}]}}"s, "$.a.b[1]"s, "{\"c\":null}"s);
+  EXPECT_JSON_VALUE_EQ("{\"a\": {\"b\": null}}"s, "$.a.b"s, "null"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": {\"b\": 1}}"s, "$.a.c"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": [1, 2]}"s, "$.a[2]"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1}"s, "$.a.b"s);
+
+  // Invalid documents give no value, even if the path is found before the
+  // error.
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": }"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1} x"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": [1, 2}"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": tru}"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, "s, "$.a"s);
+
+  // Deep nesting.
+  std::string deep = "{\"a\": 1, \"b\": "s;
+  for (auto i = 0; i < 80; ++i) {
+    deep += "[";
+  }
+  for (auto i = 0; i < 80; ++i) {
+    deep += "]";
+  }
+  deep += "}";
+  EXPECT_SCALAR_VALUE_EQ(deep, "$.a"s, "1"s);
+}
+
+// Extracting several paths in one scan gives the same values as extracting
+// each path by itself.
+TEST(JsonExtractorTest, multiPath) {
+  std::vector<std::string> paths = {
+      "$.a",
+      "$.b.c",
+      "$.b.d[1]",
+      "$.b",
+      "$.e[*]",
+      "$",
+      "$.missing",
+      " $.a ",
+  };
+  // More paths than are scanned for at once.
+  for (auto i = 0; i < 70; ++i) {
+    paths.push_back("$.f[" + std::to_string(i % 3) + "]");
+  }
+  JsonMultiPathExtractor extractor(paths);
+  ASSERT_EQ(extractor.numPaths(), paths.size());
+
+  const std::vector<std::string> documents = {
+      R"({"a": 1, "b": {"c": "x", "d": [true, 2.5]}, "e": ["y"], "f": [1]})",
+      R"({"b": {"d": [1], "c": null}, "a": "\u00e9"})",
+      R"({"a": 123456789012345678901234567890, "b": {"c": 1}})",
+      R"({"a": 1, "b": })",
+      R"([1, 2])",
+      R"("text")",
+      R"({"f": [0, 1, 2], "b": {"d": [{}, "z"]}})",
+  };
+  std::vector<folly::Optional<std::string>> results;
+  for (const auto& document : documents) {
+    extractor.extractScalars(document, results);
+    ASSERT_EQ(results.size(), paths.size());
+    for (auto i = 0; i < paths.size(); ++i) {
+      EXPECT_EQ(results[i], jsonExtractScalar(document, paths[i]))
+          << document << " " << paths[i];
+    }
+  }
+
+  EXPECT_THROW(JsonMultiPathExtractor({"$.a", "$k1"}), VeloxUserError);
+}
@@ -39,6 +39,8 @@ void registerJsonFunctions(const std::string& prefix) {
       {prefix + "json_size"});
   VELOX_REGISTER_VECTOR_FUNCTION(udf_json_format, prefix + "json_format");
   VELOX_REGISTER_VECTOR_FUNCTION(udf_json_parse, prefix + "json_parse");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_json_extract_scalars, prefix + "$internal$json_extract_scalars");
 }
 
 } // namespace facebook::velox::functions
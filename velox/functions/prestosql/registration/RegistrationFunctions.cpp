@@ -15,6 +15,8 @@
  */
 #include <string>
 
+#include "velox/expression/SimpleFunctionRegistry.h"
+
 namespace facebook::velox::functions {
 
 extern void registerArithmeticFunctions(const std::string& prefix);
@@ -88,6 +90,9 @@ void registerBitwiseFunctions(const std::string& prefix) {
 }
 
 void registerAllScalarFunctions(const std::string& prefix) {
+  // Most of the instantiations registered here are never used by a given
+  // process, so their signatures are parsed on the first use of their name.
+  exec::SimpleFunctionRegistry::LazyRegistration lazy(exec::SimpleFunctions());
   registerArithmeticFunctions(prefix);
   registerCheckedArithmeticFunctions(prefix);
   registerComparisonFunctions(prefix);
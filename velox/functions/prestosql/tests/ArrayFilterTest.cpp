@@ -233,3 +233,24 @@ TEST_F(ArrayFilterTest, try) {
       {{{1, 2}}, std::nullopt, {{6, 7, 8, 9}}, {{10, 11, 12, 13}}});
   assertEqualVectors(expected, result);
 }
+
+TEST_F(ArrayFilterTest, chained) {
+  auto input = makeRowVector({
+      makeNullableArrayVector<int64_t>({
+          {1, 0, 2, std::nullopt, 6},
+          {0, 0},
+          {},
+          {3, 4, 12, 24},
+      }),
+  });
+
+  // The predicates are composed into one over the elements of c0. The second
+  // one is only evaluated for the elements that pass the first one, so there
+  // is no division by zero.
+  const std::string chained =
+      "filter(filter(c0, x -> x <> 0), y -> 12 / y > 2)";
+  auto exprSet = compileExpression(chained, asRowType(input->type()));
+  EXPECT_EQ("c0", exprSet->expr(0)->inputs()[0]->toString());
+  auto expected = makeArrayVector<int64_t>({{1, 2}, {}, {}, {3, 4}});
+  assertEqualVectors(expected, evaluate(chained, input));
+}
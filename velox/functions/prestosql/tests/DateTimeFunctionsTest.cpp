@@ -17,6 +17,7 @@
 #include <optional>
 #include <string>
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/external/date/tz.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/tz/TimeZoneMap.h"
@@ -1350,6 +1351,40 @@ TEST_F(DateTimeFunctionsTest, dateTrunc) {
       dateTrunc("year", Timestamp(998'474'645, 321'001'234)));
 }
 
+TEST_F(DateTimeFunctionsTest, sortedAcrossTransitions) {
+  // Every 5 minutes around the end and the start of daylight saving time in
+  // 2021. Consecutive rows reuse the cached offset of the session time zone.
+  std::vector<Timestamp> timestamps;
+  for (int64_t transition : {1'615'716'000, 1'636'275'600}) {
+    for (auto i = -300; i < 300; ++i) {
+      timestamps.emplace_back(transition + i * 300, 0);
+    }
+  }
+  auto data = makeRowVector({makeFlatVector(timestamps)});
+
+  setQueryTimeZone("America/Los_Angeles");
+  const auto* zone = date::locate_zone("America/Los_Angeles");
+  auto hours = evaluate<SimpleVector<int64_t>>("hour(c0)", data);
+  auto hourStarts =
+      evaluate<SimpleVector<Timestamp>>("date_trunc('hour', c0)", data);
+  auto dayStarts =
+      evaluate<SimpleVector<Timestamp>>("date_trunc('day', c0)", data);
+  for (auto i = 0; i < timestamps.size(); ++i) {
+    auto local = timestamps[i];
+    local.toTimezone(*zone);
+    const auto secondOfDay = local.getSeconds() % 86'400;
+    EXPECT_EQ(hours->valueAt(i), secondOfDay / 3'600) << i;
+
+    Timestamp hourStart(local.getSeconds() - secondOfDay % 3'600, 0);
+    hourStart.toGMT(*zone);
+    EXPECT_EQ(hourStarts->valueAt(i), hourStart) << i;
+
+    Timestamp dayStart(local.getSeconds() - secondOfDay, 0);
+    dayStart.toGMT(*zone);
+    EXPECT_EQ(dayStarts->valueAt(i), dayStart) << i;
+  }
+}
+
 TEST_F(DateTimeFunctionsTest, dateTruncDate) {
   const auto dateTrunc = [&](const std::string& unit,
                              std::optional<Date> date) {
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "velox/expression/FieldReference.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 
@@ -192,6 +193,61 @@ TEST_F(JsonExtractScalarTest, wildcardSelect) {
       std::nullopt);
 }
 
+// Calls with constant paths on the same input share one scan of each document.
+TEST_F(JsonExtractScalarTest, sharedScan) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<StringView>(
+          {R"({"a": 1, "b": {"c": "x"}})"_sv,
+           std::nullopt,
+           R"({"b": {"c": [1]}, "a": true})"_sv,
+           R"(not json)"_sv,
+           R"({"b": {"c": "y"}, "a": "z"})"_sv},
+          JSON()),
+      makeFlatVector<StringView>(
+          {R"({"a": 2})"_sv,
+           R"({"a": 3})"_sv,
+           R"({"a": 4})"_sv,
+           R"({"a": 5})"_sv,
+           R"({"a": 6})"_sv},
+          JSON()),
+  });
+  const std::vector<std::string> projections = {
+      "json_extract_scalar(c0, '$.a')",
+      "concat(json_extract_scalar(c0, '$.b.c'), '-')",
+      "if(c0 is null, json_extract_scalar(c1, '$.a'), "
+      "json_extract_scalar(c0, '$.a'))",
+      "json_extract_scalar(c1, '$.a')",
+  };
+  auto exprSet = compileExpressions(projections, asRowType(data->type()));
+
+  // The calls on c0 read the fields of one call.
+  const auto* field =
+      dynamic_cast<const exec::FieldReference*>(exprSet->expr(0).get());
+  ASSERT_NE(field, nullptr);
+  ASSERT_EQ(field->inputs().size(), 1);
+  EXPECT_EQ(field->inputs()[0]->name(), "$internal$json_extract_scalars");
+  EXPECT_EQ(field->inputs()[0], exprSet->expr(1)->inputs()[0]->inputs()[0]);
+
+  exec::EvalCtx context(&execCtx_, exprSet.get(), data.get());
+  SelectivityVector rows(data->size());
+  std::vector<VectorPtr> results(projections.size());
+  exprSet->eval(rows, context, results);
+  for (auto i = 0; i < projections.size(); ++i) {
+    velox::test::assertEqualVectors(
+        evaluate(projections[i], data), results[i]);
+  }
+
+  // Invalid paths fail only where they are evaluated.
+  EXPECT_EQ(
+      evaluateOnce<std::string>(
+          "if(c0 is null, json_extract_scalar(c1, '$k1'), "
+          "json_extract_scalar(c1, '$.a'))",
+          makeRowVector(
+              {makeNullableFlatVector<int64_t>({1}),
+               makeJsonVector(R"({"a": 1})")})),
+      "1");
+}
+
 } // namespace
 
 } // namespace facebook::velox::functions::prestosql
@@ -270,3 +270,28 @@ TEST_F(MapFilterTest, try) {
       {{{{1, 2}, {2, 3}}}, std::nullopt, {{{7, 8}}}, {{}}});
   assertEqualVectors(expected, result);
 }
+
+TEST_F(MapFilterTest, chained) {
+  auto data = makeRowVector({
+      makeMapVector<int64_t, int64_t>({
+          {{1, 0}, {4, 2}},
+          {{3, 4}, {6, 0}, {10, 5}},
+          {},
+          {{8, 8}},
+      }),
+  });
+
+  // The predicates are composed into one over the entries of c0. The second
+  // one is only evaluated for the entries that pass the first one.
+  const std::string chained =
+      "map_filter(map_filter(c0, (k, v) -> v <> 0), (k, v) -> k / v > 1)";
+  auto exprSet = compileExpression(chained, asRowType(data->type()));
+  EXPECT_EQ("c0", exprSet->expr(0)->inputs()[0]->toString());
+  auto expected = makeMapVector<int64_t, int64_t>({
+      {{4, 2}},
+      {{10, 5}},
+      {},
+      {},
+  });
+  assertEqualVectors(expected, evaluate(chained, data));
+}
@@ -180,3 +180,28 @@ TEST_F(ReduceTest, try) {
       makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, 0});
   assertEqualVectors(expectedResult, result);
 }
+
+TEST_F(ReduceTest, overTransform) {
+  vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      makeArrayVector<int64_t>(size, modN(5), modN(7), nullEvery(11)),
+  });
+  auto inner = evaluate("transform(c0, x -> x * 3)", input);
+  auto expected = evaluate(
+      "reduce(c0, 0, (s, y) -> s + y, s -> s * 10)", makeRowVector({inner}));
+
+  // The lambda of transform is composed into the one of reduce.
+  const std::string chained =
+      "reduce(transform(c0, x -> x * 3), 0, (s, y) -> s + y, s -> s * 10)";
+  auto exprSet = compileExpression(chained, asRowType(input->type()));
+  EXPECT_EQ("c0", exprSet->expr(0)->inputs()[0]->toString());
+  assertEqualVectors(expected, evaluate(chained, input));
+
+  // The parameter of the lambda of transform has the name of the state, so
+  // the lambdas are not composed.
+  const std::string sameNames =
+      "reduce(transform(c0, s -> s * 3), 0, (s, y) -> s + y, s -> s * 10)";
+  exprSet = compileExpression(sameNames, asRowType(input->type()));
+  EXPECT_EQ("transform", exprSet->expr(0)->inputs()[0]->name());
+  assertEqualVectors(expected, evaluate(sameNames, input));
+}
@@ -159,3 +159,33 @@ TEST_F(TransformTest, try) {
   });
   assertEqualVectors(expectedResult, result);
 }
+
+TEST_F(TransformTest, chained) {
+  vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      makeArrayVector<int64_t>(size, modN(5), modN(7), nullEvery(11)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+  });
+  auto inner = evaluate("transform(c0, x -> x + 1)", input);
+  auto expected = evaluate(
+      "transform(c0, y -> y * c1)", makeRowVector({inner, input->childAt(1)}));
+
+  // The lambdas are composed into one over the elements of c0.
+  const std::string chained =
+      "transform(transform(c0, x -> x + 1), y -> y * c1)";
+  auto exprSet = compileExpression(chained, asRowType(input->type()));
+  EXPECT_EQ("c0", exprSet->expr(0)->inputs()[0]->toString());
+  assertEqualVectors(expected, evaluate(chained, input));
+
+  // The capture x of the second lambda would be shadowed by the parameter of
+  // the first one, so the lambdas are not composed.
+  input = makeRowVector({"c0", "x"}, {input->childAt(0), input->childAt(1)});
+  expected = evaluate(
+      "transform(c0, y -> y + x)",
+      makeRowVector({"c0", "x"}, {inner, input->childAt(1)}));
+  const std::string shadowing =
+      "transform(transform(c0, x -> x + 1), y -> y + x)";
+  exprSet = compileExpression(shadowing, asRowType(input->type()));
+  EXPECT_EQ("transform", exprSet->expr(0)->inputs()[0]->name());
+  assertEqualVectors(expected, evaluate(shadowing, input));
+}
@@ -39,13 +39,13 @@ class RankFunction : public exec::WindowFunction {
   void resetPartition(const exec::WindowPartition* partition) override {
     rank_ = 1;
     currentPeerGroupStart_ = 0;
-    previousPeerCount_ = 0;
+    partitionOffset_ = 0;
     numPartitionRows_ = partition->numRows();
   }
 
   void apply(
       const BufferPtr& peerGroupStarts,
-      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& peerGroupEnds,
       const BufferPtr& /*frameStarts*/,
       const BufferPtr& /*frameEnds*/,
       const SelectivityVector& validRows,
@@ -53,39 +53,54 @@ class RankFunction : public exec::WindowFunction {
       const VectorPtr& result) override {
     int numRows = peerGroupStarts->size() / sizeof(vector_size_t);
     auto* rawPeerStarts = peerGroupStarts->as<vector_size_t>();
-    auto rawValues = result->asFlatVector<TResult>()->mutableRawValues();
-
-    for (int i = 0; i < numRows; i++) {
-      auto start = rawPeerStarts[i];
-      if (start != currentPeerGroupStart_) {
-        currentPeerGroupStart_ = start;
-        if constexpr (TRank == RankType::kDenseRank) {
-          if (previousPeerCount_ > 0) {
-            ++rank_;
-          }
-        } else {
-          rank_ += previousPeerCount_;
-        }
-        previousPeerCount_ = 0;
+    auto* rawValues =
+        result->asFlatVector<TResult>()->mutableRawValues() + resultOffset;
+
+    // The peer group starts are offsets in the partition. The rank of a row
+    // is one more than the number of rows before its peer group, so rank and
+    // percent_rank are computed without a dependency between rows.
+    if constexpr (TRank == RankType::kRank) {
+      for (int i = 0; i < numRows; i++) {
+        rawValues[i] = rawPeerStarts[i] + 1;
       }
-
-      if constexpr (TRank == RankType::kPercentRank) {
-        rawValues[resultOffset + i] = (numPartitionRows_ == 1)
-            ? 0
-            : double(rank_ - 1) / (numPartitionRows_ - 1);
+    } else if constexpr (TRank == RankType::kPercentRank) {
+      if (numPartitionRows_ == 1) {
+        std::fill_n(rawValues, numRows, 0);
       } else {
-        rawValues[resultOffset + i] = rank_;
+        const double denominator = numPartitionRows_ - 1;
+        for (int i = 0; i < numRows; i++) {
+          rawValues[i] = rawPeerStarts[i] / denominator;
+        }
+      }
+    } else {
+      // The dense rank counts the peer groups, which are filled a run at a
+      // time. A peer group may continue from the previous call.
+      auto* rawPeerEnds = peerGroupEnds->as<vector_size_t>();
+      int i = 0;
+      while (i < numRows) {
+        if (rawPeerStarts[i] != currentPeerGroupStart_) {
+          currentPeerGroupStart_ = rawPeerStarts[i];
+          ++rank_;
+        }
+        // The peer group ends are inclusive partition offsets.
+        const int end =
+            std::min(numRows, rawPeerEnds[i] - partitionOffset_ + 1);
+        std::fill(rawValues + i, rawValues + end, rank_);
+        i = end;
       }
-      previousPeerCount_ += 1;
     }
+    partitionOffset_ += numRows;
 
     // Set NULL values for rows with empty frames.
     setNullEmptyFramesResults(validRows, resultOffset, result);
   }
 
  private:
+  // Offset in the partition of the start of the peer group of 'rank_'. Only
+  // used by dense_rank.
   int32_t currentPeerGroupStart_ = 0;
-  int32_t previousPeerCount_ = 0;
+  // Offset in the partition of the first row of the next call to apply().
+  vector_size_t partitionOffset_ = 0;
   int64_t rank_ = 1;
   vector_size_t numPartitionRows_ = 1;
 };
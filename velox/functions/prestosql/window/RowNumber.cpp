@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <numeric>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/FunctionSignature.h"
@@ -40,10 +42,10 @@ class RowNumberFunction : public exec::WindowFunction {
       vector_size_t resultOffset,
       const VectorPtr& result) override {
     int numRows = peerGroupStarts->size() / sizeof(vector_size_t);
-    auto* rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
-    for (int i = 0; i < numRows; i++) {
-      rawValues[resultOffset + i] = rowNumber_++;
-    }
+    auto* rawValues =
+        result->asFlatVector<int64_t>()->mutableRawValues() + resultOffset;
+    std::iota(rawValues, rawValues + numRows, rowNumber_);
+    rowNumber_ += numRows;
 
     // Set NULL values for rows with empty frames.
     setNullEmptyFramesResults(validRows, resultOffset, result);
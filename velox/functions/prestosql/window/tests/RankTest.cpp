@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/functions/prestosql/window/tests/WindowTestBase.h"
 
 using namespace facebook::velox::exec::test;
@@ -102,6 +106,107 @@ TEST_P(RankTest, rangeFrames) {
   testKRangeFrames(function_);
 }
 
+class RowNumberTest : public WindowTestBase {};
+
+TEST_F(RowNumberTest, spill) {
+  std::vector<RowVectorPtr> input;
+  for (int i = 0; i < 10; ++i) {
+    input.push_back(makeSimpleVector(100));
+  }
+  createDuckDbTable(input);
+
+  for (const auto& overClause : kOverClauses) {
+    const auto functionSql = fmt::format("row_number() over ({})", overClause);
+    SCOPED_TRACE(functionSql);
+    core::PlanNodeId windowId;
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .window({functionSql})
+                    .capturePlanNodeId(windowId)
+                    .planNode();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .spillDirectory(spillDirectory->path)
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kWindowSpillEnabled, "true")
+            .assertResults(fmt::format(
+                "SELECT c0, c1, c2, c3, {} FROM tmp", functionSql));
+    const auto windowStats = toPlanStats(task->taskStats()).at(windowId);
+    ASSERT_LT(0, windowStats.spilledBytes);
+    ASSERT_EQ(1, windowStats.spilledPartitions);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
+
+TEST_F(RowNumberTest, streaming) {
+  std::vector<RowVectorPtr> input;
+  for (int i = 0; i < 10; ++i) {
+    input.push_back(makeSimpleVector(100));
+  }
+  createDuckDbTable(input);
+
+  for (const auto& rankFunction : kRankFunctions) {
+    const auto functionSql = fmt::format(
+        "{} over (partition by c0 order by c1 asc nulls last, c2, c3)",
+        rankFunction);
+    SCOPED_TRACE(functionSql);
+    // The streaming window relies on the input being sorted on the partition
+    // and sort keys.
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .orderBy({"c0", "c1 ASC NULLS LAST", "c2", "c3"}, false)
+                    .streamingWindow({functionSql})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kMaxOutputBatchRows, "7")
+        .assertResults(
+            fmt::format("SELECT c0, c1, c2, c3, {} FROM tmp", functionSql));
+  }
+}
+
+TEST_F(RowNumberTest, peerGroupsAcrossOutputBatches) {
+  // Peer groups of 10 rows in partitions of 100 rows, produced 7 rows at a
+  // time, so that peer groups and partitions span output batches.
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row / 100; }),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row / 10; }),
+  });
+  createDuckDbTable({input});
+
+  for (const auto& rankFunction : kRankFunctions) {
+    const auto functionSql =
+        fmt::format("{} over (partition by c0 order by c1)", rankFunction);
+    SCOPED_TRACE(functionSql);
+    auto plan = PlanBuilder().values({input}).window({functionSql}).planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kMaxOutputBatchRows, "7")
+        .assertResults(fmt::format("SELECT c0, c1, {} FROM tmp", functionSql));
+  }
+}
+
+TEST_F(RowNumberTest, parallel) {
+  std::vector<RowVectorPtr> input;
+  for (int i = 0; i < 10; ++i) {
+    input.push_back(makeSimpleVector(100));
+  }
+  createDuckDbTable(input);
+
+  for (const auto& overClause : kOverClauses) {
+    const auto functionSql = fmt::format("row_number() over ({})", overClause);
+    SCOPED_TRACE(functionSql);
+    auto plan = PlanBuilder()
+                    .values(input, true)
+                    .parallelWindow({functionSql})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .maxDrivers(4)
+        .assertResults(
+            fmt::format("SELECT c0, c1, c2, c3, {} FROM tmp", functionSql));
+  }
+}
+
 // Run above tests for all combinations of rank function and over clauses.
 VELOX_INSTANTIATE_TEST_SUITE_P(
     RankTestInstantiation,
@@ -219,5 +219,60 @@ TEST_F(KPrecedingFollowingTest, rowsFrames) {
   testWindowFunction({vectors}, "count(c0)", {overClause}, kRangeFrames);
 }
 
+TEST_F(KPrecedingFollowingTest, rangeFramesWithNullsAndDescendingOrder) {
+  const vector_size_t size = 2'000;
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row / 3 * 2; }, nullEvery(37)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 2; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 5 + 1; }),
+  });
+  const std::vector<std::string> overClauses = {
+      "partition by c1 order by c0",
+      "partition by c1 order by c0 desc",
+      "partition by c1 order by c0 nulls first",
+      "partition by c1 order by c0 desc nulls first",
+      "order by c0",
+  };
+  const std::vector<std::string> frames = {
+      "range between 5 preceding and current row",
+      "range between current row and 5 following",
+      "range between 100 preceding and 3 following",
+      "range between c2 preceding and c2 following",
+      "range between unbounded preceding and 5 following",
+      "range between 5 preceding and unbounded following",
+      // May produce empty frames.
+      "range between 3 following and 5 following",
+      "range between 10 preceding and 1 preceding",
+  };
+  testWindowFunction({vectors}, "count(c0)", overClauses, frames);
+  testWindowFunction({vectors}, "sum(c2)", overClauses, frames);
+}
+
+// Tests frames large enough to be evaluated by retracting rows leaving the
+// frame (count, avg) or over a segment tree (sum, min, max).
+TEST_F(KPrecedingFollowingTest, largeRowsFrames) {
+  const vector_size_t size = 5'000;
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 7'919 % 10'007; }, nullEvery(11)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 3; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+  });
+  const std::vector<std::string> overClauses = {
+      "partition by c1 order by c2", "order by c2"};
+  const std::vector<std::string> frames = {
+      "rows between 100 preceding and 100 following",
+      "rows between 1000 preceding and 10 preceding",
+      "rows between 5 following and 500 following",
+      "rows between current row and unbounded following",
+      "rows between 70 preceding and current row",
+  };
+  for (const auto& function :
+       {"count(c0)", "avg(c0)", "sum(c0)", "min(c0)", "max(c0)"}) {
+    testWindowFunction({vectors}, function, overClauses, frames);
+  }
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
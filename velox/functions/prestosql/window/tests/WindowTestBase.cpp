@@ -125,10 +125,6 @@ void WindowTestBase::testWindowFunction(
 }
 
 void WindowTestBase::testKRangeFrames(const std::string& function) {
-  // The current support for k Range frames is limited to ascending sort
-  // orders without null values. Frames clauses generating empty frames
-  // are also not supported.
-
   // For deterministic results its expected that rows have a fixed ordering
   // in the partition so that the range frames are predictable. So the
   // input table.
@@ -285,7 +285,7 @@ struct HourFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       TInput& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_hour;
+    result = getSecondOfDay(getSeconds(timestamp, this->timeZone_)) / 3'600;
   }
 
   template <typename TInput>
@@ -311,7 +311,7 @@ struct MinuteFunction : public InitSessionTimezone<T>,
   FOLLY_ALWAYS_INLINE void call(
       TInput& result,
       const arg_type<Timestamp>& timestamp) {
-    result = getDateTime(timestamp, this->timeZone_).tm_min;
+    result = getSecondOfDay(getSeconds(timestamp, this->timeZone_)) / 60 % 60;
   }
 
   template <typename TInput>
@@ -16,6 +16,7 @@
 #include "velox/functions/sparksql/Hash.h"
 
 #include <folly/CPortability.h>
+#include <xsimd/xsimd.hpp>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/expression/DecodedArgs.h"
@@ -25,69 +26,6 @@
 namespace facebook::velox::functions::sparksql {
 namespace {
 
-// ReturnType can be either int32_t or int64_t
-// HashClass contains the function like hashInt32
-template <typename ReturnType, typename HashClass, typename SeedType>
-void applyWithType(
-    const SelectivityVector& rows,
-    std::vector<VectorPtr>& args, // Not using const ref so we can reuse args
-    exec::EvalCtx& context,
-    VectorPtr& resultRef) {
-  SeedType seed = 42;
-  auto hashIdx = 0;
-  if (args[0]->isConstantEncoding()) {
-    seed = args[0]->as<ConstantVector<SeedType>>()->valueAt(0);
-    hashIdx = 1;
-  }
-
-  HashClass hash;
-
-  auto& result = *resultRef->as<FlatVector<ReturnType>>();
-  rows.applyToSelected([&](int row) { result.set(row, seed); });
-
-  exec::LocalSelectivityVector selectedMinusNulls(context);
-
-  exec::DecodedArgs decodedArgs(rows, args, context);
-  for (auto i = hashIdx; i < args.size(); i++) {
-    auto decoded = decodedArgs.at(i);
-    const SelectivityVector* selected = &rows;
-    if (args[i]->mayHaveNulls()) {
-      *selectedMinusNulls.get(rows.end()) = rows;
-      selectedMinusNulls->deselectNulls(
-          decoded->nulls(), rows.begin(), rows.end());
-      selected = selectedMinusNulls.get();
-    }
-    switch (args[i]->type()->kind()) {
-// Derived from InterpretedHashFunction.hash:
-// https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
-#define CASE(typeEnum, hashFn, inputType)                                      \
-  case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
-    break;
-      CASE(BOOLEAN, hash.hashInt32, bool);
-      CASE(TINYINT, hash.hashInt32, int8_t);
-      CASE(SMALLINT, hash.hashInt32, int16_t);
-      CASE(INTEGER, hash.hashInt32, int32_t);
-      CASE(BIGINT, hash.hashInt64, int64_t);
-      CASE(VARCHAR, hash.hashBytes, StringView);
-      CASE(VARBINARY, hash.hashBytes, StringView);
-      CASE(REAL, hash.hashFloat, float);
-      CASE(DOUBLE, hash.hashDouble, double);
-      CASE(DATE, hash.hashDate, int32_t);
-      CASE(SHORT_DECIMAL, hash.hashShortDecimal, UnscaledShortDecimal);
-      CASE(LONG_DECIMAL, hash.hashLongDecimal, UnscaledLongDecimal);
-      CASE(TIMESTAMP, hash.hashTimestamp, Timestamp);
-#undef CASE
-      default:
-        VELOX_NYI(
-            "Unsupported type for HASH(): {}", args[i]->type()->toString());
-    }
-  }
-}
-
 // Derived from src/main/java/org/apache/spark/unsafe/hash/Murmur3_x86_32.java.
 //
 // Spark's Murmur3 seems slightly different from the original from Austin
@@ -97,26 +35,36 @@ void applyWithType(
 //
 // Signed integer types have been remapped to unsigned types (as in the
 // original) to avoid undefined signed integer overflow and sign extension.
+//
+// The mixing steps are templates over uint32_t and SIMD batches of uint32_t,
+// so that 32 bit values are hashed a batch at a time.
 
 class Murmur3Hash final {
  public:
   uint32_t hashInt32(int32_t input, uint32_t seed) {
-    uint32_t k1 = mixK1(input);
-    uint32_t h1 = mixH1(seed, k1);
-    return fmix(h1, 4);
+    uint32_t k1 = mixK1<uint32_t>(input);
+    uint32_t h1 = mixH1<uint32_t>(seed, k1);
+    return fmix<uint32_t>(h1, 4);
+  }
+
+  template <typename A>
+  xsimd::batch<uint32_t, A> hashInt32(
+      xsimd::batch<uint32_t, A> input,
+      xsimd::batch<uint32_t, A> seed) {
+    return fmix(mixH1(seed, mixK1(input)), 4);
   }
 
   uint32_t hashInt64(uint64_t input, uint32_t seed) {
     uint32_t low = input;
     uint32_t high = input >> 32;
 
-    uint32_t k1 = mixK1(low);
-    uint32_t h1 = mixH1(seed, k1);
+    uint32_t k1 = mixK1<uint32_t>(low);
+    uint32_t h1 = mixH1<uint32_t>(seed, k1);
 
-    k1 = mixK1(high);
-    h1 = mixH1(h1, k1);
+    k1 = mixK1<uint32_t>(high);
+    h1 = mixH1<uint32_t>(h1, k1);
 
-    return fmix(h1, 8);
+    return fmix<uint32_t>(h1, 8);
   }
 
   // Floating point numbers are hashed as if they are integers, with
@@ -138,12 +86,13 @@ class Murmur3Hash final {
     const char* const end = input.data() + input.size();
     uint32_t h1 = seed;
     for (; i <= end - 4; i += 4) {
-      h1 = mixH1(h1, mixK1(*reinterpret_cast<const uint32_t*>(i)));
+      h1 = mixH1<uint32_t>(
+          h1, mixK1<uint32_t>(*reinterpret_cast<const uint32_t*>(i)));
     }
     for (; i != end; ++i) {
-      h1 = mixH1(h1, mixK1(*i));
+      h1 = mixH1<uint32_t>(h1, mixK1<uint32_t>(*i));
     }
-    return fmix(h1, input.size());
+    return fmix<uint32_t>(h1, input.size());
   }
 
   uint32_t hashDate(Date input, uint32_t seed) {
@@ -166,48 +115,101 @@ class Murmur3Hash final {
   }
 
  private:
-  uint32_t mixK1(uint32_t k1) {
-    k1 *= 0xcc9e2d51;
-    k1 = bits::rotateLeft(k1, 15);
-    k1 *= 0x1b873593;
+  template <typename T>
+  static T rotateLeft(T value, int32_t shift) {
+    return (value << shift) | (value >> (32 - shift));
+  }
+
+  template <typename T>
+  T mixK1(T k1) {
+    k1 *= T(0xcc9e2d51);
+    k1 = rotateLeft(k1, 15);
+    k1 *= T(0x1b873593);
     return k1;
   }
 
-  uint32_t mixH1(uint32_t h1, uint32_t k1) {
+  template <typename T>
+  T mixH1(T h1, T k1) {
     h1 ^= k1;
-    h1 = bits::rotateLeft(h1, 13);
-    h1 = h1 * 5 + 0xe6546b64;
+    h1 = rotateLeft(h1, 13);
+    h1 = h1 * T(5) + T(0xe6546b64);
     return h1;
   }
 
   // Finalization mix - force all bits of a hash block to avalanche
-  uint32_t fmix(uint32_t h1, uint32_t length) {
-    h1 ^= length;
+  template <typename T>
+  T fmix(T h1, uint32_t length) {
+    h1 ^= T(length);
     h1 ^= h1 >> 16;
-    h1 *= 0x85ebca6b;
+    h1 *= T(0x85ebca6b);
     h1 ^= h1 >> 13;
-    h1 *= 0xc2b2ae35;
+    h1 *= T(0xc2b2ae35);
     h1 ^= h1 >> 16;
     return h1;
   }
 };
 
-class Murmur3HashFunction final : public exec::VectorFunction {
-  bool isDefaultNullBehavior() const final {
-    return false;
+// Updates the non-null 'rows' of 'hashes' with the hash of the value of the
+// row in 'values'. 'hashFn' takes a value and the hash so far as the seed.
+template <typename T, typename SeedType, typename HashFn>
+void hashRows(
+    const DecodedVector& values,
+    const SelectivityVector& rows,
+    HashFn hashFn,
+    SeedType* hashes) {
+  if (values.mayHaveNulls()) {
+    rows.applyToSelected([&](auto row) {
+      if (!values.isNullAt(row)) {
+        hashes[row] = hashFn(values.valueAt<T>(row), hashes[row]);
+      }
+    });
+    return;
+  }
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (values.isIdentityMapping()) {
+      const auto* rawValues = values.data<T>();
+      rows.applyToSelected(
+          [&](auto row) { hashes[row] = hashFn(rawValues[row], hashes[row]); });
+      return;
+    }
   }
+  rows.applyToSelected([&](auto row) {
+    hashes[row] = hashFn(values.valueAt<T>(row), hashes[row]);
+  });
+}
 
-  void apply(
-      const SelectivityVector& rows,
-      std::vector<VectorPtr>& args, // Not using const ref so we can reuse args
-      const TypePtr& /* outputType */,
-      exec::EvalCtx& context,
-      VectorPtr& resultRef) const final {
-    context.ensureWritable(rows, INTEGER(), resultRef);
-    applyWithType<int32_t, Murmur3Hash, int32_t>(
-        rows, args, context, resultRef);
+// Hashes the 32 bit values of a flat vector without nulls with SIMD. Returns
+// false if 'values' is not such a vector. 'isFloat' maps -0f to 0 like
+// Murmur3Hash::hashFloat().
+bool murmur3HashInt32s(
+    const DecodedVector& values,
+    const SelectivityVector& rows,
+    bool isFloat,
+    uint32_t* hashes) {
+  if (values.mayHaveNulls() || !values.isIdentityMapping() ||
+      !rows.isAllSelected()) {
+    return false;
   }
-};
+  using Batch = xsimd::batch<uint32_t>;
+  Murmur3Hash hash;
+  const auto* rawValues = values.data<uint32_t>();
+  const Batch negativeZero(0x80000000);
+  auto row = rows.begin();
+  for (; row + Batch::size <= rows.end(); row += Batch::size) {
+    auto input = Batch::load_unaligned(rawValues + row);
+    if (isFloat) {
+      input = xsimd::select(input == negativeZero, Batch(0), input);
+    }
+    hash.hashInt32(input, Batch::load_unaligned(hashes + row))
+        .store_unaligned(hashes + row);
+  }
+  for (; row < rows.end(); ++row) {
+    const auto input = rawValues[row];
+    hashes[row] = hash.hashInt32(
+        isFloat && input == 0x80000000 ? 0 : input, hashes[row]);
+  }
+  return true;
+}
 
 class XxHash64 final {
   const uint64_t PRIME64_1 = 0x9E3779B185EBCA87L;
@@ -362,6 +364,146 @@ class XxHash64 final {
   }
 };
 
+} // namespace
+
+void murmur3Hash(
+    const DecodedVector& values,
+    TypeKind kind,
+    const SelectivityVector& rows,
+    uint32_t* hashes) {
+  Murmur3Hash hash;
+  switch (kind) {
+// Derived from InterpretedHashFunction.hash:
+// https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
+#define CASE(typeEnum, hashFn, inputType)                                    \
+  case TypeKind::typeEnum:                                                   \
+    hashRows<inputType>(                                                     \
+        values,                                                              \
+        rows,                                                                \
+        [&](auto value, uint32_t seed) { return hash.hashFn(value, seed); }, \
+        hashes);                                                             \
+    break;
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      if (!murmur3HashInt32s(values, rows, false, hashes)) {
+        hashRows<int32_t>(
+            values,
+            rows,
+            [&](int32_t value, uint32_t seed) {
+              return hash.hashInt32(value, seed);
+            },
+            hashes);
+      }
+      break;
+    case TypeKind::REAL:
+      if (!murmur3HashInt32s(values, rows, true, hashes)) {
+        hashRows<float>(
+            values,
+            rows,
+            [&](float value, uint32_t seed) {
+              return hash.hashFloat(value, seed);
+            },
+            hashes);
+      }
+      break;
+      CASE(BOOLEAN, hashInt32, bool);
+      CASE(TINYINT, hashInt32, int8_t);
+      CASE(SMALLINT, hashInt32, int16_t);
+      CASE(BIGINT, hashInt64, int64_t);
+      CASE(VARCHAR, hashBytes, StringView);
+      CASE(VARBINARY, hashBytes, StringView);
+      CASE(DOUBLE, hashDouble, double);
+      CASE(SHORT_DECIMAL, hashShortDecimal, UnscaledShortDecimal);
+      CASE(LONG_DECIMAL, hashLongDecimal, UnscaledLongDecimal);
+      CASE(TIMESTAMP, hashTimestamp, Timestamp);
+#undef CASE
+    default:
+      VELOX_NYI("Unsupported type for HASH(): {}", mapTypeKindToName(kind));
+  }
+}
+
+void xxHash64(
+    const DecodedVector& values,
+    TypeKind kind,
+    const SelectivityVector& rows,
+    uint64_t* hashes) {
+  XxHash64 hash;
+  switch (kind) {
+#define CASE(typeEnum, hashFn, inputType)                                    \
+  case TypeKind::typeEnum:                                                   \
+    hashRows<inputType>(                                                     \
+        values,                                                              \
+        rows,                                                                \
+        [&](auto value, uint64_t seed) { return hash.hashFn(value, seed); }, \
+        hashes);                                                             \
+    break;
+    CASE(BOOLEAN, hashInt32, bool);
+    CASE(TINYINT, hashInt32, int8_t);
+    CASE(SMALLINT, hashInt32, int16_t);
+    CASE(INTEGER, hashInt32, int32_t);
+    CASE(BIGINT, hashInt64, int64_t);
+    CASE(VARCHAR, hashBytes, StringView);
+    CASE(VARBINARY, hashBytes, StringView);
+    CASE(REAL, hashFloat, float);
+    CASE(DOUBLE, hashDouble, double);
+    CASE(DATE, hashDate, Date);
+    CASE(SHORT_DECIMAL, hashShortDecimal, UnscaledShortDecimal);
+    CASE(LONG_DECIMAL, hashLongDecimal, UnscaledLongDecimal);
+    CASE(TIMESTAMP, hashTimestamp, Timestamp);
+#undef CASE
+    default:
+      VELOX_NYI(
+          "Unsupported type for XXHASH64(): {}", mapTypeKindToName(kind));
+  }
+}
+
+namespace {
+
+// ReturnType can be either int32_t or int64_t. 'hashColumn' is murmur3Hash()
+// or xxHash64().
+template <typename ReturnType, typename SeedType, typename HashColumn>
+void applyWithType(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args, // Not using const ref so we can reuse args
+    exec::EvalCtx& context,
+    VectorPtr& resultRef,
+    HashColumn hashColumn) {
+  SeedType seed = 42;
+  auto hashIdx = 0;
+  if (args[0]->isConstantEncoding()) {
+    seed = args[0]->as<ConstantVector<SeedType>>()->valueAt(0);
+    hashIdx = 1;
+  }
+
+  auto& result = *resultRef->as<FlatVector<ReturnType>>();
+  result.clearNulls(rows);
+  auto* rawHashes = reinterpret_cast<std::make_unsigned_t<ReturnType>*>(
+      result.mutableRawValues());
+  rows.applyToSelected([&](auto row) { rawHashes[row] = seed; });
+
+  exec::DecodedArgs decodedArgs(rows, args, context);
+  for (auto i = hashIdx; i < args.size(); i++) {
+    hashColumn(*decodedArgs.at(i), args[i]->typeKind(), rows, rawHashes);
+  }
+}
+
+class Murmur3HashFunction final : public exec::VectorFunction {
+  bool isDefaultNullBehavior() const final {
+    return false;
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args, // Not using const ref so we can reuse args
+      const TypePtr& /* outputType */,
+      exec::EvalCtx& context,
+      VectorPtr& resultRef) const final {
+    context.ensureWritable(rows, INTEGER(), resultRef);
+    applyWithType<int32_t, int32_t>(
+        rows, args, context, resultRef, murmur3Hash);
+  }
+};
+
 class XxHash64Function final : public exec::VectorFunction {
   bool isDefaultNullBehavior() const final {
     return false;
@@ -374,7 +516,7 @@ class XxHash64Function final : public exec::VectorFunction {
       exec::EvalCtx& context,
       VectorPtr& resultRef) const final {
     context.ensureWritable(rows, BIGINT(), resultRef);
-    applyWithType<int64_t, XxHash64, int64_t>(rows, args, context, resultRef);
+    applyWithType<int64_t, int64_t>(rows, args, context, resultRef, xxHash64);
   }
 };
 
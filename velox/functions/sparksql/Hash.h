@@ -13,7 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#pragma once
+
 #include "velox/expression/VectorFunction.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::functions::sparksql {
 
@@ -58,4 +61,22 @@ std::shared_ptr<exec::VectorFunction> makeXxHash64(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
 
+/// Updates 'hashes' with the murmur3 hash of the 'rows' of 'values', which are
+/// of 'kind'. The hash of each row is seeded with its value in 'hashes', so
+/// that hashing the columns in order into hashes initialized to the seed gives
+/// hash(seed, c1, c2, ...). Null rows keep their hash. Flat 32 bit values
+/// without nulls are hashed with SIMD.
+void murmur3Hash(
+    const DecodedVector& values,
+    TypeKind kind,
+    const SelectivityVector& rows,
+    uint32_t* hashes);
+
+/// Same as murmur3Hash() for xxhash64().
+void xxHash64(
+    const DecodedVector& values,
+    TypeKind kind,
+    const SelectivityVector& rows,
+    uint64_t* hashes);
+
 } // namespace facebook::velox::functions::sparksql
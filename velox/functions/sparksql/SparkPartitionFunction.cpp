@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/SparkPartitionFunction.h"
+
+#include "velox/functions/sparksql/Hash.h"
+
+namespace facebook::velox::functions::sparksql {
+
+SparkPartitionFunction::SparkPartitionFunction(
+    int numPartitions,
+    std::vector<column_index_t> keyChannels,
+    const std::vector<VectorPtr>& constValues)
+    : numPartitions_{numPartitions}, keyChannels_{std::move(keyChannels)} {
+  VELOX_CHECK_GT(numPartitions_, 0);
+  constValues_.resize(keyChannels_.size());
+  size_t constChannel{0};
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    if (keyChannels_[i] == kConstantChannel) {
+      VELOX_CHECK_LT(constChannel, constValues.size());
+      constValues_[i] = constValues[constChannel++];
+    }
+  }
+}
+
+void SparkPartitionFunction::partition(
+    const RowVector& input,
+    std::vector<uint32_t>& partitions) {
+  const auto numRows = input.size();
+
+  rows_.resize(numRows, true);
+  hashes_.resize(numRows);
+  std::fill(hashes_.begin(), hashes_.end(), kSeed);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    // The hash of a constant key still depends on the keys before it, so it
+    // is hashed for each row.
+    const auto keyVector = keyChannels_[i] == kConstantChannel
+        ? BaseVector::wrapInConstant(numRows, 0, constValues_[i])
+        : input.childAt(keyChannels_[i]);
+    decodedVector_.decode(*keyVector, rows_);
+    murmur3Hash(decodedVector_, keyVector->typeKind(), rows_, hashes_.data());
+  }
+
+  partitions.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    // Spark's Pmod of the signed hash.
+    const auto partition =
+        static_cast<int32_t>(hashes_[i]) % numPartitions_;
+    partitions[i] = partition < 0 ? partition + numPartitions_ : partition;
+  }
+}
+
+} // namespace facebook::velox::functions::sparksql
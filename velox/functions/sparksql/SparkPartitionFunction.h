@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::functions::sparksql {
+
+/// Partitions rows the way Spark's HashPartitioning does for shuffles and
+/// bucketed writes: the partition is pmod(hash(42, keys...), numPartitions),
+/// where hash is Spark's murmur3 hash() of the keys in order.
+class SparkPartitionFunction : public core::PartitionFunction {
+ public:
+  /// 'keyChannels' are the channels of the keys in the input. A key that is
+  /// kConstantChannel takes the next of 'constValues'.
+  SparkPartitionFunction(
+      int numPartitions,
+      std::vector<column_index_t> keyChannels,
+      const std::vector<VectorPtr>& constValues = {});
+
+  ~SparkPartitionFunction() override = default;
+
+  void partition(const RowVector& input, std::vector<uint32_t>& partitions)
+      override;
+
+ private:
+  static constexpr uint32_t kSeed = 42;
+
+  const int numPartitions_;
+  const std::vector<column_index_t> keyChannels_;
+  // The values of the constant keys, one per key. Null for the other keys.
+  std::vector<VectorPtr> constValues_;
+
+  // Reusable memory.
+  std::vector<uint32_t> hashes_;
+  SelectivityVector rows_;
+  DecodedVector decodedVector_;
+};
+
+} // namespace facebook::velox::functions::sparksql
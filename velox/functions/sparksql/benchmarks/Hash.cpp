@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <numeric>
+#include <string>
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/Register.h"
+#include "velox/functions/sparksql/SparkPartitionFunction.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::velox::functions::sparksql {
+namespace {
+
+constexpr vector_size_t kVectorSize = 10'000;
+
+// Makes a row vector of 'types' with flat columns or, if 'dictionary' is
+// true, dictionary encoded columns. 'nullRatio' is the fraction of null rows.
+RowVectorPtr makeData(
+    test::FunctionBenchmarkBase& benchmarkBase,
+    const std::vector<TypePtr>& types,
+    bool dictionary,
+    double nullRatio) {
+  VectorFuzzer::Options opts;
+  opts.vectorSize = kVectorSize;
+  opts.nullRatio = nullRatio;
+  VectorFuzzer fuzzer(opts, benchmarkBase.pool());
+  std::vector<VectorPtr> children;
+  for (const auto& type : types) {
+    auto flat = fuzzer.fuzzFlat(type);
+    children.push_back(dictionary ? fuzzer.fuzzDictionary(flat) : flat);
+  }
+  return benchmarkBase.maker().rowVector(children);
+}
+
+int hash(
+    int iters,
+    const std::string& function,
+    const std::vector<TypePtr>& types,
+    bool dictionary,
+    double nullRatio) {
+  folly::BenchmarkSuspender kSuspender;
+  test::FunctionBenchmarkBase benchmarkBase;
+  const auto data = makeData(benchmarkBase, types, dictionary, nullRatio);
+  std::string exprStr = function + "(";
+  for (auto i = 0; i < types.size(); ++i) {
+    exprStr += (i > 0 ? ", c" : "c") + std::to_string(i);
+  }
+  exprStr += ")";
+  exec::ExprSet expr = benchmarkBase.compileExpression(exprStr, data->type());
+  kSuspender.dismiss();
+  for (int i = 0; i != iters; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return iters * kVectorSize;
+}
+
+int partition(int iters, const std::vector<TypePtr>& types, bool dictionary) {
+  folly::BenchmarkSuspender kSuspender;
+  test::FunctionBenchmarkBase benchmarkBase;
+  const auto data = makeData(benchmarkBase, types, dictionary, 0);
+  std::vector<column_index_t> keyChannels(types.size());
+  std::iota(keyChannels.begin(), keyChannels.end(), 0);
+  SparkPartitionFunction function(200, keyChannels);
+  std::vector<uint32_t> partitions;
+  kSuspender.dismiss();
+  for (int i = 0; i != iters; ++i) {
+    function.partition(*data, partitions);
+  }
+  folly::doNotOptimizeAway(partitions);
+  return iters * kVectorSize;
+}
+
+BENCHMARK_MULTI(murmur3Integer) {
+  return hash(iters, "hash", {INTEGER()}, false, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(murmur3IntegerNulls) {
+  return hash(iters, "hash", {INTEGER()}, false, 0.1);
+}
+
+BENCHMARK_RELATIVE_MULTI(murmur3IntegerDictionary) {
+  return hash(iters, "hash", {INTEGER()}, true, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(murmur3Bigint) {
+  return hash(iters, "hash", {BIGINT()}, false, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(murmur3Varchar) {
+  return hash(iters, "hash", {VARCHAR()}, false, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(murmur3ThreeColumns) {
+  return hash(iters, "hash", {INTEGER(), BIGINT(), VARCHAR()}, false, 0);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(xxhash64Integer) {
+  return hash(iters, "xxhash64", {INTEGER()}, false, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(xxhash64Bigint) {
+  return hash(iters, "xxhash64", {BIGINT()}, false, 0);
+}
+
+BENCHMARK_RELATIVE_MULTI(xxhash64Varchar) {
+  return hash(iters, "xxhash64", {VARCHAR()}, false, 0);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(partitionInteger) {
+  return partition(iters, {INTEGER()}, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(partitionIntegerDictionary) {
+  return partition(iters, {INTEGER()}, true);
+}
+
+BENCHMARK_RELATIVE_MULTI(partitionThreeColumns) {
+  return partition(iters, {INTEGER(), BIGINT(), VARCHAR()}, false);
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::functions::sparksql::registerFunctions("");
+  folly::runBenchmarks();
+  return 0;
+}
@@ -113,5 +113,48 @@ TEST_F(HashTest, Float) {
   EXPECT_EQ(hash<float>(-limits::infinity()), 427440766);
 }
 
+TEST_F(HashTest, vectors) {
+  // Flat 32 bit columns without nulls are hashed with SIMD, the others row by
+  // row. Both give the hashes of single rows.
+  constexpr vector_size_t kSize = 1'001;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row * 7919 - 3; }),
+      makeFlatVector<float>(
+          kSize, [](auto row) { return row % 3 == 0 ? -0.0f : row * 0.1f; }),
+      makeFlatVector<int64_t>(
+          kSize, [](auto row) { return static_cast<int64_t>(row) << 40; }),
+      makeFlatVector<int32_t>(
+          kSize, [](auto row) { return row; }, nullEvery(5)),
+  });
+  auto expectRowHashes = [&](const RowVectorPtr& input) {
+    auto result = evaluate<SimpleVector<int32_t>>(
+        "hash(c0, c1, c2, c3)", input);
+    auto* c0 = input->childAt(0)->as<SimpleVector<int32_t>>();
+    auto* c1 = input->childAt(1)->as<SimpleVector<float>>();
+    auto* c2 = input->childAt(2)->as<SimpleVector<int64_t>>();
+    auto* c3 = input->childAt(3)->as<SimpleVector<int32_t>>();
+    for (auto row = 0; row < kSize; ++row) {
+      EXPECT_EQ(
+          result->valueAt(row),
+          evaluateOnce<int32_t>(
+              "hash(c0, c1, c2, c3)",
+              std::optional(c0->valueAt(row)),
+              std::optional(c1->valueAt(row)),
+              std::optional(c2->valueAt(row)),
+              c3->isNullAt(row) ? std::nullopt
+                                : std::optional(c3->valueAt(row))))
+          << "at " << row;
+    }
+  };
+  expectRowHashes(data);
+
+  auto reversed = makeIndicesInReverse(kSize);
+  std::vector<VectorPtr> children;
+  for (const auto& child : data->children()) {
+    children.push_back(wrapInDictionary(reversed, kSize, child));
+  }
+  expectRowHashes(makeRowVector(children));
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/SparkPartitionFunction.h"
+#include "velox/functions/sparksql/tests/SparkFunctionBaseTest.h"
+
+namespace facebook::velox::functions::sparksql::test {
+namespace {
+
+class SparkPartitionFunctionTest : public SparkFunctionBaseTest {
+ protected:
+  // Checks that the partitions of the rows of 'input' by 'keyChannels' are
+  // pmod('hashExpr', numPartitions), where 'hashExpr' hashes the same keys.
+  void assertPartitions(
+      const RowVectorPtr& input,
+      const std::vector<column_index_t>& keyChannels,
+      const std::vector<VectorPtr>& constValues,
+      const std::string& hashExpr) {
+    for (auto numPartitions : {1, 7, 16}) {
+      SparkPartitionFunction function(numPartitions, keyChannels, constValues);
+      std::vector<uint32_t> partitions;
+      function.partition(*input, partitions);
+      ASSERT_EQ(partitions.size(), input->size());
+      auto expected = evaluate<SimpleVector<int32_t>>(
+          fmt::format("pmod({}, {})", hashExpr, numPartitions), input);
+      for (auto row = 0; row < input->size(); ++row) {
+        ASSERT_EQ(partitions[row], expected->valueAt(row)) << "at " << row;
+      }
+    }
+  }
+};
+
+TEST_F(SparkPartitionFunctionTest, keys) {
+  constexpr vector_size_t kSize = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row - 500; }),
+      makeFlatVector<std::string>(
+          kSize,
+          [](auto row) { return std::string(row % 37, 'a' + row % 26); },
+          nullEvery(11)),
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row * 1'000'003; }),
+  });
+  assertPartitions(input, {0}, {}, "hash(c0)");
+  assertPartitions(input, {2, 1, 0}, {}, "hash(c2, c1, c0)");
+
+  auto dictionary = makeRowVector({wrapInDictionary(
+      makeIndicesInReverse(kSize), kSize, input->childAt(1))});
+  assertPartitions(dictionary, {0}, {}, "hash(c0)");
+}
+
+TEST_F(SparkPartitionFunctionTest, constantKey) {
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  });
+  assertPartitions(
+      input,
+      {0, kConstantChannel},
+      {makeConstant<int32_t>(10, 1)},
+      "hash(c0, 10::INTEGER)");
+  assertPartitions(
+      input,
+      {kConstantChannel, 0},
+      {makeNullConstant(TypeKind::INTEGER, 1)},
+      "hash(null::INTEGER, c0)");
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql::test
@@ -519,6 +519,51 @@ TEST_F(FunctionRegistryTest, resolveFunctionsBasedOnPriority) {
   ASSERT_EQ(*result5, *REAL());
 }
 
+TEST_F(FunctionRegistryTest, lazyRegistration) {
+  const std::string func = "lazy_func";
+  auto& simpleFunctions = exec::SimpleFunctions();
+  {
+    exec::SimpleFunctionRegistry::LazyRegistration lazy(simpleFunctions);
+    registerFunction<TestFunction, Varchar, Varchar, Varchar>({func});
+    registerFunction<TestFunction, int32_t, Variadic<Varchar>>({func});
+    registerFunction<TestFunction, float, Generic<T1>, Generic<T1>>({func});
+
+    // The name is known before the signatures are built.
+    auto names = simpleFunctions.getFunctionNames();
+    ASSERT_NE(std::find(names.begin(), names.end(), func), names.end());
+  }
+
+  ASSERT_EQ(*resolveFunction(func, {VARCHAR(), VARCHAR()}), *VARCHAR());
+  ASSERT_EQ(*resolveFunction(func, {INTEGER(), INTEGER()}), *REAL());
+  ASSERT_EQ(*resolveFunction(func, {VARCHAR()}), *INTEGER());
+  ASSERT_EQ(*resolveFunction(func, {}), *INTEGER());
+  ASSERT_EQ(resolveFunction(func, {INTEGER()}), nullptr);
+  ASSERT_EQ(resolveFunction(func, {VARCHAR(), INTEGER()}), nullptr);
+  ASSERT_EQ(simpleFunctions.getFunctionSignatures(func).size(), 3);
+
+  // Registrations after the first lookup of a name are not deferred.
+  {
+    exec::SimpleFunctionRegistry::LazyRegistration lazy(simpleFunctions);
+    registerFunction<TestFunction, int64_t, Variadic<Any>>({func});
+  }
+  ASSERT_EQ(*resolveFunction(func, {INTEGER()}), *BIGINT());
+  ASSERT_EQ(simpleFunctions.getFunctionSignatures(func).size(), 4);
+}
+
+TEST_F(FunctionRegistryTest, resolveByArgumentKinds) {
+  // Signatures of other arities or argument kinds are ruled out before
+  // binding, while the ones with type variables bind to any kind.
+  ASSERT_EQ(*resolveFunction("func_two", {BIGINT(), INTEGER()}), *BIGINT());
+  ASSERT_EQ(*resolveFunction("func_two", {BIGINT(), SMALLINT()}), *BIGINT());
+  ASSERT_EQ(resolveFunction("func_two", {BIGINT(), BIGINT()}), nullptr);
+  ASSERT_EQ(resolveFunction("func_two", {BIGINT()}), nullptr);
+  ASSERT_EQ(
+      *resolveFunction("func_three_alias1", {ARRAY(BIGINT())}),
+      *ARRAY(BIGINT()));
+  ASSERT_EQ(resolveFunction("func_three_alias1", {ARRAY(INTEGER())}), nullptr);
+  ASSERT_EQ(resolveFunction("func_three_alias1", {BIGINT()}), nullptr);
+}
+
 TEST_F(FunctionRegistryTest, resolveSpecialForms) {
   auto andResult =
       resolveFunctionOrCallableSpecialForm("and", {BOOLEAN(), BOOLEAN()});
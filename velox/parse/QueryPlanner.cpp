@@ -292,12 +292,17 @@ PlanNodePtr toVeloxPlan(
     std::vector<PlanNodePtr> sources,
     QueryContext& queryContext) {
   std::vector<CallTypedExprPtr> aggregates;
+  std::vector<bool> distinctFlags;
 
   std::vector<std::string> projectNames;
   std::vector<TypedExprPtr> projections;
 
   bool identityProjection = true;
   for (auto& expression : logicalAggregate.expressions) {
+    auto* agg =
+        dynamic_cast<::duckdb::BoundAggregateExpression*>(expression.get());
+    distinctFlags.push_back(agg != nullptr && agg->distinct);
+
     auto call = std::dynamic_pointer_cast<const CallTypedExpr>(
         toVeloxExpression(*expression, sources[0]->outputType()));
     std::vector<TypedExprPtr> fieldInputs;
@@ -361,6 +366,7 @@ PlanNodePtr toVeloxPlan(
       names,
       aggregates,
       std::vector<FieldAccessTypedExprPtr>{}, // aggregateMasks
+      distinctFlags,
       false, // ignoreNullKeys
       source);
 }
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowFast.h"
+#include "velox/row/UnsafeRow.h"
+
+namespace facebook::velox::row {
+
+namespace {
+constexpr size_t kFieldWidth = UnsafeRow::kFieldWidthBytes;
+
+bool isSupportedKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+constexpr bool isVariableWidth(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Writes the value of 'decoded' at 'row' into 'rowBuffer'. Strings are
+// written at 'variableOffset', which is advanced past the padded data.
+template <TypeKind Kind>
+FOLLY_ALWAYS_INLINE void serializeValue(
+    const DecodedVector& decoded,
+    vector_size_t row,
+    char* rowBuffer,
+    char* slot,
+    size_t& variableOffset) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (Kind == TypeKind::BOOLEAN) {
+    *slot = decoded.valueAt<bool>(row);
+  } else if constexpr (Kind == TypeKind::TIMESTAMP) {
+    const int64_t micros = decoded.valueAt<Timestamp>(row).toMicros();
+    memcpy(slot, &micros, sizeof(micros));
+  } else if constexpr (isVariableWidth(Kind)) {
+    const auto value = decoded.valueAt<StringView>(row);
+    const uint64_t size = value.size();
+    const auto paddedSize = UnsafeRow::alignToFieldWidth(size);
+    char* data = rowBuffer + variableOffset;
+    if (paddedSize > 0) {
+      // Clears the padding after the string.
+      memset(data + paddedSize - kFieldWidth, 0, kFieldWidth);
+      memcpy(data, value.data(), size);
+    }
+    const uint64_t dataPointer = variableOffset << 32 | size;
+    memcpy(slot, &dataPointer, sizeof(dataPointer));
+    variableOffset += paddedSize;
+  } else {
+    const T value = decoded.valueAt<T>(row);
+    memcpy(slot, &value, sizeof(T));
+  }
+}
+
+template <TypeKind Kind>
+void serializeColumn(
+    const DecodedVector& decoded,
+    column_index_t field,
+    size_t nullLength,
+    vector_size_t numRows,
+    const size_t* offsets,
+    size_t* variableOffsets,
+    char* buffer) {
+  const auto slotOffset = nullLength + field * kFieldWidth;
+  if (!decoded.mayHaveNulls()) {
+    for (auto row = 0; row < numRows; ++row) {
+      char* rowBuffer = buffer + offsets[row];
+      serializeValue<Kind>(
+          decoded,
+          row,
+          rowBuffer,
+          rowBuffer + slotOffset,
+          variableOffsets[row]);
+    }
+    return;
+  }
+  for (auto row = 0; row < numRows; ++row) {
+    char* rowBuffer = buffer + offsets[row];
+    if (decoded.isNullAt(row)) {
+      bits::setBit(rowBuffer, field);
+      continue;
+    }
+    serializeValue<Kind>(
+        decoded, row, rowBuffer, rowBuffer + slotOffset, variableOffsets[row]);
+  }
+}
+
+template <TypeKind Kind>
+void deserializeColumn(
+    const std::vector<std::string_view>& rows,
+    column_index_t field,
+    size_t nullLength,
+    BaseVector& result) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto* flat = result.asUnchecked<FlatVector<T>>();
+  const auto slotOffset = nullLength + field * kFieldWidth;
+  const vector_size_t numRows = rows.size();
+  const auto isNullFlagSet = [&](vector_size_t row) {
+    const auto* nulls = reinterpret_cast<const uint8_t*>(rows[row].data());
+    return bits::isBitSet(nulls, field);
+  };
+  uint64_t* rawNulls = nullptr;
+  const auto isNull = [&](vector_size_t row) {
+    if (!isNullFlagSet(row)) {
+      return false;
+    }
+    if (!rawNulls) {
+      rawNulls = result.mutableRawNulls();
+    }
+    bits::setNull(rawNulls, row);
+    return true;
+  };
+
+  if constexpr (Kind == TypeKind::BOOLEAN) {
+    auto* rawValues = flat->template mutableRawValues<uint64_t>();
+    for (auto row = 0; row < numRows; ++row) {
+      if (!isNull(row)) {
+        bits::setBit(rawValues, row, rows[row][slotOffset] != 0);
+      }
+    }
+  } else if constexpr (Kind == TypeKind::TIMESTAMP) {
+    auto* rawValues = flat->mutableRawValues();
+    for (auto row = 0; row < numRows; ++row) {
+      if (!isNull(row)) {
+        int64_t micros;
+        memcpy(&micros, rows[row].data() + slotOffset, sizeof(micros));
+        rawValues[row] = Timestamp::fromMicros(micros);
+      }
+    }
+  } else if constexpr (isVariableWidth(Kind)) {
+    // Copies the strings that are not inlined into one buffer.
+    const auto dataPointer = [&](vector_size_t row) {
+      uint64_t offsetAndSize;
+      memcpy(&offsetAndSize, rows[row].data() + slotOffset, kFieldWidth);
+      return offsetAndSize;
+    };
+    size_t totalSize = 0;
+    for (auto row = 0; row < numRows; ++row) {
+      if (isNullFlagSet(row)) {
+        continue;
+      }
+      const uint32_t size = dataPointer(row);
+      if (!StringView::isInline(size)) {
+        totalSize += size;
+      }
+    }
+    VELOX_CHECK_LE(totalSize, std::numeric_limits<vector_size_t>::max());
+    char* data = nullptr;
+    if (totalSize > 0) {
+      auto* buffer = flat->getBufferWithSpace(totalSize);
+      data = buffer->template asMutable<char>() + buffer->size();
+      buffer->setSize(buffer->size() + totalSize);
+    }
+    auto* rawValues = flat->mutableRawValues();
+    for (auto row = 0; row < numRows; ++row) {
+      if (isNull(row)) {
+        continue;
+      }
+      const auto offsetAndSize = dataPointer(row);
+      const uint32_t size = offsetAndSize;
+      const char* value = rows[row].data() + (offsetAndSize >> 32);
+      if (StringView::isInline(size)) {
+        rawValues[row] = StringView(value, size);
+      } else {
+        memcpy(data, value, size);
+        rawValues[row] = StringView(data, size);
+        data += size;
+      }
+    }
+  } else {
+    auto* rawValues = flat->mutableRawValues();
+    for (auto row = 0; row < numRows; ++row) {
+      if (!isNull(row)) {
+        memcpy(rawValues + row, rows[row].data() + slotOffset, sizeof(T));
+      }
+    }
+  }
+}
+
+template <TypeKind Kind>
+auto serializerFor() {
+  return &serializeColumn<Kind>;
+}
+
+template <TypeKind Kind>
+auto deserializerFor() {
+  return &deserializeColumn<Kind>;
+}
+} // namespace
+
+// static
+bool UnsafeRowFast::isSupported(const RowTypePtr& rowType) {
+  return std::all_of(
+      rowType->children().begin(),
+      rowType->children().end(),
+      [](const auto& type) { return isSupportedKind(type->kind()); });
+}
+
+UnsafeRowFast::UnsafeRowFast(RowTypePtr rowType)
+    : rowType_(std::move(rowType)),
+      nullLength_(UnsafeRow::getNullLength(rowType_->size())),
+      fixedSize_(nullLength_ + rowType_->size() * kFieldWidth),
+      decoded_(rowType_->size()) {
+  VELOX_CHECK(
+      isSupported(rowType_),
+      "Unsupported type for UnsafeRowFast: {}",
+      rowType_->toString());
+  for (auto i = 0; i < rowType_->size(); ++i) {
+    const auto kind = rowType_->childAt(i)->kind();
+    serializers_.push_back(
+        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(serializerFor, kind));
+    deserializers_.push_back(
+        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(deserializerFor, kind));
+    if (isVariableWidth(kind)) {
+      variableWidthFields_.push_back(i);
+    }
+  }
+}
+
+size_t UnsafeRowFast::rowOffsets(
+    const RowVector& data,
+    std::vector<size_t>& offsets) {
+  VELOX_CHECK_EQ(data.childrenSize(), rowType_->size());
+  const auto numRows = data.size();
+  offsets.resize(numRows + 1);
+  std::fill(offsets.begin(), offsets.end(), fixedSize_);
+  allRows_.resizeFill(numRows, true);
+  for (auto field : variableWidthFields_) {
+    auto& decoded = decoded_[field];
+    decoded.decode(*data.childAt(field), allRows_);
+    for (auto row = 0; row < numRows; ++row) {
+      if (!decoded.isNullAt(row)) {
+        offsets[row] += UnsafeRow::alignToFieldWidth(
+            decoded.valueAt<StringView>(row).size());
+      }
+    }
+  }
+
+  // Turns the sizes into offsets.
+  size_t offset = 0;
+  for (auto row = 0; row < numRows; ++row) {
+    const auto size = offsets[row];
+    offsets[row] = offset;
+    offset += size;
+  }
+  offsets[numRows] = offset;
+  return offset;
+}
+
+void UnsafeRowFast::serialize(
+    const RowVector& data,
+    const std::vector<size_t>& offsets,
+    char* buffer) {
+  VELOX_CHECK_EQ(data.childrenSize(), rowType_->size());
+  const auto numRows = data.size();
+  VELOX_CHECK_EQ(offsets.size(), numRows + 1);
+  // Clears the null flags and the fixed slots of each row.
+  for (auto row = 0; row < numRows; ++row) {
+    memset(buffer + offsets[row], 0, fixedSize_);
+  }
+  variableOffsets_.assign(numRows, fixedSize_);
+  allRows_.resizeFill(numRows, true);
+  for (auto field = 0; field < rowType_->size(); ++field) {
+    auto& decoded = decoded_[field];
+    decoded.decode(*data.childAt(field), allRows_);
+    serializers_[field](
+        decoded,
+        field,
+        nullLength_,
+        numRows,
+        offsets.data(),
+        variableOffsets_.data(),
+        buffer);
+  }
+}
+
+RowVectorPtr UnsafeRowFast::deserialize(
+    const std::vector<std::string_view>& rows,
+    memory::MemoryPool* pool) const {
+  const vector_size_t numRows = rows.size();
+  std::vector<VectorPtr> children(rowType_->size());
+  for (auto field = 0; field < rowType_->size(); ++field) {
+    children[field] =
+        BaseVector::create(rowType_->childAt(field), numRows, pool);
+    deserializers_[field](rows, field, nullLength_, *children[field]);
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType_, nullptr, numRows, std::move(children));
+}
+
+} // namespace facebook::velox::row
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Converts batches of rows between a RowVector and the UnsafeRow format of
+/// Spark, a column at a time. Unlike UnsafeRowSerializer and
+/// UnsafeRowDeserializer, which dispatch on the type of each field of each
+/// row, the conversion is planned once per schema: each field gets a copy
+/// function instantiated for its type, which then runs over all the rows of
+/// the batch. Fixed width values are copied with a fixed size memcpy to or
+/// from their 8 byte slot and the string data of a column is copied into a
+/// single buffer when deserializing.
+///
+/// Supports rows of boolean, integer, floating point, string, varbinary,
+/// timestamp and date fields. Other schemas use UnsafeRowSerializer and
+/// UnsafeRowDeserializer.
+class UnsafeRowFast {
+ public:
+  /// Returns true if all fields of 'rowType' are supported.
+  static bool isSupported(const RowTypePtr& rowType);
+
+  explicit UnsafeRowFast(RowTypePtr rowType);
+
+  const RowTypePtr& rowType() const {
+    return rowType_;
+  }
+
+  /// Computes the serialized size of the rows of 'data' and returns their
+  /// offsets in 'offsets', which has one more element than 'data' for the end
+  /// of the last row. Returns the size of all rows.
+  size_t rowOffsets(const RowVector& data, std::vector<size_t>& offsets);
+
+  /// Serializes the rows of 'data' one after another into 'buffer', which
+  /// must have space for at least as many bytes as returned by rowOffsets().
+  /// 'offsets' are the offsets returned by rowOffsets() for the same 'data'.
+  void serialize(
+      const RowVector& data,
+      const std::vector<size_t>& offsets,
+      char* buffer);
+
+  /// Deserializes 'rows' into a RowVector allocated from 'pool'. String data
+  /// is copied and the result does not reference 'rows'.
+  RowVectorPtr deserialize(
+      const std::vector<std::string_view>& rows,
+      memory::MemoryPool* pool) const;
+
+ private:
+  using SerializeFunc = void (*)(
+      const DecodedVector& decoded,
+      column_index_t field,
+      size_t nullLength,
+      vector_size_t numRows,
+      const size_t* offsets,
+      size_t* variableOffsets,
+      char* buffer);
+
+  using DeserializeFunc = void (*)(
+      const std::vector<std::string_view>& rows,
+      column_index_t field,
+      size_t nullLength,
+      BaseVector& result);
+
+  const RowTypePtr rowType_;
+
+  // The size of the null flags at the start of each row.
+  const size_t nullLength_;
+
+  // The size of the null flags and of the 8 byte slots of all fields.
+  const size_t fixedSize_;
+
+  // The copy functions of each field.
+  std::vector<SerializeFunc> serializers_;
+  std::vector<DeserializeFunc> deserializers_;
+
+  // The fields that have data after the fixed slots.
+  std::vector<column_index_t> variableWidthFields_;
+
+  // The decoded fields of the batch being serialized.
+  std::vector<DecodedVector> decoded_;
+  SelectivityVector allRows_;
+
+  // The offset of the first unwritten byte of each row being serialized.
+  std::vector<size_t> variableOffsets_;
+};
+
+} // namespace facebook::velox::row
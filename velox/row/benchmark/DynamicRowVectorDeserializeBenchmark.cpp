@@ -19,6 +19,7 @@
 #include <random>
 
 #include "velox/row/UnsafeRowDeserializers.h"
+#include "velox/row/UnsafeRowFast.h"
 #include "velox/row/UnsafeRowSerializers.h"
 #include "velox/type/Type.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -53,8 +54,52 @@ class UnsaferowBatchDeserializer : public Deserializer {
       memory::addDefaultLeafMemoryPool();
 };
 
+class UnsafeRowFastDeserializer : public Deserializer {
+ public:
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    if (!fast_) {
+      fast_ = std::make_unique<UnsafeRowFast>(asRowType(type));
+    }
+    rows_.clear();
+    for (const auto& row : data) {
+      rows_.push_back(row.value());
+    }
+    fast_->deserialize(rows_, pool_.get());
+  }
+
+ private:
+  std::unique_ptr<UnsafeRowFast> fast_;
+  std::vector<std::string_view> rows_;
+  std::shared_ptr<memory::MemoryPool> pool_ =
+      memory::addDefaultLeafMemoryPool();
+};
+
 class BenchmarkHelper {
  public:
+  RowVectorPtr randomRows(int nFields, int nRows, bool stringOnly) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (int32_t i = 0; i < nFields; ++i) {
+      names.push_back("");
+      types.push_back(
+          stringOnly ? VARCHAR()
+                     : scalarTypes_[folly::Random::rand32() %
+                                    scalarTypes_.size()]);
+    }
+
+    VectorFuzzer::Options opts;
+    opts.vectorSize = nRows;
+    opts.nullRatio = 0.1;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    opts.timestampPrecision =
+        VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+    VectorFuzzer fuzzer(opts, pool_.get(), folly::Random::rand32());
+    return fuzzer.fuzzInputRow(ROW(std::move(names), std::move(types)));
+  }
+
   std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
   randomUnsaferows(int nFields, int nRows, bool stringOnly) {
     RowTypePtr rowType;
@@ -115,6 +160,17 @@ class BenchmarkHelper {
       MAP(VARCHAR(), ARRAY(INTEGER())),
       ROW({INTEGER()})};
 
+  std::vector<TypePtr> scalarTypes_{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      TIMESTAMP()};
+
   std::shared_ptr<memory::MemoryPool> pool_ =
       memory::addDefaultLeafMemoryPool();
 };
@@ -137,6 +193,36 @@ int deserialize(
   return nIters * nFields * nRows;
 }
 
+// Serializes a batch row by row with UnsafeRowSerializer or a column at a
+// time with UnsafeRowFast.
+int serialize(int nIters, int nFields, int nRows, bool stringOnly, bool fast) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.randomRows(nFields, nRows, stringOnly);
+  UnsafeRowFast unsafeRowFast(asRowType(data->type()));
+  std::vector<size_t> offsets;
+  std::string buffer(unsafeRowFast.rowOffsets(*data, offsets), '\0');
+  VectorPtr vector = data;
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; i++) {
+    if (fast) {
+      buffer.resize(unsafeRowFast.rowOffsets(*data, offsets));
+      unsafeRowFast.serialize(*data, offsets, buffer.data());
+    } else {
+      UnsafeRowSerializer::preloadVector(vector);
+      size_t offset = 0;
+      for (auto row = 0; row < nRows; ++row) {
+        offset += UnsafeRowSerializer::serialize(
+                      vector, buffer.data() + offset, row)
+                      .value();
+      }
+    }
+  }
+
+  return nIters * nFields * nRows;
+}
+
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
     batch_10_100k_string_only,
@@ -153,6 +239,22 @@ BENCHMARK_NAMED_PARAM_MULTI(
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
 
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserialize,
+    fast_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<UnsafeRowFastDeserializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserialize,
+    fast_100_100k_string_only,
+    100,
+    100000,
+    true,
+    std::make_unique<UnsafeRowFastDeserializer>());
+
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
     batch_10_100k_all_types,
@@ -169,6 +271,40 @@ BENCHMARK_NAMED_PARAM_MULTI(
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_100k_string_only,
+    10,
+    100000,
+    true,
+    false);
+
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    fast_10_100k_string_only,
+    10,
+    100000,
+    true,
+    true);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_100_10k_scalar_types,
+    100,
+    10000,
+    false,
+    false);
+
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    fast_100_10k_scalar_types,
+    100,
+    10000,
+    false,
+    true);
+
 } // namespace
 } // namespace facebook::spark::benchmarks
 
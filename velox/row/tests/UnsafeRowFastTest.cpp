@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowFast.h"
+
+#include <gtest/gtest.h>
+
+#include <folly/Random.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/row/UnsafeRowDeserializers.h"
+#include "velox/row/UnsafeRowSerializers.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::row {
+namespace {
+
+using namespace facebook::velox::test;
+
+class UnsafeRowFastTest : public ::testing::Test, public VectorTestBase {
+ protected:
+  // Serializes 'data' with UnsafeRowFast and returns the rows.
+  std::vector<std::string_view> serialize(
+      UnsafeRowFast& fast,
+      const RowVectorPtr& data) {
+    std::vector<size_t> offsets;
+    const auto size = fast.rowOffsets(*data, offsets);
+    buffer_.assign(size, 'x');
+    fast.serialize(*data, offsets, buffer_.data());
+    std::vector<std::string_view> rows;
+    for (auto i = 0; i < data->size(); ++i) {
+      rows.emplace_back(
+          buffer_.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return rows;
+  }
+
+  // Serializes 'data' with UnsafeRowFast and checks that the rows are the
+  // same as the ones of UnsafeRowSerializer and that both deserializers
+  // return 'data'.
+  void testRoundTrip(const RowVectorPtr& data) {
+    UnsafeRowFast fast(asRowType(data->type()));
+    auto rows = serialize(fast, data);
+
+    UnsafeRowSerializer::preloadVector(data);
+    std::vector<std::optional<std::string_view>> expectedRows;
+    std::vector<std::string> expectedBuffers(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      expectedBuffers[i].resize(
+          UnsafeRowSerializer::getSizeRow(data.get(), i), '\0');
+      auto size = UnsafeRowSerializer::serialize(
+          std::static_pointer_cast<BaseVector>(data),
+          expectedBuffers[i].data(),
+          i);
+      ASSERT_EQ(size.value(), rows[i].size());
+      ASSERT_EQ(expectedBuffers[i], rows[i]) << "at row " << i;
+      expectedRows.push_back(expectedBuffers[i]);
+    }
+
+    assertEqualVectors(data, fast.deserialize(rows, pool()));
+    assertEqualVectors(
+        data,
+        UnsafeRowDeserializer::deserialize(
+            expectedRows, data->type(), pool()));
+  }
+
+  std::string buffer_;
+};
+
+TEST_F(UnsafeRowFastTest, fuzz) {
+  auto rowType = ROW({
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      VARBINARY(),
+      TIMESTAMP(),
+  });
+  ASSERT_TRUE(UnsafeRowFast::isSupported(rowType));
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.stringVariableLength = true;
+  opts.stringLength = 30;
+  // Spark uses microseconds to store timestamp
+  opts.timestampPrecision =
+      VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool(), seed);
+  for (auto i = 0; i < 100; ++i) {
+    testRoundTrip(fuzzer.fuzzInputRow(rowType));
+    // With dictionary and constant encoded fields.
+    testRoundTrip(fuzzer.fuzzRow(rowType));
+  }
+}
+
+TEST_F(UnsafeRowFastTest, strings) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<std::string>(
+          {"", std::nullopt, "abc", "exactly 16 bytes", std::string(100, 'y')}),
+      makeFlatVector<int64_t>({1, 2, 3, 4, 5}),
+      makeNullableFlatVector<std::string>(
+          {std::nullopt, "short", "a little longer", "", std::nullopt}),
+  });
+  testRoundTrip(data);
+
+  // The deserialized strings do not reference the serialized rows.
+  UnsafeRowFast fast(asRowType(data->type()));
+  auto result = fast.deserialize(serialize(fast, data), pool());
+  buffer_.assign(buffer_.size(), '\0');
+  assertEqualVectors(data, result);
+}
+
+TEST_F(UnsafeRowFastTest, dates) {
+  auto data = makeRowVector({
+      makeNullableFlatVector<Date>({Date(0), std::nullopt, Date(18'000)}),
+      makeFlatVector<int32_t>({1, 2, 3}),
+  });
+  UnsafeRowFast fast(asRowType(data->type()));
+  assertEqualVectors(data, fast.deserialize(serialize(fast, data), pool()));
+}
+
+TEST_F(UnsafeRowFastTest, unsupported) {
+  EXPECT_FALSE(UnsafeRowFast::isSupported(ROW({INTEGER(), ARRAY(BIGINT())})));
+  EXPECT_FALSE(UnsafeRowFast::isSupported(ROW({ROW({INTEGER()})})));
+  VELOX_ASSERT_THROW(
+      UnsafeRowFast(ROW({MAP(INTEGER(), INTEGER())})),
+      "Unsupported type for UnsafeRowFast");
+}
+
+} // namespace
+} // namespace facebook::velox::row
@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+#include <folly/Random.h>
 #include "velox/common/base/Crc.h"
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Date.h"
 #include "velox/vector/BiasVector.h"
@@ -29,6 +31,7 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -42,15 +45,18 @@ int64_t computeChecksum(
   return result.checksum();
 }
 
+// Computes the checksum of the 'sizeInBytes' bytes of a page at the read
+// position of 'source', which may be compressed, and of its header fields.
 int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -67,6 +73,34 @@ int64_t computeChecksum(
   return checksum;
 }
 
+using PrestoOptions = PrestoVectorSerde::PrestoOptions;
+
+// Returns the Presto options in 'options', which may be the options of any
+// serde or nullptr.
+PrestoOptions toPrestoOptions(const VectorSerde::Options* options) {
+  if (options == nullptr) {
+    return PrestoOptions();
+  }
+  if (auto* prestoOptions = dynamic_cast<const PrestoOptions*>(options)) {
+    return *prestoOptions;
+  }
+  PrestoOptions result;
+  result.compressionKind = options->compressionKind;
+  result.preserveEncodings = options->preserveEncodings;
+  return result;
+}
+
+std::unique_ptr<folly::io::Codec> makeCodec(folly::io::CodecType kind) {
+  if (kind == folly::io::CodecType::NO_COMPRESSION) {
+    return nullptr;
+  }
+  VELOX_CHECK(
+      folly::io::hasCodec(kind),
+      "Compression codec is not available: {}",
+      static_cast<int>(kind));
+  return folly::io::getCodec(kind);
+}
+
 char getCodecMarker() {
   char marker = 0;
   marker |= kCheckSumBitMask;
@@ -432,6 +466,33 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  auto indices = allocateIndices(size, pool);
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  source->readBytes(
+      reinterpret_cast<uint8_t*>(rawIndices), size * sizeof(vector_size_t));
+  const auto dictionarySize = children[0]->size();
+  for (auto i = 0; i < size; ++i) {
+    VELOX_CHECK(
+        rawIndices[i] >= 0 && rawIndices[i] < dictionarySize,
+        "Dictionary index out of range: {}",
+        rawIndices[i]);
+  }
+  // Skip the dictionary id, which is 2 longs of a UUID and a sequence number.
+  source->skip(3 * sizeof(int64_t));
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -705,8 +766,18 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
+      // A vector from a previous RLE or DICTIONARY block can't be reused.
+      auto& previous = (*result)[i];
+      if (previous &&
+          (previous->isConstantEncoding() ||
+           previous->encoding() == VectorEncoding::Simple::DICTIONARY)) {
+        previous.reset();
+      }
       auto it = readers.find(types[i]->kind());
       VELOX_CHECK(
           it != readers.end(),
@@ -828,6 +899,10 @@ class VectorStream {
     return children_[index].get();
   }
 
+  const TypePtr& type() const {
+    return type_;
+  }
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
@@ -1577,13 +1652,22 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      const PrestoOptions& options)
+      : streamArena_(streamArena),
+        pool_(streamArena->pool()),
+        codec_(makeCodec(options.compressionKind)),
+        minCompressionRatio_(options.minCompressionRatio),
+        useLosslessTimestamp_(options.useLosslessTimestamp),
+        preserveEncodings_(options.preserveEncodings) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
     for (int i = 0; i < numTypes; i++) {
       streams_[i] = std::make_unique<VectorStream>(
-          types[i], streamArena, numRows, useLosslessTimestamp);
+          types[i], streamArena, numRows, options.useLosslessTimestamp);
+    }
+    if (preserveEncodings_) {
+      encodedColumns_.resize(numTypes);
     }
   }
 
@@ -1594,6 +1678,10 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+        if (preserveEncodings_ &&
+            appendEncoded(i, vector->childAt(i), ranges)) {
+          continue;
+        }
         serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
       }
     }
@@ -1610,13 +1698,36 @@ class PrestoVectorSerializer : public VectorSerializer {
     }
 
     std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+    }
 
     flushInternal(vector->size(), true /*rle*/, out);
   }
 
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override {
+    if (codec_ == nullptr) {
+      return {};
+    }
+    return {
+        {PrestoVectorSerde::kCompressionInputBytes,
+         RuntimeCounter(compressionInputBytes_, RuntimeCounter::Unit::kBytes)},
+        {PrestoVectorSerde::kCompressedBytes,
+         RuntimeCounter(compressedBytes_, RuntimeCounter::Unit::kBytes)},
+        {PrestoVectorSerde::kCompressionSkippedBytes,
+         RuntimeCounter(
+             compressionSkippedBytes_, RuntimeCounter::Unit::kBytes)},
+        {PrestoVectorSerde::kCompressionTimeNanos,
+         RuntimeCounter(
+             compressionTimeMicros_ * 1'000, RuntimeCounter::Unit::kNanos)}};
+  }
+
   // Writes the contents to 'stream' in wire format
   void flushInternal(int32_t numRows, bool rle, OutputStream* out) {
+    if (codec_ != nullptr) {
+      flushCompressed(numRows, rle, out);
+      return;
+    }
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1647,19 +1758,7 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
-    }
+    writeColumns(numRows, rle, out);
 
     // Pause CRC computation
     if (listener) {
@@ -1684,9 +1783,239 @@ class PrestoVectorSerializer : public VectorSerializer {
  private:
   static const int32_t kSizeInBytesOffset{4 + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
+  static const int32_t kChecksumOffset{kSizeInBytesOffset + 4 + 4};
+
+  // Writes the number of columns and the columns, i.e. the part of a page
+  // after the header.
+  void writeColumns(int32_t numRows, bool rle, OutputStream* out) {
+    writeInt32(out, streams_.size());
+
+    if (rle) {
+      // Write RLE encoding marker.
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      // Write number of RLE values.
+      writeInt32(out, numRows);
+    }
+
+    for (auto i = 0; i < streams_.size(); ++i) {
+      flushColumn(i, out);
+    }
+  }
+
+  // The rows of a top level column that are appended with their encoding
+  // preserved. Either 'constant' or 'dictionary' is set if the column has
+  // rows that are not yet in its stream.
+  struct EncodedColumn {
+    // The constant vector all rows are copies of.
+    VectorPtr constant;
+    int32_t numConstantRows{0};
+
+    // The base vector of the dictionary all rows come from.
+    VectorPtr dictionary;
+    std::vector<vector_size_t> indices;
+
+    // True if rows were added to the stream of the column. All further rows
+    // are added to the stream.
+    bool flat{false};
+  };
+
+  // Adds 'ranges' of 'vector', the 'column'th top level column, to
+  // 'encodedColumns_' if 'vector' is constant or dictionary encoded like the
+  // rows added before. Otherwise moves the rows in 'encodedColumns_' to the
+  // stream of the column and returns false.
+  bool appendEncoded(
+      int32_t column,
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges) {
+    auto& encoded = encodedColumns_[column];
+    if (encoded.flat) {
+      return false;
+    }
+    auto loaded = BaseVector::loadedVectorShared(vector);
+    if (loaded->isConstantEncoding() && encoded.dictionary == nullptr) {
+      if (encoded.constant == nullptr) {
+        encoded.constant = loaded;
+      }
+      if (encoded.constant == loaded ||
+          encoded.constant->equalValueAt(loaded.get(), 0, 0)) {
+        encoded.numConstantRows += rangesTotalSize(ranges);
+        return true;
+      }
+    }
+    // The dictionary must not add nulls since a DICTIONARY block has no
+    // nulls of its own.
+    if (loaded->encoding() == VectorEncoding::Simple::DICTIONARY &&
+        loaded->nulls() == nullptr && encoded.constant == nullptr) {
+      if (encoded.dictionary == nullptr) {
+        encoded.dictionary = loaded->valueVector();
+      }
+      if (encoded.dictionary == loaded->valueVector()) {
+        auto rawIndices = loaded->wrapInfo()->as<vector_size_t>();
+        for (const auto& range : ranges) {
+          encoded.indices.insert(
+              encoded.indices.end(),
+              rawIndices + range.begin,
+              rawIndices + range.begin + range.size);
+        }
+        return true;
+      }
+    }
+    flattenEncoded(encoded, streams_[column].get());
+    encoded.flat = true;
+    return false;
+  }
+
+  // Appends the rows in 'encoded' to 'stream' one value per row.
+  static void flattenEncoded(EncodedColumn& encoded, VectorStream* stream) {
+    if (encoded.constant != nullptr) {
+      std::vector<IndexRange> ranges{{0, encoded.numConstantRows}};
+      serializeColumn(encoded.constant.get(), ranges, stream);
+    } else if (encoded.dictionary != nullptr) {
+      std::vector<IndexRange> ranges;
+      ranges.reserve(encoded.indices.size());
+      for (auto index : encoded.indices) {
+        ranges.push_back(IndexRange{index, 1});
+      }
+      serializeColumn(encoded.dictionary.get(), ranges, stream);
+    }
+    encoded.constant = nullptr;
+    encoded.numConstantRows = 0;
+    encoded.dictionary = nullptr;
+    encoded.indices.clear();
+  }
+
+  // Writes the 'column'th top level column as an RLE or DICTIONARY block if
+  // its rows are in 'encodedColumns_' and as a block of its type otherwise. A
+  // dictionary with more values than rows is not worth sending and the rows
+  // are written one value per row.
+  void flushColumn(int32_t column, OutputStream* out) {
+    if (!preserveEncodings_) {
+      streams_[column]->flush(out);
+      return;
+    }
+    const auto& type = streams_[column]->type();
+    const auto& encoded = encodedColumns_[column];
+    if (encoded.constant != nullptr) {
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      writeInt32(out, encoded.numConstantRows);
+      VectorStream value(type, streamArena_, 1, useLosslessTimestamp_);
+      std::vector<IndexRange> ranges{{0, 1}};
+      serializeColumn(encoded.constant.get(), ranges, &value);
+      value.flush(out);
+      return;
+    }
+    if (encoded.dictionary == nullptr) {
+      streams_[column]->flush(out);
+      return;
+    }
+    const int32_t numRows = encoded.indices.size();
+    const int32_t dictionarySize = encoded.dictionary->size();
+    if (dictionarySize > numRows) {
+      VectorStream flat(type, streamArena_, numRows, useLosslessTimestamp_);
+      auto copy = encoded;
+      flattenEncoded(copy, &flat);
+      flat.flush(out);
+      return;
+    }
+    writeInt32(out, kDictionary.size());
+    out->write(kDictionary.data(), kDictionary.size());
+    writeInt32(out, numRows);
+    VectorStream values(
+        type, streamArena_, dictionarySize, useLosslessTimestamp_);
+    std::vector<IndexRange> ranges{{0, dictionarySize}};
+    serializeColumn(encoded.dictionary.get(), ranges, &values);
+    values.flush(out);
+    out->write(
+        reinterpret_cast<const char*>(encoded.indices.data()),
+        numRows * sizeof(vector_size_t));
+    // The dictionary id, a random UUID and a sequence number. Presto shares
+    // work between blocks with the same dictionary id, so each page gets a
+    // new one.
+    writeInt64(out, folly::Random::rand64());
+    writeInt64(out, folly::Random::rand64());
+    writeInt64(out, 0);
+  }
+
+  // Writes the page with the columns compressed by 'codec_', or uncompressed
+  // if they compress to more than 'minCompressionRatio_' of their size. The
+  // checksum covers the bytes after the header as written.
+  void flushCompressed(int32_t numRows, bool rle, OutputStream* out) {
+    IOBufOutputStream columns(*pool_);
+    writeColumns(numRows, rle, &columns);
+    auto uncompressed = columns.getIOBuf();
+    const int32_t uncompressedSize = uncompressed->computeChainDataLength();
+
+    std::unique_ptr<folly::IOBuf> compressed;
+    {
+      MicrosecondTimer timer(&compressionTimeMicros_);
+      compressed = codec_->compress(uncompressed.get());
+    }
+    const int32_t compressedSize = compressed->computeChainDataLength();
+    compressionInputBytes_ += uncompressedSize;
+
+    const bool useCompressed =
+        compressedSize <= uncompressedSize * minCompressionRatio_;
+    if (useCompressed) {
+      compressedBytes_ += compressedSize;
+    } else {
+      compressionSkippedBytes_ += uncompressedSize;
+    }
+    const auto& body = useCompressed ? compressed : uncompressed;
+
+    auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
+    char codec = 0;
+    if (listener) {
+      listener->reset();
+      listener->pause();
+      codec = getCodecMarker();
+    }
+    if (useCompressed) {
+      codec |= kCompressedBitMask;
+    }
+
+    int32_t offset = out->tellp();
+    writeInt32(out, numRows);
+    out->write(&codec, 1);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, useCompressed ? compressedSize : uncompressedSize);
+    writeInt64(out, 0);
+
+    if (listener) {
+      listener->resume();
+    }
+    for (const auto& range : *body) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+    if (listener) {
+      listener->pause();
+      int32_t end = out->tellp();
+      out->seekp(offset + kChecksumOffset);
+      writeInt64(
+          out, computeChecksum(listener, codec, numRows, uncompressedSize));
+      out->seekp(end);
+    }
+  }
+
+  StreamArena* const streamArena_;
+  memory::MemoryPool* const pool_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const float minCompressionRatio_;
+  const bool useLosslessTimestamp_;
+  const bool preserveEncodings_;
 
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
+
+  // One per top level column if 'preserveEncodings_' is set.
+  std::vector<EncodedColumn> encodedColumns_;
+
+  // Compression stats. See PrestoVectorSerde::kCompressionInputBytes.
+  int64_t compressionInputBytes_{0};
+  int64_t compressedBytes_{0};
+  int64_t compressionSkippedBytes_{0};
+  uint64_t compressionTimeMicros_{0};
 };
 } // namespace
 
@@ -1702,11 +2031,8 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type, numRows, streamArena, toPrestoOptions(options));
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1726,9 +2052,7 @@ void PrestoVectorSerde::deserialize(
     std::shared_ptr<const RowType> type,
     std::shared_ptr<RowVector>* result,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  const auto prestoOptions = toPrestoOptions(options);
   auto numRows = source->read<int32_t>();
   if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
@@ -1739,25 +2063,56 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(
+        source,
+        pool,
+        childTypes,
+        children,
+        prestoOptions.useLosslessTimestamp);
+    return;
+  }
+
+  auto codec = makeCodec(prestoOptions.compressionKind);
+  VELOX_CHECK_NOT_NULL(
+      codec, "Received a compressed page but no compression codec is given");
+  auto compressed = folly::IOBuf::create(sizeInBytes);
+  source->readBytes(compressed->writableData(), sizeInBytes);
+  compressed->append(sizeInBytes);
+  auto uncompressed = codec->uncompress(compressed.get(), uncompressedSize);
+
+  std::vector<ByteRange> ranges;
+  for (const auto& range : *uncompressed) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()), (int32_t)range.size(), 0});
+  }
+  ByteStream uncompressedSource;
+  uncompressedSource.resetInput(std::move(ranges));
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(
+      &uncompressedSource,
+      pool,
+      childTypes,
+      children,
+      prestoOptions.useLosslessTimestamp);
 }
 
 // static
@@ -22,15 +22,39 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    PrestoOptions() = default;
+
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        folly::io::CodecType compressionKind =
+            folly::io::CodecType::NO_COMPRESSION,
+        float minCompressionRatio = 0.8)
+        : Options(compressionKind),
+          useLosslessTimestamp(useLosslessTimestamp),
+          minCompressionRatio(minCompressionRatio) {}
+
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // With 'compressionKind', a page is written uncompressed if compression
+    // does not shrink it to at most this fraction of its size, so that the
+    // reader does not spend time decompressing pages that compress poorly.
+    float minCompressionRatio{0.8};
   };
 
+  // Runtime stats of the compression of the serialized pages.
+  static constexpr const char* kCompressionInputBytes =
+      "compressionInputBytes";
+  static constexpr const char* kCompressedBytes = "compressedBytes";
+  // Bytes of the pages that were written uncompressed because of a poor
+  // compression ratio.
+  static constexpr const char* kCompressionSkippedBytes =
+      "compressionSkippedBytes";
+  static constexpr const char* kCompressionTimeNanos = "compressionTimeNanos";
+
   void estimateSerializedSize(
       std::shared_ptr<BaseVector> vector,
       const folly::Range<const IndexRange*>& ranges,
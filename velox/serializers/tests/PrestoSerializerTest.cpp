@@ -380,3 +380,163 @@ TEST_F(PrestoSerializerTest, lazy) {
       std::make_unique<SimpleVectorLoader>([&](auto) { return rowVector; }));
   testRoundTrip(lazyVector);
 }
+
+TEST_F(PrestoSerializerTest, compression) {
+  using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+  constexpr int kSize = 10'000;
+  auto compressible = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(
+          kSize, [](vector_size_t row) { return row % 7; }),
+      vectorMaker_->flatVector<StringView>(
+          kSize, [](vector_size_t row) { return StringView("repeated"); }),
+  });
+  folly::Random::DefaultGenerator rng(1);
+  auto random = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+      kSize,
+      [&](vector_size_t /*row*/) { return folly::Random::rand64(rng); })});
+
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(kind)) {
+      continue;
+    }
+    SCOPED_TRACE(static_cast<int>(kind));
+    const PrestoVectorSerde::PrestoOptions options(false, kind);
+    for (const auto& rowVector : {compressible, random}) {
+      std::vector<IndexRange> rows{{0, kSize}};
+      auto arena = std::make_unique<StreamArena>(pool_.get());
+      auto rowType = asRowType(rowVector->type());
+      auto serializer =
+          serde_->createSerializer(rowType, kSize, arena.get(), &options);
+      serializer->append(rowVector, folly::Range(rows.data(), rows.size()));
+      serializer::presto::PrestoOutputStreamListener listener;
+      std::ostringstream output;
+      OStreamOutputStream out(&output, &listener);
+      serializer->flush(&out);
+
+      auto stats = serializer->runtimeStats();
+      const auto inputBytes =
+          stats.at(PrestoVectorSerde::kCompressionInputBytes).value;
+      const auto compressedBytes =
+          stats.at(PrestoVectorSerde::kCompressedBytes).value;
+      const auto skippedBytes =
+          stats.at(PrestoVectorSerde::kCompressionSkippedBytes).value;
+      ASSERT_GT(inputBytes, 0);
+      if (rowVector == compressible) {
+        ASSERT_LT(compressedBytes, inputBytes / 2);
+        ASSERT_EQ(skippedBytes, 0);
+        ASSERT_LT(output.str().size(), inputBytes / 2);
+      } else {
+        ASSERT_EQ(compressedBytes, 0);
+        ASSERT_EQ(skippedBytes, inputBytes);
+      }
+
+      assertEqualVectors(
+          rowVector, deserialize(rowType, output.str(), &options));
+      if (rowVector == compressible) {
+        VELOX_ASSERT_THROW(
+            deserialize(rowType, output.str(), nullptr),
+            "Received a compressed page but no compression codec is given");
+      } else {
+        // Pages that are sent uncompressed can be read without the codec.
+        assertEqualVectors(
+            rowVector, deserialize(rowType, output.str(), nullptr));
+      }
+    }
+  }
+}
+
+TEST_F(PrestoSerializerTest, preserveEncodings) {
+  using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+  constexpr int kSize = 1'000;
+  auto dictionaryValues = vectorMaker_->flatVector<StringView>(
+      {"apple", "banana", "cherry", "durian"});
+  auto indices = makeIndices(
+      kSize, [](vector_size_t row) { return row % 4; }, pool_.get());
+  auto dictionary =
+      BaseVector::wrapInDictionary(nullptr, indices, kSize, dictionaryValues);
+  auto constant = BaseVector::createConstant(
+      VARCHAR(), std::string("constant"), kSize, pool_.get());
+  auto flat = vectorMaker_->flatVector<int64_t>(
+      kSize, [](vector_size_t row) { return row; });
+  auto rowVector = vectorMaker_->rowVector({dictionary, constant, flat});
+  auto rowType = asRowType(rowVector->type());
+
+  PrestoVectorSerde::PrestoOptions options;
+  options.preserveEncodings = true;
+
+  // Serializes 'vectors' into one page.
+  auto serializePage = [&](const std::vector<RowVectorPtr>& vectors,
+                           const VectorSerde::Options* serdeOptions) {
+    auto arena = std::make_unique<StreamArena>(pool_.get());
+    auto serializer =
+        serde_->createSerializer(rowType, kSize, arena.get(), serdeOptions);
+    for (const auto& vector : vectors) {
+      std::vector<IndexRange> rows{{0, vector->size()}};
+      serializer->append(vector, folly::Range(rows.data(), rows.size()));
+    }
+    serializer::presto::PrestoOutputStreamListener listener;
+    std::ostringstream output;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    return output.str();
+  };
+
+  auto encoded = serializePage({rowVector, rowVector}, &options);
+  auto flattened = serializePage({rowVector, rowVector}, nullptr);
+  ASSERT_LT(encoded.size(), flattened.size() / 2);
+
+  auto expected = vectorMaker_->rowVector({
+      BaseVector::wrapInDictionary(
+          nullptr,
+          makeIndices(
+              2 * kSize,
+              [](vector_size_t row) { return row % 4; },
+              pool_.get()),
+          2 * kSize,
+          dictionaryValues),
+      BaseVector::createConstant(
+          VARCHAR(), std::string("constant"), 2 * kSize, pool_.get()),
+      vectorMaker_->flatVector<int64_t>(
+          2 * kSize, [](vector_size_t row) { return row % kSize; }),
+  });
+  auto result = deserialize(rowType, encoded, nullptr);
+  ASSERT_EQ(
+      result->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  ASSERT_TRUE(result->childAt(1)->isConstantEncoding());
+  ASSERT_EQ(result->childAt(2)->encoding(), VectorEncoding::Simple::FLAT);
+  assertEqualVectors(expected, result);
+
+  // Rows from different dictionaries and differing constants are written one
+  // value per row.
+  auto otherDictionary = BaseVector::wrapInDictionary(
+      nullptr,
+      indices,
+      kSize,
+      vectorMaker_->flatVector<StringView>(
+          {"apple", "banana", "cherry", "durian"}));
+  auto otherConstant = BaseVector::createConstant(
+      VARCHAR(), std::string("other"), kSize, pool_.get());
+  auto other = vectorMaker_->rowVector({otherDictionary, otherConstant, flat});
+  result = deserialize(
+      rowType, serializePage({rowVector, other}, &options), nullptr);
+  ASSERT_EQ(result->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+  ASSERT_EQ(result->childAt(1)->encoding(), VectorEncoding::Simple::FLAT);
+  auto expectedRows = BaseVector::create(rowType, 0, pool_.get());
+  expectedRows->append(rowVector.get());
+  expectedRows->append(other.get());
+  assertEqualVectors(expectedRows, result);
+
+  // A dictionary larger than the page is not sent.
+  auto rows = vectorMaker_->rowVector({
+      BaseVector::wrapInDictionary(
+          nullptr,
+          makeIndices(2, [](vector_size_t row) { return row; }, pool_.get()),
+          2,
+          dictionaryValues),
+      BaseVector::wrapInConstant(2, 0, constant),
+      vectorMaker_->flatVector<int64_t>({1, 2}),
+  });
+  result = deserialize(rowType, serializePage({rows}, &options), nullptr);
+  ASSERT_EQ(result->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+  assertEqualVectors(rows, result);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace facebook::velox::substrait {
+
+namespace {
+// The path given to the file of the i-th ReadRel of the plan that is
+// translated and cached. Identifies the table scan of the ReadRel among the
+// split infos of the translation.
+const std::string kScanMarker = "velox-plan-cache-scan:";
+
+// Adds the ReadRels under 'rel' to 'reads' in pre-order.
+void collectReads(
+    ::substrait::Rel& rel,
+    std::vector<::substrait::ReadRel*>& reads) {
+  if (rel.has_read()) {
+    reads.push_back(rel.mutable_read());
+  } else if (rel.has_filter()) {
+    collectReads(*rel.mutable_filter()->mutable_input(), reads);
+  } else if (rel.has_project()) {
+    collectReads(*rel.mutable_project()->mutable_input(), reads);
+  } else if (rel.has_aggregate()) {
+    collectReads(*rel.mutable_aggregate()->mutable_input(), reads);
+  } else if (rel.has_sort()) {
+    collectReads(*rel.mutable_sort()->mutable_input(), reads);
+  } else if (rel.has_fetch()) {
+    collectReads(*rel.mutable_fetch()->mutable_input(), reads);
+  } else if (rel.has_expand()) {
+    collectReads(*rel.mutable_expand()->mutable_input(), reads);
+  } else if (rel.has_window()) {
+    collectReads(*rel.mutable_window()->mutable_input(), reads);
+  } else if (rel.has_join()) {
+    collectReads(*rel.mutable_join()->mutable_left(), reads);
+    collectReads(*rel.mutable_join()->mutable_right(), reads);
+  }
+}
+
+std::vector<::substrait::ReadRel*> collectReads(::substrait::Plan& plan) {
+  std::vector<::substrait::ReadRel*> reads;
+  for (auto& relation : *plan.mutable_relations()) {
+    if (relation.has_root()) {
+      collectReads(*relation.mutable_root()->mutable_input(), reads);
+    } else if (relation.has_rel()) {
+      collectReads(*relation.mutable_rel(), reads);
+    }
+  }
+  return reads;
+}
+
+bool readsIterator(const ::substrait::ReadRel& read) {
+  for (const auto& file : read.local_files().items()) {
+    if (file.uri_file().rfind("iterator:", 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Serializes 'plan' so that equal plans have equal keys.
+std::string cacheKey(const ::substrait::Plan& plan) {
+  std::string key;
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream output(&stream);
+    output.SetSerializationDeterministic(true);
+    plan.SerializeToCodedStream(&output);
+  }
+  return key;
+}
+
+SubstraitPlanCache::Result translate(
+    const ::substrait::Plan& substraitPlan,
+    memory::MemoryPool* pool) {
+  SubstraitVeloxPlanConverter converter(pool);
+  SubstraitPlanCache::Result result;
+  result.plan = converter.toVeloxPlan(substraitPlan);
+  result.splitInfos = converter.splitInfos();
+  return result;
+}
+} // namespace
+
+SubstraitPlanCache::Result SubstraitPlanCache::toVeloxPlan(
+    const ::substrait::Plan& substraitPlan,
+    memory::MemoryPool* pool) {
+  ::substrait::Plan normalized = substraitPlan;
+  auto reads = collectReads(normalized);
+
+  // The split infos of the ReadRels with files and the files replaced by a
+  // marker.
+  std::vector<std::shared_ptr<SplitInfo>> splitInfos;
+  for (auto* read : reads) {
+    if (!read->has_local_files()) {
+      continue;
+    }
+    VELOX_USER_CHECK(
+        !readsIterator(*read),
+        "Substrait plans that read from iterators are not cached");
+    auto splitInfo = std::make_shared<SplitInfo>();
+    SubstraitVeloxPlanConverter::parseLocalFiles(
+        read->local_files(), *splitInfo);
+    auto* files = read->mutable_local_files()->mutable_items();
+    if (files->empty()) {
+      files->Add();
+    } else {
+      files->DeleteSubrange(1, files->size() - 1);
+    }
+    auto& file = *files->Mutable(0);
+    file.set_uri_file(fmt::format("{}{}", kScanMarker, splitInfos.size()));
+    file.set_start(0);
+    file.set_length(0);
+    file.set_partition_index(0);
+    splitInfos.push_back(std::move(splitInfo));
+  }
+
+  const auto key = cacheKey(normalized);
+  Result result;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (auto* entry = cache_.get(key)) {
+      result.plan = entry->plan;
+      for (auto i = 0; i < entry->scanIds.size(); ++i) {
+        result.splitInfos[entry->scanIds[i]] = splitInfos[i];
+      }
+      cache_.release(key);
+      return result;
+    }
+  }
+
+  // Translates the plan with the markers and finds the table scan of each
+  // ReadRel by the marker in its split info.
+  auto translated = translate(normalized, pool);
+  std::vector<core::PlanNodeId> scanIds(splitInfos.size());
+  vector_size_t numFound = 0;
+  for (const auto& [id, splitInfo] : translated.splitInfos) {
+    if (splitInfo->paths.size() != 1 ||
+        splitInfo->paths[0].rfind(kScanMarker, 0) != 0) {
+      continue;
+    }
+    const auto index =
+        std::stoul(splitInfo->paths[0].substr(kScanMarker.size()));
+    VELOX_CHECK_LT(index, scanIds.size());
+    scanIds[index] = id;
+    ++numFound;
+  }
+  if (numFound != splitInfos.size() ||
+      translated.splitInfos.size() != splitInfos.size()) {
+    // A ReadRel did not become a table scan with files. Does not cache.
+    return translate(substraitPlan, pool);
+  }
+
+  result.plan = translated.plan;
+  for (auto i = 0; i < scanIds.size(); ++i) {
+    result.splitInfos[scanIds[i]] = splitInfos[i];
+  }
+  auto* entry = new Entry{translated.plan, std::move(scanIds)};
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!cache_.add(key, entry, 1)) {
+    delete entry;
+  }
+  return result;
+}
+
+} // namespace facebook::velox::substrait
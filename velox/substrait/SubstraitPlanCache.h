@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/substrait/SubstraitToVeloxPlan.h"
+
+namespace facebook::velox::substrait {
+
+/// Caches the Velox plans translated from Substrait plans. Engines that
+/// offload many tasks of the same stage send the same plan over and over,
+/// with only the files of the ReadRels changing from task to task.
+/// Translating such a plan again resolves the same functions, builds the same
+/// typed expressions and the same pushed down filters. The cache looks up the
+/// plan with the files of its ReadRels stripped and reuses the Velox plan of
+/// an earlier plan of the same shape, pairing its table scans with the split
+/// infos of the files of the new plan.
+///
+/// Plans that read from iterators need the input nodes of a
+/// SubstraitVeloxPlanConverter and are not supported. Plans that differ in
+/// literals are different entries since the literals are folded into filters
+/// and constants of the Velox plan. Velox plan nodes are immutable and can be
+/// shared by tasks running at the same time. Thread safe.
+class SubstraitPlanCache {
+ public:
+  /// A Velox plan and the split infos of its table scans.
+  struct Result {
+    core::PlanNodePtr plan;
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>
+        splitInfos;
+  };
+
+  /// Caches up to 'maxEntries' plans.
+  explicit SubstraitPlanCache(size_t maxEntries) : cache_(maxEntries) {}
+
+  /// Returns the cached Velox plan for a plan of the same shape as
+  /// 'substraitPlan' or translates 'substraitPlan' using memory from 'pool'
+  /// and caches the result. Throws if 'substraitPlan' reads from an
+  /// iterator.
+  Result toVeloxPlan(
+      const ::substrait::Plan& substraitPlan,
+      memory::MemoryPool* pool);
+
+  SimpleLRUCacheStats stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.getStats();
+  }
+
+ private:
+  struct Entry {
+    core::PlanNodePtr plan;
+
+    // The id of the table scan of each ReadRel with files, in the order the
+    // ReadRels appear in the plan.
+    std::vector<core::PlanNodeId> scanIds;
+  };
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, Entry> cache_;
+};
+
+} // namespace facebook::velox::substrait
@@ -694,6 +694,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
       sortingOrders,
       windowColumnNames,
       windowNodeFunctions,
+      false,
       childNode);
 }
 
@@ -865,32 +866,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
 
   // Parse local files and construct split info.
   if (readRel.has_local_files()) {
-    using SubstraitFileFormatCase =
-        ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
-    const auto& fileList = readRel.local_files().items();
-    splitInfo->paths.reserve(fileList.size());
-    splitInfo->starts.reserve(fileList.size());
-    splitInfo->lengths.reserve(fileList.size());
-    for (const auto& file : fileList) {
-      // Expect all Partitions share the same index.
-      splitInfo->partitionIndex = file.partition_index();
-      splitInfo->paths.emplace_back(file.uri_file());
-      splitInfo->starts.emplace_back(file.start());
-      splitInfo->lengths.emplace_back(file.length());
-      switch (file.file_format_case()) {
-        case SubstraitFileFormatCase::kOrc:
-          splitInfo->format = dwio::common::FileFormat::ORC;
-          break;
-        case SubstraitFileFormatCase::kDwrf:
-          splitInfo->format = dwio::common::FileFormat::DWRF;
-          break;
-        case SubstraitFileFormatCase::kParquet:
-          splitInfo->format = dwio::common::FileFormat::PARQUET;
-          break;
-        default:
-          splitInfo->format = dwio::common::FileFormat::UNKNOWN;
-      }
-    }
+    parseLocalFiles(readRel.local_files(), *splitInfo);
   }
   // Do not hard-code connector ID and allow for connectors other than Hive.
   static const std::string kHiveConnectorId = "test-hive";
@@ -1130,6 +1106,38 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
   VELOX_FAIL("RelRoot or Rel is expected in Plan.");
 }
 
+// static
+void SubstraitVeloxPlanConverter::parseLocalFiles(
+    const ::substrait::ReadRel_LocalFiles& localFiles,
+    SplitInfo& splitInfo) {
+  using SubstraitFileFormatCase =
+      ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
+  const auto& fileList = localFiles.items();
+  splitInfo.paths.reserve(fileList.size());
+  splitInfo.starts.reserve(fileList.size());
+  splitInfo.lengths.reserve(fileList.size());
+  for (const auto& file : fileList) {
+    // Expect all Partitions share the same index.
+    splitInfo.partitionIndex = file.partition_index();
+    splitInfo.paths.emplace_back(file.uri_file());
+    splitInfo.starts.emplace_back(file.start());
+    splitInfo.lengths.emplace_back(file.length());
+    switch (file.file_format_case()) {
+      case SubstraitFileFormatCase::kOrc:
+        splitInfo.format = dwio::common::FileFormat::ORC;
+        break;
+      case SubstraitFileFormatCase::kDwrf:
+        splitInfo.format = dwio::common::FileFormat::DWRF;
+        break;
+      case SubstraitFileFormatCase::kParquet:
+        splitInfo.format = dwio::common::FileFormat::PARQUET;
+        break;
+      default:
+        splitInfo.format = dwio::common::FileFormat::UNKNOWN;
+    }
+  }
+}
+
 std::string SubstraitVeloxPlanConverter::nextPlanNodeId() {
   auto id = fmt::format("{}", planNodeId_);
   planNodeId_++;
@@ -132,6 +132,12 @@ class SubstraitVeloxPlanConverter {
     planNodeId_ = planNodeId;
   }
 
+  /// Adds the paths, starts, lengths, partition index and format of the files
+  /// in 'localFiles' to 'splitInfo'.
+  static void parseLocalFiles(
+      const ::substrait::ReadRel_LocalFiles& localFiles,
+      SplitInfo& splitInfo);
+
   /// Used to check if ReadRel specifies an input of stream.
   /// If yes, the index of input stream will be returned.
   /// If not, -1 will be returned.
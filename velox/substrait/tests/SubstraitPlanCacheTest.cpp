@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/common/tests/utils/DataFiles.h"
+#include "velox/substrait/tests/JsonToProtoConverter.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+using namespace facebook::velox::substrait;
+
+class SubstraitPlanCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    JsonToProtoConverter::readFromFile(
+        getDataFilePath("velox/substrait/tests", "data/if_then.json"), plan_);
+  }
+
+  ::substrait::ReadRel_LocalFiles_FileOrFiles& file(::substrait::Plan& plan) {
+    return *plan.mutable_relations(0)
+                ->mutable_root()
+                ->mutable_input()
+                ->mutable_project()
+                ->mutable_input()
+                ->mutable_read()
+                ->mutable_local_files()
+                ->mutable_items(0);
+  }
+
+  // Returns the only split info of 'result'.
+  static const SplitInfo& splitInfo(const SubstraitPlanCache::Result& result) {
+    EXPECT_EQ(result.splitInfos.size(), 1);
+    EXPECT_EQ(result.plan->leafPlanNodeIds().size(), 1);
+    return *result.splitInfos.at(*result.plan->leafPlanNodeIds().begin());
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{
+      memory::addDefaultLeafMemoryPool()};
+  ::substrait::Plan plan_;
+};
+
+TEST_F(SubstraitPlanCacheTest, differentFiles) {
+  SubstraitPlanCache cache(10);
+  auto first = cache.toVeloxPlan(plan_, pool_.get());
+  EXPECT_EQ(splitInfo(first).paths[0], "file:///tmp/tmp_file");
+  EXPECT_EQ(
+      first.plan->toString(true, true),
+      SubstraitVeloxPlanConverter(pool_.get())
+          .toVeloxPlan(plan_)
+          ->toString(true, true));
+
+  auto other = plan_;
+  file(other).set_uri_file("file:///tmp/other_file");
+  file(other).set_start(100);
+  file(other).set_length(200);
+  auto second = cache.toVeloxPlan(other, pool_.get());
+  EXPECT_EQ(second.plan, first.plan);
+  const auto& info = splitInfo(second);
+  EXPECT_EQ(info.paths, std::vector<std::string>{"file:///tmp/other_file"});
+  EXPECT_EQ(info.starts, std::vector<uint64_t>{100});
+  EXPECT_EQ(info.lengths, std::vector<uint64_t>{200});
+  EXPECT_EQ(info.format, dwio::common::FileFormat::PARQUET);
+
+  // The files of the first plan are not kept.
+  EXPECT_EQ(
+      splitInfo(cache.toVeloxPlan(plan_, pool_.get())).paths[0],
+      "file:///tmp/tmp_file");
+
+  const auto stats = cache.stats();
+  EXPECT_EQ(stats.numElements, 1);
+  EXPECT_EQ(stats.numLookups, 3);
+  EXPECT_EQ(stats.numHits, 2);
+}
+
+TEST_F(SubstraitPlanCacheTest, differentLiterals) {
+  SubstraitPlanCache cache(10);
+  auto first = cache.toVeloxPlan(plan_, pool_.get());
+
+  std::string json;
+  ASSERT_TRUE(google::protobuf::util::MessageToJsonString(plan_, &json).ok());
+  const auto pos = json.find("\"unknown\"");
+  ASSERT_NE(pos, std::string::npos);
+  json.replace(pos, 9, "\"other\"");
+  ::substrait::Plan other;
+  ASSERT_TRUE(google::protobuf::util::JsonStringToMessage(json, &other).ok());
+
+  auto second = cache.toVeloxPlan(other, pool_.get());
+  EXPECT_NE(second.plan, first.plan);
+  EXPECT_NE(
+      second.plan->toString(true, true).find("\"other\""), std::string::npos);
+  EXPECT_EQ(cache.stats().numElements, 2);
+  EXPECT_EQ(cache.stats().numHits, 0);
+}
+
+TEST_F(SubstraitPlanCacheTest, iterators) {
+  SubstraitPlanCache cache(10);
+  file(plan_).set_uri_file("iterator:0");
+  VELOX_ASSERT_THROW(
+      cache.toVeloxPlan(plan_, pool_.get()),
+      "Substrait plans that read from iterators are not cached");
+  EXPECT_EQ(cache.stats().numLookups, 0);
+  EXPECT_EQ(cache.stats().numElements, 0);
+}
@@ -87,6 +87,118 @@ Date toDate(std::string_view stringDate) {
   parseTo(stringDate, date);
   return date;
 }
+
+// Returns the scale factor DBGEN runs with. See DBGenIterator.
+int64_t dbgenScaleFactor(double scaleFactor) {
+  if (scaleFactor < MIN_SCALE && scaleFactor > 0) {
+    return 1;
+  }
+  return static_cast<int64_t>(scaleFactor);
+}
+
+// Returns the key of order 'rowNumber', the same as mk_sparse() of DBGEN for
+// the initial load.
+int64_t orderKey(int64_t rowNumber) {
+  const int64_t lowBits = rowNumber & ((1 << SPARSE_KEEP) - 1);
+  return ((rowNumber >> SPARSE_KEEP) << (SPARSE_BITS + SPARSE_KEEP)) + lowBits;
+}
+
+// Returns the retail price in cents of part 'partKey', the same as
+// rpb_routine() of DBGEN.
+int64_t partRetailPrice(int64_t partKey) {
+  return 90'000 + (partKey / 10) % 20'001 + (partKey % 1'000) * 100;
+}
+
+// Returns the key of the supplier number 'supplier' of part 'partKey', the
+// same as PART_SUPP_BRIDGE() of DBGEN.
+int64_t partSupplierKey(
+    int64_t partKey,
+    int64_t supplier,
+    int64_t numSuppliers) {
+  const auto stride =
+      numSuppliers / SUPP_PER_PART + (partKey - 1) / numSuppliers;
+  return (partKey + supplier * stride) % numSuppliers + 1;
+}
+
+// Generates 'column' of 'table' for the 'size' rows starting at 'offset'
+// into 'result'. 'column' must be native.
+void genNativeColumn(
+    Table table,
+    column_index_t column,
+    size_t offset,
+    double scaleFactor,
+    BaseVector& result) {
+  const auto size = result.size();
+  if (table == Table::TBL_PART && column == 7) {
+    auto* rawPrices = result.asFlatVector<double>()->mutableRawValues();
+    for (size_t i = 0; i < size; ++i) {
+      rawPrices[i] = decimalToDouble(partRetailPrice(offset + i + 1));
+    }
+    return;
+  }
+
+  auto* rawValues = result.asFlatVector<int64_t>()->mutableRawValues();
+  switch (table) {
+    case Table::TBL_ORDERS:
+      for (size_t i = 0; i < size; ++i) {
+        rawValues[i] = orderKey(offset + i + 1);
+      }
+      break;
+    case Table::TBL_PARTSUPP:
+      // Each part has SUPP_PER_PART consecutive partsupp rows.
+      if (column == 0) {
+        for (size_t i = 0; i < size; ++i) {
+          rawValues[i] = (offset + i) / SUPP_PER_PART + 1;
+        }
+      } else {
+        const int64_t numSuppliers = 10'000 * dbgenScaleFactor(scaleFactor);
+        for (size_t i = 0; i < size; ++i) {
+          const auto row = offset + i;
+          rawValues[i] = partSupplierKey(
+              row / SUPP_PER_PART + 1, row % SUPP_PER_PART, numSuppliers);
+        }
+      }
+      break;
+    case Table::TBL_NATION:
+    case Table::TBL_REGION:
+      for (size_t i = 0; i < size; ++i) {
+        rawValues[i] = offset + i;
+      }
+      break;
+    default:
+      for (size_t i = 0; i < size; ++i) {
+        rawValues[i] = offset + i + 1;
+      }
+      break;
+  }
+}
+
+RowVectorPtr genTpchTable(
+    Table table,
+    memory::MemoryPool* pool,
+    size_t maxRows,
+    size_t offset,
+    double scaleFactor) {
+  switch (table) {
+    case Table::TBL_PART:
+      return genTpchPart(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_SUPPLIER:
+      return genTpchSupplier(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_PARTSUPP:
+      return genTpchPartSupp(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_CUSTOMER:
+      return genTpchCustomer(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_ORDERS:
+      return genTpchOrders(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_LINEITEM:
+      return genTpchLineItem(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_NATION:
+      return genTpchNation(pool, maxRows, offset, scaleFactor);
+    case Table::TBL_REGION:
+      return genTpchRegion(pool, maxRows, offset, scaleFactor);
+  }
+  return nullptr; // make gcc happy.
+}
 } // namespace
 
 std::string_view toTableName(Table table) {
@@ -356,6 +468,70 @@ TypePtr resolveTpchColumn(Table table, const std::string& columnName) {
   return getTableSchema(table)->findChild(columnName);
 }
 
+bool isNativeColumn(Table table, column_index_t column) {
+  switch (table) {
+    case Table::TBL_PART:
+      // p_partkey and p_retailprice.
+      return column == 0 || column == 7;
+    case Table::TBL_PARTSUPP:
+      // ps_partkey and ps_suppkey.
+      return column <= 1;
+    case Table::TBL_SUPPLIER:
+    case Table::TBL_CUSTOMER:
+    case Table::TBL_ORDERS:
+    case Table::TBL_NATION:
+    case Table::TBL_REGION:
+      return column == 0;
+    case Table::TBL_LINEITEM:
+      // The number of lines of each order is random.
+      return false;
+  }
+  return false; // make gcc happy.
+}
+
+RowVectorPtr genTpchData(
+    Table table,
+    const std::vector<column_index_t>& columns,
+    memory::MemoryPool* pool,
+    size_t maxRows,
+    size_t offset,
+    double scaleFactor) {
+  const auto& schema = getTableSchema(table);
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto column : columns) {
+    VELOX_CHECK_LT(column, schema->size());
+    names.push_back(schema->nameOf(column));
+    types.push_back(schema->childAt(column));
+  }
+  auto rowType = ROW(std::move(names), std::move(types));
+
+  const bool allNative = table != Table::TBL_LINEITEM &&
+      std::all_of(columns.begin(), columns.end(), [&](auto column) {
+        return isNativeColumn(table, column);
+      });
+  std::vector<VectorPtr> children;
+  children.reserve(columns.size());
+  if (allNative) {
+    const auto vectorSize =
+        getVectorSize(getRowCount(table, scaleFactor), maxRows, offset);
+    for (auto i = 0; i < columns.size(); ++i) {
+      children.push_back(
+          BaseVector::create(rowType->childAt(i), vectorSize, pool));
+      genNativeColumn(table, columns[i], offset, scaleFactor, *children[i]);
+    }
+    return std::make_shared<RowVector>(
+        pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+  }
+
+  auto data = genTpchTable(table, pool, maxRows, offset, scaleFactor);
+  for (auto column : columns) {
+    children.push_back(data->childAt(column));
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), data->size(), std::move(children));
+}
+
 RowVectorPtr genTpchOrders(
     memory::MemoryPool* pool,
     size_t maxRows,
@@ -65,6 +65,29 @@ RowTypePtr getTableSchema(Table table);
 /// does not exist in `table`.
 TypePtr resolveTpchColumn(Table table, const std::string& columnName);
 
+/// Returns a row vector with only the `columns` of `table`, given as indices
+/// into getTableSchema(table), in the order given. The rows, `maxRows`,
+/// `offset` and `scaleFactor` are the same as for the genTpch*() function of
+/// the table below.
+///
+/// Keys and the other columns that DBGEN computes from the row number alone
+/// (p_retailprice, ps_suppkey) are generated natively, a vector at a time. If
+/// all `columns` are such columns, or if `columns` is empty, DBGEN does not
+/// run at all, which makes scans of join keys and counts of large tables
+/// cheap. Other projections generate the rows with DBGEN and only keep
+/// `columns`.
+RowVectorPtr genTpchData(
+    Table table,
+    const std::vector<column_index_t>& columns,
+    memory::MemoryPool* pool,
+    size_t maxRows = 10000,
+    size_t offset = 0,
+    double scaleFactor = 1);
+
+/// Returns true if genTpchData() generates `column` of `table` natively,
+/// without DBGEN.
+bool isNativeColumn(Table table, column_index_t column);
+
 /// Returns a row vector containing at most `maxRows` rows of the "orders"
 /// table, starting at `offset`, and given the scale factor. The row vector
 /// returned has the following schema:
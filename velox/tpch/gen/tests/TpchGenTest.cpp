@@ -819,6 +819,101 @@ TEST_F(TpchGenTestCustomerTest, reproducible) {
   }
 }
 
+// genTpchData() tests.
+
+class TpchGenTestDataTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = memory::defaultMemoryManager().addLeafPool("TpchGenTestDataTest");
+  }
+
+  // Checks that the natively generated columns of 'table' are the same as the
+  // ones generated by DBGEN.
+  void testNativeColumns(
+      Table table,
+      size_t maxRows,
+      size_t offset,
+      double scaleFactor) {
+    SCOPED_TRACE(fmt::format(
+        "{} offset {} scale factor {}",
+        toTableName(table),
+        offset,
+        scaleFactor));
+    std::vector<column_index_t> columns;
+    for (auto i = 0; i < getTableSchema(table)->size(); ++i) {
+      if (isNativeColumn(table, i)) {
+        columns.push_back(i);
+      }
+    }
+    ASSERT_FALSE(columns.empty());
+
+    auto native =
+        genTpchData(table, columns, pool_.get(), maxRows, offset, scaleFactor);
+    // The first column is generated by DBGEN, so all columns are.
+    auto withDbgen = columns;
+    withDbgen.insert(withDbgen.begin(), columns.back() + 1);
+    auto expected = genTpchData(
+        table, withDbgen, pool_.get(), maxRows, offset, scaleFactor);
+
+    ASSERT_EQ(columns.size(), native->childrenSize());
+    ASSERT_EQ(expected->size(), native->size());
+    for (auto i = 0; i < columns.size(); ++i) {
+      EXPECT_EQ(
+          getTableSchema(table)->nameOf(columns[i]),
+          native->type()->asRow().nameOf(i));
+      for (auto row = 0; row < native->size(); ++row) {
+        ASSERT_TRUE(native->childAt(i)->equalValueAt(
+            expected->childAt(i + 1).get(), row, row))
+            << "at row " << row << " of " << native->type()->asRow().nameOf(i);
+      }
+    }
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_;
+};
+
+TEST_F(TpchGenTestDataTest, nativeColumns) {
+  for (auto table :
+       {Table::TBL_PART,
+        Table::TBL_SUPPLIER,
+        Table::TBL_PARTSUPP,
+        Table::TBL_CUSTOMER,
+        Table::TBL_ORDERS,
+        Table::TBL_NATION,
+        Table::TBL_REGION}) {
+    testNativeColumns(table, 1'000, 0, 1);
+    testNativeColumns(table, 1'000, 37, 0.01);
+    testNativeColumns(table, 100, 54'321, 10);
+  }
+  // Each part has 4 partsupp rows. Starts in the middle of a part.
+  testNativeColumns(Table::TBL_PARTSUPP, 100, 7'999'998, 10);
+  EXPECT_FALSE(isNativeColumn(Table::TBL_LINEITEM, 0));
+}
+
+TEST_F(TpchGenTestDataTest, projection) {
+  auto full = genTpchLineItem(pool_.get(), 100, 10);
+  auto projected =
+      genTpchData(Table::TBL_LINEITEM, {15, 0}, pool_.get(), 100, 10);
+  ASSERT_EQ(2, projected->childrenSize());
+  ASSERT_EQ(full->size(), projected->size());
+  EXPECT_EQ("l_comment", projected->type()->asRow().nameOf(0));
+  EXPECT_EQ("l_orderkey", projected->type()->asRow().nameOf(1));
+  for (auto row = 0; row < full->size(); ++row) {
+    ASSERT_TRUE(projected->childAt(0)->equalValueAt(
+        full->childAt(15).get(), row, row));
+    ASSERT_TRUE(projected->childAt(1)->equalValueAt(
+        full->childAt(0).get(), row, row));
+  }
+
+  // No columns. Counts the rows without running DBGEN.
+  auto rows = genTpchData(Table::TBL_ORDERS, {}, pool_.get(), 10'000, 0, 100);
+  EXPECT_EQ(0, rows->childrenSize());
+  EXPECT_EQ(10'000, rows->size());
+  rows = genTpchData(
+      Table::TBL_ORDERS, {}, pool_.get(), 10'000, 149'999'000, 100);
+  EXPECT_EQ(1'000, rows->size());
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
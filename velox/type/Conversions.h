@@ -17,7 +17,10 @@
 #pragma once
 
 #include <folly/Conv.h>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <type_traits>
 #include "velox/common/base/Exceptions.h"
@@ -29,6 +32,133 @@
 
 namespace facebook::velox::util {
 
+namespace detail {
+
+// Returns true if all 8 bytes of 'chunk' are ASCII digits. Checks the bytes in
+// parallel in a 64-bit register.
+inline bool isEightDigits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+      0x3333333333333333;
+}
+
+// Returns the value of the 8 ASCII digits in 'chunk', loaded from memory in
+// little-endian order. Combines the digits pairwise with 3 multiplications
+// instead of 8.
+inline uint32_t parseEightDigits(uint64_t chunk) {
+  constexpr uint64_t kMask = 0x000000FF000000FF;
+  constexpr uint64_t kMul1 = 100 + (1'000'000ULL << 32);
+  constexpr uint64_t kMul2 = 1 + (10'000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return static_cast<uint32_t>(
+      (((chunk & kMask) * kMul1) + (((chunk >> 16) & kMask) * kMul2)) >> 32);
+}
+
+// Parses the digits in [begin, end) into 'value', 8 at a time where possible.
+// Returns false if there is a character that is not a digit. There must be
+// at most 19 digits.
+inline bool parseDigits(const char* begin, const char* end, uint64_t& value) {
+  value = 0;
+  for (; end - begin >= 8; begin += 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, begin, sizeof(chunk));
+    if (!isEightDigits(chunk)) {
+      return false;
+    }
+    value = value * 100'000'000 + parseEightDigits(chunk);
+  }
+  for (; begin < end; ++begin) {
+    const uint8_t digit = *begin - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+/// Parses 'v' of the form -?[0-9]{1,18} into 'result'. Returns false for
+/// anything else, e.g. spaces, a '+' sign or more digits, so that the caller
+/// falls back to folly::to(), which gives the same result for the strings
+/// accepted here.
+inline bool tryParseIntegerFast(folly::StringPiece v, int64_t& result) {
+  const char* begin = v.begin();
+  const bool negative = !v.empty() && *begin == '-';
+  begin += negative;
+  const auto numDigits = v.end() - begin;
+  uint64_t value;
+  if (numDigits == 0 || numDigits > 18 ||
+      !parseDigits(begin, v.end(), value)) {
+    return false;
+  }
+  result = static_cast<int64_t>(value);
+  result = negative ? -result : result;
+  return true;
+}
+
+/// Parses 'v' of the form -?(0|[1-9][0-9]*)(\.[0-9]+)? with at most 15 digits
+/// into 'result'. Both the digits as an integer and the power of 10 to divide
+/// them by are exact doubles, so the division rounds correctly and gives the
+/// same result as folly::to(). Returns false for anything else, e.g. exponents,
+/// 'Infinity' or longer mantissas, for the caller to fall back to folly::to().
+inline bool tryParseDoubleFast(folly::StringPiece v, double& result) {
+  static constexpr double kPowersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  const char* begin = v.begin();
+  const bool negative = !v.empty() && *begin == '-';
+  begin += negative;
+  const char* point = std::find(begin, v.end(), '.');
+  const auto numIntegerDigits = point - begin;
+  if (numIntegerDigits == 0 || (*begin == '0' && numIntegerDigits > 1)) {
+    return false;
+  }
+  const char* fractionBegin = point == v.end() ? point : point + 1;
+  const auto numFractionDigits = v.end() - fractionBegin;
+  if ((point != v.end() && numFractionDigits == 0) ||
+      numIntegerDigits + numFractionDigits > 15) {
+    return false;
+  }
+  uint64_t integerPart;
+  uint64_t fractionPart;
+  if (!parseDigits(begin, point, integerPart) ||
+      !parseDigits(fractionBegin, v.end(), fractionPart)) {
+    return false;
+  }
+  const auto mantissa =
+      integerPart * static_cast<uint64_t>(kPowersOfTen[numFractionDigits]) +
+      fractionPart;
+  result = static_cast<double>(mantissa) / kPowersOfTen[numFractionDigits];
+  result = negative ? -result : result;
+  return true;
+}
+
+/// Converts 'v' to an integer of type T or a double with the fast parsers
+/// above. Returns false if 'v' is not in the form they accept or the value is
+/// out of range for T.
+template <typename T>
+inline bool tryCastFromStringFast(folly::StringPiece v, T& result) {
+  if constexpr (
+      std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+      std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+    int64_t value;
+    if (!tryParseIntegerFast(v, value) ||
+        value < std::numeric_limits<T>::min() ||
+        value > std::numeric_limits<T>::max()) {
+      return false;
+    }
+    result = value;
+    return true;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return tryParseDoubleFast(v, result);
+  } else {
+    return false;
+  }
+}
+
+} // namespace detail
+
 template <
     TypeKind KIND,
     typename = void,
@@ -227,6 +357,10 @@ struct Converter<
       if constexpr (TRUNCATE) {
         return convertStringToInt(v, ALLOW_DECIMAL, nullOutput);
       } else {
+        T result;
+        if (detail::tryCastFromStringFast(v, result)) {
+          return result;
+        }
         return folly::to<T>(v);
       }
     } catch (const std::exception& e) {
@@ -235,28 +369,11 @@ struct Converter<
   }
 
   static T cast(const StringView& v, bool& nullOutput) {
-    try {
-      if constexpr (TRUNCATE) {
-        return convertStringToInt(
-            folly::StringPiece(v), ALLOW_DECIMAL, nullOutput);
-      } else {
-        return folly::to<T>(folly::StringPiece(v));
-      }
-    } catch (const std::exception& e) {
-      VELOX_USER_FAIL(e.what());
-    }
+    return cast(folly::StringPiece(v), nullOutput);
   }
 
   static T cast(const std::string& v, bool& nullOutput) {
-    try {
-      if constexpr (TRUNCATE) {
-        return convertStringToInt(v, ALLOW_DECIMAL, nullOutput);
-      } else {
-        return folly::to<T>(v);
-      }
-    } catch (const std::exception& e) {
-      VELOX_USER_FAIL(e.what());
-    }
+    return cast(folly::StringPiece(v), nullOutput);
   }
 
   static T cast(const bool& v, bool& nullOutput) {
@@ -423,15 +540,19 @@ struct Converter<
   }
 
   static T cast(const folly::StringPiece& v, bool& nullOutput) {
+    T result;
+    if (detail::tryCastFromStringFast(v, result)) {
+      return result;
+    }
     return cast<folly::StringPiece>(v, nullOutput);
   }
 
   static T cast(const StringView& v, bool& nullOutput) {
-    return cast<folly::StringPiece>(folly::StringPiece(v), nullOutput);
+    return cast(folly::StringPiece(v), nullOutput);
   }
 
   static T cast(const std::string& v, bool& nullOutput) {
-    return cast<std::string>(v, nullOutput);
+    return cast(folly::StringPiece(v), nullOutput);
   }
 
   static T cast(const bool& v, bool& nullOutput) {
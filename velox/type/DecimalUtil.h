@@ -183,6 +183,92 @@ class DecimalUtil {
     return remainder;
   }
 
+  /// Returns true if 'value' fits in 64 bits.
+  inline static bool fitsInt64(int128_t value) {
+    return value == static_cast<int64_t>(value);
+  }
+
+  /// Returns true if 'value' is in the range of the unscaled values of 'R',
+  /// which is UnscaledShortDecimal or UnscaledLongDecimal.
+  template <typename R>
+  inline static bool valueInRange(int128_t value) {
+    if constexpr (std::is_same_v<R, UnscaledShortDecimal>) {
+      return fitsInt64(value) && UnscaledShortDecimal::valueInRange(value);
+    } else {
+      return UnscaledLongDecimal::valueInRange(value);
+    }
+  }
+
+  /// Sets 'result' to 'a' * 'b' and returns true if the product overflows
+  /// 128 bits. The unscaled values of most decimals fit in 64 bits, so the
+  /// product of two such values is computed with a single 64 x 64 -> 128 bit
+  /// multiplication, which cannot overflow. Only larger values take the
+  /// checked 128 bit multiplication, which is a library call.
+  inline static bool
+  multiplyWithOverflow(int128_t a, int128_t b, int128_t& result) {
+    if (LIKELY(fitsInt64(a) && fitsInt64(b))) {
+      result = static_cast<int128_t>(static_cast<int64_t>(a)) *
+          static_cast<int64_t>(b);
+      return false;
+    }
+    return __builtin_mul_overflow(a, b, &result);
+  }
+
+  /// Sets 'result' to 'value' * 10 ^ 'power' and returns true on overflow.
+  inline static bool
+  rescaleWithOverflow(int128_t value, uint8_t power, int128_t& result) {
+    if (power == 0) {
+      result = value;
+      return false;
+    }
+    return multiplyWithOverflow(value, kPowersOfTen[power], result);
+  }
+
+  /// Same as divideWithRoundUp() for unscaled values. Sets 'r' to 'a' * 10 ^
+  /// 'aRescale' / 'b' rounded half away from zero unless 'noRoundUp' is set
+  /// and returns the remainder. Throws if the rescaled dividend is outside
+  /// the range of 'R'. Divides in 64 bits when the rescaled dividend and the
+  /// divisor fit, which is a single instruction instead of a library call.
+  template <typename R>
+  inline static int128_t divideUnscaledWithRoundUp(
+      int128_t& r,
+      int128_t a,
+      int128_t b,
+      bool noRoundUp,
+      uint8_t aRescale) {
+    VELOX_CHECK_NE(b, 0, "Division by zero");
+    const bool negative = (a < 0) != (b < 0);
+    const int128_t unsignedDividend = a < 0 ? -a : a;
+    const int128_t unsignedDivisor = b < 0 ? -b : b;
+    int128_t dividend;
+    if (UNLIKELY(
+            rescaleWithOverflow(unsignedDividend, aRescale, dividend) ||
+            !valueInRange<R>(dividend))) {
+      VELOX_ARITHMETIC_ERROR(
+          "Decimal overflow: {} * {}",
+          unsignedDividend,
+          kPowersOfTen[aRescale]);
+    }
+    int128_t quotient;
+    int128_t remainder;
+    if (LIKELY(
+            dividend <= std::numeric_limits<uint64_t>::max() &&
+            unsignedDivisor <= std::numeric_limits<uint64_t>::max())) {
+      const auto dividend64 = static_cast<uint64_t>(dividend);
+      const auto divisor64 = static_cast<uint64_t>(unsignedDivisor);
+      quotient = dividend64 / divisor64;
+      remainder = dividend64 % divisor64;
+    } else {
+      quotient = dividend / unsignedDivisor;
+      remainder = dividend % unsignedDivisor;
+    }
+    if (!noRoundUp && remainder * 2 >= unsignedDivisor) {
+      ++quotient;
+    }
+    r = negative ? -quotient : quotient;
+    return remainder;
+  }
+
   /*
    * sum up and return overflow/underflow.
    */
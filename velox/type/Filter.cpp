@@ -22,6 +22,7 @@
 #include <string>
 
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/encode/Base64.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::common {
@@ -95,6 +96,9 @@ std::string Filter::toString() const {
     case FilterKind::kShortDecimalMultiRange:
       strKind = "ShortDecimalMultiRange";
       break;
+    case FilterKind::kBloomFilter:
+      strKind = "BloomFilterValues";
+      break;
   };
 
   return fmt::format(
@@ -104,6 +108,147 @@ std::string Filter::toString() const {
       nullAllowed_ ? "null allowed" : "null not allowed");
 }
 
+folly::dynamic Filter::serializeBase(std::string_view name) const {
+  folly::dynamic obj = folly::dynamic::object;
+  obj["name"] = name;
+  obj["nullAllowed"] = nullAllowed_;
+  return obj;
+}
+
+folly::dynamic AlwaysFalse::serialize() const {
+  return serializeBase("AlwaysFalse");
+}
+
+folly::dynamic AlwaysTrue::serialize() const {
+  return serializeBase("AlwaysTrue");
+}
+
+folly::dynamic IsNull::serialize() const {
+  return serializeBase("IsNull");
+}
+
+folly::dynamic IsNotNull::serialize() const {
+  return serializeBase("IsNotNull");
+}
+
+folly::dynamic BigintRange::serialize() const {
+  auto obj = serializeBase("BigintRange");
+  obj["lower"] = lower_;
+  obj["upper"] = upper_;
+  return obj;
+}
+
+namespace {
+folly::dynamic serializeBigintValues(const std::vector<int64_t>& values) {
+  folly::dynamic array = folly::dynamic::array;
+  for (auto value : values) {
+    array.push_back(value);
+  }
+  return array;
+}
+} // namespace
+
+folly::dynamic BigintValuesUsingHashTable::serialize() const {
+  auto obj = serializeBase("BigintValues");
+  obj["values"] = serializeBigintValues(values_);
+  return obj;
+}
+
+folly::dynamic BigintValuesUsingBitmask::serialize() const {
+  auto obj = serializeBase("BigintValues");
+  obj["values"] = serializeBigintValues(values());
+  return obj;
+}
+
+folly::dynamic BytesValues::serialize() const {
+  auto obj = serializeBase("BytesValues");
+  folly::dynamic values = folly::dynamic::array;
+  for (const auto& value : values_) {
+    values.push_back(encoding::Base64::encode(value));
+  }
+  obj["values"] = std::move(values);
+  return obj;
+}
+
+folly::dynamic BigintMultiRange::serialize() const {
+  auto obj = serializeBase("BigintMultiRange");
+  folly::dynamic ranges = folly::dynamic::array;
+  for (const auto& range : ranges_) {
+    ranges.push_back(range->serialize());
+  }
+  obj["ranges"] = std::move(ranges);
+  return obj;
+}
+
+folly::dynamic BloomFilterValues::serialize() const {
+  auto obj = serializeBase("BloomFilterValues");
+  std::string bits(bloomFilter_->serializedSize(), '\0');
+  bloomFilter_->serialize(bits.data());
+  obj["bloomFilter"] = encoding::Base64::encode(bits);
+  if (conjunct_) {
+    obj["conjunct"] = conjunct_->serialize();
+  }
+  return obj;
+}
+
+// static
+std::unique_ptr<Filter> Filter::create(const folly::dynamic& obj) {
+  const auto name = obj["name"].asString();
+  const bool nullAllowed = obj["nullAllowed"].asBool();
+  if (name == "AlwaysFalse") {
+    return std::make_unique<AlwaysFalse>();
+  }
+  if (name == "AlwaysTrue") {
+    return std::make_unique<AlwaysTrue>();
+  }
+  if (name == "IsNull") {
+    return std::make_unique<IsNull>();
+  }
+  if (name == "IsNotNull") {
+    return std::make_unique<IsNotNull>();
+  }
+  if (name == "BigintRange") {
+    return std::make_unique<BigintRange>(
+        obj["lower"].asInt(), obj["upper"].asInt(), nullAllowed);
+  }
+  if (name == "BigintValues") {
+    std::vector<int64_t> values;
+    values.reserve(obj["values"].size());
+    for (const auto& value : obj["values"]) {
+      values.push_back(value.asInt());
+    }
+    return createBigintValues(values, nullAllowed);
+  }
+  if (name == "BytesValues") {
+    std::vector<std::string> values;
+    values.reserve(obj["values"].size());
+    for (const auto& value : obj["values"]) {
+      values.push_back(encoding::Base64::decode(value.asString()));
+    }
+    return std::make_unique<BytesValues>(values, nullAllowed);
+  }
+  if (name == "BigintMultiRange") {
+    std::vector<std::unique_ptr<BigintRange>> ranges;
+    for (const auto& range : obj["ranges"]) {
+      ranges.push_back(std::make_unique<BigintRange>(
+          range["lower"].asInt(), range["upper"].asInt(), false));
+    }
+    return std::make_unique<BigintMultiRange>(std::move(ranges), nullAllowed);
+  }
+  if (name == "BloomFilterValues") {
+    const auto bits = encoding::Base64::decode(obj["bloomFilter"].asString());
+    auto bloomFilter = std::make_shared<BloomFilter<>>();
+    bloomFilter->merge(bits.data());
+    std::shared_ptr<const Filter> conjunct;
+    if (obj.count("conjunct")) {
+      conjunct = create(obj["conjunct"]);
+    }
+    return std::make_unique<BloomFilterValues>(
+        std::move(bloomFilter), nullAllowed, std::move(conjunct));
+  }
+  VELOX_UNSUPPORTED("Unsupported filter to deserialize: {}", name);
+}
+
 BigintValuesUsingBitmask::BigintValuesUsingBitmask(
     int64_t min,
     int64_t max,
@@ -2061,4 +2206,67 @@ std::unique_ptr<Filter> NegatedBytesValues::mergeWith(
       VELOX_UNREACHABLE();
   }
 }
+
+bool BloomFilterValues::testInt64Range(int64_t min, int64_t max, bool hasNull)
+    const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+  if (conjunct_ && !conjunct_->testInt64Range(min, max, false)) {
+    return false;
+  }
+  if (min == max) {
+    return bloomFilter_->mayContain(hashInt64(min));
+  }
+  return true;
+}
+
+bool BloomFilterValues::testBytesRange(
+    std::optional<std::string_view> min,
+    std::optional<std::string_view> max,
+    bool hasNull) const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+  if (conjunct_ && !conjunct_->testBytesRange(min, max, false)) {
+    return false;
+  }
+  if (min.has_value() && max.has_value() && min.value() == max.value()) {
+    return bloomFilter_->mayContain(
+        hashBytes(min.value().data(), min.value().size()));
+  }
+  return true;
+}
+
+std::unique_ptr<Filter> BloomFilterValues::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+      return this->clone();
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return this->clone(false);
+    default: {
+      // Keeps the Bloom filter of 'this' and folds 'other' into the exact
+      // conjunct. Two Bloom filters are not intersected. The one of 'other'
+      // becomes part of the conjunct.
+      const bool bothNullAllowed = nullAllowed_ && other->testNull();
+      std::shared_ptr<const Filter> conjunct;
+      if (!conjunct_) {
+        conjunct = other->clone();
+      } else if (other->kind() == FilterKind::kBloomFilter) {
+        conjunct = other->mergeWith(conjunct_.get());
+      } else {
+        conjunct = conjunct_->mergeWith(other);
+      }
+      if (conjunct->kind() == FilterKind::kAlwaysFalse) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BloomFilterValues>(
+          bloomFilter_, bothNullAllowed, std::move(conjunct));
+    }
+  }
+}
 } // namespace facebook::velox::common
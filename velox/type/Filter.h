@@ -24,7 +24,10 @@
 
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
+#include <folly/dynamic.h>
+#include <folly/hash/Hash.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -57,6 +60,7 @@ enum class FilterKind {
   kHugeintRange,
   kShortDecimalRange,
   kShortDecimalMultiRange,
+  kBloomFilter,
 };
 
 /**
@@ -237,7 +241,20 @@ class Filter {
 
   virtual std::string toString() const;
 
+  /// Returns the filter in a form that can be sent to another process and
+  /// restored with Filter::create(). Supported by the filter kinds that hash
+  /// joins produce as dynamic filters.
+  virtual folly::dynamic serialize() const {
+    VELOX_UNSUPPORTED("{}: serialize() is not supported.", toString());
+  }
+
+  /// Restores a filter from the output of serialize().
+  static std::unique_ptr<Filter> create(const folly::dynamic& obj);
+
  protected:
+  // Returns the fields common to all filters for serialize().
+  folly::dynamic serializeBase(std::string_view name) const;
+
   const bool nullAllowed_;
 
  private:
@@ -264,6 +281,8 @@ class AlwaysFalse final : public Filter {
  public:
   AlwaysFalse() : Filter(true, false, FilterKind::kAlwaysFalse) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     return std::make_unique<AlwaysFalse>();
@@ -320,6 +339,8 @@ class AlwaysTrue final : public Filter {
  public:
   AlwaysTrue() : Filter(true, true, FilterKind::kAlwaysTrue) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     return std::make_unique<AlwaysTrue>();
@@ -389,6 +410,8 @@ class IsNull final : public Filter {
  public:
   IsNull() : Filter(true, true, FilterKind::kIsNull) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     return std::make_unique<IsNull>();
@@ -447,6 +470,8 @@ class IsNotNull final : public Filter {
  public:
   IsNotNull() : Filter(true, false, FilterKind::kIsNotNull) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     return std::make_unique<IsNotNull>();
@@ -717,6 +742,8 @@ class BigintRange final : public Filter {
             std::min<int64_t>(upper_, std::numeric_limits<int16_t>::max())),
         isSingleValue_(upper_ == lower_) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     if (nullAllowed) {
@@ -946,6 +973,8 @@ class BigintValuesUsingHashTable final : public Filter {
         values_(other.values_),
         sizeMask_(other.sizeMask_) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     if (nullAllowed) {
@@ -1025,6 +1054,8 @@ class BigintValuesUsingBitmask final : public Filter {
         min_(other.min_),
         max_(other.max_) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     if (nullAllowed) {
@@ -1710,6 +1741,8 @@ class BytesValues final : public Filter {
         values_(other.values_),
         lengths_(other.lengths_) {}
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
     if (nullAllowed) {
@@ -1760,6 +1793,8 @@ class BigintMultiRange final : public Filter {
 
   BigintMultiRange(const BigintMultiRange& other, bool nullAllowed);
 
+  folly::dynamic serialize() const final;
+
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final;
 
@@ -1893,6 +1928,84 @@ class MultiRange final : public Filter {
   const bool nanAllowed_;
 };
 
+/// Approximate IN-list filter over integral or string values backed by a Bloom
+/// filter. Used for join keys with too many distinct values for an exact
+/// BigintValues or BytesValues filter. Passes all the values in the set and a
+/// small fraction of the values outside of it. May be combined with an exact
+/// 'conjunct' filter, e.g. a range over the same values, with AND semantics.
+class BloomFilterValues final : public Filter {
+ public:
+  /// @param bloomFilter Bloom filter over the hashes of the values that pass
+  /// the filter. The hashes must be computed with hashInt64() or hashBytes().
+  /// @param nullAllowed Null values are passing the filter if true.
+  /// @param conjunct Optional filter that must also pass.
+  BloomFilterValues(
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed,
+      std::shared_ptr<const Filter> conjunct = nullptr)
+      : Filter(true, nullAllowed, FilterKind::kBloomFilter),
+        bloomFilter_(std::move(bloomFilter)),
+        conjunct_(std::move(conjunct)) {
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+    VELOX_CHECK(bloomFilter_->isSet());
+  }
+
+  static uint64_t hashInt64(int64_t value) {
+    return folly::hasher<int64_t>()(value);
+  }
+
+  static uint64_t hashBytes(const char* value, int32_t length) {
+    return folly::hasher<folly::StringPiece>()(
+        folly::StringPiece(value, length));
+  }
+
+  folly::dynamic serialize() const final;
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<BloomFilterValues>(
+        bloomFilter_, nullAllowed.value_or(nullAllowed_), conjunct_);
+  }
+
+  bool testInt64(int64_t value) const final {
+    return bloomFilter_->mayContain(hashInt64(value)) &&
+        (!conjunct_ || conjunct_->testInt64(value));
+  }
+
+  bool testBytes(const char* value, int32_t length) const final {
+    return bloomFilter_->mayContain(hashBytes(value, length)) &&
+        (!conjunct_ || conjunct_->testBytes(value, length));
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  bool testBytesRange(
+      std::optional<std::string_view> min,
+      std::optional<std::string_view> max,
+      bool hasNull) const final;
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  const std::shared_ptr<const BloomFilter<>>& bloomFilter() const {
+    return bloomFilter_;
+  }
+
+  const std::shared_ptr<const Filter>& conjunct() const {
+    return conjunct_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BloomFilterValues: {}{}",
+        conjunct_ ? conjunct_->toString() + " " : "",
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+  const std::shared_ptr<const Filter> conjunct_;
+};
+
 // Helper for applying filters to different types
 template <typename TFilter, typename T>
 static inline bool applyFilter(TFilter& filter, T value) {
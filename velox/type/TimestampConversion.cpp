@@ -445,6 +445,20 @@ bool tryParseUTCOffsetString(
   return true;
 }
 
+// Parses the 'numDigits' digits at 'buf' into 'result'. Returns false if any
+// of them is not a digit.
+inline bool parseFixedDigits(const char* buf, int numDigits, int32_t& result) {
+  result = 0;
+  for (auto i = 0; i < numDigits; ++i) {
+    const uint8_t digit = buf[i] - '0';
+    if (digit > 9) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+  return true;
+}
+
 } // namespace
 
 bool isLeapYear(int32_t year) {
@@ -524,10 +538,77 @@ int64_t daysSinceEpochFromDayOfYear(int32_t year, int32_t dayOfYear) {
   return startOfYear + (dayOfYear - 1);
 }
 
+namespace {
+
+// Parses a date in exactly the form YYYY-MM-DD at the start of 'buf', which
+// must have at least 10 characters. This is the common form of dates in text
+// files, which is parsed here without the branches of tryParseDateString() for
+// signs, separators, variable numbers of digits and suffixes. Returns false if
+// 'buf' is not in this form or the date is not valid, for the caller to fall
+// back to tryParseDateString().
+bool tryParseCanonicalDate(const char* buf, int64_t& daysSinceEpoch) {
+  int32_t year;
+  int32_t month;
+  int32_t day;
+  if (buf[4] != '-' || buf[7] != '-' || !parseFixedDigits(buf, 4, year) ||
+      !parseFixedDigits(buf + 5, 2, month) ||
+      !parseFixedDigits(buf + 8, 2, day) || !isValidDate(year, month, day)) {
+    return false;
+  }
+  daysSinceEpoch = daysSinceEpochFromDate(year, month, day);
+  return true;
+}
+
+// Parses a timestamp in exactly the form YYYY-MM-DD HH:MM:SS[.f] with 1 to 6
+// fractional digits and 'T' or ' ' as the separator of the date and time.
+// Returns false for anything else, for the caller to fall back to the general
+// parser.
+bool tryParseCanonicalTimestamp(
+    const char* buf,
+    size_t len,
+    Timestamp& timestamp) {
+  static constexpr int32_t kMicrosMultipliers[] = {
+      0, 100'000, 10'000, 1'000, 100, 10, 1};
+  constexpr size_t kSecondsLength = 19;
+  if (len != kSecondsLength &&
+      (len < kSecondsLength + 2 || len > kSecondsLength + 7 ||
+       buf[kSecondsLength] != '.')) {
+    return false;
+  }
+  int64_t daysSinceEpoch;
+  int32_t hour;
+  int32_t minute;
+  int32_t second;
+  if ((buf[10] != ' ' && buf[10] != 'T') || buf[13] != ':' ||
+      buf[16] != ':' || !parseFixedDigits(buf + 11, 2, hour) || hour >= 24 ||
+      !parseFixedDigits(buf + 14, 2, minute) || minute >= 60 ||
+      !parseFixedDigits(buf + 17, 2, second) || second > 60 ||
+      !tryParseCanonicalDate(buf, daysSinceEpoch)) {
+    return false;
+  }
+  int32_t micros = 0;
+  if (len > kSecondsLength) {
+    const int numDigits = len - kSecondsLength - 1;
+    if (!parseFixedDigits(buf + kSecondsLength + 1, numDigits, micros)) {
+      return false;
+    }
+    micros *= kMicrosMultipliers[numDigits];
+  }
+  timestamp =
+      fromDatetime(daysSinceEpoch, fromTime(hour, minute, second, micros));
+  return true;
+}
+
+} // namespace
+
 int64_t fromDateString(const char* str, size_t len) {
   int64_t daysSinceEpoch;
   size_t pos = 0;
 
+  if (len == 10 && tryParseCanonicalDate(str, daysSinceEpoch)) {
+    return daysSinceEpoch;
+  }
+
   if (!tryParseDateString(str, len, pos, daysSinceEpoch, true)) {
     if (len == 19) {
       // Timestamp format: (YYYY-MM-DD HH:MM:SS).
@@ -623,6 +704,11 @@ Timestamp fromTimestampString(const char* str, size_t len) {
   int64_t daysSinceEpoch;
   int64_t microsSinceMidnight;
 
+  Timestamp canonical;
+  if (len >= 19 && tryParseCanonicalTimestamp(str, len, canonical)) {
+    return canonical;
+  }
+
   if (!tryParseDateString(str, len, pos, daysSinceEpoch, false)) {
     parserError(str, len);
   }
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/Conversions.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+namespace facebook::velox::util {
+namespace {
+
+// Checks that the fast parser accepts 'input' if 'expectFast' and that its
+// result then matches folly::to().
+template <typename T>
+void testFastCast(const std::string& input, bool expectFast) {
+  SCOPED_TRACE(input);
+  T result;
+  ASSERT_EQ(detail::tryCastFromStringFast<T>(input, result), expectFast);
+  if (expectFast) {
+    EXPECT_EQ(result, folly::to<T>(input));
+  }
+}
+
+TEST(ConversionsTest, integerFast) {
+  testFastCast<int64_t>("0", true);
+  testFastCast<int64_t>("-0", true);
+  testFastCast<int64_t>("7", true);
+  testFastCast<int64_t>("0012", true);
+  testFastCast<int64_t>("12345678", true);
+  testFastCast<int64_t>("-123456789", true);
+  testFastCast<int64_t>("999999999999999999", true);
+  testFastCast<int64_t>("-999999999999999999", true);
+  testFastCast<int32_t>("2147483647", true);
+  testFastCast<int32_t>("-2147483648", true);
+  testFastCast<int8_t>("-128", true);
+
+  // Out of range for the type or more than 18 digits.
+  testFastCast<int8_t>("128", false);
+  testFastCast<int32_t>("2147483648", false);
+  testFastCast<int64_t>("9223372036854775807", false);
+  // Forms that folly::to() handles or rejects by itself.
+  testFastCast<int64_t>("", false);
+  testFastCast<int64_t>("-", false);
+  testFastCast<int64_t>("+1", false);
+  testFastCast<int64_t>(" 1", false);
+  testFastCast<int64_t>("1 ", false);
+  testFastCast<int64_t>("1234567a", false);
+  testFastCast<int64_t>("12345678a", false);
+  testFastCast<int64_t>("1.5", false);
+  testFastCast<int64_t>("--1", false);
+}
+
+TEST(ConversionsTest, doubleFast) {
+  testFastCast<double>("0", true);
+  testFastCast<double>("-0", true);
+  testFastCast<double>("0.1", true);
+  testFastCast<double>("-0.0", true);
+  testFastCast<double>("3.14159", true);
+  testFastCast<double>("123456789.012345", true);
+  testFastCast<double>("0.000000000000001", true);
+  testFastCast<double>("100", true);
+
+  testFastCast<double>("1e5", false);
+  testFastCast<double>("1.", false);
+  testFastCast<double>(".5", false);
+  testFastCast<double>("01.5", false);
+  testFastCast<double>("1234567890.1234567", false);
+  testFastCast<double>("Infinity", false);
+  testFastCast<double>("NaN", false);
+  testFastCast<double>("1.5x", false);
+  testFastCast<double>(" 1.5", false);
+
+  // Not supported for other types.
+  testFastCast<float>("1.5", false);
+  testFastCast<bool>("1", false);
+
+  // Random values with up to 15 digits round the same as folly::to().
+  std::mt19937 rng(1);
+  for (auto i = 0; i < 10'000; ++i) {
+    const auto numDigits = 1 + rng() % 15;
+    const auto pointPosition = 1 + rng() % numDigits;
+    std::string input = std::to_string(1 + rng() % 9);
+    for (auto j = 1; j < numDigits; ++j) {
+      if (j == pointPosition) {
+        input += '.';
+      }
+      input += static_cast<char>('0' + rng() % 10);
+    }
+    testFastCast<double>(input, true);
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::util
@@ -139,6 +139,80 @@ TEST(DecimalTest, addUnsignedValues) {
   ASSERT_EQ(LOWER(sum), 0x11d0ffffff0bdc0);
 }
 
+TEST(DecimalTest, multiplyWithOverflow) {
+  int128_t result;
+  // 64 bit operands.
+  EXPECT_FALSE(DecimalUtil::multiplyWithOverflow(
+      std::numeric_limits<int64_t>::max(),
+      std::numeric_limits<int64_t>::min(),
+      result));
+  EXPECT_EQ(
+      result,
+      static_cast<int128_t>(std::numeric_limits<int64_t>::max()) *
+          std::numeric_limits<int64_t>::min());
+  EXPECT_FALSE(DecimalUtil::multiplyWithOverflow(-123, 456, result));
+  EXPECT_EQ(result, -56088);
+
+  // 128 bit operands.
+  const auto large = DecimalUtil::kPowersOfTen[30];
+  EXPECT_FALSE(DecimalUtil::multiplyWithOverflow(large, -1000, result));
+  EXPECT_EQ(result, -DecimalUtil::kPowersOfTen[33]);
+  EXPECT_TRUE(DecimalUtil::multiplyWithOverflow(large, large, result));
+
+  EXPECT_FALSE(DecimalUtil::rescaleWithOverflow(-7, 0, result));
+  EXPECT_EQ(result, -7);
+  EXPECT_FALSE(DecimalUtil::rescaleWithOverflow(7, 37, result));
+  EXPECT_EQ(result, 7 * DecimalUtil::kPowersOfTen[37]);
+  EXPECT_TRUE(DecimalUtil::rescaleWithOverflow(large, 10, result));
+}
+
+TEST(DecimalTest, divideUnscaledWithRoundUp) {
+  int128_t result;
+  // 64 bit division.
+  EXPECT_EQ(
+      DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+          result, 15, 10, false, 0),
+      5);
+  EXPECT_EQ(result, 2);
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+      result, -15, 10, false, 0);
+  EXPECT_EQ(result, -2);
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+      result, -14, -10, false, 0);
+  EXPECT_EQ(result, 1);
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+      result, 15, 10, true, 0);
+  EXPECT_EQ(result, 1);
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+      result, 1, 3, false, 2);
+  EXPECT_EQ(result, 33);
+
+  // 128 bit division.
+  const auto max = UnscaledLongDecimal::max().unscaledValue();
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledLongDecimal>(
+      result, max, -2, false, 0);
+  EXPECT_EQ(result, -(max / 2 + 1));
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledLongDecimal>(
+      result, max, max, false, 0);
+  EXPECT_EQ(result, 1);
+  DecimalUtil::divideUnscaledWithRoundUp<UnscaledLongDecimal>(
+      result, 10, DecimalUtil::kPowersOfTen[20], false, 19);
+  EXPECT_EQ(result, 1);
+
+  VELOX_ASSERT_THROW(
+      DecimalUtil::divideUnscaledWithRoundUp<UnscaledLongDecimal>(
+          result, 1, 0, false, 0),
+      "Division by zero");
+  VELOX_ASSERT_THROW(
+      DecimalUtil::divideUnscaledWithRoundUp<UnscaledShortDecimal>(
+          result, -DecimalUtil::kPowersOfTen[17], 3, false, 1),
+      "Decimal overflow: 100000000000000000 * 10");
+  VELOX_ASSERT_THROW(
+      DecimalUtil::divideUnscaledWithRoundUp<UnscaledLongDecimal>(
+          result, max, 3, false, 1),
+      "Decimal overflow: 99999999999999999999999999999999999999 * 10");
+}
+
 TEST(DecimalTest, longDecimalSerDe) {
   char data[100];
   UnscaledLongDecimal::serialize(UnscaledLongDecimal::min(), data);
@@ -20,7 +20,9 @@
 #include <numeric>
 #include <optional>
 
+#include <folly/json.h>
 #include <velox/type/Filter.h>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/type/Filter.h"
 #include "velox/type/UnscaledLongDecimal.h"
@@ -1813,3 +1815,87 @@ TEST(FilterTest, HugeIntRange) {
   EXPECT_FALSE(filter->testInt128(max));
   EXPECT_FALSE(filter->testInt128Range(min, max, false));
 }
+
+TEST(FilterTest, bloomFilterValues) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(100);
+  for (auto i = 0; i < 100; ++i) {
+    bloomFilter->insert(BloomFilterValues::hashInt64(i * 10));
+    auto value = fmt::format("value{}", i * 10);
+    bloomFilter->insert(
+        BloomFilterValues::hashBytes(value.data(), value.size()));
+  }
+
+  BloomFilterValues filter(bloomFilter, false);
+  EXPECT_EQ(FilterKind::kBloomFilter, filter.kind());
+  EXPECT_FALSE(filter.testNull());
+  int32_t numPassed = 0;
+  for (auto i = 0; i < 1'000; ++i) {
+    auto value = fmt::format("value{}", i);
+    if (i % 10 == 0) {
+      EXPECT_TRUE(filter.testInt64(i));
+      EXPECT_TRUE(filter.testBytes(value.data(), value.size()));
+    } else {
+      numPassed += filter.testInt64(i);
+    }
+  }
+  // Few false positives.
+  EXPECT_LT(numPassed, 100);
+
+  EXPECT_TRUE(filter.testInt64Range(5, 15, false));
+  EXPECT_TRUE(filter.testInt64Range(20, 20, false));
+  EXPECT_TRUE(filter.testBytesRange("value1", "value2", false));
+  EXPECT_TRUE(filter.testBytesRange("value20", "value20", false));
+  EXPECT_TRUE(filter.clone(true)->testNull());
+
+  // Merging keeps the Bloom filter and the other filter as a conjunct.
+  auto range = between(0, 500);
+  auto merged = filter.mergeWith(range.get());
+  ASSERT_EQ(FilterKind::kBloomFilter, merged->kind());
+  EXPECT_TRUE(merged->testInt64(100));
+  EXPECT_FALSE(merged->testInt64(600));
+  EXPECT_FALSE(merged->testInt64Range(600, 700, false));
+  EXPECT_TRUE(merged->testInt64Range(400, 700, false));
+
+  auto isNull = std::make_unique<IsNull>();
+  EXPECT_EQ(FilterKind::kAlwaysFalse, filter.mergeWith(isNull.get())->kind());
+  auto alwaysTrue = std::make_unique<AlwaysTrue>();
+  EXPECT_EQ(
+      FilterKind::kBloomFilter, filter.mergeWith(alwaysTrue.get())->kind());
+}
+
+TEST(FilterTest, serialize) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(10);
+  bloomFilter->insert(BloomFilterValues::hashInt64(7));
+
+  std::vector<std::unique_ptr<Filter>> filters;
+  filters.push_back(std::make_unique<AlwaysFalse>());
+  filters.push_back(std::make_unique<AlwaysTrue>());
+  filters.push_back(std::make_unique<IsNull>());
+  filters.push_back(std::make_unique<IsNotNull>());
+  filters.push_back(between(-5, 100, true));
+  filters.push_back(in({1, 5, 1'000'000}, false));
+  filters.push_back(in({1, 2, 3, 5}, true));
+  filters.push_back(in({"a", "bc", std::string("\0x", 2)}, false));
+  filters.push_back(bigintOr(lessThan(-10), greaterThan(10)));
+  filters.push_back(std::make_unique<BloomFilterValues>(
+      bloomFilter, true, std::make_shared<BigintRange>(0, 10, false)));
+
+  for (const auto& filter : filters) {
+    SCOPED_TRACE(filter->toString());
+    auto obj = filter->serialize();
+    // The serialized form survives a round trip through JSON.
+    auto copy = Filter::create(folly::parseJson(folly::toJson(obj)));
+    EXPECT_EQ(copy->kind(), filter->kind());
+    EXPECT_EQ(copy->testNull(), filter->testNull());
+    EXPECT_EQ(copy->toString(), filter->toString());
+  }
+
+  auto copy = Filter::create(filters.back()->serialize());
+  EXPECT_TRUE(copy->testInt64(7));
+  EXPECT_FALSE(copy->testInt64(20));
+
+  auto multiRange = orFilter(lessThanDouble(1.0), greaterThanDouble(2.0));
+  VELOX_ASSERT_THROW(multiRange->serialize(), "serialize() is not supported");
+}
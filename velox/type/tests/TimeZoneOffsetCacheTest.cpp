@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/tz/TimeZoneOffsetCache.h"
+
+#include <gtest/gtest.h>
+
+#include <folly/Random.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+
+namespace facebook::velox::util {
+namespace {
+
+// Converts 'seconds' with 'cache' and with Timestamp and checks that both
+// agree.
+void testConversions(TimeZoneOffsetCache& cache, int64_t seconds) {
+  const auto* zone = cache.zone();
+  Timestamp local(seconds, 123);
+  cache.toTimezone(local);
+  Timestamp expectedLocal(seconds, 123);
+  expectedLocal.toTimezone(*zone);
+  ASSERT_EQ(local, expectedLocal) << zone->name() << " " << seconds;
+
+  // 'seconds' is also taken as a local time to cover the ones that are
+  // skipped or repeated at transitions.
+  Timestamp utc(seconds, 456);
+  cache.toGMT(utc);
+  Timestamp expectedUtc(seconds, 456);
+  expectedUtc.toGMT(*zone);
+  ASSERT_EQ(utc, expectedUtc) << zone->name() << " " << seconds;
+}
+
+TEST(TimeZoneOffsetCacheTest, sorted) {
+  // 2020 and 2021 in steps of 15 minutes, across the transitions of each zone.
+  constexpr int64_t kBegin = 1'577'836'800;
+  constexpr int64_t kEnd = kBegin + 2 * 366 * 86'400;
+  for (const auto* name :
+       {"America/Los_Angeles",
+        "Europe/London",
+        "Australia/Lord_Howe",
+        "Asia/Kolkata",
+        "UTC"}) {
+    TimeZoneOffsetCache cache(date::locate_zone(name));
+    for (auto seconds = kBegin; seconds < kEnd; seconds += 900) {
+      testConversions(cache, seconds);
+    }
+  }
+}
+
+TEST(TimeZoneOffsetCacheTest, transitions) {
+  TimeZoneOffsetCache cache(date::locate_zone("America/Los_Angeles"));
+  // Every second around the start and the end of daylight saving time in
+  // 2021, after clustered lookups on either side.
+  for (int64_t transition : {1'615'716'000, 1'636'275'600}) {
+    for (auto seconds = transition - 2 * 3'600;
+         seconds < transition + 2 * 3'600;
+         ++seconds) {
+      testConversions(cache, seconds);
+    }
+  }
+
+  // A repeated local time maps to the later UTC time and a skipped one to
+  // the transition.
+  Timestamp repeated(1'636'246'800 + 1'800, 0);
+  cache.toGMT(repeated);
+  EXPECT_EQ(repeated.getSeconds(), 1'636'277'400);
+  Timestamp skipped(1'615'687'200 + 1'800, 0);
+  cache.toGMT(skipped);
+  EXPECT_EQ(skipped.getSeconds(), 1'615'716'000);
+}
+
+TEST(TimeZoneOffsetCacheTest, random) {
+  auto seed = folly::Random::rand32();
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  std::mt19937 rng(seed);
+  TimeZoneOffsetCache cache(date::locate_zone("Europe/Moscow"));
+  for (auto i = 0; i < 10'000; ++i) {
+    // Years 1900 to 2100.
+    const auto seconds = static_cast<int64_t>(
+        folly::Random::rand64(200ULL * 365 * 86'400, rng)) -
+        2'208'988'800;
+    testConversions(cache, seconds);
+  }
+}
+
+TEST(TimeZoneOffsetCacheTest, outOfBound) {
+  TimeZoneOffsetCache cache(date::locate_zone("America/Los_Angeles"));
+  Timestamp timestamp(0, 0);
+  cache.toGMT(timestamp);
+  timestamp = Timestamp(-1096193779200L, 0);
+  VELOX_ASSERT_THROW(
+      cache.toGMT(timestamp),
+      "Timestamp out of bound for time zone adjustment");
+}
+
+} // namespace
+} // namespace facebook::velox::util
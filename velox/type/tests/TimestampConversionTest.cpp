@@ -90,6 +90,10 @@ TEST(DateTimeUtilTest, fromDateString) {
 
   // Other string types.
   EXPECT_EQ(0, fromDateString(StringView("1970-01-01")));
+
+  EXPECT_EQ(11016, fromDateString("2000-02-29"));
+  EXPECT_EQ(-1, fromDateString("1969-12-31"));
+  EXPECT_EQ(-719528, fromDateString("0000-01-01"));
 }
 
 TEST(DateTimeUtilTest, fromDateStrInvalid) {
@@ -99,6 +103,9 @@ TEST(DateTimeUtilTest, fromDateStrInvalid) {
 
   // Different separators.
   EXPECT_THROW(fromDateString("2000/01-01"), VeloxUserError);
+  EXPECT_THROW(fromDateString("2001-02-29"), VeloxUserError);
+  EXPECT_THROW(fromDateString("2000-13-01"), VeloxUserError);
+  EXPECT_THROW(fromDateString("2000-1a-01"), VeloxUserError);
   EXPECT_THROW(fromDateString("2000 01-01"), VeloxUserError);
 
   // Trailing characters.
@@ -174,6 +181,29 @@ TEST(DateTimeUtilTest, fromTimestampString) {
       fromTimestampString("2020-04-23 04:23:37+09:00"));
 }
 
+TEST(DateTimeUtilTest, fromTimestampStringFractions) {
+  EXPECT_EQ(
+      Timestamp(946729316, 500'000'000),
+      fromTimestampString("2000-01-01 12:21:56.5"));
+  EXPECT_EQ(
+      Timestamp(946729316, 123'456'000),
+      fromTimestampString("2000-01-01T12:21:56.123456"));
+  // Digits past microseconds are ignored.
+  EXPECT_EQ(
+      Timestamp(946729316, 123'456'000),
+      fromTimestampString("2000-01-01 12:21:56.1234567"));
+  EXPECT_EQ(
+      Timestamp(946729316, 100'000'000),
+      fromTimestampString("2000-01-01 12:21:56.1 "));
+  EXPECT_EQ(
+      Timestamp(946684860, 0), fromTimestampString("2000-01-01 00:00:60"));
+
+  EXPECT_THROW(fromTimestampString("2000-01-01 24:00:00"), VeloxUserError);
+  EXPECT_THROW(fromTimestampString("2000-01-01 12:60:00"), VeloxUserError);
+  EXPECT_THROW(fromTimestampString("2000-02-30 12:00:00"), VeloxUserError);
+  EXPECT_THROW(fromTimestampString("2000-01-01 12:00:0x"), VeloxUserError);
+}
+
 TEST(DateTimeUtilTest, fromTimestampStrInvalid) {
   // Needs at least a date.
   EXPECT_THROW(fromTimestampString(""), VeloxUserError);
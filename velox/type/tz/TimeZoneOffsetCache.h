@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/external/date/tz.h"
+#include "velox/type/Timestamp.h"
+
+namespace facebook::velox::util {
+
+/// Converts timestamps between UTC and the local time of a time zone like
+/// Timestamp::toTimezone() and Timestamp::toGMT(), remembering the interval
+/// of UTC time over which the offset of the last conversion holds. The offset
+/// of a zone changes a few times a year at most, so for timestamps that are
+/// sorted or clustered in time most conversions add or subtract the cached
+/// offset instead of searching the transitions of the zone.
+///
+/// Not thread safe. Each function instance keeps its own cache.
+class TimeZoneOffsetCache {
+ public:
+  explicit TimeZoneOffsetCache(const date::time_zone* zone = nullptr)
+      : zone_(zone) {}
+
+  /// The zone or nullptr if none.
+  const date::time_zone* zone() const {
+    return zone_;
+  }
+
+  /// Returns the offset of the local time of the zone from UTC at
+  /// 'utcSeconds'.
+  int64_t offsetSeconds(int64_t utcSeconds) {
+    if (utcSeconds < begin_ || utcSeconds >= end_) {
+      refresh(utcSeconds);
+    }
+    return offset_;
+  }
+
+  /// Same as timestamp.toTimezone(*zone()).
+  void toTimezone(Timestamp& timestamp) {
+    const auto seconds = timestamp.getSeconds();
+    timestamp =
+        Timestamp(seconds + offsetSeconds(seconds), timestamp.getNanos());
+  }
+
+  /// Same as timestamp.toGMT(*zone()).
+  void toGMT(Timestamp& timestamp) {
+    const auto localSeconds = timestamp.getSeconds();
+    // The local time has a single UTC time if the UTC time it gets with the
+    // cached offset is further from the ends of the cached interval than any
+    // offset change. Near a transition the local time may be ambiguous or
+    // skipped, which Timestamp::toGMT() resolves.
+    if (localSeconds > kMinLocalSeconds) {
+      const auto utcSeconds = localSeconds - offset_;
+      if (utcSeconds >= begin_ + kMaxOffsetChange &&
+          utcSeconds < end_ - kMaxOffsetChange) {
+        timestamp = Timestamp(utcSeconds, timestamp.getNanos());
+        return;
+      }
+    }
+    timestamp.toGMT(*zone_);
+    refresh(timestamp.getSeconds());
+  }
+
+ private:
+  // More than the difference between any two offsets of a zone.
+  static constexpr int64_t kMaxOffsetChange = 2 * 86'400;
+
+  // Local times up to this are out of bounds for Timestamp::toGMT().
+  static constexpr int64_t kMinLocalSeconds = -1096193779200L + 86'400;
+
+  // The ends of the cached interval are clamped so that the bounds in
+  // toGMT() do not overflow for the first and last intervals of a zone.
+  static constexpr int64_t kMaxIntervalEnd = int64_t{1} << 62;
+
+  void refresh(int64_t utcSeconds) {
+    const auto info = zone_->get_info(
+        date::sys_seconds{std::chrono::seconds(utcSeconds)});
+    begin_ = std::max<int64_t>(
+        info.begin.time_since_epoch().count(), -kMaxIntervalEnd);
+    end_ = std::min<int64_t>(
+        info.end.time_since_epoch().count(), kMaxIntervalEnd);
+    offset_ = info.offset.count();
+  }
+
+  const date::time_zone* zone_;
+
+  // The interval [begin_, end_) of UTC seconds over which offset_ is the
+  // offset of the zone. Empty until the first conversion.
+  int64_t begin_{1};
+  int64_t end_{0};
+  int64_t offset_{0};
+};
+
+} // namespace facebook::velox::util
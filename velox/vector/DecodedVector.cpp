@@ -16,6 +16,7 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/vector/BaseVector.h"
 #include "velox/vector/BiasVector.h"
 #include "velox/vector/LazyVector.h"
@@ -33,6 +34,24 @@ std::vector<vector_size_t> makeConsecutiveIndices(size_t size) {
   }
   return consecutiveIndices;
 }
+
+// Sets 'result[row]' to 'indices[wrappedIndices[row]]' for the rows in
+// [begin, end). 'result' may be the same as 'wrappedIndices'.
+void combineIndices(
+    const vector_size_t* indices,
+    const vector_size_t* wrappedIndices,
+    vector_size_t begin,
+    vector_size_t end,
+    vector_size_t* result) {
+  constexpr int32_t kBatchSize = xsimd::batch<int32_t>::size;
+  auto row = begin;
+  for (; row + kBatchSize <= end; row += kBatchSize) {
+    simd::gather(indices, wrappedIndices + row).store_unaligned(result + row);
+  }
+  for (; row < end; ++row) {
+    result[row] = indices[wrappedIndices[row]];
+  }
+}
 } // namespace
 
 const std::vector<vector_size_t>& DecodedVector::consecutiveIndices() {
@@ -230,6 +249,21 @@ void DecodedVector::applyDictionaryWrapper(
     indices_ = copiedIndices_.data();
   }
 
+  if (!nulls_ && !newNulls) {
+    // Without nulls, ranges of consecutive rows gather a batch of indices at
+    // a time.
+    auto* combinedIndices = copiedIndices_.data();
+    auto combine = [&](vector_size_t begin, vector_size_t end) {
+      combineIndices(newIndices, currentIndices, begin, end, combinedIndices);
+    };
+    if (rows) {
+      rows->applyToSelectedRanges(combine);
+    } else {
+      combine(0, size_);
+    }
+    return;
+  }
+
   applyToRows(rows, [&](vector_size_t row) {
     if (!nulls_ || !bits::isBitNull(nulls_, row)) {
       auto wrappedIndex = currentIndices[row];
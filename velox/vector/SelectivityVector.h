@@ -331,6 +331,13 @@ class SelectivityVector {
   template <typename Callable>
   void applyToSelected(Callable func) const;
 
+  /// Invokes a function on each range of consecutive selected rows in order.
+  /// The function must take "begin" and "end" arguments of type vector_size_t
+  /// and return void. Use this instead of applyToSelected for loops that
+  /// vectorize over a range of rows.
+  template <typename Callable>
+  void applyToSelectedRanges(Callable func) const;
+
   /// Invokes a function on each selected row sequentially in order starting
   /// from the lowest row number until a function returns 'false' or all
   /// selected rows have been processed. The function must take a single "row"
@@ -433,6 +440,17 @@ inline void SelectivityVector::applyToSelected(Callable func) const {
   }
 }
 
+template <typename Callable>
+inline void SelectivityVector::applyToSelectedRanges(Callable func) const {
+  if (isAllSelected()) {
+    if (begin_ < end_) {
+      func(begin_, end_);
+    }
+  } else {
+    bits::forEachSetRange(bits_.data(), begin_, end_, func);
+  }
+}
+
 template <typename Callable>
 inline bool SelectivityVector::testSelected(Callable func) const {
   if (isAllSelected()) {
@@ -175,6 +175,31 @@ vector_size_t SequenceVector<T>::offsetOfIndex(vector_size_t index) const {
   return lastRangeIndex_;
 }
 
+template <typename T>
+VectorPtr SequenceVector<T>::slice(vector_size_t offset, vector_size_t length)
+    const {
+  VELOX_CHECK_LE(offset + length, BaseVector::length_);
+  if (length == 0) {
+    return BaseVector::create(BaseVector::type(), 0, BaseVector::pool_);
+  }
+  const auto firstRun = offsetOfIndex(offset);
+  const auto lastRun = offsetOfIndex(offset + length - 1);
+  const auto numRuns = lastRun - firstRun + 1;
+  auto lengths =
+      AlignedBuffer::allocate<vector_size_t>(numRuns, BaseVector::pool_);
+  auto* rawLengths = lengths->template asMutable<vector_size_t>();
+  std::copy(lengths_ + firstRun, lengths_ + lastRun + 1, rawLengths);
+  // The first and last runs may be cut. 'lastIndexRangeEnd_' is the end of
+  // 'lastRun'.
+  rawLengths[numRuns - 1] -= lastIndexRangeEnd_ - (offset + length);
+  offsetOfIndex(offset);
+  rawLengths[0] -= offset - lastIndexRangeStart_;
+  return BaseVector::wrapInSequence(
+      std::move(lengths),
+      length,
+      sequenceValues_->slice(firstRun, numRuns));
+}
+
 static inline vector_size_t offsetOfIndex(
     const vector_size_t* lengths,
     vector_size_t index,
@@ -21,5 +21,20 @@ namespace velox {
 
 template class SequenceVector<int32_t>;
 
+bool setRunStarts(const BaseVector& vector, uint64_t* runStarts) {
+  if (vector.encoding() != VectorEncoding::Simple::SEQUENCE) {
+    return false;
+  }
+  const auto& lengths = vector.wrapInfo();
+  const auto* rawLengths = lengths->as<vector_size_t>();
+  const auto numRuns = lengths->size() / sizeof(vector_size_t);
+  vector_size_t start = 0;
+  for (auto i = 0; i < numRuns && start < vector.size(); ++i) {
+    bits::setBit(runStarts, start);
+    start += rawLengths[i];
+  }
+  return true;
+}
+
 } // namespace velox
 } // namespace facebook
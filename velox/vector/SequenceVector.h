@@ -169,9 +169,7 @@ class SequenceVector : public SimpleVector<T> {
     return out.str();
   }
 
-  VectorPtr slice(vector_size_t, vector_size_t) const override {
-    VELOX_NYI();
-  }
+  VectorPtr slice(vector_size_t offset, vector_size_t length) const override;
 
   bool isNullsWritable() const override {
     return false;
@@ -200,6 +198,13 @@ class SequenceVector : public SimpleVector<T> {
 template <typename T>
 using SequenceVectorPtr = std::shared_ptr<SequenceVector<T>>;
 
+/// Sets the bit in 'runStarts' for the first row of each run of 'vector' and
+/// returns true if 'vector' is a SequenceVector. Returns false otherwise.
+/// Setting the run starts of several vectors in the same bits gives the rows
+/// where any of these changes value, so that an operator can process the rows
+/// of each run together.
+bool setRunStarts(const BaseVector& vector, uint64_t* runStarts);
+
 } // namespace facebook::velox
 
 #include "velox/vector/SequenceVector-inl.h"
@@ -42,6 +42,22 @@ bool isRegisteredVectorSerde() {
   return getVectorSerdeImpl() != nullptr;
 }
 
+std::optional<folly::io::CodecType> compressionCodecFromName(
+    const std::string& name) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kCodecs{
+      {"none", folly::io::CodecType::NO_COMPRESSION},
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+      {"snappy", folly::io::CodecType::SNAPPY},
+      {"zlib", folly::io::CodecType::ZLIB},
+  };
+  auto it = kCodecs.find(name);
+  if (it == kCodecs.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 void VectorStreamGroup::createStreamTree(
     RowTypePtr type,
     int32_t numRows,
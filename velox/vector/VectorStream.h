@@ -15,7 +15,10 @@
  */
 #pragma once
 
+#include <folly/compression/Compression.h>
+
 #include "velox/buffer/Buffer.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryAllocator.h"
@@ -54,6 +57,11 @@ class VectorSerializer {
 
   // Writes the contents to 'stream' in wire format
   virtual void flush(OutputStream* stream) = 0;
+
+  // Returns the stats of the serializer, e.g. of compression, so far.
+  virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return {};
+  }
 };
 
 class VectorSerde {
@@ -62,7 +70,23 @@ class VectorSerde {
   // Lets the caller pass options to the Serde. This can be extended to add
   // custom options by each of its extended classes.
   struct Options {
+    Options() = default;
+
+    explicit Options(folly::io::CodecType _compressionKind)
+        : compressionKind(_compressionKind) {}
+
     virtual ~Options() {}
+
+    // Codec for compressing the serialized data. Serdes that support
+    // compression mark the compressed data, so that the deserializing side
+    // needs the same codec but reads uncompressed data with any codec.
+    folly::io::CodecType compressionKind{
+        folly::io::CodecType::NO_COMPRESSION};
+
+    // If true, serdes whose format has dictionary and run length encodings
+    // keep the dictionary and constant encodings of top level columns
+    // instead of writing one value per row.
+    bool preserveEncodings{false};
   };
 
   virtual void estimateSerializedSize(
@@ -88,6 +112,11 @@ void registerVectorSerde(std::unique_ptr<VectorSerde> serdeToRegister);
 
 bool isRegisteredVectorSerde();
 
+// Returns the codec for a compression name, i.e. one of "none", "lz4",
+// "zstd", "snappy" or "zlib", or std::nullopt for other names.
+std::optional<folly::io::CodecType> compressionCodecFromName(
+    const std::string& name);
+
 VectorSerde* getVectorSerde();
 
 class VectorStreamGroup : public StreamArena {
@@ -112,6 +141,11 @@ class VectorStreamGroup : public StreamArena {
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
+  // Returns the stats of the serializer.
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return serializer_->runtimeStats();
+  }
+
   // Reads data in wire format. Returns the RowVector in 'result'.
   static void read(
       ByteStream* source,
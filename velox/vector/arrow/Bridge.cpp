@@ -24,6 +24,8 @@
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Abi.h"
 
+#include <cerrno>
+
 namespace facebook::velox {
 
 namespace {
@@ -645,6 +647,143 @@ void exportBase(
   out.release = releaseArrowArray;
 }
 
+// Returns true if 'vector' and all its children are flat, so that its
+// ArrowSchema depends only on its type.
+bool isFlatRecursive(const BaseVector& vector) {
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return true;
+    case VectorEncoding::Simple::ROW:
+      for (const auto& child : vector.asUnchecked<RowVector>()->children()) {
+        if (!isFlatRecursive(*child)) {
+          return false;
+        }
+      }
+      return true;
+    case VectorEncoding::Simple::ARRAY:
+      return isFlatRecursive(*vector.asUnchecked<ArrayVector>()->elements());
+    case VectorEncoding::Simple::MAP: {
+      auto* map = vector.asUnchecked<MapVector>();
+      return isFlatRecursive(*map->mapKeys()) &&
+          isFlatRecursive(*map->mapValues());
+    }
+    default:
+      return false;
+  }
+}
+
+// Returns 'input' with the columns that are not flat copied to flat vectors.
+// The flat columns are shared.
+RowVectorPtr flattenColumns(
+    const RowVectorPtr& input,
+    memory::MemoryPool* pool) {
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  bool changed = false;
+  for (const auto& child : input->children()) {
+    auto loaded = BaseVector::loadedVectorShared(child);
+    if (isFlatRecursive(*loaded)) {
+      children.push_back(std::move(loaded));
+      continue;
+    }
+    auto flat = BaseVector::create(loaded->type(), loaded->size(), pool);
+    flat->copy(loaded.get(), 0, 0, loaded->size());
+    children.push_back(std::move(flat));
+    changed = true;
+  }
+  if (!changed) {
+    return input;
+  }
+  return std::make_shared<RowVector>(
+      pool,
+      input->type(),
+      input->nulls(),
+      input->size(),
+      std::move(children));
+}
+
+// Carried by ArrowArrayStream.private_data of exportToArrowStream().
+class VeloxToArrowStreamBridgeHolder {
+ public:
+  VeloxToArrowStreamBridgeHolder(
+      RowTypePtr type,
+      std::function<RowVectorPtr()> next,
+      memory::MemoryPool* pool)
+      : type_(std::move(type)), next_(std::move(next)), pool_(pool) {}
+
+  static VeloxToArrowStreamBridgeHolder* from(ArrowArrayStream* stream) {
+    return static_cast<VeloxToArrowStreamBridgeHolder*>(stream->private_data);
+  }
+
+  int getSchema(ArrowSchema* out) {
+    return run([&]() {
+      exportToArrow(BaseVector::create(type_, 0, pool_), *out);
+    });
+  }
+
+  int getNext(ArrowArray* out) {
+    return run([&]() {
+      auto batch = next_();
+      if (batch == nullptr) {
+        // Marks the end of the stream.
+        out->release = nullptr;
+        return;
+      }
+      VELOX_CHECK(
+          batch->type()->equivalent(*type_),
+          "Batch of type {} does not match the Arrow stream type {}",
+          batch->type()->toString(),
+          type_->toString());
+      exportToArrow(flattenColumns(batch, pool_), *out, pool_);
+    });
+  }
+
+  const char* lastError() const {
+    return lastError_.empty() ? nullptr : lastError_.c_str();
+  }
+
+ private:
+  // Runs 'func' and returns 0 or, if 'func' throws, an errno code after
+  // recording the error message.
+  template <typename Func>
+  int run(Func func) {
+    lastError_.clear();
+    try {
+      func();
+      return 0;
+    } catch (const std::exception& e) {
+      lastError_ = e.what();
+      return EIO;
+    }
+  }
+
+  const RowTypePtr type_;
+  const std::function<RowVectorPtr()> next_;
+  memory::MemoryPool* const pool_;
+  std::string lastError_;
+};
+
+int streamGetSchema(ArrowArrayStream* stream, ArrowSchema* out) {
+  return VeloxToArrowStreamBridgeHolder::from(stream)->getSchema(out);
+}
+
+int streamGetNext(ArrowArrayStream* stream, ArrowArray* out) {
+  return VeloxToArrowStreamBridgeHolder::from(stream)->getNext(out);
+}
+
+const char* streamGetLastError(ArrowArrayStream* stream) {
+  return VeloxToArrowStreamBridgeHolder::from(stream)->lastError();
+}
+
+void releaseArrowStream(ArrowArrayStream* stream) {
+  if (stream->release == nullptr) {
+    return;
+  }
+  delete VeloxToArrowStreamBridgeHolder::from(stream);
+  stream->private_data = nullptr;
+  stream->release = nullptr;
+}
+
 } // namespace
 
 void exportToArrow(
@@ -757,6 +896,19 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
   arrowSchema.private_data = bridgeHolder.release();
 }
 
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    memory::MemoryPool* pool,
+    ArrowArrayStream& arrowStream) {
+  arrowStream.get_schema = streamGetSchema;
+  arrowStream.get_next = streamGetNext;
+  arrowStream.get_last_error = streamGetLastError;
+  arrowStream.release = releaseArrowStream;
+  arrowStream.private_data =
+      new VeloxToArrowStreamBridgeHolder(type, std::move(next), pool);
+}
+
 TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
   const char* format = arrowSchema.format;
   VELOX_CHECK_NOT_NULL(format);
@@ -945,6 +1097,37 @@ VectorPtr createFlatVector(
 using WrapInBufferViewFunc =
     std::function<BufferPtr(const void* buffer, size_t length)>;
 
+// Returns 'length' bits of 'buffer' starting at bit 'offset', e.g. the nulls
+// of an Arrow array that is a slice of a larger one. Wraps 'buffer' if
+// 'offset' is at a byte boundary and copies the bits otherwise.
+BufferPtr importBits(
+    const void* buffer,
+    int64_t offset,
+    int64_t length,
+    memory::MemoryPool* pool,
+    const WrapInBufferViewFunc& wrapInBufferView) {
+  if (offset % 8 == 0) {
+    return wrapInBufferView(
+        static_cast<const uint8_t*>(buffer) + offset / 8,
+        bits::nbytes(length));
+  }
+  auto result = AlignedBuffer::allocate<bool>(length, pool);
+  bits::copyBits(
+      static_cast<const uint64_t*>(buffer),
+      offset,
+      result->asMutable<uint64_t>(),
+      0,
+      length);
+  return result;
+}
+
+// Returns the first value of 'arrowArray' in the buffer at 'index', which has
+// values of 'width' bytes.
+const void* valuesAt(const ArrowArray& arrowArray, int index, size_t width) {
+  return static_cast<const uint8_t*>(arrowArray.buffers[index]) +
+      arrowArray.offset * width;
+}
+
 template <typename TOffset>
 VectorPtr createStringFlatVector(
     memory::MemoryPool* pool,
@@ -996,7 +1179,8 @@ VectorPtr createDecimalVector(
     const ArrowArray& arrowArray,
     WrapInBufferViewFunc wrapInBufferView) {
   auto valueBuf = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * sizeof(int128_t));
+      valuesAt(arrowArray, 1, sizeof(int128_t)),
+      arrowArray.length * sizeof(int128_t));
 
   auto src = valueBuf->as<uint8_t>();
 
@@ -1025,7 +1209,8 @@ VectorPtr createTimestampVector(
     const ArrowArray& arrowArray,
     WrapInBufferViewFunc wrapInBufferView) {
   auto valueBuf = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * sizeof(Timestamp));
+      valuesAt(arrowArray, 1, sizeof(int64_t)),
+      arrowArray.length * sizeof(int64_t));
 
   auto src = valueBuf->as<uint8_t>();
 
@@ -1095,8 +1280,11 @@ ArrayVectorPtr createArrayVector(
   static_assert(sizeof(vector_size_t) == sizeof(int32_t));
   VELOX_CHECK_EQ(arrowArray.n_buffers, 2);
   VELOX_CHECK_EQ(arrowArray.n_children, 1);
+  // The offsets of a slice index the elements of the whole array, like the
+  // offsets of a Velox array.
   auto offsets = wrapInBufferView(
-      arrowArray.buffers[1], (arrowArray.length + 1) * sizeof(vector_size_t));
+      valuesAt(arrowArray, 1, sizeof(vector_size_t)),
+      (arrowArray.length + 1) * sizeof(vector_size_t));
   auto sizes =
       computeSizes(offsets->as<vector_size_t>(), arrowArray.length, pool);
   auto elements = importFromArrowImpl(
@@ -1123,7 +1311,8 @@ MapVectorPtr createMapVector(
   VELOX_CHECK_EQ(arrowArray.n_buffers, 2);
   VELOX_CHECK_EQ(arrowArray.n_children, 1);
   auto offsets = wrapInBufferView(
-      arrowArray.buffers[1], (arrowArray.length + 1) * sizeof(vector_size_t));
+      valuesAt(arrowArray, 1, sizeof(vector_size_t)),
+      (arrowArray.length + 1) * sizeof(vector_size_t));
   auto sizes =
       computeSizes(offsets->as<vector_size_t>(), arrowArray.length, pool);
   // Arrow wraps keys and values into a struct.
@@ -1160,7 +1349,8 @@ VectorPtr createDictionaryVector(
       TypeKind::INTEGER,
       "Only int32 indices are supported for arrow conversion");
   auto indices = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * sizeof(vector_size_t));
+      valuesAt(arrowArray, 1, sizeof(vector_size_t)),
+      arrowArray.length * sizeof(vector_size_t));
   auto type = importFromArrow(*arrowSchema.dictionary);
   auto wrapped = importFromArrowImpl(
       *arrowSchema.dictionary, *arrowArray.dictionary, pool, isViewer);
@@ -1179,16 +1369,19 @@ VectorPtr importFromArrowImpl(
     WrapInBufferViewFunc wrapInBufferView) {
   VELOX_USER_CHECK_NOT_NULL(arrowSchema.release, "arrowSchema was released.");
   VELOX_USER_CHECK_NOT_NULL(arrowArray.release, "arrowArray was released.");
-  VELOX_USER_CHECK_EQ(
-      arrowArray.offset,
-      0,
-      "Offsets are not supported during arrow conversion yet.");
   VELOX_CHECK_GE(
       arrowArray.length, 0, "Array length needs to be non-negative.");
+  VELOX_USER_CHECK_GE(
+      arrowArray.offset, 0, "Array offset needs to be non-negative.");
 
   // First parse and generate a Velox type.
   auto type = importFromArrow(arrowSchema);
 
+  // The children of a struct slice would need the offset too.
+  VELOX_USER_CHECK(
+      arrowArray.offset == 0 || !type->isRow(),
+      "Offsets of struct arrays are not supported yet.");
+
   // Wrap the nulls buffer into a Velox BufferView (zero-copy). Null buffer size
   // needs to be at least one bit per element.
   BufferPtr nulls = nullptr;
@@ -1202,8 +1395,12 @@ VectorPtr importFromArrowImpl(
     VELOX_USER_CHECK_NOT_NULL(
         arrowArray.buffers[0],
         "Nulls buffer can't be null unless null_count is zero.");
-    nulls = wrapInBufferView(
-        arrowArray.buffers[0], bits::nbytes(arrowArray.length));
+    nulls = importBits(
+        arrowArray.buffers[0],
+        arrowArray.offset,
+        arrowArray.length,
+        pool,
+        wrapInBufferView);
   }
 
   if (arrowSchema.dictionary) {
@@ -1217,12 +1414,24 @@ VectorPtr importFromArrowImpl(
         arrowArray.n_buffers,
         3,
         "Expecting three buffers as input for string types.");
+    // Large strings and binaries have 64 bit offsets.
+    if (arrowSchema.format[0] == 'U' || arrowSchema.format[0] == 'Z') {
+      return createStringFlatVector(
+          pool,
+          type,
+          nulls,
+          arrowArray.length,
+          static_cast<const int64_t*>(valuesAt(arrowArray, 1, sizeof(int64_t))),
+          static_cast<const char*>(arrowArray.buffers[2]), // values
+          arrowArray.null_count,
+          wrapInBufferView);
+    }
     return createStringFlatVector(
         pool,
         type,
         nulls,
         arrowArray.length,
-        static_cast<const int32_t*>(arrowArray.buffers[1]), // offsets
+        static_cast<const int32_t*>(valuesAt(arrowArray, 1, sizeof(int32_t))),
         static_cast<const char*>(arrowArray.buffers[2]), // values
         arrowArray.null_count,
         wrapInBufferView);
@@ -1263,8 +1472,19 @@ VectorPtr importFromArrowImpl(
   // Wrap the values buffer into a Velox BufferView - zero-copy.
   VELOX_USER_CHECK_EQ(
       arrowArray.n_buffers, 2, "Primitive types expect two buffers as input.");
-  auto values = wrapInBufferView(
-      arrowArray.buffers[1], arrowArray.length * type->cppSizeInBytes());
+  BufferPtr values;
+  if (type->isBoolean()) {
+    values = importBits(
+        arrowArray.buffers[1],
+        arrowArray.offset,
+        arrowArray.length,
+        pool,
+        wrapInBufferView);
+  } else {
+    values = wrapInBufferView(
+        valuesAt(arrowArray, 1, type->cppSizeInBytes()),
+        arrowArray.length * type->cppSizeInBytes());
+  }
 
   return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
       createFlatVector,
@@ -16,14 +16,18 @@
 
 #pragma once
 
+#include <functional>
+
 #include "velox/common/memory/Memory.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/ComplexVector.h"
 
 /// These 2 definitions should be included by user from either
 ///   1. <arrow/c/abi.h> or
 ///   2. "velox/vector/arrow/Abi.h"
 struct ArrowArray;
 struct ArrowSchema;
+struct ArrowArrayStream;
 
 namespace facebook::velox {
 
@@ -80,6 +84,36 @@ void exportToArrow(
 /// actual data (containing encoding) to create an ArrowSchema.
 void exportToArrow(const VectorPtr&, ArrowSchema&);
 
+/// Export a sequence of Velox RowVectors to an ArrowArrayStream, as defined by
+/// Arrow's C stream interface:
+///
+///   https://arrow.apache.org/docs/format/CStreamInterface.html
+///
+/// Each get_next() on the stream calls 'next' and exports the returned batch
+/// like the VectorPtr->ArrowArray export function, so flat fixed width
+/// columns and nulls are exported without copying. 'next' returns nullptr at
+/// the end of the stream. Since all batches of a stream have the schema of
+/// 'type', columns that are not flat, e.g. dictionaries and constants, are
+/// flattened first. Exceptions thrown by 'next' or by the export are returned
+/// as stream errors with their message in get_last_error().
+///
+/// 'pool' is used for the conversions that are not zero-copy and must outlive
+/// the stream and the exported arrays. The consumer calls release() on the
+/// stream when done with it.
+///
+/// Example usage:
+///
+///   ArrowArrayStream arrowStream;
+///   arrow::exportToArrowStream(rowType, nextBatch, pool, arrowStream);
+///
+///   (pass arrowStream to a consumer, e.g. pyarrow.RecordBatchReader)
+///
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    memory::MemoryPool* pool,
+    ArrowArrayStream& arrowStream);
+
 /// Import an ArrowSchema into a Velox Type object.
 ///
 /// This function does the exact opposite of the function above. TypePtr carries
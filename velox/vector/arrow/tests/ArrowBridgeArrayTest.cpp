@@ -665,6 +665,76 @@ TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
 }
 
+TEST_F(ArrowBridgeArrayExportTest, stream) {
+  auto flat = vectorMaker_.flatVector<int64_t>({1, 2, 3});
+  std::vector<RowVectorPtr> batches = {
+      vectorMaker_.rowVector(
+          {flat,
+           BaseVector::wrapInDictionary(
+               nullptr,
+               makeBuffer<vector_size_t>({2, 1, 0}),
+               3,
+               vectorMaker_.flatVector<StringView>({"a", "b", "c"}))}),
+      vectorMaker_.rowVector(
+          {vectorMaker_.flatVectorNullable<int64_t>({4, std::nullopt}),
+           BaseVector::createConstant(
+               VARCHAR(), variant("d"), 2, pool_.get())})};
+  auto type = asRowType(batches[0]->type());
+  size_t index = 0;
+  ArrowArrayStream stream;
+  exportToArrowStream(
+      type,
+      [&]() -> RowVectorPtr {
+        return index < batches.size() ? batches[index++] : nullptr;
+      },
+      pool_.get(),
+      stream);
+  ASSERT_OK_AND_ASSIGN(auto reader, arrow::ImportRecordBatchReader(&stream));
+  ASSERT_EQ(
+      *reader->schema(),
+      *arrow::schema(
+          {arrow::field("c0", arrow::int64()),
+           arrow::field("c1", arrow::utf8())}));
+
+  // The flat column is shared and the dictionary is flattened.
+  std::shared_ptr<arrow::RecordBatch> batch;
+  ASSERT_OK(reader->ReadNext(&batch));
+  ASSERT_OK(batch->ValidateFull());
+  auto& c0 = static_cast<const arrow::Int64Array&>(*batch->column(0));
+  EXPECT_EQ(c0.raw_values(), flat->rawValues());
+  EXPECT_EQ(c0.Value(2), 3);
+  auto& c1 = static_cast<const arrow::StringArray&>(*batch->column(1));
+  EXPECT_EQ(c1.GetString(0), "c");
+  EXPECT_EQ(c1.GetString(2), "a");
+
+  ASSERT_OK(reader->ReadNext(&batch));
+  ASSERT_OK(batch->ValidateFull());
+  EXPECT_EQ(batch->num_rows(), 2);
+  EXPECT_TRUE(batch->column(0)->IsNull(1));
+  EXPECT_EQ(
+      static_cast<const arrow::StringArray&>(*batch->column(1)).GetString(1),
+      "d");
+
+  ASSERT_OK(reader->ReadNext(&batch));
+  EXPECT_EQ(batch, nullptr);
+}
+
+TEST_F(ArrowBridgeArrayExportTest, streamError) {
+  ArrowArrayStream stream;
+  exportToArrowStream(
+      ROW({"c0"}, {BIGINT()}),
+      []() -> RowVectorPtr { VELOX_FAIL("Producer failed"); },
+      pool_.get(),
+      stream);
+  ArrowArray array;
+  EXPECT_EQ(stream.get_next(&stream, &array), EIO);
+  EXPECT_NE(
+      std::string(stream.get_last_error(&stream)).find("Producer failed"),
+      std::string::npos);
+  stream.release(&stream);
+  EXPECT_EQ(stream.release, nullptr);
+}
+
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
  protected:
   // Used by this base test class to import Arrow data and create Velox Vector.
@@ -1075,6 +1145,71 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  // Slices of Arrow arrays, e.g. of a sliced pyarrow table, are imported
+  // with their offset.
+  void testImportSlices() {
+    arrow::Int64Builder ib;
+    arrow::BooleanBuilder bb;
+    arrow::StringBuilder sb;
+    auto vb = std::make_shared<arrow::Int32Builder>();
+    arrow::ListBuilder lb(arrow::default_memory_pool(), vb);
+    for (int i = 0; i < 40; ++i) {
+      if (i % 3 == 0) {
+        ASSERT_OK(ib.AppendNull());
+        ASSERT_OK(bb.AppendNull());
+        ASSERT_OK(sb.AppendNull());
+        ASSERT_OK(lb.AppendNull());
+        continue;
+      }
+      ASSERT_OK(ib.Append(i));
+      ASSERT_OK(bb.Append(i % 5 == 0));
+      ASSERT_OK(sb.Append(std::string(i, 'a' + i % 26)));
+      ASSERT_OK(lb.Append());
+      for (int j = 0; j < i % 4; ++j) {
+        ASSERT_OK(vb->Append(i + j));
+      }
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays(4);
+    ASSERT_OK(ib.Finish(&arrays[0]));
+    ASSERT_OK(bb.Finish(&arrays[1]));
+    ASSERT_OK(sb.Finish(&arrays[2]));
+    ASSERT_OK(lb.Finish(&arrays[3]));
+    // Slices at and off byte boundaries of the bit buffers.
+    for (auto& array : arrays) {
+      for (int64_t offset : {8, 13}) {
+        auto slice = array->Slice(offset, 20);
+        testArrowRoundTrip(*slice, [](const BaseVector& vec) {
+          EXPECT_EQ(vec.size(), 20);
+        });
+      }
+    }
+  }
+
+  // Large strings have 64 bit offsets.
+  void testImportLargeString() {
+    arrow::LargeStringBuilder b;
+    ASSERT_OK(b.Append("short"));
+    ASSERT_OK(b.AppendNull());
+    ASSERT_OK(b.Append("a string which is too long to be inlined"));
+    ASSERT_OK(b.Append(""));
+    ASSERT_OK_AND_ASSIGN(auto array, b.Finish());
+    ArrowSchema schema;
+    ArrowArray data;
+    ASSERT_OK(arrow::ExportType(*array->type(), &schema));
+    ASSERT_OK(arrow::ExportArray(*array->Slice(1), &data));
+    auto vec = importFromArrow(schema, data, pool_.get());
+    ASSERT_EQ(*vec->type(), *VARCHAR());
+    ASSERT_EQ(vec->size(), 3);
+    auto* flat = vec->asFlatVector<StringView>();
+    EXPECT_TRUE(flat->isNullAt(0));
+    EXPECT_EQ(flat->valueAt(1), "a string which is too long to be inlined");
+    EXPECT_EQ(flat->valueAt(2), "");
+    if (isViewer()) {
+      schema.release(&schema);
+      data.release(&data);
+    }
+  }
+
   void testImportFailures() {
     ArrowSchema arrowSchema;
     ArrowArray arrowArray;
@@ -1084,9 +1219,9 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
 
     // Unsupported:
 
-    // Offset not yet supported.
-    arrowSchema = makeArrowSchema("i");
-    arrowArray = makeArrowArray(buffers, 2, 4, 0);
+    // Offset of a struct not yet supported.
+    arrowSchema = makeArrowSchema("+s");
+    arrowArray = makeArrowArray(buffers, 0, 4, 0);
     arrowArray.offset = 1;
     EXPECT_THROW(
         importFromArrow(arrowSchema, arrowArray, pool_.get()), VeloxUserError);
@@ -1178,6 +1313,11 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, slices) {
+  testImportSlices();
+  testImportLargeString();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, failures) {
   testImportFailures();
 }
@@ -1225,6 +1365,11 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, slices) {
+  testImportSlices();
+  testImportLargeString();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, failures) {
   testImportFailures();
 }
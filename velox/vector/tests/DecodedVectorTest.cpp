@@ -1154,6 +1154,41 @@ TEST_F(DecodedVectorTest, emptyRowsMultiDict) {
   }
 }
 
+TEST_F(DecodedVectorTest, nestedDictionaryRanges) {
+  // Three levels of dictionaries without nulls, decoded for all rows and for
+  // ranges of rows that are not aligned to the SIMD width.
+  const vector_size_t size = 1'000;
+  auto base = makeFlatVector<int64_t>(size, [](auto row) { return row * 3; });
+  auto dict = wrapInDictionary(
+      makeIndices(size, [](auto row) { return (row * 7) % size; }),
+      size,
+      wrapInDictionary(
+          makeIndicesInReverse(size),
+          size,
+          wrapInDictionary(
+              makeIndices(size, [](auto row) { return (row + 11) % size; }),
+              size,
+              base)));
+  auto expectedAt = [&](auto row) {
+    return ((size - 1 - (row * 7) % size) + 11) % size * 3;
+  };
+
+  SelectivityVector rows(size);
+  DecodedVector decoded(*dict, rows);
+  for (auto row = 0; row < size; ++row) {
+    ASSERT_EQ(decoded.valueAt<int64_t>(row), expectedAt(row));
+  }
+
+  rows.setValidRange(3, 17, false);
+  rows.setValidRange(500, 501, false);
+  rows.setValidRange(700, 999, false);
+  rows.updateBounds();
+  decoded.decode(*dict, rows);
+  rows.applyToSelected([&](auto row) {
+    ASSERT_EQ(decoded.valueAt<int64_t>(row), expectedAt(row));
+  });
+}
+
 TEST_F(DecodedVectorTest, flatNulls) {
   // Flat vector with no nulls.
   auto flatNoNulls = makeFlatVector<int64_t>(100, [](auto row) { return row; });
@@ -440,6 +440,41 @@ TEST(SelectivityVectorTest, select) {
   assertIsValid(2, 8, bitAfterCheck, true);
 }
 
+TEST(SelectivityVectorTest, applyToSelectedRanges) {
+  auto collectRanges = [](const SelectivityVector& rows) {
+    std::vector<std::pair<vector_size_t, vector_size_t>> ranges;
+    rows.applyToSelectedRanges(
+        [&](auto begin, auto end) { ranges.emplace_back(begin, end); });
+    return ranges;
+  };
+
+  SelectivityVector rows(1'000);
+  EXPECT_EQ(
+      collectRanges(rows),
+      (std::vector<std::pair<vector_size_t, vector_size_t>>{{0, 1'000}}));
+
+  rows.setValidRange(10, 20, false);
+  rows.setValid(500, false);
+  rows.setValidRange(990, 1'000, false);
+  rows.updateBounds();
+  EXPECT_EQ(
+      collectRanges(rows),
+      (std::vector<std::pair<vector_size_t, vector_size_t>>{
+          {0, 10}, {20, 500}, {501, 990}}));
+
+  // Every other row.
+  SelectivityVector sparse(100, false);
+  std::vector<std::pair<vector_size_t, vector_size_t>> expected;
+  for (auto row = 1; row < 100; row += 2) {
+    sparse.setValid(row, true);
+    expected.emplace_back(row, row + 1);
+  }
+  sparse.updateBounds();
+  EXPECT_EQ(collectRanges(sparse), expected);
+
+  EXPECT_TRUE(collectRanges(SelectivityVector(100, false)).empty());
+}
+
 TEST(SelectivityVectorTest, selectAndGrow) {
   {
     SelectivityVector a(5);
@@ -996,6 +996,32 @@ TEST_F(VectorTest, bias) {
   testCopy(base, 4);
 }
 
+TEST_F(VectorTest, sequenceSlice) {
+  // Runs of lengths 1 to 20 with a null every 5th run.
+  const vector_size_t numRuns = 20;
+  auto runValues = makeFlatVector<int64_t>(
+      numRuns, [](auto row) { return row * 10; }, nullEvery(5));
+  auto lengths = allocateSizes(numRuns, pool_.get());
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  vector_size_t size = 0;
+  for (auto i = 0; i < numRuns; ++i) {
+    rawLengths[i] = i + 1;
+    size += i + 1;
+  }
+  auto sequence = BaseVector::wrapInSequence(lengths, size, runValues);
+  for (vector_size_t offset : {0, 1, 15, 16, 17, 100}) {
+    for (vector_size_t length : {0, 1, 2, 30, 83}) {
+      if (offset + length <= size) {
+        testSlice(sequence, 0, offset, length);
+      }
+    }
+  }
+  auto slice = sequence->slice(16, 29);
+  ASSERT_EQ(slice->encoding(), VectorEncoding::Simple::SEQUENCE);
+  // Rows 16 to 44 are in the runs of lengths 6 to 9.
+  ASSERT_EQ(slice->valueVector()->size(), 4);
+}
+
 TEST_F(VectorTest, row) {
   auto baseRow = createRow(vectorSize_, false);
   testCopy(baseRow, numIterations_);